@@ -40,6 +40,7 @@ set(INHERITED_CMAKE_ARGS
   -DTILEDB_STATIC=${TILEDB_STATIC}
   -DTILEDB_TESTS=${TILEDB_TESTS}
   -DTILEDB_TOOLS=${TILEDB_TOOLS}
+  -DTILEDB_MICROBENCHMARKS=${TILEDB_MICROBENCHMARKS}
   -DTILEDB_SERIALIZATION=${TILEDB_SERIALIZATION}
   -DTILEDB_INSTALL_LIBDIR=${TILEDB_INSTALL_LIBDIR}
 )
@@ -3,7 +3,10 @@
 import argparse
 import glob
 import json
+import math
+import multiprocessing
 import os
+import platform
 import subprocess
 import sys
 import threading
@@ -14,6 +17,11 @@ benchmark_build_dir = os.path.abspath('build')
 
 NUM_TRIALS = 3
 
+# A change in the mean run time is flagged when it is statistically
+# significant (p-value below this) and larger than the relative threshold.
+SIGNIFICANCE_LEVEL = 0.05
+DEFAULT_THRESHOLD = 0.05
+
 if os.name == 'posix':
     if sys.platform == 'darwin':
         os_name = 'mac'
@@ -123,22 +131,231 @@ def build_benchmarks(args):
         p.stop()
 
 
-def print_results(results):
+def benchmark_config(args):
+    """
+    Returns the TileDB config parameters the benchmark programs run with.
+
+    :param args: argparse args instance
+    :return: config dict
+    """
+    config = {}
+    if args.s3_endpoint is not None:
+        config['vfs.s3.endpoint_override'] = args.s3_endpoint
+        config['vfs.s3.scheme'] = args.s3_scheme
+        config['vfs.s3.use_virtual_addressing'] = 'false'
+        config['vfs.s3.verify_ssl'] = 'false'
+    if args.latency_ms is not None:
+        config['vfs.emulated_latency_ms'] = str(args.latency_ms)
+    if args.bandwidth is not None:
+        config['vfs.emulated_bandwidth'] = str(int(args.bandwidth * 1e6))
+    for param in args.config:
+        key, _, value = param.partition('=')
+        config[key] = value
+    return config
+
+
+def benchmark_env(args):
+    """
+    Returns the environment of the benchmark programs, which selects the
+    storage and the TileDB config they run with.
+
+    :param args: argparse args instance
+    :return: environment dict
+    """
+    config = benchmark_config(args)
+    env = dict(os.environ)
+    if args.uri_prefix is not None:
+        prefix = args.uri_prefix
+        env['TILEDB_BENCH_URI_PREFIX'] = prefix if prefix.endswith(
+            '/') else prefix + '/'
+    if config:
+        config_path = os.path.join(benchmark_build_dir, 'bench.config')
+        with open(config_path, 'w') as f:
+            for key in sorted(config.keys()):
+                f.write('{} {}\n'.format(key, config[key]))
+        env['TILEDB_BENCH_CONFIG'] = config_path
+    return env
+
+
+def print_results(results, num_trials):
     "Prints benchmark timing results."
     print('Reporting minimum time of {} runs for each benchmark:'.format(
-        NUM_TRIALS))
+        num_trials))
     print('-' * 93)
     for bench in sorted(results.keys()):
-        print('{:<30s}{:>60d} ms'.format(bench, min(results[bench])))
+        print('{:<30s}{:>60d} ms'.format(bench, min(results[bench]['ms'])))
 
 
-def run_benchmarks(args):
+def parse_run_output(output):
+    """
+    Returns the run phase result and the other results (e.g. throughputs)
+    among the JSON lines of a run.
+    """
+    run_result, other_results = None, []
+    for line in output.splitlines():
+        result = json.loads(line)
+        if result.get('phase') == 'run':
+            run_result = result
+        else:
+            other_results.append(result)
+    return run_result, other_results
+
+
+def git_sha():
+    """Returns the git SHA of the source tree, suffixed if it is dirty."""
+    src_dir = os.path.dirname(os.path.abspath(__file__))
+    try:
+        sha = subprocess.check_output(['git', 'rev-parse', 'HEAD'],
+                                      cwd=src_dir).decode().strip()
+        status = subprocess.check_output(['git', 'status', '--porcelain'],
+                                         cwd=src_dir).decode().strip()
+        return sha + ('-dirty' if status else '')
+    except (OSError, subprocess.CalledProcessError):
+        return None
+
+
+def machine_info():
+    """Returns a description of the machine running the benchmarks."""
+    return {
+        'hostname': platform.node(),
+        'os': platform.platform(),
+        'processor': platform.processor() or platform.machine(),
+        'cpu_count': multiprocessing.cpu_count(),
+        'python': platform.python_version(),
+    }
+
+
+def save_results(args, results, num_trials):
+    """Saves the results of the run with its provenance as JSON."""
+    report = {
+        'git_sha': git_sha(),
+        'date': time.strftime('%Y-%m-%dT%H:%M:%S%z'),
+        'machine': machine_info(),
+        'tiledb_path': find_tiledb_path(args),
+        'uri_prefix': args.uri_prefix,
+        'config': benchmark_config(args),
+        'num_trials': num_trials,
+        'benchmarks': results,
+    }
+    with open(args.output, 'w') as f:
+        json.dump(report, f, indent=2, sort_keys=True)
+    print('Results saved to {}'.format(args.output))
+
+
+def mean_and_variance(samples):
+    """Returns the mean and the unbiased variance of the samples."""
+    n = len(samples)
+    mean = float(sum(samples)) / n
+    if n < 2:
+        return mean, 0.0
+    return mean, sum((x - mean) ** 2 for x in samples) / (n - 1)
+
+
+def incomplete_beta(a, b, x):
+    """
+    Returns the regularized incomplete beta function I_x(a, b), evaluated
+    with its continued fraction (Numerical Recipes, 6.4).
+    """
+    if x <= 0.0:
+        return 0.0
+    if x >= 1.0:
+        return 1.0
+    if x > (a + 1.0) / (a + b + 2.0):
+        return 1.0 - incomplete_beta(b, a, 1.0 - x)
+
+    front = math.exp(math.lgamma(a + b) - math.lgamma(a) - math.lgamma(b) +
+                     a * math.log(x) + b * math.log(1.0 - x)) / a
+    tiny = 1e-300
+    c, d = 1.0, 1.0 - (a + b) * x / (a + 1.0)
+    d = 1.0 / (d if abs(d) > tiny else tiny)
+    f = d
+    for m in range(1, 200):
+        for numerator in (
+                m * (b - m) * x / ((a + 2 * m - 1) * (a + 2 * m)),
+                -(a + m) * (a + b + m) * x / ((a + 2 * m) * (a + 2 * m + 1))):
+            d = 1.0 + numerator * d
+            d = 1.0 / (d if abs(d) > tiny else tiny)
+            c = 1.0 + numerator / c
+            c = c if abs(c) > tiny else tiny
+            f *= c * d
+        if abs(c * d - 1.0) < 1e-12:
+            break
+    return front * f
+
+
+def welch_p_value(baseline, candidate):
+    """
+    Returns the two-sided p-value of Welch's t-test that the two sets of
+    samples have the same mean.
+    """
+    if len(baseline) < 2 or len(candidate) < 2:
+        return 1.0
+    m1, v1 = mean_and_variance(baseline)
+    m2, v2 = mean_and_variance(candidate)
+    s1, s2 = v1 / len(baseline), v2 / len(candidate)
+    if s1 + s2 == 0.0:
+        return 1.0 if m1 == m2 else 0.0
+    t = (m2 - m1) / math.sqrt(s1 + s2)
+    dof = (s1 + s2) ** 2 / (s1 ** 2 / (len(baseline) - 1) +
+                             s2 ** 2 / (len(candidate) - 1))
+    return incomplete_beta(dof / 2.0, 0.5, dof / (dof + t * t))
+
+
+def compare_results(baseline_path, candidate_path, threshold):
+    """
+    Compares the run times of two saved results, and returns the names of
+    the benchmarks with a statistically significant regression.
+    """
+    with open(baseline_path) as f:
+        baseline = json.load(f)
+    with open(candidate_path) as f:
+        candidate = json.load(f)
+
+    print('Baseline:  {} ({})'.format(baseline['git_sha'], baseline['date']))
+    print('Candidate: {} ({})'.format(candidate['git_sha'], candidate['date']))
+    if baseline['machine'] != candidate['machine']:
+        print('WARNING: the results were obtained on different machines')
+    if baseline['config'] != candidate['config'] or \
+            baseline['uri_prefix'] != candidate['uri_prefix']:
+        print('WARNING: the results were obtained with different configs')
+    print('-' * 93)
+    print('{:<30s}{:>14s}{:>14s}{:>10s}{:>10s}  {}'.format(
+        'benchmark', 'baseline ms', 'candidate ms', 'change', 'p-value',
+        'verdict'))
+
+    regressions = []
+    for bench in sorted(baseline['benchmarks'].keys()):
+        if bench not in candidate['benchmarks']:
+            continue
+        base_ms = baseline['benchmarks'][bench]['ms']
+        cand_ms = candidate['benchmarks'][bench]['ms']
+        base_mean, _ = mean_and_variance(base_ms)
+        cand_mean, _ = mean_and_variance(cand_ms)
+        change = (cand_mean - base_mean) / base_mean if base_mean else 0.0
+        p_value = welch_p_value(base_ms, cand_ms)
+
+        verdict = ''
+        if p_value < SIGNIFICANCE_LEVEL and abs(change) > threshold:
+            if change > 0:
+                verdict = 'REGRESSION'
+                regressions.append(bench)
+            else:
+                verdict = 'improvement'
+        print('{:<30s}{:>14.1f}{:>14.1f}{:>+9.1f}%{:>10.3f}  {}'.format(
+            bench, base_mean, cand_mean, 100 * change, p_value, verdict))
+
+    return regressions
+
+
+def run_benchmarks(args, num_trials):
     """Runs the benchmark programs."""
     if args.benchmarks is None:
         benchmarks = list_benchmarks()
     else:
         benchmarks = args.benchmarks.split(',')
 
+    env = benchmark_env(args)
+
     print('Dropping caches (you may be prompted for sudo access).')
     drop_fs_caches()
 
@@ -153,23 +370,28 @@ def run_benchmarks(args):
                 print('Error: no benchmark named "{}"'.format(b))
                 continue
 
-            subprocess.check_output([exe, 'setup'], cwd=benchmark_build_dir)
+            subprocess.check_output([exe, 'setup'], cwd=benchmark_build_dir,
+                                    env=env)
 
-            times_ms = []
-            for i in range(0, NUM_TRIALS):
+            times_ms, outputs = [], []
+            for i in range(0, num_trials):
                 sync_fs()
                 drop_fs_caches()
                 output_json = subprocess.check_output([exe, 'run'],
-                                                      cwd=benchmark_build_dir)
-                result = json.loads(output_json)
+                                                      cwd=benchmark_build_dir,
+                                                      env=env)
+                result, other_results = parse_run_output(output_json)
                 times_ms.append(result['ms'])
-            results[b] = times_ms
+                outputs.append(other_results)
+            results[b] = {'ms': times_ms, 'outputs': outputs}
 
-            subprocess.check_output([exe, 'teardown'], cwd=benchmark_build_dir)
+            subprocess.check_output([exe, 'teardown'],
+                                    cwd=benchmark_build_dir, env=env)
     finally:
         p.stop()
 
-    print_results(results)
+    print_results(results, num_trials)
+    return results
 
 
 def main():
@@ -183,8 +405,49 @@ def main():
     parser.add_argument('-b', '--benchmarks', metavar='NAMES',
                         help='If given, one or more comma-separated names of '
                              'benchmarks to run.')
+    parser.add_argument('--uri-prefix', metavar='URI',
+                        help='If given, the arrays are created under this '
+                             'prefix, e.g. s3://tiledb-bench/, instead of the '
+                             'build directory.')
+    parser.add_argument('--s3-endpoint', metavar='HOST:PORT',
+                        help='If given, S3 requests go to this endpoint, e.g. '
+                             'a local minio server.')
+    parser.add_argument('--s3-scheme', metavar='SCHEME', default='https',
+                        help='The scheme of the S3 endpoint (default https).')
+    parser.add_argument('--latency-ms', metavar='MS', type=int,
+                        help='If given, every VFS request is delayed by this '
+                             'emulated round trip time.')
+    parser.add_argument('--bandwidth', metavar='MB/S', type=float,
+                        help='If given, VFS reads and writes are delayed as '
+                             'if transferred at this bandwidth.')
+    parser.add_argument('-c', '--config', metavar='KEY=VALUE', default=[],
+                        action='append',
+                        help='Sets a TileDB config parameter of the '
+                             'benchmarks (may be repeated).')
+    parser.add_argument('-n', '--trials', metavar='N', type=int,
+                        default=NUM_TRIALS,
+                        help='The number of runs of each benchmark (default '
+                             '{}).'.format(NUM_TRIALS))
+    parser.add_argument('-o', '--output', metavar='FILE',
+                        help='If given, the results are saved as JSON to this '
+                             'file, with the git SHA, config and machine.')
+    parser.add_argument('--compare', metavar=('BASELINE', 'CANDIDATE'),
+                        nargs=2,
+                        help='Compares two saved results instead of running '
+                             'the benchmarks, and exits with an error if '
+                             'there is a significant regression.')
+    parser.add_argument('--threshold', metavar='FRACTION', type=float,
+                        default=DEFAULT_THRESHOLD,
+                        help='The minimum relative change of the mean run '
+                             'time reported by --compare (default '
+                             '{}).'.format(DEFAULT_THRESHOLD))
     args = parser.parse_args()
 
+    if args.compare is not None:
+        regressions = compare_results(args.compare[0], args.compare[1],
+                                      args.threshold)
+        sys.exit(1 if regressions else 0)
+
     if find_tiledb_path(args) is None:
         print('Error: TileDB installation not found in directory \'{}\''.format(
             args.tiledb))
@@ -196,7 +459,9 @@ def main():
         list_benchmarks(show=True)
         sys.exit(0)
 
-    run_benchmarks(args)
+    results = run_benchmarks(args, args.trials)
+    if args.output is not None:
+        save_results(args, results, args.trials)
 
 
 if __name__ == '__main__':
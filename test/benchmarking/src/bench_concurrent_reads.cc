@@ -0,0 +1,307 @@
+/**
+ * @file   bench_concurrent_reads.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * Benchmark concurrent read scalability: an increasing number of threads
+ * sharing one context issue a random mix of point, range and scan queries
+ * against a shared dense and a shared sparse array. For each number of
+ * threads, prints the throughput and the latency percentiles of each query
+ * kind as a JSON line.
+ */
+
+#include <tiledb/tiledb>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#include "benchmark.h"
+
+using namespace tiledb;
+
+class Benchmark : public BenchmarkBase {
+ protected:
+  virtual void setup() {
+    // Dense array, written in full
+    {
+      ArraySchema schema(ctx_, TILEDB_DENSE);
+      schema.set_domain(create_domain());
+      schema.add_attribute(create_attribute());
+      Array::create(dense_uri_, schema);
+
+      std::vector<int32_t> data(array_rows * array_cols);
+      for (uint64_t i = 0; i < data.size(); i++)
+        data[i] = i;
+      Array array(ctx_, dense_uri_, TILEDB_WRITE);
+      Query query(ctx_, array);
+      query.set_layout(TILEDB_ROW_MAJOR)
+          .set_subarray<uint32_t>({1, array_rows, 1, array_cols})
+          .set_buffer("a", data);
+      query.submit();
+      array.close();
+    }
+
+    // Sparse array, with every other cell of every other row nonempty
+    {
+      ArraySchema schema(ctx_, TILEDB_SPARSE);
+      schema.set_domain(create_domain());
+      schema.set_capacity(capacity);
+      schema.add_attribute(create_attribute());
+      Array::create(sparse_uri_, schema);
+
+      std::vector<uint32_t> coords;
+      for (uint32_t i = 1; i <= array_rows; i += 2) {
+        for (uint32_t j = 1; j <= array_cols; j += 2) {
+          coords.push_back(i);
+          coords.push_back(j);
+        }
+      }
+      std::vector<int32_t> data(coords.size() / 2);
+      for (uint64_t i = 0; i < data.size(); i++)
+        data[i] = i;
+      Array array(ctx_, sparse_uri_, TILEDB_WRITE);
+      Query query(ctx_, array);
+      query.set_layout(TILEDB_UNORDERED)
+          .set_buffer("a", data)
+          .set_coordinates(coords);
+      query.submit();
+      array.close();
+    }
+  }
+
+  virtual void teardown() {
+    VFS vfs(ctx_);
+    for (const auto& uri : {dense_uri_, sparse_uri_}) {
+      if (vfs.is_dir(uri))
+        vfs.remove_dir(uri);
+    }
+  }
+
+  virtual void run() {
+    for (unsigned thread_num : thread_nums) {
+      std::vector<Latencies> latencies(thread_num);
+      auto elapsed_ms = run_threads(&latencies);
+      print_results(thread_num, elapsed_ms, latencies);
+    }
+  }
+
+ private:
+  /** The query kinds, issued with decreasing frequency. */
+  enum QueryKind { POINT, RANGE, SCAN, QUERY_KIND_NUM };
+
+  /** The latencies in microseconds of one thread, per query kind. */
+  typedef std::array<std::vector<uint64_t>, QUERY_KIND_NUM> Latencies;
+
+  /** The query buffers of one thread, large enough for a scan. */
+  struct Buffers {
+    std::vector<int32_t> data;
+    std::vector<uint32_t> coords;
+  };
+
+  const std::string dense_uri_ = array_uri("bench_array_dense");
+  const std::string sparse_uri_ = array_uri("bench_array_sparse");
+  const uint32_t array_rows = 1000, array_cols = 1000;
+  const uint32_t tile_rows = 100, tile_cols = 100;
+  const uint32_t range_rows = 100, range_cols = 100;
+  const unsigned capacity = 1000;
+  const std::vector<unsigned> thread_nums = {1, 2, 4, 8, 16};
+  const std::chrono::milliseconds duration_per_thread_num{3000};
+
+  /** The context shared by all the threads. */
+  Context ctx_{config()};
+
+  /** Guards the start of the threads. */
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  unsigned ready_num_;
+  bool started_;
+  std::chrono::steady_clock::time_point deadline_;
+
+  Domain create_domain() {
+    Domain domain(ctx_);
+    domain.add_dimension(
+        Dimension::create<uint32_t>(ctx_, "d1", {{1, array_rows}}, tile_rows));
+    domain.add_dimension(
+        Dimension::create<uint32_t>(ctx_, "d2", {{1, array_cols}}, tile_cols));
+    return domain;
+  }
+
+  Attribute create_attribute() {
+    FilterList filters(ctx_);
+    filters.add_filter({ctx_, TILEDB_FILTER_BYTESHUFFLE})
+        .add_filter({ctx_, TILEDB_FILTER_LZ4});
+    return Attribute::create<int32_t>(ctx_, "a", filters);
+  }
+
+  /**
+   * Runs one thread per entry of ``latencies`` until the deadline, and
+   * returns the time until the last thread finished.
+   */
+  uint64_t run_threads(std::vector<Latencies>* latencies) {
+    ready_num_ = 0;
+    started_ = false;
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < latencies->size(); t++)
+      threads.emplace_back(&Benchmark::run_thread, this, t, &(*latencies)[t]);
+
+    // Start the threads together, once they have all opened the arrays
+    std::chrono::steady_clock::time_point start;
+    {
+      std::unique_lock<std::mutex> lck(mtx_);
+      cv_.wait(lck, [&]() { return ready_num_ == latencies->size(); });
+      start = std::chrono::steady_clock::now();
+      deadline_ = start + duration_per_thread_num;
+      started_ = true;
+    }
+    cv_.notify_all();
+
+    for (auto& thread : threads)
+      thread.join();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(end - start)
+        .count();
+  }
+
+  /** Issues random queries until the deadline, recording their latencies. */
+  void run_thread(unsigned t, Latencies* latencies) {
+    Array dense(ctx_, dense_uri_, TILEDB_READ);
+    Array sparse(ctx_, sparse_uri_, TILEDB_READ);
+    Buffers buffers;
+    buffers.data.resize(array_rows * array_cols);
+    buffers.coords.resize(2 * array_rows * array_cols);
+    std::minstd_rand gen(t + 1);
+
+    {
+      std::unique_lock<std::mutex> lck(mtx_);
+      ready_num_++;
+      cv_.notify_all();
+      cv_.wait(lck, [&]() { return started_; });
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    while (now < deadline_) {
+      auto kind = random_query_kind(&gen);
+      auto subarray = random_subarray(kind, &gen);
+      if (gen() % 2 == 0)
+        read(&dense, subarray, &buffers, false);
+      else
+        read(&sparse, subarray, &buffers, true);
+
+      auto end = std::chrono::steady_clock::now();
+      (*latencies)[kind].push_back(
+          std::chrono::duration_cast<std::chrono::microseconds>(end - now)
+              .count());
+      now = end;
+    }
+
+    dense.close();
+    sparse.close();
+  }
+
+  /** Returns a random query kind: 70% points, 25% ranges and 5% scans. */
+  QueryKind random_query_kind(std::minstd_rand* gen) {
+    auto r = (*gen)() % 100;
+    return r < 70 ? POINT : (r < 95 ? RANGE : SCAN);
+  }
+
+  /** Returns a random subarray of the input query kind. */
+  std::vector<uint32_t> random_subarray(QueryKind kind, std::minstd_rand* gen) {
+    uint32_t rows = 1, cols = 1;
+    if (kind == RANGE) {
+      rows = range_rows;
+      cols = range_cols;
+    } else if (kind == SCAN) {
+      return {1, array_rows, 1, array_cols};
+    }
+    uint32_t row = 1 + (*gen)() % (array_rows - rows + 1);
+    uint32_t col = 1 + (*gen)() % (array_cols - cols + 1);
+    return {row, row + rows - 1, col, col + cols - 1};
+  }
+
+  /** Reads the subarray from the array into the buffers. */
+  void read(
+      Array* array,
+      const std::vector<uint32_t>& subarray,
+      Buffers* buffers,
+      bool sparse) {
+    Query query(ctx_, *array);
+    query.set_subarray(subarray)
+        .set_layout(TILEDB_ROW_MAJOR)
+        .set_buffer("a", buffers->data);
+    if (sparse)
+      query.set_coordinates(buffers->coords);
+    query.submit();
+  }
+
+  /** Returns the latency at the input percentile of the sorted latencies. */
+  static uint64_t percentile(const std::vector<uint64_t>& sorted, double p) {
+    if (sorted.empty())
+      return 0;
+    auto idx = std::min<size_t>(sorted.size() - 1, p * sorted.size());
+    return sorted[idx];
+  }
+
+  /** Prints the throughput and latencies of each query kind in JSON. */
+  void print_results(
+      unsigned thread_num,
+      uint64_t elapsed_ms,
+      const std::vector<Latencies>& latencies) {
+    const char* names[] = {"point", "range", "scan"};
+    std::vector<uint64_t> all;
+    for (int kind = 0; kind <= QUERY_KIND_NUM; kind++) {
+      std::vector<uint64_t> merged;
+      if (kind < QUERY_KIND_NUM) {
+        for (const auto& l : latencies)
+          merged.insert(merged.end(), l[kind].begin(), l[kind].end());
+        all.insert(all.end(), merged.begin(), merged.end());
+      } else {
+        merged.swap(all);
+      }
+      std::sort(merged.begin(), merged.end());
+
+      double qps = elapsed_ms == 0 ? 0 : merged.size() * 1000.0 / elapsed_ms;
+      std::cout << "{ \"threads\": " << thread_num << ", \"query\": \""
+                << (kind < QUERY_KIND_NUM ? names[kind] : "all")
+                << "\", \"queries\": " << merged.size()
+                << ", \"qps\": " << (uint64_t)qps
+                << ", \"p50_us\": " << percentile(merged, 0.5)
+                << ", \"p90_us\": " << percentile(merged, 0.9)
+                << ", \"p99_us\": " << percentile(merged, 0.99)
+                << ", \"max_us\": " << percentile(merged, 1.0) << " }\n";
+    }
+  }
+};
+
+int main(int argc, char** argv) {
+  Benchmark bench;
+  return bench.main(argc, argv);
+}
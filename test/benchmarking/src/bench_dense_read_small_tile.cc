@@ -87,11 +87,11 @@ class Benchmark : public BenchmarkBase {
   }
 
  private:
-  const std::string array_uri_ = "bench_array";
+  const std::string array_uri_ = array_uri("bench_array");
   const unsigned array_rows = 10000, array_cols = 10000;
   const unsigned tile_rows = 100, tile_cols = 100;
 
-  Context ctx_;
+  Context ctx_{config()};
   std::vector<int> data_;
 };
 
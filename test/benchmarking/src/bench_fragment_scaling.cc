@@ -0,0 +1,212 @@
+/**
+ * @file   bench_fragment_scaling.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * Benchmark how array opening and sparse point queries scale with the
+ * number of fragments. For 10 to 10,000 small fragments, prints as a JSON
+ * line the latency of opening the array and of a point query, then the time
+ * to consolidate the fragment metadata and the same latencies after it, and
+ * finally the time to consolidate the fragments and the latencies after it.
+ */
+
+#include <tiledb/tiledb>
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+#include "benchmark.h"
+
+using namespace tiledb;
+
+class Benchmark : public BenchmarkBase {
+ protected:
+  virtual void teardown() {
+    VFS vfs(ctx_);
+    for (auto fragment_num : fragment_nums) {
+      auto uri = fragment_array_uri(fragment_num);
+      if (vfs.is_dir(uri))
+        vfs.remove_dir(uri);
+    }
+  }
+
+  virtual void run() {
+    for (auto fragment_num : fragment_nums) {
+      auto uri = fragment_array_uri(fragment_num);
+      std::cout << "{ \"fragments\": " << fragment_num;
+
+      auto start = std::chrono::steady_clock::now();
+      auto coords = write_fragments(uri, fragment_num);
+      print_ms("write_ms", start);
+      print_latencies("", uri, coords);
+
+      start = std::chrono::steady_clock::now();
+      Array::consolidate_fragment_metadata(ctx_, uri);
+      print_ms("consolidate_metadata_ms", start);
+      print_latencies("consolidated_metadata_", uri, coords);
+
+      start = std::chrono::steady_clock::now();
+      Array::consolidate(ctx_, uri);
+      Array::vacuum(ctx_, uri);
+      print_ms("consolidate_ms", start);
+      print_latencies("consolidated_", uri, coords);
+
+      std::cout << " }\n";
+    }
+  }
+
+ private:
+  const std::string array_uri_ = array_uri("bench_array");
+  const std::vector<unsigned> fragment_nums = {10, 100, 1000, 10000};
+  const uint32_t array_rows = 10000, array_cols = 10000;
+  const uint32_t tile_rows = 100, tile_cols = 100;
+  const unsigned capacity = 1000;
+  const unsigned cells_per_fragment = 100;
+  const unsigned open_num = 5;
+  const unsigned query_num = 100;
+
+  Context ctx_{uncached_config()};
+
+  /**
+   * Returns the benchmark config with the fragment metadata cache disabled,
+   * so that every open loads the fragment metadata.
+   */
+  static Config uncached_config() {
+    auto cfg = config();
+    cfg["sm.fragment_metadata_cache_size"] = "0";
+    return cfg;
+  }
+
+  /** Returns the URI of the array with the input number of fragments. */
+  std::string fragment_array_uri(unsigned fragment_num) const {
+    return array_uri_ + "_" + std::to_string(fragment_num);
+  }
+
+  /**
+   * Creates a sparse array with the input number of fragments of random
+   * cells, and returns the coordinates of the written cells.
+   */
+  std::vector<uint32_t> write_fragments(
+      const std::string& uri, unsigned fragment_num) {
+    VFS vfs(ctx_);
+    if (vfs.is_dir(uri))
+      vfs.remove_dir(uri);
+
+    ArraySchema schema(ctx_, TILEDB_SPARSE);
+    Domain domain(ctx_);
+    domain.add_dimension(
+        Dimension::create<uint32_t>(ctx_, "d1", {{1, array_rows}}, tile_rows));
+    domain.add_dimension(
+        Dimension::create<uint32_t>(ctx_, "d2", {{1, array_cols}}, tile_cols));
+    schema.set_domain(domain);
+    schema.set_capacity(capacity);
+    schema.add_attribute(Attribute::create<int32_t>(ctx_, "a"));
+    Array::create(uri, schema);
+
+    std::minstd_rand gen(fragment_num);
+    std::vector<uint32_t> all_coords;
+    std::vector<uint32_t> coords(2 * cells_per_fragment);
+    std::vector<int32_t> data(cells_per_fragment);
+    Array array(ctx_, uri, TILEDB_WRITE);
+    for (unsigned f = 0; f < fragment_num; f++) {
+      for (unsigned i = 0; i < cells_per_fragment; i++) {
+        coords[2 * i] = 1 + gen() % array_rows;
+        coords[2 * i + 1] = 1 + gen() % array_cols;
+        data[i] = f;
+      }
+      Query query(ctx_, array);
+      query.set_layout(TILEDB_UNORDERED)
+          .set_buffer("a", data)
+          .set_coordinates(coords);
+      query.submit();
+      all_coords.insert(all_coords.end(), coords.begin(), coords.end());
+    }
+    array.close();
+
+    return all_coords;
+  }
+
+  /**
+   * Prints the average latency of opening the array and of a point query
+   * on a random written cell, with the input name prefix.
+   */
+  void print_latencies(
+      const std::string& prefix,
+      const std::string& uri,
+      const std::vector<uint32_t>& coords) {
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < open_num; i++) {
+      Array array(ctx_, uri, TILEDB_READ);
+      array.close();
+    }
+    print_us(prefix + "open_us", start, open_num);
+
+    // Duplicate coordinates may be written, so the buffers hold a few cells
+    std::minstd_rand gen(0);
+    std::vector<int32_t> data(16);
+    std::vector<uint32_t> result_coords(32);
+    Array array(ctx_, uri, TILEDB_READ);
+    start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < query_num; i++) {
+      auto cell = gen() % (coords.size() / 2);
+      auto row = coords[2 * cell], col = coords[2 * cell + 1];
+      Query query(ctx_, array);
+      query.set_subarray<uint32_t>({row, row, col, col})
+          .set_layout(TILEDB_ROW_MAJOR)
+          .set_buffer("a", data)
+          .set_coordinates(result_coords);
+      query.submit();
+    }
+    print_us(prefix + "point_query_us", start, query_num);
+    array.close();
+  }
+
+  /** Prints the time in milliseconds since the start. */
+  static void print_ms(
+      const std::string& name, std::chrono::steady_clock::time_point start) {
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                  std::chrono::steady_clock::now() - start)
+                  .count();
+    std::cout << ", \"" << name << "\": " << ms;
+  }
+
+  /** Prints the average time in microseconds of ``num`` operations. */
+  static void print_us(
+      const std::string& name,
+      std::chrono::steady_clock::time_point start,
+      unsigned num) {
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                  std::chrono::steady_clock::now() - start)
+                  .count();
+    std::cout << ", \"" << name << "\": " << us / num;
+  }
+};
+
+int main(int argc, char** argv) {
+  Benchmark bench;
+  return bench.main(argc, argv);
+}
@@ -115,12 +115,12 @@ class Benchmark : public BenchmarkBase {
   }
 
  private:
-  const std::string array_uri_ = "bench_array";
+  const std::string array_uri_ = array_uri("bench_array");
   const unsigned tile_rows = 300, tile_cols = 300;
   const unsigned capacity = 1000;
   const unsigned max_row = 5000, max_col = 5000;
 
-  Context ctx_;
+  Context ctx_{config()};
   std::vector<int> data_;
   std::vector<uint32_t> subarray_, coords_;
 };
@@ -31,6 +31,7 @@
  */
 
 #include <chrono>
+#include <cstdlib>
 #include <iostream>
 #include <string>
 
@@ -85,6 +86,16 @@ void BenchmarkBase::teardown_base() {
 }
 
 void BenchmarkBase::setup_base() {
+  // Create the bucket of a remote URI prefix, if it does not exist
+  std::string prefix = array_uri("");
+  if (prefix.compare(0, 5, "s3://") == 0) {
+    auto bucket = prefix.substr(0, prefix.find('/', 5));
+    tiledb::Context ctx(config());
+    tiledb::VFS vfs(ctx);
+    if (!vfs.is_bucket(bucket))
+      vfs.create_bucket(bucket);
+  }
+
   teardown();
 
   auto t0 = std::chrono::steady_clock::now();
@@ -120,6 +131,20 @@ void BenchmarkBase::run() {
 void BenchmarkBase::pre_run() {
 }
 
+tiledb::Config BenchmarkBase::config() {
+  const char* path = std::getenv("TILEDB_BENCH_CONFIG");
+  if (path == nullptr || path[0] == '\0')
+    return tiledb::Config();
+  return tiledb::Config(path);
+}
+
+std::string BenchmarkBase::array_uri(const std::string& name) {
+  const char* prefix = std::getenv("TILEDB_BENCH_URI_PREFIX");
+  if (prefix == nullptr)
+    return name;
+  return prefix + name;
+}
+
 void BenchmarkBase::print_task_ms_json(const std::string& name, uint64_t ms) {
   std::cout << "{ \"phase\": \"" << name << "\", \"ms\": " << ms << " }\n";
 }
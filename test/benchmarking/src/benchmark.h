@@ -33,6 +33,8 @@
 #ifndef TILEDB_BENCHMARK_H
 #define TILEDB_BENCHMARK_H
 
+#include <tiledb/tiledb>
+
 #include <cassert>
 #include <string>
 
@@ -75,6 +77,20 @@ class BenchmarkBase {
   /** Implemented by subclass: the run phase. */
   virtual void run();
 
+  /**
+   * Returns the config of the benchmark contexts, loaded from the file in
+   * the `TILEDB_BENCH_CONFIG` environment variable if it is set. This is
+   * how the harness selects S3 settings or the emulated VFS latency.
+   */
+  static tiledb::Config config();
+
+  /**
+   * Returns the URI of the array with the input name, under the prefix in
+   * the `TILEDB_BENCH_URI_PREFIX` environment variable if it is set (e.g.
+   * `s3://tiledb-bench/`), or in the working directory otherwise.
+   */
+  static std::string array_uri(const std::string& name);
+
  private:
   /**
    * Prints a time in milliseconds for a task name in JSON.
@@ -0,0 +1,170 @@
+/**
+ * @file bench_filter_pipeline.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * @section DESCRIPTION
+ *
+ * Microbenchmarks of the filter pipeline, running each filter and each
+ * compressor (at several levels) forward and in reverse on a tile.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "tiledb/sm/buffer/buffer.h"
+#include "tiledb/sm/enums/compressor.h"
+#include "tiledb/sm/enums/datatype.h"
+#include "tiledb/sm/filter/bit_width_reduction_filter.h"
+#include "tiledb/sm/filter/bitshuffle_filter.h"
+#include "tiledb/sm/filter/byteshuffle_filter.h"
+#include "tiledb/sm/filter/compression_filter.h"
+#include "tiledb/sm/filter/dictionary_filter.h"
+#include "tiledb/sm/filter/filter_pipeline.h"
+#include "tiledb/sm/filter/float_xor_filter.h"
+#include "tiledb/sm/filter/frame_of_reference_filter.h"
+#include "tiledb/sm/filter/positive_delta_filter.h"
+#include "tiledb/sm/tile/tile.h"
+
+#include <random>
+
+using namespace tiledb::sm;
+
+namespace {
+
+/** The size of the benchmarked tiles, the default tile capacity in bytes. */
+const uint64_t tile_size = 10000 * sizeof(uint64_t);
+
+/**
+ * Fills the buffer with a tile of increasing values with small random
+ * steps, which every filter reduces, as 64-bit integers or doubles.
+ */
+void fill_tile(Datatype type, Buffer* buff) {
+  std::minstd_rand gen(0);
+  int64_t value = 0;
+  buff->reset_size();
+  for (uint64_t i = 0; i < tile_size / sizeof(int64_t); ++i) {
+    value += gen() % 16;
+    if (type == Datatype::FLOAT64) {
+      double d = value / 4.0;
+      buff->write(&d, sizeof(d));
+    } else {
+      buff->write(&value, sizeof(value));
+    }
+  }
+}
+
+/** Runs the pipeline of the input filter forward on a tile. */
+void filter_forward(
+    benchmark::State& state, const Filter& filter, Datatype type) {
+  FilterPipeline pipeline;
+  if (!pipeline.add_filter(filter).ok()) {
+    state.SkipWithError("Cannot add filter");
+    return;
+  }
+
+  Buffer input, buff;
+  fill_tile(type, &input);
+  for (auto _ : state) {
+    state.PauseTiming();
+    buff.reset_size();
+    buff.write(input.data(), input.size());
+    Tile tile(type, datatype_size(type), 0, &buff, false);
+    state.ResumeTiming();
+
+    if (!pipeline.run_forward(&tile).ok()) {
+      state.SkipWithError("Cannot run filter pipeline forward");
+      break;
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * tile_size);
+}
+
+/** Runs the pipeline of the input filter in reverse on a filtered tile. */
+void filter_reverse(
+    benchmark::State& state, const Filter& filter, Datatype type) {
+  FilterPipeline pipeline;
+  if (!pipeline.add_filter(filter).ok()) {
+    state.SkipWithError("Cannot add filter");
+    return;
+  }
+
+  // The tile is filtered once, and its filtered data copied to each run
+  Buffer filtered, buff;
+  fill_tile(type, &filtered);
+  Tile filtered_tile(type, datatype_size(type), 0, &filtered, false);
+  if (!pipeline.run_forward(&filtered_tile).ok()) {
+    state.SkipWithError("Cannot run filter pipeline forward");
+    return;
+  }
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    buff.reset_size();
+    buff.write(filtered.data(), filtered.size());
+    Tile tile(type, datatype_size(type), 0, &buff, false);
+    tile.set_filtered(true);
+    state.ResumeTiming();
+
+    if (!pipeline.run_reverse(&tile).ok()) {
+      state.SkipWithError("Cannot run filter pipeline in reverse");
+      break;
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * tile_size);
+}
+
+}  // namespace
+
+/** Registers the forward and reverse benchmarks of a filter. */
+#define BENCHMARK_FILTER(name, filter, type)             \
+  BENCHMARK_CAPTURE(filter_forward, name, filter, type); \
+  BENCHMARK_CAPTURE(filter_reverse, name, filter, type)
+
+BENCHMARK_FILTER(
+    bit_width_reduction, BitWidthReductionFilter(), Datatype::INT64);
+BENCHMARK_FILTER(bitshuffle, BitshuffleFilter(), Datatype::INT64);
+BENCHMARK_FILTER(byteshuffle, ByteshuffleFilter(), Datatype::INT64);
+BENCHMARK_FILTER(dictionary, DictionaryFilter(), Datatype::INT64);
+BENCHMARK_FILTER(float_xor, FloatXorFilter(), Datatype::FLOAT64);
+BENCHMARK_FILTER(
+    frame_of_reference, FrameOfReferenceFilter(), Datatype::INT64);
+BENCHMARK_FILTER(positive_delta, PositiveDeltaFilter(), Datatype::INT64);
+
+/** Registers the benchmarks of a compressor at a level (if it has any). */
+#define BENCHMARK_COMPRESSOR(name, compressor, level) \
+  BENCHMARK_FILTER(                                   \
+      name, CompressionFilter(compressor, level), Datatype::INT64)
+
+BENCHMARK_COMPRESSOR(gzip_1, Compressor::GZIP, 1);
+BENCHMARK_COMPRESSOR(gzip_6, Compressor::GZIP, 6);
+BENCHMARK_COMPRESSOR(gzip_9, Compressor::GZIP, 9);
+BENCHMARK_COMPRESSOR(zstd_1, Compressor::ZSTD, 1);
+BENCHMARK_COMPRESSOR(zstd_3, Compressor::ZSTD, 3);
+BENCHMARK_COMPRESSOR(zstd_9, Compressor::ZSTD, 9);
+BENCHMARK_COMPRESSOR(zstd_19, Compressor::ZSTD, 19);
+BENCHMARK_COMPRESSOR(lz4, Compressor::LZ4, -1);
+BENCHMARK_COMPRESSOR(bzip2_1, Compressor::BZIP2, 1);
+BENCHMARK_COMPRESSOR(bzip2_9, Compressor::BZIP2, 9);
+BENCHMARK_COMPRESSOR(rle, Compressor::RLE, -1);
+BENCHMARK_COMPRESSOR(double_delta, Compressor::DOUBLE_DELTA, -1);
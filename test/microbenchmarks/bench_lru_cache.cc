@@ -0,0 +1,123 @@
+/**
+ * @file bench_lru_cache.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * @section DESCRIPTION
+ *
+ * Microbenchmarks of the LRU cache, reading and inserting tiles from an
+ * increasing number of threads sharing the cache.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "tiledb/sm/buffer/buffer.h"
+#include "tiledb/sm/cache/lru_cache.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <string>
+#include <thread>
+
+using namespace tiledb::sm;
+
+namespace {
+
+/** The size of each cached object, a typical filtered tile. */
+const uint64_t object_size = 64 * 1024;
+
+/** The number of objects that fit in the cache. */
+const uint64_t object_num = 256;
+
+/** Returns a random generator seeded differently on each thread. */
+std::minstd_rand thread_gen() {
+  return std::minstd_rand(
+      (unsigned)std::hash<std::thread::id>()(std::this_thread::get_id()));
+}
+
+/** Returns the key of the object with the input id. */
+std::string object_key(uint64_t id) {
+  return "tile_" + std::to_string(id);
+}
+
+/** Reads random objects from a cache holding all of them. */
+void lru_cache_read(benchmark::State& state) {
+  static LRUCache cache(object_num * object_size);
+  static bool populated = [] {
+    for (uint64_t i = 0; i < object_num; ++i) {
+      auto object = std::calloc(1, object_size);
+      if (!cache.insert(object_key(i), object, object_size).ok())
+        return false;
+    }
+    return true;
+  }();
+  if (!populated) {
+    state.SkipWithError("Cannot populate cache");
+    return;
+  }
+
+  // The keys are built outside the measured loop
+  std::vector<std::string> keys(object_num);
+  for (uint64_t i = 0; i < object_num; ++i)
+    keys[i] = object_key(i);
+
+  auto gen = thread_gen();
+  Buffer buff;
+  bool success;
+  for (auto _ : state) {
+    buff.reset_size();
+    if (!cache.read(keys[gen() % object_num], &buff, &success).ok() ||
+        !success) {
+      state.SkipWithError("Cannot read from cache");
+      break;
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * object_size);
+}
+
+/**
+ * Inserts new objects into a full cache, evicting the oldest ones. The
+ * allocation of each object is measured along with its insertion, as on
+ * a read caching a tile.
+ */
+void lru_cache_insert(benchmark::State& state) {
+  static LRUCache cache(object_num * object_size);
+  static std::atomic<uint64_t> next_id(0);
+
+  for (auto _ : state) {
+    auto object = std::malloc(object_size);
+    if (!cache.insert(object_key(next_id++), object, object_size).ok()) {
+      state.SkipWithError("Cannot insert into cache");
+      break;
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * object_size);
+}
+
+}  // namespace
+
+BENCHMARK(lru_cache_read)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(lru_cache_insert)->ThreadRange(1, 8)->UseRealTime();
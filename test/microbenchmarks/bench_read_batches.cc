@@ -0,0 +1,79 @@
+/**
+ * @file bench_read_batches.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * @section DESCRIPTION
+ *
+ * Microbenchmarks of the VFS read batching, grouping the tile regions of a
+ * read into batched reads.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "tiledb/sm/filesystem/vfs.h"
+#include "tiledb/sm/misc/uri.h"
+
+#include <random>
+#include <tuple>
+#include <vector>
+
+using namespace tiledb::sm;
+
+namespace {
+
+/**
+ * Groups ``state.range(0)`` regions into batches. The regions are tiles of
+ * 1KB to 64KB in file order, separated by gaps of up to 1MB, so that some
+ * are merged and some are not under the default batching parameters.
+ */
+void vfs_compute_read_batches(benchmark::State& state) {
+  auto num = (uint64_t)state.range(0);
+  std::minstd_rand gen(0);
+  std::vector<std::tuple<uint64_t, void*, uint64_t>> regions;
+  regions.reserve(num);
+  uint64_t offset = 0;
+  for (uint64_t i = 0; i < num; ++i) {
+    uint64_t nbytes = 1024 + gen() % (63 * 1024);
+    regions.emplace_back(offset, nullptr, nbytes);
+    offset += nbytes + gen() % (1024 * 1024);
+  }
+
+  VFS vfs;
+  URI uri("file:///tiledb_microbenchmark");
+  std::vector<VFS::BatchedRead> batches;
+  for (auto _ : state) {
+    batches.clear();
+    if (!vfs.compute_read_batches(uri, regions, &batches).ok()) {
+      state.SkipWithError("Cannot compute read batches");
+      break;
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num);
+  state.counters["batches"] = (double)batches.size();
+}
+
+}  // namespace
+
+BENCHMARK(vfs_compute_read_batches)->RangeMultiplier(8)->Range(1 << 6, 1 << 15);
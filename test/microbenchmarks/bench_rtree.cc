@@ -0,0 +1,110 @@
+/**
+ * @file bench_rtree.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * @section DESCRIPTION
+ *
+ * Microbenchmarks of the R-tree tile overlap computation, querying ranges of
+ * increasing size on the R-tree of a grid of 2D tiles.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "tiledb/sm/enums/datatype.h"
+#include "tiledb/sm/misc/constants.h"
+#include "tiledb/sm/rtree/rtree.h"
+
+#include <random>
+
+using namespace tiledb::sm;
+
+namespace {
+
+/** The number of tiles along each dimension of the grid. */
+const int64_t grid_tiles = 256;
+
+/** The extent of each tile along each dimension. */
+const int64_t tile_extent = 100;
+
+/**
+ * Builds the R-tree of a ``grid_tiles x grid_tiles`` grid of tiles, with
+ * the MBRs in row-major order.
+ */
+RTree build_rtree(bool str_packing) {
+  std::vector<int64_t> mbr_data;
+  mbr_data.reserve(grid_tiles * grid_tiles * 4);
+  for (int64_t r = 0; r < grid_tiles; ++r) {
+    for (int64_t c = 0; c < grid_tiles; ++c) {
+      mbr_data.push_back(r * tile_extent);
+      mbr_data.push_back((r + 1) * tile_extent - 1);
+      mbr_data.push_back(c * tile_extent);
+      mbr_data.push_back((c + 1) * tile_extent - 1);
+    }
+  }
+
+  std::vector<void*> mbrs(grid_tiles * grid_tiles);
+  for (size_t i = 0; i < mbrs.size(); ++i)
+    mbrs[i] = &mbr_data[4 * i];
+
+  return RTree(
+      Datatype::INT64, 2, constants::rtree_fanout, mbrs, str_packing);
+}
+
+/**
+ * Computes the tile overlap of random square ranges, whose side spans
+ * ``state.range(0)`` tiles and which are not aligned to the tiles.
+ */
+void rtree_get_tile_overlap(benchmark::State& state, bool str_packing) {
+  auto rtree = build_rtree(str_packing);
+  const int64_t side = state.range(0) * tile_extent;
+  const int64_t domain_size = grid_tiles * tile_extent;
+
+  std::minstd_rand gen(0);
+  std::uniform_int_distribution<int64_t> dist(0, domain_size - side);
+  int64_t r[2], c[2];
+  std::vector<const int64_t*> range = {r, c};
+  uint64_t tile_num = 0;
+  for (auto _ : state) {
+    r[0] = dist(gen);
+    r[1] = r[0] + side - 1;
+    c[0] = dist(gen);
+    c[1] = c[0] + side - 1;
+    auto overlap = rtree.get_tile_overlap<int64_t>(range);
+    tile_num += overlap.tiles_.size() + overlap.tile_ranges_.size();
+    benchmark::DoNotOptimize(overlap);
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.counters["overlaps"] =
+      benchmark::Counter(tile_num, benchmark::Counter::kAvgIterations);
+}
+
+}  // namespace
+
+BENCHMARK_CAPTURE(rtree_get_tile_overlap, bulk, false)
+    ->RangeMultiplier(4)
+    ->Range(1, 256);
+BENCHMARK_CAPTURE(rtree_get_tile_overlap, str, true)
+    ->RangeMultiplier(4)
+    ->Range(1, 256);
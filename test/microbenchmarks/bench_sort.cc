@@ -0,0 +1,190 @@
+/**
+ * @file bench_sort.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * @section DESCRIPTION
+ *
+ * Microbenchmarks of the coordinate sorts, sorting random 2D coordinates in
+ * the global order on write and in the global and row-major orders on read.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "tiledb/sm/array_schema/array_schema.h"
+#include "tiledb/sm/array_schema/dimension.h"
+#include "tiledb/sm/array_schema/domain.h"
+#include "tiledb/sm/buffer/buffer.h"
+#include "tiledb/sm/enums/array_type.h"
+#include "tiledb/sm/enums/datatype.h"
+#include "tiledb/sm/enums/layout.h"
+#include "tiledb/sm/query/reader.h"
+#include "tiledb/sm/query/result_coords.h"
+#include "tiledb/sm/query/result_tile.h"
+#include "tiledb/sm/query/writer.h"
+#include "tiledb/sm/tile/tile.h"
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <random>
+
+using namespace tiledb::sm;
+
+namespace {
+
+/** The upper bound of the domain of both dimensions. */
+const int64_t domain_max = (1 << 20) - 1;
+
+/** The tile extent of both dimensions. */
+const int64_t tile_extent = 1024;
+
+/** The number of cells in each result tile on read. */
+const uint64_t tile_capacity = 10000;
+
+/** Creates a sparse 2D ``int64`` array schema with the input cell order. */
+std::unique_ptr<ArraySchema> create_schema(Layout cell_order) {
+  const int64_t domain[] = {0, domain_max};
+  Dimension d1("d1", Datatype::INT64);
+  Dimension d2("d2", Datatype::INT64);
+  Domain dom(Datatype::INT64);
+  for (auto d : {&d1, &d2}) {
+    if (!d->set_domain(domain).ok() || !d->set_tile_extent(&tile_extent).ok() ||
+        !dom.add_dimension(d).ok())
+      return nullptr;
+  }
+
+  std::unique_ptr<ArraySchema> schema(new ArraySchema(ArrayType::SPARSE));
+  schema->set_cell_order(cell_order);
+  schema->set_tile_order(Layout::ROW_MAJOR);
+  if (!schema->set_domain(&dom).ok() || !schema->init().ok())
+    return nullptr;
+  return schema;
+}
+
+/** Returns ``num`` random coordinates in the domain. */
+std::vector<int64_t> random_coords(uint64_t num, unsigned seed) {
+  std::minstd_rand gen(seed);
+  std::uniform_int_distribution<int64_t> dist(0, domain_max);
+  std::vector<int64_t> coords(num);
+  for (auto& c : coords)
+    c = dist(gen);
+  return coords;
+}
+
+/**
+ * Sorts ``state.range(0)`` random coordinates in the global order of an
+ * array with the input cell order, as on an unordered write.
+ */
+void writer_sort_coords(benchmark::State& state, Layout cell_order) {
+  auto schema = create_schema(cell_order);
+  if (schema == nullptr) {
+    state.SkipWithError("Cannot create array schema");
+    return;
+  }
+
+  auto num = (uint64_t)state.range(0);
+  auto d1 = random_coords(num, 1), d2 = random_coords(num, 2);
+  uint64_t size = num * sizeof(int64_t);
+  Writer writer;
+  writer.set_array_schema(schema.get());
+  if (!writer.set_buffer("d1", &d1[0], &size).ok() ||
+      !writer.set_buffer("d2", &d2[0], &size).ok()) {
+    state.SkipWithError("Cannot set the coordinate buffers");
+    return;
+  }
+
+  std::vector<uint64_t> cell_pos;
+  for (auto _ : state) {
+    if (!writer.sort_coords(&cell_pos).ok()) {
+      state.SkipWithError("Cannot sort coordinates");
+      break;
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * 2 * size);
+}
+
+/**
+ * Sorts ``state.range(0)`` random result coordinates, spread over result
+ * tiles, in the input layout, as on a sparse read.
+ */
+void reader_sort_result_coords(benchmark::State& state, Layout layout) {
+  auto schema = create_schema(Layout::ROW_MAJOR);
+  if (schema == nullptr) {
+    state.SkipWithError("Cannot create array schema");
+    return;
+  }
+
+  // Populate the coordinate tiles and the result coordinates
+  auto num = (uint64_t)state.range(0);
+  auto d1 = random_coords(num, 1), d2 = random_coords(num, 2);
+  std::deque<Buffer> buffers;
+  std::deque<ResultTile> result_tiles;
+  std::vector<ResultCoords> coords;
+  for (uint64_t start = 0; start < num; start += tile_capacity) {
+    auto cell_num = std::min(tile_capacity, num - start);
+    result_tiles.emplace_back(0, result_tiles.size(), schema->domain());
+    auto& result_tile = result_tiles.back();
+    int64_t* data[] = {&d1[start], &d2[start]};
+    for (unsigned d = 0; d < 2; ++d) {
+      const auto& name = schema->dimension(d)->name();
+      buffers.emplace_back(data[d], cell_num * sizeof(int64_t));
+      result_tile.init_coord_tile(name, d);
+      result_tile.tile_pair(name)->first = Tile(
+          Datatype::INT64, sizeof(int64_t), 0, &buffers.back(), false);
+    }
+    for (uint64_t i = 0; i < cell_num; ++i)
+      coords.emplace_back(&result_tile, i);
+  }
+  std::shuffle(coords.begin(), coords.end(), std::minstd_rand(0));
+
+  Reader reader;
+  reader.set_array_schema(schema.get());
+  std::vector<ResultCoords> sorted;
+  for (auto _ : state) {
+    state.PauseTiming();
+    sorted = coords;
+    state.ResumeTiming();
+
+    if (!reader.sort_result_coords(&sorted, layout).ok()) {
+      state.SkipWithError("Cannot sort result coordinates");
+      break;
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * 2 * num * sizeof(int64_t));
+}
+
+}  // namespace
+
+/** Registers a sort benchmark on 16K, 128K and 1M coordinates. */
+#define BENCHMARK_SORT(func, name, layout) \
+  BENCHMARK_CAPTURE(func, name, layout)    \
+      ->RangeMultiplier(8)                 \
+      ->Range(1 << 14, 1 << 20)            \
+      ->Unit(benchmark::kMillisecond)
+
+BENCHMARK_SORT(writer_sort_coords, row_major, Layout::ROW_MAJOR);
+BENCHMARK_SORT(writer_sort_coords, hilbert, Layout::HILBERT);
+BENCHMARK_SORT(reader_sort_result_coords, row_major, Layout::ROW_MAJOR);
+BENCHMARK_SORT(reader_sort_result_coords, global_order, Layout::GLOBAL_ORDER);
@@ -445,3 +445,82 @@ TEST_CASE_METHOD(
 
   close_array(ctx_, array_);
 }
+
+TEST_CASE_METHOD(
+    CellSlabIterFx,
+    "CellSlabIter: Test 3D slabs",
+    "[CellSlabIter][slabs][3d]") {
+  // Create array
+  uint64_t domain[] = {1, 4};
+  uint64_t tile_extent = 2;
+  create_array(
+      ctx_,
+      array_name_,
+      TILEDB_DENSE,
+      {"d1", "d2", "d3"},
+      {TILEDB_UINT64, TILEDB_UINT64, TILEDB_UINT64},
+      {domain, domain, domain},
+      {&tile_extent, &tile_extent, &tile_extent},
+      {"a", "b"},
+      {TILEDB_INT32, TILEDB_INT32},
+      {1, TILEDB_VAR_NUM},
+      {tiledb::test::Compressor(TILEDB_FILTER_LZ4, -1),
+       tiledb::test::Compressor(TILEDB_FILTER_LZ4, -1)},
+      TILEDB_ROW_MAJOR,
+      TILEDB_ROW_MAJOR,
+      2);
+
+  Layout subarray_layout = Layout::ROW_MAJOR;
+  std::vector<CellSlab<uint64_t>> c_cell_slabs;
+  uint64_t tile_coords_0_0_0[] = {0, 0, 0};
+  uint64_t tile_coords_0_0_1[] = {0, 0, 1};
+  uint64_t tile_coords_1_0_0[] = {1, 0, 0};
+  uint64_t tile_coords_1_0_1[] = {1, 0, 1};
+
+  SECTION("- row-major") {
+    subarray_layout = Layout::ROW_MAJOR;
+    c_cell_slabs = {
+        CellSlab<uint64_t>(tile_coords_0_0_0, {1, 1, 2}, 1),
+        CellSlab<uint64_t>(tile_coords_0_0_1, {1, 1, 3}, 1),
+        CellSlab<uint64_t>(tile_coords_0_0_0, {1, 2, 2}, 1),
+        CellSlab<uint64_t>(tile_coords_0_0_1, {1, 2, 3}, 1),
+        CellSlab<uint64_t>(tile_coords_0_0_0, {2, 1, 2}, 1),
+        CellSlab<uint64_t>(tile_coords_0_0_1, {2, 1, 3}, 1),
+        CellSlab<uint64_t>(tile_coords_0_0_0, {2, 2, 2}, 1),
+        CellSlab<uint64_t>(tile_coords_0_0_1, {2, 2, 3}, 1),
+        CellSlab<uint64_t>(tile_coords_1_0_0, {3, 1, 2}, 1),
+        CellSlab<uint64_t>(tile_coords_1_0_1, {3, 1, 3}, 1),
+        CellSlab<uint64_t>(tile_coords_1_0_0, {3, 2, 2}, 1),
+        CellSlab<uint64_t>(tile_coords_1_0_1, {3, 2, 3}, 1),
+    };
+  }
+
+  SECTION("- col-major") {
+    subarray_layout = Layout::COL_MAJOR;
+    c_cell_slabs = {
+        CellSlab<uint64_t>(tile_coords_0_0_0, {1, 1, 2}, 2),
+        CellSlab<uint64_t>(tile_coords_1_0_0, {3, 1, 2}, 1),
+        CellSlab<uint64_t>(tile_coords_0_0_0, {1, 2, 2}, 2),
+        CellSlab<uint64_t>(tile_coords_1_0_0, {3, 2, 2}, 1),
+        CellSlab<uint64_t>(tile_coords_0_0_1, {1, 1, 3}, 2),
+        CellSlab<uint64_t>(tile_coords_1_0_1, {3, 1, 3}, 1),
+        CellSlab<uint64_t>(tile_coords_0_0_1, {1, 2, 3}, 2),
+        CellSlab<uint64_t>(tile_coords_1_0_1, {3, 2, 3}, 1),
+    };
+  }
+
+  open_array(ctx_, array_, TILEDB_READ);
+
+  Subarray subarray;
+  SubarrayRanges<uint64_t> ranges = {
+      {1, 3},
+      {1, 2},
+      {2, 3},
+  };
+  create_subarray(array_->array_, ranges, subarray_layout, &subarray);
+  subarray.compute_tile_coords<uint64_t>();
+
+  check_iter<uint64_t>(subarray, c_cell_slabs);
+
+  close_array(ctx_, array_);
+}
@@ -0,0 +1,101 @@
+/**
+ * @file unit-ReadCostModel.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * Tests the `ReadCostModel` class.
+ */
+
+#include "catch.hpp"
+#include "tiledb/sm/filesystem/read_cost_model.h"
+#include "tiledb/sm/misc/constants.h"
+
+using namespace tiledb::sm;
+
+TEST_CASE(
+    "ReadCostModel: Test batch gap estimate", "[read-cost-model][vfs]") {
+  ReadCostModel model;
+  uint64_t gap = 0;
+
+  // Nothing is known before enough reads have been observed
+  CHECK(!model.batch_gap(1 << 30, &gap));
+  for (uint64_t i = 1; i < constants::read_cost_model_min_samples; ++i)
+    model.record(i * 1000, 0.01 + i * 1000 * 1e-8);
+  CHECK(!model.batch_gap(1 << 30, &gap));
+
+  // 10ms latency at 100MB/s: the break-even gap is 1MB
+  model.record(1000000, 0.01 + 1000000 * 1e-8);
+  CHECK(model.num_samples() == constants::read_cost_model_min_samples);
+  CHECK(model.latency() == Approx(0.01));
+  CHECK(model.seconds_per_byte() == Approx(1e-8));
+  REQUIRE(model.batch_gap(1 << 30, &gap));
+  CHECK(gap == Approx(1000000).epsilon(0.001));
+
+  // The estimate is capped
+  REQUIRE(model.batch_gap(4096, &gap));
+  CHECK(gap == 4096);
+
+  model.reset();
+  CHECK(model.num_samples() == 0);
+  CHECK(!model.batch_gap(1 << 30, &gap));
+}
+
+TEST_CASE(
+    "ReadCostModel: Test degenerate samples", "[read-cost-model][vfs]") {
+  ReadCostModel model;
+  uint64_t gap = 0;
+
+  SECTION("- same size") {
+    // The slope cannot be fitted
+    for (uint64_t i = 0; i < 2 * constants::read_cost_model_min_samples; ++i)
+      model.record(4096, 0.001);
+    CHECK(!model.batch_gap(1 << 30, &gap));
+  }
+
+  SECTION("- no latency") {
+    for (uint64_t i = 1; i <= 2 * constants::read_cost_model_min_samples; ++i)
+      model.record(i * 4096, i * 4096 * 1e-9);
+    REQUIRE(model.batch_gap(1 << 30, &gap));
+    CHECK(gap == 0);
+  }
+
+  SECTION("- no transfer cost") {
+    for (uint64_t i = 1; i <= 2 * constants::read_cost_model_min_samples; ++i)
+      model.record(i * 4096, 0.005);
+    REQUIRE(model.batch_gap(1 << 30, &gap));
+    CHECK(gap == 1 << 30);
+  }
+
+  SECTION("- recent samples dominate") {
+    for (uint64_t i = 1; i <= 200; ++i)
+      model.record(i * 4096, 0.1 + i * 4096 * 1e-8);
+    for (uint64_t i = 1; i <= 200; ++i)
+      model.record(i * 4096, 0.001 + i * 4096 * 1e-8);
+    REQUIRE(model.batch_gap(1 << 30, &gap));
+    CHECK(gap < 1000000);
+  }
+}
@@ -32,6 +32,8 @@
 
 #include "test/src/helpers.h"
 #include "tiledb/sm/c_api/tiledb_struct_def.h"
+#include "tiledb/sm/fragment/fragment_metadata.h"
+#include "tiledb/sm/rtree/rtree.h"
 #include "tiledb/sm/subarray/subarray_partitioner.h"
 
 #ifdef _WIN32
@@ -327,3 +329,121 @@ TEST_CASE_METHOD(
 
   close_array(ctx_, array_);
 }
+
+TEST_CASE_METHOD(
+    SubarrayFx,
+    "Subarray: Test normalize ranges",
+    "[Subarray][2d][normalize_ranges]") {
+  uint64_t domain[] = {1, 10};
+  uint64_t tile_extent = 2;
+  create_array(
+      ctx_,
+      array_name_,
+      TILEDB_SPARSE,
+      {"d1", "d2"},
+      {TILEDB_UINT64, TILEDB_UINT64},
+      {domain, domain},
+      {&tile_extent, &tile_extent},
+      {"a"},
+      {TILEDB_INT32},
+      {1},
+      {tiledb::test::Compressor(TILEDB_FILTER_NONE, -1)},
+      TILEDB_ROW_MAJOR,
+      TILEDB_ROW_MAJOR,
+      2);
+
+  open_array(ctx_, array_, TILEDB_READ);
+
+  Subarray subarray;
+  Layout subarray_layout = Layout::ROW_MAJOR;
+
+  SECTION("- Disjoint ranges") {
+    SubarrayRanges<uint64_t> ranges = {{9, 9, 3, 4, 1, 1, 6, 7, 5, 5},
+                                       {2, 2}};
+    create_subarray(array_->array_, ranges, subarray_layout, &subarray);
+    CHECK(!subarray.has_sorted_disjoint_ranges<uint64_t>());
+    CHECK(subarray.normalize_ranges().ok());
+    CHECK(subarray.has_sorted_disjoint_ranges<uint64_t>());
+    SubarrayRanges<uint64_t> c_ranges = {{1, 1, 3, 7, 9, 9}, {2, 2}};
+    check_subarray<uint64_t>(subarray, c_ranges);
+  }
+
+  SECTION("- Overlapping ranges") {
+    SubarrayRanges<uint64_t> ranges = {{5, 8, 1, 2}, {6, 9, 2, 6}};
+    create_subarray(array_->array_, ranges, subarray_layout, &subarray);
+    CHECK(subarray.normalize_ranges().ok());
+    CHECK(!subarray.has_sorted_disjoint_ranges<uint64_t>());
+    check_subarray<uint64_t>(subarray, ranges);
+  }
+
+  close_array(ctx_, array_);
+}
+
+TEST_CASE_METHOD(
+    SubarrayFx,
+    "Subarray: Test tile overlap with the fragment index",
+    "[Subarray][1d][tile_overlap][fragment_index]") {
+  uint64_t domain[] = {1, 100};
+  uint64_t tile_extent = 10;
+  create_array(
+      ctx_,
+      array_name_,
+      TILEDB_SPARSE,
+      {"d"},
+      {TILEDB_UINT64},
+      {domain},
+      {&tile_extent},
+      {"a"},
+      {TILEDB_INT32},
+      {1},
+      {tiledb::test::Compressor(TILEDB_FILTER_NONE, -1)},
+      TILEDB_ROW_MAJOR,
+      TILEDB_ROW_MAJOR,
+      2);
+
+  // Write fragments with disjoint non-empty domains
+  const uint64_t fragment_num = 10;
+  for (uint64_t f = 0; f < fragment_num; ++f) {
+    tiledb::test::QueryBuffers buffers;
+    std::vector<uint64_t> coords = {10 * f + 1, 10 * f + 3, 10 * f + 5};
+    std::vector<int> a = {1, 2, 3};
+    buffers[TILEDB_COORDS] = tiledb::test::QueryBuffer(
+        {&coords[0], coords.size() * sizeof(uint64_t), nullptr, 0});
+    buffers["a"] =
+        tiledb::test::QueryBuffer({&a[0], a.size() * sizeof(int), nullptr, 0});
+    write_array(ctx_, array_name_, TILEDB_UNORDERED, buffers);
+  }
+
+  open_array(ctx_, array_, TILEDB_READ);
+
+  auto meta = array_->array_->fragment_metadata();
+  REQUIRE(meta.size() == fragment_num);
+  auto fragment_index = array_->array_->fragment_index();
+  REQUIRE(fragment_index != nullptr);
+  CHECK(fragment_index->leaf_num() == fragment_num);
+
+  Subarray subarray;
+  SubarrayRanges<uint64_t> ranges = {{4, 12, 33, 33, 50, 55, 97, 100}};
+  Layout subarray_layout = Layout::ROW_MAJOR;
+  create_subarray(array_->array_, ranges, subarray_layout, &subarray);
+  CHECK(subarray.compute_tile_overlap().ok());
+
+  // Only the fragments intersecting a range have a tile overlap
+  const auto& tile_overlap = subarray.tile_overlap();
+  REQUIRE(tile_overlap.size() == fragment_num);
+  for (uint64_t f = 0; f < fragment_num; ++f) {
+    auto non_empty_domain = (const uint64_t*)meta[f]->non_empty_domain();
+    REQUIRE(tile_overlap[f].size() == 4);
+    for (uint64_t r = 0; r < 4; ++r) {
+      auto range = &ranges[0][2 * r];
+      bool intersects =
+          range[0] <= non_empty_domain[1] && non_empty_domain[0] <= range[1];
+      const auto& overlap = tile_overlap[f][r];
+      CHECK(
+          intersects ==
+          (!overlap.tiles_.empty() || !overlap.tile_ranges_.empty()));
+    }
+  }
+
+  close_array(ctx_, array_);
+}
@@ -62,6 +62,7 @@ struct SubarrayPartitionerDenseFx {
   tiledb_array_t* array_ = nullptr;
   uint64_t memory_budget_ = 1024 * 1024 * 1024;
   uint64_t memory_budget_var_ = 1024 * 1024 * 1024;
+  bool balanced_splits_ = false;
 
   SubarrayPartitionerDenseFx();
   ~SubarrayPartitionerDenseFx();
@@ -263,6 +264,8 @@ void SubarrayPartitionerDenseFx::test_subarray_partitioner(
       subarray, memory_budget_, memory_budget_var_);
   auto st = subarray_partitioner.set_result_budget(attr.c_str(), budget);
   CHECK(st.ok());
+  st = subarray_partitioner.set_balanced_splits(balanced_splits_);
+  CHECK(st.ok());
 
   check_partitions(subarray_partitioner, partitions, unsplittable);
 }
@@ -416,6 +419,40 @@ TEST_CASE_METHOD(
   close_array(ctx_, array_);
 }
 
+TEST_CASE_METHOD(
+    SubarrayPartitionerDenseFx,
+    "SubarrayPartitioner (Dense): 1D, single-range, balanced splits",
+    "[SubarrayPartitioner][dense][1D][1R][balanced_splits]") {
+  Layout subarray_layout;
+  SubarrayRanges<uint64_t> ranges = {{2, 9}};
+  std::vector<SubarrayRanges<uint64_t>> partitions;
+  uint64_t budget = 4 * sizeof(int);
+  std::string attr = "a";
+  bool unsplittable = false;
+
+  create_default_1d_array(TILEDB_ROW_MAJOR, TILEDB_ROW_MAJOR);
+  write_default_1d_array();
+  open_array(ctx_, array_, TILEDB_READ);
+
+  // The midpoint splits fetch tile [5, 6] in two partitions
+  subarray_layout = Layout::ROW_MAJOR;
+  partitions = {{{2, 5}}, {{6, 9}}};
+  test_subarray_partitioner(
+      subarray_layout, ranges, partitions, attr, budget, unsplittable);
+
+  // The balanced splits fall on the space tile boundaries
+  balanced_splits_ = true;
+  partitions = {{{2, 4}}, {{5, 6}}, {{7, 9}}};
+  test_subarray_partitioner(
+      subarray_layout, ranges, partitions, attr, budget, unsplittable);
+
+  subarray_layout = Layout::UNORDERED;
+  test_subarray_partitioner(
+      subarray_layout, ranges, partitions, attr, budget, unsplittable);
+
+  close_array(ctx_, array_);
+}
+
 TEST_CASE_METHOD(
     SubarrayPartitionerDenseFx,
     "SubarrayPartitioner (Dense): 1D, single-range, unsplittable at once",
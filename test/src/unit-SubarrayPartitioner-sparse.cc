@@ -41,7 +41,9 @@
 #endif
 
 #include <catch.hpp>
+#include <algorithm>
 #include <iostream>
+#include <thread>
 
 using namespace tiledb::sm;
 using namespace tiledb::test;
@@ -62,6 +64,7 @@ struct SubarrayPartitionerSparseFx {
   tiledb_array_t* array_ = nullptr;
   uint64_t memory_budget_ = 1024 * 1024 * 1024;
   uint64_t memory_budget_var_ = 1024 * 1024 * 1024;
+  bool balanced_splits_ = false;
 
   SubarrayPartitionerSparseFx();
   ~SubarrayPartitionerSparseFx();
@@ -340,6 +343,8 @@ void SubarrayPartitionerSparseFx::test_subarray_partitioner(
       subarray, memory_budget_, memory_budget_var_);
   auto st = subarray_partitioner.set_result_budget(attr.c_str(), budget);
   CHECK(st.ok());
+  st = subarray_partitioner.set_balanced_splits(balanced_splits_);
+  CHECK(st.ok());
 
   check_partitions(subarray_partitioner, partitions, unsplittable);
 }
@@ -493,6 +498,36 @@ TEST_CASE_METHOD(
   close_array(ctx_, array_);
 }
 
+TEST_CASE_METHOD(
+    SubarrayPartitionerSparseFx,
+    "SubarrayPartitioner (Sparse): 1D, single-range, balanced splits",
+    "[SubarrayPartitioner][sparse][1D][1R][balanced_splits]") {
+  Layout subarray_layout;
+  SubarrayRanges<uint64_t> ranges = {{3, 30}};
+  std::vector<SubarrayRanges<uint64_t>> partitions;
+  uint64_t budget = 3 * sizeof(int);
+  std::string attr = "a";
+  bool unsplittable = false;
+
+  // The MBRs are [2, 4], [5, 10], [12, 18], [25, 27] and [33, 40]
+  create_default_1d_array(TILEDB_ROW_MAJOR, TILEDB_ROW_MAJOR);
+  write_default_1d_array_2();
+  open_array(ctx_, array_, TILEDB_READ);
+
+  // The balanced splits fall on the MBR upper bounds
+  balanced_splits_ = true;
+  subarray_layout = Layout::ROW_MAJOR;
+  partitions = {{{3, 4}}, {{5, 10}}, {{11, 18}}, {{19, 30}}};
+  test_subarray_partitioner(
+      subarray_layout, ranges, partitions, attr, budget, unsplittable);
+
+  subarray_layout = Layout::UNORDERED;
+  test_subarray_partitioner(
+      subarray_layout, ranges, partitions, attr, budget, unsplittable);
+
+  close_array(ctx_, array_);
+}
+
 TEST_CASE_METHOD(
     SubarrayPartitionerSparseFx,
     "SubarrayPartitioner (Sparse): 1D, single-range, unsplittable at once",
@@ -2133,3 +2168,123 @@ TEST_CASE_METHOD(
 
   close_array(ctx_, array_);
 }
+
+TEST_CASE_METHOD(
+    SubarrayPartitionerSparseFx,
+    "SubarrayPartitioner (Sparse): 2D, tile overlap derived from parent",
+    "[SubarrayPartitioner][sparse][2D][tile_overlap]") {
+  create_default_2d_array(TILEDB_ROW_MAJOR, TILEDB_ROW_MAJOR);
+  write_default_2d_array();
+  write_default_2d_array();
+  open_array(ctx_, array_, TILEDB_READ);
+
+  // Flattens a tile overlap into sorted (tile, ratio) pairs
+  auto flatten = [](const TileOverlap& overlap) {
+    std::vector<std::pair<uint64_t, double>> ret = overlap.tiles_;
+    for (const auto& tr : overlap.tile_ranges_) {
+      for (uint64_t tid = tr.first; tid <= tr.second; ++tid)
+        ret.emplace_back(tid, 1.0);
+    }
+    std::sort(ret.begin(), ret.end());
+    return ret;
+  };
+
+  SubarrayRanges<uint64_t> parent_ranges = {{1, 4}, {1, 10}};
+  SubarrayRanges<uint64_t> ranges = {{1, 2, 4, 4}, {2, 3, 5, 9}};
+  for (auto layout : {Layout::ROW_MAJOR, Layout::COL_MAJOR}) {
+    Subarray parent, derived, computed;
+    create_subarray(array_->array_, parent_ranges, layout, &parent);
+    create_subarray(array_->array_, ranges, layout, &derived);
+    create_subarray(array_->array_, ranges, layout, &computed);
+    CHECK(parent.compute_tile_overlap().ok());
+    CHECK(derived.compute_tile_overlap(parent).ok());
+    CHECK(computed.compute_tile_overlap().ok());
+
+    const auto& derived_overlap = derived.tile_overlap();
+    const auto& computed_overlap = computed.tile_overlap();
+    REQUIRE(derived_overlap.size() == 2);
+    REQUIRE(derived_overlap.size() == computed_overlap.size());
+    for (size_t f = 0; f < derived_overlap.size(); ++f) {
+      REQUIRE(derived_overlap[f].size() == 4);
+      REQUIRE(derived_overlap[f].size() == computed_overlap[f].size());
+      for (size_t r = 0; r < derived_overlap[f].size(); ++r) {
+        CHECK(
+            flatten(derived_overlap[f][r]) == flatten(computed_overlap[f][r]));
+      }
+    }
+  }
+
+  close_array(ctx_, array_);
+}
+
+TEST_CASE_METHOD(
+    SubarrayPartitionerSparseFx,
+    "SubarrayPartitioner (Sparse): 1D, enumerate partitions concurrently",
+    "[SubarrayPartitioner][sparse][1D][MR][concurrent]") {
+  SubarrayRanges<uint64_t> ranges = {{5, 10, 25, 27, 33, 40}};
+  std::vector<SubarrayRanges<uint64_t>> c_partitions = {
+      {{5, 7}},
+      {{8, 10}},
+      {{25, 26}},
+      {{27, 27}},
+      {{33, 36}},
+      {{37, 40}},
+  };
+  uint64_t budget = 2 * sizeof(int) - 1;
+
+  create_default_1d_array(TILEDB_ROW_MAJOR, TILEDB_ROW_MAJOR);
+  write_default_1d_array_2();
+  open_array(ctx_, array_, TILEDB_READ);
+
+  Subarray subarray;
+  create_subarray(array_->array_, ranges, Layout::UNORDERED, &subarray);
+
+  SECTION("- Up front") {
+    SubarrayPartitioner partitioner(
+        subarray, memory_budget_, memory_budget_var_);
+    CHECK(partitioner.set_result_budget("a", budget).ok());
+    std::vector<Subarray> partitions;
+    bool unsplittable;
+    CHECK(partitioner.partitions(&partitions, &unsplittable).ok());
+    CHECK(!unsplittable);
+    CHECK(partitioner.done());
+    REQUIRE(partitions.size() == c_partitions.size());
+    for (size_t i = 0; i < partitions.size(); ++i)
+      check_subarray<uint64_t>(partitions[i], c_partitions[i]);
+  }
+
+  SECTION("- Thread-safe iterator") {
+    SubarrayPartitioner partitioner(
+        subarray, memory_budget_, memory_budget_var_);
+    CHECK(partitioner.set_result_budget("a", budget).ok());
+
+    // Retrieve the partitions from several threads
+    std::mutex mtx;
+    std::vector<uint64_t> starts;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+      threads.emplace_back([&]() {
+        Subarray partition;
+        bool unsplittable;
+        while (true) {
+          auto st = partitioner.next(&partition, &unsplittable);
+          if (!st.ok() || unsplittable || partition.empty())
+            break;
+          const void* range;
+          partition.get_range(0, 0, &range);
+          std::lock_guard<std::mutex> lock(mtx);
+          starts.push_back(((const uint64_t*)range)[0]);
+        }
+      });
+    }
+    for (auto& thread : threads)
+      thread.join();
+
+    CHECK(partitioner.done());
+    std::sort(starts.begin(), starts.end());
+    std::vector<uint64_t> c_starts = {5, 8, 25, 27, 33, 37};
+    CHECK(starts == c_starts);
+  }
+
+  close_array(ctx_, array_);
+}
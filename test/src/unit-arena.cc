@@ -0,0 +1,80 @@
+/**
+ * @file unit-arena.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *
+ * This file unit-tests class Arena.
+ */
+
+#include "catch.hpp"
+#include "tiledb/sm/misc/arena.h"
+
+#include <cstring>
+#include <map>
+#include <vector>
+
+using namespace tiledb::sm;
+
+TEST_CASE("Arena: Test allocation", "[arena]") {
+  Arena arena(64);
+  CHECK(arena.allocated() == 0);
+
+  // Allocations are aligned and do not overlap
+  auto a = static_cast<char*>(arena.allocate(3, 1));
+  auto b = static_cast<char*>(arena.allocate(8, 8));
+  CHECK(reinterpret_cast<uintptr_t>(b) % 8 == 0);
+  CHECK((b >= a + 3 || b + 8 <= a));
+  CHECK(arena.allocated() == 11);
+
+  // Allocations larger than a block get a block of their own
+  auto c = static_cast<char*>(arena.allocate(1000, 16));
+  CHECK(reinterpret_cast<uintptr_t>(c) % 16 == 0);
+  std::memset(c, 1, 1000);
+
+  // The largest block is reused after a reset
+  arena.reset();
+  CHECK(arena.allocated() == 0);
+  auto d = static_cast<char*>(arena.allocate(1000, 16));
+  CHECK(d == c);
+}
+
+TEST_CASE("Arena: Test STL allocator", "[arena]") {
+  Arena arena;
+  ArenaAllocator<std::pair<const int, int>> alloc(&arena);
+  std::map<int, int, std::less<int>, decltype(alloc)> m(alloc);
+  for (int i = 0; i < 1000; ++i)
+    m[i] = 2 * i;
+  CHECK(m.size() == 1000);
+  CHECK(m[500] == 1000);
+  CHECK(arena.allocated() > 0);
+
+  ArenaAllocator<int> alloc2(&arena);
+  std::vector<int, ArenaAllocator<int>> v(alloc2);
+  for (int i = 0; i < 1000; ++i)
+    v.push_back(i);
+  CHECK(v[999] == 999);
+  CHECK(alloc == alloc2);
+}
@@ -0,0 +1,113 @@
+/**
+ * @file unit-bloom_filter.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * This file unit-tests class IndexCache.
+ * This file unit-tests class BloomFilter.
+ */
+
+#include "catch.hpp"
+#include "tiledb/sm/buffer/buffer.h"
+#include "tiledb/sm/buffer/const_buffer.h"
+#include "tiledb/sm/misc/bloom_filter.h"
+
+using namespace tiledb::sm;
+
+TEST_CASE("BloomFilter: Test empty filter", "[bloom_filter]") {
+  BloomFilter bloom_filter;
+  CHECK(bloom_filter.empty());
+  CHECK(bloom_filter.size() == 0);
+  CHECK(bloom_filter.may_contain(BloomFilter::hash_coords<int>(nullptr, 0)));
+}
+
+TEST_CASE(
+    "BloomFilter: Test no false negatives and false positive rate",
+    "[bloom_filter]") {
+  const uint64_t n = 10000;
+  BloomFilter bloom_filter(n, 10);
+  CHECK(!bloom_filter.empty());
+
+  int64_t coords[2];
+  for (uint64_t i = 0; i < n; ++i) {
+    coords[0] = (int64_t)i;
+    coords[1] = 2 * (int64_t)i;
+    bloom_filter.add(BloomFilter::hash_coords<int64_t>(coords, 2));
+  }
+
+  for (uint64_t i = 0; i < n; ++i) {
+    coords[0] = (int64_t)i;
+    coords[1] = 2 * (int64_t)i;
+    REQUIRE(
+        bloom_filter.may_contain(BloomFilter::hash_coords<int64_t>(coords, 2)));
+  }
+
+  // About 1% false positives are expected with 10 bits per hash
+  uint64_t false_positives = 0;
+  for (uint64_t i = 0; i < n; ++i) {
+    coords[0] = (int64_t)i;
+    coords[1] = 2 * (int64_t)i + 1;
+    if (bloom_filter.may_contain(BloomFilter::hash_coords<int64_t>(coords, 2)))
+      ++false_positives;
+  }
+  CHECK(false_positives < n / 40);
+}
+
+TEST_CASE("BloomFilter: Test serialization", "[bloom_filter]") {
+  BloomFilter bloom_filter(100, 10);
+  for (int i = 0; i < 100; ++i)
+    bloom_filter.add(BloomFilter::hash_coords<int>(&i, 1));
+
+  Buffer buff;
+  REQUIRE(bloom_filter.serialize(&buff).ok());
+
+  BloomFilter loaded;
+  ConstBuffer cbuff(buff.data(), buff.size());
+  REQUIRE(loaded.deserialize(&cbuff).ok());
+  CHECK(loaded.size() == bloom_filter.size());
+  for (int i = 0; i < 1000; ++i) {
+    auto hash = BloomFilter::hash_coords<int>(&i, 1);
+    CHECK(loaded.may_contain(hash) == bloom_filter.may_contain(hash));
+  }
+
+  // Truncated input
+  ConstBuffer truncated(buff.data(), buff.size() - 1);
+  CHECK(!BloomFilter().deserialize(&truncated).ok());
+}
+
+TEST_CASE("BloomFilter: Test coordinate hashes", "[bloom_filter]") {
+  double pos_zero[] = {0.0, 1.5};
+  double neg_zero[] = {-0.0, 1.5};
+  CHECK(
+      BloomFilter::hash_coords<double>(pos_zero, 2) ==
+      BloomFilter::hash_coords<double>(neg_zero, 2));
+
+  int a[] = {1, 2};
+  int b[] = {2, 1};
+  CHECK(
+      BloomFilter::hash_coords<int>(a, 2) !=
+      BloomFilter::hash_coords<int>(b, 2));
+}
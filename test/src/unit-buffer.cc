@@ -32,8 +32,10 @@
  */
 
 #include "tiledb/sm/buffer/buffer.h"
+#include "tiledb/sm/buffer/buffer_pool.h"
 
 #include <catch.hpp>
+#include <cstring>
 #include <iostream>
 
 using namespace tiledb::sm;
@@ -186,3 +188,63 @@ TEST_CASE("Buffer: Test move", "[buffer]") {
   CHECK(b.alloced_size() == 0);
   CHECK(b.data() == nullptr);
 }
+
+TEST_CASE("BufferPool: Test allocation and reuse", "[buffer][buffer-pool]") {
+  BufferPool pool;
+  uint64_t alloced = 0;
+
+  // A disabled pool allocates the exact size and keeps nothing
+  auto data = pool.allocate(100000, &alloced);
+  REQUIRE(data != nullptr);
+  CHECK(alloced == 100000);
+  pool.free(data, alloced);
+  CHECK(pool.cached() == 0);
+
+  // Large allocations are rounded up to a class and reused
+  pool.configure(1 << 20, false);
+  data = pool.allocate(100000, &alloced);
+  REQUIRE(data != nullptr);
+  CHECK(alloced >= 100000);
+  CHECK(alloced <= 125000);
+  pool.free(data, alloced);
+  CHECK(pool.cached() == alloced);
+  uint64_t alloced2 = 0;
+  auto data2 = pool.allocate(alloced - 1, &alloced2);
+  CHECK(data2 == data);
+  CHECK(alloced2 == alloced);
+  CHECK(pool.cached() == 0);
+
+  // Reallocation preserves the contents
+  std::memset(data2, 7, alloced2);
+  auto data3 = pool.reallocate(data2, alloced2, 300000, &alloced);
+  REQUIRE(data3 != nullptr);
+  CHECK(alloced >= 300000);
+  CHECK(static_cast<char*>(data3)[alloced2 - 1] == 7);
+  CHECK(pool.cached() == alloced2);
+
+  // Small allocations and allocations beyond the capacity are not kept
+  auto small = pool.allocate(100, &alloced2);
+  CHECK(alloced2 == 100);
+  pool.free(small, alloced2);
+  auto large = pool.allocate(2 << 20, &alloced2);
+  pool.free(large, alloced2);
+  pool.free(data3, alloced);
+  CHECK(pool.cached() <= (1 << 20));
+
+  pool.release();
+  CHECK(pool.cached() == 0);
+}
+
+TEST_CASE("Buffer: Test alignment", "[buffer]") {
+  Buffer small, large;
+  REQUIRE(small.realloc(100).ok());
+  REQUIRE(large.realloc(1 << 20).ok());
+  CHECK(reinterpret_cast<uintptr_t>(small.data()) % 64 == 0);
+  CHECK(reinterpret_cast<uintptr_t>(large.data()) % 4096 == 0);
+
+  // Growing a buffer keeps its contents and alignment
+  std::memset(small.data(), 3, 100);
+  REQUIRE(small.realloc(200000).ok());
+  CHECK(reinterpret_cast<uintptr_t>(small.data()) % 4096 == 0);
+  CHECK(static_cast<char*>(small.data())[99] == 3);
+}
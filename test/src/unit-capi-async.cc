@@ -35,6 +35,7 @@
 #include "tiledb/sm/c_api/tiledb.h"
 
 #include <cstring>
+#include <set>
 
 using namespace tiledb::test;
 
@@ -58,6 +59,7 @@ struct AsyncFx {
   void write_sparse_async();
   void write_sparse_async_cancelled();
   void read_dense_async();
+  void read_dense_async_tagged();
   void read_sparse_async();
   void remove_dense_array();
   void remove_sparse_array();
@@ -637,6 +639,82 @@ void AsyncFx::read_dense_async() {
   tiledb_query_free(&query);
 }
 
+void AsyncFx::read_dense_async_tagged() {
+  // Open array
+  tiledb_array_t* array;
+  int rc = tiledb_array_alloc(ctx_, DENSE_ARRAY_NAME, &array);
+  CHECK(rc == TILEDB_OK);
+  rc = tiledb_array_open(ctx_, array, TILEDB_READ);
+  CHECK(rc == TILEDB_OK);
+
+  // Nothing has been submitted yet
+  const uint32_t num_queries = 4;
+  void* tags[num_queries];
+  uint32_t num_tags = 1;
+  rc = tiledb_ctx_poll_completions(ctx_, tags, num_queries, 0, &num_tags);
+  CHECK(rc == TILEDB_OK);
+  CHECK(num_tags == 0);
+
+  // Submit one query per row, tagged with the query itself
+  int buffers_a1[num_queries][4];
+  uint64_t buffer_a1_sizes[num_queries];
+  tiledb_query_t* queries[num_queries];
+  for (uint32_t i = 0; i < num_queries; ++i) {
+    uint64_t subarray[] = {i + 1, i + 1, 1, 4};
+    buffer_a1_sizes[i] = sizeof(buffers_a1[i]);
+    rc = tiledb_query_alloc(ctx_, array, TILEDB_READ, &queries[i]);
+    CHECK(rc == TILEDB_OK);
+    rc = tiledb_query_set_layout(ctx_, queries[i], TILEDB_ROW_MAJOR);
+    CHECK(rc == TILEDB_OK);
+    rc = tiledb_query_set_subarray(ctx_, queries[i], subarray);
+    CHECK(rc == TILEDB_OK);
+    rc = tiledb_query_set_buffer(
+        ctx_, queries[i], "a1", buffers_a1[i], &buffer_a1_sizes[i]);
+    CHECK(rc == TILEDB_OK);
+    rc = tiledb_query_submit_async_tagged(ctx_, queries[i], queries[i]);
+    CHECK(rc == TILEDB_OK);
+  }
+
+  // Harvest the completions in batches
+  std::set<void*> harvested;
+  while (harvested.size() < num_queries) {
+    rc = tiledb_ctx_poll_completions(ctx_, tags, num_queries, -1, &num_tags);
+    CHECK(rc == TILEDB_OK);
+    CHECK(num_tags > 0);
+    for (uint32_t i = 0; i < num_tags; ++i) {
+      // The query status is final once its tag is harvested
+      tiledb_query_status_t status;
+      rc = tiledb_query_get_status(
+          ctx_, static_cast<tiledb_query_t*>(tags[i]), &status);
+      CHECK(rc == TILEDB_OK);
+      CHECK(status == TILEDB_COMPLETED);
+      CHECK(harvested.insert(tags[i]).second);
+    }
+  }
+
+  // Each tag is harvested once
+  rc = tiledb_ctx_poll_completions(ctx_, tags, num_queries, 10, &num_tags);
+  CHECK(rc == TILEDB_OK);
+  CHECK(num_tags == 0);
+
+  // Check buffers
+  int c_buffer_a1[][4] = {
+      {0, 1, 4, 5}, {2, 3, 6, 7}, {8, 9, 12, 13}, {10, 11, 14, 15}};
+  for (uint32_t i = 0; i < num_queries; ++i) {
+    CHECK(harvested.count(queries[i]) == 1);
+    CHECK(buffer_a1_sizes[i] == sizeof(c_buffer_a1[i]));
+    CHECK(!memcmp(buffers_a1[i], c_buffer_a1[i], sizeof(c_buffer_a1[i])));
+    tiledb_query_free(&queries[i]);
+  }
+
+  // Close array
+  rc = tiledb_array_close(ctx_, array);
+  CHECK(rc == TILEDB_OK);
+
+  // Clean up
+  tiledb_array_free(&array);
+}
+
 void AsyncFx::read_sparse_async() {
   // Open array
   tiledb_array_t* array;
@@ -783,6 +861,17 @@ TEST_CASE_METHOD(
   remove_dense_array();
 }
 
+TEST_CASE_METHOD(
+    AsyncFx,
+    "C API: Test async completion queue",
+    "[capi], [async], [dense-async], [completion-queue]") {
+  remove_dense_array();
+  create_dense_array();
+  write_dense_async();
+  read_dense_async_tagged();
+  remove_dense_array();
+}
+
 TEST_CASE_METHOD(
     AsyncFx, "C API: Test sparse async", "[capi], [async], [sparse-async]") {
   remove_sparse_array();
@@ -196,30 +196,92 @@ void check_save_to_file() {
   REQUIRE(rc == TILEDB_OK);
 
   std::stringstream ss;
+  ss << "rest.cache_ttl_ms 0\n";
   ss << "rest.http_compressor any\n";
+  ss << "rest.http_request_compressor none\n";
+  ss << "rest.read_partition_num 1\n";
   ss << "rest.server_address https://api.tiledb.com\n";
   ss << "rest.server_serialization_format CAPNP\n";
+  ss << "sm.array_manifest false\n";
+  ss << "sm.buffer_pool_huge_pages false\n";
+  ss << "sm.buffer_pool_size 0\n";
+  ss << "sm.capacity_target_tile_size 0\n";
   ss << "sm.check_coord_dups true\n";
   ss << "sm.check_coord_oob true\n";
   ss << "sm.check_global_order true\n";
   ss << "sm.consolidation.amplification 1.0\n";
+  ss << "sm.consolidation.auto_array_metadata_num 64\n";
+  ss << "sm.consolidation.auto_fragment_num 16\n";
+  ss << "sm.consolidation.auto_interval_ms 0\n";
   ss << "sm.consolidation.buffer_size 50000000\n";
+  ss << "sm.consolidation.deferred_vacuum false\n";
+  ss << "sm.consolidation.dry_run false\n";
+  ss << "sm.consolidation.memory_budget 0\n";
+  ss << "sm.consolidation.planner size_ratio\n";
+  ss << "sm.consolidation.planner_fragment_cost 1048576\n";
+  ss << "sm.consolidation.pyramid_levels 0\n";
+  ss << "sm.consolidation.pyramid_method mean\n";
   ss << "sm.consolidation.step_max_frags 4294967295\n";
   ss << "sm.consolidation.step_min_frags 4294967295\n";
   ss << "sm.consolidation.step_size_ratio 0.0\n";
   ss << "sm.consolidation.steps 4294967295\n";
+  ss << "sm.consolidation.tile_copy true\n";
+  ss << "sm.consolidation.timestamp_end 18446744073709551615\n";
+  ss << "sm.consolidation.timestamp_start 0\n";
+  ss << "sm.coords_bloom_filter_bits 0\n";
   ss << "sm.dedup_coords false\n";
+  ss << "sm.eager_metadata_load false\n";
+  ss << "sm.empty_subarray_cache_size 0\n";
   ss << "sm.enable_signal_handlers true\n";
+  ss << "sm.fragment_metadata_cache_size 10000000\n";
+  ss << "sm.fragment_metadata_speculative_read_size 65536\n";
+  ss << "sm.fragment_metadata_unfiltered false\n";
+  ss << "sm.fragment_packing_max_size 0\n";
+  ss << "sm.fragment_sketches false\n";
+  ss << "sm.index_cache_size 100000000\n";
   ss << "sm.memory_budget 5368709120\n";
   ss << "sm.memory_budget_var 10737418240\n";
   ss << "sm.num_async_threads 1\n";
+  ss << "sm.num_fragment_metadata_threads 0\n";
   ss << "sm.num_reader_threads 1\n";
+  ss << "sm.num_scheduler_threads 0\n";
   ss << "sm.num_tbb_threads -1\n";
   ss << "sm.num_writer_threads 1\n";
+  ss << "sm.numa_pinning false\n";
+  ss << "sm.partition_tile_cache_ratio 0.1\n";
+  ss << "sm.partitioner.balanced_splits false\n";
+  ss << "sm.read_planner none\n";
+  ss << "sm.read_prefetch false\n";
+  ss << "sm.rtree_str_packing false\n";
+  ss << "sm.stats.sample_rate 0.0\n";
+  ss << "sm.stats.sample_traces false\n";
+  ss << "sm.stats.slow_query_threshold_ms 0\n";
+  ss << "sm.tile_cache_mode unfiltered\n";
+  ss << "sm.tile_cache_policy lru\n";
+  ss << "sm.tile_cache_shards 8\n";
   ss << "sm.tile_cache_size 10000000\n";
+  ss << "sm.tile_disk_cache_size 1073741824\n";
+  ss << "sm.unordered_write_fragment_num 1\n";
+  ss << "sm.var_offsets.bitsize 64\n";
+  ss << "sm.var_offsets.extra_element false\n";
+  ss << "sm.var_offsets.mode bytes\n";
+  ss << "sm.write_async_flush false\n";
+  ss << "sm.write_buffer.max_age_ms 0\n";
+  ss << "sm.write_buffer.max_size 0\n";
+  ss << "vfs.adaptive_batch_gap false\n";
+  ss << "vfs.emulated_bandwidth 0\n";
+  ss << "vfs.emulated_latency_ms 0\n";
+  ss << "vfs.file.direct_io false\n";
   ss << "vfs.file.enable_filelocks true\n";
+  ss << "vfs.file.enable_mmap false\n";
+  ss << "vfs.file.enable_read_filelocks true\n";
+  ss << "vfs.file.io_engine pread\n";
   ss << "vfs.file.max_parallel_ops " << std::thread::hardware_concurrency()
      << "\n";
+  ss << "vfs.hdfs.max_parallel_ops " << std::thread::hardware_concurrency()
+     << "\n";
+  ss << "vfs.hdfs.short_circuit_read false\n";
+  ss << "vfs.hdfs.zero_copy_read false\n";
   ss << "vfs.min_batch_gap 512000\n";
   ss << "vfs.min_batch_size 20971520\n";
   ss << "vfs.min_parallel_size 10485760\n";
@@ -227,18 +289,23 @@ void check_save_to_file() {
   ss << "vfs.s3.connect_max_tries 5\n";
   ss << "vfs.s3.connect_scale_factor 25\n";
   ss << "vfs.s3.connect_timeout_ms 3000\n";
+  ss << "vfs.s3.hedge_max_ratio 0.05\n";
+  ss << "vfs.s3.hedge_percentile 0.0\n";
   ss << "vfs.s3.logging_level Off\n";
+  ss << "vfs.s3.max_buffer_size 0\n";
   ss << "vfs.s3.max_parallel_ops " << std::thread::hardware_concurrency()
      << "\n";
   ss << "vfs.s3.multipart_part_size 5242880\n";
   ss << "vfs.s3.proxy_port 0\n";
   ss << "vfs.s3.proxy_scheme https\n";
+  ss << "vfs.s3.read_part_size 0\n";
   ss << "vfs.s3.region us-east-1\n";
   ss << "vfs.s3.request_timeout_ms 3000\n";
   ss << "vfs.s3.scheme https\n";
   ss << "vfs.s3.use_multipart_upload true\n";
   ss << "vfs.s3.use_virtual_addressing true\n";
   ss << "vfs.s3.verify_ssl true\n";
+  ss << "vfs.write_behind_buffer_size 0\n";
 
   std::ifstream ifs("test_config.txt");
   std::stringstream ss_file;
@@ -394,32 +461,95 @@ TEST_CASE("C API: Test config iter", "[capi], [config]") {
   all_param_values["rest.server_address"] = "https://api.tiledb.com";
   all_param_values["rest.server_serialization_format"] = "CAPNP";
   all_param_values["rest.http_compressor"] = "any";
+  all_param_values["rest.http_request_compressor"] = "none";
+  all_param_values["rest.cache_ttl_ms"] = "0";
+  all_param_values["rest.read_partition_num"] = "1";
   all_param_values["sm.dedup_coords"] = "false";
   all_param_values["sm.check_coord_dups"] = "true";
   all_param_values["sm.check_coord_oob"] = "true";
   all_param_values["sm.check_global_order"] = "true";
   all_param_values["sm.tile_cache_size"] = "100";
+  all_param_values["sm.tile_cache_shards"] = "8";
+  all_param_values["sm.tile_cache_policy"] = "lru";
+  all_param_values["sm.tile_cache_mode"] = "unfiltered";
+  all_param_values["sm.tile_disk_cache_dir"] = "";
+  all_param_values["sm.tile_disk_cache_size"] = "1073741824";
+  all_param_values["sm.read_prefetch"] = "false";
+  all_param_values["sm.read_planner"] = "none";
+  all_param_values["sm.eager_metadata_load"] = "false";
+  all_param_values["sm.partitioner.balanced_splits"] = "false";
+  all_param_values["sm.partition_tile_cache_ratio"] = "0.1";
+  all_param_values["sm.write_async_flush"] = "false";
+  all_param_values["sm.write_buffer.max_size"] = "0";
+  all_param_values["sm.write_buffer.max_age_ms"] = "0";
+  all_param_values["sm.unordered_write_fragment_num"] = "1";
+  all_param_values["sm.capacity_target_tile_size"] = "0";
+  all_param_values["sm.fragment_metadata_cache_size"] = "10000000";
+  all_param_values["sm.fragment_metadata_speculative_read_size"] = "65536";
+  all_param_values["sm.fragment_metadata_unfiltered"] = "false";
+  all_param_values["sm.fragment_packing_max_size"] = "0";
+  all_param_values["sm.index_cache_size"] = "100000000";
+  all_param_values["sm.empty_subarray_cache_size"] = "0";
+  all_param_values["sm.var_offsets.bitsize"] = "64";
+  all_param_values["sm.var_offsets.extra_element"] = "false";
+  all_param_values["sm.var_offsets.mode"] = "bytes";
+  all_param_values["sm.coords_bloom_filter_bits"] = "0";
+  all_param_values["sm.rtree_str_packing"] = "false";
+  all_param_values["sm.fragment_sketches"] = "false";
+  all_param_values["sm.value_index_attributes"] = "";
+  all_param_values["sm.array_manifest"] = "false";
+  all_param_values["sm.buffer_pool_size"] = "0";
+  all_param_values["sm.buffer_pool_huge_pages"] = "false";
   all_param_values["sm.memory_budget"] = "5368709120";
   all_param_values["sm.memory_budget_var"] = "10737418240";
   all_param_values["sm.enable_signal_handlers"] = "true";
   all_param_values["sm.num_async_threads"] = "1";
   all_param_values["sm.num_reader_threads"] = "1";
   all_param_values["sm.num_writer_threads"] = "1";
+  all_param_values["sm.num_fragment_metadata_threads"] = "0";
+  all_param_values["sm.num_scheduler_threads"] = "0";
   all_param_values["sm.num_tbb_threads"] = "-1";
+  all_param_values["sm.numa_pinning"] = "false";
+  all_param_values["sm.stats.sample_rate"] = "0.0";
+  all_param_values["sm.stats.sample_traces"] = "false";
+  all_param_values["sm.stats.slow_query_threshold_ms"] = "0";
+  all_param_values["sm.stats.slow_query_log"] = "";
   all_param_values["sm.consolidation.amplification"] = "1.0";
   all_param_values["sm.consolidation.steps"] = "4294967295";
   all_param_values["sm.consolidation.step_min_frags"] = "4294967295";
   all_param_values["sm.consolidation.step_max_frags"] = "4294967295";
   all_param_values["sm.consolidation.buffer_size"] = "50000000";
   all_param_values["sm.consolidation.step_size_ratio"] = "0.0";
+  all_param_values["sm.consolidation.tile_copy"] = "true";
+  all_param_values["sm.consolidation.timestamp_start"] = "0";
+  all_param_values["sm.consolidation.timestamp_end"] = "18446744073709551615";
+  all_param_values["sm.consolidation.subarray"] = "";
+  all_param_values["sm.consolidation.memory_budget"] = "0";
+  all_param_values["sm.consolidation.planner"] = "size_ratio";
+  all_param_values["sm.consolidation.planner_fragment_cost"] = "1048576";
+  all_param_values["sm.consolidation.dry_run"] = "false";
+  all_param_values["sm.consolidation.deferred_vacuum"] = "false";
+  all_param_values["sm.consolidation.pyramid_levels"] = "0";
+  all_param_values["sm.consolidation.pyramid_method"] = "mean";
+  all_param_values["sm.consolidation.auto_interval_ms"] = "0";
+  all_param_values["sm.consolidation.auto_fragment_num"] = "16";
+  all_param_values["sm.consolidation.auto_array_metadata_num"] = "64";
   all_param_values["vfs.num_threads"] =
       std::to_string(std::thread::hardware_concurrency());
   all_param_values["vfs.min_batch_gap"] = "512000";
+  all_param_values["vfs.adaptive_batch_gap"] = "false";
   all_param_values["vfs.min_batch_size"] = "20971520";
+  all_param_values["vfs.write_behind_buffer_size"] = "0";
+  all_param_values["vfs.emulated_latency_ms"] = "0";
+  all_param_values["vfs.emulated_bandwidth"] = "0";
   all_param_values["vfs.min_parallel_size"] = "10485760";
   all_param_values["vfs.file.max_parallel_ops"] =
       std::to_string(std::thread::hardware_concurrency());
   all_param_values["vfs.file.enable_filelocks"] = "true";
+  all_param_values["vfs.file.enable_read_filelocks"] = "true";
+  all_param_values["vfs.file.io_engine"] = "pread";
+  all_param_values["vfs.file.enable_mmap"] = "false";
+  all_param_values["vfs.file.direct_io"] = "false";
   all_param_values["vfs.s3.scheme"] = "https";
   all_param_values["vfs.s3.region"] = "us-east-1";
   all_param_values["vfs.s3.aws_access_key_id"] = "";
@@ -431,6 +561,10 @@ TEST_CASE("C API: Test config iter", "[capi], [config]") {
   all_param_values["vfs.s3.max_parallel_ops"] =
       std::to_string(std::thread::hardware_concurrency());
   all_param_values["vfs.s3.multipart_part_size"] = "5242880";
+  all_param_values["vfs.s3.max_buffer_size"] = "0";
+  all_param_values["vfs.s3.read_part_size"] = "0";
+  all_param_values["vfs.s3.hedge_percentile"] = "0.0";
+  all_param_values["vfs.s3.hedge_max_ratio"] = "0.05";
   all_param_values["vfs.s3.ca_file"] = "";
   all_param_values["vfs.s3.ca_path"] = "";
   all_param_values["vfs.s3.connect_timeout_ms"] = "3000";
@@ -447,16 +581,29 @@ TEST_CASE("C API: Test config iter", "[capi], [config]") {
   all_param_values["vfs.hdfs.username"] = "stavros";
   all_param_values["vfs.hdfs.kerb_ticket_cache_path"] = "";
   all_param_values["vfs.hdfs.name_node_uri"] = "";
+  all_param_values["vfs.hdfs.max_parallel_ops"] =
+      std::to_string(std::thread::hardware_concurrency());
+  all_param_values["vfs.hdfs.short_circuit_read"] = "false";
+  all_param_values["vfs.hdfs.domain_socket_path"] = "";
+  all_param_values["vfs.hdfs.zero_copy_read"] = "false";
 
   std::map<std::string, std::string> vfs_param_values;
   vfs_param_values["num_threads"] =
       std::to_string(std::thread::hardware_concurrency());
   vfs_param_values["min_batch_gap"] = "512000";
+  vfs_param_values["adaptive_batch_gap"] = "false";
   vfs_param_values["min_batch_size"] = "20971520";
+  vfs_param_values["write_behind_buffer_size"] = "0";
+  vfs_param_values["emulated_latency_ms"] = "0";
+  vfs_param_values["emulated_bandwidth"] = "0";
   vfs_param_values["min_parallel_size"] = "10485760";
   vfs_param_values["file.max_parallel_ops"] =
       std::to_string(std::thread::hardware_concurrency());
   vfs_param_values["file.enable_filelocks"] = "true";
+  vfs_param_values["file.enable_read_filelocks"] = "true";
+  vfs_param_values["file.io_engine"] = "pread";
+  vfs_param_values["file.enable_mmap"] = "false";
+  vfs_param_values["file.direct_io"] = "false";
   vfs_param_values["s3.scheme"] = "https";
   vfs_param_values["s3.region"] = "us-east-1";
   vfs_param_values["s3.aws_access_key_id"] = "";
@@ -468,6 +615,10 @@ TEST_CASE("C API: Test config iter", "[capi], [config]") {
   vfs_param_values["s3.max_parallel_ops"] =
       std::to_string(std::thread::hardware_concurrency());
   vfs_param_values["s3.multipart_part_size"] = "5242880";
+  vfs_param_values["s3.max_buffer_size"] = "0";
+  vfs_param_values["s3.read_part_size"] = "0";
+  vfs_param_values["s3.hedge_percentile"] = "0.0";
+  vfs_param_values["s3.hedge_max_ratio"] = "0.05";
   vfs_param_values["s3.ca_file"] = "";
   vfs_param_values["s3.ca_path"] = "";
   vfs_param_values["s3.connect_timeout_ms"] = "3000";
@@ -484,6 +635,11 @@ TEST_CASE("C API: Test config iter", "[capi], [config]") {
   vfs_param_values["hdfs.username"] = "stavros";
   vfs_param_values["hdfs.kerb_ticket_cache_path"] = "";
   vfs_param_values["hdfs.name_node_uri"] = "";
+  vfs_param_values["hdfs.max_parallel_ops"] =
+      std::to_string(std::thread::hardware_concurrency());
+  vfs_param_values["hdfs.short_circuit_read"] = "false";
+  vfs_param_values["hdfs.domain_socket_path"] = "";
+  vfs_param_values["hdfs.zero_copy_read"] = "false";
 
   std::map<std::string, std::string> s3_param_values;
   s3_param_values["scheme"] = "https";
@@ -497,6 +653,10 @@ TEST_CASE("C API: Test config iter", "[capi], [config]") {
   s3_param_values["max_parallel_ops"] =
       std::to_string(std::thread::hardware_concurrency());
   s3_param_values["multipart_part_size"] = "5242880";
+  s3_param_values["max_buffer_size"] = "0";
+  s3_param_values["read_part_size"] = "0";
+  s3_param_values["hedge_percentile"] = "0.0";
+  s3_param_values["hedge_max_ratio"] = "0.05";
   s3_param_values["ca_file"] = "";
   s3_param_values["ca_path"] = "";
   s3_param_values["connect_timeout_ms"] = "3000";
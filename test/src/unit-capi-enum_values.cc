@@ -92,6 +92,7 @@ TEST_CASE("C API: Test enum values", "[capi], [enums]") {
   REQUIRE(TILEDB_COL_MAJOR == 1);
   REQUIRE(TILEDB_GLOBAL_ORDER == 2);
   REQUIRE(TILEDB_UNORDERED == 3);
+  REQUIRE(TILEDB_HILBERT == 4);
 
   /** Filter type */
   REQUIRE(TILEDB_FILTER_NONE == 0);
@@ -105,12 +106,18 @@ TEST_CASE("C API: Test enum values", "[capi], [enums]") {
   REQUIRE(TILEDB_FILTER_BITSHUFFLE == 8);
   REQUIRE(TILEDB_FILTER_BYTESHUFFLE == 9);
   REQUIRE(TILEDB_FILTER_POSITIVE_DELTA == 10);
+  REQUIRE(TILEDB_FILTER_DICTIONARY == 12);
+  REQUIRE(TILEDB_FILTER_FLOAT_XOR == 13);
+  REQUIRE(TILEDB_FILTER_FRAME_OF_REFERENCE == 14);
   REQUIRE((uint8_t)FilterType::INTERNAL_FILTER_AES_256_GCM == 11);
 
   /** Filter option */
   REQUIRE(TILEDB_COMPRESSION_LEVEL == 0);
   REQUIRE(TILEDB_BIT_WIDTH_MAX_WINDOW == 1);
   REQUIRE(TILEDB_POSITIVE_DELTA_MAX_WINDOW == 2);
+  REQUIRE(TILEDB_COMPRESSION_DICTIONARY_SIZE == 3);
+  REQUIRE(TILEDB_COMPRESSION_BYTESHUFFLE == 4);
+  REQUIRE(TILEDB_FRAME_OF_REFERENCE_DELTA == 5);
 
   /** Encryption type */
   REQUIRE(TILEDB_NO_ENCRYPTION == 0);
@@ -131,6 +138,29 @@ TEST_CASE("C API: Test enum values", "[capi], [enums]") {
   REQUIRE(TILEDB_VFS_READ == 0);
   REQUIRE(TILEDB_VFS_WRITE == 1);
   REQUIRE(TILEDB_VFS_APPEND == 2);
+
+  /** Query condition operator */
+  REQUIRE(TILEDB_LT == 0);
+  REQUIRE(TILEDB_LE == 1);
+  REQUIRE(TILEDB_GT == 2);
+  REQUIRE(TILEDB_GE == 3);
+  REQUIRE(TILEDB_EQ == 4);
+  REQUIRE(TILEDB_NE == 5);
+
+  /** Query condition combination operator */
+  REQUIRE(TILEDB_AND == 0);
+  REQUIRE(TILEDB_OR == 1);
+
+  /** Aggregate operator */
+  REQUIRE(TILEDB_AGGREGATE_COUNT == 0);
+  REQUIRE(TILEDB_AGGREGATE_SUM == 1);
+  REQUIRE(TILEDB_AGGREGATE_MIN == 2);
+  REQUIRE(TILEDB_AGGREGATE_MAX == 3);
+
+  /** Query priority */
+  REQUIRE(TILEDB_QUERY_PRIORITY_NORMAL == 0);
+  REQUIRE(TILEDB_QUERY_PRIORITY_HIGH == 1);
+  REQUIRE(TILEDB_QUERY_PRIORITY_LOW == 2);
 }
 
 TEST_CASE("C API: Test enum string conversion", "[capi], [enums]") {
@@ -332,6 +362,12 @@ TEST_CASE("C API: Test enum string conversion", "[capi], [enums]") {
   REQUIRE(
       (tiledb_layout_from_str("unordered", &layout) == TILEDB_OK &&
        layout == TILEDB_UNORDERED));
+  REQUIRE(
+      (tiledb_layout_to_str(TILEDB_HILBERT, &c_str) == TILEDB_OK &&
+       std::string(c_str) == "hilbert"));
+  REQUIRE(
+      (tiledb_layout_from_str("hilbert", &layout) == TILEDB_OK &&
+       layout == TILEDB_HILBERT));
 
   tiledb_filter_type_t filter_type;
   REQUIRE(
@@ -407,6 +443,28 @@ TEST_CASE("C API: Test enum string conversion", "[capi], [enums]") {
       (tiledb_filter_type_from_str("POSITIVE_DELTA", &filter_type) ==
            TILEDB_OK &&
        filter_type == TILEDB_FILTER_POSITIVE_DELTA));
+  REQUIRE(
+      (tiledb_filter_type_to_str(TILEDB_FILTER_DICTIONARY, &c_str) ==
+           TILEDB_OK &&
+       std::string(c_str) == "DICTIONARY"));
+  REQUIRE(
+      (tiledb_filter_type_from_str("DICTIONARY", &filter_type) == TILEDB_OK &&
+       filter_type == TILEDB_FILTER_DICTIONARY));
+  REQUIRE(
+      (tiledb_filter_type_to_str(TILEDB_FILTER_FLOAT_XOR, &c_str) ==
+           TILEDB_OK &&
+       std::string(c_str) == "FLOAT_XOR"));
+  REQUIRE(
+      (tiledb_filter_type_from_str("FLOAT_XOR", &filter_type) == TILEDB_OK &&
+       filter_type == TILEDB_FILTER_FLOAT_XOR));
+  REQUIRE(
+      (tiledb_filter_type_to_str(TILEDB_FILTER_FRAME_OF_REFERENCE, &c_str) ==
+           TILEDB_OK &&
+       std::string(c_str) == "FRAME_OF_REFERENCE"));
+  REQUIRE(
+      (tiledb_filter_type_from_str("FRAME_OF_REFERENCE", &filter_type) ==
+           TILEDB_OK &&
+       filter_type == TILEDB_FILTER_FRAME_OF_REFERENCE));
 
   tiledb_filter_option_t filter_option;
   REQUIRE(
@@ -433,6 +491,30 @@ TEST_CASE("C API: Test enum string conversion", "[capi], [enums]") {
       (tiledb_filter_option_from_str(
            "POSITIVE_DELTA_MAX_WINDOW", &filter_option) == TILEDB_OK &&
        filter_option == TILEDB_POSITIVE_DELTA_MAX_WINDOW));
+  REQUIRE(
+      (tiledb_filter_option_to_str(
+           TILEDB_COMPRESSION_DICTIONARY_SIZE, &c_str) == TILEDB_OK &&
+       std::string(c_str) == "COMPRESSION_DICTIONARY_SIZE"));
+  REQUIRE(
+      (tiledb_filter_option_from_str(
+           "COMPRESSION_DICTIONARY_SIZE", &filter_option) == TILEDB_OK &&
+       filter_option == TILEDB_COMPRESSION_DICTIONARY_SIZE));
+  REQUIRE(
+      (tiledb_filter_option_to_str(TILEDB_COMPRESSION_BYTESHUFFLE, &c_str) ==
+           TILEDB_OK &&
+       std::string(c_str) == "COMPRESSION_BYTESHUFFLE"));
+  REQUIRE(
+      (tiledb_filter_option_from_str(
+           "COMPRESSION_BYTESHUFFLE", &filter_option) == TILEDB_OK &&
+       filter_option == TILEDB_COMPRESSION_BYTESHUFFLE));
+  REQUIRE(
+      (tiledb_filter_option_to_str(TILEDB_FRAME_OF_REFERENCE_DELTA, &c_str) ==
+           TILEDB_OK &&
+       std::string(c_str) == "FRAME_OF_REFERENCE_DELTA"));
+  REQUIRE(
+      (tiledb_filter_option_from_str(
+           "FRAME_OF_REFERENCE_DELTA", &filter_option) == TILEDB_OK &&
+       filter_option == TILEDB_FRAME_OF_REFERENCE_DELTA));
 
   tiledb_encryption_type_t encryption_type;
   REQUIRE(
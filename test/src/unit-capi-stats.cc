@@ -32,8 +32,34 @@
 
 #include "catch.hpp"
 #include "tiledb/sm/c_api/tiledb.h"
+#include "tiledb/sm/misc/stats.h"
+#include "tiledb/sm/misc/thread_pool.h"
 
 #include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace tiledb::sm;
+
+namespace {
+
+/** A function timed with the stats macros. */
+Status timed_function() {
+  STATS_FUNC_IN(reader_read);
+  return Status::Ok();
+  STATS_FUNC_OUT(reader_read);
+}
+
+/** Returns the number of occurrences of `pattern` in `str`. */
+uint64_t occurrences(const std::string& str, const std::string& pattern) {
+  uint64_t num = 0;
+  for (auto pos = str.find(pattern); pos != std::string::npos;
+       pos = str.find(pattern, pos + 1))
+    ++num;
+  return num;
+}
+
+}  // namespace
 
 TEST_CASE("C API: Test stats", "[capi], [stats]") {
   REQUIRE(tiledb_stats_enable() == TILEDB_OK);
@@ -49,3 +75,178 @@ TEST_CASE("C API: Test stats", "[capi], [stats]") {
   REQUIRE(stats_str == nullptr);
   REQUIRE(tiledb_stats_disable() == TILEDB_OK);
 }
+
+TEST_CASE("Stats: Test counters from concurrent threads", "[stats]") {
+  auto& counter = stats::all_stats.counter_reader_num_attr_tiles_touched;
+  counter = 0;
+
+  // Every thread adds to the stripe assigned to it
+  const unsigned thread_num = 2 * stats::Counter::stripe_num + 1;
+  std::vector<std::thread> threads;
+  for (unsigned i = 0; i < thread_num; ++i) {
+    threads.emplace_back([&counter]() {
+      for (unsigned j = 0; j < 1000; ++j)
+        counter += 1;
+    });
+  }
+  for (auto& t : threads)
+    t.join();
+  CHECK(counter.load() == thread_num * 1000);
+
+  // Reset
+  counter = 0;
+  CHECK(counter.load() == 0);
+
+  // Max
+  counter.max(10);
+  counter.max(5);
+  CHECK(counter.load() == 10);
+  counter = 0;
+}
+
+TEST_CASE("Stats: Test query stats", "[stats]") {
+  stats::all_stats.set_enabled(true);
+  auto& global = stats::all_stats.counter_reader_num_attr_tiles_touched;
+  global = 0;
+
+  ThreadPool pool;
+  REQUIRE(pool.init(2).ok());
+  std::shared_ptr<stats::Statistics> query_stats(new stats::Statistics());
+  {
+    // The counters added in the scope and by the tasks enqueued in it are
+    // added to the query stats too
+    stats::QueryStatsScope stats_scope(query_stats.get());
+    STATS_COUNTER_ADD(reader_num_attr_tiles_touched, 1);
+    std::vector<std::future<Status>> tasks;
+    for (unsigned i = 0; i < 4; ++i) {
+      tasks.push_back(pool.enqueue([]() {
+        STATS_COUNTER_ADD(reader_num_attr_tiles_touched, 2);
+        return Status::Ok();
+      }));
+    }
+    CHECK(pool.wait_all(tasks).ok());
+  }
+  STATS_COUNTER_ADD(reader_num_attr_tiles_touched, 4);
+
+  CHECK(stats::query_stats() == nullptr);
+  CHECK(query_stats->counter_reader_num_attr_tiles_touched.load() == 9);
+  CHECK(global.load() == 13);
+
+  std::string json;
+  query_stats->dump(&json);
+  CHECK(
+      json.find("\"reader_num_attr_tiles_touched\", \"value\": 9") !=
+      std::string::npos);
+
+  global = 0;
+  stats::all_stats.set_enabled(false);
+}
+
+TEST_CASE("Stats: Test latency histograms", "[stats]") {
+  stats::Histogram histogram;
+  CHECK(histogram.count() == 0);
+  CHECK(histogram.quantile(0.5) == 0);
+
+  // Small values are counted exactly
+  for (uint64_t v = 1; v <= 8; ++v)
+    histogram.add(v);
+  CHECK(histogram.count() == 8);
+  CHECK(histogram.quantile(0.5) == 4);
+  CHECK(histogram.quantile(1) == 8);
+
+  // Larger values are within 12.5% of the exact quantiles
+  histogram.reset();
+  for (uint64_t v = 1; v <= 100000; ++v)
+    histogram.add(v * 1000);
+  CHECK(histogram.count() == 100000);
+  CHECK(histogram.max() == 100000000);
+  auto p50 = histogram.quantile(0.5);
+  CHECK(p50 >= 50000000);
+  CHECK(p50 <= 50000000 * 1.125);
+  auto p99 = histogram.quantile(0.99);
+  CHECK(p99 >= 99000000);
+  CHECK(p99 <= 100000000);
+
+  // The largest values are counted in the last bucket
+  histogram.add(UINT64_MAX);
+  CHECK(histogram.quantile(1) == UINT64_MAX);
+
+  // Histogram timers are reported in the stats dump
+  stats::all_stats.set_enabled(true);
+  stats::all_stats.histogram_reader_read.reset();
+  {
+    STATS_HISTOGRAM_TIMER(reader_read);
+  }
+  CHECK(stats::all_stats.histogram_reader_read.count() == 1);
+  std::string json;
+  stats::all_stats.dump(&json);
+  CHECK(
+      json.find("\"name\": \"reader_read\", \"count\": 1") !=
+      std::string::npos);
+  stats::all_stats.histogram_reader_read.reset();
+  stats::all_stats.set_enabled(false);
+}
+
+TEST_CASE("Stats: Test tracing", "[stats]") {
+  auto& tracer = stats::Tracer::global();
+  tracer.reset();
+
+  // The calls are recorded only while tracing is enabled
+  CHECK(timed_function().ok());
+  tracer.set_enabled(true);
+  CHECK(timed_function().ok());
+  std::thread thread([]() { CHECK(timed_function().ok()); });
+  thread.join();
+  tracer.set_enabled(false);
+  CHECK(timed_function().ok());
+
+  std::string json;
+  tracer.dump(&json);
+  CHECK(json.find("\"traceEvents\": [") != std::string::npos);
+  CHECK(occurrences(json, "\"name\": \"reader_read\"") == 2);
+  CHECK(occurrences(json, "\"ph\": \"X\"") == 2);
+  CHECK(occurrences(json, "\"tid\": ") == 2);
+
+  // Reset
+  tracer.reset();
+  tracer.dump(&json);
+  CHECK(occurrences(json, "\"ph\": \"X\"") == 0);
+}
+
+TEST_CASE("Stats: Test sampled query stats", "[stats]") {
+  auto& global = stats::all_stats.counter_reader_num_attr_tiles_touched;
+  global = 0;
+  uint64_t global_call_count = stats::all_stats.reader_read_call_count;
+  auto& tracer = stats::Tracer::global();
+  tracer.reset();
+
+  // While the global stats and tracing are disabled, only the sampled query
+  // gathers its stats and traces its calls
+  std::shared_ptr<stats::Statistics> sampled(new stats::Statistics());
+  sampled->set_sampled(true, true);
+  std::shared_ptr<stats::Statistics> unsampled(new stats::Statistics());
+  {
+    stats::QueryStatsScope stats_scope(sampled.get());
+    STATS_COUNTER_ADD(reader_num_attr_tiles_touched, 1);
+    CHECK(timed_function().ok());
+  }
+  {
+    stats::QueryStatsScope stats_scope(unsampled.get());
+    STATS_COUNTER_ADD(reader_num_attr_tiles_touched, 2);
+    CHECK(timed_function().ok());
+  }
+  STATS_COUNTER_ADD(reader_num_attr_tiles_touched, 4);
+  CHECK(timed_function().ok());
+
+  CHECK(sampled->counter_reader_num_attr_tiles_touched.load() == 1);
+  CHECK(sampled->reader_read_call_count == 1);
+  CHECK(unsampled->counter_reader_num_attr_tiles_touched.load() == 0);
+  CHECK(unsampled->reader_read_call_count == 0);
+  CHECK(global.load() == 0);
+  CHECK(stats::all_stats.reader_read_call_count == global_call_count);
+
+  std::string json;
+  tracer.dump(&json);
+  CHECK(occurrences(json, "\"name\": \"reader_read\"") == 1);
+  tracer.reset();
+}
@@ -847,3 +847,65 @@ TEST_CASE_METHOD(VFSFx, "C API: Test VFS parallel I/O", "[capi], [vfs]") {
 #endif
   }
 }
+
+TEST_CASE_METHOD(
+    VFSFx, "C API: Test VFS S3 split-range reads", "[capi], [vfs], [s3]") {
+  if (!supports_s3_)
+    return;
+
+  // With a single VFS thread, only `vfs.s3.read_part_size` splits a read.
+  set_num_vfs_threads(1);
+  tiledb_config_t* config = nullptr;
+  tiledb_error_t* error = nullptr;
+  REQUIRE(tiledb_vfs_get_config(ctx_, vfs_, &config) == TILEDB_OK);
+  REQUIRE(
+      tiledb_config_set(config, "vfs.s3.read_part_size", "4", &error) ==
+      TILEDB_OK);
+  REQUIRE(error == nullptr);
+  tiledb_vfs_free(&vfs_);
+  REQUIRE(tiledb_vfs_alloc(ctx_, config, &vfs_) == TILEDB_OK);
+  tiledb_config_free(&config);
+
+  // Create bucket
+  int is_bucket = 0;
+  int rc = tiledb_vfs_is_bucket(ctx_, vfs_, S3_BUCKET.c_str(), &is_bucket);
+  REQUIRE(rc == TILEDB_OK);
+  if (!is_bucket) {
+    rc = tiledb_vfs_create_bucket(ctx_, vfs_, S3_BUCKET.c_str());
+    REQUIRE(rc == TILEDB_OK);
+  }
+
+  // Write file
+  auto file = S3_TEMP_DIR + "file";
+  std::string to_write = "This will be written to the file";
+  tiledb_vfs_fh_t* fh;
+  rc = tiledb_vfs_open(ctx_, vfs_, file.c_str(), TILEDB_VFS_WRITE, &fh);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_vfs_write(ctx_, fh, to_write.c_str(), to_write.size());
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_vfs_close(ctx_, fh);
+  REQUIRE(rc == TILEDB_OK);
+  tiledb_vfs_fh_free(&fh);
+
+  // Read the whole file in 4-byte parts
+  tiledb_stats_enable();
+  tiledb_stats_reset();
+  std::string to_read;
+  to_read.resize(to_write.size());
+  rc = tiledb_vfs_open(ctx_, vfs_, file.c_str(), TILEDB_VFS_READ, &fh);
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_vfs_read(ctx_, fh, 0, &to_read[0], to_read.size());
+  REQUIRE(rc == TILEDB_OK);
+  CHECK_THAT(to_read, Catch::Equals(to_write));
+  rc = tiledb_vfs_close(ctx_, fh);
+  REQUIRE(rc == TILEDB_OK);
+  tiledb_vfs_fh_free(&fh);
+  CHECK(tiledb::sm::stats::all_stats.counter_vfs_read_num_parallelized == 1);
+  tiledb_stats_disable();
+
+  // Clean up
+  rc = tiledb_vfs_empty_bucket(ctx_, vfs_, S3_BUCKET.c_str());
+  REQUIRE(rc == TILEDB_OK);
+  rc = tiledb_vfs_remove_bucket(ctx_, vfs_, S3_BUCKET.c_str());
+  REQUIRE(rc == TILEDB_OK);
+}
@@ -35,6 +35,13 @@
 #include "tiledb/sm/misc/constants.h"
 #include "tiledb/sm/misc/utils.h"
 
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <set>
+#include <thread>
+#include <tuple>
+
 using namespace tiledb;
 
 struct Point {
@@ -835,6 +842,74 @@ TEST_CASE("C++ API: Open array at", "[cppapi][open-array-at]") {
     vfs.remove_dir(array_name);
 }
 
+TEST_CASE(
+    "C++ API: Open array with a start timestamp",
+    "[cppapi][open-array-timestamp-start]") {
+  Context ctx;
+  VFS vfs(ctx);
+  const std::string array_name = "cppapi_open_array_timestamp_start";
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  // Create array
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 3}}, 3));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  Array::create(array_name, schema);
+
+  // Write one cell per fragment, at distinct timestamps
+  std::vector<uint64_t> timestamps;
+  for (int i = 1; i <= 3; ++i) {
+    Array array_w(ctx, array_name, TILEDB_WRITE);
+    Query query_w(ctx, array_w);
+    std::vector<int> coords_w = {i};
+    std::vector<int> a_w = {i};
+    query_w.set_layout(TILEDB_UNORDERED)
+        .set_coordinates(coords_w)
+        .set_buffer("a", a_w);
+    query_w.submit();
+    timestamps.push_back(query_w.fragment_timestamp_range(0).first);
+    array_w.close();
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+
+  auto read = [&](Array& array) {
+    std::vector<int> subarray = {1, 3};
+    std::vector<int> a_r(3);
+    Query query_r(ctx, array);
+    query_r.set_subarray(subarray)
+        .set_layout(TILEDB_ROW_MAJOR)
+        .set_buffer("a", a_r);
+    query_r.submit();
+    a_r.resize(query_r.result_buffer_elements()["a"].second);
+    return a_r;
+  };
+
+  // Only the fragments written since the start timestamp are opened
+  Array array_r(ctx, array_name, TILEDB_READ);
+  CHECK(array_r.open_timestamp_start() == 0);
+  CHECK(read(array_r) == std::vector<int>({1, 2, 3}));
+  array_r.close();
+  array_r.set_open_timestamp_start(timestamps[1]);
+  CHECK(array_r.open_timestamp_start() == timestamps[1]);
+  array_r.open(TILEDB_READ);
+  CHECK(read(array_r) == std::vector<int>({2, 3}));
+
+  // The start timestamp applies on reopen, together with the timestamp
+  array_r.set_open_timestamp_start(timestamps[2]);
+  array_r.reopen();
+  CHECK(read(array_r) == std::vector<int>({3}));
+  array_r.set_open_timestamp_start(timestamps[1]);
+  array_r.reopen_at(timestamps[1]);
+  CHECK(read(array_r) == std::vector<int>({2}));
+  array_r.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
 TEST_CASE(
     "C++ API: Open encrypted array at", "[cppapi][open-encrypted-array-at]") {
   const char key[] = "0123456789abcdeF0123456789abcdeF";
@@ -1043,3 +1118,1441 @@ TEST_CASE("C++ API: Write cell with large cell val num", "[cppapi][sparse]") {
   if (vfs.is_dir(array_name))
     vfs.remove_dir(array_name);
 }
+
+TEST_CASE(
+    "C++ API: Read with memory-mapped tiles", "[cppapi][dense][mmap]") {
+  const std::string array_name = "cpp_unit_array";
+  Config config;
+  config["vfs.file.enable_mmap"] = "true";
+  config["sm.tile_cache_size"] = "0";
+  Context ctx(config);
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  // Create array with an unfiltered, a compressed and a var-sized attribute
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "rows", {{0, 3}}, 2))
+      .add_dimension(Dimension::create<int>(ctx, "cols", {{0, 3}}, 2));
+  ArraySchema schema(ctx, TILEDB_DENSE);
+  schema.set_domain(domain).set_order({{TILEDB_ROW_MAJOR, TILEDB_ROW_MAJOR}});
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  schema.add_attribute(
+      Attribute::create<int>(ctx, "b").set_filter_list(
+          FilterList(ctx).add_filter(Filter(ctx, TILEDB_FILTER_GZIP))));
+  schema.add_attribute(Attribute::create<std::string>(ctx, "c"));
+  Array::create(array_name, schema);
+
+  // Write
+  std::vector<int> a_w, b_w;
+  std::vector<uint64_t> c_off_w;
+  std::string c_w;
+  for (int i = 0; i < 16; i++) {
+    a_w.push_back(i);
+    b_w.push_back(2 * i);
+    c_off_w.push_back(c_w.size());
+    c_w += std::string((size_t)(i % 3) + 1, (char)('a' + i));
+  }
+  Array array_w(ctx, array_name, TILEDB_WRITE);
+  Query query_w(ctx, array_w);
+  query_w.set_subarray({0, 3, 0, 3})
+      .set_layout(TILEDB_ROW_MAJOR)
+      .set_buffer("a", a_w)
+      .set_buffer("b", b_w)
+      .set_buffer("c", c_off_w, c_w);
+  query_w.submit();
+  array_w.close();
+
+  // Read
+  std::vector<int> a_r(16), b_r(16);
+  std::vector<uint64_t> c_off_r(16);
+  std::string c_r;
+  c_r.resize(c_w.size());
+  Array array(ctx, array_name, TILEDB_READ);
+  Query query(ctx, array);
+  query.set_subarray({0, 3, 0, 3})
+      .set_layout(TILEDB_ROW_MAJOR)
+      .set_buffer("a", a_r)
+      .set_buffer("b", b_r)
+      .set_buffer("c", c_off_r, c_r);
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+  array.close();
+
+  REQUIRE(a_r == a_w);
+  REQUIRE(b_r == b_w);
+  REQUIRE(c_off_r == c_off_w);
+  REQUIRE(c_r == c_w);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Incomplete reads with partition prefetch",
+    "[cppapi][dense][prefetch]") {
+  const std::string array_name = "cpp_unit_array";
+  Config config;
+  config["sm.read_prefetch"] = "true";
+  Context ctx(config);
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "rows", {{0, 3}}, 2))
+      .add_dimension(Dimension::create<int>(ctx, "cols", {{0, 3}}, 2));
+  ArraySchema schema(ctx, TILEDB_DENSE);
+  schema.set_domain(domain).set_order({{TILEDB_ROW_MAJOR, TILEDB_ROW_MAJOR}});
+  schema.add_attribute(
+      Attribute::create<int>(ctx, "a").set_filter_list(
+          FilterList(ctx).add_filter(Filter(ctx, TILEDB_FILTER_GZIP))));
+  schema.add_attribute(Attribute::create<std::string>(ctx, "b"));
+  Array::create(array_name, schema);
+
+  // Write
+  std::vector<int> a_w;
+  std::vector<uint64_t> b_off_w;
+  std::string b_w;
+  for (int i = 0; i < 16; i++) {
+    a_w.push_back(i);
+    b_off_w.push_back(b_w.size());
+    b_w += std::string((size_t)(i % 3) + 1, (char)('a' + i));
+  }
+  Array array_w(ctx, array_name, TILEDB_WRITE);
+  Query query_w(ctx, array_w);
+  query_w.set_subarray({0, 3, 0, 3})
+      .set_layout(TILEDB_ROW_MAJOR)
+      .set_buffer("a", a_w)
+      .set_buffer("b", b_off_w, b_w);
+  query_w.submit();
+  array_w.close();
+
+  // Read one row per submission
+  std::vector<int> a_r(4);
+  std::vector<uint64_t> b_off_r(4);
+  std::string b_r;
+  b_r.resize(b_w.size());
+  Array array(ctx, array_name, TILEDB_READ);
+  Query query(ctx, array);
+  query.set_subarray({0, 3, 0, 3})
+      .set_layout(TILEDB_ROW_MAJOR)
+      .set_buffer("a", a_r)
+      .set_buffer("b", b_off_r, b_r);
+
+  std::vector<int> a_all;
+  std::string b_all;
+  Query::Status status;
+  do {
+    status = query.submit();
+    auto result_num = query.result_buffer_elements();
+    REQUIRE(result_num["a"].second > 0);
+    a_all.insert(
+        a_all.end(), a_r.begin(), a_r.begin() + result_num["a"].second);
+    b_all += b_r.substr(0, result_num["b"].second);
+  } while (status == Query::Status::INCOMPLETE);
+  array.close();
+
+  REQUIRE(status == Query::Status::COMPLETE);
+  REQUIRE(a_all == a_w);
+  REQUIRE(b_all == b_w);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE("C++ API: Prefetch array", "[cppapi][prefetch]") {
+  const std::string array_name = "cpp_unit_array_prefetch";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  // Create
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "rows", {{0, 3}}, 2))
+      .add_dimension(Dimension::create<int>(ctx, "cols", {{0, 3}}, 2));
+  ArraySchema schema(ctx, TILEDB_DENSE);
+  schema.set_domain(domain);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  schema.add_attribute(Attribute::create<std::string>(ctx, "b"));
+  Array::create(array_name, schema);
+
+  // Write
+  std::vector<int> a_w = {
+      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+  std::string b_w = "abcdefghijklmnop";
+  std::vector<uint64_t> b_off_w;
+  for (uint64_t i = 0; i < 16; i++)
+    b_off_w.push_back(i);
+  Array array_w(ctx, array_name, TILEDB_WRITE);
+  Query query_w(ctx, array_w);
+  query_w.set_subarray({0, 3, 0, 3})
+      .set_layout(TILEDB_ROW_MAJOR)
+      .set_buffer("a", a_w)
+      .set_buffer("b", b_off_w, b_w);
+  query_w.submit();
+  array_w.close();
+
+  // Invalid prefetches
+  Array array(ctx, array_name, TILEDB_READ);
+  REQUIRE_THROWS_AS(
+      array.prefetch<int>({0, 1, 0, 1}, {"foo"}), tiledb::TileDBError);
+  REQUIRE_THROWS_AS(array.prefetch<int64_t>({0, 1, 0, 1}), TileDBError);
+
+  // Prefetch, then read both the prefetched and the remaining region
+  array.prefetch<int>({0, 1, 0, 3}, {"a"});
+  array.prefetch<int>({});
+
+  std::vector<int> a(16);
+  std::vector<uint64_t> b_off(16);
+  std::string b(16, ' ');
+  Query query(ctx, array);
+  query.set_subarray<int>({0, 3, 0, 3})
+      .set_layout(TILEDB_ROW_MAJOR)
+      .set_buffer("a", a)
+      .set_buffer("b", b_off, b);
+  query.submit();
+  REQUIRE(query.query_status() == Query::Status::COMPLETE);
+  CHECK(a == a_w);
+  CHECK(b_off == b_off_w);
+  CHECK(b == b_w);
+
+  // Closing waits for in-flight prefetches
+  array.prefetch<int>({2, 3, 0, 3});
+  array.close();
+  REQUIRE_THROWS_AS(array.prefetch<int>({}), TileDBError);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Repeated sparse reads of empty subarrays",
+    "[cppapi][sparse][empty-subarray]") {
+  const std::string array_name = "cpp_unit_array_empty_subarray";
+  Config config;
+  config["sm.empty_subarray_cache_size"] = "10";
+  Context ctx(config);
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "rows", {{0, 99}}, 10))
+      .add_dimension(Dimension::create<int>(ctx, "cols", {{0, 99}}, 10));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain).set_capacity(2);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  Array::create(array_name, schema);
+
+  auto write = [&](std::vector<int> coords, std::vector<int> a) {
+    Array array_w(ctx, array_name, TILEDB_WRITE);
+    Query query_w(ctx, array_w);
+    query_w.set_layout(TILEDB_UNORDERED)
+        .set_buffer("a", a)
+        .set_coordinates(coords);
+    query_w.submit();
+    array_w.close();
+  };
+  auto read = [&](Array& array, const std::vector<int>& subarray) {
+    std::vector<int> a(10);
+    Query query(ctx, array);
+    query.set_subarray(subarray).set_layout(TILEDB_ROW_MAJOR).set_buffer(
+        "a", a);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    a.resize(query.result_buffer_elements()["a"].second);
+    return a;
+  };
+
+  write({1, 1, 5, 5, 50, 50}, {1, 2, 3});
+
+  // Repeated misses, interleaved with hits
+  Array array(ctx, array_name, TILEDB_READ);
+  for (int i = 0; i < 3; ++i) {
+    CHECK(read(array, {2, 4, 2, 4}).empty());
+    CHECK(read(array, {5, 5, 5, 5}) == std::vector<int>{2});
+    CHECK(read(array, {0, 99, 0, 99}) == (std::vector<int>{1, 2, 3}));
+  }
+
+  // A new fragment makes the subarray non-empty after reopening
+  write({3, 3}, {4});
+  CHECK(read(array, {2, 4, 2, 4}).empty());
+  array.reopen();
+  CHECK(read(array, {2, 4, 2, 4}) == std::vector<int>{4});
+  CHECK(read(array, {6, 8, 6, 8}).empty());
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Point reads with coordinate bloom filters",
+    "[cppapi][sparse][bloom-filter]") {
+  const std::string array_name = "cpp_unit_array_bloom_filter";
+  Config config;
+  config["sm.coords_bloom_filter_bits"] = "10";
+  Context ctx(config);
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "rows", {{0, 99}}, 10))
+      .add_dimension(Dimension::create<int>(ctx, "cols", {{0, 99}}, 10));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain).set_capacity(2);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  Array::create(array_name, schema);
+
+  auto write = [&](tiledb_layout_t layout,
+                   std::vector<int> coords,
+                   std::vector<int> a) {
+    Array array_w(ctx, array_name, TILEDB_WRITE);
+    Query query_w(ctx, array_w);
+    query_w.set_layout(layout).set_buffer("a", a).set_coordinates(coords);
+    query_w.submit();
+    query_w.finalize();
+    array_w.close();
+  };
+
+  // Three overlapping fragments, the last one written in global order
+  write(TILEDB_UNORDERED, {1, 1, 5, 5, 50, 50}, {1, 2, 3});
+  write(TILEDB_UNORDERED, {1, 2, 5, 5, 60, 60}, {4, 5, 6});
+  write(TILEDB_GLOBAL_ORDER, {2, 2, 3, 3, 4, 4}, {7, 8, 9});
+
+  Array array(ctx, array_name, TILEDB_READ);
+  auto read = [&](const std::vector<int>& rows, const std::vector<int>& cols) {
+    std::vector<int> a(10);
+    Query query(ctx, array);
+    for (auto r : rows)
+      query.add_range(0, r, r);
+    for (auto c : cols)
+      query.add_range(1, c, c);
+    query.set_layout(TILEDB_ROW_MAJOR).set_buffer("a", a);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    a.resize(query.result_buffer_elements()["a"].second);
+    return a;
+  };
+
+  CHECK(read({1}, {1}) == std::vector<int>{1});
+  CHECK(read({5}, {5}) == std::vector<int>{5});
+  CHECK(read({3}, {3}) == std::vector<int>{8});
+  CHECK(read({60}, {60}) == std::vector<int>{6});
+  CHECK(read({7}, {7}).empty());
+  CHECK(read({1}, {50}).empty());
+
+  // Multiple points, and a non-unary range
+  CHECK(read({1, 5}, {1, 5}) == (std::vector<int>{1, 5}));
+  CHECK(read({1, 50}, {2, 60}) == std::vector<int>{4});
+  std::vector<int> a(10);
+  Query query(ctx, array);
+  query.add_range(0, 1, 5).add_range(1, 1, 2);
+  query.set_layout(TILEDB_ROW_MAJOR).set_buffer("a", a);
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+  a.resize(query.result_buffer_elements()["a"].second);
+  CHECK(a == (std::vector<int>{1, 4, 7}));
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Reads across tile offset pages", "[cppapi][sparse][paged]") {
+  const std::string array_name = "cpp_unit_array_tile_offset_pages";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  // With capacity 2, the fragment spans two pages of tile offsets
+  const int cell_num = 20000;
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{0, 29999}}, 1000));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain).set_capacity(2);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  schema.add_attribute(Attribute::create<std::string>(ctx, "b"));
+  Array::create(array_name, schema);
+
+  std::vector<int> coords(cell_num), a(cell_num);
+  std::vector<uint64_t> b_off(cell_num);
+  std::string b;
+  for (int i = 0; i < cell_num; ++i) {
+    coords[i] = i;
+    a[i] = i;
+    b_off[i] = b.size();
+    b += std::to_string(i);
+  }
+  Array array_w(ctx, array_name, TILEDB_WRITE);
+  Query query_w(ctx, array_w);
+  query_w.set_layout(TILEDB_GLOBAL_ORDER)
+      .set_buffer("a", a)
+      .set_buffer("b", b_off, b)
+      .set_coordinates(coords);
+  query_w.submit();
+  query_w.finalize();
+  array_w.close();
+
+  Array array(ctx, array_name, TILEDB_READ);
+  auto read = [&](int start, int end) {
+    std::vector<int> a_r(end - start + 1);
+    std::vector<uint64_t> b_off_r(end - start + 1);
+    std::string b_r;
+    b_r.resize(10 * (end - start + 1));
+    Query query(ctx, array);
+    query.add_range(0, start, end);
+    query.set_layout(TILEDB_ROW_MAJOR)
+        .set_buffer("a", a_r)
+        .set_buffer("b", b_off_r, b_r);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    auto result_num = query.result_buffer_elements()["a"].second;
+    REQUIRE(result_num == (uint64_t)(end - start + 1));
+    for (int i = start; i <= end; ++i)
+      CHECK(a_r[i - start] == i);
+    CHECK(
+        b_r.substr(0, query.result_buffer_elements()["b"].second) ==
+        b.substr(b_off[start], b_off[end] - b_off[start]) +
+            std::to_string(end));
+  };
+
+  // Point reads in each page, a read across the page boundary and a
+  // read of all the cells
+  read(19998, 19998);
+  read(5, 5);
+  read(16380, 16390);
+  read(0, cell_num - 1);
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Reads with STR-packed R-Trees", "[cppapi][sparse][rtree]") {
+  const std::string array_name = "cpp_unit_array_rtree_str";
+  Config config;
+  config["sm.rtree_str_packing"] = "true";
+  Context ctx(config);
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  // Each data tile holds a short segment of a column
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "rows", {{0, 39}}, 40))
+      .add_dimension(Dimension::create<int>(ctx, "cols", {{0, 39}}, 40));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain).set_capacity(3);
+  schema.set_cell_order(TILEDB_COL_MAJOR);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  Array::create(array_name, schema);
+
+  std::vector<int> coords, a;
+  for (int i = 0; i < 40; ++i) {
+    for (int j = 0; j < 40; ++j) {
+      coords.insert(coords.end(), {i, j});
+      a.push_back(i * 40 + j);
+    }
+  }
+  Array array_w(ctx, array_name, TILEDB_WRITE);
+  Query query_w(ctx, array_w);
+  query_w.set_layout(TILEDB_UNORDERED).set_buffer("a", a).set_coordinates(
+      coords);
+  query_w.submit();
+  query_w.finalize();
+  array_w.close();
+
+  Array array(ctx, array_name, TILEDB_READ);
+  auto read = [&](int r0, int r1, int c0, int c1) {
+    std::vector<int> a_r(1600);
+    Query query(ctx, array);
+    query.add_range(0, r0, r1).add_range(1, c0, c1);
+    query.set_layout(TILEDB_ROW_MAJOR).set_buffer("a", a_r);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    a_r.resize(query.result_buffer_elements()["a"].second);
+    std::vector<int> expected;
+    for (int i = r0; i <= r1; ++i) {
+      for (int j = c0; j <= c1; ++j)
+        expected.push_back(i * 40 + j);
+    }
+    CHECK(a_r == expected);
+  };
+
+  read(0, 39, 0, 39);
+  read(7, 7, 21, 21);
+  read(3, 12, 5, 30);
+  read(38, 39, 0, 1);
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Load fragment metadata with single reads and a dedicated pool",
+    "[cppapi][sparse][fragment-metadata]") {
+  const std::string array_name = "cpp_unit_array_frag_meta_load";
+  Config config;
+  SECTION("- Speculative reads, dedicated pool") {
+    config["sm.fragment_metadata_speculative_read_size"] = "1000000";
+    config["sm.num_fragment_metadata_threads"] = "2";
+  }
+  SECTION("- Per-section reads, dedicated pool") {
+    config["sm.fragment_metadata_speculative_read_size"] = "0";
+    config["sm.num_fragment_metadata_threads"] = "2";
+  }
+  SECTION("- Speculative reads, default pool") {
+    config["sm.fragment_metadata_speculative_read_size"] = "1000000";
+  }
+  Context ctx(config);
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{0, 99}}, 10));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain).set_capacity(2);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  Array::create(array_name, schema);
+
+  // One fragment per group of cells
+  for (int f = 0; f < 4; ++f) {
+    std::vector<int> coords = {f * 20, f * 20 + 5, f * 20 + 9};
+    std::vector<int> a = {f, f + 10, f + 20};
+    Array array_w(ctx, array_name, TILEDB_WRITE);
+    Query query_w(ctx, array_w);
+    query_w.set_layout(TILEDB_UNORDERED).set_buffer("a", a).set_coordinates(
+        coords);
+    query_w.submit();
+    query_w.finalize();
+    array_w.close();
+  }
+
+  Array array(ctx, array_name, TILEDB_READ);
+  std::vector<int> a_r(12);
+  std::vector<int> coords_r(12);
+  Query query(ctx, array);
+  query.add_range(0, 0, 99);
+  query.set_layout(TILEDB_GLOBAL_ORDER)
+      .set_buffer("a", a_r)
+      .set_coordinates(coords_r);
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+  CHECK(query.result_buffer_elements()["a"].second == 12);
+  std::vector<int> expected_coords, expected_a;
+  for (int f = 0; f < 4; ++f) {
+    expected_coords.insert(
+        expected_coords.end(), {f * 20, f * 20 + 5, f * 20 + 9});
+    expected_a.insert(expected_a.end(), {f, f + 10, f + 20});
+  }
+  CHECK(coords_r == expected_coords);
+  CHECK(a_r == expected_a);
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Read with memory-mapped unfiltered fragment metadata",
+    "[cppapi][sparse][mmap][fragment-metadata]") {
+  const std::string array_name = "cpp_unit_array_frag_meta_mmap";
+  Config config;
+  config["vfs.file.enable_mmap"] = "true";
+  config["sm.fragment_metadata_unfiltered"] = "true";
+  config["sm.fragment_metadata_speculative_read_size"] = "0";
+  Context ctx(config);
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  // Many small tiles, so that the R-Tree and tile offsets span pages
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{0, 9999}}, 100));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain).set_capacity(2);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  Array::create(array_name, schema);
+
+  std::vector<int> coords(10000), a(10000);
+  for (int i = 0; i < 10000; ++i) {
+    coords[i] = i;
+    a[i] = 3 * i;
+  }
+  Array array_w(ctx, array_name, TILEDB_WRITE);
+  Query query_w(ctx, array_w);
+  query_w.set_layout(TILEDB_GLOBAL_ORDER)
+      .set_buffer("a", a)
+      .set_coordinates(coords);
+  query_w.submit();
+  query_w.finalize();
+  array_w.close();
+
+  Array array(ctx, array_name, TILEDB_READ);
+  auto read = [&](int start, int end) {
+    std::vector<int> a_r(10000);
+    Query query(ctx, array);
+    query.add_range(0, start, end);
+    query.set_layout(TILEDB_GLOBAL_ORDER).set_buffer("a", a_r);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    a_r.resize(query.result_buffer_elements()["a"].second);
+    std::vector<int> expected;
+    for (int i = start; i <= end; ++i)
+      expected.push_back(3 * i);
+    CHECK(a_r == expected);
+  };
+  read(0, 9999);
+  read(4321, 4400);
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Sparse array with Hilbert cell order",
+    "[cppapi][sparse][hilbert]") {
+  const std::string array_name = "cpp_unit_array_hilbert";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "x", {{1, 8}}, 8))
+      .add_dimension(Dimension::create<int>(ctx, "y", {{1, 8}}, 8));
+
+  // The Hilbert layout is a cell order of sparse arrays only
+  ArraySchema dense_schema(ctx, TILEDB_DENSE);
+  dense_schema.set_domain(domain).set_cell_order(TILEDB_HILBERT);
+  dense_schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  CHECK_THROWS(dense_schema.check());
+
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain).set_cell_order(TILEDB_HILBERT).set_capacity(16);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  CHECK(schema.cell_order() == TILEDB_HILBERT);
+  Array::create(array_name, schema);
+
+  // Write all cells, in two fragments of interleaved rows
+  for (int f = 0; f < 2; ++f) {
+    std::vector<int> x, y, a;
+    for (int i = 1 + f; i <= 8; i += 2) {
+      for (int j = 1; j <= 8; ++j) {
+        x.push_back(i);
+        y.push_back(j);
+        a.push_back(10 * i + j);
+      }
+    }
+    Array array(ctx, array_name, TILEDB_WRITE);
+    Query query(ctx, array);
+    query.set_layout(TILEDB_UNORDERED)
+        .set_buffer("a", a)
+        .set_buffer("x", x)
+        .set_buffer("y", y);
+    CHECK_THROWS(query.set_layout(TILEDB_HILBERT));
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    array.close();
+  }
+
+  // The cells come back along a curve that moves to an adjacent cell in
+  // every step, both before and after consolidation
+  auto check_global_order = [&]() {
+    std::vector<int> x(64), y(64), a(64);
+    Array array(ctx, array_name, TILEDB_READ);
+    Query query(ctx, array);
+    query.set_layout(TILEDB_GLOBAL_ORDER)
+        .set_buffer("a", a)
+        .set_buffer("x", x)
+        .set_buffer("y", y);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    REQUIRE(query.result_buffer_elements()["a"].second == 64);
+    array.close();
+
+    std::set<int> cells;
+    for (int i = 0; i < 64; ++i) {
+      CHECK(a[i] == 10 * x[i] + y[i]);
+      cells.insert(a[i]);
+      if (i > 0)
+        CHECK(std::abs(x[i] - x[i - 1]) + std::abs(y[i] - y[i - 1]) == 1);
+    }
+    CHECK(cells.size() == 64);
+  };
+  check_global_order();
+  Array::consolidate(ctx, array_name);
+  check_global_order();
+
+  // Ordered reads are unaffected by the cell order
+  std::vector<int> x(64), y(64), a(64);
+  Array array(ctx, array_name, TILEDB_READ);
+  Query query(ctx, array);
+  query.set_layout(TILEDB_ROW_MAJOR)
+      .set_buffer("a", a)
+      .set_buffer("x", x)
+      .set_buffer("y", y);
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+  array.close();
+  for (int i = 0; i < 64; ++i)
+    CHECK(a[i] == 10 * (i / 8 + 1) + (i % 8 + 1));
+
+  // Global order writes must follow the Hilbert curve, which never jumps
+  // diagonally within an aligned block of 2x2 cells
+  Array array_w(ctx, array_name, TILEDB_WRITE);
+  Query query_w(ctx, array_w);
+  std::vector<int> x_w = {1, 1, 2, 2}, y_w = {1, 2, 1, 2};
+  std::vector<int> a_w = {11, 12, 21, 22};
+  query_w.set_layout(TILEDB_GLOBAL_ORDER)
+      .set_buffer("a", a_w)
+      .set_buffer("x", x_w)
+      .set_buffer("y", y_w);
+  CHECK_THROWS(query_w.submit());
+  array_w.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Open the same array concurrently",
+    "[cppapi][array][open][concurrent]") {
+  const std::string array_name = "cpp_unit_array_concurrent";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 8}}, 2));
+  ArraySchema schema(ctx, TILEDB_DENSE);
+  schema.set_domain(domain);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  Array::create(array_name, schema);
+
+  // Write each pair of cells in its own fragment
+  for (int f = 0; f < 4; ++f) {
+    std::vector<int> a = {10 * f, 10 * f + 1};
+    Array array(ctx, array_name, TILEDB_WRITE);
+    Query query(ctx, array);
+    query.set_subarray<int>({2 * f + 1, 2 * f + 2})
+        .set_layout(TILEDB_ROW_MAJOR)
+        .set_buffer("a", a);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    array.close();
+  }
+
+  // Open, read, reopen and close the array from several threads, counting
+  // the reads that return the written cells
+  const std::vector<int> expected = {0, 1, 10, 11, 20, 21, 30, 31};
+  std::atomic<int> correct_num{0};
+  const int thread_num = 8, iter_num = 10;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < thread_num; ++t) {
+    threads.emplace_back([&]() {
+      for (int i = 0; i < iter_num; ++i) {
+        Array array(ctx, array_name, TILEDB_READ);
+        if (i % 2 == 1)
+          array.reopen();
+        std::vector<int> a(8);
+        Query query(ctx, array);
+        query.set_subarray<int>({1, 8})
+            .set_layout(TILEDB_ROW_MAJOR)
+            .set_buffer("a", a);
+        if (query.submit() == Query::Status::COMPLETE && a == expected)
+          ++correct_num;
+        array.close();
+      }
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+  CHECK(correct_num == thread_num * iter_num);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Open arrays for reads without filelocks",
+    "[cppapi][array][filelocks]") {
+  const std::string array_name = "cpp_unit_array_read_filelocks";
+  Config config;
+  config["vfs.file.enable_read_filelocks"] = "false";
+  Context ctx(config);
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 4}}, 2));
+  ArraySchema schema(ctx, TILEDB_DENSE);
+  schema.set_domain(domain);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  Array::create(array_name, schema);
+
+  for (int f = 0; f < 2; ++f) {
+    std::vector<int> a = {f, f};
+    Array array(ctx, array_name, TILEDB_WRITE);
+    Query query(ctx, array);
+    query.set_subarray<int>({2 * f + 1, 2 * f + 2})
+        .set_layout(TILEDB_ROW_MAJOR)
+        .set_buffer("a", a);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    array.close();
+  }
+
+  // Reads and consolidation, which still locks the array, work as before
+  auto read = [&]() {
+    std::vector<int> a(4);
+    Array array(ctx, array_name, TILEDB_READ);
+    Query query(ctx, array);
+    query.set_subarray<int>({1, 4})
+        .set_layout(TILEDB_ROW_MAJOR)
+        .set_buffer("a", a);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    array.close();
+    return a;
+  };
+  CHECK(read() == std::vector<int>{0, 0, 1, 1});
+  Array::consolidate(ctx, array_name);
+  CHECK(read() == std::vector<int>{0, 0, 1, 1});
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Query an array snapshot concurrently",
+    "[cppapi][array][snapshot][concurrent]") {
+  const std::string array_name = "cpp_unit_array_snapshot";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 8}}, 2));
+  ArraySchema schema(ctx, TILEDB_DENSE);
+  schema.set_domain(domain);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  Array::create(array_name, schema);
+
+  auto write = [&](int value) {
+    std::vector<int> a(8, value);
+    Array array(ctx, array_name, TILEDB_WRITE);
+    Query query(ctx, array);
+    query.set_subarray<int>({1, 8})
+        .set_layout(TILEDB_ROW_MAJOR)
+        .set_buffer("a", a);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    array.close();
+  };
+  write(1);
+  std::unique_ptr<ArraySnapshot> snapshot(new ArraySnapshot(ctx, array_name));
+  CHECK(snapshot->array().is_open());
+  CHECK(snapshot->schema().attribute_num() == 1);
+
+  // Fragments written after the snapshot was opened are not visible
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  write(2);
+
+  // Read from several threads, each with its own copy of the snapshot
+  std::atomic<int> correct_num{0};
+  const int thread_num = 8, iter_num = 10;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < thread_num; ++t) {
+    ArraySnapshot copy = *snapshot;
+    threads.emplace_back([&correct_num, copy]() {
+      for (int i = 0; i < iter_num; ++i) {
+        std::vector<int> a(8);
+        auto query = copy.query();
+        query.set_subarray<int>({1, 8})
+            .set_layout(TILEDB_ROW_MAJOR)
+            .set_buffer("a", a);
+        if (query.submit() == Query::Status::COMPLETE &&
+            a == std::vector<int>(8, 1))
+          ++correct_num;
+      }
+    });
+  }
+
+  // The array stays open while any copy is alive
+  snapshot.reset();
+  for (auto& thread : threads)
+    thread.join();
+  CHECK(correct_num == thread_num * iter_num);
+
+  // A new snapshot sees the latest fragment
+  ArraySnapshot latest(ctx, array_name);
+  std::vector<int> a(8);
+  auto query = latest.query();
+  query.set_subarray<int>({1, 8}).set_layout(TILEDB_ROW_MAJOR).set_buffer(
+      "a", a);
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+  CHECK(a == std::vector<int>(8, 2));
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Pack the tiles of small fragments into a single file",
+    "[cppapi][sparse][fragment-packing]") {
+  const std::string array_name = "cpp_unit_array_fragment_packing";
+  uint64_t max_size = 0;
+  SECTION("- packing enabled") {
+    max_size = 1024 * 1024;
+  }
+  SECTION("- fragments too large") {
+    max_size = 1;
+  }
+  SECTION("- packing disabled") {
+    max_size = 0;
+  }
+  Config config;
+  config["sm.fragment_packing_max_size"] = std::to_string(max_size);
+  Context ctx(config);
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{0, 99}}, 10));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain).set_capacity(4);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  schema.add_attribute(Attribute::create<std::string>(ctx, "b"));
+  Array::create(array_name, schema);
+
+  // Write two fragments in unordered layout
+  std::vector<int> a_expected;
+  std::string b_expected;
+  std::vector<uint64_t> b_off_expected;
+  for (int f = 0; f < 2; ++f) {
+    std::vector<int> coords, a;
+    std::string b;
+    std::vector<uint64_t> b_off;
+    for (int i = 19; i >= 0; --i) {
+      coords.push_back(20 * f + i);
+      a.push_back(20 * f + i);
+      b_off.push_back(b.size());
+      b += std::string((size_t)(i % 3) + 1, (char)('a' + i));
+    }
+    Array array_w(ctx, array_name, TILEDB_WRITE);
+    Query query_w(ctx, array_w);
+    query_w.set_layout(TILEDB_UNORDERED)
+        .set_buffer("a", a)
+        .set_buffer("b", b_off, b)
+        .set_coordinates(coords);
+    REQUIRE(query_w.submit() == Query::Status::COMPLETE);
+    array_w.close();
+
+    for (int i = 0; i < 20; ++i) {
+      a_expected.push_back(20 * f + i);
+      b_off_expected.push_back(b_expected.size());
+      b_expected += std::string((size_t)(i % 3) + 1, (char)('a' + i));
+    }
+  }
+
+  // Small fragments are packed into a single file, unless packing is off
+  bool packed = max_size > 1;
+  for (const auto& f : vfs.ls(array_name)) {
+    if (!vfs.is_file(
+            f + "/" + tiledb::sm::constants::fragment_metadata_filename))
+      continue;
+    CHECK(
+        vfs.is_file(
+            f + "/" + tiledb::sm::constants::packed_fragment_filename) ==
+        packed);
+    CHECK(vfs.is_file(f + "/a.tdb") == !packed);
+    CHECK(vfs.is_file(f + "/b_var.tdb") == !packed);
+  }
+
+  auto read = [&]() {
+    Array array(ctx, array_name, TILEDB_READ);
+    std::vector<int> a_r(40);
+    std::vector<uint64_t> b_off_r(40);
+    std::string b_r;
+    b_r.resize(b_expected.size());
+    Query query(ctx, array);
+    query.add_range(0, 0, 99);
+    query.set_layout(TILEDB_ROW_MAJOR)
+        .set_buffer("a", a_r)
+        .set_buffer("b", b_off_r, b_r);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    CHECK(a_r == a_expected);
+    CHECK(b_off_r == b_off_expected);
+    CHECK(b_r == b_expected);
+    array.close();
+  };
+  read();
+
+  // The tiles of packed fragments are copied out on consolidation
+  Array::consolidate(ctx, array_name);
+  read();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Co-locate the tiles of all attributes",
+    "[cppapi][sparse][tile-colocation]") {
+  const std::string array_name = "cpp_unit_array_tile_colocation";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{0, 99}}, 10));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain).set_capacity(4).set_tile_colocation(true);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  schema.add_attribute(Attribute::create<std::string>(ctx, "b"));
+  schema.add_attribute(Attribute::create<double>(ctx, "c"));
+  Array::create(array_name, schema);
+  CHECK(ArraySchema(ctx, array_name).tile_colocation());
+
+  // Write a fragment in unordered layout, and one in global order with two
+  // submissions
+  auto cells = [](int start, int end, bool reverse) {
+    std::vector<int> coords, a;
+    std::vector<double> c;
+    std::string b;
+    std::vector<uint64_t> b_off;
+    for (int k = start; k < end; ++k) {
+      int i = reverse ? end - 1 - (k - start) : k;
+      coords.push_back(i);
+      a.push_back(i);
+      c.push_back(i / 2.0);
+      b_off.push_back(b.size());
+      b += std::string((size_t)(i % 3) + 1, (char)('a' + i % 26));
+    }
+    return std::make_tuple(coords, a, b_off, b, c);
+  };
+  {
+    auto data = cells(0, 30, true);
+    Array array_w(ctx, array_name, TILEDB_WRITE);
+    Query query_w(ctx, array_w);
+    query_w.set_layout(TILEDB_UNORDERED)
+        .set_buffer("a", std::get<1>(data))
+        .set_buffer("b", std::get<2>(data), std::get<3>(data))
+        .set_buffer("c", std::get<4>(data))
+        .set_coordinates(std::get<0>(data));
+    REQUIRE(query_w.submit() == Query::Status::COMPLETE);
+    array_w.close();
+  }
+  {
+    Array array_w(ctx, array_name, TILEDB_WRITE);
+    Query query_w(ctx, array_w);
+    query_w.set_layout(TILEDB_GLOBAL_ORDER);
+    for (int s = 0; s < 2; ++s) {
+      auto data = cells(30 + 15 * s, 45 + 15 * s, false);
+      query_w.set_buffer("a", std::get<1>(data))
+          .set_buffer("b", std::get<2>(data), std::get<3>(data))
+          .set_buffer("c", std::get<4>(data))
+          .set_coordinates(std::get<0>(data));
+      REQUIRE(query_w.submit() == Query::Status::COMPLETE);
+    }
+    query_w.finalize();
+    array_w.close();
+  }
+
+  // Each fragment stores its tiles in a single file
+  int frag_num = 0;
+  for (const auto& f : vfs.ls(array_name)) {
+    if (!vfs.is_file(
+            f + "/" + tiledb::sm::constants::fragment_metadata_filename))
+      continue;
+    ++frag_num;
+    CHECK(vfs.is_file(
+        f + "/" + tiledb::sm::constants::packed_fragment_filename));
+    CHECK(!vfs.is_file(f + "/a.tdb"));
+    CHECK(!vfs.is_file(f + "/b_var.tdb"));
+    CHECK(!vfs.is_file(f + "/d.tdb"));
+  }
+  CHECK(frag_num == 2);
+
+  auto read = [&](int start, int end) {
+    auto expected = cells(start, end + 1, false);
+    Array array(ctx, array_name, TILEDB_READ);
+    std::vector<int> a_r(60);
+    std::vector<double> c_r(60);
+    std::vector<uint64_t> b_off_r(60);
+    std::string b_r;
+    b_r.resize(60 * 3);
+    Query query(ctx, array);
+    query.add_range(0, start, end);
+    query.set_layout(TILEDB_ROW_MAJOR)
+        .set_buffer("a", a_r)
+        .set_buffer("b", b_off_r, b_r)
+        .set_buffer("c", c_r);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    auto result_num = (size_t)query.result_buffer_elements()["a"].second;
+    a_r.resize(result_num);
+    c_r.resize(result_num);
+    b_off_r.resize(result_num);
+    b_r.resize((size_t)query.result_buffer_elements()["b"].second);
+    CHECK(a_r == std::get<1>(expected));
+    CHECK(b_off_r == std::get<2>(expected));
+    CHECK(b_r == std::get<3>(expected));
+    CHECK(c_r == std::get<4>(expected));
+    array.close();
+  };
+  read(0, 59);
+  read(27, 33);
+  read(50, 50);
+
+  Array::consolidate(ctx, array_name);
+  read(0, 59);
+  read(27, 33);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Buffer the unordered writes of a context in memory",
+    "[cppapi][sparse][write-buffer]") {
+  const std::string array_name = "cpp_unit_array_write_buffer";
+  uint64_t max_size = 0;
+  int written_frag_num = 0, expected_frag_num = 0;
+  SECTION("- writes batched") {
+    max_size = 1024 * 1024;
+    written_frag_num = 0;
+    expected_frag_num = 1;
+  }
+  SECTION("- each write reaches the maximum size") {
+    max_size = 1;
+    written_frag_num = 3;
+    expected_frag_num = 3;
+  }
+  Config config;
+  config["sm.write_buffer.max_size"] = std::to_string(max_size);
+  Context ctx(config);
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{0, 99}}, 10));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain).set_capacity(4);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  schema.add_attribute(Attribute::create<std::string>(ctx, "b"));
+  Array::create(array_name, schema);
+
+  auto frag_num = [&]() {
+    int num = 0;
+    for (const auto& f : vfs.ls(array_name))
+      num += vfs.is_file(
+          f + "/" + tiledb::sm::constants::fragment_metadata_filename);
+    return num;
+  };
+
+  // Write three batches of cells in unordered layout
+  std::vector<int> a_expected;
+  std::string b_expected;
+  std::vector<uint64_t> b_off_expected;
+  for (int w = 0; w < 3; ++w) {
+    std::vector<int> coords, a;
+    std::string b;
+    std::vector<uint64_t> b_off;
+    for (int i = 9; i >= 0; --i) {
+      coords.push_back(10 * w + i);
+      a.push_back(10 * w + i);
+      b_off.push_back(b.size());
+      b += std::string((size_t)(i % 3) + 1, (char)('a' + i));
+    }
+    Array array_w(ctx, array_name, TILEDB_WRITE);
+    Query query_w(ctx, array_w);
+    query_w.set_layout(TILEDB_UNORDERED)
+        .set_buffer("a", a)
+        .set_buffer("b", b_off, b)
+        .set_coordinates(coords);
+    REQUIRE(query_w.submit() == Query::Status::COMPLETE);
+    array_w.close();
+
+    for (int i = 0; i < 10; ++i) {
+      a_expected.push_back(10 * w + i);
+      b_off_expected.push_back(b_expected.size());
+      b_expected += std::string((size_t)(i % 3) + 1, (char)('a' + i));
+    }
+  }
+  CHECK(frag_num() == written_frag_num);
+
+  // Opening the array for reads flushes the buffered cells
+  Array array(ctx, array_name, TILEDB_READ);
+  std::vector<int> a_r(30);
+  std::vector<uint64_t> b_off_r(30);
+  std::string b_r;
+  b_r.resize(b_expected.size());
+  Query query(ctx, array);
+  query.add_range(0, 0, 99);
+  query.set_layout(TILEDB_ROW_MAJOR)
+      .set_buffer("a", a_r)
+      .set_buffer("b", b_off_r, b_r);
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+  CHECK(a_r == a_expected);
+  CHECK(b_off_r == b_off_expected);
+  CHECK(b_r == b_expected);
+  array.close();
+  CHECK(frag_num() == expected_frag_num);
+
+  // Freeing the context flushes the buffered cells
+  {
+    Context ctx_w(config);
+    Array array_w(ctx_w, array_name, TILEDB_WRITE);
+    std::vector<int> coords = {50}, a = {50};
+    std::string b = "z";
+    std::vector<uint64_t> b_off = {0};
+    Query query_w(ctx_w, array_w);
+    query_w.set_layout(TILEDB_UNORDERED)
+        .set_buffer("a", a)
+        .set_buffer("b", b_off, b)
+        .set_coordinates(coords);
+    REQUIRE(query_w.submit() == Query::Status::COMPLETE);
+    array_w.close();
+  }
+  CHECK(frag_num() == expected_frag_num + 1);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Load the fragment metadata eagerly on open",
+    "[cppapi][sparse][eager-metadata-load]") {
+  const std::string array_name = "cpp_unit_array_eager_metadata_load";
+  Config config;
+  config["sm.eager_metadata_load"] = "true";
+  Context ctx(config);
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{0, 99}}, 10));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain).set_capacity(4);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  schema.add_attribute(Attribute::create<std::string>(ctx, "b"));
+  Array::create(array_name, schema);
+
+  // Write two fragments
+  for (int f = 0; f < 2; ++f) {
+    std::vector<int> coords, a;
+    std::string b;
+    std::vector<uint64_t> b_off;
+    for (int i = 0; i < 20; ++i) {
+      coords.push_back(20 * f + i);
+      a.push_back(20 * f + i);
+      b_off.push_back(b.size());
+      b += std::string((size_t)(i % 3) + 1, (char)('a' + i));
+    }
+    Array array_w(ctx, array_name, TILEDB_WRITE);
+    Query query_w(ctx, array_w);
+    query_w.set_layout(TILEDB_GLOBAL_ORDER)
+        .set_buffer("a", a)
+        .set_buffer("b", b_off, b)
+        .set_coordinates(coords);
+    REQUIRE(query_w.submit() == Query::Status::COMPLETE);
+    query_w.finalize();
+    array_w.close();
+  }
+
+  // The first read records the attributes whose tile offsets the later
+  // opens load eagerly
+  for (int r = 0; r < 3; ++r) {
+    Array array(ctx, array_name, TILEDB_READ);
+    if (r == 2)
+      array.reopen();
+    std::vector<int> a_r(40);
+    std::vector<uint64_t> b_off_r(40);
+    std::string b_r;
+    b_r.resize(40 * 3);
+    Query query(ctx, array);
+    query.add_range(0, 15, 24);
+    query.set_layout(TILEDB_ROW_MAJOR)
+        .set_buffer("a", a_r)
+        .set_buffer("b", b_off_r, b_r);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    auto result_num = (size_t)query.result_buffer_elements()["a"].second;
+    REQUIRE(result_num == 10);
+    for (int i = 0; i < 10; ++i)
+      CHECK(a_r[i] == 15 + i);
+    CHECK(b_r.substr(0, 3) == "pqq");
+    array.close();
+  }
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Approximate distinct counts and quantiles from sketches",
+    "[cppapi][sparse][sketches]") {
+  const std::string array_name = "cpp_unit_array_sketches";
+  Config config;
+  config["sm.fragment_sketches"] = "true";
+  Context ctx(config);
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{0, 9999}}, 100));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain).set_capacity(100);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  schema.add_attribute(Attribute::create<std::string>(ctx, "b"));
+  Array::create(array_name, schema);
+
+  // Write two fragments over disjoint halves of the domain, with 1000 and
+  // 2000 distinct values respectively
+  for (int f = 0; f < 2; ++f) {
+    std::vector<int> coords, a;
+    std::string b;
+    std::vector<uint64_t> b_off;
+    for (int i = 0; i < 5000; ++i) {
+      coords.push_back(5000 * f + i);
+      a.push_back(f == 0 ? i % 1000 : 1000 + i % 2000);
+      b_off.push_back(b.size());
+      b += "b";
+    }
+    Array array_w(ctx, array_name, TILEDB_WRITE);
+    Query query_w(ctx, array_w);
+    query_w.set_layout(TILEDB_GLOBAL_ORDER)
+        .set_buffer("a", a)
+        .set_buffer("b", b_off, b)
+        .set_coordinates(coords);
+    REQUIRE(query_w.submit() == Query::Status::COMPLETE);
+    query_w.finalize();
+    array_w.close();
+  }
+
+  Array array(ctx, array_name, TILEDB_READ);
+  auto count = array.approx_distinct_count<int>("a");
+  CHECK(count > 2900);
+  CHECK(count < 3100);
+  count = array.approx_distinct_count<int>("a", {0, 4999});
+  CHECK(count > 970);
+  CHECK(count < 1030);
+  CHECK(array.approx_quantile<int>("a", 0, {0, 4999}) == 0);
+  CHECK(array.approx_quantile<int>("a", 1, {0, 4999}) == 999);
+  CHECK(array.approx_quantile<int>("a", 1) == 2999);
+  auto median = array.approx_quantile<int>("a", 0.5, {5000, 9999});
+  CHECK(median > 1900);
+  CHECK(median < 2100);
+  CHECK_THROWS(array.approx_quantile<int>("a", 1.5));
+  CHECK_THROWS(array.approx_distinct_count<int>("b"));
+  array.close();
+
+  // Fragments written without sketches are reported
+  Context ctx_no_sketches;
+  {
+    std::vector<int> coords = {10}, a = {1};
+    std::string b = "b";
+    std::vector<uint64_t> b_off = {0};
+    Array array_w(ctx_no_sketches, array_name, TILEDB_WRITE);
+    Query query_w(ctx_no_sketches, array_w);
+    query_w.set_layout(TILEDB_UNORDERED)
+        .set_buffer("a", a)
+        .set_buffer("b", b_off, b)
+        .set_coordinates(coords);
+    REQUIRE(query_w.submit() == Query::Status::COMPLETE);
+    array_w.close();
+  }
+  array.open(TILEDB_READ);
+  CHECK_THROWS(array.approx_distinct_count<int>("a"));
+  count = array.approx_distinct_count<int>("a", {5000, 9999});
+  CHECK(count > 1940);
+  CHECK(count < 2060);
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE("C++ API: Context memory usage", "[cppapi][memory-usage]") {
+  const std::string array_name = "cpp_unit_array_memory_usage";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{0, 9999}}, 100));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain).set_capacity(10);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  Array::create(array_name, schema);
+
+  std::vector<int> coords, a;
+  for (int i = 0; i < 1000; ++i) {
+    coords.push_back(i);
+    a.push_back(i);
+  }
+  Array array_w(ctx, array_name, TILEDB_WRITE);
+  Query query_w(ctx, array_w);
+  query_w.set_layout(TILEDB_GLOBAL_ORDER)
+      .set_buffer("a", a)
+      .set_coordinates(coords);
+  REQUIRE(query_w.submit() == Query::Status::COMPLETE);
+  query_w.finalize();
+  array_w.close();
+
+  // Returns the value of the input member of the memory usage
+  auto value = [](const std::string& json, const std::string& name) {
+    auto pos = json.find("\"" + name + "\": ");
+    REQUIRE(pos != std::string::npos);
+    return std::stoull(json.substr(pos + name.size() + 4));
+  };
+
+  auto json = ctx.memory_usage();
+  CHECK(value(json, "openArrays") == 0);
+  CHECK(value(json, "metadata") == 0);
+  CHECK(json.find("\"process\": {") != std::string::npos);
+  value(json, "buffersInUse");
+  value(json, "fragmentMetadataCache");
+
+  // The fragment metadata loaded by a read are counted until the array is
+  // closed
+  Array array(ctx, array_name, TILEDB_READ);
+  Query query(ctx, array);
+  std::vector<int> a_read(10);
+  query.set_subarray<int>({0, 9}).set_buffer("a", a_read);
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+  json = ctx.memory_usage();
+  CHECK(value(json, "openArrays") == 1);
+  CHECK(value(json, "metadata") > 0);
+  array.close();
+
+  json = ctx.memory_usage();
+  CHECK(value(json, "openArrays") == 0);
+  CHECK(value(json, "metadata") == 0);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
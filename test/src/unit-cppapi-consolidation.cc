@@ -33,6 +33,9 @@
 #include "catch.hpp"
 #include "tiledb/sm/cpp_api/tiledb"
 
+#include <chrono>
+#include <thread>
+
 using namespace tiledb;
 
 void remove_array(const std::string& array_name) {
@@ -116,3 +119,563 @@ TEST_CASE(
 
   remove_array(array_name);
 }
+
+TEST_CASE(
+    "C++ API: Test reopen after consolidation", "[cppapi][consolidation]") {
+  std::string array_name = "cppapi_consolidation_reopen";
+  remove_array(array_name);
+
+  create_array(array_name);
+  write_array(array_name, {1, 2}, {1, 2});
+
+  Context ctx;
+  Array array(ctx, array_name, TILEDB_READ);
+
+  // Reopening loads only the new fragment
+  write_array(array_name, {3, 3}, {3});
+  array.reopen();
+  std::vector<int> values(10);
+  Query query(ctx, array, TILEDB_READ);
+  query.set_layout(TILEDB_ROW_MAJOR);
+  query.set_subarray(std::vector<int>{1, 3});
+  query.set_buffer("a", values);
+  query.submit();
+  CHECK(query.result_buffer_elements()["a"].second == 3);
+  CHECK(values[2] == 3);
+
+  // Reopening after consolidation drops the removed fragments
+  REQUIRE_NOTHROW(Array::consolidate(ctx, array_name));
+  CHECK(num_fragments(array_name) == 1);
+  array.reopen();
+  std::vector<int> values2(10);
+  Query query2(ctx, array, TILEDB_READ);
+  query2.set_layout(TILEDB_ROW_MAJOR);
+  query2.set_subarray(std::vector<int>{1, 3});
+  query2.set_buffer("a", values2);
+  query2.submit();
+  values2.resize(query2.result_buffer_elements()["a"].second);
+  CHECK(values2 == std::vector<int>{1, 2, 3});
+  array.close();
+
+  remove_array(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test fragment metadata consolidation",
+    "[cppapi][consolidation]") {
+  std::string array_name = "cppapi_consolidation_fragment_metadata";
+  remove_array(array_name);
+
+  create_array(array_name);
+  write_array(array_name, {1, 1}, {1});
+  write_array(array_name, {2, 2}, {2});
+  write_array(array_name, {3, 3}, {3});
+
+  Context ctx;
+  VFS vfs(ctx);
+  REQUIRE_NOTHROW(Array::consolidate_fragment_metadata(ctx, array_name));
+  CHECK(vfs.is_file(array_name + "/__fragment_metadata_consolidated.tdb"));
+  CHECK(num_fragments(array_name) == 4);
+
+  // The consolidated file is used for the fragments it contains
+  read_array(array_name, {1, 3}, {1, 2, 3});
+
+  // Newer fragments are loaded individually
+  write_array(array_name, {2, 2}, {5});
+  read_array(array_name, {1, 3}, {1, 5, 3});
+
+  // Fragments removed by consolidation are ignored
+  REQUIRE_NOTHROW(Array::consolidate(ctx, array_name));
+  read_array(array_name, {1, 3}, {1, 5, 3});
+  REQUIRE_NOTHROW(Array::consolidate_fragment_metadata(ctx, array_name));
+  read_array(array_name, {1, 3}, {1, 5, 3});
+
+  remove_array(array_name);
+}
+
+TEST_CASE("C++ API: Test array manifest", "[cppapi][consolidation]") {
+  std::string array_name = "cppapi_consolidation_array_manifest";
+  remove_array(array_name);
+  create_array(array_name);
+
+  Config config;
+  config["sm.array_manifest"] = "true";
+  Context ctx(config);
+  VFS vfs(ctx);
+  auto write = [&](Context& wctx, int i, int v) {
+    Array array(wctx, array_name, TILEDB_WRITE);
+    Query query(wctx, array, TILEDB_WRITE);
+    query.set_layout(TILEDB_ROW_MAJOR);
+    query.set_subarray(std::vector<int>{i, i});
+    std::vector<int> values = {v};
+    query.set_buffer("a", values);
+    query.submit();
+    array.close();
+  };
+  auto read = [&]() {
+    Array array(ctx, array_name, TILEDB_READ);
+    Query query(ctx, array, TILEDB_READ);
+    query.set_layout(TILEDB_ROW_MAJOR);
+    query.set_subarray(std::vector<int>{1, 3});
+    std::vector<int> values(3);
+    query.set_buffer("a", values);
+    query.submit();
+    array.close();
+    return values;
+  };
+
+  // Writers maintain the manifest
+  write(ctx, 1, 1);
+  write(ctx, 2, 2);
+  CHECK(vfs.is_file(array_name + "/__array_manifest.tdb"));
+  CHECK(read() == std::vector<int>{1, 2, INT32_MIN});
+
+  // Readers get the fragments from the manifest, so a fragment written
+  // without updating it is not visible
+  Context ctx_no_manifest;
+  write(ctx_no_manifest, 3, 3);
+  CHECK(read() == std::vector<int>{1, 2, INT32_MIN});
+  write(ctx, 3, 4);
+  CHECK(read() == std::vector<int>{1, 2, 4});
+
+  // Consolidation replaces the consolidated fragments in the manifest
+  REQUIRE_NOTHROW(Array::consolidate(ctx, array_name));
+  CHECK(read() == std::vector<int>{1, 2, 4});
+  write(ctx, 1, 5);
+  CHECK(read() == std::vector<int>{5, 2, 4});
+
+  // Writers and consolidation with deferred vacuum commit without waiting
+  // for the readers that have the array open, which keep their view
+  Array reader(ctx, array_name, TILEDB_READ);
+  write(ctx, 2, 6);
+  Config consolidation_config;
+  consolidation_config["sm.consolidation.deferred_vacuum"] = "true";
+  REQUIRE_NOTHROW(Array::consolidate(ctx, array_name, &consolidation_config));
+  write(ctx, 3, 7);
+  std::vector<int> values(3);
+  Query query(ctx, reader, TILEDB_READ);
+  query.set_layout(TILEDB_ROW_MAJOR)
+      .set_subarray(std::vector<int>{1, 3})
+      .set_buffer("a", values);
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+  CHECK(values == std::vector<int>{5, 2, 4});
+  reader.close();
+  CHECK(read() == std::vector<int>{5, 6, 7});
+  REQUIRE_NOTHROW(Array::vacuum(ctx, array_name));
+  CHECK(read() == std::vector<int>{5, 6, 7});
+
+  remove_array(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test consolidation by copying tiles", "[cppapi][consolidation]") {
+  std::string array_name = "cppapi_consolidation_tile_copy";
+  remove_array(array_name);
+
+  Context ctx;
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 100}}, 10));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain).set_capacity(2);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  schema.add_attribute(Attribute::create<std::string>(ctx, "b"));
+  Array::create(array_name, schema);
+
+  auto write = [&](std::vector<int> d) {
+    std::vector<int> a;
+    std::vector<uint64_t> b_off;
+    std::string b;
+    for (auto c : d) {
+      a.push_back(10 * c);
+      b_off.push_back(b.size());
+      b += std::string((size_t)c % 3 + 1, 'a' + (char)(c % 26));
+    }
+    Array array(ctx, array_name, TILEDB_WRITE);
+    Query query(ctx, array, TILEDB_WRITE);
+    query.set_layout(TILEDB_UNORDERED)
+        .set_buffer("a", a)
+        .set_buffer("b", b_off, b)
+        .set_buffer("d", d);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    array.close();
+  };
+  auto check = [&](const std::vector<int>& c_d) {
+    std::vector<int> d(10), a(10);
+    std::vector<uint64_t> b_off(10);
+    std::string b;
+    b.resize(100);
+    Array array(ctx, array_name, TILEDB_READ);
+    Query query(ctx, array, TILEDB_READ);
+    query.set_layout(TILEDB_GLOBAL_ORDER)
+        .set_buffer("a", a)
+        .set_buffer("b", b_off, b)
+        .set_buffer("d", d);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    array.close();
+    auto result_num = query.result_buffer_elements()["d"].second;
+    REQUIRE(result_num == c_d.size());
+    d.resize(result_num);
+    CHECK(d == c_d);
+    for (size_t i = 0; i < result_num; ++i) {
+      CHECK(a[i] == 10 * d[i]);
+      CHECK(b[b_off[i]] == 'a' + (char)(d[i] % 26));
+    }
+  };
+
+  // Written out of the global order, with full tiles except for the last
+  write({11, 12, 13});
+  write({1, 2, 3, 4});
+  CHECK(num_fragments(array_name) == 2);
+  REQUIRE_NOTHROW(Array::consolidate(ctx, array_name));
+  CHECK(num_fragments(array_name) == 1);
+  check({1, 2, 3, 4, 11, 12, 13});
+
+  // The consolidated fragment now ends with a partial tile, so its cells
+  // are consolidated by decoding them
+  write({50});
+  write({60, 61});
+  REQUIRE_NOTHROW(Array::consolidate(ctx, array_name));
+  CHECK(num_fragments(array_name) == 1);
+  check({1, 2, 3, 4, 11, 12, 13, 50, 60, 61});
+
+  remove_array(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test dense consolidation rewriting only overlapping tiles",
+    "[cppapi][consolidation]") {
+  std::string array_name = "cppapi_consolidation_dense_tile_copy";
+  remove_array(array_name);
+
+  Context ctx;
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 8}}, 2));
+  ArraySchema schema(ctx, TILEDB_DENSE);
+  schema.set_domain(domain);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  schema.add_attribute(Attribute::create<std::string>(ctx, "b"));
+  Array::create(array_name, schema);
+
+  auto write = [&](const std::vector<int>& subarray, std::vector<int> a) {
+    std::vector<uint64_t> b_off;
+    std::string b;
+    for (auto v : a) {
+      b_off.push_back(b.size());
+      b += std::to_string(v);
+    }
+    Array array(ctx, array_name, TILEDB_WRITE);
+    Query query(ctx, array, TILEDB_WRITE);
+    query.set_layout(TILEDB_ROW_MAJOR)
+        .set_subarray(subarray)
+        .set_buffer("a", a)
+        .set_buffer("b", b_off, b);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    array.close();
+  };
+  auto check = [&](const std::vector<int>& c_a) {
+    std::vector<int> a(8);
+    std::vector<uint64_t> b_off(8);
+    std::string b;
+    b.resize(100);
+    Array array(ctx, array_name, TILEDB_READ);
+    Query query(ctx, array, TILEDB_READ);
+    query.set_layout(TILEDB_ROW_MAJOR)
+        .set_subarray(std::vector<int>{1, 8})
+        .set_buffer("a", a)
+        .set_buffer("b", b_off, b);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    array.close();
+    auto result = query.result_buffer_elements();
+    REQUIRE(result["a"].second == c_a.size());
+    CHECK(a == c_a);
+    b.resize(result["b"].second);
+    std::string c_b;
+    for (auto v : c_a)
+      c_b += std::to_string(v);
+    CHECK(b == c_b);
+  };
+
+  // Only the second of the four space tiles is covered by both fragments
+  write({1, 8}, {1, 2, 3, 4, 5, 6, 7, 8});
+  write({3, 3}, {30});
+  REQUIRE_NOTHROW(Array::consolidate(ctx, array_name));
+  CHECK(num_fragments(array_name) == 1);
+  check({1, 2, 30, 4, 5, 6, 7, 8});
+
+  // Overwriting most space tiles consolidates the cells as usual
+  write({2, 7}, {20, 300, 40, 50, 60, 70});
+  REQUIRE_NOTHROW(Array::consolidate(ctx, array_name));
+  CHECK(num_fragments(array_name) == 1);
+  check({1, 20, 300, 40, 50, 60, 70, 8});
+
+  remove_array(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test background consolidation", "[cppapi][consolidation]") {
+  std::string array_name = "cppapi_consolidation_auto";
+  remove_array(array_name);
+  create_array(array_name);
+
+  Config config;
+  config["sm.consolidation.auto_interval_ms"] = "10";
+  config["sm.consolidation.auto_fragment_num"] = "3";
+  Context ctx(config);
+  auto write = [&](int i, int v) {
+    Array array(ctx, array_name, TILEDB_WRITE);
+    Query query(ctx, array, TILEDB_WRITE);
+    query.set_layout(TILEDB_ROW_MAJOR);
+    query.set_subarray(std::vector<int>{i, i});
+    std::vector<int> values = {v};
+    query.set_buffer("a", values);
+    query.submit();
+    array.close();
+  };
+
+  // Arrays with fewer fragments than the threshold are left alone
+  write(1, 1);
+  write(2, 2);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  CHECK(num_fragments(array_name) == 2);
+
+  // The service consolidates the array opened for writes in the background
+  write(3, 3);
+  for (int i = 0; i < 500 && num_fragments(array_name) > 1; ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  CHECK(num_fragments(array_name) == 1);
+  read_array(array_name, {1, 3}, {1, 2, 3});
+
+  remove_array(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test consolidation of a subarray or timestamp range",
+    "[cppapi][consolidation]") {
+  std::string array_name = "cppapi_consolidation_region";
+  remove_array(array_name);
+
+  create_array(array_name);
+  write_array(array_name, {1, 1}, {1});
+  write_array(array_name, {2, 2}, {2});
+  write_array(array_name, {3, 3}, {3});
+  CHECK(num_fragments(array_name) == 3);
+
+  Context ctx;
+  Config config;
+
+  // Invalid subarrays are rejected
+  config["sm.consolidation.subarray"] = "1,2,3";
+  CHECK_THROWS(Array::consolidate(ctx, array_name, &config));
+  config["sm.consolidation.subarray"] = "2,1";
+  CHECK_THROWS(Array::consolidate(ctx, array_name, &config));
+
+  // No fragment is in the timestamp range
+  config["sm.consolidation.subarray"] = "";
+  config["sm.consolidation.timestamp_end"] = "0";
+  REQUIRE_NOTHROW(Array::consolidate(ctx, array_name, &config));
+  CHECK(num_fragments(array_name) == 3);
+
+  // A single fragment intersects the subarray
+  config["sm.consolidation.timestamp_end"] = "18446744073709551615";
+  config["sm.consolidation.subarray"] = "3,3";
+  REQUIRE_NOTHROW(Array::consolidate(ctx, array_name, &config));
+  CHECK(num_fragments(array_name) == 3);
+
+  // Only the fragments intersecting the subarray are consolidated
+  config["sm.consolidation.subarray"] = "1,2";
+  REQUIRE_NOTHROW(Array::consolidate(ctx, array_name, &config));
+  CHECK(num_fragments(array_name) == 2);
+  read_array(array_name, {1, 3}, {1, 2, 3});
+
+  remove_array(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test parallel consolidation steps", "[cppapi][consolidation]") {
+  std::string array_name = "cppapi_consolidation_parallel";
+  remove_array(array_name);
+
+  Context ctx;
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 4}}, 2));
+  ArraySchema schema(ctx, TILEDB_DENSE);
+  schema.set_domain(domain);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  Array::create(array_name, schema);
+
+  for (int i = 1; i <= 4; ++i)
+    write_array(array_name, {i, i}, {i});
+  CHECK(num_fragments(array_name) == 4);
+
+  // Two steps over disjoint pairs of fragments run at once, each reading
+  // and writing one cell at a time through double buffers
+  Config config;
+  config["sm.consolidation.steps"] = "2";
+  config["sm.consolidation.step_min_frags"] = "2";
+  config["sm.consolidation.step_max_frags"] = "2";
+  config["sm.consolidation.buffer_size"] = "4";
+  config["sm.consolidation.memory_budget"] = "1000";
+  REQUIRE_NOTHROW(Array::consolidate(ctx, array_name, &config));
+  CHECK(num_fragments(array_name) == 2);
+  read_array(array_name, {1, 4}, {1, 2, 3, 4});
+
+  remove_array(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test cost-based consolidation planner",
+    "[cppapi][consolidation]") {
+  std::string array_name = "cppapi_consolidation_planner";
+  remove_array(array_name);
+
+  Context ctx;
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 4}}, 2));
+  ArraySchema schema(ctx, TILEDB_DENSE);
+  schema.set_domain(domain);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  Array::create(array_name, schema);
+
+  write_array(array_name, {1, 2}, {1, 2});
+  write_array(array_name, {3, 4}, {3, 4});
+  CHECK(num_fragments(array_name) == 2);
+
+  Config config;
+  CHECK_THROWS(config["sm.consolidation.planner"] = "foo");
+  config["sm.consolidation.planner"] = "cost";
+
+  // Disjoint fragments that cost nothing to open are not worth rewriting
+  config["sm.consolidation.planner_fragment_cost"] = "0";
+  REQUIRE_NOTHROW(Array::consolidate(ctx, array_name, &config));
+  CHECK(num_fragments(array_name) == 2);
+
+  // A dry run only prints the plan
+  config["sm.consolidation.planner_fragment_cost"] = "1048576";
+  config["sm.consolidation.dry_run"] = "true";
+  REQUIRE_NOTHROW(Array::consolidate(ctx, array_name, &config));
+  CHECK(num_fragments(array_name) == 2);
+
+  // Small fragments are worth consolidating
+  config["sm.consolidation.dry_run"] = "false";
+  REQUIRE_NOTHROW(Array::consolidate(ctx, array_name, &config));
+  CHECK(num_fragments(array_name) == 1);
+  read_array(array_name, {1, 4}, {1, 2, 3, 4});
+
+  remove_array(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test consolidation with deferred vacuum",
+    "[cppapi][consolidation]") {
+  std::string array_name = "cppapi_consolidation_vacuum";
+  remove_array(array_name);
+
+  create_array(array_name);
+  write_array(array_name, {1, 2}, {1, 2});
+  write_array(array_name, {3, 3}, {3});
+
+  // The old fragments stay on disk next to the vacuum file, but are ignored
+  Context ctx;
+  Config config;
+  config["sm.consolidation.deferred_vacuum"] = "true";
+  REQUIRE_NOTHROW(Array::consolidate(ctx, array_name, &config));
+  CHECK(num_fragments(array_name) == 4);
+  read_array(array_name, {1, 3}, {1, 2, 3});
+
+  // A reader opened before the vacuum is waited for
+  Array array(ctx, array_name, TILEDB_READ);
+  std::thread reader([&]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    array.close();
+  });
+  REQUIRE_NOTHROW(Array::vacuum(ctx, array_name));
+  reader.join();
+  CHECK(num_fragments(array_name) == 1);
+  read_array(array_name, {1, 3}, {1, 2, 3});
+
+  // Nothing else to vacuum
+  REQUIRE_NOTHROW(Array::vacuum(ctx, array_name));
+  CHECK(num_fragments(array_name) == 1);
+
+  remove_array(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test consolidation statistics", "[cppapi][consolidation]") {
+  std::string array_name = "cppapi_consolidation_stats";
+  remove_array(array_name);
+
+  create_array(array_name);
+  write_array(array_name, {1, 2}, {1, 2});
+  write_array(array_name, {3, 3}, {3});
+  write_array(array_name, {1, 1}, {10});
+
+  Context ctx;
+  std::string stats;
+  REQUIRE_NOTHROW(stats = Array::consolidate_with_stats(ctx, array_name));
+  CHECK(num_fragments(array_name) == 1);
+  read_array(array_name, {1, 3}, {10, 2, 3});
+
+  auto has = [&](const std::string& field) {
+    return stats.find(field) != std::string::npos;
+  };
+  CHECK(has("\"fragmentsBefore\": 3,"));
+  CHECK(has("\"fragmentsAfter\": 1,"));
+  CHECK(has("\"fragmentsConsolidated\": 3,"));
+  CHECK(has("\"steps\": [\n    { \"fragments\": 3, "));
+  CHECK(!has("\"bytesWritten\": 0,"));
+
+  // Nothing left to consolidate
+  REQUIRE_NOTHROW(stats = Array::consolidate_with_stats(ctx, array_name));
+  CHECK(has("\"fragmentsBefore\": 1,"));
+  CHECK(has("\"fragmentsAfter\": 1,"));
+  CHECK(has("\"steps\": []"));
+
+  remove_array(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test consolidation with pyramid levels",
+    "[cppapi][consolidation][pyramid]") {
+  std::string array_name = "cppapi_consolidation_pyramid";
+  remove_array(array_name);
+
+  create_array(array_name);
+  write_array(array_name, {1, 2}, {1, 2});
+  write_array(array_name, {3, 3}, {3});
+
+  std::string method;
+  SECTION("max") {
+    method = "max";
+  }
+  SECTION("mean") {
+    method = "mean";
+  }
+  Context ctx;
+  Config config;
+  config["sm.consolidation.pyramid_levels"] = "3";
+  config["sm.consolidation.pyramid_method"] = method;
+  REQUIRE_NOTHROW(Array::consolidate(ctx, array_name, &config));
+  read_array(array_name, {1, 3}, {1, 2, 3});
+
+  auto read_level = [&](uint32_t level, const std::vector<int>& subarray) {
+    Array array(ctx, array_name, TILEDB_READ);
+    Query query(ctx, array, TILEDB_READ);
+    query.set_resolution_level(level).set_layout(TILEDB_ROW_MAJOR);
+    query.set_subarray(subarray);
+    std::vector<int> values(10);
+    query.set_buffer("a", values);
+    query.submit();
+    CHECK(query.query_status() == Query::Status::COMPLETE);
+    values.resize(query.result_buffer_elements()["a"].second);
+    return values;
+  };
+
+  // Level 1 halves the 3 cells, and level 2 is the last one
+  CHECK(read_level(0, {1, 3}) == std::vector<int>{1, 2, 3});
+  CHECK(read_level(1, {1, 2}) == std::vector<int>{2, 3});
+  CHECK(read_level(2, {1, 1}) == std::vector<int>{3});
+  CHECK_THROWS(read_level(3, {1, 1}));
+
+  remove_array(array_name);
+}
@@ -33,6 +33,9 @@
 #include "catch.hpp"
 #include "tiledb/sm/cpp_api/tiledb"
 
+#include <cstring>
+#include <limits>
+
 static void check_filters(
     const tiledb::FilterList& answer, const tiledb::FilterList& check) {
   REQUIRE(check.nfilters() == answer.nfilters());
@@ -222,3 +225,465 @@ TEST_CASE("C++ API: Filter lists on array", "[cppapi], [filter]") {
   if (vfs.is_dir(array_name))
     vfs.remove_dir(array_name);
 }
+
+TEST_CASE(
+    "C++ API: Zstd dictionary compression on array", "[cppapi], [filter]") {
+  using namespace tiledb;
+  Context ctx;
+  VFS vfs(ctx);
+  std::string array_name = "cpp_unit_array";
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  // Dictionaries are only supported by zstd
+  Filter bzip2(ctx, TILEDB_FILTER_BZIP2);
+  REQUIRE_THROWS_AS(
+      bzip2.set_option(TILEDB_COMPRESSION_DICTIONARY_SIZE, 1024u),
+      TileDBError);
+
+  Filter zstd(ctx, TILEDB_FILTER_ZSTD);
+  uint32_t dict_size;
+  zstd.get_option(TILEDB_COMPRESSION_DICTIONARY_SIZE, &dict_size);
+  REQUIRE(dict_size == 0);
+  zstd.set_option(TILEDB_COMPRESSION_DICTIONARY_SIZE, 4096u);
+  zstd.get_option(TILEDB_COMPRESSION_DICTIONARY_SIZE, &dict_size);
+  REQUIRE(dict_size == 4096);
+
+  // Create a dense array with a dictionary-compressed string attribute,
+  // chunked finely so that each tile has many chunks
+  FilterList a_filters(ctx);
+  a_filters.set_max_chunk_size(1024);
+  a_filters.add_filter(zstd);
+  auto a = Attribute::create<std::string>(ctx, "a");
+  a.set_filter_list(a_filters);
+
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 20000}}, 10000));
+  ArraySchema schema(ctx, TILEDB_DENSE);
+  schema.set_domain(domain);
+  schema.add_attribute(a);
+  Array::create(array_name, schema);
+
+  // Write repetitive strings
+  std::vector<std::string> a_data;
+  for (int i = 0; i < 20000; i++)
+    a_data.push_back(
+        "value_" + std::to_string(i % 97) + "_suffix_" + std::to_string(i));
+  auto a_buf = ungroup_var_buffer(a_data);
+  Array array(ctx, array_name, TILEDB_WRITE);
+  Query query(ctx, array);
+  query.set_buffer("a", a_buf).set_layout(TILEDB_ROW_MAJOR);
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+  array.close();
+
+  // Read back and check the schema kept the dictionary size
+  array.open(TILEDB_READ);
+  uint32_t dict_size_r;
+  array.schema()
+      .attribute("a")
+      .filter_list()
+      .filter(0)
+      .get_option(TILEDB_COMPRESSION_DICTIONARY_SIZE, &dict_size_r);
+  REQUIRE(dict_size_r == 4096);
+
+  std::vector<int> subarray = {1, 20000};
+  std::vector<uint64_t> a_read_off(20000);
+  std::string a_read_data;
+  a_read_data.resize(a_buf.second.size());
+  Query query_r(ctx, array);
+  query_r.set_subarray(subarray)
+      .set_layout(TILEDB_ROW_MAJOR)
+      .set_buffer("a", a_read_off, a_read_data);
+  REQUIRE(query_r.submit() == Query::Status::COMPLETE);
+  array.close();
+  REQUIRE(a_read_off == a_buf.first);
+  REQUIRE(a_read_data == std::string(a_buf.second.begin(), a_buf.second.end()));
+
+  // Clean up
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Byteshuffling compression on array", "[cppapi], [filter]") {
+  using namespace tiledb;
+  Context ctx;
+  VFS vfs(ctx);
+  std::string array_name = "cpp_unit_array";
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  // Byteshuffling is only supported by lz4 and zstd
+  Filter gzip(ctx, TILEDB_FILTER_GZIP);
+  REQUIRE_THROWS_AS(
+      gzip.set_option(TILEDB_COMPRESSION_BYTESHUFFLE, 1u), TileDBError);
+
+  Filter lz4(ctx, TILEDB_FILTER_LZ4);
+  uint32_t shuffle;
+  lz4.get_option(TILEDB_COMPRESSION_BYTESHUFFLE, &shuffle);
+  REQUIRE(shuffle == 0);
+  lz4.set_option(TILEDB_COMPRESSION_BYTESHUFFLE, 1u);
+  lz4.get_option(TILEDB_COMPRESSION_BYTESHUFFLE, &shuffle);
+  REQUIRE(shuffle == 1);
+
+  // Create a dense array with a byteshuffled, lz4-compressed attribute
+  FilterList a_filters(ctx);
+  a_filters.add_filter(lz4);
+  auto a = Attribute::create<double>(ctx, "a");
+  a.set_filter_list(a_filters);
+
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 100000}}, 50000));
+  ArraySchema schema(ctx, TILEDB_DENSE);
+  schema.set_domain(domain);
+  schema.add_attribute(a);
+  Array::create(array_name, schema);
+
+  // Write slowly varying values
+  std::vector<double> a_data(100000);
+  for (int i = 0; i < 100000; i++)
+    a_data[i] = 100.0 + 0.25 * (i % 1000);
+  Array array(ctx, array_name, TILEDB_WRITE);
+  Query query(ctx, array);
+  query.set_buffer("a", a_data).set_layout(TILEDB_ROW_MAJOR);
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+  array.close();
+
+  // Read back and check the schema kept the option
+  array.open(TILEDB_READ);
+  uint32_t shuffle_r;
+  array.schema()
+      .attribute("a")
+      .filter_list()
+      .filter(0)
+      .get_option(TILEDB_COMPRESSION_BYTESHUFFLE, &shuffle_r);
+  REQUIRE(shuffle_r == 1);
+
+  std::vector<int> subarray = {1, 100000};
+  std::vector<double> a_read(100000);
+  Query query_r(ctx, array);
+  query_r.set_subarray(subarray)
+      .set_layout(TILEDB_ROW_MAJOR)
+      .set_buffer("a", a_read);
+  REQUIRE(query_r.submit() == Query::Status::COMPLETE);
+  array.close();
+  REQUIRE(a_read == a_data);
+
+  // Clean up
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Dictionary encoding filter on array", "[cppapi], [filter]") {
+  using namespace tiledb;
+  Context ctx;
+  VFS vfs(ctx);
+  std::string array_name = "cpp_unit_array";
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  // Create a dense array with a dictionary-encoded string attribute, with
+  // small chunks so that chunks must be split at cell boundaries
+  FilterList a_filters(ctx);
+  a_filters.set_max_chunk_size(100);
+  a_filters.add_filter({ctx, TILEDB_FILTER_DICTIONARY});
+  SECTION("- With compression") {
+    a_filters.add_filter({ctx, TILEDB_FILTER_ZSTD});
+  }
+  SECTION("- Without compression") {
+  }
+  auto a = Attribute::create<std::string>(ctx, "a");
+  a.set_filter_list(a_filters);
+
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 1000}}, 300));
+  ArraySchema schema(ctx, TILEDB_DENSE);
+  schema.set_domain(domain);
+  schema.add_attribute(a);
+  Array::create(array_name, schema);
+
+  // Write low-cardinality strings, plus an empty value and a value larger
+  // than the max chunk size
+  std::vector<std::string> symbols = {"AAPL", "MSFT", "GOOG", "AMZN", "TSLA"};
+  std::vector<std::string> a_data;
+  for (int i = 0; i < 1000; i++)
+    a_data.push_back(symbols[i % symbols.size()]);
+  a_data[10] = "";
+  a_data[500] = std::string(250, 'x');
+  auto a_buf = ungroup_var_buffer(a_data);
+  Array array(ctx, array_name, TILEDB_WRITE);
+  Query query(ctx, array);
+  query.set_buffer("a", a_buf).set_layout(TILEDB_ROW_MAJOR);
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+  array.close();
+
+  // Read back
+  array.open(TILEDB_READ);
+  REQUIRE(
+      array.schema().attribute("a").filter_list().filter(0).filter_type() ==
+      TILEDB_FILTER_DICTIONARY);
+  std::vector<int> subarray = {1, 1000};
+  std::vector<uint64_t> a_read_off(1000);
+  std::string a_read_data;
+  a_read_data.resize(a_buf.second.size());
+  Query query_r(ctx, array);
+  query_r.set_subarray(subarray)
+      .set_layout(TILEDB_ROW_MAJOR)
+      .set_buffer("a", a_read_off, a_read_data);
+  REQUIRE(query_r.submit() == Query::Status::COMPLETE);
+  array.close();
+  REQUIRE(a_read_off == a_buf.first);
+  REQUIRE(a_read_data == std::string(a_buf.second.begin(), a_buf.second.end()));
+
+  // Clean up
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE("C++ API: Float XOR filter on array", "[cppapi], [filter]") {
+  using namespace tiledb;
+  Context ctx;
+  VFS vfs(ctx);
+  std::string array_name = "cpp_unit_array";
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  // Create a dense array with float attributes and an integer attribute,
+  // which the filter passes through
+  FilterList filters(ctx);
+  filters.add_filter({ctx, TILEDB_FILTER_FLOAT_XOR});
+  SECTION("- With compression") {
+    filters.add_filter({ctx, TILEDB_FILTER_ZSTD});
+  }
+  SECTION("- Without compression") {
+  }
+  auto a1 = Attribute::create<double>(ctx, "a1");
+  auto a2 = Attribute::create<float>(ctx, "a2");
+  auto a3 = Attribute::create<int64_t>(ctx, "a3");
+  a1.set_filter_list(filters);
+  a2.set_filter_list(filters);
+  a3.set_filter_list(filters);
+
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 10000}}, 3000));
+  ArraySchema schema(ctx, TILEDB_DENSE);
+  schema.set_domain(domain);
+  schema.add_attributes(a1, a2, a3);
+  Array::create(array_name, schema);
+
+  // Write a slowly changing series, with some special values
+  std::vector<double> a1_data(10000);
+  std::vector<float> a2_data(10000);
+  std::vector<int64_t> a3_data(10000);
+  for (int i = 0; i < 10000; i++) {
+    a1_data[i] = 20.0 + (i / 10) * 0.25;
+    a2_data[i] = (float)a1_data[i];
+    a3_data[i] = i;
+  }
+  a1_data[100] = -0.0;
+  a1_data[101] = std::numeric_limits<double>::infinity();
+  a1_data[102] = std::numeric_limits<double>::max();
+  a2_data[5000] = std::numeric_limits<float>::lowest();
+  Array array(ctx, array_name, TILEDB_WRITE);
+  Query query(ctx, array);
+  query.set_buffer("a1", a1_data)
+      .set_buffer("a2", a2_data)
+      .set_buffer("a3", a3_data)
+      .set_layout(TILEDB_ROW_MAJOR);
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+  array.close();
+
+  // Read back
+  array.open(TILEDB_READ);
+  std::vector<int> subarray = {1, 10000};
+  std::vector<double> a1_read(10000);
+  std::vector<float> a2_read(10000);
+  std::vector<int64_t> a3_read(10000);
+  Query query_r(ctx, array);
+  query_r.set_subarray(subarray)
+      .set_layout(TILEDB_ROW_MAJOR)
+      .set_buffer("a1", a1_read)
+      .set_buffer("a2", a2_read)
+      .set_buffer("a3", a3_read);
+  REQUIRE(query_r.submit() == Query::Status::COMPLETE);
+  array.close();
+  REQUIRE(!memcmp(a1_read.data(), a1_data.data(), 10000 * sizeof(double)));
+  REQUIRE(!memcmp(a2_read.data(), a2_data.data(), 10000 * sizeof(float)));
+  REQUIRE(a3_read == a3_data);
+
+  // Clean up
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Frame-of-reference filter on array", "[cppapi], [filter]") {
+  using namespace tiledb;
+  Context ctx;
+  VFS vfs(ctx);
+  std::string array_name = "cpp_unit_array";
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  // Create a dense array with integer attributes and a float attribute,
+  // which the filter passes through
+  FilterList filters(ctx);
+  filters.add_filter({ctx, TILEDB_FILTER_FRAME_OF_REFERENCE});
+  SECTION("- With compression") {
+    filters.add_filter({ctx, TILEDB_FILTER_LZ4});
+  }
+  SECTION("- Without compression") {
+  }
+  auto a1 = Attribute::create<int>(ctx, "a1");
+  auto a2 = Attribute::create<int64_t>(ctx, "a2");
+  auto a3 = Attribute::create<float>(ctx, "a3");
+  a1.set_filter_list(filters);
+  a2.set_filter_list(filters);
+  a3.set_filter_list(filters);
+
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 10000}}, 3000));
+  ArraySchema schema(ctx, TILEDB_DENSE);
+  schema.set_domain(domain);
+  schema.add_attributes(a1, a2, a3);
+  Array::create(array_name, schema);
+
+  // Write clustered values, with some extreme values
+  std::vector<int> a1_data(10000);
+  std::vector<int64_t> a2_data(10000);
+  std::vector<float> a3_data(10000);
+  for (int i = 0; i < 10000; i++) {
+    a1_data[i] = -500 + (i * 7919) % 1000;
+    a2_data[i] = 1000000000000LL + i;
+    a3_data[i] = i * 0.5f;
+  }
+  a1_data[200] = std::numeric_limits<int>::min();
+  a1_data[201] = std::numeric_limits<int>::max();
+  a2_data[9000] = std::numeric_limits<int64_t>::lowest();
+  Array array(ctx, array_name, TILEDB_WRITE);
+  Query query(ctx, array);
+  query.set_buffer("a1", a1_data)
+      .set_buffer("a2", a2_data)
+      .set_buffer("a3", a3_data)
+      .set_layout(TILEDB_ROW_MAJOR);
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+  array.close();
+
+  // Read back
+  array.open(TILEDB_READ);
+  std::vector<int> subarray = {1, 10000};
+  std::vector<int> a1_read(10000);
+  std::vector<int64_t> a2_read(10000);
+  std::vector<float> a3_read(10000);
+  Query query_r(ctx, array);
+  query_r.set_subarray(subarray)
+      .set_layout(TILEDB_ROW_MAJOR)
+      .set_buffer("a1", a1_read)
+      .set_buffer("a2", a2_read)
+      .set_buffer("a3", a3_read);
+  REQUIRE(query_r.submit() == Query::Status::COMPLETE);
+  array.close();
+  REQUIRE(a1_read == a1_data);
+  REQUIRE(a2_read == a2_data);
+  REQUIRE(a3_read == a3_data);
+
+  // Clean up
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Frame-of-reference delta filter on coordinates",
+    "[cppapi], [filter]") {
+  using namespace tiledb;
+  Context ctx;
+  VFS vfs(ctx);
+  std::string array_name = "cpp_unit_array";
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  Filter filter(ctx, TILEDB_FILTER_FRAME_OF_REFERENCE);
+  uint32_t delta;
+  filter.get_option(TILEDB_FRAME_OF_REFERENCE_DELTA, &delta);
+  REQUIRE(delta == 0);
+  filter.set_option(TILEDB_FRAME_OF_REFERENCE_DELTA, 1u);
+  filter.get_option(TILEDB_FRAME_OF_REFERENCE_DELTA, &delta);
+  REQUIRE(delta == 1);
+
+  // Create a sparse array whose coordinate tiles of each dimension are
+  // delta-encoded
+  FilterList coords_filters(ctx);
+  coords_filters.add_filter(filter);
+  SECTION("- With compression") {
+    coords_filters.add_filter({ctx, TILEDB_FILTER_ZSTD});
+  }
+  SECTION("- Without compression") {
+  }
+  const int64_t bound = int64_t(1) << 40;
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int64_t>(
+      ctx, "x", {{-bound, bound}}, int64_t(1) << 30));
+  domain.add_dimension(Dimension::create<int64_t>(
+      ctx, "y", {{-bound, bound}}, int64_t(1) << 30));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain);
+  schema.set_capacity(1000);
+  schema.set_coords_filter_list(coords_filters);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  Array::create(array_name, schema);
+
+  // Write the points of a track, increasing on one dimension and wandering
+  // on the other, with a jump across the domain
+  const int num = 5000;
+  std::vector<int64_t> x(num), y(num);
+  std::vector<int> a(num);
+  for (int i = 0; i < num; i++) {
+    x[i] = (i == 0) ? -bound : x[i - 1] + 1 + (i * 7919) % 3;
+    y[i] = (i == 0) ? 0 : y[i - 1] + (i * 104729) % 21 - 10;
+    a[i] = i;
+  }
+  y[num / 2] = bound;
+  Array array(ctx, array_name, TILEDB_WRITE);
+  Query query(ctx, array);
+  query.set_buffer("x", x)
+      .set_buffer("y", y)
+      .set_buffer("a", a)
+      .set_layout(TILEDB_UNORDERED);
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+  array.close();
+
+  // Read back and check the schema kept the option
+  array.open(TILEDB_READ);
+  uint32_t delta_r;
+  array.schema().coords_filter_list().filter(0).get_option(
+      TILEDB_FRAME_OF_REFERENCE_DELTA, &delta_r);
+  REQUIRE(delta_r == 1);
+
+  std::vector<int64_t> subarray = {-bound, bound, -bound, bound};
+  std::vector<int64_t> x_read(num), y_read(num);
+  std::vector<int> a_read(num);
+  Query query_r(ctx, array);
+  query_r.set_subarray(subarray)
+      .set_layout(TILEDB_UNORDERED)
+      .set_buffer("x", x_read)
+      .set_buffer("y", y_read)
+      .set_buffer("a", a_read);
+  REQUIRE(query_r.submit() == Query::Status::COMPLETE);
+  array.close();
+  REQUIRE(query_r.result_buffer_elements()["a"].second == (uint64_t)num);
+  for (int i = 0; i < num; i++) {
+    REQUIRE(x_read[i] == x[a_read[i]]);
+    REQUIRE(y_read[i] == y[a_read[i]]);
+  }
+
+  // Clean up
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
@@ -696,3 +696,55 @@ TEST_CASE_METHOD(
   // Close array
   array.close();
 }
+
+TEST_CASE_METHOD(
+    CPPMetadataFx,
+    "C++ Metadata, automatic consolidation",
+    "[cppapi][metadata][consolidation]") {
+  // Create default array
+  create_default_array_1d();
+
+  Config config;
+  config["sm.consolidation.auto_array_metadata_num"] = "3";
+  Context ctx(config);
+  VFS vfs(ctx);
+  auto meta_dir = array_name_ + "/__meta";
+
+  // Write items in separate sessions
+  Array array(ctx, array_name_, TILEDB_WRITE);
+  int32_t v = 5;
+  array.put_metadata("bb", TILEDB_INT32, 1, &v);
+  array.put_metadata("aaa", TILEDB_INT32, 1, &v);
+  array.close();
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+  array.open(TILEDB_WRITE);
+  v = 6;
+  array.put_metadata("aaa", TILEDB_INT32, 1, &v);
+  array.close();
+  CHECK(vfs.ls(meta_dir).size() == 2);
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+  // The third file triggers the consolidation
+  array.open(TILEDB_WRITE);
+  array.delete_metadata("bb");
+  array.put_metadata("c", TILEDB_INT32, 1, &v);
+  array.close();
+  CHECK(vfs.ls(meta_dir).size() == 1);
+
+  // Read the latest values, in key order
+  array.open(TILEDB_READ);
+  CHECK(array.metadata_num() == 2);
+  const void* v_r;
+  tiledb_datatype_t v_type;
+  uint32_t v_num;
+  array.get_metadata("bb", &v_type, &v_num, &v_r);
+  CHECK(v_r == nullptr);
+  std::string key;
+  array.get_metadata_from_index(0, &key, &v_type, &v_num, &v_r);
+  CHECK(key == "aaa");
+  CHECK(*((const int32_t*)v_r) == 6);
+  array.get_metadata_from_index(1, &key, &v_type, &v_num, &v_r);
+  CHECK(key == "c");
+  array.close();
+}
@@ -32,7 +32,14 @@
 
 #include "catch.hpp"
 #include "tiledb/sm/cpp_api/tiledb"
+#include "tiledb/sm/misc/stats.h"
 #include "tiledb/sm/misc/utils.h"
+#include "tiledb/sm/query/arrow_export.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <tuple>
 
 using namespace tiledb;
 
@@ -130,3 +137,2653 @@ TEST_CASE(
   if (vfs.is_dir(array_name))
     vfs.remove_dir(array_name);
 }
+
+TEST_CASE(
+    "C++ API: Test sparse reads of overlapping fragments",
+    "[cppapi][query][sparse][dedup]") {
+  const std::string array_name = "cpp_unit_array";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  // Create
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "rows", {{1, 4}}, 2))
+      .add_dimension(Dimension::create<int>(ctx, "cols", {{1, 4}}, 2));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain).set_capacity(2);
+  schema.set_order({{TILEDB_ROW_MAJOR, TILEDB_ROW_MAJOR}});
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  Array::create(array_name, schema);
+
+  // Write two fragments, the second one updating two cells of the first
+  std::vector<std::vector<int>> coords = {{1, 1, 1, 4, 3, 2, 4, 4},
+                                          {1, 4, 2, 2, 3, 2, 4, 1}};
+  std::vector<std::vector<int>> values = {{1, 2, 3, 4}, {20, 21, 22, 23}};
+  for (size_t f = 0; f < 2; ++f) {
+    Array array(ctx, array_name, TILEDB_WRITE);
+    Query query(ctx, array);
+    query.set_layout(TILEDB_UNORDERED)
+        .set_buffer("a", values[f])
+        .set_coordinates(coords[f]);
+    query.submit();
+    array.close();
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+
+  tiledb_layout_t layout = TILEDB_ROW_MAJOR;
+  std::vector<int> expected;
+  SECTION("- Row-major") {
+    layout = TILEDB_ROW_MAJOR;
+    expected = {1, 20, 21, 22, 23, 4};
+  }
+  SECTION("- Col-major") {
+    layout = TILEDB_COL_MAJOR;
+    expected = {1, 23, 21, 22, 20, 4};
+  }
+  SECTION("- Global order") {
+    layout = TILEDB_GLOBAL_ORDER;
+    expected = {1, 21, 20, 22, 23, 4};
+  }
+  SECTION("- Unordered") {
+    layout = TILEDB_UNORDERED;
+    expected = {1, 4, 20, 21, 22, 23};
+  }
+
+  Array array(ctx, array_name, TILEDB_READ);
+  std::vector<int> subarray = {1, 4, 1, 4};
+  std::vector<int> a(8);
+  Query query(ctx, array);
+  query.set_subarray(subarray).set_layout(layout).set_buffer("a", a);
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+  REQUIRE(query.result_buffer_elements()["a"].second == 6);
+  a.resize(6);
+  if (layout == TILEDB_UNORDERED)
+    std::sort(a.begin(), a.end());
+  CHECK(a == expected);
+
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test sparse reads with multiple ranges",
+    "[cppapi][query][sparse][multi-range]") {
+  const std::string array_name = "cpp_unit_array";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  // Create
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "rows", {{1, 4}}, 2))
+      .add_dimension(Dimension::create<int>(ctx, "cols", {{1, 4}}, 2));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain).set_capacity(2);
+  schema.set_order({{TILEDB_ROW_MAJOR, TILEDB_ROW_MAJOR}});
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  Array::create(array_name, schema);
+
+  // Write two fragments, the second one updating two cells of the first
+  std::vector<std::vector<int>> coords = {{1, 1, 1, 4, 3, 2, 4, 4},
+                                          {1, 4, 2, 2, 3, 2, 4, 1}};
+  std::vector<std::vector<int>> values = {{1, 2, 3, 4}, {20, 21, 22, 23}};
+  for (size_t f = 0; f < 2; ++f) {
+    Array array(ctx, array_name, TILEDB_WRITE);
+    Query query(ctx, array);
+    query.set_layout(TILEDB_UNORDERED)
+        .set_buffer("a", values[f])
+        .set_coordinates(coords[f]);
+    query.submit();
+    array.close();
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+
+  tiledb_layout_t layout = TILEDB_ROW_MAJOR;
+  std::vector<int> expected;
+  SECTION("- Row-major") {
+    layout = TILEDB_ROW_MAJOR;
+    expected = {1, 20, 22, 23, 4};
+  }
+  SECTION("- Col-major") {
+    layout = TILEDB_COL_MAJOR;
+    expected = {1, 23, 22, 20, 4};
+  }
+  SECTION("- Unordered") {
+    layout = TILEDB_UNORDERED;
+    expected = {1, 4, 20, 22, 23};
+  }
+
+  // Unsorted point and adjacent ranges
+  Array array(ctx, array_name, TILEDB_READ);
+  std::vector<int> a(8);
+  Query query(ctx, array);
+  query.add_range(0, 4, 4)
+      .add_range(0, 1, 1)
+      .add_range(0, 3, 3)
+      .add_range(1, 4, 4)
+      .add_range(1, 2, 2)
+      .add_range(1, 1, 1)
+      .set_layout(layout)
+      .set_buffer("a", a);
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+  REQUIRE(query.result_buffer_elements()["a"].second == 5);
+  a.resize(5);
+  if (layout == TILEDB_UNORDERED)
+    std::sort(a.begin(), a.end());
+  CHECK(a == expected);
+
+  // The query ranges are left as set
+  CHECK(query.range_num(0) == 3);
+  CHECK(query.range<int>(0, 0)[0] == 4);
+
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test sparse reads with a limit",
+    "[cppapi][query][sparse][limit]") {
+  const std::string array_name = "cpp_unit_array";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  // Create
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "rows", {{1, 4}}, 2))
+      .add_dimension(Dimension::create<int>(ctx, "cols", {{1, 4}}, 2));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain).set_capacity(2);
+  schema.set_order({{TILEDB_ROW_MAJOR, TILEDB_ROW_MAJOR}});
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  Array::create(array_name, schema);
+
+  // Write two fragments, the second one updating two cells of the first
+  std::vector<std::vector<int>> coords = {{1, 1, 1, 4, 3, 2, 4, 4},
+                                          {1, 4, 2, 2, 3, 2, 4, 1}};
+  std::vector<std::vector<int>> values = {{1, 2, 3, 4}, {20, 21, 22, 23}};
+  for (size_t f = 0; f < 2; ++f) {
+    Array array(ctx, array_name, TILEDB_WRITE);
+    Query query(ctx, array);
+    query.set_layout(TILEDB_UNORDERED)
+        .set_buffer("a", values[f])
+        .set_coordinates(coords[f]);
+    query.submit();
+    array.close();
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+
+  // The expected results are the first `limit` results of the layout, or
+  // any `limit` results of unordered reads
+  tiledb_layout_t layout = TILEDB_ROW_MAJOR;
+  std::vector<int> expected;
+  uint64_t limit = 4;
+  uint64_t buffer_num = 8;
+  bool condition = false;
+  SECTION("- Row-major") {
+    layout = TILEDB_ROW_MAJOR;
+    expected = {1, 20, 21, 22};
+  }
+  SECTION("- Global order") {
+    layout = TILEDB_GLOBAL_ORDER;
+    expected = {1, 21, 20, 22};
+  }
+  SECTION("- Unordered") {
+    layout = TILEDB_UNORDERED;
+    expected = {1, 4, 20, 21, 22, 23};
+  }
+  SECTION("- Unordered, single fragment") {
+    Array::consolidate(ctx, array_name);
+    layout = TILEDB_UNORDERED;
+    expected = {1, 4, 20, 21, 22, 23};
+  }
+  SECTION("- Query condition") {
+    layout = TILEDB_ROW_MAJOR;
+    condition = true;
+    limit = 3;
+    expected = {20, 21, 22};
+  }
+  SECTION("- Incomplete submissions") {
+    layout = TILEDB_ROW_MAJOR;
+    buffer_num = 3;
+    expected = {1, 20, 21, 22};
+  }
+  SECTION("- Limit beyond the results") {
+    layout = TILEDB_ROW_MAJOR;
+    limit = 100;
+    expected = {1, 20, 21, 22, 23, 4};
+  }
+
+  Array array(ctx, array_name, TILEDB_READ);
+  std::vector<int> subarray = {1, 4, 1, 4};
+  std::vector<int> a(buffer_num);
+  Query query(ctx, array);
+  query.set_subarray(subarray)
+      .set_layout(layout)
+      .set_buffer("a", a)
+      .set_limit(limit);
+  if (condition)
+    query.set_condition(QueryCondition::create(ctx, "a", 1, TILEDB_GT));
+
+  // Collect the results of all submissions
+  std::vector<int> results;
+  Query::Status status;
+  do {
+    status = query.submit();
+    auto result_num = query.result_buffer_elements()["a"].second;
+    results.insert(results.end(), a.begin(), a.begin() + result_num);
+  } while (status == Query::Status::INCOMPLETE);
+  REQUIRE(status == Query::Status::COMPLETE);
+
+  if (layout == TILEDB_UNORDERED) {
+    REQUIRE(results.size() == limit);
+    for (auto v : results)
+      CHECK(std::count(expected.begin(), expected.end(), v) == 1);
+  } else {
+    CHECK(results == expected);
+  }
+
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE("C++ API: Test query priority", "[cppapi][query][priority]") {
+  const std::string array_name = "cpp_unit_array";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  // Create
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "rows", {{1, 4}}, 2))
+      .add_dimension(Dimension::create<int>(ctx, "cols", {{1, 4}}, 2));
+  ArraySchema schema(ctx, TILEDB_DENSE);
+  schema.set_domain(domain).set_order({{TILEDB_ROW_MAJOR, TILEDB_ROW_MAJOR}});
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  Array::create(array_name, schema);
+
+  // Write with a low priority
+  std::vector<int> values(16);
+  for (int i = 0; i < 16; ++i)
+    values[i] = i;
+  Array array_w(ctx, array_name, TILEDB_WRITE);
+  Query query_w(ctx, array_w);
+  query_w.set_layout(TILEDB_ROW_MAJOR)
+      .set_buffer("a", values)
+      .set_priority(TILEDB_QUERY_PRIORITY_LOW);
+  REQUIRE(query_w.submit() == Query::Status::COMPLETE);
+  array_w.close();
+
+  // Read with a high priority, and asynchronously with a low priority
+  Array array(ctx, array_name, TILEDB_READ);
+  std::vector<int> subarray = {1, 4, 1, 4};
+  std::vector<int> a_high(16), a_low(16);
+  Query query_high(ctx, array), query_low(ctx, array);
+  query_high.set_subarray(subarray)
+      .set_layout(TILEDB_ROW_MAJOR)
+      .set_buffer("a", a_high)
+      .set_priority(TILEDB_QUERY_PRIORITY_HIGH);
+  query_low.set_subarray(subarray)
+      .set_layout(TILEDB_ROW_MAJOR)
+      .set_buffer("a", a_low)
+      .set_priority(TILEDB_QUERY_PRIORITY_LOW);
+  query_low.submit_async([]() {});
+  REQUIRE(query_high.submit() == Query::Status::COMPLETE);
+  while (query_low.query_status() != Query::Status::COMPLETE) {
+    REQUIRE(query_low.query_status() != Query::Status::FAILED);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  CHECK(a_high == values);
+  CHECK(a_low == values);
+
+  // Invalid priority
+  CHECK_THROWS(query_high.set_priority((tiledb_query_priority_t)100));
+
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test dense reads of var-sized attributes",
+    "[cppapi][query][dense][var]") {
+  const std::string array_name = "cpp_unit_array";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  // Create
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "rows", {{1, 4}}, 2))
+      .add_dimension(Dimension::create<int>(ctx, "cols", {{1, 4}}, 2));
+  ArraySchema schema(ctx, TILEDB_DENSE);
+  schema.set_domain(domain).set_order({{TILEDB_ROW_MAJOR, TILEDB_ROW_MAJOR}});
+  schema.add_attribute(Attribute::create<std::string>(ctx, "a"));
+  Array::create(array_name, schema);
+
+  // Write the first two rows, leaving the other cells empty
+  std::vector<std::string> cells;
+  std::vector<uint64_t> offsets;
+  std::string values;
+  for (int i = 0; i < 8; ++i) {
+    cells.push_back(std::string(i % 3 + 1, (char)('a' + i)));
+    offsets.push_back(values.size());
+    values += cells.back();
+  }
+  Array array_w(ctx, array_name, TILEDB_WRITE);
+  Query query_w(ctx, array_w);
+  query_w.set_subarray<int>({1, 2, 1, 4})
+      .set_layout(TILEDB_ROW_MAJOR)
+      .set_buffer("a", offsets, values);
+  query_w.submit();
+  array_w.close();
+
+  tiledb_layout_t layout = TILEDB_ROW_MAJOR;
+  SECTION("- Row-major") {
+    layout = TILEDB_ROW_MAJOR;
+  }
+  SECTION("- Col-major") {
+    layout = TILEDB_COL_MAJOR;
+  }
+  SECTION("- Global order") {
+    layout = TILEDB_GLOBAL_ORDER;
+  }
+
+  // Read the whole array
+  Array array(ctx, array_name, TILEDB_READ);
+  std::vector<uint64_t> r_offsets(16);
+  std::string r_values(64, ' ');
+  Query query(ctx, array);
+  query.set_subarray<int>({1, 4, 1, 4})
+      .set_layout(layout)
+      .set_buffer("a", r_offsets, r_values);
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+
+  std::vector<uint64_t> expected_offsets;
+  std::string expected_values;
+  for (int i = 0; i < 4; ++i) {
+    for (int j = 0; j < 4; ++j) {
+      auto row = (layout == TILEDB_COL_MAJOR) ? j : i;
+      auto col = (layout == TILEDB_COL_MAJOR) ? i : j;
+      if (layout == TILEDB_GLOBAL_ORDER) {
+        // The cells of each 2x2 tile are consecutive
+        row = (i / 2) * 2 + j / 2;
+        col = (i % 2) * 2 + j % 2;
+      }
+      expected_offsets.push_back(expected_values.size());
+      if (row < 2)
+        expected_values += cells[row * 4 + col];
+      else
+        expected_values += std::numeric_limits<char>::min();
+    }
+  }
+  auto result_num = query.result_buffer_elements()["a"];
+  REQUIRE(result_num.first == 16);
+  REQUIRE(result_num.second == expected_values.size());
+  CHECK(r_offsets == expected_offsets);
+  CHECK(r_values.substr(0, result_num.second) == expected_values);
+
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test dense reads of compressed full tiles",
+    "[cppapi][query][dense][filter]") {
+  const std::string array_name = "cpp_unit_array";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  // Create
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 12}}, 4));
+  ArraySchema schema(ctx, TILEDB_DENSE);
+  schema.set_domain(domain);
+  FilterList filters(ctx);
+  filters.add_filter({ctx, TILEDB_FILTER_BYTESHUFFLE})
+      .add_filter({ctx, TILEDB_FILTER_ZSTD});
+  auto a = Attribute::create<int>(ctx, "a");
+  a.set_filter_list(filters);
+  schema.add_attribute(a);
+  Array::create(array_name, schema);
+
+  // Write
+  std::vector<int> data(12);
+  for (int i = 0; i < 12; ++i)
+    data[i] = 10 * (i + 1);
+  Array array_w(ctx, array_name, TILEDB_WRITE);
+  Query query_w(ctx, array_w);
+  query_w.set_subarray<int>({1, 12})
+      .set_layout(TILEDB_ROW_MAJOR)
+      .set_buffer("a", data);
+  query_w.submit();
+  array_w.close();
+
+  // The partial first tile shifts the full tiles within the result buffer
+  int start = 1;
+  tiledb_layout_t layout = TILEDB_ROW_MAJOR;
+  SECTION("- Full tiles, row-major") {
+    start = 1;
+    layout = TILEDB_ROW_MAJOR;
+  }
+  SECTION("- Full tiles, global order") {
+    start = 1;
+    layout = TILEDB_GLOBAL_ORDER;
+  }
+  SECTION("- Partial first tile") {
+    start = 3;
+    layout = TILEDB_ROW_MAJOR;
+  }
+
+  // Read twice, the second time from the tile cache
+  Array array(ctx, array_name, TILEDB_READ);
+  for (int r = 0; r < 2; ++r) {
+    std::vector<int> r_data(12, 0);
+    Query query(ctx, array);
+    query.set_subarray<int>({start, 12})
+        .set_layout(layout)
+        .set_buffer("a", r_data);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    REQUIRE(query.result_buffer_elements()["a"].second == 12u - (start - 1));
+    for (int i = start; i <= 12; ++i)
+      CHECK(r_data[i - start] == data[i - 1]);
+  }
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test sparse reads within the tile memory budget",
+    "[cppapi][query][sparse][memory-budget]") {
+  const std::string array_name = "cpp_unit_array";
+  Config config;
+  config["sm.memory_budget"] = "40";
+  Context ctx(config);
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  // Create
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 8}}, 8));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain).set_capacity(2);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  Array::create(array_name, schema);
+
+  // Write 8 cells in 4 tiles, each tile of a field taking 8 bytes
+  std::vector<int> coords = {1, 2, 3, 4, 5, 6, 7, 8};
+  std::vector<int> data = {10, 20, 30, 40, 50, 60, 70, 80};
+  Array array_w(ctx, array_name, TILEDB_WRITE);
+  Query query_w(ctx, array_w);
+  query_w.set_layout(TILEDB_GLOBAL_ORDER)
+      .set_coordinates(coords)
+      .set_buffer("a", data);
+  query_w.submit();
+  query_w.finalize();
+  array_w.close();
+
+  tiledb::sm::stats::all_stats.set_enabled(true);
+  tiledb::sm::stats::all_stats.reset();
+
+  // Each field fits the budget alone, but the tiles of both fields do not
+  Array array(ctx, array_name, TILEDB_READ);
+  std::vector<int> r_coords(8), r_data(8);
+  std::vector<int> all_coords, all_data;
+  Query query(ctx, array);
+  query.set_subarray<int>({1, 8})
+      .set_layout(TILEDB_GLOBAL_ORDER)
+      .set_coordinates(r_coords)
+      .set_buffer("a", r_data);
+  Query::Status status;
+  do {
+    status = query.submit();
+    auto result_num = query.result_buffer_elements()["a"].second;
+    all_coords.insert(
+        all_coords.end(), r_coords.begin(), r_coords.begin() + result_num);
+    all_data.insert(
+        all_data.end(), r_data.begin(), r_data.begin() + result_num);
+  } while (status == Query::Status::INCOMPLETE);
+  REQUIRE(status == Query::Status::COMPLETE);
+  CHECK(all_coords == coords);
+  CHECK(all_data == data);
+
+  auto& stats = tiledb::sm::stats::all_stats;
+  CHECK(stats.counter_reader_tile_memory_overflows > 0);
+  CHECK(stats.counter_reader_tile_memory_peak > 0);
+  CHECK(stats.counter_reader_tile_memory_peak <= 40);
+  stats.set_enabled(false);
+
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test reads overlapping the fetch of the next attribute",
+    "[cppapi][query][dense]") {
+  const std::string array_name = "cpp_unit_array";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  // Create
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 12}}, 4));
+  ArraySchema schema(ctx, TILEDB_DENSE);
+  schema.set_domain(domain);
+  FilterList filters(ctx);
+  filters.add_filter({ctx, TILEDB_FILTER_ZSTD});
+  auto a = Attribute::create<int>(ctx, "a");
+  a.set_filter_list(filters);
+  schema.add_attribute(a);
+  schema.add_attribute(Attribute::create<std::string>(ctx, "b"));
+  schema.add_attribute(Attribute::create<double>(ctx, "c"));
+  Array::create(array_name, schema);
+
+  // Write
+  std::vector<int> a_data(12);
+  std::vector<uint64_t> b_offsets;
+  std::string b_values;
+  std::vector<double> c_data(12);
+  for (int i = 0; i < 12; ++i) {
+    a_data[i] = i;
+    b_offsets.push_back(b_values.size());
+    b_values += std::string(i % 3 + 1, (char)('a' + i));
+    c_data[i] = i / 2.0;
+  }
+  Array array_w(ctx, array_name, TILEDB_WRITE);
+  Query query_w(ctx, array_w);
+  query_w.set_subarray<int>({1, 12})
+      .set_layout(TILEDB_ROW_MAJOR)
+      .set_buffer("a", a_data)
+      .set_buffer("b", b_offsets, b_values)
+      .set_buffer("c", c_data);
+  query_w.submit();
+  array_w.close();
+
+  tiledb::sm::stats::all_stats.set_enabled(true);
+  tiledb::sm::stats::all_stats.reset();
+
+  // Read the cells in the middle of the array
+  Array array(ctx, array_name, TILEDB_READ);
+  std::vector<int> r_a(8);
+  std::vector<uint64_t> r_b_offsets(8);
+  std::string r_b_values(32, ' ');
+  std::vector<double> r_c(8);
+  Query query(ctx, array);
+  query.set_subarray<int>({3, 10})
+      .set_layout(TILEDB_ROW_MAJOR)
+      .set_buffer("a", r_a)
+      .set_buffer("b", r_b_offsets, r_b_values)
+      .set_buffer("c", r_c);
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+
+  auto result_num = query.result_buffer_elements();
+  REQUIRE(result_num["a"].second == 8);
+  REQUIRE(result_num["b"].first == 8);
+  REQUIRE(result_num["c"].second == 8);
+  std::string expected_values =
+      b_values.substr(b_offsets[2], b_offsets[10] - b_offsets[2]);
+  REQUIRE(result_num["b"].second == expected_values.size());
+  for (int i = 0; i < 8; ++i) {
+    CHECK(r_a[i] == a_data[i + 2]);
+    CHECK(r_b_offsets[i] == b_offsets[i + 2] - b_offsets[2]);
+    CHECK(r_c[i] == c_data[i + 2]);
+  }
+  CHECK(r_b_values.substr(0, expected_values.size()) == expected_values);
+
+  auto& stats = tiledb::sm::stats::all_stats;
+  CHECK(stats.counter_reader_num_tile_fetches_overlapped == 2);
+  stats.set_enabled(false);
+
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test unordered sparse reads skipping unneeded dimensions",
+    "[cppapi][query][sparse]") {
+  const std::string array_name = "cpp_unit_array";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  // Create
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "x", {{1, 4}}, 4))
+      .add_dimension(Dimension::create<int>(ctx, "y", {{1, 4}}, 4))
+      .add_dimension(Dimension::create<int>(ctx, "z", {{1, 4}}, 4));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain).set_capacity(4);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  Array::create(array_name, schema);
+
+  // Write
+  std::vector<int> coords;
+  std::vector<int> data;
+  for (int i = 0; i < 8; ++i) {
+    coords.push_back(i % 4 + 1);
+    coords.push_back(i / 4 + 1);
+    coords.push_back(i % 3 + 1);
+    data.push_back(i);
+  }
+  Array array_w(ctx, array_name, TILEDB_WRITE);
+  Query query_w(ctx, array_w);
+  query_w.set_layout(TILEDB_UNORDERED)
+      .set_coordinates(coords)
+      .set_buffer("a", data);
+  query_w.submit();
+  array_w.close();
+
+  tiledb::sm::stats::all_stats.set_enabled(true);
+  tiledb::sm::stats::all_stats.reset();
+
+  // Only the cells with x in [2, 3] are results, so only "x" is read
+  Array array(ctx, array_name, TILEDB_READ);
+  std::vector<int> r_data(8);
+  Query query(ctx, array);
+  query.set_subarray<int>({2, 3, 1, 4, 1, 4})
+      .set_layout(TILEDB_UNORDERED)
+      .set_buffer("a", r_data);
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+
+  auto result_num = query.result_buffer_elements()["a"].second;
+  REQUIRE(result_num == 4);
+  r_data.resize(result_num);
+  std::sort(r_data.begin(), r_data.end());
+  CHECK(r_data == std::vector<int>({1, 2, 5, 6}));
+
+  auto& stats = tiledb::sm::stats::all_stats;
+  CHECK(stats.counter_reader_num_dim_tile_reads_skipped == 2);
+  stats.set_enabled(false);
+
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test sparse reads skipping result tiles without results",
+    "[cppapi][query][sparse]") {
+  const std::string array_name = "cpp_unit_array";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  // Create
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 8}}, 8));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain).set_capacity(2);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  schema.add_attribute(Attribute::create<int>(ctx, "b"));
+  Array::create(array_name, schema);
+
+  // Write 3 tiles, with cells {1, 4}, {5, 6} and {7, 8}
+  std::vector<int> coords = {1, 4, 5, 6, 7, 8};
+  std::vector<int> a_data = {5, 5, 1, 10, 5, 6};
+  std::vector<int> b_data = {100, 400, 500, 600, 700, 800};
+  Array array_w(ctx, array_name, TILEDB_WRITE);
+  Query query_w(ctx, array_w);
+  query_w.set_layout(TILEDB_GLOBAL_ORDER)
+      .set_coordinates(coords)
+      .set_buffer("a", a_data)
+      .set_buffer("b", b_data);
+  query_w.submit();
+  query_w.finalize();
+  array_w.close();
+
+  tiledb::sm::stats::all_stats.set_enabled(true);
+  tiledb::sm::stats::all_stats.reset();
+
+  Array array(ctx, array_name, TILEDB_READ);
+  std::vector<int> r_coords(6), r_b(6);
+  Query query(ctx, array);
+  query.set_layout(TILEDB_GLOBAL_ORDER)
+      .set_coordinates(r_coords)
+      .set_buffer("b", r_b);
+  std::vector<int> expected_coords, expected_b;
+  SECTION("- Subarray") {
+    // The first tile overlaps the subarray, but none of its cells do
+    query.set_subarray<int>({2, 5});
+    expected_coords = {5};
+    expected_b = {500};
+  }
+  SECTION("- Query condition") {
+    // The values of the second tile span the condition, but none match
+    query.set_subarray<int>({1, 8});
+    query.set_condition(QueryCondition::create(ctx, "a", 5, TILEDB_EQ));
+    expected_coords = {1, 4, 7};
+    expected_b = {100, 400, 700};
+  }
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+
+  auto result_num = query.result_buffer_elements()["b"].second;
+  REQUIRE(result_num == expected_b.size());
+  r_coords.resize(result_num);
+  r_b.resize(result_num);
+  CHECK(r_coords == expected_coords);
+  CHECK(r_b == expected_b);
+
+  auto& stats = tiledb::sm::stats::all_stats;
+  CHECK(stats.counter_reader_num_empty_result_tiles_removed == 1);
+  stats.set_enabled(false);
+
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test unordered sparse writes sorted on global order keys",
+    "[cppapi][query][sparse]") {
+  const std::string array_name = "cpp_unit_array";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  tiledb_layout_t tile_order = TILEDB_ROW_MAJOR;
+  tiledb_layout_t cell_order = TILEDB_ROW_MAJOR;
+  SECTION("- Row-major tiles, row-major cells") {
+    tile_order = TILEDB_ROW_MAJOR;
+    cell_order = TILEDB_ROW_MAJOR;
+  }
+  SECTION("- Col-major tiles, row-major cells") {
+    tile_order = TILEDB_COL_MAJOR;
+    cell_order = TILEDB_ROW_MAJOR;
+  }
+  SECTION("- Row-major tiles, col-major cells") {
+    tile_order = TILEDB_ROW_MAJOR;
+    cell_order = TILEDB_COL_MAJOR;
+  }
+
+  // Create
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "x", {{-5, 10}}, 4))
+      .add_dimension(Dimension::create<int>(ctx, "y", {{1, 20}}, 5));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain).set_order({{tile_order, cell_order}});
+  schema.set_capacity(7);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  Array::create(array_name, schema);
+
+  // Write distinct cells in a scrambled order
+  std::vector<std::pair<int, int>> cells;
+  for (int i = 0; i < 80; i += 3)
+    cells.emplace_back(-5 + (i * 7) % 16, 1 + (i * 11) % 20);
+  std::vector<int> coords, data;
+  for (size_t i = 0; i < cells.size(); ++i) {
+    coords.push_back(cells[i].first);
+    coords.push_back(cells[i].second);
+    data.push_back((int)i);
+  }
+  Array array_w(ctx, array_name, TILEDB_WRITE);
+  Query query_w(ctx, array_w);
+  query_w.set_layout(TILEDB_UNORDERED)
+      .set_coordinates(coords)
+      .set_buffer("a", data);
+  tiledb::sm::stats::all_stats.set_enabled(true);
+  tiledb::sm::stats::all_stats.reset();
+  query_w.submit();
+  CHECK(tiledb::sm::stats::all_stats.counter_writer_coords_sorted_on_keys == 1);
+  tiledb::sm::stats::all_stats.set_enabled(false);
+  array_w.close();
+
+  // The expected global order
+  auto key = [&](size_t i) {
+    int tx = (cells[i].first + 5) / 4, ty = (cells[i].second - 1) / 5;
+    int x = cells[i].first, y = cells[i].second;
+    return std::make_tuple(
+        tile_order == TILEDB_ROW_MAJOR ? tx : ty,
+        tile_order == TILEDB_ROW_MAJOR ? ty : tx,
+        cell_order == TILEDB_ROW_MAJOR ? x : y,
+        cell_order == TILEDB_ROW_MAJOR ? y : x);
+  };
+  std::vector<size_t> order(cells.size());
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return key(a) < key(b);
+  });
+
+  // Read in global order
+  Array array(ctx, array_name, TILEDB_READ);
+  std::vector<int> r_data(cells.size());
+  Query query(ctx, array);
+  query.set_subarray<int>({-5, 10, 1, 20})
+      .set_layout(TILEDB_GLOBAL_ORDER)
+      .set_buffer("a", r_data);
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+  REQUIRE(query.result_buffer_elements()["a"].second == cells.size());
+  for (size_t i = 0; i < order.size(); ++i)
+    CHECK(r_data[i] == (int)order[i]);
+
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test unordered sparse writes of cells in sorted runs",
+    "[cppapi][query][sparse][sort]") {
+  const std::string array_name = "cpp_unit_array";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  // Create
+  Domain domain(ctx);
+  domain.add_dimension(
+      Dimension::create<int64_t>(ctx, "t", {{0, 1000000}}, 10000));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  Array::create(array_name, schema);
+
+  // Cells appended in order, in two interleaved sorted runs, or scrambled
+  const int num = 20000;
+  std::vector<int64_t> t(num);
+  std::vector<int> data(num);
+  uint64_t already_sorted = 0, runs_merged = 0;
+  SECTION("- Sorted") {
+    for (int i = 0; i < num; ++i)
+      t[i] = 10 * i;
+    already_sorted = 1;
+  }
+  SECTION("- Two sorted runs") {
+    for (int i = 0; i < num; ++i)
+      t[i] = (i < num / 2) ? 20 * i : 20 * (i - num / 2) + 10;
+    runs_merged = 2;
+  }
+  SECTION("- Scrambled") {
+    for (int i = 0; i < num; ++i)
+      t[i] = (int64_t)(i * 7919 % num) * 10;
+  }
+  for (int i = 0; i < num; ++i)
+    data[i] = i;
+
+  Array array_w(ctx, array_name, TILEDB_WRITE);
+  Query query_w(ctx, array_w);
+  query_w.set_layout(TILEDB_UNORDERED)
+      .set_buffer("t", t)
+      .set_buffer("a", data);
+  tiledb::sm::stats::all_stats.set_enabled(true);
+  tiledb::sm::stats::all_stats.reset();
+  REQUIRE(query_w.submit() == Query::Status::COMPLETE);
+  CHECK(
+      tiledb::sm::stats::all_stats.counter_writer_coords_already_sorted ==
+      already_sorted);
+  CHECK(
+      tiledb::sm::stats::all_stats.counter_writer_coords_sorted_runs_merged ==
+      runs_merged);
+  tiledb::sm::stats::all_stats.set_enabled(false);
+  array_w.close();
+
+  // Read in global order
+  Array array(ctx, array_name, TILEDB_READ);
+  std::vector<int64_t> r_t(num);
+  std::vector<int> r_data(num);
+  Query query(ctx, array);
+  query.set_subarray<int64_t>({0, 1000000})
+      .set_layout(TILEDB_GLOBAL_ORDER)
+      .set_buffer("t", r_t)
+      .set_buffer("a", r_data);
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+  REQUIRE(query.result_buffer_elements()["a"].second == (uint64_t)num);
+  for (int i = 0; i < num; ++i) {
+    CHECK(r_t[i] == 10 * i);
+    CHECK(t[r_data[i]] == r_t[i]);
+  }
+
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test global order writes flushing tiles asynchronously",
+    "[cppapi][query][dense][global]") {
+  const std::string array_name = "cpp_unit_array";
+  Config config;
+  config["sm.write_async_flush"] = "true";
+  Context ctx(config);
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  // Create
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 20}}, 4));
+  ArraySchema schema(ctx, TILEDB_DENSE);
+  schema.set_domain(domain);
+  FilterList filters(ctx);
+  filters.add_filter({ctx, TILEDB_FILTER_ZSTD});
+  auto a = Attribute::create<int>(ctx, "a");
+  a.set_filter_list(filters);
+  schema.add_attribute(a);
+  schema.add_attribute(Attribute::create<std::string>(ctx, "b"));
+  Array::create(array_name, schema);
+
+  // Write in three submissions, refilling the same buffers
+  std::vector<int> a_data;
+  std::vector<uint64_t> b_offsets;
+  std::string b_values;
+  std::vector<int> expected_a;
+  std::string expected_b;
+  Array array_w(ctx, array_name, TILEDB_WRITE);
+  Query query_w(ctx, array_w);
+  query_w.set_subarray<int>({1, 20}).set_layout(TILEDB_GLOBAL_ORDER);
+  int cell = 0;
+  for (int cell_num : {6, 6, 8}) {
+    a_data.clear();
+    b_offsets.clear();
+    b_values.clear();
+    for (int i = 0; i < cell_num; ++i, ++cell) {
+      a_data.push_back(cell * 10);
+      b_offsets.push_back(b_values.size());
+      b_values += std::string(cell % 3 + 1, (char)('a' + cell));
+    }
+    expected_a.insert(expected_a.end(), a_data.begin(), a_data.end());
+    expected_b += b_values;
+    query_w.set_buffer("a", a_data).set_buffer("b", b_offsets, b_values);
+    REQUIRE(query_w.submit() == Query::Status::COMPLETE);
+  }
+  query_w.finalize();
+  array_w.close();
+
+  // Read
+  Array array(ctx, array_name, TILEDB_READ);
+  std::vector<int> r_a(20);
+  std::vector<uint64_t> r_b_offsets(20);
+  std::string r_b_values(expected_b.size(), ' ');
+  Query query(ctx, array);
+  query.set_subarray<int>({1, 20})
+      .set_layout(TILEDB_ROW_MAJOR)
+      .set_buffer("a", r_a)
+      .set_buffer("b", r_b_offsets, r_b_values);
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+  CHECK(r_a == expected_a);
+  CHECK(r_b_values == expected_b);
+
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test global order writes of fragment parts in parallel",
+    "[cppapi][query][sparse][global]") {
+  const std::string array_name = "cpp_unit_array";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  // Create
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 1000}}, 100));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain).set_capacity(4);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  schema.add_attribute(Attribute::create<std::string>(ctx, "b"));
+  Array::create(array_name, schema);
+
+  // Write three parts from different threads, in two submissions each. The
+  // first two parts consist of full tiles.
+  auto write_part = [&](Query* query, int first, int cell_num) {
+    std::vector<int> coords, a_data;
+    std::vector<uint64_t> b_offsets;
+    std::string b_values;
+    for (int half = 0; half < 2; ++half) {
+      coords.clear();
+      a_data.clear();
+      b_offsets.clear();
+      b_values.clear();
+      for (int i = half * cell_num / 2; i < (half + 1) * cell_num / 2; ++i) {
+        coords.push_back(first + i);
+        a_data.push_back((first + i) * 10);
+        b_offsets.push_back(b_values.size());
+        b_values += std::string((first + i) % 3 + 1, 'a' + (first + i) % 26);
+      }
+      query->set_coordinates(coords)
+          .set_buffer("a", a_data)
+          .set_buffer("b", b_offsets, b_values)
+          .submit();
+    }
+    query->finalize();
+  };
+  Array array_w(ctx, array_name, TILEDB_WRITE);
+  Query query_w(ctx, array_w);
+  query_w.set_layout(TILEDB_GLOBAL_ORDER);
+  std::vector<std::unique_ptr<Query>> parts;
+  for (uint32_t p = 0; p < 3; ++p) {
+    parts.emplace_back(new Query(ctx, array_w));
+    parts.back()->set_layout(TILEDB_GLOBAL_ORDER).set_fragment_part(query_w, p);
+  }
+  CHECK_THROWS(parts[0]->set_fragment_part(query_w, 0));
+  std::vector<std::thread> producers;
+  producers.emplace_back(write_part, parts[2].get(), 17, 6);
+  producers.emplace_back(write_part, parts[0].get(), 1, 8);
+  producers.emplace_back(write_part, parts[1].get(), 9, 8);
+  for (auto& producer : producers)
+    producer.join();
+  for (auto& part : parts)
+    CHECK(part->query_status() == Query::Status::COMPLETE);
+  query_w.finalize();
+  REQUIRE(query_w.fragment_num() == 1);
+  CHECK(!vfs.is_dir(query_w.fragment_uri(0) + "/__parts"));
+  array_w.close();
+
+  // Read
+  Array array(ctx, array_name, TILEDB_READ);
+  std::vector<int> r_coords(30), r_a(30);
+  std::vector<uint64_t> r_b_offsets(30);
+  std::string r_b_values(100, ' ');
+  Query query(ctx, array);
+  query.set_subarray<int>({1, 1000})
+      .set_layout(TILEDB_GLOBAL_ORDER)
+      .set_coordinates(r_coords)
+      .set_buffer("a", r_a)
+      .set_buffer("b", r_b_offsets, r_b_values);
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+  auto result_num = query.result_buffer_elements()["a"].second;
+  REQUIRE(result_num == 22);
+  std::string expected_b;
+  for (int i = 0; i < 22; ++i) {
+    CHECK(r_coords[i] == i + 1);
+    CHECK(r_a[i] == (i + 1) * 10);
+    expected_b += std::string((i + 1) % 3 + 1, 'a' + (i + 1) % 26);
+  }
+  CHECK(r_b_values.substr(0, expected_b.size()) == expected_b);
+  array.close();
+
+  // A part other than the last one that ends with a partial tile cannot be
+  // stitched
+  Array array_w2(ctx, array_name, TILEDB_WRITE);
+  Query query_w2(ctx, array_w2);
+  query_w2.set_layout(TILEDB_GLOBAL_ORDER);
+  Query part_0(ctx, array_w2), part_1(ctx, array_w2);
+  part_0.set_layout(TILEDB_GLOBAL_ORDER).set_fragment_part(query_w2, 0);
+  part_1.set_layout(TILEDB_GLOBAL_ORDER).set_fragment_part(query_w2, 1);
+  write_part(&part_0, 101, 6);
+  write_part(&part_1, 201, 8);
+  CHECK_THROWS(query_w2.finalize());
+  array_w2.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test ordered dense writes borrowing full tiles",
+    "[cppapi][query][dense]") {
+  const std::string array_name = "cpp_unit_array";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  // Create
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 20}}, 4));
+  ArraySchema schema(ctx, TILEDB_DENSE);
+  schema.set_domain(domain);
+  FilterList filters(ctx);
+  filters.add_filter({ctx, TILEDB_FILTER_ZSTD});
+  auto a = Attribute::create<int>(ctx, "a");
+  a.set_filter_list(filters);
+  schema.add_attribute(a);
+  schema.add_attribute(Attribute::create<std::string>(ctx, "b"));
+  Array::create(array_name, schema);
+
+  // Write cells [3, 18], which cover three full tiles of "a"
+  std::vector<int> a_data;
+  std::vector<uint64_t> b_offsets;
+  std::string b_values;
+  for (int i = 3; i <= 18; ++i) {
+    a_data.push_back(i * 10);
+    b_offsets.push_back(b_values.size());
+    b_values += std::string(i % 3 + 1, (char)('a' + i));
+  }
+  auto expected_a = a_data;
+  tiledb::sm::stats::all_stats.set_enabled(true);
+  tiledb::sm::stats::all_stats.reset();
+  Array array_w(ctx, array_name, TILEDB_WRITE);
+  Query query_w(ctx, array_w);
+  query_w.set_subarray<int>({3, 18})
+      .set_layout(TILEDB_ROW_MAJOR)
+      .set_buffer("a", a_data)
+      .set_buffer("b", b_offsets, b_values);
+  REQUIRE(query_w.submit() == Query::Status::COMPLETE);
+  array_w.close();
+  CHECK(tiledb::sm::stats::all_stats.counter_writer_num_tiles_borrowed == 3);
+  tiledb::sm::stats::all_stats.set_enabled(false);
+  CHECK(a_data == expected_a);
+
+  // Read
+  Array array(ctx, array_name, TILEDB_READ);
+  std::vector<int> r_a(16);
+  std::vector<uint64_t> r_b_offsets(16);
+  std::string r_b_values(b_values.size(), ' ');
+  Query query(ctx, array);
+  query.set_subarray<int>({3, 18})
+      .set_layout(TILEDB_ROW_MAJOR)
+      .set_buffer("a", r_a)
+      .set_buffer("b", r_b_offsets, r_b_values);
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+  CHECK(r_a == expected_a);
+  CHECK(r_b_offsets == b_offsets);
+  CHECK(r_b_values == b_values);
+
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test unordered writes split into disjoint fragments",
+    "[cppapi][query][sparse][unordered]") {
+  const std::string array_name = "cpp_unit_array";
+  Config config;
+  config["sm.unordered_write_fragment_num"] = "4";
+  Context ctx(config);
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  // Create
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d1", {{1, 100}}, 10))
+      .add_dimension(Dimension::create<int>(ctx, "d2", {{1, 100}}, 10));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain).set_capacity(8);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  schema.add_attribute(Attribute::create<std::string>(ctx, "b"));
+  Array::create(array_name, schema);
+
+  // Write 200 cells in a shuffled order, 20 per space tile row
+  std::vector<std::tuple<int, int, int, std::string>> cells;
+  std::vector<int> coords, a_data;
+  std::vector<uint64_t> b_offsets;
+  std::string b_values;
+  for (int k = 0; k < 200; ++k) {
+    int i = (k * 7) % 200;
+    int d1 = i / 2 + 1, d2 = (i * 37) % 100 + 1;
+    std::string b(i % 3 + 1, (char)('a' + i % 26));
+    cells.emplace_back(d1, d2, i, b);
+    coords.push_back(d1);
+    coords.push_back(d2);
+    a_data.push_back(i);
+    b_offsets.push_back(b_values.size());
+    b_values += b;
+  }
+  Array array_w(ctx, array_name, TILEDB_WRITE);
+  Query query_w(ctx, array_w);
+  query_w.set_layout(TILEDB_UNORDERED)
+      .set_coordinates(coords)
+      .set_buffer("a", a_data)
+      .set_buffer("b", b_offsets, b_values);
+  REQUIRE(query_w.submit() == Query::Status::COMPLETE);
+  CHECK(query_w.fragment_num() == 4);
+  array_w.close();
+
+  // Read
+  std::sort(cells.begin(), cells.end());
+  Array array(ctx, array_name, TILEDB_READ);
+  std::vector<int> r_coords(400), r_a(200);
+  std::vector<uint64_t> r_b_offsets(200);
+  std::string r_b_values(b_values.size(), ' ');
+  Query query(ctx, array);
+  query.set_subarray<int>({1, 100, 1, 100})
+      .set_layout(TILEDB_ROW_MAJOR)
+      .set_coordinates(r_coords)
+      .set_buffer("a", r_a)
+      .set_buffer("b", r_b_offsets, r_b_values);
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+  std::string expected_b;
+  for (size_t c = 0; c < cells.size(); ++c) {
+    CHECK(r_coords[2 * c] == std::get<0>(cells[c]));
+    CHECK(r_coords[2 * c + 1] == std::get<1>(cells[c]));
+    CHECK(r_a[c] == std::get<2>(cells[c]));
+    CHECK(r_b_offsets[c] == expected_b.size());
+    expected_b += std::get<3>(cells[c]);
+  }
+  CHECK(r_b_values == expected_b);
+
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test sparse writes recommending a tile capacity",
+    "[cppapi][query][sparse]") {
+  const std::string array_name = "cpp_unit_array";
+  Config config;
+  config["sm.capacity_target_tile_size"] = "4000";
+  Context ctx(config);
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  // Create an array with unfiltered tiles
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 10000}}, 100));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain).set_capacity(100);
+  schema.set_coords_filter_list(FilterList(ctx));
+  schema.set_offsets_filter_list(FilterList(ctx));
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  schema.add_attribute(Attribute::create<std::string>(ctx, "b"));
+  Array::create(array_name, schema);
+
+  // Write 1000 cells with 10 characters each on "b"
+  std::vector<int> coords, a_data;
+  std::vector<uint64_t> b_offsets;
+  std::string b_values;
+  for (int i = 0; i < 1000; ++i) {
+    coords.push_back(i + 1);
+    a_data.push_back(i);
+    b_offsets.push_back(b_values.size());
+    b_values += std::string(10, (char)('a' + i % 26));
+  }
+
+  SECTION("Unordered") {
+    tiledb::sm::stats::all_stats.set_enabled(true);
+    tiledb::sm::stats::all_stats.reset();
+    Array array(ctx, array_name, TILEDB_WRITE);
+    Query query(ctx, array);
+    query.set_layout(TILEDB_UNORDERED)
+        .set_coordinates(coords)
+        .set_buffer("a", a_data)
+        .set_buffer("b", b_offsets, b_values);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    array.close();
+  }
+
+  SECTION("Global order") {
+    tiledb::sm::stats::all_stats.set_enabled(true);
+    tiledb::sm::stats::all_stats.reset();
+    Array array(ctx, array_name, TILEDB_WRITE);
+    Query query(ctx, array);
+    query.set_layout(TILEDB_GLOBAL_ORDER)
+        .set_coordinates(coords)
+        .set_buffer("a", a_data)
+        .set_buffer("b", b_offsets, b_values);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    query.finalize();
+    array.close();
+  }
+
+  // The values of "b" take 10 bytes per cell, so 400 cells fill 4000 bytes
+  auto& stats = tiledb::sm::stats::all_stats;
+  CHECK(stats.counter_writer_recommended_capacity == 400);
+  stats.set_enabled(false);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test exporting read results to Arrow",
+    "[cppapi][query][arrow]") {
+  const std::string array_name = "cpp_unit_array";
+  Config config;
+  config["sm.var_offsets.bitsize"] = "32";
+  config["sm.var_offsets.extra_element"] = "true";
+  config["sm.var_offsets.mode"] = "elements";
+  Context ctx(config);
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 4}}, 4));
+  ArraySchema schema(ctx, TILEDB_DENSE);
+  schema.set_domain(domain);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  schema.add_attribute(Attribute::create<std::string>(ctx, "b"));
+  schema.add_attribute(Attribute::create<std::vector<int>>(ctx, "c"));
+  Array::create(array_name, schema);
+
+  // Write cells with var-sized values of different lengths, with the
+  // default offsets format
+  Context default_ctx;
+  std::vector<int> a_data = {1, 2, 3, 4};
+  std::vector<uint64_t> b_offsets = {0, 1, 3, 4};
+  std::string b_data = "abbcddd";
+  std::vector<uint64_t> c_offsets = {0, 4, 12, 16};
+  std::vector<int> c_data = {1, 2, 3, 4, 5, 6};
+  {
+    Array array(default_ctx, array_name, TILEDB_WRITE);
+    Query query(default_ctx, array);
+    query.set_layout(TILEDB_ROW_MAJOR)
+        .set_subarray<int>({1, 4})
+        .set_buffer("a", a_data)
+        .set_buffer("b", b_offsets, b_data)
+        .set_buffer("c", c_offsets, c_data);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    array.close();
+  }
+
+  // Read into buffers with room for 64-bit offsets
+  std::vector<int> a_read(4);
+  std::vector<uint64_t> b_read_offsets(5);
+  std::string b_read(7, ' ');
+  std::vector<uint64_t> c_read_offsets(5);
+  std::vector<int> c_read(6);
+  Array array(ctx, array_name, TILEDB_READ);
+  Query query(ctx, array);
+  query.set_layout(TILEDB_ROW_MAJOR)
+      .set_subarray<int>({1, 4})
+      .set_buffer("a", a_read)
+      .set_buffer("b", b_read_offsets, b_read)
+      .set_buffer("c", c_read_offsets, c_read);
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+
+  // The fixed-sized attribute is a primitive array over the user buffer
+  ArrowArray arrow_array;
+  ArrowSchema arrow_schema;
+  query.export_arrow("a", &arrow_array, &arrow_schema);
+  CHECK(std::string(arrow_schema.format) == "i");
+  CHECK(std::string(arrow_schema.name) == "a");
+  CHECK(arrow_array.length == 4);
+  CHECK(arrow_array.n_buffers == 2);
+  CHECK(arrow_array.buffers[1] == a_read.data());
+  arrow_array.release(&arrow_array);
+  arrow_schema.release(&arrow_schema);
+  CHECK(arrow_array.release == nullptr);
+  CHECK(arrow_schema.release == nullptr);
+
+  // The string attribute is a binary array with n + 1 32-bit offsets
+  query.export_arrow("b", &arrow_array, &arrow_schema);
+  CHECK(std::string(arrow_schema.format) == "z");
+  CHECK(arrow_array.length == 4);
+  CHECK(arrow_array.n_buffers == 3);
+  auto b_arrow_offsets = static_cast<const uint32_t*>(arrow_array.buffers[1]);
+  CHECK(std::vector<uint32_t>(b_arrow_offsets, b_arrow_offsets + 5) ==
+        std::vector<uint32_t>({0, 1, 3, 4, 7}));
+  CHECK(arrow_array.buffers[2] == &b_read[0]);
+  arrow_array.release(&arrow_array);
+  arrow_schema.release(&arrow_schema);
+
+  // The var-sized int attribute is a list with offsets in elements
+  query.export_arrow("c", &arrow_array, &arrow_schema);
+  CHECK(std::string(arrow_schema.format) == "+l");
+  REQUIRE(arrow_schema.n_children == 1);
+  CHECK(std::string(arrow_schema.children[0]->format) == "i");
+  CHECK(arrow_array.length == 4);
+  auto c_arrow_offsets = static_cast<const uint32_t*>(arrow_array.buffers[1]);
+  CHECK(std::vector<uint32_t>(c_arrow_offsets, c_arrow_offsets + 5) ==
+        std::vector<uint32_t>({0, 1, 3, 4, 6}));
+  REQUIRE(arrow_array.n_children == 1);
+  CHECK(arrow_array.children[0]->length == 6);
+  CHECK(arrow_array.children[0]->buffers[1] == c_read.data());
+  arrow_array.release(&arrow_array);
+  arrow_schema.release(&arrow_schema);
+  array.close();
+
+  // Without the extra offset, var-sized results cannot be exported
+  Array default_array(default_ctx, array_name, TILEDB_READ);
+  Query default_query(default_ctx, default_array);
+  default_query.set_layout(TILEDB_ROW_MAJOR)
+      .set_subarray<int>({1, 4})
+      .set_buffer("b", b_read_offsets, b_read);
+  REQUIRE(default_query.submit() == Query::Status::COMPLETE);
+  CHECK_THROWS_AS(
+      default_query.export_arrow("b", &arrow_array, &arrow_schema),
+      TileDBError);
+  default_array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test writing Arrow offsets", "[cppapi][query][arrow][write]") {
+  const std::string array_name = "cpp_unit_array";
+  Config config;
+  config["sm.var_offsets.bitsize"] = "32";
+  config["sm.var_offsets.extra_element"] = "true";
+  config["sm.var_offsets.mode"] = "elements";
+  Context ctx(config);
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 4}}, 2));
+  ArraySchema schema(ctx, TILEDB_DENSE);
+  schema.set_domain(domain);
+  schema.add_attribute(Attribute::create<std::string>(ctx, "b"));
+  schema.add_attribute(Attribute::create<std::vector<int>>(ctx, "c"));
+  Array::create(array_name, schema);
+
+  // Write n + 1 32-bit offsets, counted in elements
+  std::vector<uint32_t> b_offsets = {0, 1, 3, 4, 7};
+  std::string b_data = "abbcddd";
+  std::vector<uint32_t> c_offsets = {0, 1, 3, 4, 6};
+  std::vector<int> c_data = {1, 2, 3, 4, 5, 6};
+  uint64_t b_offsets_size = b_offsets.size() * sizeof(uint32_t);
+  uint64_t b_data_size = b_data.size();
+  uint64_t c_offsets_size = c_offsets.size() * sizeof(uint32_t);
+  uint64_t c_data_size = c_data.size() * sizeof(int);
+  {
+    Array array(ctx, array_name, TILEDB_WRITE);
+    Query query(ctx, array);
+    query.set_layout(TILEDB_ROW_MAJOR).set_subarray<int>({1, 4});
+    REQUIRE(
+        tiledb_query_set_buffer_var(
+            ctx.ptr().get(),
+            query.ptr().get(),
+            "b",
+            (uint64_t*)b_offsets.data(),
+            &b_offsets_size,
+            &b_data[0],
+            &b_data_size) == TILEDB_OK);
+    REQUIRE(
+        tiledb_query_set_buffer_var(
+            ctx.ptr().get(),
+            query.ptr().get(),
+            "c",
+            (uint64_t*)c_offsets.data(),
+            &c_offsets_size,
+            c_data.data(),
+            &c_data_size) == TILEDB_OK);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+
+    // An extra offset past the values is rejected
+    std::vector<uint32_t> bad_offsets = {0, 1, 3, 4, 8};
+    Query bad_query(ctx, array);
+    CHECK(
+        tiledb_query_set_buffer_var(
+            ctx.ptr().get(),
+            bad_query.ptr().get(),
+            "b",
+            (uint64_t*)bad_offsets.data(),
+            &b_offsets_size,
+            &b_data[0],
+            &b_data_size) == TILEDB_ERR);
+    array.close();
+  }
+
+  // Read back with the default byte offsets
+  Context default_ctx;
+  std::vector<uint64_t> b_read_offsets(4);
+  std::string b_read(7, ' ');
+  std::vector<uint64_t> c_read_offsets(4);
+  std::vector<int> c_read(6);
+  Array array(default_ctx, array_name, TILEDB_READ);
+  Query query(default_ctx, array);
+  query.set_layout(TILEDB_ROW_MAJOR)
+      .set_subarray<int>({1, 4})
+      .set_buffer("b", b_read_offsets, b_read)
+      .set_buffer("c", c_read_offsets, c_read);
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+  CHECK(b_read_offsets == std::vector<uint64_t>({0, 1, 3, 4}));
+  CHECK(b_read == b_data);
+  CHECK(c_read_offsets == std::vector<uint64_t>({0, 4, 12, 16}));
+  CHECK(c_read == c_data);
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test per-query 32-bit offsets",
+    "[cppapi][query][offsets-bitsize]") {
+  const std::string array_name = "cpp_unit_array";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 4}}, 2));
+  ArraySchema schema(ctx, TILEDB_DENSE);
+  schema.set_domain(domain);
+  schema.add_attribute(Attribute::create<std::string>(ctx, "b"));
+  Array::create(array_name, schema);
+
+  // Write 32-bit offsets with a context that keeps the 64-bit default
+  std::vector<uint32_t> b_offsets = {0, 1, 3, 4};
+  std::string b_data = "abbcddd";
+  uint64_t b_offsets_size = b_offsets.size() * sizeof(uint32_t);
+  uint64_t b_data_size = b_data.size();
+  {
+    Array array(ctx, array_name, TILEDB_WRITE);
+    Query query(ctx, array);
+    CHECK_THROWS_AS(query.set_offsets_bitsize(16), TileDBError);
+    query.set_layout(TILEDB_ROW_MAJOR)
+        .set_subarray<int>({1, 4})
+        .set_offsets_bitsize(32);
+    REQUIRE(
+        tiledb_query_set_buffer_var(
+            ctx.ptr().get(),
+            query.ptr().get(),
+            "b",
+            (uint64_t*)b_offsets.data(),
+            &b_offsets_size,
+            &b_data[0],
+            &b_data_size) == TILEDB_OK);
+
+    // The width of the offsets cannot change once the buffers are set
+    CHECK_THROWS_AS(query.set_offsets_bitsize(64), TileDBError);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    array.close();
+  }
+
+  // Read back 32-bit offsets, while other queries keep the 64-bit default
+  std::vector<uint32_t> b_read_offsets(4);
+  std::string b_read(7, ' ');
+  uint64_t b_read_offsets_size = b_read_offsets.size() * sizeof(uint32_t);
+  uint64_t b_read_size = b_read.size();
+  Array array(ctx, array_name, TILEDB_READ);
+  Query query(ctx, array);
+  query.set_layout(TILEDB_ROW_MAJOR)
+      .set_subarray<int>({1, 4})
+      .set_offsets_bitsize(32);
+  REQUIRE(
+      tiledb_query_set_buffer_var(
+          ctx.ptr().get(),
+          query.ptr().get(),
+          "b",
+          (uint64_t*)b_read_offsets.data(),
+          &b_read_offsets_size,
+          &b_read[0],
+          &b_read_size) == TILEDB_OK);
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+  CHECK(b_read_offsets_size == 4 * sizeof(uint32_t));
+  CHECK(b_read_offsets == b_offsets);
+  CHECK(b_read == b_data);
+
+  // The width cannot change after the query has been submitted
+  CHECK_THROWS_AS(query.set_offsets_bitsize(64), TileDBError);
+
+  std::vector<uint64_t> default_offsets(4);
+  std::string default_read(7, ' ');
+  Query default_query(ctx, array);
+  default_query.set_layout(TILEDB_ROW_MAJOR)
+      .set_subarray<int>({1, 4})
+      .set_buffer("b", default_offsets, default_read);
+  REQUIRE(default_query.submit() == Query::Status::COMPLETE);
+  CHECK(default_offsets == std::vector<uint64_t>({0, 1, 3, 4}));
+  CHECK(default_read == b_data);
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test prepared read queries", "[cppapi][query][prepare]") {
+  const std::string array_name = "cpp_unit_array";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 10}}, 5));
+  ArraySchema schema(ctx, TILEDB_DENSE);
+  schema.set_domain(domain);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  schema.add_attribute(Attribute::create<std::string>(ctx, "b"));
+  Array::create(array_name, schema);
+
+  // Cell i holds a = 10 * i and b = i copies of 'x'
+  std::vector<int> a_data;
+  std::vector<uint64_t> b_offsets;
+  std::string b_data;
+  for (int i = 1; i <= 10; ++i) {
+    a_data.push_back(10 * i);
+    b_offsets.push_back(b_data.size());
+    b_data += std::string(i, 'x');
+  }
+  {
+    Array array(ctx, array_name, TILEDB_WRITE);
+    Query query(ctx, array);
+    query.set_layout(TILEDB_ROW_MAJOR)
+        .set_subarray<int>({1, 10})
+        .set_buffer("a", a_data)
+        .set_buffer("b", b_offsets, b_data);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+
+    // Only read queries can be prepared
+    CHECK_THROWS_AS(query.prepare(), TileDBError);
+    array.close();
+  }
+
+  std::vector<int> a_read(10);
+  std::vector<uint64_t> b_read_offsets(10);
+  std::string b_read(55, ' ');
+  Array array(ctx, array_name, TILEDB_READ);
+  Query query(ctx, array);
+  query.set_layout(TILEDB_ROW_MAJOR)
+      .set_subarray<int>({1, 10})
+      .set_buffer("a", a_read)
+      .set_buffer("b", b_read_offsets, b_read)
+      .prepare();
+
+  // The buffer sizes are restored for each new subarray
+  for (int i = 1; i <= 10; ++i) {
+    query.set_subarray<int>({i, i});
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    auto result_elements = query.result_buffer_elements();
+    CHECK(result_elements["a"].second == 1);
+    CHECK(result_elements["b"].first == 1);
+    CHECK(result_elements["b"].second == (uint64_t)i);
+    CHECK(a_read[0] == 10 * i);
+    CHECK(b_read.substr(0, i) == std::string(i, 'x'));
+  }
+
+  query.set_subarray<int>({3, 5});
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+  auto result_elements = query.result_buffer_elements();
+  CHECK(result_elements["a"].second == 3);
+  CHECK(result_elements["b"].second == 12);
+  CHECK(std::vector<int>(a_read.begin(), a_read.begin() + 3) ==
+        std::vector<int>({30, 40, 50}));
+  CHECK(std::vector<uint64_t>(
+            b_read_offsets.begin(), b_read_offsets.begin() + 3) ==
+        std::vector<uint64_t>({0, 3, 7}));
+
+  // Changing the layout initializes the query again, which does not
+  // restore the buffer sizes
+  query.set_layout(TILEDB_COL_MAJOR)
+      .set_subarray<int>({9, 10})
+      .set_buffer("a", a_read)
+      .set_buffer("b", b_read_offsets, b_read);
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+  result_elements = query.result_buffer_elements();
+  CHECK(result_elements["a"].second == 2);
+  CHECK(a_read[0] == 90);
+  CHECK(a_read[1] == 100);
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test sorting real coordinates with typed comparators",
+    "[cppapi][query][sparse][sort]") {
+  const std::string array_name = "cpp_unit_array";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  // Create
+  Domain domain(ctx);
+  domain
+      .add_dimension(Dimension::create<double>(ctx, "x", {{-5.0, 10.0}}, 4.0))
+      .add_dimension(Dimension::create<double>(ctx, "y", {{1.0, 20.0}}, 5.0));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain);
+  schema.set_capacity(7);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  Array::create(array_name, schema);
+
+  // Write distinct cells in a scrambled order
+  std::vector<std::pair<double, double>> cells;
+  for (int i = 0; i < 80; i += 3)
+    cells.emplace_back(
+        -4.5 + (i * 7) % 16 * 0.9, 1.25 + (i * 11) % 20 * 0.9);
+  std::vector<double> coords;
+  std::vector<int> data;
+  for (size_t i = 0; i < cells.size(); ++i) {
+    coords.push_back(cells[i].first);
+    coords.push_back(cells[i].second);
+    data.push_back((int)i);
+  }
+  Array array_w(ctx, array_name, TILEDB_WRITE);
+  Query query_w(ctx, array_w);
+  query_w.set_layout(TILEDB_UNORDERED)
+      .set_coordinates(coords)
+      .set_buffer("a", data);
+  tiledb::sm::stats::all_stats.set_enabled(true);
+  tiledb::sm::stats::all_stats.reset();
+  query_w.submit();
+  CHECK(tiledb::sm::stats::all_stats.counter_writer_coords_sorted_typed == 1);
+  tiledb::sm::stats::all_stats.set_enabled(false);
+  array_w.close();
+
+  tiledb_layout_t layout = TILEDB_ROW_MAJOR;
+  SECTION("- Row-major") {
+    layout = TILEDB_ROW_MAJOR;
+  }
+  SECTION("- Col-major") {
+    layout = TILEDB_COL_MAJOR;
+  }
+
+  // The expected order
+  std::vector<size_t> order(cells.size());
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    if (layout == TILEDB_ROW_MAJOR)
+      return cells[a] < cells[b];
+    return std::make_pair(cells[a].second, cells[a].first) <
+           std::make_pair(cells[b].second, cells[b].first);
+  });
+
+  // Read in the layout
+  Array array(ctx, array_name, TILEDB_READ);
+  std::vector<int> r_data(cells.size());
+  Query query(ctx, array);
+  query.set_subarray<double>({-5.0, 10.0, 1.0, 20.0})
+      .set_layout(layout)
+      .set_buffer("a", r_data);
+  tiledb::sm::stats::all_stats.set_enabled(true);
+  tiledb::sm::stats::all_stats.reset();
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+  CHECK(tiledb::sm::stats::all_stats.counter_reader_coords_sorted_typed > 0);
+  tiledb::sm::stats::all_stats.set_enabled(false);
+  REQUIRE(query.result_buffer_elements()["a"].second == cells.size());
+  for (size_t i = 0; i < order.size(); ++i)
+    CHECK(r_data[i] == (int)order[i]);
+
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test dense global order reads over many space tiles",
+    "[cppapi][query][dense][global]") {
+  const std::string array_name = "cpp_unit_array";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "rows", {{1, 12}}, 3))
+      .add_dimension(Dimension::create<int>(ctx, "cols", {{1, 12}}, 3));
+  ArraySchema schema(ctx, TILEDB_DENSE);
+  schema.set_domain(domain);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  Array::create(array_name, schema);
+
+  // Dense fragment with a = 100 * row + col
+  std::vector<int> a_data;
+  for (int r = 1; r <= 12; ++r) {
+    for (int c = 1; c <= 12; ++c)
+      a_data.push_back(100 * r + c);
+  }
+  {
+    Array array(ctx, array_name, TILEDB_WRITE);
+    Query query(ctx, array);
+    query.set_layout(TILEDB_ROW_MAJOR)
+        .set_subarray<int>({1, 12, 1, 12})
+        .set_buffer("a", a_data);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    array.close();
+  }
+
+  // Negate a few cells spread over several space tiles
+  std::vector<int> coords = {2, 2, 5, 7, 11, 12, 7, 1, 8, 1};
+  std::vector<int> a_update;
+  for (size_t i = 0; i < coords.size(); i += 2)
+    a_update.push_back(-(100 * coords[i] + coords[i + 1]));
+  {
+    Array array(ctx, array_name, TILEDB_WRITE);
+    Query query(ctx, array);
+    query.set_layout(TILEDB_UNORDERED)
+        .set_buffer("a", a_update)
+        .set_coordinates(coords);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    array.close();
+  }
+
+  // The cells of rows 2-11 in the global order
+  std::vector<int> expected;
+  for (int tr = 0; tr < 4; ++tr) {
+    for (int tc = 0; tc < 4; ++tc) {
+      for (int r = 3 * tr + 1; r <= 3 * tr + 3; ++r) {
+        for (int c = 3 * tc + 1; c <= 3 * tc + 3; ++c) {
+          if (r < 2 || r > 11)
+            continue;
+          bool updated = false;
+          for (size_t i = 0; i < coords.size(); i += 2)
+            updated |= (coords[i] == r && coords[i + 1] == c);
+          expected.push_back((updated ? -1 : 1) * (100 * r + c));
+        }
+      }
+    }
+  }
+
+  std::vector<int> a_read(120);
+  Array array(ctx, array_name, TILEDB_READ);
+  Query query(ctx, array);
+  query.set_layout(TILEDB_GLOBAL_ORDER)
+      .set_subarray<int>({2, 11, 1, 12})
+      .set_buffer("a", a_read);
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+  CHECK(query.result_buffer_elements()["a"].second == 120);
+  CHECK(a_read == expected);
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test dense reads with sparse cell updates",
+    "[cppapi][query][dense][sparse-updates]") {
+  const std::string array_name = "cpp_unit_array";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "rows", {{1, 12}}, 4))
+      .add_dimension(Dimension::create<int>(ctx, "cols", {{1, 12}}, 4));
+  ArraySchema schema(ctx, TILEDB_DENSE);
+  schema.set_domain(domain);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  Array::create(array_name, schema);
+
+  // Dense fragment with a = 100 * row + col
+  std::vector<int> a_data;
+  for (int r = 1; r <= 12; ++r) {
+    for (int c = 1; c <= 12; ++c)
+      a_data.push_back(100 * r + c);
+  }
+  {
+    Array array(ctx, array_name, TILEDB_WRITE);
+    Query query(ctx, array);
+    query.set_layout(TILEDB_ROW_MAJOR)
+        .set_subarray<int>({1, 12, 1, 12})
+        .set_buffer("a", a_data);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    array.close();
+  }
+
+  // Negate a run of cells crossing a tile boundary, a column of cells
+  // and a few scattered cells, written in no particular order
+  std::vector<int> coords = {12, 12, 4, 6, 4, 3, 4, 4, 4, 5, 2, 9, 3, 9,
+                             1,  1,  4, 7, 7, 10, 4, 8, 5, 9, 9, 2};
+  std::vector<int> a_update;
+  for (size_t i = 0; i < coords.size(); i += 2)
+    a_update.push_back(-(100 * coords[i] + coords[i + 1]));
+  {
+    Array array(ctx, array_name, TILEDB_WRITE);
+    Query query(ctx, array);
+    query.set_layout(TILEDB_UNORDERED)
+        .set_buffer("a", a_update)
+        .set_coordinates(coords);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    array.close();
+  }
+
+  auto value = [&](int r, int c) {
+    for (size_t i = 0; i < coords.size(); i += 2) {
+      if (coords[i] == r && coords[i + 1] == c)
+        return -(100 * r + c);
+    }
+    return 100 * r + c;
+  };
+
+  // Read rows 1-9 and columns 2-12
+  tiledb_layout_t layout = TILEDB_ROW_MAJOR;
+  std::vector<int> expected;
+  SECTION("- row-major") {
+    layout = TILEDB_ROW_MAJOR;
+    for (int r = 1; r <= 9; ++r) {
+      for (int c = 2; c <= 12; ++c)
+        expected.push_back(value(r, c));
+    }
+  }
+  SECTION("- col-major") {
+    layout = TILEDB_COL_MAJOR;
+    for (int c = 2; c <= 12; ++c) {
+      for (int r = 1; r <= 9; ++r)
+        expected.push_back(value(r, c));
+    }
+  }
+
+  std::vector<int> a_read(99);
+  Array array(ctx, array_name, TILEDB_READ);
+  Query query(ctx, array);
+  query.set_layout(layout)
+      .set_subarray<int>({1, 9, 2, 12})
+      .set_buffer("a", a_read);
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+  CHECK(query.result_buffer_elements()["a"].second == 99);
+  CHECK(a_read == expected);
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test dense reads over space tiles with no fragments",
+    "[cppapi][query][dense][fill]") {
+  const std::string array_name = "cpp_unit_array";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 12}}, 4));
+  ArraySchema schema(ctx, TILEDB_DENSE);
+  schema.set_domain(domain);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  schema.add_attribute(Attribute::create<std::string>(ctx, "b"));
+  Array::create(array_name, schema);
+
+  // Write only the cells of the second space tile
+  std::vector<int> a_data = {5, 6, 7, 8};
+  std::vector<uint64_t> b_offsets = {0, 1, 3, 6};
+  std::string b_values = "abbcccdddd";
+  {
+    Array array(ctx, array_name, TILEDB_WRITE);
+    Query query(ctx, array);
+    query.set_subarray<int>({5, 8})
+        .set_layout(TILEDB_ROW_MAJOR)
+        .set_buffer("a", a_data)
+        .set_buffer("b", b_offsets, b_values);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    array.close();
+  }
+
+  tiledb_layout_t layout = TILEDB_ROW_MAJOR;
+  SECTION("- row-major") {
+    layout = TILEDB_ROW_MAJOR;
+  }
+  SECTION("- global order") {
+    layout = TILEDB_GLOBAL_ORDER;
+  }
+
+  // Read the whole array, the first and last space tiles are empty
+  std::vector<int> r_a(12);
+  std::vector<uint64_t> r_b_offsets(12);
+  std::string r_b_values(32, ' ');
+  Array array(ctx, array_name, TILEDB_READ);
+  Query query(ctx, array);
+  query.set_subarray<int>({1, 12})
+      .set_layout(layout)
+      .set_buffer("a", r_a)
+      .set_buffer("b", r_b_offsets, r_b_values);
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+
+  auto result_num = query.result_buffer_elements();
+  REQUIRE(result_num["a"].second == 12);
+  REQUIRE(result_num["b"].first == 12);
+  REQUIRE(result_num["b"].second == 18);
+  std::vector<int> expected_a = {INT32_MIN, INT32_MIN, INT32_MIN, INT32_MIN,
+                                 5,         6,         7,         8,
+                                 INT32_MIN, INT32_MIN, INT32_MIN, INT32_MIN};
+  std::vector<uint64_t> expected_b_offsets = {
+      0, 1, 2, 3, 4, 5, 7, 10, 14, 15, 16, 17};
+  const std::string b_fill(4, std::numeric_limits<char>::min());
+  CHECK(r_a == expected_a);
+  CHECK(r_b_offsets == expected_b_offsets);
+  CHECK(r_b_values.substr(0, 4) == b_fill);
+  CHECK(r_b_values.substr(4, 10) == b_values);
+  CHECK(r_b_values.substr(14, 4) == b_fill);
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test sparse global order write coordinate checks",
+    "[cppapi][query][sparse][global-order][checks]") {
+  const std::string array_name = "cpp_unit_array";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 200000}}, 100));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  Array::create(array_name, schema);
+
+  // Enough cells for the checks to span several chunks
+  const int cell_num = 150000;
+  std::vector<int> d_data(cell_num);
+  std::vector<int> a_data(cell_num);
+  for (int i = 0; i < cell_num; ++i) {
+    d_data[i] = i + 1;
+    a_data[i] = i;
+  }
+
+  bool valid = false;
+  SECTION("- valid") {
+    valid = true;
+  }
+  SECTION("- out-of-bounds") {
+    d_data[cell_num - 1] = 200001;
+  }
+  SECTION("- duplicates across chunks") {
+    d_data[1 << 16] = d_data[(1 << 16) - 1];
+  }
+  SECTION("- global order across chunks") {
+    std::swap(d_data[1 << 16], d_data[(1 << 16) - 1]);
+  }
+
+  Array array(ctx, array_name, TILEDB_WRITE);
+  Query query(ctx, array);
+  query.set_layout(TILEDB_GLOBAL_ORDER)
+      .set_buffer("a", a_data)
+      .set_coordinates(d_data);
+  if (valid) {
+    CHECK_NOTHROW(query.submit());
+    query.finalize();
+  } else {
+    CHECK_THROWS(query.submit());
+  }
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test batched reads of several arrays",
+    "[cppapi][query][batch]") {
+  const std::vector<std::string> array_names = {"cpp_unit_array_batch_0",
+                                                "cpp_unit_array_batch_1",
+                                                "cpp_unit_array_batch_2"};
+  Config config;
+  config["sm.num_async_threads"] = "2";
+  Context ctx(config);
+  VFS vfs(ctx);
+
+  // Create and write the arrays, each with its own values
+  for (size_t i = 0; i < array_names.size(); ++i) {
+    if (vfs.is_dir(array_names[i]))
+      vfs.remove_dir(array_names[i]);
+
+    Domain domain(ctx);
+    domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 100}}, 10));
+    ArraySchema schema(ctx, TILEDB_DENSE);
+    schema.set_domain(domain);
+    schema.add_attribute(Attribute::create<int>(ctx, "a"));
+    Array::create(array_names[i], schema);
+
+    std::vector<int> a_data(100);
+    for (int j = 0; j < 100; ++j)
+      a_data[j] = int(i) * 1000 + j;
+    Array array(ctx, array_names[i], TILEDB_WRITE);
+    Query query(ctx, array);
+    query.set_layout(TILEDB_ROW_MAJOR)
+        .set_subarray<int>({1, 100})
+        .set_buffer("a", a_data);
+    query.submit();
+    array.close();
+  }
+
+  // Read the same range from all the arrays in one batch
+  std::vector<std::unique_ptr<Array>> arrays;
+  std::vector<std::unique_ptr<Query>> queries;
+  std::vector<std::vector<int>> results(
+      array_names.size(), std::vector<int>(20));
+  std::vector<Query*> batch;
+  for (size_t i = 0; i < array_names.size(); ++i) {
+    arrays.emplace_back(new Array(ctx, array_names[i], TILEDB_READ));
+    queries.emplace_back(new Query(ctx, *arrays[i]));
+    queries[i]
+        ->set_layout(TILEDB_ROW_MAJOR)
+        .set_subarray<int>({41, 60})
+        .set_buffer("a", results[i]);
+    batch.push_back(queries[i].get());
+  }
+  Query::submit_batch(ctx, batch);
+
+  for (size_t i = 0; i < array_names.size(); ++i) {
+    CHECK(queries[i]->query_status() == Query::Status::COMPLETE);
+    for (int j = 0; j < 20; ++j)
+      CHECK(results[i][j] == int(i) * 1000 + 40 + j);
+    arrays[i]->close();
+  }
+
+  // An empty batch is a no-op
+  CHECK_NOTHROW(Query::submit_batch(ctx, {}));
+
+  for (const auto& array_name : array_names) {
+    if (vfs.is_dir(array_name))
+      vfs.remove_dir(array_name);
+  }
+}
+
+TEST_CASE(
+    "C++ API: Test incomplete reads resetting the same buffers",
+    "[cppapi][query][incomplete][result-elements]") {
+  const std::string array_name = "cpp_unit_array";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  // Create
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 10}}, 10));
+  ArraySchema schema(ctx, TILEDB_DENSE);
+  schema.set_domain(domain);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  schema.add_attribute(Attribute::create<std::string>(ctx, "b"));
+  Array::create(array_name, schema);
+
+  // Write
+  std::vector<int> a_data;
+  std::vector<uint64_t> b_offsets;
+  std::string b_data;
+  for (int i = 0; i < 10; ++i) {
+    a_data.push_back(i);
+    b_offsets.push_back(b_data.size());
+    b_data += std::string(size_t(i % 3 + 1), char('a' + i));
+  }
+  Array array_w(ctx, array_name, TILEDB_WRITE);
+  Query query_w(ctx, array_w);
+  query_w.set_layout(TILEDB_ROW_MAJOR)
+      .set_subarray<int>({1, 10})
+      .set_buffer("a", a_data)
+      .set_buffer("b", b_offsets, b_data);
+  query_w.submit();
+  array_w.close();
+
+  // Read in several submissions into buffers of 3 cells
+  std::vector<int> a_read(3);
+  std::vector<uint64_t> b_offsets_read(3);
+  std::string b_data_read(100, '\0');
+  std::vector<int> a_all;
+  std::string b_all;
+  Array array(ctx, array_name, TILEDB_READ);
+  Query query(ctx, array);
+  query.set_layout(TILEDB_ROW_MAJOR).set_subarray<int>({1, 10});
+  CHECK(
+      query.result_buffer_elements("a") ==
+      std::pair<uint64_t, uint64_t>(0, 0));
+  Query::Status status;
+  do {
+    query.set_buffer("a", a_read).set_buffer("b", b_offsets_read, b_data_read);
+    status = query.submit();
+
+    auto result_el = query.result_buffer_elements();
+    auto a_el = query.result_buffer_elements("a");
+    auto b_el = query.result_buffer_elements("b");
+    CHECK(result_el.size() == 2);
+    CHECK(result_el["a"] == a_el);
+    CHECK(result_el["b"] == b_el);
+    CHECK(a_el.first == 0);
+    CHECK(a_el.second == b_el.first);
+    CHECK(a_el.second > 0);
+
+    a_all.insert(a_all.end(), a_read.begin(), a_read.begin() + a_el.second);
+    b_all.append(b_data_read, 0, b_el.second);
+  } while (status == Query::Status::INCOMPLETE);
+  array.close();
+
+  CHECK(status == Query::Status::COMPLETE);
+  CHECK(a_all == a_data);
+  CHECK(b_all == b_data);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test reads into managed buffers",
+    "[cppapi][query][managed-buffers]") {
+  const std::string array_name = "cpp_unit_array";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  // Create
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 10}}, 2));
+  ArraySchema schema(ctx, TILEDB_DENSE);
+  schema.set_domain(domain);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  schema.add_attribute(Attribute::create<std::string>(ctx, "b"));
+  Array::create(array_name, schema);
+
+  // Write
+  std::vector<int> a_data;
+  std::vector<uint64_t> b_offsets;
+  std::string b_data;
+  for (int i = 0; i < 10; ++i) {
+    a_data.push_back(i);
+    b_offsets.push_back(b_data.size());
+    b_data += std::string(size_t(i % 3 + 1), char('a' + i));
+  }
+  Array array_w(ctx, array_name, TILEDB_WRITE);
+  Query query_w(ctx, array_w);
+  query_w.set_layout(TILEDB_ROW_MAJOR)
+      .set_subarray<int>({1, 10})
+      .set_buffer("a", a_data)
+      .set_buffer("b", b_offsets, b_data);
+  query_w.submit();
+  array_w.close();
+
+  // Read, with the default budget or one of a few tiles
+  uint64_t expected_submissions = 1;
+  Config config;
+  SECTION("- default memory budget") {
+  }
+  SECTION("- small memory budget") {
+    config["sm.memory_budget"] = "32";
+    config["sm.memory_budget_var"] = "16";
+    expected_submissions = 2;
+  }
+  tiledb::sm::stats::all_stats.set_enabled(true);
+  tiledb::sm::stats::all_stats.reset();
+  Context ctx_read(config);
+  Array array(ctx_read, array_name, TILEDB_READ);
+  Query query(ctx_read, array);
+  query.set_layout(TILEDB_ROW_MAJOR)
+      .set_subarray<int>({1, 10})
+      .set_managed_buffer("a")
+      .set_managed_buffer("b");
+
+  std::vector<int> a_all;
+  std::string b_all;
+  uint64_t submissions = 0;
+  Query::Status status;
+  do {
+    status = query.submit();
+    ++submissions;
+
+    auto a = query.managed_buffer<int>("a");
+    auto b = query.managed_buffer_var<char>("b");
+    CHECK(a.second > 0);
+    CHECK(std::get<1>(b) == a.second);
+    a_all.insert(a_all.end(), a.first, a.first + a.second);
+    b_all.append(std::get<2>(b), std::get<3>(b));
+  } while (status == Query::Status::INCOMPLETE);
+  array.close();
+
+  CHECK(status == Query::Status::COMPLETE);
+  CHECK(submissions >= expected_submissions);
+  CHECK(a_all == a_data);
+  CHECK(b_all == b_data);
+
+  // The buffers grew instead of the partitions being split to fit them
+  auto& stats = tiledb::sm::stats::all_stats;
+  CHECK(stats.counter_reader_managed_buffer_growths > 0);
+  stats.set_enabled(false);
+
+  // Managed buffers are only for reads
+  Array array_w2(ctx, array_name, TILEDB_WRITE);
+  Query query_w2(ctx, array_w2);
+  CHECK_THROWS(query_w2.set_managed_buffer("a"));
+  array_w2.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test incomplete reads reuse the tiles of the previous partition",
+    "[cppapi][query][partition-tile-cache]") {
+  const std::string array_name = "cpp_unit_array";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  // Create, with tiles [1, 4], [5, 8] and [9, 10]
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 10}}, 4));
+  ArraySchema schema(ctx, TILEDB_DENSE);
+  schema.set_domain(domain);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  Array::create(array_name, schema);
+
+  // Write
+  std::vector<int> a_data = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+  Array array_w(ctx, array_name, TILEDB_WRITE);
+  Query query_w(ctx, array_w);
+  query_w.set_layout(TILEDB_ROW_MAJOR)
+      .set_subarray<int>({1, 10})
+      .set_buffer("a", a_data);
+  query_w.submit();
+  array_w.close();
+
+  // Read into a buffer of half the results, so that the partitions
+  // [1, 5] and [6, 10] share tile [5, 8]
+  bool cache_enabled = true;
+  Config config;
+  SECTION("- enabled") {
+  }
+  SECTION("- disabled") {
+    config["sm.partition_tile_cache_ratio"] = "0";
+    cache_enabled = false;
+  }
+  tiledb::sm::stats::all_stats.set_enabled(true);
+  tiledb::sm::stats::all_stats.reset();
+  Context ctx_read(config);
+  Array array(ctx_read, array_name, TILEDB_READ);
+  Query query(ctx_read, array);
+  std::vector<int> a(5);
+  query.set_layout(TILEDB_ROW_MAJOR)
+      .set_subarray<int>({1, 10})
+      .set_buffer("a", a);
+
+  std::vector<int> a_all;
+  Query::Status status;
+  do {
+    status = query.submit();
+    auto result_num = query.result_buffer_elements()["a"].second;
+    CHECK(result_num > 0);
+    a_all.insert(a_all.end(), a.begin(), a.begin() + result_num);
+  } while (status == Query::Status::INCOMPLETE);
+  array.close();
+
+  CHECK(status == Query::Status::COMPLETE);
+  CHECK(a_all == a_data);
+
+  auto& stats = tiledb::sm::stats::all_stats;
+  CHECK((stats.counter_reader_partition_tile_cache_hits > 0) == cache_enabled);
+  stats.set_enabled(false);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Test reads with the tile cache modes",
+    "[cppapi][query][tile-cache-mode]") {
+  const std::string array_name = "cpp_unit_array";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  // Create, with a zstd, a gzip and a var-sized attribute
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 8}}, 4));
+  ArraySchema schema(ctx, TILEDB_DENSE);
+  schema.set_domain(domain);
+  FilterList zstd(ctx);
+  zstd.add_filter({ctx, TILEDB_FILTER_ZSTD});
+  FilterList gzip(ctx);
+  gzip.add_filter({ctx, TILEDB_FILTER_GZIP});
+  FilterList lz4(ctx);
+  lz4.add_filter({ctx, TILEDB_FILTER_LZ4});
+  auto a = Attribute::create<int>(ctx, "a");
+  a.set_filter_list(zstd);
+  auto b = Attribute::create<int>(ctx, "b");
+  b.set_filter_list(gzip);
+  auto v = Attribute::create<std::string>(ctx, "v");
+  v.set_filter_list(zstd);
+  schema.add_attribute(a).add_attribute(b).add_attribute(v);
+  schema.set_offsets_filter_list(lz4);
+  Array::create(array_name, schema);
+
+  // Write
+  std::vector<int> a_data = {1, 2, 3, 4, 5, 6, 7, 8};
+  std::vector<int> b_data = {10, 20, 30, 40, 50, 60, 70, 80};
+  std::string v_data = "abbcccddddeeeeeffffffggggggghhhhhhhh";
+  std::vector<uint64_t> v_offsets = {0, 1, 3, 6, 10, 15, 21, 28};
+  Array array_w(ctx, array_name, TILEDB_WRITE);
+  Query query_w(ctx, array_w);
+  query_w.set_layout(TILEDB_ROW_MAJOR)
+      .set_subarray<int>({1, 8})
+      .set_buffer("a", a_data)
+      .set_buffer("b", b_data)
+      .set_buffer("v", v_offsets, v_data);
+  query_w.submit();
+  array_w.close();
+
+  // Read twice, the second time from the tile cache
+  Config config;
+  SECTION("- unfiltered") {
+  }
+  SECTION("- filtered") {
+    config["sm.tile_cache_mode"] = "filtered";
+  }
+  SECTION("- auto") {
+    config["sm.tile_cache_mode"] = "auto";
+  }
+  config["sm.partition_tile_cache_ratio"] = "0";
+  Context ctx_read(config);
+  auto& stats = tiledb::sm::stats::all_stats;
+  for (int r = 0; r < 2; ++r) {
+    stats.set_enabled(true);
+    stats.reset();
+    Array array(ctx_read, array_name, TILEDB_READ);
+    Query query(ctx_read, array);
+    std::vector<int> a_read(8);
+    std::vector<int> b_read(8);
+    std::string v_read(v_data.size(), '\0');
+    std::vector<uint64_t> v_offsets_read(8);
+    query.set_layout(TILEDB_ROW_MAJOR)
+        .set_subarray<int>({1, 8})
+        .set_buffer("a", a_read)
+        .set_buffer("b", b_read)
+        .set_buffer("v", v_offsets_read, v_read);
+    CHECK(query.submit() == Query::Status::COMPLETE);
+    array.close();
+
+    CHECK(a_read == a_data);
+    CHECK(b_read == b_data);
+    CHECK(v_read == v_data);
+    CHECK(v_offsets_read == v_offsets);
+    CHECK((stats.counter_reader_attr_tile_cache_hits > 0) == (r == 1));
+  }
+  stats.set_enabled(false);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE("C++ API: Test query deadline", "[cppapi][query][deadline]") {
+  const std::string array_name = "cpp_unit_array";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 100}}, 10));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  Array::create(array_name, schema);
+
+  // Write three cells far apart
+  std::vector<int> d_data = {1, 50, 100};
+  std::vector<int> a_data = {1, 2, 3};
+  {
+    Array array(ctx, array_name, TILEDB_WRITE);
+    Query query(ctx, array);
+    query.set_layout(TILEDB_UNORDERED)
+        .set_buffer("d", d_data)
+        .set_buffer("a", a_data);
+    CHECK_THROWS_AS(query.set_deadline(10), TileDBError);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    array.close();
+  }
+
+  // Read one cell per submission over ten ranges, most of them empty
+  Array array(ctx, array_name, TILEDB_READ);
+  for (uint64_t deadline_ms : {0, 1}) {
+    Query query(ctx, array);
+    std::vector<int> a_read(1);
+    query.set_layout(TILEDB_ROW_MAJOR)
+        .set_buffer("a", a_read)
+        .set_deadline(deadline_ms);
+    for (int r = 0; r < 10; ++r)
+      query.add_range<int>(0, 10 * r + 1, 10 * r + 10);
+
+    // Every submission makes progress or stops at its deadline, and the
+    // query returns all the cells in order when resubmitted
+    std::vector<int> results;
+    Query::Status status;
+    int submissions = 0;
+    do {
+      status = query.submit();
+      auto num = query.result_buffer_elements()["a"].second;
+      results.insert(results.end(), a_read.begin(), a_read.begin() + num);
+    } while (status == Query::Status::INCOMPLETE && ++submissions < 100);
+    CHECK(status == Query::Status::COMPLETE);
+    CHECK(results == a_data);
+  }
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE("C++ API: Test sampled reads", "[cppapi][query][sample]") {
+  const std::string array_name = "cpp_unit_array";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 1000}}, 100));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain).set_capacity(10);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  Array::create(array_name, schema);
+
+  // Write 100 tiles of 10 cells
+  std::vector<int> d_data(1000);
+  std::vector<int> a_data(1000);
+  for (int i = 0; i < 1000; ++i) {
+    d_data[i] = i + 1;
+    a_data[i] = i;
+  }
+  {
+    Array array(ctx, array_name, TILEDB_WRITE);
+    Query query(ctx, array);
+    query.set_layout(TILEDB_GLOBAL_ORDER)
+        .set_buffer("d", d_data)
+        .set_buffer("a", a_data);
+    CHECK_THROWS_AS(query.set_sample(0.5), TileDBError);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    query.finalize();
+    array.close();
+  }
+
+  // Reads whole tiles, the same ones for the same seed
+  Array array(ctx, array_name, TILEDB_READ);
+  auto read = [&](double fraction, uint64_t seed, double* ratio) {
+    std::vector<int> a_read(1000);
+    Query query(ctx, array);
+    query.set_layout(TILEDB_ROW_MAJOR)
+        .set_subarray<int>({1, 1000})
+        .set_buffer("a", a_read)
+        .set_sample(fraction, seed);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    a_read.resize(query.result_buffer_elements()["a"].second);
+    *ratio = query.sample_ratio();
+    return a_read;
+  };
+  double ratio = 0;
+  auto all = read(1.0, 0, &ratio);
+  CHECK(all == a_data);
+  CHECK(ratio == 1.0);
+
+  auto sample = read(0.3, 7, &ratio);
+  CHECK(!sample.empty());
+  CHECK(sample.size() < 1000);
+  CHECK(sample.size() % 10 == 0);
+  CHECK(ratio == sample.size() / 1000.0);
+  for (uint64_t i = 0; i < sample.size(); i += 10)
+    CHECK(sample[i] % 10 == 0);
+  CHECK(read(0.3, 7, &ratio) == sample);
+  CHECK(read(0.3, 8, &ratio) != sample);
+
+  // Counts are computed over the sampled tiles
+  uint64_t count = 0;
+  Query count_query(ctx, array);
+  count_query.set_subarray<int>({1, 1000})
+      .set_sample(0.3, 7)
+      .add_aggregate("a", TILEDB_AGGREGATE_COUNT, &count);
+  REQUIRE(count_query.submit() == Query::Status::COMPLETE);
+  CHECK(count == sample.size());
+
+  Query bad_query(ctx, array);
+  CHECK_THROWS_AS(bad_query.set_sample(0.0), TileDBError);
+  CHECK_THROWS_AS(bad_query.set_sample(1.5), TileDBError);
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
@@ -0,0 +1,290 @@
+/**
+ * @file   unit-cppapi-query_aggregate.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *
+ * @section DESCRIPTION
+ *
+ * Tests the C++ API for aggregate queries.
+ */
+
+#include "catch.hpp"
+#include "tiledb/sm/cpp_api/tiledb"
+
+using namespace tiledb;
+
+namespace {
+
+void create_dense_array(const Context& ctx, const std::string& array_name) {
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "rows", {{1, 4}}, 2))
+      .add_dimension(Dimension::create<int>(ctx, "cols", {{1, 4}}, 2));
+  ArraySchema schema(ctx, TILEDB_DENSE);
+  schema.set_domain(domain);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  schema.add_attribute(Attribute::create<double>(ctx, "b"));
+  schema.add_attribute(Attribute::create<std::string>(ctx, "c"));
+  Array::create(array_name, schema);
+
+  std::vector<int> a(16);
+  std::vector<double> b(16);
+  std::vector<uint64_t> c_off(16);
+  std::string c_val(16, 'x');
+  for (int i = 0; i < 16; ++i) {
+    a[i] = i + 1;
+    b[i] = 0.5 * (i + 1);
+    c_off[i] = (uint64_t)i;
+  }
+  Array array(ctx, array_name, TILEDB_WRITE);
+  Query query(ctx, array);
+  query.set_layout(TILEDB_ROW_MAJOR)
+      .set_buffer("a", a)
+      .set_buffer("b", b)
+      .set_buffer("c", c_off, c_val);
+  query.submit();
+  array.close();
+}
+
+void create_sparse_array(const Context& ctx, const std::string& array_name) {
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "rows", {{1, 4}}, 2))
+      .add_dimension(Dimension::create<int>(ctx, "cols", {{1, 4}}, 2));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain).set_capacity(2);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  Array::create(array_name, schema);
+
+  std::vector<int> coords = {1, 1, 1, 2, 2, 1, 3, 3, 4, 4};
+  std::vector<int> a = {1, 2, 3, 4, 5};
+  Array array(ctx, array_name, TILEDB_WRITE);
+  Query query(ctx, array);
+  query.set_layout(TILEDB_UNORDERED)
+      .set_buffer("a", a)
+      .set_coordinates(coords);
+  query.submit();
+  array.close();
+}
+
+}  // namespace
+
+TEST_CASE(
+    "C++ API: Aggregate queries on dense array", "[cppapi][query-aggregate]") {
+  const std::string array_name = "cpp_unit_array_query_aggregate_dense";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+  create_dense_array(ctx, array_name);
+
+  Array array(ctx, array_name, TILEDB_READ);
+  uint64_t count = 0, count_c = 0;
+  int64_t sum = 0;
+  int min = 0, max = 0;
+  double sum_b = 0, max_b = 0;
+
+  SECTION("- Full tiles") {
+    std::vector<int> subarray = {1, 4, 1, 4};
+    Query query(ctx, array);
+    query.set_subarray(subarray)
+        .set_layout(TILEDB_ROW_MAJOR)
+        .add_aggregate("a", TILEDB_AGGREGATE_COUNT, &count)
+        .add_aggregate("a", TILEDB_AGGREGATE_SUM, &sum)
+        .add_aggregate("a", TILEDB_AGGREGATE_MIN, &min)
+        .add_aggregate("a", TILEDB_AGGREGATE_MAX, &max)
+        .add_aggregate("b", TILEDB_AGGREGATE_SUM, &sum_b)
+        .add_aggregate("b", TILEDB_AGGREGATE_MAX, &max_b)
+        .add_aggregate("c", TILEDB_AGGREGATE_COUNT, &count_c);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    CHECK(count == 16);
+    CHECK(sum == 136);
+    CHECK(min == 1);
+    CHECK(max == 16);
+    CHECK(sum_b == 68.0);
+    CHECK(max_b == 8.0);
+    CHECK(count_c == 16);
+  }
+
+  SECTION("- Partial tiles") {
+    std::vector<int> subarray = {2, 3, 1, 4};
+    Query query(ctx, array);
+    query.set_subarray(subarray)
+        .set_layout(TILEDB_ROW_MAJOR)
+        .add_aggregate("a", TILEDB_AGGREGATE_COUNT, &count)
+        .add_aggregate("a", TILEDB_AGGREGATE_SUM, &sum)
+        .add_aggregate("a", TILEDB_AGGREGATE_MIN, &min)
+        .add_aggregate("a", TILEDB_AGGREGATE_MAX, &max);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    CHECK(count == 8);
+    CHECK(sum == 68);
+    CHECK(min == 5);
+    CHECK(max == 12);
+  }
+
+  SECTION("- With query condition") {
+    std::vector<int> subarray = {1, 4, 1, 4};
+    auto cond = QueryCondition::create(ctx, "a", 10, TILEDB_GT);
+    Query query(ctx, array);
+    query.set_subarray(subarray)
+        .set_layout(TILEDB_ROW_MAJOR)
+        .set_condition(cond)
+        .add_aggregate("a", TILEDB_AGGREGATE_COUNT, &count)
+        .add_aggregate("a", TILEDB_AGGREGATE_SUM, &sum)
+        .add_aggregate("b", TILEDB_AGGREGATE_MAX, &max_b);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    CHECK(count == 6);
+    CHECK(sum == 81);
+    CHECK(max_b == 8.0);
+  }
+
+  SECTION("- Invalid aggregates") {
+    Query query(ctx, array);
+    CHECK_THROWS(query.add_aggregate("c", TILEDB_AGGREGATE_SUM, &sum));
+    CHECK_THROWS(query.add_aggregate("foo", TILEDB_AGGREGATE_MIN, &min));
+    CHECK_THROWS(query.add_aggregate("a", TILEDB_AGGREGATE_MAX, nullptr));
+
+    std::vector<int> subarray = {1, 4, 1, 4};
+    std::vector<int> a(16);
+    query.set_subarray(subarray)
+        .set_layout(TILEDB_ROW_MAJOR)
+        .add_aggregate("a", TILEDB_AGGREGATE_SUM, &sum)
+        .set_buffer("a", a);
+    CHECK_THROWS(query.submit());
+  }
+
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Aggregate queries on sparse array", "[cppapi][query-aggregate]") {
+  const std::string array_name = "cpp_unit_array_query_aggregate_sparse";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+  create_sparse_array(ctx, array_name);
+
+  Array array(ctx, array_name, TILEDB_READ);
+  uint64_t count = 0;
+  int64_t sum = 0;
+  int min = 0, max = 0;
+
+  std::vector<int> subarray = {1, 4, 1, 4};
+  Query query(ctx, array);
+  query.set_subarray(subarray).set_layout(TILEDB_ROW_MAJOR);
+
+  SECTION("- Whole array") {
+    query.add_aggregate("a", TILEDB_AGGREGATE_COUNT, &count)
+        .add_aggregate("a", TILEDB_AGGREGATE_SUM, &sum)
+        .add_aggregate("a", TILEDB_AGGREGATE_MIN, &min)
+        .add_aggregate("a", TILEDB_AGGREGATE_MAX, &max);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    CHECK(count == 5);
+    CHECK(sum == 15);
+    CHECK(min == 1);
+    CHECK(max == 5);
+  }
+
+  SECTION("- With query condition") {
+    auto cond = QueryCondition::create(ctx, "a", 2, TILEDB_GE);
+    query.set_condition(cond)
+        .add_aggregate("a", TILEDB_AGGREGATE_COUNT, &count)
+        .add_aggregate("a", TILEDB_AGGREGATE_SUM, &sum)
+        .add_aggregate("a", TILEDB_AGGREGATE_MIN, &min);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    CHECK(count == 4);
+    CHECK(sum == 14);
+    CHECK(min == 2);
+  }
+
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Count queries on sparse array", "[cppapi][query-aggregate]") {
+  const std::string array_name = "cpp_unit_array_query_aggregate_sparse";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+  create_sparse_array(ctx, array_name);
+
+  uint64_t expected = 0;
+  std::vector<int> subarray = {1, 4, 1, 4};
+  SECTION("- Whole array") {
+    expected = 5;
+  }
+  SECTION("- Partially covered tiles") {
+    subarray = {1, 3, 1, 3};
+    expected = 4;
+  }
+  SECTION("- Overlapping fragments") {
+    // Update cell (1, 1) and add cell (3, 4)
+    std::vector<int> coords = {1, 1, 3, 4};
+    std::vector<int> a = {10, 11};
+    Array array(ctx, array_name, TILEDB_WRITE);
+    Query query(ctx, array);
+    query.set_layout(TILEDB_UNORDERED)
+        .set_buffer("a", a)
+        .set_coordinates(coords);
+    query.submit();
+    array.close();
+    expected = 6;
+  }
+
+  Array array(ctx, array_name, TILEDB_READ);
+  uint64_t count = 0;
+  Query query(ctx, array);
+  query.set_subarray(subarray)
+      .set_layout(TILEDB_ROW_MAJOR)
+      .add_aggregate("a", TILEDB_AGGREGATE_COUNT, &count);
+  REQUIRE(query.submit() == Query::Status::COMPLETE);
+  CHECK(count == expected);
+
+  // Multiple ranges count their cells separately
+  uint64_t count_ranges = 0;
+  Query query_ranges(ctx, array);
+  query_ranges.add_range(0, 1, 2)
+      .add_range(0, 4, 4)
+      .add_range(1, 1, 4)
+      .set_layout(TILEDB_UNORDERED)
+      .add_aggregate("a", TILEDB_AGGREGATE_COUNT, &count_ranges);
+  REQUIRE(query_ranges.submit() == Query::Status::COMPLETE);
+  CHECK(count_ranges == 4);
+
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
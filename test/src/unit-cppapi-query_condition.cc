@@ -0,0 +1,521 @@
+/**
+ * @file   unit-cppapi-query_condition.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * Tests the C++ API for query conditions.
+ */
+
+#include "catch.hpp"
+#include "tiledb/sm/cpp_api/tiledb"
+#include "tiledb/sm/misc/stats.h"
+
+using namespace tiledb;
+
+namespace {
+
+void create_sparse_array(const Context& ctx, const std::string& array_name) {
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "rows", {{1, 4}}, 2))
+      .add_dimension(Dimension::create<int>(ctx, "cols", {{1, 4}}, 2));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain).set_capacity(2);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  schema.add_attribute(Attribute::create<float>(ctx, "b"));
+  schema.add_attribute(Attribute::create<std::string>(ctx, "c"));
+  Array::create(array_name, schema);
+
+  std::vector<int> coords = {1, 1, 1, 2, 2, 1, 3, 3, 4, 4};
+  std::vector<int> a = {1, 2, 3, 4, 5};
+  std::vector<float> b = {0.1f, 0.6f, 0.2f, 0.9f, 0.3f};
+  std::vector<uint64_t> c_off = {0, 1, 2, 3, 4};
+  std::string c_val = "abcde";
+  Array array(ctx, array_name, TILEDB_WRITE);
+  Query query(ctx, array);
+  query.set_layout(TILEDB_UNORDERED)
+      .set_buffer("a", a)
+      .set_buffer("b", b)
+      .set_buffer("c", c_off, c_val)
+      .set_coordinates(coords);
+  query.submit();
+  array.close();
+}
+
+}  // namespace
+
+TEST_CASE(
+    "C++ API: Query condition on sparse array", "[cppapi][query-condition]") {
+  const std::string array_name = "cpp_unit_array_query_condition";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+  create_sparse_array(ctx, array_name);
+
+  Array array(ctx, array_name, TILEDB_READ);
+  std::vector<int> subarray = {1, 4, 1, 4};
+
+  SECTION("- AND") {
+    auto cond = QueryCondition::create(ctx, "a", 2, TILEDB_GE)
+                    .combine(
+                        QueryCondition::create(ctx, "b", 0.5f, TILEDB_LT),
+                        TILEDB_AND);
+    std::vector<int> a(5), coords(10);
+    Query query(ctx, array);
+    query.set_subarray(subarray)
+        .set_layout(TILEDB_ROW_MAJOR)
+        .set_condition(cond)
+        .set_buffer("a", a)
+        .set_coordinates(coords);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    auto result_num = query.result_buffer_elements();
+    REQUIRE(result_num["a"].second == 2);
+    REQUIRE(result_num[TILEDB_COORDS].second == 4);
+    CHECK(a[0] == 3);
+    CHECK(a[1] == 5);
+    CHECK(coords[0] == 2);
+    CHECK(coords[1] == 1);
+    CHECK(coords[2] == 4);
+    CHECK(coords[3] == 4);
+  }
+
+  SECTION("- OR, on attributes not read") {
+    auto cond = QueryCondition::create(ctx, "a", 1, TILEDB_EQ)
+                    .combine(
+                        QueryCondition::create(ctx, "b", 0.8f, TILEDB_GT),
+                        TILEDB_OR);
+    std::vector<uint64_t> c_off(5);
+    std::string c_val;
+    c_val.resize(5);
+    Query query(ctx, array);
+    query.set_subarray(subarray)
+        .set_layout(TILEDB_ROW_MAJOR)
+        .set_condition(cond)
+        .set_buffer("c", c_off, c_val);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    auto result_num = query.result_buffer_elements();
+    REQUIRE(result_num["c"].first == 2);
+    REQUIRE(result_num["c"].second == 2);
+    CHECK(c_val.substr(0, 2) == "ad");
+    CHECK(c_off[1] == 1);
+  }
+
+  SECTION("- Incomplete") {
+    auto cond = QueryCondition::create(ctx, "a", 1, TILEDB_NE);
+    std::vector<int> a(1), results;
+    Query query(ctx, array);
+    query.set_subarray(subarray)
+        .set_layout(TILEDB_ROW_MAJOR)
+        .set_condition(cond)
+        .set_buffer("a", a);
+    Query::Status status;
+    do {
+      status = query.submit();
+      auto result_num = query.result_buffer_elements()["a"].second;
+      results.insert(results.end(), a.begin(), a.begin() + result_num);
+    } while (status == Query::Status::INCOMPLETE);
+    REQUIRE(status == Query::Status::COMPLETE);
+    CHECK(results == (std::vector<int>{2, 3, 4, 5}));
+  }
+
+  SECTION("- Invalid conditions") {
+    std::vector<int> a(5);
+    Query query(ctx, array);
+    query.set_subarray(subarray).set_buffer("a", a);
+    CHECK_THROWS(query.set_condition(
+        QueryCondition::create(ctx, "foo", 1, TILEDB_EQ)));
+    CHECK_THROWS(
+        query.set_condition(QueryCondition::create(ctx, "c", 1, TILEDB_EQ)));
+    CHECK_THROWS(query.set_condition(
+        QueryCondition::create(ctx, "a", (int64_t)1, TILEDB_EQ)));
+    CHECK_THROWS(query.set_condition(QueryCondition(ctx)));
+    CHECK_THROWS(QueryCondition(ctx).combine(
+        QueryCondition::create(ctx, "a", 1, TILEDB_EQ), TILEDB_AND));
+
+    Array array_w(ctx, array_name, TILEDB_WRITE);
+    Query query_w(ctx, array_w);
+    CHECK_THROWS(query_w.set_condition(
+        QueryCondition::create(ctx, "a", 1, TILEDB_EQ)));
+    array_w.close();
+  }
+
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Query condition on dense array", "[cppapi][query-condition]") {
+  const std::string array_name = "cpp_unit_array_query_condition_dense";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 10}}, 5));
+  ArraySchema schema(ctx, TILEDB_DENSE);
+  schema.set_domain(domain);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  Array::create(array_name, schema);
+
+  // Write cells 1-5, leaving cells 6-10 empty
+  {
+    std::vector<int> a = {1, 2, 3, 4, 5};
+    Array array(ctx, array_name, TILEDB_WRITE);
+    Query query(ctx, array);
+    query.set_subarray<int>({1, 5}).set_layout(TILEDB_ROW_MAJOR);
+    query.set_buffer("a", a);
+    query.submit();
+    array.close();
+  }
+
+  Array array(ctx, array_name, TILEDB_READ);
+  auto read = [&](const QueryCondition& cond) {
+    std::vector<int> a(10);
+    Query query(ctx, array);
+    query.set_subarray<int>({1, 10})
+        .set_layout(TILEDB_ROW_MAJOR)
+        .set_condition(cond)
+        .set_buffer("a", a);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    a.resize(query.result_buffer_elements()["a"].second);
+    return a;
+  };
+
+  // Empty cells are compared using the fill value
+  CHECK(
+      read(QueryCondition::create(ctx, "a", 2, TILEDB_GT)) ==
+      (std::vector<int>{3, 4, 5}));
+  auto ne = read(QueryCondition::create(ctx, "a", 3, TILEDB_NE));
+  REQUIRE(ne.size() == 9);
+  CHECK(ne[0] == 1);
+  CHECK(ne[2] == 4);
+  CHECK(ne[4] == std::numeric_limits<int>::min());
+  CHECK(read(QueryCondition::create(ctx, "a", 0, TILEDB_LT)).size() == 5);
+
+  // Dense reads with a condition cannot retrieve the coordinates
+  std::vector<int> a(10), coords(10);
+  Query query(ctx, array);
+  query.set_subarray<int>({1, 10})
+      .set_condition(QueryCondition::create(ctx, "a", 2, TILEDB_GT))
+      .set_buffer("a", a)
+      .set_coordinates(coords);
+  CHECK_THROWS(query.submit());
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Query condition skipping tiles by value range",
+    "[cppapi][query-condition]") {
+  const std::string array_name = "cpp_unit_array_query_condition_ranges";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 10}}, 10));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain).set_capacity(2);
+  schema.add_attribute(Attribute::create<float>(ctx, "a"));
+  Array::create(array_name, schema);
+
+  // Tiles {1, 2}, {NaN, 3}, {4, 4} in the first fragment
+  {
+    std::vector<int> coords = {1, 2, 3, 4, 5, 6};
+    std::vector<float> a = {
+        1, 2, std::numeric_limits<float>::quiet_NaN(), 3, 4, 4};
+    Array array(ctx, array_name, TILEDB_WRITE);
+    Query query(ctx, array);
+    query.set_layout(TILEDB_UNORDERED)
+        .set_buffer("a", a)
+        .set_coordinates(coords);
+    query.submit();
+    array.close();
+  }
+
+  // Tiles {10, 11}, {12} in the second fragment, the last one written
+  // when the global order write is finalized
+  {
+    std::vector<int> coords = {7, 8, 9};
+    std::vector<float> a = {10, 11, 12};
+    Array array(ctx, array_name, TILEDB_WRITE);
+    Query query(ctx, array);
+    query.set_layout(TILEDB_GLOBAL_ORDER)
+        .set_buffer("a", a)
+        .set_coordinates(coords);
+    query.submit();
+    query.finalize();
+    array.close();
+  }
+
+  Array array(ctx, array_name, TILEDB_READ);
+  auto read = [&](const QueryCondition& cond) {
+    std::vector<int> coords(9);
+    std::vector<float> a(9);
+    Query query(ctx, array);
+    query.set_subarray<int>({1, 10})
+        .set_layout(TILEDB_ROW_MAJOR)
+        .set_condition(cond)
+        .set_buffer("a", a)
+        .set_coordinates(coords);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    coords.resize(query.result_buffer_elements()[TILEDB_COORDS].second);
+    return coords;
+  };
+
+  CHECK(
+      read(QueryCondition::create(ctx, "a", 4.0f, TILEDB_EQ)) ==
+      (std::vector<int>{5, 6}));
+  CHECK(
+      read(QueryCondition::create(ctx, "a", 4.0f, TILEDB_NE)) ==
+      (std::vector<int>{1, 2, 3, 4, 7, 8, 9}));
+  CHECK(
+      read(QueryCondition::create(ctx, "a", 2.0f, TILEDB_LT)) ==
+      (std::vector<int>{1}));
+  CHECK(
+      read(QueryCondition::create(ctx, "a", 11.0f, TILEDB_GE)) ==
+      (std::vector<int>{8, 9}));
+  CHECK(
+      read(QueryCondition::create(ctx, "a", 11.5f, TILEDB_GT)
+               .combine(
+                   QueryCondition::create(ctx, "a", 1.5f, TILEDB_LE),
+                   TILEDB_OR)) == (std::vector<int>{1, 9}));
+  CHECK(read(QueryCondition::create(ctx, "a", 20.0f, TILEDB_GT)).empty());
+  array.close();
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Query condition with value indexes",
+    "[cppapi][query-condition][value-index]") {
+  const std::string array_name = "cpp_unit_array_query_condition_index";
+  Config config;
+  config["sm.value_index_attributes"] = "a,c";
+  Context ctx(config);
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 10}}, 10));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain).set_capacity(2);
+  schema.add_attribute(Attribute::create<float>(ctx, "a"));
+  Array::create(array_name, schema);
+
+  // Tiles {1, 5}, {3, 3}, {NaN, 7}, the last two written by the second
+  // submission
+  {
+    Array array(ctx, array_name, TILEDB_WRITE);
+    Query query(ctx, array);
+    query.set_layout(TILEDB_GLOBAL_ORDER);
+    std::vector<int> coords = {1, 2, 3};
+    std::vector<float> a = {1, 5, 3};
+    query.set_buffer("a", a).set_coordinates(coords);
+    query.submit();
+    coords = {4, 5, 6};
+    a = {3, std::numeric_limits<float>::quiet_NaN(), 7};
+    query.set_buffer("a", a).set_coordinates(coords);
+    query.submit();
+    query.finalize();
+    array.close();
+  }
+
+  auto check = [&]() {
+    Array array(ctx, array_name, TILEDB_READ);
+    auto read = [&](const QueryCondition& cond) {
+      std::vector<int> coords(6);
+      std::vector<float> a(6);
+      Query query(ctx, array);
+      query.set_subarray<int>({1, 10})
+          .set_layout(TILEDB_ROW_MAJOR)
+          .set_condition(cond)
+          .set_buffer("a", a)
+          .set_coordinates(coords);
+      REQUIRE(query.submit() == Query::Status::COMPLETE);
+      coords.resize(query.result_buffer_elements()[TILEDB_COORDS].second);
+      return coords;
+    };
+
+    CHECK(
+        read(QueryCondition::create(ctx, "a", 3.0f, TILEDB_EQ)) ==
+        (std::vector<int>{3, 4}));
+    CHECK(read(QueryCondition::create(ctx, "a", 2.0f, TILEDB_EQ)).empty());
+    CHECK(
+        read(QueryCondition::create(ctx, "a", 3.0f, TILEDB_NE)) ==
+        (std::vector<int>{1, 2, 5, 6}));
+    CHECK(
+        read(QueryCondition::create(ctx, "a", 5.0f, TILEDB_GE)
+                 .combine(
+                     QueryCondition::create(ctx, "a", 7.0f, TILEDB_LT),
+                     TILEDB_AND)) == (std::vector<int>{2}));
+    CHECK(
+        read(QueryCondition::create(ctx, "a", 1.0f, TILEDB_EQ)
+                 .combine(
+                     QueryCondition::create(ctx, "a", 7.0f, TILEDB_EQ),
+                     TILEDB_OR)) == (std::vector<int>{1, 6}));
+    array.close();
+  };
+  check();
+
+  // The consolidated fragment keeps the index
+  {
+    std::vector<int> coords = {8};
+    std::vector<float> a = {3};
+    Array array(ctx, array_name, TILEDB_WRITE);
+    Query query(ctx, array);
+    query.set_layout(TILEDB_UNORDERED)
+        .set_buffer("a", a)
+        .set_coordinates(coords);
+    query.submit();
+    array.close();
+  }
+  Array::consolidate(ctx, array_name);
+  Array::vacuum(ctx, array_name);
+  {
+    Array array(ctx, array_name, TILEDB_READ);
+    std::vector<int> coords(7);
+    std::vector<float> a(7);
+    Query query(ctx, array);
+    query.set_subarray<int>({1, 10})
+        .set_layout(TILEDB_ROW_MAJOR)
+        .set_condition(QueryCondition::create(ctx, "a", 3.0f, TILEDB_EQ))
+        .set_buffer("a", a)
+        .set_coordinates(coords);
+    REQUIRE(query.submit() == Query::Status::COMPLETE);
+    coords.resize(query.result_buffer_elements()[TILEDB_COORDS].second);
+    CHECK(coords == (std::vector<int>{3, 4, 8}));
+    array.close();
+  }
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
+
+TEST_CASE(
+    "C++ API: Query condition with the cost-based read planner",
+    "[cppapi][query-condition][value-index][read-planner]") {
+  const std::string array_name = "cpp_unit_array_query_condition_planner";
+  Config config;
+  config["sm.value_index_attributes"] = "a";
+  config["sm.read_planner"] = "cost";
+  Context ctx(config);
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  // 100 tiles of 4 cells, with values cycling through 0-9
+  Domain domain(ctx);
+  domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 1000}}, 1000));
+  ArraySchema schema(ctx, TILEDB_SPARSE);
+  schema.set_domain(domain).set_capacity(4);
+  schema.add_attribute(Attribute::create<int>(ctx, "a"));
+  Array::create(array_name, schema);
+  {
+    std::vector<int> coords(400), a(400);
+    for (int i = 0; i < 400; ++i) {
+      coords[i] = i + 1;
+      a[i] = i % 10;
+    }
+    Array array(ctx, array_name, TILEDB_WRITE);
+    Query query(ctx, array);
+    query.set_layout(TILEDB_GLOBAL_ORDER)
+        .set_buffer("a", a)
+        .set_coordinates(coords);
+    query.submit();
+    query.finalize();
+    array.close();
+  }
+
+  // Reads the cells with value 3 in [1, end] with buffers of `cell_num`
+  // cells, over as many submissions as needed
+  auto read = [&](int end, uint64_t cell_num) {
+    Array array(ctx, array_name, TILEDB_READ);
+    Query query(ctx, array);
+    std::vector<int> coords(cell_num), a(cell_num), result;
+    query.set_subarray<int>({1, end})
+        .set_layout(TILEDB_ROW_MAJOR)
+        .set_condition(QueryCondition::create(ctx, "a", 3, TILEDB_EQ))
+        .set_buffer("a", a)
+        .set_coordinates(coords);
+    Query::Status status;
+    do {
+      status = query.submit();
+      auto num = query.result_buffer_elements()[TILEDB_COORDS].second;
+      result.insert(result.end(), coords.begin(), coords.begin() + num);
+    } while (status == Query::Status::INCOMPLETE);
+    CHECK(status == Query::Status::COMPLETE);
+    array.close();
+    return result;
+  };
+
+  auto& stats = tiledb::sm::stats::all_stats;
+  stats.set_enabled(true);
+
+  SECTION("- Index, several partitions") {
+    stats.reset();
+    auto result = read(1000, 8);
+    REQUIRE(result.size() == 40);
+    for (int i = 0; i < 40; ++i)
+      CHECK(result[i] == 10 * i + 4);
+    CHECK(stats.counter_reader_plan_num == 1);
+    CHECK(stats.counter_reader_plan_index_fragments == 1);
+    CHECK(stats.counter_reader_plan_scan_fragments == 0);
+    CHECK(stats.counter_reader_plan_prefetch == 1);
+    CHECK(stats.counter_reader_plan_balanced_splits == 1);
+    CHECK(stats.counter_reader_plan_est_partitions > 1);
+  }
+
+  SECTION("- Scan, single partition") {
+    stats.reset();
+    CHECK(read(8, 100) == (std::vector<int>{4}));
+    CHECK(stats.counter_reader_plan_num == 1);
+    CHECK(stats.counter_reader_plan_index_fragments == 0);
+    CHECK(stats.counter_reader_plan_scan_fragments == 1);
+    CHECK(stats.counter_reader_plan_prefetch == 0);
+    CHECK(stats.counter_reader_plan_balanced_splits == 0);
+    CHECK(stats.counter_reader_plan_est_partitions == 1);
+  }
+
+  stats.set_enabled(false);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
@@ -384,3 +384,86 @@ TEST_CASE(
   if (vfs.is_dir(array_name))
     vfs.remove_dir(array_name);
 }
+
+TEST_CASE(
+    "C++ API: Test subarray estimated result sizes",
+    "[cppapi][subarray][est-result-size]") {
+  const std::string array_name = "cpp_unit_array";
+  Context ctx;
+  VFS vfs(ctx);
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+
+  SECTION("- Sparse, overlapping fragments") {
+    Domain domain(ctx);
+    domain.add_dimension(Dimension::create<int>(ctx, "rows", {{0, 3}}, 4))
+        .add_dimension(Dimension::create<int>(ctx, "cols", {{0, 3}}, 4));
+    ArraySchema schema(ctx, TILEDB_SPARSE);
+    schema.set_domain(domain).set_order({{TILEDB_ROW_MAJOR, TILEDB_ROW_MAJOR}});
+    schema.add_attribute(Attribute::create<std::string>(ctx, "b"));
+    Array::create(array_name, schema);
+
+    // Write the same cells twice, in two fragments
+    std::vector<int> coords_w = {0, 0, 0, 1, 1, 0, 1, 1};
+    std::string b_w = "aabbccdd";
+    std::vector<uint64_t> b_off_w = {0, 2, 4, 6};
+    for (int i = 0; i < 2; ++i) {
+      Array array_w(ctx, array_name, TILEDB_WRITE);
+      Query query_w(ctx, array_w);
+      query_w.set_coordinates(coords_w)
+          .set_layout(TILEDB_UNORDERED)
+          .set_buffer("b", b_off_w, b_w);
+      query_w.submit();
+      query_w.finalize();
+      array_w.close();
+    }
+
+    // The estimate is calibrated to the 4 cells of the range
+    Array array(ctx, array_name, TILEDB_READ);
+    Query query(ctx, array);
+    int range[] = {0, 1};
+    query.add_range(0, range[0], range[1]).add_range(1, range[0], range[1]);
+    auto est_size = query.est_result_size_var("b");
+    CHECK(est_size.first == 4);
+    CHECK(est_size.second == 8);
+    array.close();
+  }
+
+  SECTION("- Dense, partially written") {
+    Domain domain(ctx);
+    domain.add_dimension(Dimension::create<int>(ctx, "d", {{1, 4}}, 2));
+    ArraySchema schema(ctx, TILEDB_DENSE);
+    schema.set_domain(domain).set_order({{TILEDB_ROW_MAJOR, TILEDB_ROW_MAJOR}});
+    schema.add_attribute(Attribute::create<int>(ctx, "a"));
+    schema.add_attribute(Attribute::create<std::string>(ctx, "b"));
+    Array::create(array_name, schema);
+
+    std::vector<int> a_w = {1, 2};
+    std::string b_w = "abcdef";
+    std::vector<uint64_t> b_off_w = {0, 3};
+    Array array_w(ctx, array_name, TILEDB_WRITE);
+    Query query_w(ctx, array_w);
+    query_w.set_subarray<int>({1, 2})
+        .set_layout(TILEDB_ROW_MAJOR)
+        .set_buffer("a", a_w)
+        .set_buffer("b", b_off_w, b_w);
+    query_w.submit();
+    query_w.finalize();
+    array_w.close();
+
+    // Dense reads return all cells, with single-value fills for the
+    // empty var-sized cells
+    Array array(ctx, array_name, TILEDB_READ);
+    Query query(ctx, array);
+    query.add_range(0, 1, 4);
+    CHECK(query.est_result_size("a") == 4 * sizeof(int));
+    auto est_size = query.est_result_size_var("b");
+    CHECK(est_size.first == 4);
+    CHECK(est_size.second == 8);
+    array.close();
+  }
+
+  if (vfs.is_dir(array_name))
+    vfs.remove_dir(array_name);
+}
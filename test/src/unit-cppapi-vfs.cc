@@ -167,3 +167,40 @@ TEST_CASE(
   // Clean up
   vfs.remove_dir(path);
 }
+
+TEST_CASE(
+    "C++ API: Test VFS warm up",
+    "[cppapi], [cppapi-vfs], [cppapi-vfs-warm-up]") {
+  using namespace tiledb;
+  Context ctx;
+  VFS vfs(ctx);
+
+#ifdef _WIN32
+  std::string path = sm::Win::current_dir() + "\\vfs_test\\";
+#else
+  std::string path =
+      std::string("file://") + sm::Posix::current_dir() + "/vfs_test/";
+#endif
+
+  // Warming up a backend without a connection pool is a no-op
+  REQUIRE_NOTHROW(vfs.warm_up(path));
+  REQUIRE_NOTHROW(ctx.warm_up(path));
+
+  // Unsupported schemes are an error
+  REQUIRE_THROWS_AS(vfs.warm_up("foo://bar"), tiledb::TileDBError);
+
+  if (ctx.is_supported_fs(TILEDB_S3)) {
+    Config config;
+    config["vfs.s3.endpoint_override"] = "localhost:9999";
+    config["vfs.s3.scheme"] = "http";
+    config["vfs.s3.use_virtual_addressing"] = "false";
+    Context s3_ctx(config);
+    VFS s3_vfs(s3_ctx);
+    std::string bucket = "s3://tiledb-warm-up";
+    if (!s3_vfs.is_bucket(bucket))
+      s3_vfs.create_bucket(bucket);
+    REQUIRE_NOTHROW(s3_vfs.warm_up(bucket));
+    REQUIRE_NOTHROW(s3_ctx.warm_up(bucket + "/some_array"));
+    s3_vfs.remove_bucket(bucket);
+  }
+}
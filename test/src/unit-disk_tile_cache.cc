@@ -0,0 +1,126 @@
+/**
+ * @file unit-disk_tile_cache.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * This file unit-tests class DiskTileCache.
+ */
+
+#include "catch.hpp"
+#include "tiledb/sm/cache/disk_tile_cache.h"
+#include "tiledb/sm/filesystem/vfs.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+using namespace tiledb::sm;
+
+TEST_CASE(
+    "DiskTileCache: Test read, write and eviction", "[disk_tile_cache]") {
+  std::unique_ptr<VFS> vfs(new VFS);
+  REQUIRE(vfs->init(nullptr, nullptr).ok());
+  URI dir("disk_tile_cache_unit_test");
+  bool exists = false;
+  REQUIRE(vfs->is_dir(dir, &exists).ok());
+  if (exists)
+    REQUIRE(vfs->remove_dir(dir).ok());
+
+  URI remote("s3://bucket/array/__fragment/a.tdb");
+  URI local("file:///array/__fragment/a.tdb");
+  const unsigned n = 100;
+  std::vector<int> tile(n), read_tile(n);
+  for (unsigned i = 0; i < n; ++i)
+    tile[i] = (int)i;
+  const uint64_t nbytes = n * sizeof(int);
+  const uint64_t entry_size =
+      sizeof(uint64_t) + remote.to_string().size() + nbytes;
+
+  {
+    // Room for two tiles
+    DiskTileCache cache(vfs.get(), dir, 2 * entry_size);
+    REQUIRE(cache.init().ok());
+    REQUIRE(vfs->is_dir(dir, &exists).ok());
+    CHECK(exists);
+    CHECK(cache.caches(remote));
+    CHECK(!cache.caches(local));
+
+    bool hit = true;
+    CHECK(cache.read(remote, 0, read_tile.data(), nbytes, &hit).ok());
+    CHECK(!hit);
+
+    CHECK(cache.write(remote, 0, tile.data(), nbytes).ok());
+    CHECK(cache.size() == entry_size);
+    CHECK(cache.read(remote, 0, read_tile.data(), nbytes, &hit).ok());
+    CHECK(hit);
+    CHECK(read_tile == tile);
+
+    // Other offsets and sizes are distinct tiles
+    CHECK(cache.read(remote, 4, read_tile.data(), nbytes, &hit).ok());
+    CHECK(!hit);
+    CHECK(cache.read(remote, 0, read_tile.data(), nbytes - 4, &hit).ok());
+    CHECK(!hit);
+
+    // The least recently used tile is evicted first
+    CHECK(cache.write(remote, 1000, tile.data(), nbytes).ok());
+    CHECK(cache.read(remote, 0, read_tile.data(), nbytes, &hit).ok());
+    CHECK(hit);
+    CHECK(cache.write(remote, 2000, tile.data(), nbytes).ok());
+    CHECK(cache.size() == 2 * entry_size);
+    CHECK(cache.read(remote, 1000, read_tile.data(), nbytes, &hit).ok());
+    CHECK(!hit);
+
+    // A tile larger than the cache is not stored
+    std::vector<int> big(3 * n);
+    CHECK(cache.write(remote, 3000, big.data(), 3 * nbytes).ok());
+    CHECK(cache.read(remote, 3000, big.data(), 3 * nbytes, &hit).ok());
+    CHECK(!hit);
+  }
+
+  {
+    // The entries are found again by a new cache on the same directory
+    DiskTileCache cache(vfs.get(), dir, 2 * entry_size);
+    REQUIRE(cache.init().ok());
+    CHECK(cache.size() == 2 * entry_size);
+    bool hit = false;
+    std::fill(read_tile.begin(), read_tile.end(), 0);
+    CHECK(cache.read(remote, 2000, read_tile.data(), nbytes, &hit).ok());
+    CHECK(hit);
+    CHECK(read_tile == tile);
+  }
+
+  {
+    // A smaller cache evicts entries on initialization
+    DiskTileCache cache(vfs.get(), dir, entry_size);
+    REQUIRE(cache.init().ok());
+    CHECK(cache.size() == entry_size);
+    std::vector<URI> uris;
+    REQUIRE(vfs->ls(dir, &uris).ok());
+    CHECK(uris.size() == 1);
+  }
+
+  REQUIRE(vfs->remove_dir(dir).ok());
+}
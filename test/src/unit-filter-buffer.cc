@@ -396,6 +396,27 @@ TEST_CASE("FilterBuffer: Test view reclaim", "[filter], [filter-buffer]") {
   CHECK(storage.num_in_use() == 0);
 }
 
+TEST_CASE("FilterBuffer: Test reclaim unused", "[filter], [filter-buffer]") {
+  FilterStorage storage;
+  {
+    FilterBuffer fbuf(&storage), fbuf2(&storage);
+    CHECK(fbuf.prepend_buffer(sizeof(uint64_t)).ok());
+    CHECK(fbuf2.prepend_buffer(sizeof(uint64_t)).ok());
+    CHECK(storage.num_available() == 0);
+    CHECK(storage.num_in_use() == 2);
+
+    // Buffers still used by a filter buffer are not reclaimed.
+    storage.reclaim_unused();
+    CHECK(storage.num_available() == 0);
+    CHECK(storage.num_in_use() == 2);
+  }
+
+  // The buffers of the destroyed filter buffers are reclaimed.
+  storage.reclaim_unused();
+  CHECK(storage.num_available() == 2);
+  CHECK(storage.num_in_use() == 0);
+}
+
 TEST_CASE("FilterBuffer: Test fixed allocation", "[filter], [filter-buffer]") {
   FilterStorage storage;
   FilterBuffer fbuf(&storage);
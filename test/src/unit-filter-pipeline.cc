@@ -39,6 +39,7 @@
 #include "tiledb/sm/enums/compressor.h"
 #include "tiledb/sm/enums/datatype.h"
 #include "tiledb/sm/enums/encryption_type.h"
+#include "tiledb/sm/enums/filter_option.h"
 #include "tiledb/sm/enums/filter_type.h"
 #include "tiledb/sm/filter/bit_width_reduction_filter.h"
 #include "tiledb/sm/filter/bitshuffle_filter.h"
@@ -47,6 +48,7 @@
 #include "tiledb/sm/filter/encryption_aes256gcm_filter.h"
 #include "tiledb/sm/filter/filter_pipeline.h"
 #include "tiledb/sm/filter/positive_delta_filter.h"
+#include "tiledb/sm/misc/constants.h"
 #include "tiledb/sm/tile/tile.h"
 
 #include <catch.hpp>
@@ -1060,6 +1062,102 @@ TEST_CASE("Filter: Test pipeline copy", "[filter]") {
     CHECK(buff.value<uint64_t>(i * sizeof(uint64_t)) == i);
 }
 
+TEST_CASE("Filter: Test batched pipeline runs", "[filter]") {
+  // Set up tiles of different sizes, each with its own pipeline
+  const std::vector<uint64_t> nelts = {1, 100, 3, 10000, 70000};
+  const auto tile_num = nelts.size();
+  std::vector<Buffer> buffs(tile_num);
+  std::vector<std::unique_ptr<Tile>> tiles;
+  std::vector<FilterPipeline> pipelines(tile_num);
+  for (uint64_t t = 0; t < tile_num; t++) {
+    for (uint64_t i = 0; i < nelts[t]; i++)
+      CHECK(buffs[t].write(&i, sizeof(uint64_t)).ok());
+    tiles.emplace_back(
+        new Tile(Datatype::UINT64, sizeof(uint64_t), 0, &buffs[t], false));
+
+    CHECK(pipelines[t].add_filter(Add1InPlace()).ok());
+    if (t % 2 == 0) {
+      CHECK(pipelines[t].add_filter(Add1OutOfPlace()).ok());
+      CHECK(pipelines[t].add_filter(PseudoChecksumFilter()).ok());
+    } else {
+      CHECK(pipelines[t].add_filter(BitWidthReductionFilter()).ok());
+    }
+    pipelines[t].set_max_chunk_size(1024);
+  }
+
+  std::vector<const FilterPipeline*> pipeline_ptrs;
+  std::vector<Tile*> tile_ptrs;
+  for (uint64_t t = 0; t < tile_num; t++) {
+    pipeline_ptrs.push_back(&pipelines[t]);
+    tile_ptrs.push_back(tiles[t].get());
+  }
+  std::vector<const Tile*> offsets_tiles(tile_num, nullptr);
+  std::vector<std::pair<void*, uint64_t>> dests(
+      tile_num, std::make_pair(nullptr, 0));
+
+  CHECK(FilterPipeline::run_forward(pipeline_ptrs, tile_ptrs, offsets_tiles)
+            .ok());
+  for (uint64_t t = 0; t < tile_num; t++) {
+    auto num_chunks = (nelts[t] * sizeof(uint64_t) + 1023) / 1024;
+    CHECK(buffs[t].value<uint64_t>(0) == num_chunks);
+  }
+
+  CHECK(FilterPipeline::run_reverse(pipeline_ptrs, tile_ptrs, dests).ok());
+  for (uint64_t t = 0; t < tile_num; t++) {
+    CHECK(tiles[t]->buffer()->size() == nelts[t] * sizeof(uint64_t));
+    for (uint64_t i = 0; i < nelts[t]; i++)
+      CHECK(tiles[t]->buffer()->value<uint64_t>(i * sizeof(uint64_t)) == i);
+  }
+}
+
+TEST_CASE("Filter: Test automatic chunk size", "[filter]") {
+  // Set up test data
+  const uint64_t nelts = 512 * 1024;
+  Buffer buff;
+  for (uint64_t i = 0; i < nelts; i++)
+    CHECK(buff.write(&i, sizeof(uint64_t)).ok());
+  CHECK(buff.size() == nelts * sizeof(uint64_t));
+
+  Tile tile(Datatype::UINT64, sizeof(uint64_t), 0, &buff, false);
+
+  FilterPipeline pipeline;
+  pipeline.set_max_chunk_size(0);
+  uint64_t min_chunk_size = constants::max_tile_chunk_size;
+  SECTION("- Without compression") {
+    CHECK(pipeline.add_filter(Add1InPlace()).ok());
+  }
+  SECTION("- With zstd") {
+    CHECK(pipeline.add_filter(CompressionFilter(Compressor::ZSTD, 5)).ok());
+    min_chunk_size = constants::auto_tile_chunk_min_size_large_window;
+  }
+
+  CHECK(pipeline.run_forward(&tile).ok());
+
+  // Check the chunk sizes
+  buff.reset_offset();
+  auto num_chunks = buff.value<uint64_t>();
+  CHECK(num_chunks >= nelts * sizeof(uint64_t) /
+                          constants::auto_tile_chunk_max_size);
+  buff.advance_offset(sizeof(uint64_t));
+  for (uint64_t i = 0; i < num_chunks; i++) {
+    auto orig_size = buff.value<uint32_t>();
+    CHECK(orig_size <= constants::auto_tile_chunk_max_size);
+    if (i + 1 < num_chunks)
+      CHECK(orig_size >= min_chunk_size);
+    buff.advance_offset(sizeof(uint32_t));
+    auto filtered_size = buff.value<uint32_t>();
+    buff.advance_offset(sizeof(uint32_t));
+    auto metadata_size = buff.value<uint32_t>();
+    buff.advance_offset(sizeof(uint32_t));
+    buff.advance_offset(metadata_size + filtered_size);
+  }
+
+  CHECK(pipeline.run_reverse(&tile).ok());
+  CHECK(tile.buffer()->size() == nelts * sizeof(uint64_t));
+  for (uint64_t i = 0; i < nelts; i++)
+    CHECK(tile.buffer()->value<uint64_t>(i * sizeof(uint64_t)) == i);
+}
+
 TEST_CASE("Filter: Test random pipeline", "[filter]") {
   // Set up test data
   const uint64_t nelts = 10000;
@@ -1182,7 +1280,7 @@ TEST_CASE("Filter: Test bit width reduction", "[filter]") {
 
   SECTION("- Window sizes") {
     std::vector<uint32_t> window_sizes = {
-        32, 64, 128, 256, 437, 512, 1024, 2000};
+        32, 64, 128, 256, 437, 512, 1024, 2000, 4000, 8000};
     for (auto window_size : window_sizes) {
       pipeline.get_filter<BitWidthReductionFilter>()->set_max_window_size(
           window_size);
@@ -1317,7 +1415,7 @@ TEST_CASE("Filter: Test positive-delta encoding", "[filter]") {
 
   SECTION("- Window sizes") {
     std::vector<uint32_t> window_sizes = {
-        32, 64, 128, 256, 437, 512, 1024, 2000};
+        32, 64, 128, 256, 437, 512, 1024, 2000, 4000, 8000};
     for (auto window_size : window_sizes) {
       pipeline.get_filter<PositiveDeltaFilter>()->set_max_window_size(
           window_size);
@@ -1340,6 +1438,17 @@ TEST_CASE("Filter: Test positive-delta encoding", "[filter]") {
 
     CHECK(!pipeline.run_forward(&tile).ok());
   }
+
+  SECTION("- Error on non-positive delta past the first batch") {
+    pipeline.get_filter<PositiveDeltaFilter>()->set_max_window_size(8000);
+    buff.reset_offset();
+    for (uint64_t i = 0; i < nelts; i++) {
+      auto val = i == 700 ? 0 : i;
+      CHECK(buff.write(&val, sizeof(uint64_t)).ok());
+    }
+
+    CHECK(!pipeline.run_forward(&tile).ok());
+  }
 }
 
 TEST_CASE("Filter: Test bitshuffle", "[filter]") {
@@ -1420,6 +1529,75 @@ TEST_CASE("Filter: Test byteshuffle", "[filter]") {
   }
 }
 
+TEST_CASE(
+    "Filter: Test byteshuffling compression", "[filter], [compression]") {
+  // Set up test data spanning several byteshuffle blocks in one chunk
+  const uint64_t nelts = 100000;
+  Buffer buff, plain_buff;
+  for (uint64_t i = 0; i < nelts; i++) {
+    uint64_t val = 1000000 + 7 * i;
+    CHECK(buff.write(&val, sizeof(uint64_t)).ok());
+    CHECK(plain_buff.write(&val, sizeof(uint64_t)).ok());
+  }
+  CHECK(buff.size() > constants::compression_byteshuffle_block_size);
+
+  Tile tile(Datatype::UINT64, sizeof(uint64_t), 0, &buff, false);
+  Tile plain_tile(Datatype::UINT64, sizeof(uint64_t), 0, &plain_buff, false);
+
+  Compressor compressor = Compressor::LZ4;
+  SECTION("- LZ4") {
+    compressor = Compressor::LZ4;
+  }
+  SECTION("- ZSTD") {
+    compressor = Compressor::ZSTD;
+  }
+
+  CompressionFilter filter(compressor, 1);
+  uint32_t shuffle = 1;
+  CHECK(
+      filter.set_option(FilterOption::COMPRESSION_BYTESHUFFLE, &shuffle).ok());
+  shuffle = 0;
+  CHECK(
+      filter.get_option(FilterOption::COMPRESSION_BYTESHUFFLE, &shuffle).ok());
+  CHECK(shuffle == 1);
+
+  FilterPipeline pipeline, plain_pipeline;
+  pipeline.set_max_chunk_size(buff.size());
+  plain_pipeline.set_max_chunk_size(buff.size());
+  CHECK(pipeline.add_filter(filter).ok());
+  CHECK(plain_pipeline.add_filter(CompressionFilter(compressor, 1)).ok());
+
+  // Check the shuffled data compresses better than the plain data
+  CHECK(pipeline.run_forward(&tile).ok());
+  CHECK(plain_pipeline.run_forward(&plain_tile).ok());
+  CHECK(tile.buffer()->size() < plain_tile.buffer()->size());
+
+  // Check the option survives serialization
+  Buffer serialized;
+  CHECK(pipeline.serialize(&serialized).ok());
+  ConstBuffer cbuff(serialized.data(), serialized.size());
+  FilterPipeline deserialized;
+  CHECK(deserialized.deserialize(&cbuff).ok());
+  auto deserialized_filter = deserialized.get_filter<CompressionFilter>();
+  REQUIRE(deserialized_filter != nullptr);
+  CHECK(deserialized_filter->byteshuffle());
+
+  CHECK(deserialized.run_reverse(&tile).ok());
+  CHECK(tile.buffer()->size() == nelts * sizeof(uint64_t));
+  for (uint64_t i = 0; i < nelts; i++)
+    CHECK(
+        tile.buffer()->value<uint64_t>(i * sizeof(uint64_t)) ==
+        1000000 + 7 * i);
+}
+
+TEST_CASE("Filter: Test byteshuffling compression option", "[filter]") {
+  CompressionFilter filter(Compressor::GZIP, 1);
+  uint32_t shuffle = 1;
+  CHECK(
+      !filter.set_option(FilterOption::COMPRESSION_BYTESHUFFLE, &shuffle).ok());
+  CHECK(!filter.byteshuffle());
+}
+
 TEST_CASE("Filter: Test encryption", "[filter], [encryption]") {
   // Set up test data
   const uint64_t nelts = 1000;
@@ -1469,4 +1647,30 @@ TEST_CASE("Filter: Test encryption", "[filter], [encryption]") {
     for (uint64_t i = 0; i < nelts; i++)
       CHECK(tile.buffer()->value<uint64_t>(i * sizeof(uint64_t)) == i);
   }
+
+  SECTION("- AES-256-GCM with several parts per chunk") {
+    // The compression filter outputs a metadata part and a data part per
+    // chunk, so all but the first part of each chunk use a derived IV.
+    FilterPipeline pipeline;
+    pipeline.set_max_chunk_size(1024);
+    CHECK(pipeline.add_filter(CompressionFilter(Compressor::LZ4, 1)).ok());
+    CHECK(pipeline.add_filter(EncryptionAES256GCMFilter()).ok());
+    char key[32], other_key[32];
+    for (unsigned i = 0; i < 32; i++) {
+      key[i] = (char)i;
+      other_key[i] = (char)(2 * i);
+    }
+    auto filter = pipeline.get_filter<EncryptionAES256GCMFilter>();
+
+    // Alternate keys, so that the cached key schedules get replaced
+    for (int round = 0; round < 4; round++) {
+      CHECK(filter->set_key(round % 2 == 0 ? key : other_key).ok());
+      CHECK(pipeline.run_forward(&tile).ok());
+      CHECK(pipeline.run_reverse(&tile).ok());
+      CHECK(tile.buffer()->size() == nelts * sizeof(uint64_t));
+      tile.buffer()->reset_offset();
+      for (uint64_t i = 0; i < nelts; i++)
+        CHECK(tile.buffer()->value<uint64_t>(i * sizeof(uint64_t)) == i);
+    }
+  }
 }
@@ -0,0 +1,127 @@
+/**
+ * @file unit-fragment_metadata_cache.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * This file unit-tests class FragmentMetadataCache.
+ */
+
+#include "catch.hpp"
+#include "tiledb/sm/buffer/buffer.h"
+#include "tiledb/sm/cache/fragment_metadata_cache.h"
+
+#include <memory>
+
+using namespace tiledb::sm;
+
+namespace {
+
+/** Returns a buffer holding `n` consecutive ints starting at `first`. */
+std::shared_ptr<const Buffer> make_object(int first, int n) {
+  auto v = std::make_shared<Buffer>();
+  for (int i = first; i < first + n; ++i)
+    v->write(&i, sizeof(int));
+  return v;
+}
+
+}  // namespace
+
+TEST_CASE(
+    "FragmentMetadataCache: Test insert, get and eviction",
+    "[fragment_metadata_cache]") {
+  URI meta_uri("file:///array/__1_1_uuid_5/__fragment_metadata.tdb");
+  auto key_size = (meta_uri.to_string() + "#0").size();
+  FragmentMetadataCache cache(2 * (key_size + 4 * sizeof(int)));
+
+  // Misses
+  CHECK(cache.get(meta_uri, 0) == nullptr);
+  uint64_t file_size = 0;
+  CHECK(!cache.file_size(meta_uri, &file_size));
+
+  // Objects at different offsets are distinct
+  auto v1 = make_object(0, 4);
+  auto v2 = make_object(4, 4);
+  cache.insert(meta_uri, 0, v1);
+  cache.insert(meta_uri, 4, v2);
+  CHECK(cache.get(meta_uri, 0) == v1);
+  CHECK(cache.get(meta_uri, 4) == v2);
+  CHECK(cache.size() == 2 * (key_size + 4 * sizeof(int)));
+
+  // The least recently used object is evicted, but stays valid
+  auto v3 = make_object(8, 4);
+  cache.insert(meta_uri, 8, v3);
+  CHECK(cache.get(meta_uri, 0) == nullptr);
+  CHECK(v1->value<int>(0) == 0);
+  CHECK(cache.get(meta_uri, 4) == v2);
+  CHECK(cache.get(meta_uri, 8) == v3);
+
+  // An object larger than the cache is not inserted
+  cache.insert(meta_uri, 12, make_object(0, 100));
+  CHECK(cache.get(meta_uri, 12) == nullptr);
+  CHECK(cache.get(meta_uri, 4) == v2);
+
+  // File sizes
+  cache.insert_file_size(meta_uri, 1234);
+  CHECK(cache.file_size(meta_uri, &file_size));
+  CHECK(file_size == 1234);
+
+  // Shrinking the cache evicts objects, and size zero disables it
+  cache.set_max_size(key_size + 4 * sizeof(int));
+  CHECK(cache.size() <= cache.max_size());
+  cache.set_max_size(0);
+  CHECK(cache.size() == 0);
+  cache.insert(meta_uri, 0, v1);
+  CHECK(cache.get(meta_uri, 0) == nullptr);
+}
+
+TEST_CASE(
+    "FragmentMetadataCache: Test invalidation", "[fragment_metadata_cache]") {
+  FragmentMetadataCache cache(1000000);
+  URI schema_uri("file:///array/__array_schema.tdb");
+  URI other_schema_uri("file:///array2/__array_schema.tdb");
+  URI meta_uri("file:///array/__1_1_uuid_5/__fragment_metadata.tdb");
+  auto v = make_object(0, 4);
+  cache.insert(schema_uri, 0, v);
+  cache.insert(other_schema_uri, 0, v);
+  cache.insert(meta_uri, 0, v);
+  cache.insert_file_size(meta_uri, 100);
+
+  // Invalidating a file only evicts its own objects
+  cache.invalidate(schema_uri);
+  CHECK(cache.get(schema_uri, 0) == nullptr);
+  CHECK(cache.get(other_schema_uri, 0) == v);
+  CHECK(cache.get(meta_uri, 0) == v);
+
+  // Invalidating a directory evicts the objects of all its files, but not
+  // of the directories that share its name as a prefix
+  cache.invalidate(URI("file:///array/"));
+  uint64_t file_size;
+  CHECK(cache.get(meta_uri, 0) == nullptr);
+  CHECK(!cache.file_size(meta_uri, &file_size));
+  CHECK(cache.get(other_schema_uri, 0) == v);
+  cache.clear();
+  CHECK(cache.size() == 0);
+}
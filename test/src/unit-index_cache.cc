@@ -0,0 +1,95 @@
+/**
+ * @file unit-index_cache.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * This file unit-tests class IndexCache.
+ */
+
+#include "catch.hpp"
+#include "tiledb/sm/cache/index_cache.h"
+#include "tiledb/sm/enums/datatype.h"
+#include "tiledb/sm/rtree/rtree.h"
+
+#include <memory>
+
+using namespace tiledb::sm;
+
+namespace {
+
+/** Returns a 1D R-Tree over `n` unit MBRs starting at `first`. */
+std::shared_ptr<const RTree> make_rtree(int first, int n) {
+  std::vector<int> m;
+  for (int i = first; i < first + n; ++i) {
+    m.push_back(i);
+    m.push_back(i);
+  }
+  std::vector<void*> mbrs;
+  for (int i = 0; i < n; ++i)
+    mbrs.push_back(&m[2 * i]);
+  return std::make_shared<RTree>(Datatype::INT32, 1, 2, mbrs);
+}
+
+}  // namespace
+
+TEST_CASE("IndexCache: Test insert, get and eviction", "[index_cache]") {
+  URI frag1("file:///array/__1_1_uuid1_5");
+  URI frag2("file:///array/__2_2_uuid2_5");
+  URI frag3("file:///array/__3_3_uuid3_5");
+  auto r1 = make_rtree(0, 4);
+  auto r2 = make_rtree(4, 4);
+  auto r3 = make_rtree(8, 4);
+  auto item_size = frag1.to_string().size() + sizeof(RTree) + r1->size();
+  REQUIRE(r1->size() > 0);
+  IndexCache cache(2 * item_size);
+
+  // Miss
+  CHECK(cache.get_rtree(frag1) == nullptr);
+
+  // Hits share the inserted R-Tree
+  cache.insert_rtree(frag1, r1);
+  cache.insert_rtree(frag2, r2);
+  CHECK(cache.get_rtree(frag1) == r1);
+  CHECK(cache.get_rtree(frag2) == r2);
+  CHECK(cache.size() == 2 * item_size);
+
+  // The least recently used R-Tree is evicted, but stays valid
+  cache.insert_rtree(frag3, r3);
+  CHECK(cache.get_rtree(frag1) == nullptr);
+  CHECK(r1->height() > 0);
+  CHECK(cache.get_rtree(frag2) == r2);
+  CHECK(cache.get_rtree(frag3) == r3);
+  CHECK(cache.size() <= cache.max_size());
+
+  // An R-Tree larger than the cache is not inserted
+  cache.insert_rtree(frag1, make_rtree(0, 100));
+  CHECK(cache.get_rtree(frag1) == nullptr);
+  CHECK(cache.get_rtree(frag2) == r2);
+
+  cache.clear();
+  CHECK(cache.size() == 0);
+  CHECK(cache.get_rtree(frag2) == nullptr);
+}
@@ -0,0 +1,122 @@
+/**
+ * @file   unit-parallel_functions.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *
+ * @section DESCRIPTION
+ *
+ * Tests the parallel utility functions.
+ */
+
+#include "tiledb/sm/misc/status.h"
+#include "tiledb/sm/misc/parallel_functions.h"
+
+#include <atomic>
+#include <catch.hpp>
+#include <random>
+
+using namespace tiledb::sm;
+
+TEST_CASE("Parallel functions: Radix sort", "[parallel][radix-sort]") {
+  uint64_t max_key = 0;
+  uint64_t n = 0;
+  SECTION("- Small keys, single chunk") {
+    max_key = 200;
+    n = 1000;
+  }
+  SECTION("- Large keys, multiple chunks") {
+    max_key = UINT64_MAX;
+    n = 200000;
+  }
+
+  std::mt19937_64 gen(0);
+  std::uniform_int_distribution<uint64_t> dist(0, max_key);
+  std::vector<std::pair<uint64_t, uint64_t>> v;
+  for (uint64_t i = 0; i < n; ++i)
+    v.emplace_back(dist(gen), i);
+
+  auto expected = v;
+  std::stable_sort(
+      expected.begin(),
+      expected.end(),
+      [](const std::pair<uint64_t, uint64_t>& a,
+         const std::pair<uint64_t, uint64_t>& b) { return a.first < b.first; });
+
+  parallel_radix_sort(&v, max_key);
+  CHECK(v == expected);
+}
+
+TEST_CASE(
+    "Parallel functions: Cancelable parallel for",
+    "[parallel][cancel]") {
+  const uint64_t n = 1000;
+  std::atomic<bool> cancel(false);
+  std::atomic<uint64_t> runs(0);
+
+  SECTION("- Not cancelled") {
+    auto statuses = cancelable_parallel_for(0, n, &cancel, [&](uint64_t) {
+      ++runs;
+      return Status::Ok();
+    });
+    for (uint64_t i = 0; i < n; ++i)
+      CHECK(statuses[i].ok());
+    CHECK(runs == n);
+  }
+
+  SECTION("- Cancelled midway") {
+    auto statuses = cancelable_parallel_for(0, n, &cancel, [&](uint64_t i) {
+      ++runs;
+      if (i == 0)
+        cancel = true;
+      return Status::Ok();
+    });
+    uint64_t failed = 0;
+    for (uint64_t i = 0; i < n; ++i)
+      failed += !statuses[i].ok();
+    CHECK(statuses[0].ok());
+    CHECK(runs + failed == n);
+  }
+
+  SECTION("- Cancelled before") {
+    cancel = true;
+    auto statuses = cancelable_parallel_for(0, n, &cancel, [&](uint64_t) {
+      ++runs;
+      return Status::Ok();
+    });
+    for (uint64_t i = 0; i < n; ++i)
+      CHECK(!statuses[i].ok());
+    CHECK(runs == 0);
+  }
+
+  SECTION("- No flag") {
+    cancel = true;
+    cancelable_parallel_for(0, n, nullptr, [&](uint64_t) {
+      ++runs;
+      return Status::Ok();
+    });
+    CHECK(runs == n);
+  }
+}
@@ -0,0 +1,108 @@
+/**
+ * @file unit-partition_tile_cache.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2021 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * This file unit-tests class PartitionTileCache.
+ */
+
+#include "catch.hpp"
+#include "tiledb/sm/buffer/buffer.h"
+#include "tiledb/sm/cache/partition_tile_cache.h"
+
+#include <cstring>
+
+using namespace tiledb::sm;
+
+namespace {
+
+/** Fills `buffer` with `n` consecutive ints starting at `first`. */
+void make_tile(int first, int n, Buffer* buffer) {
+  for (int i = first; i < first + n; ++i)
+    buffer->write(&i, sizeof(int));
+}
+
+}  // namespace
+
+TEST_CASE(
+    "PartitionTileCache: Test insert, get and eviction",
+    "[partition_tile_cache]") {
+  Buffer t1, t2, t3, big;
+  make_tile(0, 4, &t1);
+  make_tile(4, 4, &t2);
+  make_tile(8, 4, &t3);
+  make_tile(0, 20, &big);
+  TileCacheKey k1 = {1, 0, 0}, k2 = {1, 0, 16}, k3 = {2, 1, 0};
+  auto tile_size = 4 * sizeof(int);
+  PartitionTileCache cache;
+
+  // The cache is disabled until its size is set
+  CHECK(cache.insert(k1, &t1).ok());
+  CHECK(cache.get(k1, tile_size) == nullptr);
+  CHECK(cache.size() == 0);
+  cache.set_max_size(10 * sizeof(int));
+  CHECK(cache.max_size() == 10 * sizeof(int));
+
+  // Hits return a private copy of the tile
+  CHECK(cache.insert(k1, &t1).ok());
+  CHECK(cache.insert(k2, &t2).ok());
+  auto hit = cache.get(k1, tile_size);
+  REQUIRE(hit != nullptr);
+  CHECK(hit->data() != t1.data());
+  CHECK(std::memcmp(hit->data(), t1.data(), tile_size) == 0);
+  CHECK(cache.size() == 2 * tile_size);
+
+  // A tile smaller than requested is not returned
+  CHECK(cache.get(k1, tile_size + 1) == nullptr);
+
+  // The tiles of the previous partition are kept for the next one, but
+  // are evicted first to make room for its own tiles
+  cache.next_partition();
+  CHECK(cache.get(k2, tile_size) != nullptr);
+  CHECK(cache.insert(k3, &t3).ok());
+  CHECK(cache.get(k1, tile_size) == nullptr);
+  CHECK(cache.get(k2, tile_size) != nullptr);
+  CHECK(cache.get(k3, tile_size) != nullptr);
+  CHECK(cache.size() == 2 * tile_size);
+
+  // The tiles unused by two partitions are evicted, but stay valid
+  hit = cache.get(k3, tile_size);
+  cache.next_partition();
+  CHECK(cache.size() == 2 * tile_size);
+  cache.next_partition();
+  CHECK(cache.size() == 0);
+  CHECK(cache.get(k3, tile_size) == nullptr);
+  CHECK(std::memcmp(hit->data(), t3.data(), tile_size) == 0);
+
+  // A tile larger than the cache is not inserted
+  CHECK(cache.insert(k1, &big).ok());
+  CHECK(cache.get(k1, tile_size) == nullptr);
+
+  CHECK(cache.insert(k1, &t1).ok());
+  cache.clear();
+  CHECK(cache.size() == 0);
+  CHECK(cache.get(k1, tile_size) == nullptr);
+}
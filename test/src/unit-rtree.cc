@@ -30,6 +30,8 @@
  * Tests the `RTree` class.
  */
 
+#include "tiledb/sm/buffer/buffer.h"
+#include "tiledb/sm/buffer/const_buffer.h"
 #include "tiledb/sm/enums/datatype.h"
 #include "tiledb/sm/rtree/rtree.h"
 
@@ -38,6 +40,17 @@
 
 using namespace tiledb::sm;
 
+namespace {
+
+/** Returns the leaf MBR of the input R-Tree with the input index. */
+std::vector<uint8_t> leaf(const RTree& rtree, uint64_t leaf_idx) {
+  std::vector<uint8_t> mbr(2 * rtree.dim_num() * datatype_size(rtree.type()));
+  rtree.leaf(leaf_idx, &mbr[0]);
+  return mbr;
+}
+
+}  // namespace
+
 TEST_CASE("RTree: Test R-Tree, basic functions", "[rtree][basic]") {
   // Empty tree
   RTree rtree0;
@@ -62,9 +75,9 @@ TEST_CASE("RTree: Test R-Tree, basic functions", "[rtree][basic]") {
   CHECK(rtree1.subtree_leaf_num(0) == 3);
   CHECK(rtree1.subtree_leaf_num(1) == 1);
   CHECK(rtree1.subtree_leaf_num(2) == 0);
-  CHECK(!std::memcmp(rtree1.leaf(0), &m1[0], 2 * sizeof(int)));
-  CHECK(!std::memcmp(rtree1.leaf(1), &m1[2], 2 * sizeof(int)));
-  CHECK(!std::memcmp(rtree1.leaf(2), &m1[4], 2 * sizeof(int)));
+  CHECK(!std::memcmp(leaf(rtree1, 0).data(), &m1[0], 2 * sizeof(int)));
+  CHECK(!std::memcmp(leaf(rtree1, 1).data(), &m1[2], 2 * sizeof(int)));
+  CHECK(!std::memcmp(leaf(rtree1, 2).data(), &m1[4], 2 * sizeof(int)));
 
   std::vector<const int*> range1;
   int mbr1[] = {5, 10};
@@ -114,9 +127,9 @@ TEST_CASE("RTree: Test R-Tree, basic functions", "[rtree][basic]") {
   CHECK(rtree2.dim_num() == 2);
   CHECK(rtree2.fanout() == 5);
   CHECK(rtree2.type() == Datatype::INT64);
-  CHECK(!std::memcmp(rtree2.leaf(0), &m2[0], 4 * sizeof(int64_t)));
-  CHECK(!std::memcmp(rtree2.leaf(1), &m2[4], 4 * sizeof(int64_t)));
-  CHECK(!std::memcmp(rtree2.leaf(2), &m2[8], 4 * sizeof(int64_t)));
+  CHECK(!std::memcmp(leaf(rtree2, 0).data(), &m2[0], 4 * sizeof(int64_t)));
+  CHECK(!std::memcmp(leaf(rtree2, 1).data(), &m2[4], 4 * sizeof(int64_t)));
+  CHECK(!std::memcmp(leaf(rtree2, 2).data(), &m2[8], 4 * sizeof(int64_t)));
   std::vector<const int64_t*> range2;
   int64_t mbr2[] = {5, 10, 2, 9};
   int64_t r2_no[] = {6, 7, 10, 12};
@@ -409,3 +422,94 @@ TEST_CASE("RTree: Test 2D R-tree, height 3", "[rtree][2d][3h]") {
   CHECK(overlap.tiles_[0].first == 5);
   CHECK(overlap.tiles_[0].second == 2.0 / 3);
 }
+
+namespace {
+
+/**
+ * Returns the overlap ratio of each leaf of the input R-Tree with the
+ * input range, as computed by `get_tile_overlap`.
+ */
+template <class T>
+std::vector<double> overlap_ratios(
+    const RTree& rtree, const std::vector<const T*>& range) {
+  std::vector<double> ratios(rtree.leaf_num(), 0.0);
+  auto overlap = rtree.get_tile_overlap(range);
+  for (const auto& tr : overlap.tile_ranges_) {
+    CHECK(tr.first <= tr.second);
+    for (auto i = tr.first; i <= tr.second; ++i)
+      ratios[i] = 1.0;
+  }
+  for (size_t i = 1; i < overlap.tile_ranges_.size(); ++i)
+    CHECK(overlap.tile_ranges_[i - 1].second < overlap.tile_ranges_[i].first);
+  for (size_t i = 0; i < overlap.tiles_.size(); ++i) {
+    ratios[overlap.tiles_[i].first] = overlap.tiles_[i].second;
+    if (i > 0)
+      CHECK(overlap.tiles_[i - 1].first < overlap.tiles_[i].first);
+  }
+  return ratios;
+}
+
+/**
+ * Checks that STR packing gives the same tile overlap as consecutive
+ * grouping on a shuffled 2D grid of MBRs.
+ */
+template <class T>
+void check_str_packing(Datatype type) {
+  // A 20x20 grid of unit MBRs, in a shuffled order
+  std::vector<T> m;
+  for (int i = 0; i < 400; ++i) {
+    int pos = (i * 149) % 400;
+    T x = (T)(pos / 20), y = (T)(pos % 20);
+    m.insert(m.end(), {x, x, y, y});
+  }
+  std::vector<void*> mbrs;
+  for (size_t i = 0; i < m.size() / 4; ++i)
+    mbrs.push_back(&m[4 * i]);
+  RTree rtree(type, 2, 4, mbrs);
+  RTree rtree_str(type, 2, 4, mbrs, true);
+  CHECK(!rtree.str_packed());
+  CHECK(rtree_str.str_packed());
+  CHECK(rtree_str.leaf_num() == 400);
+  for (uint64_t i = 0; i < 400; ++i)
+    CHECK(!std::memcmp(leaf(rtree_str, i).data(), &m[4 * i], 4 * sizeof(T)));
+
+  // Serialization keeps the leaf order
+  Buffer buff;
+  CHECK(rtree_str.serialize(&buff).ok());
+  ConstBuffer cbuff(&buff);
+  RTree rtree_str2;
+  CHECK(rtree_str2.deserialize(&cbuff).ok());
+  CHECK(rtree_str2.str_packed());
+  CHECK(rtree_str2.size() == rtree_str.size());
+
+  T ranges[][4] = {{0, 19, 0, 19},
+                   {3, 3, 7, 7},
+                   {2, 9, 5, 12},
+                   {(T)2.5, 8, 0, 1},
+                   {30, 40, 0, 19}};
+  for (const auto& r : ranges) {
+    std::vector<const T*> range = {&r[0], &r[2]};
+    auto ratios = overlap_ratios<T>(rtree, range);
+    CHECK(overlap_ratios<T>(rtree_str, range) == ratios);
+    CHECK(overlap_ratios<T>(rtree_str2, range) == ratios);
+    for (uint64_t i = 0; i < 400; ++i)
+      CHECK(ratios[i] == RTree::range_overlap<T>(range, &m[4 * i]));
+  }
+}
+
+}  // namespace
+
+TEST_CASE("RTree: Test STR packing", "[rtree][str]") {
+  check_str_packing<int32_t>(Datatype::INT32);
+  check_str_packing<int64_t>(Datatype::INT64);
+  check_str_packing<uint16_t>(Datatype::UINT16);
+  check_str_packing<float>(Datatype::FLOAT32);
+  check_str_packing<double>(Datatype::FLOAT64);
+
+  // Packing fewer leaves than the fanout keeps the input order
+  int m[] = {5, 6, 1, 2};
+  std::vector<void*> mbrs = {&m[0], &m[2]};
+  RTree rtree(Datatype::INT32, 1, 4, mbrs, true);
+  CHECK(!rtree.str_packed());
+  CHECK(!std::memcmp(leaf(rtree, 1).data(), &m[2], 2 * sizeof(int)));
+}
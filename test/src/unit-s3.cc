@@ -36,9 +36,11 @@
 #include "tiledb/sm/config/config.h"
 #include "tiledb/sm/filesystem/s3.h"
 #include "tiledb/sm/global_state/unit_test_config.h"
+#include "tiledb/sm/misc/stats.h"
 #include "tiledb/sm/misc/thread_pool.h"
 #include "tiledb/sm/misc/utils.h"
 
+#include <algorithm>
 #include <fstream>
 #include <thread>
 
@@ -290,4 +292,185 @@ TEST_CASE_METHOD(S3Fx, "Test S3 multiupload abort path", "[s3]") {
   }
 }
 
+TEST_CASE_METHOD(S3Fx, "Test S3 writes within the buffer cap", "[s3]") {
+  // Cap the buffers of all objects below two parts
+  Config config;
+#ifndef TILEDB_TESTS_AWS_S3_CONFIG
+  REQUIRE(config.set("vfs.s3.endpoint_override", "localhost:9999").ok());
+  REQUIRE(config.set("vfs.s3.scheme", "https").ok());
+  REQUIRE(config.set("vfs.s3.use_virtual_addressing", "false").ok());
+  REQUIRE(config.set("vfs.s3.verify_ssl", "false").ok());
+#endif
+  REQUIRE(config.set("vfs.s3.max_parallel_ops", "4").ok());
+  REQUIRE(config.set("vfs.s3.max_buffer_size", "7340032").ok());
+  tiledb::sm::S3 s3;
+  REQUIRE(s3.init(config, &thread_pool_).ok());
+
+  // Prepare a buffer of 3MB
+  uint64_t buffer_size = 3 * 1024 * 1024;
+  std::vector<char> write_buffer(buffer_size);
+  for (uint64_t i = 0; i < buffer_size; i++)
+    write_buffer[i] = (char)('a' + (i % 26));
+
+  // Write to three files in turns, exceeding the cap after the third write
+  stats::all_stats.set_enabled(true);
+  stats::all_stats.reset();
+  std::vector<URI> files;
+  for (int f = 0; f < 3; ++f)
+    files.emplace_back(TEST_DIR + "capped_file" + std::to_string(f));
+  for (int w = 0; w < 2; ++w) {
+    for (const auto& file : files)
+      CHECK(s3.write(file, write_buffer.data(), buffer_size).ok());
+  }
+  CHECK(stats::all_stats.counter_vfs_s3_num_buffer_cap_flushes == 3);
+  stats::all_stats.set_enabled(false);
+
+  // Flush the files and check their contents
+  std::vector<char> read_buffer(2 * buffer_size);
+  for (const auto& file : files) {
+    CHECK(s3.flush_object(file).ok());
+    uint64_t nbytes = 0;
+    CHECK(s3.object_size(file, &nbytes).ok());
+    CHECK(nbytes == 2 * buffer_size);
+    CHECK(s3.read(file, 0, read_buffer.data(), 2 * buffer_size).ok());
+    CHECK(std::equal(
+        write_buffer.begin(), write_buffer.end(), read_buffer.begin()));
+    CHECK(std::equal(
+        write_buffer.begin(),
+        write_buffer.end(),
+        read_buffer.begin() + buffer_size));
+  }
+
+  s3.disconnect();
+}
+
+TEST_CASE_METHOD(S3Fx, "Test S3 hedged reads", "[s3]") {
+  // Hedge every read that is slower than the median, for any ratio of reads
+  Config config;
+#ifndef TILEDB_TESTS_AWS_S3_CONFIG
+  REQUIRE(config.set("vfs.s3.endpoint_override", "localhost:9999").ok());
+  REQUIRE(config.set("vfs.s3.scheme", "https").ok());
+  REQUIRE(config.set("vfs.s3.use_virtual_addressing", "false").ok());
+  REQUIRE(config.set("vfs.s3.verify_ssl", "false").ok());
+#endif
+  REQUIRE(config.set("vfs.s3.hedge_percentile", "50").ok());
+  REQUIRE(config.set("vfs.s3.hedge_max_ratio", "1.0").ok());
+  tiledb::sm::S3 s3;
+  REQUIRE(s3.init(config, &thread_pool_).ok());
+
+  // Write a file of 1MB
+  uint64_t buffer_size = 1024 * 1024;
+  std::vector<char> write_buffer(buffer_size);
+  for (uint64_t i = 0; i < buffer_size; i++)
+    write_buffer[i] = (char)('a' + (i % 26));
+  auto file = URI(TEST_DIR + "hedged_file");
+  CHECK(s3.write(file, write_buffer.data(), buffer_size).ok());
+  CHECK(s3.flush_object(file).ok());
+
+  // Every read returns the right bytes, whichever GET answers first
+  std::vector<char> read_buffer(4096);
+  for (uint64_t r = 0; r < 100; ++r) {
+    uint64_t offset = (r * 7919) % (buffer_size - read_buffer.size());
+    CHECK(s3.read(file, offset, read_buffer.data(), read_buffer.size()).ok());
+    CHECK(std::equal(
+        read_buffer.begin(),
+        read_buffer.end(),
+        write_buffer.begin() + offset));
+  }
+
+  s3.disconnect();
+}
+
+TEST_CASE_METHOD(S3Fx, "Test S3 batched remove_dir", "[s3]") {
+  // Create enough objects to span several multi-object delete requests
+  auto dir1 = TEST_DIR + "batch_dir1/";
+  auto dir2 = TEST_DIR + "batch_dir2/";
+  const uint64_t num_objects = 2 * constants::s3_max_delete_objects + 5;
+  for (uint64_t i = 0; i < num_objects; ++i)
+    REQUIRE(s3_.touch(URI(dir1 + "file" + std::to_string(i))).ok());
+  REQUIRE(s3_.touch(URI(dir2 + "file")).ok());
+
+  std::vector<std::string> paths;
+  CHECK(s3_.ls(URI(dir1), &paths, "").ok());
+  CHECK(paths.size() == num_objects);
+
+  // Remove both directories at once
+  CHECK(s3_.remove_dirs({URI(dir1), URI(dir2)}).ok());
+  paths.clear();
+  CHECK(s3_.ls(URI(TEST_DIR), &paths, "").ok());
+  CHECK(paths.empty());
+}
+
+TEST_CASE_METHOD(S3Fx, "Test S3 sharded ls", "[s3]") {
+  // Create more objects than fit in one listing page, with names that
+  // sort by a numeric prefix, plus a few common prefixes
+  auto dir = TEST_DIR + "sharded_dir/";
+  const uint64_t num_objects = 1500;
+  for (uint64_t i = 0; i < num_objects; ++i)
+    REQUIRE(
+        s3_.touch(URI(dir + "__" + std::to_string(10000 + i) + "_obj")).ok());
+  for (uint64_t i = 0; i < 10; ++i)
+    REQUIRE(s3_.touch(URI(dir + "__" + std::to_string(10500 + i) + "/f")).ok());
+  REQUIRE(s3_.touch(URI(dir + "__zzz")).ok());
+
+  std::vector<std::string> expected;
+  CHECK(s3_.ls(URI(dir), &expected).ok());
+  std::sort(expected.begin(), expected.end());
+  CHECK(expected.size() == num_objects + 11);
+
+  // Split the rest evenly up to the last numeric name
+  auto shard_boundaries = [&](const std::string& last, uint64_t shard_num) {
+    std::vector<std::string> boundaries;
+    uint64_t first = std::stoull(last.substr(2, 5));
+    uint64_t end = 10000 + num_objects;
+    for (uint64_t i = 1; i < shard_num; ++i)
+      boundaries.push_back(
+          "__" + std::to_string(first + (end - first) * i / shard_num));
+    return boundaries;
+  };
+  std::vector<std::string> paths;
+  CHECK(s3_.ls_sharded(URI(dir), &paths, shard_boundaries).ok());
+  std::sort(paths.begin(), paths.end());
+  CHECK(paths == expected);
+
+  CHECK(s3_.remove_dir(URI(dir)).ok());
+}
+
+TEST_CASE_METHOD(S3Fx, "Test S3 parallel move_dir", "[s3]") {
+  // Create objects of different sizes, some in a subdirectory
+  auto dir = TEST_DIR + "move_dir/";
+  auto dir2 = TEST_DIR + "move_dir2/";
+  const uint64_t num_objects = 20;
+  std::vector<std::string> names;
+  for (uint64_t i = 0; i < num_objects; ++i) {
+    auto name = (i % 2 ? "sub/file" : "file") + std::to_string(i);
+    std::string data(100 * i + 1, (char)('a' + i));
+    REQUIRE(s3_.write(URI(dir + name), data.data(), data.size()).ok());
+    REQUIRE(s3_.flush_object(URI(dir + name)).ok());
+    names.push_back(name);
+  }
+
+  std::vector<std::string> paths;
+  std::vector<uint64_t> sizes;
+  CHECK(s3_.ls(URI(dir), &paths, "", -1, &sizes).ok());
+  CHECK(paths.size() == num_objects);
+  CHECK(sizes.size() == num_objects);
+
+  // Move and check the new objects
+  CHECK(s3_.move_dir(URI(dir), URI(dir2)).ok());
+  paths.clear();
+  CHECK(s3_.ls(URI(dir), &paths, "").ok());
+  CHECK(paths.empty());
+  for (uint64_t i = 0; i < num_objects; ++i) {
+    uint64_t nbytes = 0;
+    CHECK(s3_.object_size(URI(dir2 + names[i]), &nbytes).ok());
+    CHECK(nbytes == 100 * i + 1);
+    std::string data(nbytes, '\0');
+    CHECK(s3_.read(URI(dir2 + names[i]), 0, &data[0], nbytes).ok());
+    CHECK(data == std::string(nbytes, (char)('a' + i)));
+  }
+
+  CHECK(s3_.remove_dir(URI(dir2)).ok());
+}
+
 #endif
@@ -0,0 +1,130 @@
+/**
+ * @file unit-sketches.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * This file unit-tests classes HyperLogLog and KllSketch.
+ */
+
+#include "catch.hpp"
+#include "tiledb/sm/buffer/buffer.h"
+#include "tiledb/sm/buffer/const_buffer.h"
+#include "tiledb/sm/misc/hyperloglog.h"
+#include "tiledb/sm/misc/kll_sketch.h"
+
+#include <cmath>
+
+using namespace tiledb::sm;
+
+TEST_CASE("HyperLogLog: Test estimate", "[sketches]") {
+  HyperLogLog hll;
+  CHECK(hll.estimate() == 0);
+
+  // Small cardinalities are counted almost exactly
+  for (int i = 0; i < 100; ++i) {
+    hll.add(HyperLogLog::hash_value<int>(i));
+    hll.add(HyperLogLog::hash_value<int>(i));
+  }
+  CHECK(hll.estimate() >= 98);
+  CHECK(hll.estimate() <= 102);
+
+  // The standard error is about 1.6%
+  for (int64_t i = 0; i < 100000; ++i)
+    hll.add(HyperLogLog::hash_value<int64_t>(i));
+  CHECK(hll.estimate() > 95000);
+  CHECK(hll.estimate() < 105000);
+
+  CHECK(
+      HyperLogLog::hash_value<double>(0.0) ==
+      HyperLogLog::hash_value<double>(-0.0));
+}
+
+TEST_CASE("HyperLogLog: Test merge and serialization", "[sketches]") {
+  HyperLogLog a, b;
+  for (uint32_t i = 0; i < 20000; ++i)
+    a.add(HyperLogLog::hash_value<uint32_t>(i));
+  for (uint32_t i = 10000; i < 30000; ++i)
+    b.add(HyperLogLog::hash_value<uint32_t>(i));
+  a.merge(b);
+  CHECK(a.estimate() > 28500);
+  CHECK(a.estimate() < 31500);
+
+  Buffer buff;
+  REQUIRE(a.serialize(&buff).ok());
+  HyperLogLog loaded;
+  ConstBuffer cbuff(buff.data(), buff.size());
+  REQUIRE(loaded.deserialize(&cbuff).ok());
+  CHECK(loaded.estimate() == a.estimate());
+
+  // Truncated input
+  ConstBuffer truncated(buff.data(), buff.size() - 1);
+  CHECK(!HyperLogLog().deserialize(&truncated).ok());
+}
+
+TEST_CASE("KllSketch: Test quantiles", "[sketches]") {
+  KllSketch kll;
+  CHECK(std::isnan(kll.quantile(0.5)));
+
+  const uint64_t n = 100000;
+  for (uint64_t i = 0; i < n; ++i)
+    kll.add((double)((i * 7919) % n));
+  kll.add(std::nan(""));
+  CHECK(kll.count() == n);
+
+  // The extremes are exact and the other ranks within a few percent
+  CHECK(kll.quantile(0) == 0);
+  CHECK(kll.quantile(1) == n - 1);
+  for (double q : {0.1, 0.5, 0.9}) {
+    auto v = kll.quantile(q);
+    CHECK(std::abs(v - q * n) < 0.03 * n);
+  }
+}
+
+TEST_CASE("KllSketch: Test merge and serialization", "[sketches]") {
+  KllSketch a, b;
+  for (int i = 0; i < 50000; ++i) {
+    a.add(i);
+    b.add(50000 + i);
+  }
+  a.merge(b);
+  CHECK(a.count() == 100000);
+  CHECK(a.quantile(0) == 0);
+  CHECK(a.quantile(1) == 99999);
+  CHECK(std::abs(a.quantile(0.5) - 50000) < 3000);
+
+  Buffer buff;
+  REQUIRE(a.serialize(&buff).ok());
+  KllSketch loaded;
+  ConstBuffer cbuff(buff.data(), buff.size());
+  REQUIRE(loaded.deserialize(&cbuff).ok());
+  CHECK(loaded.count() == a.count());
+  for (double q : {0.0, 0.25, 0.5, 0.75, 1.0})
+    CHECK(loaded.quantile(q) == a.quantile(q));
+
+  // Truncated input
+  ConstBuffer truncated(buff.data(), buff.size() - 1);
+  CHECK(!KllSketch().deserialize(&truncated).ok());
+}
@@ -30,9 +30,11 @@
  * Tests the `ThreadPool` class.
  */
 
+#include <algorithm>
 #include <atomic>
 #include <catch.hpp>
 #include "tiledb/sm/misc/cancelable_tasks.h"
+#include "tiledb/sm/misc/numa.h"
 #include "tiledb/sm/misc/thread_pool.h"
 
 using namespace tiledb::sm;
@@ -89,6 +91,142 @@ TEST_CASE("ThreadPool: Test wait status", "[threadpool]") {
   CHECK(result == 100);
 }
 
+TEST_CASE("ThreadPool: Test nested wait", "[threadpool]") {
+  // Every task waits on subtasks of the same pool; the waiting threads
+  // execute the subtasks themselves, so even one thread cannot deadlock.
+  for (uint64_t num_threads : {1, 4}) {
+    std::atomic<int> result(0);
+    std::vector<std::future<Status>> results;
+    ThreadPool pool;
+    REQUIRE(pool.init(num_threads).ok());
+    for (int i = 0; i < 10; i++) {
+      results.push_back(pool.enqueue([&pool, &result]() {
+        std::vector<std::future<Status>> subtasks;
+        for (int j = 0; j < 10; j++) {
+          subtasks.push_back(pool.enqueue([&result]() {
+            result++;
+            return Status::Ok();
+          }));
+        }
+        return pool.wait_all(subtasks);
+      }));
+    }
+    CHECK(pool.wait_all(results).ok());
+    CHECK(result == 100);
+  }
+}
+
+TEST_CASE("ThreadPool: Test priorities and views", "[threadpool]") {
+  ThreadPool scheduler;
+  REQUIRE(scheduler.init(1).ok());
+  std::vector<int> order;
+  {
+    ThreadPool io, compute, background;
+    REQUIRE(io.init(&scheduler, ThreadPool::Priority::IO).ok());
+    REQUIRE(compute.init(&scheduler, ThreadPool::Priority::COMPUTE).ok());
+    REQUIRE(
+        background.init(&scheduler, ThreadPool::Priority::BACKGROUND).ok());
+    CHECK(io.num_threads() == 1);
+
+    // Keep the only thread busy while the tasks are enqueued
+    std::promise<void> started, release;
+    auto released = release.get_future().share();
+    auto blocker = scheduler.enqueue([&started, released]() {
+      started.set_value();
+      released.wait();
+      return Status::Ok();
+    });
+    started.get_future().wait();
+
+    std::vector<std::future<Status>> tasks;
+    ThreadPool* pools[] = {&background, &compute, &io};
+    for (int i = 0; i < 3; i++) {
+      tasks.push_back(pools[i]->enqueue([&order, i]() {
+        order.push_back(i);
+        return Status::Ok();
+      }));
+    }
+    release.set_value();
+    CHECK(blocker.get().ok());
+
+    // The views wait for their outstanding tasks when destroyed
+  }
+  CHECK(order == std::vector<int>({2, 1, 0}));
+}
+
+TEST_CASE("ThreadPool: Test inherited priority", "[threadpool]") {
+  ThreadPool pool;
+  REQUIRE(pool.init(1).ok());
+
+  // Keep the only thread busy while the tasks are enqueued
+  std::promise<void> started, release;
+  auto released = release.get_future().share();
+  auto blocker = pool.enqueue([&started, released]() {
+    started.set_value();
+    released.wait();
+    return Status::Ok();
+  });
+  started.get_future().wait();
+
+  // The high priority task enqueues an I/O task, which inherits its class
+  // and overtakes the pending I/O task enqueued before
+  std::vector<int> order;
+  std::vector<std::future<Status>> tasks;
+  tasks.push_back(pool.enqueue(
+      [&order]() {
+        order.push_back(0);
+        return Status::Ok();
+      },
+      ThreadPool::Priority::IO));
+  std::future<Status> nested;
+  {
+    ThreadPool::PriorityScope scope(ThreadPool::Priority::HIGH);
+    tasks.push_back(pool.enqueue([&pool, &order, &nested]() {
+      order.push_back(1);
+      nested = pool.enqueue(
+          [&order]() {
+            order.push_back(2);
+            return Status::Ok();
+          },
+          ThreadPool::Priority::IO);
+      return Status::Ok();
+    }));
+  }
+  release.set_value();
+  CHECK(blocker.get().ok());
+  CHECK(pool.wait_all(tasks).ok());
+  CHECK(nested.get().ok());
+  CHECK(order == std::vector<int>({1, 2, 0}));
+}
+
+TEST_CASE("ThreadPool: Test NUMA pinning", "[threadpool]") {
+  ThreadPool pool;
+  REQUIRE(pool.init(4).ok());
+  REQUIRE(pool.pin_numa_nodes().ok());
+
+  // Every task runs on a CPU of some NUMA node, if the topology is known
+  const auto& nodes = numa::node_cpus();
+  std::atomic<int> misplaced(0);
+  std::vector<std::future<Status>> tasks;
+  for (int i = 0; i < 16; i++) {
+    tasks.push_back(pool.enqueue([&nodes, &misplaced]() {
+#ifdef __linux__
+      auto cpu = (unsigned)sched_getcpu();
+      bool found = nodes.empty();
+      for (const auto& cpus : nodes)
+        found |= std::count(cpus.begin(), cpus.end(), cpu) > 0;
+      misplaced += found ? 0 : 1;
+#else
+      (void)nodes;
+      (void)misplaced;
+#endif
+      return Status::Ok();
+    }));
+  }
+  CHECK(pool.wait_all(tasks).ok());
+  CHECK(misplaced == 0);
+}
+
 TEST_CASE("ThreadPool: Test no wait", "[threadpool]") {
   {
     ThreadPool pool;
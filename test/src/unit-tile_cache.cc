@@ -0,0 +1,255 @@
+/**
+ * @file unit-tile_cache.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * This file unit-tests class TileCache.
+ */
+
+#include "catch.hpp"
+#include "tiledb/sm/buffer/buffer.h"
+#include "tiledb/sm/cache/tile_cache.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace tiledb::sm;
+
+namespace {
+
+/** Returns a buffer holding `n` consecutive ints starting at `first`. */
+std::shared_ptr<const Buffer> make_object(int first, int n) {
+  auto v = std::make_shared<Buffer>();
+  for (int i = first; i < first + n; ++i)
+    v->write(&i, sizeof(int));
+  return v;
+}
+
+}  // namespace
+
+TEST_CASE("TileCache: Test insert, read and eviction", "[tile_cache]") {
+  TileCache cache(10 * sizeof(int), 1);
+  CHECK(cache.shard_num() == 1);
+  CHECK(cache.max_object_size() == 10 * sizeof(int));
+
+  // Insert a null object
+  TileCacheKey k1 = {1, 0, 0};
+  CHECK(!cache.insert(k1, nullptr, true).ok());
+
+  // Insert an object larger than the cache
+  bool success;
+  auto big = make_object(0, 11);
+  CHECK(cache.insert(k1, big, true).ok());
+  Buffer buf;
+  CHECK(cache.read(k1, &buf, 0, sizeof(int), &success).ok());
+  CHECK(!success);
+  CHECK(cache.size() == 0);
+
+  // Keys that differ in a single field are distinct
+  TileCacheKey k2 = {1, 1, 0};
+  TileCacheKey k3 = {1, 0, 16};
+  auto v1 = make_object(0, 3);
+  auto v2 = make_object(3, 3);
+  auto v3 = make_object(6, 3);
+  CHECK(cache.insert(k1, v1, true).ok());
+  CHECK(cache.insert(k2, v2, true).ok());
+  CHECK(cache.insert(k3, v3, true).ok());
+  CHECK(cache.size() == 9 * sizeof(int));
+
+  // Read full and partial objects
+  CHECK(cache.read(k3, &buf, 0, 3 * sizeof(int), &success).ok());
+  CHECK(success);
+  CHECK(!memcmp(buf.data(), v3->data(), 3 * sizeof(int)));
+  buf.reset_offset();
+  CHECK(cache.read(k1, &buf, sizeof(int), sizeof(int), &success).ok());
+  CHECK(success);
+  CHECK(buf.value<int>(0) == 1);
+
+  // Read out of bounds
+  buf.reset_offset();
+  CHECK(!cache.read(k1, &buf, sizeof(int), 3 * sizeof(int), &success).ok());
+
+  // Do not overwrite if not requested
+  auto v1_new = make_object(100, 3);
+  CHECK(cache.insert(k1, v1_new, false).ok());
+  buf.reset_offset();
+  CHECK(cache.read(k1, &buf, 0, sizeof(int), &success).ok());
+  CHECK(success);
+  CHECK(buf.value<int>(0) == 0);
+
+  // The least recently used object (k2) is evicted first
+  TileCacheKey k4 = {2, 0, 0};
+  auto v4 = make_object(9, 3);
+  CHECK(cache.insert(k4, v4, true).ok());
+  buf.reset_offset();
+  CHECK(cache.read(k2, &buf, 0, sizeof(int), &success).ok());
+  CHECK(!success);
+  CHECK(cache.size() == 9 * sizeof(int));
+
+  // Invalidate
+  CHECK(cache.invalidate(k3, &success).ok());
+  CHECK(success);
+  CHECK(cache.invalidate(k3, &success).ok());
+  CHECK(!success);
+  CHECK(cache.size() == 6 * sizeof(int));
+
+  // Clear
+  cache.clear();
+  CHECK(cache.size() == 0);
+  buf.reset_offset();
+  CHECK(cache.read(k1, &buf, 0, sizeof(int), &success).ok());
+  CHECK(!success);
+}
+
+TEST_CASE("TileCache: Test shards", "[tile_cache]") {
+  // Zero shards are treated as one
+  TileCache single(100, 0);
+  CHECK(single.shard_num() == 1);
+
+  const int shard_num = 4;
+  const int object_num = 64;
+  TileCache cache(shard_num * 4 * object_num * sizeof(int), shard_num);
+  CHECK(cache.shard_num() == shard_num);
+  CHECK(cache.max_object_size() == 4 * object_num * sizeof(int));
+
+  // Insert and read concurrently, one thread per fragment
+  std::vector<std::thread> threads;
+  std::vector<int> hits(shard_num, 0);
+  for (int t = 0; t < shard_num; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < object_num; ++i) {
+        TileCacheKey key = {(uint64_t)t, 0, (uint64_t)i * 64};
+        cache.insert(key, make_object(i, 1), true);
+      }
+      Buffer buf;
+      for (int i = 0; i < object_num; ++i) {
+        TileCacheKey key = {(uint64_t)t, 0, (uint64_t)i * 64};
+        bool success = false;
+        buf.reset_offset();
+        cache.read(key, &buf, 0, sizeof(int), &success);
+        if (success && buf.value<int>(0) == i)
+          ++hits[t];
+      }
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+
+  // The cache is large enough to hold every object in any shard
+  for (int t = 0; t < shard_num; ++t)
+    CHECK(hits[t] == object_num);
+  CHECK(cache.size() == shard_num * object_num * sizeof(int));
+}
+
+TEST_CASE("TileCache: Test pinned objects", "[tile_cache]") {
+  TileCache cache(3 * sizeof(int), 1);
+
+  // A miss pins nothing
+  TileCacheKey k1 = {1, 0, 0};
+  std::shared_ptr<const Buffer> pinned = make_object(0, 1);
+  CHECK(cache.pin(k1, &pinned).ok());
+  CHECK(pinned == nullptr);
+
+  // A hit shares the cached object
+  auto v1 = make_object(0, 3);
+  CHECK(cache.insert(k1, v1, true).ok());
+  CHECK(cache.pin(k1, &pinned).ok());
+  CHECK(pinned == v1);
+  v1.reset();
+
+  // The pinned object outlives its eviction
+  TileCacheKey k2 = {2, 0, 0};
+  CHECK(cache.insert(k2, make_object(3, 3), true).ok());
+  CHECK(cache.size() == 3 * sizeof(int));
+  std::shared_ptr<const Buffer> evicted;
+  CHECK(cache.pin(k1, &evicted).ok());
+  CHECK(evicted == nullptr);
+  CHECK(pinned.use_count() == 1);
+  CHECK(pinned->size() == 3 * sizeof(int));
+  CHECK(((const int*)pinned->data())[2] == 2);
+}
+
+TEST_CASE("TileCache: Test 2Q scan resistance", "[tile_cache]") {
+  TileCache::Policy policy;
+  CHECK(TileCache::policy_from_str("lru", &policy).ok());
+  CHECK(policy == TileCache::Policy::LRU);
+  CHECK(TileCache::policy_from_str("2q", &policy).ok());
+  CHECK(policy == TileCache::Policy::TWO_Q);
+  CHECK(!TileCache::policy_from_str("foo", &policy).ok());
+
+  bool two_q = false;
+  SECTION("- LRU") {
+    policy = TileCache::Policy::LRU;
+  }
+  SECTION("- 2Q") {
+    policy = TileCache::Policy::TWO_Q;
+    two_q = true;
+  }
+
+  // Room for 8 objects of one int each
+  TileCache cache(8 * sizeof(int), 1, policy);
+  CHECK(cache.policy() == policy);
+  auto insert = [&](uint64_t id) {
+    TileCacheKey key = {id, 0, 0};
+    CHECK(cache.insert(key, make_object((int)id, 1), false).ok());
+  };
+  auto cached = [&](uint64_t id) {
+    TileCacheKey key = {id, 0, 0};
+    std::shared_ptr<const Buffer> object;
+    CHECK(cache.pin(key, &object).ok());
+    return object != nullptr;
+  };
+
+  // Two hot objects are read, pushed out and read again
+  insert(1);
+  insert(2);
+  for (uint64_t id = 100; id < 108; ++id)
+    insert(id);
+  CHECK(!cached(1));
+  CHECK(!cached(2));
+  insert(1);
+  insert(2);
+  CHECK(cached(1));
+  CHECK(cached(2));
+
+  // A large scan evicts the hot objects only under LRU
+  for (uint64_t id = 200; id < 240; ++id)
+    insert(id);
+  CHECK(cached(1) == two_q);
+  CHECK(cached(2) == two_q);
+  CHECK(cached(239));
+  CHECK(cache.size() == 8 * sizeof(int));
+
+  // Invalidation and clearing cover both lists
+  bool success;
+  CHECK(cache.invalidate({239, 0, 0}, &success).ok());
+  CHECK(success);
+  CHECK(cache.size() == 7 * sizeof(int));
+  cache.clear();
+  CHECK(cache.size() == 0);
+  CHECK(!cached(1));
+}
@@ -0,0 +1,146 @@
+/**
+ * @file unit-value_index.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * This file unit-tests class ValueIndex.
+ */
+
+#include "catch.hpp"
+#include "tiledb/sm/buffer/buffer.h"
+#include "tiledb/sm/buffer/const_buffer.h"
+#include "tiledb/sm/misc/value_index.h"
+
+#include <cmath>
+#include <limits>
+
+using namespace tiledb::sm;
+
+typedef std::vector<std::pair<uint64_t, uint64_t>> CellPos;
+
+TEST_CASE("ValueIndex: Test lookups", "[value_index]") {
+  ValueIndex index(Datatype::INT32);
+  std::vector<int32_t> tile_0 = {5, 1, 3};
+  std::vector<int32_t> tile_1 = {3, 7};
+  std::vector<int32_t> tile_2 = {9, 9, 8};
+  index.add_tile(2, &tile_2[0], tile_2.size());
+  index.add_tile(0, &tile_0[0], tile_0.size());
+  index.add_tile(1, &tile_1[0], tile_1.size());
+  CHECK(index.entry_num() == 8);
+
+  std::vector<uint64_t> tiles;
+  int32_t v = 3;
+  CHECK(!index.lookup(QueryConditionOp::EQ, &v, &tiles).ok());
+  index.sort();
+
+  CellPos cells;
+  REQUIRE(index.lookup(QueryConditionOp::EQ, &v, &tiles, &cells).ok());
+  CHECK(tiles == std::vector<uint64_t>{0, 1});
+  CHECK(cells == CellPos{{0, 2}, {1, 0}});
+  REQUIRE(index.lookup(QueryConditionOp::LT, &v, &tiles, &cells).ok());
+  CHECK(tiles == std::vector<uint64_t>{0});
+  CHECK(cells == CellPos{{0, 1}});
+  REQUIRE(index.lookup(QueryConditionOp::LE, &v, &tiles).ok());
+  CHECK(tiles == std::vector<uint64_t>{0, 1});
+  REQUIRE(index.lookup(QueryConditionOp::NE, &v, &tiles).ok());
+  CHECK(tiles == std::vector<uint64_t>{0, 1, 2});
+
+  v = 7;
+  REQUIRE(index.lookup(QueryConditionOp::GT, &v, &tiles).ok());
+  CHECK(tiles == std::vector<uint64_t>{2});
+  REQUIRE(index.lookup(QueryConditionOp::GE, &v, &tiles).ok());
+  CHECK(tiles == std::vector<uint64_t>{1, 2});
+
+  v = 4;
+  REQUIRE(index.lookup(QueryConditionOp::EQ, &v, &tiles).ok());
+  CHECK(tiles.empty());
+  v = 10;
+  REQUIRE(index.lookup(QueryConditionOp::GE, &v, &tiles).ok());
+  CHECK(tiles.empty());
+}
+
+TEST_CASE("ValueIndex: Test NaN values", "[value_index]") {
+  ValueIndex index(Datatype::FLOAT64);
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  std::vector<double> tile_0 = {nan, 1.0};
+  std::vector<double> tile_1 = {2.0, nan, -1.0};
+  index.add_tile(0, &tile_0[0], tile_0.size());
+  index.add_tile(1, &tile_1[0], tile_1.size());
+  index.sort();
+
+  // NaN satisfies only the inequality
+  std::vector<uint64_t> tiles;
+  CellPos cells;
+  double v = 1.5;
+  REQUIRE(index.lookup(QueryConditionOp::GT, &v, &tiles, &cells).ok());
+  CHECK(cells == CellPos{{1, 0}});
+  REQUIRE(index.lookup(QueryConditionOp::NE, &v, &tiles, &cells).ok());
+  CHECK(cells.size() == 5);
+  v = 1.0;
+  REQUIRE(index.lookup(QueryConditionOp::LE, &v, &tiles, &cells).ok());
+  CHECK(cells == CellPos{{0, 1}, {1, 2}});
+  REQUIRE(index.lookup(QueryConditionOp::EQ, &nan, &tiles).ok());
+  CHECK(tiles.empty());
+  REQUIRE(index.lookup(QueryConditionOp::NE, &nan, &tiles).ok());
+  CHECK(tiles == std::vector<uint64_t>{0, 1});
+}
+
+TEST_CASE("ValueIndex: Test merge and serialization", "[value_index]") {
+  ValueIndex index(Datatype::UINT16);
+  std::vector<uint16_t> values = {4, 2, 4};
+  index.add_tile(0, &values[0], values.size());
+  index.sort();
+
+  // The merged tiles follow the tiles of the index
+  ValueIndex other(Datatype::UINT16);
+  std::vector<uint16_t> other_values = {2, 6};
+  other.add_tile(0, &other_values[0], other_values.size());
+  other.sort();
+  index.merge(other, 1);
+  index.sort();
+  CHECK(index.entry_num() == 5);
+
+  Buffer buff;
+  REQUIRE(index.serialize(&buff).ok());
+  ValueIndex loaded(Datatype::UINT16);
+  ConstBuffer cbuff(buff.data(), buff.size());
+  REQUIRE(loaded.deserialize(&cbuff).ok());
+  CHECK(loaded.entry_num() == 5);
+
+  std::vector<uint64_t> tiles;
+  CellPos cells;
+  uint16_t v = 2;
+  REQUIRE(loaded.lookup(QueryConditionOp::EQ, &v, &tiles, &cells).ok());
+  CHECK(cells == CellPos{{0, 1}, {1, 0}});
+  v = 5;
+  REQUIRE(loaded.lookup(QueryConditionOp::GT, &v, &tiles).ok());
+  CHECK(tiles == std::vector<uint64_t>{1});
+
+  // Truncated data is rejected
+  ValueIndex truncated(Datatype::UINT16);
+  ConstBuffer short_cbuff(buff.data(), buff.size() - 1);
+  CHECK(!truncated.deserialize(&short_cbuff).ok());
+}
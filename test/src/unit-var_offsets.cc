@@ -0,0 +1,112 @@
+/**
+ * @file unit-var_offsets.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * Tests the kernels converting var-sized cell offsets.
+ */
+
+#include "catch.hpp"
+#include "tiledb/sm/misc/var_offsets.h"
+
+#include <cstring>
+#include <vector>
+
+using namespace tiledb::sm;
+
+namespace {
+
+/** Reads the `i`-th user offset of `bitsize` bits from `buffer`. */
+uint64_t user_offset(
+    const unsigned char* buffer, uint32_t bitsize, uint64_t i) {
+  if (bitsize == 32) {
+    uint32_t offset;
+    std::memcpy(&offset, buffer + i * sizeof(offset), sizeof(offset));
+    return offset;
+  }
+  uint64_t offset;
+  std::memcpy(&offset, buffer + i * sizeof(offset), sizeof(offset));
+  return offset;
+}
+
+/**
+ * Checks the conversions of `num` offsets in units of `unit` bytes from
+ * and to user offsets of `bitsize` bits.
+ */
+void check_conversions(uint32_t bitsize, uint64_t unit, uint64_t num) {
+  std::vector<uint64_t> tile_offsets(num);
+  for (uint64_t i = 0; i < num; ++i)
+    tile_offsets[i] = 100 + i * i * unit;
+
+  // Rebase the offsets forward, to an unaligned user buffer
+  std::vector<unsigned char> buffer(num * sizeof(uint64_t) + 1);
+  const uint64_t base = 100 - 8 * unit;
+  var_offsets::to_user(
+      tile_offsets.data(), num, base, unit, bitsize, &buffer[1]);
+  for (uint64_t i = 0; i < num; ++i)
+    CHECK(user_offset(&buffer[1], bitsize, i) == (i * i + 8));
+
+  // Converting them back with the opposite shift restores the tile offsets
+  std::vector<uint64_t> offsets(num);
+  var_offsets::to_disk(
+      &buffer[1], num, unit, bitsize, 0 - base, offsets.data());
+  CHECK(offsets == tile_offsets);
+
+  // Offsets of cells of equal size
+  var_offsets::sequence(num, 2 * unit, 3 * unit, unit, bitsize, &buffer[1]);
+  for (uint64_t i = 0; i < num; ++i)
+    CHECK(user_offset(&buffer[1], bitsize, i) == 2 + 3 * i);
+}
+
+}  // namespace
+
+TEST_CASE(
+    "var_offsets: Test conversions between tile and user offsets",
+    "[var_offsets]") {
+  // Sizes that leave scalar remainders after the vectorized steps
+  for (uint64_t num : {0, 3, 8, 13}) {
+    check_conversions(32, 1, num);
+    check_conversions(32, 4, num);
+    check_conversions(64, 1, num);
+    check_conversions(64, 4, num);
+  }
+}
+
+TEST_CASE("var_offsets: Test prefix sums", "[var_offsets]") {
+  for (uint64_t num : {0, 1, 4, 11}) {
+    std::vector<uint64_t> values(num), expected(num);
+    uint64_t sum = 0;
+    for (uint64_t i = 0; i < num; ++i) {
+      values[i] = 2 * i + 1;
+      expected[i] = sum;
+      sum += values[i];
+    }
+
+    CHECK(var_offsets::prefix_sum(values.data(), num) == sum);
+    CHECK(values == expected);
+  }
+}
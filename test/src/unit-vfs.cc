@@ -32,6 +32,7 @@
 
 #include <atomic>
 #include <catch.hpp>
+#include <chrono>
 #include "tiledb/sm/filesystem/vfs.h"
 #include "tiledb/sm/misc/stats.h"
 
@@ -217,10 +218,260 @@ TEST_CASE("VFS: Test read batching", "[vfs]") {
         nelts * sizeof(uint32_t));
   }
 
+  SECTION("- io_uring engine") {
+    // Falls back to pread if io_uring is not available
+    Config default_config, vfs_config;
+    vfs_config.set("vfs.file.io_engine", "io_uring");
+    REQUIRE(vfs->init(&default_config, &vfs_config).ok());
+
+    // Read every other element as a different region
+    std::memset(data_read, 0, nelts * sizeof(uint32_t));
+    batches.clear();
+    for (unsigned i = 0; i < nelts / 2; i++)
+      batches.emplace_back(
+          2 * i * sizeof(uint32_t), &data_read[i], sizeof(uint32_t));
+    REQUIRE(vfs->read_all(testfile, batches, &thread_pool, &tasks).ok());
+    REQUIRE(thread_pool.wait_all(tasks).ok());
+    tasks.clear();
+    for (unsigned i = 0; i < nelts / 2; i++)
+      REQUIRE(data_read[i] == 2 * i);
+    CHECK(
+        stats::all_stats.counter_vfs_read_total_bytes ==
+        (nelts / 2) * sizeof(uint32_t));
+
+    // Reading past the end of the file fails
+    batches.clear();
+    batches.emplace_back(nelts * sizeof(uint32_t), data_read, sizeof(uint32_t));
+    REQUIRE(vfs->read_all(testfile, batches, &thread_pool, &tasks).ok());
+    REQUIRE(!thread_pool.wait_all(tasks).ok());
+    tasks.clear();
+  }
+
+  SECTION("- Direct I/O") {
+    Config default_config, vfs_config;
+    vfs_config.set("vfs.min_batch_size", "0");
+    vfs_config.set("vfs.min_batch_gap", "0");
+    vfs_config.set("vfs.file.direct_io", "true");
+    REQUIRE(vfs->init(&default_config, &vfs_config).ok());
+
+    // Regions in the same disk block are read together
+    std::memset(data_read, 0, nelts * sizeof(uint32_t));
+    batches.clear();
+    for (unsigned i = 0; i < nelts / 2; i++)
+      batches.emplace_back(
+          2 * i * sizeof(uint32_t), &data_read[i], sizeof(uint32_t));
+    REQUIRE(vfs->read_all(testfile, batches, &thread_pool, &tasks).ok());
+    REQUIRE(thread_pool.wait_all(tasks).ok());
+    tasks.clear();
+    for (unsigned i = 0; i < nelts / 2; i++)
+      REQUIRE(data_read[i] == 2 * i);
+#ifndef _WIN32
+    CHECK(stats::all_stats.vfs_read_call_count == 1);
+#endif
+  }
+
+  REQUIRE(vfs->is_file(testfile, &exists).ok());
+  if (exists)
+    REQUIRE(vfs->remove_file(testfile).ok());
+
+  REQUIRE(vfs->terminate().ok());
+}
+
+TEST_CASE("VFS: Test direct I/O", "[vfs]") {
+  URI testfile("vfs_unit_test_data");
+  Config default_config, vfs_config;
+  vfs_config.set("vfs.file.direct_io", "true");
+  std::unique_ptr<VFS> vfs(new VFS);
+  REQUIRE(vfs->init(&default_config, &vfs_config).ok());
+
+  bool exists = false;
+  REQUIRE(vfs->is_file(testfile, &exists).ok());
+  if (exists)
+    REQUIRE(vfs->remove_file(testfile).ok());
+
+  // Append pieces that start and end inside disk blocks
+  const unsigned nelts = 500000;
+  std::vector<uint32_t> data_write(nelts);
+  for (unsigned i = 0; i < nelts; i++)
+    data_write[i] = i;
+  const unsigned pieces[] = {3, 1000, 1, 2048, 300000, 196948};
+  unsigned written = 0;
+  for (auto n : pieces) {
+    REQUIRE(vfs->write(
+                   testfile,
+                   data_write.data() + written,
+                   n * sizeof(uint32_t))
+                .ok());
+    written += n;
+  }
+  REQUIRE(written == nelts);
+  REQUIRE(vfs->close_file(testfile).ok());
+
+  uint64_t size = 0;
+  REQUIRE(vfs->file_size(testfile, &size).ok());
+  REQUIRE(size == nelts * sizeof(uint32_t));
+
+  // Read unaligned ranges, including the partial last block
+  std::vector<uint32_t> data_read(nelts);
+  const unsigned ranges[][2] = {
+      {0, nelts}, {1, 5}, {1023, 3000}, {nelts - 7, 7}};
+  for (const auto& r : ranges) {
+    REQUIRE(vfs->read(
+                   testfile,
+                   r[0] * sizeof(uint32_t),
+                   data_read.data(),
+                   r[1] * sizeof(uint32_t))
+                .ok());
+    for (unsigned i = 0; i < r[1]; i++)
+      REQUIRE(data_read[i] == r[0] + i);
+  }
+
+  // Reading past the end of the file fails
+  REQUIRE(!vfs->read(testfile, size - 4, data_read.data(), 8).ok());
+
+  REQUIRE(vfs->remove_file(testfile).ok());
+  REQUIRE(vfs->terminate().ok());
+}
+
+TEST_CASE("VFS: Test map region", "[vfs]") {
+  URI testfile("vfs_unit_test_data");
+  std::unique_ptr<VFS> vfs(new VFS);
+  REQUIRE(vfs->init(nullptr, nullptr).ok());
+  CHECK(!vfs->mmap_enabled(testfile));
+
+  bool exists = false;
+  REQUIRE(vfs->is_file(testfile, &exists).ok());
+  if (exists)
+    vfs->remove_file(testfile);
+
+  // Write enough data to span more than one page.
+  const unsigned nelts = 10000;
+  std::vector<uint32_t> data_write(nelts);
+  for (unsigned i = 0; i < nelts; i++)
+    data_write[i] = i;
+  REQUIRE(
+      vfs->write(testfile, data_write.data(), nelts * sizeof(uint32_t)).ok());
+  REQUIRE(vfs->close_file(testfile).ok());
+
+  std::shared_ptr<MappedRegion> region;
+#ifdef _WIN32
+  REQUIRE(!vfs->map_region(testfile, 0, sizeof(uint32_t), &region).ok());
+#else
+  // Map a region at an offset that is not page-aligned.
+  const unsigned first = 1234, num = 5000;
+  REQUIRE(vfs->map_region(
+                 testfile,
+                 first * sizeof(uint32_t),
+                 num * sizeof(uint32_t),
+                 &region)
+              .ok());
+  REQUIRE(region != nullptr);
+  REQUIRE(region->size() == num * sizeof(uint32_t));
+  auto mapped = static_cast<const uint32_t*>(region->data());
+  for (unsigned i = 0; i < num; i++)
+    REQUIRE(mapped[i] == first + i);
+  region.reset();
+
+  // Regions past the end of the file cannot be mapped.
+  REQUIRE(!vfs->map_region(
+                  testfile, (nelts - 1) * sizeof(uint32_t), 8, &region)
+               .ok());
+
+  Config default_config, vfs_config;
+  vfs_config.set("vfs.file.enable_mmap", "true");
+  REQUIRE(vfs->init(&default_config, &vfs_config).ok());
+  CHECK(vfs->mmap_enabled(testfile));
+#endif
+
+  REQUIRE(vfs->remove_file(testfile).ok());
+  REQUIRE(vfs->terminate().ok());
+}
+
+TEST_CASE("VFS: Test write-behind buffering", "[vfs]") {
+  URI testfile("vfs_unit_test_data");
+  Config default_config, vfs_config;
+  vfs_config.set("vfs.write_behind_buffer_size", "1000");
+  vfs_config.set("vfs.file.max_parallel_ops", "4");
+  std::unique_ptr<VFS> vfs(new VFS);
+  REQUIRE(vfs->init(&default_config, &vfs_config).ok());
+
+  bool exists = false;
+  REQUIRE(vfs->is_file(testfile, &exists).ok());
+  if (exists)
+    REQUIRE(vfs->remove_file(testfile).ok());
+
+  // Write in pieces smaller and larger than the buffer
+  const unsigned nelts = 10000;
+  std::vector<uint32_t> data_write(nelts);
+  for (unsigned i = 0; i < nelts; i++)
+    data_write[i] = i;
+  const unsigned pieces[] = {1, 7, 100, 1000, 2500, 6392};
+  unsigned written = 0;
+  for (auto n : pieces) {
+    REQUIRE(vfs->write(
+                   testfile,
+                   data_write.data() + written,
+                   n * sizeof(uint32_t))
+                .ok());
+    written += n;
+  }
+  REQUIRE(written == nelts);
+  REQUIRE(vfs->close_file(testfile).ok());
+
+  uint64_t size = 0;
+  REQUIRE(vfs->file_size(testfile, &size).ok());
+  REQUIRE(size == nelts * sizeof(uint32_t));
+
+  // Append to the existing file
+  REQUIRE(vfs->write(testfile, data_write.data(), 10 * sizeof(uint32_t)).ok());
+  REQUIRE(vfs->close_file(testfile).ok());
+  REQUIRE(vfs->file_size(testfile, &size).ok());
+  REQUIRE(size == (nelts + 10) * sizeof(uint32_t));
+
+  std::vector<uint32_t> data_read(nelts + 10);
+  REQUIRE(vfs->read(testfile, 0, data_read.data(), size).ok());
+  for (unsigned i = 0; i < nelts; i++)
+    REQUIRE(data_read[i] == i);
+  for (unsigned i = 0; i < 10; i++)
+    REQUIRE(data_read[nelts + i] == i);
+
+  REQUIRE(vfs->remove_file(testfile).ok());
+  REQUIRE(vfs->terminate().ok());
+}
+
+TEST_CASE("VFS: Test latency and bandwidth emulation", "[vfs]") {
+  URI testfile("vfs_unit_test_data");
+  Config default_config, vfs_config;
+  vfs_config.set("vfs.emulated_latency_ms", "20");
+  vfs_config.set("vfs.emulated_bandwidth", "1000000");
+  std::unique_ptr<VFS> vfs(new VFS);
+  REQUIRE(vfs->init(&default_config, &vfs_config).ok());
+
+  auto elapsed_ms = [](std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+  };
+
+  // A metadata lookup only pays the latency
+  auto start = std::chrono::steady_clock::now();
+  bool exists = false;
   REQUIRE(vfs->is_file(testfile, &exists).ok());
+  CHECK(elapsed_ms(start) >= 20);
   if (exists)
     REQUIRE(vfs->remove_file(testfile).ok());
 
+  // Writing and reading 100KB also pay 100 ms of transfer each
+  std::vector<char> data(100000, 'a');
+  start = std::chrono::steady_clock::now();
+  REQUIRE(vfs->write(testfile, data.data(), data.size()).ok());
+  REQUIRE(vfs->close_file(testfile).ok());
+  CHECK(elapsed_ms(start) >= 120);
+  start = std::chrono::steady_clock::now();
+  REQUIRE(vfs->read(testfile, 0, data.data(), data.size()).ok());
+  CHECK(elapsed_ms(start) >= 120);
+
+  REQUIRE(vfs->remove_file(testfile).ok());
   REQUIRE(vfs->terminate().ok());
 }
 
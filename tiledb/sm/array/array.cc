@@ -33,6 +33,7 @@
 #include "tiledb/sm/array/array.h"
 #include "tiledb/sm/array_schema/array_schema.h"
 #include "tiledb/sm/array_schema/attribute.h"
+#include "tiledb/sm/array_schema/dimension.h"
 #include "tiledb/sm/array_schema/domain.h"
 #include "tiledb/sm/encryption/encryption.h"
 #include "tiledb/sm/enums/datatype.h"
@@ -40,13 +41,21 @@
 #include "tiledb/sm/enums/query_type.h"
 #include "tiledb/sm/enums/serialization_type.h"
 #include "tiledb/sm/fragment/fragment_metadata.h"
+#include "tiledb/sm/misc/constants.h"
+#include "tiledb/sm/misc/hyperloglog.h"
+#include "tiledb/sm/misc/kll_sketch.h"
 #include "tiledb/sm/misc/logger.h"
+#include "tiledb/sm/misc/parallel_functions.h"
 #include "tiledb/sm/misc/stats.h"
 #include "tiledb/sm/misc/utils.h"
+#include "tiledb/sm/query/query.h"
 #include "tiledb/sm/rest/rest_client.h"
+#include "tiledb/sm/rtree/rtree.h"
 #include "tiledb/sm/storage_manager/storage_manager.h"
+#include "tiledb/sm/storage_manager/write_buffer.h"
 
 #include <cassert>
+#include <cstring>
 #include <iostream>
 
 namespace tiledb {
@@ -62,12 +71,14 @@ Array::Array(const URI& array_uri, StorageManager* storage_manager)
   is_open_ = false;
   array_schema_ = nullptr;
   timestamp_ = 0;
+  timestamp_start_ = 0;
   last_max_buffer_sizes_subarray_ = nullptr;
   remote_ = array_uri.is_tiledb();
   metadata_loaded_ = false;
 };
 
 Array::~Array() {
+  wait_prefetch();
   std::free(last_max_buffer_sizes_subarray_);
 }
 
@@ -114,6 +125,8 @@ Status Array::open(
   RETURN_NOT_OK(
       encryption_key_.set_key(encryption_type, encryption_key, key_length));
 
+  RETURN_NOT_OK(flush_write_buffer());
+
   timestamp_ = timestamp;
   metadata_.clear();
   metadata_loaded_ = false;
@@ -130,10 +143,12 @@ Status Array::open(
     // Open the array.
     RETURN_NOT_OK(storage_manager_->array_open_for_reads(
         array_uri_,
+        timestamp_start_,
         timestamp_,
         encryption_key_,
         &array_schema_,
         &fragment_metadata_));
+    load_fragment_metadata_async();
   }
 
   is_open_ = true;
@@ -213,6 +228,9 @@ Status Array::open(
   RETURN_NOT_OK(
       encryption_key_.set_key(encryption_type, encryption_key, key_length));
 
+  if (query_type == QueryType::READ)
+    RETURN_NOT_OK(flush_write_buffer());
+
   timestamp_ =
       query_type == QueryType::READ ? utils::time::timestamp_now_ms() : 0;
   metadata_.clear();
@@ -228,10 +246,12 @@ Status Array::open(
   } else if (query_type == QueryType::READ) {
     RETURN_NOT_OK(storage_manager_->array_open_for_reads(
         array_uri_,
+        timestamp_start_,
         timestamp_,
         encryption_key_,
         &array_schema_,
         &fragment_metadata_));
+    load_fragment_metadata_async();
   } else {
     RETURN_NOT_OK(storage_manager_->array_open_for_writes(
         array_uri_, encryption_key_, &array_schema_));
@@ -245,6 +265,9 @@ Status Array::open(
 }
 
 Status Array::close() {
+  // The prefetches use the array, so they must finish before it closes
+  wait_prefetch();
+
   std::unique_lock<std::mutex> lck(mtx_);
 
   if (!is_open_)
@@ -253,6 +276,7 @@ Status Array::close() {
   is_open_ = false;
   clear_last_max_buffer_sizes();
   fragment_metadata_.clear();
+  fragment_index_.reset();
 
   if (remote_) {
     // Update array metadata for write queries if metadata was written by the
@@ -301,11 +325,36 @@ bool Array::is_remote() const {
   return remote_;
 }
 
+StorageManager* Array::storage_manager() const {
+  return storage_manager_;
+}
+
 std::vector<FragmentMetadata*> Array::fragment_metadata() const {
   std::unique_lock<std::mutex> lck(mtx_);
   return fragment_metadata_;
 }
 
+std::shared_ptr<const RTree> Array::fragment_index() const {
+  std::unique_lock<std::mutex> lck(mtx_);
+  if (fragment_index_ == nullptr && !fragment_metadata_.empty()) {
+    auto domain = array_schema_->domain();
+    std::vector<void*> non_empty_domains;
+    non_empty_domains.reserve(fragment_metadata_.size());
+    for (auto meta : fragment_metadata_)
+      non_empty_domains.push_back(const_cast<void*>(meta->non_empty_domain()));
+
+    // The fragment domains are not sorted, so the leaves are packed
+    // with Sort-Tile-Recursive
+    fragment_index_ = std::make_shared<RTree>(
+        domain->type(),
+        domain->dim_num(),
+        constants::rtree_fanout,
+        non_empty_domains,
+        true);
+  }
+  return fragment_index_;
+}
+
 Status Array::get_array_schema(ArraySchema** array_schema) const {
   std::unique_lock<std::mutex> lck(mtx_);
 
@@ -332,6 +381,36 @@ Status Array::get_query_type(QueryType* query_type) const {
   return Status::Ok();
 }
 
+Status Array::approx_distinct_count(
+    const char* attribute, const void* subarray, uint64_t* count) {
+  HyperLogLog hll;
+  KllSketch kll;
+  RETURN_NOT_OK(merge_sketches(
+      "Cannot get approximate distinct count",
+      attribute,
+      subarray,
+      &hll,
+      &kll));
+  *count = hll.estimate();
+
+  return Status::Ok();
+}
+
+Status Array::approx_quantile(
+    const char* attribute, const void* subarray, double q, double* value) {
+  if (!(q >= 0 && q <= 1))
+    return LOG_STATUS(Status::ArrayError(
+        "Cannot get approximate quantile; The quantile must be in [0, 1]"));
+
+  HyperLogLog hll;
+  KllSketch kll;
+  RETURN_NOT_OK(merge_sketches(
+      "Cannot get approximate quantile", attribute, subarray, &hll, &kll));
+  *value = kll.quantile(q);
+
+  return Status::Ok();
+}
+
 Status Array::get_max_buffer_size(
     const char* attribute, const void* subarray, uint64_t* buffer_size) {
   std::unique_lock<std::mutex> lck(mtx_);
@@ -433,11 +512,68 @@ const EncryptionKey& Array::get_encryption_key() const {
   return encryption_key_;
 }
 
+Status Array::prefetch(
+    const void* subarray, const std::vector<std::string>& attributes) {
+  std::unique_lock<std::mutex> lck(mtx_);
+
+  if (!is_open_)
+    return LOG_STATUS(
+        Status::ArrayError("Cannot prefetch; Array is not open"));
+
+  if (query_type_ != QueryType::READ)
+    return LOG_STATUS(Status::ArrayError(
+        "Cannot prefetch; Array was not opened in read mode"));
+
+  if (remote_)
+    return LOG_STATUS(Status::ArrayError(
+        "Cannot prefetch; Operation not supported for remote arrays"));
+
+  // Check the attributes
+  std::vector<std::string> attribute_names = attributes;
+  if (attribute_names.empty()) {
+    for (const auto& attr : array_schema_->attributes())
+      attribute_names.push_back(attr->name());
+  }
+  for (const auto& name : attribute_names) {
+    if (array_schema_->attribute(name) == nullptr)
+      return LOG_STATUS(Status::ArrayError(
+          std::string("Cannot prefetch; Invalid attribute '") + name + "'"));
+  }
+
+  // Copy the subarray, which the caller may free. Dense reads need an
+  // explicit subarray, so a missing one becomes the whole domain.
+  if (subarray == nullptr)
+    subarray = array_schema_->domain()->domain();
+  auto subarray_size = 2 * array_schema_->coords_size();
+  std::vector<uint8_t> subarray_copy(subarray_size);
+  std::memcpy(&subarray_copy[0], subarray, subarray_size);
+  lck.unlock();
+
+  // Run on a dedicated thread rather than on the reader thread pool, which
+  // the prefetch itself waits on
+  std::lock_guard<std::mutex> prefetch_lck(prefetch_mtx_);
+  prefetch_tasks_.push_back(std::async(
+      std::launch::async, [this, subarray_copy, attribute_names]() {
+        Query query(storage_manager_, this);
+        auto st = query.set_subarray(&subarray_copy[0]);
+        if (st.ok())
+          st = query.reader()->prefetch(attribute_names);
+        if (!st.ok())
+          LOG_STATUS(st);
+        return st;
+      }));
+
+  return Status::Ok();
+}
+
 Status Array::reopen() {
+  RETURN_NOT_OK(flush_write_buffer());
   return reopen(utils::time::timestamp_now_ms());
 }
 
 Status Array::reopen(uint64_t timestamp) {
+  wait_prefetch();
+
   std::unique_lock<std::mutex> lck(mtx_);
 
   if (!is_open_)
@@ -451,8 +587,11 @@ Status Array::reopen(uint64_t timestamp) {
 
   clear_last_max_buffer_sizes();
 
+  RETURN_NOT_OK(flush_write_buffer());
+
   timestamp_ = timestamp;
   fragment_metadata_.clear();
+  fragment_index_.reset();
   metadata_.clear();
   metadata_loaded_ = false;
 
@@ -463,12 +602,16 @@ Status Array::reopen(uint64_t timestamp) {
         encryption_key_.key().data(),
         encryption_key_.key().size());
   }
-  return storage_manager_->array_reopen(
+  RETURN_NOT_OK(storage_manager_->array_reopen(
       array_uri_,
+      timestamp_start_,
       timestamp_,
       encryption_key_,
       &array_schema_,
-      &fragment_metadata_);
+      &fragment_metadata_));
+  load_fragment_metadata_async();
+
+  return Status::Ok();
 }
 
 uint64_t Array::timestamp() const {
@@ -482,6 +625,17 @@ Status Array::set_timestamp(uint64_t timestamp) {
   return Status::Ok();
 }
 
+uint64_t Array::timestamp_start() const {
+  std::unique_lock<std::mutex> lck(mtx_);
+  return timestamp_start_;
+}
+
+Status Array::set_timestamp_start(uint64_t timestamp_start) {
+  std::unique_lock<std::mutex> lck(mtx_);
+  timestamp_start_ = timestamp_start;
+  return Status::Ok();
+}
+
 Status Array::set_uri(const std::string& uri) {
   std::unique_lock<std::mutex> lck(mtx_);
   array_uri_ = URI(uri);
@@ -665,6 +819,52 @@ Status Array::metadata(Metadata** metadata) {
 /*          PRIVATE METHODS          */
 /* ********************************* */
 
+void Array::wait_prefetch() {
+  std::lock_guard<std::mutex> lck(prefetch_mtx_);
+  for (auto& task : prefetch_tasks_)
+    task.wait();
+  prefetch_tasks_.clear();
+}
+
+void Array::load_fragment_metadata_async() {
+  if (!storage_manager_->eager_metadata_load() || fragment_metadata_.empty())
+    return;
+
+  // Sparse reads always locate the tiles of the dimensions
+  auto names = storage_manager_->read_attributes(array_uri_);
+  if (!array_schema_->dense()) {
+    for (unsigned d = 0; d < array_schema_->dim_num(); ++d)
+      names.push_back(array_schema_->dimension(d)->name());
+  }
+
+  // The loads lock each fragment metadata, so the queries needing a
+  // structure wait only for the fragment loading it
+  auto fragment_metadata = fragment_metadata_;
+  std::lock_guard<std::mutex> prefetch_lck(prefetch_mtx_);
+  prefetch_tasks_.push_back(std::async(
+      std::launch::async, [this, fragment_metadata, names]() {
+        auto statuses = parallel_for(
+            0, fragment_metadata.size(), [&](uint64_t i) {
+              return fragment_metadata[i]->load_read_metadata(
+                  encryption_key_, names);
+            });
+        for (const auto& st : statuses) {
+          if (!st.ok()) {
+            LOG_STATUS(st);
+            return st;
+          }
+        }
+        return Status::Ok();
+      }));
+}
+
+Status Array::flush_write_buffer() {
+  auto write_buffer = storage_manager_->write_buffer();
+  if (remote_ || write_buffer == nullptr)
+    return Status::Ok();
+  return write_buffer->flush(array_uri_);
+}
+
 void Array::clear_last_max_buffer_sizes() {
   last_max_buffer_sizes_.clear();
   std::free(last_max_buffer_sizes_subarray_);
@@ -776,6 +976,125 @@ Status Array::compute_max_buffer_sizes(
   return Status::Ok();
 }
 
+Status Array::merge_sketches(
+    const std::string& errmsg,
+    const char* attribute,
+    const void* subarray,
+    HyperLogLog* hll,
+    KllSketch* kll) {
+  std::unique_lock<std::mutex> lck(mtx_);
+
+  if (!is_open_)
+    return LOG_STATUS(Status::ArrayError(errmsg + "; Array is not open"));
+
+  if (query_type_ != QueryType::READ)
+    return LOG_STATUS(Status::ArrayError(
+        errmsg + "; Array was not opened in read mode"));
+
+  if (remote_)
+    return LOG_STATUS(Status::ArrayError(
+        errmsg + "; Operation not supported for remote arrays"));
+
+  if (attribute == nullptr)
+    return LOG_STATUS(Status::ArrayError(errmsg + "; Attribute is null"));
+
+  std::string name;
+  RETURN_NOT_OK(ArraySchema::attribute_name_normalized(attribute, &name));
+  auto attr = array_schema_->attribute(name);
+  if (attr == nullptr)
+    return LOG_STATUS(Status::ArrayError(
+        errmsg + "; Attribute '" + name + "' does not exist"));
+  auto type = attr->type();
+  if (attr->cell_val_num() != 1 ||
+      (!datatype_is_integer(type) && !datatype_is_datetime(type) &&
+       type != Datatype::FLOAT32 && type != Datatype::FLOAT64))
+    return LOG_STATUS(Status::ArrayError(
+        errmsg + "; Attribute '" + name +
+        "' is not numeric with one value per cell"));
+
+  switch (array_schema_->coords_type()) {
+    case Datatype::INT32:
+      return merge_sketches<int>(
+          errmsg, name, static_cast<const int*>(subarray), hll, kll);
+    case Datatype::INT64:
+      return merge_sketches<int64_t>(
+          errmsg, name, static_cast<const int64_t*>(subarray), hll, kll);
+    case Datatype::FLOAT32:
+      return merge_sketches<float>(
+          errmsg, name, static_cast<const float*>(subarray), hll, kll);
+    case Datatype::FLOAT64:
+      return merge_sketches<double>(
+          errmsg, name, static_cast<const double*>(subarray), hll, kll);
+    case Datatype::INT8:
+      return merge_sketches<int8_t>(
+          errmsg, name, static_cast<const int8_t*>(subarray), hll, kll);
+    case Datatype::UINT8:
+      return merge_sketches<uint8_t>(
+          errmsg, name, static_cast<const uint8_t*>(subarray), hll, kll);
+    case Datatype::INT16:
+      return merge_sketches<int16_t>(
+          errmsg, name, static_cast<const int16_t*>(subarray), hll, kll);
+    case Datatype::UINT16:
+      return merge_sketches<uint16_t>(
+          errmsg, name, static_cast<const uint16_t*>(subarray), hll, kll);
+    case Datatype::UINT32:
+      return merge_sketches<uint32_t>(
+          errmsg, name, static_cast<const uint32_t*>(subarray), hll, kll);
+    case Datatype::UINT64:
+      return merge_sketches<uint64_t>(
+          errmsg, name, static_cast<const uint64_t*>(subarray), hll, kll);
+    case Datatype::DATETIME_YEAR:
+    case Datatype::DATETIME_MONTH:
+    case Datatype::DATETIME_WEEK:
+    case Datatype::DATETIME_DAY:
+    case Datatype::DATETIME_HR:
+    case Datatype::DATETIME_MIN:
+    case Datatype::DATETIME_SEC:
+    case Datatype::DATETIME_MS:
+    case Datatype::DATETIME_US:
+    case Datatype::DATETIME_NS:
+    case Datatype::DATETIME_PS:
+    case Datatype::DATETIME_FS:
+    case Datatype::DATETIME_AS:
+      return merge_sketches<int64_t>(
+          errmsg, name, static_cast<const int64_t*>(subarray), hll, kll);
+    default:
+      return LOG_STATUS(
+          Status::ArrayError(errmsg + "; Invalid coordinates type"));
+  }
+
+  return Status::Ok();
+}
+
+template <class T>
+Status Array::merge_sketches(
+    const std::string& errmsg,
+    const std::string& name,
+    const T* subarray,
+    HyperLogLog* hll,
+    KllSketch* kll) {
+  auto dim_num = array_schema_->dim_num();
+  for (auto meta : fragment_metadata_) {
+    if (subarray != nullptr &&
+        !utils::geometry::overlap(
+            subarray, (const T*)meta->non_empty_domain(), dim_num))
+      continue;
+
+    const HyperLogLog* frag_hll = nullptr;
+    const KllSketch* frag_kll = nullptr;
+    RETURN_NOT_OK(
+        meta->get_sketches(encryption_key_, name, &frag_hll, &frag_kll));
+    if (frag_hll == nullptr)
+      return LOG_STATUS(Status::ArrayError(
+          errmsg + "; Fragment '" + meta->fragment_uri().to_string() +
+          "' has no sketches for attribute '" + name + "'"));
+    hll->merge(*frag_hll);
+    kll->merge(*frag_kll);
+  }
+
+  return Status::Ok();
+}
+
 template <class T>
 Status Array::compute_max_buffer_sizes(
     const T* subarray,
@@ -835,6 +1154,9 @@ Status Array::compute_max_buffer_sizes(
 
 Status Array::load_metadata() {
   std::lock_guard<std::mutex> lock{mtx_};
+  // Another thread may have loaded the metadata while this one waited
+  if (metadata_loaded_)
+    return Status::Ok();
   if (remote_) {
     auto rest_client = storage_manager_->rest_client();
     if (rest_client == nullptr)
@@ -34,6 +34,9 @@
 #define TILEDB_ARRAY_H
 
 #include <atomic>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -47,6 +50,9 @@ namespace sm {
 
 class ArraySchema;
 class FragmentMetadata;
+class HyperLogLog;
+class KllSketch;
+class RTree;
 class StorageManager;
 enum class QueryType : uint8_t;
 
@@ -148,6 +154,15 @@ class Array {
    */
   std::vector<FragmentMetadata*> fragment_metadata() const;
 
+  /**
+   * Returns an R-Tree over the non-empty domains of the fragments the
+   * array was opened with. Its leaf indices are positions in
+   * `fragment_metadata()`, so it yields the fragments that may intersect
+   * a range without visiting every fragment. The index is built on first
+   * use and is `nullptr` if the array has no fragments.
+   */
+  std::shared_ptr<const RTree> fragment_index() const;
+
   /**
    * Returns `true` if the array is empty at the time it is opened.
    * The funciton returns `false` if the array is not open.
@@ -160,6 +175,9 @@ class Array {
   /** Returns `true` if the array is remote */
   bool is_remote() const;
 
+  /** Returns the storage manager of the array. */
+  StorageManager* storage_manager() const;
+
   /** Retrieves the array schema. Errors if the array is not open. */
   Status get_array_schema(ArraySchema** array_schema) const;
 
@@ -188,6 +206,66 @@ class Array {
    */
   const EncryptionKey& get_encryption_key() const;
 
+  /**
+   * Estimates the number of distinct values of a numeric attribute in a
+   * subarray from the sketches stored with the fragments (see the
+   * `sm.fragment_sketches` config parameter), without reading any tiles.
+   * The sketches of all the fragments whose non-empty domain overlaps the
+   * subarray are merged, so the estimate covers all their cells, including
+   * those outside the subarray and those overwritten by later fragments.
+   * Errors if an overlapping fragment was written without sketches.
+   *
+   * @param attribute The attribute name.
+   * @param subarray The subarray, of the same type as the array domain. If
+   *     `nullptr`, all the fragments are considered.
+   * @param count Set to the estimated number of distinct values, with a
+   *     standard error of about 1.6%.
+   * @return Status
+   *
+   * @note Applicable only to local arrays opened for reads.
+   */
+  Status approx_distinct_count(
+      const char* attribute, const void* subarray, uint64_t* count);
+
+  /**
+   * Estimates a quantile of the values of a numeric attribute in a subarray
+   * from the sketches stored with the fragments, merged as in
+   * `approx_distinct_count`. The minimum and maximum (`q` equal to 0 or 1)
+   * are exact over the merged fragments.
+   *
+   * @param attribute The attribute name.
+   * @param subarray The subarray, of the same type as the array domain. If
+   *     `nullptr`, all the fragments are considered.
+   * @param q The quantile, in [0, 1].
+   * @param value Set to the estimated quantile, or NaN if the fragments
+   *     have no values.
+   * @return Status
+   *
+   * @note Applicable only to local arrays opened for reads.
+   */
+  Status approx_quantile(
+      const char* attribute, const void* subarray, double q, double* value);
+
+  /**
+   * Starts loading the fragment metadata and the tiles of the input
+   * attributes that overlap the input subarray into the tile cache in the
+   * background, without producing results, so that later reads of the
+   * region find them in memory. The function returns immediately;
+   * `close` and `reopen` wait for the prefetch to finish. Prefetching is
+   * best-effort, so its errors are only logged. It has no effect if the
+   * tile cache is disabled.
+   *
+   * @param subarray The subarray to prefetch, of the same type as the
+   *     array domain. If `nullptr`, the entire domain is prefetched.
+   * @param attributes The attributes to prefetch. If empty, all the
+   *     attributes are prefetched.
+   * @return Status
+   *
+   * @note Applicable only to local arrays opened for reads.
+   */
+  Status prefetch(
+      const void* subarray, const std::vector<std::string>& attributes);
+
   /**
    * Re-opens the array. This effectively updates the "view" of the array,
    * by loading the fragments potentially written after the last time
@@ -212,6 +290,20 @@ class Array {
   /** Directly set the timestamp value. */
   Status set_timestamp(uint64_t timestamp);
 
+  /**
+   * Returns the start timestamp of the fragments the array is opened
+   * with for reads (see `set_timestamp_start`).
+   */
+  uint64_t timestamp_start() const;
+
+  /**
+   * Sets the start timestamp of the fragments the array is opened with
+   * for reads. The fragments whose timestamp range ends before it are
+   * ignored, without loading their metadata. It takes effect the next
+   * time the array is opened or reopened, and defaults to 0.
+   */
+  Status set_timestamp_start(uint64_t timestamp_start);
+
   /** Directly set the array URI. */
   Status set_uri(const std::string& uri);
 
@@ -325,6 +417,12 @@ class Array {
   /** The metadata of the fragments the array was opened with. */
   std::vector<FragmentMetadata*> fragment_metadata_;
 
+  /**
+   * The R-Tree over the non-empty domains of `fragment_metadata_`
+   * (see `fragment_index`).
+   */
+  mutable std::shared_ptr<const RTree> fragment_index_;
+
   /** `True` if the array has been opened. */
   std::atomic<bool> is_open_;
 
@@ -337,6 +435,12 @@ class Array {
    */
   uint64_t timestamp_;
 
+  /**
+   * Fragments whose timestamp range ends before this timestamp are
+   * ignored when opening the array for reads.
+   */
+  uint64_t timestamp_start_;
+
   /** TileDB storage manager. */
   StorageManager* storage_manager_;
 
@@ -359,8 +463,17 @@ class Array {
   /** The array metadata. */
   Metadata metadata_;
 
-  /** True if the array metadata is loaded. */
-  bool metadata_loaded_;
+  /**
+   * True if the array metadata is loaded. It is checked without the lock by
+   * the metadata getters, so that concurrent reads load it once.
+   */
+  std::atomic<bool> metadata_loaded_;
+
+  /** The in-flight prefetches (see `prefetch`). */
+  std::vector<std::future<Status>> prefetch_tasks_;
+
+  /** Protects `prefetch_tasks_`. */
+  std::mutex prefetch_mtx_;
 
   /* ********************************* */
   /*          PRIVATE METHODS          */
@@ -369,6 +482,23 @@ class Array {
   /** Clears the cached max buffer sizes and subarray. */
   void clear_last_max_buffer_sizes();
 
+  /** Waits for the in-flight prefetches to finish. */
+  void wait_prefetch();
+
+  /**
+   * Starts loading the R-Trees and tile offsets of the fragments in the
+   * background if `sm.eager_metadata_load` is set, as a prefetch. The
+   * caller must hold `mtx_`.
+   */
+  void load_fragment_metadata_async();
+
+  /**
+   * Writes the cells of the array buffered by the context (if any), so that
+   * opening the array for reads sees the earlier writes of the context. It
+   * must be called before the timestamp of the array is set.
+   */
+  Status flush_write_buffer();
+
   /**
    * Computes the maximum buffer sizes for all attributes given a subarray,
    * which are cached locally in the instance.
@@ -419,6 +549,39 @@ class Array {
    * @return  Status
    */
   Status load_metadata();
+
+  /**
+   * Merges the sketches of the input attribute of the fragments whose
+   * non-empty domain overlaps the subarray.
+   *
+   * @param errmsg The prefix of the error messages.
+   * @param attribute The attribute name.
+   * @param subarray The subarray. If `nullptr`, all the fragments are
+   *     merged.
+   * @param hll The distinct count sketch to merge into.
+   * @param kll The quantile sketch to merge into.
+   * @return Status
+   */
+  Status merge_sketches(
+      const std::string& errmsg,
+      const char* attribute,
+      const void* subarray,
+      HyperLogLog* hll,
+      KllSketch* kll);
+
+  /**
+   * Merges the sketches of the input attribute of the fragments whose
+   * non-empty domain overlaps the subarray.
+   *
+   * @tparam T The domain type.
+   */
+  template <class T>
+  Status merge_sketches(
+      const std::string& errmsg,
+      const std::string& name,
+      const T* subarray,
+      HyperLogLog* hll,
+      KllSketch* kll);
 };
 
 }  // namespace sm
@@ -61,6 +61,7 @@ ArraySchema::ArraySchema() {
   capacity_ = constants::capacity;
   cell_order_ = Layout::ROW_MAJOR;
   domain_ = nullptr;
+  tile_colocation_ = false;
   tile_order_ = Layout::ROW_MAJOR;
   version_ = constants::format_version;
 
@@ -78,6 +79,7 @@ ArraySchema::ArraySchema(ArrayType array_type)
   capacity_ = constants::capacity;
   cell_order_ = Layout::ROW_MAJOR;
   domain_ = nullptr;
+  tile_colocation_ = false;
   tile_order_ = Layout::ROW_MAJOR;
   version_ = constants::format_version;
 
@@ -99,6 +101,7 @@ ArraySchema::ArraySchema(const ArraySchema* array_schema) {
   cell_var_offsets_filters_ = array_schema->cell_var_offsets_filters_;
   coords_filters_ = array_schema->coords_filters_;
   coords_size_ = array_schema->coords_size_;
+  tile_colocation_ = array_schema->tile_colocation_;
   tile_order_ = array_schema->tile_order_;
   version_ = array_schema->version_;
 
@@ -245,8 +248,18 @@ Status ArraySchema::check() const {
       return LOG_STATUS(Status::ArraySchemaError(
           "Array schema check failed; No attributes provided"));
     }
+    if (cell_order_ == Layout::HILBERT) {
+      return LOG_STATUS(
+          Status::ArraySchemaError("Array schema check failed; Dense arrays "
+                                   "cannot have a Hilbert cell order"));
+    }
   }
 
+  if (tile_order_ == Layout::HILBERT)
+    return LOG_STATUS(Status::ArraySchemaError(
+        "Array schema check failed; The Hilbert layout can only be used as "
+        "a cell order"));
+
   if (!check_double_delta_compressor())
     return LOG_STATUS(Status::ArraySchemaError(
         "Array schema check failed; Double delta compression can be used "
@@ -425,9 +438,19 @@ Status ArraySchema::serialize(Buffer* buff) const {
   for (auto& attr : attributes_)
     RETURN_NOT_OK(attr->serialize(buff));
 
+  // Write tile colocation
+  if (version_ >= 7) {
+    auto tile_colocation = (uint8_t)tile_colocation_;
+    RETURN_NOT_OK(buff->write(&tile_colocation, sizeof(uint8_t)));
+  }
+
   return Status::Ok();
 }
 
+bool ArraySchema::tile_colocation() const {
+  return tile_colocation_;
+}
+
 Layout ArraySchema::tile_order() const {
   return tile_order_;
 }
@@ -563,6 +586,13 @@ Status ArraySchema::deserialize(ConstBuffer* buff) {
     dim_map_[dim->name()] = dim;
   }
 
+  // Load tile colocation
+  if (version_ >= 7) {
+    uint8_t tile_colocation;
+    RETURN_NOT_OK(buff->read(&tile_colocation, sizeof(uint8_t)));
+    tile_colocation_ = tile_colocation != 0;
+  }
+
   // Initialize the rest of the object members
   RETURN_NOT_OK(init());
 
@@ -649,6 +679,10 @@ Status ArraySchema::set_domain(Domain* domain) {
   return Status::Ok();
 }
 
+void ArraySchema::set_tile_colocation(bool tile_colocation) {
+  tile_colocation_ = tile_colocation;
+}
+
 void ArraySchema::set_tile_order(Layout tile_order) {
   tile_order_ = tile_order;
 }
@@ -694,6 +728,7 @@ void ArraySchema::clear() {
   array_type_ = ArrayType::DENSE;
   capacity_ = constants::capacity;
   cell_order_ = Layout::ROW_MAJOR;
+  tile_colocation_ = false;
   tile_order_ = Layout::ROW_MAJOR;
 
   for (auto& attr : attributes_)
@@ -233,6 +233,12 @@ class ArraySchema {
    */
   Status serialize(Buffer* buff) const;
 
+  /**
+   * Returns `true` if the tiles with the same index of all attributes and
+   * dimensions of each fragment are stored contiguously in a single file.
+   */
+  bool tile_colocation() const;
+
   /** Returns the tile order. */
   Layout tile_order() const;
 
@@ -301,6 +307,9 @@ class ArraySchema {
    */
   Status set_domain(Domain* domain);
 
+  /** Sets whether the tiles of each fragment are co-located. */
+  void set_tile_colocation(bool tile_colocation);
+
   /** Sets the tile order. */
   void set_tile_order(Layout tile_order);
 
@@ -350,6 +359,12 @@ class ArraySchema {
   /** The array domain. */
   Domain* domain_;
 
+  /**
+   * Whether the tiles with the same index of all attributes and dimensions
+   * of each fragment are stored contiguously in a single file.
+   */
+  bool tile_colocation_;
+
   /**
    * The tile order. It can be one of the following:
    *    - TILEDB_ROW_MAJOR
@@ -38,6 +38,7 @@
 #include "tiledb/sm/enums/layout.h"
 #include "tiledb/sm/misc/logger.h"
 #include "tiledb/sm/misc/utils.h"
+#include "tiledb/sm/query/result_coords.h"
 
 #include <cassert>
 #include <iostream>
@@ -80,6 +81,8 @@ Domain::Domain(const Domain* domain) {
   type_ = domain->type_;
   cell_order_cmp_func_ = domain->cell_order_cmp_func_;
   tile_order_cmp_func_ = domain->tile_order_cmp_func_;
+  hilbert_bucket_func_ = domain->hilbert_bucket_func_;
+  hilbert_ = domain->hilbert_;
 
   for (auto dim : domain->dimensions_)
     dimensions_.emplace_back(new Dimension(dim));
@@ -486,7 +489,17 @@ int Domain::cell_order_cmp(
 
 int Domain::cell_order_cmp(
     const std::vector<const void*>& coord_buffs, uint64_t a, uint64_t b) const {
-  if (cell_order_ == Layout::ROW_MAJOR) {
+  if (cell_order_ == Layout::HILBERT) {
+    auto ha = hilbert_value(coord_buffs, a);
+    auto hb = hilbert_value(coord_buffs, b);
+    if (ha < hb)
+      return -1;
+    if (ha > hb)
+      return 1;
+    // else same Hilbert value --> break ties in row-major order
+  }
+
+  if (cell_order_ != Layout::COL_MAJOR) {
     for (unsigned d = 0; d < dim_num_; ++d) {
       auto dim = dimension(d);
       auto coord_size = dim->coord_size();
@@ -830,6 +843,19 @@ Status Domain::has_dimension(const std::string& name, bool* has_dim) const {
   return Status::Ok();
 }
 
+uint64_t Domain::hilbert_value(
+    const std::vector<const void*>& coord_buffs, uint64_t pos) const {
+  return compute_hilbert_value([&](unsigned d) {
+    auto coord_size = dimension(d)->coord_size();
+    auto buff = (const unsigned char*)coord_buffs[d];
+    return (const void*)&buff[pos * coord_size];
+  });
+}
+
+uint64_t Domain::hilbert_value(const ResultCoords& coords) const {
+  return compute_hilbert_value([&](unsigned d) { return coords.coord(d); });
+}
+
 Status Domain::init(Layout cell_order, Layout tile_order) {
   // Set cell and tile order
   cell_order_ = cell_order;
@@ -1173,39 +1199,49 @@ void Domain::compute_tile_domain() {
 void Domain::set_tile_cell_order_cmp_funcs() {
   tile_order_cmp_func_.resize(dim_num_);
   cell_order_cmp_func_.resize(dim_num_);
+  hilbert_bucket_func_.resize(dim_num_);
+  hilbert_ = Hilbert(dim_num_);
   for (unsigned d = 0; d < dim_num_; ++d) {
     switch (type_) {
       case Datatype::INT32:
         tile_order_cmp_func_[d] = tile_order_cmp<int32_t>;
         cell_order_cmp_func_[d] = cell_order_cmp<int32_t>;
+        hilbert_bucket_func_[d] = hilbert_bucket<int32_t>;
         break;
       case Datatype::INT64:
         tile_order_cmp_func_[d] = tile_order_cmp<int64_t>;
         cell_order_cmp_func_[d] = cell_order_cmp<int64_t>;
+        hilbert_bucket_func_[d] = hilbert_bucket<int64_t>;
         break;
       case Datatype::INT8:
         tile_order_cmp_func_[d] = tile_order_cmp<int8_t>;
         cell_order_cmp_func_[d] = cell_order_cmp<int8_t>;
+        hilbert_bucket_func_[d] = hilbert_bucket<int8_t>;
         break;
       case Datatype::UINT8:
         tile_order_cmp_func_[d] = tile_order_cmp<uint8_t>;
         cell_order_cmp_func_[d] = cell_order_cmp<uint8_t>;
+        hilbert_bucket_func_[d] = hilbert_bucket<uint8_t>;
         break;
       case Datatype::INT16:
         tile_order_cmp_func_[d] = tile_order_cmp<int16_t>;
         cell_order_cmp_func_[d] = cell_order_cmp<int16_t>;
+        hilbert_bucket_func_[d] = hilbert_bucket<int16_t>;
         break;
       case Datatype::UINT16:
         tile_order_cmp_func_[d] = tile_order_cmp<uint16_t>;
         cell_order_cmp_func_[d] = cell_order_cmp<uint16_t>;
+        hilbert_bucket_func_[d] = hilbert_bucket<uint16_t>;
         break;
       case Datatype::UINT32:
         tile_order_cmp_func_[d] = tile_order_cmp<uint32_t>;
         cell_order_cmp_func_[d] = cell_order_cmp<uint32_t>;
+        hilbert_bucket_func_[d] = hilbert_bucket<uint32_t>;
         break;
       case Datatype::UINT64:
         tile_order_cmp_func_[d] = tile_order_cmp<uint64_t>;
         cell_order_cmp_func_[d] = cell_order_cmp<uint64_t>;
+        hilbert_bucket_func_[d] = hilbert_bucket<uint64_t>;
         break;
       case Datatype::DATETIME_YEAR:
       case Datatype::DATETIME_MONTH:
@@ -1222,14 +1258,17 @@ void Domain::set_tile_cell_order_cmp_funcs() {
       case Datatype::DATETIME_AS:
         tile_order_cmp_func_[d] = tile_order_cmp<int64_t>;
         cell_order_cmp_func_[d] = cell_order_cmp<int64_t>;
+        hilbert_bucket_func_[d] = hilbert_bucket<int64_t>;
         break;
       case Datatype::FLOAT32:
         tile_order_cmp_func_[d] = tile_order_cmp<float>;
         cell_order_cmp_func_[d] = cell_order_cmp<float>;
+        hilbert_bucket_func_[d] = hilbert_bucket<float>;
         break;
       case Datatype::FLOAT64:
         tile_order_cmp_func_[d] = tile_order_cmp<double>;
         cell_order_cmp_func_[d] = cell_order_cmp<double>;
+        hilbert_bucket_func_[d] = hilbert_bucket<double>;
         break;
       case Datatype::CHAR:
       case Datatype::STRING_ASCII:
@@ -1371,6 +1410,46 @@ std::string Domain::default_dimension_name(unsigned int i) const {
   return ss.str();
 }
 
+template <class T>
+uint64_t Domain::hilbert_bucket(
+    const Dimension* dim, uint64_t max_bucket, const void* coord) {
+  auto domain = (const T*)dim->domain();
+  auto c = *(const T*)coord;
+
+  // The unsigned conversions compute the differences modulo 2^64, which is
+  // exact since the coordinates are in the domain
+  if (std::numeric_limits<T>::is_integer) {
+    auto range = (uint64_t)domain[1] - (uint64_t)domain[0];
+    auto offset = (uint64_t)c - (uint64_t)domain[0];
+    while (range > max_bucket) {
+      range >>= 1;
+      offset >>= 1;
+    }
+    return offset;
+  }
+
+  auto range = (double)domain[1] - (double)domain[0];
+  if (range <= 0)
+    return 0;
+  auto bucket = ((double)c - (double)domain[0]) / range * (double)max_bucket;
+  if (bucket <= 0)
+    return 0;
+  return (bucket >= (double)max_bucket) ? max_bucket : (uint64_t)bucket;
+}
+
+template <class CoordFunc>
+uint64_t Domain::compute_hilbert_value(const CoordFunc& coord) const {
+  if (hilbert_.bits() == 0)
+    return 0;
+
+  uint64_t buckets[Hilbert::max_dim_num];
+  auto max_bucket = hilbert_.max_bucket();
+  for (unsigned d = 0; d < dim_num_; ++d)
+    buckets[d] = hilbert_bucket_func_[d](dimension(d), max_bucket, coord(d));
+
+  return hilbert_.coords_to_hilbert(buckets);
+}
+
 template <class T>
 uint64_t Domain::get_cell_pos_col(const T* coords) const {
   // For easy reference
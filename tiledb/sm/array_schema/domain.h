@@ -33,6 +33,7 @@
 #ifndef TILEDB_DOMAIN_H
 #define TILEDB_DOMAIN_H
 
+#include "tiledb/sm/misc/hilbert.h"
 #include "tiledb/sm/misc/status.h"
 
 #include <vector>
@@ -43,6 +44,7 @@ namespace sm {
 class Buffer;
 class ConstBuffer;
 class Dimension;
+struct ResultCoords;
 
 enum class Datatype : uint8_t;
 enum class Layout : uint8_t;
@@ -557,6 +559,30 @@ class Domain {
    */
   Status has_dimension(const std::string& name, bool* has_dim) const;
 
+  /**
+   * Returns the position of the input coordinates along a Hilbert curve
+   * that covers the domain. Each coordinate is first mapped monotonically
+   * to the discrete Hilbert grid, so distinct coordinates may share the
+   * same Hilbert value.
+   *
+   * @param coord_buffs The input coordinates, given n separate buffers,
+   *     one per dimension. The buffers are sorted in the same order of the
+   *     dimensions as defined in the array schema.
+   * @param pos The position of the coordinate tuple across all buffers.
+   * @return The Hilbert value.
+   */
+  uint64_t hilbert_value(
+      const std::vector<const void*>& coord_buffs, uint64_t pos) const;
+
+  /**
+   * Returns the position of the input result coordinates along a Hilbert
+   * curve that covers the domain.
+   *
+   * @param coords The input result coordinates.
+   * @return The Hilbert value.
+   */
+  uint64_t hilbert_value(const ResultCoords& coords) const;
+
   /**
    * Initializes the domain.
    *
@@ -806,6 +832,21 @@ class Domain {
       const Dimension* dim, const void* coord_a, const void* coord_b)>
       tile_order_cmp_func_;
 
+  /**
+   * Vector of functions, one per dimension, for mapping a coordinate to
+   * the discrete grid of the Hilbert curve. The inputs to the function are:
+   *
+   * - dim: The dimension the coordinate belongs to.
+   * - max_bucket: The largest value of the grid on the dimension.
+   * - coord: The coordinate to map.
+   */
+  std::vector<uint64_t (*)(
+      const Dimension* dim, uint64_t max_bucket, const void* coord)>
+      hilbert_bucket_func_;
+
+  /** Computes Hilbert values over the dimensions of the domain. */
+  Hilbert hilbert_;
+
   /** The type of dimensions. */
   Datatype type_;
 
@@ -859,6 +900,29 @@ class Domain {
   /** Returns the default name constructed for the i-th dimension. */
   std::string default_dimension_name(unsigned int i) const;
 
+  /**
+   * Maps the input coordinate to the discrete grid of the Hilbert curve,
+   * preserving the order of the coordinates. Integer coordinates are
+   * offset from the domain low bound and, if the dimension domain does not
+   * fit the grid, shifted right; real coordinates are scaled.
+   *
+   * @tparam T The coordinates type.
+   * @param dim The dimension the coordinate belongs to.
+   * @param max_bucket The largest value of the grid on the dimension.
+   * @param coord The coordinate to map.
+   * @return The coordinate on the Hilbert grid.
+   */
+  template <class T>
+  static uint64_t hilbert_bucket(
+      const Dimension* dim, uint64_t max_bucket, const void* coord);
+
+  /**
+   * Returns the Hilbert value of the coordinates returned by `coord` for
+   * each dimension index.
+   */
+  template <class CoordFunc>
+  uint64_t compute_hilbert_value(const CoordFunc& coord) const;
+
   /**
    * Retrieves the next tile coordinates along the array tile order within a
    * given tile domain. Applicable only to **dense** arrays, and focusing on
@@ -31,6 +31,7 @@
  */
 
 #include "tiledb/sm/buffer/buffer.h"
+#include "tiledb/sm/buffer/buffer_pool.h"
 #include "tiledb/sm/buffer/const_buffer.h"
 #include "tiledb/sm/misc/logger.h"
 
@@ -76,7 +77,7 @@ Buffer::Buffer(const Buffer& buff) {
     if (buff.data_ == nullptr) {
       data_ = nullptr;
     } else {
-      data_ = std::malloc(alloced_size_);
+      data_ = BufferPool::global().allocate(buff.alloced_size_, &alloced_size_);
       assert(data_);
       std::memcpy(data_, buff.data_, buff.alloced_size_);
     }
@@ -113,7 +114,7 @@ uint64_t Buffer::alloced_size() const {
 
 void Buffer::clear() {
   if (data_ != nullptr && owns_data_)
-    std::free(data_);
+    BufferPool::global().free(data_, alloced_size_);
 
   data_ = nullptr;
   offset_ = 0;
@@ -170,21 +171,26 @@ Status Buffer::realloc(uint64_t nbytes) {
         "Cannot reallocate buffer; Buffer does not own data"));
   }
 
+  // Large allocations are drawn from (and returned to) the buffer pool, so
+  // that they are rounded up to its size classes
+  auto& pool = BufferPool::global();
   if (data_ == nullptr) {
-    data_ = std::malloc(nbytes);
+    data_ = pool.allocate(nbytes, &alloced_size_);
     if (data_ == nullptr) {
+      alloced_size_ = 0;
       return LOG_STATUS(Status::BufferError(
           "Cannot allocate buffer; Memory allocation failed"));
     }
-    alloced_size_ = nbytes;
   } else if (nbytes > alloced_size_) {
-    auto new_data = std::realloc(data_, nbytes);
+    uint64_t new_alloced_size = 0;
+    auto new_data =
+        pool.reallocate(data_, alloced_size_, nbytes, &new_alloced_size);
     if (new_data == nullptr) {
       return LOG_STATUS(Status::BufferError(
           "Cannot reallocate buffer; Memory allocation failed"));
     }
     data_ = new_data;
-    alloced_size_ = nbytes;
+    alloced_size_ = new_alloced_size;
   }
 
   return Status::Ok();
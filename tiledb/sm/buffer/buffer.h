@@ -130,7 +130,10 @@ class Buffer {
   Status read(void* buffer, uint64_t nbytes);
 
   /**
-   * Reallocates memory for the buffer with the input size.
+   * Reallocates memory for the buffer with the input size. The memory is
+   * aligned to `constants::buffer_alignment` bytes, or to
+   * `constants::direct_io_alignment` bytes for large buffers (see
+   * `BufferPool`).
    *
    * @param nbytes Number of bytes to allocate.
    * @return Status.
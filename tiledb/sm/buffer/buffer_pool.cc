@@ -0,0 +1,227 @@
+/**
+ * @file   buffer_pool.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *
+ * This file implements class BufferPool.
+ */
+
+#include "tiledb/sm/buffer/buffer_pool.h"
+#include "tiledb/sm/misc/constants.h"
+#include "tiledb/sm/misc/stats.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace tiledb {
+namespace sm {
+
+/** The smallest pooled allocation. Smaller ones go to the system directly. */
+static const uint64_t min_pooled_size = 1 << 16;
+
+/** The largest pooled allocation. */
+static const uint64_t max_pooled_size = 1ULL << 32;
+
+/** The huge page size. */
+static const uint64_t huge_page_size = 1 << 21;
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+BufferPool::BufferPool()
+    : capacity_(0)
+    , cached_(0)
+    , in_use_(0)
+    , huge_pages_(false) {
+}
+
+BufferPool::~BufferPool() {
+  release();
+}
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+BufferPool& BufferPool::global() {
+  // Never destroyed, since buffers may be freed by other static destructors
+  static BufferPool* pool = new BufferPool();
+  return *pool;
+}
+
+void* BufferPool::allocate(uint64_t nbytes, uint64_t* alloced) {
+  uint64_t class_size = 0;
+  auto c = size_class(nbytes, &class_size);
+  if (capacity_ == 0 || c == UINT64_MAX) {
+    *alloced = nbytes;
+    auto data = system_allocate(nbytes);
+    if (data != nullptr)
+      in_use_ += nbytes;
+    return data;
+  }
+
+  *alloced = class_size;
+  {
+    std::unique_lock<std::mutex> lck(mtx_);
+    if (c < free_lists_.size() && !free_lists_[c].empty()) {
+      auto data = free_lists_[c].back();
+      free_lists_[c].pop_back();
+      cached_ -= class_size;
+      in_use_ += class_size;
+      STATS_COUNTER_ADD(cache_buffer_pool_hits, 1);
+      return data;
+    }
+  }
+
+  STATS_COUNTER_ADD(cache_buffer_pool_misses, 1);
+  auto data = system_allocate(class_size);
+  if (data != nullptr)
+    in_use_ += class_size;
+  return data;
+}
+
+uint64_t BufferPool::cached() const {
+  std::unique_lock<std::mutex> lck(mtx_);
+  return cached_;
+}
+
+uint64_t BufferPool::in_use() const {
+  return in_use_;
+}
+
+void BufferPool::configure(uint64_t capacity, bool huge_pages) {
+  auto current = capacity_.load();
+  while (current < capacity &&
+         !capacity_.compare_exchange_weak(current, capacity)) {
+  }
+  if (huge_pages)
+    huge_pages_ = true;
+}
+
+void BufferPool::free(void* data, uint64_t alloced) {
+  if (data == nullptr)
+    return;
+  in_use_ -= alloced;
+
+  // Keep only the allocations of exactly a class size, within capacity
+  uint64_t class_size = 0;
+  auto c = size_class(alloced, &class_size);
+  if (c != UINT64_MAX && class_size == alloced) {
+    std::unique_lock<std::mutex> lck(mtx_);
+    if (cached_ + alloced <= capacity_) {
+      if (c >= free_lists_.size())
+        free_lists_.resize(c + 1);
+      free_lists_[c].push_back(data);
+      cached_ += alloced;
+      return;
+    }
+  }
+
+  system_free(data);
+}
+
+void* BufferPool::reallocate(
+    void* data, uint64_t alloced, uint64_t nbytes, uint64_t* new_alloced) {
+  // There is no aligned `realloc`, so the data is always moved
+  auto new_data = allocate(nbytes, new_alloced);
+  if (new_data == nullptr)
+    return nullptr;
+  std::memcpy(new_data, data, std::min(alloced, nbytes));
+  free(data, alloced);
+  return new_data;
+}
+
+void BufferPool::release() {
+  std::unique_lock<std::mutex> lck(mtx_);
+  for (auto& free_list : free_lists_) {
+    for (auto data : free_list)
+      system_free(data);
+    free_list.clear();
+  }
+  cached_ = 0;
+}
+
+/* ****************************** */
+/*         PRIVATE METHODS        */
+/* ****************************** */
+
+void* BufferPool::system_allocate(uint64_t nbytes) const {
+  uint64_t alignment = (nbytes >= constants::direct_io_min_buffer_size) ?
+                           constants::direct_io_alignment :
+                           constants::buffer_alignment;
+  bool huge = huge_pages_ && nbytes >= huge_page_size;
+  if (huge)
+    alignment = huge_page_size;
+
+#ifdef _WIN32
+  return _aligned_malloc(std::max<uint64_t>(nbytes, 1), alignment);
+#else
+  void* data = nullptr;
+  if (posix_memalign(&data, alignment, std::max<uint64_t>(nbytes, 1)) != 0)
+    return nullptr;
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  if (huge)
+    madvise(data, nbytes, MADV_HUGEPAGE);
+#endif
+  return data;
+#endif
+}
+
+void BufferPool::system_free(void* data) {
+#ifdef _WIN32
+  _aligned_free(data);
+#else
+  std::free(data);
+#endif
+}
+
+uint64_t BufferPool::size_class(uint64_t nbytes, uint64_t* class_size) {
+  if (nbytes < min_pooled_size || nbytes > max_pooled_size)
+    return UINT64_MAX;
+
+  // Four classes per power of two, starting at `min_pooled_size`
+  uint64_t pow = min_pooled_size;
+  uint64_t c = 0;
+  while (2 * pow < nbytes) {
+    pow *= 2;
+    c += 4;
+  }
+  auto step = pow / 4;
+  auto sub = (nbytes - pow + step - 1) / step;
+  *class_size = pow + sub * step;
+  return c + sub;
+}
+
+}  // namespace sm
+}  // namespace tiledb
@@ -0,0 +1,174 @@
+/**
+ * @file   buffer_pool.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ *
+ * This file declares class BufferPool.
+ */
+
+#ifndef TILEDB_BUFFER_POOL_H
+#define TILEDB_BUFFER_POOL_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "tiledb/sm/misc/macros.h"
+
+namespace tiledb {
+namespace sm {
+
+/**
+ * A process-wide pool of the large allocations backing the buffers (e.g.,
+ * the tile buffers). The allocated sizes are rounded up to size classes,
+ * four per power of two, and freed allocations are kept per class up to a
+ * total capacity, so that the next tiles of about the same size reuse them
+ * instead of faulting in fresh memory.
+ *
+ * The pool is disabled (i.e., it allocates and frees directly) while its
+ * capacity is zero.
+ *
+ * All the allocations are aligned to `constants::buffer_alignment` bytes, or
+ * to `constants::direct_io_alignment` bytes from
+ * `constants::direct_io_min_buffer_size` bytes, so that they suit aligned
+ * SIMD loads and direct I/O. They must be released through the pool.
+ */
+class BufferPool {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /** Constructor. */
+  BufferPool();
+
+  /** Destructor. */
+  ~BufferPool();
+
+  DISABLE_COPY_AND_COPY_ASSIGN(BufferPool);
+  DISABLE_MOVE_AND_MOVE_ASSIGN(BufferPool);
+
+  /* ********************************* */
+  /*                 API               */
+  /* ********************************* */
+
+  /** Returns the process-wide pool. */
+  static BufferPool& global();
+
+  /**
+   * Allocates memory.
+   *
+   * @param nbytes The number of bytes to allocate.
+   * @param alloced Set to the size actually allocated, at least `nbytes`.
+   * @return The allocated memory, or `nullptr` on failure.
+   */
+  void* allocate(uint64_t nbytes, uint64_t* alloced);
+
+  /** Returns the number of bytes of the freed allocations kept. */
+  uint64_t cached() const;
+
+  /** Returns the number of bytes allocated and not freed yet. */
+  uint64_t in_use() const;
+
+  /**
+   * Raises the capacity of the pool, i.e., the maximum number of bytes of
+   * freed allocations that it keeps, and enables huge pages.
+   *
+   * @param capacity The capacity in bytes.
+   * @param huge_pages If `true`, allocations of at least one huge page are
+   *     aligned to huge pages and advised to be backed by them (Linux only).
+   */
+  void configure(uint64_t capacity, bool huge_pages);
+
+  /**
+   * Frees memory returned by `allocate`, keeping it if the pool has room.
+   *
+   * @param data The memory to free.
+   * @param alloced The size reported by `allocate`.
+   */
+  void free(void* data, uint64_t alloced);
+
+  /**
+   * Grows an allocation, like `std::realloc`, preserving its alignment.
+   *
+   * @param data The memory returned by `allocate`.
+   * @param alloced The size reported by `allocate`.
+   * @param nbytes The new number of bytes to allocate.
+   * @param new_alloced Set to the size actually allocated.
+   * @return The reallocated memory, or `nullptr` on failure, in which case
+   *     `data` is left intact.
+   */
+  void* reallocate(
+      void* data, uint64_t alloced, uint64_t nbytes, uint64_t* new_alloced);
+
+  /** Releases all the freed allocations kept by the pool. */
+  void release();
+
+ private:
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The maximum number of bytes kept. */
+  std::atomic<uint64_t> capacity_;
+
+  /** The number of bytes kept. */
+  uint64_t cached_;
+
+  /** The number of bytes allocated and not freed yet. */
+  std::atomic<uint64_t> in_use_;
+
+  /** The freed allocations kept, per size class. */
+  std::vector<std::vector<void*>> free_lists_;
+
+  /** Whether large allocations are backed by huge pages. */
+  std::atomic<bool> huge_pages_;
+
+  /** Mutex protecting `cached_` and `free_lists_`. */
+  mutable std::mutex mtx_;
+
+  /* ********************************* */
+  /*           PRIVATE METHODS         */
+  /* ********************************* */
+
+  /** Allocates `nbytes` aligned bytes from the system. */
+  void* system_allocate(uint64_t nbytes) const;
+
+  /** Frees memory returned by `system_allocate`. */
+  static void system_free(void* data);
+
+  /**
+   * Returns the size class of `nbytes`, setting `class_size` to the size of
+   * the class. Returns `UINT64_MAX` if the size is not pooled.
+   */
+  static uint64_t size_class(uint64_t nbytes, uint64_t* class_size);
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_BUFFER_POOL_H
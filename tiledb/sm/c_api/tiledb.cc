@@ -39,12 +39,14 @@
 #include "tiledb/sm/config/config.h"
 #include "tiledb/sm/config/config_iter.h"
 #include "tiledb/sm/cpp_api/core_interface.h"
+#include "tiledb/sm/enums/aggregate_op.h"
 #include "tiledb/sm/enums/array_type.h"
 #include "tiledb/sm/enums/encryption_type.h"
 #include "tiledb/sm/enums/filesystem.h"
 #include "tiledb/sm/enums/filter_option.h"
 #include "tiledb/sm/enums/filter_type.h"
 #include "tiledb/sm/enums/object_type.h"
+#include "tiledb/sm/enums/query_priority.h"
 #include "tiledb/sm/enums/query_status.h"
 #include "tiledb/sm/enums/query_type.h"
 #include "tiledb/sm/enums/serialization_type.h"
@@ -56,6 +58,7 @@
 #include "tiledb/sm/misc/logger.h"
 #include "tiledb/sm/misc/stats.h"
 #include "tiledb/sm/misc/utils.h"
+#include "tiledb/sm/query/arrow_export.h"
 #include "tiledb/sm/query/query.h"
 #include "tiledb/sm/rest/rest_client.h"
 #include "tiledb/sm/serialization/array_schema.h"
@@ -503,6 +506,18 @@ inline int32_t sanity_check(tiledb_ctx_t* ctx, const tiledb_query_t* query) {
   return TILEDB_OK;
 }
 
+inline int32_t sanity_check(
+    tiledb_ctx_t* ctx, const tiledb_query_condition_t* cond) {
+  if (cond == nullptr || cond->query_condition_ == nullptr) {
+    auto st =
+        tiledb::sm::Status::Error("Invalid TileDB query condition object");
+    LOG_STATUS(st);
+    save_error(ctx, st);
+    return TILEDB_ERR;
+  }
+  return TILEDB_OK;
+}
+
 inline int32_t sanity_check(tiledb_ctx_t* ctx, const tiledb_vfs_t* vfs) {
   if (vfs == nullptr || vfs->vfs_ == nullptr) {
     auto st =
@@ -1154,6 +1169,26 @@ int32_t tiledb_ctx_cancel_tasks(tiledb_ctx_t* ctx) {
   return TILEDB_OK;
 }
 
+int32_t tiledb_ctx_poll_completions(
+    tiledb_ctx_t* ctx,
+    void** tags,
+    uint32_t max_completions,
+    int32_t timeout_ms,
+    uint32_t* num_completions) {
+  if (sanity_check(ctx) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  uint64_t num = 0;
+  if (SAVE_ERROR_CATCH(
+          ctx,
+          ctx->ctx_->storage_manager()->poll_completions(
+              tags, max_completions, timeout_ms, &num)))
+    return TILEDB_ERR;
+  *num_completions = static_cast<uint32_t>(num);
+
+  return TILEDB_OK;
+}
+
 int32_t tiledb_ctx_set_tag(
     tiledb_ctx_t* ctx, const char* key, const char* value) {
   if (sanity_check(ctx) == TILEDB_ERR)
@@ -1165,6 +1200,39 @@ int32_t tiledb_ctx_set_tag(
   return TILEDB_OK;
 }
 
+int32_t tiledb_ctx_warm_up(tiledb_ctx_t* ctx, const char* uri) {
+  if (sanity_check(ctx) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  if (SAVE_ERROR_CATCH(
+          ctx,
+          ctx->ctx_->storage_manager()->vfs()->warm_up(tiledb::sm::URI(uri))))
+    return TILEDB_ERR;
+
+  return TILEDB_OK;
+}
+
+int32_t tiledb_ctx_get_memory_usage(tiledb_ctx_t* ctx, char** json) {
+  if (sanity_check(ctx) == TILEDB_ERR || json == nullptr)
+    return TILEDB_ERR;
+
+  std::string str;
+  if (SAVE_ERROR_CATCH(ctx, ctx->ctx_->storage_manager()->memory_usage(&str)))
+    return TILEDB_ERR;
+
+  *json = static_cast<char*>(std::malloc(str.size() + 1));
+  if (*json == nullptr) {
+    auto st = tiledb::sm::Status::Error("Failed to allocate the memory usage");
+    LOG_STATUS(st);
+    save_error(ctx, st);
+    return TILEDB_ERR;
+  }
+  std::memcpy(*json, str.data(), str.size());
+  (*json)[str.size()] = '\0';
+
+  return TILEDB_OK;
+}
+
 /* ****************************** */
 /*              GROUP             */
 /* ****************************** */
@@ -1989,6 +2057,17 @@ int32_t tiledb_array_schema_set_tile_order(
   return TILEDB_OK;
 }
 
+int32_t tiledb_array_schema_set_tile_colocation(
+    tiledb_ctx_t* ctx,
+    tiledb_array_schema_t* array_schema,
+    int32_t tile_colocation) {
+  if (sanity_check(ctx) == TILEDB_ERR ||
+      sanity_check(ctx, array_schema) == TILEDB_ERR)
+    return TILEDB_ERR;
+  array_schema->array_schema_->set_tile_colocation(tile_colocation != 0);
+  return TILEDB_OK;
+}
+
 int32_t tiledb_array_schema_set_coords_filter_list(
     tiledb_ctx_t* ctx,
     tiledb_array_schema_t* array_schema,
@@ -2261,6 +2340,17 @@ int32_t tiledb_array_schema_get_tile_order(
   return TILEDB_OK;
 }
 
+int32_t tiledb_array_schema_get_tile_colocation(
+    tiledb_ctx_t* ctx,
+    const tiledb_array_schema_t* array_schema,
+    int32_t* tile_colocation) {
+  if (sanity_check(ctx) == TILEDB_ERR ||
+      sanity_check(ctx, array_schema) == TILEDB_ERR)
+    return TILEDB_ERR;
+  *tile_colocation = array_schema->array_schema_->tile_colocation() ? 1 : 0;
+  return TILEDB_OK;
+}
+
 int32_t tiledb_array_schema_get_attribute_num(
     tiledb_ctx_t* ctx,
     const tiledb_array_schema_t* array_schema,
@@ -2517,14 +2607,6 @@ int32_t tiledb_query_set_buffer_var(
   if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, query) == TILEDB_ERR)
     return TILEDB_ERR;
 
-  // On writes, check the provided offsets for validity.
-  if (query->query_->type() == tiledb::sm::QueryType::WRITE &&
-      save_error(
-          ctx,
-          tiledb::sm::Query::check_var_attr_offsets(
-              buffer_off, buffer_off_size, buffer_val_size)))
-    return TILEDB_ERR;
-
   // Normalize name
   std::string normalized_name;
   if (SAVE_ERROR_CATCH(
@@ -2591,6 +2673,19 @@ int32_t tiledb_query_get_buffer_var(
   return TILEDB_OK;
 }
 
+int32_t tiledb_query_set_managed_buffer(
+    tiledb_ctx_t* ctx, tiledb_query_t* query, const char* attribute) {
+  // Sanity check
+  if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, query) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  // Set managed attribute buffer
+  if (SAVE_ERROR_CATCH(ctx, query->query_->set_managed_buffer(attribute)))
+    return TILEDB_ERR;
+
+  return TILEDB_OK;
+}
+
 int32_t tiledb_query_set_layout(
     tiledb_ctx_t* ctx, tiledb_query_t* query, tiledb_layout_t layout) {
   // Sanity check
@@ -2606,6 +2701,221 @@ int32_t tiledb_query_set_layout(
   return TILEDB_OK;
 }
 
+int32_t tiledb_query_set_condition(
+    tiledb_ctx_t* ctx,
+    tiledb_query_t* query,
+    const tiledb_query_condition_t* cond) {
+  // Sanity check
+  if (sanity_check(ctx) == TILEDB_ERR ||
+      sanity_check(ctx, query) == TILEDB_ERR ||
+      sanity_check(ctx, cond) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  // Set condition
+  if (SAVE_ERROR_CATCH(
+          ctx, query->query_->set_condition(*cond->query_condition_)))
+    return TILEDB_ERR;
+
+  return TILEDB_OK;
+}
+
+int32_t tiledb_query_add_aggregate(
+    tiledb_ctx_t* ctx,
+    tiledb_query_t* query,
+    const char* attribute_name,
+    tiledb_aggregate_op_t op,
+    void* result) {
+  // Sanity check
+  if (sanity_check(ctx) == TILEDB_ERR ||
+      sanity_check(ctx, query) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  if (attribute_name == nullptr) {
+    auto st = tiledb::sm::Status::QueryError(
+        "Cannot add aggregate; Invalid attribute name");
+    LOG_STATUS(st);
+    save_error(ctx, st);
+    return TILEDB_ERR;
+  }
+
+  // Add aggregate
+  if (SAVE_ERROR_CATCH(
+          ctx,
+          query->query_->add_aggregate(
+              attribute_name,
+              static_cast<tiledb::sm::AggregateOp>(op),
+              result)))
+    return TILEDB_ERR;
+
+  return TILEDB_OK;
+}
+
+int32_t tiledb_query_set_limit(
+    tiledb_ctx_t* ctx, tiledb_query_t* query, uint64_t limit) {
+  // Sanity check
+  if (sanity_check(ctx) == TILEDB_ERR ||
+      sanity_check(ctx, query) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  // Set limit
+  if (SAVE_ERROR_CATCH(ctx, query->query_->set_limit(limit)))
+    return TILEDB_ERR;
+
+  return TILEDB_OK;
+}
+
+int32_t tiledb_query_set_deadline(
+    tiledb_ctx_t* ctx, tiledb_query_t* query, uint64_t deadline_ms) {
+  // Sanity check
+  if (sanity_check(ctx) == TILEDB_ERR ||
+      sanity_check(ctx, query) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  // Set deadline
+  if (SAVE_ERROR_CATCH(ctx, query->query_->set_deadline(deadline_ms)))
+    return TILEDB_ERR;
+
+  return TILEDB_OK;
+}
+
+int32_t tiledb_query_set_sample(
+    tiledb_ctx_t* ctx,
+    tiledb_query_t* query,
+    double fraction,
+    uint64_t seed) {
+  // Sanity check
+  if (sanity_check(ctx) == TILEDB_ERR ||
+      sanity_check(ctx, query) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  // Set sample
+  if (SAVE_ERROR_CATCH(ctx, query->query_->set_sample(fraction, seed)))
+    return TILEDB_ERR;
+
+  return TILEDB_OK;
+}
+
+int32_t tiledb_query_get_sample_ratio(
+    tiledb_ctx_t* ctx, tiledb_query_t* query, double* ratio) {
+  // Sanity check
+  if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, query) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  *ratio = query->query_->sample_ratio();
+
+  return TILEDB_OK;
+}
+
+int32_t tiledb_query_set_resolution_level(
+    tiledb_ctx_t* ctx, tiledb_query_t* query, uint32_t level) {
+  // Sanity check
+  if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, query) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  // Set resolution level
+  if (SAVE_ERROR_CATCH(ctx, query->query_->set_resolution_level(level)))
+    return TILEDB_ERR;
+
+  return TILEDB_OK;
+}
+
+int32_t tiledb_query_set_fragment_part(
+    tiledb_ctx_t* ctx,
+    tiledb_query_t* query,
+    tiledb_query_t* fragment_query,
+    uint32_t part) {
+  // Sanity check
+  if (sanity_check(ctx) == TILEDB_ERR ||
+      sanity_check(ctx, query) == TILEDB_ERR ||
+      sanity_check(ctx, fragment_query) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  // Set fragment part
+  if (SAVE_ERROR_CATCH(
+          ctx,
+          query->query_->set_fragment_part(fragment_query->query_, part)))
+    return TILEDB_ERR;
+
+  return TILEDB_OK;
+}
+
+int32_t tiledb_query_set_offsets_bitsize(
+    tiledb_ctx_t* ctx, tiledb_query_t* query, uint32_t bitsize) {
+  // Sanity check
+  if (sanity_check(ctx) == TILEDB_ERR ||
+      sanity_check(ctx, query) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  // Set offsets bitsize
+  if (SAVE_ERROR_CATCH(ctx, query->query_->set_offsets_bitsize(bitsize)))
+    return TILEDB_ERR;
+
+  return TILEDB_OK;
+}
+
+int32_t tiledb_query_set_priority(
+    tiledb_ctx_t* ctx,
+    tiledb_query_t* query,
+    tiledb_query_priority_t priority) {
+  // Sanity check
+  if (sanity_check(ctx) == TILEDB_ERR ||
+      sanity_check(ctx, query) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  // Set priority
+  if (SAVE_ERROR_CATCH(
+          ctx,
+          query->query_->set_priority(
+              static_cast<tiledb::sm::QueryPriority>(priority))))
+    return TILEDB_ERR;
+
+  return TILEDB_OK;
+}
+
+int32_t tiledb_query_export_arrow(
+    tiledb_ctx_t* ctx,
+    tiledb_query_t* query,
+    const char* name,
+    void* arrow_array,
+    void* arrow_schema) {
+  // Sanity check
+  if (sanity_check(ctx) == TILEDB_ERR ||
+      sanity_check(ctx, query) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  if (name == nullptr || arrow_array == nullptr || arrow_schema == nullptr) {
+    auto st = tiledb::sm::Status::Error(
+        "Cannot export query buffer to Arrow; Invalid arguments");
+    LOG_STATUS(st);
+    save_error(ctx, st);
+    return TILEDB_ERR;
+  }
+
+  // Export the results
+  if (SAVE_ERROR_CATCH(
+          ctx,
+          tiledb::sm::arrow::export_query_buffer(
+              query->query_,
+              name,
+              static_cast<ArrowArray*>(arrow_array),
+              static_cast<ArrowSchema*>(arrow_schema))))
+    return TILEDB_ERR;
+
+  return TILEDB_OK;
+}
+
+int32_t tiledb_query_prepare(tiledb_ctx_t* ctx, tiledb_query_t* query) {
+  // Sanity check
+  if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, query) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  // Prepare query
+  if (SAVE_ERROR_CATCH(ctx, query->query_->prepare()))
+    return TILEDB_ERR;
+
+  return TILEDB_OK;
+}
+
 int32_t tiledb_query_finalize(tiledb_ctx_t* ctx, tiledb_query_t* query) {
   // Trivial case
   if (query == nullptr)
@@ -2657,6 +2967,37 @@ int32_t tiledb_query_submit_async(
   return TILEDB_OK;
 }
 
+int32_t tiledb_query_submit_async_tagged(
+    tiledb_ctx_t* ctx, tiledb_query_t* query, void* tag) {
+  // Sanity checks
+  if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, query) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  if (SAVE_ERROR_CATCH(ctx, query->query_->submit_async(tag)))
+    return TILEDB_ERR;
+
+  return TILEDB_OK;
+}
+
+int32_t tiledb_query_submit_batch(
+    tiledb_ctx_t* ctx, tiledb_query_t** queries, uint32_t num_queries) {
+  // Sanity checks
+  if (sanity_check(ctx) == TILEDB_ERR)
+    return TILEDB_ERR;
+  std::vector<tiledb::sm::Query*> batch(num_queries);
+  for (uint32_t i = 0; i < num_queries; ++i) {
+    if (sanity_check(ctx, queries[i]) == TILEDB_ERR)
+      return TILEDB_ERR;
+    batch[i] = queries[i]->query_;
+  }
+
+  if (SAVE_ERROR_CATCH(
+          ctx, ctx->ctx_->storage_manager()->query_submit_batch(batch)))
+    return TILEDB_ERR;
+
+  return TILEDB_OK;
+}
+
 int32_t tiledb_query_has_results(
     tiledb_ctx_t* ctx, tiledb_query_t* query, int32_t* has_results) {
   // Sanity check
@@ -2668,6 +3009,30 @@ int32_t tiledb_query_has_results(
   return TILEDB_OK;
 }
 
+int32_t tiledb_query_get_stats(
+    tiledb_ctx_t* ctx, tiledb_query_t* query, char** stats_json) {
+  // Sanity check
+  if (sanity_check(ctx) == TILEDB_ERR ||
+      sanity_check(ctx, query) == TILEDB_ERR || stats_json == nullptr)
+    return TILEDB_ERR;
+
+  std::string str;
+  if (SAVE_ERROR_CATCH(ctx, query->query_->stats(&str)))
+    return TILEDB_ERR;
+
+  *stats_json = static_cast<char*>(std::malloc(str.size() + 1));
+  if (*stats_json == nullptr) {
+    auto st = tiledb::sm::Status::Error("Failed to allocate the query stats");
+    LOG_STATUS(st);
+    save_error(ctx, st);
+    return TILEDB_ERR;
+  }
+  std::memcpy(*stats_json, str.data(), str.size());
+  (*stats_json)[str.size()] = '\0';
+
+  return TILEDB_OK;
+}
+
 int32_t tiledb_query_get_status(
     tiledb_ctx_t* ctx, tiledb_query_t* query, tiledb_query_status_t* status) {
   // Sanity check
@@ -2843,6 +3208,109 @@ int32_t tiledb_query_get_fragment_timestamp_range(
   return TILEDB_OK;
 }
 
+/* ****************************** */
+/*         QUERY CONDITION        */
+/* ****************************** */
+
+int32_t tiledb_query_condition_alloc(
+    tiledb_ctx_t* ctx, tiledb_query_condition_t** cond) {
+  if (sanity_check(ctx) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  // Create query condition struct
+  *cond = new (std::nothrow) tiledb_query_condition_t;
+  if (*cond == nullptr) {
+    auto st = tiledb::sm::Status::Error(
+        "Failed to create TileDB query condition object; Memory allocation "
+        "error");
+    LOG_STATUS(st);
+    save_error(ctx, st);
+    return TILEDB_OOM;
+  }
+
+  // Create query condition object
+  (*cond)->query_condition_ = new (std::nothrow) tiledb::sm::QueryCondition();
+  if ((*cond)->query_condition_ == nullptr) {
+    delete *cond;
+    *cond = nullptr;
+    auto st = tiledb::sm::Status::Error(
+        "Failed to allocate TileDB query condition object");
+    LOG_STATUS(st);
+    save_error(ctx, st);
+    return TILEDB_OOM;
+  }
+
+  // Success
+  return TILEDB_OK;
+}
+
+void tiledb_query_condition_free(tiledb_query_condition_t** cond) {
+  if (cond != nullptr && *cond != nullptr) {
+    delete (*cond)->query_condition_;
+    delete *cond;
+    *cond = nullptr;
+  }
+}
+
+int32_t tiledb_query_condition_init(
+    tiledb_ctx_t* ctx,
+    tiledb_query_condition_t* cond,
+    const char* attribute_name,
+    const void* condition_value,
+    uint64_t condition_value_size,
+    tiledb_query_condition_op_t op) {
+  if (sanity_check(ctx) == TILEDB_ERR ||
+      sanity_check(ctx, cond) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  if (attribute_name == nullptr) {
+    auto st = tiledb::sm::Status::Error(
+        "Cannot initialize query condition; Invalid attribute name");
+    LOG_STATUS(st);
+    save_error(ctx, st);
+    return TILEDB_ERR;
+  }
+
+  if (SAVE_ERROR_CATCH(
+          ctx,
+          cond->query_condition_->init(
+              attribute_name,
+              condition_value,
+              condition_value_size,
+              static_cast<tiledb::sm::QueryConditionOp>(op))))
+    return TILEDB_ERR;
+
+  return TILEDB_OK;
+}
+
+int32_t tiledb_query_condition_combine(
+    tiledb_ctx_t* ctx,
+    const tiledb_query_condition_t* left_cond,
+    const tiledb_query_condition_t* right_cond,
+    tiledb_query_condition_combination_op_t combination_op,
+    tiledb_query_condition_t** combined_cond) {
+  if (sanity_check(ctx) == TILEDB_ERR ||
+      sanity_check(ctx, left_cond) == TILEDB_ERR ||
+      sanity_check(ctx, right_cond) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  if (tiledb_query_condition_alloc(ctx, combined_cond) != TILEDB_OK)
+    return TILEDB_OOM;
+
+  if (SAVE_ERROR_CATCH(
+          ctx,
+          left_cond->query_condition_->combine(
+              *right_cond->query_condition_,
+              static_cast<tiledb::sm::QueryConditionCombinationOp>(
+                  combination_op),
+              (*combined_cond)->query_condition_))) {
+    tiledb_query_condition_free(combined_cond);
+    return TILEDB_ERR;
+  }
+
+  return TILEDB_OK;
+}
+
 /* ****************************** */
 /*              ARRAY             */
 /* ****************************** */
@@ -2992,6 +3460,69 @@ int32_t tiledb_array_is_open(
   return TILEDB_OK;
 }
 
+int32_t tiledb_array_prefetch(
+    tiledb_ctx_t* ctx,
+    tiledb_array_t* array,
+    const void* subarray,
+    const char** attributes,
+    uint32_t attribute_num) {
+  if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, array) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  std::vector<std::string> attribute_names;
+  for (uint32_t i = 0; i < attribute_num; ++i) {
+    if (attributes[i] == nullptr) {
+      auto st = tiledb::sm::Status::Error(
+          "Cannot prefetch array; Invalid attribute name");
+      LOG_STATUS(st);
+      save_error(ctx, st);
+      return TILEDB_ERR;
+    }
+    attribute_names.emplace_back(attributes[i]);
+  }
+
+  // Prefetch array
+  if (SAVE_ERROR_CATCH(
+          ctx, array->array_->prefetch(subarray, attribute_names)))
+    return TILEDB_ERR;
+
+  return TILEDB_OK;
+}
+
+int32_t tiledb_array_get_approx_distinct_count(
+    tiledb_ctx_t* ctx,
+    tiledb_array_t* array,
+    const char* attribute,
+    const void* subarray,
+    uint64_t* count) {
+  if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, array) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  if (SAVE_ERROR_CATCH(
+          ctx,
+          array->array_->approx_distinct_count(attribute, subarray, count)))
+    return TILEDB_ERR;
+
+  return TILEDB_OK;
+}
+
+int32_t tiledb_array_get_approx_quantile(
+    tiledb_ctx_t* ctx,
+    tiledb_array_t* array,
+    const char* attribute,
+    const void* subarray,
+    double q,
+    double* value) {
+  if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, array) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  if (SAVE_ERROR_CATCH(
+          ctx, array->array_->approx_quantile(attribute, subarray, q, value)))
+    return TILEDB_ERR;
+
+  return TILEDB_OK;
+}
+
 int32_t tiledb_array_reopen(tiledb_ctx_t* ctx, tiledb_array_t* array) {
   if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, array) == TILEDB_ERR)
     return TILEDB_ERR;
@@ -3025,6 +3556,28 @@ int32_t tiledb_array_get_timestamp(
   return TILEDB_OK;
 }
 
+int32_t tiledb_array_set_open_timestamp_start(
+    tiledb_ctx_t* ctx, tiledb_array_t* array, uint64_t timestamp_start) {
+  if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, array) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  if (SAVE_ERROR_CATCH(
+          ctx, array->array_->set_timestamp_start(timestamp_start)))
+    return TILEDB_ERR;
+
+  return TILEDB_OK;
+}
+
+int32_t tiledb_array_get_open_timestamp_start(
+    tiledb_ctx_t* ctx, tiledb_array_t* array, uint64_t* timestamp_start) {
+  if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, array) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  *timestamp_start = array->array_->timestamp_start();
+
+  return TILEDB_OK;
+}
+
 int32_t tiledb_array_close(tiledb_ctx_t* ctx, tiledb_array_t* array) {
   if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, array) == TILEDB_ERR)
     return TILEDB_ERR;
@@ -3200,6 +3753,41 @@ int32_t tiledb_array_consolidate_with_key(
   return TILEDB_OK;
 }
 
+int32_t tiledb_array_consolidate_with_stats(
+    tiledb_ctx_t* ctx,
+    const char* array_uri,
+    tiledb_config_t* config,
+    char** stats) {
+  // Sanity checks
+  if (sanity_check(ctx) == TILEDB_ERR || stats == nullptr)
+    return TILEDB_ERR;
+
+  std::string str;
+  if (SAVE_ERROR_CATCH(
+          ctx,
+          ctx->ctx_->storage_manager()->array_consolidate(
+              array_uri,
+              tiledb::sm::EncryptionType::NO_ENCRYPTION,
+              nullptr,
+              0,
+              (config == nullptr) ? nullptr : config->config_,
+              &str)))
+    return TILEDB_ERR;
+
+  *stats = static_cast<char*>(std::malloc(str.size() + 1));
+  if (*stats == nullptr) {
+    auto st = tiledb::sm::Status::Error(
+        "Failed to allocate the consolidation statistics");
+    LOG_STATUS(st);
+    save_error(ctx, st);
+    return TILEDB_ERR;
+  }
+  std::memcpy(*stats, str.data(), str.size());
+  (*stats)[str.size()] = '\0';
+
+  return TILEDB_OK;
+}
+
 int32_t tiledb_array_get_non_empty_domain(
     tiledb_ctx_t* ctx, tiledb_array_t* array, void* domain, int32_t* is_empty) {
   if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, array) == TILEDB_ERR)
@@ -3449,6 +4037,48 @@ int32_t tiledb_array_consolidate_metadata_with_key(
   return TILEDB_OK;
 }
 
+int32_t tiledb_array_consolidate_fragment_metadata(
+    tiledb_ctx_t* ctx, const char* array_uri, tiledb_config_t* config) {
+  return tiledb_array_consolidate_fragment_metadata_with_key(
+      ctx, array_uri, TILEDB_NO_ENCRYPTION, nullptr, 0, config);
+}
+
+int32_t tiledb_array_consolidate_fragment_metadata_with_key(
+    tiledb_ctx_t* ctx,
+    const char* array_uri,
+    tiledb_encryption_type_t encryption_type,
+    const void* encryption_key,
+    uint32_t key_length,
+    tiledb_config_t* config) {
+  // Sanity checks
+  if (sanity_check(ctx) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  if (SAVE_ERROR_CATCH(
+          ctx,
+          ctx->ctx_->storage_manager()->fragment_metadata_consolidate(
+              array_uri,
+              static_cast<tiledb::sm::EncryptionType>(encryption_type),
+              encryption_key,
+              key_length,
+              (config == nullptr) ? nullptr : config->config_)))
+    return TILEDB_ERR;
+
+  return TILEDB_OK;
+}
+
+int32_t tiledb_array_vacuum(tiledb_ctx_t* ctx, const char* array_uri) {
+  // Sanity checks
+  if (sanity_check(ctx) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  if (SAVE_ERROR_CATCH(
+          ctx, ctx->ctx_->storage_manager()->array_vacuum(array_uri)))
+    return TILEDB_ERR;
+
+  return TILEDB_OK;
+}
+
 /* ****************************** */
 /*         OBJECT MANAGEMENT      */
 /* ****************************** */
@@ -4018,6 +4648,17 @@ int32_t tiledb_vfs_touch(
   return TILEDB_OK;
 }
 
+int32_t tiledb_vfs_warm_up(
+    tiledb_ctx_t* ctx, tiledb_vfs_t* vfs, const char* uri) {
+  if (sanity_check(ctx) == TILEDB_ERR || sanity_check(ctx, vfs) == TILEDB_ERR)
+    return TILEDB_ERR;
+
+  if (SAVE_ERROR_CATCH(ctx, vfs->vfs_->warm_up(tiledb::sm::URI(uri))))
+    return TILEDB_ERR;
+
+  return TILEDB_OK;
+}
+
 /* ****************************** */
 /*              URI               */
 /* ****************************** */
@@ -4089,6 +4730,43 @@ int32_t tiledb_stats_free_str(char** out) {
   return TILEDB_OK;
 }
 
+int32_t tiledb_stats_trace_enable() {
+  tiledb::sm::stats::Tracer::global().set_enabled(true);
+  return TILEDB_OK;
+}
+
+int32_t tiledb_stats_trace_disable() {
+  tiledb::sm::stats::Tracer::global().set_enabled(false);
+  return TILEDB_OK;
+}
+
+int32_t tiledb_stats_trace_reset() {
+  tiledb::sm::stats::Tracer::global().reset();
+  return TILEDB_OK;
+}
+
+int32_t tiledb_stats_trace_dump(FILE* out) {
+  tiledb::sm::stats::Tracer::global().dump(out == nullptr ? stdout : out);
+  return TILEDB_OK;
+}
+
+int32_t tiledb_stats_trace_dump_str(char** out) {
+  if (out == nullptr)
+    return TILEDB_ERR;
+
+  std::string str;
+  tiledb::sm::stats::Tracer::global().dump(&str);
+
+  *out = static_cast<char*>(std::malloc(str.size() + 1));
+  if (*out == nullptr)
+    return TILEDB_ERR;
+
+  std::memcpy(*out, str.data(), str.size());
+  (*out)[str.size()] = '\0';
+
+  return TILEDB_OK;
+}
+
 /* ****************************** */
 /*          Serialization         */
 /* ****************************** */
@@ -150,6 +150,38 @@ typedef enum {
 #undef TILEDB_VFS_MODE_ENUM
 } tiledb_vfs_mode_t;
 
+/** Query condition operator. */
+typedef enum {
+/** Helper macro for defining query condition operator enums. */
+#define TILEDB_QUERY_CONDITION_OP_ENUM(id) TILEDB_##id
+#include "tiledb_enum.h"
+#undef TILEDB_QUERY_CONDITION_OP_ENUM
+} tiledb_query_condition_op_t;
+
+/** Query condition combination operator. */
+typedef enum {
+/** Helper macro for defining query condition combination operator enums. */
+#define TILEDB_QUERY_CONDITION_COMBINATION_OP_ENUM(id) TILEDB_##id
+#include "tiledb_enum.h"
+#undef TILEDB_QUERY_CONDITION_COMBINATION_OP_ENUM
+} tiledb_query_condition_combination_op_t;
+
+/** Aggregate operator. */
+typedef enum {
+/** Helper macro for defining aggregate operator enums. */
+#define TILEDB_AGGREGATE_OP_ENUM(id) TILEDB_##id
+#include "tiledb_enum.h"
+#undef TILEDB_AGGREGATE_OP_ENUM
+} tiledb_aggregate_op_t;
+
+/** Query priority. */
+typedef enum {
+/** Helper macro for defining query priority enums. */
+#define TILEDB_QUERY_PRIORITY_ENUM(id) TILEDB_##id
+#include "tiledb_enum.h"
+#undef TILEDB_QUERY_PRIORITY_ENUM
+} tiledb_query_priority_t;
+
 /* ****************************** */
 /*       ENUMS TO/FROM STR        */
 /* ****************************** */
@@ -511,6 +543,9 @@ typedef struct tiledb_filter_list_t tiledb_filter_list_t;
 /** A TileDB query. */
 typedef struct tiledb_query_t tiledb_query_t;
 
+/** A TileDB query condition object. */
+typedef struct tiledb_query_condition_t tiledb_query_condition_t;
+
 /** A virtual filesystem object. */
 typedef struct tiledb_vfs_t tiledb_vfs_t;
 
@@ -914,6 +949,215 @@ TILEDB_EXPORT void tiledb_config_free(tiledb_config_t** config);
  * - `sm.tile_cache_size` <br>
  *    The tile cache size in bytes. Any `uint64_t` value is acceptable. <br>
  *    **Default**: 10,000,000
+ * - `sm.tile_cache_shards` <br>
+ *    The number of shards of the tile cache. Each shard is an independent LRU
+ *    cache with its own lock and an equal part of `sm.tile_cache_size`, and
+ *    each tile is assigned to a shard by a hash of its location, so that
+ *    concurrent readers rarely wait on each other. A tile larger than one shard
+ *    is not cached. `0` is treated as `1`. <br>
+ *    **Default**: 8
+ * - `sm.tile_cache_policy` <br>
+ *    The eviction and admission policy of the tile cache shards. `lru` evicts
+ *    the least recently used tile. `2q` first admits a new tile to a small FIFO
+ *    probation queue and promotes it to the main LRU list only if it is read
+ *    again after leaving the queue, so that a large one-off scan does not evict
+ *    the tiles used by other queries. Valid values: `lru`, `2q`. <br>
+ *    **Default**: lru
+ * - `sm.tile_cache_mode` <br>
+ *    The form in which the tile cache holds the tiles. `unfiltered` caches
+ *    decompressed tiles, which are copied as is on a hit. `filtered` caches
+ *    the compressed (persisted) bytes, which fit more tiles in
+ *    `sm.tile_cache_size` but are unfiltered again on every hit. `auto`
+ *    caches filtered tiles only for the attributes compressed with a fast
+ *    decompressor (i.e., other than gzip and bzip2). Valid values:
+ *    `unfiltered`, `filtered`, `auto`. <br>
+ *    **Default**: unfiltered
+ * - `sm.tile_disk_cache_dir` <br>
+ *    A local directory where the filtered tiles of arrays on remote storage
+ *    (e.g., S3) are cached as files, as a second tier behind the in-memory tile
+ *    cache. The directory is created if it does not exist. The cache is
+ *    disabled if this is empty. <br>
+ *    **Default**: ""
+ * - `sm.tile_disk_cache_size` <br>
+ *    The maximum total size in bytes of the on-disk tile cache. The least
+ *    recently used tiles are removed to stay under it. <br>
+ *    **Default**: 1073741824
+ * - `sm.read_prefetch` <br>
+ *    If `true`, an incomplete read query fetches and unfilters the tiles of its
+ *    next subarray partition in the background while the current results are
+ *    being consumed, so that the next submission finds them in the tile cache.
+ *    This has an effect only if `sm.tile_cache_size` is not zero. <br>
+ *    **Default**: false
+ * - `sm.read_planner` <br>
+ *    If `cost`, each read query chooses its strategy when it is
+ *    initialized, from the tile overlap of its subarray and its estimated
+ *    result sizes. A query condition uses the value indexes of a fragment
+ *    only if the condition tiles it may skip are larger than the index, and
+ *    otherwise the tile minimum and maximum values only. Prefetching and
+ *    `sm.partitioner.balanced_splits` are enabled only if the results are
+ *    estimated to span several partitions (balanced splits only for single
+ *    range subarrays), overriding their config values. The choices are
+ *    reported in the read statistics. `none` uses the config values. <br>
+ *    **Default**: none
+ * - `sm.eager_metadata_load` <br>
+ *    If `true`, opening or reopening an array for reads starts loading the
+ *    R-Trees of its fragments in the background, along with the tile offsets
+ *    of the dimensions and of the attributes read by earlier queries of the
+ *    context on the array (for recent fragments, only the page index and the
+ *    first page of the offsets). Queries wait only for the structures they
+ *    need, while the application sets them up. <br>
+ *    **Default**: false
+ * - `sm.partitioner.balanced_splits` <br>
+ *    If `true`, a read partition that does not fit the result buffers is
+ *    split on an MBR or space tile boundary, chosen to balance the estimated
+ *    results of the two halves, instead of at its midpoint. This avoids
+ *    fetching and unfiltering the same tile in consecutive partitions. <br>
+ *    **Default**: false
+ * - `sm.partition_tile_cache_ratio` <br>
+ *    The fraction of `sm.memory_budget` that a read query spends to keep
+ *    the tiles it unfiltered for a partition until its next partition has
+ *    run, so that the tiles shared by consecutive partitions of an
+ *    incomplete read are not read and unfiltered again. Unlike the tile
+ *    cache, this cache is private to the query. `0` disables it. <br>
+ *    **Default**: 0.1
+ * - `sm.write_async_flush` <br>
+ *    If `true`, each submission of a global order write filters and writes
+ *    its full tiles in the background and returns, so that the next
+ *    submission can be prepared meanwhile. A submission waits for the tiles
+ *    of the previous one to be written, and so does the finalization, which
+ *    reports any error of the last flush. <br>
+ *    **Default**: false
+ * - `sm.write_buffer.max_size` <br>
+ *    If not `0`, the unordered writes to sparse arrays are not written
+ *    right away, but their cells are buffered in memory per array across
+ *    queries of the context, and flushed as a single fragment once they
+ *    take this many bytes. The buffered cells of an array are also flushed
+ *    when the array is opened or reopened for reads with the context, so
+ *    that reads see the earlier writes, and when the context is freed.
+ *    Buffered cells are lost if the process exits before they are flushed,
+ *    and a buffered write reports errors such as duplicate coordinates only
+ *    when it is flushed. <br>
+ *    **Default**: 0
+ * - `sm.write_buffer.max_age_ms` <br>
+ *    If not `0`, a background service flushes the cells buffered for an
+ *    array (see `sm.write_buffer.max_size`) once the oldest of them has
+ *    been buffered for this many milliseconds. <br>
+ *    **Default**: 0
+ * - `sm.unordered_write_fragment_num` <br>
+ *    The maximum number of fragments an unordered write splits its sorted
+ *    cells into. The cells are split at space tile boundaries along the first
+ *    dimension of the tile order, so that the non-empty domains of the
+ *    fragments do not overlap, and the fragments are written in parallel.
+ *    Splitting requires all dimensions to have tile extents and no explicit
+ *    fragment URI. <br>
+ *    **Default**: 1
+ * - `sm.capacity_target_tile_size` <br>
+ *    If not `0`, each sparse write samples its filtered tiles and recommends
+ *    the capacity for which the largest filtered tiles would have this size
+ *    in bytes, e.g., 1-4MB for S3. The largest recommendation is reported by
+ *    the `writer_recommended_capacity` statistics counter. <br>
+ *    **Default**: 0
+ * - `sm.fragment_metadata_cache_size` <br>
+ *    The size in bytes of the process-wide cache of decoded array schemas and
+ *    fragment metadata, shared by all contexts, so that reopening an array
+ *    only reads the metadata of fragments it has not seen before. It is set
+ *    by the first context created in the process. `0` disables the cache.
+ *    Arrays that are encrypted are not cached. <br>
+ *    **Default**: 10,000,000
+ * - `sm.fragment_metadata_speculative_read_size` <br>
+ *    Fragment metadata files up to this size in bytes are fetched with a
+ *    single read when an array is opened, decoding the footer and the R-Tree
+ *    from the same buffer instead of issuing a request per section. `0`
+ *    disables the speculative read. <br>
+ *    **Default**: 65536
+ * - `sm.fragment_metadata_unfiltered` <br>
+ *    If `true`, the R-Tree, tile offsets and other sections of the metadata
+ *    of new fragments are stored uncompressed. With `vfs.file.enable_mmap`,
+ *    readers of local arrays then use them in place from the mapped file
+ *    instead of reading and decompressing them. <br>
+ *    **Default**: false
+ * - `sm.fragment_packing_max_size` <br>
+ *    If not `0`, new fragments whose filtered tiles take at most this many
+ *    bytes in total store the tiles of all their attributes and dimensions
+ *    in a single object, with the offset of each attribute file recorded in
+ *    the fragment metadata. A small write then creates one object instead
+ *    of one or two per attribute, and reading a tile of all attributes is a
+ *    single coalesced read. Global order writes are not packed. <br>
+ *    **Default**: 0
+ * - `sm.index_cache_size` <br>
+ *    The size in bytes of the cache of deserialized fragment R-Trees, shared
+ *    by all the arrays opened with the context and kept apart from the tile
+ *    cache, so that sparse reads do not deserialize the R-Trees again after
+ *    an array is reopened. `0` disables the cache. <br>
+ *    **Default**: 100,000,000
+ * - `sm.empty_subarray_cache_size` <br>
+ *    The number of subarrays in which sparse reads found no results that are
+ *    recorded per array opened for reads, so that repeating such a read
+ *    returns immediately until a new fragment is loaded. `0` disables the
+ *    records. <br>
+ *    **Default**: 0
+ * - `sm.var_offsets.bitsize` <br>
+ *    The width in bits (`32` or `64`) of the offsets that reads write to
+ *    the offsets buffers of var-sized attributes, and that writes read
+ *    from them. <br>
+ *    **Default**: 64
+ * - `sm.var_offsets.extra_element` <br>
+ *    If `true`, reads write one more offset after those of the result
+ *    cells, holding the end of the last cell, so that the offsets buffer
+ *    of `n` cells holds `n + 1` offsets as in Apache Arrow. Writes then
+ *    expect `n + 1` offsets too. <br>
+ *    **Default**: false
+ * - `sm.var_offsets.mode` <br>
+ *    The unit of the offsets of var-sized attributes for reads and writes:
+ *    `bytes`, or `elements` of the attribute datatype, as Apache Arrow list
+ *    offsets. <br>
+ *    **Default**: bytes
+ * - `sm.coords_bloom_filter_bits` <br>
+ *    The number of bits per cell of the bloom filter over the coordinates
+ *    that writes store with each new sparse fragment. Point reads skip the
+ *    fragments whose filter rejects the queried coordinates; `10` bits give
+ *    about 1% false positives. `0` stores no bloom filter. <br>
+ *    **Default**: 0
+ * - `sm.rtree_str_packing` <br>
+ *    If `true`, writes pack the R-Tree leaves of each new sparse fragment
+ *    with Sort-Tile-Recursive instead of grouping consecutive tiles, which
+ *    improves pruning when the tile MBRs are not spatially ordered. <br>
+ *    **Default**: false
+ * - `sm.fragment_sketches` <br>
+ *    If `true`, writes and consolidation store with each new fragment a
+ *    HyperLogLog distinct count sketch and a KLL quantile sketch of the
+ *    values of each numeric attribute with one value per cell, which
+ *    `tiledb_array_get_approx_distinct_count` and
+ *    `tiledb_array_get_approx_quantile` answer from. <br>
+ *    **Default**: false
+ * - `sm.value_index_attributes` <br>
+ *    The comma-separated names of attributes whose values writes and
+ *    consolidation index in each new fragment, as sorted (value, tile,
+ *    cell) entries. Read queries with a condition on an indexed attribute
+ *    then read only the tiles with cells satisfying it. Only numeric
+ *    attributes with one value per cell are indexed. <br>
+ *    **Default**: ""
+ * - `sm.array_manifest` <br>
+ *    If `true`, writes and consolidation keep a manifest file listing the
+ *    fragments of the array, and opening the array for reads gets the
+ *    fragments from it with a single request instead of listing the array
+ *    directory. All the writers of the array must enable it, and their
+ *    commits must not be concurrent across processes, as a manifest
+ *    update could otherwise miss a fragment. Writers then commit fragments
+ *    without locking the array, so they never wait for readers or for a
+ *    consolidation. <br>
+ *    **Default**: false
+ * - `sm.buffer_pool_size` <br>
+ *    The maximum number of bytes of freed tile buffers that are kept by a
+ *    process-wide pool, so that the buffers of later tiles of about the same
+ *    size reuse them instead of allocating new memory. Buffers of 64KB or
+ *    more are rounded up to the pool size classes (within 25%). The largest
+ *    size set by any context applies. `0` disables the pool. <br>
+ *    **Default**: 0
+ * - `sm.buffer_pool_huge_pages` <br>
+ *    If `true`, the pooled buffers of 2MB or more are backed by huge pages
+ *    where possible (Linux only). <br>
+ *    **Default**: false
  * - `sm.enable_signal_handlers` <br>
  *    Determines whether or not TileDB will install signal handlers. <br>
  *    **Default**: true
@@ -927,12 +1171,56 @@ TILEDB_EXPORT void tiledb_config_free(tiledb_config_t** config);
  *    The number of threads allocated for issuing writes to VFS in
  *    parallel.<br>
  *    **Default**: 1
+ * - `sm.num_fragment_metadata_threads` <br>
+ *    The number of threads allocated for loading the metadata of the
+ *    fragments of an array in parallel. `0` loads them on the TBB threads
+ *    (or serially if TBB is disabled). <br>
+ *    **Default**: 0
+ * - `sm.num_scheduler_threads` <br>
+ *    If non-zero, the reader, writer, async, fragment metadata and VFS
+ *    tasks of all contexts run on a single process-wide work-stealing
+ *    scheduler with this many threads (e.g., the number of cores), instead
+ *    of on per-context pools. The scheduler runs the tasks of high priority
+ *    queries first, then I/O tasks, then compute tasks, then tasks of low
+ *    priority queries and of the background consolidation. It is created
+ *    with the value of the first context that sets this parameter.
+ *    <br>
+ *    **Default**: 0
  * - `sm.num_tbb_threads` <br>
  *    The number of threads allocated for the TBB thread pool (if TBB is
  *    enabled). Note: this is a whole-program setting. Usually this should not
  *    be modified from the default. See also the documentation for TBB's
  *    `task_scheduler_init` class.<br>
  *    **Default**: TBB automatic
+ * - `sm.numa_pinning` <br>
+ *    If `true`, every worker of the thread pools of the context (or of the
+ *    process-wide scheduler) and of TBB is pinned to the CPUs of one NUMA
+ *    node, the workers being spread round robin over the nodes. Memory is
+ *    placed on the node of the thread that first writes it, so the tile
+ *    buffers a worker fills, e.g., when unfiltering, stay local to it. Linux
+ *    only. <br>
+ *    **Default**: false
+ * - `sm.stats.sample_rate` <br>
+ *    The fraction of the queries, drawn at random when they are created,
+ *    that gather their own stats (see `tiledb_query_get_stats`) while the
+ *    global stats are disabled. Only the sampled queries pay for gathering
+ *    stats. <br>
+ *    **Default**: 0.0
+ * - `sm.stats.sample_traces` <br>
+ *    If `true`, the calls of the sampled queries are also recorded in the
+ *    trace (see `tiledb_stats_trace_dump`) while tracing is disabled. <br>
+ *    **Default**: false
+ * - `sm.stats.slow_query_threshold_ms` <br>
+ *    If non-zero, every query submission whose processing takes at least
+ *    that many milliseconds is appended to the slow query log as a JSON
+ *    line with the array, type, status and latency of the query, and its
+ *    stats if it gathers them (i.e., if stats are enabled or its stats
+ *    are sampled). <br>
+ *    **Default**: 0
+ * - `sm.stats.slow_query_log` <br>
+ *    The file the slow query log is appended to, or standard error if
+ *    empty. <br>
+ *    **Default**: ""
  * - `sm.consolidation.amplification` <br>
  *    The factor by which the size of the dense fragment resulting
  *    from consolidating a set of fragments (containing at least one
@@ -960,6 +1248,85 @@ TILEDB_EXPORT void tiledb_config_free(tiledb_config_t** config);
  *    The size ratio that two ("adjacent") fragments must satisfy to be
  *    considered for consolidation in a single step.<br>
  *    **Default**: 0.0
+ * - `sm.consolidation.tile_copy` <br>
+ *    If `true`, fragments that do not overlap in the global order (and
+ *    whose tiles line up) are consolidated by copying their filtered tiles
+ *    instead of decoding and re-encoding their cells. Overlapping dense
+ *    fragments are consolidated by rewriting only the space tiles that
+ *    more than one of them covers, if those are at most half. <br>
+ *    **Default**: true
+ * - `sm.consolidation.timestamp_start` <br>
+ *    Only the fragments whose timestamp range intersects
+ *    `[timestamp_start, timestamp_end]` are consolidated, which leaves
+ *    older (cold) fragments untouched. <br>
+ *    **Default**: 0
+ * - `sm.consolidation.timestamp_end` <br>
+ *    See `sm.consolidation.timestamp_start`. <br>
+ *    **Default**: UINT64_MAX
+ * - `sm.consolidation.subarray` <br>
+ *    If set, only the fragments whose non-empty domain intersects this
+ *    subarray are consolidated. It is given as comma-separated low and
+ *    high bounds per dimension, e.g., `"1,10,5,20"`. <br>
+ *    **Default**: ""
+ * - `sm.consolidation.memory_budget` <br>
+ *    If it can hold the buffers of several consolidation steps (two sets
+ *    of `sm.consolidation.buffer_size` buffers each), the steps over
+ *    disjoint sets of fragments run concurrently within this budget.
+ *    `0` runs one step at a time. <br>
+ *    **Default**: 0
+ * - `sm.consolidation.planner` <br>
+ *    How each consolidation step picks its fragments among the eligible
+ *    sets. `size_ratio` picks the largest set with the smallest size.
+ *    `cost` estimates the read cost each set saves (fragments no longer
+ *    opened plus overwritten cells no longer read, weighted by the ratio
+ *    of read to write queries when statistics are enabled) and picks the
+ *    set with the best benefit per byte written, provided it saves at
+ *    least as many bytes as it writes. <br>
+ *    **Default**: size_ratio
+ * - `sm.consolidation.planner_fragment_cost` <br>
+ *    The read cost of opening a fragment in bytes, used by the `cost`
+ *    planner. <br>
+ *    **Default**: 1048576
+ * - `sm.consolidation.dry_run` <br>
+ *    If `true`, consolidation prints to stdout the sets of fragments it
+ *    would consolidate next, with their sizes and estimated benefit,
+ *    without consolidating them. <br>
+ *    **Default**: false
+ * - `sm.consolidation.deferred_vacuum` <br>
+ *    If `true`, consolidation does not delete the fragments it supersedes.
+ *    It lists them in a vacuum file next to the new fragment, readers
+ *    ignore them, and `tiledb_array_vacuum` (or the background
+ *    consolidation service) deletes them later in a batch. <br>
+ *    **Default**: false
+ * - `sm.consolidation.pyramid_levels` <br>
+ *    If non-zero, consolidating a dense array also rebuilds that many
+ *    levels of its pyramid, each halving the resolution of the previous
+ *    one along every dimension, which read queries select with
+ *    `tiledb_query_set_resolution_level`. The levels hold the fixed-sized
+ *    attributes and are snapshots of the array at consolidation. <br>
+ *    **Default**: 0
+ * - `sm.consolidation.pyramid_method` <br>
+ *    How a cell of a pyramid level is computed from the cells it covers in
+ *    the previous level: `mean`, `max` or `nearest` (the first cell).
+ *    Attributes that are not numeric with one value per cell use
+ *    `nearest`. <br>
+ *    **Default**: mean
+ * - `sm.consolidation.auto_interval_ms` <br>
+ *    If non-zero, a background service consolidates the arrays opened for
+ *    writes with the context, visiting one array every that many
+ *    milliseconds. Each visit runs a single consolidation step following
+ *    the other `sm.consolidation.*` parameters, if the array has at least
+ *    `sm.consolidation.auto_fragment_num` fragments and no query is in
+ *    progress and the array is not open for reads. <br>
+ *    **Default**: 0
+ * - `sm.consolidation.auto_fragment_num` <br>
+ *    The number of fragments at which the background consolidation service
+ *    consolidates an array. <br>
+ *    **Default**: 16
+ * - `sm.consolidation.auto_array_metadata_num` <br>
+ *    The number of array metadata files at which closing an array for
+ *    writes consolidates them into one. `0` disables it. <br>
+ *    **Default**: 64
  * - `sm.memory_budget` <br>
  *    The memory budget for tiles of fixed-sized attributes (or offsets for
  *    var-sized attributes) to be fetched during reads.<br>
@@ -980,9 +1347,35 @@ TILEDB_EXPORT void tiledb_config_free(tiledb_config_t** config);
  * - `vfs.min_batch_size` <br>
  *    The minimum number of bytes in a VFS read operation<br>
  *    **Default**: 20MB
+ * - `vfs.write_behind_buffer_size` <br>
+ *    If not zero, writes to local and HDFS files are buffered per file and
+ *    flushed in chunks of this many bytes on the VFS thread pool, while the
+ *    caller keeps producing data. Up to `vfs.file.max_parallel_ops` chunks of a
+ *    local file are flushed concurrently (one for HDFS). Closing the file waits
+ *    for all its flushes, and flush errors are reported by the next write or by
+ *    the close. `0` disables write-behind buffering. <br>
+ *    **Default**: 0
+ * - `vfs.emulated_latency_ms` <br>
+ *    If not zero, every VFS request (read, write, listing or metadata lookup)
+ *    on any backend is delayed by this many milliseconds, emulating the
+ *    round trip of an object store on local files. Meant for benchmarking.
+ *    <br>
+ *    **Default**: 0
+ * - `vfs.emulated_bandwidth` <br>
+ *    If not zero, every VFS read and write is further delayed as if its data
+ *    were transferred at this many bytes per second. Meant for benchmarking,
+ *    together with `vfs.emulated_latency_ms`. <br>
+ *    **Default**: 0
  * - `vfs.min_batch_gap` <br>
  *    The minimum number of bytes between two VFS read batches.<br>
  *    **Default**: 500KB
+ * - `vfs.adaptive_batch_gap` <br>
+ *    If `true`, read batching measures the latency and bandwidth of each
+ *    backend and merges two regions whenever reading the gap between them is
+ *    cheaper than issuing a separate request. `vfs.min_batch_gap` and
+ *    `vfs.min_batch_size` are used until enough reads have been observed, and
+ *    `vfs.min_batch_size` caps the estimated gap. <br>
+ *    **Default**: false
  * - `vfs.file.max_parallel_ops` <br>
  *    The maximum number of parallel operations on objects with `file:///`
  *    URIs. <br>
@@ -991,6 +1384,34 @@ TILEDB_EXPORT void tiledb_config_free(tiledb_config_t** config);
  *    If set to `false`, file locking operations are no-ops for `file:///` URIs
  *    in VFS. <br>
  *    **Default**: `true`
+ * - `vfs.file.enable_read_filelocks` <br>
+ *    If set to `false`, opening an array for reads does not take a shared
+ *    filelock, relying on fragments being immutable instead. Consolidation
+ *    and vacuuming still lock the array exclusively, but they no longer wait
+ *    for readers in other processes. <br>
+ *    **Default**: `true`
+ * - `vfs.file.io_engine` <br>
+ *    The engine used for batched reads of `file:///` URIs. `pread` issues one
+ *    positional read per region; `io_uring` submits all regions of a batch to
+ *    the kernel at once (Linux only); `overlapped` keeps several asynchronous
+ *    reads in flight through an I/O completion port (Windows only). If the
+ *    engine is not available, TileDB falls back to `pread`. <br>
+ *    **Default**: pread
+ * - `vfs.file.enable_mmap` <br>
+ *    If set to `true`, tiles of `file:///` URIs are memory-mapped instead of
+ *    being read into heap buffers. Tiles with an empty filter pipeline are then
+ *    used directly from the mapped pages, without any copy. <br>
+ *    **Default**: false
+ * - `vfs.file.direct_io` <br>
+ *    If `true`, local file reads and writes use direct I/O (`O_DIRECT`, or
+ *    `FILE_FLAG_NO_BUFFERING` on Windows) through aligned staging buffers, so
+ *    that large scans do not evict other data from the operating system page
+ *    cache. Read batching also merges regions that share a disk block.
+ *    Filesystems that do not support direct I/O fall back to buffered access.
+ *    The `io_uring` engine is not used with direct I/O; the `overlapped`
+ *    engine reads without buffering when all regions of a batch are
+ *    aligned. <br>
+ *    **Default**: false
  * - `vfs.s3.region` <br>
  *    The S3 region, if S3 is enabled. <br>
  *    **Default**: us-east-1
@@ -1026,6 +1447,32 @@ TILEDB_EXPORT void tiledb_config_free(tiledb_config_t** config);
  *    vfs.s3.max_parallel_ops` bytes will be buffered before issuing multipart
  *    uploads in parallel. <br>
  *    **Default**: 5MB
+ * - `vfs.s3.max_buffer_size` <br>
+ *    The maximum number of bytes buffered across all the objects being
+ *    written with multipart uploads, e.g., the attribute files of a fragment.
+ *    When a write exceeds it, the whole parts buffered for its object are
+ *    uploaded right away, and the write waits for them. If `0`, each object
+ *    buffers up to `vfs.s3.multipart_part_size * vfs.s3.max_parallel_ops`
+ *    bytes. <br>
+ *    **Default**: 0
+ * - `vfs.s3.read_part_size` <br>
+ *    The part size (in bytes) used to split large S3 reads into concurrent
+ *    range GETs, which are issued in parallel on the VFS thread pool and
+ *    assembled in place. If `0`, S3 reads are split like any other read,
+ *    according to `vfs.min_parallel_size` and `vfs.s3.max_parallel_ops`. <br>
+ *    **Default**: 0
+ * - `vfs.s3.hedge_percentile` <br>
+ *    If not `0`, an S3 range GET that has not completed within this
+ *    percentile (e.g., `95`) of the latencies of the recent GETs is hedged:
+ *    a duplicate GET is issued and the first response is used. This cuts
+ *    the tail latency of the reads, which a few straggler GETs determine.
+ *    The GETs of the reads then run on a dedicated thread pool. <br>
+ *    **Default**: 0.0
+ * - `vfs.s3.hedge_max_ratio` <br>
+ *    The maximum ratio of the S3 reads that are hedged (see
+ *    `vfs.s3.hedge_percentile`), which bounds the cost of the duplicate
+ *    GETs. <br>
+ *    **Default**: 0.05
  * - `vfs.s3.ca_file` <br>
  *    Path to SSL/TLS certificate file to be used by cURL for for S3 HTTPS
  *    encryption. Follows cURL conventions:
@@ -1083,6 +1530,23 @@ TILEDB_EXPORT void tiledb_config_free(tiledb_config_t** config);
  * - `vfs.hdfs.kerb_ticket_cache_path` <br>
  *    HDFS kerb ticket cache path. <br>
  *    **Default**: ""
+ * - `vfs.hdfs.max_parallel_ops` <br>
+ *    The maximum number of parallel operations on objects with `hdfs://`
+ *    URIs. <br>
+ *    **Default**: `vfs.num_threads`
+ * - `vfs.hdfs.short_circuit_read` <br>
+ *    If `true`, blocks stored on the local datanode are read directly from
+ *    disk, bypassing the datanode (`dfs.client.read.shortcircuit`). <br>
+ *    **Default**: false
+ * - `vfs.hdfs.domain_socket_path` <br>
+ *    The UNIX domain socket shared with the local datanode for short-circuit
+ *    reads (`dfs.domain.socket.path`). <br>
+ *    **Default**: ""
+ * - `vfs.hdfs.zero_copy_read` <br>
+ *    If `true`, reads are first attempted as zero-copy reads of memory-mapped
+ *    blocks (cached or short-circuited), falling back to regular reads when
+ *    unavailable. <br>
+ *    **Default**: false
  *
  * <br>
  *
@@ -1093,6 +1557,15 @@ TILEDB_EXPORT void tiledb_config_free(tiledb_config_t** config);
  *    Serialization format to use for remote array requests (CAPNP or
  *    JSON). <br>
  *    **Default**: "CAPNP"
+ * - `rest.http_compressor` <br>
+ *    The encodings accepted for the REST server responses, as a
+ *    comma-separated list (e.g. "zstd,gzip"), "any" for all the encodings
+ *    supported by libcurl, or "none". <br>
+ *    **Default**: "any"
+ * - `rest.http_request_compressor` <br>
+ *    The encoding of the request bodies sent to the REST server ("none",
+ *    "gzip" or "zstd"). The bodies are compressed as they are sent. <br>
+ *    **Default**: "none"
  * - `rest.username` <br>
  *    Username for login to REST server (a token can be used instead). <br>
  *    **Default**: ""
@@ -1107,6 +1580,29 @@ TILEDB_EXPORT void tiledb_config_free(tiledb_config_t** config);
  *    If true, incomplete queries received from server are automatically
  *    resubmitted before returning to user control. <br>
  *    **Default**: "true"
+ * - `rest.stream_incomplete` <br>
+ *    If true, the server pushes all the results of a read query in one
+ *    streamed response. When the user buffers are full, the response is
+ *    paused and the query returns incomplete; its next submission resumes
+ *    the response instead of sending a new request. <br>
+ *    **Default**: "false"
+ * - `rest.cache_ttl_ms` <br>
+ *    The time in milliseconds for which the array schemas and non-empty
+ *    domains received from the REST server are reused by later requests of
+ *    the same context. They are dropped earlier when the context creates the
+ *    array, writes to it or deregisters it. 0 disables the cache. <br>
+ *    **Default**: "0"
+ * - `rest.read_partition_num` <br>
+ *    The number of partitions a remote read query with a single range per
+ *    dimension is split into, along its slowest varying dimension. The
+ *    partitions are submitted to the REST server concurrently, each into
+ *    its own scratch buffers sized from the max buffer size estimates, and
+ *    their results are concatenated into the user buffers in the query
+ *    layout. Reads in global order or on real domains are not split. If a
+ *    partition does not complete, or the results do not fit in the user
+ *    buffers, the query is submitted whole instead. 1 disables splitting.
+ *    <br>
+ *    **Default**: "1"
  * - `rest.ignore_ssl_validation` <br>
  *    Have curl ignore ssl peer and host validation for REST server. <br>
  *    **Default**: false
@@ -1476,6 +1972,44 @@ TILEDB_EXPORT int32_t tiledb_ctx_is_supported_fs(
  */
 TILEDB_EXPORT int32_t tiledb_ctx_cancel_tasks(tiledb_ctx_t* ctx);
 
+/**
+ * Harvests the completions of the queries submitted with
+ * `tiledb_query_submit_async_tagged` on the given context. Each completion
+ * is the tag its query was submitted with, and completions are returned in
+ * the order the queries finished processing. The status of each query is
+ * final once its tag is returned, and should be checked with
+ * `tiledb_query_get_status`.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * void* tags[16];
+ * uint32_t num_tags;
+ * tiledb_ctx_poll_completions(ctx, tags, 16, 100, &num_tags);
+ * for (uint32_t i = 0; i < num_tags; ++i) {
+ *   tiledb_query_t* query = (tiledb_query_t*)tags[i];
+ *   // Handle the query
+ * }
+ * @endcode
+ *
+ * @param ctx The TileDB context.
+ * @param tags Set to the harvested tags. It must have room for
+ *     `max_completions` tags.
+ * @param max_completions The maximum number of completions to harvest.
+ * @param timeout_ms If no completion is pending, the number of milliseconds
+ *     to wait for one; `0` does not wait and a negative value waits
+ *     indefinitely.
+ * @param num_completions Set to the number of harvested completions, `0` if
+ *     the timeout expired.
+ * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ */
+TILEDB_EXPORT int32_t tiledb_ctx_poll_completions(
+    tiledb_ctx_t* ctx,
+    void** tags,
+    uint32_t max_completions,
+    int32_t timeout_ms,
+    uint32_t* num_completions);
+
 /**
  * Sets a string key-value "tag" on the given context.
  *
@@ -1493,6 +2027,62 @@ TILEDB_EXPORT int32_t tiledb_ctx_cancel_tasks(tiledb_ctx_t* ctx);
 TILEDB_EXPORT int32_t
 tiledb_ctx_set_tag(tiledb_ctx_t* ctx, const char* key, const char* value);
 
+/**
+ * Pre-opens the connections of the context to the storage backend of the
+ * given URI, so that the first queries do not pay for connection setup.
+ * For S3, this opens `vfs.s3.max_parallel_ops` connections to the bucket
+ * of the URI. This is a no-op for other backends.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * tiledb_ctx_warm_up(ctx, "s3://my_bucket");
+ * @endcode
+ *
+ * @param ctx The TileDB context.
+ * @param uri A URI in the bucket to connect to.
+ * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ */
+TILEDB_EXPORT int32_t tiledb_ctx_warm_up(tiledb_ctx_t* ctx, const char* uri);
+
+/**
+ * Retrieves the memory held by the context as a JSON object, with the bytes
+ * of each component:
+ *
+ * - `tileCache`: the tile cache (see `sm.tile_cache_size`).
+ * - `indexCache`: the index cache (see `sm.index_cache_size`).
+ * - `metadata`: the loaded fragment metadata (R-Trees, tile offsets, etc.)
+ *   and array metadata of the arrays open for reads, whose number is
+ *   `openArrays`. The R-Trees shared with the index cache are counted in
+ *   both.
+ * - `writeBuffer`: the buffered unordered writes (see
+ *   `sm.write_buffer.max_size`).
+ * - `vfsWriteBuffers`: the bytes written but not flushed yet to S3.
+ *
+ * It also holds the number of queries in progress (`queriesInProgress`),
+ * and, under `process`, the memory shared by all contexts: the buffers in
+ * use (`buffersInUse`), such as the tiles of the queries in progress and
+ * the cached tiles, the freed buffers kept by the buffer pool
+ * (`bufferPoolCached`, see `sm.buffer_pool_size`) and the fragment metadata
+ * cache (`fragmentMetadataCache`). The string must be freed with
+ * `tiledb_stats_free_str`.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * char* json;
+ * tiledb_ctx_get_memory_usage(ctx, &json);
+ * // ...
+ * tiledb_stats_free_str(&json);
+ * @endcode
+ *
+ * @param ctx The TileDB context.
+ * @param json Set to an allocated string with the memory usage.
+ * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ */
+TILEDB_EXPORT int32_t
+tiledb_ctx_get_memory_usage(tiledb_ctx_t* ctx, char** json);
+
 /* ********************************* */
 /*                GROUP              */
 /* ********************************* */
@@ -1693,7 +2283,9 @@ TILEDB_EXPORT int32_t tiledb_filter_list_add_filter(
     tiledb_filter_t* filter);
 
 /**
- * Sets the maximum tile chunk size for a filter list.
+ * Sets the maximum tile chunk size for a filter list. A max chunk size of 0
+ * selects the chunk size of each tile automatically, from the tile size, the
+ * number of threads and the compressor of the filter list.
  *
  * **Example:**
  *
@@ -2408,7 +3000,8 @@ TILEDB_EXPORT int32_t tiledb_array_schema_set_capacity(
     tiledb_ctx_t* ctx, tiledb_array_schema_t* array_schema, uint64_t capacity);
 
 /**
- * Sets the cell order.
+ * Sets the cell order. Sparse arrays may also use `TILEDB_HILBERT`, which
+ * orders the cells of each space tile along a Hilbert curve.
  *
  * **Example:**
  *
@@ -2445,6 +3038,29 @@ TILEDB_EXPORT int32_t tiledb_array_schema_set_tile_order(
     tiledb_array_schema_t* array_schema,
     tiledb_layout_t tile_order);
 
+/**
+ * Sets whether the tiles with the same index of all attributes and
+ * dimensions of each fragment are stored contiguously in a single file,
+ * rather than in one file per attribute/dimension. This lets queries that
+ * read many attributes of few cells fetch each tile of all attributes with
+ * a single request. It is disabled by default.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * tiledb_array_schema_set_tile_colocation(ctx, array_schema, 1);
+ * @endcode
+ *
+ * @param ctx The TileDB context.
+ * @param array_schema The array schema.
+ * @param tile_colocation `1` to co-locate the tiles, `0` otherwise.
+ * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ */
+TILEDB_EXPORT int32_t tiledb_array_schema_set_tile_colocation(
+    tiledb_ctx_t* ctx,
+    tiledb_array_schema_t* array_schema,
+    int32_t tile_colocation);
+
 /**
  * Sets the filter list to use for the coordinates.
  *
@@ -2707,6 +3323,28 @@ TILEDB_EXPORT int32_t tiledb_array_schema_get_tile_order(
     const tiledb_array_schema_t* array_schema,
     tiledb_layout_t* tile_order);
 
+/**
+ * Retrieves whether the tiles of each fragment are co-located (see
+ * `tiledb_array_schema_set_tile_colocation`).
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * int32_t tile_colocation;
+ * tiledb_array_schema_get_tile_colocation(ctx, array_schema, &tile_colocation);
+ * @endcode
+ *
+ * @param ctx The TileDB context.
+ * @param array_schema The array schema.
+ * @param tile_colocation Set to `1` if the tiles are co-located, `0`
+ *     otherwise.
+ * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ */
+TILEDB_EXPORT int32_t tiledb_array_schema_get_tile_colocation(
+    tiledb_ctx_t* ctx,
+    const tiledb_array_schema_t* array_schema,
+    int32_t* tile_colocation);
+
 /**
  * Retrieves the number of array attributes.
  *
@@ -3036,6 +3674,36 @@ TILEDB_EXPORT int32_t tiledb_query_get_buffer_var(
     void** buffer_val,
     uint64_t** buffer_val_size);
 
+/**
+ * Makes a read query allocate the result buffers of an attribute itself,
+ * instead of using buffers set with `tiledb_query_set_buffer`. The buffers
+ * grow to fit the results of each partition of the subarray, up to
+ * `sm.memory_budget` (`sm.memory_budget_var` for var-sized values), so
+ * that the query does not split partitions to fit small buffers. After
+ * each submission, `tiledb_query_get_buffer` or
+ * `tiledb_query_get_buffer_var` return the buffers and result sizes
+ * without a copy. They stay valid until the next submission or until the
+ * query is freed.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * tiledb_query_set_managed_buffer(ctx, query, "a1");
+ * tiledb_query_submit(ctx, query);
+ * int* a1;
+ * uint64_t* a1_size;
+ * tiledb_query_get_buffer(ctx, query, "a1", (void**)&a1, &a1_size);
+ * @endcode
+ *
+ * @param ctx The TileDB context.
+ * @param query The TileDB read query.
+ * @param attribute The attribute to allocate the buffers of. Note that the
+ *     coordinates have special attribute name `TILEDB_COORDS`.
+ * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ */
+TILEDB_EXPORT int32_t tiledb_query_set_managed_buffer(
+    tiledb_ctx_t* ctx, tiledb_query_t* query, const char* attribute);
+
 /**
  * Sets the layout of the cells to be written or read.
  *
@@ -3069,148 +3737,585 @@ TILEDB_EXPORT int32_t tiledb_query_set_layout(
     tiledb_ctx_t* ctx, tiledb_query_t* query, tiledb_layout_t layout);
 
 /**
- * Flushes all internal state of a query object and finalizes the query.
- * This is applicable only to global layout writes. It has no effect for
- * any other query type.
+ * Sets the condition that the result cells of a read query must satisfy.
+ * The condition is evaluated inside the read, so that only the cells
+ * satisfying it are copied to the result buffers. The query keeps its own
+ * copy of the condition, which may be freed afterwards.
  *
  * **Example:**
  *
  * @code{.c}
- * tiledb_query_t* query;
- * // ... Your code here ... //
- * tiledb_query_finalize(ctx, query);
+ * tiledb_query_condition_t* cond;
+ * tiledb_query_condition_alloc(ctx, &cond);
+ * int value = 5;
+ * tiledb_query_condition_init(ctx, cond, "a1", &value, sizeof(int),
+ *     TILEDB_GT);
+ * tiledb_query_set_condition(ctx, query, cond);
+ * tiledb_query_condition_free(&cond);
  * @endcode
  *
  * @param ctx The TileDB context.
- * @param query The query object to be flushed.
+ * @param query The TileDB read query.
+ * @param cond The query condition.
  * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ *
+ * @note Dense reads (not in sparse mode) with a query condition cannot
+ *     retrieve the coordinates.
  */
-TILEDB_EXPORT int32_t
-tiledb_query_finalize(tiledb_ctx_t* ctx, tiledb_query_t* query);
+TILEDB_EXPORT int32_t tiledb_query_set_condition(
+    tiledb_ctx_t* ctx,
+    tiledb_query_t* query,
+    const tiledb_query_condition_t* cond);
 
 /**
- * Frees a TileDB query object.
+ * Adds an aggregate over an attribute to a read query. A query with
+ * aggregates computes them over all its result cells in a single
+ * submission, instead of copying the cells to result buffers, and writes
+ * the results when it completes. The tiles whose cells are all results
+ * are aggregated from the statistics stored in the fragment metadata,
+ * without being read, where possible.
+ *
+ * The result of `TILEDB_AGGREGATE_COUNT` is a `uint64_t`. The result of
+ * `TILEDB_AGGREGATE_SUM` is an `int64_t` for signed integer and datetime
+ * attributes, a `uint64_t` for unsigned integer attributes and a `double`
+ * for floating point attributes. The results of `TILEDB_AGGREGATE_MIN` and
+ * `TILEDB_AGGREGATE_MAX` have the attribute type, ignore NaN values and are
+ * not written if there is no value to aggregate.
  *
  * **Example:**
  *
  * @code{.c}
- * tiledb_query_free(&query);
+ * int64_t sum;
+ * uint64_t count;
+ * tiledb_query_add_aggregate(ctx, query, "a1", TILEDB_AGGREGATE_SUM, &sum);
+ * tiledb_query_add_aggregate(
+ *     ctx, query, "a1", TILEDB_AGGREGATE_COUNT, &count);
+ * tiledb_query_submit(ctx, query);
  * @endcode
  *
- * @param query The query object to be deleted.
+ * @param ctx The TileDB context.
+ * @param query The TileDB read query.
+ * @param attribute_name The aggregated attribute. It must be numeric with
+ *     a single fixed-sized value per cell, unless the operator is
+ *     `TILEDB_AGGREGATE_COUNT`.
+ * @param op The aggregate operator.
+ * @param result The location the result is written to.
+ * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ *
+ * @note A query with aggregates cannot set result buffers, and the
+ *     aggregates wrap around on integer overflow.
  */
-TILEDB_EXPORT void tiledb_query_free(tiledb_query_t** query);
+TILEDB_EXPORT int32_t tiledb_query_add_aggregate(
+    tiledb_ctx_t* ctx,
+    tiledb_query_t* query,
+    const char* attribute_name,
+    tiledb_aggregate_op_t op,
+    void* result);
 
 /**
- * Submits a TileDB query.
+ * Sets the maximum number of result cells a read query on a sparse array
+ * returns over all its submissions. Once the query has returned `limit`
+ * cells it is completed, and it computes and reads only what is needed for
+ * those cells where possible, e.g., it stops merging the fragments of
+ * global order reads after `limit` cells. With a query condition, the limit
+ * applies to the cells satisfying the condition.
  *
  * **Example:**
  *
  * @code{.c}
+ * // Get the first 100 cells of the subarray
+ * tiledb_query_set_limit(ctx, query, 100);
  * tiledb_query_submit(ctx, query);
  * @endcode
  *
  * @param ctx The TileDB context.
- * @param query The query to be submitted.
+ * @param query The TileDB read query.
+ * @param limit The maximum number of result cells.
  * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
  *
- * @note `tiledb_query_finalize` must be invoked after finish writing in
- *     global layout (via repeated invocations of `tiledb_query_submit`),
- *     in order to flush any internal state.
- *
- * @note For the case of reads, if the returned status is `TILEDB_INCOMPLETE`,
- *    TileDB could not fit the entire result in the user's buffers. In this
- *    case, the user should consume the read results (if any), optionally
- *    reset the buffers with `tiledb_query_set_buffer`, and then resubmit the
- *    query until the status becomes `TILEDB_COMPLETED`. If all buffer sizes
- *    after the termination of this function become 0, then this means that
- *    **no** useful data was read into the buffers, implying that larger
- *    buffers are needed for the query to proceed. In this case, the users
- *    must reallocate their buffers (increasing their size), reset the buffers
- *    with `tiledb_query_set_buffer`, and resubmit the query.
+ * @note A query with aggregates cannot set a limit.
  */
-TILEDB_EXPORT int32_t
-tiledb_query_submit(tiledb_ctx_t* ctx, tiledb_query_t* query);
+TILEDB_EXPORT int32_t tiledb_query_set_limit(
+    tiledb_ctx_t* ctx, tiledb_query_t* query, uint64_t limit);
 
 /**
- * Submits a TileDB query in asynchronous mode.
- *
- * **Examples:**
+ * Sets the wall-clock budget of each submission of a read query. Once
+ * reading the next partition of the subarray would exceed it, judging by
+ * the time the previous partition took, the submission stops and returns
+ * the results it has, possibly none, with status `TILEDB_INCOMPLETE`.
+ * Resubmitting the query resumes from where it stopped.
  *
- * Submit without a callback.
+ * **Example:**
  *
  * @code{.c}
- * tiledb_query_submit_async(ctx, query, NULL, NULL);
+ * // Return within about 50 ms
+ * tiledb_query_set_deadline(ctx, query, 50);
+ * tiledb_query_submit(ctx, query);
  * @endcode
  *
- * Submit with a callback function `print` that takes as input message
- * `msg` and prints it upon completion of the query.
+ * @param ctx The TileDB context.
+ * @param query The TileDB read query.
+ * @param deadline_ms The budget of a submission in milliseconds, `0` for
+ *     none.
+ * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ *
+ * @note A submission reads at least one partition, which is not
+ *     interrupted, so it may still exceed the budget.
+ */
+TILEDB_EXPORT int32_t tiledb_query_set_deadline(
+    tiledb_ctx_t* ctx, tiledb_query_t* query, uint64_t deadline_ms);
+
+/**
+ * Makes a read query on a sparse array read a random sample of the tiles
+ * overlapping its subarray, for approximate answers over large arrays.
+ * Each tile of each fragment is kept with probability `fraction`, and only
+ * the kept tiles are read and unfiltered; the query returns all the
+ * results within them. The same `seed` selects the same tiles. The actual
+ * ratio of the cells sampled is given by `tiledb_query_get_sample_ratio`.
+ *
+ * **Example:**
  *
  * @code{.c}
- * const char* msg = "Query completed";
- * tiledb_query_submit_async(ctx, &query, foo, msg);
+ * // Count the cells in about 1% of the tiles
+ * tiledb_query_set_sample(ctx, query, 0.01, 42);
+ * tiledb_query_add_aggregate(
+ *     ctx, query, "a", TILEDB_AGGREGATE_COUNT, &count);
+ * tiledb_query_submit(ctx, query);
+ * double ratio;
+ * tiledb_query_get_sample_ratio(ctx, query, &ratio);
  * @endcode
  *
  * @param ctx The TileDB context.
- * @param query The query to be submitted.
- * @param callback The function to be called when the query completes.
- * @param callback_data The data to be passed to the callback function.
- * @return `TILEDB_OK` for success and `TILEDB_OOM` or `TILEDB_ERR` for error.
- *
- * @note `tiledb_query_finalize` must be invoked after finish writing in
- *     global layout (via repeated invocations of `tiledb_query_submit`),
- *     in order to flush any internal state.
+ * @param query The TileDB read query.
+ * @param fraction The probability of a tile to be read, in `(0, 1]`.
+ * @param seed The seed of the sample.
+ * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
  *
- * @note For the case of reads, if the returned status is `TILEDB_INCOMPLETE`,
- *    TileDB could not fit the entire result in the user's buffers. In this
- *    case, the user should consume the read results (if any), optionally
- *    reset the buffers with `tiledb_query_set_buffer`, and then resubmit the
- *    query until the status becomes `TILEDB_COMPLETED`. If all buffer sizes
- *    after the termination of this function become 0, then this means that
- *    **no** useful data was read into the buffers, implying that larger
- *    buffers are needed for the query to proceed. In this case, the users
- *    must reallocate their buffers (increasing their size), reset the buffers
- *    with `tiledb_query_set_buffer`, and resubmit the query.
+ * @note Cells that a skipped tile of a newer fragment would overwrite may
+ *     be returned from an older fragment.
  */
-TILEDB_EXPORT int32_t tiledb_query_submit_async(
+TILEDB_EXPORT int32_t tiledb_query_set_sample(
     tiledb_ctx_t* ctx,
     tiledb_query_t* query,
-    void (*callback)(void*),
-    void* callback_data);
+    double fraction,
+    uint64_t seed);
 
 /**
- * Checks if the query has returned any results. Applicable only to
- * read queries; it sets `has_results` to `0 in the case of writes.
+ * Retrieves the ratio of the cells in the tiles a sampled read query has
+ * read so far over the cells in all the tiles overlapping its subarray.
+ * Dividing a count over the sample by it estimates the count over the
+ * whole subarray. It is `1` for queries that are not sampled.
+ *
+ * @param ctx The TileDB context.
+ * @param query The TileDB read query.
+ * @param ratio The ratio to be retrieved.
+ * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ */
+TILEDB_EXPORT int32_t tiledb_query_get_sample_ratio(
+    tiledb_ctx_t* ctx, tiledb_query_t* query, double* ratio);
+
+/**
+ * Makes a read query on a dense array read a downsampled level of its
+ * pyramid, built on consolidation when `sm.consolidation.pyramid_levels`
+ * is set, instead of the array itself. Level `l` starts at the lower
+ * bounds of the array domain and has `2^l` times fewer cells along each
+ * dimension; each of its cells aggregates the corresponding cells of level
+ * `l - 1` with `sm.consolidation.pyramid_method`. The level holds only the
+ * fixed-sized attributes of the array.
  *
  * **Example:**
  *
  * @code{.c}
- * int32_t has_results;
- * tiledb_query_has_results(ctx, query, &has_results);
+ * tiledb_query_set_resolution_level(ctx, query, 2);
+ * tiledb_query_set_subarray(ctx, query, level_subarray);
+ * tiledb_query_set_buffer(ctx, query, "a", a, &a_size);
+ * tiledb_query_submit(ctx, query);
  * @endcode
  *
  * @param ctx The TileDB context.
- * @param query The query.
- * @param has_results Set to `1` if the query returned results and `0`
- *     otherwise.
- * @return `TILEDB_OK` upon success, and `TILEDB_ERR` upon error.
+ * @param query The TileDB read query.
+ * @param level The pyramid level, `0` for the array itself.
+ * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ *
+ * @note It must be set before the subarray and the buffers, the subarray
+ *     being given in the domain of the level.
  */
-TILEDB_EXPORT int32_t tiledb_query_has_results(
-    tiledb_ctx_t* ctx, tiledb_query_t* query, int32_t* has_results);
+TILEDB_EXPORT int32_t tiledb_query_set_resolution_level(
+    tiledb_ctx_t* ctx, tiledb_query_t* query, uint32_t level);
 
 /**
- * Retrieves the status of a query.
+ * Makes a global order write query write a part of the fragment of another
+ * global order write query, concurrently with the queries writing its
+ * other parts, e.g., from different threads. The parts must follow each
+ * other in the global order and, on sparse arrays, each part but the last
+ * one must consist of full tiles (a multiple of the capacity of cells).
+ * Finalizing `fragment_query` after all the part queries stitches their
+ * tiles into a single fragment, without decoding them.
  *
  * **Example:**
  *
  * @code{.c}
- * tiledb_query_status_t status;
- * tiledb_query_get_status(ctx, query, &status);
+ * tiledb_query_t *query, *part;
+ * tiledb_query_alloc(ctx, array, TILEDB_WRITE, &query);
+ * tiledb_query_set_layout(ctx, query, TILEDB_GLOBAL_ORDER);
+ * tiledb_query_alloc(ctx, array, TILEDB_WRITE, &part);
+ * tiledb_query_set_layout(ctx, part, TILEDB_GLOBAL_ORDER);
+ * tiledb_query_set_fragment_part(ctx, part, query, 0);
+ * // Set the buffers of `part`, submit and finalize it, then:
+ * tiledb_query_finalize(ctx, query);
  * @endcode
  *
  * @param ctx The TileDB context.
- * @param query The query.
- * @param status The query status to be retrieved.
+ * @param query The TileDB query writing the part.
+ * @param fragment_query The TileDB query of the fragment, which writes no
+ *     cells itself.
+ * @param part The index of the part, unique within the fragment.
+ * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ *
+ * @note The layouts of both queries must be set before, and neither of them
+ *     may have been submitted.
+ */
+TILEDB_EXPORT int32_t tiledb_query_set_fragment_part(
+    tiledb_ctx_t* ctx,
+    tiledb_query_t* query,
+    tiledb_query_t* fragment_query,
+    uint32_t part);
+
+/**
+ * Sets the width in bits (32 or 64) of the var-sized offsets in the buffers
+ * of a query, overriding the `sm.var_offsets.bitsize` config parameter for
+ * this query only. 32-bit offsets halve the size of the offsets buffers.
+ * If the offsets of the results of a read do not fit in 32 bits, the read
+ * returns fewer results and is incomplete, as if the buffers were too
+ * small.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * tiledb_query_set_offsets_bitsize(ctx, query, 32);
+ * tiledb_query_set_buffer_var(
+ *     ctx, query, "a", offsets32, &offsets_size, values, &values_size);
+ * @endcode
+ *
+ * @param ctx The TileDB context.
+ * @param query The TileDB query.
+ * @param bitsize The offsets width in bits, `32` or `64`.
+ * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ *
+ * @note It must be set before the query is submitted and, for writes,
+ *     before its buffers are set.
+ */
+TILEDB_EXPORT int32_t tiledb_query_set_offsets_bitsize(
+    tiledb_ctx_t* ctx, tiledb_query_t* query, uint32_t bitsize);
+
+/**
+ * Sets the scheduling priority of a query. The tasks a high priority query
+ * enqueues on the thread pools of the context (or on the process-wide
+ * scheduler, see `sm.num_scheduler_threads`), including tile reads,
+ * filtering and VFS tasks, run before the pending tasks of other queries;
+ * those of a low priority query run after them, like the tasks of the
+ * background consolidation. Running tasks are not preempted.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * tiledb_query_set_priority(ctx, query, TILEDB_QUERY_PRIORITY_HIGH);
+ * tiledb_query_submit(ctx, query);
+ * @endcode
+ *
+ * @param ctx The TileDB context.
+ * @param query The TileDB query.
+ * @param priority The query priority (`TILEDB_QUERY_PRIORITY_NORMAL` by
+ *     default).
+ * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ */
+TILEDB_EXPORT int32_t tiledb_query_set_priority(
+    tiledb_ctx_t* ctx, tiledb_query_t* query, tiledb_query_priority_t priority);
+
+/**
+ * Exports the results of the last submission of a read query for an
+ * attribute (or `TILEDB_COORDS`) through the Apache Arrow C data interface,
+ * without copying them. The buffers of the exported array are the buffers
+ * set on the query, which must stay valid (and must not be reused for
+ * another submission) until the array is released.
+ *
+ * Fixed-sized attributes are exported as primitive arrays, or fixed-size
+ * lists or binaries for several values per cell. Var-sized attributes are
+ * exported as strings (`TILEDB_STRING_ASCII`, `TILEDB_STRING_UTF8`),
+ * binaries (other single-byte types) or lists, which requires the query to
+ * write Arrow offsets: set `sm.var_offsets.extra_element` to `true`, and
+ * for lists `sm.var_offsets.mode` to `elements`. With
+ * `sm.var_offsets.bitsize` set to `32` the regular Arrow types are
+ * exported, otherwise the large ones.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * struct ArrowArray arrow_array;
+ * struct ArrowSchema arrow_schema;
+ * tiledb_query_submit(ctx, query);
+ * tiledb_query_export_arrow(ctx, query, "a", &arrow_array, &arrow_schema);
+ * // ... Import into Arrow, which releases the structs ... //
+ * @endcode
+ *
+ * @param ctx The TileDB context.
+ * @param query The TileDB read query.
+ * @param name The attribute name.
+ * @param arrow_array A `struct ArrowArray` to initialize.
+ * @param arrow_schema A `struct ArrowSchema` to initialize.
+ * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ */
+TILEDB_EXPORT int32_t tiledb_query_export_arrow(
+    tiledb_ctx_t* ctx,
+    tiledb_query_t* query,
+    const char* name,
+    void* arrow_array,
+    void* arrow_schema);
+
+/**
+ * Prepares a read query for repeated submissions over different subarrays.
+ * The query is validated and initialized once; afterwards, setting a new
+ * subarray only resets its read state and restores the buffer sizes to
+ * those given with `tiledb_query_set_buffer`, so that the buffers are
+ * reused for the results of each submission. Setting the layout, sparse
+ * mode, limit, condition or aggregates of the query undoes the
+ * preparation. It has no effect on queries of remote arrays.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * tiledb_query_prepare(ctx, query);
+ * for (int i = 0; i < n; ++i) {
+ *   int subarray[] = {keys[i], keys[i]};
+ *   tiledb_query_set_subarray(ctx, query, subarray);
+ *   tiledb_query_submit(ctx, query);
+ * }
+ * @endcode
+ *
+ * @param ctx The TileDB context.
+ * @param query The TileDB read query.
+ * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ */
+TILEDB_EXPORT int32_t tiledb_query_prepare(
+    tiledb_ctx_t* ctx, tiledb_query_t* query);
+
+/**
+ * Flushes all internal state of a query object and finalizes the query.
+ * This is applicable only to global layout writes. It has no effect for
+ * any other query type.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * tiledb_query_t* query;
+ * // ... Your code here ... //
+ * tiledb_query_finalize(ctx, query);
+ * @endcode
+ *
+ * @param ctx The TileDB context.
+ * @param query The query object to be flushed.
+ * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ */
+TILEDB_EXPORT int32_t
+tiledb_query_finalize(tiledb_ctx_t* ctx, tiledb_query_t* query);
+
+/**
+ * Frees a TileDB query object.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * tiledb_query_free(&query);
+ * @endcode
+ *
+ * @param query The query object to be deleted.
+ */
+TILEDB_EXPORT void tiledb_query_free(tiledb_query_t** query);
+
+/**
+ * Submits a TileDB query.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * tiledb_query_submit(ctx, query);
+ * @endcode
+ *
+ * @param ctx The TileDB context.
+ * @param query The query to be submitted.
+ * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ *
+ * @note `tiledb_query_finalize` must be invoked after finish writing in
+ *     global layout (via repeated invocations of `tiledb_query_submit`),
+ *     in order to flush any internal state.
+ *
+ * @note For the case of reads, if the returned status is `TILEDB_INCOMPLETE`,
+ *    TileDB could not fit the entire result in the user's buffers. In this
+ *    case, the user should consume the read results (if any), optionally
+ *    reset the buffers with `tiledb_query_set_buffer`, and then resubmit the
+ *    query until the status becomes `TILEDB_COMPLETED`. If all buffer sizes
+ *    after the termination of this function become 0, then this means that
+ *    **no** useful data was read into the buffers, implying that larger
+ *    buffers are needed for the query to proceed. In this case, the users
+ *    must reallocate their buffers (increasing their size), reset the buffers
+ *    with `tiledb_query_set_buffer`, and resubmit the query.
+ */
+TILEDB_EXPORT int32_t
+tiledb_query_submit(tiledb_ctx_t* ctx, tiledb_query_t* query);
+
+/**
+ * Submits a TileDB query in asynchronous mode.
+ *
+ * **Examples:**
+ *
+ * Submit without a callback.
+ *
+ * @code{.c}
+ * tiledb_query_submit_async(ctx, query, NULL, NULL);
+ * @endcode
+ *
+ * Submit with a callback function `print` that takes as input message
+ * `msg` and prints it upon completion of the query.
+ *
+ * @code{.c}
+ * const char* msg = "Query completed";
+ * tiledb_query_submit_async(ctx, &query, foo, msg);
+ * @endcode
+ *
+ * @param ctx The TileDB context.
+ * @param query The query to be submitted.
+ * @param callback The function to be called when the query completes.
+ * @param callback_data The data to be passed to the callback function.
+ * @return `TILEDB_OK` for success and `TILEDB_OOM` or `TILEDB_ERR` for error.
+ *
+ * @note `tiledb_query_finalize` must be invoked after finish writing in
+ *     global layout (via repeated invocations of `tiledb_query_submit`),
+ *     in order to flush any internal state.
+ *
+ * @note For the case of reads, if the returned status is `TILEDB_INCOMPLETE`,
+ *    TileDB could not fit the entire result in the user's buffers. In this
+ *    case, the user should consume the read results (if any), optionally
+ *    reset the buffers with `tiledb_query_set_buffer`, and then resubmit the
+ *    query until the status becomes `TILEDB_COMPLETED`. If all buffer sizes
+ *    after the termination of this function become 0, then this means that
+ *    **no** useful data was read into the buffers, implying that larger
+ *    buffers are needed for the query to proceed. In this case, the users
+ *    must reallocate their buffers (increasing their size), reset the buffers
+ *    with `tiledb_query_set_buffer`, and resubmit the query.
+ */
+TILEDB_EXPORT int32_t tiledb_query_submit_async(
+    tiledb_ctx_t* ctx,
+    tiledb_query_t* query,
+    void (*callback)(void*),
+    void* callback_data);
+
+/**
+ * Submits a TileDB query in asynchronous mode without a callback. Once the
+ * query has been processed (whether it completed, is incomplete, failed or
+ * was cancelled), `tag` is posted to the completion queue of the context,
+ * from which it is harvested with `tiledb_ctx_poll_completions`. This lets
+ * an event loop handle many concurrent queries in batches instead of in
+ * callbacks run on the TileDB threads.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * tiledb_query_submit_async_tagged(ctx, query, query);
+ * @endcode
+ *
+ * @param ctx The TileDB context.
+ * @param query The query to be submitted.
+ * @param tag The tag to post to the completion queue.
+ * @return `TILEDB_OK` for success and `TILEDB_OOM` or `TILEDB_ERR` for error.
+ *
+ * @note The same notes apply as for `tiledb_query_submit_async`.
+ */
+TILEDB_EXPORT int32_t tiledb_query_submit_async_tagged(
+    tiledb_ctx_t* ctx, tiledb_query_t* query, void* tag);
+
+/**
+ * Submits a batch of TileDB queries, typically on different arrays, and
+ * blocks until all of them have been processed. The queries are processed
+ * concurrently, on the async threads of the context (see
+ * `sm.num_async_threads`) and the calling thread, so the batch takes about
+ * as long as its slowest query instead of the sum of all of them.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * tiledb_query_t* queries[] = {query_1, query_2};
+ * tiledb_query_submit_batch(ctx, queries, 2);
+ * @endcode
+ *
+ * @param ctx The TileDB context.
+ * @param queries The queries to be submitted.
+ * @param num_queries The number of queries.
+ * @return `TILEDB_OK` for success and `TILEDB_OOM` or `TILEDB_ERR` for error.
+ *
+ * @note All the queries are processed even if some of them fail. The status
+ *     of each query should be checked with `tiledb_query_get_status`, and
+ *     the same notes apply to each query as for `tiledb_query_submit`.
+ */
+TILEDB_EXPORT int32_t tiledb_query_submit_batch(
+    tiledb_ctx_t* ctx, tiledb_query_t** queries, uint32_t num_queries);
+
+/**
+ * Checks if the query has returned any results. Applicable only to
+ * read queries; it sets `has_results` to `0 in the case of writes.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * int32_t has_results;
+ * tiledb_query_has_results(ctx, query, &has_results);
+ * @endcode
+ *
+ * @param ctx The TileDB context.
+ * @param query The query.
+ * @param has_results Set to `1` if the query returned results and `0`
+ *     otherwise.
+ * @return `TILEDB_OK` upon success, and `TILEDB_ERR` upon error.
+ */
+TILEDB_EXPORT int32_t tiledb_query_has_results(
+    tiledb_ctx_t* ctx, tiledb_query_t* query, int32_t* has_results);
+
+/**
+ * Retrieves the stats of a query as a JSON string, in the format of
+ * `tiledb_stats_dump_str`. They hold the function timers and counters
+ * gathered by the submissions of the query while stats were enabled (see
+ * `tiledb_stats_enable`), which are also added to the global stats. The
+ * string must be freed with `tiledb_stats_free_str`.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * char* stats_json;
+ * tiledb_query_get_stats(ctx, query, &stats_json);
+ * // ...
+ * tiledb_stats_free_str(&stats_json);
+ * @endcode
+ *
+ * @param ctx The TileDB context.
+ * @param query The query.
+ * @param stats_json Set to an allocated string with the query stats.
+ * @return `TILEDB_OK` upon success, and `TILEDB_ERR` upon error.
+ */
+TILEDB_EXPORT int32_t tiledb_query_get_stats(
+    tiledb_ctx_t* ctx, tiledb_query_t* query, char** stats_json);
+
+/**
+ * Retrieves the status of a query.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * tiledb_query_status_t status;
+ * tiledb_query_get_status(ctx, query, &status);
+ * @endcode
+ *
+ * @param ctx The TileDB context.
+ * @param query The query.
+ * @param status The query status to be retrieved.
  * @return `TILEDB_OK` upon success, and `TILEDB_ERR` upon error.
  */
 TILEDB_EXPORT int32_t tiledb_query_get_status(
@@ -3460,6 +4565,99 @@ TILEDB_EXPORT int32_t tiledb_query_get_fragment_timestamp_range(
     uint64_t* t1,
     uint64_t* t2);
 
+/* ********************************* */
+/*          QUERY CONDITION          */
+/* ********************************* */
+
+/**
+ * Allocates a TileDB query condition object.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * tiledb_query_condition_t* cond;
+ * tiledb_query_condition_alloc(ctx, &cond);
+ * @endcode
+ *
+ * @param ctx The TileDB context.
+ * @param cond The allocated query condition object.
+ * @return `TILEDB_OK` for success and `TILEDB_OOM` or `TILEDB_ERR` for error.
+ */
+TILEDB_EXPORT int32_t tiledb_query_condition_alloc(
+    tiledb_ctx_t* ctx, tiledb_query_condition_t** cond);
+
+/**
+ * Frees a TileDB query condition object.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * tiledb_query_condition_t* cond;
+ * tiledb_query_condition_alloc(ctx, &cond);
+ * tiledb_query_condition_free(&cond);
+ * @endcode
+ *
+ * @param cond The query condition object to be freed.
+ */
+TILEDB_EXPORT void tiledb_query_condition_free(tiledb_query_condition_t** cond);
+
+/**
+ * Initializes a TileDB query condition object as the comparison of an
+ * attribute with a value. The attribute must have a single fixed-sized
+ * numeric value per cell, and the value must have the attribute size.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * tiledb_query_condition_t* cond;
+ * tiledb_query_condition_alloc(ctx, &cond);
+ * float value = 0.5f;
+ * tiledb_query_condition_init(ctx, cond, "a2", &value, sizeof(float),
+ *     TILEDB_LE);
+ * @endcode
+ *
+ * @param ctx The TileDB context.
+ * @param cond The allocated query condition object.
+ * @param attribute_name The name of the compared attribute.
+ * @param condition_value The value the attribute is compared with.
+ * @param condition_value_size The size of `condition_value` in bytes.
+ * @param op The comparison operator.
+ * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ */
+TILEDB_EXPORT int32_t tiledb_query_condition_init(
+    tiledb_ctx_t* ctx,
+    tiledb_query_condition_t* cond,
+    const char* attribute_name,
+    const void* condition_value,
+    uint64_t condition_value_size,
+    tiledb_query_condition_op_t op);
+
+/**
+ * Combines two initialized query conditions with a logical operator into
+ * a new query condition, which must be freed by the caller.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * tiledb_query_condition_t* combined_cond;
+ * tiledb_query_condition_combine(
+ *     ctx, left_cond, right_cond, TILEDB_AND, &combined_cond);
+ * @endcode
+ *
+ * @param ctx The TileDB context.
+ * @param left_cond The first query condition.
+ * @param right_cond The second query condition.
+ * @param combination_op The logical operator combining the conditions.
+ * @param combined_cond The allocated combined query condition.
+ * @return `TILEDB_OK` for success and `TILEDB_OOM` or `TILEDB_ERR` for error.
+ */
+TILEDB_EXPORT int32_t tiledb_query_condition_combine(
+    tiledb_ctx_t* ctx,
+    const tiledb_query_condition_t* left_cond,
+    const tiledb_query_condition_t* right_cond,
+    tiledb_query_condition_combination_op_t combination_op,
+    tiledb_query_condition_t** combined_cond);
+
 /* ********************************* */
 /*               ARRAY               */
 /* ********************************* */
@@ -3634,6 +4832,111 @@ TILEDB_EXPORT int32_t tiledb_array_open_at_with_key(
 TILEDB_EXPORT int32_t tiledb_array_is_open(
     tiledb_ctx_t* ctx, tiledb_array_t* array, int32_t* is_open);
 
+/**
+ * Asynchronously loads the fragment metadata and the tiles of the given
+ * attributes that overlap the given subarray into the tile cache, so that
+ * subsequent reads of that region are served from memory. The function
+ * returns immediately; closing or reopening the array waits for the
+ * prefetch to finish. Errors encountered while prefetching are logged but
+ * not reported, since prefetching is only a hint. It has no effect if the
+ * tile cache is disabled (`sm.tile_cache_size` is `0`).
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * tiledb_array_t* array;
+ * tiledb_array_alloc(ctx, "hdfs:///tiledb_arrays/my_array", &array);
+ * tiledb_array_open(ctx, array, TILEDB_READ);
+ * uint64_t subarray[] = {1, 10, 1, 10};
+ * const char* attributes[] = {"a1", "a2"};
+ * tiledb_array_prefetch(ctx, array, subarray, attributes, 2);
+ * @endcode
+ *
+ * @param ctx The TileDB context.
+ * @param array An array opened for reads.
+ * @param subarray The subarray to prefetch, of the same type as the domain.
+ *     If `NULL`, the entire domain is prefetched.
+ * @param attributes The names of the attributes to prefetch.
+ * @param attribute_num The number of attributes. If `0`, all the attributes
+ *     are prefetched.
+ * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ *
+ * @note This is applicable only to local arrays opened for reads.
+ */
+TILEDB_EXPORT int32_t tiledb_array_prefetch(
+    tiledb_ctx_t* ctx,
+    tiledb_array_t* array,
+    const void* subarray,
+    const char** attributes,
+    uint32_t attribute_num);
+
+/**
+ * Estimates the number of distinct values of a numeric attribute in a
+ * subarray, from the sketches stored with the fragments when
+ * `sm.fragment_sketches` is enabled, without reading any tiles. The
+ * sketches of all the fragments whose non-empty domain overlaps the
+ * subarray are merged, so the estimate also covers their cells outside the
+ * subarray and those overwritten by later fragments. It errors if an
+ * overlapping fragment has no sketches.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * uint64_t subarray[] = {1, 10, 1, 10};
+ * uint64_t count;
+ * tiledb_array_get_approx_distinct_count(ctx, array, "a1", subarray, &count);
+ * @endcode
+ *
+ * @param ctx The TileDB context.
+ * @param array An array opened for reads.
+ * @param attribute The attribute name.
+ * @param subarray The subarray, of the same type as the domain. If `NULL`,
+ *     all the fragments are considered.
+ * @param count The estimated number of distinct values, with a standard
+ *     error of about 1.6%.
+ * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ *
+ * @note This is applicable only to local arrays opened for reads.
+ */
+TILEDB_EXPORT int32_t tiledb_array_get_approx_distinct_count(
+    tiledb_ctx_t* ctx,
+    tiledb_array_t* array,
+    const char* attribute,
+    const void* subarray,
+    uint64_t* count);
+
+/**
+ * Estimates a quantile of the values of a numeric attribute in a subarray,
+ * from the sketches stored with the fragments, merged as in
+ * `tiledb_array_get_approx_distinct_count`. The minimum (`q` is `0`) and
+ * maximum (`q` is `1`) are exact over the merged fragments.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * double median;
+ * tiledb_array_get_approx_quantile(ctx, array, "a1", NULL, 0.5, &median);
+ * @endcode
+ *
+ * @param ctx The TileDB context.
+ * @param array An array opened for reads.
+ * @param attribute The attribute name.
+ * @param subarray The subarray, of the same type as the domain. If `NULL`,
+ *     all the fragments are considered.
+ * @param q The quantile, in [0, 1].
+ * @param value The estimated quantile, or NaN if there are no values.
+ * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ *
+ * @note This is applicable only to local arrays opened for reads.
+ */
+TILEDB_EXPORT int32_t tiledb_array_get_approx_quantile(
+    tiledb_ctx_t* ctx,
+    tiledb_array_t* array,
+    const char* attribute,
+    const void* subarray,
+    double q,
+    double* value);
+
 /**
  * Reopens a TileDB array (the array must be already open). This is useful
  * when the array got updated after it got opened and the `tiledb_array_t`
@@ -3715,6 +5018,55 @@ TILEDB_EXPORT int32_t tiledb_array_reopen_at(
 TILEDB_EXPORT int32_t tiledb_array_get_timestamp(
     tiledb_ctx_t* ctx, tiledb_array_t* array, uint64_t* timestamp);
 
+/**
+ * Sets the start timestamp, representing time in milliseconds ellapsed since
+ * 1970-01-01 00:00:00 +0000 (UTC), of the fragments the array is opened with
+ * for reads. The fragments whose timestamp range ends before it are ignored,
+ * without loading their metadata. Together with `tiledb_array_open_at`, this
+ * opens the array with only the fragments written in a time window. The
+ * start timestamp takes effect the next time the array is opened or
+ * reopened, and defaults to 0.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * tiledb_array_t* array;
+ * tiledb_array_alloc(ctx, "s3://tiledb_bucket/my_array", &array);
+ * // Consider only the fragments written since `timestamp_start`
+ * tiledb_array_set_open_timestamp_start(ctx, array, timestamp_start);
+ * tiledb_array_open(ctx, array, TILEDB_READ);
+ * @endcode
+ *
+ * @param ctx The TileDB context.
+ * @param array The array to set the start timestamp for.
+ * @param timestamp_start The start timestamp.
+ * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ *
+ * @note A consolidated fragment whose timestamp range contains
+ *     `timestamp_start` is kept, so it may hold older writes as well.
+ */
+TILEDB_EXPORT int32_t tiledb_array_set_open_timestamp_start(
+    tiledb_ctx_t* ctx, tiledb_array_t* array, uint64_t timestamp_start);
+
+/**
+ * Retrieves the start timestamp of the fragments the array is opened with
+ * for reads. See also `tiledb_array_set_open_timestamp_start`.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * uint64_t timestamp_start;
+ * tiledb_array_get_open_timestamp_start(ctx, array, &timestamp_start);
+ * @endcode
+ *
+ * @param ctx The TileDB context.
+ * @param array The array to retrieve the start timestamp for.
+ * @param timestamp_start Set to the start timestamp.
+ * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ */
+TILEDB_EXPORT int32_t tiledb_array_get_open_timestamp_start(
+    tiledb_ctx_t* ctx, tiledb_array_t* array, uint64_t* timestamp_start);
+
 /**
  * Closes a TileDB array.
  *
@@ -3899,6 +5251,38 @@ TILEDB_EXPORT int32_t tiledb_array_consolidate_with_key(
     uint32_t key_length,
     tiledb_config_t* config);
 
+/**
+ * Consolidates the fragments of an array like `tiledb_array_consolidate`,
+ * and returns the statistics of the consolidation as a JSON object: the
+ * number of fragments before and after it, the number of fragments deleted
+ * as overwritten, the fragments consolidated, bytes read and written and
+ * tiles copied in total, the duration in nanoseconds, and the fragments,
+ * bytes and duration of each step. The string must be freed with
+ * `tiledb_stats_free_str`.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * char* stats;
+ * tiledb_array_consolidate_with_stats(
+ *     ctx, "hdfs:///tiledb_arrays/my_array", nullptr, &stats);
+ * // ...
+ * tiledb_stats_free_str(&stats);
+ * @endcode
+ *
+ * @param ctx The TileDB context.
+ * @param array_uri The name of the TileDB array to be consolidated.
+ * @param config Configuration parameters for the consolidation
+ *     (`nullptr` means default, which will use the config from `ctx`).
+ * @param stats Set to the statistics of the consolidation.
+ * @return `TILEDB_OK` on success, and `TILEDB_ERR` on error.
+ */
+TILEDB_EXPORT int32_t tiledb_array_consolidate_with_stats(
+    tiledb_ctx_t* ctx,
+    const char* array_uri,
+    tiledb_config_t* config,
+    char** stats);
+
 /**
  * Retrieves the non-empty domain from an array. This is the union of the
  * non-empty domains of the array fragments.
@@ -4197,6 +5581,79 @@ TILEDB_EXPORT int32_t tiledb_array_consolidate_metadata_with_key(
     uint32_t key_length,
     tiledb_config_t* config);
 
+/**
+ * Consolidates the fragment metadata (footers and R-Trees) of all the
+ * fragments of an array into a single file. Opening the array then fetches
+ * the metadata of those fragments with a single request, and only the
+ * fragments written after the consolidation are loaded individually.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * tiledb_array_consolidate_fragment_metadata(
+ *     ctx, "s3://tiledb_bucket/my_array", nullptr);
+ * @endcode
+ *
+ * @param ctx The TileDB context.
+ * @param array_uri The name of the TileDB array whose fragment metadata will
+ *     be consolidated.
+ * @param config Configuration parameters for the consolidation
+ *     (`nullptr` means default, which will use the config from `ctx`).
+ * @return `TILEDB_OK` on success, and `TILEDB_ERR` on error.
+ */
+TILEDB_EXPORT int32_t tiledb_array_consolidate_fragment_metadata(
+    tiledb_ctx_t* ctx, const char* array_uri, tiledb_config_t* config);
+
+/**
+ * Consolidates the fragment metadata of an encrypted array into a single file.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * uint8_t key[32] = ...;
+ * tiledb_array_consolidate_fragment_metadata_with_key(
+ *     ctx, "s3://tiledb_bucket/my_array",
+ *     TILEDB_AES_256_GCM, key, sizeof(key), nullptr);
+ * @endcode
+ *
+ * @param ctx The TileDB context.
+ * @param array_uri The name of the TileDB array whose fragment metadata will
+ *     be consolidated.
+ * @param encryption_type The encryption type to use.
+ * @param encryption_key The encryption key to use.
+ * @param key_length Length in bytes of the encryption key.
+ * @param config Configuration parameters for the consolidation
+ *     (`nullptr` means default, which will use the config from `ctx`).
+ *
+ * @return `TILEDB_OK` on success, and `TILEDB_ERR` on error.
+ */
+TILEDB_EXPORT int32_t tiledb_array_consolidate_fragment_metadata_with_key(
+    tiledb_ctx_t* ctx,
+    const char* array_uri,
+    tiledb_encryption_type_t encryption_type,
+    const void* encryption_key,
+    uint32_t key_length,
+    tiledb_config_t* config);
+
+/**
+ * Deletes the fragments superseded by the consolidations of an array that
+ * ran with `sm.consolidation.deferred_vacuum` set. Readers that open the
+ * array after a consolidation already ignore those fragments, so the
+ * deletion only waits for the readers opened before it.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * tiledb_array_vacuum(ctx, "s3://tiledb_bucket/my_array");
+ * @endcode
+ *
+ * @param ctx The TileDB context.
+ * @param array_uri The name of the TileDB array to vacuum.
+ * @return `TILEDB_OK` on success, and `TILEDB_ERR` on error.
+ */
+TILEDB_EXPORT int32_t tiledb_array_vacuum(
+    tiledb_ctx_t* ctx, const char* array_uri);
+
 /* ********************************* */
 /*          OBJECT MANAGEMENT        */
 /* ********************************* */
@@ -4840,6 +6297,26 @@ TILEDB_EXPORT int32_t tiledb_vfs_fh_is_closed(
 TILEDB_EXPORT int32_t
 tiledb_vfs_touch(tiledb_ctx_t* ctx, tiledb_vfs_t* vfs, const char* uri);
 
+/**
+ * Pre-opens the connections of the virtual filesystem to the storage
+ * backend of the given URI. For S3, this opens `vfs.s3.max_parallel_ops`
+ * connections to the bucket of the URI. This is a no-op for other
+ * backends.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * tiledb_vfs_warm_up(ctx, vfs, "s3://my_bucket");
+ * @endcode
+ *
+ * @param ctx The TileDB context.
+ * @param vfs The virtual filesystem object.
+ * @param uri A URI in the bucket to connect to.
+ * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ */
+TILEDB_EXPORT int32_t
+tiledb_vfs_warm_up(tiledb_ctx_t* ctx, tiledb_vfs_t* vfs, const char* uri);
+
 /* ****************************** */
 /*              URI               */
 /* ****************************** */
@@ -4931,6 +6408,60 @@ TILEDB_EXPORT int32_t tiledb_stats_dump_str(char** out);
  */
 TILEDB_EXPORT int32_t tiledb_stats_free_str(char** out);
 
+/**
+ * Enables tracing, which records the begin time, duration and thread of
+ * each call of the timed internal functions (the functions of the stats
+ * dump, and the backend VFS reads), so that the timeline of the queries can
+ * be dumped with `tiledb_stats_trace_dump` and loaded into Perfetto or
+ * `chrome://tracing`. At most 2^20 calls are recorded until the trace is
+ * reset. Tracing requires a build with stats (the default).
+ *
+ * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ */
+TILEDB_EXPORT int32_t tiledb_stats_trace_enable();
+
+/**
+ * Disables tracing. The recorded calls are kept until the trace is reset.
+ *
+ * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ */
+TILEDB_EXPORT int32_t tiledb_stats_trace_disable();
+
+/**
+ * Discards the recorded calls and restarts the timeline of the trace.
+ *
+ * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ */
+TILEDB_EXPORT int32_t tiledb_stats_trace_reset();
+
+/**
+ * Dumps the recorded calls to some output (e.g., file or stdout) in the
+ * JSON format of Chrome traces.
+ *
+ * @param out The output.
+ * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ */
+TILEDB_EXPORT int32_t tiledb_stats_trace_dump(FILE* out);
+
+/**
+ * Dumps the recorded calls to an output string in the JSON format of Chrome
+ * traces. The string must be freed with `tiledb_stats_free_str`.
+ *
+ * **Example:**
+ *
+ * @code{.c}
+ * char *trace_str;
+ * tiledb_stats_trace_dump_str(&trace_str);
+ * // ...
+ * tiledb_stats_free_str(&trace_str);
+ * @endcode
+ *
+ * @param out Will be set to point to an allocated string containing the
+ *     trace.
+ * @return `TILEDB_OK` for success and `TILEDB_ERR` for error.
+ */
+TILEDB_EXPORT int32_t tiledb_stats_trace_dump_str(char** out);
+
 #ifdef __cplusplus
 }
 #endif
@@ -131,6 +131,8 @@
     TILEDB_LAYOUT_ENUM(GLOBAL_ORDER) = 2,
     /** Unordered layout */
     TILEDB_LAYOUT_ENUM(UNORDERED) = 3,
+    /** Hilbert-curve layout (cell order of sparse arrays only) */
+    TILEDB_LAYOUT_ENUM(HILBERT) = 4,
 #endif
 
 #ifdef TILEDB_FILTER_TYPE_ENUM
@@ -156,6 +158,15 @@
     TILEDB_FILTER_TYPE_ENUM(FILTER_BYTESHUFFLE) = 9,
     /** Positive-delta encoding filter. */
     TILEDB_FILTER_TYPE_ENUM(FILTER_POSITIVE_DELTA) = 10,
+    /**
+     * Dictionary encoding filter (var-sized attributes/dimensions). Value 11
+     * is reserved for the internal encryption filter.
+     */
+    TILEDB_FILTER_TYPE_ENUM(FILTER_DICTIONARY) = 12,
+    /** Floating point XOR encoding filter (Gorilla-style, lossless). */
+    TILEDB_FILTER_TYPE_ENUM(FILTER_FLOAT_XOR) = 13,
+    /** Frame-of-reference bit-packing filter (integers). */
+    TILEDB_FILTER_TYPE_ENUM(FILTER_FRAME_OF_REFERENCE) = 14,
 #endif
 
 #ifdef TILEDB_FILTER_OPTION_ENUM
@@ -165,6 +176,21 @@
     TILEDB_FILTER_OPTION_ENUM(BIT_WIDTH_MAX_WINDOW) = 1,
     /** Max window length for positive-delta encoding. Type: `uint32_t`. */
     TILEDB_FILTER_OPTION_ENUM(POSITIVE_DELTA_MAX_WINDOW) = 2,
+    /**
+     * Max size of the zstd dictionary trained per tile (0 disables
+     * dictionaries). Type: `uint32_t`.
+     */
+    TILEDB_FILTER_OPTION_ENUM(COMPRESSION_DICTIONARY_SIZE) = 3,
+    /**
+     * Whether the lz4/zstd filter byte-shuffles each block of data before
+     * compressing it (0 or 1). Type: `uint32_t`.
+     */
+    TILEDB_FILTER_OPTION_ENUM(COMPRESSION_BYTESHUFFLE) = 4,
+    /**
+     * Whether the frame-of-reference filter encodes the differences of
+     * consecutive values (0 or 1). Type: `uint32_t`.
+     */
+    TILEDB_FILTER_OPTION_ENUM(FRAME_OF_REFERENCE_DELTA) = 5,
 #endif
 
 #ifdef TILEDB_ENCRYPTION_TYPE_ENUM
@@ -210,3 +236,49 @@
     /** Append mode */
     TILEDB_VFS_MODE_ENUM(VFS_APPEND) = 2,
 #endif
+
+/** TileDB query condition operator */
+#ifdef TILEDB_QUERY_CONDITION_OP_ENUM
+    /** Less-than operator */
+    TILEDB_QUERY_CONDITION_OP_ENUM(LT) = 0,
+    /** Less-than-or-equal operator */
+    TILEDB_QUERY_CONDITION_OP_ENUM(LE) = 1,
+    /** Greater-than operator */
+    TILEDB_QUERY_CONDITION_OP_ENUM(GT) = 2,
+    /** Greater-than-or-equal operator */
+    TILEDB_QUERY_CONDITION_OP_ENUM(GE) = 3,
+    /** Equal operator */
+    TILEDB_QUERY_CONDITION_OP_ENUM(EQ) = 4,
+    /** Not-equal operator */
+    TILEDB_QUERY_CONDITION_OP_ENUM(NE) = 5,
+#endif
+
+/** TileDB query condition combination operator */
+#ifdef TILEDB_QUERY_CONDITION_COMBINATION_OP_ENUM
+    /** Logical AND of the combined conditions */
+    TILEDB_QUERY_CONDITION_COMBINATION_OP_ENUM(AND) = 0,
+    /** Logical OR of the combined conditions */
+    TILEDB_QUERY_CONDITION_COMBINATION_OP_ENUM(OR) = 1,
+#endif
+
+/** TileDB aggregate operator */
+#ifdef TILEDB_AGGREGATE_OP_ENUM
+    /** Number of result cells */
+    TILEDB_AGGREGATE_OP_ENUM(AGGREGATE_COUNT) = 0,
+    /** Sum of the attribute values */
+    TILEDB_AGGREGATE_OP_ENUM(AGGREGATE_SUM) = 1,
+    /** Minimum attribute value */
+    TILEDB_AGGREGATE_OP_ENUM(AGGREGATE_MIN) = 2,
+    /** Maximum attribute value */
+    TILEDB_AGGREGATE_OP_ENUM(AGGREGATE_MAX) = 3,
+#endif
+
+/** TileDB query priority */
+#ifdef TILEDB_QUERY_PRIORITY_ENUM
+    /** Tasks are scheduled by their kind (I/O before compute) */
+    TILEDB_QUERY_PRIORITY_ENUM(QUERY_PRIORITY_NORMAL) = 0,
+    /** Tasks run before those of normal and low priority queries */
+    TILEDB_QUERY_PRIORITY_ENUM(QUERY_PRIORITY_HIGH) = 1,
+    /** Tasks run after those of normal and high priority queries */
+    TILEDB_QUERY_PRIORITY_ENUM(QUERY_PRIORITY_LOW) = 2,
+#endif
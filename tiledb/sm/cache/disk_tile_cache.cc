@@ -0,0 +1,251 @@
+/**
+ * @file   disk_tile_cache.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * This file implements class DiskTileCache.
+ */
+
+#include "tiledb/sm/cache/disk_tile_cache.h"
+#include "tiledb/sm/filesystem/vfs.h"
+#include "tiledb/sm/misc/logger.h"
+#include "tiledb/sm/misc/stats.h"
+
+#include <cstring>
+#include <functional>
+#include <sstream>
+#include <vector>
+
+namespace tiledb {
+namespace sm {
+
+namespace {
+
+/** The suffix of the temporary files of in-progress writes. */
+const std::string tmp_suffix = ".tmp";
+
+}  // namespace
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+DiskTileCache::DiskTileCache(VFS* vfs, const URI& dir, uint64_t max_size)
+    : dir_(dir)
+    , max_size_(max_size)
+    , size_(0)
+    , tmp_counter_(0)
+    , vfs_(vfs) {
+}
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+bool DiskTileCache::caches(const URI& uri) const {
+  return !uri.is_file();
+}
+
+Status DiskTileCache::init() {
+  bool is_dir = false;
+  RETURN_NOT_OK(vfs_->is_dir(dir_, &is_dir));
+  if (!is_dir)
+    RETURN_NOT_OK(vfs_->create_dir(dir_));
+
+  // Index the existing entries and discard leftover temporary files
+  std::vector<URI> uris;
+  RETURN_NOT_OK(vfs_->ls(dir_, &uris));
+  std::vector<std::string> to_remove;
+  {
+    std::lock_guard<std::mutex> lock{mtx_};
+    for (const auto& uri : uris) {
+      auto name = uri.last_path_part();
+      if (name.find(tmp_suffix) != std::string::npos) {
+        to_remove.push_back(name);
+        continue;
+      }
+      uint64_t size = 0;
+      RETURN_NOT_OK(vfs_->file_size(uri, &size));
+      if (entry_map_.count(name) != 0)
+        continue;
+      entry_ll_.push_back({name, size});
+      entry_map_[name] = std::prev(entry_ll_.end());
+      size_ += size;
+    }
+    evict(0, &to_remove);
+  }
+
+  for (const auto& name : to_remove)
+    RETURN_NOT_OK(vfs_->remove_file(dir_.join_path(name)));
+
+  return Status::Ok();
+}
+
+uint64_t DiskTileCache::max_size() const {
+  return max_size_;
+}
+
+Status DiskTileCache::read(
+    const URI& uri,
+    uint64_t offset,
+    void* buffer,
+    uint64_t nbytes,
+    bool* hit) {
+  STATS_FUNC_IN(cache_disk_tile_read);
+
+  *hit = false;
+  auto name = entry_name(uri, offset, nbytes);
+  auto uri_str = uri.to_string();
+  uint64_t header_size = sizeof(uint64_t) + uri_str.size();
+  {
+    std::lock_guard<std::mutex> lock{mtx_};
+    auto it = entry_map_.find(name);
+    if (it == entry_map_.end() || it->second->size_ != header_size + nbytes) {
+      STATS_COUNTER_ADD(cache_disk_tile_read_misses, 1);
+      return Status::Ok();
+    }
+
+    // Make the entry the most recently used
+    entry_ll_.splice(entry_ll_.end(), entry_ll_, it->second);
+  }
+
+  // Check that the entry belongs to the tile and read it. The entry may
+  // have been evicted meanwhile, in which case the read is a miss.
+  auto entry_uri = dir_.join_path(name);
+  std::vector<char> header(header_size);
+  if (!vfs_->read(entry_uri, 0, header.data(), header_size).ok()) {
+    STATS_COUNTER_ADD(cache_disk_tile_read_misses, 1);
+    return Status::Ok();
+  }
+  uint64_t uri_size = 0;
+  std::memcpy(&uri_size, header.data(), sizeof(uint64_t));
+  if (uri_size != uri_str.size() ||
+      std::memcmp(header.data() + sizeof(uint64_t), uri_str.data(), uri_size)) {
+    STATS_COUNTER_ADD(cache_disk_tile_read_misses, 1);
+    return Status::Ok();
+  }
+  if (!vfs_->read(entry_uri, header_size, buffer, nbytes).ok()) {
+    STATS_COUNTER_ADD(cache_disk_tile_read_misses, 1);
+    return Status::Ok();
+  }
+
+  *hit = true;
+  STATS_COUNTER_ADD(cache_disk_tile_read_hits, 1);
+
+  return Status::Ok();
+
+  STATS_FUNC_OUT(cache_disk_tile_read);
+}
+
+uint64_t DiskTileCache::size() const {
+  std::lock_guard<std::mutex> lock{mtx_};
+  return size_;
+}
+
+Status DiskTileCache::write(
+    const URI& uri, uint64_t offset, const void* buffer, uint64_t nbytes) {
+  STATS_FUNC_IN(cache_disk_tile_write);
+
+  auto uri_str = uri.to_string();
+  uint64_t uri_size = uri_str.size();
+  uint64_t entry_size = sizeof(uint64_t) + uri_size + nbytes;
+  if (entry_size > max_size_)
+    return Status::Ok();
+
+  auto name = entry_name(uri, offset, nbytes);
+  {
+    std::lock_guard<std::mutex> lock{mtx_};
+    if (entry_map_.count(name) != 0)
+      return Status::Ok();
+  }
+
+  // Write under a temporary name, so readers never see a partial entry
+  auto tmp_uri =
+      dir_.join_path(name + tmp_suffix + std::to_string(tmp_counter_++));
+  auto entry_uri = dir_.join_path(name);
+  auto st = vfs_->write(tmp_uri, &uri_size, sizeof(uint64_t));
+  if (st.ok())
+    st = vfs_->write(tmp_uri, uri_str.data(), uri_size);
+  if (st.ok())
+    st = vfs_->write(tmp_uri, buffer, nbytes);
+  if (st.ok())
+    st = vfs_->close_file(tmp_uri);
+  if (st.ok())
+    st = vfs_->move_file(tmp_uri, entry_uri);
+  if (!st.ok()) {
+    vfs_->close_file(tmp_uri);
+    bool is_file = false;
+    if (vfs_->is_file(tmp_uri, &is_file).ok() && is_file)
+      vfs_->remove_file(tmp_uri);
+    return st;
+  }
+
+  // Index the entry, evicting others to make room
+  std::vector<std::string> to_remove;
+  {
+    std::lock_guard<std::mutex> lock{mtx_};
+    if (entry_map_.count(name) == 0) {
+      evict(entry_size, &to_remove);
+      entry_ll_.push_back({name, entry_size});
+      entry_map_[name] = std::prev(entry_ll_.end());
+      size_ += entry_size;
+      STATS_COUNTER_ADD(cache_disk_tile_inserts, 1);
+    }
+  }
+
+  for (const auto& evicted : to_remove)
+    RETURN_NOT_OK(vfs_->remove_file(dir_.join_path(evicted)));
+
+  return Status::Ok();
+
+  STATS_FUNC_OUT(cache_disk_tile_write);
+}
+
+/* ****************************** */
+/*          PRIVATE METHODS       */
+/* ****************************** */
+
+std::string DiskTileCache::entry_name(
+    const URI& uri, uint64_t offset, uint64_t nbytes) {
+  std::stringstream ss;
+  ss << std::hex << std::hash<std::string>()(uri.to_string()) << "_" << offset
+     << "_" << nbytes;
+  return ss.str();
+}
+
+void DiskTileCache::evict(uint64_t extra, std::vector<std::string>* evicted) {
+  while (!entry_ll_.empty() && size_ + extra > max_size_) {
+    auto& entry = entry_ll_.front();
+    evicted->push_back(entry.name_);
+    size_ -= entry.size_;
+    entry_map_.erase(entry.name_);
+    entry_ll_.pop_front();
+    STATS_COUNTER_ADD(cache_disk_tile_evictions, 1);
+  }
+}
+
+}  // namespace sm
+}  // namespace tiledb
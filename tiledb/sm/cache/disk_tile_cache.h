@@ -0,0 +1,207 @@
+/**
+ * @file   disk_tile_cache.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * This file defines class DiskTileCache.
+ */
+
+#ifndef TILEDB_DISK_TILE_CACHE_H
+#define TILEDB_DISK_TILE_CACHE_H
+
+#include "tiledb/sm/misc/status.h"
+#include "tiledb/sm/misc/uri.h"
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tiledb {
+namespace sm {
+
+class VFS;
+
+/**
+ * A thread-safe LRU cache of filtered (persisted) tile bytes, stored as
+ * files in a local directory. It is a second tier behind the in-memory
+ * tile cache for arrays on remote storage: a tile evicted from memory can
+ * be fetched from local disk instead of the object store.
+ *
+ * A tile is keyed by the URI of its fragment file and its offset in that
+ * file. Fragments are immutable, so entries never need invalidation. Each
+ * entry file starts with the URI it was written for, which is checked on
+ * read, so hash collisions between file names can never return the wrong
+ * bytes. An entry is written under a temporary name and renamed, so that
+ * readers never see a partially written entry.
+ *
+ * The entries found in the directory on initialization are reused, so the
+ * cache survives across processes. A directory must not be shared by
+ * processes running concurrently.
+ */
+class DiskTileCache {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /**
+   * Constructor.
+   *
+   * @param vfs The VFS used to access the cache directory.
+   * @param dir The local cache directory.
+   * @param max_size The maximum total size of the entries in bytes.
+   */
+  DiskTileCache(VFS* vfs, const URI& dir, uint64_t max_size);
+
+  /** Destructor. */
+  ~DiskTileCache() = default;
+
+  DiskTileCache(const DiskTileCache&) = delete;
+  DiskTileCache& operator=(const DiskTileCache&) = delete;
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /**
+   * Returns `true` if the tiles of the input file are eligible for the
+   * cache, i.e., if the file is not local.
+   */
+  bool caches(const URI& uri) const;
+
+  /**
+   * Creates the cache directory if it does not exist, and indexes the
+   * entries it already contains, evicting entries if they exceed the
+   * maximum size.
+   *
+   * @return Status
+   */
+  Status init();
+
+  /** Returns the maximum total size of the entries in bytes. */
+  uint64_t max_size() const;
+
+  /**
+   * Reads the tile at the given file offset, if cached.
+   *
+   * @param uri The URI of the fragment file of the tile.
+   * @param offset The offset of the tile in the file.
+   * @param buffer The buffer to read into.
+   * @param nbytes The tile size.
+   * @param hit Set to `true` if the tile was read from the cache.
+   * @return Status
+   */
+  Status read(
+      const URI& uri,
+      uint64_t offset,
+      void* buffer,
+      uint64_t nbytes,
+      bool* hit);
+
+  /** Returns the current total size of the entries in bytes. */
+  uint64_t size() const;
+
+  /**
+   * Stores the tile at the given file offset, evicting the least recently
+   * used entries to make room. A tile larger than the cache is not stored.
+   *
+   * @param uri The URI of the fragment file of the tile.
+   * @param offset The offset of the tile in the file.
+   * @param buffer The tile bytes.
+   * @param nbytes The tile size.
+   * @return Status
+   */
+  Status write(
+      const URI& uri, uint64_t offset, const void* buffer, uint64_t nbytes);
+
+ private:
+  /* ********************************* */
+  /*        PRIVATE DATATYPES          */
+  /* ********************************* */
+
+  /** A cache entry. */
+  struct Entry {
+    /** The entry file name, within the cache directory. */
+    std::string name_;
+    /** The entry file size. */
+    uint64_t size_;
+  };
+
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The cache directory. */
+  URI dir_;
+
+  /** The entries, the least recently used first. */
+  std::list<Entry> entry_ll_;
+
+  /** Maps an entry file name to its entry. */
+  std::unordered_map<std::string, std::list<Entry>::iterator> entry_map_;
+
+  /** The maximum total size of the entries. */
+  uint64_t max_size_;
+
+  /** Protects the entry index. */
+  mutable std::mutex mtx_;
+
+  /** The current total size of the entries. */
+  uint64_t size_;
+
+  /** Makes the temporary file names of concurrent writes unique. */
+  std::atomic<uint64_t> tmp_counter_;
+
+  /** The VFS used to access the cache directory. */
+  VFS* vfs_;
+
+  /* ********************************* */
+  /*          PRIVATE METHODS          */
+  /* ********************************* */
+
+  /** Returns the entry file name of the tile at the given file offset. */
+  static std::string entry_name(
+      const URI& uri, uint64_t offset, uint64_t nbytes);
+
+  /**
+   * Evicts least recently used entries from the index until `extra` more
+   * bytes fit in the cache. Must be called with `mtx_` held. The files of
+   * the evicted entries are not removed, so that the caller can remove them
+   * after releasing the lock.
+   *
+   * @param extra The number of bytes to make room for.
+   * @param evicted The names of the evicted entries are appended here.
+   */
+  void evict(uint64_t extra, std::vector<std::string>* evicted);
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_DISK_TILE_CACHE_H
@@ -0,0 +1,184 @@
+/**
+ * @file   fragment_metadata_cache.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * This file implements class FragmentMetadataCache.
+ */
+
+#include "tiledb/sm/cache/fragment_metadata_cache.h"
+#include "tiledb/sm/buffer/buffer.h"
+#include "tiledb/sm/misc/stats.h"
+#include "tiledb/sm/misc/utils.h"
+
+namespace tiledb {
+namespace sm {
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+FragmentMetadataCache::FragmentMetadataCache(uint64_t max_size)
+    : max_size_(max_size)
+    , size_(0) {
+}
+
+FragmentMetadataCache::~FragmentMetadataCache() {
+  clear();
+}
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+void FragmentMetadataCache::clear() {
+  std::lock_guard<std::mutex> lock{mtx_};
+  item_ll_.clear();
+  item_map_.clear();
+  size_ = 0;
+}
+
+bool FragmentMetadataCache::file_size(const URI& uri, uint64_t* size) {
+  std::lock_guard<std::mutex> lock{mtx_};
+  auto item_it = item_map_.find(size_key(uri));
+  if (item_it == item_map_.end())
+    return false;
+
+  auto node = item_it->second;
+  item_ll_.splice(item_ll_.end(), item_ll_, node);
+  *size = node->object_->value<uint64_t>(0);
+  return true;
+}
+
+std::shared_ptr<const Buffer> FragmentMetadataCache::get(
+    const URI& uri, uint64_t offset) {
+  std::lock_guard<std::mutex> lock{mtx_};
+  auto item_it = item_map_.find(key(uri, offset));
+  if (item_it == item_map_.end()) {
+    STATS_COUNTER_ADD(fragment_metadata_cache_read_misses, 1);
+    return nullptr;
+  }
+
+  auto node = item_it->second;
+  item_ll_.splice(item_ll_.end(), item_ll_, node);
+  STATS_COUNTER_ADD(fragment_metadata_cache_read_hits, 1);
+  return node->object_;
+}
+
+void FragmentMetadataCache::insert_file_size(const URI& uri, uint64_t size) {
+  auto object = std::make_shared<Buffer>();
+  object->write(&size, sizeof(uint64_t));
+  auto k = size_key(uri);
+  insert(k, object, k.size() + sizeof(uint64_t));
+}
+
+void FragmentMetadataCache::insert(
+    const URI& uri,
+    uint64_t offset,
+    const std::shared_ptr<const Buffer>& object) {
+  if (object == nullptr)
+    return;
+
+  auto k = key(uri, offset);
+  insert(k, object, k.size() + object->size());
+}
+
+void FragmentMetadataCache::invalidate(const URI& uri) {
+  auto prefix = uri.remove_trailing_slash().to_string();
+  std::lock_guard<std::mutex> lock{mtx_};
+  for (auto it = item_ll_.begin(); it != item_ll_.end();) {
+    auto next = std::next(it);
+    // The key is the file URI followed by a `#` and the offset or size tag
+    const auto& k = it->key_;
+    if (utils::parse::starts_with(k, prefix) &&
+        (k[prefix.size()] == '/' || k[prefix.size()] == '#'))
+      remove(it);
+    it = next;
+  }
+}
+
+uint64_t FragmentMetadataCache::max_size() const {
+  std::lock_guard<std::mutex> lock{mtx_};
+  return max_size_;
+}
+
+void FragmentMetadataCache::set_max_size(uint64_t max_size) {
+  std::lock_guard<std::mutex> lock{mtx_};
+  max_size_ = max_size;
+  while (size_ > max_size_)
+    remove(item_ll_.begin());
+}
+
+uint64_t FragmentMetadataCache::size() const {
+  std::lock_guard<std::mutex> lock{mtx_};
+  return size_;
+}
+
+/* ****************************** */
+/*         PRIVATE METHODS        */
+/* ****************************** */
+
+void FragmentMetadataCache::insert(
+    const std::string& key,
+    const std::shared_ptr<const Buffer>& object,
+    uint64_t size) {
+  std::lock_guard<std::mutex> lock{mtx_};
+
+  // Do nothing if the object does not fit in the cache
+  if (size > max_size_)
+    return;
+
+  // Replace an existing object, which is identical since files do not change
+  auto item_it = item_map_.find(key);
+  if (item_it != item_map_.end())
+    remove(item_it->second);
+
+  while (size_ + size > max_size_)
+    remove(item_ll_.begin());
+
+  item_ll_.push_back(Item{key, object, size});
+  item_map_[key] = std::prev(item_ll_.end());
+  size_ += size;
+
+  STATS_COUNTER_ADD(fragment_metadata_cache_inserts, 1);
+}
+
+std::string FragmentMetadataCache::key(const URI& uri, uint64_t offset) {
+  return uri.to_string() + "#" + std::to_string(offset);
+}
+
+std::string FragmentMetadataCache::size_key(const URI& uri) {
+  return uri.to_string() + "#size";
+}
+
+void FragmentMetadataCache::remove(std::list<Item>::iterator node) {
+  size_ -= node->size_;
+  item_map_.erase(node->key_);
+  item_ll_.erase(node);
+}
+
+}  // namespace sm
+}  // namespace tiledb
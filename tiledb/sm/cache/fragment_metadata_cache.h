@@ -0,0 +1,206 @@
+/**
+ * @file   fragment_metadata_cache.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * This file defines class FragmentMetadataCache.
+ */
+
+#ifndef TILEDB_FRAGMENT_METADATA_CACHE_H
+#define TILEDB_FRAGMENT_METADATA_CACHE_H
+
+#include "tiledb/sm/misc/status.h"
+#include "tiledb/sm/misc/uri.h"
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace tiledb {
+namespace sm {
+
+class Buffer;
+
+/**
+ * A process-wide, thread-safe LRU cache of the decoded (decompressed and
+ * decrypted) regions of array schema and fragment metadata files, keyed by
+ * file URI and offset. It is shared by all contexts, so that opening an
+ * array that was already opened, even by another context, parses the
+ * cached regions instead of reading them from storage again.
+ *
+ * Fragment metadata files never change once written, and a fragment URI is
+ * never reused. An array schema file changes only when its array is removed
+ * and created again, so `invalidate` must be called on the schema URI when
+ * a schema is stored. Note that an array removed and created again by
+ * another process may be served with a stale schema.
+ *
+ * Cached objects are immutable, reference-counted buffers, so an evicted
+ * object stays valid for as long as a reader holds it.
+ */
+class FragmentMetadataCache {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /**
+   * Constructor.
+   *
+   * @param max_size The maximum cache size in bytes.
+   */
+  explicit FragmentMetadataCache(uint64_t max_size);
+
+  /** Destructor. */
+  ~FragmentMetadataCache();
+
+  FragmentMetadataCache(const FragmentMetadataCache&) = delete;
+  FragmentMetadataCache& operator=(const FragmentMetadataCache&) = delete;
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /** Clears the cache. */
+  void clear();
+
+  /**
+   * Retrieves the cached size of the input file.
+   *
+   * @param uri The file URI.
+   * @param size Set to the file size, if found.
+   * @return `true` if the size was found in the cache.
+   */
+  bool file_size(const URI& uri, uint64_t* size);
+
+  /**
+   * Retrieves the cached region of the input file that starts at `offset`.
+   *
+   * @param uri The file URI.
+   * @param offset The offset of the region in the file.
+   * @return The cached region, or `nullptr` if it is not in the cache.
+   */
+  std::shared_ptr<const Buffer> get(const URI& uri, uint64_t offset);
+
+  /**
+   * Inserts the size of the input file.
+   *
+   * @param uri The file URI.
+   * @param size The file size.
+   */
+  void insert_file_size(const URI& uri, uint64_t size);
+
+  /**
+   * Inserts the decoded region of the input file that starts at `offset`.
+   * The buffer must not be modified after insertion. A region larger than
+   * the cache is not inserted.
+   *
+   * @param uri The file URI.
+   * @param offset The offset of the region in the file.
+   * @param object The decoded region.
+   */
+  void insert(
+      const URI& uri,
+      uint64_t offset,
+      const std::shared_ptr<const Buffer>& object);
+
+  /**
+   * Evicts all the objects of the input file, or of the files in the input
+   * directory.
+   */
+  void invalidate(const URI& uri);
+
+  /** Returns the maximum size of the cache in bytes. */
+  uint64_t max_size() const;
+
+  /**
+   * Sets the maximum cache size, evicting objects if needed. A size of `0`
+   * disables the cache.
+   */
+  void set_max_size(uint64_t max_size);
+
+  /** Returns the current size of the cache in bytes. */
+  uint64_t size() const;
+
+ private:
+  /* ********************************* */
+  /*        PRIVATE DATATYPES          */
+  /* ********************************* */
+
+  /** A cached object. */
+  struct Item {
+    /** The object key. */
+    std::string key_;
+    /** The object. */
+    std::shared_ptr<const Buffer> object_;
+    /** The size charged for the object. */
+    uint64_t size_;
+  };
+
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The items, the least recently used first. */
+  std::list<Item> item_ll_;
+
+  /** Maps a key to its item. */
+  std::unordered_map<std::string, std::list<Item>::iterator> item_map_;
+
+  /** The maximum cache size. */
+  uint64_t max_size_;
+
+  /** Protects the cache. */
+  mutable std::mutex mtx_;
+
+  /** The current cache size. */
+  uint64_t size_;
+
+  /* ********************************* */
+  /*          PRIVATE METHODS          */
+  /* ********************************* */
+
+  /** Inserts an object under the input key, evicting objects if needed. */
+  void insert(
+      const std::string& key,
+      const std::shared_ptr<const Buffer>& object,
+      uint64_t size);
+
+  /** Returns the key of the input file region. */
+  static std::string key(const URI& uri, uint64_t offset);
+
+  /** Returns the key of the size of the input file. */
+  static std::string size_key(const URI& uri);
+
+  /** Removes the given item. */
+  void remove(std::list<Item>::iterator node);
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_FRAGMENT_METADATA_CACHE_H
@@ -0,0 +1,127 @@
+/**
+ * @file   index_cache.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * This file implements class IndexCache.
+ */
+
+#include "tiledb/sm/cache/index_cache.h"
+#include "tiledb/sm/misc/stats.h"
+#include "tiledb/sm/rtree/rtree.h"
+
+namespace tiledb {
+namespace sm {
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+IndexCache::IndexCache(uint64_t max_size)
+    : max_size_(max_size)
+    , size_(0) {
+}
+
+IndexCache::~IndexCache() {
+  clear();
+}
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+void IndexCache::clear() {
+  std::lock_guard<std::mutex> lock{mtx_};
+  item_ll_.clear();
+  item_map_.clear();
+  size_ = 0;
+}
+
+std::shared_ptr<const RTree> IndexCache::get_rtree(const URI& fragment_uri) {
+  std::lock_guard<std::mutex> lock{mtx_};
+  auto item_it = item_map_.find(fragment_uri.to_string());
+  if (item_it == item_map_.end()) {
+    STATS_COUNTER_ADD(index_cache_read_misses, 1);
+    return nullptr;
+  }
+
+  auto node = item_it->second;
+  item_ll_.splice(item_ll_.end(), item_ll_, node);
+  STATS_COUNTER_ADD(index_cache_read_hits, 1);
+  return node->rtree_;
+}
+
+void IndexCache::insert_rtree(
+    const URI& fragment_uri, const std::shared_ptr<const RTree>& rtree) {
+  if (rtree == nullptr)
+    return;
+
+  auto key = fragment_uri.to_string();
+  auto size = key.size() + sizeof(RTree) + rtree->size();
+
+  std::lock_guard<std::mutex> lock{mtx_};
+
+  // Do nothing if the R-Tree does not fit in the cache
+  if (size > max_size_)
+    return;
+
+  // Replace an existing R-Tree, which is identical since fragments do not
+  // change
+  auto item_it = item_map_.find(key);
+  if (item_it != item_map_.end())
+    remove(item_it->second);
+
+  while (size_ + size > max_size_)
+    remove(item_ll_.begin());
+
+  item_ll_.push_back(Item{key, rtree, size});
+  item_map_[key] = std::prev(item_ll_.end());
+  size_ += size;
+
+  STATS_COUNTER_ADD(index_cache_inserts, 1);
+}
+
+uint64_t IndexCache::max_size() const {
+  return max_size_;
+}
+
+uint64_t IndexCache::size() const {
+  std::lock_guard<std::mutex> lock{mtx_};
+  return size_;
+}
+
+/* ****************************** */
+/*         PRIVATE METHODS        */
+/* ****************************** */
+
+void IndexCache::remove(std::list<Item>::iterator node) {
+  size_ -= node->size_;
+  item_map_.erase(node->key_);
+  item_ll_.erase(node);
+}
+
+}  // namespace sm
+}  // namespace tiledb
@@ -0,0 +1,155 @@
+/**
+ * @file   index_cache.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * This file defines class IndexCache.
+ */
+
+#ifndef TILEDB_INDEX_CACHE_H
+#define TILEDB_INDEX_CACHE_H
+
+#include "tiledb/sm/misc/uri.h"
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace tiledb {
+namespace sm {
+
+class RTree;
+
+/**
+ * A thread-safe LRU cache of the deserialized R-Trees of fragments, keyed
+ * by fragment URI. It is owned by the storage manager and kept apart from
+ * the tile cache, so that index structures are shared by all the array
+ * handles of a context, outlive the handles, and are never evicted by data
+ * tiles.
+ *
+ * Fragments never change once written and a fragment URI is never reused,
+ * so entries never become stale. Cached R-Trees are immutable and
+ * reference-counted, so an evicted R-Tree stays valid for as long as a
+ * fragment holds it.
+ */
+class IndexCache {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /**
+   * Constructor.
+   *
+   * @param max_size The maximum cache size in bytes. `0` disables the cache.
+   */
+  explicit IndexCache(uint64_t max_size);
+
+  /** Destructor. */
+  ~IndexCache();
+
+  IndexCache(const IndexCache&) = delete;
+  IndexCache& operator=(const IndexCache&) = delete;
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /** Clears the cache. */
+  void clear();
+
+  /**
+   * Retrieves the cached R-Tree of the input fragment.
+   *
+   * @param fragment_uri The fragment URI.
+   * @return The R-Tree, or `nullptr` if it is not in the cache.
+   */
+  std::shared_ptr<const RTree> get_rtree(const URI& fragment_uri);
+
+  /**
+   * Inserts the R-Tree of the input fragment. An R-Tree larger than the
+   * cache is not inserted.
+   *
+   * @param fragment_uri The fragment URI.
+   * @param rtree The R-Tree.
+   */
+  void insert_rtree(
+      const URI& fragment_uri, const std::shared_ptr<const RTree>& rtree);
+
+  /** Returns the maximum size of the cache in bytes. */
+  uint64_t max_size() const;
+
+  /** Returns the current size of the cache in bytes. */
+  uint64_t size() const;
+
+ private:
+  /* ********************************* */
+  /*        PRIVATE DATATYPES          */
+  /* ********************************* */
+
+  /** A cached R-Tree. */
+  struct Item {
+    /** The fragment URI. */
+    std::string key_;
+    /** The R-Tree. */
+    std::shared_ptr<const RTree> rtree_;
+    /** The size charged for the R-Tree. */
+    uint64_t size_;
+  };
+
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The items, the least recently used first. */
+  std::list<Item> item_ll_;
+
+  /** Maps a key to its item. */
+  std::unordered_map<std::string, std::list<Item>::iterator> item_map_;
+
+  /** The maximum cache size. */
+  const uint64_t max_size_;
+
+  /** Protects the cache. */
+  mutable std::mutex mtx_;
+
+  /** The current cache size. */
+  uint64_t size_;
+
+  /* ********************************* */
+  /*          PRIVATE METHODS          */
+  /* ********************************* */
+
+  /** Removes the given item. */
+  void remove(std::list<Item>::iterator node);
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_INDEX_CACHE_H
@@ -0,0 +1,144 @@
+/**
+ * @file   partition_tile_cache.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2021 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * This file implements class PartitionTileCache.
+ */
+
+#include "tiledb/sm/cache/partition_tile_cache.h"
+#include "tiledb/sm/buffer/buffer.h"
+#include "tiledb/sm/misc/stats.h"
+
+namespace tiledb {
+namespace sm {
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+PartitionTileCache::PartitionTileCache()
+    : max_size_(0)
+    , partition_(0)
+    , size_(0) {
+}
+
+PartitionTileCache::~PartitionTileCache() = default;
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+void PartitionTileCache::clear() {
+  std::lock_guard<std::mutex> lock{mtx_};
+  items_.clear();
+  size_ = 0;
+}
+
+std::shared_ptr<const Buffer> PartitionTileCache::get(
+    const TileCacheKey& key, uint64_t nbytes) {
+  std::lock_guard<std::mutex> lock{mtx_};
+  auto item_it = items_.find(key);
+  if (item_it == items_.end() || item_it->second.buffer_->size() < nbytes)
+    return nullptr;
+
+  item_it->second.partition_ = partition_;
+  STATS_COUNTER_ADD(reader_partition_tile_cache_hits, 1);
+  return item_it->second.buffer_;
+}
+
+Status PartitionTileCache::insert(
+    const TileCacheKey& key, const Buffer* buffer) {
+  auto size = buffer->size();
+
+  std::lock_guard<std::mutex> lock{mtx_};
+
+  // Do nothing if the tile is cached already or does not fit in the cache
+  if (size > max_size_ || items_.count(key) != 0)
+    return Status::Ok();
+
+  // Make room with the tiles the current partition has not used. The
+  // previous partition may still have tiles that the current one will use
+  // later, but those are only kept if they fit.
+  if (size_ + size > max_size_)
+    evict_before(partition_);
+  if (size_ + size > max_size_)
+    return Status::Ok();
+
+  // Insert a private copy, as the tile may not own its data (e.g., it may
+  // point into a result buffer or a memory-mapped file)
+  auto object = std::make_shared<Buffer>();
+  RETURN_NOT_OK(object->write(buffer->data(), size));
+  items_[key] = Item{object, partition_};
+  size_ += size;
+
+  return Status::Ok();
+}
+
+uint64_t PartitionTileCache::max_size() const {
+  std::lock_guard<std::mutex> lock{mtx_};
+  return max_size_;
+}
+
+void PartitionTileCache::next_partition() {
+  std::lock_guard<std::mutex> lock{mtx_};
+  if (items_.empty())
+    return;
+  ++partition_;
+  evict_before(partition_ - 1);
+}
+
+void PartitionTileCache::set_max_size(uint64_t max_size) {
+  std::lock_guard<std::mutex> lock{mtx_};
+  max_size_ = max_size;
+  if (size_ > max_size_) {
+    items_.clear();
+    size_ = 0;
+  }
+}
+
+uint64_t PartitionTileCache::size() const {
+  std::lock_guard<std::mutex> lock{mtx_};
+  return size_;
+}
+
+/* ****************************** */
+/*         PRIVATE METHODS        */
+/* ****************************** */
+
+void PartitionTileCache::evict_before(uint64_t partition) {
+  for (auto it = items_.begin(); it != items_.end();) {
+    if (it->second.partition_ < partition) {
+      size_ -= it->second.buffer_->size();
+      it = items_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+}  // namespace sm
+}  // namespace tiledb
@@ -0,0 +1,158 @@
+/**
+ * @file   partition_tile_cache.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2021 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * This file defines class PartitionTileCache.
+ */
+
+#ifndef TILEDB_PARTITION_TILE_CACHE_H
+#define TILEDB_PARTITION_TILE_CACHE_H
+
+#include "tiledb/sm/cache/tile_cache.h"
+#include "tiledb/sm/misc/status.h"
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace tiledb {
+namespace sm {
+
+class Buffer;
+
+/**
+ * A thread-safe cache of the tiles unfiltered by the recent partitions of a
+ * single read query. Consecutive partitions of an incomplete read often
+ * overlap the same tiles at their boundaries, so a tile unfiltered for one
+ * partition is kept until the next partition has run, and is dropped after
+ * that unless the next partition used it too.
+ *
+ * Unlike the tile cache of the storage manager, the cache is private to a
+ * query, so it takes no lock shared with other queries, and it works when
+ * the tile cache is disabled.
+ */
+class PartitionTileCache {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /** Constructor. The cache is disabled until its size is set. */
+  PartitionTileCache();
+
+  /** Destructor. */
+  ~PartitionTileCache();
+
+  PartitionTileCache(const PartitionTileCache&) = delete;
+  PartitionTileCache& operator=(const PartitionTileCache&) = delete;
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /** Clears the cache. */
+  void clear();
+
+  /**
+   * Retrieves a cached tile, which is then kept for one more partition.
+   *
+   * @param key The tile key.
+   * @param nbytes The tile size. A smaller cached tile is not returned.
+   * @return The tile, or `nullptr` if it is not in the cache.
+   */
+  std::shared_ptr<const Buffer> get(const TileCacheKey& key, uint64_t nbytes);
+
+  /**
+   * Inserts a copy of an unfiltered tile. To make room, the tiles that
+   * the current partition has not used are evicted first. A tile that does
+   * not fit is not inserted.
+   *
+   * @param key The tile key.
+   * @param buffer The unfiltered tile.
+   * @return Status
+   */
+  Status insert(const TileCacheKey& key, const Buffer* buffer);
+
+  /** Returns the maximum size of the cache in bytes. */
+  uint64_t max_size() const;
+
+  /**
+   * Starts a new partition, evicting the tiles that neither the previous
+   * nor the current partition used.
+   */
+  void next_partition();
+
+  /** Sets the maximum size of the cache in bytes. `0` disables the cache. */
+  void set_max_size(uint64_t max_size);
+
+  /** Returns the current size of the cache in bytes. */
+  uint64_t size() const;
+
+ private:
+  /* ********************************* */
+  /*        PRIVATE DATATYPES          */
+  /* ********************************* */
+
+  /** A cached tile. */
+  struct Item {
+    /** The unfiltered tile. */
+    std::shared_ptr<const Buffer> buffer_;
+    /** The last partition that used the tile. */
+    uint64_t partition_;
+  };
+
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The cached tiles. */
+  std::unordered_map<TileCacheKey, Item, TileCacheKeyHasher> items_;
+
+  /** The maximum cache size. */
+  uint64_t max_size_;
+
+  /** Protects the cache. */
+  mutable std::mutex mtx_;
+
+  /** The current partition number. */
+  uint64_t partition_;
+
+  /** The current cache size. */
+  uint64_t size_;
+
+  /* ********************************* */
+  /*          PRIVATE METHODS          */
+  /* ********************************* */
+
+  /** Evicts the tiles last used before partition `partition`. */
+  void evict_before(uint64_t partition);
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_PARTITION_TILE_CACHE_H
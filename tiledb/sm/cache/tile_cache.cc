@@ -0,0 +1,372 @@
+/**
+ * @file   tile_cache.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * This file implements class TileCache.
+ */
+
+#include "tiledb/sm/cache/tile_cache.h"
+#include "tiledb/sm/buffer/buffer.h"
+#include "tiledb/sm/misc/logger.h"
+#include "tiledb/sm/misc/stats.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace tiledb {
+namespace sm {
+
+namespace {
+
+/** The share of a shard that the 2Q probation queue may occupy. */
+const uint64_t probation_share_div = 4;
+
+/** The share of a shard that the 2Q ghosts may stand for. */
+const uint64_t ghost_share_div = 2;
+
+/** Mixes the key fields with the 64-bit finalizer of MurmurHash3. */
+uint64_t hash_key(const TileCacheKey& key) {
+  auto mix = [](uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+  };
+  uint64_t h = mix(key.fragment_id_);
+  h = mix(h ^ key.file_id_);
+  h = mix(h ^ key.offset_);
+  return h;
+}
+
+}  // namespace
+
+size_t TileCacheKeyHasher::operator()(const TileCacheKey& key) const {
+  return (size_t)hash_key(key);
+}
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+TileCache::TileCache(
+    uint64_t max_size, uint64_t shard_num, Policy policy, Mode mode)
+    : max_size_(max_size)
+    , policy_(policy)
+    , mode_(mode) {
+  shard_num = std::max<uint64_t>(shard_num, 1);
+  shard_max_size_ = max_size / shard_num;
+  for (uint64_t i = 0; i < shard_num; ++i)
+    shards_.emplace_back(new Shard());
+}
+
+TileCache::~TileCache() {
+  clear();
+}
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+void TileCache::clear() {
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock{shard->mtx_};
+    shard->item_ll_.clear();
+    shard->probation_ll_.clear();
+    shard->item_map_.clear();
+    shard->ghost_ll_.clear();
+    shard->ghost_map_.clear();
+    shard->size_ = 0;
+    shard->probation_size_ = 0;
+    shard->ghost_size_ = 0;
+  }
+}
+
+Status TileCache::insert(
+    const TileCacheKey& key,
+    const std::shared_ptr<const Buffer>& object,
+    bool overwrite) {
+  STATS_FUNC_IN(cache_tile_insert);
+
+  if (object == nullptr)
+    return LOG_STATUS(Status::LRUCacheError(
+        "Cannot insert into cache; Object cannot be null"));
+
+  // Do nothing if the object size is bigger than a shard
+  uint64_t size = object->size();
+  if (size > shard_max_size_)
+    return Status::Ok();
+
+  auto s = shard(key);
+  std::lock_guard<std::mutex> lock{s->mtx_};
+
+  auto item_it = s->item_map_.find(key);
+  bool exists = item_it != s->item_map_.end();
+  if (exists && !overwrite)
+    return Status::Ok();
+
+  if (exists) {
+    // Replace cache item. A main item becomes the most recently used, while
+    // a probation item keeps its place in the queue.
+    auto node = item_it->second;
+    s->size_ -= node->object_->size();
+    if (node->probation_) {
+      s->probation_size_ -= node->object_->size();
+      s->probation_size_ += size;
+    } else {
+      s->item_ll_.splice(s->item_ll_.end(), s->item_ll_, node);
+    }
+    node->object_ = object;
+  } else {
+    // Under 2Q, only an object remembered by a ghost enters the main list
+    bool probation = false;
+    if (policy_ == Policy::TWO_Q) {
+      auto ghost_it = s->ghost_map_.find(key);
+      if (ghost_it == s->ghost_map_.end()) {
+        probation = true;
+      } else {
+        s->ghost_size_ -= ghost_it->second->size_;
+        s->ghost_ll_.erase(ghost_it->second);
+        s->ghost_map_.erase(ghost_it);
+        STATS_COUNTER_ADD(cache_tile_ghost_admissions, 1);
+      }
+    }
+    auto& ll = probation ? s->probation_ll_ : s->item_ll_;
+    ll.push_back({key, object, probation});
+    s->item_map_[key] = std::prev(ll.end());
+    if (probation)
+      s->probation_size_ += size;
+  }
+  s->size_ += size;
+
+  // Evict if necessary. Under LRU the new item is the most recently used,
+  // so it is never evicted.
+  while (s->size_ > shard_max_size_)
+    evict(s);
+
+  STATS_COUNTER_ADD(cache_tile_inserts, 1);
+
+  return Status::Ok();
+
+  STATS_FUNC_OUT(cache_tile_insert);
+}
+
+Status TileCache::invalidate(const TileCacheKey& key, bool* success) {
+  STATS_FUNC_IN(cache_tile_invalidate);
+
+  auto s = shard(key);
+  std::lock_guard<std::mutex> lock{s->mtx_};
+
+  auto item_it = s->item_map_.find(key);
+  if (item_it == s->item_map_.end()) {
+    *success = false;
+    return Status::Ok();
+  }
+
+  remove(s, item_it->second);
+  *success = true;
+
+  return Status::Ok();
+
+  STATS_FUNC_OUT(cache_tile_invalidate);
+}
+
+uint64_t TileCache::max_object_size() const {
+  return shard_max_size_;
+}
+
+uint64_t TileCache::max_size() const {
+  return max_size_;
+}
+
+Status TileCache::pin(
+    const TileCacheKey& key, std::shared_ptr<const Buffer>* object) {
+  STATS_FUNC_IN(cache_tile_pin);
+
+  auto s = shard(key);
+  std::lock_guard<std::mutex> lock{s->mtx_};
+
+  auto item_it = s->item_map_.find(key);
+  if (item_it == s->item_map_.end()) {
+    object->reset();
+    STATS_COUNTER_ADD(cache_tile_read_misses, 1);
+    return Status::Ok();
+  }
+
+  // Make a main item the most recently used. Probation is a FIFO queue, so
+  // a probation item stays where it is.
+  auto node = item_it->second;
+  *object = node->object_;
+  if (!node->probation_)
+    s->item_ll_.splice(s->item_ll_.end(), s->item_ll_, node);
+  STATS_COUNTER_ADD(cache_tile_read_hits, 1);
+
+  return Status::Ok();
+
+  STATS_FUNC_OUT(cache_tile_pin);
+}
+
+Status TileCache::read(
+    const TileCacheKey& key,
+    Buffer* buffer,
+    uint64_t offset,
+    uint64_t nbytes,
+    bool* success) {
+  STATS_FUNC_IN(cache_tile_read);
+
+  *success = false;
+  std::shared_ptr<const Buffer> object;
+  RETURN_NOT_OK(pin(key, &object));
+  if (object == nullptr)
+    return Status::Ok();
+
+  // Copy from the pinned object, outside the shard lock
+  if (object->size() < offset + nbytes) {
+    return LOG_STATUS(Status::LRUCacheError(
+        "Failed to read item; Byte range out of bounds"));
+  }
+  RETURN_NOT_OK(buffer->write((const char*)object->data() + offset, nbytes));
+  *success = true;
+
+  return Status::Ok();
+
+  STATS_FUNC_OUT(cache_tile_read);
+}
+
+TileCache::Policy TileCache::policy() const {
+  return policy_;
+}
+
+TileCache::Mode TileCache::mode() const {
+  return mode_;
+}
+
+Status TileCache::policy_from_str(const std::string& str, Policy* policy) {
+  if (str == "lru")
+    *policy = Policy::LRU;
+  else if (str == "2q")
+    *policy = Policy::TWO_Q;
+  else
+    return LOG_STATUS(Status::LRUCacheError(
+        "Cannot parse tile cache policy; Unknown policy '" + str + "'"));
+
+  return Status::Ok();
+}
+
+Status TileCache::mode_from_str(const std::string& str, Mode* mode) {
+  if (str == "unfiltered")
+    *mode = Mode::UNFILTERED;
+  else if (str == "filtered")
+    *mode = Mode::FILTERED;
+  else if (str == "auto")
+    *mode = Mode::AUTO;
+  else
+    return LOG_STATUS(Status::LRUCacheError(
+        "Cannot parse tile cache mode; Unknown mode '" + str + "'"));
+
+  return Status::Ok();
+}
+
+uint64_t TileCache::shard_num() const {
+  return shards_.size();
+}
+
+uint64_t TileCache::size() const {
+  uint64_t size = 0;
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock{shard->mtx_};
+    size += shard->size_;
+  }
+  return size;
+}
+
+/* ****************************** */
+/*          PRIVATE METHODS       */
+/* ****************************** */
+
+void TileCache::add_ghost(
+    Shard* shard, const TileCacheKey& key, uint64_t size) {
+  if (shard->ghost_map_.count(key) == 0) {
+    shard->ghost_ll_.push_back({key, size});
+    shard->ghost_map_[key] = std::prev(shard->ghost_ll_.end());
+    shard->ghost_size_ += size;
+  }
+
+  while (shard->ghost_size_ > shard_max_size_ / ghost_share_div &&
+         !shard->ghost_ll_.empty()) {
+    auto& ghost = shard->ghost_ll_.front();
+    shard->ghost_size_ -= ghost.size_;
+    shard->ghost_map_.erase(ghost.key_);
+    shard->ghost_ll_.pop_front();
+  }
+}
+
+void TileCache::evict(Shard* shard) {
+  STATS_FUNC_VOID_IN(cache_tile_evict);
+
+  bool from_probation =
+      !shard->probation_ll_.empty() &&
+      (shard->probation_size_ > shard_max_size_ / probation_share_div ||
+       shard->item_ll_.empty());
+  if (from_probation) {
+    auto node = shard->probation_ll_.begin();
+    add_ghost(shard, node->key_, node->object_->size());
+    remove(shard, node);
+  } else {
+    assert(!shard->item_ll_.empty());
+    remove(shard, shard->item_ll_.begin());
+  }
+  STATS_COUNTER_ADD(cache_tile_evictions, 1);
+
+  STATS_FUNC_VOID_OUT(cache_tile_evict);
+}
+
+void TileCache::remove(Shard* shard, std::list<Item>::iterator node) {
+  // A pinned object is only released here by the cache; it is freed when
+  // its last user unpins it.
+  STATS_COUNTER_ADD_IF(
+      node->object_.use_count() > 1, cache_tile_pinned_evictions, 1);
+  auto size = node->object_->size();
+  shard->size_ -= size;
+  shard->item_map_.erase(node->key_);
+  if (node->probation_) {
+    shard->probation_size_ -= size;
+    shard->probation_ll_.erase(node);
+  } else {
+    shard->item_ll_.erase(node);
+  }
+}
+
+TileCache::Shard* TileCache::shard(const TileCacheKey& key) const {
+  // The upper bits pick the shard, so that the shard does not correlate
+  // with the hash table bucket within it.
+  return shards_[(hash_key(key) >> 32) % shards_.size()].get();
+}
+
+}  // namespace sm
+}  // namespace tiledb
@@ -0,0 +1,345 @@
+/**
+ * @file   tile_cache.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * This file defines class TileCache.
+ */
+
+#ifndef TILEDB_TILE_CACHE_H
+#define TILEDB_TILE_CACHE_H
+
+#include "tiledb/sm/misc/status.h"
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tiledb {
+namespace sm {
+
+class Buffer;
+
+/**
+ * The location of a cached tile: the fragment it belongs to, the file of
+ * the attribute or dimension within the fragment, and the tile offset in
+ * that file.
+ */
+struct TileCacheKey {
+  /** The fragment id (see `FragmentMetadata::id`). */
+  uint64_t fragment_id_;
+  /** The file id within the fragment (see `FragmentMetadata::file_id`). */
+  uint64_t file_id_;
+  /** The offset of the tile in the file. */
+  uint64_t offset_;
+
+  /** Equality operator. */
+  bool operator==(const TileCacheKey& key) const {
+    return fragment_id_ == key.fragment_id_ && file_id_ == key.file_id_ &&
+           offset_ == key.offset_;
+  }
+};
+
+/** Hashes a tile cache key. */
+struct TileCacheKeyHasher {
+  size_t operator()(const TileCacheKey& key) const;
+};
+
+/**
+ * A thread-safe LRU cache of tiles. The cache is split into
+ * shards, each with its own lock, LRU list and an equal part of the
+ * capacity, and every key maps to a single shard by hash. Threads that
+ * access different shards never contend.
+ *
+ * The eviction policy is either plain LRU, or 2Q. Under 2Q, a newly
+ * inserted object first enters a FIFO probation queue that holds at most a
+ * quarter of the shard. Objects evicted from probation leave a "ghost"
+ * entry (their key only) behind, and only an object that is inserted again
+ * while its ghost is remembered is admitted to the main LRU list. A single
+ * large scan therefore only cycles through the probation queue and does not
+ * evict the frequently used objects of the main list.
+ *
+ * Cached objects are immutable, reference-counted buffers. A reader pins
+ * an object by holding the pointer returned by `pin`, and unpins it by
+ * releasing the pointer. Eviction only drops the reference of the cache,
+ * so a pinned object stays valid until its last user releases it; while
+ * pinned, the memory of an evicted object is not counted in the cache
+ * size.
+ *
+ * The cache mode tells whether the reader caches tiles unfiltered, or as
+ * the filtered bytes persisted in the fragment, which hold more tiles in
+ * the same capacity at the cost of unfiltering them on every hit.
+ */
+class TileCache {
+ public:
+  /* ********************************* */
+  /*           PUBLIC DATATYPES        */
+  /* ********************************* */
+
+  /** The eviction and admission policy. */
+  enum class Policy {
+    /** Least recently used. */
+    LRU,
+    /** 2Q: probation FIFO, ghost keys and a main LRU list. */
+    TWO_Q
+  };
+
+  /** The form in which the reader caches tiles. */
+  enum class Mode {
+    /** Unfiltered (decompressed) tiles, ready to be copied on a hit. */
+    UNFILTERED,
+    /** Filtered (persisted) tiles, unfiltered again on every hit. */
+    FILTERED,
+    /**
+     * Filtered tiles for the attributes whose filter pipeline compresses
+     * with a fast decompressor, unfiltered tiles otherwise.
+     */
+    AUTO
+  };
+
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /**
+   * Constructor.
+   *
+   * @param max_size The maximum cache size, over all shards.
+   * @param shard_num The number of shards (`0` is treated as `1`).
+   * @param policy The eviction and admission policy.
+   * @param mode The form in which the reader caches tiles.
+   */
+  TileCache(
+      uint64_t max_size,
+      uint64_t shard_num,
+      Policy policy = Policy::LRU,
+      Mode mode = Mode::UNFILTERED);
+
+  /** Destructor. */
+  ~TileCache();
+
+  TileCache(const TileCache&) = delete;
+  TileCache& operator=(const TileCache&) = delete;
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /** Clears the cache, deleting all cached items. */
+  void clear();
+
+  /**
+   * Inserts an object with a given key into the cache. The object must not
+   * be modified after insertion.
+   *
+   * @param key The key that describes the inserted object.
+   * @param object The object to be stored.
+   * @param overwrite If `true`, if the object exists in the cache it will be
+   *     overwritten. Otherwise, the new object is not inserted.
+   * @return Status
+   */
+  Status insert(
+      const TileCacheKey& key,
+      const std::shared_ptr<const Buffer>& object,
+      bool overwrite);
+
+  /**
+   * Invalidates and evicts the object in the cache with the given key.
+   *
+   * @param key The key that describes the object to be invalidated.
+   * @param success Set to `true` if the object was removed successfully; if
+   *    the object did not exist in the cache, set to `false`.
+   * @return Status
+   */
+  Status invalidate(const TileCacheKey& key, bool* success);
+
+  /** Returns the maximum size of an object that can be cached. */
+  uint64_t max_object_size() const;
+
+  /** Returns the maximum size of the cache in bytes. */
+  uint64_t max_size() const;
+
+  /**
+   * Pins the object labeled by `key`, without copying it. The object stays
+   * valid for as long as `object` (or a copy of it) is held, even if it is
+   * evicted in the meantime.
+   *
+   * @param key The label of the object to be pinned.
+   * @param object Set to the cached object, or to `nullptr` if it is not in
+   *     the cache.
+   * @return Status.
+   */
+  Status pin(const TileCacheKey& key, std::shared_ptr<const Buffer>* object);
+
+  /**
+   * Reads a portion of the object labeled by `key`.
+   *
+   * @param key The label of the object to be read.
+   * @param buffer The buffer that will store the data to be read.
+   * @param offset The offset where the read will start.
+   * @param nbytes The number of bytes to be read.
+   * @param success `true` if the data were read from the cache and `false`
+   *     otherwise.
+   * @return Status.
+   */
+  Status read(
+      const TileCacheKey& key,
+      Buffer* buffer,
+      uint64_t offset,
+      uint64_t nbytes,
+      bool* success);
+
+  /** Returns the eviction and admission policy. */
+  Policy policy() const;
+
+  /** Returns the form in which the reader caches tiles. */
+  Mode mode() const;
+
+  /**
+   * Parses a policy from its configuration value (`lru` or `2q`).
+   *
+   * @param str The policy name.
+   * @param policy Set to the parsed policy.
+   * @return Status
+   */
+  static Status policy_from_str(const std::string& str, Policy* policy);
+
+  /**
+   * Parses a cache mode from its configuration value (`unfiltered`,
+   * `filtered` or `auto`).
+   *
+   * @param str The mode name.
+   * @param mode Set to the parsed mode.
+   * @return Status
+   */
+  static Status mode_from_str(const std::string& str, Mode* mode);
+
+  /** Returns the number of shards. */
+  uint64_t shard_num() const;
+
+  /** Returns the current size of cache in bytes, over all shards. */
+  uint64_t size() const;
+
+ private:
+  /* ********************************* */
+  /*        PRIVATE DATATYPES          */
+  /* ********************************* */
+
+  /** A cached object. */
+  struct Item {
+    /** The object key. */
+    TileCacheKey key_;
+    /** The object. */
+    std::shared_ptr<const Buffer> object_;
+    /** `true` if the item is in the probation queue (2Q only). */
+    bool probation_;
+  };
+
+  /** The key and size of an object evicted from probation (2Q only). */
+  struct Ghost {
+    /** The object key. */
+    TileCacheKey key_;
+    /** The object size. */
+    uint64_t size_;
+  };
+
+  /** An independently locked part of the cache. */
+  struct Shard {
+    /** Protects the shard. */
+    std::mutex mtx_;
+    /** The main items, the least recently used first. */
+    std::list<Item> item_ll_;
+    /** The probation items, the oldest first (2Q only). */
+    std::list<Item> probation_ll_;
+    /** Maps a key to its item, in either list. */
+    std::unordered_map<
+        TileCacheKey,
+        std::list<Item>::iterator,
+        TileCacheKeyHasher>
+        item_map_;
+    /** The ghosts, the oldest first (2Q only). */
+    std::list<Ghost> ghost_ll_;
+    /** Maps a key to its ghost. */
+    std::unordered_map<
+        TileCacheKey,
+        std::list<Ghost>::iterator,
+        TileCacheKeyHasher>
+        ghost_map_;
+    /** The current shard size. */
+    uint64_t size_ = 0;
+    /** The current size of the probation items. */
+    uint64_t probation_size_ = 0;
+    /** The total size of the objects the ghosts stand for. */
+    uint64_t ghost_size_ = 0;
+  };
+
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The maximum cache size. */
+  uint64_t max_size_;
+
+  /** The maximum size of each shard. */
+  uint64_t shard_max_size_;
+
+  /** The eviction and admission policy. */
+  Policy policy_;
+
+  /** The form in which the reader caches tiles. */
+  Mode mode_;
+
+  /** The shards. */
+  std::vector<std::unique_ptr<Shard>> shards_;
+
+  /* ********************************* */
+  /*          PRIVATE METHODS          */
+  /* ********************************* */
+
+  /** Adds a ghost for the given object and trims the oldest ghosts. */
+  void add_ghost(Shard* shard, const TileCacheKey& key, uint64_t size);
+
+  /**
+   * Evicts an object of the shard, as dictated by the policy: the oldest
+   * probation object if the probation queue is over its share, or else the
+   * least recently used main object.
+   */
+  void evict(Shard* shard);
+
+  /** Removes the given item from the shard. */
+  void remove(Shard* shard, std::list<Item>::iterator node);
+
+  /** Returns the shard of the given key. */
+  Shard* shard(const TileCacheKey& key) const;
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_TILE_CACHE_H
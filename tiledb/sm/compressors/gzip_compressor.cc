@@ -43,6 +43,63 @@
 namespace tiledb {
 namespace sm {
 
+namespace {
+
+/**
+ * A zlib stream owned by a single thread, initialized on first use and reset
+ * (instead of re-initialized) between calls, so that the deflate/inflate
+ * state is allocated once per thread rather than once per chunk.
+ */
+struct ThreadStream {
+  /** The zlib stream. */
+  z_stream strm_;
+  /** `true` if `strm_` has been initialized. */
+  bool init_ = false;
+  /** `true` for a deflate stream, `false` for an inflate stream. */
+  const bool deflate_;
+  /** The level the deflate stream was initialized with. */
+  int level_ = 0;
+
+  explicit ThreadStream(bool deflate)
+      : deflate_(deflate) {
+  }
+
+  ~ThreadStream() {
+    if (init_)
+      (void)(deflate_ ? deflateEnd(&strm_) : inflateEnd(&strm_));
+  }
+
+  /** Returns the reset stream, or `nullptr` if it cannot be initialized. */
+  z_stream* get(int level) {
+    if (init_ && deflate_ && level != level_) {
+      (void)deflateEnd(&strm_);
+      init_ = false;
+    }
+
+    if (init_) {
+      int ret = deflate_ ? deflateReset(&strm_) : inflateReset(&strm_);
+      return ret == Z_OK ? &strm_ : nullptr;
+    }
+
+    strm_.zalloc = Z_NULL;
+    strm_.zfree = Z_NULL;
+    strm_.opaque = Z_NULL;
+    strm_.avail_in = 0;
+    strm_.next_in = Z_NULL;
+    int ret = deflate_ ? deflateInit(&strm_, level) : inflateInit(&strm_);
+    if (ret != Z_OK) {
+      if (deflate_)
+        (void)deflateEnd(&strm_);
+      return nullptr;
+    }
+    init_ = true;
+    level_ = level;
+    return &strm_;
+  }
+};
+
+}  // namespace
+
 Status GZip::compress(
     int level, ConstBuffer* input_buffer, Buffer* output_buffer) {
   STATS_FUNC_IN(compressor_gzip_compress);
@@ -52,36 +109,26 @@ Status GZip::compress(
     return LOG_STATUS(Status::CompressionError(
         "Failed compressing with GZip; invalid buffer format"));
 
-  int ret;
-  z_stream strm;
-
-  // Allocate deflate state
-  strm.zalloc = Z_NULL;
-  strm.zfree = Z_NULL;
-  strm.opaque = Z_NULL;
-  ret = deflateInit(&strm, level < 0 ? GZip::default_level() : level);
-
-  if (ret != Z_OK) {
-    (void)deflateEnd(&strm);
+  // Get the thread's deflate state
+  static thread_local ThreadStream thread_strm(true);
+  z_stream* strm =
+      thread_strm.get(level < 0 ? GZip::default_level() : level);
+  if (strm == nullptr)
     return LOG_STATUS(Status::GZipError("Cannot compress with GZIP"));
-  }
 
   // Compress
-  strm.next_in = (unsigned char*)input_buffer->data();
-  strm.next_out = (unsigned char*)output_buffer->cur_data();
-  strm.avail_in = (uInt)input_buffer->size();
-  strm.avail_out = (uInt)output_buffer->free_space();
-  ret = deflate(&strm, Z_FINISH);
-
-  // Clean up
-  (void)deflateEnd(&strm);
+  strm->next_in = (unsigned char*)input_buffer->data();
+  strm->next_out = (unsigned char*)output_buffer->cur_data();
+  strm->avail_in = (uInt)input_buffer->size();
+  strm->avail_out = (uInt)output_buffer->free_space();
+  int ret = deflate(strm, Z_FINISH);
 
   // Return
-  if (ret == Z_STREAM_ERROR || strm.avail_in != 0)
+  if (ret == Z_STREAM_ERROR || strm->avail_in != 0)
     return LOG_STATUS(Status::GZipError("Cannot compress with GZIP"));
 
   // Set size of compressed data
-  uint64_t compressed_size = output_buffer->free_space() - strm.avail_out;
+  uint64_t compressed_size = output_buffer->free_space() - strm->avail_out;
   output_buffer->advance_size(compressed_size);
   output_buffer->advance_offset(compressed_size);
 
@@ -99,27 +146,18 @@ Status GZip::decompress(
     return LOG_STATUS(Status::CompressionError(
         "Failed decompressing with GZip; invalid buffer format"));
 
-  int ret;
-  z_stream strm;
-
-  // Allocate deflate state
-  strm.zalloc = Z_NULL;
-  strm.zfree = Z_NULL;
-  strm.opaque = Z_NULL;
-  strm.avail_in = 0;
-  strm.next_in = Z_NULL;
-  ret = inflateInit(&strm);
-
-  if (ret != Z_OK) {
+  // Get the thread's inflate state
+  static thread_local ThreadStream thread_strm(false);
+  z_stream* strm = thread_strm.get(0);
+  if (strm == nullptr)
     return LOG_STATUS(Status::GZipError("Cannot decompress with GZIP"));
-  }
 
   // Decompress
-  strm.next_in = (unsigned char*)input_buffer->data();
-  strm.next_out = (unsigned char*)output_buffer->cur_data();
-  strm.avail_in = (uInt)input_buffer->size();
-  strm.avail_out = (uInt)output_buffer->free_space();
-  ret = inflate(&strm, Z_FINISH);
+  strm->next_in = (unsigned char*)input_buffer->data();
+  strm->next_out = (unsigned char*)output_buffer->cur_data();
+  strm->avail_in = (uInt)input_buffer->size();
+  strm->avail_out = (uInt)output_buffer->free_space();
+  int ret = inflate(strm, Z_FINISH);
 
   if (ret != Z_STREAM_END) {
     return LOG_STATUS(
@@ -127,12 +165,9 @@ Status GZip::decompress(
   }
 
   // Set size of decompressed data
-  uint64_t compressed_size = output_buffer->free_space() - strm.avail_out;
+  uint64_t compressed_size = output_buffer->free_space() - strm->avail_out;
   output_buffer->advance_offset(compressed_size);
 
-  // Clean up
-  (void)inflateEnd(&strm);
-
   // Success
   return Status::Ok();
 
@@ -39,6 +39,7 @@
 
 #include <lz4.h>
 #include <limits>
+#include <vector>
 
 namespace tiledb {
 namespace sm {
@@ -56,11 +57,15 @@ Status LZ4::compress(
   (void)level;
 // Compress
 #if LZ4_VERSION_NUMBER >= 10705
-  int ret = LZ4_compress_default(
+  // Reuse the thread's compression state across chunks and tiles
+  static thread_local std::vector<char> state(LZ4_sizeofState());
+  int ret = LZ4_compress_fast_extState(
+      state.data(),
       (char*)input_buffer->data(),
       (char*)output_buffer->cur_data(),
       (int)input_buffer->size(),
-      (int)output_buffer->free_space());
+      (int)output_buffer->free_space(),
+      1);
 #else
   // deprecated lz4 api
   int ret = LZ4_compress(
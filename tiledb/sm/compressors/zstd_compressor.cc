@@ -37,14 +37,47 @@
 #include "tiledb/sm/misc/logger.h"
 #include "tiledb/sm/misc/stats.h"
 
+#include <zdict.h>
 #include <zstd.h>
 #include <iostream>
+#include <memory>
 
 namespace tiledb {
 namespace sm {
 
+namespace {
+
+/**
+ * Returns the compression context of the calling thread. The context is
+ * created on first use and reused across all the chunks and tiles the
+ * thread compresses, avoiding a context allocation per chunk.
+ */
+ZSTD_CCtx* thread_compress_ctx() {
+  static thread_local std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)>
+      ctx(ZSTD_createCCtx(), ZSTD_freeCCtx);
+  return ctx.get();
+}
+
+/** Returns the decompression context of the calling thread. */
+ZSTD_DCtx* thread_decompress_ctx() {
+  static thread_local std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)>
+      ctx(ZSTD_createDCtx(), ZSTD_freeDCtx);
+  return ctx.get();
+}
+
+}  // namespace
+
 Status ZStd::compress(
     int level, ConstBuffer* input_buffer, Buffer* output_buffer) {
+  return compress(level, nullptr, 0, input_buffer, output_buffer);
+}
+
+Status ZStd::compress(
+    int level,
+    const void* dict,
+    uint64_t dict_size,
+    ConstBuffer* input_buffer,
+    Buffer* output_buffer) {
   STATS_FUNC_IN(compressor_zstd_compress);
 
   // Sanity check
@@ -52,20 +85,21 @@ Status ZStd::compress(
     return LOG_STATUS(Status::CompressionError(
         "Failed compressing with ZStd; invalid buffer format"));
 
-  // Create context
-  std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> ctx(
-      ZSTD_createCCtx(), ZSTD_freeCCtx);
-  if (ctx.get() == nullptr)
+  // Get the thread's context
+  ZSTD_CCtx* ctx = thread_compress_ctx();
+  if (ctx == nullptr)
     return LOG_STATUS(Status::CompressionError(
         std::string("ZStd compression failed; could not allocate context.")));
 
   // Compress
-  uint64_t zstd_ret = ZSTD_compressCCtx(
-      ctx.get(),
+  uint64_t zstd_ret = ZSTD_compress_usingDict(
+      ctx,
       output_buffer->cur_data(),
       output_buffer->free_space(),
       input_buffer->data(),
       input_buffer->size(),
+      dict,
+      dict_size,
       level < 0 ? ZStd::default_level() : level);
 
   // Handle error
@@ -86,6 +120,14 @@ Status ZStd::compress(
 
 Status ZStd::decompress(
     ConstBuffer* input_buffer, PreallocatedBuffer* output_buffer) {
+  return decompress(nullptr, 0, input_buffer, output_buffer);
+}
+
+Status ZStd::decompress(
+    const void* dict,
+    uint64_t dict_size,
+    ConstBuffer* input_buffer,
+    PreallocatedBuffer* output_buffer) {
   STATS_FUNC_IN(compressor_zstd_decompress);
 
   // Sanity check
@@ -93,20 +135,21 @@ Status ZStd::decompress(
     return LOG_STATUS(Status::CompressionError(
         "Failed decompressing with ZStd; invalid buffer format"));
 
-  // Create context
-  std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> ctx(
-      ZSTD_createDCtx(), ZSTD_freeDCtx);
-  if (ctx.get() == nullptr)
+  // Get the thread's context
+  ZSTD_DCtx* ctx = thread_decompress_ctx();
+  if (ctx == nullptr)
     return LOG_STATUS(Status::CompressionError(
         std::string("ZStd decompression failed; could not allocate context.")));
 
   // Decompress
-  uint64_t zstd_ret = ZSTD_decompressDCtx(
-      ctx.get(),
+  uint64_t zstd_ret = ZSTD_decompress_usingDict(
+      ctx,
       output_buffer->cur_data(),
       output_buffer->free_space(),
       input_buffer->data(),
-      input_buffer->size());
+      input_buffer->size(),
+      dict,
+      dict_size);
 
   // Check error
   if (ZSTD_isError(zstd_ret) != 0) {
@@ -123,6 +166,30 @@ Status ZStd::decompress(
   STATS_FUNC_OUT(compressor_zstd_decompress);
 }
 
+Status ZStd::train_dictionary(
+    const void* samples,
+    const std::vector<size_t>& sample_sizes,
+    uint32_t max_size,
+    std::vector<uint8_t>* dict) {
+  dict->resize(max_size);
+  size_t zstd_ret = ZDICT_trainFromBuffer(
+      dict->data(),
+      max_size,
+      samples,
+      sample_sizes.data(),
+      (unsigned)sample_sizes.size());
+
+  // Too few or too uniform samples are not an error; the data is simply
+  // compressed without a dictionary
+  if (ZDICT_isError(zstd_ret) != 0) {
+    dict->clear();
+    return Status::Ok();
+  }
+
+  dict->resize(zstd_ret);
+  return Status::Ok();
+}
+
 uint64_t ZStd::overhead(uint64_t nbytes) {
   return ZSTD_compressBound(nbytes) - nbytes;
 }
@@ -35,6 +35,8 @@
 
 #include "tiledb/sm/misc/status.h"
 
+#include <vector>
+
 namespace tiledb {
 namespace sm {
 
@@ -56,6 +58,23 @@ class ZStd {
   static Status compress(
       int level, ConstBuffer* input_buffer, Buffer* output_buffer);
 
+  /**
+   * Compression function using a dictionary.
+   *
+   * @param level Compression level.
+   * @param dict The dictionary (may be `nullptr` for no dictionary).
+   * @param dict_size The dictionary size in bytes.
+   * @param input_buffer Input buffer to read from.
+   * @param output_buffer Output buffer to write to the compressed data.
+   * @return Status
+   */
+  static Status compress(
+      int level,
+      const void* dict,
+      uint64_t dict_size,
+      ConstBuffer* input_buffer,
+      Buffer* output_buffer);
+
   /**
    * Decompression function.
    *
@@ -66,6 +85,38 @@ class ZStd {
   static Status decompress(
       ConstBuffer* input_buffer, PreallocatedBuffer* output_buffer);
 
+  /**
+   * Decompression function using the dictionary the data was compressed with.
+   *
+   * @param dict The dictionary (may be `nullptr` for no dictionary).
+   * @param dict_size The dictionary size in bytes.
+   * @param input_buffer Input buffer to read from.
+   * @param output_buffer Output buffer to write the decompressed data to.
+   * @return Status
+   */
+  static Status decompress(
+      const void* dict,
+      uint64_t dict_size,
+      ConstBuffer* input_buffer,
+      PreallocatedBuffer* output_buffer);
+
+  /**
+   * Trains a dictionary from the input samples, which are stored
+   * contiguously. If the samples are not sufficient for training, the
+   * dictionary is left empty and the function still succeeds.
+   *
+   * @param samples The concatenated samples.
+   * @param sample_sizes The size of each sample.
+   * @param max_size The max dictionary size.
+   * @param dict The trained dictionary.
+   * @return Status
+   */
+  static Status train_dictionary(
+      const void* samples,
+      const std::vector<size_t>& sample_sizes,
+      uint32_t max_size,
+      std::vector<uint8_t>* dict);
+
   /** Returns the default compression level. */
   static int default_level() {
     return 5;
@@ -51,17 +51,58 @@ const std::string Config::REST_SERVER_DEFAULT_ADDRESS =
     "https://api.tiledb.com";
 const std::string Config::REST_SERIALIZATION_DEFAULT_FORMAT = "CAPNP";
 const std::string Config::REST_SERVER_DEFAULT_HTTP_COMPRESSOR = "any";
+const std::string Config::REST_SERVER_DEFAULT_HTTP_REQUEST_COMPRESSOR = "none";
+const std::string Config::REST_SERVER_DEFAULT_CACHE_TTL_MS = "0";
+const std::string Config::REST_SERVER_DEFAULT_READ_PARTITION_NUM = "1";
 const std::string Config::SM_DEDUP_COORDS = "false";
 const std::string Config::SM_CHECK_COORD_DUPS = "true";
 const std::string Config::SM_CHECK_COORD_OOB = "true";
 const std::string Config::SM_CHECK_GLOBAL_ORDER = "true";
 const std::string Config::SM_TILE_CACHE_SIZE = "10000000";
+const std::string Config::SM_TILE_CACHE_SHARDS = "8";
+const std::string Config::SM_TILE_CACHE_POLICY = "lru";
+const std::string Config::SM_TILE_CACHE_MODE = "unfiltered";
+const std::string Config::SM_TILE_DISK_CACHE_DIR = "";
+const std::string Config::SM_TILE_DISK_CACHE_SIZE = "1073741824";
+const std::string Config::SM_READ_PREFETCH = "false";
+const std::string Config::SM_READ_PLANNER = "none";
+const std::string Config::SM_EAGER_METADATA_LOAD = "false";
+const std::string Config::SM_PARTITIONER_BALANCED_SPLITS = "false";
+const std::string Config::SM_PARTITION_TILE_CACHE_RATIO = "0.1";
+const std::string Config::SM_WRITE_ASYNC_FLUSH = "false";
+const std::string Config::SM_WRITE_BUFFER_MAX_SIZE = "0";
+const std::string Config::SM_WRITE_BUFFER_MAX_AGE_MS = "0";
+const std::string Config::SM_UNORDERED_WRITE_FRAGMENT_NUM = "1";
+const std::string Config::SM_CAPACITY_TARGET_TILE_SIZE = "0";
+const std::string Config::SM_FRAGMENT_METADATA_CACHE_SIZE = "10000000";
+const std::string Config::SM_FRAGMENT_METADATA_SPECULATIVE_READ_SIZE = "65536";
+const std::string Config::SM_FRAGMENT_METADATA_UNFILTERED = "false";
+const std::string Config::SM_FRAGMENT_PACKING_MAX_SIZE = "0";
+const std::string Config::SM_INDEX_CACHE_SIZE = "100000000";
+const std::string Config::SM_EMPTY_SUBARRAY_CACHE_SIZE = "0";
+const std::string Config::SM_VAR_OFFSETS_BITSIZE = "64";
+const std::string Config::SM_VAR_OFFSETS_EXTRA_ELEMENT = "false";
+const std::string Config::SM_VAR_OFFSETS_MODE = "bytes";
+const std::string Config::SM_COORDS_BLOOM_FILTER_BITS = "0";
+const std::string Config::SM_RTREE_STR_PACKING = "false";
+const std::string Config::SM_FRAGMENT_SKETCHES = "false";
+const std::string Config::SM_VALUE_INDEX_ATTRIBUTES = "";
+const std::string Config::SM_ARRAY_MANIFEST = "false";
+const std::string Config::SM_BUFFER_POOL_SIZE = "0";
+const std::string Config::SM_BUFFER_POOL_HUGE_PAGES = "false";
 const std::string Config::SM_MEMORY_BUDGET = "5368709120";       // 5GB
 const std::string Config::SM_MEMORY_BUDGET_VAR = "10737418240";  // 10GB;
 const std::string Config::SM_ENABLE_SIGNAL_HANDLERS = "true";
 const std::string Config::SM_NUM_ASYNC_THREADS = "1";
 const std::string Config::SM_NUM_READER_THREADS = "1";
 const std::string Config::SM_NUM_WRITER_THREADS = "1";
+const std::string Config::SM_NUM_FRAGMENT_METADATA_THREADS = "0";
+const std::string Config::SM_NUM_SCHEDULER_THREADS = "0";
+const std::string Config::SM_NUMA_PINNING = "false";
+const std::string Config::SM_STATS_SAMPLE_RATE = "0.0";
+const std::string Config::SM_STATS_SAMPLE_TRACES = "false";
+const std::string Config::SM_STATS_SLOW_QUERY_THRESHOLD_MS = "0";
+const std::string Config::SM_STATS_SLOW_QUERY_LOG = "";
 #ifdef HAVE_TBB
 const std::string Config::SM_NUM_TBB_THREADS =
     utils::parse::to_str((int)tbb::task_scheduler_init::automatic);
@@ -74,13 +115,36 @@ const std::string Config::SM_CONSOLIDATION_STEPS = "4294967295";
 const std::string Config::SM_CONSOLIDATION_STEP_MIN_FRAGS = "4294967295";
 const std::string Config::SM_CONSOLIDATION_STEP_MAX_FRAGS = "4294967295";
 const std::string Config::SM_CONSOLIDATION_STEP_SIZE_RATIO = "0.0";
+const std::string Config::SM_CONSOLIDATION_TILE_COPY = "true";
+const std::string Config::SM_CONSOLIDATION_TIMESTAMP_START = "0";
+const std::string Config::SM_CONSOLIDATION_TIMESTAMP_END =
+    "18446744073709551615";
+const std::string Config::SM_CONSOLIDATION_SUBARRAY = "";
+const std::string Config::SM_CONSOLIDATION_MEMORY_BUDGET = "0";
+const std::string Config::SM_CONSOLIDATION_PLANNER = "size_ratio";
+const std::string Config::SM_CONSOLIDATION_PLANNER_FRAGMENT_COST = "1048576";
+const std::string Config::SM_CONSOLIDATION_DRY_RUN = "false";
+const std::string Config::SM_CONSOLIDATION_DEFERRED_VACUUM = "false";
+const std::string Config::SM_CONSOLIDATION_PYRAMID_LEVELS = "0";
+const std::string Config::SM_CONSOLIDATION_PYRAMID_METHOD = "mean";
+const std::string Config::SM_CONSOLIDATION_AUTO_INTERVAL_MS = "0";
+const std::string Config::SM_CONSOLIDATION_AUTO_FRAGMENT_NUM = "16";
+const std::string Config::SM_CONSOLIDATION_AUTO_ARRAY_METADATA_NUM = "64";
 const std::string Config::VFS_NUM_THREADS =
     utils::parse::to_str(std::thread::hardware_concurrency());
 const std::string Config::VFS_MIN_PARALLEL_SIZE = "10485760";
 const std::string Config::VFS_MIN_BATCH_GAP = "512000";
+const std::string Config::VFS_ADAPTIVE_BATCH_GAP = "false";
 const std::string Config::VFS_MIN_BATCH_SIZE = "20971520";
+const std::string Config::VFS_WRITE_BEHIND_BUFFER_SIZE = "0";
+const std::string Config::VFS_EMULATED_LATENCY_MS = "0";
+const std::string Config::VFS_EMULATED_BANDWIDTH = "0";
 const std::string Config::VFS_FILE_MAX_PARALLEL_OPS = Config::VFS_NUM_THREADS;
 const std::string Config::VFS_FILE_ENABLE_FILELOCKS = "true";
+const std::string Config::VFS_FILE_ENABLE_READ_FILELOCKS = "true";
+const std::string Config::VFS_FILE_IO_ENGINE = "pread";
+const std::string Config::VFS_FILE_ENABLE_MMAP = "false";
+const std::string Config::VFS_FILE_DIRECT_IO = "false";
 const std::string Config::VFS_S3_REGION = "us-east-1";
 const std::string Config::VFS_S3_AWS_ACCESS_KEY_ID = "";
 const std::string Config::VFS_S3_AWS_SECRET_ACCESS_KEY = "";
@@ -91,6 +155,10 @@ const std::string Config::VFS_S3_USE_VIRTUAL_ADDRESSING = "true";
 const std::string Config::VFS_S3_USE_MULTIPART_UPLOAD = "true";
 const std::string Config::VFS_S3_MAX_PARALLEL_OPS = Config::VFS_NUM_THREADS;
 const std::string Config::VFS_S3_MULTIPART_PART_SIZE = "5242880";
+const std::string Config::VFS_S3_MAX_BUFFER_SIZE = "0";
+const std::string Config::VFS_S3_READ_PART_SIZE = "0";
+const std::string Config::VFS_S3_HEDGE_PERCENTILE = "0.0";
+const std::string Config::VFS_S3_HEDGE_MAX_RATIO = "0.05";
 const std::string Config::VFS_S3_CA_FILE = "";
 const std::string Config::VFS_S3_CA_PATH = "";
 const std::string Config::VFS_S3_CONNECT_TIMEOUT_MS = "3000";
@@ -107,6 +175,10 @@ const std::string Config::VFS_S3_VERIFY_SSL = "true";
 const std::string Config::VFS_HDFS_KERB_TICKET_CACHE_PATH = "";
 const std::string Config::VFS_HDFS_NAME_NODE_URI = "";
 const std::string Config::VFS_HDFS_USERNAME = "";
+const std::string Config::VFS_HDFS_MAX_PARALLEL_OPS = Config::VFS_NUM_THREADS;
+const std::string Config::VFS_HDFS_SHORT_CIRCUIT_READ = "false";
+const std::string Config::VFS_HDFS_DOMAIN_SOCKET_PATH = "";
+const std::string Config::VFS_HDFS_ZERO_COPY_READ = "false";
 
 /* ****************************** */
 /*        PRIVATE CONSTANTS       */
@@ -135,18 +207,70 @@ Config::Config() {
   param_values_["rest.server_serialization_format"] =
       REST_SERIALIZATION_DEFAULT_FORMAT;
   param_values_["rest.http_compressor"] = REST_SERVER_DEFAULT_HTTP_COMPRESSOR;
+  param_values_["rest.http_request_compressor"] =
+      REST_SERVER_DEFAULT_HTTP_REQUEST_COMPRESSOR;
+  param_values_["rest.cache_ttl_ms"] = REST_SERVER_DEFAULT_CACHE_TTL_MS;
+  param_values_["rest.read_partition_num"] =
+      REST_SERVER_DEFAULT_READ_PARTITION_NUM;
   param_values_["sm.dedup_coords"] = SM_DEDUP_COORDS;
   param_values_["sm.check_coord_dups"] = SM_CHECK_COORD_DUPS;
   param_values_["sm.check_coord_oob"] = SM_CHECK_COORD_OOB;
   param_values_["sm.check_global_order"] = SM_CHECK_GLOBAL_ORDER;
   param_values_["sm.tile_cache_size"] = SM_TILE_CACHE_SIZE;
+  param_values_["sm.tile_cache_shards"] = SM_TILE_CACHE_SHARDS;
+  param_values_["sm.tile_cache_policy"] = SM_TILE_CACHE_POLICY;
+  param_values_["sm.tile_cache_mode"] = SM_TILE_CACHE_MODE;
+  param_values_["sm.tile_disk_cache_dir"] = SM_TILE_DISK_CACHE_DIR;
+  param_values_["sm.tile_disk_cache_size"] = SM_TILE_DISK_CACHE_SIZE;
+  param_values_["sm.read_prefetch"] = SM_READ_PREFETCH;
+  param_values_["sm.read_planner"] = SM_READ_PLANNER;
+  param_values_["sm.eager_metadata_load"] = SM_EAGER_METADATA_LOAD;
+  param_values_["sm.partitioner.balanced_splits"] =
+      SM_PARTITIONER_BALANCED_SPLITS;
+  param_values_["sm.partition_tile_cache_ratio"] =
+      SM_PARTITION_TILE_CACHE_RATIO;
+  param_values_["sm.write_async_flush"] = SM_WRITE_ASYNC_FLUSH;
+  param_values_["sm.write_buffer.max_size"] = SM_WRITE_BUFFER_MAX_SIZE;
+  param_values_["sm.write_buffer.max_age_ms"] = SM_WRITE_BUFFER_MAX_AGE_MS;
+  param_values_["sm.unordered_write_fragment_num"] =
+      SM_UNORDERED_WRITE_FRAGMENT_NUM;
+  param_values_["sm.capacity_target_tile_size"] =
+      SM_CAPACITY_TARGET_TILE_SIZE;
+  param_values_["sm.fragment_metadata_cache_size"] =
+      SM_FRAGMENT_METADATA_CACHE_SIZE;
+  param_values_["sm.fragment_metadata_speculative_read_size"] =
+      SM_FRAGMENT_METADATA_SPECULATIVE_READ_SIZE;
+  param_values_["sm.fragment_metadata_unfiltered"] =
+      SM_FRAGMENT_METADATA_UNFILTERED;
+  param_values_["sm.fragment_packing_max_size"] = SM_FRAGMENT_PACKING_MAX_SIZE;
+  param_values_["sm.index_cache_size"] = SM_INDEX_CACHE_SIZE;
+  param_values_["sm.empty_subarray_cache_size"] = SM_EMPTY_SUBARRAY_CACHE_SIZE;
+  param_values_["sm.var_offsets.bitsize"] = SM_VAR_OFFSETS_BITSIZE;
+  param_values_["sm.var_offsets.extra_element"] = SM_VAR_OFFSETS_EXTRA_ELEMENT;
+  param_values_["sm.var_offsets.mode"] = SM_VAR_OFFSETS_MODE;
+  param_values_["sm.coords_bloom_filter_bits"] = SM_COORDS_BLOOM_FILTER_BITS;
+  param_values_["sm.rtree_str_packing"] = SM_RTREE_STR_PACKING;
+  param_values_["sm.fragment_sketches"] = SM_FRAGMENT_SKETCHES;
+  param_values_["sm.value_index_attributes"] = SM_VALUE_INDEX_ATTRIBUTES;
+  param_values_["sm.array_manifest"] = SM_ARRAY_MANIFEST;
+  param_values_["sm.buffer_pool_size"] = SM_BUFFER_POOL_SIZE;
+  param_values_["sm.buffer_pool_huge_pages"] = SM_BUFFER_POOL_HUGE_PAGES;
   param_values_["sm.memory_budget"] = SM_MEMORY_BUDGET;
   param_values_["sm.memory_budget_var"] = SM_MEMORY_BUDGET_VAR;
   param_values_["sm.enable_signal_handlers"] = SM_ENABLE_SIGNAL_HANDLERS;
   param_values_["sm.num_async_threads"] = SM_NUM_ASYNC_THREADS;
   param_values_["sm.num_reader_threads"] = SM_NUM_READER_THREADS;
   param_values_["sm.num_writer_threads"] = SM_NUM_WRITER_THREADS;
+  param_values_["sm.num_fragment_metadata_threads"] =
+      SM_NUM_FRAGMENT_METADATA_THREADS;
+  param_values_["sm.num_scheduler_threads"] = SM_NUM_SCHEDULER_THREADS;
   param_values_["sm.num_tbb_threads"] = SM_NUM_TBB_THREADS;
+  param_values_["sm.numa_pinning"] = SM_NUMA_PINNING;
+  param_values_["sm.stats.sample_rate"] = SM_STATS_SAMPLE_RATE;
+  param_values_["sm.stats.sample_traces"] = SM_STATS_SAMPLE_TRACES;
+  param_values_["sm.stats.slow_query_threshold_ms"] =
+      SM_STATS_SLOW_QUERY_THRESHOLD_MS;
+  param_values_["sm.stats.slow_query_log"] = SM_STATS_SLOW_QUERY_LOG;
   param_values_["sm.consolidation.amplification"] =
       SM_CONSOLIDATION_AMPLIFICATION;
   param_values_["sm.consolidation.buffer_size"] = SM_CONSOLIDATION_BUFFER_SIZE;
@@ -157,12 +281,45 @@ Config::Config() {
   param_values_["sm.consolidation.step_size_ratio"] =
       SM_CONSOLIDATION_STEP_SIZE_RATIO;
   param_values_["sm.consolidation.steps"] = SM_CONSOLIDATION_STEPS;
+  param_values_["sm.consolidation.tile_copy"] = SM_CONSOLIDATION_TILE_COPY;
+  param_values_["sm.consolidation.timestamp_start"] =
+      SM_CONSOLIDATION_TIMESTAMP_START;
+  param_values_["sm.consolidation.timestamp_end"] =
+      SM_CONSOLIDATION_TIMESTAMP_END;
+  param_values_["sm.consolidation.subarray"] = SM_CONSOLIDATION_SUBARRAY;
+  param_values_["sm.consolidation.memory_budget"] =
+      SM_CONSOLIDATION_MEMORY_BUDGET;
+  param_values_["sm.consolidation.planner"] = SM_CONSOLIDATION_PLANNER;
+  param_values_["sm.consolidation.planner_fragment_cost"] =
+      SM_CONSOLIDATION_PLANNER_FRAGMENT_COST;
+  param_values_["sm.consolidation.dry_run"] = SM_CONSOLIDATION_DRY_RUN;
+  param_values_["sm.consolidation.deferred_vacuum"] =
+      SM_CONSOLIDATION_DEFERRED_VACUUM;
+  param_values_["sm.consolidation.pyramid_levels"] =
+      SM_CONSOLIDATION_PYRAMID_LEVELS;
+  param_values_["sm.consolidation.pyramid_method"] =
+      SM_CONSOLIDATION_PYRAMID_METHOD;
+  param_values_["sm.consolidation.auto_interval_ms"] =
+      SM_CONSOLIDATION_AUTO_INTERVAL_MS;
+  param_values_["sm.consolidation.auto_fragment_num"] =
+      SM_CONSOLIDATION_AUTO_FRAGMENT_NUM;
+  param_values_["sm.consolidation.auto_array_metadata_num"] =
+      SM_CONSOLIDATION_AUTO_ARRAY_METADATA_NUM;
   param_values_["vfs.num_threads"] = VFS_NUM_THREADS;
   param_values_["vfs.min_parallel_size"] = VFS_MIN_PARALLEL_SIZE;
   param_values_["vfs.min_batch_gap"] = VFS_MIN_BATCH_GAP;
+  param_values_["vfs.adaptive_batch_gap"] = VFS_ADAPTIVE_BATCH_GAP;
   param_values_["vfs.min_batch_size"] = VFS_MIN_BATCH_SIZE;
+  param_values_["vfs.write_behind_buffer_size"] = VFS_WRITE_BEHIND_BUFFER_SIZE;
+  param_values_["vfs.emulated_latency_ms"] = VFS_EMULATED_LATENCY_MS;
+  param_values_["vfs.emulated_bandwidth"] = VFS_EMULATED_BANDWIDTH;
   param_values_["vfs.file.max_parallel_ops"] = VFS_FILE_MAX_PARALLEL_OPS;
   param_values_["vfs.file.enable_filelocks"] = VFS_FILE_ENABLE_FILELOCKS;
+  param_values_["vfs.file.enable_read_filelocks"] =
+      VFS_FILE_ENABLE_READ_FILELOCKS;
+  param_values_["vfs.file.io_engine"] = VFS_FILE_IO_ENGINE;
+  param_values_["vfs.file.enable_mmap"] = VFS_FILE_ENABLE_MMAP;
+  param_values_["vfs.file.direct_io"] = VFS_FILE_DIRECT_IO;
   param_values_["vfs.s3.region"] = VFS_S3_REGION;
   param_values_["vfs.s3.aws_access_key_id"] = VFS_S3_AWS_ACCESS_KEY_ID;
   param_values_["vfs.s3.aws_secret_access_key"] = VFS_S3_AWS_SECRET_ACCESS_KEY;
@@ -174,6 +331,10 @@ Config::Config() {
   param_values_["vfs.s3.use_multipart_upload"] = VFS_S3_USE_MULTIPART_UPLOAD;
   param_values_["vfs.s3.max_parallel_ops"] = VFS_S3_MAX_PARALLEL_OPS;
   param_values_["vfs.s3.multipart_part_size"] = VFS_S3_MULTIPART_PART_SIZE;
+  param_values_["vfs.s3.max_buffer_size"] = VFS_S3_MAX_BUFFER_SIZE;
+  param_values_["vfs.s3.read_part_size"] = VFS_S3_READ_PART_SIZE;
+  param_values_["vfs.s3.hedge_percentile"] = VFS_S3_HEDGE_PERCENTILE;
+  param_values_["vfs.s3.hedge_max_ratio"] = VFS_S3_HEDGE_MAX_RATIO;
   param_values_["vfs.s3.ca_file"] = VFS_S3_CA_FILE;
   param_values_["vfs.s3.ca_path"] = VFS_S3_CA_PATH;
   param_values_["vfs.s3.connect_timeout_ms"] = VFS_S3_CONNECT_TIMEOUT_MS;
@@ -191,6 +352,10 @@ Config::Config() {
   param_values_["vfs.hdfs.username"] = VFS_HDFS_USERNAME;
   param_values_["vfs.hdfs.kerb_ticket_cache_path"] =
       VFS_HDFS_KERB_TICKET_CACHE_PATH;
+  param_values_["vfs.hdfs.max_parallel_ops"] = VFS_HDFS_MAX_PARALLEL_OPS;
+  param_values_["vfs.hdfs.short_circuit_read"] = VFS_HDFS_SHORT_CIRCUIT_READ;
+  param_values_["vfs.hdfs.domain_socket_path"] = VFS_HDFS_DOMAIN_SOCKET_PATH;
+  param_values_["vfs.hdfs.zero_copy_read"] = VFS_HDFS_ZERO_COPY_READ;
 }
 
 Config::~Config() = default;
@@ -320,6 +485,14 @@ Status Config::unset(const std::string& param) {
         REST_SERIALIZATION_DEFAULT_FORMAT;
   } else if (param == "rest.http_compressor") {
     param_values_["rest.http_compressor"] = REST_SERVER_DEFAULT_HTTP_COMPRESSOR;
+  } else if (param == "rest.http_request_compressor") {
+    param_values_["rest.http_request_compressor"] =
+        REST_SERVER_DEFAULT_HTTP_REQUEST_COMPRESSOR;
+  } else if (param == "rest.cache_ttl_ms") {
+    param_values_["rest.cache_ttl_ms"] = REST_SERVER_DEFAULT_CACHE_TTL_MS;
+  } else if (param == "rest.read_partition_num") {
+    param_values_["rest.read_partition_num"] =
+        REST_SERVER_DEFAULT_READ_PARTITION_NUM;
   } else if (param == "sm.dedup_coords") {
     param_values_["sm.dedup_coords"] = SM_DEDUP_COORDS;
   } else if (param == "sm.check_coord_dups") {
@@ -330,6 +503,78 @@ Status Config::unset(const std::string& param) {
     param_values_["sm.check_global_order"] = SM_CHECK_GLOBAL_ORDER;
   } else if (param == "sm.tile_cache_size") {
     param_values_["sm.tile_cache_size"] = SM_TILE_CACHE_SIZE;
+  } else if (param == "sm.tile_cache_shards") {
+    param_values_["sm.tile_cache_shards"] = SM_TILE_CACHE_SHARDS;
+  } else if (param == "sm.tile_cache_policy") {
+    param_values_["sm.tile_cache_policy"] = SM_TILE_CACHE_POLICY;
+  } else if (param == "sm.tile_cache_mode") {
+    param_values_["sm.tile_cache_mode"] = SM_TILE_CACHE_MODE;
+  } else if (param == "sm.tile_disk_cache_dir") {
+    param_values_["sm.tile_disk_cache_dir"] = SM_TILE_DISK_CACHE_DIR;
+  } else if (param == "sm.tile_disk_cache_size") {
+    param_values_["sm.tile_disk_cache_size"] = SM_TILE_DISK_CACHE_SIZE;
+  } else if (param == "sm.read_prefetch") {
+    param_values_["sm.read_prefetch"] = SM_READ_PREFETCH;
+  } else if (param == "sm.read_planner") {
+    param_values_["sm.read_planner"] = SM_READ_PLANNER;
+  } else if (param == "sm.eager_metadata_load") {
+    param_values_["sm.eager_metadata_load"] = SM_EAGER_METADATA_LOAD;
+  } else if (param == "sm.partitioner.balanced_splits") {
+    param_values_["sm.partitioner.balanced_splits"] =
+        SM_PARTITIONER_BALANCED_SPLITS;
+  } else if (param == "sm.partition_tile_cache_ratio") {
+    param_values_["sm.partition_tile_cache_ratio"] =
+        SM_PARTITION_TILE_CACHE_RATIO;
+  } else if (param == "sm.write_async_flush") {
+    param_values_["sm.write_async_flush"] = SM_WRITE_ASYNC_FLUSH;
+  } else if (param == "sm.write_buffer.max_size") {
+    param_values_["sm.write_buffer.max_size"] = SM_WRITE_BUFFER_MAX_SIZE;
+  } else if (param == "sm.write_buffer.max_age_ms") {
+    param_values_["sm.write_buffer.max_age_ms"] = SM_WRITE_BUFFER_MAX_AGE_MS;
+  } else if (param == "sm.unordered_write_fragment_num") {
+    param_values_["sm.unordered_write_fragment_num"] =
+        SM_UNORDERED_WRITE_FRAGMENT_NUM;
+  } else if (param == "sm.capacity_target_tile_size") {
+    param_values_["sm.capacity_target_tile_size"] =
+        SM_CAPACITY_TARGET_TILE_SIZE;
+  } else if (param == "sm.fragment_metadata_cache_size") {
+    param_values_["sm.fragment_metadata_cache_size"] =
+        SM_FRAGMENT_METADATA_CACHE_SIZE;
+  } else if (param == "sm.fragment_metadata_speculative_read_size") {
+    param_values_["sm.fragment_metadata_speculative_read_size"] =
+        SM_FRAGMENT_METADATA_SPECULATIVE_READ_SIZE;
+  } else if (param == "sm.fragment_metadata_unfiltered") {
+    param_values_["sm.fragment_metadata_unfiltered"] =
+        SM_FRAGMENT_METADATA_UNFILTERED;
+  } else if (param == "sm.fragment_packing_max_size") {
+    param_values_["sm.fragment_packing_max_size"] =
+        SM_FRAGMENT_PACKING_MAX_SIZE;
+  } else if (param == "sm.index_cache_size") {
+    param_values_["sm.index_cache_size"] = SM_INDEX_CACHE_SIZE;
+  } else if (param == "sm.empty_subarray_cache_size") {
+    param_values_["sm.empty_subarray_cache_size"] =
+        SM_EMPTY_SUBARRAY_CACHE_SIZE;
+  } else if (param == "sm.var_offsets.bitsize") {
+    param_values_["sm.var_offsets.bitsize"] = SM_VAR_OFFSETS_BITSIZE;
+  } else if (param == "sm.var_offsets.extra_element") {
+    param_values_["sm.var_offsets.extra_element"] =
+        SM_VAR_OFFSETS_EXTRA_ELEMENT;
+  } else if (param == "sm.var_offsets.mode") {
+    param_values_["sm.var_offsets.mode"] = SM_VAR_OFFSETS_MODE;
+  } else if (param == "sm.coords_bloom_filter_bits") {
+    param_values_["sm.coords_bloom_filter_bits"] = SM_COORDS_BLOOM_FILTER_BITS;
+  } else if (param == "sm.rtree_str_packing") {
+    param_values_["sm.rtree_str_packing"] = SM_RTREE_STR_PACKING;
+  } else if (param == "sm.fragment_sketches") {
+    param_values_["sm.fragment_sketches"] = SM_FRAGMENT_SKETCHES;
+  } else if (param == "sm.value_index_attributes") {
+    param_values_["sm.value_index_attributes"] = SM_VALUE_INDEX_ATTRIBUTES;
+  } else if (param == "sm.array_manifest") {
+    param_values_["sm.array_manifest"] = SM_ARRAY_MANIFEST;
+  } else if (param == "sm.buffer_pool_size") {
+    param_values_["sm.buffer_pool_size"] = SM_BUFFER_POOL_SIZE;
+  } else if (param == "sm.buffer_pool_huge_pages") {
+    param_values_["sm.buffer_pool_huge_pages"] = SM_BUFFER_POOL_HUGE_PAGES;
   } else if (param == "sm.memory_budget") {
     param_values_["sm.memory_budget"] = SM_MEMORY_BUDGET;
   } else if (param == "sm.memory_budget_var") {
@@ -342,8 +587,24 @@ Status Config::unset(const std::string& param) {
     param_values_["sm.num_reader_threads"] = SM_NUM_READER_THREADS;
   } else if (param == "sm.num_writer_threads") {
     param_values_["sm.num_writer_threads"] = SM_NUM_WRITER_THREADS;
+  } else if (param == "sm.num_fragment_metadata_threads") {
+    param_values_["sm.num_fragment_metadata_threads"] =
+        SM_NUM_FRAGMENT_METADATA_THREADS;
+  } else if (param == "sm.num_scheduler_threads") {
+    param_values_["sm.num_scheduler_threads"] = SM_NUM_SCHEDULER_THREADS;
   } else if (param == "sm.num_tbb_threads") {
     param_values_["sm.num_tbb_threads"] = SM_NUM_TBB_THREADS;
+  } else if (param == "sm.numa_pinning") {
+    param_values_["sm.numa_pinning"] = SM_NUMA_PINNING;
+  } else if (param == "sm.stats.sample_rate") {
+    param_values_["sm.stats.sample_rate"] = SM_STATS_SAMPLE_RATE;
+  } else if (param == "sm.stats.sample_traces") {
+    param_values_["sm.stats.sample_traces"] = SM_STATS_SAMPLE_TRACES;
+  } else if (param == "sm.stats.slow_query_threshold_ms") {
+    param_values_["sm.stats.slow_query_threshold_ms"] =
+        SM_STATS_SLOW_QUERY_THRESHOLD_MS;
+  } else if (param == "sm.stats.slow_query_log") {
+    param_values_["sm.stats.slow_query_log"] = SM_STATS_SLOW_QUERY_LOG;
   } else if (param == "sm.consolidation.amplification") {
     param_values_["sm.consolidation.amplification"] =
         SM_CONSOLIDATION_AMPLIFICATION;
@@ -361,18 +622,74 @@ Status Config::unset(const std::string& param) {
   } else if (param == "sm.consolidation.step_size_ratio") {
     param_values_["sm.consolidation.step_size_ratio"] =
         SM_CONSOLIDATION_STEP_SIZE_RATIO;
+  } else if (param == "sm.consolidation.tile_copy") {
+    param_values_["sm.consolidation.tile_copy"] = SM_CONSOLIDATION_TILE_COPY;
+  } else if (param == "sm.consolidation.timestamp_start") {
+    param_values_["sm.consolidation.timestamp_start"] =
+        SM_CONSOLIDATION_TIMESTAMP_START;
+  } else if (param == "sm.consolidation.timestamp_end") {
+    param_values_["sm.consolidation.timestamp_end"] =
+        SM_CONSOLIDATION_TIMESTAMP_END;
+  } else if (param == "sm.consolidation.subarray") {
+    param_values_["sm.consolidation.subarray"] = SM_CONSOLIDATION_SUBARRAY;
+  } else if (param == "sm.consolidation.memory_budget") {
+    param_values_["sm.consolidation.memory_budget"] =
+        SM_CONSOLIDATION_MEMORY_BUDGET;
+  } else if (param == "sm.consolidation.planner") {
+    param_values_["sm.consolidation.planner"] = SM_CONSOLIDATION_PLANNER;
+  } else if (param == "sm.consolidation.planner_fragment_cost") {
+    param_values_["sm.consolidation.planner_fragment_cost"] =
+        SM_CONSOLIDATION_PLANNER_FRAGMENT_COST;
+  } else if (param == "sm.consolidation.dry_run") {
+    param_values_["sm.consolidation.dry_run"] = SM_CONSOLIDATION_DRY_RUN;
+  } else if (param == "sm.consolidation.deferred_vacuum") {
+    param_values_["sm.consolidation.deferred_vacuum"] =
+        SM_CONSOLIDATION_DEFERRED_VACUUM;
+  } else if (param == "sm.consolidation.pyramid_levels") {
+    param_values_["sm.consolidation.pyramid_levels"] =
+        SM_CONSOLIDATION_PYRAMID_LEVELS;
+  } else if (param == "sm.consolidation.pyramid_method") {
+    param_values_["sm.consolidation.pyramid_method"] =
+        SM_CONSOLIDATION_PYRAMID_METHOD;
+  } else if (param == "sm.consolidation.auto_interval_ms") {
+    param_values_["sm.consolidation.auto_interval_ms"] =
+        SM_CONSOLIDATION_AUTO_INTERVAL_MS;
+  } else if (param == "sm.consolidation.auto_fragment_num") {
+    param_values_["sm.consolidation.auto_fragment_num"] =
+        SM_CONSOLIDATION_AUTO_FRAGMENT_NUM;
+  } else if (param == "sm.consolidation.auto_array_metadata_num") {
+    param_values_["sm.consolidation.auto_array_metadata_num"] =
+        SM_CONSOLIDATION_AUTO_ARRAY_METADATA_NUM;
   } else if (param == "vfs.num_threads") {
     param_values_["vfs.num_threads"] = VFS_NUM_THREADS;
   } else if (param == "vfs.min_parallel_size") {
     param_values_["vfs.min_parallel_size"] = VFS_MIN_PARALLEL_SIZE;
   } else if (param == "vfs.min_batch_gap") {
     param_values_["vfs.min_batch_gap"] = VFS_MIN_BATCH_GAP;
+  } else if (param == "vfs.adaptive_batch_gap") {
+    param_values_["vfs.adaptive_batch_gap"] = VFS_ADAPTIVE_BATCH_GAP;
   } else if (param == "vfs.min_batch_size") {
     param_values_["vfs.min_batch_size"] = VFS_MIN_BATCH_SIZE;
+  } else if (param == "vfs.write_behind_buffer_size") {
+    param_values_["vfs.write_behind_buffer_size"] =
+        VFS_WRITE_BEHIND_BUFFER_SIZE;
+  } else if (param == "vfs.emulated_latency_ms") {
+    param_values_["vfs.emulated_latency_ms"] = VFS_EMULATED_LATENCY_MS;
+  } else if (param == "vfs.emulated_bandwidth") {
+    param_values_["vfs.emulated_bandwidth"] = VFS_EMULATED_BANDWIDTH;
   } else if (param == "vfs.file.max_parallel_ops") {
     param_values_["vfs.file.max_parallel_ops"] = VFS_FILE_MAX_PARALLEL_OPS;
   } else if (param == "vfs.file.enable_filelocks") {
     param_values_["vfs.file.enable_filelocks"] = VFS_FILE_ENABLE_FILELOCKS;
+  } else if (param == "vfs.file.enable_read_filelocks") {
+    param_values_["vfs.file.enable_read_filelocks"] =
+        VFS_FILE_ENABLE_READ_FILELOCKS;
+  } else if (param == "vfs.file.io_engine") {
+    param_values_["vfs.file.io_engine"] = VFS_FILE_IO_ENGINE;
+  } else if (param == "vfs.file.enable_mmap") {
+    param_values_["vfs.file.enable_mmap"] = VFS_FILE_ENABLE_MMAP;
+  } else if (param == "vfs.file.direct_io") {
+    param_values_["vfs.file.direct_io"] = VFS_FILE_DIRECT_IO;
   } else if (param == "vfs.s3.region") {
     param_values_["vfs.s3.region"] = VFS_S3_REGION;
   } else if (param == "vfs.s3.aws_access_key_id") {
@@ -397,6 +714,14 @@ Status Config::unset(const std::string& param) {
     param_values_["vfs.s3.max_parallel_ops"] = VFS_S3_MAX_PARALLEL_OPS;
   } else if (param == "vfs.s3.multipart_part_size") {
     param_values_["vfs.s3.multipart_part_size"] = VFS_S3_MULTIPART_PART_SIZE;
+  } else if (param == "vfs.s3.max_buffer_size") {
+    param_values_["vfs.s3.max_buffer_size"] = VFS_S3_MAX_BUFFER_SIZE;
+  } else if (param == "vfs.s3.read_part_size") {
+    param_values_["vfs.s3.read_part_size"] = VFS_S3_READ_PART_SIZE;
+  } else if (param == "vfs.s3.hedge_percentile") {
+    param_values_["vfs.s3.hedge_percentile"] = VFS_S3_HEDGE_PERCENTILE;
+  } else if (param == "vfs.s3.hedge_max_ratio") {
+    param_values_["vfs.s3.hedge_max_ratio"] = VFS_S3_HEDGE_MAX_RATIO;
   } else if (param == "vfs.s3.ca_file") {
     param_values_["vfs.s3.ca_file"] = VFS_S3_CA_FILE;
   } else if (param == "vfs.s3.ca_path") {
@@ -428,6 +753,14 @@ Status Config::unset(const std::string& param) {
   } else if (param == "vfs.hdfs.kerb_ticket_cache_path") {
     param_values_["vfs.hdfs.kerb_ticket_cache_path"] =
         VFS_HDFS_KERB_TICKET_CACHE_PATH;
+  } else if (param == "vfs.hdfs.max_parallel_ops") {
+    param_values_["vfs.hdfs.max_parallel_ops"] = VFS_HDFS_MAX_PARALLEL_OPS;
+  } else if (param == "vfs.hdfs.short_circuit_read") {
+    param_values_["vfs.hdfs.short_circuit_read"] = VFS_HDFS_SHORT_CIRCUIT_READ;
+  } else if (param == "vfs.hdfs.domain_socket_path") {
+    param_values_["vfs.hdfs.domain_socket_path"] = VFS_HDFS_DOMAIN_SOCKET_PATH;
+  } else if (param == "vfs.hdfs.zero_copy_read") {
+    param_values_["vfs.hdfs.zero_copy_read"] = VFS_HDFS_ZERO_COPY_READ;
   }
 
   // Remove from the set parameters
@@ -462,6 +795,17 @@ Status Config::sanity_check(
   if (param == "rest.server_serialization_format") {
     SerializationType serialization_type;
     RETURN_NOT_OK(serialization_type_enum(value, &serialization_type));
+  } else if (param == "rest.http_request_compressor") {
+    if (value != "none" && value != "gzip" && value != "zstd")
+      return LOG_STATUS(Status::ConfigError(
+          "Invalid http request compressor parameter value"));
+  } else if (param == "rest.cache_ttl_ms") {
+    RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
+  } else if (param == "rest.read_partition_num") {
+    RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
+    if (vuint64 == 0)
+      return LOG_STATUS(Status::ConfigError(
+          "Invalid read partition number parameter value; must be positive"));
   } else if (param == "sm.dedup_coords") {
     RETURN_NOT_OK(utils::parse::convert(value, &v));
   } else if (param == "sm.check_coord_dups") {
@@ -472,6 +816,94 @@ Status Config::sanity_check(
     RETURN_NOT_OK(utils::parse::convert(value, &v));
   } else if (param == "sm.tile_cache_size") {
     RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
+  } else if (param == "sm.tile_cache_shards") {
+    RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
+  } else if (param == "sm.tile_cache_policy") {
+    if (value != "lru" && value != "2q")
+      return LOG_STATUS(
+          Status::ConfigError("Invalid tile cache policy parameter value"));
+  } else if (param == "sm.tile_cache_mode") {
+    if (value != "unfiltered" && value != "filtered" && value != "auto")
+      return LOG_STATUS(
+          Status::ConfigError("Invalid tile cache mode parameter value"));
+  } else if (param == "sm.tile_disk_cache_size") {
+    RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
+  } else if (param == "sm.read_prefetch") {
+    RETURN_NOT_OK(utils::parse::convert(value, &v));
+  } else if (param == "sm.read_planner") {
+    if (value != "none" && value != "cost")
+      return LOG_STATUS(
+          Status::ConfigError("Invalid read planner parameter value"));
+  } else if (param == "sm.eager_metadata_load") {
+    RETURN_NOT_OK(utils::parse::convert(value, &v));
+  } else if (param == "sm.partitioner.balanced_splits") {
+    RETURN_NOT_OK(utils::parse::convert(value, &v));
+  } else if (param == "sm.partition_tile_cache_ratio") {
+    RETURN_NOT_OK(utils::parse::convert(value, &vf));
+    if (vf < 0.0f || vf > 1.0f)
+      return LOG_STATUS(Status::ConfigError(
+          "Invalid partition tile cache ratio parameter value; must be in "
+          "[0.0, 1.0]"));
+  } else if (param == "sm.write_async_flush") {
+    RETURN_NOT_OK(utils::parse::convert(value, &v));
+  } else if (param == "sm.write_buffer.max_size") {
+    RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
+  } else if (param == "sm.write_buffer.max_age_ms") {
+    RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
+  } else if (param == "sm.unordered_write_fragment_num") {
+    RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
+    if (vuint64 == 0)
+      return LOG_STATUS(Status::ConfigError(
+          "Invalid unordered write fragment number parameter value"));
+  } else if (param == "sm.capacity_target_tile_size") {
+    RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
+  } else if (param == "sm.fragment_metadata_cache_size") {
+    RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
+  } else if (param == "sm.fragment_metadata_speculative_read_size") {
+    RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
+  } else if (param == "sm.fragment_metadata_unfiltered") {
+    RETURN_NOT_OK(utils::parse::convert(value, &v));
+  } else if (param == "sm.fragment_packing_max_size") {
+    RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
+  } else if (param == "sm.index_cache_size") {
+    RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
+  } else if (param == "sm.empty_subarray_cache_size") {
+    RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
+  } else if (param == "sm.var_offsets.bitsize") {
+    RETURN_NOT_OK(utils::parse::convert(value, &v32));
+    if (v32 != 32 && v32 != 64)
+      return LOG_STATUS(Status::ConfigError(
+          "Invalid var offsets bitsize parameter value; must be 32 or 64"));
+  } else if (param == "sm.var_offsets.extra_element") {
+    RETURN_NOT_OK(utils::parse::convert(value, &v));
+  } else if (param == "sm.var_offsets.mode") {
+    if (value != "bytes" && value != "elements")
+      return LOG_STATUS(Status::ConfigError(
+          "Invalid var offsets mode parameter value; must be 'bytes' or "
+          "'elements'"));
+  } else if (param == "sm.coords_bloom_filter_bits") {
+    RETURN_NOT_OK(utils::parse::convert(value, &v32));
+  } else if (param == "sm.rtree_str_packing") {
+    RETURN_NOT_OK(utils::parse::convert(value, &v));
+  } else if (param == "sm.fragment_sketches") {
+    RETURN_NOT_OK(utils::parse::convert(value, &v));
+  } else if (param == "sm.array_manifest") {
+    RETURN_NOT_OK(utils::parse::convert(value, &v));
+  } else if (param == "sm.buffer_pool_size") {
+    RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
+  } else if (param == "sm.buffer_pool_huge_pages") {
+    RETURN_NOT_OK(utils::parse::convert(value, &v));
+  } else if (param == "sm.numa_pinning") {
+    RETURN_NOT_OK(utils::parse::convert(value, &v));
+  } else if (param == "sm.stats.sample_rate") {
+    RETURN_NOT_OK(utils::parse::convert(value, &vf));
+    if (vf < 0.0f || vf > 1.0f)
+      return LOG_STATUS(
+          Status::ConfigError("Invalid stats sample rate parameter value"));
+  } else if (param == "sm.stats.sample_traces") {
+    RETURN_NOT_OK(utils::parse::convert(value, &v));
+  } else if (param == "sm.stats.slow_query_threshold_ms") {
+    RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
   } else if (param == "sm.memory_budget") {
     RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
   } else if (param == "sm.memory_budget_var") {
@@ -484,6 +916,10 @@ Status Config::sanity_check(
     RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
   } else if (param == "sm.num_writer_threads") {
     RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
+  } else if (param == "sm.num_fragment_metadata_threads") {
+    RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
+  } else if (param == "sm.num_scheduler_threads") {
+    RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
   } else if (param == "sm.num_tbb_threads") {
     RETURN_NOT_OK(utils::parse::convert(value, &vint));
   } else if (param == "sm.consolidation.amplification") {
@@ -498,18 +934,66 @@ Status Config::sanity_check(
     RETURN_NOT_OK(utils::parse::convert(value, &v32));
   } else if (param == "sm.consolidation.step_size_ratio") {
     RETURN_NOT_OK(utils::parse::convert(value, &vf));
+  } else if (param == "sm.consolidation.tile_copy") {
+    RETURN_NOT_OK(utils::parse::convert(value, &v));
+  } else if (param == "sm.consolidation.timestamp_start") {
+    RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
+  } else if (param == "sm.consolidation.timestamp_end") {
+    RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
+  } else if (param == "sm.consolidation.memory_budget") {
+    RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
+  } else if (param == "sm.consolidation.planner") {
+    if (value != "size_ratio" && value != "cost")
+      return LOG_STATUS(
+          Status::ConfigError("Invalid consolidation planner parameter value"));
+  } else if (param == "sm.consolidation.planner_fragment_cost") {
+    RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
+  } else if (param == "sm.consolidation.dry_run") {
+    RETURN_NOT_OK(utils::parse::convert(value, &v));
+  } else if (param == "sm.consolidation.deferred_vacuum") {
+    RETURN_NOT_OK(utils::parse::convert(value, &v));
+  } else if (param == "sm.consolidation.pyramid_levels") {
+    RETURN_NOT_OK(utils::parse::convert(value, &v32));
+  } else if (param == "sm.consolidation.pyramid_method") {
+    if (value != "mean" && value != "max" && value != "nearest")
+      return LOG_STATUS(
+          Status::ConfigError("Invalid pyramid method parameter value"));
+  } else if (param == "sm.consolidation.auto_interval_ms") {
+    RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
+  } else if (param == "sm.consolidation.auto_fragment_num") {
+    RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
+  } else if (param == "sm.consolidation.auto_array_metadata_num") {
+    RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
   } else if (param == "vfs.num_threads") {
     RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
   } else if (param == "vfs.min_parallel_size") {
     RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
   } else if (param == "vfs.min_batch_gap") {
     RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
+  } else if (param == "vfs.adaptive_batch_gap") {
+    RETURN_NOT_OK(utils::parse::convert(value, &v));
   } else if (param == "vfs.min_batch_size") {
     RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
+  } else if (param == "vfs.write_behind_buffer_size") {
+    RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
+  } else if (param == "vfs.emulated_latency_ms") {
+    RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
+  } else if (param == "vfs.emulated_bandwidth") {
+    RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
   } else if (param == "vfs.file.max_parallel_ops") {
     RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
   } else if (param == "vfs.file.enable_filelocks") {
     RETURN_NOT_OK(utils::parse::convert(value, &v));
+  } else if (param == "vfs.file.enable_read_filelocks") {
+    RETURN_NOT_OK(utils::parse::convert(value, &v));
+  } else if (param == "vfs.file.io_engine") {
+    if (value != "pread" && value != "io_uring" && value != "overlapped")
+      return LOG_STATUS(
+          Status::ConfigError("Invalid file I/O engine parameter value"));
+  } else if (param == "vfs.file.enable_mmap") {
+    RETURN_NOT_OK(utils::parse::convert(value, &v));
+  } else if (param == "vfs.file.direct_io") {
+    RETURN_NOT_OK(utils::parse::convert(value, &v));
   } else if (param == "vfs.s3.scheme") {
     if (value != "http" && value != "https")
       return LOG_STATUS(
@@ -520,8 +1004,25 @@ Status Config::sanity_check(
     RETURN_NOT_OK(utils::parse::convert(value, &v));
   } else if (param == "vfs.s3.max_parallel_ops") {
     RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
+  } else if (param == "vfs.hdfs.max_parallel_ops") {
+    RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
+  } else if (param == "vfs.hdfs.short_circuit_read") {
+    RETURN_NOT_OK(utils::parse::convert(value, &v));
+  } else if (param == "vfs.hdfs.zero_copy_read") {
+    RETURN_NOT_OK(utils::parse::convert(value, &v));
   } else if (param == "vfs.s3.multipart_part_size") {
     RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
+  } else if (param == "vfs.s3.max_buffer_size") {
+    RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
+  } else if (param == "vfs.s3.read_part_size") {
+    RETURN_NOT_OK(utils::parse::convert(value, &vuint64));
+  } else if (param == "vfs.s3.hedge_percentile") {
+    RETURN_NOT_OK(utils::parse::convert(value, &vf));
+    if (vf < 0.0f || vf >= 100.0f)
+      return LOG_STATUS(Status::ConfigError(
+          "Invalid S3 hedge percentile; Must be in [0, 100)"));
+  } else if (param == "vfs.s3.hedge_max_ratio") {
+    RETURN_NOT_OK(utils::parse::convert(value, &vf));
   } else if (param == "vfs.s3.connect_timeout_ms") {
     RETURN_NOT_OK(utils::parse::convert(value, &vint64));
   } else if (param == "vfs.s3.connect_max_tries") {
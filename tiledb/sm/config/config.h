@@ -66,6 +66,18 @@ class Config {
   /** The default compressor for http requests with the rest server. */
   static const std::string REST_SERVER_DEFAULT_HTTP_COMPRESSOR;
 
+  /** The default compressor of the http request bodies sent to the server. */
+  static const std::string REST_SERVER_DEFAULT_HTTP_REQUEST_COMPRESSOR;
+
+  /**
+   * The default time in milliseconds for which the array schemas and
+   * non-empty domains received from the server are reused.
+   */
+  static const std::string REST_SERVER_DEFAULT_CACHE_TTL_MS;
+
+  /** The default number of concurrent requests a remote read is split into. */
+  static const std::string REST_SERVER_DEFAULT_READ_PARTITION_NUM;
+
   /** If `true`, this will deduplicate coordinates upon sparse writes. */
   static const std::string SM_DEDUP_COORDS;
 
@@ -90,6 +102,151 @@ class Config {
   /** The tile cache size. */
   static const std::string SM_TILE_CACHE_SIZE;
 
+  /** The number of independently locked shards of the tile cache. */
+  static const std::string SM_TILE_CACHE_SHARDS;
+
+  /** The tile cache eviction and admission policy. */
+  static const std::string SM_TILE_CACHE_POLICY;
+
+  /** The form (`unfiltered`, `filtered` or `auto`) of the cached tiles. */
+  static const std::string SM_TILE_CACHE_MODE;
+
+  /** The local directory of the on-disk tile cache (empty to disable). */
+  static const std::string SM_TILE_DISK_CACHE_DIR;
+
+  /** The maximum size of the on-disk tile cache in bytes. */
+  static const std::string SM_TILE_DISK_CACHE_SIZE;
+
+  /** If `true`, incomplete reads prefetch the tiles of the next partition. */
+  static const std::string SM_READ_PREFETCH;
+
+  /**
+   * The read planner, `none` or `cost` (the query chooses its tile selection,
+   * prefetching and partition splits from the fragment metadata).
+   */
+  static const std::string SM_READ_PLANNER;
+
+  /**
+   * If `true`, opening an array for reads loads the fragment R-Trees and
+   * tile offsets in the background.
+   */
+  static const std::string SM_EAGER_METADATA_LOAD;
+
+  /**
+   * If `true`, read partitions are split on tile boundaries balanced by
+   * their estimated results, instead of at the range midpoint.
+   */
+  static const std::string SM_PARTITIONER_BALANCED_SPLITS;
+
+  /**
+   * The fraction of `sm.memory_budget` that a read query may spend to keep
+   * the tiles unfiltered by a partition for the next one.
+   */
+  static const std::string SM_PARTITION_TILE_CACHE_RATIO;
+
+  /**
+   * If `true`, global order writes filter and write their tiles in the
+   * background.
+   */
+  static const std::string SM_WRITE_ASYNC_FLUSH;
+
+  /**
+   * The size of the cells of unordered sparse writes buffered per array in
+   * the context before they are flushed as a single fragment (`0` disables
+   * the write buffer).
+   */
+  static const std::string SM_WRITE_BUFFER_MAX_SIZE;
+
+  /**
+   * The age (in ms) at which the cells buffered for an array are flushed
+   * in the background (`0` to flush only on size).
+   */
+  static const std::string SM_WRITE_BUFFER_MAX_AGE_MS;
+
+  /**
+   * The maximum number of fragments an unordered write splits its cells
+   * into, writing them in parallel.
+   */
+  static const std::string SM_UNORDERED_WRITE_FRAGMENT_NUM;
+
+  /**
+   * The filtered tile size that sparse writes recommend a capacity for
+   * (`0` to disable the recommendation).
+   */
+  static const std::string SM_CAPACITY_TARGET_TILE_SIZE;
+
+  /** The size of the process-wide fragment metadata cache. */
+  static const std::string SM_FRAGMENT_METADATA_CACHE_SIZE;
+
+  /**
+   * The size up to which a fragment metadata file is fetched with a single
+   * read when its footer is loaded (`0` to disable).
+   */
+  static const std::string SM_FRAGMENT_METADATA_SPECULATIVE_READ_SIZE;
+
+  /**
+   * Whether the generic tiles of new fragment metadata files are stored
+   * uncompressed, so that they are used in place when mapped.
+   */
+  static const std::string SM_FRAGMENT_METADATA_UNFILTERED;
+
+  /**
+   * The total filtered size up to which the tiles of a new fragment are
+   * packed into a single object (`0` to disable packing).
+   */
+  static const std::string SM_FRAGMENT_PACKING_MAX_SIZE;
+
+  /** The size of the per-context cache of deserialized fragment R-Trees. */
+  static const std::string SM_INDEX_CACHE_SIZE;
+
+  /** The number of empty subarrays recorded per array opened for reads. */
+  static const std::string SM_EMPTY_SUBARRAY_CACHE_SIZE;
+
+  /** The width in bits of the var-sized offsets of reads and writes. */
+  static const std::string SM_VAR_OFFSETS_BITSIZE;
+
+  /**
+   * If `true`, the offsets of var-sized attributes of reads and writes end
+   * with the end offset of the last cell.
+   */
+  static const std::string SM_VAR_OFFSETS_EXTRA_ELEMENT;
+
+  /** The unit (bytes or elements) of the var-sized offsets. */
+  static const std::string SM_VAR_OFFSETS_MODE;
+
+  /** The bits per cell of the coordinate bloom filter of sparse fragments. */
+  static const std::string SM_COORDS_BLOOM_FILTER_BITS;
+
+  /** Whether the R-Trees of new fragments are packed with STR. */
+  static const std::string SM_RTREE_STR_PACKING;
+
+  /**
+   * Whether new fragments store distinct count and quantile sketches of
+   * their numeric attributes.
+   */
+  static const std::string SM_FRAGMENT_SKETCHES;
+
+  /**
+   * The comma-separated names of the attributes whose values are indexed
+   * in each new fragment.
+   */
+  static const std::string SM_VALUE_INDEX_ATTRIBUTES;
+
+  /**
+   * Whether writers maintain an array manifest listing the fragments, which
+   * readers use instead of listing the array directory.
+   */
+  static const std::string SM_ARRAY_MANIFEST;
+
+  /**
+   * The maximum number of bytes of freed tile buffers kept by the
+   * process-wide buffer pool for reuse (`0` to disable the pool).
+   */
+  static const std::string SM_BUFFER_POOL_SIZE;
+
+  /** Whether the large buffers of the buffer pool use huge pages. */
+  static const std::string SM_BUFFER_POOL_HUGE_PAGES;
+
   /**
    * The maximum memory budget for producing the result (in bytes)
    * for a fixed-sized attribute or the offsets of a var-sized attribute.
@@ -114,9 +271,46 @@ class Config {
   /** The number of threads allocated per StorageManager for the Writer pool. */
   static const std::string SM_NUM_WRITER_THREADS;
 
+  /**
+   * The number of threads allocated per StorageManager for loading fragment
+   * metadata (`0` to load on the TBB/parallel_for threads).
+   */
+  static const std::string SM_NUM_FRAGMENT_METADATA_THREADS;
+
+  /**
+   * The number of threads of the process-wide task scheduler shared by the
+   * reader, writer, async, fragment metadata and VFS pools of all contexts
+   * (`0` to give every context its own pools).
+   */
+  static const std::string SM_NUM_SCHEDULER_THREADS;
+
   /** The number of threads allocated for TBB. */
   static const std::string SM_NUM_TBB_THREADS;
 
+  /**
+   * If `true`, the workers of the thread pools are pinned round robin to the
+   * CPUs of the NUMA nodes (Linux only).
+   */
+  static const std::string SM_NUMA_PINNING;
+
+  /**
+   * The fraction of the queries that gather their own stats (and traces, if
+   * `sm.stats.sample_traces` is set) while the global stats are disabled.
+   */
+  static const std::string SM_STATS_SAMPLE_RATE;
+
+  /** If `true`, the calls of the sampled queries are traced too. */
+  static const std::string SM_STATS_SAMPLE_TRACES;
+
+  /**
+   * The latency (in ms) from which a query submission is logged to the slow
+   * query log. `0` disables the log.
+   */
+  static const std::string SM_STATS_SLOW_QUERY_THRESHOLD_MS;
+
+  /** The file of the slow query log (standard error if empty). */
+  static const std::string SM_STATS_SLOW_QUERY_LOG;
+
   /**
    * The factor by which the size of the dense fragment resulting
    * from consolidating a set of fragments (containing at least one
@@ -140,6 +334,79 @@ class Config {
   /** Maximum number of fragments to consolidate per step. */
   static const std::string SM_CONSOLIDATION_STEP_MAX_FRAGS;
 
+  /**
+   * Whether fragments that do not overlap in the global order are
+   * consolidated by copying their filtered tiles.
+   */
+  static const std::string SM_CONSOLIDATION_TILE_COPY;
+
+  /**
+   * Only fragments whose timestamp range intersects
+   * `[timestamp_start, timestamp_end]` are consolidated.
+   */
+  static const std::string SM_CONSOLIDATION_TIMESTAMP_START;
+
+  /** See `SM_CONSOLIDATION_TIMESTAMP_START`. */
+  static const std::string SM_CONSOLIDATION_TIMESTAMP_END;
+
+  /**
+   * If not empty, only fragments whose non-empty domain intersects this
+   * subarray (comma-separated low/high bounds per dimension) are
+   * consolidated.
+   */
+  static const std::string SM_CONSOLIDATION_SUBARRAY;
+
+  /**
+   * Upper bound on the buffer memory of the consolidation steps that run
+   * concurrently. `0` runs one step at a time.
+   */
+  static const std::string SM_CONSOLIDATION_MEMORY_BUDGET;
+
+  /**
+   * The consolidation step planner, `size_ratio` or `cost` (best estimated
+   * read benefit per byte written).
+   */
+  static const std::string SM_CONSOLIDATION_PLANNER;
+
+  /** The read cost of a fragment in bytes for the `cost` planner. */
+  static const std::string SM_CONSOLIDATION_PLANNER_FRAGMENT_COST;
+
+  /** If `true`, consolidation prints its plan instead of executing it. */
+  static const std::string SM_CONSOLIDATION_DRY_RUN;
+
+  /**
+   * If `true`, consolidation leaves the fragments it supersedes to a later
+   * vacuum instead of deleting them.
+   */
+  static const std::string SM_CONSOLIDATION_DEFERRED_VACUUM;
+
+  /**
+   * The number of downsampled levels of the pyramid that consolidation
+   * builds for dense arrays. `0` builds none.
+   */
+  static const std::string SM_CONSOLIDATION_PYRAMID_LEVELS;
+
+  /** The downsampling method of the pyramid levels. */
+  static const std::string SM_CONSOLIDATION_PYRAMID_METHOD;
+
+  /**
+   * The period (in ms) of the background consolidation service of the
+   * arrays opened for writes. `0` disables it.
+   */
+  static const std::string SM_CONSOLIDATION_AUTO_INTERVAL_MS;
+
+  /**
+   * The number of fragments at which the background consolidation service
+   * consolidates an array.
+   */
+  static const std::string SM_CONSOLIDATION_AUTO_FRAGMENT_NUM;
+
+  /**
+   * The number of array metadata files at which closing an array for
+   * writes consolidates them. `0` disables it.
+   */
+  static const std::string SM_CONSOLIDATION_AUTO_ARRAY_METADATA_NUM;
+
   /**
    * Size ratio of two fragments to be considered for consolidation in a step.
    * This should be a value in [0.0, 1.0].
@@ -158,15 +425,39 @@ class Config {
    */
   static const std::string VFS_MIN_BATCH_GAP;
 
+  /** If `true`, the batch gap is derived from the observed read cost. */
+  static const std::string VFS_ADAPTIVE_BATCH_GAP;
+
   /** The default minimum number of bytes in a batched VFS read operation. */
   static const std::string VFS_MIN_BATCH_SIZE;
 
+  /** The per-file write-behind buffer size for local and HDFS writes. */
+  static const std::string VFS_WRITE_BEHIND_BUFFER_SIZE;
+
+  /** The latency (in ms) added to every VFS request, for benchmarking. */
+  static const std::string VFS_EMULATED_LATENCY_MS;
+
+  /** The per-request bandwidth (in bytes/s) emulated by the VFS. */
+  static const std::string VFS_EMULATED_BANDWIDTH;
+
   /** The default maximum number of parallel file:/// operations. */
   static const std::string VFS_FILE_MAX_PARALLEL_OPS;
 
   /** Whether or not filelocks are enabled for VFS. */
   static const std::string VFS_FILE_ENABLE_FILELOCKS;
 
+  /** Whether or not arrays opened for reads take a shared filelock. */
+  static const std::string VFS_FILE_ENABLE_READ_FILELOCKS;
+
+  /** The engine used for batched reads on `file:///` URIs. */
+  static const std::string VFS_FILE_IO_ENGINE;
+
+  /** Whether or not local tiles are read through memory mapping. */
+  static const std::string VFS_FILE_ENABLE_MMAP;
+
+  /** If `true`, local file reads and writes bypass the page cache. */
+  static const std::string VFS_FILE_DIRECT_IO;
+
   /** S3 region. */
   static const std::string VFS_S3_REGION;
 
@@ -197,6 +488,24 @@ class Config {
   /** Size of parts used in the S3 multi-part uploads. */
   static const std::string VFS_S3_MULTIPART_PART_SIZE;
 
+  /**
+   * The maximum number of bytes buffered across all the S3 objects being
+   * written with multi-part uploads (`0` for no limit).
+   */
+  static const std::string VFS_S3_MAX_BUFFER_SIZE;
+
+  /** The part size (in bytes) of parallel S3 range reads. */
+  static const std::string VFS_S3_READ_PART_SIZE;
+
+  /**
+   * The percentile of the latencies of recent S3 range GETs after which a
+   * read issues a duplicate GET (`0` disables hedging).
+   */
+  static const std::string VFS_S3_HEDGE_PERCENTILE;
+
+  /** The maximum ratio of S3 reads that issue a duplicate GET. */
+  static const std::string VFS_S3_HEDGE_MAX_RATIO;
+
   /** Certificate file path. */
   static const std::string VFS_S3_CA_FILE;
 
@@ -245,6 +554,18 @@ class Config {
   /** HDFS default username. */
   static const std::string VFS_HDFS_USERNAME;
 
+  /** The default maximum number of parallel hdfs:// operations. */
+  static const std::string VFS_HDFS_MAX_PARALLEL_OPS;
+
+  /** Whether HDFS reads are short-circuited for local blocks. */
+  static const std::string VFS_HDFS_SHORT_CIRCUIT_READ;
+
+  /** The domain socket path used for short-circuit HDFS reads. */
+  static const std::string VFS_HDFS_DOMAIN_SOCKET_PATH;
+
+  /** Whether HDFS reads are attempted as zero-copy reads. */
+  static const std::string VFS_HDFS_ZERO_COPY_READ;
+
   /* ****************************** */
   /*        OTHER CONSTANTS         */
   /* ****************************** */
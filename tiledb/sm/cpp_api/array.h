@@ -509,6 +509,125 @@ class Array {
         timestamp);
   }
 
+  /**
+   * Asynchronously loads the fragment metadata and the tiles of the given
+   * attributes that overlap the given subarray into the tile cache, so that
+   * later reads of that region are served from memory. Returns
+   * immediately; `close()` and `reopen()` wait for the prefetch to finish.
+   *
+   * **Example:**
+   * @code{.cpp}
+   * tiledb::Array array(ctx, "s3://bucket-name/array-name", TILEDB_READ);
+   * array.prefetch<int32_t>({1, 100, 1, 100}, {"a1"});
+   * // ... later
+   * tiledb::Query query(ctx, array);
+   * @endcode
+   *
+   * @tparam T The domain datatype
+   * @param subarray The subarray to prefetch. If empty, the entire domain
+   *     is prefetched.
+   * @param attrs The attributes to prefetch. If empty, all the attributes
+   *     are prefetched.
+   *
+   * @throws TileDBError if the array is not open for reads or an attribute
+   *     is invalid.
+   */
+  template <typename T>
+  void prefetch(
+      const std::vector<T>& subarray,
+      const std::vector<std::string>& attrs = {}) {
+    auto& ctx = ctx_.get();
+    if (!subarray.empty())
+      impl::type_check<T>(schema_.domain().type(), 1);
+    std::vector<const char*> c_attrs;
+    for (const auto& attr : attrs)
+      c_attrs.push_back(attr.c_str());
+    ctx.handle_error(tiledb_array_prefetch(
+        ctx.ptr().get(),
+        array_.get(),
+        subarray.empty() ? nullptr : subarray.data(),
+        c_attrs.data(),
+        (uint32_t)c_attrs.size()));
+  }
+
+  /**
+   * Estimates the number of distinct values of a numeric attribute in a
+   * subarray from the sketches stored with the fragments (see the
+   * `sm.fragment_sketches` config parameter), without reading any tiles.
+   * The sketches of all the fragments whose non-empty domain overlaps the
+   * subarray are merged, so the estimate also covers their cells outside
+   * the subarray and those overwritten by later fragments.
+   *
+   * **Example:**
+   * @code{.cpp}
+   * tiledb::Array array(ctx, "s3://bucket-name/array-name", TILEDB_READ);
+   * uint64_t count = array.approx_distinct_count<int32_t>("a1", {1, 100});
+   * @endcode
+   *
+   * @tparam T The domain datatype
+   * @param attr The attribute name.
+   * @param subarray The subarray. If empty, all the fragments are
+   *     considered.
+   * @return The estimated number of distinct values.
+   *
+   * @throws TileDBError if an overlapping fragment has no sketches.
+   */
+  template <typename T>
+  uint64_t approx_distinct_count(
+      const std::string& attr, const std::vector<T>& subarray = {}) {
+    auto& ctx = ctx_.get();
+    if (!subarray.empty())
+      impl::type_check<T>(schema_.domain().type(), 1);
+    uint64_t count = 0;
+    ctx.handle_error(tiledb_array_get_approx_distinct_count(
+        ctx.ptr().get(),
+        array_.get(),
+        attr.c_str(),
+        subarray.empty() ? nullptr : subarray.data(),
+        &count));
+    return count;
+  }
+
+  /**
+   * Estimates a quantile of the values of a numeric attribute in a
+   * subarray from the sketches stored with the fragments, merged as in
+   * `approx_distinct_count`. The minimum and maximum (`q` equal to 0 or 1)
+   * are exact over the merged fragments.
+   *
+   * **Example:**
+   * @code{.cpp}
+   * tiledb::Array array(ctx, "s3://bucket-name/array-name", TILEDB_READ);
+   * double p99 = array.approx_quantile<int32_t>("a1", 0.99);
+   * @endcode
+   *
+   * @tparam T The domain datatype
+   * @param attr The attribute name.
+   * @param q The quantile, in [0, 1].
+   * @param subarray The subarray. If empty, all the fragments are
+   *     considered.
+   * @return The estimated quantile, or NaN if there are no values.
+   *
+   * @throws TileDBError if an overlapping fragment has no sketches.
+   */
+  template <typename T>
+  double approx_quantile(
+      const std::string& attr,
+      double q,
+      const std::vector<T>& subarray = {}) {
+    auto& ctx = ctx_.get();
+    if (!subarray.empty())
+      impl::type_check<T>(schema_.domain().type(), 1);
+    double value = 0;
+    ctx.handle_error(tiledb_array_get_approx_quantile(
+        ctx.ptr().get(),
+        array_.get(),
+        attr.c_str(),
+        subarray.empty() ? nullptr : subarray.data(),
+        q,
+        &value));
+    return value;
+  }
+
   /**
    * Reopens the array (the array must be already open). This is useful
    * when the array got updated after it got opened and the `Array`
@@ -572,6 +691,38 @@ class Array {
     return timestamp;
   }
 
+  /**
+   * Sets the start timestamp of the fragments the array is opened with
+   * for reads. Fragments whose timestamp range ends before it are ignored
+   * without loading their metadata, so that only the fragments written
+   * since `timestamp_start` are read. It takes effect the next time the
+   * array is opened or reopened.
+   *
+   * **Example:**
+   * @code{.cpp}
+   * tiledb::Array array(ctx, "s3://bucket-name/array-name");
+   * array.set_open_timestamp_start(timestamp_start);
+   * array.open(TILEDB_READ);
+   * @endcode
+   *
+   * @param timestamp_start The start timestamp, in ms elapsed since
+   *     1970-01-01 00:00:00 +0000 (UTC).
+   */
+  void set_open_timestamp_start(uint64_t timestamp_start) const {
+    auto& ctx = ctx_.get();
+    ctx.handle_error(tiledb_array_set_open_timestamp_start(
+        ctx.ptr().get(), array_.get(), timestamp_start));
+  }
+
+  /** Returns the start timestamp of the fragments the array is opened with. */
+  uint64_t open_timestamp_start() const {
+    auto& ctx = ctx_.get();
+    uint64_t timestamp_start;
+    ctx.handle_error(tiledb_array_get_open_timestamp_start(
+        ctx.ptr().get(), array_.get(), &timestamp_start));
+    return timestamp_start;
+  }
+
   /**
    * Closes the array. The destructor calls this automatically.
    *
@@ -1015,6 +1166,117 @@ class Array {
         config);
   }
 
+  /**
+   * @brief Consolidates the fragment metadata (footers and R-Trees) of an
+   * array into a single file, which opening the array fetches with a single
+   * request.
+   *
+   * **Example:**
+   * @code{.cpp}
+   * tiledb::Array::consolidate_fragment_metadata(
+   *     ctx, "s3://bucket-name/array-name");
+   * @endcode
+   *
+   * @param ctx TileDB context
+   * @param array_uri The URI of the TileDB array whose
+   *     fragment metadata will be consolidated.
+   * @param config Configuration parameters for the consolidation.
+   */
+  static void consolidate_fragment_metadata(
+      const Context& ctx,
+      const std::string& uri,
+      Config* const config = nullptr) {
+    consolidate_fragment_metadata(
+        ctx, uri, TILEDB_NO_ENCRYPTION, nullptr, 0, config);
+  }
+
+  /**
+   * @brief Consolidates the fragment metadata of an encrypted array.
+   *
+   * **Example:**
+   * @code{.cpp}
+   * // Load AES-256 key from disk, environment variable, etc.
+   * uint8_t key[32] = ...;
+   * tiledb::Array::consolidate_fragment_metadata(
+   *     ctx,
+   *     "s3://bucket-name/array-name",
+   *     TILEDB_AES_256_GCM,
+   *     key,
+   *     sizeof(key));
+   * @endcode
+   *
+   * @param ctx TileDB context
+   * @param array_uri The URI of the TileDB array whose
+   *     fragment metadata will be consolidated.
+   * @param encryption_type The encryption type to use.
+   * @param encryption_key The encryption key to use.
+   * @param key_length Length in bytes of the encryption key.
+   * @param config Configuration parameters for the consolidation.
+   */
+  static void consolidate_fragment_metadata(
+      const Context& ctx,
+      const std::string& uri,
+      tiledb_encryption_type_t encryption_type,
+      const void* encryption_key,
+      uint32_t key_length,
+      Config* const config = nullptr) {
+    ctx.handle_error(tiledb_array_consolidate_fragment_metadata_with_key(
+        ctx.ptr().get(),
+        uri.c_str(),
+        encryption_type,
+        encryption_key,
+        key_length,
+        config ? config->ptr().get() : nullptr));
+  }
+
+  /**
+   * @brief Deletes the fragments superseded by the consolidations of an
+   * array that ran with `sm.consolidation.deferred_vacuum` set.
+   *
+   * **Example:**
+   * @code{.cpp}
+   * tiledb::Array::vacuum(ctx, "s3://bucket-name/array-name");
+   * @endcode
+   *
+   * @param ctx TileDB context
+   * @param array_uri The URI of the TileDB array to vacuum.
+   */
+  static void vacuum(const Context& ctx, const std::string& uri) {
+    ctx.handle_error(tiledb_array_vacuum(ctx.ptr().get(), uri.c_str()));
+  }
+
+  /**
+   * @brief Consolidates the fragments of an array and returns the statistics
+   * of the consolidation as a JSON object.
+   *
+   * See `tiledb_array_consolidate_with_stats` for the statistics returned.
+   *
+   * **Example:**
+   * @code{.cpp}
+   * std::string stats = tiledb::Array::consolidate_with_stats(
+   *     ctx, "s3://bucket-name/array-name");
+   * @endcode
+   *
+   * @param ctx TileDB context
+   * @param array_uri The URI of the TileDB array to be consolidated.
+   * @param config Configuration parameters for the consolidation.
+   * @return The statistics of the consolidation.
+   */
+  static std::string consolidate_with_stats(
+      const Context& ctx,
+      const std::string& uri,
+      Config* const config = nullptr) {
+    char* stats;
+    ctx.handle_error(tiledb_array_consolidate_with_stats(
+        ctx.ptr().get(),
+        uri.c_str(),
+        config ? config->ptr().get() : nullptr,
+        &stats));
+    std::string str(stats);
+    tiledb_stats_free_str(&stats);
+    return str;
+  }
+
   /**
    * It puts a metadata key-value item to an open array. The array must
    * be opened in WRITE mode, otherwise the function will error out.
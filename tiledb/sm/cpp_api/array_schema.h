@@ -278,6 +278,34 @@ class ArraySchema : public Schema {
     return *this;
   }
 
+  /**
+   * Returns `true` if the tiles of each fragment are co-located (see
+   * `set_tile_colocation`).
+   */
+  bool tile_colocation() const {
+    auto& ctx = ctx_.get();
+    int32_t tile_colocation;
+    ctx.handle_error(tiledb_array_schema_get_tile_colocation(
+        ctx.ptr().get(), schema_.get(), &tile_colocation));
+    return tile_colocation != 0;
+  }
+
+  /**
+   * Sets whether the tiles with the same index of all attributes and
+   * dimensions of each fragment are stored contiguously in a single file,
+   * so that queries reading many attributes of few cells fetch each tile
+   * of all attributes with a single request.
+   *
+   * @param tile_colocation Whether to co-locate the tiles.
+   * @return Reference to this `ArraySchema` instance.
+   */
+  ArraySchema& set_tile_colocation(bool tile_colocation) {
+    auto& ctx = ctx_.get();
+    ctx.handle_error(tiledb_array_schema_set_tile_colocation(
+        ctx.ptr().get(), schema_.get(), tile_colocation ? 1 : 0));
+    return *this;
+  }
+
   /**
    * Sets both the tile and cell orders.
    *
@@ -300,7 +328,8 @@ class ArraySchema : public Schema {
   }
 
   /**
-   * Sets the cell order.
+   * Sets the cell order. Sparse arrays may also use `TILEDB_HILBERT`,
+   * which orders the cells of each space tile along a Hilbert curve.
    *
    * @param layout Cell order to set.
    * @return Reference to this `ArraySchema` instance.
@@ -571,6 +600,8 @@ class ArraySchema : public Schema {
         return "COL-MAJOR";
       case TILEDB_UNORDERED:
         return "UNORDERED";
+      case TILEDB_HILBERT:
+        return "HILBERT";
     }
     return "";
   }
@@ -0,0 +1,202 @@
+/**
+ * @file   query_condition.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file declares the C++ API for the TileDB ArraySnapshot object.
+ */
+
+#ifndef TILEDB_CPP_API_ARRAY_SNAPSHOT_H
+#define TILEDB_CPP_API_ARRAY_SNAPSHOT_H
+
+#include "array.h"
+#include "array_schema.h"
+#include "context.h"
+#include "query.h"
+#include "tiledb.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace tiledb {
+
+/**
+ * An immutable view of an array opened for reads at a fixed timestamp, which
+ * can be shared by threads submitting concurrent read queries. All the
+ * copies of a snapshot share a single open array, and with it a single load
+ * of the array schema and fragment metadata. The array is closed when the
+ * last copy is destroyed, and it cannot be reopened or closed through the
+ * snapshot.
+ *
+ * **Example:**
+ *
+ * @code{.cpp}
+ * tiledb::Context ctx;
+ * tiledb::ArraySnapshot snapshot(ctx, "my_array");
+ *
+ * // In each worker thread
+ * auto query = snapshot.query();
+ * query.set_subarray(...).set_buffer("a1", data_a1);
+ * query.submit();
+ * @endcode
+ *
+ * @note The context must outlive the snapshot and its queries. Each query
+ *     must still be used by a single thread at a time.
+ */
+class ArraySnapshot {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /**
+   * Opens a snapshot of the array at the given timestamp.
+   *
+   * @param ctx TileDB context.
+   * @param array_uri The array URI.
+   * @param timestamp The timestamp to open the array at. By default, the
+   *     array is opened at the current time.
+   */
+  ArraySnapshot(
+      const Context& ctx,
+      const std::string& array_uri,
+      uint64_t timestamp = UINT64_MAX)
+      : ArraySnapshot(
+            ctx, array_uri, TILEDB_NO_ENCRYPTION, nullptr, 0, timestamp) {
+  }
+
+  /**
+   * Opens a snapshot of an encrypted array at the given timestamp.
+   *
+   * @param ctx TileDB context.
+   * @param array_uri The array URI.
+   * @param encryption_type The encryption type to use.
+   * @param encryption_key The encryption key to use.
+   * @param key_length Length in bytes of the encryption key.
+   * @param timestamp The timestamp to open the array at. By default, the
+   *     array is opened at the current time.
+   */
+  ArraySnapshot(
+      const Context& ctx,
+      const std::string& array_uri,
+      tiledb_encryption_type_t encryption_type,
+      const void* encryption_key,
+      uint32_t key_length,
+      uint64_t timestamp = UINT64_MAX)
+      : ctx_(ctx)
+      , array_(open(
+            ctx,
+            array_uri,
+            encryption_type,
+            encryption_key,
+            key_length,
+            timestamp))
+      , schema_(array_->schema())
+      , timestamp_(array_->timestamp()) {
+  }
+
+  ArraySnapshot(const ArraySnapshot&) = default;
+  ArraySnapshot(ArraySnapshot&&) = default;
+  ArraySnapshot& operator=(const ArraySnapshot&) = default;
+  ArraySnapshot& operator=(ArraySnapshot&&) = default;
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /** Returns the open array, for read-only use. */
+  const Array& array() const {
+    return *array_;
+  }
+
+  /** Returns the array schema. */
+  const ArraySchema& schema() const {
+    return schema_;
+  }
+
+  /** Returns the timestamp the array was opened at. */
+  uint64_t timestamp() const {
+    return timestamp_;
+  }
+
+  /** Returns a new read query on the snapshot. */
+  Query query() const {
+    return Query(ctx_.get(), *array_, TILEDB_READ);
+  }
+
+ private:
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The TileDB context. */
+  std::reference_wrapper<const Context> ctx_;
+
+  /** The open array, shared by all the copies of the snapshot. */
+  std::shared_ptr<const Array> array_;
+
+  /** The array schema. */
+  ArraySchema schema_;
+
+  /** The timestamp the array was opened at. */
+  uint64_t timestamp_;
+
+  /* ********************************* */
+  /*          PRIVATE METHODS          */
+  /* ********************************* */
+
+  /** Opens the array, at the current time if `timestamp` is `UINT64_MAX`. */
+  static std::shared_ptr<const Array> open(
+      const Context& ctx,
+      const std::string& array_uri,
+      tiledb_encryption_type_t encryption_type,
+      const void* encryption_key,
+      uint32_t key_length,
+      uint64_t timestamp) {
+    if (timestamp == UINT64_MAX)
+      return std::shared_ptr<const Array>(new Array(
+          ctx,
+          array_uri,
+          TILEDB_READ,
+          encryption_type,
+          encryption_key,
+          key_length));
+    return std::shared_ptr<const Array>(new Array(
+        ctx,
+        array_uri,
+        TILEDB_READ,
+        encryption_type,
+        encryption_key,
+        key_length,
+        timestamp));
+  }
+};
+
+}  // namespace tiledb
+
+#endif  // TILEDB_CPP_API_ARRAY_SNAPSHOT_H
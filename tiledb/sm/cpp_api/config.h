@@ -240,14 +240,210 @@ class Config {
    * - `sm.tile_cache_size` <br>
    *    The tile cache size in bytes. Any `uint64_t` value is acceptable. <br>
    *    **Default**: 10,000,000
+   * - `sm.tile_cache_shards` <br>
+   *    The number of shards of the tile cache. Each shard is an independent LRU
+   *    cache with its own lock and an equal part of `sm.tile_cache_size`, and
+   *    each tile is assigned to a shard by a hash of its location, so that
+   *    concurrent readers rarely wait on each other. A tile larger than one
+   *    shard is not cached. `0` is treated as `1`. <br>
+   *    **Default**: 8
+   * - `sm.tile_cache_policy` <br>
+   *    The eviction and admission policy of the tile cache shards. `lru` evicts
+   *    the least recently used tile. `2q` first admits a new tile to a small
+   *    FIFO probation queue and promotes it to the main LRU list only if it is
+   *    read again after leaving the queue, so that a large one-off scan does
+   *    not evict the tiles used by other queries. Valid values: `lru`, `2q`.
+   *    <br>
+   *    **Default**: lru
+   * - `sm.tile_cache_mode` <br>
+   *    The form in which the tile cache holds the tiles. `unfiltered` caches
+   *    decompressed tiles, which are copied as is on a hit. `filtered` caches
+   *    the compressed (persisted) bytes, which fit more tiles in
+   *    `sm.tile_cache_size` but are unfiltered again on every hit. `auto`
+   *    caches filtered tiles only for the attributes compressed with a fast
+   *    decompressor (i.e., other than gzip and bzip2). Valid values:
+   *    `unfiltered`, `filtered`, `auto`. <br>
+   *    **Default**: unfiltered
+   * - `sm.tile_disk_cache_dir` <br>
+   *    A local directory where the filtered tiles of arrays on remote storage
+   *    (e.g., S3) are cached as files, as a second tier behind the in-memory
+   *    tile cache. The directory is created if it does not exist. The cache is
+   *    disabled if this is empty. <br>
+   *    **Default**: ""
+   * - `sm.tile_disk_cache_size` <br>
+   *    The maximum total size in bytes of the on-disk tile cache. The least
+   *    recently used tiles are removed to stay under it. <br>
+   *    **Default**: 1073741824
+   * - `sm.read_prefetch` <br>
+   *    If `true`, an incomplete read query fetches and unfilters the tiles of
+   *    its next subarray partition in the background while the current results
+   *    are being consumed, so that the next submission finds them in the tile
+   *    cache. This has an effect only if `sm.tile_cache_size` is not zero. <br>
+   *    **Default**: false
+   * - `sm.read_planner` <br>
+   *    If `cost`, each read query chooses its strategy when it is
+   *    initialized, from the tile overlap of its subarray and its estimated
+   *    result sizes. A query condition uses the value indexes of a fragment
+   *    only if the condition tiles it may skip are larger than the index, and
+   *    otherwise the tile minimum and maximum values only. Prefetching and
+   *    `sm.partitioner.balanced_splits` are enabled only if the results are
+   *    estimated to span several partitions (balanced splits only for single
+   *    range subarrays), overriding their config values. The choices are
+   *    reported in the read statistics. `none` uses the config values. <br>
+   *    **Default**: none
+   * - `sm.eager_metadata_load` <br>
+   *    If `true`, opening or reopening an array for reads starts loading the
+   *    R-Trees of its fragments in the background, along with the tile
+   *    offsets of the dimensions and of the attributes read by earlier
+   *    queries of the context on the array (for recent fragments, only the
+   *    page index and the first page of the offsets). Queries wait only for
+   *    the structures they need, while the application sets them up. <br>
+   *    **Default**: false
+   * - `sm.partitioner.balanced_splits` <br>
+   *    If `true`, a read partition that does not fit the result buffers is
+   *    split on an MBR or space tile boundary, chosen to balance the
+   *    estimated results of the two halves, instead of at its midpoint. This
+   *    avoids fetching and unfiltering the same tile in consecutive
+   *    partitions. <br>
+   *    **Default**: false
+   * - `sm.partition_tile_cache_ratio` <br>
+   *    The fraction of `sm.memory_budget` that a read query spends to keep
+   *    the tiles it unfiltered for a partition until its next partition has
+   *    run, so that the tiles shared by consecutive partitions of an
+   *    incomplete read are not read and unfiltered again. Unlike the tile
+   *    cache, this cache is private to the query. `0` disables it. <br>
+   *    **Default**: 0.1
+   * - `sm.write_async_flush` <br>
+   *    If `true`, each submission of a global order write filters and writes
+   *    its full tiles in the background and returns, so that the next
+   *    submission can be prepared meanwhile. A submission waits for the
+   *    tiles of the previous one to be written, and so does the
+   *    finalization, which reports any error of the last flush. <br>
+   *    **Default**: false
+   * - `sm.write_buffer.max_size` <br>
+   *    If not `0`, the unordered writes to sparse arrays are not written
+   *    right away, but their cells are buffered in memory per array across
+   *    queries of the context, and flushed as a single fragment once they
+   *    take this many bytes. The buffered cells of an array are also
+   *    flushed when the array is opened or reopened for reads with the
+   *    context, so that reads see the earlier writes, and when the context
+   *    is freed. Buffered cells are lost if the process exits before they
+   *    are flushed, and a buffered write reports errors such as duplicate
+   *    coordinates only when it is flushed. <br>
+   *    **Default**: 0
+   * - `sm.write_buffer.max_age_ms` <br>
+   *    If not `0`, a background service flushes the cells buffered for an
+   *    array (see `sm.write_buffer.max_size`) once the oldest of them has
+   *    been buffered for this many milliseconds. <br>
+   *    **Default**: 0
+   * - `sm.unordered_write_fragment_num` <br>
+   *    The maximum number of fragments an unordered write splits its sorted
+   *    cells into. The cells are split at space tile boundaries along the
+   *    first dimension of the tile order, so that the non-empty domains of
+   *    the fragments do not overlap, and the fragments are written in
+   *    parallel. Splitting requires all dimensions to have tile extents and
+   *    no explicit fragment URI. <br>
+   *    **Default**: 1
+   * - `sm.capacity_target_tile_size` <br>
+   *    If not `0`, each sparse write samples its filtered tiles and
+   *    recommends the capacity for which the largest filtered tiles would
+   *    have this size in bytes, e.g., 1-4MB for S3. The largest
+   *    recommendation is reported by the `writer_recommended_capacity`
+   *    statistics counter. <br>
+   *    **Default**: 0
    * - `sm.array_schema_cache_size` <br>
    *    Array schema cache size in bytes. Any `uint64_t` value is acceptable.
    * <br>
    *    **Default**: 10,000,000
    * - `sm.fragment_metadata_cache_size` <br>
-   *    The fragment metadata cache size in bytes. Any `uint64_t` value is
-   *    acceptable. <br>
+   *    The size in bytes of the process-wide cache of decoded array schemas
+   *    and fragment metadata, shared by all contexts, so that reopening an
+   *    array only reads the metadata of fragments it has not seen before.
+   *    It is set by the first context created in the process. `0` disables
+   *    the cache. Arrays that are encrypted are not cached. <br>
    *    **Default**: 10,000,000
+   * - `sm.fragment_metadata_speculative_read_size` <br>
+   *    Fragment metadata files up to this size in bytes are fetched with a
+   *    single read when an array is opened, decoding the footer and the
+   *    R-Tree from the same buffer instead of issuing a request per
+   *    section. `0` disables the speculative read. <br>
+   *    **Default**: 65536
+   * - `sm.fragment_metadata_unfiltered` <br>
+   *    If `true`, the R-Tree, tile offsets and other sections of the
+   *    metadata of new fragments are stored uncompressed. With
+   *    `vfs.file.enable_mmap`, readers of local arrays then use them in
+   *    place from the mapped file instead of reading and decompressing
+   *    them. <br>
+   *    **Default**: false
+   * - `sm.fragment_packing_max_size` <br>
+   *    If not `0`, new fragments whose filtered tiles take at most this many
+   *    bytes in total store the tiles of all their attributes and
+   *    dimensions in a single object, with the offset of each attribute file
+   *    recorded in the fragment metadata. A small write then creates one
+   *    object instead of one or two per attribute, and reading a tile of all
+   *    attributes is a single coalesced read. Global order writes are not
+   *    packed. <br>
+   *    **Default**: 0
+   * - `sm.index_cache_size` <br>
+   *    The size in bytes of the cache of deserialized fragment R-Trees,
+   *    shared by all the arrays opened with the context and kept apart from
+   *    the tile cache, so that sparse reads do not deserialize the R-Trees
+   *    again after an array is reopened. `0` disables the cache. <br>
+   *    **Default**: 100,000,000
+   * - `sm.empty_subarray_cache_size` <br>
+   *    The number of subarrays in which sparse reads found no results that
+   *    are recorded per array opened for reads, so that repeating such a
+   *    read returns immediately until a new fragment is loaded. `0`
+   *    disables the records. <br>
+   *    **Default**: 0
+   * - `sm.coords_bloom_filter_bits` <br>
+   *    The number of bits per cell of the bloom filter over the coordinates
+   *    that writes store with each new sparse fragment. Point reads skip
+   *    the fragments whose filter rejects the queried coordinates; `10`
+   *    bits give about 1% false positives. `0` stores no bloom filter. <br>
+   *    **Default**: 0
+   * - `sm.rtree_str_packing` <br>
+   *    If `true`, writes pack the R-Tree leaves of each new sparse fragment
+   *    with Sort-Tile-Recursive instead of grouping consecutive tiles,
+   *    which improves pruning when the tile MBRs are not spatially
+   *    ordered. <br>
+   *    **Default**: false
+   * - `sm.fragment_sketches` <br>
+   *    If `true`, writes and consolidation store with each new fragment a
+   *    HyperLogLog distinct count sketch and a KLL quantile sketch of the
+   *    values of each numeric attribute with one value per cell, which
+   *    `Array::approx_distinct_count` and `Array::approx_quantile` answer
+   *    from. <br>
+   *    **Default**: false
+   * - `sm.value_index_attributes` <br>
+   *    The comma-separated names of attributes whose values writes and
+   *    consolidation index in each new fragment, as sorted (value, tile,
+   *    cell) entries. Read queries with a condition on an indexed attribute
+   *    then read only the tiles with cells satisfying it. Only numeric
+   *    attributes with one value per cell are indexed. <br>
+   *    **Default**: ""
+   * - `sm.array_manifest` <br>
+   *    If `true`, writes and consolidation keep a manifest file listing the
+   *    fragments of the array, and opening the array for reads gets the
+   *    fragments from it with a single request instead of listing the
+   *    array directory. All the writers of the array must enable it, and
+   *    their commits must not be concurrent across processes, as a
+   *    manifest update could otherwise miss a fragment. Writers then commit
+   *    fragments without locking the array, so they never wait for readers
+   *    or for a consolidation. <br>
+   *    **Default**: false
+   * - `sm.buffer_pool_size` <br>
+   *    The maximum number of bytes of freed tile buffers that are kept by a
+   *    process-wide pool, so that the buffers of later tiles of about the
+   *    same size reuse them instead of allocating new memory. Buffers of
+   *    64KB or more are rounded up to the pool size classes (within 25%).
+   *    The largest size set by any context applies. `0` disables the pool.
+   *    <br>
+   *    **Default**: 0
+   * - `sm.buffer_pool_huge_pages` <br>
+   *    If `true`, the pooled buffers of 2MB or more are backed by huge
+   *    pages where possible (Linux only). <br>
+   *    **Default**: false
    * - `sm.enable_signal_handlers` <br>
    *    Whether or not TileDB will install signal handlers. <br>
    *    **Default**: true
@@ -262,12 +458,56 @@ class Config {
    *    The number of threads allocated for issuing writes to VFS in
    *    parallel.<br>
    *    **Default**: 1
+   * - `sm.num_fragment_metadata_threads` <br>
+   *    The number of threads allocated for loading the metadata of the
+   *    fragments of an array in parallel. `0` loads them on the TBB threads
+   *    (or serially if TBB is disabled). <br>
+   *    **Default**: 0
+   * - `sm.num_scheduler_threads` <br>
+   *    If non-zero, the reader, writer, async, fragment metadata and VFS
+   *    tasks of all contexts run on a single process-wide work-stealing
+   *    scheduler with this many threads (e.g., the number of cores), instead
+   *    of on per-context pools. The scheduler runs the tasks of high
+   *    priority queries first, then I/O tasks, then compute tasks, then tasks
+   *    of low priority queries and of the background consolidation. It is
+   *    created with the value of the first context that sets this
+   *    parameter. <br>
+   *    **Default**: 0
    * - `sm.num_tbb_threads` <br>
    *    The number of threads allocated for the TBB thread pool (if TBB is
    *    enabled). Note: this is a whole-program setting. Usually this should not
    *    be modified from the default. See also the documentation for TBB's
    *    `task_scheduler_init` class.<br>
    *    **Default**: TBB automatic
+   * - `sm.numa_pinning` <br>
+   *    If `true`, every worker of the thread pools of the context (or of the
+   *    process-wide scheduler) and of TBB is pinned to the CPUs of one NUMA
+   *    node, the workers being spread round robin over the nodes. Memory
+   *    is placed on the node of the thread that first writes it, so the
+   *    tile buffers a worker fills, e.g., when unfiltering, stay local to
+   *    it. Linux only. <br>
+   *    **Default**: false
+   * - `sm.stats.sample_rate` <br>
+   *    The fraction of the queries, drawn at random when they are created,
+   *    that gather their own stats (see `Query::stats`) while the global
+   *    stats are disabled. Only the sampled queries pay for gathering
+   *    stats. <br>
+   *    **Default**: 0.0
+   * - `sm.stats.sample_traces` <br>
+   *    If `true`, the calls of the sampled queries are also recorded in the
+   *    trace (see `Stats::trace_dump`) while tracing is disabled. <br>
+   *    **Default**: false
+   * - `sm.stats.slow_query_threshold_ms` <br>
+   *    If non-zero, every query submission whose processing takes at least
+   *    that many milliseconds is appended to the slow query log as a JSON
+   *    line with the array, type, status and latency of the query, and its
+   *    stats if it gathers them (i.e., if stats are enabled or its stats
+   *    are sampled). <br>
+   *    **Default**: 0
+   * - `sm.stats.slow_query_log` <br>
+   *    The file the slow query log is appended to, or standard error if
+   *    empty. <br>
+   *    **Default**: ""
    * - `sm.consolidation.amplification` <br>
    *    The factor by which the size of the dense fragment resulting
    *    from consolidating a set of fragments (containing at least one
@@ -295,6 +535,85 @@ class Config {
    *    The size ratio that two ("adjacent") fragments must satisfy to be
    *    considered for consolidation in a single step.<br>
    *    **Default**: 0.0
+   * - `sm.consolidation.tile_copy` <br>
+   *    If `true`, fragments that do not overlap in the global order (and
+   *    whose tiles line up) are consolidated by copying their filtered tiles
+   *    instead of decoding and re-encoding their cells. Overlapping dense
+   *    fragments are consolidated by rewriting only the space tiles that
+   *    more than one of them covers, if those are at most half. <br>
+   *    **Default**: true
+   * - `sm.consolidation.timestamp_start` <br>
+   *    Only the fragments whose timestamp range intersects
+   *    `[timestamp_start, timestamp_end]` are consolidated, which leaves
+   *    older (cold) fragments untouched. <br>
+   *    **Default**: 0
+   * - `sm.consolidation.timestamp_end` <br>
+   *    See `sm.consolidation.timestamp_start`. <br>
+   *    **Default**: UINT64_MAX
+   * - `sm.consolidation.subarray` <br>
+   *    If set, only the fragments whose non-empty domain intersects this
+   *    subarray are consolidated. It is given as comma-separated low and
+   *    high bounds per dimension, e.g., `"1,10,5,20"`. <br>
+   *    **Default**: ""
+   * - `sm.consolidation.memory_budget` <br>
+   *    If it can hold the buffers of several consolidation steps (two sets
+   *    of `sm.consolidation.buffer_size` buffers each), the steps over
+   *    disjoint sets of fragments run concurrently within this budget.
+   *    `0` runs one step at a time. <br>
+   *    **Default**: 0
+   * - `sm.consolidation.planner` <br>
+   *    How each consolidation step picks its fragments among the eligible
+   *    sets. `size_ratio` picks the largest set with the smallest size.
+   *    `cost` estimates the read cost each set saves (fragments no longer
+   *    opened plus overwritten cells no longer read, weighted by the ratio
+   *    of read to write queries when statistics are enabled) and picks the
+   *    set with the best benefit per byte written, provided it saves at
+   *    least as many bytes as it writes. <br>
+   *    **Default**: size_ratio
+   * - `sm.consolidation.planner_fragment_cost` <br>
+   *    The read cost of opening a fragment in bytes, used by the `cost`
+   *    planner. <br>
+   *    **Default**: 1048576
+   * - `sm.consolidation.dry_run` <br>
+   *    If `true`, consolidation prints to stdout the sets of fragments it
+   *    would consolidate next, with their sizes and estimated benefit,
+   *    without consolidating them. <br>
+   *    **Default**: false
+   * - `sm.consolidation.deferred_vacuum` <br>
+   *    If `true`, consolidation does not delete the fragments it supersedes.
+   *    It lists them in a vacuum file next to the new fragment, readers
+   *    ignore them, and `Array::vacuum` (or the background
+   *    consolidation service) deletes them later in a batch. <br>
+   *    **Default**: false
+   * - `sm.consolidation.pyramid_levels` <br>
+   *    If non-zero, consolidating a dense array also rebuilds that many
+   *    levels of its pyramid, each halving the resolution of the previous
+   *    one along every dimension, which read queries select with
+   *    `Query::set_resolution_level`. The levels hold the fixed-sized
+   *    attributes and are snapshots of the array at consolidation. <br>
+   *    **Default**: 0
+   * - `sm.consolidation.pyramid_method` <br>
+   *    How a cell of a pyramid level is computed from the cells it covers in
+   *    the previous level: `mean`, `max` or `nearest` (the first cell).
+   *    Attributes that are not numeric with one value per cell use
+   *    `nearest`. <br>
+   *    **Default**: mean
+   * - `sm.consolidation.auto_interval_ms` <br>
+   *    If non-zero, a background service consolidates the arrays opened for
+   *    writes with the context, visiting one array every that many
+   *    milliseconds. Each visit runs a single consolidation step following
+   *    the other `sm.consolidation.*` parameters, if the array has at least
+   *    `sm.consolidation.auto_fragment_num` fragments and no query is in
+   *    progress and the array is not open for reads. <br>
+   *    **Default**: 0
+   * - `sm.consolidation.auto_fragment_num` <br>
+   *    The number of fragments at which the background consolidation service
+   *    consolidates an array. <br>
+   *    **Default**: 16
+   * - `sm.consolidation.auto_array_metadata_num` <br>
+   *    The number of array metadata files at which closing an array for
+   *    writes consolidates them into one. `0` disables it. <br>
+   *    **Default**: 64
    * - `sm.memory_budget` <br>
    *    The memory budget for tiles of fixed-sized attributes (or offsets for
    *    var-sized attributes) to be fetched during reads.<br>
@@ -315,9 +634,35 @@ class Config {
    * - `vfs.min_batch_size` <br>
    *    The minimum number of bytes in a VFS read operation<br>
    *    **Default**: 20MB
+   * - `vfs.write_behind_buffer_size` <br>
+   *    If not zero, writes to local and HDFS files are buffered per file and
+   *    flushed in chunks of this many bytes on the VFS thread pool, while the
+   *    caller keeps producing data. Up to `vfs.file.max_parallel_ops` chunks of
+   *    a local file are flushed concurrently (one for HDFS). Closing the file
+   *    waits for all its flushes, and flush errors are reported by the next
+   *    write or by the close. `0` disables write-behind buffering. <br>
+   *    **Default**: 0
+   * - `vfs.emulated_latency_ms` <br>
+   *    If not zero, every VFS request (read, write, listing or metadata
+   *    lookup) on any backend is delayed by this many milliseconds, emulating
+   *    the round trip of an object store on local files. Meant for
+   *    benchmarking. <br>
+   *    **Default**: 0
+   * - `vfs.emulated_bandwidth` <br>
+   *    If not zero, every VFS read and write is further delayed as if its
+   *    data were transferred at this many bytes per second. Meant for
+   *    benchmarking, together with `vfs.emulated_latency_ms`. <br>
+   *    **Default**: 0
    * - `vfs.min_batch_gap` <br>
    *    The minimum number of bytes between two VFS read batches.<br>
    *    **Default**: 500KB
+   * - `vfs.adaptive_batch_gap` <br>
+   *    If `true`, read batching measures the latency and bandwidth of each
+   *    backend and merges two regions whenever reading the gap between them is
+   *    cheaper than issuing a separate request. `vfs.min_batch_gap` and
+   *    `vfs.min_batch_size` are used until enough reads have been observed, and
+   *    `vfs.min_batch_size` caps the estimated gap. <br>
+   *    **Default**: false
    * - `vfs.file.max_parallel_ops` <br>
    *    The maximum number of parallel operations on objects with `file:///`
    *    URIs. <br>
@@ -326,6 +671,35 @@ class Config {
    *    If set to `false`, file locking operations are no-ops for `file:///`
    *    URIs in VFS. <br>
    *    **Default**: `true`
+   * - `vfs.file.enable_read_filelocks` <br>
+   *    If set to `false`, opening an array for reads does not take a shared
+   *    filelock, relying on fragments being immutable instead. Consolidation
+   *    and vacuuming still lock the array exclusively, but they no longer
+   *    wait for readers in other processes. <br>
+   *    **Default**: `true`
+   * - `vfs.file.io_engine` <br>
+   *    The engine used for batched reads of `file:///` URIs. `pread` issues one
+   *    positional read per region; `io_uring` submits all regions of a batch to
+   *    the kernel at once (Linux only); `overlapped` keeps several
+   *    asynchronous reads in flight through an I/O completion port (Windows
+   *    only). If the engine is not available, TileDB falls back to `pread`.
+   *    <br>
+   *    **Default**: pread
+   * - `vfs.file.enable_mmap` <br>
+   *    If set to `true`, tiles of `file:///` URIs are memory-mapped instead of
+   *    being read into heap buffers. Tiles with an empty filter pipeline are
+   *    then used directly from the mapped pages, without any copy. <br>
+   *    **Default**: false
+   * - `vfs.file.direct_io` <br>
+   *    If `true`, local file reads and writes use direct I/O (`O_DIRECT`, or
+   *    `FILE_FLAG_NO_BUFFERING` on Windows) through aligned staging buffers, so
+   *    that large scans do not evict other data from the operating system page
+   *    cache. Read batching also merges regions that share a disk block.
+   *    Filesystems that do not support direct I/O fall back to buffered
+   *    access. The `io_uring` engine is not used with direct I/O; the
+   *    `overlapped` engine reads without buffering when all regions of a
+   *    batch are aligned. <br>
+   *    **Default**: false
    * - `vfs.s3.region` <br>
    *    The S3 region, if S3 is enabled. <br>
    *    **Default**: us-east-1
@@ -361,6 +735,33 @@ class Config {
    *    vfs.s3.max_parallel_ops` bytes will be buffered before issuing multipart
    *    uploads in parallel. <br>
    *    **Default**: 5MB
+   * - `vfs.s3.max_buffer_size` <br>
+   *    The maximum number of bytes buffered across all the objects being
+   *    written with multipart uploads, e.g., the attribute files of a
+   *    fragment. When a write exceeds it, the whole parts buffered for its
+   *    object are uploaded right away, and the write waits for them. If `0`,
+   *    each object buffers up to `vfs.s3.multipart_part_size *
+   *    vfs.s3.max_parallel_ops` bytes. <br>
+   *    **Default**: 0
+   * - `vfs.s3.read_part_size` <br>
+   *    The part size (in bytes) used to split large S3 reads into concurrent
+   *    range GETs, which are issued in parallel on the VFS thread pool and
+   *    assembled in place. If `0`, S3 reads are split like any other read,
+   *    according to `vfs.min_parallel_size` and `vfs.s3.max_parallel_ops`. <br>
+   *    **Default**: 0
+   * - `vfs.s3.hedge_percentile` <br>
+   *    If not `0`, an S3 range GET that has not completed within this
+   *    percentile (e.g., `95`) of the latencies of the recent GETs is
+   *    hedged: a duplicate GET is issued and the first response is used.
+   *    This cuts the tail latency of the reads, which a few straggler GETs
+   *    determine. The GETs of the reads then run on a dedicated thread
+   *    pool. <br>
+   *    **Default**: 0.0
+   * - `vfs.s3.hedge_max_ratio` <br>
+   *    The maximum ratio of the S3 reads that are hedged (see
+   *    `vfs.s3.hedge_percentile`), which bounds the cost of the duplicate
+   *    GETs. <br>
+   *    **Default**: 0.05
    * - `vfs.s3.ca_file` <br>
    *    Path to SSL/TLS certificate file to be used by cURL for for S3 HTTPS
    *    encryption. Follows cURL conventions:
@@ -418,6 +819,23 @@ class Config {
    * - `vfs.hdfs.kerb_ticket_cache_path` <br>
    *    HDFS kerb ticket cache path. <br>
    *    **Default**: ""
+   * - `vfs.hdfs.max_parallel_ops` <br>
+   *    The maximum number of parallel operations on objects with `hdfs://`
+   *    URIs. <br>
+   *    **Default**: `vfs.num_threads`
+   * - `vfs.hdfs.short_circuit_read` <br>
+   *    If `true`, blocks stored on the local datanode are read directly from
+   *    disk, bypassing the datanode (`dfs.client.read.shortcircuit`). <br>
+   *    **Default**: false
+   * - `vfs.hdfs.domain_socket_path` <br>
+   *    The UNIX domain socket shared with the local datanode for
+   *    short-circuit reads (`dfs.domain.socket.path`). <br>
+   *    **Default**: ""
+   * - `vfs.hdfs.zero_copy_read` <br>
+   *    If `true`, reads are first attempted as zero-copy reads of
+   *    memory-mapped blocks (cached or short-circuited), falling back to
+   *    regular reads when unavailable. <br>
+   *    **Default**: false
    */
   Config& set(const std::string& param, const std::string& value) {
     tiledb_error_t* err;
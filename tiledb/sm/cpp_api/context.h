@@ -193,11 +193,61 @@ class Context {
     handle_error(tiledb_ctx_cancel_tasks(ctx_.get()));
   }
 
+  /**
+   * Harvests the tags of the queries submitted with
+   * `Query::submit_async_tagged` that have been processed since the last
+   * poll, in the order they finished.
+   *
+   * **Example:**
+   * @code{.cpp}
+   * for (void* tag : ctx.poll_completions(16, -1)) {
+   *   auto query = static_cast<tiledb::Query*>(tag);
+   *   // Handle query->query_status()
+   * }
+   * @endcode
+   *
+   * @param max_completions The maximum number of tags to harvest.
+   * @param timeout_ms If no query has been processed, the number of
+   *     milliseconds to wait for one; 0 does not wait and a negative value
+   *     waits indefinitely.
+   * @return The harvested tags, empty if the timeout expired.
+   */
+  std::vector<void*> poll_completions(
+      uint32_t max_completions, int32_t timeout_ms = 0) const {
+    std::vector<void*> tags(max_completions);
+    uint32_t num = 0;
+    handle_error(tiledb_ctx_poll_completions(
+        ctx_.get(), tags.data(), max_completions, timeout_ms, &num));
+    tags.resize(num);
+    return tags;
+  }
+
   /** Sets a string/string KV tag on the context. */
   void set_tag(const std::string& key, const std::string& value) {
     handle_error(tiledb_ctx_set_tag(ctx_.get(), key.c_str(), value.c_str()));
   }
 
+  /**
+   * Pre-opens the connections of this context to the storage backend of the
+   * input URI (only S3 for now), so that the first queries do not pay for
+   * connection setup.
+   */
+  void warm_up(const std::string& uri) const {
+    handle_error(tiledb_ctx_warm_up(ctx_.get(), uri.c_str()));
+  }
+
+  /**
+   * Returns the memory held by this context as a JSON string, with the
+   * bytes of each component (see `tiledb_ctx_get_memory_usage`).
+   */
+  std::string memory_usage() const {
+    char* c_str;
+    handle_error(tiledb_ctx_get_memory_usage(ctx_.get(), &c_str));
+    std::string str(c_str);
+    tiledb_stats_free_str(&c_str);
+    return str;
+  }
+
   /* ********************************* */
   /*          STATIC FUNCTIONS         */
   /* ********************************* */
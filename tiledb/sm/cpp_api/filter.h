@@ -265,6 +265,12 @@ class Filter {
         return "BYTESHUFFLE";
       case TILEDB_FILTER_POSITIVE_DELTA:
         return "POSITIVE_DELTA";
+      case TILEDB_FILTER_DICTIONARY:
+        return "DICTIONARY";
+      case TILEDB_FILTER_FLOAT_XOR:
+        return "FLOAT_XOR";
+      case TILEDB_FILTER_FRAME_OF_REFERENCE:
+        return "FRAME_OF_REFERENCE";
     }
     return "";
   }
@@ -300,6 +306,9 @@ class Filter {
         break;
       case TILEDB_BIT_WIDTH_MAX_WINDOW:
       case TILEDB_POSITIVE_DELTA_MAX_WINDOW:
+      case TILEDB_COMPRESSION_DICTIONARY_SIZE:
+      case TILEDB_COMPRESSION_BYTESHUFFLE:
+      case TILEDB_FRAME_OF_REFERENCE_DELTA:
         if (!std::is_same<uint32_t, T>::value)
           throw std::invalid_argument("Option value must be uint32_t.");
         break;
@@ -191,7 +191,8 @@ class FilterList {
   /**
    * Sets the maximum tile chunk size for the filter list.
    *
-   * @param max_chunk_size Maximum tile chunk size to set
+   * @param max_chunk_size Maximum tile chunk size to set, or 0 to size the
+   *     chunks of each tile automatically
    * @return Reference to this FilterList
    */
   FilterList& set_max_chunk_size(uint32_t max_chunk_size) {
@@ -41,6 +41,7 @@
 #include "core_interface.h"
 #include "deleter.h"
 #include "exception.h"
+#include "query_condition.h"
 #include "tiledb.h"
 #include "type.h"
 #include "utils.h"
@@ -52,6 +53,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <tuple>
 #include <type_traits>
 #include <unordered_map>
 #include <vector>
@@ -129,7 +131,8 @@ class Query {
    */
   Query(const Context& ctx, const Array& array, tiledb_query_type_t type)
       : ctx_(ctx)
-      , schema_(array.schema()) {
+      , schema_(array.schema())
+      , type_(type) {
     tiledb_query_t* q;
     ctx.handle_error(
         tiledb_query_alloc(ctx.ptr().get(), array.ptr().get(), type, &q));
@@ -163,11 +166,11 @@ class Query {
    */
   Query(const Context& ctx, const Array& array)
       : ctx_(ctx)
-      , schema_(array.schema()) {
+      , schema_(array.schema())
+      , type_(array.query_type()) {
     tiledb_query_t* q;
-    auto type = array.query_type();
     ctx.handle_error(
-        tiledb_query_alloc(ctx.ptr().get(), array.ptr().get(), type, &q));
+        tiledb_query_alloc(ctx.ptr().get(), array.ptr().get(), type_, &q));
     query_ = std::shared_ptr<tiledb_query_t>(q, deleter_);
   }
 
@@ -222,6 +225,303 @@ class Query {
     return *this;
   }
 
+  /**
+   * Sets the condition that the result cells of a read query must
+   * satisfy. Only the cells satisfying it are copied to the result
+   * buffers.
+   *
+   * **Example:**
+   *
+   * @code{.cpp}
+   * auto cond = tiledb::QueryCondition::create(ctx, "a1", 5, TILEDB_GT);
+   * query.set_condition(cond);
+   * @endcode
+   *
+   * @param condition The query condition.
+   * @return Reference to this Query
+   */
+  Query& set_condition(const QueryCondition& condition) {
+    auto& ctx = ctx_.get();
+    ctx.handle_error(tiledb_query_set_condition(
+        ctx.ptr().get(), query_.get(), condition.ptr().get()));
+    return *this;
+  }
+
+  /**
+   * Adds an aggregate over an attribute to a read query. A query with
+   * aggregates computes them over all its result cells when it is
+   * submitted, instead of copying the cells to result buffers, and writes
+   * the results when it completes. See `tiledb_query_add_aggregate` for the
+   * result types.
+   *
+   * **Example:**
+   *
+   * @code{.cpp}
+   * int64_t sum;
+   * uint64_t count;
+   * query.add_aggregate("a1", TILEDB_AGGREGATE_SUM, &sum)
+   *     .add_aggregate("a1", TILEDB_AGGREGATE_COUNT, &count);
+   * query.submit();
+   * @endcode
+   *
+   * @param attr The aggregated attribute.
+   * @param op The aggregate operator.
+   * @param result The location the result is written to.
+   * @return Reference to this Query
+   */
+  Query& add_aggregate(
+      const std::string& attr, tiledb_aggregate_op_t op, void* result) {
+    auto& ctx = ctx_.get();
+    ctx.handle_error(tiledb_query_add_aggregate(
+        ctx.ptr().get(), query_.get(), attr.c_str(), op, result));
+    return *this;
+  }
+
+  /**
+   * Sets the maximum number of result cells a read query on a sparse array
+   * returns over all its submissions. The query completes once it has
+   * returned `limit` cells.
+   *
+   * **Example:**
+   *
+   * @code{.cpp}
+   * // Preview the first 100 cells of the subarray
+   * query.set_limit(100);
+   * query.submit();
+   * @endcode
+   *
+   * @param limit The maximum number of result cells.
+   * @return Reference to this Query
+   */
+  Query& set_limit(uint64_t limit) {
+    auto& ctx = ctx_.get();
+    ctx.handle_error(
+        tiledb_query_set_limit(ctx.ptr().get(), query_.get(), limit));
+    return *this;
+  }
+
+  /**
+   * Sets the wall-clock budget of each submission of this read query. A
+   * submission that would exceed it by reading another partition returns
+   * the results it has, possibly none, as incomplete; resubmitting the
+   * query resumes from there.
+   *
+   * **Example:**
+   *
+   * @code{.cpp}
+   * query.set_deadline(50);
+   * while (query.submit() == Query::Status::INCOMPLETE) {
+   *   // Serve the partial results
+   * }
+   * @endcode
+   *
+   * @param deadline_ms The budget in milliseconds, `0` for none.
+   * @return Reference to this Query
+   */
+  Query& set_deadline(uint64_t deadline_ms) {
+    auto& ctx = ctx_.get();
+    ctx.handle_error(
+        tiledb_query_set_deadline(ctx.ptr().get(), query_.get(), deadline_ms));
+    return *this;
+  }
+
+  /**
+   * Makes this read query on a sparse array read a random sample of the
+   * overlapping tiles, each kept with probability `fraction`. Only the
+   * sampled tiles are read and unfiltered.
+   *
+   * **Example:**
+   *
+   * @code{.cpp}
+   * uint64_t count = 0;
+   * query.set_sample(0.01).add_aggregate("a", TILEDB_AGGREGATE_COUNT, &count);
+   * query.submit();
+   * double estimate = count / query.sample_ratio();
+   * @endcode
+   *
+   * @param fraction The probability of a tile to be read, in `(0, 1]`.
+   * @param seed The seed of the sample.
+   * @return Reference to this Query
+   */
+  Query& set_sample(double fraction, uint64_t seed = 0) {
+    auto& ctx = ctx_.get();
+    ctx.handle_error(tiledb_query_set_sample(
+        ctx.ptr().get(), query_.get(), fraction, seed));
+    return *this;
+  }
+
+  /**
+   * Returns the ratio of the cells in the tiles this sampled query has read
+   * over the cells in all the overlapping tiles, `1.0` if not sampled.
+   */
+  double sample_ratio() const {
+    double ratio = 1.0;
+    auto& ctx = ctx_.get();
+    ctx.handle_error(tiledb_query_get_sample_ratio(
+        ctx.ptr().get(), query_.get(), &ratio));
+    return ratio;
+  }
+
+  /**
+   * Makes this read query on a dense array read a downsampled level of its
+   * pyramid (see `sm.consolidation.pyramid_levels`), where level `l` has
+   * `2^l` times fewer cells along each dimension. It must be set before
+   * the subarray and the buffers, which are given in the domain of the
+   * level.
+   *
+   * **Example:**
+   *
+   * @code{.cpp}
+   * tiledb::Query query(ctx, array, TILEDB_READ);
+   * query.set_resolution_level(2)
+   *     .set_subarray<int>({1, 25, 1, 25})
+   *     .set_buffer("a", data);
+   * query.submit();
+   * @endcode
+   *
+   * @param level The pyramid level, `0` for the array itself.
+   * @return Reference to this Query
+   */
+  Query& set_resolution_level(uint32_t level) {
+    auto& ctx = ctx_.get();
+    ctx.handle_error(tiledb_query_set_resolution_level(
+        ctx.ptr().get(), query_.get(), level));
+    return *this;
+  }
+
+  /**
+   * Makes this global order write query write a part of the fragment of
+   * `fragment_query`, concurrently with the queries writing its other
+   * parts. The parts must follow each other in the global order and, on
+   * sparse arrays, each part but the last one must consist of full tiles.
+   * Finalizing `fragment_query` after all the part queries stitches them
+   * into a single fragment.
+   *
+   * **Example:**
+   *
+   * @code{.cpp}
+   * tiledb::Query query(ctx, array, TILEDB_WRITE);
+   * query.set_layout(TILEDB_GLOBAL_ORDER);
+   * tiledb::Query part(ctx, array, TILEDB_WRITE);
+   * part.set_layout(TILEDB_GLOBAL_ORDER).set_fragment_part(query, 0);
+   * // Set the buffers of `part`, submit and finalize it, then:
+   * query.finalize();
+   * @endcode
+   *
+   * @param fragment_query The query of the fragment, which writes no cells
+   *     itself.
+   * @param part The index of the part, unique within the fragment.
+   * @return Reference to this Query
+   */
+  Query& set_fragment_part(Query& fragment_query, uint32_t part) {
+    auto& ctx = ctx_.get();
+    ctx.handle_error(tiledb_query_set_fragment_part(
+        ctx.ptr().get(), query_.get(), fragment_query.ptr().get(), part));
+    return *this;
+  }
+
+  /**
+   * Sets the width in bits (32 or 64) of the var-sized offsets in the
+   * buffers of this query, overriding `sm.var_offsets.bitsize`. Reads whose
+   * offsets do not fit in 32 bits return fewer results and are incomplete.
+   *
+   * **Example:**
+   *
+   * @code{.cpp}
+   * // The buffer has room for 1000 32-bit offsets
+   * std::vector<uint64_t> offsets(500);
+   * std::string data(10000, ' ');
+   * query.set_offsets_bitsize(32).set_buffer("a", offsets, data);
+   * @endcode
+   *
+   * @param bitsize The offsets width in bits.
+   * @return Reference to this Query
+   *
+   * @note For writes, it must be set before the buffers.
+   */
+  Query& set_offsets_bitsize(uint32_t bitsize) {
+    auto& ctx = ctx_.get();
+    ctx.handle_error(tiledb_query_set_offsets_bitsize(
+        ctx.ptr().get(), query_.get(), bitsize));
+    return *this;
+  }
+
+  /**
+   * Sets the scheduling priority of the query. The pending tasks of high
+   * priority queries run first, those of low priority queries last.
+   *
+   * **Example:**
+   *
+   * @code{.cpp}
+   * // Keep an interactive query ahead of a concurrent export
+   * query.set_priority(TILEDB_QUERY_PRIORITY_HIGH);
+   * query.submit();
+   * @endcode
+   *
+   * @param priority The query priority.
+   * @return Reference to this Query
+   */
+  Query& set_priority(tiledb_query_priority_t priority) {
+    auto& ctx = ctx_.get();
+    ctx.handle_error(
+        tiledb_query_set_priority(ctx.ptr().get(), query_.get(), priority));
+    return *this;
+  }
+
+  /**
+   * Exports the results of the last submission of a read query for an
+   * attribute through the Apache Arrow C data interface, without copying
+   * them. See `tiledb_query_export_arrow` for the exported types and the
+   * offsets configuration var-sized attributes require.
+   *
+   * **Example:**
+   *
+   * @code{.cpp}
+   * ArrowArray arrow_array;
+   * ArrowSchema arrow_schema;
+   * query.submit();
+   * query.export_arrow("a", &arrow_array, &arrow_schema);
+   * @endcode
+   *
+   * @param attr The attribute name.
+   * @param arrow_array A `struct ArrowArray` to initialize.
+   * @param arrow_schema A `struct ArrowSchema` to initialize.
+   */
+  void export_arrow(
+      const std::string& attr, void* arrow_array, void* arrow_schema) const {
+    auto& ctx = ctx_.get();
+    ctx.handle_error(tiledb_query_export_arrow(
+        ctx.ptr().get(),
+        query_.get(),
+        attr.c_str(),
+        arrow_array,
+        arrow_schema));
+  }
+
+  /**
+   * Prepares a read query for repeated submissions over different
+   * subarrays, validating and initializing it once. Setting a new subarray
+   * then only resets the read state and restores the buffer sizes, so the
+   * buffers are reused. See `tiledb_query_prepare`.
+   *
+   * **Example:**
+   *
+   * @code{.cpp}
+   * query.prepare();
+   * for (int key : keys) {
+   *   query.set_subarray<int>({key, key});
+   *   query.submit();
+   * }
+   * @endcode
+   *
+   * @return Reference to this Query
+   */
+  Query& prepare() {
+    auto& ctx = ctx_.get();
+    ctx.handle_error(tiledb_query_prepare(ctx.ptr().get(), query_.get()));
+    return *this;
+  }
+
   /** Returns the layout of the query. */
   tiledb_layout_t query_layout() const {
     auto& ctx = ctx_.get();
@@ -231,6 +531,20 @@ class Query {
     return query_layout;
   }
 
+  /**
+   * Returns the stats of the query as a JSON string, gathered by its
+   * submissions while stats were enabled (see `Stats::enable`).
+   */
+  std::string stats() const {
+    auto& ctx = ctx_.get();
+    char* c_str;
+    ctx.handle_error(
+        tiledb_query_get_stats(ctx.ptr().get(), query_.get(), &c_str));
+    std::string str(c_str);
+    tiledb_stats_free_str(&c_str);
+    return str;
+  }
+
   /** Returns the query status. */
   Status query_status() const {
     tiledb_query_status_t status;
@@ -317,6 +631,54 @@ class Query {
     submit_async([]() {});
   }
 
+  /**
+   * Submit an async query without a callback. Once the query is processed,
+   * `tag` is harvested with `Context::poll_completions`. Call returns
+   * immediately.
+   *
+   * @note Same notes apply as `Query::submit()`.
+   *
+   * **Example:**
+   * @code{.cpp}
+   * // Create query
+   * tiledb::Query query(...);
+   * // Submit, tagged with the query itself
+   * query.submit_async_tagged(&query);
+   * @endcode
+   *
+   * @param tag The tag posted to the completion queue of the context.
+   */
+  void submit_async_tagged(void* tag) {
+    auto& ctx = ctx_.get();
+    ctx.handle_error(
+        tiledb_query_submit_async_tagged(ctx.ptr().get(), query_.get(), tag));
+  }
+
+  /**
+   * Submits a batch of queries, typically on different arrays, processing
+   * them concurrently and blocking until all of them are processed. The
+   * status of each query is then retrieved with `Query::query_status()`.
+   *
+   * **Example:**
+   * @code{.cpp}
+   * tiledb::Query query_1(ctx, array_1), query_2(ctx, array_2);
+   * ...
+   * tiledb::Query::submit_batch(ctx, {&query_1, &query_2});
+   * @endcode
+   *
+   * @param ctx TileDB context.
+   * @param queries The queries to submit.
+   */
+  static void submit_batch(
+      const Context& ctx, const std::vector<Query*>& queries) {
+    std::vector<tiledb_query_t*> batch;
+    batch.reserve(queries.size());
+    for (auto query : queries)
+      batch.push_back(query->query_.get());
+    ctx.handle_error(tiledb_query_submit_batch(
+        ctx.ptr().get(), batch.data(), static_cast<uint32_t>(batch.size())));
+  }
+
   /**
    * Flushes all internal state of a query object and finalizes the query.
    * This is applicable only to global layout writes. It has no effect for
@@ -374,26 +736,38 @@ class Query {
   std::unordered_map<std::string, std::pair<uint64_t, uint64_t>>
   result_buffer_elements() const {
     std::unordered_map<std::string, std::pair<uint64_t, uint64_t>> elements;
-    if (buff_sizes_.empty())
-      return std::unordered_map<
-          std::string,
-          std::pair<uint64_t, uint64_t>>();  // Query hasn't been submitted
-    for (const auto& b_it : buff_sizes_) {
-      auto attr_name = b_it.first;
-      auto size_pair = b_it.second;
-      auto var =
-          (attr_name != TILEDB_COORDS &&
-           schema_.attribute(attr_name).cell_val_num() == TILEDB_VAR_NUM);
-      auto element_size = element_sizes_.find(attr_name)->second;
-      elements[attr_name] = (var) ? std::pair<uint64_t, uint64_t>(
-                                        size_pair.first / sizeof(uint64_t),
-                                        size_pair.second / element_size) :
-                                    std::pair<uint64_t, uint64_t>(
-                                        0, size_pair.second / element_size);
-    }
+    elements.reserve(buffers_.size());
+    for (const auto& b_it : buffers_)
+      elements[b_it.first] = result_elements(b_it.second);
     return elements;
   }
 
+  /**
+   * Returns the number of elements in the result buffers of a single
+   * attribute or dimension, as a pair in the same format as the values of
+   * `result_buffer_elements()`, but without building a map. It is meant for
+   * loops resubmitting incomplete reads.
+   *
+   * **Example:**
+   * @code{.cpp}
+   * while (query.submit() == tiledb::Query::Status::INCOMPLETE) {
+   *   auto num_a1_elements = query.result_buffer_elements("a1").second;
+   *   ...
+   * }
+   * @endcode
+   *
+   * @param name The name of the attribute or dimension.
+   * @return The pair of element numbers, `(0, 0)` if no buffer is set for
+   *     `name`.
+   */
+  std::pair<uint64_t, uint64_t> result_buffer_elements(
+      const std::string& name) const {
+    auto it = buffers_.find(name);
+    if (it == buffers_.end())
+      return std::pair<uint64_t, uint64_t>(0, 0);
+    return result_elements(it->second);
+  }
+
   /**
    * Adds a 1D range along a subarray dimension, in the form
    * (start, end, stride). The datatype of the range
@@ -918,6 +1292,90 @@ class Query {
         sizeof(char));
   }
 
+  /**
+   * Makes a read query allocate the result buffers of an attribute itself,
+   * instead of using a buffer set with `set_buffer`. The buffers grow to
+   * fit the results of each partition of the subarray, up to
+   * `sm.memory_budget` (`sm.memory_budget_var` for var-sized values), so
+   * that the query does not split partitions to fit small buffers.
+   *
+   * **Example:**
+   * @code{.cpp}
+   * query.set_managed_buffer("a1");
+   * query.submit();
+   * auto a1 = query.managed_buffer<int>("a1");
+   * for (uint64_t i = 0; i < a1.second; ++i)
+   *   std::cout << a1.first[i] << "\n";
+   * @endcode
+   *
+   * @param attr Attribute name
+   * @return Reference to this Query
+   */
+  Query& set_managed_buffer(const std::string& attr) {
+    auto& ctx = ctx_.get();
+    ctx.handle_error(tiledb_query_set_managed_buffer(
+        ctx.ptr().get(), query_.get(), attr.c_str()));
+    buffers_.erase(attr);
+    return *this;
+  }
+
+  /**
+   * Returns the results of the last submission for a fixed-sized attribute
+   * set with `set_managed_buffer`, without a copy. They stay valid until
+   * the next submission.
+   *
+   * @tparam T The attribute type.
+   * @param attr Attribute name
+   * @return A pointer to the result values and their number.
+   */
+  template <typename T>
+  std::pair<const T*, uint64_t> managed_buffer(const std::string& attr) const {
+    if (attr != TILEDB_COORDS)
+      impl::type_check<T>(schema_.attribute(attr).type());
+    auto& ctx = ctx_.get();
+    void* data = nullptr;
+    uint64_t* size = nullptr;
+    ctx.handle_error(tiledb_query_get_buffer(
+        ctx.ptr().get(), query_.get(), attr.c_str(), &data, &size));
+    return std::pair<const T*, uint64_t>(
+        static_cast<const T*>(data), size == nullptr ? 0 : *size / sizeof(T));
+  }
+
+  /**
+   * Returns the results of the last submission for a var-sized attribute
+   * set with `set_managed_buffer`, without a copy. They stay valid until
+   * the next submission.
+   *
+   * @tparam T The attribute type.
+   * @param attr Attribute name
+   * @return The result offsets, their number, the result values and their
+   *     number. The offsets are 64-bit, so `sm.var_offsets.bitsize` must
+   *     be 64.
+   */
+  template <typename T>
+  std::tuple<const uint64_t*, uint64_t, const T*, uint64_t>
+  managed_buffer_var(const std::string& attr) const {
+    impl::type_check<T>(schema_.attribute(attr).type());
+    auto& ctx = ctx_.get();
+    uint64_t* offsets = nullptr;
+    uint64_t* offsets_size = nullptr;
+    void* data = nullptr;
+    uint64_t* data_size = nullptr;
+    ctx.handle_error(tiledb_query_get_buffer_var(
+        ctx.ptr().get(),
+        query_.get(),
+        attr.c_str(),
+        &offsets,
+        &offsets_size,
+        &data,
+        &data_size));
+    return std::tuple<const uint64_t*, uint64_t, const T*, uint64_t>(
+        offsets,
+        offsets_size == nullptr ? 0 : *offsets_size / sizeof(uint64_t),
+        static_cast<const T*>(data),
+        data_size == nullptr ? 0 : *data_size / sizeof(T));
+  }
+
   /* ********************************* */
   /*         STATIC FUNCTIONS          */
   /* ********************************* */
@@ -956,21 +1414,41 @@ class Query {
   /*         PRIVATE ATTRIBUTES        */
   /* ********************************* */
 
-  /**
-   * The buffer sizes that were set along with the buffers to the TileDB
-   * query. It is a map from the attribute name to a pair of sizes.
-   * For var-sized attributes, the first element of the pair is the
-   * offsets size and the second is the var-sized values size. For
-   * fixed-sized attributes, the first is always 0, and the second is
-   * the values size. All sizes are in bytes.
-   */
-  std::unordered_map<std::string, std::pair<uint64_t, uint64_t>> buff_sizes_;
+  /** A buffer set to the TileDB query for an attribute or dimension. */
+  struct BufferInfo {
+    /** The offsets buffer, `nullptr` for fixed-sized buffers. */
+    uint64_t* offsets = nullptr;
+
+    /** The values buffer. */
+    void* data = nullptr;
+
+    /**
+     * The buffer sizes the TileDB query points to. For var-sized buffers,
+     * the first element of the pair is the offsets size and the second is
+     * the var-sized values size. For fixed-sized buffers, the first is
+     * always 0, and the second is the values size. All sizes are in bytes.
+     * Reads update them to the result sizes.
+     */
+    std::pair<uint64_t, uint64_t> sizes;
+
+    /** The sizes the buffers were last set to the TileDB query with. */
+    std::pair<uint64_t, uint64_t> set_sizes;
+
+    /**
+     * The sizes the TileDB query was last pointed to. They differ from
+     * `&sizes` in a copy of this object.
+     */
+    const std::pair<uint64_t, uint64_t>* set_sizes_ptr = nullptr;
+
+    /** The size of a single element of the values buffer. */
+    uint64_t element_size = 0;
+  };
 
   /**
-   * Stores the size of a single element for the buffer set for a given
-   * attribute.
+   * The buffers set to the TileDB query, by attribute or dimension name.
+   * The map nodes are stable, so the query keeps pointing to their sizes.
    */
-  std::unordered_map<std::string, uint64_t> element_sizes_;
+  std::unordered_map<std::string, BufferInfo> buffers_;
 
   /** The TileDB context. */
   std::reference_wrapper<const Context> ctx_;
@@ -987,6 +1465,9 @@ class Query {
   /** Number of cells set by `set_subarray`, influences `resize_buffer`. */
   uint64_t subarray_cell_num_ = 0;
 
+  /** The query type. */
+  tiledb_query_type_t type_;
+
   /* ********************************* */
   /*          PRIVATE METHODS          */
   /* ********************************* */
@@ -1006,14 +1487,18 @@ class Query {
       size_t element_size) {
     auto ctx = ctx_.get();
     size_t size = nelements * element_size;
-    buff_sizes_[attr] = std::pair<uint64_t, uint64_t>(0, size);
-    element_sizes_[attr] = element_size;
+    auto& info = buffers_[attr];
+    auto sizes = std::pair<uint64_t, uint64_t>(0, size);
+    info.element_size = element_size;
+    info.sizes = sizes;
+    if (is_buffer_set(info, nullptr, buff, sizes))
+      return *this;
     ctx.handle_error(tiledb_query_set_buffer(
-        ctx.ptr().get(),
-        query_.get(),
-        attr.c_str(),
-        buff,
-        &(buff_sizes_[attr].second)));
+        ctx.ptr().get(), query_.get(), attr.c_str(), buff, &info.sizes.second));
+    info.offsets = nullptr;
+    info.data = buff;
+    info.set_sizes = sizes;
+    info.set_sizes_ptr = &info.sizes;
     return *this;
   }
 
@@ -1040,18 +1525,53 @@ class Query {
     auto ctx = ctx_.get();
     auto data_size = data_nelements * element_size;
     auto offset_size = offset_nelements * sizeof(uint64_t);
-    element_sizes_[attr] = element_size;
-    buff_sizes_[attr] = std::pair<uint64_t, uint64_t>(offset_size, data_size);
+    auto& info = buffers_[attr];
+    auto sizes = std::pair<uint64_t, uint64_t>(offset_size, data_size);
+    info.element_size = element_size;
+    info.sizes = sizes;
+    if (is_buffer_set(info, offsets, data, sizes))
+      return *this;
     ctx.handle_error(tiledb_query_set_buffer_var(
         ctx.ptr().get(),
         query_.get(),
         attr.c_str(),
         offsets,
-        &(buff_sizes_[attr].first),
+        &info.sizes.first,
         data,
-        &(buff_sizes_[attr].second)));
+        &info.sizes.second));
+    info.offsets = offsets;
+    info.data = data;
+    info.set_sizes = sizes;
+    info.set_sizes_ptr = &info.sizes;
     return *this;
   }
+
+  /**
+   * Returns true if a read query already has the given buffers set with the
+   * given sizes, in which case resetting their sizes in `info` suffices and
+   * the TileDB query does not need to be updated. Writes always reset their
+   * buffers, so that TileDB checks their new contents.
+   */
+  bool is_buffer_set(
+      const BufferInfo& info,
+      const uint64_t* offsets,
+      const void* data,
+      const std::pair<uint64_t, uint64_t>& sizes) const {
+    return type_ == TILEDB_READ && info.set_sizes_ptr == &info.sizes &&
+           info.data == data && info.offsets == offsets &&
+           info.set_sizes == sizes;
+  }
+
+  /** Returns the number of result elements in a buffer. */
+  static std::pair<uint64_t, uint64_t> result_elements(
+      const BufferInfo& info) {
+    if (info.offsets != nullptr)
+      return std::pair<uint64_t, uint64_t>(
+          info.sizes.first / sizeof(uint64_t),
+          info.sizes.second / info.element_size);
+    return std::pair<uint64_t, uint64_t>(
+        0, info.sizes.second / info.element_size);
+  }
 };
 
 /* ********************************* */
@@ -0,0 +1,201 @@
+/**
+ * @file   query_condition.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * This file implements the C++ API for the TileDB QueryCondition object.
+ */
+
+#ifndef TILEDB_CPP_API_QUERY_CONDITION_H
+#define TILEDB_CPP_API_QUERY_CONDITION_H
+
+#include "context.h"
+#include "deleter.h"
+#include "tiledb.h"
+
+#include <memory>
+#include <string>
+#include <type_traits>
+
+namespace tiledb {
+
+/**
+ * Represents a condition on attribute values, which a read query evaluates
+ * before copying the result cells to the user buffers.
+ *
+ * **Example:**
+ *
+ * @code{.cpp}
+ * tiledb::Context ctx;
+ * auto c1 = tiledb::QueryCondition::create(ctx, "a1", 5, TILEDB_GE);
+ * auto c2 = tiledb::QueryCondition::create(ctx, "a2", 0.5f, TILEDB_LT);
+ * query.set_condition(c1.combine(c2, TILEDB_AND));
+ * @endcode
+ */
+class QueryCondition {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /**
+   * Creates an uninitialized TileDB query condition object.
+   *
+   * @param ctx TileDB context
+   */
+  explicit QueryCondition(const Context& ctx)
+      : ctx_(ctx) {
+    tiledb_query_condition_t* cond;
+    ctx.handle_error(tiledb_query_condition_alloc(ctx.ptr().get(), &cond));
+    query_condition_ =
+        std::shared_ptr<tiledb_query_condition_t>(cond, deleter_);
+  }
+
+  /**
+   * Creates a TileDB query condition object with the input C object.
+   *
+   * @param ctx TileDB context
+   * @param cond C API query condition object
+   */
+  QueryCondition(const Context& ctx, tiledb_query_condition_t* cond)
+      : ctx_(ctx) {
+    query_condition_ =
+        std::shared_ptr<tiledb_query_condition_t>(cond, deleter_);
+  }
+
+  QueryCondition() = delete;
+  QueryCondition(const QueryCondition&) = default;
+  QueryCondition(QueryCondition&&) = default;
+  QueryCondition& operator=(const QueryCondition&) = default;
+  QueryCondition& operator=(QueryCondition&&) = default;
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /** Returns a shared pointer to the C TileDB query condition object. */
+  std::shared_ptr<tiledb_query_condition_t> ptr() const {
+    return query_condition_;
+  }
+
+  /**
+   * Initializes the condition as the comparison of an attribute with a
+   * value.
+   *
+   * @param attribute_name The name of the compared attribute.
+   * @param condition_value The value the attribute is compared with.
+   * @param condition_value_size The size of the value in bytes.
+   * @param op The comparison operator.
+   * @return Reference to this QueryCondition
+   */
+  QueryCondition& init(
+      const std::string& attribute_name,
+      const void* condition_value,
+      uint64_t condition_value_size,
+      tiledb_query_condition_op_t op) {
+    auto& ctx = ctx_.get();
+    ctx.handle_error(tiledb_query_condition_init(
+        ctx.ptr().get(),
+        query_condition_.get(),
+        attribute_name.c_str(),
+        condition_value,
+        condition_value_size,
+        op));
+    return *this;
+  }
+
+  /**
+   * Combines the condition with another one into a new condition.
+   *
+   * @param rhs The condition to combine with.
+   * @param combination_op The logical operator combining the conditions.
+   * @return The combined condition.
+   */
+  QueryCondition combine(
+      const QueryCondition& rhs,
+      tiledb_query_condition_combination_op_t combination_op) const {
+    auto& ctx = ctx_.get();
+    tiledb_query_condition_t* combined_cond;
+    ctx.handle_error(tiledb_query_condition_combine(
+        ctx.ptr().get(),
+        query_condition_.get(),
+        rhs.ptr().get(),
+        combination_op,
+        &combined_cond));
+    return QueryCondition(ctx, combined_cond);
+  }
+
+  /* ********************************* */
+  /*          STATIC FUNCTIONS         */
+  /* ********************************* */
+
+  /**
+   * Creates the comparison of an attribute with a value.
+   *
+   * **Example:**
+   *
+   * @code{.cpp}
+   * auto cond = tiledb::QueryCondition::create<int>(ctx, "a1", 5, TILEDB_NE);
+   * @endcode
+   *
+   * @tparam T The attribute type.
+   * @param ctx TileDB context
+   * @param attribute_name The name of the compared attribute.
+   * @param value The value the attribute is compared with.
+   * @param op The comparison operator.
+   * @return The query condition.
+   */
+  template <
+      typename T,
+      typename std::enable_if<std::is_arithmetic<T>::value>::type* = nullptr>
+  static QueryCondition create(
+      const Context& ctx,
+      const std::string& attribute_name,
+      T value,
+      tiledb_query_condition_op_t op) {
+    QueryCondition cond(ctx);
+    cond.init(attribute_name, &value, sizeof(T), op);
+    return cond;
+  }
+
+ private:
+  /* ********************************* */
+  /*          PRIVATE ATTRIBUTES       */
+  /* ********************************* */
+
+  /** The TileDB context. */
+  std::reference_wrapper<const Context> ctx_;
+
+  /** An auxiliary deleter. */
+  impl::Deleter deleter_;
+
+  /** The pointer to the C TileDB query condition object. */
+  std::shared_ptr<tiledb_query_condition_t> query_condition_;
+};
+
+}  // namespace tiledb
+
+#endif  // TILEDB_CPP_API_QUERY_CONDITION_H
@@ -90,6 +90,46 @@ class Stats {
     check_error(tiledb_stats_free_str(&c_str), "error freeing stats string");
   }
 
+  /**
+   * Enables tracing of the timeline of the timed internal functions (see
+   * `tiledb_stats_trace_enable`).
+   */
+  static void trace_enable() {
+    check_error(tiledb_stats_trace_enable(), "error enabling tracing");
+  }
+
+  /** Disables tracing. */
+  static void trace_disable() {
+    check_error(tiledb_stats_trace_disable(), "error disabling tracing");
+  }
+
+  /** Discards the recorded calls and restarts the timeline of the trace. */
+  static void trace_reset() {
+    check_error(tiledb_stats_trace_reset(), "error resetting trace");
+  }
+
+  /**
+   * Dumps the trace in the JSON format of Chrome traces to some output
+   * (e.g., file or stdout).
+   *
+   * @param out The output.
+   */
+  static void trace_dump(FILE* out = nullptr) {
+    check_error(tiledb_stats_trace_dump(out), "error dumping trace");
+  }
+
+  /**
+   * Dumps the trace in the JSON format of Chrome traces to a string.
+   *
+   * @param out The output.
+   */
+  static void trace_dump(std::string* out) {
+    char* c_str = nullptr;
+    check_error(tiledb_stats_trace_dump_str(&c_str), "error dumping trace");
+    *out = std::string(c_str);
+    check_error(tiledb_stats_free_str(&c_str), "error freeing trace string");
+  }
+
  private:
   /**
    * Checks the return code for TILEDB_OK and throws an exception if not.
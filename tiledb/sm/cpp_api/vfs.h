@@ -512,6 +512,17 @@ class VFS {
         tiledb_vfs_touch(ctx.ptr().get(), vfs_.get(), uri.c_str()));
   }
 
+  /**
+   * Pre-opens the connections to the storage backend of the input URI
+   * (only S3 for now), so that the first operations do not pay for
+   * connection setup.
+   */
+  void warm_up(const std::string& uri) const {
+    auto& ctx = ctx_.get();
+    ctx.handle_error(
+        tiledb_vfs_warm_up(ctx.ptr().get(), vfs_.get(), uri.c_str()));
+  }
+
   /** Get the underlying context **/
   const Context& context() const {
     return ctx_.get();
@@ -43,9 +43,92 @@
 #include <openssl/evp.h>
 #include <openssl/rand.h>
 
+#include <cstring>
+
 namespace tiledb {
 namespace sm {
 
+namespace {
+
+/**
+ * An AES-256-GCM cipher context reused by all the encryptions (or all the
+ * decryptions) of a thread. Besides saving a context allocation per chunk, the
+ * context keeps the expanded schedule of the last key it was initialized with,
+ * so that consecutive chunks under the same key only need to set a new IV.
+ */
+class ThreadCipherContext {
+ public:
+  /** Constructor. */
+  ThreadCipherContext()
+      : ctx_(EVP_CIPHER_CTX_new())
+      , keyed_(false) {
+  }
+
+  /** Destructor. Wipes the copy of the last key. */
+  ~ThreadCipherContext() {
+    OPENSSL_cleanse(key_, sizeof(key_));
+    if (ctx_ != nullptr)
+      EVP_CIPHER_CTX_free(ctx_);
+  }
+
+  /** Returns the OpenSSL context, or nullptr if its allocation failed. */
+  EVP_CIPHER_CTX* ctx() const {
+    return ctx_;
+  }
+
+  /** Returns true if the context is initialized with the given key. */
+  bool has_key(const void* key) const {
+    return keyed_ && std::memcmp(key_, key, sizeof(key_)) == 0;
+  }
+
+  /** Records the key the context was initialized with. */
+  void set_key(const void* key) {
+    std::memcpy(key_, key, sizeof(key_));
+    keyed_ = true;
+  }
+
+  /**
+   * Forgets the key, so that the next use fully reinitializes the context. Used
+   * after any OpenSSL error, which may leave the context in an unknown state.
+   */
+  void clear_key() {
+    keyed_ = false;
+  }
+
+ private:
+  /** The OpenSSL cipher context. */
+  EVP_CIPHER_CTX* ctx_;
+
+  /** Whether the context holds the schedule of `key_`. */
+  bool keyed_;
+
+  /** The key the context was last initialized with. */
+  unsigned char key_[Encryption::AES256GCM_KEY_BYTES];
+};
+
+/** Returns the encryption context of the calling thread. */
+ThreadCipherContext* thread_encrypt_ctx() {
+  static thread_local ThreadCipherContext ctx;
+  return &ctx;
+}
+
+/** Returns the decryption context of the calling thread. */
+ThreadCipherContext* thread_decrypt_ctx() {
+  static thread_local ThreadCipherContext ctx;
+  return &ctx;
+}
+
+/**
+ * Fails the current operation on the given thread context, so that it is fully
+ * reinitialized by the next one.
+ */
+Status cipher_error(ThreadCipherContext* cipher, const std::string& msg) {
+  cipher->clear_key();
+  return LOG_STATUS(Status::EncryptionError(msg));
+}
+
+}  // namespace
+
 Status OpenSSL::get_random_bytes(unsigned num_bytes, Buffer* output) {
   if (output->free_space() < num_bytes)
     RETURN_NOT_OK(output->realloc(output->alloced_size() + num_bytes));
@@ -96,24 +179,24 @@ Status OpenSSL::encrypt_aes256gcm(
   // Copy IV to output arg.
   std::memcpy(output_iv->cur_data(), iv_buf, iv_len);
 
-  EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+  ThreadCipherContext* cipher = thread_encrypt_ctx();
+  EVP_CIPHER_CTX* ctx = cipher->ctx();
   if (ctx == nullptr)
     return LOG_STATUS(Status::EncryptionError(
         "OpenSSL error; cannot encrypt: context allocation failed."));
 
-  // Initialize the cipher. We use the default parameter lengths for the IV and
-  // tag, so no further configuration is needed for the cipher.
-  EVP_CIPHER_CTX_init(ctx);
+  // Initialize the cipher, only setting the IV if the thread's context already
+  // holds the key. We use the default parameter lengths for the IV and tag, so
+  // no further configuration is needed for the cipher.
+  bool same_key = cipher->has_key(key->data());
   if (EVP_EncryptInit_ex(
           ctx,
-          EVP_aes_256_gcm(),
+          same_key ? nullptr : EVP_aes_256_gcm(),
           nullptr,
-          (unsigned char*)key->data(),
-          iv_buf) == 0) {
-    EVP_CIPHER_CTX_free(ctx);
-    return LOG_STATUS(
-        Status::EncryptionError("OpenSSL error; error initializing cipher."));
-  }
+          same_key ? nullptr : (const unsigned char*)key->data(),
+          iv_buf) == 0)
+    return cipher_error(cipher, "OpenSSL error; error initializing cipher.");
+  cipher->set_key(key->data());
 
   // Encrypt the input.
   int output_len;
@@ -122,21 +205,15 @@ Status OpenSSL::encrypt_aes256gcm(
           (unsigned char*)output->cur_data(),
           &output_len,
           (const unsigned char*)input->data(),
-          (int)input->size()) == 0) {
-    EVP_CIPHER_CTX_free(ctx);
-    return LOG_STATUS(
-        Status::EncryptionError("OpenSSL error; error encrypting data."));
-  }
+          (int)input->size()) == 0)
+    return cipher_error(cipher, "OpenSSL error; error encrypting data.");
   output->advance_size((uint64_t)output_len);
   output->advance_offset((uint64_t)output_len);
 
   // Finalize encryption.
   if (EVP_EncryptFinal_ex(
-          ctx, (unsigned char*)output->cur_data(), &output_len) == 0) {
-    EVP_CIPHER_CTX_free(ctx);
-    return LOG_STATUS(
-        Status::EncryptionError("OpenSSL error; error finalizing encryption."));
-  }
+          ctx, (unsigned char*)output->cur_data(), &output_len) == 0)
+    return cipher_error(cipher, "OpenSSL error; error finalizing encryption.");
   output->advance_size((uint64_t)output_len);
   output->advance_offset((uint64_t)output_len);
 
@@ -145,14 +222,8 @@ Status OpenSSL::encrypt_aes256gcm(
           ctx,
           EVP_CTRL_GCM_GET_TAG,
           Encryption::AES256GCM_TAG_BYTES,
-          (char*)output_tag->data()) == 0) {
-    EVP_CIPHER_CTX_free(ctx);
-    return LOG_STATUS(
-        Status::EncryptionError("OpenSSL error; error getting tag."));
-  }
-
-  // Clean up.
-  EVP_CIPHER_CTX_free(ctx);
+          (char*)output_tag->data()) == 0)
+    return cipher_error(cipher, "OpenSSL error; error getting tag.");
 
   return Status::Ok();
 }
@@ -178,24 +249,24 @@ Status OpenSSL::decrypt_aes256gcm(
         "OpenSSL error; cannot decrypt: output buffer too small."));
   }
 
-  EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+  ThreadCipherContext* cipher = thread_decrypt_ctx();
+  EVP_CIPHER_CTX* ctx = cipher->ctx();
   if (ctx == nullptr)
     return LOG_STATUS(Status::EncryptionError(
         "OpenSSL error; cannot decrypt: context allocation failed."));
 
-  // Initialize the cipher. We use the default parameter lengths for the IV and
-  // tag, so no further configuration is needed for the cipher.
-  EVP_CIPHER_CTX_init(ctx);
+  // Initialize the cipher, only setting the IV if the thread's context already
+  // holds the key. We use the default parameter lengths for the IV and tag, so
+  // no further configuration is needed for the cipher.
+  bool same_key = cipher->has_key(key->data());
   if (EVP_DecryptInit_ex(
           ctx,
-          EVP_aes_256_gcm(),
+          same_key ? nullptr : EVP_aes_256_gcm(),
           nullptr,
-          (unsigned char*)key->data(),
-          (unsigned char*)iv->data()) == 0) {
-    EVP_CIPHER_CTX_free(ctx);
-    return LOG_STATUS(
-        Status::EncryptionError("OpenSSL error; error initializing cipher."));
-  }
+          same_key ? nullptr : (const unsigned char*)key->data(),
+          (const unsigned char*)iv->data()) == 0)
+    return cipher_error(cipher, "OpenSSL error; error initializing cipher.");
+  cipher->set_key(key->data());
 
   // Decrypt the input.
   int output_len;
@@ -204,11 +275,8 @@ Status OpenSSL::decrypt_aes256gcm(
           (unsigned char*)output->cur_data(),
           &output_len,
           (const unsigned char*)input->data(),
-          (int)input->size()) == 0) {
-    EVP_CIPHER_CTX_free(ctx);
-    return LOG_STATUS(
-        Status::EncryptionError("OpenSSL error; error decrypting data."));
-  }
+          (int)input->size()) == 0)
+    return cipher_error(cipher, "OpenSSL error; error decrypting data.");
   if (output->owns_data())
     output->advance_size((uint64_t)output_len);
   output->advance_offset((uint64_t)output_len);
@@ -218,26 +286,17 @@ Status OpenSSL::decrypt_aes256gcm(
           ctx,
           EVP_CTRL_GCM_SET_TAG,
           Encryption::AES256GCM_TAG_BYTES,
-          (char*)tag->data()) == 0) {
-    EVP_CIPHER_CTX_free(ctx);
-    return LOG_STATUS(
-        Status::EncryptionError("OpenSSL error; error setting tag."));
-  }
+          (char*)tag->data()) == 0)
+    return cipher_error(cipher, "OpenSSL error; error setting tag.");
 
   // Finalize decryption.
   if (EVP_DecryptFinal_ex(
-          ctx, (unsigned char*)output->cur_data(), &output_len) == 0) {
-    EVP_CIPHER_CTX_free(ctx);
-    return LOG_STATUS(
-        Status::EncryptionError("OpenSSL error; error finalizing decryption."));
-  }
+          ctx, (unsigned char*)output->cur_data(), &output_len) == 0)
+    return cipher_error(cipher, "OpenSSL error; error finalizing decryption.");
   if (output->owns_data())
     output->advance_size((uint64_t)output_len);
   output->advance_offset((uint64_t)output_len);
 
-  // Clean up.
-  EVP_CIPHER_CTX_free(ctx);
-
   return Status::Ok();
 }
 
@@ -57,6 +57,12 @@ inline const std::string& filter_option_str(FilterOption filter_option_) {
       return constants::filter_option_bit_width_max_window_str;
     case FilterOption::POSITIVE_DELTA_MAX_WINDOW:
       return constants::filter_option_positive_delta_max_window_str;
+    case FilterOption::COMPRESSION_DICTIONARY_SIZE:
+      return constants::filter_option_compression_dictionary_size_str;
+    case FilterOption::COMPRESSION_BYTESHUFFLE:
+      return constants::filter_option_compression_byteshuffle_str;
+    case FilterOption::FRAME_OF_REFERENCE_DELTA:
+      return constants::filter_option_frame_of_reference_delta_str;
     default:
       return constants::empty_str;
   }
@@ -74,6 +80,17 @@ inline Status filter_option_enum(
       filter_option_str ==
       constants::filter_option_positive_delta_max_window_str)
     *filter_option_ = FilterOption::POSITIVE_DELTA_MAX_WINDOW;
+  else if (
+      filter_option_str ==
+      constants::filter_option_compression_dictionary_size_str)
+    *filter_option_ = FilterOption::COMPRESSION_DICTIONARY_SIZE;
+  else if (
+      filter_option_str == constants::filter_option_compression_byteshuffle_str)
+    *filter_option_ = FilterOption::COMPRESSION_BYTESHUFFLE;
+  else if (
+      filter_option_str ==
+      constants::filter_option_frame_of_reference_delta_str)
+    *filter_option_ = FilterOption::FRAME_OF_REFERENCE_DELTA;
   else
     return Status::Error("Invalid FilterOption " + filter_option_str);
 
@@ -79,6 +79,12 @@ inline const std::string& filter_type_str(FilterType filter_type) {
       return constants::filter_byteshuffle_str;
     case FilterType::FILTER_POSITIVE_DELTA:
       return constants::filter_positive_delta_str;
+    case FilterType::FILTER_DICTIONARY:
+      return constants::filter_dictionary_str;
+    case FilterType::FILTER_FLOAT_XOR:
+      return constants::filter_float_xor_str;
+    case FilterType::FILTER_FRAME_OF_REFERENCE:
+      return constants::filter_frame_of_reference_str;
     default:
       return constants::empty_str;
   }
@@ -109,6 +115,12 @@ inline Status filter_type_enum(
     *filter_type = FilterType::FILTER_BYTESHUFFLE;
   else if (filter_type_str == constants::filter_positive_delta_str)
     *filter_type = FilterType::FILTER_POSITIVE_DELTA;
+  else if (filter_type_str == constants::filter_dictionary_str)
+    *filter_type = FilterType::FILTER_DICTIONARY;
+  else if (filter_type_str == constants::filter_float_xor_str)
+    *filter_type = FilterType::FILTER_FLOAT_XOR;
+  else if (filter_type_str == constants::filter_frame_of_reference_str)
+    *filter_type = FilterType::FILTER_FRAME_OF_REFERENCE;
   else {
     return Status::Error("Invalid FilterType " + filter_type_str);
   }
@@ -48,7 +48,10 @@
 #include "tiledb/sm/misc/utils.h"
 
 #include <dlfcn.h>
+#include <algorithm>
 #include <cassert>
+#include <climits>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -118,6 +121,8 @@ class LibHDFS {
   std::function<hdfsBuilder*()> hdfsNewBuilder;
   std::function<void(hdfsBuilder*, const char*)> hdfsBuilderSetNameNode;
   std::function<int(const char*, char**)> hdfsConfGetStr;
+  std::function<int(hdfsBuilder*, const char*, const char*)>
+      hdfsBuilderConfSetStr;
   std::function<void(hdfsBuilder*, const char* kerbTicketCachePath)>
       hdfsBuilderSetKerbTicketCachePath;
   std::function<void(hdfsBuilder*, const char* userName)>
@@ -139,6 +144,14 @@ class LibHDFS {
   std::function<int(hdfsFS, const char*, const char*)> hdfsRename;
   std::function<int(hdfsFS, hdfsFile, tOffset)> hdfsSeek;
   std::function<int(hdfsFS)> hdfsDisconnect;
+  std::function<hadoopRzOptions*()> hadoopRzOptionsAlloc;
+  std::function<int(hadoopRzOptions*, int)> hadoopRzOptionsSetSkipChecksum;
+  std::function<void(hadoopRzOptions*)> hadoopRzOptionsFree;
+  std::function<hadoopRzBuffer*(hdfsFile, hadoopRzOptions*, int32_t)>
+      hadoopReadZero;
+  std::function<int32_t(const hadoopRzBuffer*)> hadoopRzBufferLength;
+  std::function<const void*(const hadoopRzBuffer*)> hadoopRzBufferGet;
+  std::function<void(hdfsFile, hadoopRzBuffer*)> hadoopRzBufferFree;
 
  private:
   void load_and_bind() {
@@ -151,6 +164,7 @@ class LibHDFS {
       BIND_HDFS_FUNC(hdfsNewBuilder);
       BIND_HDFS_FUNC(hdfsBuilderSetNameNode);
       BIND_HDFS_FUNC(hdfsConfGetStr);
+      BIND_HDFS_FUNC(hdfsBuilderConfSetStr);
       BIND_HDFS_FUNC(hdfsBuilderSetKerbTicketCachePath);
       BIND_HDFS_FUNC(hdfsBuilderSetUserName);
       BIND_HDFS_FUNC(hdfsCloseFile);
@@ -168,7 +182,14 @@ class LibHDFS {
       BIND_HDFS_FUNC(hdfsGetPathInfo);
       BIND_HDFS_FUNC(hdfsRename);
       BIND_HDFS_FUNC(hdfsSeek);
-      BIND_HDFS_FUNC(hdfsDisconnect)
+      BIND_HDFS_FUNC(hdfsDisconnect);
+      BIND_HDFS_FUNC(hadoopRzOptionsAlloc);
+      BIND_HDFS_FUNC(hadoopRzOptionsSetSkipChecksum);
+      BIND_HDFS_FUNC(hadoopRzOptionsFree);
+      BIND_HDFS_FUNC(hadoopReadZero);
+      BIND_HDFS_FUNC(hadoopRzBufferLength);
+      BIND_HDFS_FUNC(hadoopRzBufferGet);
+      BIND_HDFS_FUNC(hadoopRzBufferFree);
 #undef BIND_HDFS_FUNC
       return Status::Ok();
     };
@@ -204,7 +225,8 @@ class LibHDFS {
 
 HDFS::HDFS()
     : hdfs_(nullptr)
-    , libhdfs_(LibHDFS::load()) {
+    , libhdfs_(LibHDFS::load())
+    , zero_copy_read_(false) {
 }
 
 Status HDFS::init(const Config& config) {
@@ -217,6 +239,16 @@ Status HDFS::init(const Config& config) {
   std::string kerb_ticket_cache_path =
       config.get("vfs.hdfs.kerb_ticket_cache_path", &found);
   assert(found);
+  bool short_circuit_read = false;
+  RETURN_NOT_OK(config.get<bool>(
+      "vfs.hdfs.short_circuit_read", &short_circuit_read, &found));
+  assert(found);
+  std::string domain_socket_path =
+      config.get("vfs.hdfs.domain_socket_path", &found);
+  assert(found);
+  RETURN_NOT_OK(
+      config.get<bool>("vfs.hdfs.zero_copy_read", &zero_copy_read_, &found));
+  assert(found);
 
   // if libhdfs does not exist, just return and fail lazily on connection
   if (!libhdfs_->status().ok()) {
@@ -237,7 +269,18 @@ Status HDFS::init(const Config& config) {
     libhdfs_->hdfsBuilderSetKerbTicketCachePath(
         builder, kerb_ticket_cache_path.c_str());
   }
-  // TODO: Set config strings
+  if (short_circuit_read) {
+    if (libhdfs_->hdfsBuilderConfSetStr(
+            builder, "dfs.client.read.shortcircuit", "true") != 0)
+      return LOG_STATUS(Status::HDFSError(
+          "Failed to connect to hdfs, could not enable short-circuit reads"));
+    if (!domain_socket_path.empty() &&
+        libhdfs_->hdfsBuilderConfSetStr(
+            builder, "dfs.domain.socket.path", domain_socket_path.c_str()) !=
+            0)
+      return LOG_STATUS(Status::HDFSError(
+          "Failed to connect to hdfs, could not set the domain socket path"));
+  }
   hdfs_ = libhdfs_->hdfsBuilderConnect(builder);
   if (hdfs_ == nullptr) {
     // TODO: errno for better options
@@ -403,24 +446,36 @@ Status HDFS::read(const URI& uri, off_t offset, void* buffer, uint64_t length) {
         "'; offset > typemax(tOffset)"));
   }
   tOffset off = static_cast<tOffset>(offset);
-  int ret = libhdfs_->hdfsSeek(fs, readFile, off);
-  if (ret < 0) {
-    return LOG_STATUS(Status::HDFSError(
-        std::string("Cannot seek to offset ") + uri.to_string()));
-  }
   uint64_t bytes_to_read = length;
   char* buffptr = static_cast<char*>(buffer);
-  do {
+
+  // Copy what can be read straight from memory-mapped blocks first
+  if (zero_copy_read_ && bytes_to_read > 0) {
+    if (libhdfs_->hdfsSeek(fs, readFile, off) < 0) {
+      return LOG_STATUS(Status::HDFSError(
+          std::string("Cannot seek to offset ") + uri.to_string()));
+    }
+    uint64_t nbytes = 0;
+    RETURN_NOT_OK(read_zero_copy(readFile, buffptr, bytes_to_read, &nbytes));
+    off += static_cast<tOffset>(nbytes);
+    bytes_to_read -= nbytes;
+    buffptr += nbytes;
+  }
+
+  // Positional reads do not share the file position, so concurrent reads of
+  // the same file do not serialize on it
+  while (bytes_to_read > 0) {
     tSize nbytes = (bytes_to_read <= INT_MAX) ? bytes_to_read : INT_MAX;
-    tSize bytes_read =
-        libhdfs_->hdfsRead(fs, readFile, static_cast<void*>(buffptr), nbytes);
-    if (bytes_read < 0) {
+    tSize bytes_read = libhdfs_->hdfsPread(
+        fs, readFile, off, static_cast<void*>(buffptr), nbytes);
+    if (bytes_read <= 0) {
       return LOG_STATUS(Status::HDFSError(
           "Cannot read from file " + uri.to_string() + "; File reading error"));
     }
+    off += bytes_read;
     bytes_to_read -= bytes_read;
     buffptr += bytes_read;
-  } while (bytes_to_read > 0);
+  }
 
   // Close file
   if (libhdfs_->hdfsCloseFile(fs, readFile)) {
@@ -431,6 +486,38 @@ Status HDFS::read(const URI& uri, off_t offset, void* buffer, uint64_t length) {
   return Status::Ok();
 }
 
+Status HDFS::read_zero_copy(
+    hdfsFile file, void* buffer, uint64_t length, uint64_t* nbytes) {
+  *nbytes = 0;
+  hadoopRzOptions* opts = libhdfs_->hadoopRzOptionsAlloc();
+  if (opts == nullptr)
+    return Status::Ok();
+
+  // Without a fallback buffer pool, `hadoopReadZero` returns nullptr for
+  // blocks that cannot be memory-mapped, and the caller reads them instead
+  auto buffptr = static_cast<char*>(buffer);
+  while (*nbytes < length) {
+    auto max_length = static_cast<int32_t>(
+        std::min<uint64_t>(length - *nbytes, INT32_MAX));
+    hadoopRzBuffer* rz_buffer =
+        libhdfs_->hadoopReadZero(file, opts, max_length);
+    if (rz_buffer == nullptr)
+      break;
+    const void* data = libhdfs_->hadoopRzBufferGet(rz_buffer);
+    int32_t rz_length = libhdfs_->hadoopRzBufferLength(rz_buffer);
+    if (data == nullptr || rz_length <= 0) {
+      libhdfs_->hadoopRzBufferFree(file, rz_buffer);
+      break;
+    }
+    std::memcpy(buffptr + *nbytes, data, rz_length);
+    *nbytes += rz_length;
+    libhdfs_->hadoopRzBufferFree(file, rz_buffer);
+  }
+
+  libhdfs_->hadoopRzOptionsFree(opts);
+  return Status::Ok();
+}
+
 Status HDFS::write(const URI& uri, const void* buffer, uint64_t buffer_size) {
   hdfsFS fs = nullptr;
   RETURN_NOT_OK(connect(&fs));
@@ -194,6 +194,24 @@ class HDFS {
   hdfsFS hdfs_;
   LibHDFS* libhdfs_;
 
+  /** If true, reads are first attempted as zero-copy reads. */
+  bool zero_copy_read_;
+
+  /**
+   * Reads as many bytes as possible from the current position of an open
+   * file with zero-copy reads, which only succeed on memory-mapped (cached
+   * or short-circuited) blocks.
+   *
+   * @param file The open file.
+   * @param buffer The buffer to copy the read bytes to.
+   * @param length The number of bytes to read.
+   * @param nbytes Set to the number of bytes read, possibly less than
+   *     `length` when zero-copy reads are not available.
+   * @return Status
+   */
+  Status read_zero_copy(
+      hdfsFile file, void* buffer, uint64_t length, uint64_t* nbytes);
+
   /** Connect to hdfsFS and return handle, stub for future cached dynamic
    * connections **/
   Status connect(hdfsFS* fs);
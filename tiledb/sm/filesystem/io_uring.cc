@@ -0,0 +1,307 @@
+/**
+ * @file   io_uring.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements class IOUring.
+ */
+
+#ifdef HAVE_IO_URING
+
+#include "tiledb/sm/filesystem/io_uring.h"
+#include "tiledb/sm/misc/logger.h"
+#include "tiledb/sm/misc/stats.h"
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+
+namespace tiledb {
+namespace sm {
+
+namespace {
+
+int sys_io_uring_setup(unsigned entries, struct io_uring_params* p) {
+  return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+int sys_io_uring_enter(
+    int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+  return (int)syscall(
+      __NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0);
+}
+
+}  // namespace
+
+/* ********************************* */
+/*     CONSTRUCTORS & DESTRUCTORS    */
+/* ********************************* */
+
+IOUring::IOUring()
+    : ring_fd_(-1)
+    , sq_ring_(MAP_FAILED)
+    , sq_ring_size_(0)
+    , cq_ring_(MAP_FAILED)
+    , cq_ring_size_(0)
+    , sqes_(nullptr)
+    , sq_head_(nullptr)
+    , sq_tail_(nullptr)
+    , sq_mask_(nullptr)
+    , sq_array_(nullptr)
+    , cq_head_(nullptr)
+    , cq_tail_(nullptr)
+    , cq_mask_(nullptr)
+    , cqes_(nullptr) {
+  std::memset(&params_, 0, sizeof(params_));
+}
+
+IOUring::~IOUring() {
+  teardown();
+}
+
+/* ********************************* */
+/*                API                */
+/* ********************************* */
+
+Status IOUring::init(unsigned queue_depth) {
+  if (ring_fd_ != -1)
+    return Status::Ok();
+
+  std::memset(&params_, 0, sizeof(params_));
+  ring_fd_ = sys_io_uring_setup(std::max(queue_depth, 1u), &params_);
+  if (ring_fd_ < 0) {
+    ring_fd_ = -1;
+    return Status::IOError(
+        std::string("Cannot set up io_uring; ") + strerror(errno));
+  }
+
+  // Map the submission and completion rings. Newer kernels allow a single
+  // mapping for both.
+  sq_ring_size_ = params_.sq_off.array + params_.sq_entries * sizeof(unsigned);
+  cq_ring_size_ =
+      params_.cq_off.cqes + params_.cq_entries * sizeof(struct io_uring_cqe);
+  bool single_mmap = (params_.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap)
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+
+  sq_ring_ = mmap(
+      nullptr,
+      sq_ring_size_,
+      PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_POPULATE,
+      ring_fd_,
+      IORING_OFF_SQ_RING);
+  if (sq_ring_ == MAP_FAILED) {
+    auto st = Status::IOError(
+        std::string("Cannot map io_uring submission ring; ") +
+        strerror(errno));
+    teardown();
+    return st;
+  }
+
+  if (single_mmap) {
+    cq_ring_ = sq_ring_;
+  } else {
+    cq_ring_ = mmap(
+        nullptr,
+        cq_ring_size_,
+        PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_POPULATE,
+        ring_fd_,
+        IORING_OFF_CQ_RING);
+    if (cq_ring_ == MAP_FAILED) {
+      auto st = Status::IOError(
+          std::string("Cannot map io_uring completion ring; ") +
+          strerror(errno));
+      teardown();
+      return st;
+    }
+  }
+
+  void* sqes = mmap(
+      nullptr,
+      params_.sq_entries * sizeof(struct io_uring_sqe),
+      PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_POPULATE,
+      ring_fd_,
+      IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    auto st = Status::IOError(
+        std::string("Cannot map io_uring submission entries; ") +
+        strerror(errno));
+    teardown();
+    return st;
+  }
+  sqes_ = static_cast<struct io_uring_sqe*>(sqes);
+
+  auto sq = static_cast<char*>(sq_ring_);
+  sq_head_ = reinterpret_cast<unsigned*>(sq + params_.sq_off.head);
+  sq_tail_ = reinterpret_cast<unsigned*>(sq + params_.sq_off.tail);
+  sq_mask_ = reinterpret_cast<unsigned*>(sq + params_.sq_off.ring_mask);
+  sq_array_ = reinterpret_cast<unsigned*>(sq + params_.sq_off.array);
+
+  auto cq = static_cast<char*>(cq_ring_);
+  cq_head_ = reinterpret_cast<unsigned*>(cq + params_.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned*>(cq + params_.cq_off.tail);
+  cq_mask_ = reinterpret_cast<unsigned*>(cq + params_.cq_off.ring_mask);
+  cqes_ = reinterpret_cast<struct io_uring_cqe*>(cq + params_.cq_off.cqes);
+
+  return Status::Ok();
+}
+
+Status IOUring::read_all(
+    int fd, const std::vector<std::tuple<uint64_t, void*, uint64_t>>& regions) {
+  if (ring_fd_ == -1)
+    return LOG_STATUS(
+        Status::IOError("Cannot read with io_uring; Ring not initialized"));
+
+  // Build the read operations and the queue of operations to submit
+  std::vector<ReadOp> ops(regions.size());
+  std::deque<uint64_t> to_push;
+  for (uint64_t i = 0; i < regions.size(); ++i) {
+    ops[i].offset_ = std::get<0>(regions[i]);
+    ops[i].iov_.iov_base = std::get<1>(regions[i]);
+    ops[i].iov_.iov_len = std::get<2>(regions[i]);
+    if (ops[i].iov_.iov_len > 0)
+      to_push.push_back(i);
+  }
+
+  Status st = Status::Ok();
+  uint64_t in_flight = 0;
+  while (!to_push.empty() || in_flight > 0) {
+    // Fill the submission queue. Stop queuing new work on error, but keep
+    // reaping until every in-flight operation has completed, as the kernel
+    // may still be writing into the destination buffers.
+    while (st.ok() && !to_push.empty() &&
+           in_flight < params_.sq_entries) {
+      auto idx = to_push.front();
+      to_push.pop_front();
+      push_read(fd, &ops[idx], idx);
+      ++in_flight;
+    }
+    if (!st.ok())
+      to_push.clear();
+    if (in_flight == 0)
+      break;
+
+    // Submit everything the kernel has not consumed yet and wait for at
+    // least one completion.
+    unsigned to_submit =
+        *sq_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+    if (sys_io_uring_enter(
+            ring_fd_, to_submit, 1, IORING_ENTER_GETEVENTS) < 0) {
+      if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+        continue;
+      // Nothing can be reaped reliably anymore; the ring teardown will
+      // cancel any outstanding work.
+      return LOG_STATUS(Status::IOError(
+          std::string("Cannot submit io_uring reads; ") + strerror(errno)));
+    }
+    STATS_COUNTER_ADD(vfs_posix_io_uring_num_submits, 1);
+
+    // Reap completions
+    unsigned head = *cq_head_;
+    unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    for (; head != tail; ++head) {
+      const struct io_uring_cqe& cqe = cqes_[head & *cq_mask_];
+      auto idx = cqe.user_data;
+      auto& op = ops[idx];
+      --in_flight;
+
+      if (cqe.res < 0) {
+        if (cqe.res == -EINTR || cqe.res == -EAGAIN) {
+          to_push.push_back(idx);
+        } else if (st.ok()) {
+          st = LOG_STATUS(Status::IOError(
+              std::string("io_uring read error: ") + strerror(-cqe.res)));
+        }
+      } else if (cqe.res == 0) {
+        if (st.ok())
+          st = LOG_STATUS(Status::IOError(
+              "io_uring read error: Unexpected end of file"));
+      } else {
+        auto nread = (uint64_t)cqe.res;
+        if (nread < op.iov_.iov_len) {
+          // Short read: resubmit the remainder
+          op.offset_ += nread;
+          op.iov_.iov_base = static_cast<char*>(op.iov_.iov_base) + nread;
+          op.iov_.iov_len -= nread;
+          to_push.push_back(idx);
+        }
+      }
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+  }
+
+  return st;
+}
+
+/* ********************************* */
+/*          PRIVATE METHODS          */
+/* ********************************* */
+
+void IOUring::push_read(int fd, ReadOp* op, uint64_t user_data) {
+  unsigned tail = *sq_tail_;
+  unsigned idx = tail & *sq_mask_;
+  struct io_uring_sqe* sqe = &sqes_[idx];
+  std::memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = IORING_OP_READV;
+  sqe->fd = fd;
+  sqe->off = op->offset_;
+  sqe->addr = (uint64_t)(uintptr_t)&op->iov_;
+  sqe->len = 1;
+  sqe->user_data = user_data;
+  sq_array_[idx] = idx;
+  __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+}
+
+void IOUring::teardown() {
+  if (sqes_ != nullptr) {
+    munmap(sqes_, params_.sq_entries * sizeof(struct io_uring_sqe));
+    sqes_ = nullptr;
+  }
+  if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_)
+    munmap(cq_ring_, cq_ring_size_);
+  cq_ring_ = MAP_FAILED;
+  if (sq_ring_ != MAP_FAILED)
+    munmap(sq_ring_, sq_ring_size_);
+  sq_ring_ = MAP_FAILED;
+  if (ring_fd_ != -1) {
+    close(ring_fd_);
+    ring_fd_ = -1;
+  }
+}
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // HAVE_IO_URING
@@ -0,0 +1,179 @@
+/**
+ * @file   io_uring.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class IOUring, a minimal wrapper around the Linux
+ * io_uring kernel interface used by the POSIX backend.
+ */
+
+#ifndef TILEDB_IO_URING_H
+#define TILEDB_IO_URING_H
+
+#ifdef HAVE_IO_URING
+
+#include <linux/io_uring.h>
+#include <sys/uio.h>
+
+#include <cinttypes>
+#include <tuple>
+#include <vector>
+
+#include "tiledb/sm/misc/status.h"
+
+namespace tiledb {
+namespace sm {
+
+/**
+ * A single-owner io_uring instance that submits batches of positional reads
+ * against an open file descriptor. The ring talks to the kernel directly
+ * through the `io_uring_setup`/`io_uring_enter` system calls, so no external
+ * library is required.
+ *
+ * An instance must not be shared across threads.
+ */
+class IOUring {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /** Constructor. */
+  IOUring();
+
+  /** Destructor. Tears down the ring, if it was set up. */
+  ~IOUring();
+
+  IOUring(const IOUring&) = delete;
+  IOUring& operator=(const IOUring&) = delete;
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /**
+   * Sets up the ring with (at least) the given number of submission queue
+   * entries. This fails if the kernel does not support io_uring or the
+   * process is not allowed to use it.
+   *
+   * @param queue_depth The requested submission queue size.
+   * @return Status
+   */
+  Status init(unsigned queue_depth);
+
+  /**
+   * Reads all the given regions from `fd`. All regions are submitted to the
+   * kernel up front (up to the ring capacity) and completions are reaped as
+   * they arrive, resubmitting the remainder of any short reads.
+   *
+   * @param fd The open file descriptor to read from.
+   * @param regions The regions to read, as tuples
+   *     `(file_offset, dest_buffer, nbytes)`.
+   * @return Status
+   */
+  Status read_all(
+      int fd,
+      const std::vector<std::tuple<uint64_t, void*, uint64_t>>& regions);
+
+ private:
+  /* ********************************* */
+  /*        PRIVATE DATATYPES          */
+  /* ********************************* */
+
+  /** State of a single (possibly partially completed) read operation. */
+  struct ReadOp {
+    /** Current file offset. */
+    uint64_t offset_;
+    /** Scatter vector pointing at the remaining destination bytes. */
+    struct iovec iov_;
+  };
+
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The ring file descriptor (-1 if not set up). */
+  int ring_fd_;
+
+  /** Setup parameters filled in by the kernel. */
+  struct io_uring_params params_;
+
+  /** The mapped submission queue ring. */
+  void* sq_ring_;
+
+  /** The size of the mapped submission queue ring. */
+  size_t sq_ring_size_;
+
+  /** The mapped completion queue ring (may alias `sq_ring_`). */
+  void* cq_ring_;
+
+  /** The size of the mapped completion queue ring. */
+  size_t cq_ring_size_;
+
+  /** The mapped submission queue entries. */
+  struct io_uring_sqe* sqes_;
+
+  /** Submission queue head (advanced by the kernel). */
+  unsigned* sq_head_;
+
+  /** Submission queue tail (advanced by us). */
+  unsigned* sq_tail_;
+
+  /** Submission queue index mask. */
+  unsigned* sq_mask_;
+
+  /** Submission queue index array. */
+  unsigned* sq_array_;
+
+  /** Completion queue head (advanced by us). */
+  unsigned* cq_head_;
+
+  /** Completion queue tail (advanced by the kernel). */
+  unsigned* cq_tail_;
+
+  /** Completion queue index mask. */
+  unsigned* cq_mask_;
+
+  /** The completion queue entries. */
+  struct io_uring_cqe* cqes_;
+
+  /* ********************************* */
+  /*          PRIVATE METHODS          */
+  /* ********************************* */
+
+  /** Queues a readv SQE for the given operation. */
+  void push_read(int fd, ReadOp* op, uint64_t user_data);
+
+  /** Unmaps the rings and closes the ring file descriptor. */
+  void teardown();
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // HAVE_IO_URING
+#endif  // TILEDB_IO_URING_H
@@ -0,0 +1,74 @@
+/**
+ * @file   mapped_region.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements class MappedRegion.
+ */
+
+#include "tiledb/sm/filesystem/mapped_region.h"
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+namespace tiledb {
+namespace sm {
+
+/* ********************************* */
+/*     CONSTRUCTORS & DESTRUCTORS    */
+/* ********************************* */
+
+MappedRegion::MappedRegion(
+    void* map_addr, uint64_t map_size, uint64_t data_offset, uint64_t size)
+    : map_addr_(map_addr)
+    , map_size_(map_size)
+    , data_offset_(data_offset)
+    , size_(size) {
+}
+
+MappedRegion::~MappedRegion() {
+#ifndef _WIN32
+  if (map_addr_ != nullptr)
+    munmap(map_addr_, map_size_);
+#endif
+}
+
+/* ********************************* */
+/*                API                */
+/* ********************************* */
+
+void* MappedRegion::data() const {
+  return static_cast<char*>(map_addr_) + data_offset_;
+}
+
+uint64_t MappedRegion::size() const {
+  return size_;
+}
+
+}  // namespace sm
+}  // namespace tiledb
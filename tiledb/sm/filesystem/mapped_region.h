@@ -0,0 +1,100 @@
+/**
+ * @file   mapped_region.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class MappedRegion.
+ */
+
+#ifndef TILEDB_MAPPED_REGION_H
+#define TILEDB_MAPPED_REGION_H
+
+#include <cinttypes>
+
+namespace tiledb {
+namespace sm {
+
+/**
+ * A memory-mapped region of a file. The mapping is private (copy-on-write)
+ * and is released when the object is destroyed, so holders of the data
+ * pointer must keep the region alive (typically via `std::shared_ptr`).
+ */
+class MappedRegion {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /**
+   * Constructor.
+   *
+   * @param map_addr The (page-aligned) address returned by `mmap`.
+   * @param map_size The size of the whole mapping.
+   * @param data_offset The offset of the requested data in the mapping.
+   * @param size The size of the requested data.
+   */
+  MappedRegion(
+      void* map_addr, uint64_t map_size, uint64_t data_offset, uint64_t size);
+
+  /** Destructor. Unmaps the region. */
+  ~MappedRegion();
+
+  MappedRegion(const MappedRegion&) = delete;
+  MappedRegion& operator=(const MappedRegion&) = delete;
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /** Returns a pointer to the requested data. */
+  void* data() const;
+
+  /** Returns the size of the requested data. */
+  uint64_t size() const;
+
+ private:
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The address of the mapping. */
+  void* map_addr_;
+
+  /** The size of the mapping. */
+  uint64_t map_size_;
+
+  /** The offset of the requested data in the mapping. */
+  uint64_t data_offset_;
+
+  /** The size of the requested data. */
+  uint64_t size_;
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_MAPPED_REGION_H
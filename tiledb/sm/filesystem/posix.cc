@@ -33,6 +33,7 @@
 #ifndef _WIN32
 
 #include "tiledb/sm/filesystem/posix.h"
+#include "tiledb/sm/filesystem/io_uring.h"
 #include "tiledb/sm/misc/constants.h"
 #include "tiledb/sm/misc/logger.h"
 #include "tiledb/sm/misc/stats.h"
@@ -41,7 +42,10 @@
 
 #include <dirent.h>
 #include <limits.h>
+#include <sys/mman.h>
 
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <future>
 #include <iostream>
@@ -304,6 +308,61 @@ Status Posix::ls(
   return Status::Ok();
 }
 
+Status Posix::map_region(
+    const std::string& path,
+    uint64_t offset,
+    uint64_t nbytes,
+    std::shared_ptr<MappedRegion>* region) const {
+  // Checks
+  if (nbytes == 0)
+    return LOG_STATUS(
+        Status::IOError("Cannot map file region; Region is empty"));
+  uint64_t file_size;
+  RETURN_NOT_OK(this->file_size(path, &file_size));
+  if (offset + nbytes > file_size)
+    return LOG_STATUS(
+        Status::IOError("Cannot map file region; Region exceeds file size"));
+
+  // Open file
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return LOG_STATUS(Status::IOError(
+        std::string("Cannot map file region; ") + strerror(errno)));
+  }
+
+  // The mapping offset must be a multiple of the page size
+  auto page_size = (uint64_t)sysconf(_SC_PAGESIZE);
+  uint64_t map_offset = (offset / page_size) * page_size;
+  uint64_t data_offset = offset - map_offset;
+  uint64_t map_size = data_offset + nbytes;
+  void* addr = mmap(
+      nullptr,
+      map_size,
+      PROT_READ | PROT_WRITE,
+      MAP_PRIVATE,
+      fd,
+      (off_t)map_offset);
+  if (addr == MAP_FAILED) {
+    auto st = LOG_STATUS(Status::IOError(
+        std::string("Cannot map file region '") + path + "'; " +
+        strerror(errno)));
+    close(fd);
+    return st;
+  }
+
+  // The mapping stays valid after the file is closed
+  if (close(fd)) {
+    munmap(addr, map_size);
+    return LOG_STATUS(Status::IOError(
+        std::string("Cannot map file region; ") + strerror(errno)));
+  }
+
+  *region =
+      std::make_shared<MappedRegion>(addr, map_size, data_offset, nbytes);
+
+  return Status::Ok();
+}
+
 Status Posix::move_path(
     const std::string& old_path, const std::string& new_path) {
   if (rename(old_path.c_str(), new_path.c_str()) != 0) {
@@ -379,8 +438,13 @@ Status Posix::read(
     return LOG_STATUS(
         Status::IOError("Cannot read from file; Read exceeds file size"));
 
-  // Open file
-  int fd = open(path.c_str(), O_RDONLY);
+  // Open file, falling back to buffered I/O if direct I/O is not supported
+  bool direct = direct_io();
+  int fd = direct ? open_direct(path, O_RDONLY) : -1;
+  if (fd == -1) {
+    direct = false;
+    fd = open(path.c_str(), O_RDONLY);
+  }
   if (fd == -1) {
     return LOG_STATUS(Status::IOError(
         std::string("Cannot read from file; ") + strerror(errno)));
@@ -395,8 +459,15 @@ Status Posix::read(
         std::string("Cannot read from file ' ") + path.c_str() +
         "'; nbytes > SSIZE_MAX"));
   }
-  uint64_t bytes_read = read_all(fd, buffer, nbytes, offset);
-  if (bytes_read != nbytes) {
+  if (direct) {
+    auto st = read_direct(fd, offset, buffer, nbytes);
+    if (!st.ok()) {
+      close(fd);
+      return LOG_STATUS(Status::IOError(
+          std::string("Cannot read from file '") + path.c_str() + "'; " +
+          st.message()));
+    }
+  } else if (read_all(fd, buffer, nbytes, offset) != nbytes) {
     return LOG_STATUS(Status::IOError(
         std::string("Cannot read from file '") + path.c_str() +
         "'; File reading error"));
@@ -409,6 +480,69 @@ Status Posix::read(
   return Status::Ok();
 }
 
+Status Posix::read_batch(
+    const std::string& path,
+    const std::vector<std::tuple<uint64_t, void*, uint64_t>>& regions) const {
+  if (regions.empty())
+    return Status::Ok();
+
+  // Checks
+  uint64_t file_size;
+  RETURN_NOT_OK(this->file_size(path, &file_size));
+  for (const auto& region : regions) {
+    if (std::get<0>(region) + std::get<2>(region) > file_size)
+      return LOG_STATUS(
+          Status::IOError("Cannot read from file; Read exceeds file size"));
+    if (std::get<2>(region) > SSIZE_MAX) {
+      return LOG_STATUS(Status::IOError(
+          std::string("Cannot read from file ' ") + path.c_str() +
+          "'; nbytes > SSIZE_MAX"));
+    }
+  }
+
+  // Open file
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return LOG_STATUS(Status::IOError(
+        std::string("Cannot read from file; ") + strerror(errno)));
+  }
+
+  Status st = Status::Ok();
+  bool done = false;
+#ifdef HAVE_IO_URING
+  if (use_io_uring()) {
+    IOUring ring;
+    unsigned queue_depth = (unsigned)std::min<uint64_t>(
+        regions.size(), constants::io_uring_queue_depth);
+    // Fall back to pread if the kernel refuses to set up the ring
+    if (ring.init(queue_depth).ok()) {
+      st = ring.read_all(fd, regions);
+      done = true;
+    }
+  }
+#endif
+
+  if (!done) {
+    for (const auto& region : regions) {
+      uint64_t nbytes = std::get<2>(region);
+      if (read_all(fd, std::get<1>(region), nbytes, std::get<0>(region)) !=
+          nbytes) {
+        st = LOG_STATUS(Status::IOError(
+            std::string("Cannot read from file '") + path.c_str() +
+            "'; File reading error"));
+        break;
+      }
+    }
+  }
+
+  // Close file
+  if (close(fd) && st.ok()) {
+    return LOG_STATUS(Status::IOError(
+        std::string("Cannot read from file; ") + strerror(errno)));
+  }
+  return st;
+}
+
 Status Posix::sync(const std::string& path) {
   // Open file
   int fd = -1;
@@ -443,6 +577,25 @@ Status Posix::sync(const std::string& path) {
   return Status::Ok();
 }
 
+bool Posix::use_io_uring() const {
+#ifdef HAVE_IO_URING
+  bool found;
+  auto engine = config_.get().get("vfs.file.io_engine", &found);
+  assert(found);
+  return engine == "io_uring" && !direct_io();
+#else
+  return false;
+#endif
+}
+
+bool Posix::direct_io() const {
+  bool found;
+  bool direct = false;
+  if (!config_.get().get<bool>("vfs.file.direct_io", &direct, &found).ok())
+    return false;
+  return direct;
+}
+
 Status Posix::write(
     const std::string& path, const void* buffer, uint64_t buffer_size) {
   // Get config params
@@ -468,6 +621,15 @@ Status Posix::write(
     }
   }
 
+  // Direct writes are not split across the thread pool
+  if (direct_io()) {
+    bool written = false;
+    RETURN_NOT_OK(
+        write_direct(path, file_offset, buffer, buffer_size, &written));
+    if (written)
+      return Status::Ok();
+  }
+
   // Open or create file.
   int fd = open(path.c_str(), O_WRONLY | O_CREAT, S_IRWXU);
   if (fd == -1) {
@@ -519,6 +681,188 @@ Status Posix::write(
   return st;
 }
 
+Status Posix::write_at_offset(
+    const std::string& path,
+    uint64_t file_offset,
+    const void* buffer,
+    uint64_t buffer_size) const {
+  if (direct_io()) {
+    bool written = false;
+    RETURN_NOT_OK(
+        write_direct(path, file_offset, buffer, buffer_size, &written));
+    if (written)
+      return Status::Ok();
+  }
+
+  int fd = open(path.c_str(), O_WRONLY | O_CREAT, S_IRWXU);
+  if (fd == -1) {
+    return LOG_STATUS(Status::IOError(
+        std::string("Cannot open file '") + path + "'; " + strerror(errno)));
+  }
+
+  auto st = write_at(fd, file_offset, buffer, buffer_size);
+  if (!st.ok()) {
+    close(fd);
+    std::stringstream errmsg;
+    errmsg << "Cannot write to file '" << path << "'; " << st.message();
+    return LOG_STATUS(Status::IOError(errmsg.str()));
+  }
+
+  if (close(fd) != 0) {
+    return LOG_STATUS(Status::IOError(
+        std::string("Cannot close file '") + path + "'; " + strerror(errno)));
+  }
+
+  return Status::Ok();
+}
+
+int Posix::open_direct(const std::string& path, int flags) {
+#if defined(O_DIRECT)
+  return open(path.c_str(), flags | O_DIRECT, S_IRWXU);
+#elif defined(F_NOCACHE)
+  // No alignment restrictions, but this still bypasses the cache
+  int fd = open(path.c_str(), flags, S_IRWXU);
+  if (fd != -1 && fcntl(fd, F_NOCACHE, 1) == -1) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+#else
+  (void)path;
+  (void)flags;
+  errno = EINVAL;
+  return -1;
+#endif
+}
+
+Status Posix::read_direct(
+    int fd, uint64_t offset, void* buffer, uint64_t nbytes) {
+  const uint64_t align = constants::direct_io_alignment;
+
+  // Aligned requests are read in place
+  if (offset % align == 0 && nbytes % align == 0 &&
+      reinterpret_cast<uintptr_t>(buffer) % align == 0) {
+    if (read_all(fd, buffer, nbytes, offset) != nbytes)
+      return Status::IOError("Direct read error");
+    return Status::Ok();
+  }
+
+  uint64_t first_block = offset - offset % align;
+  uint64_t staging_size = std::min(
+      constants::direct_io_staging_size,
+      utils::math::ceil(offset + nbytes - first_block, align) * align);
+  void* staging = nullptr;
+  if (posix_memalign(&staging, align, staging_size) != 0)
+    return Status::IOError("Cannot allocate direct I/O staging buffer");
+
+  auto dest = static_cast<char*>(buffer);
+  auto src = static_cast<char*>(staging);
+  uint64_t pos = offset, end = offset + nbytes;
+  while (pos < end) {
+    uint64_t block = pos - pos % align;
+    uint64_t len = std::min(
+        staging_size, utils::math::ceil(end - block, align) * align);
+
+    // The last block of the file may be partial
+    uint64_t nread = 0;
+    while (nread < len) {
+      ssize_t actual_read =
+          ::pread(fd, src + nread, len - nread, block + nread);
+      if (actual_read == -1 && errno == EINTR)
+        continue;
+      if (actual_read == -1) {
+        free(staging);
+        return Status::IOError(
+            std::string("POSIX pread error: ") + strerror(errno));
+      }
+      nread += actual_read;
+      if (actual_read == 0 || (block + nread) % align != 0)
+        break;
+    }
+
+    uint64_t copy_end = std::min(block + nread, end);
+    if (copy_end <= pos) {
+      free(staging);
+      return Status::IOError("Direct read error; Unexpected end of file");
+    }
+    std::memcpy(dest + (pos - offset), src + (pos - block), copy_end - pos);
+    pos = copy_end;
+  }
+
+  free(staging);
+  return Status::Ok();
+}
+
+Status Posix::write_direct(
+    const std::string& path,
+    uint64_t file_offset,
+    const void* buffer,
+    uint64_t buffer_size,
+    bool* written) {
+  *written = false;
+  int direct_fd = open_direct(path, O_WRONLY | O_CREAT);
+  if (direct_fd == -1)
+    return Status::Ok();
+
+  // Split into an unaligned head, an aligned body and an unaligned tail
+  const uint64_t align = constants::direct_io_alignment;
+  uint64_t end = file_offset + buffer_size;
+  uint64_t body_start =
+      std::min(utils::math::ceil(file_offset, align) * align, end);
+  uint64_t body_end = std::max(end - end % align, body_start);
+  auto bytes = static_cast<const char*>(buffer);
+
+  Status st = Status::Ok();
+  auto body = bytes + (body_start - file_offset);
+  if (body_end > body_start &&
+      reinterpret_cast<uintptr_t>(body) % align == 0) {
+    // Aligned buffers are written in place
+    if (pwrite_all(direct_fd, body_start, body, body_end - body_start) !=
+        body_end - body_start)
+      st = Status::IOError("Direct write error");
+  } else if (body_end > body_start) {
+    uint64_t staging_size =
+        std::min(constants::direct_io_staging_size, body_end - body_start);
+    void* staging = nullptr;
+    if (posix_memalign(&staging, align, staging_size) != 0) {
+      st = Status::IOError("Cannot allocate direct I/O staging buffer");
+    } else {
+      for (uint64_t pos = body_start; pos < body_end && st.ok();
+           pos += staging_size) {
+        uint64_t len = std::min(staging_size, body_end - pos);
+        std::memcpy(staging, bytes + (pos - file_offset), len);
+        if (pwrite_all(direct_fd, pos, staging, len) != len)
+          st = Status::IOError("Direct write error");
+      }
+      free(staging);
+    }
+  }
+  close(direct_fd);
+
+  if (st.ok() && (body_start > file_offset || end > body_end)) {
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT, S_IRWXU);
+    if (fd == -1) {
+      st = Status::IOError(strerror(errno));
+    } else {
+      if (body_start > file_offset)
+        st = write_at(fd, file_offset, bytes, body_start - file_offset);
+      if (st.ok() && end > body_end)
+        st = write_at(
+            fd, body_end, bytes + (body_end - file_offset), end - body_end);
+      close(fd);
+    }
+  }
+
+  if (!st.ok()) {
+    std::stringstream errmsg;
+    errmsg << "Cannot write to file '" << path << "'; " << st.message();
+    return LOG_STATUS(Status::IOError(errmsg.str()));
+  }
+
+  *written = true;
+  return Status::Ok();
+}
+
 Status Posix::write_at(
     int fd, uint64_t file_offset, const void* buffer, uint64_t buffer_size) {
   // Append data to the file in batches of constants::max_write_bytes
@@ -39,11 +39,14 @@
 #include <sys/types.h>
 
 #include <functional>
+#include <memory>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include "tiledb/sm/config/config.h"
 #include "tiledb/sm/filesystem/filelock.h"
+#include "tiledb/sm/filesystem/mapped_region.h"
 #include "tiledb/sm/misc/status.h"
 
 namespace tiledb {
@@ -175,6 +178,23 @@ class Posix {
    */
   Status ls(const std::string& path, std::vector<std::string>* paths) const;
 
+  /**
+   * Maps a region of a file into memory (private, read/write copy-on-write
+   * pages). The mapping is released when the last reference to `region` is
+   * dropped.
+   *
+   * @param path The name of the file.
+   * @param offset The offset in the file where the region starts.
+   * @param nbytes The size of the region.
+   * @param region The mapped region to be returned.
+   * @return Status
+   */
+  Status map_region(
+      const std::string& path,
+      uint64_t offset,
+      uint64_t nbytes,
+      std::shared_ptr<MappedRegion>* region) const;
+
   /**
    * Move a given filesystem path.
    *
@@ -199,6 +219,31 @@ class Posix {
       void* buffer,
       uint64_t nbytes) const;
 
+  /**
+   * Reads multiple regions of a file directly into their destination
+   * buffers, opening the file only once. If `vfs.file.io_engine` is
+   * `io_uring` (and supported), all regions are submitted to the kernel
+   * together; otherwise they are read one by one with `pread`.
+   *
+   * @param path The name of the file.
+   * @param regions The regions to read, as tuples
+   *     `(file_offset, dest_buffer, nbytes)`.
+   * @return Status
+   */
+  Status read_batch(
+      const std::string& path,
+      const std::vector<std::tuple<uint64_t, void*, uint64_t>>& regions)
+      const;
+
+  /**
+   * Returns `true` if batched reads are configured to use io_uring and this
+   * build supports it.
+   */
+  bool use_io_uring() const;
+
+  /** Returns `true` if reads and writes are configured to use direct I/O. */
+  bool direct_io() const;
+
   /**
    * Syncs a file or directory.
    *
@@ -221,6 +266,23 @@ class Posix {
   Status write(
       const std::string& path, const void* buffer, uint64_t buffer_size);
 
+  /**
+   * Writes the input buffer to a file at the given offset, creating the
+   * file if it does not exist. Unlike `write`, this never splits the write
+   * across the thread pool, so it is safe to call from a pool task.
+   *
+   * @param path The name of the file.
+   * @param file_offset The offset in the file to write at.
+   * @param buffer The input buffer.
+   * @param buffer_size The size of the input buffer.
+   * @return Status
+   */
+  Status write_at_offset(
+      const std::string& path,
+      uint64_t file_offset,
+      const void* buffer,
+      uint64_t buffer_size) const;
+
  private:
   /** Config parameters inherited from parent VFS. */
   std::reference_wrapper<const Config> config_;
@@ -233,6 +295,46 @@ class Posix {
 
   static void adjacent_slashes_dedup(std::string* path);
 
+  /**
+   * Opens a file for direct I/O with the given `open` flags. Returns -1 and
+   * sets `errno` if the platform or filesystem does not support it.
+   */
+  static int open_direct(const std::string& path, int flags);
+
+  /**
+   * Reads from a file opened for direct I/O. The read is expanded to the
+   * direct I/O alignment and goes through an aligned staging buffer, unless
+   * the request is already aligned.
+   *
+   * @param fd The file descriptor, opened for direct I/O.
+   * @param offset The offset in the file from which the read will start.
+   * @param buffer The buffer into which the data will be written.
+   * @param nbytes The size of the data to be read from the file.
+   * @return Status
+   */
+  static Status read_direct(
+      int fd, uint64_t offset, void* buffer, uint64_t nbytes);
+
+  /**
+   * Writes to a file with direct I/O at the given offset. The unaligned
+   * head and tail of the range are written through the page cache, and the
+   * aligned body through an aligned staging buffer.
+   *
+   * @param path The name of the file.
+   * @param file_offset The offset in the file to write at.
+   * @param buffer The input buffer.
+   * @param buffer_size The size of the input buffer.
+   * @param written Set to `false` if the file could not be opened for direct
+   *     I/O, in which case nothing was written.
+   * @return Status
+   */
+  static Status write_direct(
+      const std::string& path,
+      uint64_t file_offset,
+      const void* buffer,
+      uint64_t buffer_size,
+      bool* written);
+
   static bool both_slashes(char a, char b);
 
   /**
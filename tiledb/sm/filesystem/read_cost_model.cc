@@ -0,0 +1,148 @@
+/**
+ * @file   read_cost_model.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements class ReadCostModel.
+ */
+
+#include "tiledb/sm/filesystem/read_cost_model.h"
+#include "tiledb/sm/misc/constants.h"
+
+#include <cmath>
+
+namespace tiledb {
+namespace sm {
+
+/* ********************************* */
+/*     CONSTRUCTORS & DESTRUCTORS    */
+/* ********************************* */
+
+ReadCostModel::ReadCostModel()
+    : num_samples_(0)
+    , sum_w_(0)
+    , sum_x_(0)
+    , sum_y_(0)
+    , sum_xx_(0)
+    , sum_xy_(0) {
+}
+
+/* ********************************* */
+/*                API                */
+/* ********************************* */
+
+bool ReadCostModel::batch_gap(uint64_t max_gap, uint64_t* gap) const {
+  std::unique_lock<std::mutex> lck(mtx_);
+
+  if (num_samples_ < constants::read_cost_model_min_samples)
+    return false;
+
+  double latency, seconds_per_byte;
+  if (!fit(&latency, &seconds_per_byte))
+    return false;
+
+  // No measurable latency: never over-read.
+  if (latency <= 0) {
+    *gap = 0;
+    return true;
+  }
+
+  // No measurable transfer cost: always over-read.
+  if (seconds_per_byte <= 0 || latency >= seconds_per_byte * (double)max_gap) {
+    *gap = max_gap;
+    return true;
+  }
+
+  *gap = (uint64_t)(latency / seconds_per_byte);
+  return true;
+}
+
+double ReadCostModel::latency() const {
+  std::unique_lock<std::mutex> lck(mtx_);
+  double latency = 0, seconds_per_byte = 0;
+  fit(&latency, &seconds_per_byte);
+  return latency;
+}
+
+uint64_t ReadCostModel::num_samples() const {
+  std::unique_lock<std::mutex> lck(mtx_);
+  return num_samples_;
+}
+
+void ReadCostModel::record(uint64_t nbytes, double seconds) {
+  std::unique_lock<std::mutex> lck(mtx_);
+
+  // Age the previous observations
+  const double decay = constants::read_cost_model_decay;
+  sum_w_ *= decay;
+  sum_x_ *= decay;
+  sum_y_ *= decay;
+  sum_xx_ *= decay;
+  sum_xy_ *= decay;
+
+  auto x = (double)nbytes;
+  sum_w_ += 1;
+  sum_x_ += x;
+  sum_y_ += seconds;
+  sum_xx_ += x * x;
+  sum_xy_ += x * seconds;
+  ++num_samples_;
+}
+
+void ReadCostModel::reset() {
+  std::unique_lock<std::mutex> lck(mtx_);
+  num_samples_ = 0;
+  sum_w_ = sum_x_ = sum_y_ = sum_xx_ = sum_xy_ = 0;
+}
+
+double ReadCostModel::seconds_per_byte() const {
+  std::unique_lock<std::mutex> lck(mtx_);
+  double latency = 0, seconds_per_byte = 0;
+  fit(&latency, &seconds_per_byte);
+  return seconds_per_byte;
+}
+
+/* ********************************* */
+/*          PRIVATE METHODS          */
+/* ********************************* */
+
+bool ReadCostModel::fit(double* latency, double* seconds_per_byte) const {
+  if (sum_w_ <= 0)
+    return false;
+
+  // The slope is undetermined if (almost) all reads have the same size.
+  double det = sum_w_ * sum_xx_ - sum_x_ * sum_x_;
+  if (det <= 1e-9 * sum_w_ * sum_xx_)
+    return false;
+
+  *seconds_per_byte = (sum_w_ * sum_xy_ - sum_x_ * sum_y_) / det;
+  *latency = (sum_y_ - *seconds_per_byte * sum_x_) / sum_w_;
+  return std::isfinite(*latency) && std::isfinite(*seconds_per_byte);
+}
+
+}  // namespace sm
+}  // namespace tiledb
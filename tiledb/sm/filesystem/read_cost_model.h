@@ -0,0 +1,151 @@
+/**
+ * @file   read_cost_model.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class ReadCostModel.
+ */
+
+#ifndef TILEDB_READ_COST_MODEL_H
+#define TILEDB_READ_COST_MODEL_H
+
+#include <cinttypes>
+#include <mutex>
+
+namespace tiledb {
+namespace sm {
+
+/**
+ * Keeps a running estimate of the cost of a read operation on a backend,
+ * modeled as `time = latency + nbytes / bandwidth`. The model is fitted with
+ * exponentially-weighted least squares over the observed reads, so that it
+ * tracks changing conditions.
+ *
+ * The estimate is used to decide when two regions should be read with a
+ * single request: over-reading a gap of `g` bytes costs `g / bandwidth`,
+ * whereas an extra request costs `latency`. Hence the break-even gap is the
+ * bandwidth-delay product `latency * bandwidth`.
+ *
+ * This class is thread-safe.
+ */
+class ReadCostModel {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /** Constructor. */
+  ReadCostModel();
+
+  /** Destructor. */
+  ~ReadCostModel() = default;
+
+  ReadCostModel(const ReadCostModel&) = delete;
+  ReadCostModel& operator=(const ReadCostModel&) = delete;
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /**
+   * Computes the break-even batch gap from the current estimate.
+   *
+   * @param max_gap The value to clamp the gap to.
+   * @param gap The computed gap (in bytes).
+   * @return `true` if enough reads have been observed for a reliable
+   *     estimate; otherwise `gap` is left untouched.
+   */
+  bool batch_gap(uint64_t max_gap, uint64_t* gap) const;
+
+  /** Returns the estimated per-request latency (in seconds). */
+  double latency() const;
+
+  /** Returns the number of observed reads. */
+  uint64_t num_samples() const;
+
+  /**
+   * Records an observed read.
+   *
+   * @param nbytes The number of bytes read.
+   * @param seconds The duration of the read.
+   */
+  void record(uint64_t nbytes, double seconds);
+
+  /** Clears all observations. */
+  void reset();
+
+  /**
+   * Returns the estimated transfer time per byte (the inverse of the
+   * bandwidth, in seconds).
+   */
+  double seconds_per_byte() const;
+
+ private:
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** Protects the fields below. */
+  mutable std::mutex mtx_;
+
+  /** The number of observed reads. */
+  uint64_t num_samples_;
+
+  /** Weighted sum of observation weights. */
+  double sum_w_;
+
+  /** Weighted sum of read sizes. */
+  double sum_x_;
+
+  /** Weighted sum of read durations. */
+  double sum_y_;
+
+  /** Weighted sum of squared read sizes. */
+  double sum_xx_;
+
+  /** Weighted sum of read sizes times durations. */
+  double sum_xy_;
+
+  /* ********************************* */
+  /*          PRIVATE METHODS          */
+  /* ********************************* */
+
+  /**
+   * Fits the model to the current observations. Must be called with `mtx_`
+   * held.
+   *
+   * @param latency The fitted latency.
+   * @param seconds_per_byte The fitted transfer time per byte.
+   * @return `true` if the observations determine the model.
+   */
+  bool fit(double* latency, double* seconds_per_byte) const;
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_READ_COST_MODEL_H
@@ -32,15 +32,26 @@
 
 #ifdef HAVE_S3
 
+#include <aws/core/monitoring/HttpClientMetrics.h>
+#include <aws/core/monitoring/MonitoringFactory.h>
+#include <aws/core/monitoring/MonitoringInterface.h>
 #include <aws/core/utils/logging/AWSLogging.h>
 #include <aws/core/utils/logging/DefaultLogSystem.h>
 #include <aws/core/utils/logging/LogLevel.h>
 #include <aws/core/utils/memory/stl/AWSString.h>
 #include <aws/s3/model/AbortMultipartUploadRequest.h>
 #include <aws/s3/model/CreateMultipartUploadRequest.h>
+#include <aws/s3/model/UploadPartCopyRequest.h>
 #include <boost/interprocess/streams/bufferstream.hpp>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <streambuf>
 #include "tiledb/sm/global_state/global_state.h"
 
 #include "tiledb/sm/global_state/unit_test_config.h"
@@ -98,6 +109,175 @@ std::string outcome_error_message(const Aws::Utils::Outcome<R, E>& outcome) {
          outcome.GetError().GetMessage().c_str();
 }
 
+/**
+ * AWS monitoring hook that classifies every completed HTTP request as
+ * having opened a new connection or reused a pooled one, and records it in
+ * the connection stats counters. The HTTP client does not always report
+ * reuse explicitly; in that case a request with a non-zero TCP connect or
+ * TLS handshake time is counted as a new connection, so the counters are
+ * an estimate. It also counts the requests retried by the retry strategy.
+ */
+class ConnectionReuseMonitor : public Aws::Monitoring::MonitoringInterface {
+ public:
+  void* OnRequestStarted(
+      const Aws::String&,
+      const Aws::String&,
+      const std::shared_ptr<const Aws::Http::HttpRequest>&) const override {
+    return nullptr;
+  }
+
+  void OnRequestSucceeded(
+      const Aws::String&,
+      const Aws::String&,
+      const std::shared_ptr<const Aws::Http::HttpRequest>&,
+      const Aws::Client::HttpResponseOutcome&,
+      const Aws::Monitoring::CoreMetricsCollection& metrics,
+      void*) const override {
+    record(metrics);
+  }
+
+  void OnRequestFailed(
+      const Aws::String&,
+      const Aws::String&,
+      const std::shared_ptr<const Aws::Http::HttpRequest>&,
+      const Aws::Client::HttpResponseOutcome&,
+      const Aws::Monitoring::CoreMetricsCollection& metrics,
+      void*) const override {
+    record(metrics);
+  }
+
+  void OnRequestRetry(
+      const Aws::String&,
+      const Aws::String&,
+      const std::shared_ptr<const Aws::Http::HttpRequest>&,
+      void*) const override {
+    STATS_COUNTER_ADD(vfs_s3_num_retries, 1);
+  }
+
+  void OnFinish(
+      const Aws::String&,
+      const Aws::String&,
+      const std::shared_ptr<const Aws::Http::HttpRequest>&,
+      void*) const override {
+  }
+
+ private:
+  static void record(const Aws::Monitoring::CoreMetricsCollection& metrics) {
+    using Aws::Monitoring::GetHttpClientMetricNameByType;
+    using Aws::Monitoring::HttpClientMetricsType;
+    const auto& m = metrics.httpClientMetrics;
+
+    auto it = m.find(
+        GetHttpClientMetricNameByType(HttpClientMetricsType::ConnectionReused));
+    bool reused;
+    if (it != m.end()) {
+      reused = it->second != 0;
+    } else {
+      reused = true;
+      for (auto type : {HttpClientMetricsType::ConnectLatency,
+                        HttpClientMetricsType::TcpLatency,
+                        HttpClientMetricsType::SslLatency}) {
+        it = m.find(GetHttpClientMetricNameByType(type));
+        if (it != m.end() && it->second > 0)
+          reused = false;
+      }
+    }
+
+    STATS_COUNTER_ADD_IF(reused, vfs_s3_num_reused_connections, 1);
+    STATS_COUNTER_ADD_IF(!reused, vfs_s3_num_new_connections, 1);
+  }
+};
+
+/** Creates the connection reuse monitors of the AWS clients. */
+class ConnectionReuseMonitorFactory
+    : public Aws::Monitoring::MonitoringFactory {
+ public:
+  Aws::UniquePtr<Aws::Monitoring::MonitoringInterface>
+  CreateMonitoringInstance() const override {
+    return Aws::MakeUnique<ConnectionReuseMonitor>(
+        constants::s3_allocation_tag.c_str());
+  }
+};
+
+/** The number of recent GET latencies the hedging percentile is over. */
+const uint64_t hedge_latency_num = 1000;
+
+/** The minimum number of recorded GET latencies for reads to be hedged. */
+const uint64_t hedge_min_latency_num = 20;
+
+/**
+ * The state shared by the GETs of a hedged read. It outlives the read if
+ * a GET is still running when the read returns.
+ */
+struct HedgedReadState {
+  /** Constructor. */
+  HedgedReadState(void* buffer, uint64_t length)
+      : buffer_((char*)buffer)
+      , length_(length)
+      , done_(false)
+      , succeeded_(false)
+      , pending_(0)
+      , status_(Status::Ok()) {
+  }
+
+  /** The buffer of the read. */
+  char* buffer_;
+  /** The number of bytes to read. */
+  uint64_t length_;
+  /** Set once a GET succeeded or the read returned. */
+  bool done_;
+  /** Set if a GET succeeded. */
+  bool succeeded_;
+  /** The number of running GETs. */
+  unsigned pending_;
+  /** The error of the last failed GET. */
+  Status status_;
+  /** The stream buffers of the GETs. */
+  std::vector<std::unique_ptr<std::streambuf>> streambufs_;
+  /** Protects the state and the writes to `buffer_`. */
+  std::mutex mtx_;
+  /** Notified when a GET completes. */
+  std::condition_variable cv_;
+};
+
+/**
+ * Writes the bytes of a GET of a hedged read to the buffer of the read.
+ * The GETs read the same bytes, so they may write the buffer in turn, but
+ * the writes fail once the read is done, which aborts the other GET.
+ */
+class HedgedReadStreamBuf : public std::streambuf {
+ public:
+  /** Constructor. */
+  explicit HedgedReadStreamBuf(HedgedReadState* state)
+      : state_(state)
+      , pos_(0) {
+  }
+
+ protected:
+  std::streamsize xsputn(const char* s, std::streamsize n) override {
+    std::lock_guard<std::mutex> lock(state_->mtx_);
+    if (state_->done_)
+      return 0;
+    auto nbytes = std::min((uint64_t)n, state_->length_ - pos_);
+    std::memcpy(state_->buffer_ + pos_, s, nbytes);
+    pos_ += nbytes;
+    return (std::streamsize)nbytes;
+  }
+
+  int_type overflow(int_type c) override {
+    if (traits_type::eq_int_type(c, traits_type::eof()))
+      return traits_type::not_eof(c);
+    char ch = traits_type::to_char_type(c);
+    return xsputn(&ch, 1) == 1 ? c : traits_type::eof();
+  }
+
+ private:
+  /** The state of the read. */
+  HedgedReadState* state_;
+  /** The position in the buffer of the next byte. */
+  uint64_t pos_;
+};
+
 }  // namespace
 
 /* ********************************* */
@@ -116,9 +296,16 @@ S3::S3()
     , file_buffer_size_(0)
     , max_parallel_ops_(1)
     , multipart_part_size_(0)
+    , max_buffer_size_(0)
+    , buffered_size_(0)
     , vfs_thread_pool_(nullptr)
     , use_virtual_addressing_(false)
-    , use_multipart_upload_(true) {
+    , use_multipart_upload_(true)
+    , hedge_percentile_(0.0)
+    , hedge_max_ratio_(0.0)
+    , get_latency_pos_(0)
+    , hedge_read_num_(0)
+    , hedged_read_num_(0) {
 }
 
 S3::~S3() {
@@ -146,7 +333,15 @@ Status S3::init(const Config& config, ThreadPool* const thread_pool) {
   options_.loggingOptions.logLevel = aws_log_name_to_level(logging_level);
 
   // Initialize the library once per process.
-  std::call_once(aws_lib_initialized, [this]() { Aws::InitAPI(options_); });
+  std::call_once(aws_lib_initialized, [this]() {
+    auto& monitors =
+        options_.monitoringOptions.customizedMonitoringFactory_create_fn;
+    monitors.emplace_back([]() {
+      return Aws::MakeUnique<ConnectionReuseMonitorFactory>(
+          constants::s3_allocation_tag.c_str());
+    });
+    Aws::InitAPI(options_);
+  });
 
   if (options_.loggingOptions.logLevel != Aws::Utils::Logging::LogLevel::Off) {
     Aws::Utils::Logging::InitializeAWSLogging(
@@ -162,6 +357,9 @@ Status S3::init(const Config& config, ThreadPool* const thread_pool) {
       "vfs.s3.multipart_part_size", &multipart_part_size_, &found));
   assert(found);
   file_buffer_size_ = multipart_part_size_ * max_parallel_ops_;
+  RETURN_NOT_OK(config.get<uint64_t>(
+      "vfs.s3.max_buffer_size", &max_buffer_size_, &found));
+  assert(found);
   region_ = config.get("vfs.s3.region", &found);
   assert(found);
   RETURN_NOT_OK(config.get<bool>(
@@ -172,6 +370,16 @@ Status S3::init(const Config& config, ThreadPool* const thread_pool) {
   assert(found);
   auto s3_endpoint_override = config.get("vfs.s3.endpoint_override", &found);
   assert(found);
+  RETURN_NOT_OK(config.get<double>(
+      "vfs.s3.hedge_percentile", &hedge_percentile_, &found));
+  assert(found);
+  RETURN_NOT_OK(config.get<double>(
+      "vfs.s3.hedge_max_ratio", &hedge_max_ratio_, &found));
+  assert(found);
+  if (hedge_percentile_ > 0.0) {
+    // The reads wait for their GETs, so the GETs need their own threads
+    RETURN_NOT_OK(hedge_thread_pool_.init(2 * max_parallel_ops_));
+  }
 
   client_config_ = std::unique_ptr<Aws::Client::ClientConfiguration>(
       new Aws::Client::ClientConfiguration);
@@ -578,7 +786,8 @@ Status S3::ls(
     const URI& prefix,
     std::vector<std::string>* paths,
     const std::string& delimiter,
-    int max_paths) const {
+    int max_paths,
+    std::vector<uint64_t>* sizes) const {
   RETURN_NOT_OK(init_client());
 
   auto prefix_str = prefix.to_string();
@@ -610,12 +819,16 @@ Status S3::ls(
     for (const auto& object : list_objects_outcome.GetResult().GetContents()) {
       std::string file(object.GetKey().c_str());
       paths->push_back("s3://" + aws_auth + add_front_slash(file));
+      if (sizes != nullptr)
+        sizes->push_back(static_cast<uint64_t>(object.GetSize()));
     }
 
     for (const auto& object :
          list_objects_outcome.GetResult().GetCommonPrefixes()) {
       std::string file(object.GetPrefix().c_str());
       paths->push_back("s3://" + aws_auth + add_front_slash(file));
+      if (sizes != nullptr)
+        sizes->push_back(0);
     }
 
     is_done = !list_objects_outcome.GetResult().GetIsTruncated();
@@ -639,10 +852,84 @@ Status S3::ls(
   return Status::Ok();
 }
 
+Status S3::ls_sharded(
+    const URI& prefix,
+    std::vector<std::string>* paths,
+    const std::function<std::vector<std::string>(
+        const std::string&, uint64_t)>& shard_boundaries,
+    const std::string& delimiter) const {
+  STATS_FUNC_IN(vfs_s3_ls_sharded);
+
+  RETURN_NOT_OK(init_client());
+
+  auto prefix_str = prefix.to_string();
+  if (!prefix.is_s3()) {
+    return LOG_STATUS(
+        Status::S3Error(std::string("URI is not an S3 URI: " + prefix_str)));
+  }
+
+  Aws::Http::URI aws_uri = prefix_str.c_str();
+  auto aws_prefix = remove_front_slash(aws_uri.GetPath().c_str());
+  std::string bucket = aws_uri.GetAuthority().c_str();
+
+  // List the first page. Most listings fit in it.
+  std::string marker;
+  RETURN_NOT_OK(
+      ls_range(bucket, aws_prefix, delimiter, "", "", 1, paths, &marker));
+  if (marker.empty())
+    return Status::Ok();
+
+  // Split the rest of the listing into ranges
+  std::vector<std::string> bounds;
+  for (const auto& b :
+       shard_boundaries(marker.substr(aws_prefix.size()), max_parallel_ops_)) {
+    auto key = aws_prefix + b;
+    if (key > (bounds.empty() ? marker : bounds.back()))
+      bounds.push_back(key);
+  }
+  std::vector<std::string> starts = {marker}, ends = bounds;
+  starts.insert(starts.end(), bounds.begin(), bounds.end());
+  ends.emplace_back();
+  STATS_COUNTER_ADD(vfs_s3_ls_num_shards, starts.size());
+
+  // List the ranges in parallel
+  std::vector<std::vector<std::string>> shard_paths(starts.size());
+  std::vector<std::future<Status>> tasks;
+  for (size_t i = 0; i < starts.size(); ++i) {
+    tasks.push_back(vfs_thread_pool_->enqueue([&, i]() {
+      std::string next_marker;
+      return ls_range(
+          bucket,
+          aws_prefix,
+          delimiter,
+          starts[i],
+          ends[i],
+          0,
+          &shard_paths[i],
+          &next_marker);
+    }));
+  }
+  RETURN_NOT_OK(vfs_thread_pool_->wait_all(tasks));
+
+  for (auto& sp : shard_paths)
+    paths->insert(paths->end(), sp.begin(), sp.end());
+
+  // A boundary that falls inside a common prefix makes the two adjacent
+  // ranges both report it.
+  std::sort(paths->begin(), paths->end());
+  paths->erase(std::unique(paths->begin(), paths->end()), paths->end());
+
+  return Status::Ok();
+
+  STATS_FUNC_OUT(vfs_s3_ls_sharded);
+}
+
 Status S3::move_object(const URI& old_uri, const URI& new_uri) {
   RETURN_NOT_OK(init_client());
 
-  RETURN_NOT_OK(copy_object(old_uri, new_uri));
+  uint64_t nbytes;
+  RETURN_NOT_OK(object_size(old_uri, &nbytes));
+  RETURN_NOT_OK(copy_object(old_uri, new_uri, nbytes));
   RETURN_NOT_OK(remove_object(old_uri));
   return Status::Ok();
 }
@@ -651,14 +938,24 @@ Status S3::move_dir(const URI& old_uri, const URI& new_uri) {
   RETURN_NOT_OK(init_client());
 
   std::vector<std::string> paths;
-  RETURN_NOT_OK(ls(old_uri, &paths, ""));
-  for (const auto& path : paths) {
-    auto suffix = path.substr(old_uri.to_string().size());
-    auto new_path = new_uri.join_path(suffix);
-    RETURN_NOT_OK(move_object(URI(path), URI(new_path)));
+  std::vector<uint64_t> sizes;
+  RETURN_NOT_OK(ls(old_uri, &paths, "", -1, &sizes));
+
+  // Copy all objects in parallel. The old objects are deleted only if all
+  // copies succeeded, so that a failed move loses no data.
+  auto old_uri_len = old_uri.to_string().size();
+  std::vector<std::future<Status>> tasks;
+  tasks.reserve(paths.size());
+  for (size_t i = 0; i < paths.size(); ++i) {
+    tasks.push_back(vfs_thread_pool_->enqueue([&, i]() {
+      auto suffix = paths[i].substr(old_uri_len);
+      return copy_object(
+          URI(paths[i]), URI(new_uri.join_path(suffix)), sizes[i]);
+    }));
   }
+  RETURN_NOT_OK(vfs_thread_pool_->wait_all(tasks));
 
-  return Status::Ok();
+  return remove_objects(paths);
 }
 
 Status S3::object_size(const URI& uri, uint64_t* nbytes) const {
@@ -699,29 +996,18 @@ Status S3::read(
         std::string("URI is not an S3 URI: " + uri.to_string())));
   }
 
-  Aws::Http::URI aws_uri = uri.c_str();
-  Aws::S3::Model::GetObjectRequest get_object_request;
-  get_object_request.WithBucket(aws_uri.GetAuthority())
-      .WithKey(aws_uri.GetPath());
-  get_object_request.SetRange(("bytes=" + std::to_string(offset) + "-" +
-                               std::to_string(offset + length - 1))
-                                  .c_str());
-  get_object_request.SetResponseStreamFactory([buffer, length]() {
-    auto streamBuf = new boost::interprocess::bufferbuf((char*)buffer, length);
-    return Aws::New<Aws::IOStream>(
-        constants::s3_allocation_tag.c_str(), streamBuf);
-  });
+  if (hedge_percentile_ > 0.0)
+    return read_hedged(uri, offset, buffer, length);
 
-  auto get_object_outcome = client_->GetObject(get_object_request);
-  if (!get_object_outcome.IsSuccess()) {
-    return LOG_STATUS(Status::S3Error(
-        std::string("Failed to read S3 object ") + uri.c_str() +
-        outcome_error_message(get_object_outcome)));
-  }
-  if ((uint64_t)get_object_outcome.GetResult().GetContentLength() != length) {
-    return LOG_STATUS(Status::S3Error(
-        std::string("Read operation returned different size of bytes.")));
-  }
+  auto st =
+      get_object_range(client_, uri, offset, length, [buffer, length]() {
+        auto streamBuf =
+            new boost::interprocess::bufferbuf((char*)buffer, length);
+        return Aws::New<Aws::IOStream>(
+            constants::s3_allocation_tag.c_str(), streamBuf);
+      });
+  if (!st.ok())
+    return LOG_STATUS(st);
 
   return Status::Ok();
 }
@@ -757,9 +1043,16 @@ Status S3::remove_dir(const URI& uri) const {
   std::vector<std::string> paths;
   auto uri_dir = uri.add_trailing_slash();
   RETURN_NOT_OK(ls(uri_dir, &paths, ""));
-  for (const auto& p : paths)
-    RETURN_NOT_OK(remove_object(URI(p)));
-  return Status::Ok();
+  return remove_objects(paths);
+}
+
+Status S3::remove_dirs(const std::vector<URI>& prefixes) const {
+  RETURN_NOT_OK(init_client());
+
+  std::vector<std::string> paths;
+  for (const auto& prefix : prefixes)
+    RETURN_NOT_OK(ls(prefix.add_trailing_slash(), &paths, ""));
+  return remove_objects(paths);
 }
 
 Status S3::touch(const URI& uri) const {
@@ -796,6 +1089,38 @@ Status S3::touch(const URI& uri) const {
   return Status::Ok();
 }
 
+Status S3::warm_up(const URI& uri) const {
+  RETURN_NOT_OK(init_client());
+
+  if (!uri.is_s3())
+    return LOG_STATUS(Status::S3Error(
+        std::string("URI is not an S3 URI: " + uri.to_string())));
+
+  // Issue one request per parallel operation at the same time, so that the
+  // client has to open that many connections and keeps them pooled.
+  Aws::Http::URI aws_uri = uri.c_str();
+  auto bucket = aws_uri.GetAuthority();
+  std::vector<std::future<Status>> tasks;
+  for (uint64_t i = 0; i < max_parallel_ops_; ++i) {
+    tasks.push_back(vfs_thread_pool_->enqueue([this, &bucket]() {
+      Aws::S3::Model::HeadBucketRequest head_bucket_request;
+      head_bucket_request.SetBucket(bucket);
+      auto head_bucket_outcome = client_->HeadBucket(head_bucket_request);
+      if (!head_bucket_outcome.IsSuccess())
+        return LOG_STATUS(Status::S3Error(
+            std::string("Cannot warm up connections to bucket '") +
+            bucket.c_str() + outcome_error_message(head_bucket_outcome)));
+      return Status::Ok();
+    }));
+  }
+
+  return vfs_thread_pool_->wait_all(tasks);
+}
+
+uint64_t S3::buffered_size() const {
+  return buffered_size_;
+}
+
 Status S3::write(const URI& uri, const void* buffer, uint64_t length) {
   RETURN_NOT_OK(init_client());
 
@@ -847,6 +1172,11 @@ Status S3::write(const URI& uri, const void* buffer, uint64_t length) {
       }
     }
     assert(offset == length);
+
+    // Upload the whole parts of this object early if the buffers of all
+    // objects exceed their cap
+    if (max_buffer_size_ > 0 && buffered_size_ > max_buffer_size_)
+      RETURN_NOT_OK(flush_file_buffer_parts(uri, buff));
   }
 
   return Status::Ok();
@@ -882,9 +1212,144 @@ Status S3::init_client() const {
   return Status::Ok();
 }
 
-Status S3::copy_object(const URI& old_uri, const URI& new_uri) {
+Status S3::get_object_range(
+    const std::shared_ptr<Aws::S3::S3Client>& client,
+    const URI& uri,
+    off_t offset,
+    uint64_t length,
+    const Aws::IOStreamFactory& stream_factory) const {
+  Aws::Http::URI aws_uri = uri.c_str();
+  Aws::S3::Model::GetObjectRequest get_object_request;
+  get_object_request.WithBucket(aws_uri.GetAuthority())
+      .WithKey(aws_uri.GetPath());
+  get_object_request.SetRange(("bytes=" + std::to_string(offset) + "-" +
+                               std::to_string(offset + length - 1))
+                                  .c_str());
+  get_object_request.SetResponseStreamFactory(stream_factory);
+
+  auto get_object_outcome = client->GetObject(get_object_request);
+  if (!get_object_outcome.IsSuccess()) {
+    return Status::S3Error(
+        std::string("Failed to read S3 object ") + uri.c_str() +
+        outcome_error_message(get_object_outcome));
+  }
+  if ((uint64_t)get_object_outcome.GetResult().GetContentLength() != length) {
+    return Status::S3Error(
+        std::string("Read operation returned different size of bytes."));
+  }
+
+  return Status::Ok();
+}
+
+Status S3::read_hedged(
+    const URI& uri, off_t offset, void* buffer, uint64_t length) const {
+  auto state = std::make_shared<HedgedReadState>(buffer, length);
+  auto client = client_;
+
+  // Runs a GET on the hedging thread pool; the first to succeed wins. The
+  // caller must hold the lock of the state.
+  auto launch_get = [&]() {
+    auto streambuf = new HedgedReadStreamBuf(state.get());
+    state->streambufs_.emplace_back(streambuf);
+    auto task = hedge_thread_pool_.enqueue(
+        [this, client, uri, offset, length, state, streambuf]() {
+          auto start = std::chrono::steady_clock::now();
+          auto st = get_object_range(
+              client, uri, offset, length, [streambuf]() {
+                return Aws::New<Aws::IOStream>(
+                    constants::s3_allocation_tag.c_str(), streambuf);
+              });
+          if (st.ok()) {
+            record_get_latency(
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start)
+                    .count());
+          }
+
+          std::lock_guard<std::mutex> lock(state->mtx_);
+          --state->pending_;
+          if (st.ok() && !state->done_) {
+            state->done_ = true;
+            state->succeeded_ = true;
+          } else if (!st.ok()) {
+            state->status_ = st;
+          }
+          state->cv_.notify_all();
+          return Status::Ok();
+        });
+    if (!task.valid())
+      return Status::S3Error("Cannot read S3 object; Failed to enqueue GET");
+    ++state->pending_;
+    return Status::Ok();
+  };
+
+  auto delay_us = hedge_delay_us();
+  auto finished = [&state]() { return state->done_ || state->pending_ == 0; };
+  std::unique_lock<std::mutex> lck(state->mtx_);
+  auto st = launch_get();
+  if (!st.ok())
+    return LOG_STATUS(st);
+
+  // Duplicate a GET slower than the recent ones, within the budget
+  if (delay_us != UINT64_MAX &&
+      !state->cv_.wait_for(
+          lck, std::chrono::microseconds(delay_us), finished) &&
+      hedge_allowed()) {
+    STATS_COUNTER_ADD(vfs_s3_num_hedged_reads, 1);
+    st = launch_get();
+    if (!st.ok())
+      LOG_STATUS(st);
+  }
+
+  state->cv_.wait(lck, finished);
+  state->done_ = true;
+  if (!state->succeeded_)
+    return LOG_STATUS(state->status_);
+
+  return Status::Ok();
+}
+
+uint64_t S3::hedge_delay_us() const {
+  std::vector<uint64_t> latencies;
+  {
+    std::lock_guard<std::mutex> lock(hedge_mtx_);
+    ++hedge_read_num_;
+    if (get_latencies_.size() < hedge_min_latency_num)
+      return UINT64_MAX;
+    latencies = get_latencies_;
+  }
+
+  auto pos = (size_t)(hedge_percentile_ / 100.0 * (latencies.size() - 1));
+  std::nth_element(
+      latencies.begin(), latencies.begin() + pos, latencies.end());
+  return latencies[pos];
+}
+
+bool S3::hedge_allowed() const {
+  std::lock_guard<std::mutex> lock(hedge_mtx_);
+  if (hedged_read_num_ + 1 > hedge_max_ratio_ * hedge_read_num_)
+    return false;
+  ++hedged_read_num_;
+  return true;
+}
+
+void S3::record_get_latency(uint64_t latency_us) const {
+  std::lock_guard<std::mutex> lock(hedge_mtx_);
+  if (get_latencies_.size() < hedge_latency_num)
+    get_latencies_.push_back(latency_us);
+  else
+    get_latencies_[get_latency_pos_] = latency_us;
+  get_latency_pos_ = (get_latency_pos_ + 1) % hedge_latency_num;
+}
+
+Status S3::copy_object(
+    const URI& old_uri, const URI& new_uri, uint64_t nbytes) {
   RETURN_NOT_OK(init_client());
 
+  // A single copy request is limited to 5GB
+  if (nbytes > constants::s3_max_copy_object_size)
+    return copy_object_multipart(old_uri, new_uri, nbytes);
+
   Aws::Http::URI src_uri = old_uri.c_str();
   Aws::Http::URI dst_uri = new_uri.c_str();
   Aws::S3::Model::CopyObjectRequest copy_object_request;
@@ -908,6 +1373,91 @@ Status S3::copy_object(const URI& old_uri, const URI& new_uri) {
   return Status::Ok();
 }
 
+Status S3::copy_object_multipart(
+    const URI& old_uri, const URI& new_uri, uint64_t nbytes) {
+  RETURN_NOT_OK(init_client());
+
+  Aws::Http::URI src_uri = old_uri.c_str();
+  Aws::Http::URI dst_uri = new_uri.c_str();
+  auto copy_source = join_authority_and_path(
+      src_uri.GetAuthority().c_str(), src_uri.GetPath().c_str());
+
+  Aws::S3::Model::CreateMultipartUploadRequest multipart_upload_request;
+  multipart_upload_request.SetBucket(dst_uri.GetAuthority());
+  multipart_upload_request.SetKey(dst_uri.GetPath());
+  multipart_upload_request.SetContentType("application/octet-stream");
+  auto multipart_upload_outcome =
+      client_->CreateMultipartUpload(multipart_upload_request);
+  if (!multipart_upload_outcome.IsSuccess())
+    return LOG_STATUS(Status::S3Error(
+        std::string("Failed to create multipart copy request for object '") +
+        new_uri.c_str() + "'" +
+        outcome_error_message(multipart_upload_outcome)));
+
+  MultiPartUploadState state(
+      1,
+      Aws::String(dst_uri.GetAuthority()),
+      Aws::String(dst_uri.GetPath()),
+      Aws::String(multipart_upload_outcome.GetResult().GetUploadId()),
+      std::map<int, Aws::S3::Model::CompletedPart>());
+
+  // Copy the parts in parallel
+  uint64_t part_num = utils::math::ceil(nbytes, constants::s3_copy_part_size);
+  std::vector<Aws::S3::Model::CompletedPart> parts(part_num);
+  std::vector<std::future<Status>> tasks;
+  tasks.reserve(part_num);
+  for (uint64_t p = 0; p < part_num; ++p) {
+    tasks.push_back(vfs_thread_pool_->enqueue([&, p]() {
+      auto start = p * constants::s3_copy_part_size;
+      auto end = std::min(start + constants::s3_copy_part_size, nbytes) - 1;
+      Aws::S3::Model::UploadPartCopyRequest upload_part_copy_request;
+      upload_part_copy_request.SetBucket(state.bucket);
+      upload_part_copy_request.SetKey(state.key);
+      upload_part_copy_request.SetUploadId(state.upload_id);
+      upload_part_copy_request.SetPartNumber(static_cast<int>(p + 1));
+      upload_part_copy_request.SetCopySource(copy_source.c_str());
+      upload_part_copy_request.SetCopySourceRange(
+          ("bytes=" + std::to_string(start) + "-" + std::to_string(end))
+              .c_str());
+
+      auto upload_part_copy_outcome =
+          client_->UploadPartCopy(upload_part_copy_request);
+      if (!upload_part_copy_outcome.IsSuccess())
+        return LOG_STATUS(Status::S3Error(
+            std::string("Failed to copy part ") + std::to_string(p + 1) +
+            " of S3 object " + old_uri.c_str() + " to " + new_uri.c_str() +
+            outcome_error_message(upload_part_copy_outcome)));
+
+      parts[p].SetETag(upload_part_copy_outcome.GetResult()
+                           .GetCopyPartResult()
+                           .GetETag());
+      parts[p].SetPartNumber(static_cast<int>(p + 1));
+      STATS_COUNTER_ADD(vfs_s3_num_part_copies, 1);
+      return Status::Ok();
+    }));
+  }
+  state.st = vfs_thread_pool_->wait_all(tasks);
+
+  if (!state.st.ok()) {
+    client_->AbortMultipartUpload(make_multipart_abort_request(state));
+    return state.st;
+  }
+
+  for (uint64_t p = 0; p < part_num; ++p)
+    state.completed_parts.emplace(static_cast<int>(p + 1), parts[p]);
+  auto outcome =
+      client_->CompleteMultipartUpload(make_multipart_complete_request(state));
+  if (!outcome.IsSuccess())
+    return LOG_STATUS(Status::S3Error(
+        std::string("Failed to complete multipart copy of S3 object ") +
+        old_uri.c_str() + " to " + new_uri.c_str() +
+        outcome_error_message(outcome)));
+
+  wait_for_object_to_propagate(state.bucket, state.key);
+
+  return Status::Ok();
+}
+
 Status S3::fill_file_buffer(
     Buffer* buff,
     const void* buffer,
@@ -916,8 +1466,11 @@ Status S3::fill_file_buffer(
   STATS_FUNC_IN(vfs_s3_fill_file_buffer);
 
   *nbytes_filled = std::min(file_buffer_size_ - buff->size(), length);
-  if (*nbytes_filled > 0)
+  if (*nbytes_filled > 0) {
     RETURN_NOT_OK(buff->write(buffer, *nbytes_filled));
+    if (use_multipart_upload_)
+      buffered_size_ += *nbytes_filled;
+  }
 
   return Status::Ok();
 
@@ -934,11 +1487,132 @@ std::string S3::remove_front_slash(const std::string& path) const {
   return path;
 }
 
+Status S3::ls_range(
+    const std::string& bucket,
+    const std::string& aws_prefix,
+    const std::string& delimiter,
+    const std::string& start,
+    const std::string& end,
+    uint64_t max_pages,
+    std::vector<std::string>* paths,
+    std::string* next_marker) const {
+  Aws::S3::Model::ListObjectsRequest list_objects_request;
+  list_objects_request.SetBucket(bucket.c_str());
+  list_objects_request.SetPrefix(aws_prefix.c_str());
+  list_objects_request.SetDelimiter(delimiter.c_str());
+  if (!start.empty())
+    list_objects_request.SetMarker(start.c_str());
+
+  // Appends `key` to the paths, returning false if it is past the range
+  auto add = [&](const Aws::String& key) {
+    if (!end.empty() && key.c_str() > end)
+      return false;
+    paths->push_back("s3://" + bucket + add_front_slash(key.c_str()));
+    return true;
+  };
+
+  next_marker->clear();
+  std::string last_marker;
+  for (uint64_t page = 0; max_pages == 0 || page < max_pages; ++page) {
+    auto list_objects_outcome = client_->ListObjects(list_objects_request);
+    if (!list_objects_outcome.IsSuccess())
+      return LOG_STATUS(Status::S3Error(
+          std::string("Error while listing with prefix 's3://") + bucket +
+          add_front_slash(aws_prefix) + "' and delimiter '" + delimiter +
+          "'" + outcome_error_message(list_objects_outcome)));
+
+    const auto& result = list_objects_outcome.GetResult();
+    bool in_range = true;
+    for (const auto& object : result.GetContents())
+      in_range = add(object.GetKey()) && in_range;
+    for (const auto& object : result.GetCommonPrefixes())
+      in_range = add(object.GetPrefix()) && in_range;
+    if (!in_range || !result.GetIsTruncated())
+      return Status::Ok();
+
+    // See `ls` for how the next marker is determined
+    Aws::String marker = !delimiter.empty() ?
+                             result.GetNextMarker() :
+                             result.GetContents().back().GetKey();
+    if (!end.empty() && marker.c_str() >= end)
+      return Status::Ok();
+    last_marker = marker.c_str();
+    list_objects_request.SetMarker(std::move(marker));
+  }
+
+  *next_marker = last_marker;
+  return Status::Ok();
+}
+
+Status S3::remove_objects(const std::vector<std::string>& paths) const {
+  STATS_FUNC_IN(vfs_s3_remove_objects);
+
+  RETURN_NOT_OK(init_client());
+
+  // Group the keys by bucket
+  std::map<std::string, std::vector<std::string>> bucket_keys;
+  for (const auto& p : paths) {
+    Aws::Http::URI aws_uri = p.c_str();
+    bucket_keys[aws_uri.GetAuthority().c_str()].push_back(
+        remove_front_slash(aws_uri.GetPath().c_str()));
+  }
+
+  // Issue one multi-object delete per batch of keys
+  std::vector<std::future<Status>> tasks;
+  for (const auto& bk : bucket_keys) {
+    const auto& bucket = bk.first;
+    const auto& keys = bk.second;
+    for (uint64_t start = 0; start < keys.size();
+         start += constants::s3_max_delete_objects) {
+      auto end = std::min<uint64_t>(
+          start + constants::s3_max_delete_objects, keys.size());
+      auto task = [this, &bucket, &keys, start, end]() {
+        Aws::S3::Model::Delete objects;
+        objects.SetQuiet(true);
+        for (auto k = start; k < end; ++k)
+          objects.AddObjects(
+              Aws::S3::Model::ObjectIdentifier().WithKey(keys[k].c_str()));
+
+        Aws::S3::Model::DeleteObjectsRequest delete_objects_request;
+        delete_objects_request.SetBucket(bucket.c_str());
+        delete_objects_request.SetDelete(objects);
+        auto delete_objects_outcome =
+            client_->DeleteObjects(delete_objects_request);
+        if (!delete_objects_outcome.IsSuccess())
+          return LOG_STATUS(Status::S3Error(
+              std::string("Failed to delete S3 objects from bucket '") +
+              bucket + "'" + outcome_error_message(delete_objects_outcome)));
+
+        // In quiet mode, only the keys that failed are returned
+        const auto& errors = delete_objects_outcome.GetResult().GetErrors();
+        if (!errors.empty())
+          return LOG_STATUS(Status::S3Error(
+              std::string("Failed to delete S3 object 's3://") + bucket + "/" +
+              errors.front().GetKey().c_str() + "'\nError message:  " +
+              errors.front().GetMessage().c_str()));
+        STATS_COUNTER_ADD(vfs_s3_num_delete_batches, 1);
+
+        // Waiting on every key would double the number of requests, so only
+        // the last key of the batch is checked for propagation.
+        wait_for_object_to_be_deleted(
+            delete_objects_request.GetBucket(), keys[end - 1].c_str());
+        return Status::Ok();
+      };
+      tasks.push_back(vfs_thread_pool_->enqueue(std::move(task)));
+    }
+  }
+
+  return vfs_thread_pool_->wait_all(tasks);
+
+  STATS_FUNC_OUT(vfs_s3_remove_objects);
+}
+
 Status S3::flush_file_buffer(const URI& uri, Buffer* buff, bool last_part) {
   RETURN_NOT_OK(init_client());
   if (buff->size() > 0) {
     const Status st =
         write_multipart(uri, buff->data(), buff->size(), last_part);
+    buffered_size_ -= buff->size();
     buff->reset_size();
     RETURN_NOT_OK(st);
   }
@@ -946,6 +1620,22 @@ Status S3::flush_file_buffer(const URI& uri, Buffer* buff, bool last_part) {
   return Status::Ok();
 }
 
+Status S3::flush_file_buffer_parts(const URI& uri, Buffer* buff) {
+  auto nbytes = buff->size() / multipart_part_size_ * multipart_part_size_;
+  if (nbytes == 0)
+    return Status::Ok();
+
+  RETURN_NOT_OK(write_multipart(uri, buff->data(), nbytes, false));
+  STATS_COUNTER_ADD(vfs_s3_num_buffer_cap_flushes, 1);
+
+  // Keep only the remaining bytes, releasing the memory of the parts
+  Buffer rest;
+  auto rest_size = buff->size() - nbytes;
+  RETURN_NOT_OK(rest.write((char*)buff->data() + nbytes, rest_size));
+  buffered_size_ -= nbytes;
+  return buff->swap(rest);
+}
+
 Status S3::get_file_buffer(const URI& uri, Buffer** buff) {
   std::unique_lock<std::mutex> lck(multipart_upload_mtx_);
 
@@ -60,6 +60,7 @@
 #include <aws/s3/model/CreateBucketRequest.h>
 #include <aws/s3/model/DeleteBucketRequest.h>
 #include <aws/s3/model/DeleteObjectRequest.h>
+#include <aws/s3/model/DeleteObjectsRequest.h>
 #include <aws/s3/model/GetBucketLocationRequest.h>
 #include <aws/s3/model/GetObjectRequest.h>
 #include <aws/s3/model/HeadBucketRequest.h>
@@ -68,6 +69,8 @@
 #include <aws/s3/model/PutObjectRequest.h>
 #include <aws/s3/model/UploadPartRequest.h>
 #include <sys/types.h>
+#include <atomic>
+#include <functional>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -190,13 +193,39 @@ class S3 {
    * @param delimiter The delimiter that will
    * @param max_paths The maximum number of paths to be retrieved. The default
    *     `-1` indicates that no upper bound is specified.
+   * @param sizes If not `nullptr`, the size of each retrieved path is
+   *     appended to it (`0` for the common prefixes).
    * @return Status
    */
   Status ls(
       const URI& prefix,
       std::vector<std::string>* paths,
       const std::string& delimiter = "/",
-      int max_paths = -1) const;
+      int max_paths = -1,
+      std::vector<uint64_t>* sizes = nullptr) const;
+
+  /**
+   * Lists the objects that start with `prefix`, like `ls`, but splits the
+   * listing into key ranges that are listed concurrently. The first page is
+   * listed serially. If the listing is incomplete, `shard_boundaries` is
+   * called with the last listed name (relative to `prefix`) and the
+   * requested number of shards, and must return sorted names greater than
+   * it. Each boundary closes one range and starts the next. The results are
+   * returned in no particular order.
+   *
+   * @param prefix The prefix URI.
+   * @param paths Pointer of a vector of URIs to store the retrieved paths.
+   * @param shard_boundaries Returns the shard boundaries for the listing
+   *     remaining after a given name.
+   * @param delimiter The delimiter that will
+   * @return Status
+   */
+  Status ls_sharded(
+      const URI& prefix,
+      std::vector<std::string>* paths,
+      const std::function<std::vector<std::string>(
+          const std::string&, uint64_t)>& shard_boundaries,
+      const std::string& delimiter = "/") const;
 
   /**
    * Renames an object.
@@ -211,7 +240,9 @@ class S3 {
    * Renames a directory. Note that this is an expensive operation.
    * The function will essentially copy all objects with directory
    * prefix `old_uri` to new objects with prefix `new_uri` and then
-   * delete the old ones.
+   * delete the old ones. The objects are copied in parallel on the VFS
+   * thread pool, and the old ones are deleted with batched multi-object
+   * delete requests only once all copies succeeded.
    *
    * @param old_uri The URI of the old path.
    * @param new_uri The URI of the new path.
@@ -282,6 +313,16 @@ class S3 {
    */
   Status remove_dir(const URI& prefix) const;
 
+  /**
+   * Deletes all objects under each of the given prefixes, as in
+   * `remove_dir`. The objects of all prefixes are deleted together with
+   * batched multi-object delete requests, issued in parallel.
+   *
+   * @param prefixes The prefixes of the objects to be deleted.
+   * @return Status
+   */
+  Status remove_dirs(const std::vector<URI>& prefixes) const;
+
   /**
    * Creates an empty object.
    *
@@ -290,6 +331,23 @@ class S3 {
    */
   Status touch(const URI& uri) const;
 
+  /**
+   * Initializes the client and pre-opens `max_parallel_ops_` connections
+   * to the bucket of the input URI, by issuing that many concurrent
+   * HeadBucket requests. The connections then stay in the client pool and
+   * are reused by subsequent requests.
+   *
+   * @param uri A URI in the bucket to connect to.
+   * @return Status
+   */
+  Status warm_up(const URI& uri) const;
+
+  /**
+   * Returns the number of bytes buffered across all the multipart uploads,
+   * i.e., written but not flushed yet.
+   */
+  uint64_t buffered_size() const;
+
   /**
    * Writes the input buffer to an S3 object. Note that this is essentially
    * an append operation implemented via multipart uploads.
@@ -415,6 +473,15 @@ class S3 {
   /** The length of a non-terminal multipart part. */
   uint64_t multipart_part_size_;
 
+  /**
+   * The maximum number of bytes buffered across all the multipart uploads
+   * (`0` for no limit).
+   */
+  uint64_t max_buffer_size_;
+
+  /** The number of bytes buffered across all the multipart uploads. */
+  std::atomic<uint64_t> buffered_size_;
+
   /** File buffers used in the multi-part uploads. */
   std::unordered_map<std::string, Buffer*> file_buffers_;
 
@@ -430,6 +497,37 @@ class S3 {
   /** Whether or not to use multipart upload. */
   bool use_multipart_upload_;
 
+  /**
+   * The percentile of the latencies of the recent GETs after which a read
+   * issues a duplicate GET (`0` if hedging is disabled).
+   */
+  double hedge_percentile_;
+
+  /** The maximum ratio of the reads that issue a duplicate GET. */
+  double hedge_max_ratio_;
+
+  /** The latencies in microseconds of the recent GETs (a ring buffer). */
+  mutable std::vector<uint64_t> get_latencies_;
+
+  /** The position in `get_latencies_` of the next latency. */
+  mutable uint64_t get_latency_pos_;
+
+  /** The number of reads since hedging was enabled. */
+  mutable uint64_t hedge_read_num_;
+
+  /** The number of reads that issued a duplicate GET. */
+  mutable uint64_t hedged_read_num_;
+
+  /** Protects the hedging state. */
+  mutable std::mutex hedge_mtx_;
+
+  /**
+   * The thread pool running the GETs of the reads if hedging is enabled,
+   * so that the reads can wait for the first of two GETs. It is destroyed
+   * before the client, which the GETs still running use.
+   */
+  mutable ThreadPool hedge_thread_pool_;
+
   /* ********************************* */
   /*          PRIVATE METHODS          */
   /* ********************************* */
@@ -442,13 +540,75 @@ class S3 {
   Status init_client() const;
 
   /**
-   * Copies an object.
+   * Reads a range of an object with a single GET, writing the bytes to the
+   * streams created by `stream_factory`. The errors are not logged.
+   *
+   * @param client The S3 client.
+   * @param uri The URI of the object to be read.
+   * @param offset The offset where the read begins.
+   * @param length The number of bytes to read.
+   * @param stream_factory Creates the stream the GET writes to.
+   * @return Status
+   */
+  Status get_object_range(
+      const std::shared_ptr<Aws::S3::S3Client>& client,
+      const URI& uri,
+      off_t offset,
+      uint64_t length,
+      const Aws::IOStreamFactory& stream_factory) const;
+
+  /**
+   * Reads a range of an object, issuing a duplicate GET if the first has
+   * not completed within the hedging percentile of the recent latencies,
+   * and using the first response.
+   *
+   * @param uri The URI of the object to be read.
+   * @param offset The offset where the read begins.
+   * @param buffer The buffer into which the data will be written.
+   * @param length The size of the data to be read from the object.
+   * @return Status
+   */
+  Status read_hedged(
+      const URI& uri, off_t offset, void* buffer, uint64_t length) const;
+
+  /**
+   * Counts a new read and returns the time in microseconds after which it
+   * is hedged, or `UINT64_MAX` if too few latencies were recorded.
+   */
+  uint64_t hedge_delay_us() const;
+
+  /**
+   * Returns `true` and counts a hedged read if hedging one more read keeps
+   * the ratio of hedged reads under the maximum.
+   */
+  bool hedge_allowed() const;
+
+  /** Records the latency in microseconds of a successful GET. */
+  void record_get_latency(uint64_t latency_us) const;
+
+  /**
+   * Copies an object on the server side. An object larger than
+   * `constants::s3_max_copy_object_size` is copied with a multipart copy.
    *
    * @param old_uri The object to be copied.
    * @param new_uri The newly created object.
+   * @param nbytes The size of the object to be copied.
    * @return Status
    */
-  Status copy_object(const URI& old_uri, const URI& new_uri);
+  Status copy_object(const URI& old_uri, const URI& new_uri, uint64_t nbytes);
+
+  /**
+   * Copies an object on the server side with a multipart upload, whose
+   * parts of `constants::s3_copy_part_size` bytes are copied in parallel on
+   * the VFS thread pool. The upload is aborted if any part fails.
+   *
+   * @param old_uri The object to be copied.
+   * @param new_uri The newly created object.
+   * @param nbytes The size of the object to be copied.
+   * @return Status
+   */
+  Status copy_object_multipart(
+      const URI& old_uri, const URI& new_uri, uint64_t nbytes);
 
   /**
    * Fills the file buffer (given as an input `Buffer` object) from the
@@ -479,6 +639,43 @@ class S3 {
    */
   std::string remove_front_slash(const std::string& path) const;
 
+  /**
+   * Lists the objects with the given key prefix that are greater than
+   * `start` and not greater than `end`.
+   *
+   * @param bucket The bucket to list.
+   * @param aws_prefix The key prefix.
+   * @param delimiter The delimiter.
+   * @param start The listing starts after this key. If empty, the listing
+   *     starts from the first key.
+   * @param end The last key to list. If empty, there is no upper bound.
+   * @param max_pages The maximum number of result pages to fetch, or 0 for
+   *     no limit.
+   * @param paths The listed paths are appended here.
+   * @param next_marker Set to the key after which the listing has to
+   *     continue, or to the empty string if the range is exhausted.
+   * @return Status
+   */
+  Status ls_range(
+      const std::string& bucket,
+      const std::string& aws_prefix,
+      const std::string& delimiter,
+      const std::string& start,
+      const std::string& end,
+      uint64_t max_pages,
+      std::vector<std::string>* paths,
+      std::string* next_marker) const;
+
+  /**
+   * Deletes the given objects. The objects are grouped by bucket into
+   * multi-object delete requests of up to `constants::s3_max_delete_objects`
+   * keys, which are issued in parallel on the VFS thread pool.
+   *
+   * @param paths The full URIs of the objects to be deleted.
+   * @return Status
+   */
+  Status remove_objects(const std::vector<std::string>& paths) const;
+
   /**
    * Writes the contents of the input buffer to the S3 object given by
    * the input `uri` as a new series of multipart uploads. It then
@@ -492,6 +689,17 @@ class S3 {
    */
   Status flush_file_buffer(const URI& uri, Buffer* buff, bool last_part);
 
+  /**
+   * Uploads the whole multipart parts of the input buffer of the S3 object
+   * given by the input `uri`, keeping the remaining bytes in a buffer that
+   * is reallocated to their size.
+   *
+   * @param uri The S3 object to write to.
+   * @param buff The input buffer to flush.
+   * @return Status
+   */
+  Status flush_file_buffer_parts(const URI& uri, Buffer* buff);
+
   /**
    * Gets the local file buffer of an S3 object with a given URI.
    *
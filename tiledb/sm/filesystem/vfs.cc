@@ -35,13 +35,17 @@
 #include "tiledb/sm/enums/filesystem.h"
 #include "tiledb/sm/enums/vfs_mode.h"
 #include "tiledb/sm/filesystem/hdfs_filesystem.h"
+#include "tiledb/sm/global_state/global_state.h"
+#include "tiledb/sm/misc/constants.h"
 #include "tiledb/sm/misc/logger.h"
 #include "tiledb/sm/misc/parallel_functions.h"
 #include "tiledb/sm/misc/stats.h"
 #include "tiledb/sm/misc/utils.h"
 
+#include <chrono>
 #include <iostream>
 #include <list>
+#include <thread>
 #include <unordered_map>
 
 namespace tiledb {
@@ -76,6 +80,8 @@ VFS::VFS() {
 #endif
 
   init_ = false;
+  emulated_latency_ms_ = 0;
+  emulated_bandwidth_ = 0;
 
   STATS_FUNC_VOID_OUT(vfs_constructor);
 }
@@ -231,6 +237,32 @@ Status VFS::touch(const URI& uri) const {
   STATS_FUNC_OUT(vfs_create_file);
 }
 
+Status VFS::warm_up(const URI& uri) const {
+  if (!init_)
+    return LOG_STATUS(
+        Status::VFSError("Cannot warm up connections; VFS not initialized"));
+
+  if (uri.is_s3()) {
+#ifdef HAVE_S3
+    return s3_.warm_up(uri);
+#else
+    return LOG_STATUS(Status::VFSError("TileDB was built without S3 support"));
+#endif
+  }
+  if (uri.is_file() || uri.is_hdfs())
+    return Status::Ok();
+  return LOG_STATUS(Status::VFSError(
+      std::string("Unsupported URI scheme: ") + uri.to_string()));
+}
+
+uint64_t VFS::write_buffer_size() const {
+#ifdef HAVE_S3
+  return s3_.buffered_size();
+#else
+  return 0;
+#endif
+}
+
 Status VFS::cancel_all_tasks() {
   if (!init_)
     return LOG_STATUS(
@@ -366,6 +398,29 @@ Status VFS::remove_dir(const URI& uri) const {
   STATS_FUNC_OUT(vfs_remove_dir);
 }
 
+Status VFS::remove_dirs(const std::vector<URI>& uris) const {
+  if (!init_)
+    return LOG_STATUS(
+        Status::VFSError("Cannot remove directories; VFS not "
+                         "initialized"));
+
+  std::vector<URI> s3_uris;
+  for (const auto& uri : uris) {
+    if (uri.is_s3())
+      s3_uris.push_back(uri);
+    else
+      RETURN_NOT_OK(remove_dir(uri));
+  }
+
+  if (s3_uris.empty())
+    return Status::Ok();
+#ifdef HAVE_S3
+  return s3_.remove_dirs(s3_uris);
+#else
+  return LOG_STATUS(Status::VFSError("TileDB was built without S3 support"));
+#endif
+}
+
 Status VFS::remove_file(const URI& uri) const {
   STATS_FUNC_IN(vfs_remove_file);
 
@@ -555,8 +610,9 @@ Status VFS::max_parallel_ops(const URI& uri, uint64_t* ops) const {
         config_.get<uint64_t>("vfs.file.max_parallel_ops", ops, &found));
     assert(found);
   } else if (uri.is_hdfs()) {
-    // HDFS backend is currently serial.
-    *ops = 1;
+    RETURN_NOT_OK(
+        config_.get<uint64_t>("vfs.hdfs.max_parallel_ops", ops, &found));
+    assert(found);
   } else if (uri.is_s3()) {
     RETURN_NOT_OK(
         config_.get<uint64_t>("vfs.s3.max_parallel_ops", ops, &found));
@@ -575,6 +631,8 @@ Status VFS::file_size(const URI& uri, uint64_t* size) const {
     return LOG_STATUS(
         Status::VFSError("Cannot get file size; VFS not initialized"));
 
+  emulate_request(0);
+
   if (uri.is_file()) {
 #ifdef _WIN32
     return win_.file_size(uri.to_path(), size);
@@ -610,6 +668,8 @@ Status VFS::is_dir(const URI& uri, bool* is_dir) const {
     return LOG_STATUS(
         Status::VFSError("Cannot check directory; VFS not initialized"));
 
+  emulate_request(0);
+
   if (uri.is_file()) {
 #ifdef _WIN32
     *is_dir = win_.is_dir(uri.to_path());
@@ -648,6 +708,8 @@ Status VFS::is_file(const URI& uri, bool* is_file) const {
     return LOG_STATUS(
         Status::VFSError("Cannot check file; VFS not initialized"));
 
+  emulate_request(0);
+
   if (uri.is_file()) {
 #ifdef _WIN32
     *is_file = win_.is_file(uri.to_path());
@@ -716,8 +778,27 @@ Status VFS::init(const Config* ctx_config, const Config* vfs_config) {
   uint64_t nthreads = 0;
   RETURN_NOT_OK(config_.get<uint64_t>("vfs.num_threads", &nthreads, &found));
   assert(found);
+  RETURN_NOT_OK(config_.get<uint64_t>(
+      "vfs.emulated_latency_ms", &emulated_latency_ms_, &found));
+  assert(found);
+  RETURN_NOT_OK(config_.get<uint64_t>(
+      "vfs.emulated_bandwidth", &emulated_bandwidth_, &found));
+  assert(found);
 
-  RETURN_NOT_OK(thread_pool_.init(nthreads));
+  ThreadPool* scheduler = nullptr;
+  RETURN_NOT_OK(global_state::GlobalState::GetGlobalState().scheduler(
+      config_, &scheduler));
+  if (scheduler != nullptr) {
+    RETURN_NOT_OK(thread_pool_.init(scheduler, ThreadPool::Priority::IO));
+  } else {
+    RETURN_NOT_OK(thread_pool_.init(nthreads));
+    bool numa_pinning = false;
+    RETURN_NOT_OK(
+        config_.get<bool>("sm.numa_pinning", &numa_pinning, &found));
+    assert(found);
+    if (numa_pinning)
+      RETURN_NOT_OK(thread_pool_.pin_numa_nodes());
+  }
 
 #ifdef HAVE_HDFS
   hdfs_ = std::unique_ptr<hdfs::HDFS>(new (std::nothrow) hdfs::HDFS());
@@ -747,6 +828,16 @@ Status VFS::init(const Config* ctx_config, const Config* vfs_config) {
 Status VFS::terminate() {
   STATS_FUNC_IN(vfs_terminate);
 
+  // Do not leave flushes running against a destroyed thread pool
+  std::vector<std::string> buffered;
+  {
+    std::unique_lock<std::mutex> lck(write_behind_mtx_);
+    for (const auto& it : write_behind_files_)
+      buffered.push_back(it.first);
+  }
+  for (const auto& uri : buffered)
+    RETURN_NOT_OK(finish_write_behind(URI(uri)));
+
 #ifdef HAVE_S3
   return s3_.disconnect();
 #endif
@@ -762,6 +853,8 @@ Status VFS::ls(const URI& parent, std::vector<URI>* uris) const {
   if (!init_)
     return LOG_STATUS(Status::VFSError("Cannot list; VFS not initialized"));
 
+  emulate_request(0);
+
   std::vector<std::string> paths;
   if (parent.is_file()) {
 #ifdef _WIN32
@@ -795,6 +888,77 @@ Status VFS::ls(const URI& parent, std::vector<URI>* uris) const {
   STATS_FUNC_OUT(vfs_ls);
 }
 
+Status VFS::ls_sharded(
+    const URI& parent,
+    std::vector<URI>* uris,
+    const std::function<std::vector<std::string>(
+        const std::string&, uint64_t)>& shard_boundaries) const {
+  if (!parent.is_s3())
+    return ls(parent, uris);
+
+  if (!init_)
+    return LOG_STATUS(Status::VFSError("Cannot list; VFS not initialized"));
+
+#ifdef HAVE_S3
+  std::vector<std::string> paths;
+  RETURN_NOT_OK(s3_.ls_sharded(parent, &paths, shard_boundaries));
+  parallel_sort(paths.begin(), paths.end());
+  for (auto& path : paths)
+    uris->emplace_back(path);
+  return Status::Ok();
+#else
+  (void)shard_boundaries;
+  return LOG_STATUS(Status::VFSError("TileDB was built without S3 support"));
+#endif
+}
+
+Status VFS::map_region(
+    const URI& uri,
+    uint64_t offset,
+    uint64_t nbytes,
+    std::shared_ptr<MappedRegion>* region) const {
+  STATS_FUNC_IN(vfs_map_region);
+
+  if (!init_)
+    return LOG_STATUS(
+        Status::VFSError("Cannot map region; VFS not initialized"));
+
+  if (uri.is_file()) {
+#ifdef _WIN32
+    (void)offset;
+    (void)nbytes;
+    (void)region;
+    return LOG_STATUS(Status::VFSError(
+        "Cannot map region; Memory mapping is not supported on Windows"));
+#else
+    RETURN_NOT_OK(posix_.map_region(uri.to_path(), offset, nbytes, region));
+    STATS_COUNTER_ADD(vfs_map_region_total_bytes, nbytes);
+    return Status::Ok();
+#endif
+  }
+
+  return LOG_STATUS(Status::VFSError(
+      "Cannot map region; Memory mapping is only supported for local files"));
+
+  STATS_FUNC_OUT(vfs_map_region);
+}
+
+bool VFS::mmap_enabled(const URI& uri) const {
+#ifdef _WIN32
+  (void)uri;
+  return false;
+#else
+  if (!init_ || !uri.is_file())
+    return false;
+
+  bool found;
+  bool enable_mmap = false;
+  auto st = config_.get<bool>("vfs.file.enable_mmap", &enable_mmap, &found);
+  assert(found);
+  return st.ok() && enable_mmap;
+#endif
+}
+
 Status VFS::move_file(const URI& old_uri, const URI& new_uri) {
   STATS_FUNC_IN(vfs_move_file);
 
@@ -933,6 +1097,19 @@ Status VFS::read(
   uint64_t num_ops =
       std::min(std::max(nbytes / min_parallel_size, uint64_t(1)), max_ops);
 
+  // For S3, optionally split the read into fixed-size range GETs instead, as
+  // a single stream is bandwidth-capped well below the NIC limit. The parts
+  // are queued on the thread pool, so they may exceed the max parallel ops.
+  if (uri.is_s3()) {
+    uint64_t read_part_size = 0;
+    RETURN_NOT_OK(config_.get<uint64_t>(
+        "vfs.s3.read_part_size", &read_part_size, &found));
+    assert(found);
+    if (read_part_size > 0)
+      num_ops = std::max(
+          utils::math::ceil(nbytes, read_part_size), uint64_t(1));
+  }
+
   if (num_ops == 1) {
     return read_impl(uri, offset, buffer, nbytes);
   } else {
@@ -968,7 +1145,28 @@ Status VFS::read(
 
 Status VFS::read_impl(
     const URI& uri, uint64_t offset, void* buffer, uint64_t nbytes) {
+  auto model = read_cost_model(uri);
+  if (model == nullptr)
+    return read_backend(uri, offset, buffer, nbytes);
+
+  // Feed the observed cost of the read to the batching model
+  auto start = std::chrono::steady_clock::now();
+  RETURN_NOT_OK(read_backend(uri, offset, buffer, nbytes));
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  model->record(nbytes, elapsed.count());
+
+  return Status::Ok();
+}
+
+Status VFS::read_backend(
+    const URI& uri, uint64_t offset, void* buffer, uint64_t nbytes) {
+  emulate_request(nbytes);
+
   if (uri.is_file()) {
+    STATS_COUNTER_ADD(vfs_file_num_reads, 1);
+    STATS_COUNTER_ADD(vfs_file_read_bytes, nbytes);
+    STATS_HISTOGRAM_TIMER(vfs_read_file);
 #ifdef _WIN32
     return win_.read(uri.to_path(), offset, buffer, nbytes);
 #else
@@ -977,6 +1175,9 @@ Status VFS::read_impl(
   }
   if (uri.is_hdfs()) {
 #ifdef HAVE_HDFS
+    STATS_COUNTER_ADD(vfs_hdfs_num_reads, 1);
+    STATS_COUNTER_ADD(vfs_hdfs_read_bytes, nbytes);
+    STATS_HISTOGRAM_TIMER(vfs_read_hdfs);
     return hdfs_->read(uri, offset, buffer, nbytes);
 #else
     return LOG_STATUS(
@@ -985,6 +1186,9 @@ Status VFS::read_impl(
   }
   if (uri.is_s3()) {
 #ifdef HAVE_S3
+    STATS_COUNTER_ADD(vfs_s3_num_reads, 1);
+    STATS_COUNTER_ADD(vfs_s3_read_bytes, nbytes);
+    STATS_HISTOGRAM_TIMER(vfs_read_s3);
     return s3_.read(uri, offset, buffer, nbytes);
 #else
     return LOG_STATUS(Status::VFSError("TileDB was built without S3 support"));
@@ -1012,9 +1216,40 @@ Status VFS::read_all(
   if (regions.empty())
     return Status::Ok();
 
+  // With io_uring (or overlapped I/O on Windows), submit the original
+  // regions directly into their destinations instead of reading (and
+  // copying out of) larger batches.
+#ifdef _WIN32
+  bool submit_regions = uri.is_file() && win_.use_overlapped_io();
+#else
+  bool submit_regions = uri.is_file() && posix_.use_io_uring();
+#endif
+  if (submit_regions) {
+    uint64_t nbytes = 0;
+    for (const auto& region : regions)
+      nbytes += std::get<2>(region);
+    STATS_COUNTER_ADD(vfs_read_total_bytes, nbytes);
+    STATS_COUNTER_ADD(vfs_read_all_bytes_requested, nbytes);
+    STATS_COUNTER_ADD(vfs_read_all_bytes_batched, nbytes);
+    STATS_COUNTER_ADD(vfs_file_num_reads, regions.size());
+    STATS_COUNTER_ADD(vfs_file_read_bytes, nbytes);
+
+    URI uri_copy = uri;
+    auto regions_copy = regions;
+    auto task = thread_pool->enqueue([uri_copy, regions_copy, this]() {
+#ifdef _WIN32
+      return win_.read_batch(uri_copy.to_path(), regions_copy);
+#else
+      return posix_.read_batch(uri_copy.to_path(), regions_copy);
+#endif
+    });
+    tasks->push_back(std::move(task));
+    return Status::Ok();
+  }
+
   // Convert the individual regions into batched regions.
   std::vector<BatchedRead> batches;
-  RETURN_NOT_OK(compute_read_batches(regions, &batches));
+  RETURN_NOT_OK(compute_read_batches(uri, regions, &batches));
 
   // Read all the batches and copy to the original destinations.
   for (const auto& batch : batches) {
@@ -1046,6 +1281,7 @@ Status VFS::read_all(
 }
 
 Status VFS::compute_read_batches(
+    const URI& uri,
     const std::vector<std::tuple<uint64_t, void*, uint64_t>>& regions,
     std::vector<BatchedRead>* batches) const {
   // Get config params
@@ -1059,6 +1295,17 @@ Status VFS::compute_read_batches(
       config_.get<uint64_t>("vfs.min_batch_gap", &min_batch_gap, &found));
   assert(found);
 
+  // In adaptive mode, once the backend cost is known, merge two regions only
+  // if over-reading the gap between them is cheaper than an extra request.
+  // The estimate replaces both static thresholds.
+  auto model = read_cost_model(uri);
+  uint64_t adaptive_gap = 0;
+  if (model != nullptr && model->batch_gap(min_batch_size, &adaptive_gap)) {
+    STATS_COUNTER_ADD(vfs_read_all_adaptive_batches, 1);
+    min_batch_size = 0;
+    min_batch_gap = adaptive_gap;
+  }
+
   // Ensure the regions are sorted on offset.
   std::vector<std::tuple<uint64_t, void*, uint64_t>> sorted_regions(
       regions.begin(), regions.end());
@@ -1070,6 +1317,17 @@ Status VFS::compute_read_batches(
         return std::get<0>(a) < std::get<0>(b);
       });
 
+  // With direct I/O every read is expanded to whole blocks, so the gap
+  // is measured between the blocks the regions occupy.
+  uint64_t align = 1;
+#ifdef _WIN32
+  if (uri.is_file() && win_.direct_io())
+    align = constants::direct_io_alignment;
+#else
+  if (uri.is_file() && posix_.direct_io())
+    align = constants::direct_io_alignment;
+#endif
+
   // Start the first batch containing only the first region.
   BatchedRead curr_batch(sorted_regions.front());
   uint64_t curr_batch_useful_bytes = curr_batch.nbytes;
@@ -1079,6 +1337,14 @@ Status VFS::compute_read_batches(
     uint64_t nbytes = std::get<2>(region);
     uint64_t new_batch_size = (offset + nbytes) - curr_batch.offset;
     uint64_t gap = offset - (curr_batch.offset + curr_batch.nbytes);
+    if (align > 1) {
+      uint64_t batch_end_block =
+          utils::math::ceil(curr_batch.offset + curr_batch.nbytes, align);
+      uint64_t region_block = offset / align;
+      gap = region_block > batch_end_block ?
+                (region_block - batch_end_block) * align :
+                0;
+    }
     if (new_batch_size <= min_batch_size || gap <= min_batch_gap) {
       // Extend current batch.
       curr_batch.nbytes = new_batch_size;
@@ -1098,9 +1364,47 @@ Status VFS::compute_read_batches(
   // Push the last batch
   batches->push_back(curr_batch);
 
+  // The bytes of the gaps merged into the batches are over-read
+  if (stats::gathering()) {
+    uint64_t bytes_requested = 0, bytes_batched = 0;
+    for (const auto& region : regions)
+      bytes_requested += std::get<2>(region);
+    for (const auto& batch : *batches)
+      bytes_batched += batch.nbytes;
+    STATS_COUNTER_ADD(vfs_read_all_bytes_requested, bytes_requested);
+    STATS_COUNTER_ADD(vfs_read_all_bytes_batched, bytes_batched);
+  }
+
   return Status::Ok();
 }
 
+ReadCostModel* VFS::read_cost_model(const URI& uri) const {
+  bool found;
+  bool adaptive = false;
+  if (!config_.get<bool>("vfs.adaptive_batch_gap", &adaptive, &found).ok() ||
+      !adaptive)
+    return nullptr;
+
+  if (uri.is_file())
+    return &read_cost_models_[0];
+  if (uri.is_hdfs())
+    return &read_cost_models_[1];
+  if (uri.is_s3())
+    return &read_cost_models_[2];
+  return nullptr;
+}
+
+void VFS::emulate_request(uint64_t nbytes) const {
+  if (emulated_latency_ms_ == 0 && emulated_bandwidth_ == 0)
+    return;
+
+  std::chrono::duration<double> delay(emulated_latency_ms_ / 1000.0);
+  if (emulated_bandwidth_ > 0)
+    delay +=
+        std::chrono::duration<double>((double)nbytes / emulated_bandwidth_);
+  std::this_thread::sleep_for(delay);
+}
+
 bool VFS::supports_fs(Filesystem fs) const {
   STATS_FUNC_IN(vfs_supports_fs);
 
@@ -1200,6 +1504,8 @@ Status VFS::close_file(const URI& uri) {
     return LOG_STATUS(
         Status::VFSError("Cannot close file; VFS not initialized"));
 
+  RETURN_NOT_OK(finish_write_behind(uri));
+
   if (uri.is_file()) {
 #ifdef _WIN32
     return win_.sync(uri.to_path());
@@ -1236,7 +1542,16 @@ Status VFS::write(const URI& uri, const void* buffer, uint64_t buffer_size) {
 
   STATS_COUNTER_ADD(vfs_write_total_bytes, buffer_size);
 
+  auto max_buffer_size = write_behind_buffer_size(uri);
+  if (max_buffer_size > 0)
+    return write_behind(uri, buffer, buffer_size, max_buffer_size);
+
+  emulate_request(buffer_size);
+
   if (uri.is_file()) {
+    STATS_COUNTER_ADD(vfs_file_num_writes, 1);
+    STATS_COUNTER_ADD(vfs_file_write_bytes, buffer_size);
+    STATS_HISTOGRAM_TIMER(vfs_write_file);
 #ifdef _WIN32
     return win_.write(uri.to_path(), buffer, buffer_size);
 #else
@@ -1245,6 +1560,9 @@ Status VFS::write(const URI& uri, const void* buffer, uint64_t buffer_size) {
   }
   if (uri.is_hdfs()) {
 #ifdef HAVE_HDFS
+    STATS_COUNTER_ADD(vfs_hdfs_num_writes, 1);
+    STATS_COUNTER_ADD(vfs_hdfs_write_bytes, buffer_size);
+    STATS_HISTOGRAM_TIMER(vfs_write_hdfs);
     return hdfs_->write(uri, buffer, buffer_size);
 #else
     return LOG_STATUS(
@@ -1253,6 +1571,9 @@ Status VFS::write(const URI& uri, const void* buffer, uint64_t buffer_size) {
   }
   if (uri.is_s3()) {
 #ifdef HAVE_S3
+    STATS_COUNTER_ADD(vfs_s3_num_writes, 1);
+    STATS_COUNTER_ADD(vfs_s3_write_bytes, buffer_size);
+    STATS_HISTOGRAM_TIMER(vfs_write_s3);
     return s3_.write(uri, buffer, buffer_size);
 #else
     return LOG_STATUS(Status::VFSError("TileDB was built without S3 support"));
@@ -1264,5 +1585,125 @@ Status VFS::write(const URI& uri, const void* buffer, uint64_t buffer_size) {
   STATS_FUNC_OUT(vfs_write);
 }
 
+Status VFS::finish_write_behind(const URI& uri) {
+  std::unique_ptr<WriteBehindFile> file;
+  {
+    std::unique_lock<std::mutex> lck(write_behind_mtx_);
+    auto it = write_behind_files_.find(uri.to_string());
+    if (it == write_behind_files_.end())
+      return Status::Ok();
+    file = std::move(it->second);
+    write_behind_files_.erase(it);
+  }
+
+  // Always wait for the in-flight flushes, even if the last flush fails,
+  // as they reference the file state
+  auto st = Status::Ok();
+  if (file->buffer_.size() > 0)
+    st = flush_write_behind(uri, file.get());
+  auto st_wait = thread_pool_.wait_all(file->flushes_);
+  RETURN_NOT_OK(st);
+  return st_wait;
+}
+
+Status VFS::flush_write_behind(const URI& uri, WriteBehindFile* file) {
+  // HDFS only appends, so it keeps a single flush in flight
+  uint64_t max_ops = 1;
+  if (!uri.is_hdfs())
+    RETURN_NOT_OK(max_parallel_ops(uri, &max_ops));
+  if (file->flushes_.size() >= std::max(max_ops, (uint64_t)1)) {
+    auto st = thread_pool_.wait_all(file->flushes_);
+    file->flushes_.clear();
+    RETURN_NOT_OK(st);
+  }
+
+  // Hand the buffered data over to the flush task
+  auto data = std::make_shared<Buffer>();
+  RETURN_NOT_OK(data->swap(file->buffer_));
+  auto offset = file->offset_;
+  file->offset_ += data->size();
+  STATS_COUNTER_ADD(vfs_write_behind_num_flushes, 1);
+
+  // Local files are written in place, so their flushes may run
+  // concurrently.
+  file->flushes_.push_back(thread_pool_.enqueue([this, uri, data, offset]() {
+    emulate_request(data->size());
+#ifndef _WIN32
+    if (uri.is_file()) {
+      STATS_COUNTER_ADD(vfs_file_num_writes, 1);
+      STATS_COUNTER_ADD(vfs_file_write_bytes, data->size());
+      STATS_HISTOGRAM_TIMER(vfs_write_file);
+      return posix_.write_at_offset(
+          uri.to_path(), offset, data->data(), data->size());
+    }
+#endif
+#ifdef HAVE_HDFS
+    STATS_COUNTER_ADD(vfs_hdfs_num_writes, 1);
+    STATS_COUNTER_ADD(vfs_hdfs_write_bytes, data->size());
+    STATS_HISTOGRAM_TIMER(vfs_write_hdfs);
+    return hdfs_->write(uri, data->data(), data->size());
+#else
+    return LOG_STATUS(
+        Status::VFSError("TileDB was built without HDFS support"));
+#endif
+  }));
+
+
+  return Status::Ok();
+}
+
+uint64_t VFS::write_behind_buffer_size(const URI& uri) const {
+#ifdef _WIN32
+  if (uri.is_file())
+    return 0;
+#endif
+  if (!uri.is_file() && !uri.is_hdfs())
+    return 0;
+
+  bool found;
+  uint64_t size = 0;
+  if (!config_
+           .get<uint64_t>("vfs.write_behind_buffer_size", &size, &found)
+           .ok())
+    return 0;
+  return size;
+}
+
+Status VFS::write_behind(
+    const URI& uri,
+    const void* buffer,
+    uint64_t buffer_size,
+    uint64_t max_buffer_size) {
+  // Get the state of the file, starting at its end for appends
+  WriteBehindFile* file = nullptr;
+  {
+    std::unique_lock<std::mutex> lck(write_behind_mtx_);
+    auto& entry = write_behind_files_[uri.to_string()];
+    if (entry == nullptr) {
+      std::unique_ptr<WriteBehindFile> new_file(new WriteBehindFile());
+      bool exists = false;
+      RETURN_NOT_OK(is_file(uri, &exists));
+      if (exists)
+        RETURN_NOT_OK(file_size(uri, &new_file->offset_));
+      entry = std::move(new_file);
+    }
+    file = entry.get();
+  }
+
+  // Fill the buffer, flushing whenever it is full
+  auto bytes = static_cast<const char*>(buffer);
+  while (buffer_size > 0) {
+    auto nbytes =
+        std::min(buffer_size, max_buffer_size - file->buffer_.size());
+    RETURN_NOT_OK(file->buffer_.write(bytes, nbytes));
+    bytes += nbytes;
+    buffer_size -= nbytes;
+    if (file->buffer_.size() >= max_buffer_size)
+      RETURN_NOT_OK(flush_write_behind(uri, file));
+  }
+
+  return Status::Ok();
+}
+
 }  // namespace sm
 }  // namespace tiledb
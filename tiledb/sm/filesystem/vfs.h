@@ -34,12 +34,19 @@
 #define TILEDB_VFS_H
 
 #include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include "tiledb/sm/buffer/buffer.h"
 #include "tiledb/sm/config/config.h"
 #include "tiledb/sm/filesystem/filelock.h"
+#include "tiledb/sm/filesystem/mapped_region.h"
+#include "tiledb/sm/filesystem/read_cost_model.h"
 #include "tiledb/sm/misc/cancelable_tasks.h"
 #include "tiledb/sm/misc/status.h"
 #include "tiledb/sm/misc/thread_pool.h"
@@ -71,6 +78,34 @@ enum class VFSMode : uint8_t;
  */
 class VFS {
  public:
+  /* ********************************* */
+  /*           PUBLIC DATATYPES        */
+  /* ********************************* */
+
+  /**
+   * Helper type holding information about a batched read operation.
+   */
+  struct BatchedRead {
+    /** Construct a BatchedRead consisting of the single given region. */
+    BatchedRead(const std::tuple<uint64_t, void*, uint64_t>& region) {
+      offset = std::get<0>(region);
+      nbytes = std::get<2>(region);
+      regions.push_back(region);
+    }
+
+    /** Offset of the batch. */
+    uint64_t offset;
+
+    /** Number of bytes in the batch. */
+    uint64_t nbytes;
+
+    /**
+     * Original regions making up the batch. Vector of tuples of the form
+     * (offset, dest_buffer, nbytes).
+     */
+    std::vector<std::tuple<uint64_t, void*, uint64_t>> regions;
+  };
+
   /* ********************************* */
   /*     CONSTRUCTORS & DESTRUCTORS    */
   /* ********************************* */
@@ -120,6 +155,22 @@ class VFS {
    */
   Status touch(const URI& uri) const;
 
+  /**
+   * Pre-opens the connections to the storage backend of the input URI, so
+   * that the first operations do not pay for connection setup. Only S3
+   * keeps a connection pool; this is a no-op for the other backends.
+   *
+   * @param uri A URI on the backend to connect to.
+   * @return Status
+   */
+  Status warm_up(const URI& uri) const;
+
+  /**
+   * Returns the number of bytes written but not flushed yet, held in the
+   * write buffers of the backends (only S3 buffers writes).
+   */
+  uint64_t write_buffer_size() const;
+
   /**
    * Cancels all background or queued tasks.
    */
@@ -133,6 +184,21 @@ class VFS {
    */
   Status create_bucket(const URI& uri) const;
 
+  /**
+   * Groups the given vector of regions to be read into a possibly smaller
+   * vector of batched reads.
+   *
+   * @param uri The URI of the file the regions belong to.
+   * @param regions Vector of individual regions to be read. Each region is a
+   *    tuple `(file_offset, dest_buffer, nbytes)`.
+   * @param batches Vector storing the batched read information.
+   * @return Status
+   */
+  Status compute_read_batches(
+      const URI& uri,
+      const std::vector<std::tuple<uint64_t, void*, uint64_t>>& regions,
+      std::vector<BatchedRead>* batches) const;
+
   /**
    * Returns the size of the files in the input directory.
    * This function is **recursive**, i.e., it will calculate
@@ -170,6 +236,15 @@ class VFS {
    */
   Status remove_dir(const URI& uri) const;
 
+  /**
+   * Removes the given directories (recursive). On S3, the objects of all
+   * directories are deleted together with batched multi-object deletes.
+   *
+   * @param uris The uris of the directories to be removed
+   * @return Status
+   */
+  Status remove_dirs(const std::vector<URI>& uris) const;
+
   /**
    * Deletes a file.
    *
@@ -273,6 +348,46 @@ class VFS {
    */
   Status ls(const URI& parent, std::vector<URI>* uris) const;
 
+  /**
+   * Retrieves all the URIs that have the first input as parent, like `ls`.
+   * On S3, the listing is split into key ranges that are listed in
+   * parallel (see `S3::ls_sharded`). The other backends list serially.
+   *
+   * @param parent The target directory to list.
+   * @param uris The URIs that are contained in the parent.
+   * @param shard_boundaries Given the last listed name and a number of
+   *     shards, returns the sorted names that split the rest of the listing.
+   * @return Status
+   */
+  Status ls_sharded(
+      const URI& parent,
+      std::vector<URI>* uris,
+      const std::function<std::vector<std::string>(
+          const std::string&, uint64_t)>& shard_boundaries) const;
+
+  /**
+   * Maps a region of a file into memory, so that it can be read without
+   * copying. This is supported only for local (non-Windows) files.
+   *
+   * @param uri The URI of the file.
+   * @param offset The offset in the file where the region starts.
+   * @param nbytes The size of the region.
+   * @param region The mapped region to be returned. The mapping is released
+   *     when the last reference to it is dropped.
+   * @return Status
+   */
+  Status map_region(
+      const URI& uri,
+      uint64_t offset,
+      uint64_t nbytes,
+      std::shared_ptr<MappedRegion>* region) const;
+
+  /**
+   * Returns `true` if `vfs.file.enable_mmap` is set and `map_region` is
+   * supported for the input URI.
+   */
+  bool mmap_enabled(const URI& uri) const;
+
   /**
    * Renames a file.
    *
@@ -354,7 +469,8 @@ class VFS {
   Status open_file(const URI& uri, VFSMode mode);
 
   /**
-   * Closes a file, flushing its contents to persistent storage.
+   * Closes a file, flushing its contents to persistent storage. This waits
+   * for any write-behind flushes of the file.
    *
    * @param uri The URI of the file.
    * @return Status
@@ -362,7 +478,10 @@ class VFS {
   Status close_file(const URI& uri);
 
   /**
-   * Writes the contents of a buffer into a file.
+   * Writes the contents of a buffer into a file. If
+   * `vfs.write_behind_buffer_size` is set, local and HDFS writes are
+   * buffered and the data is only guaranteed to be written once the file
+   * is closed.
    *
    * @param uri The URI of the file.
    * @param buffer The buffer to write from.
@@ -376,28 +495,16 @@ class VFS {
   /*        PRIVATE DATATYPES          */
   /* ********************************* */
 
-  /**
-   * Helper type holding information about a batched read operation.
-   */
-  struct BatchedRead {
-    /** Construct a BatchedRead consisting of the single given region. */
-    BatchedRead(const std::tuple<uint64_t, void*, uint64_t>& region) {
-      offset = std::get<0>(region);
-      nbytes = std::get<2>(region);
-      regions.push_back(region);
-    }
+  /** The write-behind state of a file being written. */
+  struct WriteBehindFile {
+    /** The data written since the last flush. */
+    Buffer buffer_;
 
-    /** Offset of the batch. */
-    uint64_t offset;
-
-    /** Number of bytes in the batch. */
-    uint64_t nbytes;
+    /** The file offset at which `buffer_` will be flushed. */
+    uint64_t offset_ = 0;
 
-    /**
-     * Original regions making up the batch. Vector of tuples of the form
-     * (offset, dest_buffer, nbytes).
-     */
-    std::vector<std::tuple<uint64_t, void*, uint64_t>> regions;
+    /** The flushes of the file that may still be in flight. */
+    std::vector<std::future<Status>> flushes_;
   };
 
   /* ********************************* */
@@ -434,17 +541,23 @@ class VFS {
   CancelableTasks cancelable_tasks_;
 
   /**
-   * Groups the given vector of regions to be read into a possibly smaller
-   * vector of batched reads.
-   *
-   * @param regions Vector of individual regions to be read. Each region is a
-   *    tuple `(file_offset, dest_buffer, nbytes)`.
-   * @param batches Vector storing the batched read information.
-   * @return Status
+   * Running estimates of the read cost on the local filesystem, HDFS and S3
+   * (in that order), used when `vfs.adaptive_batch_gap` is set.
    */
-  Status compute_read_batches(
-      const std::vector<std::tuple<uint64_t, void*, uint64_t>>& regions,
-      std::vector<BatchedRead>* batches) const;
+  mutable ReadCostModel read_cost_models_[3];
+
+  /** The write-behind state of the files being written, keyed on URI. */
+  std::unordered_map<std::string, std::unique_ptr<WriteBehindFile>>
+      write_behind_files_;
+
+  /** Protects `write_behind_files_`. */
+  std::mutex write_behind_mtx_;
+
+  /** The latency added to every request (`vfs.emulated_latency_ms`). */
+  uint64_t emulated_latency_ms_;
+
+  /** The emulated per-request bandwidth (`vfs.emulated_bandwidth`). */
+  uint64_t emulated_bandwidth_;
 
   /**
    * Reads from a file by calling the specific backend read function.
@@ -458,6 +571,30 @@ class VFS {
   Status read_impl(
       const URI& uri, uint64_t offset, void* buffer, uint64_t nbytes);
 
+  /**
+   * Dispatches a read to the backend of the input URI.
+   *
+   * @param uri The URI of the file.
+   * @param offset The offset where the read begins.
+   * @param buffer The buffer to read into.
+   * @param nbytes Number of bytes to read.
+   * @return Status
+   */
+  Status read_backend(
+      const URI& uri, uint64_t offset, void* buffer, uint64_t nbytes);
+
+  /**
+   * Returns the read cost model of the backend of the input URI, or `nullptr`
+   * if `vfs.adaptive_batch_gap` is not set.
+   */
+  ReadCostModel* read_cost_model(const URI& uri) const;
+
+  /**
+   * Delays the calling thread by the emulated latency of a request and the
+   * emulated transfer time of ``nbytes``, if any is configured.
+   */
+  void emulate_request(uint64_t nbytes) const;
+
   /**
    * Decrement the lock count of the given URI.
    *
@@ -472,6 +609,49 @@ class VFS {
    * read.
    */
   Status max_parallel_ops(const URI& uri, uint64_t* ops) const;
+
+  /**
+   * Flushes the remaining buffered data of a file written with write-behind
+   * buffering and waits for all its flushes. This is a no-op for files
+   * that are not buffered.
+   *
+   * @param uri The URI of the file.
+   * @return Status
+   */
+  Status finish_write_behind(const URI& uri);
+
+  /**
+   * Enqueues the flush of the buffered data of the input file on the
+   * thread pool. If the file already has the maximum number of flushes in
+   * flight, this waits for them first.
+   *
+   * @param uri The URI of the file.
+   * @param file The write-behind state of the file.
+   * @return Status
+   */
+  Status flush_write_behind(const URI& uri, WriteBehindFile* file);
+
+  /**
+   * Returns the write-behind buffer size for the input URI, or 0 if writes
+   * to it are not buffered.
+   */
+  uint64_t write_behind_buffer_size(const URI& uri) const;
+
+  /**
+   * Appends the input buffer to the write-behind buffer of a file, flushing
+   * it once it is full.
+   *
+   * @param uri The URI of the file.
+   * @param buffer The input buffer.
+   * @param buffer_size The size of the input buffer.
+   * @param max_buffer_size The write-behind buffer size.
+   * @return Status
+   */
+  Status write_behind(
+      const URI& uri,
+      const void* buffer,
+      uint64_t buffer_size,
+      uint64_t max_buffer_size);
 };
 
 }  // namespace sm
@@ -39,8 +39,11 @@
 
 #include <Shlwapi.h>
 #include <Windows.h>
+#include <malloc.h>
 #include <wininet.h>  // For INTERNET_MAX_URL_LENGTH
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 
@@ -352,34 +355,50 @@ Status Win::read(
     void* buffer,
     uint64_t nbytes) const {
   // Open the file (OPEN_EXISTING with CreateFile() will only open, not create,
-  // the file).
-  HANDLE file_h = CreateFile(
-      path.c_str(),
-      GENERIC_READ,
-      FILE_SHARE_READ,
-      NULL,
-      OPEN_EXISTING,
-      FILE_ATTRIBUTE_NORMAL,
-      NULL);
+  // the file), falling back to buffered I/O if unbuffered I/O is not
+  // supported.
+  bool direct = direct_io();
+  HANDLE file_h = INVALID_HANDLE_VALUE;
+  if (direct)
+    file_h = CreateFile(
+        path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        NULL,
+        OPEN_EXISTING,
+        FILE_FLAG_NO_BUFFERING,
+        NULL);
+  if (file_h == INVALID_HANDLE_VALUE) {
+    direct = false;
+    file_h = CreateFile(
+        path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        NULL,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        NULL);
+  }
   if (file_h == INVALID_HANDLE_VALUE) {
     return LOG_STATUS(Status::IOError(
         "Cannot read from file '" + path + "'; File opening error"));
   }
 
-  LARGE_INTEGER offset_lg_int;
-  offset_lg_int.QuadPart = offset;
-  if (SetFilePointerEx(file_h, offset_lg_int, NULL, FILE_BEGIN) == 0) {
-    CloseHandle(file_h);
-    return LOG_STATUS(Status::IOError(
-        "Cannot read from file '" + path + "'; File seek error"));
+  // Reads are positional, so the file pointer is never moved
+  Status st;
+  if (direct) {
+    st = read_direct(file_h, offset, buffer, nbytes);
+  } else {
+    uint64_t nbytes_read = 0;
+    st = read_at(file_h, offset, buffer, nbytes, &nbytes_read);
+    if (st.ok() && nbytes_read != nbytes)
+      st = Status::IOError("Unexpected end of file");
   }
-
-  unsigned long num_bytes_read = 0;
-  if (ReadFile(file_h, buffer, nbytes, &num_bytes_read, NULL) == 0 ||
-      num_bytes_read != nbytes) {
+  if (!st.ok()) {
     CloseHandle(file_h);
     return LOG_STATUS(Status::IOError(
-        "Cannot read from file '" + path + "'; File read error"));
+        "Cannot read from file '" + path + "'; File read error: " +
+        st.message()));
   }
 
   if (CloseHandle(file_h) == 0) {
@@ -390,6 +409,55 @@ Status Win::read(
   return Status::Ok();
 }
 
+Status Win::read_batch(
+    const std::string& path,
+    const std::vector<std::tuple<uint64_t, void*, uint64_t>>& regions) const {
+  if (regions.empty())
+    return Status::Ok();
+
+  if (!use_overlapped_io()) {
+    for (const auto& region : regions)
+      RETURN_NOT_OK(read(
+          path, std::get<0>(region), std::get<1>(region), std::get<2>(region)));
+    return Status::Ok();
+  }
+
+  // The file can only be opened without buffering if every region is
+  // aligned in the file and in memory.
+  const uint64_t align = constants::direct_io_alignment;
+  bool direct = direct_io();
+  for (const auto& region : regions) {
+    if (std::get<0>(region) % align != 0 || std::get<2>(region) % align != 0 ||
+        reinterpret_cast<uintptr_t>(std::get<1>(region)) % align != 0) {
+      direct = false;
+      break;
+    }
+  }
+
+  auto st = read_overlapped(path, regions, direct);
+  if (!st.ok()) {
+    return LOG_STATUS(Status::IOError(
+        "Cannot read from file '" + path + "'; " + st.message()));
+  }
+
+  return Status::Ok();
+}
+
+bool Win::use_overlapped_io() const {
+  bool found;
+  auto engine = config_.get("vfs.file.io_engine", &found);
+  assert(found);
+  return engine == "overlapped";
+}
+
+bool Win::direct_io() const {
+  bool found;
+  bool direct = false;
+  if (!config_.get<bool>("vfs.file.direct_io", &direct, &found).ok())
+    return false;
+  return direct;
+}
+
 Status Win::sync(const std::string& path) const {
   if (!is_file(path)) {
     return Status::Ok();
@@ -459,6 +527,30 @@ Status Win::write(
         "Cannot write to file '" + path + "'; File size error"));
   }
   uint64_t file_offset = file_size_lg_int.QuadPart;
+
+  // Unbuffered writes are not split across the thread pool
+  if (direct_io()) {
+    CloseHandle(file_h);
+    bool written = false;
+    RETURN_NOT_OK(
+        write_direct(path, file_offset, buffer, buffer_size, &written));
+    if (written)
+      return Status::Ok();
+
+    file_h = CreateFile(
+        path.c_str(),
+        GENERIC_WRITE,
+        0,
+        NULL,
+        OPEN_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL,
+        NULL);
+    if (file_h == INVALID_HANDLE_VALUE) {
+      return LOG_STATUS(Status::IOError(
+          "Cannot write to file '" + path + "'; File opening error"));
+    }
+  }
+
   // Ensure that each thread is responsible for at least min_parallel_size
   // bytes, and cap the number of parallel operations at the thread pool size.
   uint64_t num_ops = std::min(
@@ -551,6 +643,285 @@ Status Win::write_at(
   return Status::Ok();
 }
 
+Status Win::read_at(
+    HANDLE file_h,
+    uint64_t file_offset,
+    void* buffer,
+    uint64_t nbytes,
+    uint64_t* nbytes_read) {
+  // As in write_at(), the OVERLAPPED struct gives the offset of each read,
+  // so the file pointer is not moved and the handle may be shared.
+  char* byte_buffer = reinterpret_cast<char*>(buffer);
+  *nbytes_read = 0;
+  while (*nbytes_read < nbytes) {
+    LARGE_INTEGER offset;
+    offset.QuadPart = file_offset + *nbytes_read;
+    OVERLAPPED ov = {0};
+    ov.Offset = offset.LowPart;
+    ov.OffsetHigh = offset.HighPart;
+    DWORD len = static_cast<DWORD>(
+        std::min(nbytes - *nbytes_read, constants::max_win_io_bytes));
+    unsigned long bytes_read = 0;
+    if (ReadFile(file_h, byte_buffer + *nbytes_read, len, &bytes_read, &ov) ==
+        0) {
+      if (GetLastError() == ERROR_HANDLE_EOF)
+        break;
+      return Status::IOError(
+          std::string("File reading error: ") + get_last_error_msg());
+    }
+    *nbytes_read += bytes_read;
+    // A short synchronous read only happens at the end of the file
+    if (bytes_read < len)
+      break;
+  }
+  return Status::Ok();
+}
+
+Status Win::read_direct(
+    HANDLE file_h, uint64_t offset, void* buffer, uint64_t nbytes) {
+  const uint64_t align = constants::direct_io_alignment;
+
+  // Aligned requests are read in place
+  uint64_t nread = 0;
+  if (offset % align == 0 && nbytes % align == 0 &&
+      reinterpret_cast<uintptr_t>(buffer) % align == 0) {
+    RETURN_NOT_OK(read_at(file_h, offset, buffer, nbytes, &nread));
+    if (nread != nbytes)
+      return Status::IOError("Direct read error; Unexpected end of file");
+    return Status::Ok();
+  }
+
+  uint64_t first_block = offset - offset % align;
+  uint64_t staging_size = std::min(
+      constants::direct_io_staging_size,
+      utils::math::ceil(offset + nbytes - first_block, align) * align);
+  void* staging = _aligned_malloc(staging_size, align);
+  if (staging == nullptr)
+    return Status::IOError("Cannot allocate direct I/O staging buffer");
+
+  auto dest = static_cast<char*>(buffer);
+  auto src = static_cast<char*>(staging);
+  uint64_t pos = offset, end = offset + nbytes;
+  while (pos < end) {
+    uint64_t block = pos - pos % align;
+    uint64_t len = std::min(
+        staging_size, utils::math::ceil(end - block, align) * align);
+
+    // The last block of the file may be partial
+    auto st = read_at(file_h, block, src, len, &nread);
+    if (!st.ok()) {
+      _aligned_free(staging);
+      return st;
+    }
+
+    uint64_t copy_end = std::min(block + nread, end);
+    if (copy_end <= pos) {
+      _aligned_free(staging);
+      return Status::IOError("Direct read error; Unexpected end of file");
+    }
+    std::memcpy(dest + (pos - offset), src + (pos - block), copy_end - pos);
+    pos = copy_end;
+  }
+
+  _aligned_free(staging);
+  return Status::Ok();
+}
+
+Status Win::write_direct(
+    const std::string& path,
+    uint64_t file_offset,
+    const void* buffer,
+    uint64_t buffer_size,
+    bool* written) {
+  *written = false;
+  HANDLE direct_h = CreateFile(
+      path.c_str(),
+      GENERIC_WRITE,
+      0,
+      NULL,
+      OPEN_ALWAYS,
+      FILE_FLAG_NO_BUFFERING,
+      NULL);
+  if (direct_h == INVALID_HANDLE_VALUE)
+    return Status::Ok();
+
+  // Split into an unaligned head, an aligned body and an unaligned tail
+  const uint64_t align = constants::direct_io_alignment;
+  uint64_t end = file_offset + buffer_size;
+  uint64_t body_start =
+      std::min(utils::math::ceil(file_offset, align) * align, end);
+  uint64_t body_end = std::max(end - end % align, body_start);
+  auto bytes = static_cast<const char*>(buffer);
+
+  Status st = Status::Ok();
+  auto body = bytes + (body_start - file_offset);
+  if (body_end > body_start &&
+      reinterpret_cast<uintptr_t>(body) % align == 0) {
+    // Aligned buffers are written in place, in aligned chunks
+    for (uint64_t pos = body_start; pos < body_end && st.ok();
+         pos += constants::max_win_io_bytes) {
+      uint64_t len = std::min(constants::max_win_io_bytes, body_end - pos);
+      st = write_at(direct_h, pos, bytes + (pos - file_offset), len);
+    }
+  } else if (body_end > body_start) {
+    uint64_t staging_size =
+        std::min(constants::direct_io_staging_size, body_end - body_start);
+    void* staging = _aligned_malloc(staging_size, align);
+    if (staging == nullptr) {
+      st = Status::IOError("Cannot allocate direct I/O staging buffer");
+    } else {
+      for (uint64_t pos = body_start; pos < body_end && st.ok();
+           pos += staging_size) {
+        uint64_t len = std::min(staging_size, body_end - pos);
+        std::memcpy(staging, bytes + (pos - file_offset), len);
+        st = write_at(direct_h, pos, staging, len);
+      }
+      _aligned_free(staging);
+    }
+  }
+  CloseHandle(direct_h);
+
+  if (st.ok() && (body_start > file_offset || end > body_end)) {
+    HANDLE file_h = CreateFile(
+        path.c_str(),
+        GENERIC_WRITE,
+        0,
+        NULL,
+        OPEN_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL,
+        NULL);
+    if (file_h == INVALID_HANDLE_VALUE) {
+      st = Status::IOError("File opening error: " + get_last_error_msg());
+    } else {
+      if (body_start > file_offset)
+        st = write_at(file_h, file_offset, bytes, body_start - file_offset);
+      if (st.ok() && end > body_end)
+        st = write_at(
+            file_h, body_end, bytes + (body_end - file_offset), end - body_end);
+      CloseHandle(file_h);
+    }
+  }
+
+  if (!st.ok()) {
+    std::stringstream errmsg;
+    errmsg << "Cannot write to file '" << path << "'; " << st.message();
+    return LOG_STATUS(Status::IOError(errmsg.str()));
+  }
+
+  *written = true;
+  return Status::Ok();
+}
+
+Status Win::read_overlapped(
+    const std::string& path,
+    const std::vector<std::tuple<uint64_t, void*, uint64_t>>& regions,
+    bool direct) {
+  DWORD flags = FILE_FLAG_OVERLAPPED;
+  HANDLE file_h = INVALID_HANDLE_VALUE;
+  if (direct)
+    file_h = CreateFile(
+        path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        NULL,
+        OPEN_EXISTING,
+        flags | FILE_FLAG_NO_BUFFERING,
+        NULL);
+  if (file_h == INVALID_HANDLE_VALUE)
+    file_h = CreateFile(
+        path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        NULL,
+        OPEN_EXISTING,
+        flags,
+        NULL);
+  if (file_h == INVALID_HANDLE_VALUE)
+    return Status::IOError("File opening error: " + get_last_error_msg());
+
+  HANDLE port = CreateIoCompletionPort(file_h, NULL, 0, 1);
+  if (port == NULL) {
+    auto msg = get_last_error_msg();
+    CloseHandle(file_h);
+    return Status::IOError("Cannot create I/O completion port: " + msg);
+  }
+
+  // Regions larger than a single ReadFile() call are split. The requests
+  // are all created up front, because the kernel keeps pointers to their
+  // OVERLAPPED structs until they complete.
+  struct Request {
+    OVERLAPPED ov;
+    char* dest;
+    DWORD nbytes;
+  };
+  std::vector<Request> requests;
+  for (const auto& region : regions) {
+    auto dest = static_cast<char*>(std::get<1>(region));
+    for (uint64_t pos = 0; pos < std::get<2>(region);
+         pos += constants::max_win_io_bytes) {
+      Request req;
+      std::memset(&req.ov, 0, sizeof(req.ov));
+      LARGE_INTEGER offset;
+      offset.QuadPart = std::get<0>(region) + pos;
+      req.ov.Offset = offset.LowPart;
+      req.ov.OffsetHigh = offset.HighPart;
+      req.dest = dest + pos;
+      req.nbytes = static_cast<DWORD>(
+          std::min(std::get<2>(region) - pos, constants::max_win_io_bytes));
+      requests.push_back(req);
+    }
+  }
+
+  // Keep up to `overlapped_io_queue_depth` reads in flight, and stop
+  // submitting after the first error. Every submitted read is waited for
+  // before returning, even on error.
+  Status st = Status::Ok();
+  size_t next = 0, pending = 0;
+  while ((st.ok() && next < requests.size()) || pending > 0) {
+    while (st.ok() && next < requests.size() &&
+           pending < constants::overlapped_io_queue_depth) {
+      auto& req = requests[next++];
+      if (ReadFile(file_h, req.dest, req.nbytes, NULL, &req.ov) == 0 &&
+          GetLastError() != ERROR_IO_PENDING) {
+        st = Status::IOError("File reading error: " + get_last_error_msg());
+        CancelIoEx(file_h, NULL);
+        break;
+      }
+      ++pending;
+      STATS_COUNTER_ADD(vfs_win32_overlapped_num_reads, 1);
+    }
+    if (pending == 0)
+      break;
+
+    DWORD nbytes_read = 0;
+    ULONG_PTR key = 0;
+    LPOVERLAPPED ov = NULL;
+    BOOL ok =
+        GetQueuedCompletionStatus(port, &nbytes_read, &key, &ov, INFINITE);
+    if (ov == NULL) {
+      // No completion was dequeued, which with an infinite timeout means the
+      // port itself is unusable. Cancel the outstanding reads.
+      st = Status::IOError(
+          "I/O completion port error: " + get_last_error_msg());
+      CancelIoEx(file_h, NULL);
+      break;
+    }
+    --pending;
+    auto req = CONTAINING_RECORD(ov, Request, ov);
+    if (st.ok() && (ok == 0 || nbytes_read != req->nbytes)) {
+      st = ok == 0 ?
+               Status::IOError("File reading error: " + get_last_error_msg()) :
+               Status::IOError("File reading error; Unexpected end of file");
+      CancelIoEx(file_h, NULL);
+    }
+  }
+
+  CloseHandle(port);
+  if (CloseHandle(file_h) == 0 && st.ok())
+    return Status::IOError("File closing error");
+  return st;
+}
+
 std::string Win::uri_from_path(const std::string& path) {
   if (path.length() == 0) {
     return "";
@@ -37,6 +37,7 @@
 
 #include <sys/types.h>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include "tiledb/sm/buffer/buffer.h"
@@ -193,6 +194,31 @@ class Win {
       void* buffer,
       uint64_t nbytes) const;
 
+  /**
+   * Reads a batch of regions of a file. If `vfs.file.io_engine` is
+   * `overlapped`, the regions are read asynchronously through an I/O
+   * completion port, with several requests in flight at once; otherwise
+   * they are read one by one.
+   *
+   * @param path The name of the file.
+   * @param regions The regions to read, as tuples
+   *     `(file_offset, dest_buffer, nbytes)`.
+   * @return Status
+   */
+  Status read_batch(
+      const std::string& path,
+      const std::vector<std::tuple<uint64_t, void*, uint64_t>>& regions)
+      const;
+
+  /** Returns `true` if batched reads are configured to use overlapped I/O. */
+  bool use_overlapped_io() const;
+
+  /**
+   * Returns `true` if reads and writes are configured to bypass the system
+   * cache (`FILE_FLAG_NO_BUFFERING`).
+   */
+  bool direct_io() const;
+
   /**
    * Syncs a file or directory.
    *
@@ -254,6 +280,74 @@ class Win {
    */
   Status recursively_remove_directory(const std::string& path) const;
 
+  /**
+   * Reads data from the file handle into the given buffer, beginning at the
+   * given offset, without moving the file pointer. Stops early at the end of
+   * the file.
+   *
+   * @param file_h Open file handle to read from
+   * @param file_offset Offset in the file at which to start reading
+   * @param buffer Buffer into which the data will be written
+   * @param nbytes Number of bytes to read
+   * @param nbytes_read Set to the number of bytes actually read
+   * @return Status
+   */
+  static Status read_at(
+      HANDLE file_h,
+      uint64_t file_offset,
+      void* buffer,
+      uint64_t nbytes,
+      uint64_t* nbytes_read);
+
+  /**
+   * Reads from a file opened with `FILE_FLAG_NO_BUFFERING`. The read is
+   * expanded to the direct I/O alignment and goes through an aligned staging
+   * buffer, unless the request is already aligned.
+   *
+   * @param file_h The file handle, opened without buffering.
+   * @param offset The offset in the file from which the read will start.
+   * @param buffer The buffer into which the data will be written.
+   * @param nbytes The size of the data to be read from the file.
+   * @return Status
+   */
+  static Status read_direct(
+      HANDLE file_h, uint64_t offset, void* buffer, uint64_t nbytes);
+
+  /**
+   * Writes to a file without buffering at the given offset. The unaligned
+   * head and tail of the range are written through the system cache, and the
+   * aligned body through an aligned staging buffer.
+   *
+   * @param path The name of the file.
+   * @param file_offset The offset in the file to write at.
+   * @param buffer The input buffer.
+   * @param buffer_size The size of the input buffer.
+   * @param written Set to `false` if the file could not be opened without
+   *     buffering, in which case nothing was written.
+   * @return Status
+   */
+  static Status write_direct(
+      const std::string& path,
+      uint64_t file_offset,
+      const void* buffer,
+      uint64_t buffer_size,
+      bool* written);
+
+  /**
+   * Reads the regions of a file through an I/O completion port, keeping up
+   * to `constants::overlapped_io_queue_depth` requests in flight.
+   *
+   * @param path The name of the file.
+   * @param regions The regions to read.
+   * @param direct If `true`, the file is opened without buffering. All
+   *     regions must then be aligned to `constants::direct_io_alignment`.
+   * @return Status
+   */
+  static Status read_overlapped(
+      const std::string& path,
+      const std::vector<std::tuple<uint64_t, void*, uint64_t>>& regions,
+      bool direct);
+
   /**
    * Write data from the given buffer to the file handle, beginning at the
    * given offset. Multiple threads can safely write to the same open file
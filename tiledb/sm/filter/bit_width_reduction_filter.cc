@@ -39,9 +39,22 @@
 #include "tiledb/sm/misc/utils.h"
 #include "tiledb/sm/tile/tile.h"
 
+#include <cstring>
+
 namespace tiledb {
 namespace sm {
 
+/**
+ * Number of values converted per bulk read or write, so that the conversion
+ * loops run over contiguous local arrays the compiler can vectorize.
+ */
+static const uint32_t batch_nelts = 256;
+
+/** The integer type S or U with the same signedness as T. */
+template <typename T, typename S, typename U>
+using same_sign_t =
+    typename std::conditional<std::is_signed<T>::value, S, U>::type;
+
 /** Compute the number of bits required to represent a signed integral value. */
 template <typename T>
 static inline uint8_t bits_required(T value, std::true_type) {
@@ -232,14 +245,13 @@ Status BitWidthReductionFilter::compress_part(
       input->advance_offset(window_nbytes);
     } else {
       // Compress and write the relative values to output.
-      for (uint32_t j = 0; j < window_nelts; j++) {
-        T relative_value = input->value<T>() - window_value_offset;
-
-        RETURN_NOT_OK(
-            write_compressed_value(output, relative_value, compressed_bits));
-
-        input->advance_offset(sizeof(T));
-      }
+      RETURN_NOT_OK(write_compressed_window(
+          output,
+          (char*)input->data() + input->offset(),
+          window_nelts,
+          window_value_offset,
+          compressed_bits));
+      input->advance_offset(window_nbytes);
     }
   }
 
@@ -337,15 +349,10 @@ Status BitWidthReductionFilter::run_reverse(
       RETURN_NOT_OK(output->write(input, window_nbytes));
       input->advance_offset(window_nbytes);
     } else {
-      // Read and uncompress each window value.
+      // Read and uncompress the window values.
       uint32_t window_nelts = window_nbytes / sizeof(T);
-      for (uint32_t j = 0; j < window_nelts; j++) {
-        T input_value = 0;
-        RETURN_NOT_OK(
-            read_compressed_value(input, compressed_bits, &input_value));
-        input_value += window_value_offset;
-        RETURN_NOT_OK(output->write(&input_value, tile_type_size));
-      }
+      RETURN_NOT_OK(read_compressed_window(
+          input, window_nelts, window_value_offset, compressed_bits, output));
     }
   }
 
@@ -364,14 +371,16 @@ uint8_t BitWidthReductionFilter::compute_bits_required(
   // Compute the min and max element values within the window.
   T window_min = std::numeric_limits<T>::max(),
     window_max = std::numeric_limits<T>::lowest();
-  auto orig_offset = buffer->offset();
-  for (uint32_t j = 0; j < num_elements; j++) {
-    T input_value = buffer->value<T>();
-    window_min = std::min(window_min, input_value);
-    window_max = std::max(window_max, input_value);
-    buffer->advance_offset(sizeof(T));
+  auto values = (const char*)buffer->data() + buffer->offset();
+  T batch[batch_nelts];
+  for (uint32_t start = 0; start < num_elements; start += batch_nelts) {
+    uint32_t n = std::min(batch_nelts, num_elements - start);
+    std::memcpy(batch, values + start * sizeof(T), n * sizeof(T));
+    for (uint32_t j = 0; j < n; j++) {
+      window_min = std::min(window_min, batch[j]);
+      window_max = std::max(window_max, batch[j]);
+    }
   }
-  buffer->set_offset(orig_offset);
 
   // Check for overflow
   T range = window_max - window_min;
@@ -396,40 +405,25 @@ uint8_t BitWidthReductionFilter::compute_bits_required(
 }
 
 template <typename T>
-Status BitWidthReductionFilter::write_compressed_value(
-    FilterBuffer* buffer, T value, uint8_t num_bits) const {
+Status BitWidthReductionFilter::write_compressed_window(
+    FilterBuffer* buffer,
+    const void* values,
+    uint32_t num_values,
+    T offset,
+    uint8_t num_bits) const {
   switch (num_bits) {
-    case 8: {
-      auto val = static_cast<
-          typename std::conditional<std::is_signed<T>::value, int8_t, uint8_t>::
-              type>(value);
-      RETURN_NOT_OK(buffer->write(&val, sizeof(val)));
-      break;
-    }
-    case 16: {
-      auto val = static_cast<
-          typename std::
-              conditional<std::is_signed<T>::value, int16_t, uint16_t>::type>(
-          value);
-      RETURN_NOT_OK(buffer->write(&val, sizeof(val)));
-      break;
-    }
-    case 32: {
-      auto val = static_cast<
-          typename std::
-              conditional<std::is_signed<T>::value, int32_t, uint32_t>::type>(
-          value);
-      RETURN_NOT_OK(buffer->write(&val, sizeof(val)));
-      break;
-    }
-    case 64: {
-      auto val = static_cast<
-          typename std::
-              conditional<std::is_signed<T>::value, int64_t, uint64_t>::type>(
-          value);
-      RETURN_NOT_OK(buffer->write(&val, sizeof(val)));
-      break;
-    }
+    case 8:
+      return write_compressed_window<T, same_sign_t<T, int8_t, uint8_t>>(
+          buffer, values, num_values, offset);
+    case 16:
+      return write_compressed_window<T, same_sign_t<T, int16_t, uint16_t>>(
+          buffer, values, num_values, offset);
+    case 32:
+      return write_compressed_window<T, same_sign_t<T, int32_t, uint32_t>>(
+          buffer, values, num_values, offset);
+    case 64:
+      return write_compressed_window<T, same_sign_t<T, int64_t, uint64_t>>(
+          buffer, values, num_values, offset);
     default:
       assert(false);
   }
@@ -437,38 +431,46 @@ Status BitWidthReductionFilter::write_compressed_value(
   return Status::Ok();
 }
 
+template <typename T, typename C>
+Status BitWidthReductionFilter::write_compressed_window(
+    FilterBuffer* buffer,
+    const void* values,
+    uint32_t num_values,
+    T offset) const {
+  auto input = static_cast<const char*>(values);
+  T batch[batch_nelts];
+  C compressed[batch_nelts];
+  for (uint32_t start = 0; start < num_values; start += batch_nelts) {
+    uint32_t n = std::min(batch_nelts, num_values - start);
+    std::memcpy(batch, input + start * sizeof(T), n * sizeof(T));
+    for (uint32_t j = 0; j < n; j++)
+      compressed[j] = static_cast<C>(static_cast<T>(batch[j] - offset));
+    RETURN_NOT_OK(buffer->write(compressed, n * sizeof(C)));
+  }
+
+  return Status::Ok();
+}
+
 template <typename T>
-Status BitWidthReductionFilter::read_compressed_value(
-    FilterBuffer* buffer, uint8_t compressed_bits, T* value) const {
+Status BitWidthReductionFilter::read_compressed_window(
+    FilterBuffer* input,
+    uint32_t num_values,
+    T offset,
+    uint8_t compressed_bits,
+    FilterBuffer* output) const {
   switch (compressed_bits) {
-    case 8: {
-      typename std::conditional<std::is_signed<T>::value, int8_t, uint8_t>::type
-          val;
-      RETURN_NOT_OK(buffer->read(&val, sizeof(val)));
-      *value = val;
-      break;
-    }
-    case 16: {
-      typename std::conditional<std::is_signed<T>::value, int16_t, uint16_t>::
-          type val;
-      RETURN_NOT_OK(buffer->read(&val, sizeof(val)));
-      *value = val;
-      break;
-    }
-    case 32: {
-      typename std::conditional<std::is_signed<T>::value, int32_t, uint32_t>::
-          type val;
-      RETURN_NOT_OK(buffer->read(&val, sizeof(val)));
-      *value = val;
-      break;
-    }
-    case 64: {
-      typename std::conditional<std::is_signed<T>::value, int64_t, uint64_t>::
-          type val;
-      RETURN_NOT_OK(buffer->read(&val, sizeof(val)));
-      *value = val;
-      break;
-    }
+    case 8:
+      return read_compressed_window<T, same_sign_t<T, int8_t, uint8_t>>(
+          input, num_values, offset, output);
+    case 16:
+      return read_compressed_window<T, same_sign_t<T, int16_t, uint16_t>>(
+          input, num_values, offset, output);
+    case 32:
+      return read_compressed_window<T, same_sign_t<T, int32_t, uint32_t>>(
+          input, num_values, offset, output);
+    case 64:
+      return read_compressed_window<T, same_sign_t<T, int64_t, uint64_t>>(
+          input, num_values, offset, output);
     default:
       assert(false);
   }
@@ -476,6 +478,25 @@ Status BitWidthReductionFilter::read_compressed_value(
   return Status::Ok();
 }
 
+template <typename T, typename C>
+Status BitWidthReductionFilter::read_compressed_window(
+    FilterBuffer* input,
+    uint32_t num_values,
+    T offset,
+    FilterBuffer* output) const {
+  C compressed[batch_nelts];
+  T batch[batch_nelts];
+  for (uint32_t start = 0; start < num_values; start += batch_nelts) {
+    uint32_t n = std::min(batch_nelts, num_values - start);
+    RETURN_NOT_OK(input->read(compressed, n * sizeof(C)));
+    for (uint32_t j = 0; j < n; j++)
+      batch[j] = static_cast<T>(static_cast<T>(compressed[j]) + offset);
+    RETURN_NOT_OK(output->write(batch, n * sizeof(T)));
+  }
+
+  return Status::Ok();
+}
+
 Status BitWidthReductionFilter::set_option_impl(
     FilterOption option, const void* value) {
   if (value == nullptr)
@@ -151,18 +151,36 @@ class BitWidthReductionFilter : public Filter {
   Status get_option_impl(FilterOption option, void* value) const override;
 
   /**
-   * Reads a compressed value of type T from the given buffer after
-   * decompressing from a value of the given bit width.
+   * Reads a window of compressed values from the given buffer, decompresses
+   * them from the given bit width to type T, adds the window offset and writes
+   * them to the output buffer.
    *
    * @tparam T Tile cell datatype
-   * @param buffer Buffer to read from
-   * @param compressed_bits Bit width of compressed value to read
-   * @param value Will be set to the decompressed value
+   * @param input Buffer to read from
+   * @param num_values Number of values in the window
+   * @param offset The window value offset
+   * @param compressed_bits Bit width of the compressed values to read
+   * @param output Buffer to write the decompressed values to
    * @return Status
    */
   template <typename T>
-  Status read_compressed_value(
-      FilterBuffer* buffer, uint8_t compressed_bits, T* value) const;
+  Status read_compressed_window(
+      FilterBuffer* input,
+      uint32_t num_values,
+      T offset,
+      uint8_t compressed_bits,
+      FilterBuffer* output) const;
+
+  /**
+   * Reads a window of compressed values of type C, converting them to
+   * type T in batches.
+   */
+  template <typename T, typename C>
+  Status read_compressed_window(
+      FilterBuffer* input,
+      uint32_t num_values,
+      T offset,
+      FilterBuffer* output) const;
 
   /** Run_forward method templated on the tile cell datatype. */
   template <typename T>
@@ -187,17 +205,36 @@ class BitWidthReductionFilter : public Filter {
   Status serialize_impl(Buffer* buff) const override;
 
   /**
-   * Writes the given value of type T to the given buffer after compressing
-   * (casting) to a value of the given bit width.
+   * Writes the given window of values of type T to the given buffer after
+   * subtracting the window offset and compressing (casting) each value to the
+   * given bit width.
    *
+   * @tparam T Tile cell datatype
    * @param buffer Buffer to write to
-   * @param value Uncompressed value to write
-   * @param num_bits Bit width of compressed value to write
+   * @param values The uncompressed window values
+   * @param num_values Number of values in the window
+   * @param offset The window value offset
+   * @param num_bits Bit width of the compressed values to write
    * @return Status
    */
   template <typename T>
-  Status write_compressed_value(
-      FilterBuffer* buffer, T value, uint8_t num_bits) const;
+  Status write_compressed_window(
+      FilterBuffer* buffer,
+      const void* values,
+      uint32_t num_values,
+      T offset,
+      uint8_t num_bits) const;
+
+  /**
+   * Writes a window of values of type T compressed to type C, converting
+   * them in batches.
+   */
+  template <typename T, typename C>
+  Status write_compressed_window(
+      FilterBuffer* buffer,
+      const void* values,
+      uint32_t num_values,
+      T offset) const;
 };
 
 }  // namespace sm
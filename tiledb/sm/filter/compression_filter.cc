@@ -39,6 +39,7 @@
 #include "tiledb/sm/compressors/rle_compressor.h"
 #include "tiledb/sm/compressors/zstd_compressor.h"
 #include "tiledb/sm/enums/compressor.h"
+#include "tiledb/sm/enums/datatype.h"
 #include "tiledb/sm/enums/filter_option.h"
 #include "tiledb/sm/enums/filter_type.h"
 #include "tiledb/sm/filter/filter_pipeline.h"
@@ -46,19 +47,41 @@
 #include "tiledb/sm/misc/utils.h"
 #include "tiledb/sm/tile/tile.h"
 
+#include "blosc/shuffle.h"
+
 namespace tiledb {
 namespace sm {
 
+namespace {
+
+/**
+ * Returns the byteshuffle scratch space of the calling thread, grown to at
+ * least `nbytes`. It is allocated once per thread and reused for every block
+ * the thread shuffles or unshuffles.
+ */
+uint8_t* thread_shuffle_scratch(uint64_t nbytes) {
+  static thread_local std::vector<uint8_t> scratch;
+  if (scratch.size() < nbytes)
+    scratch.resize(nbytes);
+  return scratch.data();
+}
+
+}  // namespace
+
 CompressionFilter::CompressionFilter(FilterType compressor, int level)
     : Filter(compressor) {
   compressor_ = filter_to_compressor(compressor);
   level_ = level;
+  dictionary_size_ = 0;
+  byteshuffle_ = false;
 }
 
 CompressionFilter::CompressionFilter(Compressor compressor, int level)
     : Filter(FilterType::FILTER_NONE) {
   compressor_ = compressor;
   level_ = level;
+  dictionary_size_ = 0;
+  byteshuffle_ = false;
   type_ = compressor_to_filter(compressor);
 }
 
@@ -70,8 +93,20 @@ int CompressionFilter::compression_level() const {
   return level_;
 }
 
+uint32_t CompressionFilter::dictionary_size() const {
+  return compressor_ == Compressor::ZSTD ? dictionary_size_ : 0;
+}
+
+bool CompressionFilter::byteshuffle() const {
+  return (compressor_ == Compressor::LZ4 || compressor_ == Compressor::ZSTD) &&
+         byteshuffle_;
+}
+
 CompressionFilter* CompressionFilter::clone_impl() const {
-  return new CompressionFilter(compressor_, level_);
+  auto clone = new CompressionFilter(compressor_, level_);
+  clone->dictionary_size_ = dictionary_size_;
+  clone->byteshuffle_ = byteshuffle_;
+  return clone;
 }
 
 void CompressionFilter::set_compressor(Compressor compressor) {
@@ -137,6 +172,20 @@ Status CompressionFilter::set_option_impl(
     case FilterOption::COMPRESSION_LEVEL:
       level_ = *(int*)value;
       return Status::Ok();
+    case FilterOption::COMPRESSION_DICTIONARY_SIZE:
+      if (compressor_ != Compressor::ZSTD)
+        return LOG_STATUS(Status::FilterError(
+            "Compression filter error; dictionaries are only supported by "
+            "zstd"));
+      dictionary_size_ = *(uint32_t*)value;
+      return Status::Ok();
+    case FilterOption::COMPRESSION_BYTESHUFFLE:
+      if (compressor_ != Compressor::LZ4 && compressor_ != Compressor::ZSTD)
+        return LOG_STATUS(Status::FilterError(
+            "Compression filter error; byteshuffling is only supported by lz4 "
+            "and zstd"));
+      byteshuffle_ = *(uint32_t*)value != 0;
+      return Status::Ok();
     default:
       return LOG_STATUS(
           Status::FilterError("Compression filter error; unknown option"));
@@ -149,6 +198,20 @@ Status CompressionFilter::get_option_impl(
     case FilterOption::COMPRESSION_LEVEL:
       *(int*)value = level_;
       return Status::Ok();
+    case FilterOption::COMPRESSION_DICTIONARY_SIZE:
+      if (compressor_ != Compressor::ZSTD)
+        return LOG_STATUS(Status::FilterError(
+            "Compression filter error; dictionaries are only supported by "
+            "zstd"));
+      *(uint32_t*)value = dictionary_size_;
+      return Status::Ok();
+    case FilterOption::COMPRESSION_BYTESHUFFLE:
+      if (compressor_ != Compressor::LZ4 && compressor_ != Compressor::ZSTD)
+        return LOG_STATUS(Status::FilterError(
+            "Compression filter error; byteshuffling is only supported by lz4 "
+            "and zstd"));
+      *(uint32_t*)value = byteshuffle_ ? 1 : 0;
+      return Status::Ok();
     default:
       return LOG_STATUS(
           Status::FilterError("Compression filter error; unknown option"));
@@ -171,9 +234,13 @@ Status CompressionFilter::run_forward(
     return LOG_STATUS(
         Status::FilterError("Input is too large to be compressed."));
 
-  // Compute the upper bound on the size of the output.
+  // Compute the upper bound on the size of the output. When byteshuffling,
+  // each cache-sized block of the data is compressed as its own part.
+  const bool shuffle = byteshuffle();
   std::vector<ConstBuffer> data_parts = input->buffers(),
                            metadata_parts = input_metadata->buffers();
+  if (shuffle)
+    data_parts = split_blocks(data_parts);
   auto num_data_parts = (uint32_t)data_parts.size(),
        num_metadata_parts = (uint32_t)metadata_parts.size(),
        total_num_parts = num_data_parts + num_metadata_parts;
@@ -198,9 +265,9 @@ Status CompressionFilter::run_forward(
 
   // Compress all parts.
   for (auto& part : metadata_parts)
-    RETURN_NOT_OK(compress_part(&part, buffer_ptr, output_metadata));
+    RETURN_NOT_OK(compress_part(&part, buffer_ptr, output_metadata, false));
   for (auto& part : data_parts)
-    RETURN_NOT_OK(compress_part(&part, buffer_ptr, output_metadata));
+    RETURN_NOT_OK(compress_part(&part, buffer_ptr, output_metadata, shuffle));
 
   return Status::Ok();
 }
@@ -230,32 +297,64 @@ Status CompressionFilter::run_reverse(
   Buffer* metadata_buffer = output_metadata->buffer_ptr(0);
   assert(metadata_buffer != nullptr);
 
+  const bool unshuffle = byteshuffle();
   for (uint32_t i = 0; i < num_metadata_parts; i++)
-    RETURN_NOT_OK(decompress_part(input, metadata_buffer, input_metadata));
+    RETURN_NOT_OK(
+        decompress_part(input, metadata_buffer, input_metadata, false));
   for (uint32_t i = 0; i < num_data_parts; i++)
-    RETURN_NOT_OK(decompress_part(input, data_buffer, input_metadata));
+    RETURN_NOT_OK(
+        decompress_part(input, data_buffer, input_metadata, unshuffle));
 
   return Status::Ok();
 }
 
-Status CompressionFilter::compress_part(
-    ConstBuffer* part, Buffer* output, FilterBuffer* output_metadata) const {
-  // Create const buffer
-  ConstBuffer input_buffer(part->data(), part->size());
+std::vector<ConstBuffer> CompressionFilter::split_blocks(
+    const std::vector<ConstBuffer>& parts) {
+  const uint64_t block_size = constants::compression_byteshuffle_block_size;
+  std::vector<ConstBuffer> blocks;
+  for (const auto& part : parts) {
+    auto data = (const char*)part.data();
+    for (uint64_t offset = 0; offset < part.size(); offset += block_size)
+      blocks.emplace_back(
+          data + offset, std::min(block_size, part.size() - offset));
+  }
+  return blocks;
+}
 
+Status CompressionFilter::compress_part(
+    ConstBuffer* part,
+    Buffer* output,
+    FilterBuffer* output_metadata,
+    bool shuffle) const {
   auto tile = pipeline_->current_tile();
   auto cell_size = tile->cell_size();
   auto type = tile->type();
 
+  // Create const buffer, shuffling the part into the thread's scratch space
+  // first if requested so that the compressor reads it while it is in cache.
+  ConstBuffer input_buffer(part->data(), part->size());
+  if (shuffle) {
+    uint8_t* scratch = thread_shuffle_scratch(part->size());
+    blosc::shuffle(
+        datatype_size(type),
+        part->size(),
+        (const uint8_t*)part->data(),
+        scratch);
+    input_buffer = ConstBuffer(scratch, part->size());
+  }
+
   // Invoke the proper compressor
   uint32_t orig_size = (uint32_t)output->size();
   switch (compressor_) {
     case Compressor::GZIP:
       RETURN_NOT_OK(GZip::compress(level_, &input_buffer, output));
       break;
-    case Compressor::ZSTD:
-      RETURN_NOT_OK(ZStd::compress(level_, &input_buffer, output));
+    case Compressor::ZSTD: {
+      const auto& dict = pipeline_->current_dictionary();
+      RETURN_NOT_OK(ZStd::compress(
+          level_, dict.data(), dict.size(), &input_buffer, output));
       break;
+    }
     case Compressor::LZ4:
       RETURN_NOT_OK(LZ4::compress(level_, &input_buffer, output));
       break;
@@ -286,7 +385,10 @@ Status CompressionFilter::compress_part(
 }
 
 Status CompressionFilter::decompress_part(
-    FilterBuffer* input, Buffer* output, FilterBuffer* input_metadata) const {
+    FilterBuffer* input,
+    Buffer* output,
+    FilterBuffer* input_metadata,
+    bool unshuffle) const {
   auto tile = pipeline_->current_tile();
   auto cell_size = tile->cell_size();
   auto type = tile->type();
@@ -307,7 +409,12 @@ Status CompressionFilter::decompress_part(
   ConstBuffer input_buffer(nullptr, 0);
   RETURN_NOT_OK(input->get_const_buffer(compressed_size, &input_buffer));
 
-  PreallocatedBuffer output_buffer(output->cur_data(), uncompressed_size);
+  // When unshuffling, decompress into the thread's scratch space and
+  // unshuffle from there into the output.
+  void* decompress_dest = output->cur_data();
+  if (unshuffle)
+    decompress_dest = thread_shuffle_scratch(uncompressed_size);
+  PreallocatedBuffer output_buffer(decompress_dest, uncompressed_size);
 
   // Invoke the proper decompressor
   Status st = Status::Ok();
@@ -318,9 +425,12 @@ Status CompressionFilter::decompress_part(
     case Compressor::GZIP:
       st = GZip::decompress(&input_buffer, &output_buffer);
       break;
-    case Compressor::ZSTD:
-      st = ZStd::decompress(&input_buffer, &output_buffer);
+    case Compressor::ZSTD: {
+      const auto& dict = pipeline_->current_dictionary();
+      st = ZStd::decompress(
+          dict.data(), dict.size(), &input_buffer, &output_buffer);
       break;
+    }
     case Compressor::LZ4:
       st = LZ4::decompress(&input_buffer, &output_buffer);
       break;
@@ -335,6 +445,13 @@ Status CompressionFilter::decompress_part(
       break;
   }
 
+  if (st.ok() && unshuffle)
+    blosc::unshuffle(
+        datatype_size(type),
+        uncompressed_size,
+        (const uint8_t*)decompress_dest,
+        (uint8_t*)output->cur_data());
+
   if (output->owns_data())
     output->advance_size(uncompressed_size);
   output->advance_offset(uncompressed_size);
@@ -371,6 +488,17 @@ Status CompressionFilter::serialize_impl(Buffer* buff) const {
   RETURN_NOT_OK(buff->write(&compressor_char, sizeof(uint8_t)));
   RETURN_NOT_OK(buff->write(&level_, sizeof(int32_t)));
 
+  // The dictionary size and the byteshuffle flag are only serialized when set,
+  // so that arrays not using them keep the original format. The flag follows
+  // the (possibly zero) dictionary size.
+  auto dict_size = dictionary_size();
+  if (dict_size > 0 || byteshuffle())
+    RETURN_NOT_OK(buff->write(&dict_size, sizeof(uint32_t)));
+  if (byteshuffle()) {
+    uint8_t shuffle_char = 1;
+    RETURN_NOT_OK(buff->write(&shuffle_char, sizeof(uint8_t)));
+  }
+
   return Status::Ok();
 }
 
@@ -379,6 +507,13 @@ Status CompressionFilter::deserialize_impl(ConstBuffer* buff) {
   RETURN_NOT_OK(buff->read(&compressor_char, sizeof(uint8_t)));
   compressor_ = static_cast<Compressor>(compressor_char);
   RETURN_NOT_OK(buff->read(&level_, sizeof(int32_t)));
+  if (buff->nbytes_left_to_read() >= sizeof(uint32_t))
+    RETURN_NOT_OK(buff->read(&dictionary_size_, sizeof(uint32_t)));
+  if (buff->nbytes_left_to_read() >= sizeof(uint8_t)) {
+    uint8_t shuffle_char;
+    RETURN_NOT_OK(buff->read(&shuffle_char, sizeof(uint8_t)));
+    byteshuffle_ = shuffle_char != 0;
+  }
 
   return Status::Ok();
 }
@@ -36,6 +36,8 @@
 #include "tiledb/sm/filter/filter.h"
 #include "tiledb/sm/misc/status.h"
 
+#include <vector>
+
 namespace tiledb {
 namespace sm {
 
@@ -70,6 +72,17 @@ enum class Compressor : uint8_t;
  *
  * The reverse (decompress) output format is simply:
  *   uint8_t[] - Array of uncompressed bytes
+ *
+ * With zstd, a non-zero dictionary size makes the filter pipeline train a
+ * dictionary of at most that many bytes per tile, which is stored once in the
+ * filtered tile and used to compress/decompress every chunk of the tile.
+ *
+ * With lz4 and zstd, the byteshuffle option fuses a ByteshuffleFilter into the
+ * compression, the way blosc does: each data part is split into cache-sized
+ * blocks, and each block is shuffled into a per-thread scratch buffer and
+ * compressed right away as its own data part (decompression unshuffles each
+ * block straight into the output). This avoids the intermediate filter buffer
+ * and the extra pass over memory of a separate byteshuffle filter.
  */
 class CompressionFilter : public Filter {
  public:
@@ -95,6 +108,18 @@ class CompressionFilter : public Filter {
   /** Return the compression level used by this filter instance. */
   int compression_level() const;
 
+  /**
+   * Return the max size of the per-tile compression dictionary, or 0 if this
+   * filter instance does not use dictionaries.
+   */
+  uint32_t dictionary_size() const;
+
+  /**
+   * Return true if this filter instance byte-shuffles data before compressing
+   * it.
+   */
+  bool byteshuffle() const;
+
   /**
    * Compress the given input into the given output.
    */
@@ -126,22 +151,44 @@ class CompressionFilter : public Filter {
   /** The compression level. */
   int level_;
 
+  /** The max size of the per-tile compression dictionary (zstd only). */
+  uint32_t dictionary_size_;
+
+  /** Whether data is byte-shuffled before compression (lz4 and zstd only). */
+  bool byteshuffle_;
+
   /** Returns a new clone of this filter. */
   CompressionFilter* clone_impl() const override;
 
-  /** Helper function to compress a single contiguous buffer (part). */
+  /**
+   * Helper function to compress a single contiguous buffer (part), optionally
+   * byte-shuffling it first.
+   */
   Status compress_part(
-      ConstBuffer* part, Buffer* output, FilterBuffer* output_metadata) const;
+      ConstBuffer* part,
+      Buffer* output,
+      FilterBuffer* output_metadata,
+      bool shuffle) const;
+
+  /**
+   * Splits the given data parts into views of at most
+   * `constants::compression_byteshuffle_block_size` bytes.
+   */
+  static std::vector<ConstBuffer> split_blocks(
+      const std::vector<ConstBuffer>& parts);
 
   /** Return the FilterType corresponding to the given Compressor. */
   static FilterType compressor_to_filter(Compressor compressor);
 
   /**
    * Helper function to decompress a single contiguous buffer (part), appending
-   * onto the single output buffer.
+   * onto the single output buffer and optionally unshuffling it.
    */
   Status decompress_part(
-      FilterBuffer* input, Buffer* output, FilterBuffer* input_metadata) const;
+      FilterBuffer* input,
+      Buffer* output,
+      FilterBuffer* input_metadata,
+      bool unshuffle) const;
 
   /** Deserializes this filter's metadata from the given buffer. */
   Status deserialize_impl(ConstBuffer* buff) override;
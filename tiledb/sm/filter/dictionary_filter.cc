@@ -0,0 +1,241 @@
+/**
+ * @file   dictionary_filter.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class DictionaryFilter.
+ */
+
+#include "tiledb/sm/filter/dictionary_filter.h"
+#include "tiledb/sm/enums/filter_type.h"
+#include "tiledb/sm/filter/filter_buffer.h"
+#include "tiledb/sm/filter/filter_pipeline.h"
+#include "tiledb/sm/misc/constants.h"
+#include "tiledb/sm/misc/logger.h"
+#include "tiledb/sm/tile/tile.h"
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <unordered_map>
+
+namespace tiledb {
+namespace sm {
+
+DictionaryFilter::DictionaryFilter()
+    : Filter(FilterType::FILTER_DICTIONARY) {
+}
+
+Status DictionaryFilter::run_forward(
+    FilterBuffer* input_metadata,
+    FilterBuffer* input,
+    FilterBuffer* output_metadata,
+    FilterBuffer* output) const {
+  // Encoding requires the input to be whole cells of the current tile
+  std::vector<ConstBuffer> parts = input->buffers();
+  std::vector<uint64_t> value_sizes;
+  if (parts.size() != 1 ||
+      input->size() > std::numeric_limits<uint32_t>::max() ||
+      !chunk_value_sizes(parts[0].data(), parts[0].size(), &value_sizes))
+    return pass_through(input_metadata, input, output_metadata, output);
+
+  // Build the dictionary, storing the position of the first occurrence of
+  // each distinct value
+  auto data = static_cast<const char*>(parts[0].data());
+  auto value_num = (uint32_t)value_sizes.size();
+  std::unordered_map<std::string, uint32_t> codes;
+  std::vector<std::pair<uint64_t, uint64_t>> entries;
+  std::vector<uint32_t> value_codes(value_num);
+  uint64_t entries_size = 0, offset = 0;
+  for (uint32_t i = 0; i < value_num; ++i) {
+    std::string value(data + offset, value_sizes[i]);
+    auto it = codes.find(value);
+    if (it == codes.end()) {
+      it = codes.emplace(std::move(value), (uint32_t)entries.size()).first;
+      entries.emplace_back(offset, value_sizes[i]);
+      entries_size += value_sizes[i];
+    }
+    value_codes[i] = it->second;
+    offset += value_sizes[i];
+  }
+
+  // Pass the chunk through if encoding does not make it smaller
+  auto entry_num = (uint32_t)entries.size();
+  uint8_t code_width = sizeof(uint32_t);
+  if (entry_num <= std::numeric_limits<uint8_t>::max() + 1u)
+    code_width = sizeof(uint8_t);
+  else if (entry_num <= std::numeric_limits<uint16_t>::max() + 1u)
+    code_width = sizeof(uint16_t);
+  uint64_t encoded_size = entry_num * sizeof(uint32_t) + entries_size +
+                          (uint64_t)value_num * code_width;
+  if (encoded_size >= input->size())
+    return pass_through(input_metadata, input, output_metadata, output);
+
+  // Write the dictionary and the codes
+  RETURN_NOT_OK(output->prepend_buffer(encoded_size));
+  for (const auto& entry : entries) {
+    auto entry_size = (uint32_t)entry.second;
+    RETURN_NOT_OK(output->write(&entry_size, sizeof(uint32_t)));
+  }
+  for (const auto& entry : entries)
+    RETURN_NOT_OK(output->write(data + entry.first, entry.second));
+  for (auto code : value_codes) {
+    if (code_width == sizeof(uint8_t)) {
+      auto c = (uint8_t)code;
+      RETURN_NOT_OK(output->write(&c, sizeof(uint8_t)));
+    } else if (code_width == sizeof(uint16_t)) {
+      auto c = (uint16_t)code;
+      RETURN_NOT_OK(output->write(&c, sizeof(uint16_t)));
+    } else {
+      RETURN_NOT_OK(output->write(&code, sizeof(uint32_t)));
+    }
+  }
+
+  // Forward the existing metadata and write the header
+  uint8_t encoded = 1;
+  auto decoded_size = (uint32_t)input->size();
+  RETURN_NOT_OK(output_metadata->append_view(input_metadata));
+  RETURN_NOT_OK(output_metadata->prepend_buffer(
+      2 * sizeof(uint8_t) + 3 * sizeof(uint32_t)));
+  RETURN_NOT_OK(output_metadata->write(&encoded, sizeof(uint8_t)));
+  RETURN_NOT_OK(output_metadata->write(&value_num, sizeof(uint32_t)));
+  RETURN_NOT_OK(output_metadata->write(&entry_num, sizeof(uint32_t)));
+  RETURN_NOT_OK(output_metadata->write(&code_width, sizeof(uint8_t)));
+  RETURN_NOT_OK(output_metadata->write(&decoded_size, sizeof(uint32_t)));
+
+  return Status::Ok();
+}
+
+Status DictionaryFilter::run_reverse(
+    FilterBuffer* input_metadata,
+    FilterBuffer* input,
+    FilterBuffer* output_metadata,
+    FilterBuffer* output) const {
+  uint8_t encoded;
+  RETURN_NOT_OK(input_metadata->read(&encoded, sizeof(uint8_t)));
+
+  if (encoded == 0) {
+    RETURN_NOT_OK(output->append_view(input));
+  } else {
+    // Read the header
+    uint32_t value_num, entry_num, decoded_size;
+    uint8_t code_width;
+    RETURN_NOT_OK(input_metadata->read(&value_num, sizeof(uint32_t)));
+    RETURN_NOT_OK(input_metadata->read(&entry_num, sizeof(uint32_t)));
+    RETURN_NOT_OK(input_metadata->read(&code_width, sizeof(uint8_t)));
+    RETURN_NOT_OK(input_metadata->read(&decoded_size, sizeof(uint32_t)));
+
+    // Read the dictionary
+    std::vector<uint32_t> entry_sizes(entry_num);
+    std::vector<uint64_t> entry_offsets(entry_num);
+    RETURN_NOT_OK(
+        input->read(entry_sizes.data(), entry_num * sizeof(uint32_t)));
+    uint64_t entries_size = 0;
+    for (uint32_t i = 0; i < entry_num; ++i) {
+      entry_offsets[i] = entries_size;
+      entries_size += entry_sizes[i];
+    }
+    ConstBuffer entries(nullptr, 0);
+    RETURN_NOT_OK(input->get_const_buffer(entries_size, &entries));
+    input->advance_offset(entries_size);
+    auto entries_data = static_cast<const char*>(entries.data());
+
+    // Decode each value
+    RETURN_NOT_OK(output->prepend_buffer(decoded_size));
+    for (uint32_t i = 0; i < value_num; ++i) {
+      uint32_t code = 0;
+      RETURN_NOT_OK(input->read(&code, code_width));
+      if (code >= entry_num)
+        return LOG_STATUS(Status::FilterError(
+            "Dictionary filter error; invalid dictionary code"));
+      RETURN_NOT_OK(output->write(
+          entries_data + entry_offsets[code], entry_sizes[code]));
+    }
+  }
+
+  // Output metadata is a view on the input metadata, skipping what was used by
+  // this filter.
+  auto md_offset = input_metadata->offset();
+  RETURN_NOT_OK(output_metadata->append_view(
+      input_metadata, md_offset, input_metadata->size() - md_offset));
+
+  return Status::Ok();
+}
+
+DictionaryFilter* DictionaryFilter::clone_impl() const {
+  return new DictionaryFilter;
+}
+
+bool DictionaryFilter::chunk_value_sizes(
+    const void* data,
+    uint64_t size,
+    std::vector<uint64_t>* value_sizes) const {
+  auto tile = pipeline_->current_tile();
+  auto offsets_tile = pipeline_->current_offsets_tile();
+  if (offsets_tile == nullptr || pipeline_->get_filter(0) != this)
+    return false;
+
+  // The chunk must lie within the var-sized data of the tile
+  auto tile_data = static_cast<const char*>(tile->internal_data());
+  auto tile_size = tile->size();
+  auto chunk_data = static_cast<const char*>(data);
+  if (chunk_data < tile_data || chunk_data + size > tile_data + tile_size)
+    return false;
+
+  // The chunk must start and end at cell boundaries
+  auto offsets = static_cast<const uint64_t*>(offsets_tile->internal_data());
+  auto offsets_end =
+      offsets + offsets_tile->size() / constants::cell_var_offset_size;
+  uint64_t start = chunk_data - tile_data, end = start + size;
+  auto it = std::lower_bound(offsets, offsets_end, start);
+  if (it == offsets_end || *it != start)
+    return false;
+  for (; it != offsets_end && *it < end; ++it) {
+    uint64_t next = (it + 1 == offsets_end) ? tile_size : *(it + 1);
+    if (next > end)
+      return false;
+    value_sizes->push_back(next - *it);
+  }
+
+  return true;
+}
+
+Status DictionaryFilter::pass_through(
+    FilterBuffer* input_metadata,
+    FilterBuffer* input,
+    FilterBuffer* output_metadata,
+    FilterBuffer* output) const {
+  uint8_t encoded = 0;
+  RETURN_NOT_OK(output->append_view(input));
+  RETURN_NOT_OK(output_metadata->append_view(input_metadata));
+  RETURN_NOT_OK(output_metadata->prepend_buffer(sizeof(uint8_t)));
+  RETURN_NOT_OK(output_metadata->write(&encoded, sizeof(uint8_t)));
+  return Status::Ok();
+}
+
+}  // namespace sm
+}  // namespace tiledb
@@ -0,0 +1,120 @@
+/**
+ * @file   dictionary_filter.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file declares class DictionaryFilter.
+ */
+
+#ifndef TILEDB_DICTIONARY_FILTER_H
+#define TILEDB_DICTIONARY_FILTER_H
+
+#include "tiledb/sm/filter/filter.h"
+#include "tiledb/sm/misc/status.h"
+
+#include <vector>
+
+namespace tiledb {
+namespace sm {
+
+/**
+ * A filter that dictionary-encodes the values of a var-sized
+ * attribute/dimension tile. The distinct values of each chunk are stored once
+ * in a dictionary, and each value is replaced by the integer code of its
+ * dictionary entry.
+ *
+ * Encoding needs the cell boundaries, so the filter only encodes input that
+ * is the unmodified var-sized data of the current tile, i.e. when it is the
+ * first filter of the pipeline. The pipeline then splits such tiles into
+ * chunks at cell boundaries. Any other input, as well as chunks whose
+ * encoding would not be smaller, is passed through unmodified.
+ *
+ * The forward output metadata has the format:
+ *   uint8_t - 1 if the chunk was encoded, 0 otherwise
+ * and, if the chunk was encoded:
+ *   uint32_t - Number of values
+ *   uint32_t - Number of dictionary entries
+ *   uint8_t - Code width in bytes (1, 2 or 4)
+ *   uint32_t - Decoded chunk size in bytes
+ * followed by the input metadata.
+ *
+ * The forward output data format, if the chunk was encoded, is:
+ *   uint32_t[] - Size of each dictionary entry
+ *   uint8_t[] - Concatenated dictionary entries
+ *   uint8_t[] - Code of each value, of the code width each
+ *
+ * The reverse output is the concatenated values of the chunk.
+ */
+class DictionaryFilter : public Filter {
+ public:
+  /** Constructor. */
+  DictionaryFilter();
+
+  /** Dictionary-encodes the values of the input chunk. */
+  Status run_forward(
+      FilterBuffer* input_metadata,
+      FilterBuffer* input,
+      FilterBuffer* output_metadata,
+      FilterBuffer* output) const override;
+
+  /** Decodes the values of the input chunk. */
+  Status run_reverse(
+      FilterBuffer* input_metadata,
+      FilterBuffer* input,
+      FilterBuffer* output_metadata,
+      FilterBuffer* output) const override;
+
+ private:
+  /** Returns a new clone of this filter. */
+  DictionaryFilter* clone_impl() const override;
+
+  /**
+   * Computes the size of each value in the input chunk, if the chunk is the
+   * unmodified var-sized data of whole cells of the current tile.
+   *
+   * @param data The chunk data.
+   * @param size The chunk size.
+   * @param value_sizes The computed value sizes.
+   * @return `true` if the value sizes could be computed.
+   */
+  bool chunk_value_sizes(
+      const void* data,
+      uint64_t size,
+      std::vector<uint64_t>* value_sizes) const;
+
+  /** Passes the input through unmodified, with a "not encoded" header. */
+  Status pass_through(
+      FilterBuffer* input_metadata,
+      FilterBuffer* input,
+      FilterBuffer* output_metadata,
+      FilterBuffer* output) const;
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_DICTIONARY_FILTER_H
@@ -39,6 +39,8 @@
 #include "tiledb/sm/misc/logger.h"
 #include "tiledb/sm/tile/tile.h"
 
+#include <cstring>
+
 namespace tiledb {
 namespace sm {
 
@@ -90,16 +92,24 @@ Status EncryptionAES256GCMFilter::run_forward(
   RETURN_NOT_OK(output_metadata->write(&num_data_parts, sizeof(uint32_t)));
 
   // Encrypt all parts
+  uint8_t chunk_iv[Encryption::AES256GCM_IV_BYTES];
+  uint32_t part_idx = 0;
   for (auto& part : metadata_parts)
-    RETURN_NOT_OK(encrypt_part(&part, output_buf, output_metadata));
+    RETURN_NOT_OK(encrypt_part(
+        &part, output_buf, output_metadata, chunk_iv, part_idx++));
   for (auto& part : data_parts)
-    RETURN_NOT_OK(encrypt_part(&part, output_buf, output_metadata));
+    RETURN_NOT_OK(encrypt_part(
+        &part, output_buf, output_metadata, chunk_iv, part_idx++));
 
   return Status::Ok();
 }
 
 Status EncryptionAES256GCMFilter::encrypt_part(
-    ConstBuffer* part, Buffer* output, FilterBuffer* output_metadata) const {
+    ConstBuffer* part,
+    Buffer* output,
+    FilterBuffer* output_metadata,
+    uint8_t* chunk_iv,
+    uint32_t part_idx) const {
   // Set up the key buffer.
   ConstBuffer key(key_bytes_, Encryption::AES256GCM_KEY_BYTES);
 
@@ -109,11 +119,34 @@ Status EncryptionAES256GCMFilter::encrypt_part(
   PreallocatedBuffer output_iv(iv, Encryption::AES256GCM_IV_BYTES),
       output_tag(tag, Encryption::AES256GCM_TAG_BYTES);
 
+  // The first part gets a random IV. The others add their index to the 32-bit
+  // big-endian counter in the last bytes of that IV.
+  uint8_t derived_iv[Encryption::AES256GCM_IV_BYTES];
+  ConstBuffer derived_iv_buff(derived_iv, Encryption::AES256GCM_IV_BYTES);
+  if (part_idx > 0) {
+    const unsigned counter_offset = Encryption::AES256GCM_IV_BYTES - 4;
+    std::memcpy(derived_iv, chunk_iv, counter_offset);
+    uint32_t counter = 0;
+    for (unsigned i = counter_offset; i < Encryption::AES256GCM_IV_BYTES; i++)
+      counter = (counter << 8) | chunk_iv[i];
+    counter += part_idx;
+    for (unsigned i = 0; i < 4; i++)
+      derived_iv[Encryption::AES256GCM_IV_BYTES - 1 - i] =
+          (uint8_t)(counter >> (8 * i));
+  }
+
   // Encrypt.
   auto orig_size = (uint32_t)output->size();
 
   RETURN_NOT_OK(Encryption::encrypt_aes256gcm(
-      &key, nullptr, part, output, &output_iv, &output_tag));
+      &key,
+      part_idx > 0 ? &derived_iv_buff : nullptr,
+      part,
+      output,
+      &output_iv,
+      &output_tag));
+  if (part_idx == 0)
+    std::memcpy(chunk_iv, iv, Encryption::AES256GCM_IV_BYTES);
 
   if (output->size() > std::numeric_limits<uint32_t>::max())
     return LOG_STATUS(
@@ -47,6 +47,9 @@ class EncryptionKey;
  *
  * If the input comes in multiple FilterBuffer parts, each part is encrypted
  * independently in the forward direction. Input metadata is encrypted as well.
+ * The first part of a chunk is encrypted under a random IV, and the following
+ * parts under IVs derived from it by incrementing its last 32 bits (big
+ * endian), so that only one IV per chunk is drawn from the random generator.
  *
  * The forward output metadata has the format:
  *   uint32_t - Number of encrypted metadata parts
@@ -154,10 +157,17 @@ class EncryptionAES256GCMFilter : public Filter {
    * @param input Plaintext to encrypt
    * @param output Buffer to hold encrypted bytes
    * @param output_metadata Metadata about ciphertext
+   * @param chunk_iv The IV of the first part of the chunk, set when
+   *    `part_idx` is 0 and used to derive the IVs of the following parts
+   * @param part_idx Index of the part in the chunk
    * @return Status
    */
   Status encrypt_part(
-      ConstBuffer* part, Buffer* output, FilterBuffer* output_metadata) const;
+      ConstBuffer* part,
+      Buffer* output,
+      FilterBuffer* output_metadata,
+      uint8_t* chunk_iv,
+      uint32_t part_idx) const;
 };
 
 }  // namespace sm
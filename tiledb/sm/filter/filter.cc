@@ -37,7 +37,10 @@
 #include "tiledb/sm/filter/bitshuffle_filter.h"
 #include "tiledb/sm/filter/byteshuffle_filter.h"
 #include "tiledb/sm/filter/compression_filter.h"
+#include "tiledb/sm/filter/dictionary_filter.h"
 #include "tiledb/sm/filter/encryption_aes256gcm_filter.h"
+#include "tiledb/sm/filter/float_xor_filter.h"
+#include "tiledb/sm/filter/frame_of_reference_filter.h"
 #include "tiledb/sm/filter/noop_filter.h"
 #include "tiledb/sm/filter/positive_delta_filter.h"
 #include "tiledb/sm/misc/logger.h"
@@ -77,6 +80,12 @@ Filter* Filter::create(FilterType type) {
       return new (std::nothrow) ByteshuffleFilter();
     case FilterType::FILTER_POSITIVE_DELTA:
       return new (std::nothrow) PositiveDeltaFilter();
+    case FilterType::FILTER_DICTIONARY:
+      return new (std::nothrow) DictionaryFilter();
+    case FilterType::FILTER_FLOAT_XOR:
+      return new (std::nothrow) FloatXorFilter();
+    case FilterType::FILTER_FRAME_OF_REFERENCE:
+      return new (std::nothrow) FrameOfReferenceFilter();
     case FilterType::INTERNAL_FILTER_AES_256_GCM:
       return new (std::nothrow) EncryptionAES256GCMFilter();
     default:
@@ -107,14 +116,22 @@ Status Filter::deserialize(ConstBuffer* buff, Filter** filter) {
   if (f == nullptr)
     return LOG_STATUS(Status::FilterError("Deserialization error."));
 
-  auto offset = buff->offset();
-  RETURN_NOT_OK_ELSE(f->deserialize_impl(buff), delete f);
+  // Deserialize from a view bounded by the metadata length, so that filters
+  // can detect optional trailing metadata fields
+  if (buff->nbytes_left_to_read() < filter_metadata_len) {
+    delete f;
+    return LOG_STATUS(Status::FilterError(
+        "Deserialization error; unexpected metadata length"));
+  }
+  ConstBuffer metadata(buff->cur_data(), filter_metadata_len);
+  RETURN_NOT_OK_ELSE(f->deserialize_impl(&metadata), delete f);
 
-  if (buff->offset() - offset != filter_metadata_len) {
+  if (metadata.offset() != filter_metadata_len) {
     delete f;
     return LOG_STATUS(Status::FilterError(
         "Deserialization error; unexpected metadata length"));
   }
+  buff->advance_offset(filter_metadata_len);
 
   *filter = f;
 
@@ -31,14 +31,18 @@
  */
 
 #include "tiledb/sm/filter/filter_pipeline.h"
+#include "tiledb/sm/compressors/zstd_compressor.h"
 #include "tiledb/sm/encryption/encryption_key.h"
+#include "tiledb/sm/enums/compressor.h"
 #include "tiledb/sm/enums/encryption_type.h"
 #include "tiledb/sm/enums/filter_type.h"
 #include "tiledb/sm/filter/compression_filter.h"
+#include "tiledb/sm/filter/dictionary_filter.h"
 #include "tiledb/sm/filter/encryption_aes256gcm_filter.h"
 #include "tiledb/sm/filter/filter.h"
 #include "tiledb/sm/filter/filter_storage.h"
 #include "tiledb/sm/filter/noop_filter.h"
+#include "tiledb/sm/global_state/tbb_state.h"
 #include "tiledb/sm/misc/logger.h"
 #include "tiledb/sm/misc/parallel_functions.h"
 #include "tiledb/sm/misc/stats.h"
@@ -47,8 +51,38 @@
 namespace tiledb {
 namespace sm {
 
+namespace {
+
+/**
+ * Returns the storage of the intermediate filter buffers of the chunks run by
+ * the calling thread, so that their allocations are reused across chunks and
+ * tiles.
+ */
+FilterStorage* thread_filter_storage() {
+  static thread_local FilterStorage storage;
+  return &storage;
+}
+
+/**
+ * Returns the (tile, chunk) index pairs of all the chunks of tiles with the
+ * given numbers of chunks.
+ */
+std::vector<std::pair<uint64_t, uint64_t>> flatten_chunks(
+    const std::vector<uint64_t>& chunk_nums) {
+  std::vector<std::pair<uint64_t, uint64_t>> work;
+  for (uint64_t t = 0; t < chunk_nums.size(); t++) {
+    for (uint64_t c = 0; c < chunk_nums[t]; c++)
+      work.emplace_back(t, c);
+  }
+  return work;
+}
+
+}  // namespace
+
 FilterPipeline::FilterPipeline() {
   current_tile_ = nullptr;
+  current_offsets_tile_ = nullptr;
+  unfiltered_in_place_ = false;
   max_chunk_size_ = constants::max_tile_chunk_size;
 }
 
@@ -57,6 +91,9 @@ FilterPipeline::FilterPipeline(const FilterPipeline& other) {
     add_filter(*filter);
   }
   current_tile_ = other.current_tile_;
+  current_dictionary_ = other.current_dictionary_;
+  current_offsets_tile_ = other.current_offsets_tile_;
+  unfiltered_in_place_ = false;
   max_chunk_size_ = other.max_chunk_size_;
 }
 
@@ -90,6 +127,11 @@ void FilterPipeline::clear() {
 
 Status FilterPipeline::compute_tile_chunks(
     Tile* tile, std::vector<std::pair<void*, uint32_t>>* chunks) const {
+  // Dictionary encoding needs chunks of whole cells
+  if (current_offsets_tile_ != nullptr &&
+      get_filter<DictionaryFilter>() != nullptr)
+    return compute_var_tile_chunks(tile, chunks);
+
   // For coordinate tiles, we treat each dimension separately (chunks won't
   // cross dimension boundaries, since the coordinates have been split).
   // Attribute tiles are treated as a whole.
@@ -99,7 +141,8 @@ Status FilterPipeline::compute_tile_chunks(
 
   // Compute a chunk size as a multiple of the cell size, ensuring that the
   // chunk contains always at least 1 cell.
-  uint64_t chunk_size = std::min((uint64_t)max_chunk_size_, dim_tile_size);
+  uint64_t chunk_size =
+      std::min(this->chunk_size(dim_tile_size), dim_tile_size);
   chunk_size = chunk_size / dim_cell_size * dim_cell_size;
   chunk_size = std::max(chunk_size, dim_cell_size);
   if (chunk_size > std::numeric_limits<uint32_t>::max())
@@ -127,305 +170,366 @@ Status FilterPipeline::compute_tile_chunks(
   return Status::Ok();
 }
 
-const Tile* FilterPipeline::current_tile() const {
-  return current_tile_;
-}
-
-Status FilterPipeline::filter_chunks_forward(
-    const std::vector<std::pair<void*, uint32_t>>& chunks,
-    Buffer* output) const {
-  // Vector storing the input and output of the final pipeline stage for each
-  // chunk.
-  std::vector<std::pair<FilterBufferPair, FilterBufferPair>> final_stage_io(
-      chunks.size());
-
-  // Run each chunk through the entire pipeline.
-  auto statuses = parallel_for(0, chunks.size(), [&](uint64_t i) {
-    // TODO(ttd): can we instead allocate one FilterStorage per thread?
-    // or make it threadsafe?
-    FilterStorage storage;
-    FilterBuffer input_data(&storage), output_data(&storage);
-    FilterBuffer input_metadata(&storage), output_metadata(&storage);
-
-    // First filter's input is the original chunk.
-    const auto& chunk_input = chunks[i];
-    RETURN_NOT_OK(input_data.init(chunk_input.first, chunk_input.second));
-
-    // Apply the filters sequentially.
-    for (auto it = filters_.begin(), ite = filters_.end(); it != ite; ++it) {
-      auto& f = *it;
+Status FilterPipeline::compute_var_tile_chunks(
+    Tile* tile, std::vector<std::pair<void*, uint32_t>>* chunks) const {
+  auto offsets =
+      static_cast<const uint64_t*>(current_offsets_tile_->internal_data());
+  auto cell_num =
+      current_offsets_tile_->size() / constants::cell_var_offset_size;
+  auto tile_size = tile->size();
+  auto data = static_cast<char*>(tile->internal_data());
+  auto max_chunk_size = chunk_size(tile_size);
+
+  // Close the current chunk before a cell that does not fit in it. A cell
+  // larger than the max chunk size forms a chunk on its own.
+  std::vector<uint64_t> chunk_starts;
+  uint64_t chunk_start = 0;
+  for (uint64_t i = 0; i < cell_num; ++i) {
+    uint64_t cell_start = offsets[i];
+    uint64_t cell_end = (i + 1 < cell_num) ? offsets[i + 1] : tile_size;
+    if (cell_end - chunk_start > max_chunk_size && cell_start > chunk_start) {
+      chunk_starts.push_back(chunk_start);
+      chunk_start = cell_start;
+    }
+  }
+  if (tile_size > chunk_start)
+    chunk_starts.push_back(chunk_start);
+
+  for (uint64_t i = 0; i < chunk_starts.size(); ++i) {
+    uint64_t end =
+        (i + 1 < chunk_starts.size()) ? chunk_starts[i + 1] : tile_size;
+    if (end - chunk_starts[i] > std::numeric_limits<uint32_t>::max())
+      return LOG_STATUS(
+          Status::FilterError("Filter error; chunk size exceeds uint32_t"));
+    chunks->emplace_back(
+        data + chunk_starts[i], static_cast<uint32_t>(end - chunk_starts[i]));
+  }
 
-      // Clear and reset I/O buffers
-      input_data.reset_offset();
-      input_data.set_read_only(true);
-      input_metadata.reset_offset();
-      input_metadata.set_read_only(true);
+  return Status::Ok();
+}
 
-      output_data.clear();
-      output_metadata.clear();
+uint64_t FilterPipeline::chunk_size(uint64_t tile_size) const {
+  if (max_chunk_size_ > 0)
+    return max_chunk_size_;
+
+  // Split the tile evenly across the threads
+  uint64_t num_threads = global_state::tbb_num_threads();
+  uint64_t even_size = (tile_size + num_threads - 1) / num_threads;
+
+  // Keep the chunks large enough for the compressor
+  uint64_t min_size = constants::max_tile_chunk_size;
+  auto compression_filter = get_filter<CompressionFilter>();
+  if (compression_filter != nullptr) {
+    auto compressor = compression_filter->compressor();
+    if (compressor == Compressor::ZSTD || compressor == Compressor::GZIP ||
+        compressor == Compressor::BZIP2)
+      min_size = constants::auto_tile_chunk_min_size_large_window;
+  }
 
-      RETURN_NOT_OK(f->run_forward(
-          &input_metadata, &input_data, &output_metadata, &output_data));
+  return std::min(
+      std::max(even_size, min_size), constants::auto_tile_chunk_max_size);
+}
 
-      input_data.set_read_only(false);
-      input_data.swap(output_data);
-      input_metadata.set_read_only(false);
-      input_metadata.swap(output_metadata);
-      // Next input (input_buffers) now stores this output (output_buffers).
-    }
+const Tile* FilterPipeline::current_tile() const {
+  return current_tile_;
+}
 
-    // Save the finished chunk (last stage's output). This is safe to do because
-    // when the local FilterStorage goes out of scope, it will not free the
-    // buffers saved here as their shared_ptr counters will not be zero.
-    // However, as the output may have been a view on the input, we do need to
-    // save both here to prevent the input buffer from being freed.
-    auto& io = final_stage_io[i];
-    auto& io_input = io.first;
-    auto& io_output = io.second;
-    io_input.first.swap(input_metadata);
-    io_input.second.swap(input_data);
-    io_output.first.swap(output_metadata);
-    io_output.second.swap(output_data);
+const Tile* FilterPipeline::current_offsets_tile() const {
+  return current_offsets_tile_;
+}
 
-    return Status::Ok();
-  });
+const std::vector<uint8_t>& FilterPipeline::current_dictionary() const {
+  return current_dictionary_;
+}
 
-  // Check statuses
-  for (auto st : statuses)
-    RETURN_NOT_OK(st);
+uint32_t FilterPipeline::dictionary_size() const {
+  auto compression_filter = get_filter<CompressionFilter>();
+  return compression_filter == nullptr ? 0 :
+                                         compression_filter->dictionary_size();
+}
 
-  // Compute the destination offset of each processed chunk in the final output
-  // buffer.
-  uint64_t offset = output->offset();
-  uint64_t total_processed_size = 0;
-  std::vector<uint64_t> offsets(final_stage_io.size());
-  for (uint64_t i = 0; i < final_stage_io.size(); i++) {
-    auto& final_stage_output_metadata = final_stage_io[i].first.first;
-    auto& final_stage_output_data = final_stage_io[i].first.second;
-
-    // Check the size doesn't exceed the limit (should never happen).
-    if (final_stage_output_data.size() > std::numeric_limits<uint32_t>::max() ||
-        final_stage_output_metadata.size() >
-            std::numeric_limits<uint32_t>::max())
-      return LOG_STATUS(Status::FilterError(
-          "Filter error; filtered chunk size exceeds uint32_t"));
-
-    // Leave space for the chunk sizes and the data itself.
-    auto space_required = 3 * sizeof(uint32_t) +
-                          final_stage_output_data.size() +
-                          final_stage_output_metadata.size();
-    offsets[i] = offset;
-    offset += space_required;
-    total_processed_size += space_required;
-  }
+Status FilterPipeline::train_dictionary(
+    const Tile* tile, uint32_t max_size) const {
+  auto sample_budget = std::min(
+      tile->size(), (uint64_t)max_size * constants::dictionary_training_ratio);
+  std::vector<size_t> sample_sizes;
+  for (uint64_t offset = 0; offset < sample_budget;
+       offset += constants::dictionary_sample_size)
+    sample_sizes.push_back((size_t)std::min(
+        constants::dictionary_sample_size, sample_budget - offset));
+
+  return ZStd::train_dictionary(
+      tile->internal_data(), sample_sizes, max_size, &current_dictionary_);
+}
 
-  // Concatenate all processed chunks into the final output buffer.
-  RETURN_NOT_OK(output->realloc(output->size() + total_processed_size));
-  statuses = parallel_for(0, final_stage_io.size(), [&](uint64_t i) {
-    auto& final_stage_output_metadata = final_stage_io[i].first.first;
-    auto& final_stage_output_data = final_stage_io[i].first.second;
-    auto filtered_size = (uint32_t)final_stage_output_data.size();
-    auto orig_chunk_size = chunks[i].second;
-    auto metadata_size = (uint32_t)final_stage_output_metadata.size();
-    void* dest = output->data(offsets[i]);
-    uint64_t dest_offset = 0;
-
-    // Write the original (unfiltered) chunk size
-    std::memcpy((char*)dest + dest_offset, &orig_chunk_size, sizeof(uint32_t));
-    dest_offset += sizeof(uint32_t);
-    // Write the filtered chunk size
-    std::memcpy((char*)dest + dest_offset, &filtered_size, sizeof(uint32_t));
-    dest_offset += sizeof(uint32_t);
-    // Write the metadata size
-    std::memcpy((char*)dest + dest_offset, &metadata_size, sizeof(uint32_t));
-    dest_offset += sizeof(uint32_t);
-    // Write the chunk metadata
-    RETURN_NOT_OK(
-        final_stage_output_metadata.copy_to((char*)dest + dest_offset));
-    dest_offset += metadata_size;
-    // Write the chunk data
-    RETURN_NOT_OK(final_stage_output_data.copy_to((char*)dest + dest_offset));
-    return Status::Ok();
-  });
+Status FilterPipeline::prepare_forward(
+    Tile* tile, const Tile* offsets_tile, uint64_t* num_chunks) const {
+  current_tile_ = tile;
+  current_offsets_tile_ = offsets_tile;
 
-  // Check statuses
-  for (auto st : statuses)
-    RETURN_NOT_OK(st);
+  // Compute the chunks.
+  forward_chunks_.clear();
+  RETURN_NOT_OK(compute_tile_chunks(tile, &forward_chunks_));
+  *num_chunks = forward_chunks_.size();
+  if (*num_chunks == 0)
+    return Status::FilterError("Filter error; tile has 0 chunks.");
+  filtered_chunks_.clear();
+  filtered_chunks_.resize(*num_chunks);
 
-  // Ensure the final size is set to the concatenated size.
-  output->advance_offset(total_processed_size);
-  output->advance_size(total_processed_size);
+  // Train the compression dictionary shared by all chunks.
+  current_dictionary_.clear();
+  auto dict_max_size = dictionary_size();
+  if (dict_max_size > 0)
+    RETURN_NOT_OK(train_dictionary(tile, dict_max_size));
 
   return Status::Ok();
 }
 
-Status FilterPipeline::filter_chunks_reverse(
-    const std::vector<std::tuple<void*, uint32_t, uint32_t, uint32_t>>& chunks,
-    Buffer* output) const {
-  // Precompute the offsets for the final chunks in the shared output buffer.
-  std::vector<uint64_t> chunk_dest_offsets(chunks.size());
-  uint64_t chunk_dest_offset = 0;
-  for (uint64_t i = 0; i < chunks.size(); i++) {
-    chunk_dest_offsets[i] = chunk_dest_offset;
-    chunk_dest_offset += std::get<2>(chunks[i]);
-  }
+Status FilterPipeline::filter_chunk_forward(
+    uint64_t chunk_idx, FilterStorage* storage) const {
+  FilterBuffer input_data(storage), output_data(storage);
+  FilterBuffer input_metadata(storage), output_metadata(storage);
 
-  // Run each chunk through the entire pipeline.
-  auto statuses = parallel_for(0, chunks.size(), [&](uint64_t i) {
-    const auto& chunk_input = chunks[i];
-    uint32_t filtered_chunk_len = std::get<1>(chunk_input);
-    uint32_t orig_chunk_len = std::get<2>(chunk_input);
-    uint32_t metadata_len = std::get<3>(chunk_input);
-    void* metadata = std::get<0>(chunk_input);
-    void* chunk_data = (char*)metadata + metadata_len;
-
-    // TODO(ttd): can we instead allocate one FilterStorage per thread?
-    // or make it threadsafe?
-    FilterStorage storage;
-    FilterBuffer input_data(&storage), output_data(&storage);
-    FilterBuffer input_metadata(&storage), output_metadata(&storage);
-
-    // First filter's input is the filtered chunk data.
-    RETURN_NOT_OK(input_metadata.init(metadata, metadata_len));
-    RETURN_NOT_OK(input_data.init(chunk_data, filtered_chunk_len));
-
-    // If the pipeline is empty, just copy input to output.
-    if (filters_.empty()) {
-      RETURN_NOT_OK(input_data.copy_to(output->data(chunk_dest_offsets[i])));
-      return Status::Ok();
-    }
+  // First filter's input is the original chunk.
+  const auto& chunk_input = forward_chunks_[chunk_idx];
+  RETURN_NOT_OK(input_data.init(chunk_input.first, chunk_input.second));
 
-    // Apply the filters sequentially in reverse.
-    for (int64_t filter_idx = (int64_t)filters_.size() - 1; filter_idx >= 0;
-         filter_idx--) {
-      auto& f = filters_[filter_idx];
-
-      // Clear and reset I/O buffers
-      input_data.reset_offset();
-      input_data.set_read_only(true);
-      input_metadata.reset_offset();
-      input_metadata.set_read_only(true);
-
-      output_data.clear();
-      output_metadata.clear();
-
-      // Final filter: output directly into the shared output buffer.
-      bool last_filter = filter_idx == 0;
-      if (last_filter) {
-        void* dest = output->data(chunk_dest_offsets[i]);
-        RETURN_NOT_OK(output_data.set_fixed_allocation(dest, orig_chunk_len));
-      }
-
-      RETURN_NOT_OK(f->run_reverse(
-          &input_metadata, &input_data, &output_metadata, &output_data));
-
-      input_data.set_read_only(false);
-      input_metadata.set_read_only(false);
-
-      if (!last_filter) {
-        input_data.swap(output_data);
-        input_metadata.swap(output_metadata);
-        // Next input (input_buffers) now stores this output (output_buffers).
-      }
-    }
+  // Apply the filters sequentially.
+  for (auto it = filters_.begin(), ite = filters_.end(); it != ite; ++it) {
+    auto& f = *it;
 
-    return Status::Ok();
-  });
+    // Clear and reset I/O buffers
+    input_data.reset_offset();
+    input_data.set_read_only(true);
+    input_metadata.reset_offset();
+    input_metadata.set_read_only(true);
 
-  // Check statuses
-  for (auto st : statuses)
-    RETURN_NOT_OK(st);
-
-  // Ensure the final size is set to the sum of unfiltered chunk sizes.
-  output->set_offset(chunk_dest_offset);
-  output->set_size(chunk_dest_offset);
+    output_data.clear();
+    output_metadata.clear();
 
-  return Status::Ok();
-}
+    RETURN_NOT_OK(f->run_forward(
+        &input_metadata, &input_data, &output_metadata, &output_data));
 
-Filter* FilterPipeline::get_filter(unsigned index) const {
-  if (index >= filters_.size())
-    return nullptr;
+    input_data.set_read_only(false);
+    input_data.swap(output_data);
+    input_metadata.set_read_only(false);
+    input_metadata.swap(output_metadata);
+    // Next input (input_buffers) now stores this output (output_buffers).
+  }
 
-  return filters_[index].get();
-}
+  // Check the size doesn't exceed the limit (should never happen).
+  if (input_data.size() > std::numeric_limits<uint32_t>::max() ||
+      input_metadata.size() > std::numeric_limits<uint32_t>::max())
+    return LOG_STATUS(Status::FilterError(
+        "Filter error; filtered chunk size exceeds uint32_t"));
+
+  // Save the finished chunk (last stage's output) with its sizes, so that the
+  // intermediate buffers can be reused by the next chunk of this thread.
+  auto orig_chunk_size = chunk_input.second;
+  auto filtered_size = (uint32_t)input_data.size();
+  auto metadata_size = (uint32_t)input_metadata.size();
+  auto& chunk = filtered_chunks_[chunk_idx];
+  RETURN_NOT_OK(
+      chunk.realloc(3 * sizeof(uint32_t) + metadata_size + filtered_size));
+  // Write the original (unfiltered) chunk size
+  RETURN_NOT_OK(chunk.write(&orig_chunk_size, sizeof(uint32_t)));
+  // Write the filtered chunk size
+  RETURN_NOT_OK(chunk.write(&filtered_size, sizeof(uint32_t)));
+  // Write the metadata size
+  RETURN_NOT_OK(chunk.write(&metadata_size, sizeof(uint32_t)));
+  // Write the chunk metadata
+  RETURN_NOT_OK(input_metadata.copy_to(chunk.cur_data()));
+  chunk.advance_offset(metadata_size);
+  chunk.advance_size(metadata_size);
+  // Write the chunk data
+  RETURN_NOT_OK(input_data.copy_to(chunk.cur_data()));
+  chunk.advance_offset(filtered_size);
+  chunk.advance_size(filtered_size);
 
-uint32_t FilterPipeline::max_chunk_size() const {
-  return max_chunk_size_;
+  return Status::Ok();
 }
 
-Status FilterPipeline::run_forward(Tile* tile) const {
-  STATS_FUNC_IN(filter_pipeline_run_forward);
-
-  current_tile_ = tile;
-
-  // Compute the chunks.
-  std::vector<std::pair<void*, uint32_t>> chunks;
-  RETURN_NOT_OK(compute_tile_chunks(tile, &chunks));
-  uint64_t num_chunks = chunks.size();
-  if (num_chunks == 0)
-    return Status::FilterError("Filter error; tile has 0 chunks.");
-
-  // Allocate a buffer to hold the end result (the concatentated, filtered
-  // chunks), and write the number of chunks.
+Status FilterPipeline::finish_forward(Tile* tile) const {
+  // Compute the size of the end result (the concatenated, filtered chunks)
+  uint64_t num_chunks = filtered_chunks_.size();
+  auto dict_size = (uint32_t)current_dictionary_.size();
+  uint64_t filtered_tile_size = sizeof(uint64_t);
+  if (dictionary_size() > 0)
+    filtered_tile_size += sizeof(uint32_t) + dict_size;
+  for (const auto& chunk : filtered_chunks_)
+    filtered_tile_size += chunk.size();
+
+  // Write the number of chunks, followed by the compression dictionary shared
+  // by all chunks (if any) as its size (uint32_t) and bytes.
   Buffer filtered_tile;
-  filtered_tile.realloc(tile->buffer()->size());
+  RETURN_NOT_OK(filtered_tile.realloc(filtered_tile_size));
   RETURN_NOT_OK(filtered_tile.write(&num_chunks, sizeof(uint64_t)));
+  if (dictionary_size() > 0) {
+    RETURN_NOT_OK(filtered_tile.write(&dict_size, sizeof(uint32_t)));
+    RETURN_NOT_OK(filtered_tile.write(current_dictionary_.data(), dict_size));
+  }
 
-  // Run the filters over all the chunks into the filtered_tile buffer.
-  RETURN_NOT_OK(filter_chunks_forward(chunks, &filtered_tile));
+  // Concatenate all processed chunks.
+  for (const auto& chunk : filtered_chunks_)
+    RETURN_NOT_OK(filtered_tile.write(chunk.data(), chunk.size()));
+  filtered_chunks_.clear();
+  forward_chunks_.clear();
 
   // Replace the tile's buffer with the filtered buffer.
   RETURN_NOT_OK(tile->buffer()->swap(filtered_tile));
 
   return Status::Ok();
-
-  STATS_FUNC_OUT(filter_pipeline_run_forward);
 }
 
-Status FilterPipeline::run_reverse(Tile* tile) const {
-  STATS_FUNC_IN(filter_pipeline_run_reverse);
-
+Status FilterPipeline::prepare_reverse(
+    Tile* tile, void* dest, uint64_t dest_size, uint64_t* num_chunks) const {
   auto tile_buff = tile->buffer();
   if (tile_buff == nullptr)
     return LOG_STATUS(
         Status::FilterError("Filter error; tile has null buffer."));
 
   current_tile_ = tile;
+  current_offsets_tile_ = nullptr;
+  unfiltered_in_place_ = false;
 
   // First make a pass over the tile to get the chunk information.
   tile_buff->reset_offset();
-  uint64_t num_chunks;
-  RETURN_NOT_OK(tile_buff->read(&num_chunks, sizeof(uint64_t)));
-  std::vector<std::tuple<void*, uint32_t, uint32_t, uint32_t>> chunks(
-      num_chunks);
+  RETURN_NOT_OK(tile_buff->read(num_chunks, sizeof(uint64_t)));
+
+  // Load the compression dictionary shared by all chunks
+  current_dictionary_.clear();
+  if (dictionary_size() > 0) {
+    uint32_t dict_size;
+    RETURN_NOT_OK(tile_buff->read(&dict_size, sizeof(uint32_t)));
+    current_dictionary_.resize(dict_size);
+    RETURN_NOT_OK(tile_buff->read(current_dictionary_.data(), dict_size));
+  }
+  reverse_chunks_.resize(*num_chunks);
+  chunk_dest_offsets_.resize(*num_chunks);
   uint64_t total_orig_size = 0;
-  for (uint64_t i = 0; i < num_chunks; i++) {
+  for (uint64_t i = 0; i < *num_chunks; i++) {
     uint32_t filtered_chunk_size, orig_chunk_size, metadata_size;
     RETURN_NOT_OK(tile_buff->read(&orig_chunk_size, sizeof(uint32_t)));
     RETURN_NOT_OK(tile_buff->read(&filtered_chunk_size, sizeof(uint32_t)));
     RETURN_NOT_OK(tile_buff->read(&metadata_size, sizeof(uint32_t)));
-    chunks[i] = std::make_tuple(
+    reverse_chunks_[i] = std::make_tuple(
         tile_buff->cur_data(),
         filtered_chunk_size,
         orig_chunk_size,
         metadata_size);
     tile_buff->advance_offset(metadata_size + filtered_chunk_size);
+    chunk_dest_offsets_[i] = total_orig_size;
     total_orig_size += orig_chunk_size;
   }
   assert(tile_buff->offset() == tile_buff->size());
 
+  // If the tile is memory-mapped and its single chunk passes through an empty
+  // pipeline, point the tile buffer directly at the mapped chunk data.
+  if (dest == nullptr && filters_.empty() && *num_chunks == 1 &&
+      tile->mapped_region() != nullptr && !tile->stores_coords() &&
+      std::get<1>(reverse_chunks_[0]) == std::get<2>(reverse_chunks_[0])) {
+    const auto& chunk = reverse_chunks_[0];
+    auto chunk_data = (char*)std::get<0>(chunk) + std::get<3>(chunk);
+    Buffer view(chunk_data, std::get<2>(chunk));
+    RETURN_NOT_OK(tile_buff->swap(view));
+    reverse_chunks_.clear();
+    chunk_dest_offsets_.clear();
+    unfiltered_in_place_ = true;
+    *num_chunks = 0;
+    return Status::Ok();
+  }
+
   // Allocate a buffer to hold the end result (the assembled, unfiltered
-  // chunks).
-  Buffer unfiltered_tile;
-  RETURN_NOT_OK(unfiltered_tile.realloc(total_orig_size));
+  // chunks), or wrap the destination.
+  unfiltered_tile_.clear();
+  if (dest == nullptr) {
+    RETURN_NOT_OK(unfiltered_tile_.realloc(total_orig_size));
+  } else {
+    if (total_orig_size > dest_size)
+      return LOG_STATUS(Status::FilterError(
+          "Filter error; destination too small for the unfiltered tile."));
+    Buffer view(dest, dest_size);
+    RETURN_NOT_OK(unfiltered_tile_.swap(view));
+  }
+
+  return Status::Ok();
+}
+
+Status FilterPipeline::filter_chunk_reverse(
+    uint64_t chunk_idx, FilterStorage* storage) const {
+  const auto& chunk_input = reverse_chunks_[chunk_idx];
+  uint32_t filtered_chunk_len = std::get<1>(chunk_input);
+  uint32_t orig_chunk_len = std::get<2>(chunk_input);
+  uint32_t metadata_len = std::get<3>(chunk_input);
+  void* metadata = std::get<0>(chunk_input);
+  void* chunk_data = (char*)metadata + metadata_len;
+  void* dest = unfiltered_tile_.data(chunk_dest_offsets_[chunk_idx]);
+
+  FilterBuffer input_data(storage), output_data(storage);
+  FilterBuffer input_metadata(storage), output_metadata(storage);
+
+  // First filter's input is the filtered chunk data.
+  RETURN_NOT_OK(input_metadata.init(metadata, metadata_len));
+  RETURN_NOT_OK(input_data.init(chunk_data, filtered_chunk_len));
+
+  // If the pipeline is empty, just copy input to output.
+  if (filters_.empty()) {
+    RETURN_NOT_OK(input_data.copy_to(dest));
+    return Status::Ok();
+  }
+
+  // Apply the filters sequentially in reverse.
+  for (int64_t filter_idx = (int64_t)filters_.size() - 1; filter_idx >= 0;
+       filter_idx--) {
+    auto& f = filters_[filter_idx];
+
+    // Clear and reset I/O buffers
+    input_data.reset_offset();
+    input_data.set_read_only(true);
+    input_metadata.reset_offset();
+    input_metadata.set_read_only(true);
+
+    output_data.clear();
+    output_metadata.clear();
+
+    // Final filter: output directly into the shared output buffer.
+    bool last_filter = filter_idx == 0;
+    if (last_filter)
+      RETURN_NOT_OK(output_data.set_fixed_allocation(dest, orig_chunk_len));
+
+    RETURN_NOT_OK(f->run_reverse(
+        &input_metadata, &input_data, &output_metadata, &output_data));
+
+    input_data.set_read_only(false);
+    input_metadata.set_read_only(false);
+
+    if (!last_filter) {
+      input_data.swap(output_data);
+      input_metadata.swap(output_metadata);
+      // Next input (input_buffers) now stores this output (output_buffers).
+    }
+  }
 
-  // Run the filters in reverse over all the chunks into the unfiltered_tile
-  // buffer.
-  RETURN_NOT_OK(filter_chunks_reverse(chunks, &unfiltered_tile));
+  return Status::Ok();
+}
 
-  // Replace the tile's buffer with the unfiltered buffer.
-  RETURN_NOT_OK(tile->buffer()->swap(unfiltered_tile));
+Status FilterPipeline::finish_reverse(Tile* tile) const {
+  if (unfiltered_in_place_)
+    return Status::Ok();
+
+  // Ensure the final size is set to the sum of unfiltered chunk sizes.
+  uint64_t total_orig_size = 0;
+  for (const auto& chunk : reverse_chunks_)
+    total_orig_size += std::get<2>(chunk);
+  unfiltered_tile_.set_offset(total_orig_size);
+  unfiltered_tile_.set_size(total_orig_size);
+  reverse_chunks_.clear();
+  chunk_dest_offsets_.clear();
+
+  // Replace the tile's buffer with the unfiltered buffer, releasing the
+  // filtered data.
+  RETURN_NOT_OK(tile->buffer()->swap(unfiltered_tile_));
+  unfiltered_tile_.clear();
 
   // Zip the coords.
   if (tile->stores_coords()) {
@@ -440,6 +544,122 @@ Status FilterPipeline::run_reverse(Tile* tile) const {
   }
 
   return Status::Ok();
+}
+
+Filter* FilterPipeline::get_filter(unsigned index) const {
+  if (index >= filters_.size())
+    return nullptr;
+
+  return filters_[index].get();
+}
+
+uint32_t FilterPipeline::max_chunk_size() const {
+  return max_chunk_size_;
+}
+
+Status FilterPipeline::run_forward(Tile* tile) const {
+  return run_forward(tile, nullptr);
+}
+
+Status FilterPipeline::run_forward(Tile* tile, const Tile* offsets_tile) const {
+  return run_forward({this}, {tile}, {offsets_tile});
+}
+
+Status FilterPipeline::run_reverse(Tile* tile) const {
+  return run_reverse(tile, nullptr, 0);
+}
+
+Status FilterPipeline::run_reverse(
+    Tile* tile, void* dest, uint64_t dest_size) const {
+  return run_reverse({this}, {tile}, {std::make_pair(dest, dest_size)});
+}
+
+Status FilterPipeline::run_forward(
+    const std::vector<const FilterPipeline*>& pipelines,
+    const std::vector<Tile*>& tiles,
+    const std::vector<const Tile*>& offsets_tiles,
+    const std::atomic<bool>* cancel) {
+  STATS_FUNC_IN(filter_pipeline_run_forward);
+  STATS_HISTOGRAM_TIMER(filter_pipeline_run_forward);
+
+  assert(pipelines.size() == tiles.size());
+  assert(offsets_tiles.size() == tiles.size());
+
+  // Compute the chunks of each tile.
+  auto tile_num = tiles.size();
+  std::vector<uint64_t> chunk_nums(tile_num);
+  auto statuses = parallel_for(0, tile_num, [&](uint64_t t) {
+    return pipelines[t]->prepare_forward(
+        tiles[t], offsets_tiles[t], &chunk_nums[t]);
+  });
+  for (const auto& st : statuses)
+    RETURN_NOT_OK(st);
+
+  // Run the filters over the (tile, chunk) pairs of all tiles.
+  auto work = flatten_chunks(chunk_nums);
+  statuses = cancelable_parallel_for(0, work.size(), cancel, [&](uint64_t i) {
+    auto storage = thread_filter_storage();
+    auto st =
+        pipelines[work[i].first]->filter_chunk_forward(work[i].second, storage);
+    storage->reclaim_unused();
+    return st;
+  });
+  for (const auto& st : statuses)
+    RETURN_NOT_OK(st);
+
+  // Replace the buffer of each tile with its filtered chunks.
+  statuses = parallel_for(0, tile_num, [&](uint64_t t) {
+    return pipelines[t]->finish_forward(tiles[t]);
+  });
+  for (const auto& st : statuses)
+    RETURN_NOT_OK(st);
+
+  return Status::Ok();
+
+  STATS_FUNC_OUT(filter_pipeline_run_forward);
+}
+
+Status FilterPipeline::run_reverse(
+    const std::vector<const FilterPipeline*>& pipelines,
+    const std::vector<Tile*>& tiles,
+    const std::vector<std::pair<void*, uint64_t>>& dests,
+    const std::atomic<bool>* cancel) {
+  STATS_FUNC_IN(filter_pipeline_run_reverse);
+  STATS_HISTOGRAM_TIMER(filter_pipeline_run_reverse);
+
+  assert(pipelines.size() == tiles.size());
+  assert(dests.size() == tiles.size());
+
+  // Read the chunk information of each tile.
+  auto tile_num = tiles.size();
+  std::vector<uint64_t> chunk_nums(tile_num);
+  auto statuses = parallel_for(0, tile_num, [&](uint64_t t) {
+    return pipelines[t]->prepare_reverse(
+        tiles[t], dests[t].first, dests[t].second, &chunk_nums[t]);
+  });
+  for (const auto& st : statuses)
+    RETURN_NOT_OK(st);
+
+  // Run the filters in reverse over the (tile, chunk) pairs of all tiles.
+  auto work = flatten_chunks(chunk_nums);
+  statuses = cancelable_parallel_for(0, work.size(), cancel, [&](uint64_t i) {
+    auto storage = thread_filter_storage();
+    auto st =
+        pipelines[work[i].first]->filter_chunk_reverse(work[i].second, storage);
+    storage->reclaim_unused();
+    return st;
+  });
+  for (const auto& st : statuses)
+    RETURN_NOT_OK(st);
+
+  // Replace the buffer of each tile with its unfiltered chunks.
+  statuses = parallel_for(0, tile_num, [&](uint64_t t) {
+    return pipelines[t]->finish_reverse(tiles[t]);
+  });
+  for (const auto& st : statuses)
+    RETURN_NOT_OK(st);
+
+  return Status::Ok();
 
   STATS_FUNC_OUT(filter_pipeline_run_reverse);
 }
@@ -506,6 +726,8 @@ void FilterPipeline::swap(FilterPipeline& other) {
     f->set_pipeline(&other);
 
   std::swap(current_tile_, other.current_tile_);
+  current_dictionary_.swap(other.current_dictionary_);
+  std::swap(current_offsets_tile_, other.current_offsets_tile_);
   std::swap(max_chunk_size_, other.max_chunk_size_);
 }
 
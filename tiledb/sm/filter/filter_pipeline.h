@@ -33,7 +33,9 @@
 #ifndef TILEDB_FILTER_PIPELINE_H
 #define TILEDB_FILTER_PIPELINE_H
 
+#include <atomic>
 #include <memory>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -46,6 +48,7 @@ namespace sm {
 
 class Buffer;
 class EncryptionKey;
+class FilterStorage;
 class Tile;
 
 /**
@@ -87,6 +90,18 @@ class FilterPipeline {
   /** Returns pointer to the current Tile being processed by run/run_reverse. */
   const Tile* current_tile() const;
 
+  /**
+   * Returns the compression dictionary of the current tile, which is empty
+   * if the tile is not compressed with a dictionary.
+   */
+  const std::vector<uint8_t>& current_dictionary() const;
+
+  /**
+   * Returns the offsets tile of the current var-sized data tile being
+   * processed by run(), or `nullptr` if not applicable.
+   */
+  const Tile* current_offsets_tile() const;
+
   /**
    * Populates the filter pipeline from the data in the input binary buffer.
    *
@@ -168,6 +183,18 @@ class FilterPipeline {
    */
   Status run_forward(Tile* tile) const;
 
+  /**
+   * Runs the full pipeline on the given var-sized data tile, like
+   * `run_forward(Tile*)`, making the cell boundaries given by the (unfiltered)
+   * offsets tile available to the filters. With a dictionary filter, the tile
+   * is split into chunks at cell boundaries.
+   *
+   * @param tile The var-sized data tile to filter.
+   * @param offsets_tile The offsets tile of `tile`.
+   * @return Status
+   */
+  Status run_forward(Tile* tile, const Tile* offsets_tile) const;
+
   /**
    * Runs the pipeline in reverse on the given filtered tile. This is used
    * during reads, and processes filtered Tile data (e.g. compressed) into
@@ -205,6 +232,65 @@ class FilterPipeline {
    */
   Status run_reverse(Tile* tile) const;
 
+  /**
+   * Runs the full pipeline in reverse on the given filtered tile, like
+   * `run_reverse(Tile*)`, but with the last filter writing the unfiltered
+   * data directly into the given destination. The Tile's buffer is modified
+   * to wrap the destination, without owning it.
+   *
+   * @param tile Tile to filter
+   * @param dest The destination of the unfiltered data.
+   * @param dest_size The capacity of `dest`, which must be at least the
+   *     unfiltered size of the tile.
+   * @return Status
+   */
+  Status run_reverse(Tile* tile, void* dest, uint64_t dest_size) const;
+
+  /**
+   * Runs each given pipeline forward on the tile at the same position, with
+   * the offsets tile at that position (which may be null). The chunks of all
+   * the tiles are filtered as a single flat set of parallel tasks, so that
+   * few or small tiles still spread over all threads, without nesting a
+   * parallel loop over chunks within a parallel loop over tiles.
+   *
+   * The pipelines must be distinct objects, since each holds the state of the
+   * run over its tile.
+   *
+   * @param pipelines The pipeline of each tile.
+   * @param tiles The tiles to filter.
+   * @param offsets_tiles The offsets tile of each var-sized data tile, or
+   *     null.
+   * @param cancel If not null, a flag polled between chunks, which stops the
+   *     run with an error once set.
+   * @return Status
+   */
+  static Status run_forward(
+      const std::vector<const FilterPipeline*>& pipelines,
+      const std::vector<Tile*>& tiles,
+      const std::vector<const Tile*>& offsets_tiles,
+      const std::atomic<bool>* cancel = nullptr);
+
+  /**
+   * Runs each given pipeline in reverse on the tile at the same position,
+   * scheduling the chunks of all the tiles as a single flat set of parallel
+   * tasks like the batched `run_forward`.
+   *
+   * @param pipelines The pipeline of each tile. These must be distinct
+   *     objects.
+   * @param tiles The tiles to unfilter.
+   * @param dests The destination and its capacity for each tile (see
+   *     `run_reverse(Tile*, void*, uint64_t)`), where a null destination
+   *     unfilters the tile into a new buffer.
+   * @param cancel If not null, a flag polled between chunks, which stops the
+   *     run with an error once set.
+   * @return Status
+   */
+  static Status run_reverse(
+      const std::vector<const FilterPipeline*>& pipelines,
+      const std::vector<Tile*>& tiles,
+      const std::vector<std::pair<void*, uint64_t>>& dests,
+      const std::atomic<bool>* cancel = nullptr);
+
   /**
    * Serializes the pipeline metadata into a binary buffer.
    *
@@ -213,7 +299,10 @@ class FilterPipeline {
    */
   Status serialize(Buffer* buff) const;
 
-  /** Sets the maximum tile chunk size. */
+  /**
+   * Sets the maximum tile chunk size. A max chunk size of 0 selects the chunk
+   * size of each tile automatically (see `chunk_size`).
+   */
   void set_max_chunk_size(uint32_t max_chunk_size);
 
   /** Returns the number of filters in the pipeline. */
@@ -233,9 +322,6 @@ class FilterPipeline {
       FilterPipeline* pipeline, const EncryptionKey& encryption_key);
 
  private:
-  /** A pair of FilterBuffers. */
-  typedef std::pair<FilterBuffer, FilterBuffer> FilterBufferPair;
-
   /** The ordered list of filters comprising the pipeline. */
   std::vector<std::unique_ptr<Filter>> filters_;
 
@@ -245,9 +331,76 @@ class FilterPipeline {
    */
   mutable const Tile* current_tile_;
 
+  /**
+   * The compression dictionary of the current tile, trained by run() and
+   * loaded by run_reverse().
+   */
+  mutable std::vector<uint8_t> current_dictionary_;
+
+  /** The offsets tile of the current var-sized data tile processed by run(). */
+  mutable const Tile* current_offsets_tile_;
+
+  /** The chunks (data, size) of the tile being filtered by run(). */
+  mutable std::vector<std::pair<void*, uint32_t>> forward_chunks_;
+
+  /**
+   * The filtered chunks of the tile being filtered by run(), each starting
+   * with its original, filtered and metadata sizes.
+   */
+  mutable std::vector<Buffer> filtered_chunks_;
+
+  /**
+   * The chunks (metadata, filtered size, original size, metadata size) of the
+   * tile being unfiltered by run_reverse().
+   */
+  mutable std::vector<std::tuple<void*, uint32_t, uint32_t, uint32_t>>
+      reverse_chunks_;
+
+  /** The offset of each unfiltered chunk in `unfiltered_tile_`. */
+  mutable std::vector<uint64_t> chunk_dest_offsets_;
+
+  /** The buffer the chunks are unfiltered into by run_reverse(). */
+  mutable Buffer unfiltered_tile_;
+
+  /**
+   * True if run_reverse() unfiltered the current tile without running the
+   * chunks, by pointing the tile buffer at its memory-mapped data.
+   */
+  mutable bool unfiltered_in_place_;
+
   /** The max chunk size allowed within tiles. */
   uint32_t max_chunk_size_;
 
+  /**
+   * Returns the chunk size to split the given tile with for filtering, which
+   * is the max chunk size unless it is 0 (automatic). In that case, the tile
+   * is split evenly across the threads, in chunks of at least
+   * `constants::max_tile_chunk_size` (or
+   * `constants::auto_tile_chunk_min_size_large_window` for compressors that
+   * gain from long match windows) and at most
+   * `constants::auto_tile_chunk_max_size`.
+   *
+   * @param tile_size The size of the tile (or tile dimension) to split.
+   * @return The chunk size.
+   */
+  uint64_t chunk_size(uint64_t tile_size) const;
+
+  /**
+   * Returns the max compression dictionary size of the pipeline, or 0 if the
+   * pipeline does not compress with a dictionary.
+   */
+  uint32_t dictionary_size() const;
+
+  /**
+   * Trains the compression dictionary of the input tile into
+   * `current_dictionary_`, sampling the start of the (unfiltered) tile data.
+   *
+   * @param tile The tile to train the dictionary for.
+   * @param max_size The max dictionary size.
+   * @return Status
+   */
+  Status train_dictionary(const Tile* tile, uint32_t max_size) const;
+
   /**
    * Compute chunks of the given tile, used in the forward direction.
    *
@@ -259,28 +412,77 @@ class FilterPipeline {
       Tile* tile, std::vector<std::pair<void*, uint32_t>>* chunks) const;
 
   /**
-   * Run the given list of chunks forward through the pipeline.
+   * Compute chunks of the given var-sized data tile, which start and end at
+   * the cell boundaries given by `current_offsets_tile_`.
+   *
+   * @param tile Tile to compute chunks for
+   * @param chunks Output parameter storing the computed chunks
+   * @return Status
+   */
+  Status compute_var_tile_chunks(
+      Tile* tile, std::vector<std::pair<void*, uint32_t>>* chunks) const;
+
+  /**
+   * Prepares the forward run over the given tile: computes its chunks and
+   * trains its compression dictionary.
+   *
+   * @param tile The tile to filter.
+   * @param offsets_tile The offsets tile of `tile`, or null.
+   * @param num_chunks Set to the number of chunks of the tile.
+   * @return Status
+   */
+  Status prepare_forward(
+      Tile* tile, const Tile* offsets_tile, uint64_t* num_chunks) const;
+
+  /**
+   * Runs the given chunk of the current tile forward through the pipeline,
+   * into `filtered_chunks_`.
+   *
+   * @param chunk_idx The index of the chunk.
+   * @param storage The storage of the intermediate filter buffers.
+   * @return Status
+   */
+  Status filter_chunk_forward(uint64_t chunk_idx, FilterStorage* storage) const;
+
+  /**
+   * Concatenates the filtered chunks of the given tile into its buffer.
+   *
+   * @param tile The tile being filtered.
+   * @return Status
+   */
+  Status finish_forward(Tile* tile) const;
+
+  /**
+   * Prepares the reverse run over the given tile: reads its chunk sizes and
+   * compression dictionary, and allocates (or wraps) the unfiltered buffer.
+   *
+   * @param tile The tile to unfilter.
+   * @param dest The destination of the unfiltered data, or null.
+   * @param dest_size The capacity of `dest`.
+   * @param num_chunks Set to the number of chunks left to unfilter, which is
+   *     0 if the tile was unfiltered in place.
+   * @return Status
+   */
+  Status prepare_reverse(
+      Tile* tile, void* dest, uint64_t dest_size, uint64_t* num_chunks) const;
+
+  /**
+   * Runs the given chunk of the current tile in reverse through the pipeline,
+   * into `unfiltered_tile_`.
    *
-   * @param chunks Chunks to process
-   * @param output Buffer where output of last stage will be written.
+   * @param chunk_idx The index of the chunk.
+   * @param storage The storage of the intermediate filter buffers.
    * @return Status
    */
-  Status filter_chunks_forward(
-      const std::vector<std::pair<void*, uint32_t>>& chunks,
-      Buffer* output) const;
+  Status filter_chunk_reverse(uint64_t chunk_idx, FilterStorage* storage) const;
 
   /**
-   * Run the given list of chunks in reverse through the pipeline.
+   * Replaces the buffer of the given tile with the unfiltered chunks.
    *
-   * @param chunks Chunks to process. Format is
-   *    (data ptr, filtered size, original size, metadata size).
-   * @param output Buffer where output of last stage will be written.
+   * @param tile The tile being unfiltered.
    * @return Status
    */
-  Status filter_chunks_reverse(
-      const std::vector<std::tuple<void*, uint32_t, uint32_t, uint32_t>>&
-          chunks,
-      Buffer* output) const;
+  Status finish_reverse(Tile* tile) const;
 };
 
 }  // namespace sm
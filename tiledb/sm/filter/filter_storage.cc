@@ -80,5 +80,20 @@ Status FilterStorage::reclaim(Buffer* buffer) {
   return Status::Ok();
 }
 
+void FilterStorage::reclaim_unused() {
+  for (auto it = in_use_.begin(); it != in_use_.end();) {
+    if (it->use_count() == 1) {
+      Buffer* buffer = it->get();
+      buffer->reset_offset();
+      buffer->reset_size();
+      in_use_list_map_.erase(buffer);
+      available_.push_front(std::move(*it));
+      it = in_use_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
 }  // namespace sm
 }  // namespace tiledb
@@ -76,6 +76,12 @@ class FilterStorage {
    */
   Status reclaim(Buffer* buffer);
 
+  /**
+   * Reclaims all in-use buffers that are no longer referenced outside this
+   * instance, e.g. because the filter buffers using them were destroyed.
+   */
+  void reclaim_unused();
+
  private:
   /** List of buffers that are available to be used (may be empty). */
   std::list<std::shared_ptr<Buffer>> available_;
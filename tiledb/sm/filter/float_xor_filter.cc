@@ -0,0 +1,376 @@
+/**
+ * @file   float_xor_filter.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class FloatXorFilter.
+ */
+
+#include "tiledb/sm/filter/float_xor_filter.h"
+#include "tiledb/sm/buffer/const_buffer.h"
+#include "tiledb/sm/enums/datatype.h"
+#include "tiledb/sm/enums/filter_type.h"
+#include "tiledb/sm/filter/filter_buffer.h"
+#include "tiledb/sm/filter/filter_pipeline.h"
+#include "tiledb/sm/misc/logger.h"
+#include "tiledb/sm/tile/tile.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace tiledb {
+namespace sm {
+
+namespace {
+
+/** Appends bits to a byte vector, most significant bit first. */
+class BitWriter {
+ public:
+  explicit BitWriter(std::vector<uint8_t>* bytes)
+      : bytes_(bytes)
+      , bit_num_(0) {
+  }
+
+  /** Appends the `n` (at most 64) least significant bits of `value`. */
+  void write(uint64_t value, unsigned n) {
+    while (n > 0) {
+      if (bit_num_ % 8 == 0)
+        bytes_->push_back(0);
+      unsigned free = 8 - bit_num_ % 8;
+      unsigned take = std::min(free, n);
+      auto bits = (uint8_t)((value >> (n - take)) & ((1u << take) - 1));
+      bytes_->back() |= (uint8_t)(bits << (free - take));
+      n -= take;
+      bit_num_ += take;
+    }
+  }
+
+ private:
+  /** The bytes written to. */
+  std::vector<uint8_t>* bytes_;
+
+  /** The number of bits written. */
+  uint64_t bit_num_;
+};
+
+/** Reads bits from a byte array, most significant bit first. */
+class BitReader {
+ public:
+  BitReader(const uint8_t* bytes, uint64_t size)
+      : bytes_(bytes)
+      , bit_size_(size * 8)
+      , bit_num_(0) {
+  }
+
+  /**
+   * Reads `n` (at most 64) bits into the least significant bits of `value`.
+   * Returns `false` if fewer than `n` bits are left.
+   */
+  bool read(unsigned n, uint64_t* value) {
+    if (bit_num_ + n > bit_size_)
+      return false;
+
+    uint64_t v = 0;
+    while (n > 0) {
+      unsigned avail = 8 - bit_num_ % 8;
+      unsigned take = std::min(avail, n);
+      uint8_t byte = bytes_[bit_num_ / 8];
+      v = (v << take) | ((byte >> (avail - take)) & ((1u << take) - 1));
+      n -= take;
+      bit_num_ += take;
+    }
+    *value = v;
+
+    return true;
+  }
+
+ private:
+  /** The bytes read from. */
+  const uint8_t* bytes_;
+
+  /** The number of bits that can be read. */
+  uint64_t bit_size_;
+
+  /** The number of bits read. */
+  uint64_t bit_num_;
+};
+
+/** Returns the number of leading zero bits of a non-zero value. */
+inline unsigned leading_zeros(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+  return (unsigned)__builtin_clzll(x);
+#else
+  unsigned n = 0;
+  for (; (x & (uint64_t(1) << 63)) == 0; x <<= 1)
+    ++n;
+  return n;
+#endif
+}
+
+/** Returns the number of trailing zero bits of a non-zero value. */
+inline unsigned trailing_zeros(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+  return (unsigned)__builtin_ctzll(x);
+#else
+  unsigned n = 0;
+  for (; (x & 1) == 0; x >>= 1)
+    ++n;
+  return n;
+#endif
+}
+
+}  // namespace
+
+FloatXorFilter::FloatXorFilter()
+    : Filter(FilterType::FILTER_FLOAT_XOR) {
+}
+
+Status FloatXorFilter::run_forward(
+    FilterBuffer* input_metadata,
+    FilterBuffer* input,
+    FilterBuffer* output_metadata,
+    FilterBuffer* output) const {
+  // If encoding can't work, just return the input unmodified.
+  if (!float_tile()) {
+    RETURN_NOT_OK(output->append_view(input));
+    RETURN_NOT_OK(output_metadata->append_view(input_metadata));
+    return Status::Ok();
+  }
+
+  // Encode all parts, keeping a part unmodified if encoding does not
+  // make it smaller.
+  bool float32 = pipeline_->current_tile()->type() == Datatype::FLOAT32;
+  std::vector<ConstBuffer> parts = input->buffers();
+  auto num_parts = (uint32_t)parts.size();
+  std::vector<std::vector<uint8_t>> encoded(num_parts);
+  uint64_t output_size = 0;
+  for (uint32_t i = 0; i < num_parts; i++) {
+    if (parts[i].size() > std::numeric_limits<uint32_t>::max())
+      return LOG_STATUS(Status::FilterError(
+          "Float XOR filter error; input part is too large"));
+    if (float32)
+      encode_part<uint32_t>(parts[i], &encoded[i]);
+    else
+      encode_part<uint64_t>(parts[i], &encoded[i]);
+    if (encoded[i].size() >= parts[i].size())
+      encoded[i].clear();
+    output_size += encoded[i].empty() ? parts[i].size() : encoded[i].size();
+  }
+
+  // Forward the existing metadata
+  RETURN_NOT_OK(output_metadata->append_view(input_metadata));
+  // Allocate a buffer for this filter's metadata and write the header.
+  RETURN_NOT_OK(output_metadata->prepend_buffer(
+      sizeof(uint32_t) + num_parts * 2 * sizeof(uint32_t)));
+  RETURN_NOT_OK(output_metadata->write(&num_parts, sizeof(uint32_t)));
+
+  // Write all parts.
+  RETURN_NOT_OK(output->prepend_buffer(output_size));
+  for (uint32_t i = 0; i < num_parts; i++) {
+    auto part_size = (uint32_t)parts[i].size();
+    auto encoded_size =
+        encoded[i].empty() ? part_size : (uint32_t)encoded[i].size();
+    RETURN_NOT_OK(output_metadata->write(&part_size, sizeof(uint32_t)));
+    RETURN_NOT_OK(output_metadata->write(&encoded_size, sizeof(uint32_t)));
+    if (encoded[i].empty())
+      RETURN_NOT_OK(output->write(parts[i].data(), part_size));
+    else
+      RETURN_NOT_OK(output->write(encoded[i].data(), encoded_size));
+  }
+
+  return Status::Ok();
+}
+
+Status FloatXorFilter::run_reverse(
+    FilterBuffer* input_metadata,
+    FilterBuffer* input,
+    FilterBuffer* output_metadata,
+    FilterBuffer* output) const {
+  // If encoding wasn't applied, just return the input unmodified.
+  if (!float_tile()) {
+    RETURN_NOT_OK(output->append_view(input));
+    RETURN_NOT_OK(output_metadata->append_view(input_metadata));
+    return Status::Ok();
+  }
+
+  // Read the part sizes
+  uint32_t num_parts;
+  RETURN_NOT_OK(input_metadata->read(&num_parts, sizeof(uint32_t)));
+  std::vector<std::pair<uint32_t, uint32_t>> part_sizes(num_parts);
+  uint64_t output_size = 0;
+  for (auto& sizes : part_sizes) {
+    RETURN_NOT_OK(input_metadata->read(&sizes.first, sizeof(uint32_t)));
+    RETURN_NOT_OK(input_metadata->read(&sizes.second, sizeof(uint32_t)));
+    output_size += sizes.first;
+  }
+
+  // Decode all parts.
+  bool float32 = pipeline_->current_tile()->type() == Datatype::FLOAT32;
+  RETURN_NOT_OK(output->prepend_buffer(output_size));
+  for (const auto& sizes : part_sizes) {
+    if (sizes.first == 0)
+      continue;
+
+    ConstBuffer part(nullptr, 0);
+    RETURN_NOT_OK(input->get_const_buffer(sizes.second, &part));
+    input->advance_offset(sizes.second);
+    if (sizes.second == sizes.first)
+      RETURN_NOT_OK(output->write(part.data(), sizes.first));
+    else if (float32)
+      RETURN_NOT_OK(decode_part<uint32_t>(part, sizes.first, output));
+    else
+      RETURN_NOT_OK(decode_part<uint64_t>(part, sizes.first, output));
+  }
+
+  // Output metadata is a view on the input metadata, skipping what was used by
+  // this filter.
+  auto md_offset = input_metadata->offset();
+  RETURN_NOT_OK(output_metadata->append_view(
+      input_metadata, md_offset, input_metadata->size() - md_offset));
+
+  return Status::Ok();
+}
+
+FloatXorFilter* FloatXorFilter::clone_impl() const {
+  return new FloatXorFilter;
+}
+
+bool FloatXorFilter::float_tile() const {
+  auto type = pipeline_->current_tile()->type();
+  return type == Datatype::FLOAT32 || type == Datatype::FLOAT64;
+}
+
+template <typename T>
+void FloatXorFilter::encode_part(
+    const ConstBuffer& part, std::vector<uint8_t>* encoded) const {
+  const unsigned width = sizeof(T) * 8;
+  const unsigned field_bits = sizeof(T) == sizeof(uint32_t) ? 5 : 6;
+  const unsigned extra_zeros = 64 - width;
+  auto data = static_cast<const uint8_t*>(part.data());
+  uint64_t value_num = part.size() / sizeof(T);
+
+  BitWriter writer(encoded);
+  T prev = 0;
+  bool window = false;
+  unsigned window_lz = 0, window_tz = 0;
+  for (uint64_t i = 0; i < value_num; ++i) {
+    T value;
+    std::memcpy(&value, data + i * sizeof(T), sizeof(T));
+    if (i == 0) {
+      writer.write(value, width);
+      prev = value;
+      continue;
+    }
+
+    T x = value ^ prev;
+    prev = value;
+    if (x == 0) {
+      writer.write(0, 1);
+      continue;
+    }
+
+    unsigned lz = leading_zeros(x) - extra_zeros;
+    unsigned tz = trailing_zeros(x);
+    if (window && lz >= window_lz && tz >= window_tz) {
+      // The meaningful bits fit in the previous window
+      writer.write(2, 2);
+      writer.write(x >> window_tz, width - window_lz - window_tz);
+    } else {
+      unsigned len = width - lz - tz;
+      writer.write(3, 2);
+      writer.write(lz, field_bits);
+      writer.write(len - 1, field_bits);
+      writer.write(x >> tz, len);
+      window = true;
+      window_lz = lz;
+      window_tz = tz;
+    }
+  }
+
+  // Store the trailing bytes unmodified
+  encoded->insert(
+      encoded->end(), data + value_num * sizeof(T), data + part.size());
+}
+
+template <typename T>
+Status FloatXorFilter::decode_part(
+    const ConstBuffer& encoded, uint32_t part_size, FilterBuffer* output)
+    const {
+  const unsigned width = sizeof(T) * 8;
+  const unsigned field_bits = sizeof(T) == sizeof(uint32_t) ? 5 : 6;
+  auto data = static_cast<const uint8_t*>(encoded.data());
+  uint64_t value_num = part_size / sizeof(T);
+  uint64_t trailing_size = part_size % sizeof(T);
+  if (encoded.size() < trailing_size)
+    return LOG_STATUS(Status::FilterError(
+        "Float XOR filter error; invalid encoded part size"));
+
+  BitReader reader(data, encoded.size() - trailing_size);
+  T prev = 0;
+  unsigned window_lz = 0, window_tz = 0;
+  uint64_t bits, lz, len;
+  for (uint64_t i = 0; i < value_num; ++i) {
+    bool ok = true;
+    T value = prev;
+    if (i == 0) {
+      ok = reader.read(width, &bits);
+      value = (T)bits;
+    } else if ((ok = reader.read(1, &bits)) && bits == 1) {
+      ok = reader.read(1, &bits);
+      if (ok && bits == 0) {
+        ok = reader.read(width - window_lz - window_tz, &bits);
+        value = prev ^ (T)(bits << window_tz);
+      } else if (ok) {
+        ok = reader.read(field_bits, &lz) && reader.read(field_bits, &len) &&
+             lz + len + 1 <= width && reader.read((unsigned)len + 1, &bits);
+        if (ok) {
+          window_lz = (unsigned)lz;
+          window_tz = width - window_lz - (unsigned)len - 1;
+          value = prev ^ (T)(bits << window_tz);
+        }
+      }
+    }
+
+    if (!ok)
+      return LOG_STATUS(Status::FilterError(
+          "Float XOR filter error; corrupt encoded data"));
+
+    RETURN_NOT_OK(output->write(&value, sizeof(T)));
+    prev = value;
+  }
+
+  // Copy the trailing bytes
+  if (trailing_size > 0)
+    RETURN_NOT_OK(output->write(
+        data + encoded.size() - trailing_size, trailing_size));
+
+  return Status::Ok();
+}
+
+}  // namespace sm
+}  // namespace tiledb
@@ -0,0 +1,138 @@
+/**
+ * @file   float_xor_filter.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file declares class FloatXorFilter.
+ */
+
+#ifndef TILEDB_FLOAT_XOR_FILTER_H
+#define TILEDB_FLOAT_XOR_FILTER_H
+
+#include "tiledb/sm/filter/filter.h"
+#include "tiledb/sm/misc/status.h"
+
+#include <vector>
+
+namespace tiledb {
+namespace sm {
+
+/**
+ * A filter that losslessly encodes an array of floating point values by
+ * XOR-ing each value with its predecessor and bit-packing the meaningful
+ * (non-zero) bits of the result, as in the Gorilla time series encoding.
+ * Slowly changing series produce XORs with long runs of leading and trailing
+ * zeros, which are stored in a few bits. Non floating point tiles are passed
+ * through unmodified.
+ *
+ * Each input part is encoded separately. A part is stored unmodified if its
+ * encoding would not be smaller. Trailing bytes of a part that do not form a
+ * whole value are stored unmodified after the encoded values.
+ *
+ * Input metadata is not compressed or modified.
+ *
+ * The forward output metadata has the format:
+ *   uint32_t - Number of parts
+ *   part0_md
+ *   ...
+ *   partN_md
+ * Where each part*_md has the fixed format:
+ *   uint32_t - Size of the part in bytes
+ *   uint32_t - Size of the encoded part in bytes (equal to the part size if
+ *              the part was stored unmodified)
+ *
+ * The forward output data format is the concatenated encoded parts, where the
+ * bit stream of each part (most significant bit first) is:
+ *   The first value, as W bits (W is the value width in bits)
+ *   For each next value, with X = value XOR previous value:
+ *     '0' if X is 0, otherwise
+ *     '10' and the meaningful bits of X, if they fit in the leading/trailing
+ *          zero window of the previous stored XOR, otherwise
+ *     '11', the number of leading zeros of X (5 bits for float32, 6 bits for
+ *          float64), the number of meaningful bits minus 1 (same width),
+ *          and the meaningful bits of X
+ * padded to a whole byte and followed by the trailing bytes of the part.
+ *
+ * The reverse output format is simply:
+ *   T[] - Array of original elements
+ */
+class FloatXorFilter : public Filter {
+ public:
+  /** Constructor. */
+  FloatXorFilter();
+
+  /** Encodes the input. */
+  Status run_forward(
+      FilterBuffer* input_metadata,
+      FilterBuffer* input,
+      FilterBuffer* output_metadata,
+      FilterBuffer* output) const override;
+
+  /** Decodes the input. */
+  Status run_reverse(
+      FilterBuffer* input_metadata,
+      FilterBuffer* input,
+      FilterBuffer* output_metadata,
+      FilterBuffer* output) const override;
+
+ private:
+  /** Returns a new clone of this filter. */
+  FloatXorFilter* clone_impl() const override;
+
+  /** Returns true if the current tile stores floating point values. */
+  bool float_tile() const;
+
+  /**
+   * Encodes the values of the input part, where `T` is the unsigned integer
+   * type of the value width.
+   *
+   * @param part The input part.
+   * @param encoded The encoded bit stream, followed by the trailing bytes.
+   */
+  template <typename T>
+  void encode_part(const ConstBuffer& part, std::vector<uint8_t>* encoded)
+      const;
+
+  /**
+   * Decodes an encoded part, where `T` is the unsigned integer type of the
+   * value width.
+   *
+   * @param encoded The encoded part.
+   * @param part_size The size of the decoded part.
+   * @param output The buffer to write the decoded part to.
+   * @return Status
+   */
+  template <typename T>
+  Status decode_part(
+      const ConstBuffer& encoded, uint32_t part_size, FilterBuffer* output)
+      const;
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_FLOAT_XOR_FILTER_H
@@ -0,0 +1,480 @@
+/**
+ * @file   frame_of_reference_filter.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class FrameOfReferenceFilter.
+ */
+
+#include "tiledb/sm/filter/frame_of_reference_filter.h"
+#include "tiledb/sm/buffer/buffer.h"
+#include "tiledb/sm/buffer/const_buffer.h"
+#include "tiledb/sm/enums/datatype.h"
+#include "tiledb/sm/enums/filter_option.h"
+#include "tiledb/sm/enums/filter_type.h"
+#include "tiledb/sm/filter/filter_buffer.h"
+#include "tiledb/sm/filter/filter_pipeline.h"
+#include "tiledb/sm/misc/logger.h"
+#include "tiledb/sm/tile/tile.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace tiledb {
+namespace sm {
+
+namespace {
+
+/** The number of values in a block. */
+const uint64_t block_size = 128;
+
+/** Returns the number of 64-bit words packing `n` values of `width` bits. */
+inline uint64_t packed_words(uint64_t n, unsigned width) {
+  return (n * width + 63) / 64;
+}
+
+/** Returns the mask of the `width` least significant bits. */
+inline uint64_t width_mask(unsigned width) {
+  return width == 64 ? std::numeric_limits<uint64_t>::max() :
+                       (uint64_t(1) << width) - 1;
+}
+
+}  // namespace
+
+FrameOfReferenceFilter::FrameOfReferenceFilter()
+    : Filter(FilterType::FILTER_FRAME_OF_REFERENCE) {
+  delta_ = false;
+}
+
+bool FrameOfReferenceFilter::delta() const {
+  return delta_;
+}
+
+Status FrameOfReferenceFilter::run_forward(
+    FilterBuffer* input_metadata,
+    FilterBuffer* input,
+    FilterBuffer* output_metadata,
+    FilterBuffer* output) const {
+  auto tile_type = pipeline_->current_tile()->type();
+
+  switch (tile_type) {
+    case Datatype::INT8:
+      return run_forward<int8_t>(
+          input_metadata, input, output_metadata, output);
+    case Datatype::UINT8:
+      return run_forward<uint8_t>(
+          input_metadata, input, output_metadata, output);
+    case Datatype::INT16:
+      return run_forward<int16_t>(
+          input_metadata, input, output_metadata, output);
+    case Datatype::UINT16:
+      return run_forward<uint16_t>(
+          input_metadata, input, output_metadata, output);
+    case Datatype::INT32:
+      return run_forward<int>(input_metadata, input, output_metadata, output);
+    case Datatype::UINT32:
+      return run_forward<unsigned>(
+          input_metadata, input, output_metadata, output);
+    case Datatype::INT64:
+    case Datatype::DATETIME_YEAR:
+    case Datatype::DATETIME_MONTH:
+    case Datatype::DATETIME_WEEK:
+    case Datatype::DATETIME_DAY:
+    case Datatype::DATETIME_HR:
+    case Datatype::DATETIME_MIN:
+    case Datatype::DATETIME_SEC:
+    case Datatype::DATETIME_MS:
+    case Datatype::DATETIME_US:
+    case Datatype::DATETIME_NS:
+    case Datatype::DATETIME_PS:
+    case Datatype::DATETIME_FS:
+    case Datatype::DATETIME_AS:
+      return run_forward<int64_t>(
+          input_metadata, input, output_metadata, output);
+    case Datatype::UINT64:
+      return run_forward<uint64_t>(
+          input_metadata, input, output_metadata, output);
+    default:
+      // If encoding can't work, just return the input unmodified.
+      RETURN_NOT_OK(output->append_view(input));
+      RETURN_NOT_OK(output_metadata->append_view(input_metadata));
+      return Status::Ok();
+  }
+}
+
+template <typename T>
+Status FrameOfReferenceFilter::run_forward(
+    FilterBuffer* input_metadata,
+    FilterBuffer* input,
+    FilterBuffer* output_metadata,
+    FilterBuffer* output) const {
+  // Encode all parts, keeping a part unmodified if encoding does not
+  // make it smaller.
+  std::vector<ConstBuffer> parts = input->buffers();
+  auto num_parts = (uint32_t)parts.size();
+  std::vector<std::vector<uint8_t>> encoded(num_parts);
+  uint64_t output_size = 0;
+  for (uint32_t i = 0; i < num_parts; i++) {
+    if (parts[i].size() > std::numeric_limits<uint32_t>::max())
+      return LOG_STATUS(Status::FilterError(
+          "Frame of reference filter error; input part is too large"));
+    encode_part<T>(parts[i], &encoded[i]);
+    if (encoded[i].size() >= parts[i].size())
+      encoded[i].clear();
+    output_size += encoded[i].empty() ? parts[i].size() : encoded[i].size();
+  }
+
+  // Forward the existing metadata
+  RETURN_NOT_OK(output_metadata->append_view(input_metadata));
+  // Allocate a buffer for this filter's metadata and write the header.
+  RETURN_NOT_OK(output_metadata->prepend_buffer(
+      sizeof(uint32_t) + num_parts * 2 * sizeof(uint32_t)));
+  RETURN_NOT_OK(output_metadata->write(&num_parts, sizeof(uint32_t)));
+
+  // Write all parts.
+  RETURN_NOT_OK(output->prepend_buffer(output_size));
+  for (uint32_t i = 0; i < num_parts; i++) {
+    auto part_size = (uint32_t)parts[i].size();
+    auto encoded_size =
+        encoded[i].empty() ? part_size : (uint32_t)encoded[i].size();
+    RETURN_NOT_OK(output_metadata->write(&part_size, sizeof(uint32_t)));
+    RETURN_NOT_OK(output_metadata->write(&encoded_size, sizeof(uint32_t)));
+    if (encoded[i].empty())
+      RETURN_NOT_OK(output->write(parts[i].data(), part_size));
+    else
+      RETURN_NOT_OK(output->write(encoded[i].data(), encoded_size));
+  }
+
+  return Status::Ok();
+}
+
+Status FrameOfReferenceFilter::run_reverse(
+    FilterBuffer* input_metadata,
+    FilterBuffer* input,
+    FilterBuffer* output_metadata,
+    FilterBuffer* output) const {
+  auto tile_type = pipeline_->current_tile()->type();
+
+  switch (tile_type) {
+    case Datatype::INT8:
+      return run_reverse<int8_t>(
+          input_metadata, input, output_metadata, output);
+    case Datatype::UINT8:
+      return run_reverse<uint8_t>(
+          input_metadata, input, output_metadata, output);
+    case Datatype::INT16:
+      return run_reverse<int16_t>(
+          input_metadata, input, output_metadata, output);
+    case Datatype::UINT16:
+      return run_reverse<uint16_t>(
+          input_metadata, input, output_metadata, output);
+    case Datatype::INT32:
+      return run_reverse<int>(input_metadata, input, output_metadata, output);
+    case Datatype::UINT32:
+      return run_reverse<unsigned>(
+          input_metadata, input, output_metadata, output);
+    case Datatype::INT64:
+    case Datatype::DATETIME_YEAR:
+    case Datatype::DATETIME_MONTH:
+    case Datatype::DATETIME_WEEK:
+    case Datatype::DATETIME_DAY:
+    case Datatype::DATETIME_HR:
+    case Datatype::DATETIME_MIN:
+    case Datatype::DATETIME_SEC:
+    case Datatype::DATETIME_MS:
+    case Datatype::DATETIME_US:
+    case Datatype::DATETIME_NS:
+    case Datatype::DATETIME_PS:
+    case Datatype::DATETIME_FS:
+    case Datatype::DATETIME_AS:
+      return run_reverse<int64_t>(
+          input_metadata, input, output_metadata, output);
+    case Datatype::UINT64:
+      return run_reverse<uint64_t>(
+          input_metadata, input, output_metadata, output);
+    default:
+      // If encoding wasn't applied, just return the input unmodified.
+      RETURN_NOT_OK(output->append_view(input));
+      RETURN_NOT_OK(output_metadata->append_view(input_metadata));
+      return Status::Ok();
+  }
+}
+
+template <typename T>
+Status FrameOfReferenceFilter::run_reverse(
+    FilterBuffer* input_metadata,
+    FilterBuffer* input,
+    FilterBuffer* output_metadata,
+    FilterBuffer* output) const {
+  // Read the part sizes
+  uint32_t num_parts;
+  RETURN_NOT_OK(input_metadata->read(&num_parts, sizeof(uint32_t)));
+  std::vector<std::pair<uint32_t, uint32_t>> part_sizes(num_parts);
+  uint64_t output_size = 0;
+  for (auto& sizes : part_sizes) {
+    RETURN_NOT_OK(input_metadata->read(&sizes.first, sizeof(uint32_t)));
+    RETURN_NOT_OK(input_metadata->read(&sizes.second, sizeof(uint32_t)));
+    output_size += sizes.first;
+  }
+
+  // Decode all parts.
+  RETURN_NOT_OK(output->prepend_buffer(output_size));
+  for (const auto& sizes : part_sizes) {
+    if (sizes.first == 0)
+      continue;
+
+    ConstBuffer part(nullptr, 0);
+    RETURN_NOT_OK(input->get_const_buffer(sizes.second, &part));
+    input->advance_offset(sizes.second);
+    if (sizes.second == sizes.first)
+      RETURN_NOT_OK(output->write(part.data(), sizes.first));
+    else
+      RETURN_NOT_OK(decode_part<T>(part, sizes.first, output));
+  }
+
+  // Output metadata is a view on the input metadata, skipping what was used by
+  // this filter.
+  auto md_offset = input_metadata->offset();
+  RETURN_NOT_OK(output_metadata->append_view(
+      input_metadata, md_offset, input_metadata->size() - md_offset));
+
+  return Status::Ok();
+}
+
+FrameOfReferenceFilter* FrameOfReferenceFilter::clone_impl() const {
+  auto clone = new FrameOfReferenceFilter;
+  clone->delta_ = delta_;
+  return clone;
+}
+
+template <typename T>
+void FrameOfReferenceFilter::encode_part(
+    const ConstBuffer& part, std::vector<uint8_t>* encoded) const {
+  typedef typename std::make_unsigned<T>::type U;
+  typedef typename std::make_signed<T>::type S;
+  auto data = static_cast<const uint8_t*>(part.data());
+  uint64_t value_num = part.size() / sizeof(T);
+
+  T values[block_size];
+  U deltas[block_size];
+  uint64_t offsets[block_size];
+  uint64_t words[block_size];
+  for (uint64_t start = 0; start < value_num; start += block_size) {
+    uint64_t n = std::min(block_size, value_num - start);
+    std::memcpy(values, data + start * sizeof(T), n * sizeof(T));
+
+    // Compute the block frame, the packed offsets and their range. With the
+    // delta option, the offsets are those of the differences of consecutive
+    // values from their minimum, compared as signed values.
+    T frame;
+    U min_delta = 0;
+    uint64_t offset_num, range;
+    if (delta_) {
+      frame = values[0];
+      offset_num = n - 1;
+      S min = 0, max = 0;
+      for (uint64_t j = 0; j < offset_num; ++j) {
+        deltas[j] = (U)((U)values[j + 1] - (U)values[j]);
+        min = (j == 0) ? (S)deltas[j] : std::min(min, (S)deltas[j]);
+        max = (j == 0) ? (S)deltas[j] : std::max(max, (S)deltas[j]);
+      }
+      min_delta = (U)min;
+      range = (uint64_t)(U)((U)max - min_delta);
+      for (uint64_t j = 0; j < offset_num; ++j)
+        offsets[j] = (uint64_t)(U)(deltas[j] - min_delta);
+    } else {
+      T min = values[0], max = values[0];
+      for (uint64_t j = 1; j < n; ++j) {
+        min = std::min(min, values[j]);
+        max = std::max(max, values[j]);
+      }
+      frame = min;
+      offset_num = n;
+      range = (uint64_t)(U)((U)max - (U)min);
+      for (uint64_t j = 0; j < n; ++j)
+        offsets[j] = (uint64_t)(U)((U)values[j] - (U)min);
+    }
+    unsigned width = 0;
+    while (width < 64 && (range >> width) != 0)
+      ++width;
+
+    // Pack the offsets
+    uint64_t word_num = packed_words(offset_num, width);
+    std::fill(words, words + word_num, 0);
+    if (width > 0) {
+      for (uint64_t j = 0; j < offset_num; ++j) {
+        uint64_t bit = j * width;
+        unsigned shift = bit % 64;
+        words[bit / 64] |= offsets[j] << shift;
+        if (shift + width > 64)
+          words[bit / 64 + 1] |= offsets[j] >> (64 - shift);
+      }
+    }
+
+    // Append the block
+    auto width_byte = (uint8_t)width;
+    auto block_data = reinterpret_cast<const uint8_t*>(words);
+    encoded->insert(
+        encoded->end(),
+        reinterpret_cast<const uint8_t*>(&frame),
+        reinterpret_cast<const uint8_t*>(&frame) + sizeof(T));
+    if (delta_)
+      encoded->insert(
+          encoded->end(),
+          reinterpret_cast<const uint8_t*>(&min_delta),
+          reinterpret_cast<const uint8_t*>(&min_delta) + sizeof(U));
+    encoded->push_back(width_byte);
+    encoded->insert(
+        encoded->end(), block_data, block_data + word_num * sizeof(uint64_t));
+  }
+
+  // Store the trailing bytes unmodified
+  encoded->insert(
+      encoded->end(), data + value_num * sizeof(T), data + part.size());
+}
+
+template <typename T>
+Status FrameOfReferenceFilter::decode_part(
+    const ConstBuffer& encoded, uint32_t part_size, FilterBuffer* output)
+    const {
+  typedef typename std::make_unsigned<T>::type U;
+  auto data = static_cast<const uint8_t*>(encoded.data());
+  uint64_t size = encoded.size();
+  uint64_t value_num = part_size / sizeof(T);
+  uint64_t trailing_size = part_size % sizeof(T);
+  const uint64_t header_size =
+      sizeof(T) + (delta_ ? sizeof(U) : 0) + sizeof(uint8_t);
+
+  T values[block_size];
+  uint64_t words[block_size];
+  uint64_t pos = 0;
+  for (uint64_t start = 0; start < value_num; start += block_size) {
+    uint64_t n = std::min(block_size, value_num - start);
+    uint64_t offset_num = delta_ ? n - 1 : n;
+
+    // Read the block header and packed words
+    T frame;
+    U min_delta = 0;
+    if (pos + header_size > size)
+      return LOG_STATUS(Status::FilterError(
+          "Frame of reference filter error; corrupt encoded data"));
+    std::memcpy(&frame, data + pos, sizeof(T));
+    if (delta_)
+      std::memcpy(&min_delta, data + pos + sizeof(T), sizeof(U));
+    unsigned width = data[pos + header_size - sizeof(uint8_t)];
+    pos += header_size;
+    uint64_t word_num = packed_words(offset_num, width);
+    if (width > 64 || pos + word_num * sizeof(uint64_t) > size)
+      return LOG_STATUS(Status::FilterError(
+          "Frame of reference filter error; corrupt encoded data"));
+    std::memcpy(words, data + pos, word_num * sizeof(uint64_t));
+    pos += word_num * sizeof(uint64_t);
+
+    // Unpack the block, summing the differences with the delta option
+    uint64_t mask = width_mask(width);
+    values[0] = frame;
+    for (uint64_t j = 0; j < offset_num; ++j) {
+      uint64_t offset = 0;
+      if (width > 0) {
+        uint64_t bit = j * width;
+        unsigned shift = bit % 64;
+        offset = words[bit / 64] >> shift;
+        if (shift + width > 64)
+          offset |= words[bit / 64 + 1] << (64 - shift);
+        offset &= mask;
+      }
+      if (delta_)
+        values[j + 1] = (T)(U)((U)values[j] + (U)(min_delta + (U)offset));
+      else
+        values[j] = (T)(U)((U)frame + (U)offset);
+    }
+    RETURN_NOT_OK(output->write(values, n * sizeof(T)));
+  }
+
+  // Copy the trailing bytes
+  if (pos + trailing_size != size)
+    return LOG_STATUS(Status::FilterError(
+        "Frame of reference filter error; corrupt encoded data"));
+  if (trailing_size > 0)
+    RETURN_NOT_OK(output->write(data + pos, trailing_size));
+
+  return Status::Ok();
+}
+
+Status FrameOfReferenceFilter::set_option_impl(
+    FilterOption option, const void* value) {
+  if (value == nullptr)
+    return LOG_STATUS(Status::FilterError(
+        "Frame of reference filter error; invalid option value"));
+
+  switch (option) {
+    case FilterOption::FRAME_OF_REFERENCE_DELTA:
+      delta_ = *(uint32_t*)value != 0;
+      return Status::Ok();
+    default:
+      return LOG_STATUS(Status::FilterError(
+          "Frame of reference filter error; unknown option"));
+  }
+}
+
+Status FrameOfReferenceFilter::get_option_impl(
+    FilterOption option, void* value) const {
+  switch (option) {
+    case FilterOption::FRAME_OF_REFERENCE_DELTA:
+      *(uint32_t*)value = delta_ ? 1 : 0;
+      return Status::Ok();
+    default:
+      return LOG_STATUS(Status::FilterError(
+          "Frame of reference filter error; unknown option"));
+  }
+}
+
+Status FrameOfReferenceFilter::serialize_impl(Buffer* buff) const {
+  // The delta flag is only serialized when set, so that arrays not using it
+  // keep the original format
+  if (delta_) {
+    uint8_t delta_char = 1;
+    RETURN_NOT_OK(buff->write(&delta_char, sizeof(uint8_t)));
+  }
+
+  return Status::Ok();
+}
+
+Status FrameOfReferenceFilter::deserialize_impl(ConstBuffer* buff) {
+  if (buff->nbytes_left_to_read() >= sizeof(uint8_t)) {
+    uint8_t delta_char;
+    RETURN_NOT_OK(buff->read(&delta_char, sizeof(uint8_t)));
+    delta_ = delta_char != 0;
+  }
+
+  return Status::Ok();
+}
+
+}  // namespace sm
+}  // namespace tiledb
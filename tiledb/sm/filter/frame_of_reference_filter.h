@@ -0,0 +1,171 @@
+/**
+ * @file   frame_of_reference_filter.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file declares class FrameOfReferenceFilter.
+ */
+
+#ifndef TILEDB_FRAME_OF_REFERENCE_FILTER_H
+#define TILEDB_FRAME_OF_REFERENCE_FILTER_H
+
+#include "tiledb/sm/filter/filter.h"
+#include "tiledb/sm/misc/status.h"
+
+#include <vector>
+
+namespace tiledb {
+namespace sm {
+
+/**
+ * A filter that encodes an array of integers with frame-of-reference
+ * bit-packing. The input is split into blocks of 128 values; each block stores
+ * its minimum value, and the offsets of its values from the minimum are packed
+ * with the bit width of the largest offset. Blocks are packed and unpacked as a
+ * whole with branch-light loops over 64-bit words, which the compiler can
+ * vectorize, and written with one buffer write per block. Non-integer tiles
+ * are passed through unmodified.
+ *
+ * With the `FRAME_OF_REFERENCE_DELTA` option, each block instead stores its
+ * first value, and the differences of its consecutive values are packed as
+ * offsets from their minimum. This suits values that change slowly from one
+ * cell to the next, such as the coordinates of a dimension of a sparse
+ * array, whose tiles hold one dimension each.
+ *
+ * Each input part is encoded separately. A part is stored unmodified if its
+ * encoding would not be smaller. Trailing bytes of a part that do not form a
+ * whole value are stored unmodified after the encoded blocks.
+ *
+ * Input metadata is not compressed or modified.
+ *
+ * The forward output metadata has the format:
+ *   uint32_t - Number of parts
+ *   part0_md
+ *   ...
+ *   partN_md
+ * Where each part*_md has the fixed format:
+ *   uint32_t - Size of the part in bytes
+ *   uint32_t - Size of the encoded part in bytes (equal to the part size if
+ *              the part was stored unmodified)
+ *
+ * The forward output data format is the concatenated encoded parts, where each
+ * encoded part is the concatenated blocks, followed by the trailing bytes:
+ *   T - Block minimum value (first value with the delta option)
+ *   T - Minimum difference (only with the delta option)
+ *   uint8_t - Block bit width W
+ *   uint64_t[] - The value offsets packed with W bits each, least significant
+ *                bits first (ceil(block values * W / 64) words, with one value
+ *                less with the delta option)
+ *
+ * The reverse output format is simply:
+ *   T[] - Array of original elements
+ */
+class FrameOfReferenceFilter : public Filter {
+ public:
+  /** Constructor. */
+  FrameOfReferenceFilter();
+
+  /** Returns true if the differences of consecutive values are encoded. */
+  bool delta() const;
+
+  /** Encodes the input. */
+  Status run_forward(
+      FilterBuffer* input_metadata,
+      FilterBuffer* input,
+      FilterBuffer* output_metadata,
+      FilterBuffer* output) const override;
+
+  /** Decodes the input. */
+  Status run_reverse(
+      FilterBuffer* input_metadata,
+      FilterBuffer* input,
+      FilterBuffer* output_metadata,
+      FilterBuffer* output) const override;
+
+ private:
+  /** True if the differences of consecutive values are encoded. */
+  bool delta_;
+
+  /** Returns a new clone of this filter. */
+  FrameOfReferenceFilter* clone_impl() const override;
+
+  /** Sets an option on this filter. */
+  Status set_option_impl(FilterOption option, const void* value) override;
+
+  /** Gets an option from this filter. */
+  Status get_option_impl(FilterOption option, void* value) const override;
+
+  /** Deserializes this filter's metadata from the given buffer. */
+  Status deserialize_impl(ConstBuffer* buff) override;
+
+  /** Serializes this filter's metadata to the given buffer. */
+  Status serialize_impl(Buffer* buff) const override;
+
+  /** Run forward, templated on the tile type. */
+  template <typename T>
+  Status run_forward(
+      FilterBuffer* input_metadata,
+      FilterBuffer* input,
+      FilterBuffer* output_metadata,
+      FilterBuffer* output) const;
+
+  /** Run reverse, templated on the tile type. */
+  template <typename T>
+  Status run_reverse(
+      FilterBuffer* input_metadata,
+      FilterBuffer* input,
+      FilterBuffer* output_metadata,
+      FilterBuffer* output) const;
+
+  /**
+   * Encodes the values of the input part.
+   *
+   * @param part The input part.
+   * @param encoded The encoded blocks, followed by the trailing bytes.
+   */
+  template <typename T>
+  void encode_part(const ConstBuffer& part, std::vector<uint8_t>* encoded)
+      const;
+
+  /**
+   * Decodes an encoded part.
+   *
+   * @param encoded The encoded part.
+   * @param part_size The size of the decoded part.
+   * @param output The buffer to write the decoded part to.
+   * @return Status
+   */
+  template <typename T>
+  Status decode_part(
+      const ConstBuffer& encoded, uint32_t part_size, FilterBuffer* output)
+      const;
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_FRAME_OF_REFERENCE_FILTER_H
@@ -39,9 +39,14 @@
 #include "tiledb/sm/misc/utils.h"
 #include "tiledb/sm/tile/tile.h"
 
+#include <cstring>
+
 namespace tiledb {
 namespace sm {
 
+/** Number of window values encoded or decoded per bulk buffer access. */
+static const uint32_t batch_nelts = 256;
+
 PositiveDeltaFilter::PositiveDeltaFilter()
     : Filter(FilterType::FILTER_POSITIVE_DELTA) {
   max_window_size_ = 1024;
@@ -185,20 +190,27 @@ Status PositiveDeltaFilter::encode_part(
           output->write((char*)input->data() + input->offset(), window_nbytes));
       input->advance_offset(window_nbytes);
     } else {
-      // Encode and write the relative values to output.
-      T prev_value = input->value<T>();
-      for (uint32_t j = 0; j < window_nelts; j++) {
-        T curr_value = input->value<T>();
-        if (curr_value < prev_value)
+      // Encode and write the relative values to output, one batch at a time.
+      auto values = (const char*)input->data() + input->offset();
+      T batch[batch_nelts], deltas[batch_nelts];
+      T prev_value = window_value_offset;
+      for (uint32_t start = 0; start < window_nelts; start += batch_nelts) {
+        uint32_t n = std::min(batch_nelts, window_nelts - start);
+        std::memcpy(batch, values + start * sizeof(T), n * sizeof(T));
+        bool decreasing = batch[0] < prev_value;
+        deltas[0] = batch[0] - prev_value;
+        for (uint32_t j = 1; j < n; j++) {
+          decreasing |= batch[j] < batch[j - 1];
+          deltas[j] = batch[j] - batch[j - 1];
+        }
+        if (decreasing)
           return LOG_STATUS(Status::FilterError(
               "Positive delta filter error: delta is not positive."));
 
-        T delta = curr_value - prev_value;
-        RETURN_NOT_OK(output->write(&delta, sizeof(T)));
-        input->advance_offset(sizeof(T));
-
-        prev_value = curr_value;
+        RETURN_NOT_OK(output->write(deltas, n * sizeof(T)));
+        prev_value = batch[n - 1];
       }
+      input->advance_offset(window_nbytes);
     }
   }
 
@@ -292,16 +304,18 @@ Status PositiveDeltaFilter::run_reverse(
       RETURN_NOT_OK(output->write(input, window_nbytes));
       input->advance_offset(window_nbytes);
     } else {
-      // Read and decode each window value.
+      // Read and decode the window values, one batch at a time.
       uint32_t window_nelts = window_nbytes / sizeof(T);
+      T batch[batch_nelts];
       T prev_value = window_value_offset;
-      for (uint32_t j = 0; j < window_nelts; j++) {
-        T delta;
-        RETURN_NOT_OK(input->read(&delta, sizeof(T)));
-        T decoded_value = prev_value + delta;
-        RETURN_NOT_OK(output->write(&decoded_value, tile_type_size));
-
-        prev_value = decoded_value;
+      for (uint32_t start = 0; start < window_nelts; start += batch_nelts) {
+        uint32_t n = std::min(batch_nelts, window_nelts - start);
+        RETURN_NOT_OK(input->read(batch, n * sizeof(T)));
+        for (uint32_t j = 0; j < n; j++) {
+          batch[j] += prev_value;
+          prev_value = batch[j];
+        }
+        RETURN_NOT_OK(output->write(batch, n * sizeof(T)));
       }
     }
   }
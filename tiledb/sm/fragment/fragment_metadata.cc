@@ -37,7 +37,12 @@
 #include "tiledb/sm/array_schema/dimension.h"
 #include "tiledb/sm/array_schema/domain.h"
 #include "tiledb/sm/buffer/const_buffer.h"
+#include "tiledb/sm/cache/fragment_metadata_cache.h"
+#include "tiledb/sm/cache/index_cache.h"
+#include "tiledb/sm/encryption/encryption_key.h"
+#include "tiledb/sm/enums/encryption_type.h"
 #include "tiledb/sm/filesystem/vfs.h"
+#include "tiledb/sm/global_state/global_state.h"
 #include "tiledb/sm/misc/constants.h"
 #include "tiledb/sm/misc/logger.h"
 #include "tiledb/sm/misc/stats.h"
@@ -46,12 +51,24 @@
 #include "tiledb/sm/tile/tile.h"
 #include "tiledb/sm/tile/tile_io.h"
 
+#include <algorithm>
 #include <cassert>
+#include <functional>
 #include <iostream>
 
 namespace tiledb {
 namespace sm {
 
+namespace {
+
+/** A buffer viewing a mapped file region, which it keeps mapped. */
+struct MappedBuffer {
+  std::shared_ptr<MappedRegion> region_;
+  Buffer buffer_;
+};
+
+}  // namespace
+
 /* ****************************** */
 /*   CONSTRUCTORS & DESTRUCTORS   */
 /* ****************************** */
@@ -66,6 +83,7 @@ FragmentMetadata::FragmentMetadata(
     , array_schema_(array_schema)
     , dense_(dense)
     , fragment_uri_(fragment_uri)
+    , id_(std::hash<std::string>()(fragment_uri.to_string()))
     , timestamp_range_(timestamp_range) {
   domain_ = nullptr;
   meta_file_size_ = 0;
@@ -73,6 +91,12 @@ FragmentMetadata::FragmentMetadata(
   version_ = constants::format_version;
   tile_index_base_ = 0;
   sparse_tile_num_ = 0;
+  coords_bloom_filter_bits_ = 0;
+  rtree_str_packing_ = false;
+  sketches_ = false;
+  unfiltered_ = false;
+  packed_ = false;
+  locked_ = false;
   auto attributes = array_schema_->attributes();
   for (unsigned i = 0; i < attributes.size(); ++i) {
     auto attr_name = attributes[i]->name();
@@ -88,20 +112,53 @@ FragmentMetadata::FragmentMetadata(
 FragmentMetadata::~FragmentMetadata() {
   std::free(domain_);
   std::free(non_empty_domain_);
-
-  auto mbr_num = (uint64_t)mbrs_.size();
-  for (uint64_t i = 0; i < mbr_num; ++i)
-    std::free(mbrs_[i]);
-
-  auto bounding_coords_num = (uint64_t)bounding_coords_.size();
-  for (uint64_t i = 0; i < bounding_coords_num; ++i)
-    std::free(bounding_coords_[i]);
 }
 
 /* ****************************** */
 /*                API             */
 /* ****************************** */
 
+void FragmentMetadata::add_coords_hashes(const std::vector<uint64_t>& hashes) {
+  if (coords_bloom_filter_bits_ == 0)
+    return;
+  std::lock_guard<std::mutex> lock(mtx_);
+  coords_hashes_.insert(coords_hashes_.end(), hashes.begin(), hashes.end());
+}
+
+void FragmentMetadata::add_sketches(
+    const std::string& name, const HyperLogLog& hll, const KllSketch& kll) {
+  auto it = idx_map_.find(name);
+  assert(it != idx_map_.end());
+  auto idx = it->second;
+  assert(idx < hlls_.size() && hlls_[idx] != nullptr);
+  std::lock_guard<std::mutex> lock(mtx_);
+  hlls_[idx]->merge(hll);
+  klls_[idx]->merge(kll);
+}
+
+void FragmentMetadata::add_value_index_tile(
+    const std::string& name,
+    uint64_t tid,
+    const void* values,
+    uint64_t cell_num) {
+  auto it = idx_map_.find(name);
+  assert(it != idx_map_.end());
+  auto idx = it->second;
+  assert(idx < value_indexes_.size() && value_indexes_[idx] != nullptr);
+  std::lock_guard<std::mutex> lock(mtx_);
+  value_indexes_[idx]->add_tile(tid + tile_index_base_, values, cell_num);
+}
+
+void FragmentMetadata::add_value_index(
+    const std::string& name, const ValueIndex& index) {
+  auto it = idx_map_.find(name);
+  assert(it != idx_map_.end());
+  auto idx = it->second;
+  assert(idx < value_indexes_.size() && value_indexes_[idx] != nullptr);
+  std::lock_guard<std::mutex> lock(mtx_);
+  value_indexes_[idx]->merge(index, tile_index_base_);
+}
+
 const URI& FragmentMetadata::array_uri() const {
   return array_schema_->array_uri();
 }
@@ -154,11 +211,9 @@ Status FragmentMetadata::set_mbr(uint64_t tile, const void* mbr) {
   uint64_t mbr_size = 2 * array_schema_->coords_size();
   tile += tile_index_base_;
 
-  // Copy and set MBR
-  void* new_mbr = std::malloc(mbr_size);
-  std::memcpy(new_mbr, mbr, mbr_size);
-  assert(tile < mbrs_.size());
-  mbrs_[tile] = new_mbr;
+  // Copy MBR
+  assert((tile + 1) * mbr_size <= mbrs_.size());
+  std::memcpy(&mbrs_[tile * mbr_size], mbr, mbr_size);
 
   return expand_non_empty_domain(static_cast<const T*>(mbr));
 }
@@ -178,6 +233,24 @@ void FragmentMetadata::set_tile_offset(
   next_tile_offsets_[idx] += step;
 }
 
+void FragmentMetadata::set_tile_min_max_sum(
+    const std::string& name,
+    uint64_t tid,
+    const void* min,
+    const void* max,
+    const void* sum) {
+  auto it = idx_map_.find(name);
+  assert(it != idx_map_.end());
+  auto idx = it->second;
+  assert(has_tile_min_max_sum(idx));
+  auto cell_size = array_schema_->cell_size(name);
+  tid += tile_index_base_;
+  assert((tid + 1) * cell_size <= tile_min_[idx].size());
+  std::memcpy(&tile_min_[idx][tid * cell_size], min, cell_size);
+  std::memcpy(&tile_max_[idx][tid * cell_size], max, cell_size);
+  std::memcpy(&tile_sum_[idx][tid * sizeof(uint64_t)], sum, sizeof(uint64_t));
+}
+
 void FragmentMetadata::set_tile_var_offset(
     const std::string& name, uint64_t tid, uint64_t step) {
   auto it = idx_map_.find(name);
@@ -210,6 +283,12 @@ uint64_t FragmentMetadata::cell_num(uint64_t tile_pos) const {
   return last_tile_cell_num();
 }
 
+const BloomFilter* FragmentMetadata::coords_bloom_filter() const {
+  if (!loaded_metadata_.coords_bloom_filter_ || coords_bloom_filter_.empty())
+    return nullptr;
+  return &coords_bloom_filter_;
+}
+
 template <class T>
 Status FragmentMetadata::add_max_buffer_sizes(
     const EncryptionKey& encryption_key,
@@ -262,7 +341,7 @@ Status FragmentMetadata::add_max_buffer_sizes_sparse(
   range.resize(dim_num);
   for (unsigned i = 0; i < dim_num; ++i)
     range[i] = &subarray[2 * i];
-  auto tile_overlap = rtree_.get_tile_overlap<T>(range);
+  auto tile_overlap = rtree_->get_tile_overlap<T>(range);
   uint64_t size = 0;
 
   // Handle tile ranges
@@ -326,10 +405,101 @@ Status FragmentMetadata::fragment_size(uint64_t* size) const {
   return Status::Ok();
 }
 
+Status FragmentMetadata::get_tile_min_max_sum(
+    const EncryptionKey& encryption_key,
+    const std::string& name,
+    uint64_t tile_idx,
+    const void** min,
+    const void** max,
+    const void** sum) {
+  *min = nullptr;
+  *max = nullptr;
+  *sum = nullptr;
+
+  auto it = idx_map_.find(name);
+  if (version_ < 5 || it == idx_map_.end() || !has_tile_min_max_sum(it->second))
+    return Status::Ok();
+
+  auto idx = it->second;
+  RETURN_NOT_OK(load_tile_min_max_sum(encryption_key, idx));
+
+  auto cell_size = array_schema_->cell_size(name);
+  if ((tile_idx + 1) * cell_size > tile_min_[idx].size())
+    return Status::Ok();
+
+  *min = &tile_min_[idx][tile_idx * cell_size];
+  *max = &tile_max_[idx][tile_idx * cell_size];
+  *sum = &tile_sum_[idx][tile_idx * sizeof(uint64_t)];
+
+  return Status::Ok();
+}
+
+Status FragmentMetadata::get_sketches(
+    const EncryptionKey& encryption_key,
+    const std::string& name,
+    const HyperLogLog** hll,
+    const KllSketch** kll) {
+  *hll = nullptr;
+  *kll = nullptr;
+
+  auto it = idx_map_.find(name);
+  if (version_ < 8 || it == idx_map_.end() ||
+      it->second >= array_schema_->attribute_num())
+    return Status::Ok();
+
+  auto idx = it->second;
+  RETURN_NOT_OK(load_sketches(encryption_key, idx));
+
+  *hll = hlls_[idx].get();
+  *kll = klls_[idx].get();
+
+  return Status::Ok();
+}
+
+bool FragmentMetadata::has_sketches(const std::string& name) const {
+  return sketches_ && has_tile_min_max_sum(name);
+}
+
+Status FragmentMetadata::get_value_index(
+    const EncryptionKey& encryption_key,
+    const std::string& name,
+    const ValueIndex** index) {
+  *index = nullptr;
+
+  auto it = idx_map_.find(name);
+  if (version_ < 9 || it == idx_map_.end() ||
+      it->second >= array_schema_->attribute_num())
+    return Status::Ok();
+
+  auto idx = it->second;
+  RETURN_NOT_OK(load_value_index(encryption_key, idx));
+
+  *index = value_indexes_[idx].get();
+
+  return Status::Ok();
+}
+
+bool FragmentMetadata::has_value_index(const std::string& name) const {
+  return std::find(
+             value_index_attributes_.begin(),
+             value_index_attributes_.end(),
+             name) != value_index_attributes_.end() &&
+         has_tile_min_max_sum(name);
+}
+
+bool FragmentMetadata::has_tile_min_max_sum(const std::string& name) const {
+  auto it = idx_map_.find(name);
+  return it != idx_map_.end() && has_tile_min_max_sum(it->second);
+}
+
 const URI& FragmentMetadata::fragment_uri() const {
   return fragment_uri_;
 }
 
+uint64_t FragmentMetadata::id() const {
+  return id_;
+}
+
 template <class T>
 Status FragmentMetadata::get_tile_overlap(
     const EncryptionKey& encryption_key,
@@ -342,14 +512,15 @@ Status FragmentMetadata::get_tile_overlap(
   // Handle version > 2
   if (version_ > 2) {
     RETURN_NOT_OK(load_rtree(encryption_key));
-    *tile_overlap = rtree_.get_tile_overlap<T>(range);
+    *tile_overlap = rtree_->get_tile_overlap<T>(range);
     return Status::Ok();
   }
 
   // Handle version <= 2
-  auto mbr_num = mbrs_.size();
+  auto mbr_size = 2 * array_schema_->coords_size();
+  auto mbr_num = mbrs_.size() / mbr_size;
   for (size_t t = 0; t < mbr_num; ++t) {
-    auto m = (const T*)mbrs_[t];
+    auto m = (const T*)&mbrs_[t * mbr_size];
     auto overlap = RTree::range_overlap<T>(range, m);
     if (overlap > 0.0) {
       auto to = std::pair<uint64_t, double>(t, overlap);
@@ -360,6 +531,71 @@ Status FragmentMetadata::get_tile_overlap(
   return Status::Ok();
 }
 
+template <class T>
+Status FragmentMetadata::get_tile_overlap(
+    const EncryptionKey& encryption_key,
+    const std::vector<const T*>& range,
+    const TileOverlap& candidates,
+    TileOverlap* tile_overlap) {
+  // Return if the range does not overlap the non-empty domain of the fragment
+  if (!utils::geometry::overlap(range, (const T*)non_empty_domain_))
+    return Status::Ok();
+
+  if (version_ > 2)
+    RETURN_NOT_OK(load_rtree(encryption_key));
+
+  // Collect the candidate tiles in ascending order
+  std::vector<uint64_t> tids;
+  for (const auto& tr : candidates.tile_ranges_) {
+    for (uint64_t tid = tr.first; tid <= tr.second; ++tid)
+      tids.push_back(tid);
+  }
+  for (const auto& t : candidates.tiles_)
+    tids.push_back(t.first);
+  std::sort(tids.begin(), tids.end());
+
+  // Check the candidate MBRs, grouping contiguous full overlaps
+  uint64_t start_tid = UINT64_MAX;  // Indicates no new range has started
+  uint64_t end_tid = UINT64_MAX;
+  auto add_full_range = [&]() {
+    if (start_tid == UINT64_MAX)
+      return;
+    if (start_tid != end_tid)
+      tile_overlap->tile_ranges_.emplace_back(start_tid, end_tid);
+    else
+      tile_overlap->tiles_.emplace_back(start_tid, 1.0);
+    start_tid = UINT64_MAX;
+    end_tid = UINT64_MAX;
+  };
+  std::vector<T> leaf(2 * range.size());
+  for (auto tid : tids) {
+    const T* m = nullptr;
+    if (version_ > 2) {
+      rtree_->leaf(tid, &leaf[0]);
+      m = &leaf[0];
+    } else {
+      m = (const T*)&mbrs_[tid * 2 * array_schema_->coords_size()];
+    }
+    auto ratio = RTree::range_overlap<T>(range, m);
+    if (ratio == 1.0) {
+      if (start_tid != UINT64_MAX && tid == end_tid + 1) {
+        end_tid++;
+      } else {
+        add_full_range();
+        start_tid = tid;
+        end_tid = tid;
+      }
+    } else {
+      add_full_range();
+      if (ratio > 0.0)
+        tile_overlap->tiles_.emplace_back(tid, ratio);
+    }
+  }
+  add_full_range();
+
+  return Status::Ok();
+}
+
 Status FragmentMetadata::init(const void* non_empty_domain) {
   // For easy reference
   auto num = array_schema_->attribute_num() + array_schema_->dim_num() + 1;
@@ -407,6 +643,30 @@ Status FragmentMetadata::init(const void* non_empty_domain) {
   // Initialize variable tile sizes
   tile_var_sizes_.resize(num);
 
+  // Initialize tile min/max/sum values
+  auto attribute_num = array_schema_->attribute_num();
+  tile_min_.resize(attribute_num);
+  tile_max_.resize(attribute_num);
+  tile_sum_.resize(attribute_num);
+
+  // Initialize the sketches of the numeric attributes
+  hlls_.resize(attribute_num);
+  klls_.resize(attribute_num);
+  for (unsigned i = 0; i < attribute_num && sketches_; ++i) {
+    if (!has_tile_min_max_sum(i))
+      continue;
+    hlls_[i].reset(new HyperLogLog());
+    klls_[i].reset(new KllSketch());
+  }
+
+  // Initialize the value indexes of the chosen attributes
+  value_indexes_.resize(attribute_num);
+  for (unsigned i = 0; i < attribute_num; ++i) {
+    const auto& name = array_schema_->attribute(i)->name();
+    if (has_value_index(name))
+      value_indexes_[i].reset(new ValueIndex(array_schema_->type(name)));
+  }
+
   return Status::Ok();
 }
 
@@ -414,10 +674,17 @@ uint64_t FragmentMetadata::last_tile_cell_num() const {
   return last_tile_cell_num_;
 }
 
-Status FragmentMetadata::load(const EncryptionKey& encryption_key) {
+Status FragmentMetadata::load(
+    const EncryptionKey& encryption_key, uint64_t speculative_read_size) {
   auto meta_uri = fragment_uri_.join_path(
       std::string(constants::fragment_metadata_filename));
-  RETURN_NOT_OK(storage_manager_->vfs()->file_size(meta_uri, &meta_file_size_));
+  auto cache = metadata_cache(encryption_key);
+  if (cache == nullptr || !cache->file_size(meta_uri, &meta_file_size_)) {
+    RETURN_NOT_OK(
+        storage_manager_->vfs()->file_size(meta_uri, &meta_file_size_));
+    if (cache != nullptr)
+      cache->insert_file_size(meta_uri, meta_file_size_);
+  }
 
   // Get fragment name version
   uint32_t f_version;
@@ -434,13 +701,101 @@ Status FragmentMetadata::load(const EncryptionKey& encryption_key) {
   //    * __t1_t2_uuid_version
   if (f_version == 1)
     return load_v1_v2(encryption_key);
-  return load_v3_or_higher(encryption_key);
+  return load_v3_or_higher(encryption_key, speculative_read_size);
+}
+
+// ===== FORMAT =====
+// meta_file_size (uint64_t)
+// footer_size (uint64_t)
+// footer (uint8_t[])
+// rtree_size (uint64_t)
+// rtree (uint8_t[])
+Status FragmentMetadata::load_consolidated(ConstBuffer* buff) {
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  RETURN_NOT_OK(buff->read(&meta_file_size_, sizeof(uint64_t)));
+
+  uint64_t footer_size;
+  RETURN_NOT_OK(buff->read(&footer_size, sizeof(uint64_t)));
+  if (buff->nbytes_left_to_read() < footer_size)
+    return LOG_STATUS(Status::FragmentMetadataError(
+        "Cannot load consolidated fragment metadata; Invalid footer size"));
+  ConstBuffer footer(buff->cur_data(), footer_size);
+  RETURN_NOT_OK(load_footer(&footer));
+  buff->advance_offset(footer_size);
+
+  uint64_t rtree_size;
+  RETURN_NOT_OK(buff->read(&rtree_size, sizeof(uint64_t)));
+  if (buff->nbytes_left_to_read() < rtree_size)
+    return LOG_STATUS(Status::FragmentMetadataError(
+        "Cannot load consolidated fragment metadata; Invalid R-Tree size"));
+  ConstBuffer rtree_buff(buff->cur_data(), rtree_size);
+  auto rtree = std::make_shared<RTree>();
+  RETURN_NOT_OK(rtree->deserialize(&rtree_buff));
+  buff->advance_offset(rtree_size);
+  rtree_ = rtree;
+  loaded_metadata_.rtree_ = true;
+
+  return Status::Ok();
+}
+
+Status FragmentMetadata::write_consolidated(
+    const EncryptionKey& encryption_key, Buffer* buff) {
+  if (version_ <= 2)
+    return LOG_STATUS(Status::FragmentMetadataError(
+        "Cannot consolidate fragment metadata; Unsupported format version"));
+
+  std::shared_ptr<const Buffer> footer;
+  RETURN_NOT_OK(read_file_footer(encryption_key, &footer));
+  RETURN_NOT_OK(load_rtree(encryption_key));
+  Buffer rtree_buff;
+  RETURN_NOT_OK(rtree_->serialize(&rtree_buff));
+
+  uint64_t footer_size = footer->size(), rtree_size = rtree_buff.size();
+  RETURN_NOT_OK(buff->write(&meta_file_size_, sizeof(uint64_t)));
+  RETURN_NOT_OK(buff->write(&footer_size, sizeof(uint64_t)));
+  RETURN_NOT_OK(buff->write(footer->data(), footer_size));
+  RETURN_NOT_OK(buff->write(&rtree_size, sizeof(uint64_t)));
+  RETURN_NOT_OK(buff->write(rtree_buff.data(), rtree_size));
+
+  return Status::Ok();
 }
 
-const std::vector<void*> FragmentMetadata::mbrs() const {
+const std::vector<uint8_t>& FragmentMetadata::mbrs() const {
   return mbrs_;
 }
 
+uint64_t FragmentMetadata::memory_size() {
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  auto vectors_size = [](const std::vector<std::vector<uint64_t>>& vs) {
+    uint64_t size = 0;
+    for (const auto& v : vs)
+      size += v.capacity() * sizeof(uint64_t);
+    return size;
+  };
+  auto bytes_size = [](const std::vector<std::vector<uint8_t>>& vs) {
+    uint64_t size = 0;
+    for (const auto& v : vs)
+      size += v.capacity();
+    return size;
+  };
+
+  uint64_t size = bounding_coords_.capacity() + mbrs_.capacity();
+  if (rtree_ != nullptr)
+    size += rtree_->size();
+  size += vectors_size(tile_offsets_) + vectors_size(tile_var_offsets_) +
+          vectors_size(tile_var_sizes_);
+  size += bytes_size(tile_min_) + bytes_size(tile_max_) + bytes_size(tile_sum_);
+  size += coords_bloom_filter_.size();
+  for (const auto& value_index : value_indexes_) {
+    if (value_index != nullptr)
+      size += value_index->size();
+  }
+
+  return size;
+}
+
 Status FragmentMetadata::store(const EncryptionKey& encryption_key) {
   auto array_uri = this->array_uri();
   auto fragment_metadata_uri =
@@ -455,8 +810,8 @@ Status FragmentMetadata::store(const EncryptionKey& encryption_key) {
   if (!is_dir)
     return Status::Ok();
 
-  // Exclusively lock the array
-  RETURN_NOT_OK(storage_manager_->array_xlock(array_uri));
+  // Lock the array for the commit
+  RETURN_NOT_OK(storage_manager_->array_commit_lock(array_uri, &locked_));
 
   // Store R-Tree
   gt_offsets_.rtree_ = offset;
@@ -466,27 +821,66 @@ Status FragmentMetadata::store(const EncryptionKey& encryption_key) {
   // Store tile offsets
   gt_offsets_.tile_offsets_.resize(num);
   for (unsigned int i = 0; i < num; ++i) {
-    gt_offsets_.tile_offsets_[i] = offset;
     RETURN_NOT_OK_ELSE(
-        store_tile_offsets(i, encryption_key, &nbytes), clean_up());
+        store_tile_offsets(i, encryption_key, offset, &nbytes), clean_up());
     offset += nbytes;
   }
 
   // Store tile var offsets
   gt_offsets_.tile_var_offsets_.resize(num);
   for (unsigned int i = 0; i < num; ++i) {
-    gt_offsets_.tile_var_offsets_[i] = offset;
     RETURN_NOT_OK_ELSE(
-        store_tile_var_offsets(i, encryption_key, &nbytes), clean_up());
+        store_tile_var_offsets(i, encryption_key, offset, &nbytes), clean_up());
     offset += nbytes;
   }
 
   // Store tile var sizes
   gt_offsets_.tile_var_sizes_.resize(num);
   for (unsigned int i = 0; i < num; ++i) {
-    gt_offsets_.tile_var_sizes_[i] = offset;
     RETURN_NOT_OK_ELSE(
-        store_tile_var_sizes(i, encryption_key, &nbytes), clean_up());
+        store_tile_var_sizes(i, encryption_key, offset, &nbytes), clean_up());
+    offset += nbytes;
+  }
+
+  // Store tile min/max/sum values
+  auto attribute_num = array_schema_->attribute_num();
+  gt_offsets_.tile_min_max_sum_.assign(attribute_num, UINT64_MAX);
+  for (unsigned int i = 0; i < attribute_num; ++i) {
+    if (!has_tile_min_max_sum(i))
+      continue;
+    gt_offsets_.tile_min_max_sum_[i] = offset;
+    RETURN_NOT_OK_ELSE(
+        store_tile_min_max_sum(i, encryption_key, &nbytes), clean_up());
+    offset += nbytes;
+  }
+
+  // Store coordinate bloom filter
+  if (coords_bloom_filter_bits_ > 0 && !coords_hashes_.empty()) {
+    gt_offsets_.coords_bloom_filter_ = offset;
+    RETURN_NOT_OK_ELSE(
+        store_coords_bloom_filter(encryption_key, &nbytes), clean_up());
+    offset += nbytes;
+  }
+
+  // Store sketches
+  gt_offsets_.sketches_.assign(attribute_num, UINT64_MAX);
+  for (unsigned int i = 0; i < attribute_num; ++i) {
+    if (hlls_[i] == nullptr)
+      continue;
+    gt_offsets_.sketches_[i] = offset;
+    RETURN_NOT_OK_ELSE(
+        store_sketches(i, encryption_key, &nbytes), clean_up());
+    offset += nbytes;
+  }
+
+  // Store value indexes
+  gt_offsets_.value_indexes_.assign(attribute_num, UINT64_MAX);
+  for (unsigned int i = 0; i < attribute_num; ++i) {
+    if (value_indexes_[i] == nullptr)
+      continue;
+    gt_offsets_.value_indexes_[i] = offset;
+    RETURN_NOT_OK_ELSE(
+        store_value_index(i, encryption_key, &nbytes), clean_up());
     offset += nbytes;
   }
 
@@ -497,11 +891,37 @@ Status FragmentMetadata::store(const EncryptionKey& encryption_key) {
   auto st = storage_manager_->close_file(fragment_metadata_uri);
 
   // Unlock array
-  auto st2 = storage_manager_->array_xunlock(array_uri);
+  auto st2 = Status::Ok();
+  if (locked_)
+    st2 = storage_manager_->array_xunlock(array_uri);
+  locked_ = false;
 
   return !st.ok() ? st : st2;
 }
 
+Status FragmentMetadata::load_coords_bloom_filter(
+    const EncryptionKey& encryption_key) {
+  if (version_ < 5)
+    return Status::Ok();
+
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  if (loaded_metadata_.coords_bloom_filter_)
+    return Status::Ok();
+
+  if (gt_offsets_.coords_bloom_filter_ != UINT64_MAX) {
+    std::shared_ptr<const Buffer> buff;
+    RETURN_NOT_OK(read_generic_tile_from_file(
+        encryption_key, gt_offsets_.coords_bloom_filter_, &buff));
+    ConstBuffer cbuff(buff->data(), buff->size());
+    RETURN_NOT_OK(coords_bloom_filter_.deserialize(&cbuff));
+  }
+
+  loaded_metadata_.coords_bloom_filter_ = true;
+
+  return Status::Ok();
+}
+
 const void* FragmentMetadata::non_empty_domain() const {
   return non_empty_domain_;
 }
@@ -525,15 +945,52 @@ Status FragmentMetadata::set_num_tiles(uint64_t num_tiles) {
     tile_var_sizes_[i].resize(num_tiles, 0);
   }
 
+  auto attribute_num = array_schema_->attribute_num();
+  for (unsigned i = 0; i < attribute_num; i++) {
+    if (!has_tile_min_max_sum(i))
+      continue;
+    auto cell_size = array_schema_->attributes()[i]->cell_size();
+    tile_min_[i].resize(num_tiles * cell_size, 0);
+    tile_max_[i].resize(num_tiles * cell_size, 0);
+    tile_sum_[i].resize(num_tiles * sizeof(uint64_t), 0);
+  }
+
   if (!dense_) {
-    mbrs_.resize(num_tiles, nullptr);
+    auto mbr_size = 2 * array_schema_->coords_size();
+    mbrs_.resize(num_tiles * mbr_size, 0);
     sparse_tile_num_ = num_tiles;
-    bounding_coords_.resize(num_tiles, nullptr);
+    bounding_coords_.resize(num_tiles * mbr_size, 0);
   }
 
   return Status::Ok();
 }
 
+void FragmentMetadata::set_coords_bloom_filter_bits(uint32_t bits_per_cell) {
+  coords_bloom_filter_bits_ = bits_per_cell;
+}
+
+void FragmentMetadata::set_rtree_str_packing(bool str_packing) {
+  rtree_str_packing_ = str_packing;
+}
+
+void FragmentMetadata::set_sketches(bool sketches) {
+  sketches_ = sketches;
+}
+
+void FragmentMetadata::set_value_index_attributes(
+    const std::vector<std::string>& names) {
+  value_index_attributes_ = names;
+}
+
+void FragmentMetadata::set_unfiltered(bool unfiltered) {
+  unfiltered_ = unfiltered;
+}
+
+void FragmentMetadata::set_packed() {
+  packed_ = true;
+  compute_packed_offsets(next_tile_offsets_, next_tile_var_offsets_);
+}
+
 void FragmentMetadata::set_last_tile_cell_num(uint64_t cell_num) {
   last_tile_cell_num_ = cell_num;
 }
@@ -550,13 +1007,42 @@ uint64_t FragmentMetadata::tile_num() const {
 }
 
 URI FragmentMetadata::uri(const std::string& name) const {
+  if (packed_ || array_schema_->tile_colocation())
+    return packed_uri();
   return fragment_uri_.join_path(name + constants::file_suffix);
 }
 
 URI FragmentMetadata::var_uri(const std::string& name) const {
+  if (packed_ || array_schema_->tile_colocation())
+    return packed_uri();
   return fragment_uri_.join_path(name + "_var" + constants::file_suffix);
 }
 
+bool FragmentMetadata::packed() const {
+  return packed_;
+}
+
+URI FragmentMetadata::packed_uri() const {
+  return fragment_uri_.join_path(constants::packed_fragment_filename);
+}
+
+void FragmentMetadata::packed_range(
+    const std::string& name, bool var, uint64_t* offset, uint64_t* size)
+    const {
+  assert(packed_);
+  auto it = idx_map_.find(name);
+  assert(it != idx_map_.end());
+  auto idx = it->second;
+  *offset = packed_offsets_[file_id(name, var)];
+  *size = var ? file_var_sizes_[idx] : file_sizes_[idx];
+}
+
+uint64_t FragmentMetadata::file_id(const std::string& name, bool var) const {
+  auto it = idx_map_.find(name);
+  assert(it != idx_map_.end());
+  return 2 * (uint64_t)it->second + (var ? 1 : 0);
+}
+
 Status FragmentMetadata::file_offset(
     const EncryptionKey& encryption_key,
     const std::string& name,
@@ -565,8 +1051,12 @@ Status FragmentMetadata::file_offset(
   auto it = idx_map_.find(name);
   assert(it != idx_map_.end());
   auto idx = it->second;
-  RETURN_NOT_OK(load_tile_offsets(encryption_key, idx));
+  if (array_schema_->tile_colocation())
+    return colocated_file_offset(encryption_key, idx, false, tile_idx, offset);
+  RETURN_NOT_OK(load_tile_offsets(encryption_key, idx, tile_idx));
   *offset = tile_offsets_[idx][tile_idx];
+  if (packed_)
+    *offset += packed_offsets_[2 * idx];
   return Status::Ok();
 }
 
@@ -578,13 +1068,17 @@ Status FragmentMetadata::file_var_offset(
   auto it = idx_map_.find(name);
   assert(it != idx_map_.end());
   auto idx = it->second;
-  RETURN_NOT_OK(load_tile_var_offsets(encryption_key, idx));
+  if (array_schema_->tile_colocation())
+    return colocated_file_offset(encryption_key, idx, true, tile_idx, offset);
+  RETURN_NOT_OK(load_tile_var_offsets(encryption_key, idx, tile_idx));
   *offset = tile_var_offsets_[idx][tile_idx];
+  if (packed_)
+    *offset += packed_offsets_[2 * idx + 1];
   return Status::Ok();
 }
 
-const void* FragmentMetadata::mbr(uint64_t tile_idx) const {
-  return rtree_.leaf(tile_idx);
+void FragmentMetadata::mbr(uint64_t tile_idx, void* mbr) const {
+  rtree_->leaf(tile_idx, mbr);
 }
 
 Status FragmentMetadata::persisted_tile_size(
@@ -595,9 +1089,10 @@ Status FragmentMetadata::persisted_tile_size(
   auto it = idx_map_.find(name);
   assert(it != idx_map_.end());
   auto idx = it->second;
-  RETURN_NOT_OK(load_tile_offsets(encryption_key, idx));
-
   auto tile_num = this->tile_num();
+  RETURN_NOT_OK(load_tile_offsets(encryption_key, idx, tile_idx));
+  if (tile_idx != tile_num - 1)
+    RETURN_NOT_OK(load_tile_offsets(encryption_key, idx, tile_idx + 1));
 
   *tile_size =
       (tile_idx != tile_num - 1) ?
@@ -615,8 +1110,10 @@ Status FragmentMetadata::persisted_tile_var_size(
   auto it = idx_map_.find(name);
   assert(it != idx_map_.end());
   auto idx = it->second;
-  RETURN_NOT_OK(load_tile_var_offsets(encryption_key, idx));
   auto tile_num = this->tile_num();
+  RETURN_NOT_OK(load_tile_var_offsets(encryption_key, idx, tile_idx));
+  if (tile_idx != tile_num - 1)
+    RETURN_NOT_OK(load_tile_var_offsets(encryption_key, idx, tile_idx + 1));
 
   *tile_size = (tile_idx != tile_num - 1) ?
                    tile_var_offsets_[idx][tile_idx + 1] -
@@ -642,7 +1139,7 @@ Status FragmentMetadata::tile_var_size(
   auto it = idx_map_.find(name);
   assert(it != idx_map_.end());
   auto idx = it->second;
-  RETURN_NOT_OK(load_tile_var_sizes(encryption_key, idx));
+  RETURN_NOT_OK(load_tile_var_sizes(encryption_key, idx, tile_idx));
   *tile_size = tile_var_sizes_[idx][tile_idx];
 
   return Status::Ok();
@@ -705,23 +1202,32 @@ Status FragmentMetadata::get_footer_offset_and_size_v3_v4(
 
 Status FragmentMetadata::get_footer_offset_and_size_v5_or_higher(
     uint64_t* offset, uint64_t* size) const {
-  auto num = array_schema_->attribute_num() + array_schema_->dim_num() + 1;
+  auto attribute_num = array_schema_->attribute_num();
+  auto num = attribute_num + array_schema_->dim_num() + 1;
   auto domain_size = 2 * array_schema_->coords_size();
 
   // Get footer size
   *size = 0;
-  *size += sizeof(uint32_t);        // version
-  *size += sizeof(char);            // dense
-  *size += sizeof(char);            // null non-empty domain
-  *size += domain_size;             // non-empty domain
-  *size += sizeof(uint64_t);        // sparse tile num
-  *size += sizeof(uint64_t);        // last tile cell num
-  *size += num * sizeof(uint64_t);  // file sizes
-  *size += num * sizeof(uint64_t);  // file var sizes
-  *size += sizeof(uint64_t);        // R-Tree offset
-  *size += num * sizeof(uint64_t);  // tile offsets
-  *size += num * sizeof(uint64_t);  // tile var offsets
-  *size += num * sizeof(uint64_t);  // tile var sizes
+  *size += sizeof(uint32_t);                   // version
+  *size += sizeof(char);                       // dense
+  *size += sizeof(char);                       // null non-empty domain
+  *size += domain_size;                        // non-empty domain
+  *size += sizeof(uint64_t);                   // sparse tile num
+  *size += sizeof(uint64_t);                   // last tile cell num
+  *size += num * sizeof(uint64_t);             // file sizes
+  *size += num * sizeof(uint64_t);             // file var sizes
+  *size += sizeof(uint64_t);                   // R-Tree offset
+  *size += num * sizeof(uint64_t);             // tile offsets
+  *size += num * sizeof(uint64_t);             // tile var offsets
+  *size += num * sizeof(uint64_t);             // tile var sizes
+  *size += attribute_num * sizeof(uint64_t);  // tile min/max/sum values
+  *size += sizeof(uint64_t);                   // coords bloom filter offset
+  if (version_ >= 7)
+    *size += sizeof(char);  // packed
+  if (version_ >= 8)
+    *size += attribute_num * sizeof(uint64_t);  // sketches
+  if (version_ >= 9)
+    *size += attribute_num * sizeof(uint64_t);  // value indexes
 
   // Get footer offset
   *offset = meta_file_size_ - *size;
@@ -866,6 +1372,44 @@ Status FragmentMetadata::expand_non_empty_domain(const T* mbr) {
   return Status::Ok();
 }
 
+bool FragmentMetadata::has_tile_min_max_sum(unsigned idx) const {
+  if (idx >= array_schema_->attribute_num())
+    return false;
+
+  auto attr = array_schema_->attributes()[idx];
+  if (attr->var_size() || attr->cell_val_num() != 1)
+    return false;
+
+  switch (attr->type()) {
+    case Datatype::INT8:
+    case Datatype::UINT8:
+    case Datatype::INT16:
+    case Datatype::UINT16:
+    case Datatype::INT32:
+    case Datatype::UINT32:
+    case Datatype::INT64:
+    case Datatype::UINT64:
+    case Datatype::FLOAT32:
+    case Datatype::FLOAT64:
+    case Datatype::DATETIME_YEAR:
+    case Datatype::DATETIME_MONTH:
+    case Datatype::DATETIME_WEEK:
+    case Datatype::DATETIME_DAY:
+    case Datatype::DATETIME_HR:
+    case Datatype::DATETIME_MIN:
+    case Datatype::DATETIME_SEC:
+    case Datatype::DATETIME_MS:
+    case Datatype::DATETIME_US:
+    case Datatype::DATETIME_NS:
+    case Datatype::DATETIME_PS:
+    case Datatype::DATETIME_FS:
+    case Datatype::DATETIME_AS:
+      return true;
+    default:
+      return false;
+  }
+}
+
 Status FragmentMetadata::load_rtree(const EncryptionKey& encryption_key) {
   if (version_ <= 2)
     return Status::Ok();
@@ -875,20 +1419,57 @@ Status FragmentMetadata::load_rtree(const EncryptionKey& encryption_key) {
   if (loaded_metadata_.rtree_)
     return Status::Ok();
 
-  Buffer buff;
+  // Check the index cache, which may hold the RTree deserialized by another
+  // handle of the array
+  auto index_cache = storage_manager_->index_cache();
+  if (index_cache != nullptr) {
+    rtree_ = index_cache->get_rtree(fragment_uri_);
+    if (rtree_ != nullptr) {
+      loaded_metadata_.rtree_ = true;
+      return Status::Ok();
+    }
+  }
+
+  std::shared_ptr<const Buffer> buff;
   RETURN_NOT_OK(
       read_generic_tile_from_file(encryption_key, gt_offsets_.rtree_, &buff));
 
-  ConstBuffer cbuff(&buff);
-  RETURN_NOT_OK(rtree_.deserialize(&cbuff));
+  ConstBuffer cbuff(buff->data(), buff->size());
+  auto rtree = std::make_shared<RTree>();
+  RETURN_NOT_OK(rtree->deserialize(&cbuff));
 
+  if (index_cache != nullptr)
+    index_cache->insert_rtree(fragment_uri_, rtree);
+  rtree_ = rtree;
   loaded_metadata_.rtree_ = true;
 
   return Status::Ok();
 }
 
+Status FragmentMetadata::load_read_metadata(
+    const EncryptionKey& encryption_key,
+    const std::vector<std::string>& names) {
+  RETURN_NOT_OK(load_rtree(encryption_key));
+  if (tile_num() == 0)
+    return Status::Ok();
+
+  for (const auto& name : names) {
+    auto it = idx_map_.find(name);
+    if (it == idx_map_.end())
+      continue;
+    auto idx = it->second;
+    RETURN_NOT_OK(load_tile_offsets(encryption_key, idx, 0));
+    if (array_schema_->var_size(name)) {
+      RETURN_NOT_OK(load_tile_var_offsets(encryption_key, idx, 0));
+      RETURN_NOT_OK(load_tile_var_sizes(encryption_key, idx, 0));
+    }
+  }
+
+  return Status::Ok();
+}
+
 Status FragmentMetadata::load_tile_offsets(
-    const EncryptionKey& encryption_key, unsigned idx) {
+    const EncryptionKey& encryption_key, unsigned idx, uint64_t tile_idx) {
   if (version_ <= 2)
     return Status::Ok();
 
@@ -897,10 +1478,23 @@ Status FragmentMetadata::load_tile_offsets(
   if (loaded_metadata_.tile_offsets_[idx])
     return Status::Ok();
 
-  Buffer buff;
+  if (version_ >= 6) {
+    bool all_loaded = false;
+    RETURN_NOT_OK(load_tile_page(
+        encryption_key,
+        gt_offsets_.tile_offsets_[idx],
+        tile_idx,
+        &tile_offsets_[idx],
+        &tile_offsets_pages_[idx],
+        &all_loaded));
+    loaded_metadata_.tile_offsets_[idx] = all_loaded;
+    return Status::Ok();
+  }
+
+  std::shared_ptr<const Buffer> buff;
   RETURN_NOT_OK(read_generic_tile_from_file(
       encryption_key, gt_offsets_.tile_offsets_[idx], &buff));
-  ConstBuffer cbuff(&buff);
+  ConstBuffer cbuff(buff->data(), buff->size());
   RETURN_NOT_OK(load_tile_offsets(idx, &cbuff));
 
   loaded_metadata_.tile_offsets_[idx] = true;
@@ -909,7 +1503,7 @@ Status FragmentMetadata::load_tile_offsets(
 }
 
 Status FragmentMetadata::load_tile_var_offsets(
-    const EncryptionKey& encryption_key, unsigned idx) {
+    const EncryptionKey& encryption_key, unsigned idx, uint64_t tile_idx) {
   if (version_ <= 2)
     return Status::Ok();
 
@@ -918,11 +1512,24 @@ Status FragmentMetadata::load_tile_var_offsets(
   if (loaded_metadata_.tile_var_offsets_[idx])
     return Status::Ok();
 
-  Buffer buff;
+  if (version_ >= 6) {
+    bool all_loaded = false;
+    RETURN_NOT_OK(load_tile_page(
+        encryption_key,
+        gt_offsets_.tile_var_offsets_[idx],
+        tile_idx,
+        &tile_var_offsets_[idx],
+        &tile_var_offsets_pages_[idx],
+        &all_loaded));
+    loaded_metadata_.tile_var_offsets_[idx] = all_loaded;
+    return Status::Ok();
+  }
+
+  std::shared_ptr<const Buffer> buff;
   RETURN_NOT_OK(read_generic_tile_from_file(
       encryption_key, gt_offsets_.tile_var_offsets_[idx], &buff));
 
-  ConstBuffer cbuff(&buff);
+  ConstBuffer cbuff(buff->data(), buff->size());
   RETURN_NOT_OK(load_tile_var_offsets(idx, &cbuff));
 
   loaded_metadata_.tile_var_offsets_[idx] = true;
@@ -931,7 +1538,7 @@ Status FragmentMetadata::load_tile_var_offsets(
 }
 
 Status FragmentMetadata::load_tile_var_sizes(
-    const EncryptionKey& encryption_key, unsigned idx) {
+    const EncryptionKey& encryption_key, unsigned idx, uint64_t tile_idx) {
   if (version_ <= 2)
     return Status::Ok();
 
@@ -940,11 +1547,24 @@ Status FragmentMetadata::load_tile_var_sizes(
   if (loaded_metadata_.tile_var_sizes_[idx])
     return Status::Ok();
 
-  Buffer buff;
+  if (version_ >= 6) {
+    bool all_loaded = false;
+    RETURN_NOT_OK(load_tile_page(
+        encryption_key,
+        gt_offsets_.tile_var_sizes_[idx],
+        tile_idx,
+        &tile_var_sizes_[idx],
+        &tile_var_sizes_pages_[idx],
+        &all_loaded));
+    loaded_metadata_.tile_var_sizes_[idx] = all_loaded;
+    return Status::Ok();
+  }
+
+  std::shared_ptr<const Buffer> buff;
   RETURN_NOT_OK(read_generic_tile_from_file(
       encryption_key, gt_offsets_.tile_var_sizes_[idx], &buff));
 
-  ConstBuffer cbuff(&buff);
+  ConstBuffer cbuff(buff->data(), buff->size());
   RETURN_NOT_OK(load_tile_var_sizes(idx, &cbuff));
 
   loaded_metadata_.tile_var_sizes_[idx] = true;
@@ -952,6 +1572,149 @@ Status FragmentMetadata::load_tile_var_sizes(
   return Status::Ok();
 }
 
+// ===== FORMAT =====
+// Page index:
+//   tile_num (uint64_t)
+//   page_num (uint64_t)
+//   page_offset_#1 (uint64_t) ... page_offset_#<page_num> (uint64_t)
+// Page #p:
+//   value_#1 (uint64_t) ... value_#<page_tile_num> (uint64_t)
+Status FragmentMetadata::load_tile_page(
+    const EncryptionKey& encryption_key,
+    uint64_t index_offset,
+    uint64_t tile_idx,
+    std::vector<uint64_t>* values,
+    TilePages* pages,
+    bool* all_loaded) {
+  // Load the page index
+  if (!pages->index_loaded_) {
+    std::shared_ptr<const Buffer> buff;
+    RETURN_NOT_OK(
+        read_generic_tile_from_file(encryption_key, index_offset, &buff));
+    ConstBuffer cbuff(buff->data(), buff->size());
+    uint64_t tile_num = 0, page_num = 0;
+    RETURN_NOT_OK(cbuff.read(&tile_num, sizeof(uint64_t)));
+    RETURN_NOT_OK(cbuff.read(&page_num, sizeof(uint64_t)));
+    pages->offsets_.resize(page_num);
+    if (page_num != 0) {
+      auto st = cbuff.read(&pages->offsets_[0], page_num * sizeof(uint64_t));
+      if (!st.ok()) {
+        return LOG_STATUS(Status::FragmentMetadataError(
+            "Cannot load fragment metadata; Reading page index failed"));
+      }
+    }
+    pages->loaded_.assign(page_num, false);
+    pages->loaded_num_ = 0;
+    values->resize(tile_num);
+    pages->index_loaded_ = true;
+  }
+
+  *all_loaded = (pages->loaded_num_ == pages->offsets_.size());
+  if (*all_loaded)
+    return Status::Ok();
+
+  auto page_tile_num = constants::tile_offsets_page_tile_num;
+  auto page = tile_idx / page_tile_num;
+  if (page >= pages->offsets_.size()) {
+    return LOG_STATUS(Status::FragmentMetadataError(
+        "Cannot load fragment metadata; Tile index out of bounds"));
+  }
+  if (pages->loaded_[page])
+    return Status::Ok();
+
+  // Load the page
+  std::shared_ptr<const Buffer> buff;
+  RETURN_NOT_OK(read_generic_tile_from_file(
+      encryption_key, pages->offsets_[page], &buff));
+  auto first = page * page_tile_num;
+  auto num = std::min(page_tile_num, (uint64_t)values->size() - first);
+  if (buff->size() != num * sizeof(uint64_t)) {
+    return LOG_STATUS(Status::FragmentMetadataError(
+        "Cannot load fragment metadata; Unexpected page size"));
+  }
+  std::memcpy(&(*values)[first], buff->data(), buff->size());
+
+  pages->loaded_[page] = true;
+  ++pages->loaded_num_;
+  *all_loaded = (pages->loaded_num_ == pages->offsets_.size());
+
+  return Status::Ok();
+}
+
+Status FragmentMetadata::load_tile_min_max_sum(
+    const EncryptionKey& encryption_key, unsigned idx) {
+  if (version_ < 5)
+    return Status::Ok();
+
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  if (loaded_metadata_.tile_min_max_sum_[idx])
+    return Status::Ok();
+
+  if (gt_offsets_.tile_min_max_sum_[idx] != UINT64_MAX) {
+    std::shared_ptr<const Buffer> buff;
+    RETURN_NOT_OK(read_generic_tile_from_file(
+        encryption_key, gt_offsets_.tile_min_max_sum_[idx], &buff));
+
+    ConstBuffer cbuff(buff->data(), buff->size());
+    RETURN_NOT_OK(load_tile_min_max_sum(idx, &cbuff));
+  }
+
+  loaded_metadata_.tile_min_max_sum_[idx] = true;
+
+  return Status::Ok();
+}
+
+Status FragmentMetadata::load_sketches(
+    const EncryptionKey& encryption_key, unsigned idx) {
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  if (loaded_metadata_.sketches_[idx])
+    return Status::Ok();
+
+  if (gt_offsets_.sketches_[idx] != UINT64_MAX) {
+    std::shared_ptr<const Buffer> buff;
+    RETURN_NOT_OK(read_generic_tile_from_file(
+        encryption_key, gt_offsets_.sketches_[idx], &buff));
+
+    ConstBuffer cbuff(buff->data(), buff->size());
+    std::unique_ptr<HyperLogLog> hll(new HyperLogLog());
+    std::unique_ptr<KllSketch> kll(new KllSketch());
+    RETURN_NOT_OK(hll->deserialize(&cbuff));
+    RETURN_NOT_OK(kll->deserialize(&cbuff));
+    hlls_[idx] = std::move(hll);
+    klls_[idx] = std::move(kll);
+  }
+
+  loaded_metadata_.sketches_[idx] = true;
+
+  return Status::Ok();
+}
+
+Status FragmentMetadata::load_value_index(
+    const EncryptionKey& encryption_key, unsigned idx) {
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  if (loaded_metadata_.value_indexes_[idx])
+    return Status::Ok();
+
+  if (gt_offsets_.value_indexes_[idx] != UINT64_MAX) {
+    std::shared_ptr<const Buffer> buff;
+    RETURN_NOT_OK(read_generic_tile_from_file(
+        encryption_key, gt_offsets_.value_indexes_[idx], &buff));
+
+    ConstBuffer cbuff(buff->data(), buff->size());
+    std::unique_ptr<ValueIndex> index(
+        new ValueIndex(array_schema_->attribute(idx)->type()));
+    RETURN_NOT_OK(index->deserialize(&cbuff));
+    value_indexes_[idx] = std::move(index);
+  }
+
+  loaded_metadata_.value_indexes_[idx] = true;
+
+  return Status::Ok();
+}
+
 // ===== FORMAT =====
 //  bounding_coords_num (uint64_t)
 //  bounding_coords_#1 (void*) bounding_coords_#2 (void*) ...
@@ -967,18 +1730,12 @@ Status FragmentMetadata::load_bounding_coords(ConstBuffer* buff) {
         "bounding coordinates failed"));
   }
   // Get bounding coordinates
-  void* bounding_coords;
-  bounding_coords_.resize(bounding_coords_num, nullptr);
-  for (uint64_t i = 0; i < bounding_coords_num; ++i) {
-    bounding_coords = std::malloc(bounding_coords_size);
-    st = buff->read(bounding_coords, bounding_coords_size);
-    if (!st.ok()) {
-      std::free(bounding_coords);
-      return LOG_STATUS(
-          Status::FragmentMetadataError("Cannot load fragment metadata; "
-                                        "Reading bounding coordinates failed"));
-    }
-    bounding_coords_[i] = bounding_coords;
+  bounding_coords_.resize(bounding_coords_num * bounding_coords_size);
+  st = buff->read(bounding_coords_.data(), bounding_coords_.size());
+  if (!st.ok()) {
+    return LOG_STATUS(
+        Status::FragmentMetadataError("Cannot load fragment metadata; "
+                                      "Reading bounding coordinates failed"));
   }
   return Status::Ok();
 }
@@ -1095,20 +1852,14 @@ Status FragmentMetadata::load_mbrs(ConstBuffer* buff) {
 
   // Get MBRs
   uint64_t mbr_size = 2 * array_schema_->coords_size();
-  void* mbr = nullptr;
-  mbrs_.resize(mbr_num);
-  for (uint64_t i = 0; i < mbr_num; ++i) {
-    mbr = std::malloc(mbr_size);
-    st = buff->read(mbr, mbr_size);
-    if (!st.ok()) {
-      std::free(mbr);
-      return LOG_STATUS(Status::FragmentMetadataError(
-          "Cannot load fragment metadata; Reading MBR failed"));
-    }
-    mbrs_[i] = mbr;
+  mbrs_.resize(mbr_num * mbr_size);
+  st = buff->read(mbrs_.data(), mbrs_.size());
+  if (!st.ok()) {
+    return LOG_STATUS(Status::FragmentMetadataError(
+        "Cannot load fragment metadata; Reading MBRs failed"));
   }
 
-  sparse_tile_num_ = mbrs_.size();
+  sparse_tile_num_ = mbr_num;
 
   return Status::Ok();
 }
@@ -1404,6 +2155,41 @@ Status FragmentMetadata::load_tile_var_sizes(unsigned idx, ConstBuffer* buff) {
   return Status::Ok();
 }
 
+// ===== FORMAT =====
+// tile_num (uint64_t)
+// tile_min_#1 (attribute type) ... tile_min_#<tile_num>
+// tile_max_#1 (attribute type) ... tile_max_#<tile_num>
+// tile_sum_#1 (8 bytes) ... tile_sum_#<tile_num>
+Status FragmentMetadata::load_tile_min_max_sum(
+    unsigned idx, ConstBuffer* buff) {
+  uint64_t tile_num = 0;
+  auto st = buff->read(&tile_num, sizeof(uint64_t));
+  if (!st.ok()) {
+    return LOG_STATUS(Status::FragmentMetadataError(
+        "Cannot load fragment metadata; Reading number of tile min/max/sum "
+        "values failed"));
+  }
+
+  auto cell_size = array_schema_->attributes()[idx]->cell_size();
+  tile_min_[idx].resize(tile_num * cell_size);
+  tile_max_[idx].resize(tile_num * cell_size);
+  tile_sum_[idx].resize(tile_num * sizeof(uint64_t));
+  if (tile_num != 0) {
+    st = buff->read(&tile_min_[idx][0], tile_min_[idx].size());
+    if (st.ok())
+      st = buff->read(&tile_max_[idx][0], tile_max_[idx].size());
+    if (st.ok())
+      st = buff->read(&tile_sum_[idx][0], tile_sum_[idx].size());
+    if (!st.ok()) {
+      return LOG_STATUS(Status::FragmentMetadataError(
+          "Cannot load fragment metadata; Reading tile min/max/sum values "
+          "failed"));
+    }
+  }
+
+  return Status::Ok();
+}
+
 Status FragmentMetadata::load_version(ConstBuffer* buff) {
   RETURN_NOT_OK(buff->read(&version_, sizeof(uint32_t)));
   return Status::Ok();
@@ -1419,11 +2205,90 @@ Status FragmentMetadata::load_sparse_tile_num(ConstBuffer* buff) {
   return Status::Ok();
 }
 
+Status FragmentMetadata::load_sketch_offsets(ConstBuffer* buff) {
+  auto attribute_num = array_schema_->attribute_num();
+  gt_offsets_.sketches_.resize(attribute_num);
+  for (unsigned i = 0; i < attribute_num; ++i)
+    RETURN_NOT_OK(buff->read(&gt_offsets_.sketches_[i], sizeof(uint64_t)));
+
+  return Status::Ok();
+}
+
+Status FragmentMetadata::load_value_index_offsets(ConstBuffer* buff) {
+  auto attribute_num = array_schema_->attribute_num();
+  gt_offsets_.value_indexes_.resize(attribute_num);
+  for (unsigned i = 0; i < attribute_num; ++i) {
+    RETURN_NOT_OK(
+        buff->read(&gt_offsets_.value_indexes_[i], sizeof(uint64_t)));
+  }
+
+  return Status::Ok();
+}
+
+Status FragmentMetadata::load_packed(ConstBuffer* buff) {
+  char packed = 0;
+  RETURN_NOT_OK(buff->read(&packed, sizeof(char)));
+  packed_ = packed != 0;
+  return Status::Ok();
+}
+
+Status FragmentMetadata::colocated_file_offset(
+    const EncryptionKey& encryption_key,
+    unsigned idx,
+    bool var,
+    uint64_t tile_idx,
+    uint64_t* offset) {
+  // The tile follows all the tiles with a smaller index, and the tiles with
+  // the same index of the files with a smaller identifier. The size of the
+  // first `n` tiles of a file is the offset of tile `n` in that file.
+  auto tile_num = this->tile_num();
+  auto id = 2 * (uint64_t)idx + (var ? 1 : 0);
+  *offset = 0;
+  for (unsigned i = 0; i < (unsigned)file_sizes_.size(); ++i) {
+    for (unsigned v = 0; v < 2; ++v) {
+      auto file_size = v ? file_var_sizes_[i] : file_sizes_[i];
+      if (file_size == 0)
+        continue;
+
+      auto end_idx = (2 * (uint64_t)i + v < id) ? tile_idx + 1 : tile_idx;
+      if (end_idx == tile_num) {
+        *offset += file_size;
+      } else if (v) {
+        RETURN_NOT_OK(load_tile_var_offsets(encryption_key, i, end_idx));
+        *offset += tile_var_offsets_[i][end_idx];
+      } else {
+        RETURN_NOT_OK(load_tile_offsets(encryption_key, i, end_idx));
+        *offset += tile_offsets_[i][end_idx];
+      }
+    }
+  }
+
+  return Status::Ok();
+}
+
+void FragmentMetadata::compute_packed_offsets(
+    const std::vector<uint64_t>& file_sizes,
+    const std::vector<uint64_t>& file_var_sizes) {
+  auto num = file_sizes.size();
+  packed_offsets_.resize(2 * num);
+  uint64_t offset = 0;
+  for (size_t i = 0; i < num; ++i) {
+    packed_offsets_[2 * i] = offset;
+    offset += file_sizes[i];
+    packed_offsets_[2 * i + 1] = offset;
+    offset += file_var_sizes[i];
+  }
+}
+
 Status FragmentMetadata::create_rtree() {
   auto dim_num = array_schema_->dim_num();
   auto type = array_schema_->domain()->type();
-  auto rtree = RTree(type, dim_num, constants::rtree_fanout, mbrs_);
-  rtree_ = std::move(rtree);
+  auto mbr_size = 2 * array_schema_->coords_size();
+  std::vector<void*> mbrs(mbrs_.size() / mbr_size);
+  for (uint64_t i = 0; i < mbrs.size(); ++i)
+    mbrs[i] = &mbrs_[i * mbr_size];
+  rtree_ = std::make_shared<RTree>(
+      type, dim_num, constants::rtree_fanout, mbrs, rtree_str_packing_);
   return Status::Ok();
 }
 
@@ -1491,6 +2356,18 @@ Status FragmentMetadata::load_generic_tile_offsets_v5_or_higher(
         buff->read(&gt_offsets_.tile_var_sizes_[i], sizeof(uint64_t)));
   }
 
+  // Load offsets for tile min/max/sum values
+  auto attribute_num = array_schema_->attribute_num();
+  gt_offsets_.tile_min_max_sum_.resize(attribute_num);
+  for (unsigned i = 0; i < attribute_num; ++i) {
+    RETURN_NOT_OK(
+        buff->read(&gt_offsets_.tile_min_max_sum_[i], sizeof(uint64_t)));
+  }
+
+  // Load coordinate bloom filter offset
+  RETURN_NOT_OK(
+      buff->read(&gt_offsets_.coords_bloom_filter_, sizeof(uint64_t)));
+
   return Status::Ok();
 }
 
@@ -1498,16 +2375,11 @@ Status FragmentMetadata::load_v1_v2(const EncryptionKey& encryption_key) {
   URI fragment_metadata_uri = fragment_uri_.join_path(
       std::string(constants::fragment_metadata_filename));
   // Read metadata
-  TileIO tile_io(storage_manager_, fragment_metadata_uri);
-  auto tile = (Tile*)nullptr;
-  RETURN_NOT_OK(tile_io.read_generic(&tile, 0, encryption_key));
-  tile->disown_buff();
-  auto buff = tile->buffer();
-  STATS_COUNTER_ADD(fragment_metadata_bytes_read, tile_io.file_size());
-  delete tile;
+  std::shared_ptr<const Buffer> buff;
+  RETURN_NOT_OK(read_generic_tile_from_file(encryption_key, 0, &buff));
 
   // Deserialize
-  ConstBuffer cbuff(buff);
+  ConstBuffer cbuff(buff->data(), buff->size());
   RETURN_NOT_OK(load_version(&cbuff));
   RETURN_NOT_OK(load_non_empty_domain(&cbuff));
   RETURN_NOT_OK(load_mbrs(&cbuff));
@@ -1520,36 +2392,114 @@ Status FragmentMetadata::load_v1_v2(const EncryptionKey& encryption_key) {
   RETURN_NOT_OK(load_file_var_sizes(&cbuff));
   RETURN_NOT_OK(create_rtree());
 
-  delete buff;
-
   return Status::Ok();
 }
 
 Status FragmentMetadata::load_v3_or_higher(
-    const EncryptionKey& encryption_key) {
+    const EncryptionKey& encryption_key, uint64_t speculative_read_size) {
+  // The R-Tree is at the start of the file and the footer at its end, so a
+  // small file is cheaper to fetch whole than with a request per section
+  if (speculative_read_size > 0 && meta_file_size_ <= speculative_read_size)
+    return load_whole_file(encryption_key);
+
   RETURN_NOT_OK(load_footer(encryption_key));
   return Status::Ok();
 }
 
-Status FragmentMetadata::load_footer(const EncryptionKey& encryption_key) {
-  (void)encryption_key;  // Not used for now, perhaps in the future
+Status FragmentMetadata::load_whole_file(const EncryptionKey& encryption_key) {
+  std::lock_guard<std::mutex> lock(mtx_);
+
+  if (loaded_metadata_.footer_)
+    return Status::Ok();
 
+  URI fragment_metadata_uri = fragment_uri_.join_path(
+      std::string(constants::fragment_metadata_filename));
+  uint64_t footer_offset = 0, footer_size = 0;
+  RETURN_NOT_OK(get_footer_offset_and_size(&footer_offset, &footer_size));
+  if (footer_offset + footer_size > meta_file_size_)
+    return LOG_STATUS(Status::FragmentMetadataError(
+        "Cannot load fragment metadata; Footer exceeds the file size"));
+
+  // A cached footer needs no request; the R-Tree is then loaded on demand
+  auto cache = metadata_cache(encryption_key);
+  if (cache != nullptr) {
+    auto footer_buff = cache->get(fragment_metadata_uri, footer_offset);
+    if (footer_buff != nullptr) {
+      ConstBuffer cbuff(footer_buff->data(), footer_buff->size());
+      return load_footer(&cbuff);
+    }
+  }
+
+  Buffer file_buff;
+  RETURN_NOT_OK(storage_manager_->read(
+      fragment_metadata_uri, 0, &file_buff, meta_file_size_));
+
+  // Footer
+  auto footer_buff = std::make_shared<Buffer>();
+  RETURN_NOT_OK(
+      footer_buff->write(file_buff.data(footer_offset), footer_size));
+  if (cache != nullptr)
+    cache->insert(fragment_metadata_uri, footer_offset, footer_buff);
+  ConstBuffer footer_cbuff(footer_buff->data(), footer_buff->size());
+  RETURN_NOT_OK(load_footer(&footer_cbuff));
+
+  // R-Tree, unless another handle has already deserialized it
+  auto index_cache = storage_manager_->index_cache();
+  if (index_cache != nullptr) {
+    rtree_ = index_cache->get_rtree(fragment_uri_);
+    if (rtree_ != nullptr) {
+      loaded_metadata_.rtree_ = true;
+      return Status::Ok();
+    }
+  }
+
+  TileIO tile_io(storage_manager_, fragment_metadata_uri);
+  auto tile = (Tile*)nullptr;
+  RETURN_NOT_OK(tile_io.read_generic(
+      &tile, gt_offsets_.rtree_, encryption_key, file_buff, 0));
+  auto rtree_buff = std::make_shared<Buffer>();
+  tile->buffer()->swap(*rtree_buff);
+  delete tile;
+  STATS_COUNTER_ADD(fragment_metadata_bytes_read, meta_file_size_);
+  if (cache != nullptr)
+    cache->insert(fragment_metadata_uri, gt_offsets_.rtree_, rtree_buff);
+
+  ConstBuffer rtree_cbuff(rtree_buff->data(), rtree_buff->size());
+  auto rtree = std::make_shared<RTree>();
+  RETURN_NOT_OK(rtree->deserialize(&rtree_cbuff));
+
+  if (index_cache != nullptr)
+    index_cache->insert_rtree(fragment_uri_, rtree);
+  rtree_ = rtree;
+  loaded_metadata_.rtree_ = true;
+
+  return Status::Ok();
+}
+
+Status FragmentMetadata::load_footer(const EncryptionKey& encryption_key) {
   std::lock_guard<std::mutex> lock(mtx_);
 
   if (loaded_metadata_.footer_)
     return Status::Ok();
 
-  Buffer buff;
-  RETURN_NOT_OK(read_file_footer(&buff));
+  std::shared_ptr<const Buffer> buff;
+  RETURN_NOT_OK(read_file_footer(encryption_key, &buff));
 
-  ConstBuffer cbuff(&buff);
-  RETURN_NOT_OK(load_version(&cbuff));
-  RETURN_NOT_OK(load_dense(&cbuff));
-  RETURN_NOT_OK(load_non_empty_domain(&cbuff));
-  RETURN_NOT_OK(load_sparse_tile_num(&cbuff));
-  RETURN_NOT_OK(load_last_tile_cell_num(&cbuff));
-  RETURN_NOT_OK(load_file_sizes(&cbuff));
-  RETURN_NOT_OK(load_file_var_sizes(&cbuff));
+  ConstBuffer cbuff(buff->data(), buff->size());
+  return load_footer(&cbuff);
+}
+
+Status FragmentMetadata::load_footer(ConstBuffer* buff) {
+  if (loaded_metadata_.footer_)
+    return Status::Ok();
+
+  RETURN_NOT_OK(load_version(buff));
+  RETURN_NOT_OK(load_dense(buff));
+  RETURN_NOT_OK(load_non_empty_domain(buff));
+  RETURN_NOT_OK(load_sparse_tile_num(buff));
+  RETURN_NOT_OK(load_last_tile_cell_num(buff));
+  RETURN_NOT_OK(load_file_sizes(buff));
+  RETURN_NOT_OK(load_file_var_sizes(buff));
 
   unsigned num = array_schema_->attribute_num() + 1;
   num += (version_ >= 5) ? array_schema_->dim_num() : 0;
@@ -1562,7 +2512,40 @@ Status FragmentMetadata::load_footer(const EncryptionKey& encryption_key) {
   loaded_metadata_.tile_var_offsets_.resize(num, false);
   loaded_metadata_.tile_var_sizes_.resize(num, false);
 
-  RETURN_NOT_OK(load_generic_tile_offsets(&cbuff));
+  tile_offsets_pages_.resize(num);
+  tile_var_offsets_pages_.resize(num);
+  tile_var_sizes_pages_.resize(num);
+
+  auto attribute_num = array_schema_->attribute_num();
+  tile_min_.resize(attribute_num);
+  tile_max_.resize(attribute_num);
+  tile_sum_.resize(attribute_num);
+  loaded_metadata_.tile_min_max_sum_.resize(attribute_num, false);
+  hlls_.resize(attribute_num);
+  klls_.resize(attribute_num);
+  loaded_metadata_.sketches_.resize(attribute_num, false);
+  value_indexes_.resize(attribute_num);
+  loaded_metadata_.value_indexes_.resize(attribute_num, false);
+
+  RETURN_NOT_OK(load_generic_tile_offsets(buff));
+
+  // The attribute files of packed fragments follow each other in one file
+  if (version_ >= 7)
+    RETURN_NOT_OK(load_packed(buff));
+  if (packed_)
+    compute_packed_offsets(file_sizes_, file_var_sizes_);
+
+  // Sketches are stored from version 8
+  if (version_ >= 8)
+    RETURN_NOT_OK(load_sketch_offsets(buff));
+  else
+    gt_offsets_.sketches_.assign(attribute_num, UINT64_MAX);
+
+  // Value indexes are stored from version 9
+  if (version_ >= 9)
+    RETURN_NOT_OK(load_value_index_offsets(buff));
+  else
+    gt_offsets_.value_indexes_.assign(attribute_num, UINT64_MAX);
 
   loaded_metadata_.footer_ = true;
 
@@ -1610,6 +2593,10 @@ Status FragmentMetadata::write_file_var_sizes(Buffer* buff) {
 // tile_var_sizes_0(uint64_t)
 // ...
 // tile_var_sizes_{attr_num+dim_num}(uint64_t)
+// tile_min_max_sum_0(uint64_t)
+// ...
+// tile_min_max_sum_{attr_num-1}(uint64_t)
+// coords_bloom_filter_offset(uint64_t)
 Status FragmentMetadata::write_generic_tile_offsets(Buffer* buff) {
   auto num = array_schema_->attribute_num() + array_schema_->dim_num() + 1;
 
@@ -1648,6 +2635,25 @@ Status FragmentMetadata::write_generic_tile_offsets(Buffer* buff) {
     }
   }
 
+  // Write tile min/max/sum values
+  auto attribute_num = array_schema_->attribute_num();
+  for (unsigned i = 0; i < attribute_num; ++i) {
+    st = buff->write(&gt_offsets_.tile_min_max_sum_[i], sizeof(uint64_t));
+    if (!st.ok()) {
+      return LOG_STATUS(Status::FragmentMetadataError(
+          "Cannot serialize fragment metadata; Writing tile min/max/sum "
+          "offsets failed"));
+    }
+  }
+
+  // Write coordinate bloom filter offset
+  st = buff->write(&gt_offsets_.coords_bloom_filter_, sizeof(uint64_t));
+  if (!st.ok()) {
+    return LOG_STATUS(Status::FragmentMetadataError(
+        "Cannot serialize fragment metadata; Writing coordinate bloom filter "
+        "offset failed"));
+  }
+
   return Status::Ok();
 }
 
@@ -1671,6 +2677,19 @@ Status FragmentMetadata::write_last_tile_cell_num(Buffer* buff) {
   return Status::Ok();
 }
 
+Status FragmentMetadata::store_coords_bloom_filter(
+    const EncryptionKey& encryption_key, uint64_t* nbytes) {
+  BloomFilter filter(coords_hashes_.size(), coords_bloom_filter_bits_);
+  for (auto hash : coords_hashes_)
+    filter.add(hash);
+  coords_hashes_.clear();
+
+  Buffer buff;
+  RETURN_NOT_OK(filter.serialize(&buff));
+  RETURN_NOT_OK(write_generic_tile_to_file(encryption_key, &buff, nbytes));
+  return Status::Ok();
+}
+
 Status FragmentMetadata::store_rtree(
     const EncryptionKey& encryption_key, uint64_t* nbytes) {
   Buffer buff;
@@ -1681,7 +2700,7 @@ Status FragmentMetadata::store_rtree(
 
 Status FragmentMetadata::write_rtree(Buffer* buff) {
   RETURN_NOT_OK(create_rtree());
-  RETURN_NOT_OK(rtree_.serialize(buff));
+  RETURN_NOT_OK(rtree_->serialize(buff));
   return Status::Ok();
 }
 
@@ -1720,21 +2739,52 @@ Status FragmentMetadata::write_non_empty_domain(Buffer* buff) {
 }
 
 Status FragmentMetadata::read_generic_tile_from_file(
-    const EncryptionKey& encryption_key, uint64_t offset, Buffer* buff) const {
+    const EncryptionKey& encryption_key,
+    uint64_t offset,
+    std::shared_ptr<const Buffer>* buff) const {
   URI fragment_metadata_uri = fragment_uri_.join_path(
       std::string(constants::fragment_metadata_filename));
 
+  // Check the fragment metadata cache
+  auto cache = metadata_cache(encryption_key);
+  if (cache != nullptr) {
+    *buff = cache->get(fragment_metadata_uri, offset);
+    if (*buff != nullptr)
+      return Status::Ok();
+  }
+
   // Read metadata
   TileIO tile_io(storage_manager_, fragment_metadata_uri);
   auto tile = (Tile*)nullptr;
   RETURN_NOT_OK(tile_io.read_generic(&tile, offset, encryption_key));
-  tile->buffer()->swap(*buff);
+  std::shared_ptr<Buffer> tile_buff;
+  const auto& region = tile->mapped_region();
+  auto data = (const char*)tile->buffer()->data();
+  if (region != nullptr && data >= (const char*)region->data() &&
+      data < (const char*)region->data() + region->size()) {
+    // The tile is used in place from the mapped file, which must stay
+    // mapped for as long as the buffer is referenced
+    auto mapped = std::make_shared<MappedBuffer>();
+    mapped->region_ = region;
+    tile->buffer()->swap(mapped->buffer_);
+    tile_buff = std::shared_ptr<Buffer>(mapped, &mapped->buffer_);
+  } else {
+    tile_buff = std::make_shared<Buffer>();
+    tile->buffer()->swap(*tile_buff);
+  }
+  STATS_COUNTER_ADD(fragment_metadata_bytes_read, tile_io.file_size());
   delete tile;
 
+  if (cache != nullptr)
+    cache->insert(fragment_metadata_uri, offset, tile_buff);
+  *buff = tile_buff;
+
   return Status::Ok();
 }
 
-Status FragmentMetadata::read_file_footer(Buffer* buff) const {
+Status FragmentMetadata::read_file_footer(
+    const EncryptionKey& encryption_key,
+    std::shared_ptr<const Buffer>* buff) const {
   URI fragment_metadata_uri = fragment_uri_.join_path(
       std::string(constants::fragment_metadata_filename));
 
@@ -1742,9 +2792,33 @@ Status FragmentMetadata::read_file_footer(Buffer* buff) const {
   uint64_t footer_offset = 0, footer_size = 0;
   RETURN_NOT_OK(get_footer_offset_and_size(&footer_offset, &footer_size));
 
+  // Check the fragment metadata cache
+  auto cache = metadata_cache(encryption_key);
+  if (cache != nullptr) {
+    *buff = cache->get(fragment_metadata_uri, footer_offset);
+    if (*buff != nullptr)
+      return Status::Ok();
+  }
+
   // Read footer
-  return storage_manager_->read(
-      fragment_metadata_uri, footer_offset, buff, footer_size);
+  auto footer_buff = std::make_shared<Buffer>();
+  RETURN_NOT_OK(storage_manager_->read(
+      fragment_metadata_uri, footer_offset, footer_buff.get(), footer_size));
+
+  if (cache != nullptr)
+    cache->insert(fragment_metadata_uri, footer_offset, footer_buff);
+  *buff = footer_buff;
+
+  return Status::Ok();
+}
+
+FragmentMetadataCache* FragmentMetadata::metadata_cache(
+    const EncryptionKey& encryption_key) const {
+  if (encryption_key.encryption_type() != EncryptionType::NO_ENCRYPTION)
+    return nullptr;
+  auto cache =
+      global_state::GlobalState::GetGlobalState().fragment_metadata_cache();
+  return (cache->max_size() == 0) ? nullptr : cache;
 }
 
 Status FragmentMetadata::write_generic_tile_to_file(
@@ -1759,7 +2833,8 @@ Status FragmentMetadata::write_generic_tile_to_file(
       buff,
       false);
   TileIO tile_io(storage_manager_, fragment_metadata_uri);
-  RETURN_NOT_OK(tile_io.write_generic(&tile, encryption_key, nbytes));
+  RETURN_NOT_OK(
+      tile_io.write_generic(&tile, encryption_key, nbytes, unfiltered_));
 
   return Status::Ok();
 }
@@ -1773,106 +2848,154 @@ Status FragmentMetadata::write_file_footer(Buffer* buff) const {
 }
 
 Status FragmentMetadata::store_tile_offsets(
-    unsigned idx, const EncryptionKey& encryption_key, uint64_t* nbytes) {
-  Buffer buff;
-  RETURN_NOT_OK(write_tile_offsets(idx, &buff));
-  RETURN_NOT_OK(write_generic_tile_to_file(encryption_key, &buff, nbytes));
-
-  return Status::Ok();
+    unsigned idx,
+    const EncryptionKey& encryption_key,
+    uint64_t offset,
+    uint64_t* nbytes) {
+  return store_tile_pages(
+      encryption_key,
+      tile_offsets_[idx],
+      offset,
+      &gt_offsets_.tile_offsets_[idx],
+      nbytes);
 }
 
-Status FragmentMetadata::write_tile_offsets(unsigned idx, Buffer* buff) {
-  Status st;
+Status FragmentMetadata::store_tile_var_offsets(
+    unsigned idx,
+    const EncryptionKey& encryption_key,
+    uint64_t offset,
+    uint64_t* nbytes) {
+  return store_tile_pages(
+      encryption_key,
+      tile_var_offsets_[idx],
+      offset,
+      &gt_offsets_.tile_var_offsets_[idx],
+      nbytes);
+}
 
-  // Write number of tile offsets
-  uint64_t tile_offsets_num = tile_offsets_[idx].size();
-  st = buff->write(&tile_offsets_num, sizeof(uint64_t));
-  if (!st.ok()) {
-    return LOG_STATUS(Status::FragmentMetadataError(
-        "Cannot serialize fragment metadata; Writing number of tile offsets "
-        "failed"));
-  }
+Status FragmentMetadata::store_tile_var_sizes(
+    unsigned idx,
+    const EncryptionKey& encryption_key,
+    uint64_t offset,
+    uint64_t* nbytes) {
+  return store_tile_pages(
+      encryption_key,
+      tile_var_sizes_[idx],
+      offset,
+      &gt_offsets_.tile_var_sizes_[idx],
+      nbytes);
+}
 
-  // Write tile offsets
-  if (tile_offsets_num != 0) {
-    st = buff->write(
-        &tile_offsets_[idx][0], tile_offsets_num * sizeof(uint64_t));
+// ===== FORMAT =====
+// See `load_tile_page`. The pages are written first, each as a separate
+// generic tile, followed by the page index.
+Status FragmentMetadata::store_tile_pages(
+    const EncryptionKey& encryption_key,
+    const std::vector<uint64_t>& values,
+    uint64_t offset,
+    uint64_t* index_offset,
+    uint64_t* nbytes) {
+  auto page_tile_num = constants::tile_offsets_page_tile_num;
+  uint64_t tile_num = values.size();
+  uint64_t page_num = (tile_num + page_tile_num - 1) / page_tile_num;
+  std::vector<uint64_t> page_offsets(page_num);
+  uint64_t page_nbytes = 0;
+  *nbytes = 0;
+
+  // Write pages
+  for (uint64_t p = 0; p < page_num; ++p) {
+    auto first = p * page_tile_num;
+    auto num = std::min(page_tile_num, tile_num - first);
+    Buffer buff;
+    auto st = buff.write(&values[first], num * sizeof(uint64_t));
     if (!st.ok()) {
       return LOG_STATUS(Status::FragmentMetadataError(
-          "Cannot serialize fragment metadata; Writing tile offsets failed"));
+          "Cannot serialize fragment metadata; Writing tile page failed"));
     }
+    page_offsets[p] = offset + *nbytes;
+    RETURN_NOT_OK(
+        write_generic_tile_to_file(encryption_key, &buff, &page_nbytes));
+    *nbytes += page_nbytes;
   }
 
+  // Write page index
+  Buffer buff;
+  auto st = buff.write(&tile_num, sizeof(uint64_t));
+  if (st.ok())
+    st = buff.write(&page_num, sizeof(uint64_t));
+  if (st.ok() && page_num != 0)
+    st = buff.write(&page_offsets[0], page_num * sizeof(uint64_t));
+  if (!st.ok()) {
+    return LOG_STATUS(Status::FragmentMetadataError(
+        "Cannot serialize fragment metadata; Writing page index failed"));
+  }
+  *index_offset = offset + *nbytes;
+  RETURN_NOT_OK(
+      write_generic_tile_to_file(encryption_key, &buff, &page_nbytes));
+  *nbytes += page_nbytes;
+
   return Status::Ok();
 }
 
-Status FragmentMetadata::store_tile_var_offsets(
+// ===== FORMAT =====
+// hll (HyperLogLog)
+// kll (KllSketch)
+Status FragmentMetadata::store_sketches(
     unsigned idx, const EncryptionKey& encryption_key, uint64_t* nbytes) {
   Buffer buff;
-  RETURN_NOT_OK(write_tile_var_offsets(idx, &buff));
+  RETURN_NOT_OK(hlls_[idx]->serialize(&buff));
+  RETURN_NOT_OK(klls_[idx]->serialize(&buff));
   RETURN_NOT_OK(write_generic_tile_to_file(encryption_key, &buff, nbytes));
 
   return Status::Ok();
 }
 
-Status FragmentMetadata::write_tile_var_offsets(unsigned idx, Buffer* buff) {
-  Status st;
-
-  // Write tile offsets for each attribute
-  // Write number of offsets
-  uint64_t tile_var_offsets_num = tile_var_offsets_[idx].size();
-  st = buff->write(&tile_var_offsets_num, sizeof(uint64_t));
-  if (!st.ok()) {
-    return LOG_STATUS(Status::FragmentMetadataError(
-        "Cannot serialize fragment metadata; Writing number of "
-        "variable tile offsets failed"));
-  }
-
-  // Write tile offsets
-  if (tile_var_offsets_num != 0) {
-    st = buff->write(
-        &tile_var_offsets_[idx][0], tile_var_offsets_num * sizeof(uint64_t));
-    if (!st.ok()) {
-      return LOG_STATUS(Status::FragmentMetadataError(
-          "Cannot serialize fragment metadata; Writing "
-          "variable tile offsets failed"));
-    }
-  }
+Status FragmentMetadata::store_value_index(
+    unsigned idx, const EncryptionKey& encryption_key, uint64_t* nbytes) {
+  Buffer buff;
+  value_indexes_[idx]->sort();
+  RETURN_NOT_OK(value_indexes_[idx]->serialize(&buff));
+  RETURN_NOT_OK(write_generic_tile_to_file(encryption_key, &buff, nbytes));
 
   return Status::Ok();
 }
 
-Status FragmentMetadata::store_tile_var_sizes(
+Status FragmentMetadata::store_tile_min_max_sum(
     unsigned idx, const EncryptionKey& encryption_key, uint64_t* nbytes) {
   Buffer buff;
-  RETURN_NOT_OK(write_tile_var_sizes(idx, &buff));
+  RETURN_NOT_OK(write_tile_min_max_sum(idx, &buff));
   RETURN_NOT_OK(write_generic_tile_to_file(encryption_key, &buff, nbytes));
 
   return Status::Ok();
 }
 
-Status FragmentMetadata::write_tile_var_sizes(unsigned idx, Buffer* buff) {
+Status FragmentMetadata::write_tile_min_max_sum(unsigned idx, Buffer* buff) {
   Status st;
 
-  // Write number of sizes
-  uint64_t tile_var_sizes_num = tile_var_sizes_[idx].size();
-  st = buff->write(&tile_var_sizes_num, sizeof(uint64_t));
+  // Write number of tiles
+  auto cell_size = array_schema_->attributes()[idx]->cell_size();
+  uint64_t tile_num = tile_min_[idx].size() / cell_size;
+  st = buff->write(&tile_num, sizeof(uint64_t));
   if (!st.ok()) {
     return LOG_STATUS(Status::FragmentMetadataError(
-        "Cannot serialize fragment metadata; Writing number of "
-        "variable tile sizes failed"));
+        "Cannot serialize fragment metadata; Writing number of tile "
+        "min/max/sum values failed"));
   }
 
-  // Write tile sizes
-  if (tile_var_sizes_num != 0) {
-    st = buff->write(
-        &tile_var_sizes_[idx][0], tile_var_sizes_num * sizeof(uint64_t));
+  // Write minimum, maximum and sum values
+  if (tile_num != 0) {
+    st = buff->write(&tile_min_[idx][0], tile_min_[idx].size());
+    if (st.ok())
+      st = buff->write(&tile_max_[idx][0], tile_max_[idx].size());
+    if (st.ok())
+      st = buff->write(&tile_sum_[idx][0], tile_sum_[idx].size());
     if (!st.ok()) {
-      return LOG_STATUS(
-          Status::FragmentMetadataError("Cannot serialize fragment metadata; "
-                                        "Writing variable tile sizes failed"));
+      return LOG_STATUS(Status::FragmentMetadataError(
+          "Cannot serialize fragment metadata; Writing tile min/max/sum "
+          "values failed"));
     }
   }
+
   return Status::Ok();
 }
 
@@ -1891,6 +3014,48 @@ Status FragmentMetadata::write_sparse_tile_num(Buffer* buff) {
   return Status::Ok();
 }
 
+Status FragmentMetadata::write_packed(Buffer* buff) {
+  char packed = packed_ ? 1 : 0;
+  RETURN_NOT_OK(buff->write(&packed, sizeof(char)));
+  return Status::Ok();
+}
+
+// ===== FORMAT =====
+// sketches_offset_0(uint64_t)
+// ...
+// sketches_offset_{attr_num-1}(uint64_t)
+Status FragmentMetadata::write_sketch_offsets(Buffer* buff) {
+  auto attribute_num = array_schema_->attribute_num();
+  for (unsigned i = 0; i < attribute_num; ++i) {
+    auto st = buff->write(&gt_offsets_.sketches_[i], sizeof(uint64_t));
+    if (!st.ok()) {
+      return LOG_STATUS(Status::FragmentMetadataError(
+          "Cannot serialize fragment metadata; Writing sketch offsets "
+          "failed"));
+    }
+  }
+
+  return Status::Ok();
+}
+
+// ===== FORMAT =====
+// value_index_offset_0(uint64_t)
+// ...
+// value_index_offset_{attr_num-1}(uint64_t)
+Status FragmentMetadata::write_value_index_offsets(Buffer* buff) {
+  auto attribute_num = array_schema_->attribute_num();
+  for (unsigned i = 0; i < attribute_num; ++i) {
+    auto st = buff->write(&gt_offsets_.value_indexes_[i], sizeof(uint64_t));
+    if (!st.ok()) {
+      return LOG_STATUS(Status::FragmentMetadataError(
+          "Cannot serialize fragment metadata; Writing value index offsets "
+          "failed"));
+    }
+  }
+
+  return Status::Ok();
+}
+
 Status FragmentMetadata::store_footer(const EncryptionKey& encryption_key) {
   (void)encryption_key;  // Not used for now, maybe in the future
 
@@ -1903,6 +3068,9 @@ Status FragmentMetadata::store_footer(const EncryptionKey& encryption_key) {
   RETURN_NOT_OK(write_file_sizes(&buff));
   RETURN_NOT_OK(write_file_var_sizes(&buff));
   RETURN_NOT_OK(write_generic_tile_offsets(&buff));
+  RETURN_NOT_OK(write_packed(&buff));
+  RETURN_NOT_OK(write_sketch_offsets(&buff));
+  RETURN_NOT_OK(write_value_index_offsets(&buff));
   RETURN_NOT_OK(write_file_footer(&buff));
 
   return Status::Ok();
@@ -1915,7 +3083,9 @@ void FragmentMetadata::clean_up() {
 
   storage_manager_->close_file(fragment_metadata_uri);
   storage_manager_->vfs()->remove_file(fragment_metadata_uri);
-  storage_manager_->array_xunlock(array_uri);
+  if (locked_)
+    storage_manager_->array_xunlock(array_uri);
+  locked_ = false;
 }
 
 // Explicit template instantiations
@@ -2031,6 +3201,56 @@ template Status FragmentMetadata::get_tile_overlap<double>(
     const EncryptionKey& encryption_key,
     const std::vector<const double*>& range,
     TileOverlap* tile_overlap);
+template Status FragmentMetadata::get_tile_overlap<int8_t>(
+    const EncryptionKey& encryption_key,
+    const std::vector<const int8_t*>& range,
+    const TileOverlap& candidates,
+    TileOverlap* tile_overlap);
+template Status FragmentMetadata::get_tile_overlap<uint8_t>(
+    const EncryptionKey& encryption_key,
+    const std::vector<const uint8_t*>& range,
+    const TileOverlap& candidates,
+    TileOverlap* tile_overlap);
+template Status FragmentMetadata::get_tile_overlap<int16_t>(
+    const EncryptionKey& encryption_key,
+    const std::vector<const int16_t*>& range,
+    const TileOverlap& candidates,
+    TileOverlap* tile_overlap);
+template Status FragmentMetadata::get_tile_overlap<uint16_t>(
+    const EncryptionKey& encryption_key,
+    const std::vector<const uint16_t*>& range,
+    const TileOverlap& candidates,
+    TileOverlap* tile_overlap);
+template Status FragmentMetadata::get_tile_overlap<int32_t>(
+    const EncryptionKey& encryption_key,
+    const std::vector<const int32_t*>& range,
+    const TileOverlap& candidates,
+    TileOverlap* tile_overlap);
+template Status FragmentMetadata::get_tile_overlap<uint32_t>(
+    const EncryptionKey& encryption_key,
+    const std::vector<const uint32_t*>& range,
+    const TileOverlap& candidates,
+    TileOverlap* tile_overlap);
+template Status FragmentMetadata::get_tile_overlap<int64_t>(
+    const EncryptionKey& encryption_key,
+    const std::vector<const int64_t*>& range,
+    const TileOverlap& candidates,
+    TileOverlap* tile_overlap);
+template Status FragmentMetadata::get_tile_overlap<uint64_t>(
+    const EncryptionKey& encryption_key,
+    const std::vector<const uint64_t*>& range,
+    const TileOverlap& candidates,
+    TileOverlap* tile_overlap);
+template Status FragmentMetadata::get_tile_overlap<float>(
+    const EncryptionKey& encryption_key,
+    const std::vector<const float*>& range,
+    const TileOverlap& candidates,
+    TileOverlap* tile_overlap);
+template Status FragmentMetadata::get_tile_overlap<double>(
+    const EncryptionKey& encryption_key,
+    const std::vector<const double*>& range,
+    const TileOverlap& candidates,
+    TileOverlap* tile_overlap);
 
 template std::vector<std::pair<uint64_t, double>>
 FragmentMetadata::compute_overlapping_tile_ids_cov<int8_t>(
@@ -34,12 +34,17 @@
 #ifndef TILEDB_FRAGMENT_METADATA_H
 #define TILEDB_FRAGMENT_METADATA_H
 
+#include <memory>
 #include <mutex>
 #include <unordered_map>
 #include <vector>
 
 #include "tiledb/sm/misc/status.h"
 #include "tiledb/sm/misc/uri.h"
+#include "tiledb/sm/misc/bloom_filter.h"
+#include "tiledb/sm/misc/hyperloglog.h"
+#include "tiledb/sm/misc/kll_sketch.h"
+#include "tiledb/sm/misc/value_index.h"
 #include "tiledb/sm/rtree/rtree.h"
 
 namespace tiledb {
@@ -48,6 +53,7 @@ namespace sm {
 class ArraySchema;
 class Buffer;
 class EncryptionKey;
+class FragmentMetadataCache;
 class StorageManager;
 
 /** Stores the metadata structures of a fragment. */
@@ -82,12 +88,65 @@ class FragmentMetadata {
   /*                API                */
   /* ********************************* */
 
+  /**
+   * Adds the hashes of written coordinates (see `BloomFilter::hash_coords`)
+   * to the coordinate bloom filter stored with the fragment. Applicable only
+   * if the filter is enabled with `set_coords_bloom_filter_bits`.
+   */
+  void add_coords_hashes(const std::vector<uint64_t>& hashes);
+
+  /**
+   * Merges the input sketches of written values into the sketches of the
+   * input attribute stored with the fragment. Applicable only if sketches
+   * are enabled with `set_sketches` and `has_sketches` is `true` for the
+   * attribute. Thread-safe.
+   *
+   * @param name The attribute name.
+   * @param hll The distinct count sketch of the values.
+   * @param kll The quantile sketch of the values.
+   */
+  void add_sketches(
+      const std::string& name, const HyperLogLog& hll, const KllSketch& kll);
+
+  /**
+   * Adds the values of the cells of a tile to the value index of the input
+   * attribute stored with the fragment. Applicable only if
+   * `has_value_index` is `true` for the attribute. Thread-safe.
+   *
+   * @param name The attribute name.
+   * @param tid The index of the tile, relative to the tile index base.
+   * @param values The values of the cells of the tile.
+   * @param cell_num The number of cells of the tile.
+   */
+  void add_value_index_tile(
+      const std::string& name,
+      uint64_t tid,
+      const void* values,
+      uint64_t cell_num);
+
+  /**
+   * Adds the entries of the input value index of a fragment whose tiles
+   * start at the tile index base of this fragment to the value index of
+   * the input attribute (see `add_value_index_tile`). Thread-safe.
+   *
+   * @param name The attribute name.
+   * @param index The value index to add.
+   */
+  void add_value_index(const std::string& name, const ValueIndex& index);
+
   /** Returns the array URI. */
   const URI& array_uri() const;
 
   /** Returns the number of cells in the tile at the input position. */
   uint64_t cell_num(uint64_t tile_pos) const;
 
+  /**
+   * Returns the bloom filter over the coordinates of the fragment, or
+   * `nullptr` if the fragment has none or it is not loaded (see
+   * `load_coords_bloom_filter`).
+   */
+  const BloomFilter* coords_bloom_filter() const;
+
   /**
    * Computes an upper bound on the buffer sizes needed when reading a subarray
    * from the fragment, for a given set of attributes. Note that these upper
@@ -170,15 +229,136 @@ class FragmentMetadata {
   /** Returns the (expanded) domain in which the fragment is constrained. */
   const void* domain() const;
 
+  /**
+   * Returns an identifier of the file of the input attribute or dimension
+   * (or of its var-sized values, if `var` is `true`), unique within the
+   * fragment.
+   */
+  uint64_t file_id(const std::string& name, bool var) const;
+
+  /**
+   * Returns `true` if the tiles of all attributes and dimensions of the
+   * fragment are packed into the single file `packed_uri()`.
+   */
+  bool packed() const;
+
+  /**
+   * Returns the URI of the file holding all the tiles of a packed fragment,
+   * or of a fragment of an array whose schema co-locates tiles. A packed
+   * fragment holds the attribute and dimension files one after the other,
+   * in the order of their file identifiers (see `file_id()`). A co-located
+   * fragment holds the tiles in tile index order and, for the same index,
+   * in file identifier order.
+   */
+  URI packed_uri() const;
+
+  /**
+   * Retrieves the range of the packed file holding the tiles of the input
+   * attribute/dimension that would otherwise be stored in file `uri(name)`,
+   * or `var_uri(name)` if `var` is `true`. Applicable only to packed
+   * fragments.
+   */
+  void packed_range(
+      const std::string& name, bool var, uint64_t* offset, uint64_t* size)
+      const;
+
   /** Returns the format version of this fragment. */
   uint32_t format_version() const;
 
+  /**
+   * Retrieves the minimum, maximum and sum of the values of the input
+   * attribute in the input tile, loading them from storage if needed.
+   * The minimum and maximum have the attribute type. The sum is an
+   * `int64_t` for signed integer and datetime attributes, a `uint64_t`
+   * for unsigned integer attributes and a `double` for floating point
+   * attributes. Integer sums wrap around on overflow. If a tile has NaN
+   * values, its minimum and maximum are NaN.
+   *
+   * The values are set to `nullptr` if the fragment does not store them
+   * for the attribute (see `has_tile_min_max_sum`).
+   *
+   * @param encryption_key The encryption key the array was opened with.
+   * @param name The attribute name.
+   * @param tile_idx The index of the tile in the metadata.
+   * @param min Set to the minimum value of the tile.
+   * @param max Set to the maximum value of the tile.
+   * @param sum Set to the sum of the values of the tile.
+   * @return Status
+   */
+  Status get_tile_min_max_sum(
+      const EncryptionKey& encryption_key,
+      const std::string& name,
+      uint64_t tile_idx,
+      const void** min,
+      const void** max,
+      const void** sum);
+
+  /**
+   * Retrieves the distinct count and quantile sketches of the values of the
+   * input attribute in the fragment, loading them from storage if needed.
+   * They are set to `nullptr` if the fragment has none for the attribute.
+   *
+   * @param encryption_key The encryption key the array was opened with.
+   * @param name The attribute name.
+   * @param hll Set to the distinct count sketch.
+   * @param kll Set to the quantile sketch.
+   * @return Status
+   */
+  Status get_sketches(
+      const EncryptionKey& encryption_key,
+      const std::string& name,
+      const HyperLogLog** hll,
+      const KllSketch** kll);
+
+  /**
+   * Returns `true` if the fragment is written with sketches of the values
+   * of the input attribute, i.e., if sketches are enabled and it is a
+   * numeric attribute with a single fixed-sized value per cell.
+   */
+  bool has_sketches(const std::string& name) const;
+
+  /**
+   * Retrieves the value index of the input attribute in the fragment,
+   * loading it from storage if needed. It is set to `nullptr` if the
+   * fragment has none for the attribute.
+   *
+   * @param encryption_key The encryption key the array was opened with.
+   * @param name The attribute name.
+   * @param index Set to the value index.
+   * @return Status
+   */
+  Status get_value_index(
+      const EncryptionKey& encryption_key,
+      const std::string& name,
+      const ValueIndex** index);
+
+  /**
+   * Returns `true` if the fragment is written with a value index of the
+   * input attribute, i.e., if the attribute is one of those set with
+   * `set_value_index_attributes` and is numeric with a single fixed-sized
+   * value per cell.
+   */
+  bool has_value_index(const std::string& name) const;
+
+  /**
+   * Returns `true` if the minimum, maximum and sum of the values of each
+   * tile are stored for the input attribute, i.e., if it is a numeric
+   * attribute with a single fixed-sized value per cell.
+   */
+  bool has_tile_min_max_sum(const std::string& name) const;
+
   /** Retrieves the fragment size. */
   Status fragment_size(uint64_t* size) const;
 
   /** Returns the fragment URI. */
   const URI& fragment_uri() const;
 
+  /**
+   * Returns an identifier of the fragment, derived from a hash of its URI.
+   * It is the same for every instance that loads the same fragment.
+   */
+  uint64_t id() const;
+
   /**
    * Retrieves the overlap of all MBRs with the input range, which is given
    * as a vector of [low, high] intervals per dimension. The encryption
@@ -190,6 +370,20 @@ class FragmentMetadata {
       const std::vector<const T*>& range,
       TileOverlap* tile_overlap);
 
+  /**
+   * Same as above, but only the tiles in ``candidates`` are checked against
+   * the MBRs. ``candidates`` must be the overlap of a range that contains
+   * ``range`` (e.g., the range a partition was split from), so that no
+   * R-Tree traversal is needed. Contiguous tiles fully covered by ``range``
+   * are grouped into tile ranges.
+   */
+  template <class T>
+  Status get_tile_overlap(
+      const EncryptionKey& encryption_key,
+      const std::vector<const T*>& range,
+      const TileOverlap& candidates,
+      TileOverlap* tile_overlap);
+
   /**
    * Initializes the fragment metadata structures.
    *
@@ -202,15 +396,74 @@ class FragmentMetadata {
   /** Returns the number of cells in the last tile. */
   uint64_t last_tile_cell_num() const;
 
-  /** Loads the basic metadata from storage. */
-  Status load(const EncryptionKey& encryption_key);
+  /**
+   * Loads the basic metadata from storage.
+   *
+   * @param encryption_key The encryption key to use.
+   * @param speculative_read_size If the metadata file is not larger than
+   *     this, it is fetched with a single read and the R-Tree is decoded
+   *     along with the footer (`0` to disable).
+   * @return Status
+   */
+  Status load(
+      const EncryptionKey& encryption_key, uint64_t speculative_read_size = 0);
+
+  /**
+   * Loads the basic metadata and the R-Tree from the entry of this fragment
+   * in the consolidated fragment metadata file (see `write_consolidated`),
+   * instead of reading them from the fragment metadata file. Applicable to
+   * format version 3 or higher.
+   */
+  Status load_consolidated(ConstBuffer* buff);
 
-  /** Returns the MBRs of the fragment. Used in format version <=2. */
-  const std::vector<void*> mbrs() const;
+  /**
+   * Writes the entry of this fragment in the consolidated fragment metadata
+   * file, i.e., its metadata file size, footer and R-Tree. Applicable to
+   * format version 3 or higher.
+   */
+  Status write_consolidated(const EncryptionKey& encryption_key, Buffer* buff);
+
+  /**
+   * Returns the MBRs of the fragment, stored contiguously with
+   * `2 * coords_size` bytes per tile. Used in format version <=2.
+   */
+  const std::vector<uint8_t>& mbrs() const;
+
+  /**
+   * Returns the approximate number of bytes held by the loaded metadata,
+   * i.e., the R-tree, MBRs, tile offsets and sizes, tile min/max/sum
+   * values, bloom filter and value indexes. An R-tree shared through the
+   * index cache is counted in full.
+   */
+  uint64_t memory_size();
 
   /** Stores all the metadata to storage. */
   Status store(const EncryptionKey& encryption_key);
 
+  /**
+   * Loads the bloom filter over the coordinates of the fragment from
+   * storage, if the fragment has one.
+   */
+  Status load_coords_bloom_filter(const EncryptionKey& encryption_key);
+
+  /** Loads the R-tree from storage. */
+  Status load_rtree(const EncryptionKey& encryption_key);
+
+  /**
+   * Loads the R-tree and the tile offsets of the input attributes and
+   * dimensions from storage, i.e., the structures reads locate tiles with.
+   * For format version 6 or higher only the page index and the first page
+   * of the tile offsets are loaded; reads load the other pages on demand.
+   *
+   * @param encryption_key The encryption key.
+   * @param names The attribute and dimension names. Names that are not in
+   *     the array are ignored.
+   * @return Status
+   */
+  Status load_read_metadata(
+      const EncryptionKey& encryption_key,
+      const std::vector<std::string>& names);
+
   /** Returns the non-empty domain in which the fragment is constrained. */
   const void* non_empty_domain() const;
 
@@ -225,6 +478,43 @@ class FragmentMetadata {
    */
   void set_last_tile_cell_num(uint64_t cell_num);
 
+  /**
+   * Enables the bloom filter over the coordinates of the fragment, with the
+   * input number of filter bits per cell. `0` disables it.
+   */
+  void set_coords_bloom_filter_bits(uint32_t bits_per_cell);
+
+  /**
+   * Sets whether the R-Tree built on the MBRs of the fragment packs its
+   * leaves with Sort-Tile-Recursive.
+   */
+  void set_rtree_str_packing(bool str_packing);
+
+  /**
+   * Sets whether the fragment stores distinct count and quantile sketches
+   * of the values of its numeric attributes (see `add_sketches`).
+   */
+  void set_sketches(bool sketches);
+
+  /**
+   * Sets the attributes whose values are indexed in the fragment (see
+   * `add_value_index_tile`). Must be called before `init`.
+   */
+  void set_value_index_attributes(const std::vector<std::string>& names);
+
+  /**
+   * Sets whether the generic tiles of the metadata file are stored
+   * uncompressed, so that they are used in place when the file is mapped.
+   */
+  void set_unfiltered(bool unfiltered);
+
+  /**
+   * Marks the fragment as packed (see `packed()`). This must be called once
+   * the offsets of all tiles have been set, since they determine where each
+   * attribute file starts in the packed file.
+   */
+  void set_packed();
+
   /**
    * Sets the input tile's MBR in the fragment metadata. It also expands the
    * non-empty domain of the fragment.
@@ -279,6 +569,25 @@ class FragmentMetadata {
    */
   void set_tile_offset(const std::string& name, uint64_t tid, uint64_t step);
 
+  /**
+   * Sets the minimum, maximum and sum of the values of the input attribute
+   * in a tile (see `get_tile_min_max_sum`). Applicable only to attributes
+   * for which `has_tile_min_max_sum` is `true`.
+   *
+   * @param name The attribute name.
+   * @param tid The index of the tile.
+   * @param min The minimum value.
+   * @param max The maximum value.
+   * @param sum The sum of the values (8 bytes).
+   * @return void
+   */
+  void set_tile_min_max_sum(
+      const std::string& name,
+      uint64_t tid,
+      const void* min,
+      const void* max,
+      const void* sum);
+
   /**
    * Sets a variable tile offset for the input attribute or dimension.
    *
@@ -307,7 +616,10 @@ class FragmentMetadata {
   /** Returns the number of tiles in the fragment. */
   uint64_t tile_num() const;
 
-  /** Returns the URI of the input attribute/dimension. */
+  /**
+   * Returns the URI of the input attribute/dimension, which is
+   * `packed_uri()` for packed and co-located fragments.
+   */
   URI uri(const std::string& name) const;
 
   /** Returns the URI of the input variable-sized attribute/dimension. */
@@ -346,8 +658,11 @@ class FragmentMetadata {
       uint64_t tile_idx,
       uint64_t* offset);
 
-  /** Returns the MBR of the input tile. */
-  const void* mbr(uint64_t tile_idx) const;
+  /**
+   * Copies the MBR of the input tile into `mbr`, in the form
+   * `(low_1, high_1), ..., (low_d, high_d)`.
+   */
+  void mbr(uint64_t tile_idx, void* mbr) const;
 
   /**
    * Retrieves the size of the tile when it is persisted (e.g. the size of the
@@ -435,18 +750,37 @@ class FragmentMetadata {
    */
   struct GenericTileOffsets {
     uint64_t rtree_ = 0;
+    uint64_t coords_bloom_filter_ = UINT64_MAX;
     std::vector<uint64_t> tile_offsets_;
     std::vector<uint64_t> tile_var_offsets_;
     std::vector<uint64_t> tile_var_sizes_;
+    std::vector<uint64_t> tile_min_max_sum_;
+    std::vector<uint64_t> sketches_;
+    std::vector<uint64_t> value_indexes_;
   };
 
   /** Keeps track of which metadata is loaded. */
   struct LoadedMetadata {
     bool footer_ = false;
     bool rtree_ = false;
+    bool coords_bloom_filter_ = false;
     std::vector<bool> tile_offsets_;
     std::vector<bool> tile_var_offsets_;
     std::vector<bool> tile_var_sizes_;
+    std::vector<bool> tile_min_max_sum_;
+    std::vector<bool> sketches_;
+    std::vector<bool> value_indexes_;
+  };
+
+  /**
+   * The page index of per-tile values (e.g., tile offsets) stored in pages
+   * in the metadata file, along with which pages are loaded.
+   */
+  struct TilePages {
+    bool index_loaded_ = false;
+    uint64_t loaded_num_ = 0;
+    std::vector<uint64_t> offsets_;
+    std::vector<bool> loaded_;
   };
 
   /* ********************************* */
@@ -466,8 +800,11 @@ class FragmentMetadata {
    */
   std::unordered_map<std::string, unsigned> idx_map_;
 
-  /** A vector storing the first and last coordinates of each tile. */
-  std::vector<void*> bounding_coords_;
+  /**
+   * The first and last coordinates of each tile, stored contiguously
+   * with `2 * coords_size` bytes per tile.
+   */
+  std::vector<uint8_t> bounding_coords_;
 
   /** True if the fragment is dense, and false if it is sparse. */
   bool dense_;
@@ -489,6 +826,9 @@ class FragmentMetadata {
   /** The uri of the fragment the metadata belongs to. */
   URI fragment_uri_;
 
+  /** The fragment identifier (see `id()`). */
+  uint64_t id_;
+
   /** Number of cells in the last tile (meaningful only in the sparse case). */
   uint64_t last_tile_cell_num_;
 
@@ -499,8 +839,11 @@ class FragmentMetadata {
   LoadedMetadata loaded_metadata_;
 
   // TODO(sp): remove after the new dense algorithm is implemented
-  /** The MBRs (applicable only to the sparse case with irregular tiles). */
-  std::vector<void*> mbrs_;
+  /**
+   * The MBRs (applicable only to the sparse case with irregular tiles),
+   * stored contiguously with `2 * coords_size` bytes per tile.
+   */
+  std::vector<uint8_t> mbrs_;
 
   /** The size of the fragment metadata file. */
   uint64_t meta_file_size_;
@@ -520,8 +863,60 @@ class FragmentMetadata {
    */
   void* non_empty_domain_;
 
-  /** An RTree for the MBRs. */
-  RTree rtree_;
+  /**
+   * An RTree for the MBRs. It is immutable once built or loaded, so it may
+   * be shared with other fragment metadata objects through the index cache.
+   */
+  std::shared_ptr<const RTree> rtree_;
+
+  /** The bloom filter over the coordinates, if loaded or being written. */
+  BloomFilter coords_bloom_filter_;
+
+  /** The filter bits per cell of the coordinate bloom filter (`0` if none). */
+  uint32_t coords_bloom_filter_bits_;
+
+  /** Whether the R-Tree packs its leaves with Sort-Tile-Recursive. */
+  bool rtree_str_packing_;
+
+  /** Whether the fragment is written with sketches of its attributes. */
+  bool sketches_;
+
+  /**
+   * The distinct count sketch of the values of each attribute, if loaded or
+   * being written. Empty for the attributes without sketches.
+   */
+  std::vector<std::unique_ptr<HyperLogLog>> hlls_;
+
+  /** The quantile sketch of the values of each attribute. */
+  std::vector<std::unique_ptr<KllSketch>> klls_;
+
+  /** The names of the attributes whose values are indexed when written. */
+  std::vector<std::string> value_index_attributes_;
+
+  /**
+   * The value index of each attribute, if loaded or being written. Empty
+   * for the attributes without value index.
+   */
+  std::vector<std::unique_ptr<ValueIndex>> value_indexes_;
+
+  /** Whether the generic tiles of the metadata file are stored unfiltered. */
+  bool unfiltered_;
+
+  /** Whether the tiles of the fragment are packed into a single file. */
+  bool packed_;
+
+  /**
+   * The offset in the packed file at which each attribute/dimension file
+   * starts, indexed by file identifier (see `file_id()`). Empty if the
+   * fragment is not packed.
+   */
+  std::vector<uint64_t> packed_offsets_;
+
+  /** Whether `store` holds the exclusive lock of the array. */
+  bool locked_;
+
+  /** The hashes of the written coordinates, added to the bloom filter. */
+  std::vector<uint64_t> coords_hashes_;
 
   /**
    * The tile index base which is added to tile indices in setter functions.
@@ -535,18 +930,39 @@ class FragmentMetadata {
    */
   std::vector<std::vector<uint64_t>> tile_offsets_;
 
+  /** The page indices of the tile offsets (format version 6 or higher). */
+  std::vector<TilePages> tile_offsets_pages_;
+
   /**
    * The variable tile offsets in their corresponding attribute files.
    * Meaningful only for variable-sized tiles.
    */
   std::vector<std::vector<uint64_t>> tile_var_offsets_;
 
+  /** The page indices of the variable tile offsets. */
+  std::vector<TilePages> tile_var_offsets_pages_;
+
   /**
    * The sizes of the uncompressed variable tiles.
    * Meaningful only when there is compression for variable tiles.
    */
   std::vector<std::vector<uint64_t>> tile_var_sizes_;
 
+  /** The page indices of the variable tile sizes. */
+  std::vector<TilePages> tile_var_sizes_pages_;
+
+  /**
+   * The minimum value of each tile, per attribute. Empty for the
+   * attributes that do not store it (see `has_tile_min_max_sum`).
+   */
+  std::vector<std::vector<uint8_t>> tile_min_;
+
+  /** The maximum value of each tile, per attribute. */
+  std::vector<std::vector<uint8_t>> tile_max_;
+
+  /** The sum of the values of each tile (8 bytes), per attribute. */
+  std::vector<std::vector<uint8_t>> tile_sum_;
+
   /** The format version of this metadata. */
   uint32_t version_;
 
@@ -616,27 +1032,89 @@ class FragmentMetadata {
   template <class T>
   Status expand_non_empty_domain(const T* mbr);
 
-  /** Loads the R-tree from storage. */
-  Status load_rtree(const EncryptionKey& encryption_key);
+  /**
+   * Returns `true` if the minimum, maximum and sum of the values of each
+   * tile are stored for the attribute with the input index.
+   */
+  bool has_tile_min_max_sum(unsigned idx) const;
+
+  /**
+   * Loads the tile minimum, maximum and sum values for the input attribute
+   * idx from storage.
+   */
+  Status load_tile_min_max_sum(
+      const EncryptionKey& encryption_key, unsigned idx);
+
+  /**
+   * Loads the tile minimum, maximum and sum values for the input attribute
+   * idx from the input buffer.
+   */
+  Status load_tile_min_max_sum(unsigned idx, ConstBuffer* buff);
+
+  /** Loads the sketches of the input attribute idx from storage. */
+  Status load_sketches(const EncryptionKey& encryption_key, unsigned idx);
+
+  /**
+   * Loads the offsets of the sketches of the attributes from the footer
+   * (format version 8 or higher).
+   */
+  Status load_sketch_offsets(ConstBuffer* buff);
+
+  /** Loads the value index of the input attribute idx from storage. */
+  Status load_value_index(const EncryptionKey& encryption_key, unsigned idx);
+
+  /**
+   * Loads the offsets of the value indexes of the attributes from the
+   * footer (format version 9 or higher).
+   */
+  Status load_value_index_offsets(ConstBuffer* buff);
 
   /**
    * Loads the tile offsets for the input attribute or dimension idx
-   * from storage.
+   * from storage, covering at least tile `tile_idx`. For format version 6
+   * or higher only the page holding that tile is read; older fragments
+   * load all the tile offsets of the attribute or dimension.
    */
-  Status load_tile_offsets(const EncryptionKey& encryption_key, unsigned idx);
+  Status load_tile_offsets(
+      const EncryptionKey& encryption_key, unsigned idx, uint64_t tile_idx);
 
   /**
    * Loads the variable tile offsets for the input attribute or dimension idx
-   * from storage.
+   * from storage, covering at least tile `tile_idx` (see
+   * `load_tile_offsets`).
    */
   Status load_tile_var_offsets(
-      const EncryptionKey& encryption_key, unsigned idx);
+      const EncryptionKey& encryption_key, unsigned idx, uint64_t tile_idx);
 
   /**
    * Loads the variable tile sizes for the input attribute or dimension idx
-   * from storage.
-   * */
-  Status load_tile_var_sizes(const EncryptionKey& encryption_key, unsigned idx);
+   * from storage, covering at least tile `tile_idx` (see
+   * `load_tile_offsets`).
+   */
+  Status load_tile_var_sizes(
+      const EncryptionKey& encryption_key, unsigned idx, uint64_t tile_idx);
+
+  /**
+   * Loads the page of per-tile values holding tile `tile_idx`, reading the
+   * page index first if needed. Applicable to versions 6 or higher. The
+   * caller must hold `mtx_`.
+   *
+   * @param encryption_key The encryption key.
+   * @param index_offset The offset of the page index in the metadata file.
+   * @param tile_idx The index of the tile whose page will be loaded.
+   * @param values The per-tile values, resized to the tile number when the
+   *     page index is loaded.
+   * @param pages The page index and load state of `values`.
+   * @param all_loaded Set to `true` if all the pages are now loaded.
+   * @return Status
+   */
+  Status load_tile_page(
+      const EncryptionKey& encryption_key,
+      uint64_t index_offset,
+      uint64_t tile_idx,
+      std::vector<uint64_t>* values,
+      TilePages* pages,
+      bool* all_loaded);
 
   /** Loads the generic tile offsets from the buffer. */
   Status load_generic_tile_offsets(ConstBuffer* buff);
@@ -767,11 +1245,52 @@ class FragmentMetadata {
   /** Loads the number of sparse tiles from the buffer. */
   Status load_sparse_tile_num(ConstBuffer* buff);
 
+  /** Loads the `packed_` field from the buffer. */
+  Status load_packed(ConstBuffer* buff);
+
+  /**
+   * Retrieves the offset of a tile in the file of a co-located fragment
+   * (see `packed_uri()`). It is computed from the tile offsets of all the
+   * attributes and dimensions, which get loaded.
+   *
+   * @param encryption_key The encryption key of the array.
+   * @param idx The index of the attribute/dimension.
+   * @param var Whether the tile is a var-sized tile.
+   * @param tile_idx The index of the tile.
+   * @param offset The offset to retrieve.
+   * @return Status
+   */
+  Status colocated_file_offset(
+      const EncryptionKey& encryption_key,
+      unsigned idx,
+      bool var,
+      uint64_t tile_idx,
+      uint64_t* offset);
+
+  /**
+   * Computes `packed_offsets_` from the sizes of the fixed-sized and
+   * var-sized attribute/dimension files.
+   */
+  void compute_packed_offsets(
+      const std::vector<uint64_t>& file_sizes,
+      const std::vector<uint64_t>& file_var_sizes);
+
   /** Loads the basic metadata from storage (version 2 or before). */
   Status load_v1_v2(const EncryptionKey& encryption_key);
 
-  /** Loads the basic metadata from storage (version 3 or after). */
-  Status load_v3_or_higher(const EncryptionKey& encryption_key);
+  /**
+   * Loads the basic metadata from storage (version 3 or after). The whole
+   * file is read at once if it is not larger than `speculative_read_size`.
+   */
+  Status load_v3_or_higher(
+      const EncryptionKey& encryption_key, uint64_t speculative_read_size);
+
+  /**
+   * Reads the whole metadata file with a single request and loads both the
+   * footer and the R-Tree from it, populating the fragment metadata and
+   * index caches as the separate loads would.
+   */
+  Status load_whole_file(const EncryptionKey& encryption_key);
 
   /**
    * Loads the footer of the metadata file, which contains
@@ -779,6 +1298,12 @@ class FragmentMetadata {
    */
   Status load_footer(const EncryptionKey& encryption_key);
 
+  /**
+   * Deserializes the footer of the metadata file from the input buffer.
+   * The caller must hold `mtx_`.
+   */
+  Status load_footer(ConstBuffer* buff);
+
   /** Writes the sizes of each attribute file to the buffer. */
   Status write_file_sizes(Buffer* buff);
 
@@ -802,6 +1327,38 @@ class FragmentMetadata {
    */
   Status store_rtree(const EncryptionKey& encryption_key, uint64_t* nbytes);
 
+  /**
+   * Writes the coordinate bloom filter to storage.
+   *
+   * @param encryption_key The encryption key.
+   * @param nbytes The total number of bytes written for the filter.
+   * @return Status
+   */
+  Status store_coords_bloom_filter(
+      const EncryptionKey& encryption_key, uint64_t* nbytes);
+
+  /**
+   * Writes the sketches of the input attribute to storage.
+   *
+   * @param idx The index of the attribute.
+   * @param encryption_key The encryption key.
+   * @param nbytes The total number of bytes written for the sketches.
+   * @return Status
+   */
+  Status store_sketches(
+      unsigned idx, const EncryptionKey& encryption_key, uint64_t* nbytes);
+
+  /**
+   * Sorts and writes the value index of the input attribute to storage.
+   *
+   * @param idx The index of the attribute.
+   * @param encryption_key The encryption key.
+   * @param nbytes The total number of bytes written for the value index.
+   * @return Status
+   */
+  Status store_value_index(
+      unsigned idx, const EncryptionKey& encryption_key, uint64_t* nbytes);
+
   /** Stores a footer with the basic information. */
   Status store_footer(const EncryptionKey& encryption_key);
 
@@ -812,57 +1369,89 @@ class FragmentMetadata {
   Status write_non_empty_domain(Buffer* buff);
 
   /**
-   * Writes the tile offsets of the input attribute or dimension to storage.
+   * Writes the tile offsets of the input attribute or dimension to storage,
+   * and sets their generic tile offset in `gt_offsets_`.
    *
    * @param idx The index of the attribute or dimension.
    * @param encryption_key The encryption key.
+   * @param offset The offset in the metadata file the writing starts at.
    * @param nbytes The total number of bytes written for the tile offsets.
    * @return Status
    */
   Status store_tile_offsets(
-      unsigned idx, const EncryptionKey& encryption_key, uint64_t* nbytes);
-
-  /**
-   * Writes the tile offsets of the input attribute or dimension idx to the
-   * input buffer.
-   */
-  Status write_tile_offsets(unsigned idx, Buffer* buff);
+      unsigned idx,
+      const EncryptionKey& encryption_key,
+      uint64_t offset,
+      uint64_t* nbytes);
 
   /**
    * Writes the variable tile offsets of the input attribute or dimension
-   * to storage.
+   * to storage, and sets their generic tile offset in `gt_offsets_`.
    *
    * @param idx The index of the attribute or dimension.
    * @param encryption_key The encryption key.
+   * @param offset The offset in the metadata file the writing starts at.
    * @param nbytes The total number of bytes written for the tile var offsets.
    * @return Status
    */
   Status store_tile_var_offsets(
-      unsigned idx, const EncryptionKey& encryption_key, uint64_t* nbytes);
-
-  /**
-   * Writes the variable tile offsets of the input attribute or dimension idx
-   * to the buffer.
-   */
-  Status write_tile_var_offsets(unsigned idx, Buffer* buff);
+      unsigned idx,
+      const EncryptionKey& encryption_key,
+      uint64_t offset,
+      uint64_t* nbytes);
 
   /**
    * Writes the variable tile sizes for the input attribute or dimension to
-   * the buffer.
+   * storage, and sets their generic tile offset in `gt_offsets_`.
    *
    * @param idx The index of the attribute or dimension.
    * @param encryption_key The encryption key.
+   * @param offset The offset in the metadata file the writing starts at.
    * @param nbytes The total number of bytes written for the tile var sizes.
    * @return Status
    */
   Status store_tile_var_sizes(
-      unsigned idx, const EncryptionKey& encryption_key, uint64_t* nbytes);
+      unsigned idx,
+      const EncryptionKey& encryption_key,
+      uint64_t offset,
+      uint64_t* nbytes);
+
+  /**
+   * Writes the input per-tile values to storage as a sequence of pages of
+   * `constants::tile_offsets_page_tile_num` values each, followed by an
+   * index holding the file offsets of the pages.
+   *
+   * @param encryption_key The encryption key.
+   * @param values The per-tile values to write.
+   * @param offset The offset in the metadata file the writing starts at.
+   * @param index_offset Set to the offset of the page index in the file.
+   * @param nbytes The total number of bytes written.
+   * @return Status
+   */
+  Status store_tile_pages(
+      const EncryptionKey& encryption_key,
+      const std::vector<uint64_t>& values,
+      uint64_t offset,
+      uint64_t* index_offset,
+      uint64_t* nbytes);
 
   /**
-   * Writes the variable tile sizes for the input attribute or dimension
+   * Writes the tile minimum, maximum and sum values of the input attribute
    * to storage.
+   *
+   * @param idx The index of the attribute.
+   * @param encryption_key The encryption key.
+   * @param nbytes The total number of bytes written for the values.
+   * @return Status
+   */
+  Status store_tile_min_max_sum(
+      unsigned idx, const EncryptionKey& encryption_key, uint64_t* nbytes);
+
+  /**
+   * Writes the tile minimum, maximum and sum values of the input attribute
+   * idx to the buffer.
    */
-  Status write_tile_var_sizes(unsigned idx, Buffer* buff);
+  Status write_tile_min_max_sum(unsigned idx, Buffer* buff);
 
   /** Writes the format version to the buffer. */
   Status write_version(Buffer* buff);
@@ -873,18 +1462,40 @@ class FragmentMetadata {
   /** Writes the number of sparse tiles to the buffer. */
   Status write_sparse_tile_num(Buffer* buff);
 
+  /** Writes the offsets of the sketches of the attributes to the buffer. */
+  Status write_sketch_offsets(Buffer* buff);
+
+  /** Writes the offsets of the value indexes of the attributes. */
+  Status write_value_index_offsets(Buffer* buff);
+
+  /** Writes the `packed_` field to the buffer. */
+  Status write_packed(Buffer* buff);
+
   /**
    * Reads the contents of a generic tile starting at the input offset,
-   * and stores them into buffer ``buff``.
+   * and retrieves them in ``buff``. The tile is served from and added to
+   * the fragment metadata cache, if enabled.
    */
   Status read_generic_tile_from_file(
-      const EncryptionKey& encryption_key, uint64_t offset, Buffer* buff) const;
+      const EncryptionKey& encryption_key,
+      uint64_t offset,
+      std::shared_ptr<const Buffer>* buff) const;
 
   /**
    * Reads the fragment metadata file footer (which contains the generic tile
-   * offsets) into the input buffer.
+   * offsets) and retrieves it in ``buff``. The footer is served from and
+   * added to the fragment metadata cache, if enabled.
+   */
+  Status read_file_footer(
+      const EncryptionKey& encryption_key,
+      std::shared_ptr<const Buffer>* buff) const;
+
+  /**
+   * Returns the process-wide fragment metadata cache, or `nullptr` if it is
+   * disabled or the array is encrypted.
    */
-  Status read_file_footer(Buffer* buff) const;
+  FragmentMetadataCache* metadata_cache(
+      const EncryptionKey& encryption_key) const;
 
   /**
    * Writes the contents of the input buffer as a separate
@@ -910,7 +1521,7 @@ class FragmentMetadata {
 
   /**
    * Simple clean up function called in the case of error. It removes the
-   * fragment metadata file and unlocks the array.
+   * fragment metadata file and unlocks the array, if locked.
    */
   void clean_up();
 };
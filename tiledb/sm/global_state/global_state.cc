@@ -40,7 +40,6 @@
 
 #ifdef __linux__
 #include "tiledb/sm/filesystem/posix.h"
-#include "tiledb/sm/misc/thread_pool.h"
 #include "tiledb/sm/misc/utils.h"
 #endif
 
@@ -56,7 +55,8 @@ GlobalState& GlobalState::GetGlobalState() {
   return globalState;
 }
 
-GlobalState::GlobalState() {
+GlobalState::GlobalState()
+    : fragment_metadata_cache_(0) {
   initialized_ = false;
 }
 
@@ -85,6 +85,14 @@ Status GlobalState::init(const Config* config) {
     RETURN_NOT_OK(init_openssl());
     RETURN_NOT_OK(init_libcurl());
 
+    uint64_t fragment_metadata_cache_size = 0;
+    RETURN_NOT_OK(config_.get<uint64_t>(
+        "sm.fragment_metadata_cache_size",
+        &fragment_metadata_cache_size,
+        &found));
+    assert(found);
+    fragment_metadata_cache_.set_max_size(fragment_metadata_cache_size);
+
 #ifdef __linux__
     // We attempt to find the linux ca cert bundle
     // This only needs to happen one time, and then we will use the file found
@@ -120,6 +128,39 @@ std::set<StorageManager*> GlobalState::storage_managers() {
 const std::string& GlobalState::cert_file() {
   return cert_file_;
 }
+
+FragmentMetadataCache* GlobalState::fragment_metadata_cache() {
+  return &fragment_metadata_cache_;
+}
+
+Status GlobalState::scheduler(const Config& config, ThreadPool** scheduler) {
+  *scheduler = nullptr;
+
+  bool found = false;
+  uint64_t num_threads = 0;
+  RETURN_NOT_OK(config.get<uint64_t>(
+      "sm.num_scheduler_threads", &num_threads, &found));
+  assert(found);
+  if (num_threads == 0)
+    return Status::Ok();
+
+  bool numa_pinning = false;
+  RETURN_NOT_OK(config.get<bool>("sm.numa_pinning", &numa_pinning, &found));
+  assert(found);
+
+  std::unique_lock<std::mutex> lck(scheduler_mtx_);
+  if (scheduler_ == nullptr) {
+    std::unique_ptr<ThreadPool> scheduler(new ThreadPool());
+    RETURN_NOT_OK(scheduler->init(num_threads));
+    if (numa_pinning)
+      RETURN_NOT_OK(scheduler->pin_numa_nodes());
+    scheduler_ = std::move(scheduler);
+  }
+  *scheduler = scheduler_.get();
+
+  return Status::Ok();
+}
+
 }  // namespace global_state
 }  // namespace sm
 }  // namespace tiledb
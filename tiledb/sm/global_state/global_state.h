@@ -33,12 +33,15 @@
 #ifndef TILEDB_GLOBAL_STATE_H
 #define TILEDB_GLOBAL_STATE_H
 
+#include <memory>
 #include <mutex>
 #include <set>
 #include <string>
 
+#include "tiledb/sm/cache/fragment_metadata_cache.h"
 #include "tiledb/sm/config/config.h"
 #include "tiledb/sm/misc/status.h"
+#include "tiledb/sm/misc/thread_pool.h"
 
 namespace tiledb {
 namespace sm {
@@ -92,6 +95,25 @@ class GlobalState {
    */
   const std::string& cert_file();
 
+  /**
+   * Returns the process-wide cache of decoded array schema and fragment
+   * metadata, sized by `sm.fragment_metadata_cache_size` of the first
+   * initialized configuration.
+   */
+  FragmentMetadataCache* fragment_metadata_cache();
+
+  /**
+   * Returns the process-wide task scheduler, configured by
+   * `sm.num_scheduler_threads`. It is created with the number of threads of
+   * the first configuration that sets a non-zero value.
+   *
+   * @param config The TileDB configuration parameters.
+   * @param scheduler Set to the scheduler, or `nullptr` if the
+   *     configuration does not enable it.
+   * @return Status
+   */
+  Status scheduler(const Config& config, ThreadPool** scheduler);
+
  private:
   /** The TileDB configuration parameters. */
   Config config_;
@@ -111,6 +133,15 @@ class GlobalState {
   /** Detected certificate file, currently only used on linux */
   std::string cert_file_;
 
+  /** The process-wide fragment metadata cache. */
+  FragmentMetadataCache fragment_metadata_cache_;
+
+  /** The process-wide task scheduler, created on demand. */
+  std::unique_ptr<ThreadPool> scheduler_;
+
+  /** Protects the creation of `scheduler_`. */
+  std::mutex scheduler_mtx_;
+
   /** Constructor. */
   GlobalState();
 };
@@ -37,10 +37,15 @@
 #ifdef HAVE_TBB
 
 #include <tbb/task_scheduler_init.h>
+#include <tbb/task_scheduler_observer.h>
+#include <atomic>
 #include <cassert>
 #include <cstdlib>
 #include <sstream>
 
+#include "tiledb/sm/misc/logger.h"
+#include "tiledb/sm/misc/numa.h"
+
 namespace tiledb {
 namespace sm {
 namespace global_state {
@@ -51,14 +56,45 @@ static std::unique_ptr<tbb::task_scheduler_init> tbb_scheduler_;
 /** The number of TBB threads the scheduler was configured with **/
 static int tbb_nthreads_;
 
+/** Pins every TBB worker thread to a NUMA node, round robin. */
+class NumaObserver : public tbb::task_scheduler_observer {
+ public:
+  NumaObserver()
+      : next_node_(0) {
+    observe(true);
+  }
+
+  void on_scheduler_entry(bool is_worker) override {
+    // Leave the application threads joining the arena alone
+    static thread_local bool pinned = false;
+    if (!is_worker || pinned)
+      return;
+    pinned = true;
+    auto st = numa::pin_current_thread(next_node_++);
+    if (!st.ok())
+      LOG_STATUS(st);
+  }
+
+ private:
+  /** The node of the next worker to pin. */
+  std::atomic<uint64_t> next_node_;
+};
+
+/** The NUMA pinning observer, created if `sm.numa_pinning` is set. */
+static std::unique_ptr<NumaObserver> tbb_numa_observer_;
+
 Status init_tbb(const Config* config) {
   int nthreads;
+  bool numa_pinning = false;
   if (!config) {
     nthreads = std::strtol(Config::SM_NUM_TBB_THREADS.c_str(), nullptr, 10);
   } else {
     bool found = false;
     RETURN_NOT_OK(config->get<int>("sm.num_tbb_threads", &nthreads, &found));
     assert(found);
+    RETURN_NOT_OK(
+        config->get<bool>("sm.numa_pinning", &numa_pinning, &found));
+    assert(found);
   }
 
   if (nthreads == tbb::task_scheduler_init::automatic) {
@@ -94,9 +130,17 @@ Status init_tbb(const Config* config) {
       return Status::Error(msg.str());
     }
   }
+  if (numa_pinning && !tbb_numa_observer_)
+    tbb_numa_observer_ = std::unique_ptr<NumaObserver>(new NumaObserver());
   return Status::Ok();
 }
 
+unsigned tbb_num_threads() {
+  if (tbb_nthreads_ > 0)
+    return (unsigned)tbb_nthreads_;
+  return (unsigned)tbb::task_scheduler_init::default_num_threads();
+}
+
 }  // namespace global_state
 }  // namespace sm
 }  // namespace tiledb
@@ -112,6 +156,10 @@ Status init_tbb(const Config* config) {
   return Status::Ok();
 }
 
+unsigned tbb_num_threads() {
+  return 1;
+}
+
 }  // namespace global_state
 }  // namespace sm
 }  // namespace tiledb
@@ -52,6 +52,12 @@ namespace global_state {
  */
 Status init_tbb(const Config* config);
 
+/**
+ * Returns the number of threads of the Intel TBB scheduler, which is 1 if
+ * TileDB is built without Intel TBB.
+ */
+unsigned tbb_num_threads();
+
 }  // namespace global_state
 }  // namespace sm
 }  // namespace tiledb
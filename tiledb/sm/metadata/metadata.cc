@@ -37,7 +37,9 @@
 #include "tiledb/sm/misc/logger.h"
 #include "tiledb/sm/misc/utils.h"
 
+#include <algorithm>
 #include <iostream>
+#include <unordered_set>
 
 namespace tiledb {
 namespace sm {
@@ -71,10 +73,17 @@ Status Metadata::deserialize(
   if (metadata_buffs.empty())
     return Status::Ok();
 
+  // Replay the buffers from the newest, so that only the latest value of
+  // each key is copied and the overwritten values are skipped. A buffer
+  // holds each key at most once.
   uint32_t key_len;
   char del;
+  char type;
+  uint32_t num;
   size_t value_len;
-  for (const auto& buff : metadata_buffs) {
+  std::unordered_set<std::string> deleted;
+  for (auto b = metadata_buffs.rbegin(); b != metadata_buffs.rend(); ++b) {
+    const auto& buff = *b;
     // Iterate over all items
     buff->set_offset(0);
     while (buff->offset() != buff->size()) {
@@ -83,30 +92,41 @@ Status Metadata::deserialize(
       buff->advance_offset(key_len);
       RETURN_NOT_OK(buff->read(&del, sizeof(char)));
 
-      metadata_map_.erase(key);
+      value_len = 0;
+      if (!del) {
+        RETURN_NOT_OK(buff->read(&type, sizeof(char)));
+        RETURN_NOT_OK(buff->read(&num, sizeof(uint32_t)));
+        value_len = num * datatype_size(static_cast<Datatype>(type));
+      }
+
+      // Skip the keys overwritten or deleted by newer buffers
+      if (metadata_map_.count(key) != 0 || deleted.count(key) != 0) {
+        buff->advance_offset(value_len);
+        continue;
+      }
 
       // Handle deletion
-      if (del)
+      if (del) {
+        deleted.insert(std::move(key));
         continue;
+      }
 
       MetadataValue value_struct;
       value_struct.del_ = del;
-      RETURN_NOT_OK(buff->read(&value_struct.type_, sizeof(char)));
-      RETURN_NOT_OK(buff->read(&value_struct.num_, sizeof(uint32_t)));
-      if (value_struct.num_) {
-        value_len = value_struct.num_ *
-                    datatype_size(static_cast<Datatype>(value_struct.type_));
+      value_struct.type_ = type;
+      value_struct.num_ = num;
+      if (num) {
         value_struct.value_.resize(value_len);
         RETURN_NOT_OK(buff->read((void*)value_struct.value_.data(), value_len));
       }
 
       // Insert to metadata
-      metadata_map_.emplace(std::make_pair(key, std::move(value_struct)));
+      metadata_map_.emplace(
+          std::make_pair(std::move(key), std::move(value_struct)));
     }
   }
 
-  RETURN_NOT_OK(build_metadata_index());
-  // Note: `metadata_map_` and `metadata_index_` are immutable after this point
+  // Note: `metadata_map_` is immutable after this point
 
   return Status::Ok();
 }
@@ -142,6 +162,7 @@ Status Metadata::del(const char* key) {
 
   std::unique_lock<std::mutex> lck(mtx_);
 
+  metadata_index_.clear();
   MetadataValue value;
   value.del_ = 1;
   metadata_map_.emplace(std::make_pair(std::string(key), std::move(value)));
@@ -171,6 +192,7 @@ Status Metadata::put(
     value_struct.value_.resize(value_size);
     std::memcpy(value_struct.value_.data(), value, value_size);
   }
+  metadata_index_.clear();
   metadata_map_.erase(std::string(key));
   metadata_map_.emplace(
       std::make_pair(std::string(key), std::move(value_struct)));
@@ -302,11 +324,18 @@ Metadata::iterator Metadata::end() const {
 /* ********************************* */
 
 Status Metadata::build_metadata_index() {
-  // Create metadata index for fast lookups from index
+  // Create metadata index for fast lookups from index, sorted on the keys
   metadata_index_.resize(metadata_map_.size());
   size_t i = 0;
   for (auto& m : metadata_map_)
     metadata_index_[i++] = std::make_pair(&(m.first), &(m.second));
+  std::sort(
+      metadata_index_.begin(),
+      metadata_index_.end(),
+      [](const std::pair<const std::string*, MetadataValue*>& a,
+         const std::pair<const std::string*, MetadataValue*>& b) {
+        return *a.first < *b.first;
+      });
 
   return Status::Ok();
 }
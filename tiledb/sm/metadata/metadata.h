@@ -33,9 +33,9 @@
 #ifndef TILEDB_METADATA_H
 #define TILEDB_METADATA_H
 
-#include <map>
 #include <memory>
 #include <mutex>
+#include <unordered_map>
 #include <vector>
 
 #include "tiledb/sm/misc/status.h"
@@ -77,7 +77,8 @@ class Metadata {
   };
 
   /** Iterator type for iterating over metadata values. */
-  typedef std::map<std::string, MetadataValue>::const_iterator iterator;
+  typedef std::unordered_map<std::string, MetadataValue>::const_iterator
+      iterator;
 
   /* ********************************* */
   /*     CONSTRUCTORS & DESTRUCTORS    */
@@ -219,13 +220,14 @@ class Metadata {
   /*         PRIVATE ATTRIBUTES        */
   /* ********************************* */
 
-  /** A map from metadata key to metadata value. */
-  std::map<std::string, MetadataValue> metadata_map_;
+  /** A hash map from metadata key to metadata value. */
+  std::unordered_map<std::string, MetadataValue> metadata_map_;
 
   /**
-   * A vector pointing to all the values in `metadata_map_`. It facilitates
-   * searching metadata from index. Used only for reading metadata (inapplicable
-   * when writing metadata).
+   * A vector pointing to all the values in `metadata_map_`, sorted on the
+   * keys. It facilitates searching metadata from index and is built on the
+   * first such search. Used only for reading metadata (inapplicable when
+   * writing metadata).
    */
   std::vector<std::pair<const std::string*, MetadataValue*>> metadata_index_;
 
@@ -0,0 +1,116 @@
+/**
+ * @file   arena.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements class Arena.
+ */
+
+#include "tiledb/sm/misc/arena.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+namespace tiledb {
+namespace sm {
+
+/** The largest size to which the arena blocks grow. */
+static const uint64_t max_block_size = 1 << 20;
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+Arena::Arena(uint64_t block_size)
+    : allocated_(0)
+    , block_size_(std::max<uint64_t>(block_size, 64))
+    , end_(nullptr)
+    , pos_(nullptr) {
+}
+
+Arena::~Arena() {
+  for (auto& block : blocks_)
+    std::free(block.first);
+}
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+void* Arena::allocate(uint64_t nbytes, uint64_t alignment) {
+  auto aligned = [alignment](char* p) {
+    auto addr = reinterpret_cast<uintptr_t>(p);
+    return reinterpret_cast<char*>((addr + alignment - 1) & ~(alignment - 1));
+  };
+
+  auto p = aligned(pos_);
+  if (pos_ == nullptr || p > end_ || nbytes > (uint64_t)(end_ - p)) {
+    add_block(nbytes + alignment);
+    p = aligned(pos_);
+  }
+
+  pos_ = p + nbytes;
+  allocated_ += nbytes;
+  return p;
+}
+
+uint64_t Arena::allocated() const {
+  return allocated_;
+}
+
+void Arena::reset() {
+  allocated_ = 0;
+  if (blocks_.empty())
+    return;
+
+  // Keep only the largest (i.e., the last) block
+  for (size_t i = 0; i + 1 < blocks_.size(); ++i)
+    std::free(blocks_[i].first);
+  blocks_.front() = blocks_.back();
+  blocks_.resize(1);
+  pos_ = blocks_.front().first;
+  end_ = pos_ + blocks_.front().second;
+}
+
+/* ****************************** */
+/*         PRIVATE METHODS        */
+/* ****************************** */
+
+void Arena::add_block(uint64_t nbytes) {
+  auto size = std::max(block_size_, nbytes);
+  auto block = static_cast<char*>(std::malloc(size));
+  if (block == nullptr)
+    throw std::bad_alloc();
+  blocks_.emplace_back(block, size);
+  pos_ = block;
+  end_ = block + size;
+  block_size_ = std::min<uint64_t>(2 * block_size_, max_block_size);
+}
+
+}  // namespace sm
+}  // namespace tiledb
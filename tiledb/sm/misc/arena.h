@@ -0,0 +1,179 @@
+/**
+ * @file   arena.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file declares class Arena and the STL allocator over it.
+ */
+
+#ifndef TILEDB_ARENA_H
+#define TILEDB_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "tiledb/sm/misc/macros.h"
+
+namespace tiledb {
+namespace sm {
+
+/**
+ * A monotonic allocator for the transient structures of a query. Memory is
+ * carved sequentially out of large blocks and is never freed individually;
+ * it is all released at once by `reset()`, which keeps the largest block,
+ * so that a reused arena eventually serves a query without touching the
+ * system allocator.
+ *
+ * An arena is not thread-safe.
+ */
+class Arena {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /**
+   * Constructor.
+   *
+   * @param block_size The size of the first block. The following blocks
+   *     double in size.
+   */
+  explicit Arena(uint64_t block_size = 4096);
+
+  /** Destructor. */
+  ~Arena();
+
+  DISABLE_COPY_AND_COPY_ASSIGN(Arena);
+  DISABLE_MOVE_AND_MOVE_ASSIGN(Arena);
+
+  /* ********************************* */
+  /*                 API               */
+  /* ********************************* */
+
+  /**
+   * Allocates memory from the arena, throwing `std::bad_alloc` on failure.
+   *
+   * @param nbytes The number of bytes to allocate.
+   * @param alignment The alignment of the memory, a power of two.
+   * @return The allocated memory.
+   */
+  void* allocate(uint64_t nbytes, uint64_t alignment);
+
+  /** Returns the number of bytes allocated since the last reset. */
+  uint64_t allocated() const;
+
+  /**
+   * Releases all the memory allocated from the arena, keeping the largest
+   * block for reuse. All the structures using the arena must be destroyed
+   * beforehand.
+   */
+  void reset();
+
+ private:
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The number of bytes allocated since the last reset. */
+  uint64_t allocated_;
+
+  /** The blocks of the arena with their sizes, the current one last. */
+  std::vector<std::pair<char*, uint64_t>> blocks_;
+
+  /** The size of the next block. */
+  uint64_t block_size_;
+
+  /** The end of the current block. */
+  char* end_;
+
+  /** The next free byte of the current block. */
+  char* pos_;
+
+  /* ********************************* */
+  /*           PRIVATE METHODS         */
+  /* ********************************* */
+
+  /** Adds a block with room for at least `nbytes` bytes. */
+  void add_block(uint64_t nbytes);
+};
+
+/**
+ * An STL allocator over an arena. Deallocation is a no-op, since the memory
+ * is released by resetting the arena.
+ *
+ * @tparam T The allocated type.
+ */
+template <class T>
+class ArenaAllocator {
+ public:
+  typedef T value_type;
+
+  /** Constructor. */
+  explicit ArenaAllocator(Arena* arena) noexcept
+      : arena_(arena) {
+  }
+
+  /** Converting constructor, used by the containers to rebind. */
+  template <class U>
+  ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+      : arena_(other.arena()) {
+  }
+
+  /** Allocates room for `n` objects. */
+  T* allocate(std::size_t n) {
+    return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+  }
+
+  /** No-op. */
+  void deallocate(T*, std::size_t) noexcept {
+  }
+
+  /** Returns the arena. */
+  Arena* arena() const {
+    return arena_;
+  }
+
+ private:
+  /** The arena. */
+  Arena* arena_;
+};
+
+template <class T, class U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+  return a.arena() == b.arena();
+}
+
+template <class T, class U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+  return a.arena() != b.arena();
+}
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_ARENA_H
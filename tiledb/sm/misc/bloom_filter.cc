@@ -0,0 +1,182 @@
+/**
+ * @file   bloom_filter.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements class BloomFilter.
+ */
+
+#include "tiledb/sm/misc/bloom_filter.h"
+#include "tiledb/sm/buffer/buffer.h"
+#include "tiledb/sm/buffer/const_buffer.h"
+#include "tiledb/sm/misc/logger.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace tiledb {
+namespace sm {
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+BloomFilter::BloomFilter()
+    : probe_num_(0) {
+}
+
+BloomFilter::BloomFilter(uint64_t hash_num, uint32_t bits_per_hash) {
+  // The optimal number of probes is the number of bits per hash times ln(2)
+  probe_num_ = (uint32_t)std::lround(bits_per_hash * std::log(2.0));
+  probe_num_ = std::min(std::max(probe_num_, 1u), 30u);
+  auto bit_num = std::max<uint64_t>(hash_num * bits_per_hash, 64);
+  words_.resize((bit_num + 63) / 64, 0);
+}
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+void BloomFilter::add(uint64_t hash) {
+  if (words_.empty())
+    return;
+
+  uint64_t bit_num = words_.size() * 64;
+  uint64_t h2 = mix(hash) | 1;
+  for (uint32_t i = 0; i < probe_num_; ++i) {
+    uint64_t bit = (hash + i * h2) % bit_num;
+    words_[bit / 64] |= (uint64_t)1 << (bit % 64);
+  }
+}
+
+bool BloomFilter::empty() const {
+  return words_.empty();
+}
+
+bool BloomFilter::may_contain(uint64_t hash) const {
+  if (words_.empty())
+    return true;
+
+  uint64_t bit_num = words_.size() * 64;
+  uint64_t h2 = mix(hash) | 1;
+  for (uint32_t i = 0; i < probe_num_; ++i) {
+    uint64_t bit = (hash + i * h2) % bit_num;
+    if ((words_[bit / 64] & ((uint64_t)1 << (bit % 64))) == 0)
+      return false;
+  }
+
+  return true;
+}
+
+uint64_t BloomFilter::size() const {
+  return words_.size() * sizeof(uint64_t);
+}
+
+// ===== FORMAT =====
+// probe_num (uint32_t)
+// word_num (uint64_t)
+// word_#1 (uint64_t)
+// word_#2 (uint64_t)
+// ...
+Status BloomFilter::serialize(Buffer* buff) const {
+  uint64_t word_num = words_.size();
+  RETURN_NOT_OK(buff->write(&probe_num_, sizeof(uint32_t)));
+  RETURN_NOT_OK(buff->write(&word_num, sizeof(uint64_t)));
+  if (word_num > 0)
+    RETURN_NOT_OK(buff->write(&words_[0], word_num * sizeof(uint64_t)));
+
+  return Status::Ok();
+}
+
+Status BloomFilter::deserialize(ConstBuffer* cbuff) {
+  uint64_t word_num = 0;
+  RETURN_NOT_OK(cbuff->read(&probe_num_, sizeof(uint32_t)));
+  RETURN_NOT_OK(cbuff->read(&word_num, sizeof(uint64_t)));
+  if (word_num * sizeof(uint64_t) > cbuff->nbytes_left_to_read())
+    return LOG_STATUS(Status::Error(
+        "Cannot deserialize bloom filter; Invalid number of words"));
+
+  words_.resize(word_num);
+  if (word_num > 0)
+    RETURN_NOT_OK(cbuff->read(&words_[0], word_num * sizeof(uint64_t)));
+
+  return Status::Ok();
+}
+
+template <class T>
+uint64_t BloomFilter::hash_coords(const T* coords, unsigned dim_num) {
+  // FNV-1a over the coordinate bytes
+  uint64_t hash = 14695981039346656037ULL;
+  for (unsigned d = 0; d < dim_num; ++d) {
+    T c = (coords[d] == 0) ? (T)0 : coords[d];
+    auto bytes = (const unsigned char*)&c;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+      hash ^= bytes[i];
+      hash *= 1099511628211ULL;
+    }
+  }
+
+  return mix(hash);
+}
+
+/* ****************************** */
+/*         PRIVATE METHODS        */
+/* ****************************** */
+
+uint64_t BloomFilter::mix(uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+// Explicit template instantiations
+template uint64_t BloomFilter::hash_coords<int8_t>(
+    const int8_t* coords, unsigned dim_num);
+template uint64_t BloomFilter::hash_coords<uint8_t>(
+    const uint8_t* coords, unsigned dim_num);
+template uint64_t BloomFilter::hash_coords<int16_t>(
+    const int16_t* coords, unsigned dim_num);
+template uint64_t BloomFilter::hash_coords<uint16_t>(
+    const uint16_t* coords, unsigned dim_num);
+template uint64_t BloomFilter::hash_coords<int32_t>(
+    const int32_t* coords, unsigned dim_num);
+template uint64_t BloomFilter::hash_coords<uint32_t>(
+    const uint32_t* coords, unsigned dim_num);
+template uint64_t BloomFilter::hash_coords<int64_t>(
+    const int64_t* coords, unsigned dim_num);
+template uint64_t BloomFilter::hash_coords<uint64_t>(
+    const uint64_t* coords, unsigned dim_num);
+template uint64_t BloomFilter::hash_coords<float>(
+    const float* coords, unsigned dim_num);
+template uint64_t BloomFilter::hash_coords<double>(
+    const double* coords, unsigned dim_num);
+
+}  // namespace sm
+}  // namespace tiledb
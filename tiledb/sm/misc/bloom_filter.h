@@ -0,0 +1,130 @@
+/**
+ * @file   bloom_filter.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class BloomFilter.
+ */
+
+#ifndef TILEDB_BLOOM_FILTER_H
+#define TILEDB_BLOOM_FILTER_H
+
+#include <vector>
+
+#include "tiledb/sm/misc/status.h"
+
+namespace tiledb {
+namespace sm {
+
+class Buffer;
+class ConstBuffer;
+
+/**
+ * A bloom filter over 64-bit hashes. It answers whether a hash may have
+ * been added, with no false negatives and a false positive rate set by the
+ * number of bits per added hash (about 1% for 10 bits).
+ *
+ * The hashes and the serialized form are platform-independent, so that a
+ * filter may be persisted and probed by another process.
+ */
+class BloomFilter {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /** Constructor. The filter is empty and contains no hash. */
+  BloomFilter();
+
+  /**
+   * Constructor.
+   *
+   * @param hash_num The expected number of hashes to be added.
+   * @param bits_per_hash The number of filter bits per expected hash.
+   */
+  BloomFilter(uint64_t hash_num, uint32_t bits_per_hash);
+
+  /* ********************************* */
+  /*                 API               */
+  /* ********************************* */
+
+  /** Adds a hash to the filter. */
+  void add(uint64_t hash);
+
+  /** Returns `true` if the filter has no bits, i.e., it is not built. */
+  bool empty() const;
+
+  /**
+   * Returns `false` if the hash was definitely not added, and `true` if it
+   * may have been added.
+   */
+  bool may_contain(uint64_t hash) const;
+
+  /** Returns the size of the filter bits in bytes. */
+  uint64_t size() const;
+
+  /** Serializes the filter to the input buffer. */
+  Status serialize(Buffer* buff) const;
+
+  /** Deserializes the filter from the input buffer. */
+  Status deserialize(ConstBuffer* cbuff);
+
+  /**
+   * Returns the hash of a tuple of coordinates. Zero coordinates are
+   * normalized, so that the negative and positive floating point zeros
+   * have the same hash.
+   *
+   * @tparam T The coordinates type.
+   * @param coords The coordinates, one per dimension.
+   * @param dim_num The number of dimensions.
+   */
+  template <class T>
+  static uint64_t hash_coords(const T* coords, unsigned dim_num);
+
+ private:
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The number of bits set per hash. */
+  uint32_t probe_num_;
+
+  /** The filter bits. */
+  std::vector<uint64_t> words_;
+
+  /* ********************************* */
+  /*           PRIVATE METHODS         */
+  /* ********************************* */
+
+  /** Mixes the bits of the input value (the splitmix64 finalizer). */
+  static uint64_t mix(uint64_t x);
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_BLOOM_FILTER_H
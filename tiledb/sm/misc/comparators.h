@@ -191,7 +191,17 @@ class GlobalCmp {
     }
 
     // Compare cell order
-    if (cell_order_ == Layout::ROW_MAJOR) {
+    if (cell_order_ == Layout::HILBERT) {
+      auto ha = domain_->hilbert_value(a);
+      auto hb = domain_->hilbert_value(b);
+      if (ha < hb)
+        return true;
+      if (ha > hb)
+        return false;
+      // else same Hilbert value --> break ties in row-major order
+    }
+
+    if (cell_order_ != Layout::COL_MAJOR) {
       for (unsigned d = 0; d < dim_num_; ++d) {
         auto res = domain_->cell_order_cmp(d, a.coord(d), b.coord(d));
 
@@ -202,7 +212,6 @@ class GlobalCmp {
         // else same tile on dimension d --> continue
       }
     } else {  // COL_MAJOR
-      assert(cell_order_ == Layout::COL_MAJOR);
       for (unsigned d = dim_num_ - 1;; --d) {
         auto res = domain_->cell_order_cmp(d, a.coord(d), b.coord(d));
 
@@ -259,6 +268,222 @@ class GlobalCmp {
   const std::vector<const void*>* coord_buffs_;
 };
 
+/**
+ * Wrapper of comparison function for sorting coords on the global order
+ * of a domain with a Hilbert cell order, given the precomputed Hilbert
+ * values of the coordinates.
+ */
+class HilbertCmp {
+ public:
+  /**
+   * Constructor.
+   *
+   * @param domain The array domain.
+   * @param coord_buffs The coordinate buffers, one per dimension, containing
+   *     the actual values, used in positional comparisons.
+   * @param hilbert_values The Hilbert values of the coordinates, one per
+   *     cell position.
+   */
+  HilbertCmp(
+      const Domain* domain,
+      const std::vector<const void*>* coord_buffs,
+      const std::vector<uint64_t>* hilbert_values)
+      : domain_(domain)
+      , coord_buffs_(coord_buffs)
+      , hilbert_values_(hilbert_values) {
+  }
+
+  /**
+   * Positional comparison operator.
+   *
+   * @param a The first cell position.
+   * @param b The second cell position.
+   * @return `true` if cell at `a` across all coordinate buffers precedes
+   *     cell at `b`, and `false` otherwise.
+   */
+  bool operator()(uint64_t a, uint64_t b) const {
+    auto tile_cmp = domain_->tile_order_cmp(*coord_buffs_, a, b);
+
+    if (tile_cmp == -1)
+      return true;
+    if (tile_cmp == 1)
+      return false;
+    // else tile_cmp == 0 --> continue
+
+    // Compare Hilbert values
+    auto ha = (*hilbert_values_)[a];
+    auto hb = (*hilbert_values_)[b];
+    if (ha != hb)
+      return ha < hb;
+
+    // Break ties in row-major order
+    auto cell_cmp = domain_->cell_order_cmp(*coord_buffs_, a, b);
+    return cell_cmp == -1;
+  }
+
+ private:
+  /** The domain. */
+  const Domain* domain_;
+  /**
+   * The coordinate buffers, one per dimension, sorted in the order the
+   * dimensions are defined in the array schema.
+   */
+  const std::vector<const void*>* coord_buffs_;
+  /** The Hilbert values of the coordinates, one per cell position. */
+  const std::vector<uint64_t>* hilbert_values_;
+};
+
+/**
+ * Wrapper of comparison function for sorting coords of type `T` on the
+ * row-major (or, if `ColMajor` is `true`, col-major) order of a domain with
+ * `N` dimensions. With the type, the number of dimensions and the layout
+ * fixed at compile time, the loop over the dimensions unrolls and the sort
+ * inlines the comparisons, which `RowCmp` and `ColCmp` dispatch to the
+ * per-dimension comparison functions of the domain.
+ */
+template <class T, unsigned N, bool ColMajor>
+class TypedCellOrderCmp {
+ public:
+  /**
+   * Comparison operator.
+   *
+   * @param a The first coordinate.
+   * @param b The second coordinate.
+   * @return `true` if `a` precedes `b` and `false` otherwise.
+   */
+  bool operator()(const ResultCoords& a, const ResultCoords& b) const {
+    for (unsigned i = 0; i < N; ++i) {
+      const unsigned d = ColMajor ? N - 1 - i : i;
+      const T ca = *static_cast<const T*>(a.coord(d));
+      const T cb = *static_cast<const T*>(b.coord(d));
+      if (ca < cb)
+        return true;
+      if (cb < ca)
+        return false;
+      // else same coordinate on dimension d --> continue
+    }
+
+    return false;
+  }
+};
+
+/**
+ * Wrapper of comparison function for sorting coords of type `T` on the
+ * global order of a domain with `N` dimensions and a row-major or
+ * col-major cell order. It is the counterpart of `GlobalCmp` with the
+ * type and number of dimensions fixed at compile time, and the domain
+ * lows and tile extents copied in, so that the sort inlines the tile and
+ * cell comparisons.
+ */
+template <class T, unsigned N>
+class TypedGlobalCmp {
+ public:
+  /**
+   * Constructor.
+   *
+   * @param domain The array domain.
+   * @param coord_buffs The coordinate buffers, one per dimension, containing
+   *     the actual values, used in positional comparisons.
+   */
+  TypedGlobalCmp(
+      const Domain* domain,
+      const std::vector<const void*>* coord_buffs = nullptr) {
+    assert(domain->dim_num() == N);
+    assert(domain->cell_order() != Layout::HILBERT);
+    tile_col_major_ = domain->tile_order() == Layout::COL_MAJOR;
+    cell_col_major_ = domain->cell_order() == Layout::COL_MAJOR;
+    for (unsigned d = 0; d < N; ++d) {
+      auto dim = domain->dimension(d);
+      auto tile_extent = static_cast<const T*>(dim->tile_extent());
+      low_[d] = static_cast<const T*>(dim->domain())[0];
+      has_tile_extent_[d] = tile_extent != nullptr;
+      tile_extent_[d] = has_tile_extent_[d] ? *tile_extent : T();
+      buffs_[d] = (coord_buffs == nullptr) ?
+                      nullptr :
+                      static_cast<const T*>((*coord_buffs)[d]);
+    }
+  }
+
+  /**
+   * Comparison operator for a vector of `ResultCoords`.
+   *
+   * @param a The first coordinate.
+   * @param b The second coordinate.
+   * @return `true` if `a` precedes `b` and `false` otherwise.
+   */
+  bool operator()(const ResultCoords& a, const ResultCoords& b) const {
+    T ca[N], cb[N];
+    for (unsigned d = 0; d < N; ++d) {
+      ca[d] = *static_cast<const T*>(a.coord(d));
+      cb[d] = *static_cast<const T*>(b.coord(d));
+    }
+
+    return precedes(ca, cb);
+  }
+
+  /**
+   * Positional comparison operator.
+   *
+   * @param a The first cell position.
+   * @param b The second cell position.
+   * @return `true` if cell at `a` across all coordinate buffers precedes
+   *     cell at `b`, and `false` otherwise.
+   */
+  bool operator()(uint64_t a, uint64_t b) const {
+    assert(buffs_[0] != nullptr);
+    T ca[N], cb[N];
+    for (unsigned d = 0; d < N; ++d) {
+      ca[d] = buffs_[d][a];
+      cb[d] = buffs_[d][b];
+    }
+
+    return precedes(ca, cb);
+  }
+
+ private:
+  /** `true` if the tile order is col-major. */
+  bool tile_col_major_;
+  /** `true` if the cell order is col-major. */
+  bool cell_col_major_;
+  /** The domain low of each dimension. */
+  T low_[N];
+  /** The tile extent of each dimension. */
+  T tile_extent_[N];
+  /** `true` for the dimensions with a tile extent. */
+  bool has_tile_extent_[N];
+  /** The coordinate buffers, one per dimension (if set). */
+  const T* buffs_[N];
+
+  /** Returns `true` if coordinates `ca` precede `cb` in the global order. */
+  bool precedes(const T* ca, const T* cb) const {
+    // Compare tile order first
+    for (unsigned i = 0; i < N; ++i) {
+      const unsigned d = tile_col_major_ ? N - 1 - i : i;
+      if (!has_tile_extent_[d])
+        continue;
+      const T ta = (T)((ca[d] - low_[d]) / tile_extent_[d]);
+      const T tb = (T)((cb[d] - low_[d]) / tile_extent_[d]);
+      if (ta < tb)
+        return true;
+      if (tb < ta)
+        return false;
+      // else same tile on dimension d --> continue
+    }
+
+    // Compare cell order
+    for (unsigned i = 0; i < N; ++i) {
+      const unsigned d = cell_col_major_ ? N - 1 - i : i;
+      if (ca[d] < cb[d])
+        return true;
+      if (cb[d] < ca[d])
+        return false;
+      // else same coordinate on dimension d --> continue
+    }
+
+    return false;
+  }
+};
+
 }  // namespace sm
 }  // namespace tiledb
 
@@ -65,18 +65,52 @@ const double multi_range_reduction_in_split = 0.3;
 /** Amplification factor for the result size estimation. */
 const double est_result_size_amplification = 1.0;
 
+/**
+ * The maximum number of overlapping tiles whose MBRs are inspected to
+ * balance the split of a range by the partitioner.
+ */
+const uint64_t partition_split_max_tiles = 1 << 16;
+
 /** Default fanout for RTrees. */
 const unsigned rtree_fanout = 10;
 
+/**
+ * The number of tiles covered by each page of the tile offsets and
+ * variable tile sizes stored in the fragment metadata file.
+ */
+const uint64_t tile_offsets_page_tile_num = 8192;
+
 /** The array schema file name. */
 const std::string array_schema_filename = "__array_schema.tdb";
 
 /** The array metadata folder name. */
 const std::string array_metadata_folder_name = "__meta";
 
+/** The folder of the downsampled pyramid levels of a dense array. */
+const std::string pyramid_folder_name = "__pyramid";
+
+/**
+ * The folder of a fragment holding the parts written by the producers of a
+ * parallel global order write, until they are stitched.
+ */
+const std::string fragment_parts_folder_name = "__parts";
+
+/** The consolidated fragment metadata file name. */
+const std::string consolidated_fragment_metadata_filename =
+    "__fragment_metadata_consolidated.tdb";
+
+/** The array manifest file name. */
+const std::string array_manifest_filename = "__array_manifest.tdb";
+
+/** Suffix of the files listing the fragments a consolidation superseded. */
+const std::string vacuum_file_suffix = ".vac";
+
 /** The fragment metadata file name. */
 const std::string fragment_metadata_filename = "__fragment_metadata.tdb";
 
+/** The name of the file holding all the tiles of a packed fragment. */
+const std::string packed_fragment_filename = "__packed.tdb";
+
 /** The default tile capacity. */
 const uint64_t capacity = 10000;
 
@@ -267,6 +301,15 @@ const std::string filter_byteshuffle_str = "BYTESHUFFLE";
 /** String describing FILTER_POSITIVE_DELTA. */
 const std::string filter_positive_delta_str = "POSITIVE_DELTA";
 
+/** String describing FILTER_DICTIONARY. */
+const std::string filter_dictionary_str = "DICTIONARY";
+
+/** String describing FILTER_FLOAT_XOR. */
+const std::string filter_float_xor_str = "FLOAT_XOR";
+
+/** String describing FILTER_FRAME_OF_REFERENCE. */
+const std::string filter_frame_of_reference_str = "FRAME_OF_REFERENCE";
+
 /** The string representation for FilterOption type compression_level. */
 const std::string filter_option_compression_level_str = "COMPRESSION_LEVEL";
 
@@ -279,6 +322,25 @@ const std::string filter_option_bit_width_max_window_str =
 const std::string filter_option_positive_delta_max_window_str =
     "POSITIVE_DELTA_MAX_WINDOW";
 
+/**
+ * The string representation for FilterOption type
+ * compression_dictionary_size.
+ */
+const std::string filter_option_compression_dictionary_size_str =
+    "COMPRESSION_DICTIONARY_SIZE";
+
+/**
+ * The string representation for FilterOption type compression_byteshuffle.
+ */
+const std::string filter_option_compression_byteshuffle_str =
+    "COMPRESSION_BYTESHUFFLE";
+
+/**
+ * The string representation for FilterOption type frame_of_reference_delta.
+ */
+const std::string filter_option_frame_of_reference_delta_str =
+    "FRAME_OF_REFERENCE_DELTA";
+
 /** The string representation for type int32. */
 const std::string int32_str = "INT32";
 
@@ -390,6 +452,9 @@ const std::string global_order_str = "global-order";
 /** The string representation for the unordered layout. */
 const std::string unordered_str = "unordered";
 
+/** The string representation for the Hilbert layout. */
+const std::string hilbert_str = "hilbert";
+
 /** The string representation of null. */
 const std::string null_str = "null";
 
@@ -428,11 +493,36 @@ const int32_t library_version[3] = {
     TILEDB_VERSION_MAJOR, TILEDB_VERSION_MINOR, TILEDB_VERSION_PATCH};
 
 /** The TileDB serialization format version number. */
-const uint32_t format_version = 5;
+const uint32_t format_version = 9;
 
 /** The maximum size of a tile chunk (unit of compression) in bytes. */
 const uint64_t max_tile_chunk_size = 64 * 1024;
 
+/**
+ * The min size of a tile chunk with the automatic chunk size, for compressors
+ * that gain from long match windows (zstd, gzip, bzip2).
+ */
+const uint64_t auto_tile_chunk_min_size_large_window = 256 * 1024;
+
+/** The max size of a tile chunk with the automatic chunk size. */
+const uint64_t auto_tile_chunk_max_size = 1024 * 1024;
+
+/**
+ * The size of the blocks that a byteshuffling compression filter shuffles and
+ * compresses one at a time, sized so that a block and its shuffled copy stay
+ * in cache.
+ */
+const uint64_t compression_byteshuffle_block_size = 128 * 1024;
+
+/** The size of each sample a compression dictionary is trained from. */
+const uint64_t dictionary_sample_size = 4 * 1024;
+
+/**
+ * The max number of tile bytes sampled to train a compression dictionary, as
+ * a multiple of the dictionary size.
+ */
+const uint64_t dictionary_training_ratio = 100;
+
 /** The default attribute name prefix. */
 const std::string default_attr_name = "__attr";
 
@@ -445,6 +535,49 @@ const unsigned int s3_max_attempts = 1000;
 /** Milliseconds of wait time between S3 attempts. */
 const unsigned int s3_attempt_sleep_ms = 100;
 
+/** Maximum number of keys in a single S3 multi-object delete request. */
+const uint64_t s3_max_delete_objects = 1000;
+
+/** Maximum size of an object copied with a single S3 copy request. */
+const uint64_t s3_max_copy_object_size = 5ULL * 1024 * 1024 * 1024;
+
+/** Size of each part of an S3 multipart copy. */
+const uint64_t s3_copy_part_size = 1024 * 1024 * 1024;
+
+/** Maximum number of io_uring submission queue entries per batch. */
+const unsigned int io_uring_queue_depth = 256;
+
+/** Maximum number of overlapped reads in flight on Windows. */
+const unsigned int overlapped_io_queue_depth = 64;
+
+/**
+ * Maximum number of bytes in a single Windows read or unbuffered write
+ * request. This is a multiple of `direct_io_alignment`.
+ */
+const uint64_t max_win_io_bytes = uint64_t(1) << 30;
+
+/** The file offset and buffer alignment used for direct I/O. */
+const uint64_t direct_io_alignment = 4096;
+
+/**
+ * The alignment of the buffers allocated by `Buffer`, which suits aligned
+ * SIMD loads. Buffers of at least `direct_io_min_buffer_size` bytes are
+ * aligned to `direct_io_alignment` instead.
+ */
+const uint64_t buffer_alignment = 64;
+
+/** The size from which `Buffer` allocations are aligned for direct I/O. */
+const uint64_t direct_io_min_buffer_size = 65536;
+
+/** The maximum size of a staging buffer for direct I/O. */
+const uint64_t direct_io_staging_size = 4 * 1024 * 1024;
+
+/** The minimum number of observed reads for a read cost estimate. */
+const uint64_t read_cost_model_min_samples = 8;
+
+/** The decay factor of past observations in the read cost model. */
+const double read_cost_model_decay = 0.98;
+
 /** An allocation tag used for logging. */
 const std::string s3_allocation_tag = "TileDB";
 
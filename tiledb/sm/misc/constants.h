@@ -56,9 +56,21 @@ extern const double multi_range_reduction_in_split;
 /** Amplification factor for the result size estimation. */
 extern const double est_result_size_amplification;
 
+/**
+ * The maximum number of overlapping tiles whose MBRs are inspected to
+ * balance the split of a range by the partitioner.
+ */
+extern const uint64_t partition_split_max_tiles;
+
 /** Default fanout for RTrees. */
 extern const unsigned rtree_fanout;
 
+/**
+ * The number of tiles covered by each page of the tile offsets and
+ * variable tile sizes stored in the fragment metadata file.
+ */
+extern const uint64_t tile_offsets_page_tile_num;
+
 /** The object filelock name. */
 extern const std::string filelock_name;
 
@@ -68,6 +80,24 @@ extern const std::string array_schema_filename;
 /** The array metadata folder name. */
 extern const std::string array_metadata_folder_name;
 
+/** The folder of the downsampled pyramid levels of a dense array. */
+extern const std::string pyramid_folder_name;
+
+/**
+ * The folder of a fragment holding the parts written by the producers of a
+ * parallel global order write, until they are stitched.
+ */
+extern const std::string fragment_parts_folder_name;
+
+/** The consolidated fragment metadata file name. */
+extern const std::string consolidated_fragment_metadata_filename;
+
+/** The array manifest file name. */
+extern const std::string array_manifest_filename;
+
+/** Suffix of the files listing the fragments a consolidation superseded. */
+extern const std::string vacuum_file_suffix;
+
 /** The default tile capacity. */
 extern const uint64_t capacity;
 
@@ -158,6 +188,9 @@ extern const std::string file_suffix;
 /** The fragment metadata file name. */
 extern const std::string fragment_metadata_filename;
 
+/** The name of the file holding all the tiles of a packed fragment. */
+extern const std::string packed_fragment_filename;
+
 /** Default datatype for a generic tile. */
 extern const Datatype generic_tile_datatype;
 
@@ -257,6 +290,15 @@ extern const std::string filter_byteshuffle_str;
 /** String describing FILTER_POSITIVE_DELTA. */
 extern const std::string filter_positive_delta_str;
 
+/** String describing FILTER_DICTIONARY. */
+extern const std::string filter_dictionary_str;
+
+/** String describing FILTER_FLOAT_XOR. */
+extern const std::string filter_float_xor_str;
+
+/** String describing FILTER_FRAME_OF_REFERENCE. */
+extern const std::string filter_frame_of_reference_str;
+
 /** The string representation for FilterOption type compression_level. */
 extern const std::string filter_option_compression_level_str;
 
@@ -267,6 +309,22 @@ extern const std::string filter_option_bit_width_max_window_str;
  */
 extern const std::string filter_option_positive_delta_max_window_str;
 
+/**
+ * The string representation for FilterOption type
+ * compression_dictionary_size.
+ */
+extern const std::string filter_option_compression_dictionary_size_str;
+
+/**
+ * The string representation for FilterOption type compression_byteshuffle.
+ */
+extern const std::string filter_option_compression_byteshuffle_str;
+
+/**
+ * The string representation for FilterOption type frame_of_reference_delta.
+ */
+extern const std::string filter_option_frame_of_reference_delta_str;
+
 /** The string representation for type int32. */
 extern const std::string int32_str;
 
@@ -378,6 +436,9 @@ extern const std::string global_order_str;
 /** The string representation for the unordered layout. */
 extern const std::string unordered_str;
 
+/** The string representation for the Hilbert layout. */
+extern const std::string hilbert_str;
+
 /** The string representation of null. */
 extern const std::string null_str;
 
@@ -420,6 +481,31 @@ extern const uint32_t format_version;
 /** The maximum size of a tile chunk (unit of compression) in bytes. */
 extern const uint64_t max_tile_chunk_size;
 
+/**
+ * The min size of a tile chunk with the automatic chunk size, for compressors
+ * that gain from long match windows (zstd, gzip, bzip2).
+ */
+extern const uint64_t auto_tile_chunk_min_size_large_window;
+
+/** The max size of a tile chunk with the automatic chunk size. */
+extern const uint64_t auto_tile_chunk_max_size;
+
+/**
+ * The size of the blocks that a byteshuffling compression filter shuffles and
+ * compresses one at a time, sized so that a block and its shuffled copy stay
+ * in cache.
+ */
+extern const uint64_t compression_byteshuffle_block_size;
+
+/** The size of each sample a compression dictionary is trained from. */
+extern const uint64_t dictionary_sample_size;
+
+/**
+ * The max number of tile bytes sampled to train a compression dictionary, as
+ * a multiple of the dictionary size.
+ */
+extern const uint64_t dictionary_training_ratio;
+
 /** The default attribute name prefix. */
 extern const std::string default_attr_name;
 
@@ -432,6 +518,49 @@ extern const unsigned int s3_max_attempts;
 /** Milliseconds of wait time between S3 attempts. */
 extern const unsigned int s3_attempt_sleep_ms;
 
+/** Maximum number of keys in a single S3 multi-object delete request. */
+extern const uint64_t s3_max_delete_objects;
+
+/** Maximum size of an object copied with a single S3 copy request. */
+extern const uint64_t s3_max_copy_object_size;
+
+/** Size of each part of an S3 multipart copy. */
+extern const uint64_t s3_copy_part_size;
+
+/** Maximum number of io_uring submission queue entries per batch. */
+extern const unsigned int io_uring_queue_depth;
+
+/** Maximum number of overlapped reads in flight on Windows. */
+extern const unsigned int overlapped_io_queue_depth;
+
+/**
+ * Maximum number of bytes in a single Windows read or unbuffered write
+ * request. This is a multiple of `direct_io_alignment`.
+ */
+extern const uint64_t max_win_io_bytes;
+
+/** The file offset and buffer alignment used for direct I/O. */
+extern const uint64_t direct_io_alignment;
+
+/**
+ * The alignment of the buffers allocated by `Buffer`, which suits aligned
+ * SIMD loads. Buffers of at least `direct_io_min_buffer_size` bytes are
+ * aligned to `direct_io_alignment` instead.
+ */
+extern const uint64_t buffer_alignment;
+
+/** The size from which `Buffer` allocations are aligned for direct I/O. */
+extern const uint64_t direct_io_min_buffer_size;
+
+/** The maximum size of a staging buffer for direct I/O. */
+extern const uint64_t direct_io_staging_size;
+
+/** The minimum number of observed reads for a read cost estimate. */
+extern const uint64_t read_cost_model_min_samples;
+
+/** The decay factor of past observations in the read cost model. */
+extern const double read_cost_model_decay;
+
 /** An allocation tag used for logging. */
 extern const std::string s3_allocation_tag;
 
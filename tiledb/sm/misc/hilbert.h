@@ -0,0 +1,180 @@
+/**
+ * @file   hilbert.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2017-2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class Hilbert.
+ */
+
+#ifndef TILEDB_HILBERT_H
+#define TILEDB_HILBERT_H
+
+#include <cinttypes>
+
+namespace tiledb {
+namespace sm {
+
+/**
+ * Maps points of a discrete multi-dimensional space onto their positions
+ * along a Hilbert curve that covers the space. Each dimension is
+ * discretized into ``2^bits`` values, where ``bits`` is the largest number
+ * such that the Hilbert value of a point fits in 64 bits.
+ *
+ * The implementation follows J. Skilling, "Programming the Hilbert curve",
+ * AIP Conference Proceedings 707, 2004.
+ */
+class Hilbert {
+ public:
+  /* ********************************* */
+  /*         PUBLIC ATTRIBUTES         */
+  /* ********************************* */
+
+  /**
+   * The maximum number of dimensions for which every dimension gets at
+   * least one bit of the 64-bit Hilbert value.
+   */
+  static const unsigned max_dim_num = 64;
+
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /** Constructor. */
+  Hilbert()
+      : Hilbert(1) {
+  }
+
+  /**
+   * Constructor.
+   *
+   * @param dim_num The number of dimensions.
+   */
+  explicit Hilbert(unsigned dim_num)
+      : dim_num_(dim_num) {
+    bits_ = (dim_num == 0 || dim_num > max_dim_num) ? 0 : 64 / dim_num;
+    max_bucket_ = (bits_ == 64) ? UINT64_MAX :
+                                  ((bits_ == 0) ? 0 : (1ULL << bits_) - 1);
+  }
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /** Returns the number of bits each dimension is discretized into. */
+  unsigned bits() const {
+    return bits_;
+  }
+
+  /** Returns the largest discrete value on each dimension. */
+  uint64_t max_bucket() const {
+    return max_bucket_;
+  }
+
+  /**
+   * Returns the Hilbert value of the input point.
+   *
+   * @param coords The discrete coordinates of the point, one per dimension,
+   *     each in ``[0, max_bucket()]``. The function uses the array as
+   *     scratch space, so its contents are undefined on return.
+   * @return The position of the point along the Hilbert curve.
+   */
+  uint64_t coords_to_hilbert(uint64_t* coords) const {
+    if (bits_ == 0)
+      return 0;
+    if (dim_num_ == 1)
+      return coords[0];
+
+    axes_to_transpose(coords);
+
+    // Interleave the bits of the transposed coordinates, most significant
+    // bits first
+    uint64_t h = 0;
+    for (int b = (int)bits_ - 1; b >= 0; --b) {
+      for (unsigned d = 0; d < dim_num_; ++d)
+        h = (h << 1) | ((coords[d] >> b) & 1);
+    }
+
+    return h;
+  }
+
+ private:
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The number of dimensions. */
+  unsigned dim_num_;
+
+  /** The number of bits each dimension is discretized into. */
+  unsigned bits_;
+
+  /** The largest discrete value on each dimension. */
+  uint64_t max_bucket_;
+
+  /* ********************************* */
+  /*          PRIVATE METHODS          */
+  /* ********************************* */
+
+  /**
+   * Converts the input coordinates in place into the "transposed" form of
+   * their Hilbert value, i.e., the Hilbert value is obtained by reading
+   * the bits of the coordinates one bit plane at a time.
+   */
+  void axes_to_transpose(uint64_t* x) const {
+    uint64_t m = 1ULL << (bits_ - 1);
+
+    // Inverse undo
+    for (uint64_t q = m; q > 1; q >>= 1) {
+      uint64_t p = q - 1;
+      for (unsigned d = 0; d < dim_num_; ++d) {
+        if (x[d] & q) {
+          x[0] ^= p;  // Invert
+        } else {
+          uint64_t t = (x[0] ^ x[d]) & p;  // Exchange
+          x[0] ^= t;
+          x[d] ^= t;
+        }
+      }
+    }
+
+    // Gray encode
+    for (unsigned d = 1; d < dim_num_; ++d)
+      x[d] ^= x[d - 1];
+    uint64_t t = 0;
+    for (uint64_t q = m; q > 1; q >>= 1) {
+      if (x[dim_num_ - 1] & q)
+        t ^= q - 1;
+    }
+    for (unsigned d = 0; d < dim_num_; ++d)
+      x[d] ^= t;
+  }
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_HILBERT_H
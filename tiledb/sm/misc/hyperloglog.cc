@@ -0,0 +1,163 @@
+/**
+ * @file   hyperloglog.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements class HyperLogLog.
+ */
+
+#include "tiledb/sm/misc/hyperloglog.h"
+#include "tiledb/sm/buffer/buffer.h"
+#include "tiledb/sm/buffer/const_buffer.h"
+#include "tiledb/sm/misc/logger.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace tiledb {
+namespace sm {
+
+namespace {
+
+/** Returns the number of leading zero bits of a non-zero value. */
+inline unsigned leading_zeros(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+  return (unsigned)__builtin_clzll(x);
+#else
+  unsigned n = 0;
+  for (; (x & (uint64_t(1) << 63)) == 0; x <<= 1)
+    ++n;
+  return n;
+#endif
+}
+
+}  // namespace
+
+const unsigned HyperLogLog::PRECISION;
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+HyperLogLog::HyperLogLog()
+    : registers_(uint64_t(1) << PRECISION, 0) {
+}
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+void HyperLogLog::add(uint64_t hash) {
+  auto idx = hash >> (64 - PRECISION);
+  auto rest = hash << PRECISION;
+  auto rank = (uint8_t)(
+      (rest == 0) ? (64 - PRECISION + 1) : (leading_zeros(rest) + 1));
+  registers_[idx] = std::max(registers_[idx], rank);
+}
+
+uint64_t HyperLogLog::estimate() const {
+  const double m = (double)registers_.size();
+  double sum = 0;
+  uint64_t zero_num = 0;
+  for (auto r : registers_) {
+    sum += std::ldexp(1.0, -(int)r);
+    zero_num += (r == 0);
+  }
+
+  // The raw estimate is biased for small cardinalities, where linear
+  // counting over the empty registers is more accurate
+  const double alpha = 0.7213 / (1.0 + 1.079 / m);
+  double estimate = alpha * m * m / sum;
+  if (estimate <= 2.5 * m && zero_num != 0)
+    estimate = m * std::log(m / (double)zero_num);
+
+  return (uint64_t)std::llround(estimate);
+}
+
+void HyperLogLog::merge(const HyperLogLog& other) {
+  for (size_t i = 0; i < registers_.size(); ++i)
+    registers_[i] = std::max(registers_[i], other.registers_[i]);
+}
+
+// ===== FORMAT =====
+// precision (uint8_t)
+// register_#1 (uint8_t)
+// register_#2 (uint8_t)
+// ...
+Status HyperLogLog::serialize(Buffer* buff) const {
+  auto precision = (uint8_t)PRECISION;
+  RETURN_NOT_OK(buff->write(&precision, sizeof(uint8_t)));
+  RETURN_NOT_OK(buff->write(&registers_[0], registers_.size()));
+
+  return Status::Ok();
+}
+
+Status HyperLogLog::deserialize(ConstBuffer* cbuff) {
+  uint8_t precision = 0;
+  RETURN_NOT_OK(cbuff->read(&precision, sizeof(uint8_t)));
+  if (precision != PRECISION)
+    return LOG_STATUS(Status::Error(
+        "Cannot deserialize HyperLogLog sketch; Unsupported precision"));
+
+  RETURN_NOT_OK(cbuff->read(&registers_[0], registers_.size()));
+
+  return Status::Ok();
+}
+
+template <class T>
+uint64_t HyperLogLog::hash_value(T value) {
+  // FNV-1a over the value bytes, then the splitmix64 finalizer
+  T v = (value == 0) ? (T)0 : value;
+  auto bytes = (const unsigned char*)&v;
+  uint64_t hash = 14695981039346656037ULL;
+  for (size_t i = 0; i < sizeof(T); ++i) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ULL;
+  }
+
+  hash ^= hash >> 30;
+  hash *= 0xbf58476d1ce4e5b9ULL;
+  hash ^= hash >> 27;
+  hash *= 0x94d049bb133111ebULL;
+  hash ^= hash >> 31;
+  return hash;
+}
+
+// Explicit template instantiations
+template uint64_t HyperLogLog::hash_value<int8_t>(int8_t value);
+template uint64_t HyperLogLog::hash_value<uint8_t>(uint8_t value);
+template uint64_t HyperLogLog::hash_value<int16_t>(int16_t value);
+template uint64_t HyperLogLog::hash_value<uint16_t>(uint16_t value);
+template uint64_t HyperLogLog::hash_value<int32_t>(int32_t value);
+template uint64_t HyperLogLog::hash_value<uint32_t>(uint32_t value);
+template uint64_t HyperLogLog::hash_value<int64_t>(int64_t value);
+template uint64_t HyperLogLog::hash_value<uint64_t>(uint64_t value);
+template uint64_t HyperLogLog::hash_value<float>(float value);
+template uint64_t HyperLogLog::hash_value<double>(double value);
+
+}  // namespace sm
+}  // namespace tiledb
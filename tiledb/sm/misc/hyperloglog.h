@@ -0,0 +1,111 @@
+/**
+ * @file   hyperloglog.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class HyperLogLog.
+ */
+
+#ifndef TILEDB_HYPERLOGLOG_H
+#define TILEDB_HYPERLOGLOG_H
+
+#include <vector>
+
+#include "tiledb/sm/misc/status.h"
+
+namespace tiledb {
+namespace sm {
+
+class Buffer;
+class ConstBuffer;
+
+/**
+ * A HyperLogLog sketch estimating the number of distinct 64-bit hashes
+ * added to it, with a standard error of about 1.6% (4096 registers).
+ * Sketches are merged by taking the maximum of each register, so the
+ * sketch of a union is the merge of the sketches of its parts.
+ *
+ * The hashes and the serialized form are platform-independent, so that a
+ * sketch may be persisted and merged by another process.
+ */
+class HyperLogLog {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /** Constructor. The sketch is empty. */
+  HyperLogLog();
+
+  /* ********************************* */
+  /*                 API               */
+  /* ********************************* */
+
+  /** Adds a hash to the sketch. */
+  void add(uint64_t hash);
+
+  /** Returns the estimated number of distinct hashes added. */
+  uint64_t estimate() const;
+
+  /** Merges the input sketch into this one. */
+  void merge(const HyperLogLog& other);
+
+  /** Serializes the sketch to the input buffer. */
+  Status serialize(Buffer* buff) const;
+
+  /** Deserializes the sketch from the input buffer. */
+  Status deserialize(ConstBuffer* cbuff);
+
+  /**
+   * Returns the hash of a value. Zeros are normalized, so that the negative
+   * and positive floating point zeros have the same hash.
+   *
+   * @tparam T The value type.
+   * @param value The value.
+   */
+  template <class T>
+  static uint64_t hash_value(T value);
+
+ private:
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The number of hash bits selecting a register. */
+  static const unsigned PRECISION = 12;
+
+  /**
+   * The registers, each holding the maximum position of the first set bit
+   * in the remaining bits of the hashes it was selected by.
+   */
+  std::vector<uint8_t> registers_;
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_HYPERLOGLOG_H
@@ -0,0 +1,224 @@
+/**
+ * @file   kll_sketch.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements class KllSketch.
+ */
+
+#include "tiledb/sm/misc/kll_sketch.h"
+#include "tiledb/sm/buffer/buffer.h"
+#include "tiledb/sm/buffer/const_buffer.h"
+#include "tiledb/sm/misc/logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace tiledb {
+namespace sm {
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+KllSketch::KllSketch(uint32_t k)
+    : k_(std::max<uint32_t>(k, 8))
+    , n_(0)
+    , min_(std::numeric_limits<double>::infinity())
+    , max_(-std::numeric_limits<double>::infinity())
+    , rng_(0x9e3779b97f4a7c15ULL)
+    , bottom_capacity_(k_)
+    , compactors_(1) {
+}
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+void KllSketch::add(double value) {
+  if (std::isnan(value))
+    return;
+
+  compactors_[0].push_back(value);
+  ++n_;
+  min_ = std::min(min_, value);
+  max_ = std::max(max_, value);
+  if (compactors_[0].size() >= bottom_capacity_)
+    compress();
+}
+
+uint64_t KllSketch::count() const {
+  return n_;
+}
+
+void KllSketch::merge(const KllSketch& other) {
+  if (other.compactors_.size() > compactors_.size())
+    compactors_.resize(other.compactors_.size());
+  for (size_t h = 0; h < other.compactors_.size(); ++h)
+    compactors_[h].insert(
+        compactors_[h].end(),
+        other.compactors_[h].begin(),
+        other.compactors_[h].end());
+  n_ += other.n_;
+  min_ = std::min(min_, other.min_);
+  max_ = std::max(max_, other.max_);
+  compress();
+}
+
+double KllSketch::quantile(double q) const {
+  if (n_ == 0)
+    return std::numeric_limits<double>::quiet_NaN();
+  if (q <= 0)
+    return min_;
+  if (q >= 1)
+    return max_;
+
+  // Each value stands for `2^h` values in compactor `h`
+  std::vector<std::pair<double, uint64_t>> weighted;
+  uint64_t total = 0;
+  for (size_t h = 0; h < compactors_.size(); ++h) {
+    for (auto v : compactors_[h])
+      weighted.emplace_back(v, uint64_t(1) << h);
+    total += compactors_[h].size() << h;
+  }
+
+  std::sort(weighted.begin(), weighted.end());
+  auto target = q * (double)total;
+  uint64_t rank = 0;
+  for (const auto& w : weighted) {
+    rank += w.second;
+    if ((double)rank >= target)
+      return w.first;
+  }
+
+  return weighted.back().first;
+}
+
+// ===== FORMAT =====
+// k (uint32_t)
+// n (uint64_t)
+// min (double)
+// max (double)
+// rng (uint64_t)
+// compactor_num (uint64_t)
+// value_num#1 (uint64_t) value#1_1 (double) value#1_2 (double) ...
+// value_num#2 (uint64_t) value#2_1 (double) value#2_2 (double) ...
+// ...
+Status KllSketch::serialize(Buffer* buff) const {
+  uint64_t compactor_num = compactors_.size();
+  RETURN_NOT_OK(buff->write(&k_, sizeof(uint32_t)));
+  RETURN_NOT_OK(buff->write(&n_, sizeof(uint64_t)));
+  RETURN_NOT_OK(buff->write(&min_, sizeof(double)));
+  RETURN_NOT_OK(buff->write(&max_, sizeof(double)));
+  RETURN_NOT_OK(buff->write(&rng_, sizeof(uint64_t)));
+  RETURN_NOT_OK(buff->write(&compactor_num, sizeof(uint64_t)));
+  for (const auto& compactor : compactors_) {
+    uint64_t value_num = compactor.size();
+    RETURN_NOT_OK(buff->write(&value_num, sizeof(uint64_t)));
+    if (value_num > 0)
+      RETURN_NOT_OK(buff->write(&compactor[0], value_num * sizeof(double)));
+  }
+
+  return Status::Ok();
+}
+
+Status KllSketch::deserialize(ConstBuffer* cbuff) {
+  uint64_t compactor_num = 0;
+  RETURN_NOT_OK(cbuff->read(&k_, sizeof(uint32_t)));
+  RETURN_NOT_OK(cbuff->read(&n_, sizeof(uint64_t)));
+  RETURN_NOT_OK(cbuff->read(&min_, sizeof(double)));
+  RETURN_NOT_OK(cbuff->read(&max_, sizeof(double)));
+  RETURN_NOT_OK(cbuff->read(&rng_, sizeof(uint64_t)));
+  RETURN_NOT_OK(cbuff->read(&compactor_num, sizeof(uint64_t)));
+  if (compactor_num == 0 || compactor_num > 64)
+    return LOG_STATUS(Status::Error(
+        "Cannot deserialize KLL sketch; Invalid number of compactors"));
+
+  compactors_.resize(compactor_num);
+  for (auto& compactor : compactors_) {
+    uint64_t value_num = 0;
+    RETURN_NOT_OK(cbuff->read(&value_num, sizeof(uint64_t)));
+    if (value_num * sizeof(double) > cbuff->nbytes_left_to_read())
+      return LOG_STATUS(Status::Error(
+          "Cannot deserialize KLL sketch; Invalid number of values"));
+    compactor.resize(value_num);
+    if (value_num > 0)
+      RETURN_NOT_OK(cbuff->read(&compactor[0], value_num * sizeof(double)));
+  }
+  bottom_capacity_ = capacity(0);
+
+  return Status::Ok();
+}
+
+/* ****************************** */
+/*         PRIVATE METHODS        */
+/* ****************************** */
+
+uint64_t KllSketch::capacity(size_t h) const {
+  // The capacities shrink by 2/3 from the top compactor down
+  auto depth = compactors_.size() - 1 - h;
+  auto c = (uint64_t)std::ceil(k_ * std::pow(2.0 / 3.0, (double)depth));
+  return std::max<uint64_t>(c, 2);
+}
+
+void KllSketch::compress() {
+  for (size_t h = 0; h < compactors_.size(); ++h) {
+    if (compactors_[h].size() < capacity(h))
+      continue;
+
+    // Promote every other sorted value, keeping the last one of an odd
+    // number of values in place
+    if (h + 1 == compactors_.size())
+      compactors_.emplace_back();
+    auto& compactor = compactors_[h];
+    std::sort(compactor.begin(), compactor.end());
+    double last = compactor.back();
+    bool odd = compactor.size() % 2 == 1;
+    size_t pair_num = compactor.size() / 2;
+    size_t offset = random_bit() ? 1 : 0;
+    auto& next = compactors_[h + 1];
+    for (size_t i = 0; i < pair_num; ++i)
+      next.push_back(compactor[2 * i + offset]);
+    compactor.clear();
+    if (odd)
+      compactor.push_back(last);
+  }
+
+  bottom_capacity_ = capacity(0);
+}
+
+bool KllSketch::random_bit() {
+  rng_ ^= rng_ << 13;
+  rng_ ^= rng_ >> 7;
+  rng_ ^= rng_ << 17;
+  return (rng_ & 1) != 0;
+}
+
+}  // namespace sm
+}  // namespace tiledb
@@ -0,0 +1,140 @@
+/**
+ * @file   kll_sketch.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class KllSketch.
+ */
+
+#ifndef TILEDB_KLL_SKETCH_H
+#define TILEDB_KLL_SKETCH_H
+
+#include <vector>
+
+#include "tiledb/sm/misc/status.h"
+
+namespace tiledb {
+namespace sm {
+
+class Buffer;
+class ConstBuffer;
+
+/**
+ * A KLL sketch estimating the quantiles of the values added to it, with a
+ * rank error of about 1.5% for the default `k` of 200, in space
+ * logarithmic in the number of values. Sketches are mergeable, so the
+ * sketch of a union is the merge of the sketches of its parts.
+ *
+ * The values are kept in compactors of increasing weight. A full
+ * compactor is sorted and every other value, starting at the first or the
+ * second, is promoted to the next compactor with twice the weight. The
+ * choice is pseudo-random with a fixed seed, so that the sketch of a
+ * sequence of values is deterministic.
+ */
+class KllSketch {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /**
+   * Constructor. The sketch is empty.
+   *
+   * @param k The capacity of the top compactor, trading accuracy for size.
+   */
+  explicit KllSketch(uint32_t k = 200);
+
+  /* ********************************* */
+  /*                 API               */
+  /* ********************************* */
+
+  /** Adds a value to the sketch. NaN values are ignored. */
+  void add(double value);
+
+  /** Returns the number of values added. */
+  uint64_t count() const;
+
+  /** Merges the input sketch into this one. */
+  void merge(const KllSketch& other);
+
+  /**
+   * Returns the estimated value of the input quantile, i.e., the smallest
+   * value whose rank is at least `q` times the number of values, or NaN if
+   * the sketch is empty. The quantiles `0` and `1` are the exact minimum
+   * and maximum.
+   *
+   * @param q The quantile, in `[0, 1]`.
+   */
+  double quantile(double q) const;
+
+  /** Serializes the sketch to the input buffer. */
+  Status serialize(Buffer* buff) const;
+
+  /** Deserializes the sketch from the input buffer. */
+  Status deserialize(ConstBuffer* cbuff);
+
+ private:
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The capacity of the top compactor. */
+  uint32_t k_;
+
+  /** The number of values added. */
+  uint64_t n_;
+
+  /** The exact minimum and maximum of the values added. */
+  double min_, max_;
+
+  /** The state of the generator choosing which values are promoted. */
+  uint64_t rng_;
+
+  /** The capacity of the bottom compactor, cached for `add`. */
+  uint64_t bottom_capacity_;
+
+  /** The compactors; the values in compactor `h` have weight `2^h`. */
+  std::vector<std::vector<double>> compactors_;
+
+  /* ********************************* */
+  /*           PRIVATE METHODS         */
+  /* ********************************* */
+
+  /** Returns the capacity of compactor `h`. */
+  uint64_t capacity(size_t h) const;
+
+  /** Compacts the lowest full compactors until the sketch fits. */
+  void compress();
+
+  /** Returns the next pseudo-random bit (xorshift64). */
+  bool random_bit();
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_KLL_SKETCH_H
@@ -0,0 +1,159 @@
+/**
+ * @file   numa.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines utilities for pinning threads to NUMA nodes.
+ */
+
+#include "tiledb/sm/misc/numa.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#endif
+
+namespace tiledb {
+namespace sm {
+namespace numa {
+
+namespace {
+
+#ifdef __linux__
+/**
+ * Parses a sysfs list of ranges such as `0-3,8,10-11`.
+ *
+ * @param path The sysfs file.
+ * @param values The listed values to set.
+ * @return `false` if the file cannot be read.
+ */
+bool read_list(const std::string& path, std::vector<unsigned>* values) {
+  std::ifstream ifs(path);
+  std::string list;
+  if (!ifs || !std::getline(ifs, list))
+    return false;
+
+  std::stringstream ss(list);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    if (range.empty())
+      continue;
+    auto dash = range.find('-');
+    auto first = std::stoul(range.substr(0, dash));
+    auto last =
+        (dash == std::string::npos) ? first : std::stoul(range.substr(dash + 1));
+    for (auto v = first; v <= last; ++v)
+      values->push_back((unsigned)v);
+  }
+
+  return true;
+}
+
+/**
+ * Reads the CPUs of the online NUMA nodes from sysfs, keeping only those the
+ * process may run on (e.g., within a container's cpuset).
+ */
+std::vector<std::vector<unsigned>> read_node_cpus() {
+  std::vector<std::vector<unsigned>> result;
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+    return result;
+
+  const std::string dir = "/sys/devices/system/node/";
+  std::vector<unsigned> nodes;
+  try {
+    if (!read_list(dir + "online", &nodes))
+      return result;
+    for (auto node : nodes) {
+      std::vector<unsigned> cpus, usable;
+      if (!read_list(dir + "node" + std::to_string(node) + "/cpulist", &cpus))
+        continue;
+      for (auto cpu : cpus) {
+        if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed))
+          usable.push_back(cpu);
+      }
+      if (!usable.empty())
+        result.push_back(std::move(usable));
+    }
+  } catch (const std::exception&) {
+    // Malformed list; treat the topology as unknown
+    result.clear();
+  }
+
+  return result;
+}
+#endif
+
+}  // namespace
+
+const std::vector<std::vector<unsigned>>& node_cpus() {
+#ifdef __linux__
+  static const std::vector<std::vector<unsigned>> cpus = read_node_cpus();
+#else
+  static const std::vector<std::vector<unsigned>> cpus;
+#endif
+  return cpus;
+}
+
+Status pin_thread(std::thread::native_handle_type thread, uint64_t node) {
+  const auto& nodes = node_cpus();
+  if (nodes.empty())
+    return Status::Ok();
+
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (auto cpu : nodes[node % nodes.size()])
+    CPU_SET(cpu, &set);
+  auto rc = pthread_setaffinity_np(thread, sizeof(set), &set);
+  if (rc != 0)
+    return Status::Error(
+        std::string("Cannot pin thread to NUMA node; ") + strerror(rc));
+#else
+  (void)thread;
+#endif
+
+  return Status::Ok();
+}
+
+Status pin_current_thread(uint64_t node) {
+#ifdef __linux__
+  return pin_thread(pthread_self(), node);
+#else
+  (void)node;
+  return Status::Ok();
+#endif
+}
+
+}  // namespace numa
+}  // namespace sm
+}  // namespace tiledb
@@ -0,0 +1,75 @@
+/**
+ * @file   numa.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file declares utilities for pinning threads to NUMA nodes.
+ */
+
+#ifndef TILEDB_NUMA_H
+#define TILEDB_NUMA_H
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "tiledb/sm/misc/status.h"
+
+namespace tiledb {
+namespace sm {
+namespace numa {
+
+/**
+ * Returns the CPUs of each NUMA node of the machine, read once from sysfs.
+ * It is empty if the topology is unknown (e.g., on non-Linux platforms).
+ */
+const std::vector<std::vector<unsigned>>& node_cpus();
+
+/**
+ * Pins a thread to the CPUs of NUMA node `node % node_num`. This is a no-op
+ * if the NUMA topology is unknown.
+ *
+ * @param thread The thread to pin.
+ * @param node The node index.
+ * @return Status
+ */
+Status pin_thread(std::thread::native_handle_type thread, uint64_t node);
+
+/**
+ * Pins the calling thread to the CPUs of NUMA node `node % node_num`. This
+ * is a no-op if the NUMA topology is unknown.
+ *
+ * @param node The node index.
+ * @return Status
+ */
+Status pin_current_thread(uint64_t node);
+
+}  // namespace numa
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_NUMA_H
@@ -34,7 +34,10 @@
 #define TILEDB_PARALLEL_FUNCTIONS_H
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <utility>
+#include <vector>
 
 #ifdef HAVE_TBB
 #include <tbb/blocked_range2d.h>
@@ -43,6 +46,8 @@
 #include <tbb/parallel_sort.h>
 #endif
 
+#include "tiledb/sm/misc/stats.h"
+
 namespace tiledb {
 namespace sm {
 
@@ -96,10 +101,14 @@ std::vector<Status> parallel_for_each(IterT begin, IterT end, const FuncT& F) {
   auto niters = static_cast<uint64_t>(std::distance(begin, end));
   std::vector<Status> result(niters);
 #ifdef HAVE_TBB
-  tbb::parallel_for(uint64_t(0), niters, [begin, &result, &F](uint64_t i) {
-    auto it = std::next(begin, i);
-    result[i] = F(*it);
-  });
+  // The iterations add to the stats of the query of the calling thread
+  auto query_stats = stats::query_stats();
+  tbb::parallel_for(
+      uint64_t(0), niters, [begin, query_stats, &result, &F](uint64_t i) {
+        stats::QueryStatsScope stats_scope(query_stats);
+        auto it = std::next(begin, i);
+        result[i] = F(*it);
+      });
 #else
   for (uint64_t i = 0; i < niters; i++) {
     auto it = std::next(begin, i);
@@ -115,7 +124,10 @@ std::vector<Status> parallel_for(uint64_t begin, uint64_t end, const FuncT& F) {
   uint64_t num_iters = end - begin + 1;
   std::vector<Status> result(num_iters);
 #ifdef HAVE_TBB
-  tbb::parallel_for(begin, end, [begin, &result, &F](uint64_t i) {
+  // The iterations add to the stats of the query of the calling thread
+  auto query_stats = stats::query_stats();
+  tbb::parallel_for(begin, end, [begin, query_stats, &result, &F](uint64_t i) {
+    stats::QueryStatsScope stats_scope(query_stats);
     result[i - begin] = F(i);
   });
 #else
@@ -126,6 +138,164 @@ std::vector<Status> parallel_for(uint64_t begin, uint64_t end, const FuncT& F) {
   return result;
 }
 
+/**
+ * Like `parallel_for`, but checks the given cancellation flag before each
+ * iteration. Once the flag is set, the remaining iterations are skipped and
+ * report an error, so that a cancelled query releases its threads after the
+ * iterations already running rather than after the whole loop.
+ *
+ * @tparam FuncT Function type (returning Status).
+ * @param begin Inclusive start of the range.
+ * @param end Exclusive end of the range.
+ * @param cancel The cancellation flag to poll, or null to never cancel.
+ * @param F Function to call on each item.
+ * @return Vector of Status objects, one for each function invocation.
+ */
+template <typename FuncT>
+std::vector<Status> cancelable_parallel_for(
+    uint64_t begin,
+    uint64_t end,
+    const std::atomic<bool>* cancel,
+    const FuncT& F) {
+  if (cancel == nullptr)
+    return parallel_for(begin, end, F);
+  return parallel_for(begin, end, [cancel, &F](uint64_t i) {
+    if (cancel->load(std::memory_order_relaxed))
+      return Status::QueryError("Query cancelled.");
+    return F(i);
+  });
+}
+
+/**
+ * Stably sorts the given (key, value) pairs on their keys with a
+ * least-significant-digit radix sort, possibly in parallel. Every pass sorts
+ * on one byte of the keys, counting and scattering fixed-size chunks of the
+ * input concurrently.
+ *
+ * @tparam T Value type, which must be default constructible.
+ * @param v The pairs to sort.
+ * @param max_key The largest key in `v`, which bounds the number of passes.
+ */
+template <typename T>
+void parallel_radix_sort(
+    std::vector<std::pair<uint64_t, T>>* v, uint64_t max_key) {
+  const uint64_t radix = 256;
+  const uint64_t chunk_size = 1 << 16;
+  const uint64_t n = v->size();
+  const uint64_t chunk_num = (n + chunk_size - 1) / chunk_size;
+  if (n < 2)
+    return;
+
+  std::vector<std::pair<uint64_t, T>> tmp(n);
+  std::vector<uint64_t> offsets(chunk_num * radix);
+  for (unsigned shift = 0; shift < 64 && (max_key >> shift) != 0;
+       shift += 8) {
+    // Count the digits in each chunk
+    std::fill(offsets.begin(), offsets.end(), 0);
+    parallel_for(0, chunk_num, [&](uint64_t c) {
+      auto end = std::min(n, (c + 1) * chunk_size);
+      for (uint64_t i = c * chunk_size; i < end; ++i)
+        ++offsets[c * radix + (((*v)[i].first >> shift) & (radix - 1))];
+      return Status::Ok();
+    });
+
+    // Compute the position of the first value of each digit in each chunk,
+    // placing the values of the earlier chunks first to keep the sort stable
+    uint64_t sum = 0;
+    for (uint64_t d = 0; d < radix; ++d) {
+      for (uint64_t c = 0; c < chunk_num; ++c) {
+        auto count = offsets[c * radix + d];
+        offsets[c * radix + d] = sum;
+        sum += count;
+      }
+    }
+
+    // Scatter the chunks
+    parallel_for(0, chunk_num, [&](uint64_t c) {
+      auto end = std::min(n, (c + 1) * chunk_size);
+      for (uint64_t i = c * chunk_size; i < end; ++i) {
+        auto d = ((*v)[i].first >> shift) & (radix - 1);
+        tmp[offsets[c * radix + d]++] = std::move((*v)[i]);
+      }
+      return Status::Ok();
+    });
+    v->swap(tmp);
+  }
+}
+
+/**
+ * Sorts the given iterator range if it consists of at most `max_run_num`
+ * sorted runs, by merging adjacent runs pairwise, possibly in parallel. The
+ * runs are found with one comparison per element in parallel chunks, which
+ * stop early once there are too many runs, so that ranges far from sorted
+ * are rejected cheaply.
+ *
+ * @tparam IterT Random access iterator type
+ * @tparam CmpT Comparator type
+ * @param begin Beginning of range to sort (inclusive).
+ * @param end End of range to sort (exclusive).
+ * @param cmp Comparator.
+ * @param max_run_num The maximum number of runs to merge.
+ * @param run_num Set to the number of runs if the range was sorted.
+ * @return True if the range was sorted, false if it has too many runs, in
+ *     which case it is left unmodified.
+ */
+template <typename IterT, typename CmpT>
+bool parallel_merge_sorted_runs(
+    IterT begin,
+    IterT end,
+    const CmpT& cmp,
+    uint64_t max_run_num,
+    uint64_t* run_num) {
+  const uint64_t chunk_size = 1 << 16;
+  const uint64_t n = end - begin;
+  const uint64_t chunk_num = (n + chunk_size - 1) / chunk_size;
+
+  // Find the first element of every run but the first, i.e., the elements
+  // ordered before their predecessor
+  std::vector<std::vector<uint64_t>> run_starts(chunk_num);
+  std::atomic<uint64_t> start_num(0);
+  parallel_for(0, chunk_num, [&](uint64_t c) {
+    auto chunk_end = std::min(n, (c + 1) * chunk_size);
+    for (uint64_t i = std::max<uint64_t>(1, c * chunk_size); i < chunk_end;
+         ++i) {
+      if (cmp(begin[i], begin[i - 1])) {
+        run_starts[c].push_back(i);
+        if (++start_num >= max_run_num)
+          break;
+      }
+    }
+    return Status::Ok();
+  });
+  if (start_num >= max_run_num)
+    return false;
+
+  // Merge adjacent runs pairwise until a single run is left
+  std::vector<uint64_t> bounds(1, 0);
+  for (const auto& starts : run_starts)
+    bounds.insert(bounds.end(), starts.begin(), starts.end());
+  bounds.push_back(n);
+  *run_num = bounds.size() - 1;
+  while (bounds.size() > 2) {
+    parallel_for(0, (bounds.size() - 1) / 2, [&](uint64_t p) {
+      std::inplace_merge(
+          begin + bounds[2 * p],
+          begin + bounds[2 * p + 1],
+          begin + bounds[2 * p + 2],
+          cmp);
+      return Status::Ok();
+    });
+    std::vector<uint64_t> merged_bounds;
+    for (uint64_t i = 0; i < bounds.size(); i += 2)
+      merged_bounds.push_back(bounds[i]);
+    if (merged_bounds.back() != n)
+      merged_bounds.push_back(n);
+    bounds.swap(merged_bounds);
+  }
+
+  return true;
+}
+
 /**
  * Call the given function on every pair (i, j) in the given i and j ranges,
  * possibly in parallel.
@@ -148,10 +318,13 @@ std::vector<Status> parallel_for_2d(
   std::vector<Status> result(num_iters);
 #ifdef HAVE_TBB
   auto range = tbb::blocked_range2d<uint64_t>(i0, i1, j0, j1);
+  // The iterations add to the stats of the query of the calling thread
+  auto query_stats = stats::query_stats();
   tbb::parallel_for(
       range,
-      [i0, j0, num_j_iters, &result, &F](
+      [i0, j0, num_j_iters, query_stats, &result, &F](
           const tbb::blocked_range2d<uint64_t>& r) {
+        stats::QueryStatsScope stats_scope(query_stats);
         const auto& rows = r.rows();
         const auto& cols = r.cols();
         for (uint64_t i = rows.begin(); i < rows.end(); i++) {
@@ -1,4 +1,11 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <new>
 #include <thread>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
 
 #include "tiledb/sm/misc/stats.h"
 
@@ -8,11 +15,128 @@ namespace stats {
 
 Statistics all_stats;
 
+Counter& Counter::operator=(uint64_t value) {
+  stripes_[0].values_[id_] = value;
+  for (unsigned s = 1; s < stripe_num; ++s)
+    stripes_[s].values_[id_] = 0;
+  return *this;
+}
+
+uint64_t Counter::load() const {
+  uint64_t value = 0;
+  for (unsigned s = 0; s < stripe_num; ++s)
+    value += stripes_[s].values_[id_].load(std::memory_order_relaxed);
+  return value;
+}
+
+void Counter::max(uint64_t value) {
+  auto& counter = stripes_[0].values_[id_];
+  uint64_t prev = counter.load();
+  while (prev < value && !counter.compare_exchange_weak(prev, value)) {
+  }
+}
+
+Histogram::Histogram() {
+  reset();
+}
+
+void Histogram::add(uint64_t value) {
+  buckets_[bucket(value)].fetch_add(1, std::memory_order_relaxed);
+  uint64_t prev = max_.load(std::memory_order_relaxed);
+  while (prev < value && !max_.compare_exchange_weak(prev, value)) {
+  }
+}
+
+uint64_t Histogram::count() const {
+  uint64_t count = 0;
+  for (unsigned b = 0; b < bucket_num; ++b)
+    count += buckets_[b].load(std::memory_order_relaxed);
+  return count;
+}
+
+uint64_t Histogram::max() const {
+  return max_;
+}
+
+uint64_t Histogram::quantile(double q) const {
+  auto count = this->count();
+  if (count == 0)
+    return 0;
+
+  // The rank of the quantile, in [1, count]
+  auto rank = static_cast<uint64_t>(std::ceil(q * count));
+  rank = std::min(std::max(rank, uint64_t(1)), count);
+
+  uint64_t sum = 0;
+  for (unsigned b = 0; b < bucket_num; ++b) {
+    sum += buckets_[b].load(std::memory_order_relaxed);
+    if (sum >= rank)
+      return std::min(bucket_max(b), max());
+  }
+
+  return max();
+}
+
+void Histogram::reset() {
+  for (unsigned b = 0; b < bucket_num; ++b)
+    buckets_[b] = 0;
+  max_ = 0;
+}
+
+unsigned Histogram::bucket(uint64_t value) {
+  const uint64_t sub_bucket_num = uint64_t(1) << sub_bucket_bits;
+  if (value < sub_bucket_num)
+    return static_cast<unsigned>(value);
+
+  // The position of the highest set bit picks the power of two, and the
+  // next bits the bucket within it
+  unsigned p = 63;
+  while ((value >> p) == 0)
+    --p;
+  auto sub = (value >> (p - sub_bucket_bits)) & (sub_bucket_num - 1);
+  return ((p - sub_bucket_bits + 1) << sub_bucket_bits) +
+         static_cast<unsigned>(sub);
+}
+
+uint64_t Histogram::bucket_max(unsigned bucket) {
+  const uint64_t sub_bucket_num = uint64_t(1) << sub_bucket_bits;
+  if (bucket < sub_bucket_num)
+    return bucket;
+
+  auto p = (bucket >> sub_bucket_bits) + sub_bucket_bits - 1;
+  auto sub = bucket & (sub_bucket_num - 1);
+  auto width = uint64_t(1) << (p - sub_bucket_bits);
+  return ((sub_bucket_num + sub) << (p - sub_bucket_bits)) + (width - 1);
+}
+
 Statistics::Statistics() {
   enabled_ = false;
+  sampled_ = false;
+  traced_ = false;
   reset();
 }
 
+void* Statistics::operator new(size_t size) {
+  void* ptr = nullptr;
+#ifdef _WIN32
+  ptr = _aligned_malloc(size, alignof(CounterStripe));
+#else
+  if (posix_memalign(&ptr, alignof(CounterStripe), size) != 0)
+    ptr = nullptr;
+#endif
+  if (ptr == nullptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+
+void Statistics::operator delete(void* ptr) {
+#ifdef _WIN32
+  _aligned_free(ptr);
+#else
+  std::free(ptr);
+#endif
+}
+
 void Statistics::dump(FILE* out) const {
   fprintf(
       out,
@@ -39,6 +163,24 @@ void Statistics::dump(FILE* out) const {
       "\n");
   dump_all_counter_stats(out);
 
+  fprintf(out, "\nLatency histograms (ns):\n");
+  fprintf(
+      out,
+      "%-44s%12s%12s%12s%12s%12s\n",
+      "  Histogram name",
+      "Count",
+      "p50",
+      "p95",
+      "p99",
+      "Max");
+  fprintf(
+      out,
+      "  "
+      "------------------------------------------------------------------------"
+      "----------------------------"
+      "\n");
+  dump_all_histogram_stats(out);
+
   fprintf(out, "\nSummary:\n");
   fprintf(out, "--------\n");
   fprintf(
@@ -49,6 +191,32 @@ void Statistics::dump(FILE* out) const {
 
   fprintf(out, "Writes:\n");
   dump_write_summary(out);
+
+  fprintf(out, "Consolidations:\n");
+  dump_consolidation_summary(out);
+}
+
+void Statistics::dump_consolidation_summary(FILE* out) const {
+  fprintf(
+      out,
+      "  Consolidation steps: %" PRIu64 "\n",
+      uint64_t(counter_consolidator_num_steps));
+
+  report_ratio(
+      out,
+      "  Fragments consolidated per step",
+      "fragments",
+      counter_consolidator_num_fragments_consolidated,
+      counter_consolidator_num_steps);
+
+  // Consolidation write amplification is num bytes written / num bytes of
+  // the consolidated fragments read
+  report_ratio(
+      out,
+      "  Consolidation write amplification",
+      "bytes",
+      counter_consolidator_num_bytes_written,
+      counter_consolidator_num_bytes_read);
 }
 
 void Statistics::dump_read_summary(FILE* out) const {
@@ -97,6 +265,46 @@ void Statistics::dump_read_summary(FILE* out) const {
       counter_reader_num_bytes_after_filtering +
           counter_tileio_read_num_resulting_bytes,
       counter_reader_num_tile_bytes_read + counter_tileio_read_num_bytes_read);
+
+  // Batching amplification is num bytes read by the batches / num bytes of
+  // the regions batched, whose excess is the gaps merged into the batches
+  report_ratio(
+      out,
+      "  Read batching amplification",
+      "bytes",
+      counter_vfs_read_all_bytes_batched,
+      counter_vfs_read_all_bytes_requested);
+
+  fprintf(
+      out,
+      "  Backend reads (file, HDFS, S3): %" PRIu64 ", %" PRIu64 ", %" PRIu64
+      " requests\n",
+      uint64_t(counter_vfs_file_num_reads),
+      uint64_t(counter_vfs_hdfs_num_reads),
+      uint64_t(counter_vfs_s3_num_reads));
+
+  // The strategies chosen by the read planner (see `sm.read_planner`)
+  if (counter_reader_plan_num > 0) {
+    fprintf(
+        out,
+        "  Planned reads: %" PRIu64 " (prefetched: %" PRIu64
+        ", balanced splits: %" PRIu64 ")\n",
+        uint64_t(counter_reader_plan_num),
+        uint64_t(counter_reader_plan_prefetch),
+        uint64_t(counter_reader_plan_balanced_splits));
+    fprintf(
+        out,
+        "  Planned fragment tile selections (index, scan): %" PRIu64
+        ", %" PRIu64 "\n",
+        uint64_t(counter_reader_plan_index_fragments),
+        uint64_t(counter_reader_plan_scan_fragments));
+    report_ratio(
+        out,
+        "  Estimated partitions per planned read",
+        "partitions",
+        counter_reader_plan_est_partitions,
+        counter_reader_plan_num);
+  }
 }
 
 void Statistics::dump_write_summary(FILE* out) const {
@@ -140,11 +348,44 @@ void Statistics::dump(std::string* out) const {
   ss.seekp(-2, std::ios_base::cur);
   ss << "\n";
 
+  ss << "  ],\n";
+  ss << "  \"histograms\": [\n";
+  dump_all_histogram_stats(ss);
+
+  // Replace last ,\n with just \n
+  ss.seekp(-2, std::ios_base::cur);
+  ss << "\n";
+
   ss << "  ]\n";
   ss << "}";
   *out = ss.str();
 }
 
+void Statistics::dump_histogram(
+    FILE* out, const char* name, const Histogram& histogram) const {
+  fprintf(
+      out,
+      "  %-42s%12" PRIu64 "%12" PRIu64 "%12" PRIu64 "%12" PRIu64 "%12" PRIu64
+      "\n",
+      (std::string(name) + ",").c_str(),
+      histogram.count(),
+      histogram.quantile(0.5),
+      histogram.quantile(0.95),
+      histogram.quantile(0.99),
+      histogram.max());
+}
+
+void Statistics::dump_histogram(
+    std::stringstream& ss, const char* name, const Histogram& histogram) const {
+  ss << "    { ";
+  ss << "\"name\": \"" << name << "\", ";
+  ss << "\"count\": " << histogram.count() << ", ";
+  ss << "\"p50\": " << histogram.quantile(0.5) << ", ";
+  ss << "\"p95\": " << histogram.quantile(0.95) << ", ";
+  ss << "\"p99\": " << histogram.quantile(0.99) << ", ";
+  ss << "\"max\": " << histogram.max() << " },\n";
+}
+
 void Statistics::report_ratio(
     FILE* out,
     const char* msg,
@@ -40,8 +40,11 @@
 #include <chrono>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <sstream>
 
+#include "tiledb/sm/misc/trace.h"
+
 namespace tiledb {
 namespace sm {
 namespace stats {
@@ -50,10 +53,139 @@ namespace stats {
 /*          TYPE DEFINITIONS         */
 /* ********************************* */
 
+/** The ids of the counter stats. */
+enum class CounterId : unsigned {
+#define STATS_DEFINE_COUNTER_STAT(counter_name) counter_name,
+#include "tiledb/sm/misc/stats_counters.h"
+#undef STATS_DEFINE_COUNTER_STAT
+  COUNTER_NUM
+};
+
+/**
+ * The values of all counter stats added by the threads of one stripe. A
+ * stripe is aligned to a cache line, so that the threads of different
+ * stripes never write to the same cache line.
+ */
+struct alignas(64) CounterStripe {
+  std::atomic<uint64_t> values_[static_cast<unsigned>(CounterId::COUNTER_NUM)];
+};
+
+/**
+ * A counter stat. Each thread adds to the counter in the stripe assigned to
+ * it on its first addition, so that threads updating the same counter in
+ * hot loops do not contend on its cache line. The value of the counter is
+ * the sum of its stripes, aggregated when it is read.
+ */
+class Counter {
+ public:
+  /** The number of stripes of the counter stats. */
+  static const unsigned stripe_num = 64;
+
+  /** Constructor. */
+  Counter(CounterStripe* stripes, CounterId id)
+      : stripes_(stripes)
+      , id_(static_cast<unsigned>(id)) {
+  }
+
+  Counter(const Counter&) = delete;
+  Counter& operator=(const Counter&) = delete;
+
+  /** Adds a value to the stripe of the calling thread. */
+  Counter& operator+=(uint64_t value) {
+    auto& counter = stripes_[stripe()].values_[id_];
+    counter.fetch_add(value, std::memory_order_relaxed);
+    return *this;
+  }
+
+  /** Sets the value of the counter. */
+  Counter& operator=(uint64_t value);
+
+  /** Returns the value of the counter. */
+  operator uint64_t() const {
+    return load();
+  }
+
+  /** Returns the value of the counter. */
+  uint64_t load() const;
+
+  /**
+   * Raises the counter to the given value, if the value is larger. Such
+   * counters are kept in the first stripe, so they must not be added to.
+   */
+  void max(uint64_t value);
+
+ private:
+  /** The stripes holding the counter values. */
+  CounterStripe* stripes_;
+
+  /** The index of the counter in the stripes. */
+  unsigned id_;
+
+  /** Returns the stripe of the calling thread. */
+  static unsigned stripe() {
+    static std::atomic<unsigned> next_stripe(0);
+    static thread_local unsigned stripe = next_stripe++ % stripe_num;
+    return stripe;
+  }
+};
+
 /**
- * Class that defines stats counters and methods to manipulate them.
+ * An HDR-style histogram of latencies in nanoseconds. Each power of two is
+ * split into 8 buckets, so the percentiles are within 12.5% of the exact
+ * ones whatever their magnitude, in a fixed space of 496 buckets.
  */
-class Statistics {
+class Histogram {
+ public:
+  /** The number of bits of the buckets within a power of two. */
+  static const unsigned sub_bucket_bits = 3;
+
+  /** The number of buckets. */
+  static const unsigned bucket_num = (65 - sub_bucket_bits) << sub_bucket_bits;
+
+  /** Constructor. */
+  Histogram();
+
+  Histogram(const Histogram&) = delete;
+  Histogram& operator=(const Histogram&) = delete;
+
+  /** Adds a value to the histogram. */
+  void add(uint64_t value);
+
+  /** Returns the number of values added. */
+  uint64_t count() const;
+
+  /** Returns the largest value added. */
+  uint64_t max() const;
+
+  /**
+   * Returns the `q`-th quantile (in `[0, 1]`) of the values added, as the
+   * largest value of its bucket, or `0` if no value was added.
+   */
+  uint64_t quantile(double q) const;
+
+  /** Clears the histogram. */
+  void reset();
+
+ private:
+  /** The number of values of each bucket. */
+  std::atomic<uint64_t> buckets_[bucket_num];
+
+  /** The largest value added. */
+  std::atomic<uint64_t> max_;
+
+  /** Returns the bucket of the input value. */
+  static unsigned bucket(uint64_t value);
+
+  /** Returns the largest value of the input bucket. */
+  static uint64_t bucket_max(unsigned bucket);
+};
+
+/**
+ * Class that defines stats counters and methods to manipulate them. Besides
+ * the global stats, each query has its own, which are owned by a shared
+ * pointer so that the tasks of the query can keep them alive.
+ */
+class Statistics : public std::enable_shared_from_this<Statistics> {
  public:
   /* Define the counters */
 #define STATS_DEFINE_FUNC_STAT(function_name)     \
@@ -62,14 +194,31 @@ class Statistics {
 #include "tiledb/sm/misc/stats_counters.h"
 #undef STATS_DEFINE_FUNC_STAT
 
+  /** The stripes of the counter stats. */
+  CounterStripe counter_stripes_[Counter::stripe_num];
+
 #define STATS_DEFINE_COUNTER_STAT(counter_name) \
-  std::atomic<uint64_t> counter_##counter_name;
+  Counter counter_##counter_name{counter_stripes_, CounterId::counter_name};
 #include "tiledb/sm/misc/stats_counters.h"
 #undef STATS_DEFINE_COUNTER_STAT
 
+#define STATS_DEFINE_HISTOGRAM_STAT(histogram_name) \
+  Histogram histogram_##histogram_name;
+#include "tiledb/sm/misc/stats_counters.h"
+#undef STATS_DEFINE_HISTOGRAM_STAT
+
   /** Constructor. */
   Statistics();
 
+  Statistics(const Statistics&) = delete;
+  Statistics& operator=(const Statistics&) = delete;
+
+  /** Allocates the stats aligned to their counter stripes. */
+  static void* operator new(size_t size);
+
+  /** Frees stats allocated with `operator new`. */
+  static void operator delete(void* ptr);
+
   /** Returns true if statistics are currently enabled. */
   bool enabled() const;
 
@@ -84,6 +233,11 @@ class Statistics {
 #define STATS_INIT_COUNTER_STAT(counter_name) counter_##counter_name = 0;
 #include "tiledb/sm/misc/stats_counters.h"
 #undef STATS_INIT_COUNTER_STAT
+
+#define STATS_INIT_HISTOGRAM_STAT(histogram_name) \
+  histogram_##histogram_name.reset();
+#include "tiledb/sm/misc/stats_counters.h"
+#undef STATS_INIT_HISTOGRAM_STAT
   }
 
   /** Dump the current counter values to the given file. */
@@ -95,10 +249,39 @@ class Statistics {
   /** Enable or disable statistics gathering. */
   void set_enabled(bool enabled);
 
+  /**
+   * Returns true if these are the stats of a query sampled by
+   * `sm.stats.sample_rate`, which are gathered while the global stats are
+   * disabled.
+   */
+  bool sampled() const {
+    return sampled_;
+  }
+
+  /** Returns true if the calls of the sampled query are traced. */
+  bool traced() const {
+    return traced_;
+  }
+
+  /**
+   * Marks these as the stats of a sampled query, whose calls are traced
+   * too if `traced` is true.
+   */
+  void set_sampled(bool sampled, bool traced) {
+    sampled_ = sampled;
+    traced_ = sampled && traced;
+  }
+
  private:
   /** True if stats are being gathered. */
   bool enabled_;
 
+  /** True if these are the stats of a sampled query. */
+  bool sampled_;
+
+  /** True if the calls of the sampled query are traced. */
+  bool traced_;
+
   /** Dump all function stats to the output. */
   void dump_all_func_stats(FILE* out) const {
 #define STATS_REPORT_FUNC_STAT(function_name) \
@@ -145,12 +328,41 @@ class Statistics {
 #undef STATS_REPORT_COUNTER_STAT
   }
 
+  /** Dump all histogram stats to the output. */
+  void dump_all_histogram_stats(FILE* out) const {
+#define STATS_REPORT_HISTOGRAM_STAT(histogram_name) \
+  dump_histogram(out, #histogram_name, histogram_##histogram_name);
+#include "tiledb/sm/misc/stats_counters.h"
+#undef STATS_REPORT_HISTOGRAM_STAT
+  }
+
+  /** Dump all histogram stats to the output. */
+  void dump_all_histogram_stats(std::stringstream& ss) const {
+#define STATS_REPORT_HISTOGRAM_STAT(histogram_name) \
+  dump_histogram(ss, #histogram_name, histogram_##histogram_name);
+#include "tiledb/sm/misc/stats_counters.h"
+#undef STATS_REPORT_HISTOGRAM_STAT
+  }
+
+  /** Dump a histogram stat to the output. */
+  void dump_histogram(
+      FILE* out, const char* name, const Histogram& histogram) const;
+
+  /** Dump a histogram stat to the output. */
+  void dump_histogram(
+      std::stringstream& ss,
+      const char* name,
+      const Histogram& histogram) const;
+
   /** Dump a summary of read statistics. */
   void dump_read_summary(FILE* out) const;
 
   /** Dump a summary of write statistics. */
   void dump_write_summary(FILE* out) const;
 
+  /** Dump a summary of consolidation statistics. */
+  void dump_consolidation_summary(FILE* out) const;
+
   /**
    * Helper function to pretty-print a ratio of integers as a "times" value.
    *
@@ -190,6 +402,188 @@ class Statistics {
  */
 extern Statistics all_stats;
 
+/**
+ * Returns a reference to the stats of the query the calling thread is
+ * executing, which is `nullptr` if it is not executing a query.
+ */
+inline Statistics*& query_stats() {
+  static thread_local Statistics* stats = nullptr;
+  return stats;
+}
+
+/**
+ * Sets the query stats of the calling thread for the lifetime of the
+ * scope, restoring the previous ones on destruction.
+ */
+class QueryStatsScope {
+ public:
+  /** Constructor. */
+  explicit QueryStatsScope(Statistics* stats)
+      : prev_stats_(query_stats()) {
+    query_stats() = stats;
+  }
+
+  /** Destructor. */
+  ~QueryStatsScope() {
+    query_stats() = prev_stats_;
+  }
+
+  QueryStatsScope(const QueryStatsScope&) = delete;
+  QueryStatsScope& operator=(const QueryStatsScope&) = delete;
+
+ private:
+  /** The query stats of the calling thread before the scope. */
+  Statistics* prev_stats_;
+};
+
+/**
+ * Returns true if the calling thread gathers stats, i.e., if the global
+ * stats are enabled or it is executing a sampled query.
+ */
+inline bool gathering() {
+  if (all_stats.enabled())
+    return true;
+  auto stats = query_stats();
+  return stats != nullptr && stats->sampled();
+}
+
+/**
+ * Returns true if the calling thread traces its calls, i.e., if tracing is
+ * enabled or it is executing a sampled query that is traced.
+ */
+inline bool tracing() {
+  if (Tracer::global().enabled())
+    return true;
+  auto stats = query_stats();
+  return stats != nullptr && stats->traced();
+}
+
+/**
+ * Adds a value to a counter of the global stats, if they are enabled, and
+ * of the query stats.
+ */
+inline void add_counter(Counter Statistics::*counter, uint64_t value) {
+  if (all_stats.enabled())
+    all_stats.*counter += value;
+  auto stats = query_stats();
+  if (stats != nullptr)
+    stats->*counter += value;
+}
+
+/**
+ * Raises a counter of the global stats, if they are enabled, and of the
+ * query stats to the given value, if the value is larger.
+ */
+inline void max_counter(Counter Statistics::*counter, uint64_t value) {
+  if (all_stats.enabled())
+    (all_stats.*counter).max(value);
+  auto stats = query_stats();
+  if (stats != nullptr)
+    (stats->*counter).max(value);
+}
+
+/**
+ * Adds a value to a histogram of the global stats, if they are enabled, and
+ * of the query stats.
+ */
+inline void add_histogram(Histogram Statistics::*histogram, uint64_t value) {
+  if (all_stats.enabled())
+    (all_stats.*histogram).add(value);
+  auto stats = query_stats();
+  if (stats != nullptr)
+    (stats->*histogram).add(value);
+}
+
+/**
+ * Adds the time from its construction to its destruction to a histogram of
+ * the global stats and the query stats, if the thread gathers stats, and to
+ * the trace as a call of the histogram name, if the thread traces its calls.
+ */
+class HistogramTimer {
+ public:
+  /** Constructor. */
+  HistogramTimer(Histogram Statistics::*histogram, const char* name)
+      : histogram_(histogram)
+      , name_(name)
+      , start_(std::chrono::steady_clock::now()) {
+  }
+
+  /** Destructor. */
+  ~HistogramTimer() {
+    bool enabled = gathering();
+    bool traced = tracing();
+    if (!enabled && !traced)
+      return;
+
+    auto end = std::chrono::steady_clock::now();
+    if (enabled)
+      add_histogram(
+          histogram_,
+          std::chrono::duration_cast<std::chrono::nanoseconds>(end - start_)
+              .count());
+    if (traced)
+      Tracer::global().add(name_, start_, end);
+  }
+
+  HistogramTimer(const HistogramTimer&) = delete;
+  HistogramTimer& operator=(const HistogramTimer&) = delete;
+
+ private:
+  /** The histogram the time is added to. */
+  Histogram Statistics::*histogram_;
+
+  /** The name of the histogram, a string literal. */
+  const char* name_;
+
+  /** The construction time. */
+  std::chrono::steady_clock::time_point start_;
+};
+
+/**
+ * Records a function call of the given duration in the global stats, if
+ * they are enabled, and in the query stats.
+ */
+inline void add_func_call(
+    std::atomic<uint64_t> Statistics::*total_ns,
+    std::atomic<uint64_t> Statistics::*call_count,
+    uint64_t ns) {
+  if (all_stats.enabled()) {
+    all_stats.*total_ns += ns;
+    all_stats.*call_count += 1;
+  }
+  auto stats = query_stats();
+  if (stats != nullptr) {
+    stats->*total_ns += ns;
+    stats->*call_count += 1;
+  }
+}
+
+/**
+ * Ends a call of the timed function `name` that began at `start`, adding it
+ * to the stats if the thread gathers stats and to the trace if the thread
+ * traces its calls.
+ */
+inline void end_func_call(
+    std::atomic<uint64_t> Statistics::*total_ns,
+    std::atomic<uint64_t> Statistics::*call_count,
+    const char* name,
+    std::chrono::steady_clock::time_point start) {
+  bool enabled = gathering();
+  bool traced = tracing();
+  if (!enabled && !traced)
+    return;
+
+  auto end = std::chrono::steady_clock::now();
+  if (enabled)
+    add_func_call(
+        total_ns,
+        call_count,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+            .count());
+  if (traced)
+    Tracer::global().add(name, start, end);
+}
+
 /* ********************************* */
 /*               MACROS              */
 /* ********************************* */
@@ -205,18 +599,14 @@ extern Statistics all_stats;
  * statement in the function. Note that a function can have multiple exit paths
  * (i.e. multiple returns), but you should still put this macro after the very
  * last statement in the function. */
-#define STATS_FUNC_OUT(f)                                     \
-  }                                                           \
-  ();                                                         \
-  if (stats::all_stats.enabled()) {                           \
-    auto __stats_end = std::chrono::steady_clock::now();      \
-    uint64_t __stats_dur_ns =                                 \
-        std::chrono::duration_cast<std::chrono::nanoseconds>( \
-            __stats_end - __stats_start)                      \
-            .count();                                         \
-    stats::all_stats.f##_total_ns += __stats_dur_ns;          \
-    stats::all_stats.f##_call_count++;                        \
-  }                                                           \
+#define STATS_FUNC_OUT(f)                 \
+  }                                       \
+  ();                                     \
+  stats::end_func_call(                   \
+      &stats::Statistics::f##_total_ns,   \
+      &stats::Statistics::f##_call_count, \
+      #f,                                 \
+      __stats_start);                     \
   return __stats_##f##_retval;
 
 /** Marks the beginning of a stats-enabled void function. This should come
@@ -226,30 +616,39 @@ extern Statistics all_stats;
   [&]() {
 /** Marks the end of a stats-enabled void function. This should come after the
  * last statement in the function. */
-#define STATS_FUNC_VOID_OUT(f)                                 \
-  }                                                            \
-  ();                                                          \
-  if (stats::all_stats.enabled()) {                            \
-    auto __stats_##f##_end = std::chrono::steady_clock::now(); \
-    uint64_t __stats_dur_ns =                                  \
-        std::chrono::duration_cast<std::chrono::nanoseconds>(  \
-            __stats_##f##_end - __stats_##f##_start)           \
-            .count();                                          \
-    stats::all_stats.f##_total_ns += __stats_dur_ns;           \
-    stats::all_stats.f##_call_count++;                         \
-  }
+#define STATS_FUNC_VOID_OUT(f)            \
+  }                                       \
+  ();                                     \
+  stats::end_func_call(                   \
+      &stats::Statistics::f##_total_ns,   \
+      &stats::Statistics::f##_call_count, \
+      #f,                                 \
+      __stats_##f##_start);
 /** Adds a value to a counter stat. */
-#define STATS_COUNTER_ADD(counter_name, value)          \
-  if (stats::all_stats.enabled()) {                     \
-    stats::all_stats.counter_##counter_name += (value); \
+#define STATS_COUNTER_ADD(counter_name, value)                             \
+  if (stats::gathering()) {                                                \
+    stats::add_counter(&stats::Statistics::counter_##counter_name, value); \
   }
 
 /** Adds a value to a counter stat if the given condition is true. */
-#define STATS_COUNTER_ADD_IF(cond, counter_name, value) \
-  if (stats::all_stats.enabled() && (cond)) {           \
-    stats::all_stats.counter_##counter_name += (value); \
+#define STATS_COUNTER_ADD_IF(cond, counter_name, value)                    \
+  if (stats::gathering() && (cond)) {                                      \
+    stats::add_counter(&stats::Statistics::counter_##counter_name, value); \
+  }
+
+/** Raises a counter stat to the given value, if the value is larger. */
+#define STATS_COUNTER_MAX(counter_name, value)                             \
+  if (stats::gathering()) {                                                \
+    stats::max_counter(&stats::Statistics::counter_##counter_name, value); \
   }
 
+/**
+ * Adds the time until the end of the enclosing scope to a histogram stat.
+ */
+#define STATS_HISTOGRAM_TIMER(histogram_name)                      \
+  stats::HistogramTimer __stats_histogram_timer_##histogram_name( \
+      &stats::Statistics::histogram_##histogram_name, #histogram_name)
+
 /** Starts an ad hoc timer of the given name. */
 #define STATS_TIMER_START(name) \
   auto __timer_##name = std::chrono::steady_clock::now()
@@ -278,6 +677,10 @@ extern Statistics all_stats;
 
 #define STATS_COUNTER_ADD_IF(cond, counter_name, value)
 
+#define STATS_COUNTER_MAX(counter_name, value)
+
+#define STATS_HISTOGRAM_TIMER(histogram_name)
+
 #define STATS_TIMER_START(name)
 
 #define STATS_TIMER_NS(name)
@@ -56,6 +56,13 @@ STATS_DEFINE_FUNC_STAT(cache_lru_insert)
 STATS_DEFINE_FUNC_STAT(cache_lru_invalidate)
 STATS_DEFINE_FUNC_STAT(cache_lru_read)
 STATS_DEFINE_FUNC_STAT(cache_lru_read_partial)
+STATS_DEFINE_FUNC_STAT(cache_tile_evict)
+STATS_DEFINE_FUNC_STAT(cache_tile_insert)
+STATS_DEFINE_FUNC_STAT(cache_tile_invalidate)
+STATS_DEFINE_FUNC_STAT(cache_tile_pin)
+STATS_DEFINE_FUNC_STAT(cache_tile_read)
+STATS_DEFINE_FUNC_STAT(cache_disk_tile_read)
+STATS_DEFINE_FUNC_STAT(cache_disk_tile_write)
 // Reader
 STATS_DEFINE_FUNC_STAT(reader_compute_cell_ranges)
 STATS_DEFINE_FUNC_STAT(reader_compute_dense_cell_ranges)
@@ -66,21 +73,30 @@ STATS_DEFINE_FUNC_STAT(reader_compute_tile_coords)
 STATS_DEFINE_FUNC_STAT(reader_copy_fixed_cells)
 STATS_DEFINE_FUNC_STAT(reader_copy_var_cells)
 STATS_DEFINE_FUNC_STAT(reader_dedup_coords)
+STATS_DEFINE_FUNC_STAT(reader_dedup_coords_unordered)
+STATS_DEFINE_FUNC_STAT(reader_merge_coords)
 STATS_DEFINE_FUNC_STAT(reader_dense_read)
 STATS_DEFINE_FUNC_STAT(reader_fill_coords)
 STATS_DEFINE_FUNC_STAT(reader_filter_tiles)
 STATS_DEFINE_FUNC_STAT(reader_init_tile_fragment_dense_cell_range_iters)
 STATS_DEFINE_FUNC_STAT(reader_next_subarray_partition)
+STATS_DEFINE_FUNC_STAT(reader_prefetch)
+STATS_DEFINE_FUNC_STAT(reader_prefetch_tiles)
 STATS_DEFINE_FUNC_STAT(reader_read)
 STATS_DEFINE_FUNC_STAT(reader_read_all_tiles)
 STATS_DEFINE_FUNC_STAT(reader_sort_coords)
 STATS_DEFINE_FUNC_STAT(reader_sparse_read)
+STATS_DEFINE_FUNC_STAT(reader_aggregate_read)
+STATS_DEFINE_FUNC_STAT(reader_apply_query_condition)
+STATS_DEFINE_FUNC_STAT(reader_compute_aggregates)
+STATS_DEFINE_FUNC_STAT(reader_compute_range_coords_sweep)
+STATS_DEFINE_FUNC_STAT(reader_count_result_cells)
 // Writer
 STATS_DEFINE_FUNC_STAT(writer_check_coord_dups)
-STATS_DEFINE_FUNC_STAT(writer_check_coord_dups_global)
-STATS_DEFINE_FUNC_STAT(writer_check_global_order)
+STATS_DEFINE_FUNC_STAT(writer_check_coords)
 STATS_DEFINE_FUNC_STAT(writer_compute_coord_dups)
 STATS_DEFINE_FUNC_STAT(writer_compute_coord_dups_global)
+STATS_DEFINE_FUNC_STAT(writer_compute_attr_metadata)
 STATS_DEFINE_FUNC_STAT(writer_compute_coords_metadata)
 STATS_DEFINE_FUNC_STAT(writer_compute_write_cell_ranges)
 STATS_DEFINE_FUNC_STAT(writer_create_fragment)
@@ -98,6 +114,8 @@ STATS_DEFINE_FUNC_STAT(writer_sort_coords)
 STATS_DEFINE_FUNC_STAT(writer_unordered_write)
 STATS_DEFINE_FUNC_STAT(writer_write)
 STATS_DEFINE_FUNC_STAT(writer_write_all_tiles)
+// Consolidator
+STATS_DEFINE_FUNC_STAT(consolidator_consolidate)
 // StorageManager
 STATS_DEFINE_FUNC_STAT(sm_array_close_for_reads)
 STATS_DEFINE_FUNC_STAT(sm_array_close_for_writes)
@@ -129,6 +147,7 @@ STATS_DEFINE_FUNC_STAT(vfs_is_dir)
 STATS_DEFINE_FUNC_STAT(vfs_is_empty_bucket)
 STATS_DEFINE_FUNC_STAT(vfs_is_file)
 STATS_DEFINE_FUNC_STAT(vfs_ls)
+STATS_DEFINE_FUNC_STAT(vfs_map_region)
 STATS_DEFINE_FUNC_STAT(vfs_move_dir)
 STATS_DEFINE_FUNC_STAT(vfs_move_file)
 STATS_DEFINE_FUNC_STAT(vfs_open_file)
@@ -139,6 +158,8 @@ STATS_DEFINE_FUNC_STAT(vfs_remove_dir)
 STATS_DEFINE_FUNC_STAT(vfs_remove_file)
 STATS_DEFINE_FUNC_STAT(vfs_s3_fill_file_buffer)
 STATS_DEFINE_FUNC_STAT(vfs_s3_write_multipart)
+STATS_DEFINE_FUNC_STAT(vfs_s3_remove_objects)
+STATS_DEFINE_FUNC_STAT(vfs_s3_ls_sharded)
 STATS_DEFINE_FUNC_STAT(vfs_supports_fs)
 STATS_DEFINE_FUNC_STAT(vfs_sync)
 STATS_DEFINE_FUNC_STAT(vfs_terminate)
@@ -183,6 +204,13 @@ STATS_INIT_FUNC_STAT(cache_lru_insert)
 STATS_INIT_FUNC_STAT(cache_lru_invalidate)
 STATS_INIT_FUNC_STAT(cache_lru_read)
 STATS_INIT_FUNC_STAT(cache_lru_read_partial)
+STATS_INIT_FUNC_STAT(cache_tile_evict)
+STATS_INIT_FUNC_STAT(cache_tile_insert)
+STATS_INIT_FUNC_STAT(cache_tile_invalidate)
+STATS_INIT_FUNC_STAT(cache_tile_pin)
+STATS_INIT_FUNC_STAT(cache_tile_read)
+STATS_INIT_FUNC_STAT(cache_disk_tile_read)
+STATS_INIT_FUNC_STAT(cache_disk_tile_write)
 // Reader
 STATS_INIT_FUNC_STAT(reader_compute_cell_ranges)
 STATS_INIT_FUNC_STAT(reader_compute_dense_cell_ranges)
@@ -193,21 +221,30 @@ STATS_INIT_FUNC_STAT(reader_compute_tile_coords)
 STATS_INIT_FUNC_STAT(reader_copy_fixed_cells)
 STATS_INIT_FUNC_STAT(reader_copy_var_cells)
 STATS_INIT_FUNC_STAT(reader_dedup_coords)
+STATS_INIT_FUNC_STAT(reader_dedup_coords_unordered)
+STATS_INIT_FUNC_STAT(reader_merge_coords)
 STATS_INIT_FUNC_STAT(reader_dense_read)
 STATS_INIT_FUNC_STAT(reader_fill_coords)
 STATS_INIT_FUNC_STAT(reader_filter_tiles)
 STATS_INIT_FUNC_STAT(reader_init_tile_fragment_dense_cell_range_iters)
 STATS_INIT_FUNC_STAT(reader_next_subarray_partition)
+STATS_INIT_FUNC_STAT(reader_prefetch)
+STATS_INIT_FUNC_STAT(reader_prefetch_tiles)
 STATS_INIT_FUNC_STAT(reader_read)
 STATS_INIT_FUNC_STAT(reader_read_all_tiles)
 STATS_INIT_FUNC_STAT(reader_sort_coords)
 STATS_INIT_FUNC_STAT(reader_sparse_read)
+STATS_INIT_FUNC_STAT(reader_aggregate_read)
+STATS_INIT_FUNC_STAT(reader_apply_query_condition)
+STATS_INIT_FUNC_STAT(reader_compute_aggregates)
+STATS_INIT_FUNC_STAT(reader_compute_range_coords_sweep)
+STATS_INIT_FUNC_STAT(reader_count_result_cells)
 // Writer
 STATS_INIT_FUNC_STAT(writer_check_coord_dups)
-STATS_INIT_FUNC_STAT(writer_check_coord_dups_global)
-STATS_INIT_FUNC_STAT(writer_check_global_order)
+STATS_INIT_FUNC_STAT(writer_check_coords)
 STATS_INIT_FUNC_STAT(writer_compute_coord_dups)
 STATS_INIT_FUNC_STAT(writer_compute_coord_dups_global)
+STATS_INIT_FUNC_STAT(writer_compute_attr_metadata)
 STATS_INIT_FUNC_STAT(writer_compute_coords_metadata)
 STATS_INIT_FUNC_STAT(writer_compute_write_cell_ranges)
 STATS_INIT_FUNC_STAT(writer_create_fragment)
@@ -225,6 +262,8 @@ STATS_INIT_FUNC_STAT(writer_sort_coords)
 STATS_INIT_FUNC_STAT(writer_unordered_write)
 STATS_INIT_FUNC_STAT(writer_write)
 STATS_INIT_FUNC_STAT(writer_write_all_tiles)
+// Consolidator
+STATS_INIT_FUNC_STAT(consolidator_consolidate)
 // StorageManager
 STATS_INIT_FUNC_STAT(sm_array_close_for_reads)
 STATS_INIT_FUNC_STAT(sm_array_close_for_writes)
@@ -256,6 +295,7 @@ STATS_INIT_FUNC_STAT(vfs_is_dir)
 STATS_INIT_FUNC_STAT(vfs_is_empty_bucket)
 STATS_INIT_FUNC_STAT(vfs_is_file)
 STATS_INIT_FUNC_STAT(vfs_ls)
+STATS_INIT_FUNC_STAT(vfs_map_region)
 STATS_INIT_FUNC_STAT(vfs_move_file)
 STATS_INIT_FUNC_STAT(vfs_move_dir)
 STATS_INIT_FUNC_STAT(vfs_open_file)
@@ -270,6 +310,8 @@ STATS_INIT_FUNC_STAT(vfs_terminate)
 STATS_INIT_FUNC_STAT(vfs_write)
 STATS_INIT_FUNC_STAT(vfs_s3_fill_file_buffer)
 STATS_INIT_FUNC_STAT(vfs_s3_write_multipart)
+STATS_INIT_FUNC_STAT(vfs_s3_remove_objects)
+STATS_INIT_FUNC_STAT(vfs_s3_ls_sharded)
 // Serialization
 STATS_INIT_FUNC_STAT(serialization_array_schema_serialize)
 STATS_INIT_FUNC_STAT(serialization_array_schema_deserialize)
@@ -310,6 +352,13 @@ STATS_REPORT_FUNC_STAT(cache_lru_insert)
 STATS_REPORT_FUNC_STAT(cache_lru_invalidate)
 STATS_REPORT_FUNC_STAT(cache_lru_read)
 STATS_REPORT_FUNC_STAT(cache_lru_read_partial)
+STATS_REPORT_FUNC_STAT(cache_tile_evict)
+STATS_REPORT_FUNC_STAT(cache_tile_insert)
+STATS_REPORT_FUNC_STAT(cache_tile_invalidate)
+STATS_REPORT_FUNC_STAT(cache_tile_pin)
+STATS_REPORT_FUNC_STAT(cache_tile_read)
+STATS_REPORT_FUNC_STAT(cache_disk_tile_read)
+STATS_REPORT_FUNC_STAT(cache_disk_tile_write)
 // Reader
 STATS_REPORT_FUNC_STAT(reader_compute_cell_ranges)
 STATS_REPORT_FUNC_STAT(reader_compute_dense_cell_ranges)
@@ -320,21 +369,30 @@ STATS_REPORT_FUNC_STAT(reader_compute_tile_coords)
 STATS_REPORT_FUNC_STAT(reader_copy_fixed_cells)
 STATS_REPORT_FUNC_STAT(reader_copy_var_cells)
 STATS_REPORT_FUNC_STAT(reader_dedup_coords)
+STATS_REPORT_FUNC_STAT(reader_dedup_coords_unordered)
+STATS_REPORT_FUNC_STAT(reader_merge_coords)
 STATS_REPORT_FUNC_STAT(reader_dense_read)
 STATS_REPORT_FUNC_STAT(reader_fill_coords)
 STATS_REPORT_FUNC_STAT(reader_filter_tiles)
 STATS_REPORT_FUNC_STAT(reader_init_tile_fragment_dense_cell_range_iters)
 STATS_REPORT_FUNC_STAT(reader_next_subarray_partition)
+STATS_REPORT_FUNC_STAT(reader_prefetch)
+STATS_REPORT_FUNC_STAT(reader_prefetch_tiles)
 STATS_REPORT_FUNC_STAT(reader_read)
 STATS_REPORT_FUNC_STAT(reader_read_all_tiles)
 STATS_REPORT_FUNC_STAT(reader_sort_coords)
 STATS_REPORT_FUNC_STAT(reader_sparse_read)
+STATS_REPORT_FUNC_STAT(reader_aggregate_read)
+STATS_REPORT_FUNC_STAT(reader_apply_query_condition)
+STATS_REPORT_FUNC_STAT(reader_compute_aggregates)
+STATS_REPORT_FUNC_STAT(reader_compute_range_coords_sweep)
+STATS_REPORT_FUNC_STAT(reader_count_result_cells)
 // Writer
 STATS_REPORT_FUNC_STAT(writer_check_coord_dups)
-STATS_REPORT_FUNC_STAT(writer_check_coord_dups_global)
-STATS_REPORT_FUNC_STAT(writer_check_global_order)
+STATS_REPORT_FUNC_STAT(writer_check_coords)
 STATS_REPORT_FUNC_STAT(writer_compute_coord_dups)
 STATS_REPORT_FUNC_STAT(writer_compute_coord_dups_global)
+STATS_REPORT_FUNC_STAT(writer_compute_attr_metadata)
 STATS_REPORT_FUNC_STAT(writer_compute_coords_metadata)
 STATS_REPORT_FUNC_STAT(writer_compute_write_cell_ranges)
 STATS_REPORT_FUNC_STAT(writer_create_fragment)
@@ -352,6 +410,8 @@ STATS_REPORT_FUNC_STAT(writer_sort_coords)
 STATS_REPORT_FUNC_STAT(writer_unordered_write)
 STATS_REPORT_FUNC_STAT(writer_write)
 STATS_REPORT_FUNC_STAT(writer_write_all_tiles)
+// Consolidator
+STATS_REPORT_FUNC_STAT(consolidator_consolidate)
 // StorageManager
 STATS_REPORT_FUNC_STAT(sm_array_close_for_reads)
 STATS_REPORT_FUNC_STAT(sm_array_close_for_writes)
@@ -383,6 +443,7 @@ STATS_REPORT_FUNC_STAT(vfs_is_dir)
 STATS_REPORT_FUNC_STAT(vfs_is_empty_bucket)
 STATS_REPORT_FUNC_STAT(vfs_is_file)
 STATS_REPORT_FUNC_STAT(vfs_ls)
+STATS_REPORT_FUNC_STAT(vfs_map_region)
 STATS_REPORT_FUNC_STAT(vfs_move_file)
 STATS_REPORT_FUNC_STAT(vfs_move_dir)
 STATS_REPORT_FUNC_STAT(vfs_open_file)
@@ -397,6 +458,8 @@ STATS_REPORT_FUNC_STAT(vfs_terminate)
 STATS_REPORT_FUNC_STAT(vfs_write)
 STATS_REPORT_FUNC_STAT(vfs_s3_fill_file_buffer)
 STATS_REPORT_FUNC_STAT(vfs_s3_write_multipart)
+STATS_REPORT_FUNC_STAT(vfs_s3_remove_objects)
+STATS_REPORT_FUNC_STAT(vfs_s3_ls_sharded)
 // Serialization
 STATS_REPORT_FUNC_STAT(serialization_array_schema_serialize)
 STATS_REPORT_FUNC_STAT(serialization_array_schema_deserialize)
@@ -413,9 +476,21 @@ STATS_REPORT_FUNC_STAT(rest_curl_delete)
 
 #ifdef STATS_DEFINE_COUNTER_STAT
 // Cache
+STATS_DEFINE_COUNTER_STAT(cache_buffer_pool_hits)
+STATS_DEFINE_COUNTER_STAT(cache_buffer_pool_misses)
 STATS_DEFINE_COUNTER_STAT(cache_lru_inserts)
 STATS_DEFINE_COUNTER_STAT(cache_lru_read_hits)
 STATS_DEFINE_COUNTER_STAT(cache_lru_read_misses)
+STATS_DEFINE_COUNTER_STAT(cache_tile_evictions)
+STATS_DEFINE_COUNTER_STAT(cache_tile_ghost_admissions)
+STATS_DEFINE_COUNTER_STAT(cache_tile_inserts)
+STATS_DEFINE_COUNTER_STAT(cache_tile_pinned_evictions)
+STATS_DEFINE_COUNTER_STAT(cache_tile_read_hits)
+STATS_DEFINE_COUNTER_STAT(cache_tile_read_misses)
+STATS_DEFINE_COUNTER_STAT(cache_disk_tile_evictions)
+STATS_DEFINE_COUNTER_STAT(cache_disk_tile_inserts)
+STATS_DEFINE_COUNTER_STAT(cache_disk_tile_read_hits)
+STATS_DEFINE_COUNTER_STAT(cache_disk_tile_read_misses)
 // Fragment Metadata
 STATS_DEFINE_COUNTER_STAT(fragment_metadata_num_fragments)
 STATS_DEFINE_COUNTER_STAT(fragment_metadata_bytes)
@@ -424,19 +499,64 @@ STATS_DEFINE_COUNTER_STAT(fragment_metadata_cached_bytes_copied)
 STATS_DEFINE_COUNTER_STAT(fragment_metadata_cache_inserts)
 STATS_DEFINE_COUNTER_STAT(fragment_metadata_cache_read_hits)
 STATS_DEFINE_COUNTER_STAT(fragment_metadata_cache_read_misses)
+STATS_DEFINE_COUNTER_STAT(index_cache_inserts)
+STATS_DEFINE_COUNTER_STAT(index_cache_read_hits)
+STATS_DEFINE_COUNTER_STAT(index_cache_read_misses)
 // Reader
 STATS_DEFINE_COUNTER_STAT(reader_attr_tile_cache_hits)
+STATS_DEFINE_COUNTER_STAT(reader_empty_subarray_hits)
+STATS_DEFINE_COUNTER_STAT(reader_managed_buffer_growths)
+STATS_DEFINE_COUNTER_STAT(reader_partition_tile_cache_hits)
+STATS_DEFINE_COUNTER_STAT(reader_num_offsets_overflows)
+STATS_DEFINE_COUNTER_STAT(reader_num_deadline_stops)
+STATS_DEFINE_COUNTER_STAT(reader_bloom_filter_skipped_fragments)
+STATS_DEFINE_COUNTER_STAT(reader_query_condition_skipped_tiles)
+STATS_DEFINE_COUNTER_STAT(reader_aggregate_metadata_tiles)
+STATS_DEFINE_COUNTER_STAT(reader_plan_num)
+STATS_DEFINE_COUNTER_STAT(reader_plan_index_fragments)
+STATS_DEFINE_COUNTER_STAT(reader_plan_scan_fragments)
+STATS_DEFINE_COUNTER_STAT(reader_plan_prefetch)
+STATS_DEFINE_COUNTER_STAT(reader_plan_balanced_splits)
+STATS_DEFINE_COUNTER_STAT(reader_plan_est_partitions)
+STATS_DEFINE_COUNTER_STAT(reader_count_metadata_tiles)
 STATS_DEFINE_COUNTER_STAT(reader_num_attr_tiles_touched)
 STATS_DEFINE_COUNTER_STAT(reader_num_bytes_after_filtering)
 STATS_DEFINE_COUNTER_STAT(reader_num_fixed_cell_bytes_copied)
+STATS_DEFINE_COUNTER_STAT(reader_num_tiles_unfiltered_in_place)
+STATS_DEFINE_COUNTER_STAT(reader_tile_memory_peak)
+STATS_DEFINE_COUNTER_STAT(reader_tile_memory_overflows)
+STATS_DEFINE_COUNTER_STAT(reader_num_tile_fetches_overlapped)
+STATS_DEFINE_COUNTER_STAT(reader_num_colocated_tile_fetches)
+STATS_DEFINE_COUNTER_STAT(reader_num_dim_tile_reads_skipped)
+STATS_DEFINE_COUNTER_STAT(reader_num_empty_result_tiles_removed)
+STATS_DEFINE_COUNTER_STAT(reader_num_coalesced_cell_slabs)
 STATS_DEFINE_COUNTER_STAT(reader_num_fixed_cell_bytes_read)
 STATS_DEFINE_COUNTER_STAT(reader_num_tile_bytes_read)
 STATS_DEFINE_COUNTER_STAT(reader_num_var_cell_bytes_copied)
 STATS_DEFINE_COUNTER_STAT(reader_num_var_cell_bytes_read)
+STATS_DEFINE_COUNTER_STAT(reader_coords_sorted_typed)
+// Subarray
+STATS_DEFINE_COUNTER_STAT(subarray_derived_tile_overlaps)
 // Writer
 STATS_DEFINE_COUNTER_STAT(writer_num_attr_tiles_written)
 STATS_DEFINE_COUNTER_STAT(writer_num_bytes_before_filtering)
 STATS_DEFINE_COUNTER_STAT(writer_num_bytes_written)
+STATS_DEFINE_COUNTER_STAT(writer_coords_sorted_on_keys)
+STATS_DEFINE_COUNTER_STAT(writer_coords_sorted_typed)
+STATS_DEFINE_COUNTER_STAT(writer_coords_already_sorted)
+STATS_DEFINE_COUNTER_STAT(writer_coords_sorted_runs_merged)
+STATS_DEFINE_COUNTER_STAT(writer_num_tiles_borrowed)
+STATS_DEFINE_COUNTER_STAT(writer_num_unordered_fragments_split)
+STATS_DEFINE_COUNTER_STAT(writer_num_packed_fragments)
+STATS_DEFINE_COUNTER_STAT(writer_num_buffered_writes)
+STATS_DEFINE_COUNTER_STAT(writer_num_write_buffer_flushes)
+STATS_DEFINE_COUNTER_STAT(writer_recommended_capacity)
+// Consolidator
+STATS_DEFINE_COUNTER_STAT(consolidator_num_steps)
+STATS_DEFINE_COUNTER_STAT(consolidator_num_fragments_consolidated)
+STATS_DEFINE_COUNTER_STAT(consolidator_num_bytes_read)
+STATS_DEFINE_COUNTER_STAT(consolidator_num_bytes_written)
+STATS_DEFINE_COUNTER_STAT(consolidator_num_tiles_copied)
 // StorageManager
 STATS_DEFINE_COUNTER_STAT(sm_contexts_created)
 STATS_DEFINE_COUNTER_STAT(sm_query_submit_layout_col_major)
@@ -445,6 +565,7 @@ STATS_DEFINE_COUNTER_STAT(sm_query_submit_layout_global_order)
 STATS_DEFINE_COUNTER_STAT(sm_query_submit_layout_unordered)
 STATS_DEFINE_COUNTER_STAT(sm_query_submit_read)
 STATS_DEFINE_COUNTER_STAT(sm_query_submit_write)
+STATS_DEFINE_COUNTER_STAT(sm_query_batch_num_queries)
 // TileIO
 STATS_DEFINE_COUNTER_STAT(tileio_read_num_bytes_read)
 STATS_DEFINE_COUNTER_STAT(tileio_read_num_resulting_bytes)
@@ -452,20 +573,60 @@ STATS_DEFINE_COUNTER_STAT(tileio_write_num_bytes_written)
 STATS_DEFINE_COUNTER_STAT(tileio_write_num_input_bytes)
 // VFS
 STATS_DEFINE_COUNTER_STAT(vfs_read_total_bytes)
+STATS_DEFINE_COUNTER_STAT(vfs_write_behind_num_flushes)
 STATS_DEFINE_COUNTER_STAT(vfs_write_total_bytes)
 STATS_DEFINE_COUNTER_STAT(vfs_read_num_parallelized)
 STATS_DEFINE_COUNTER_STAT(vfs_read_all_total_regions)
+STATS_DEFINE_COUNTER_STAT(vfs_read_all_adaptive_batches)
+STATS_DEFINE_COUNTER_STAT(vfs_read_all_bytes_requested)
+STATS_DEFINE_COUNTER_STAT(vfs_read_all_bytes_batched)
+STATS_DEFINE_COUNTER_STAT(vfs_file_num_reads)
+STATS_DEFINE_COUNTER_STAT(vfs_file_read_bytes)
+STATS_DEFINE_COUNTER_STAT(vfs_file_num_writes)
+STATS_DEFINE_COUNTER_STAT(vfs_file_write_bytes)
+STATS_DEFINE_COUNTER_STAT(vfs_hdfs_num_reads)
+STATS_DEFINE_COUNTER_STAT(vfs_hdfs_read_bytes)
+STATS_DEFINE_COUNTER_STAT(vfs_hdfs_num_writes)
+STATS_DEFINE_COUNTER_STAT(vfs_hdfs_write_bytes)
+STATS_DEFINE_COUNTER_STAT(vfs_s3_num_reads)
+STATS_DEFINE_COUNTER_STAT(vfs_s3_read_bytes)
+STATS_DEFINE_COUNTER_STAT(vfs_s3_num_writes)
+STATS_DEFINE_COUNTER_STAT(vfs_s3_write_bytes)
 STATS_DEFINE_COUNTER_STAT(vfs_posix_write_num_parallelized)
+STATS_DEFINE_COUNTER_STAT(vfs_posix_io_uring_num_submits)
+STATS_DEFINE_COUNTER_STAT(vfs_map_region_total_bytes)
 STATS_DEFINE_COUNTER_STAT(vfs_win32_write_num_parallelized)
+STATS_DEFINE_COUNTER_STAT(vfs_win32_overlapped_num_reads)
 STATS_DEFINE_COUNTER_STAT(vfs_s3_num_parts_written)
 STATS_DEFINE_COUNTER_STAT(vfs_s3_write_num_parallelized)
+STATS_DEFINE_COUNTER_STAT(vfs_s3_num_buffer_cap_flushes)
+STATS_DEFINE_COUNTER_STAT(vfs_s3_num_new_connections)
+STATS_DEFINE_COUNTER_STAT(vfs_s3_num_reused_connections)
+STATS_DEFINE_COUNTER_STAT(vfs_s3_num_retries)
+STATS_DEFINE_COUNTER_STAT(vfs_s3_num_delete_batches)
+STATS_DEFINE_COUNTER_STAT(vfs_s3_num_part_copies)
+STATS_DEFINE_COUNTER_STAT(vfs_s3_ls_num_shards)
+STATS_DEFINE_COUNTER_STAT(vfs_s3_num_hedged_reads)
+STATS_DEFINE_COUNTER_STAT(rest_cache_hits)
 #endif
 
 #ifdef STATS_INIT_COUNTER_STAT
 // Cache
+STATS_INIT_COUNTER_STAT(cache_buffer_pool_hits)
+STATS_INIT_COUNTER_STAT(cache_buffer_pool_misses)
 STATS_INIT_COUNTER_STAT(cache_lru_inserts)
 STATS_INIT_COUNTER_STAT(cache_lru_read_hits)
 STATS_INIT_COUNTER_STAT(cache_lru_read_misses)
+STATS_INIT_COUNTER_STAT(cache_tile_evictions)
+STATS_INIT_COUNTER_STAT(cache_tile_ghost_admissions)
+STATS_INIT_COUNTER_STAT(cache_tile_inserts)
+STATS_INIT_COUNTER_STAT(cache_tile_pinned_evictions)
+STATS_INIT_COUNTER_STAT(cache_tile_read_hits)
+STATS_INIT_COUNTER_STAT(cache_tile_read_misses)
+STATS_INIT_COUNTER_STAT(cache_disk_tile_evictions)
+STATS_INIT_COUNTER_STAT(cache_disk_tile_inserts)
+STATS_INIT_COUNTER_STAT(cache_disk_tile_read_hits)
+STATS_INIT_COUNTER_STAT(cache_disk_tile_read_misses)
 // Fragment Metadata
 STATS_INIT_COUNTER_STAT(fragment_metadata_num_fragments)
 STATS_INIT_COUNTER_STAT(fragment_metadata_bytes)
@@ -474,19 +635,64 @@ STATS_INIT_COUNTER_STAT(fragment_metadata_cached_bytes_copied)
 STATS_INIT_COUNTER_STAT(fragment_metadata_cache_inserts)
 STATS_INIT_COUNTER_STAT(fragment_metadata_cache_read_hits)
 STATS_INIT_COUNTER_STAT(fragment_metadata_cache_read_misses)
+STATS_INIT_COUNTER_STAT(index_cache_inserts)
+STATS_INIT_COUNTER_STAT(index_cache_read_hits)
+STATS_INIT_COUNTER_STAT(index_cache_read_misses)
 // Reader
 STATS_INIT_COUNTER_STAT(reader_attr_tile_cache_hits)
+STATS_INIT_COUNTER_STAT(reader_empty_subarray_hits)
+STATS_INIT_COUNTER_STAT(reader_managed_buffer_growths)
+STATS_INIT_COUNTER_STAT(reader_partition_tile_cache_hits)
+STATS_INIT_COUNTER_STAT(reader_num_offsets_overflows)
+STATS_INIT_COUNTER_STAT(reader_num_deadline_stops)
+STATS_INIT_COUNTER_STAT(reader_bloom_filter_skipped_fragments)
+STATS_INIT_COUNTER_STAT(reader_query_condition_skipped_tiles)
+STATS_INIT_COUNTER_STAT(reader_aggregate_metadata_tiles)
+STATS_INIT_COUNTER_STAT(reader_plan_num)
+STATS_INIT_COUNTER_STAT(reader_plan_index_fragments)
+STATS_INIT_COUNTER_STAT(reader_plan_scan_fragments)
+STATS_INIT_COUNTER_STAT(reader_plan_prefetch)
+STATS_INIT_COUNTER_STAT(reader_plan_balanced_splits)
+STATS_INIT_COUNTER_STAT(reader_plan_est_partitions)
+STATS_INIT_COUNTER_STAT(reader_count_metadata_tiles)
 STATS_INIT_COUNTER_STAT(reader_num_attr_tiles_touched)
 STATS_INIT_COUNTER_STAT(reader_num_bytes_after_filtering)
 STATS_INIT_COUNTER_STAT(reader_num_fixed_cell_bytes_copied)
+STATS_INIT_COUNTER_STAT(reader_num_tiles_unfiltered_in_place)
+STATS_INIT_COUNTER_STAT(reader_tile_memory_peak)
+STATS_INIT_COUNTER_STAT(reader_tile_memory_overflows)
+STATS_INIT_COUNTER_STAT(reader_num_tile_fetches_overlapped)
+STATS_INIT_COUNTER_STAT(reader_num_colocated_tile_fetches)
+STATS_INIT_COUNTER_STAT(reader_num_dim_tile_reads_skipped)
+STATS_INIT_COUNTER_STAT(reader_num_empty_result_tiles_removed)
+STATS_INIT_COUNTER_STAT(reader_num_coalesced_cell_slabs)
 STATS_INIT_COUNTER_STAT(reader_num_fixed_cell_bytes_read)
 STATS_INIT_COUNTER_STAT(reader_num_tile_bytes_read)
 STATS_INIT_COUNTER_STAT(reader_num_var_cell_bytes_copied)
 STATS_INIT_COUNTER_STAT(reader_num_var_cell_bytes_read)
+STATS_INIT_COUNTER_STAT(reader_coords_sorted_typed)
+// Subarray
+STATS_INIT_COUNTER_STAT(subarray_derived_tile_overlaps)
 // Writer
 STATS_INIT_COUNTER_STAT(writer_num_attr_tiles_written)
 STATS_INIT_COUNTER_STAT(writer_num_bytes_before_filtering)
 STATS_INIT_COUNTER_STAT(writer_num_bytes_written)
+STATS_INIT_COUNTER_STAT(writer_coords_sorted_on_keys)
+STATS_INIT_COUNTER_STAT(writer_coords_sorted_typed)
+STATS_INIT_COUNTER_STAT(writer_coords_already_sorted)
+STATS_INIT_COUNTER_STAT(writer_coords_sorted_runs_merged)
+STATS_INIT_COUNTER_STAT(writer_num_tiles_borrowed)
+STATS_INIT_COUNTER_STAT(writer_num_unordered_fragments_split)
+STATS_INIT_COUNTER_STAT(writer_num_packed_fragments)
+STATS_INIT_COUNTER_STAT(writer_num_buffered_writes)
+STATS_INIT_COUNTER_STAT(writer_num_write_buffer_flushes)
+STATS_INIT_COUNTER_STAT(writer_recommended_capacity)
+// Consolidator
+STATS_INIT_COUNTER_STAT(consolidator_num_steps)
+STATS_INIT_COUNTER_STAT(consolidator_num_fragments_consolidated)
+STATS_INIT_COUNTER_STAT(consolidator_num_bytes_read)
+STATS_INIT_COUNTER_STAT(consolidator_num_bytes_written)
+STATS_INIT_COUNTER_STAT(consolidator_num_tiles_copied)
 // StorageManager
 STATS_INIT_COUNTER_STAT(sm_contexts_created)
 STATS_INIT_COUNTER_STAT(sm_query_submit_layout_col_major)
@@ -495,6 +701,7 @@ STATS_INIT_COUNTER_STAT(sm_query_submit_layout_global_order)
 STATS_INIT_COUNTER_STAT(sm_query_submit_layout_unordered)
 STATS_INIT_COUNTER_STAT(sm_query_submit_read)
 STATS_INIT_COUNTER_STAT(sm_query_submit_write)
+STATS_INIT_COUNTER_STAT(sm_query_batch_num_queries)
 // TileIO
 STATS_INIT_COUNTER_STAT(tileio_read_num_bytes_read)
 STATS_INIT_COUNTER_STAT(tileio_read_num_resulting_bytes)
@@ -502,20 +709,60 @@ STATS_INIT_COUNTER_STAT(tileio_write_num_bytes_written)
 STATS_INIT_COUNTER_STAT(tileio_write_num_input_bytes)
 // VFS
 STATS_INIT_COUNTER_STAT(vfs_read_total_bytes)
+STATS_INIT_COUNTER_STAT(vfs_write_behind_num_flushes)
 STATS_INIT_COUNTER_STAT(vfs_write_total_bytes)
 STATS_INIT_COUNTER_STAT(vfs_read_num_parallelized)
 STATS_INIT_COUNTER_STAT(vfs_read_all_total_regions)
+STATS_INIT_COUNTER_STAT(vfs_read_all_adaptive_batches)
+STATS_INIT_COUNTER_STAT(vfs_read_all_bytes_requested)
+STATS_INIT_COUNTER_STAT(vfs_read_all_bytes_batched)
+STATS_INIT_COUNTER_STAT(vfs_file_num_reads)
+STATS_INIT_COUNTER_STAT(vfs_file_read_bytes)
+STATS_INIT_COUNTER_STAT(vfs_file_num_writes)
+STATS_INIT_COUNTER_STAT(vfs_file_write_bytes)
+STATS_INIT_COUNTER_STAT(vfs_hdfs_num_reads)
+STATS_INIT_COUNTER_STAT(vfs_hdfs_read_bytes)
+STATS_INIT_COUNTER_STAT(vfs_hdfs_num_writes)
+STATS_INIT_COUNTER_STAT(vfs_hdfs_write_bytes)
+STATS_INIT_COUNTER_STAT(vfs_s3_num_reads)
+STATS_INIT_COUNTER_STAT(vfs_s3_read_bytes)
+STATS_INIT_COUNTER_STAT(vfs_s3_num_writes)
+STATS_INIT_COUNTER_STAT(vfs_s3_write_bytes)
 STATS_INIT_COUNTER_STAT(vfs_posix_write_num_parallelized)
+STATS_INIT_COUNTER_STAT(vfs_posix_io_uring_num_submits)
+STATS_INIT_COUNTER_STAT(vfs_map_region_total_bytes)
 STATS_INIT_COUNTER_STAT(vfs_win32_write_num_parallelized)
+STATS_INIT_COUNTER_STAT(vfs_win32_overlapped_num_reads)
 STATS_INIT_COUNTER_STAT(vfs_s3_num_parts_written)
 STATS_INIT_COUNTER_STAT(vfs_s3_write_num_parallelized)
+STATS_INIT_COUNTER_STAT(vfs_s3_num_buffer_cap_flushes)
+STATS_INIT_COUNTER_STAT(vfs_s3_num_new_connections)
+STATS_INIT_COUNTER_STAT(vfs_s3_num_reused_connections)
+STATS_INIT_COUNTER_STAT(vfs_s3_num_retries)
+STATS_INIT_COUNTER_STAT(vfs_s3_num_delete_batches)
+STATS_INIT_COUNTER_STAT(vfs_s3_num_part_copies)
+STATS_INIT_COUNTER_STAT(vfs_s3_ls_num_shards)
+STATS_INIT_COUNTER_STAT(vfs_s3_num_hedged_reads)
+STATS_INIT_COUNTER_STAT(rest_cache_hits)
 #endif
 
 #ifdef STATS_REPORT_COUNTER_STAT
 // Cache
+STATS_REPORT_COUNTER_STAT(cache_buffer_pool_hits)
+STATS_REPORT_COUNTER_STAT(cache_buffer_pool_misses)
 STATS_REPORT_COUNTER_STAT(cache_lru_inserts)
 STATS_REPORT_COUNTER_STAT(cache_lru_read_hits)
 STATS_REPORT_COUNTER_STAT(cache_lru_read_misses)
+STATS_REPORT_COUNTER_STAT(cache_tile_evictions)
+STATS_REPORT_COUNTER_STAT(cache_tile_ghost_admissions)
+STATS_REPORT_COUNTER_STAT(cache_tile_inserts)
+STATS_REPORT_COUNTER_STAT(cache_tile_pinned_evictions)
+STATS_REPORT_COUNTER_STAT(cache_tile_read_hits)
+STATS_REPORT_COUNTER_STAT(cache_tile_read_misses)
+STATS_REPORT_COUNTER_STAT(cache_disk_tile_evictions)
+STATS_REPORT_COUNTER_STAT(cache_disk_tile_inserts)
+STATS_REPORT_COUNTER_STAT(cache_disk_tile_read_hits)
+STATS_REPORT_COUNTER_STAT(cache_disk_tile_read_misses)
 // Fragment Metadata
 STATS_REPORT_COUNTER_STAT(fragment_metadata_num_fragments)
 STATS_REPORT_COUNTER_STAT(fragment_metadata_bytes)
@@ -524,19 +771,64 @@ STATS_REPORT_COUNTER_STAT(fragment_metadata_cached_bytes_copied)
 STATS_REPORT_COUNTER_STAT(fragment_metadata_cache_inserts)
 STATS_REPORT_COUNTER_STAT(fragment_metadata_cache_read_hits)
 STATS_REPORT_COUNTER_STAT(fragment_metadata_cache_read_misses)
+STATS_REPORT_COUNTER_STAT(index_cache_inserts)
+STATS_REPORT_COUNTER_STAT(index_cache_read_hits)
+STATS_REPORT_COUNTER_STAT(index_cache_read_misses)
 // Reader
 STATS_REPORT_COUNTER_STAT(reader_attr_tile_cache_hits)
+STATS_REPORT_COUNTER_STAT(reader_empty_subarray_hits)
+STATS_REPORT_COUNTER_STAT(reader_managed_buffer_growths)
+STATS_REPORT_COUNTER_STAT(reader_partition_tile_cache_hits)
+STATS_REPORT_COUNTER_STAT(reader_num_offsets_overflows)
+STATS_REPORT_COUNTER_STAT(reader_num_deadline_stops)
+STATS_REPORT_COUNTER_STAT(reader_bloom_filter_skipped_fragments)
+STATS_REPORT_COUNTER_STAT(reader_query_condition_skipped_tiles)
+STATS_REPORT_COUNTER_STAT(reader_aggregate_metadata_tiles)
+STATS_REPORT_COUNTER_STAT(reader_plan_num)
+STATS_REPORT_COUNTER_STAT(reader_plan_index_fragments)
+STATS_REPORT_COUNTER_STAT(reader_plan_scan_fragments)
+STATS_REPORT_COUNTER_STAT(reader_plan_prefetch)
+STATS_REPORT_COUNTER_STAT(reader_plan_balanced_splits)
+STATS_REPORT_COUNTER_STAT(reader_plan_est_partitions)
+STATS_REPORT_COUNTER_STAT(reader_count_metadata_tiles)
 STATS_REPORT_COUNTER_STAT(reader_num_attr_tiles_touched)
 STATS_REPORT_COUNTER_STAT(reader_num_bytes_after_filtering)
 STATS_REPORT_COUNTER_STAT(reader_num_fixed_cell_bytes_copied)
+STATS_REPORT_COUNTER_STAT(reader_num_tiles_unfiltered_in_place)
+STATS_REPORT_COUNTER_STAT(reader_tile_memory_peak)
+STATS_REPORT_COUNTER_STAT(reader_tile_memory_overflows)
+STATS_REPORT_COUNTER_STAT(reader_num_tile_fetches_overlapped)
+STATS_REPORT_COUNTER_STAT(reader_num_colocated_tile_fetches)
+STATS_REPORT_COUNTER_STAT(reader_num_dim_tile_reads_skipped)
+STATS_REPORT_COUNTER_STAT(reader_num_empty_result_tiles_removed)
+STATS_REPORT_COUNTER_STAT(reader_num_coalesced_cell_slabs)
 STATS_REPORT_COUNTER_STAT(reader_num_fixed_cell_bytes_read)
 STATS_REPORT_COUNTER_STAT(reader_num_tile_bytes_read)
 STATS_REPORT_COUNTER_STAT(reader_num_var_cell_bytes_copied)
 STATS_REPORT_COUNTER_STAT(reader_num_var_cell_bytes_read)
+STATS_REPORT_COUNTER_STAT(reader_coords_sorted_typed)
+// Subarray
+STATS_REPORT_COUNTER_STAT(subarray_derived_tile_overlaps)
 // Writer
 STATS_REPORT_COUNTER_STAT(writer_num_attr_tiles_written)
 STATS_REPORT_COUNTER_STAT(writer_num_bytes_before_filtering)
 STATS_REPORT_COUNTER_STAT(writer_num_bytes_written)
+STATS_REPORT_COUNTER_STAT(writer_coords_sorted_on_keys)
+STATS_REPORT_COUNTER_STAT(writer_coords_sorted_typed)
+STATS_REPORT_COUNTER_STAT(writer_coords_already_sorted)
+STATS_REPORT_COUNTER_STAT(writer_coords_sorted_runs_merged)
+STATS_REPORT_COUNTER_STAT(writer_num_tiles_borrowed)
+STATS_REPORT_COUNTER_STAT(writer_num_unordered_fragments_split)
+STATS_REPORT_COUNTER_STAT(writer_num_packed_fragments)
+STATS_REPORT_COUNTER_STAT(writer_num_buffered_writes)
+STATS_REPORT_COUNTER_STAT(writer_num_write_buffer_flushes)
+STATS_REPORT_COUNTER_STAT(writer_recommended_capacity)
+// Consolidator
+STATS_REPORT_COUNTER_STAT(consolidator_num_steps)
+STATS_REPORT_COUNTER_STAT(consolidator_num_fragments_consolidated)
+STATS_REPORT_COUNTER_STAT(consolidator_num_bytes_read)
+STATS_REPORT_COUNTER_STAT(consolidator_num_bytes_written)
+STATS_REPORT_COUNTER_STAT(consolidator_num_tiles_copied)
 // StorageManager
 STATS_REPORT_COUNTER_STAT(sm_contexts_created)
 STATS_REPORT_COUNTER_STAT(sm_query_submit_layout_col_major)
@@ -545,6 +837,7 @@ STATS_REPORT_COUNTER_STAT(sm_query_submit_layout_global_order)
 STATS_REPORT_COUNTER_STAT(sm_query_submit_layout_unordered)
 STATS_REPORT_COUNTER_STAT(sm_query_submit_read)
 STATS_REPORT_COUNTER_STAT(sm_query_submit_write)
+STATS_REPORT_COUNTER_STAT(sm_query_batch_num_queries)
 // TileIO
 STATS_REPORT_COUNTER_STAT(tileio_read_num_bytes_read)
 STATS_REPORT_COUNTER_STAT(tileio_read_num_resulting_bytes)
@@ -552,11 +845,81 @@ STATS_REPORT_COUNTER_STAT(tileio_write_num_bytes_written)
 STATS_REPORT_COUNTER_STAT(tileio_write_num_input_bytes)
 // VFS
 STATS_REPORT_COUNTER_STAT(vfs_read_total_bytes)
+STATS_REPORT_COUNTER_STAT(vfs_write_behind_num_flushes)
 STATS_REPORT_COUNTER_STAT(vfs_write_total_bytes)
 STATS_REPORT_COUNTER_STAT(vfs_read_num_parallelized)
 STATS_REPORT_COUNTER_STAT(vfs_read_all_total_regions)
+STATS_REPORT_COUNTER_STAT(vfs_read_all_adaptive_batches)
+STATS_REPORT_COUNTER_STAT(vfs_read_all_bytes_requested)
+STATS_REPORT_COUNTER_STAT(vfs_read_all_bytes_batched)
+STATS_REPORT_COUNTER_STAT(vfs_file_num_reads)
+STATS_REPORT_COUNTER_STAT(vfs_file_read_bytes)
+STATS_REPORT_COUNTER_STAT(vfs_file_num_writes)
+STATS_REPORT_COUNTER_STAT(vfs_file_write_bytes)
+STATS_REPORT_COUNTER_STAT(vfs_hdfs_num_reads)
+STATS_REPORT_COUNTER_STAT(vfs_hdfs_read_bytes)
+STATS_REPORT_COUNTER_STAT(vfs_hdfs_num_writes)
+STATS_REPORT_COUNTER_STAT(vfs_hdfs_write_bytes)
+STATS_REPORT_COUNTER_STAT(vfs_s3_num_reads)
+STATS_REPORT_COUNTER_STAT(vfs_s3_read_bytes)
+STATS_REPORT_COUNTER_STAT(vfs_s3_num_writes)
+STATS_REPORT_COUNTER_STAT(vfs_s3_write_bytes)
 STATS_REPORT_COUNTER_STAT(vfs_posix_write_num_parallelized)
+STATS_REPORT_COUNTER_STAT(vfs_posix_io_uring_num_submits)
+STATS_REPORT_COUNTER_STAT(vfs_map_region_total_bytes)
 STATS_REPORT_COUNTER_STAT(vfs_win32_write_num_parallelized)
+STATS_REPORT_COUNTER_STAT(vfs_win32_overlapped_num_reads)
 STATS_REPORT_COUNTER_STAT(vfs_s3_num_parts_written)
 STATS_REPORT_COUNTER_STAT(vfs_s3_write_num_parallelized)
+STATS_REPORT_COUNTER_STAT(vfs_s3_num_buffer_cap_flushes)
+STATS_REPORT_COUNTER_STAT(vfs_s3_num_new_connections)
+STATS_REPORT_COUNTER_STAT(vfs_s3_num_reused_connections)
+STATS_REPORT_COUNTER_STAT(vfs_s3_num_retries)
+STATS_REPORT_COUNTER_STAT(vfs_s3_num_delete_batches)
+STATS_REPORT_COUNTER_STAT(vfs_s3_num_part_copies)
+STATS_REPORT_COUNTER_STAT(vfs_s3_ls_num_shards)
+STATS_REPORT_COUNTER_STAT(vfs_s3_num_hedged_reads)
+STATS_REPORT_COUNTER_STAT(rest_cache_hits)
+#endif
+
+#ifdef STATS_DEFINE_HISTOGRAM_STAT
+STATS_DEFINE_HISTOGRAM_STAT(filter_pipeline_run_forward)
+STATS_DEFINE_HISTOGRAM_STAT(filter_pipeline_run_reverse)
+STATS_DEFINE_HISTOGRAM_STAT(reader_read)
+STATS_DEFINE_HISTOGRAM_STAT(reader_read_tiles)
+STATS_DEFINE_HISTOGRAM_STAT(vfs_read_file)
+STATS_DEFINE_HISTOGRAM_STAT(vfs_read_hdfs)
+STATS_DEFINE_HISTOGRAM_STAT(vfs_read_s3)
+STATS_DEFINE_HISTOGRAM_STAT(vfs_write_file)
+STATS_DEFINE_HISTOGRAM_STAT(vfs_write_hdfs)
+STATS_DEFINE_HISTOGRAM_STAT(vfs_write_s3)
+STATS_DEFINE_HISTOGRAM_STAT(writer_write)
+#endif
+
+#ifdef STATS_INIT_HISTOGRAM_STAT
+STATS_INIT_HISTOGRAM_STAT(filter_pipeline_run_forward)
+STATS_INIT_HISTOGRAM_STAT(filter_pipeline_run_reverse)
+STATS_INIT_HISTOGRAM_STAT(reader_read)
+STATS_INIT_HISTOGRAM_STAT(reader_read_tiles)
+STATS_INIT_HISTOGRAM_STAT(vfs_read_file)
+STATS_INIT_HISTOGRAM_STAT(vfs_read_hdfs)
+STATS_INIT_HISTOGRAM_STAT(vfs_read_s3)
+STATS_INIT_HISTOGRAM_STAT(vfs_write_file)
+STATS_INIT_HISTOGRAM_STAT(vfs_write_hdfs)
+STATS_INIT_HISTOGRAM_STAT(vfs_write_s3)
+STATS_INIT_HISTOGRAM_STAT(writer_write)
+#endif
+
+#ifdef STATS_REPORT_HISTOGRAM_STAT
+STATS_REPORT_HISTOGRAM_STAT(filter_pipeline_run_forward)
+STATS_REPORT_HISTOGRAM_STAT(filter_pipeline_run_reverse)
+STATS_REPORT_HISTOGRAM_STAT(reader_read)
+STATS_REPORT_HISTOGRAM_STAT(reader_read_tiles)
+STATS_REPORT_HISTOGRAM_STAT(vfs_read_file)
+STATS_REPORT_HISTOGRAM_STAT(vfs_read_hdfs)
+STATS_REPORT_HISTOGRAM_STAT(vfs_read_s3)
+STATS_REPORT_HISTOGRAM_STAT(vfs_write_file)
+STATS_REPORT_HISTOGRAM_STAT(vfs_write_hdfs)
+STATS_REPORT_HISTOGRAM_STAT(vfs_write_s3)
+STATS_REPORT_HISTOGRAM_STAT(writer_write)
 #endif
@@ -219,6 +219,9 @@ std::string Status::code_to_string() const {
     case StatusCode::SerializationError:
       type = "[TileDB::Serialization] Error";
       break;
+    case StatusCode::QueryConditionError:
+      type = "[TileDB::QueryCondition] Error";
+      break;
     default:
       type = "[TileDB::?] Error:";
   }
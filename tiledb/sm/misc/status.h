@@ -118,7 +118,8 @@ enum class StatusCode : char {
   RTreeError,
   CellSlabIterError,
   RestError,
-  SerializationError
+  SerializationError,
+  QueryConditionError
 };
 
 class Status {
@@ -366,6 +367,11 @@ class Status {
     return Status(StatusCode::SerializationError, msg, -1);
   }
 
+  /** Return a QueryConditionError error class Status with a given message **/
+  static Status QueryConditionError(const std::string& msg) {
+    return Status(StatusCode::QueryConditionError, msg, -1);
+  }
+
   /** Returns true iff the status indicates success **/
   bool ok() const {
     return (state_ == nullptr);
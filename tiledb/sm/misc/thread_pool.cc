@@ -33,25 +33,76 @@
 #include <cassert>
 
 #include "tiledb/sm/misc/logger.h"
+#include "tiledb/sm/misc/numa.h"
+#include "tiledb/sm/misc/stats.h"
 #include "tiledb/sm/misc/thread_pool.h"
 
 namespace tiledb {
 namespace sm {
 
+namespace {
+
+/** The pool the calling thread is a worker of, if any. */
+thread_local ThreadPool* worker_pool = nullptr;
+
+/** The index of the calling thread among the workers of `worker_pool`. */
+thread_local uint64_t worker_index = 0;
+
+/** The priority class of the task the calling thread is executing. */
+thread_local ThreadPool::Priority task_priority =
+    ThreadPool::Priority::COMPUTE;
+
+/** Returns `true` if the tasks enqueued by a task of `p` inherit `p`. */
+bool is_inherited(ThreadPool::Priority p) {
+  return p == ThreadPool::Priority::HIGH ||
+         p == ThreadPool::Priority::BACKGROUND;
+}
+
+/** Returns `true` if the given task has completed. */
+bool is_ready(const std::future<Status>& future) {
+  return future.wait_for(std::chrono::seconds(0)) ==
+         std::future_status::ready;
+}
+
+}  // namespace
+
 ThreadPool::ThreadPool() {
   should_terminate_ = false;
+  pending_ = 0;
+  for (unsigned p = 0; p < PRIORITY_NUM; ++p)
+    class_pending_[p] = 0;
+  idle_workers_ = 0;
+  waiters_ = 0;
+  next_queue_ = 0;
+  priority_ = Priority::COMPUTE;
+  scheduler_ = nullptr;
+  inflight_ = 0;
 }
 
 ThreadPool::~ThreadPool() {
   terminate();
 }
 
-Status ThreadPool::init(uint64_t num_threads) {
+ThreadPool::PriorityScope::PriorityScope(Priority priority)
+    : prev_priority_(task_priority) {
+  task_priority = priority;
+}
+
+ThreadPool::PriorityScope::~PriorityScope() {
+  task_priority = prev_priority_;
+}
+
+Status ThreadPool::init(uint64_t num_threads, Priority priority) {
   Status st = Status::Ok();
+  priority_ = priority;
+
+  // The deques must all exist before any worker starts stealing
+  for (uint64_t i = 0; i < num_threads; i++)
+    queues_.emplace_back(new TaskQueue());
 
   for (uint64_t i = 0; i < num_threads; i++) {
     try {
-      threads_.emplace_back([this]() { worker(*this); });
+      threads_.emplace_back([this, i]() { worker(*this, i); });
     } catch (const std::exception& e) {
       st = Status::Error(
           "Error allocating thread pool of " + std::to_string(num_threads) +
@@ -69,34 +120,119 @@ Status ThreadPool::init(uint64_t num_threads) {
   return st;
 }
 
+Status ThreadPool::init(ThreadPool* scheduler, Priority priority) {
+  assert(scheduler != nullptr && scheduler != this);
+  if (!threads_.empty())
+    return LOG_STATUS(Status::Error(
+        "Cannot initialize thread pool view; pool already has threads"));
+
+  scheduler_ = scheduler;
+  priority_ = priority;
+
+  return Status::Ok();
+}
+
 std::future<Status> ThreadPool::enqueue(std::function<Status()>&& function) {
+  return enqueue(std::move(function), priority_);
+}
+
+std::future<Status> ThreadPool::enqueue(
+    std::function<Status()>&& function, Priority priority) {
+  if (is_inherited(task_priority))
+    priority = task_priority;
+
+  // A view counts its outstanding tasks, so that it can wait for them when
+  // it is destroyed
+  if (scheduler_ != nullptr) {
+    {
+      std::unique_lock<std::mutex> lck(mtx_);
+      if (should_terminate_) {
+        std::future<Status> invalid_future;
+        LOG_ERROR("Cannot enqueue task; thread pool has terminated.");
+        return invalid_future;
+      }
+      ++inflight_;
+    }
+
+    auto fn = std::move(function);
+    auto future = scheduler_->enqueue(
+        [this, fn]() {
+          auto st = fn();
+          std::unique_lock<std::mutex> lck(mtx_);
+          --inflight_;
+          done_cv_.notify_all();
+          return st;
+        },
+        priority);
+    if (!future.valid()) {
+      std::unique_lock<std::mutex> lck(mtx_);
+      --inflight_;
+      done_cv_.notify_all();
+    }
+    return future;
+  }
+
   if (threads_.empty()) {
     std::future<Status> invalid_future;
     LOG_ERROR("Cannot enqueue task; thread pool has no threads.");
     return invalid_future;
   }
 
-  std::unique_lock<std::mutex> lck(queue_mutex_);
-
+  // Announce the task before checking for termination, so that the workers
+  // do not exit while it is being pushed
+  ++pending_;
   if (should_terminate_) {
+    --pending_;
     std::future<Status> invalid_future;
     LOG_ERROR("Cannot enqueue task; thread pool has terminated.");
     return invalid_future;
   }
 
-  std::packaged_task<Status()> task(move(function));
+  // The task adds to the stats of the query enqueuing it, which it keeps
+  // alive in case it outlives the query
+  auto query_stats = stats::query_stats();
+  if (query_stats != nullptr) {
+    auto fn = std::move(function);
+    auto task_stats = query_stats->shared_from_this();
+    function = [task_stats, fn]() {
+      stats::QueryStatsScope stats_scope(task_stats.get());
+      return fn();
+    };
+  }
+
+  std::packaged_task<Status()> task(std::move(function));
   auto future = task.get_future();
 
-  task_queue_.push(std::move(task));
-  queue_cv_.notify_one();
-  lck.unlock();
+  auto queue_idx = (worker_pool == this) ?
+                       worker_index :
+                       (next_queue_++ % queues_.size());
+  auto p = static_cast<unsigned>(priority);
+  {
+    auto& queue = *queues_[queue_idx];
+    std::unique_lock<std::mutex> lck(queue.mtx_);
+    queue.tasks_[p].push_back(std::move(task));
+    ++class_pending_[p];
+  }
+
+  if (idle_workers_ > 0) {
+    std::unique_lock<std::mutex> lck(mtx_);
+    work_cv_.notify_one();
+  }
+  notify_waiters();
 
   assert(future.valid());
   return future;
 }
 
+Status ThreadPool::pin_numa_nodes() {
+  for (uint64_t i = 0; i < threads_.size(); ++i)
+    RETURN_NOT_OK(numa::pin_thread(threads_[i].native_handle(), i));
+
+  return Status::Ok();
+}
+
 uint64_t ThreadPool::num_threads() const {
-  return threads_.size();
+  return (scheduler_ != nullptr) ? scheduler_->num_threads() : threads_.size();
 }
 
 Status ThreadPool::wait_all(std::vector<std::future<Status>>& tasks) {
@@ -117,7 +253,8 @@ std::vector<Status> ThreadPool::wait_all_status(
       LOG_ERROR("Waiting on invalid future.");
       statuses.push_back(Status::Error("Invalid future"));
     } else {
-      Status status = future.get();
+      Status status =
+          (scheduler_ != nullptr) ? scheduler_->wait(future) : wait(future);
       if (!status.ok()) {
         LOG_STATUS(status);
       }
@@ -127,11 +264,105 @@ std::vector<Status> ThreadPool::wait_all_status(
   return statuses;
 }
 
+bool ThreadPool::pop_task(
+    std::packaged_task<Status()>* task, Priority* priority) {
+  auto queue_num = queues_.size();
+  if (queue_num == 0)
+    return false;
+
+  bool is_worker = (worker_pool == this);
+  uint64_t first = is_worker ? worker_index : 0;
+  for (unsigned p = 0; p < PRIORITY_NUM; ++p) {
+    if (class_pending_[p] == 0)
+      continue;
+
+    // The calling worker takes its most recent task first, then steals the
+    // oldest task of another deque
+    for (uint64_t i = 0; i < queue_num; ++i) {
+      bool own = is_worker && i == 0;
+      auto& queue = *queues_[(first + i) % queue_num];
+      std::unique_lock<std::mutex> lck(queue.mtx_);
+      auto& tasks = queue.tasks_[p];
+      if (tasks.empty())
+        continue;
+      if (own) {
+        *task = std::move(tasks.back());
+        tasks.pop_back();
+      } else {
+        *task = std::move(tasks.front());
+        tasks.pop_front();
+      }
+      --class_pending_[p];
+      --pending_;
+      *priority = static_cast<Priority>(p);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool ThreadPool::run_pending_task() {
+  std::packaged_task<Status()> task;
+  Priority priority;
+  if (!pop_task(&task, &priority))
+    return false;
+
+  // Nested tasks of a high priority or background task inherit its class
+  auto prev_priority = task_priority;
+  task_priority = priority;
+  task();
+  task_priority = prev_priority;
+  notify_waiters();
+
+  return true;
+}
+
+void ThreadPool::notify_waiters() {
+  // Pairs with the fence in `wait`, so that either the waiter sees the
+  // completed task or this sees the waiter
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (waiters_ > 0) {
+    std::unique_lock<std::mutex> lck(mtx_);
+    done_cv_.notify_all();
+  }
+}
+
+Status ThreadPool::wait(std::future<Status>& future) {
+  // Only the workers help, so that the pool never runs more tasks at once
+  // than it has threads
+  if (worker_pool != this)
+    return future.get();
+
+  while (!is_ready(future)) {
+    if (run_pending_task())
+      continue;
+
+    // Nothing to help with; sleep until a task is enqueued or completes
+    std::unique_lock<std::mutex> lck(mtx_);
+    ++waiters_;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    done_cv_.wait(
+        lck, [this, &future]() { return is_ready(future) || pending_ > 0; });
+    --waiters_;
+  }
+
+  return future.get();
+}
+
 void ThreadPool::terminate() {
+  if (scheduler_ != nullptr) {
+    std::unique_lock<std::mutex> lck(mtx_);
+    should_terminate_ = true;
+    done_cv_.wait(lck, [this]() { return inflight_ == 0; });
+    return;
+  }
+
   {
-    std::unique_lock<std::mutex> lck(queue_mutex_);
+    std::unique_lock<std::mutex> lck(mtx_);
     should_terminate_ = true;
-    queue_cv_.notify_all();
+    work_cv_.notify_all();
+    done_cv_.notify_all();
   }
 
   for (auto& t : threads_) {
@@ -141,31 +372,28 @@ void ThreadPool::terminate() {
   threads_.clear();
 }
 
-void ThreadPool::worker(ThreadPool& pool) {
-  while (true) {
-    std::packaged_task<Status()> task;
-
-    {
-      // Wait until there's work to do.
-      std::unique_lock<std::mutex> lck(pool.queue_mutex_);
-      pool.queue_cv_.wait(lck, [&pool]() {
-        return pool.should_terminate_ || !pool.task_queue_.empty();
-      });
-
-      if (!pool.task_queue_.empty()) {
-        task = std::move(pool.task_queue_.front());
-        pool.task_queue_.pop();
-      }
-    }
+void ThreadPool::worker(ThreadPool& pool, uint64_t index) {
+  worker_pool = &pool;
+  worker_index = index;
 
-    if (task.valid()) {
-      task();
-    }
+  while (true) {
+    if (pool.run_pending_task())
+      continue;
 
-    if (pool.should_terminate_) {
+    // Drain all enqueued tasks before exiting
+    std::unique_lock<std::mutex> lck(pool.mtx_);
+    if (pool.should_terminate_ && pool.pending_ == 0)
       break;
-    }
+
+    // Wait until there's work to do.
+    ++pool.idle_workers_;
+    pool.work_cv_.wait(lck, [&pool]() {
+      return pool.should_terminate_ || pool.pending_ > 0;
+    });
+    --pool.idle_workers_;
   }
+
+  worker_pool = nullptr;
 }
 
 }  // namespace sm
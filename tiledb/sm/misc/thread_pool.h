@@ -33,10 +33,12 @@
 #ifndef TILEDB_THREAD_POOL_H
 #define TILEDB_THREAD_POOL_H
 
+#include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <future>
+#include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
 #include <vector>
 
@@ -46,10 +48,48 @@ namespace tiledb {
 namespace sm {
 
 /**
- * Thread pool class.
+ * Work-stealing thread pool class.
+ *
+ * Every worker owns a task deque. Tasks enqueued by a worker go to the back
+ * of its own deque, tasks enqueued by other threads are distributed round
+ * robin. A worker pops from the back of its own deque and, when that is
+ * empty, steals from the front of the others. Workers waiting on tasks via
+ * `wait_all` execute pending tasks instead of sleeping, so that waiting on
+ * tasks from within a task of the same pool cannot deadlock.
+ *
+ * Tasks belong to a priority class; pending tasks of a more urgent class run
+ * first. A pool may also be initialized as a view of another pool, the
+ * scheduler, in which case its tasks run on the threads of the scheduler.
  */
 class ThreadPool {
  public:
+  /**
+   * Task priority classes, from the most to the least urgent. `HIGH` and
+   * `BACKGROUND` are inherited: the tasks enqueued by a task of these
+   * classes (or within a `PriorityScope` of them) belong to the same class.
+   */
+  enum class Priority : uint8_t { HIGH, IO, COMPUTE, BACKGROUND };
+
+  /**
+   * Sets the priority class of the calling thread until destroyed, e.g., to
+   * give all the tasks of a query the priority of the query.
+   */
+  class PriorityScope {
+   public:
+    /** Constructor. */
+    explicit PriorityScope(Priority priority);
+
+    /** Destructor, restores the previous priority class of the thread. */
+    ~PriorityScope();
+
+    PriorityScope(const PriorityScope&) = delete;
+    PriorityScope& operator=(const PriorityScope&) = delete;
+
+   private:
+    /** The priority class of the thread before the scope. */
+    Priority prev_priority_;
+  };
+
   /** Constructor. */
   ThreadPool();
 
@@ -60,9 +100,21 @@ class ThreadPool {
    * Initialize the thread pool.
    *
    * @param num_threads Number of threads to create (default 1).
+   * @param priority The priority class of the tasks enqueued without one.
    * @return Status
    */
-  Status init(uint64_t num_threads = 1);
+  Status init(
+      uint64_t num_threads = 1, Priority priority = Priority::COMPUTE);
+
+  /**
+   * Initialize the thread pool as a view of `scheduler`, which executes its
+   * tasks. Destroying the view waits for its outstanding tasks.
+   *
+   * @param scheduler The pool executing the tasks; it must outlive the view.
+   * @param priority The priority class of the tasks enqueued without one.
+   * @return Status
+   */
+  Status init(ThreadPool* scheduler, Priority priority);
 
   /**
    * Enqueue a new task to be executed by a thread. If the returned
@@ -73,11 +125,32 @@ class ThreadPool {
    */
   std::future<Status> enqueue(std::function<Status()>&& function);
 
-  /** Return the number of threads in this pool. */
+  /**
+   * Enqueue a new task of the given priority class, unless the calling
+   * thread has an inherited class.
+   *
+   * @param function Task function to execute.
+   * @param priority The priority class of the task.
+   * @return Future for the return value of the task.
+   */
+  std::future<Status> enqueue(
+      std::function<Status()>&& function, Priority priority);
+
+  /**
+   * Pins the workers round robin to the CPUs of the NUMA nodes, so that
+   * consecutive workers run on different nodes. This is a no-op for a view
+   * or if the NUMA topology is unknown.
+   *
+   * @return Status
+   */
+  Status pin_numa_nodes();
+
+  /** Return the number of threads in this pool (or in its scheduler). */
   uint64_t num_threads() const;
 
   /**
-   * Wait on all the given tasks to complete.
+   * Wait on all the given tasks to complete. If the calling thread is a
+   * worker of the pool, it executes pending tasks while waiting.
    *
    * @param tasks Task list to wait on.
    * @return Status::Ok if all tasks returned Status::Ok, otherwise the first
@@ -95,20 +168,110 @@ class ThreadPool {
   std::vector<Status> wait_all_status(std::vector<std::future<Status>>& tasks);
 
  private:
-  std::mutex queue_mutex_;
+  /* ********************************* */
+  /*         PRIVATE DATATYPES         */
+  /* ********************************* */
+
+  /** Number of priority classes. */
+  static const unsigned PRIORITY_NUM = 4;
+
+  /** The task deques of a single worker. */
+  struct TaskQueue {
+    /** Protects `tasks_`. */
+    std::mutex mtx_;
 
-  std::condition_variable queue_cv_;
+    /** The pending tasks, one deque per priority class. */
+    std::deque<std::packaged_task<Status()>> tasks_[PRIORITY_NUM];
+  };
 
-  bool should_terminate_;
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
 
-  std::queue<std::packaged_task<Status()>> task_queue_;
+  /** Protects the sleeping and waking up of idle workers and waiters. */
+  std::mutex mtx_;
+
+  /** Idle workers sleep on this until a task is enqueued. */
+  std::condition_variable work_cv_;
+
+  /**
+   * Workers in `wait_all` sleep on this until a task is enqueued or
+   * completes.
+   */
+  std::condition_variable done_cv_;
+
+  /** Set when the pool is terminating. */
+  std::atomic<bool> should_terminate_;
+
+  /** Number of tasks enqueued but not yet taken from a deque. */
+  std::atomic<uint64_t> pending_;
+
+  /** Number of tasks of each priority class pushed but not yet taken. */
+  std::atomic<uint64_t> class_pending_[PRIORITY_NUM];
+
+  /** Number of workers sleeping on `work_cv_`. */
+  std::atomic<uint64_t> idle_workers_;
+
+  /** Number of threads sleeping on `done_cv_`. */
+  std::atomic<uint64_t> waiters_;
+
+  /** Round-robin counter for tasks enqueued by non-worker threads. */
+  std::atomic<uint64_t> next_queue_;
+
+  /** One task deque per worker. */
+  std::vector<std::unique_ptr<TaskQueue>> queues_;
 
   std::vector<std::thread> threads_;
 
+  /** The priority class of the tasks enqueued without one. */
+  Priority priority_;
+
+  /** The pool executing the tasks of this view (`nullptr` if not a view). */
+  ThreadPool* scheduler_;
+
+  /** Number of tasks of this view not yet completed by the scheduler. */
+  uint64_t inflight_;
+
+  /* ********************************* */
+  /*          PRIVATE METHODS          */
+  /* ********************************* */
+
+  /**
+   * Takes a pending task, first from the back of the deque of the calling
+   * worker (if the caller is a worker of this pool), then from the front of
+   * the other deques.
+   *
+   * The more urgent priority classes are searched first.
+   *
+   * @param task The task to set.
+   * @param priority The priority class of the task to set.
+   * @return `true` if a task was taken.
+   */
+  bool pop_task(std::packaged_task<Status()>* task, Priority* priority);
+
+  /**
+   * Executes one pending task, if any.
+   *
+   * @return `true` if a task was executed.
+   */
+  bool run_pending_task();
+
+  /** Wakes up the workers in `wait_all` after a task was enqueued or done. */
+  void notify_waiters();
+
+  /**
+   * Waits on a single task. A worker of the pool executes pending tasks in
+   * the meantime.
+   *
+   * @param future The task to wait on.
+   * @return The status of the task.
+   */
+  Status wait(std::future<Status>& future);
+
   /** Terminate the threads in the thread pool. */
   void terminate();
 
-  static void worker(ThreadPool& pool);
+  static void worker(ThreadPool& pool, uint64_t index);
 };
 
 }  // namespace sm
@@ -0,0 +1,143 @@
+/**
+ * @file   trace.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * @section DESCRIPTION
+ *
+ * This file defines the tracer.
+ */
+
+#include "tiledb/sm/misc/trace.h"
+
+#include <cinttypes>
+#include <sstream>
+
+namespace tiledb {
+namespace sm {
+namespace stats {
+
+Tracer& Tracer::global() {
+  // Leaked, so that the threads still running at exit can record to it
+  static Tracer* tracer = new Tracer();
+  return *tracer;
+}
+
+Tracer::Tracer()
+    : enabled_(false)
+    , event_num_(0)
+    , origin_ns_(steady_ns(std::chrono::steady_clock::now())) {
+}
+
+void Tracer::add(
+    const char* name,
+    std::chrono::steady_clock::time_point start,
+    std::chrono::steady_clock::time_point end) {
+  if (event_num_.fetch_add(1, std::memory_order_relaxed) >= max_event_num)
+    return;
+
+  auto& thread_events = this->thread_events();
+  Event event;
+  event.name_ = name;
+  event.start_ns_ = steady_ns(start) - origin_ns_;
+  event.dur_ns_ = steady_ns(end) - steady_ns(start);
+
+  std::unique_lock<std::mutex> lck(thread_events.mtx_);
+  thread_events.events_.push_back(event);
+}
+
+void Tracer::dump(FILE* out) const {
+  std::string str;
+  dump(&str);
+  fprintf(out, "%s\n", str.c_str());
+}
+
+void Tracer::dump(std::string* out) const {
+  std::stringstream ss;
+  ss << "{\n";
+  ss << "  \"displayTimeUnit\": \"ns\",\n";
+  ss << "  \"traceEvents\": [";
+
+  // The timestamps and durations are in microseconds
+  bool first = true;
+  char buf[64];
+  std::unique_lock<std::mutex> lck(mtx_);
+  for (const auto& thread_events : threads_) {
+    std::unique_lock<std::mutex> thread_lck(thread_events->mtx_);
+    for (const auto& event : thread_events->events_) {
+      ss << (first ? "\n" : ",\n");
+      first = false;
+      ss << "    { \"name\": \"" << event.name_ << "\", ";
+      ss << "\"cat\": \"tiledb\", \"ph\": \"X\", ";
+      snprintf(
+          buf,
+          sizeof(buf),
+          "\"ts\": %.3f, \"dur\": %.3f, ",
+          event.start_ns_ / 1000.0,
+          event.dur_ns_ / 1000.0);
+      ss << buf;
+      ss << "\"pid\": 1, \"tid\": " << thread_events->tid_ << " }";
+    }
+  }
+
+  ss << "\n  ]\n";
+  ss << "}";
+  *out = ss.str();
+}
+
+void Tracer::reset() {
+  std::unique_lock<std::mutex> lck(mtx_);
+  for (auto& thread_events : threads_) {
+    std::unique_lock<std::mutex> thread_lck(thread_events->mtx_);
+    thread_events->events_.clear();
+  }
+  event_num_ = 0;
+  origin_ns_ = steady_ns(std::chrono::steady_clock::now());
+}
+
+void Tracer::set_enabled(bool enabled) {
+  enabled_ = enabled;
+}
+
+Tracer::ThreadEvents& Tracer::thread_events() {
+  static thread_local std::shared_ptr<ThreadEvents> thread_events;
+  if (thread_events == nullptr) {
+    thread_events = std::make_shared<ThreadEvents>();
+    std::unique_lock<std::mutex> lck(mtx_);
+    thread_events->tid_ = threads_.size() + 1;
+    threads_.push_back(thread_events);
+  }
+
+  return *thread_events;
+}
+
+int64_t Tracer::steady_ns(std::chrono::steady_clock::time_point time) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             time.time_since_epoch())
+      .count();
+}
+
+}  // namespace stats
+}  // namespace sm
+}  // namespace tiledb
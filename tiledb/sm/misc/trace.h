@@ -0,0 +1,146 @@
+/**
+ * @file   trace.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ * @section DESCRIPTION
+ *
+ * This file declares the tracer, which records a timeline of the timed
+ * functions in the Chrome trace event format.
+ */
+
+#ifndef TILEDB_TRACE_H
+#define TILEDB_TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace tiledb {
+namespace sm {
+namespace stats {
+
+/**
+ * Records the begin time, duration and thread of each call of the timed
+ * functions while tracing is enabled, and dumps them in the JSON format of
+ * Chrome traces, which Perfetto and `chrome://tracing` load as a timeline.
+ * Each thread records to its own buffer, so that tracing does not
+ * serialize the threads.
+ */
+class Tracer {
+ public:
+  /** The maximum number of events recorded until the tracer is reset. */
+  static const uint64_t max_event_num = 1 << 20;
+
+  /** Returns the process-wide tracer. */
+  static Tracer& global();
+
+  Tracer(const Tracer&) = delete;
+  Tracer& operator=(const Tracer&) = delete;
+
+  /**
+   * Records a call of the function `name`, which must be a string literal,
+   * from `start` to `end` on the calling thread.
+   */
+  void add(
+      const char* name,
+      std::chrono::steady_clock::time_point start,
+      std::chrono::steady_clock::time_point end);
+
+  /** Dumps the recorded events as a Chrome trace to the given file. */
+  void dump(FILE* out) const;
+
+  /** Dumps the recorded events as a Chrome trace to the given string. */
+  void dump(std::string* out) const;
+
+  /** Returns true if tracing is enabled. */
+  bool enabled() const {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  /** Discards the recorded events and restarts the timeline. */
+  void reset();
+
+  /** Enables or disables tracing. */
+  void set_enabled(bool enabled);
+
+ private:
+  /** A recorded function call. */
+  struct Event {
+    /** The function name. */
+    const char* name_;
+    /** The begin time, in nanoseconds since the origin of the timeline. */
+    int64_t start_ns_;
+    /** The duration in nanoseconds. */
+    int64_t dur_ns_;
+  };
+
+  /** The events recorded by one thread. */
+  struct ThreadEvents {
+    /** Protects the events from concurrent dumps and resets. */
+    mutable std::mutex mtx_;
+    /** The id of the thread in the trace. */
+    uint64_t tid_;
+    /** The recorded events. */
+    std::vector<Event> events_;
+  };
+
+  /** True if tracing is enabled. */
+  std::atomic<bool> enabled_;
+
+  /** The number of recorded events. */
+  std::atomic<uint64_t> event_num_;
+
+  /** The origin of the timeline, in nanoseconds of the steady clock. */
+  std::atomic<int64_t> origin_ns_;
+
+  /** Protects `threads_`. */
+  mutable std::mutex mtx_;
+
+  /**
+   * The event buffers of the threads that recorded events. They are shared
+   * with their threads, so they outlive the threads that exit.
+   */
+  std::vector<std::shared_ptr<ThreadEvents>> threads_;
+
+  /** Constructor. */
+  Tracer();
+
+  /** Returns the event buffer of the calling thread. */
+  ThreadEvents& thread_events();
+
+  /** Returns the nanoseconds of the steady clock at the input time. */
+  static int64_t steady_ns(std::chrono::steady_clock::time_point time);
+};
+
+}  // namespace stats
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_TRACE_H
@@ -715,6 +715,37 @@ void expand_mbr_with_mbr(T* mbr_a, const T* mbr_b, unsigned int dim_num) {
   }
 }
 
+template <class T>
+void compute_range(const T* values, uint64_t num, T* range) {
+  assert(num > 0);
+
+  // Reduce full blocks into independent lanes
+  const unsigned lane_num = 16;
+  T lo[lane_num], hi[lane_num];
+  for (unsigned l = 0; l < lane_num; ++l)
+    lo[l] = hi[l] = values[0];
+  uint64_t i = 0;
+  for (; i + lane_num <= num; i += lane_num) {
+    const T* block = values + i;
+    for (unsigned l = 0; l < lane_num; ++l) {
+      lo[l] = (block[l] < lo[l]) ? block[l] : lo[l];
+      hi[l] = (hi[l] < block[l]) ? block[l] : hi[l];
+    }
+  }
+
+  // Reduce the lanes and the remaining values
+  range[0] = lo[0];
+  range[1] = hi[0];
+  for (unsigned l = 1; l < lane_num; ++l) {
+    range[0] = (lo[l] < range[0]) ? lo[l] : range[0];
+    range[1] = (range[1] < hi[l]) ? hi[l] : range[1];
+  }
+  for (; i < num; ++i) {
+    range[0] = (values[i] < range[0]) ? values[i] : range[0];
+    range[1] = (range[1] < values[i]) ? values[i] : range[1];
+  }
+}
+
 template <class T>
 bool overlap(const T* a, const T* b, unsigned dim_num) {
   for (unsigned i = 0; i < dim_num; ++i) {
@@ -935,6 +966,27 @@ template bool rect_in_rect<uint32_t>(
 template bool rect_in_rect<uint64_t>(
     const uint64_t* rect_a, const uint64_t* rect_b, unsigned int dim_num);
 
+template void compute_range<int>(
+    const int* values, uint64_t num, int* range);
+template void compute_range<int64_t>(
+    const int64_t* values, uint64_t num, int64_t* range);
+template void compute_range<float>(
+    const float* values, uint64_t num, float* range);
+template void compute_range<double>(
+    const double* values, uint64_t num, double* range);
+template void compute_range<int8_t>(
+    const int8_t* values, uint64_t num, int8_t* range);
+template void compute_range<uint8_t>(
+    const uint8_t* values, uint64_t num, uint8_t* range);
+template void compute_range<int16_t>(
+    const int16_t* values, uint64_t num, int16_t* range);
+template void compute_range<uint16_t>(
+    const uint16_t* values, uint64_t num, uint16_t* range);
+template void compute_range<uint32_t>(
+    const uint32_t* values, uint64_t num, uint32_t* range);
+template void compute_range<uint64_t>(
+    const uint64_t* values, uint64_t num, uint64_t* range);
+
 template void expand_mbr<int>(
     int* mbr, const int* coords, unsigned int dim_num);
 template void expand_mbr<int64_t>(
@@ -309,6 +309,21 @@ void expand_mbr(const std::vector<T*>& coords, const uint64_t pos, T* mbr);
 template <class T>
 void expand_mbr_with_mbr(T* mbr_a, const T* mbr_b, unsigned int dim_num);
 
+/**
+ * Computes the minimum and maximum of the input values. The values are
+ * reduced in blocks into independent lanes, which the compiler keeps in
+ * vector registers.
+ *
+ * @tparam T The type of the values.
+ * @param values The values, which must be at least one.
+ * @param num The number of values.
+ * @param range The computed range, i.e., the minimum followed by the
+ *     maximum.
+ * @return void
+ */
+template <class T>
+void compute_range(const T* values, uint64_t num, T* range);
+
 /** Returns *true* if hyper-rectangle `a` overlaps with `b`. */
 template <class T>
 bool overlap(const T* a, const T* b, unsigned dim_num);
@@ -0,0 +1,344 @@
+/**
+ * @file   value_index.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * This file implements class ValueIndex.
+ */
+
+#include "tiledb/sm/misc/value_index.h"
+#include "tiledb/sm/buffer/buffer.h"
+#include "tiledb/sm/buffer/const_buffer.h"
+#include "tiledb/sm/misc/logger.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <type_traits>
+
+namespace tiledb {
+namespace sm {
+
+namespace {
+
+/** Returns `true` if the input value is NaN. */
+template <class T>
+inline bool is_nan(T v) {
+  return std::is_floating_point<T>::value && std::isnan(static_cast<double>(v));
+}
+
+/** Orders the values, with NaN after all the others. */
+template <class T>
+inline bool value_less(T a, T b) {
+  return is_nan(b) ? !is_nan(a) : a < b;
+}
+
+}  // namespace
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+ValueIndex::ValueIndex(Datatype type)
+    : type_(type)
+    , value_size_(datatype_size(type))
+    , sorted_(true) {
+}
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+void ValueIndex::add_tile(
+    uint64_t tile_idx, const void* values, uint64_t cell_num) {
+  switch (type_) {
+    case Datatype::INT8:
+      return add_typed_tile(tile_idx, (const int8_t*)values, cell_num);
+    case Datatype::UINT8:
+      return add_typed_tile(tile_idx, (const uint8_t*)values, cell_num);
+    case Datatype::INT16:
+      return add_typed_tile(tile_idx, (const int16_t*)values, cell_num);
+    case Datatype::UINT16:
+      return add_typed_tile(tile_idx, (const uint16_t*)values, cell_num);
+    case Datatype::INT32:
+      return add_typed_tile(tile_idx, (const int32_t*)values, cell_num);
+    case Datatype::UINT32:
+      return add_typed_tile(tile_idx, (const uint32_t*)values, cell_num);
+    case Datatype::UINT64:
+      return add_typed_tile(tile_idx, (const uint64_t*)values, cell_num);
+    case Datatype::FLOAT32:
+      return add_typed_tile(tile_idx, (const float*)values, cell_num);
+    case Datatype::FLOAT64:
+      return add_typed_tile(tile_idx, (const double*)values, cell_num);
+    default:
+      assert(value_size_ == sizeof(int64_t));
+      return add_typed_tile(tile_idx, (const int64_t*)values, cell_num);
+  }
+}
+
+uint64_t ValueIndex::entry_num() const {
+  return tile_ids_.size();
+}
+
+Status ValueIndex::lookup(
+    QueryConditionOp op,
+    const void* value,
+    std::vector<uint64_t>* tile_ids,
+    std::vector<std::pair<uint64_t, uint64_t>>* cell_pos) const {
+  if (!sorted_)
+    return LOG_STATUS(
+        Status::Error("Cannot look up value index; The index is not sorted"));
+
+  std::vector<std::pair<uint64_t, uint64_t>> runs;
+  switch (type_) {
+    case Datatype::INT8:
+      find_runs<int8_t>(op, value, &runs);
+      break;
+    case Datatype::UINT8:
+      find_runs<uint8_t>(op, value, &runs);
+      break;
+    case Datatype::INT16:
+      find_runs<int16_t>(op, value, &runs);
+      break;
+    case Datatype::UINT16:
+      find_runs<uint16_t>(op, value, &runs);
+      break;
+    case Datatype::INT32:
+      find_runs<int32_t>(op, value, &runs);
+      break;
+    case Datatype::UINT32:
+      find_runs<uint32_t>(op, value, &runs);
+      break;
+    case Datatype::UINT64:
+      find_runs<uint64_t>(op, value, &runs);
+      break;
+    case Datatype::FLOAT32:
+      find_runs<float>(op, value, &runs);
+      break;
+    case Datatype::FLOAT64:
+      find_runs<double>(op, value, &runs);
+      break;
+    default:
+      find_runs<int64_t>(op, value, &runs);
+      break;
+  }
+
+  tile_ids->clear();
+  if (cell_pos != nullptr)
+    cell_pos->clear();
+  for (const auto& run : runs) {
+    for (auto e = run.first; e < run.second; ++e) {
+      tile_ids->push_back(tile_ids_[e]);
+      if (cell_pos != nullptr)
+        cell_pos->emplace_back(tile_ids_[e], cell_pos_[e]);
+    }
+  }
+  std::sort(tile_ids->begin(), tile_ids->end());
+  tile_ids->erase(
+      std::unique(tile_ids->begin(), tile_ids->end()), tile_ids->end());
+  if (cell_pos != nullptr)
+    std::sort(cell_pos->begin(), cell_pos->end());
+
+  return Status::Ok();
+}
+
+void ValueIndex::merge(const ValueIndex& other, uint64_t tile_offset) {
+  assert(other.type_ == type_);
+  values_.insert(values_.end(), other.values_.begin(), other.values_.end());
+  for (auto t : other.tile_ids_)
+    tile_ids_.push_back(t + tile_offset);
+  cell_pos_.insert(
+      cell_pos_.end(), other.cell_pos_.begin(), other.cell_pos_.end());
+  sorted_ = other.tile_ids_.empty() && sorted_;
+}
+
+// ===== FORMAT =====
+// entry_num (uint64_t)
+// values (entry_num * value_size)
+// tile_ids (entry_num * uint64_t)
+// cell_positions (entry_num * uint64_t)
+Status ValueIndex::serialize(Buffer* buff) const {
+  assert(sorted_);
+  uint64_t entry_num = tile_ids_.size();
+  RETURN_NOT_OK(buff->write(&entry_num, sizeof(uint64_t)));
+  if (entry_num == 0)
+    return Status::Ok();
+  RETURN_NOT_OK(buff->write(&values_[0], values_.size()));
+  RETURN_NOT_OK(buff->write(&tile_ids_[0], entry_num * sizeof(uint64_t)));
+  RETURN_NOT_OK(buff->write(&cell_pos_[0], entry_num * sizeof(uint64_t)));
+
+  return Status::Ok();
+}
+
+uint64_t ValueIndex::size() const {
+  return values_.size() +
+         (tile_ids_.size() + cell_pos_.size()) * sizeof(uint64_t);
+}
+
+Status ValueIndex::deserialize(ConstBuffer* cbuff) {
+  uint64_t entry_num = 0;
+  RETURN_NOT_OK(cbuff->read(&entry_num, sizeof(uint64_t)));
+  auto entry_size = value_size_ + 2 * sizeof(uint64_t);
+  if (entry_num > cbuff->nbytes_left_to_read() / entry_size)
+    return LOG_STATUS(Status::Error(
+        "Cannot deserialize value index; Invalid number of entries"));
+
+  values_.resize(entry_num * value_size_);
+  tile_ids_.resize(entry_num);
+  cell_pos_.resize(entry_num);
+  if (entry_num > 0) {
+    RETURN_NOT_OK(cbuff->read(&values_[0], values_.size()));
+    RETURN_NOT_OK(cbuff->read(&tile_ids_[0], entry_num * sizeof(uint64_t)));
+    RETURN_NOT_OK(cbuff->read(&cell_pos_[0], entry_num * sizeof(uint64_t)));
+  }
+  sorted_ = true;
+
+  return Status::Ok();
+}
+
+void ValueIndex::sort() {
+  if (sorted_)
+    return;
+
+  switch (type_) {
+    case Datatype::INT8:
+      return sort<int8_t>();
+    case Datatype::UINT8:
+      return sort<uint8_t>();
+    case Datatype::INT16:
+      return sort<int16_t>();
+    case Datatype::UINT16:
+      return sort<uint16_t>();
+    case Datatype::INT32:
+      return sort<int32_t>();
+    case Datatype::UINT32:
+      return sort<uint32_t>();
+    case Datatype::UINT64:
+      return sort<uint64_t>();
+    case Datatype::FLOAT32:
+      return sort<float>();
+    case Datatype::FLOAT64:
+      return sort<double>();
+    default:
+      return sort<int64_t>();
+  }
+}
+
+/* ****************************** */
+/*         PRIVATE METHODS        */
+/* ****************************** */
+
+template <class T>
+void ValueIndex::add_typed_tile(
+    uint64_t tile_idx, const T* values, uint64_t cell_num) {
+  auto bytes = (const uint8_t*)values;
+  values_.insert(values_.end(), bytes, bytes + cell_num * sizeof(T));
+  tile_ids_.insert(tile_ids_.end(), cell_num, tile_idx);
+  auto first = cell_pos_.size();
+  cell_pos_.resize(first + cell_num);
+  std::iota(cell_pos_.begin() + first, cell_pos_.end(), uint64_t(0));
+  sorted_ = cell_num == 0 && sorted_;
+}
+
+template <class T>
+void ValueIndex::find_runs(
+    QueryConditionOp op,
+    const void* value,
+    std::vector<std::pair<uint64_t, uint64_t>>* runs) const {
+  T v;
+  std::memcpy(&v, value, sizeof(T));
+  auto values = (const T*)values_.data();
+  auto entry_num = tile_ids_.size();
+
+  // The NaN values are at the end and satisfy only the inequality
+  auto nan_begin =
+      std::partition_point(values, values + entry_num, [](T x) {
+        return !is_nan(x);
+      }) -
+      values;
+  if (is_nan(v)) {
+    if (op == QueryConditionOp::NE)
+      runs->emplace_back(0, entry_num);
+    return;
+  }
+
+  uint64_t lower = std::lower_bound(values, values + nan_begin, v) - values;
+  uint64_t upper = std::upper_bound(values, values + nan_begin, v) - values;
+  switch (op) {
+    case QueryConditionOp::LT:
+      runs->emplace_back(0, lower);
+      break;
+    case QueryConditionOp::LE:
+      runs->emplace_back(0, upper);
+      break;
+    case QueryConditionOp::GT:
+      runs->emplace_back(upper, nan_begin);
+      break;
+    case QueryConditionOp::GE:
+      runs->emplace_back(lower, nan_begin);
+      break;
+    case QueryConditionOp::EQ:
+      runs->emplace_back(lower, upper);
+      break;
+    case QueryConditionOp::NE:
+      runs->emplace_back(0, lower);
+      runs->emplace_back(upper, entry_num);
+      break;
+  }
+}
+
+template <class T>
+void ValueIndex::sort() {
+  auto entry_num = tile_ids_.size();
+  auto values = (const T*)values_.data();
+  std::vector<uint64_t> perm(entry_num);
+  std::iota(perm.begin(), perm.end(), uint64_t(0));
+  std::sort(perm.begin(), perm.end(), [&](uint64_t a, uint64_t b) {
+    if (value_less(values[a], values[b]))
+      return true;
+    if (value_less(values[b], values[a]))
+      return false;
+    return tile_ids_[a] < tile_ids_[b] ||
+           (tile_ids_[a] == tile_ids_[b] && cell_pos_[a] < cell_pos_[b]);
+  });
+
+  std::vector<uint8_t> sorted_values(values_.size());
+  std::vector<uint64_t> sorted_tile_ids(entry_num), sorted_cell_pos(entry_num);
+  for (uint64_t i = 0; i < entry_num; ++i) {
+    std::memcpy(&sorted_values[i * sizeof(T)], &values[perm[i]], sizeof(T));
+    sorted_tile_ids[i] = tile_ids_[perm[i]];
+    sorted_cell_pos[i] = cell_pos_[perm[i]];
+  }
+  values_.swap(sorted_values);
+  tile_ids_.swap(sorted_tile_ids);
+  cell_pos_.swap(sorted_cell_pos);
+  sorted_ = true;
+}
+
+}  // namespace sm
+}  // namespace tiledb
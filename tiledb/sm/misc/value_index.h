@@ -0,0 +1,179 @@
+/**
+ * @file   value_index.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * This file defines class ValueIndex.
+ */
+
+#ifndef TILEDB_VALUE_INDEX_H
+#define TILEDB_VALUE_INDEX_H
+
+#include <vector>
+
+#include "tiledb/sm/enums/datatype.h"
+#include "tiledb/sm/enums/query_condition_op.h"
+#include "tiledb/sm/misc/status.h"
+
+namespace tiledb {
+namespace sm {
+
+class Buffer;
+class ConstBuffer;
+
+/**
+ * A secondary index over the values of a numeric attribute with a single
+ * value per cell in a fragment. It holds a (value, tile id, cell position)
+ * entry for each cell, sorted on the value, so that the cells whose value
+ * satisfies a comparison form at most two runs found by binary search.
+ * NaN values are sorted after all others, as they satisfy only the
+ * inequality comparisons.
+ */
+class ValueIndex {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /**
+   * Constructor. The index is empty.
+   *
+   * @param type The type of the indexed values, which must be numeric or
+   *     a datetime.
+   */
+  explicit ValueIndex(Datatype type);
+
+  /* ********************************* */
+  /*                 API               */
+  /* ********************************* */
+
+  /**
+   * Adds the values of the cells of a tile to the index. Not thread-safe.
+   *
+   * @param tile_idx The tile id.
+   * @param values The values of the cells of the tile, in their order.
+   * @param cell_num The number of cells of the tile.
+   */
+  void add_tile(uint64_t tile_idx, const void* values, uint64_t cell_num);
+
+  /** Returns the number of indexed cells. */
+  uint64_t entry_num() const;
+
+  /**
+   * Retrieves the cells whose value satisfies a comparison with the input
+   * value. The index must be sorted.
+   *
+   * @param op The comparison operator.
+   * @param value The value the cells are compared with.
+   * @param tile_ids Set to the sorted ids of the tiles with such cells.
+   * @param cell_pos If not `nullptr`, set to the `(tile id, position)`
+   *     pairs of the cells, sorted.
+   * @return Status
+   */
+  Status lookup(
+      QueryConditionOp op,
+      const void* value,
+      std::vector<uint64_t>* tile_ids,
+      std::vector<std::pair<uint64_t, uint64_t>>* cell_pos = nullptr) const;
+
+  /**
+   * Adds the entries of the input index to this one, offsetting their
+   * tile ids, e.g., to append the tiles of a fragment to another.
+   *
+   * @param other The index to merge, on the same type.
+   * @param tile_offset The offset added to the tile ids of `other`.
+   */
+  void merge(const ValueIndex& other, uint64_t tile_offset);
+
+  /** Serializes the sorted index to the input buffer. */
+  Status serialize(Buffer* buff) const;
+
+  /** Returns the number of bytes occupied by the entries. */
+  uint64_t size() const;
+
+  /**
+   * Sorts the entries on their value, tile id and cell position, as
+   * needed after adding tiles or merging indexes.
+   */
+  void sort();
+
+  /** Deserializes the index from the input buffer. */
+  Status deserialize(ConstBuffer* cbuff);
+
+ private:
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The type of the indexed values. */
+  Datatype type_;
+
+  /** The size of an indexed value. */
+  uint64_t value_size_;
+
+  /** The value of each entry. */
+  std::vector<uint8_t> values_;
+
+  /** The tile id of each entry. */
+  std::vector<uint64_t> tile_ids_;
+
+  /** The position of the cell of each entry in its tile. */
+  std::vector<uint64_t> cell_pos_;
+
+  /** Whether the entries are sorted. */
+  bool sorted_;
+
+  /* ********************************* */
+  /*           PRIVATE METHODS         */
+  /* ********************************* */
+
+  /** Adds the values of a tile (see `add_tile`). */
+  template <class T>
+  void add_typed_tile(uint64_t tile_idx, const T* values, uint64_t cell_num);
+
+  /**
+   * Finds the runs of entries satisfying a comparison (see `lookup`).
+   *
+   * @tparam T The value type.
+   * @param op The comparison operator.
+   * @param value The value the entries are compared with.
+   * @param runs Set to the `[begin, end)` ranges of the satisfying entries.
+   */
+  template <class T>
+  void find_runs(
+      QueryConditionOp op,
+      const void* value,
+      std::vector<std::pair<uint64_t, uint64_t>>* runs) const;
+
+  /** Sorts the entries on their value, tile id and cell position. */
+  template <class T>
+  void sort();
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_VALUE_INDEX_H
@@ -0,0 +1,366 @@
+/**
+ * @file   var_offsets.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements the kernels converting cell offsets between the
+ * on-disk and the user conventions.
+ */
+
+#include "tiledb/sm/misc/var_offsets.h"
+
+#include <cassert>
+#include <cstring>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace tiledb {
+namespace sm {
+namespace var_offsets {
+
+namespace {
+
+/** Returns the base-2 logarithm of `unit`, which is a power of two. */
+uint32_t unit_shift(uint64_t unit) {
+  assert(unit != 0 && (unit & (unit - 1)) == 0);
+  uint32_t shift = 0;
+  while ((uint64_t(1) << shift) < unit)
+    ++shift;
+  return shift;
+}
+
+/** Converts tile offsets `[start, num)` to user offsets of type `T`. */
+template <class T>
+void to_user_scalar(
+    const uint64_t* src,
+    uint64_t start,
+    uint64_t num,
+    uint64_t base,
+    uint32_t shift,
+    unsigned char* dest) {
+  for (uint64_t i = start; i < num; ++i) {
+    const auto offset = static_cast<T>((src[i] - base) >> shift);
+    std::memcpy(dest + i * sizeof(T), &offset, sizeof(T));
+  }
+}
+
+/** Converts `num` tile offsets to user offsets of type `T`. */
+template <class T>
+void to_user(
+    const uint64_t* src,
+    uint64_t num,
+    uint64_t base,
+    uint32_t shift,
+    unsigned char* dest) {
+  to_user_scalar<T>(src, 0, num, base, shift, dest);
+}
+
+/** Writes the user offsets `[start, num)` of type `T` of equal cells. */
+template <class T>
+void sequence_scalar(
+    uint64_t start,
+    uint64_t num,
+    uint64_t first,
+    uint64_t size,
+    uint32_t shift,
+    unsigned char* dest) {
+  for (uint64_t i = start; i < num; ++i) {
+    const auto offset = static_cast<T>((first + i * size) >> shift);
+    std::memcpy(dest + i * sizeof(T), &offset, sizeof(T));
+  }
+}
+
+/** Writes `num` user offsets of type `T` of equal cells. */
+template <class T>
+void sequence(
+    uint64_t num,
+    uint64_t first,
+    uint64_t size,
+    uint32_t shift,
+    unsigned char* dest) {
+  sequence_scalar<T>(0, num, first, size, shift, dest);
+}
+
+/** Converts user offsets `[start, num)` of type `T` to tile offsets. */
+template <class T>
+void to_disk_scalar(
+    const unsigned char* src,
+    uint64_t start,
+    uint64_t num,
+    uint32_t shift,
+    uint64_t base,
+    uint64_t* dest) {
+  for (uint64_t i = start; i < num; ++i) {
+    T offset;
+    std::memcpy(&offset, src + i * sizeof(T), sizeof(T));
+    dest[i] = (static_cast<uint64_t>(offset) << shift) - base;
+  }
+}
+
+/** Converts `num` user offsets of type `T` to tile offsets. */
+template <class T>
+void to_disk(
+    const unsigned char* src,
+    uint64_t num,
+    uint32_t shift,
+    uint64_t base,
+    uint64_t* dest) {
+  to_disk_scalar<T>(src, 0, num, shift, base, dest);
+}
+
+/**
+ * Replaces `values[start, num)` by their exclusive prefix sums, starting
+ * from `sum`, and returns the total sum.
+ */
+uint64_t prefix_sum_scalar(
+    uint64_t* values, uint64_t start, uint64_t num, uint64_t sum) {
+  for (uint64_t i = start; i < num; ++i) {
+    const auto value = values[i];
+    values[i] = sum;
+    sum += value;
+  }
+  return sum;
+}
+
+#ifdef __AVX2__
+
+/** Stores the low 32 bits of the 64-bit lanes of `lo`, then of `hi`. */
+inline void store_low_halves(__m256i lo, __m256i hi, unsigned char* dest) {
+  const auto idx = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+  _mm_storeu_si128(
+      (__m128i*)dest,
+      _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(lo, idx)));
+  _mm_storeu_si128(
+      (__m128i*)(dest + 16),
+      _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(hi, idx)));
+}
+
+template <>
+void to_user<uint64_t>(
+    const uint64_t* src,
+    uint64_t num,
+    uint64_t base,
+    uint32_t shift,
+    unsigned char* dest) {
+  uint64_t i = 0;
+  const auto b = _mm256_set1_epi64x((long long)base);
+  const auto s = _mm_cvtsi32_si128((int)shift);
+  for (; i + 4 <= num; i += 4) {
+    auto v = _mm256_loadu_si256((const __m256i*)&src[i]);
+    v = _mm256_srl_epi64(_mm256_sub_epi64(v, b), s);
+    _mm256_storeu_si256((__m256i*)(dest + i * sizeof(uint64_t)), v);
+  }
+  to_user_scalar<uint64_t>(src, i, num, base, shift, dest);
+}
+
+template <>
+void to_user<uint32_t>(
+    const uint64_t* src,
+    uint64_t num,
+    uint64_t base,
+    uint32_t shift,
+    unsigned char* dest) {
+  uint64_t i = 0;
+  const auto b = _mm256_set1_epi64x((long long)base);
+  const auto s = _mm_cvtsi32_si128((int)shift);
+  for (; i + 8 <= num; i += 8) {
+    auto lo = _mm256_loadu_si256((const __m256i*)&src[i]);
+    auto hi = _mm256_loadu_si256((const __m256i*)&src[i + 4]);
+    lo = _mm256_srl_epi64(_mm256_sub_epi64(lo, b), s);
+    hi = _mm256_srl_epi64(_mm256_sub_epi64(hi, b), s);
+    store_low_halves(lo, hi, dest + i * sizeof(uint32_t));
+  }
+  to_user_scalar<uint32_t>(src, i, num, base, shift, dest);
+}
+
+template <>
+void sequence<uint64_t>(
+    uint64_t num,
+    uint64_t first,
+    uint64_t size,
+    uint32_t shift,
+    unsigned char* dest) {
+  uint64_t i = 0;
+  const auto step = _mm256_set1_epi64x((long long)(4 * size));
+  const auto s = _mm_cvtsi32_si128((int)shift);
+  auto v = _mm256_setr_epi64x(
+      (long long)first,
+      (long long)(first + size),
+      (long long)(first + 2 * size),
+      (long long)(first + 3 * size));
+  for (; i + 4 <= num; i += 4) {
+    _mm256_storeu_si256(
+        (__m256i*)(dest + i * sizeof(uint64_t)), _mm256_srl_epi64(v, s));
+    v = _mm256_add_epi64(v, step);
+  }
+  sequence_scalar<uint64_t>(i, num, first, size, shift, dest);
+}
+
+template <>
+void sequence<uint32_t>(
+    uint64_t num,
+    uint64_t first,
+    uint64_t size,
+    uint32_t shift,
+    unsigned char* dest) {
+  uint64_t i = 0;
+  const auto half_step = _mm256_set1_epi64x((long long)(4 * size));
+  const auto step = _mm256_set1_epi64x((long long)(8 * size));
+  const auto s = _mm_cvtsi32_si128((int)shift);
+  auto v = _mm256_setr_epi64x(
+      (long long)first,
+      (long long)(first + size),
+      (long long)(first + 2 * size),
+      (long long)(first + 3 * size));
+  for (; i + 8 <= num; i += 8) {
+    store_low_halves(
+        _mm256_srl_epi64(v, s),
+        _mm256_srl_epi64(_mm256_add_epi64(v, half_step), s),
+        dest + i * sizeof(uint32_t));
+    v = _mm256_add_epi64(v, step);
+  }
+  sequence_scalar<uint32_t>(i, num, first, size, shift, dest);
+}
+
+template <>
+void to_disk<uint64_t>(
+    const unsigned char* src,
+    uint64_t num,
+    uint32_t shift,
+    uint64_t base,
+    uint64_t* dest) {
+  uint64_t i = 0;
+  const auto b = _mm256_set1_epi64x((long long)base);
+  const auto s = _mm_cvtsi32_si128((int)shift);
+  for (; i + 4 <= num; i += 4) {
+    auto v = _mm256_loadu_si256((const __m256i*)(src + i * sizeof(uint64_t)));
+    v = _mm256_sub_epi64(_mm256_sll_epi64(v, s), b);
+    _mm256_storeu_si256((__m256i*)&dest[i], v);
+  }
+  to_disk_scalar<uint64_t>(src, i, num, shift, base, dest);
+}
+
+template <>
+void to_disk<uint32_t>(
+    const unsigned char* src,
+    uint64_t num,
+    uint32_t shift,
+    uint64_t base,
+    uint64_t* dest) {
+  uint64_t i = 0;
+  const auto b = _mm256_set1_epi64x((long long)base);
+  const auto s = _mm_cvtsi32_si128((int)shift);
+  for (; i + 4 <= num; i += 4) {
+    auto v = _mm256_cvtepu32_epi64(
+        _mm_loadu_si128((const __m128i*)(src + i * sizeof(uint32_t))));
+    v = _mm256_sub_epi64(_mm256_sll_epi64(v, s), b);
+    _mm256_storeu_si256((__m256i*)&dest[i], v);
+  }
+  to_disk_scalar<uint32_t>(src, i, num, shift, base, dest);
+}
+
+#endif
+
+}  // namespace
+
+void to_user(
+    const uint64_t* src,
+    uint64_t num,
+    uint64_t base,
+    uint64_t unit,
+    uint32_t bitsize,
+    void* dest) {
+  auto shift = unit_shift(unit);
+  auto d = static_cast<unsigned char*>(dest);
+  if (bitsize == 32)
+    to_user<uint32_t>(src, num, base, shift, d);
+  else
+    to_user<uint64_t>(src, num, base, shift, d);
+}
+
+void sequence(
+    uint64_t num,
+    uint64_t first,
+    uint64_t size,
+    uint64_t unit,
+    uint32_t bitsize,
+    void* dest) {
+  auto shift = unit_shift(unit);
+  auto d = static_cast<unsigned char*>(dest);
+  if (bitsize == 32)
+    sequence<uint32_t>(num, first, size, shift, d);
+  else
+    sequence<uint64_t>(num, first, size, shift, d);
+}
+
+void to_disk(
+    const void* src,
+    uint64_t num,
+    uint64_t unit,
+    uint32_t bitsize,
+    uint64_t base,
+    uint64_t* dest) {
+  auto shift = unit_shift(unit);
+  auto s = static_cast<const unsigned char*>(src);
+  if (bitsize == 32)
+    to_disk<uint32_t>(s, num, shift, base, dest);
+  else
+    to_disk<uint64_t>(s, num, shift, base, dest);
+}
+
+uint64_t prefix_sum(uint64_t* values, uint64_t num) {
+  uint64_t i = 0;
+  uint64_t sum = 0;
+#ifdef __AVX2__
+  // Each step sums 4 values in 2 shifted additions and adds the sum of the
+  // values before them, broadcast from the last lane of the previous step
+  const auto zero = _mm256_setzero_si256();
+  auto carry = zero;
+  for (; i + 4 <= num; i += 4) {
+    auto v = _mm256_loadu_si256((const __m256i*)&values[i]);
+    auto t = _mm256_blend_epi32(
+        _mm256_permute4x64_epi64(v, _MM_SHUFFLE(2, 1, 0, 0)), zero, 0x03);
+    auto inclusive = _mm256_add_epi64(v, t);
+    t = _mm256_blend_epi32(
+        _mm256_permute4x64_epi64(inclusive, _MM_SHUFFLE(1, 0, 0, 0)),
+        zero,
+        0x0F);
+    inclusive = _mm256_add_epi64(_mm256_add_epi64(inclusive, t), carry);
+    _mm256_storeu_si256(
+        (__m256i*)&values[i], _mm256_sub_epi64(inclusive, v));
+    carry = _mm256_permute4x64_epi64(inclusive, _MM_SHUFFLE(3, 3, 3, 3));
+  }
+  sum = (uint64_t)_mm_cvtsi128_si64(_mm256_castsi256_si128(carry));
+#endif
+  return prefix_sum_scalar(values, i, num, sum);
+}
+
+}  // namespace var_offsets
+}  // namespace sm
+}  // namespace tiledb
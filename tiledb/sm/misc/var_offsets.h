@@ -0,0 +1,127 @@
+/**
+ * @file   var_offsets.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file declares the kernels converting cell offsets between the
+ * on-disk and the user conventions.
+ */
+
+#ifndef TILEDB_VAR_OFFSETS_H
+#define TILEDB_VAR_OFFSETS_H
+
+#include <cstdint>
+
+namespace tiledb {
+namespace sm {
+
+/**
+ * Kernels converting var-sized cell offsets between tiles, which hold
+ * 64-bit byte offsets relative to the tile, and user buffers, which hold
+ * offsets relative to the buffer, in bytes or elements, of 32 or 64 bits.
+ * The kernels use AVX2 when available. Offsets in elements are supported
+ * for elements whose size is a power of two, which is the case for every
+ * datatype.
+ */
+namespace var_offsets {
+
+/**
+ * Converts tile offsets to user offsets, i.e., sets
+ * `dest[i] = (src[i] - base) / unit` for every `i` in `[0, num)`.
+ * Subtractions wrap around, so that a `base` larger than the offsets
+ * shifts them forward.
+ *
+ * @param src The 64-bit byte offsets to convert.
+ * @param num The number of offsets.
+ * @param base The byte offset subtracted from every offset.
+ * @param unit The size of the offset unit in bytes (1 for byte offsets).
+ * @param bitsize The size of the user offsets in bits (32 or 64).
+ * @param dest The user offsets. It may be unaligned.
+ */
+void to_user(
+    const uint64_t* src,
+    uint64_t num,
+    uint64_t base,
+    uint64_t unit,
+    uint32_t bitsize,
+    void* dest);
+
+/**
+ * Writes the user offsets of `num` cells of `size` bytes each, starting
+ * at byte offset `first`.
+ *
+ * @param num The number of offsets.
+ * @param first The byte offset of the first cell.
+ * @param size The byte size of every cell.
+ * @param unit The size of the offset unit in bytes (1 for byte offsets).
+ * @param bitsize The size of the user offsets in bits (32 or 64).
+ * @param dest The user offsets. It may be unaligned.
+ */
+void sequence(
+    uint64_t num,
+    uint64_t first,
+    uint64_t size,
+    uint64_t unit,
+    uint32_t bitsize,
+    void* dest);
+
+/**
+ * Converts user offsets to tile offsets, i.e., sets
+ * `dest[i] = src[i] * unit - base` for every `i` in `[0, num)`.
+ * Subtractions wrap around as in `to_user`.
+ *
+ * @param src The user offsets to convert. It may be unaligned.
+ * @param num The number of offsets.
+ * @param unit The size of the offset unit in bytes (1 for byte offsets).
+ * @param bitsize The size of the user offsets in bits (32 or 64).
+ * @param base The byte offset subtracted from every offset.
+ * @param dest The 64-bit byte offsets.
+ */
+void to_disk(
+    const void* src,
+    uint64_t num,
+    uint64_t unit,
+    uint32_t bitsize,
+    uint64_t base,
+    uint64_t* dest);
+
+/**
+ * Replaces `values` by their exclusive prefix sums, i.e., every value by
+ * the sum of the values before it, turning sizes into offsets.
+ *
+ * @param values The values to sum.
+ * @param num The number of values.
+ * @return The sum of all values.
+ */
+uint64_t prefix_sum(uint64_t* values, uint64_t num);
+
+}  // namespace var_offsets
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_VAR_OFFSETS_H
@@ -0,0 +1,313 @@
+/**
+ * @file   aggregate.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements class Aggregate.
+ */
+
+#include "tiledb/sm/query/aggregate.h"
+#include "tiledb/sm/array_schema/array_schema.h"
+#include "tiledb/sm/array_schema/attribute.h"
+#include "tiledb/sm/misc/logger.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+
+namespace tiledb {
+namespace sm {
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+Aggregate::Aggregate(
+    const std::string& field_name, AggregateOp op, void* result)
+    : field_name_(field_name)
+    , op_(op)
+    , result_(result)
+    , type_(Datatype::ANY)
+    , count_(0)
+    , value_(0)
+    , has_value_(false) {
+}
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+Status Aggregate::check(const ArraySchema* array_schema) {
+  if (result_ == nullptr)
+    return LOG_STATUS(Status::QueryError(
+        "Invalid aggregate; The result location cannot be null"));
+
+  auto attr = array_schema->attribute(field_name_);
+  if (attr == nullptr)
+    return LOG_STATUS(Status::QueryError(
+        "Invalid aggregate; Unknown attribute '" + field_name_ + "'"));
+  type_ = attr->type();
+  if (op_ == AggregateOp::AGGREGATE_COUNT)
+    return Status::Ok();
+
+  if (attr->var_size() || attr->cell_val_num() != 1)
+    return LOG_STATUS(Status::QueryError(
+        "Invalid aggregate; Attribute '" + field_name_ +
+        "' must have a single fixed-sized value per cell"));
+
+  switch (type_) {
+    case Datatype::INT8:
+    case Datatype::UINT8:
+    case Datatype::INT16:
+    case Datatype::UINT16:
+    case Datatype::INT32:
+    case Datatype::UINT32:
+    case Datatype::INT64:
+    case Datatype::UINT64:
+    case Datatype::FLOAT32:
+    case Datatype::FLOAT64:
+    case Datatype::DATETIME_YEAR:
+    case Datatype::DATETIME_MONTH:
+    case Datatype::DATETIME_WEEK:
+    case Datatype::DATETIME_DAY:
+    case Datatype::DATETIME_HR:
+    case Datatype::DATETIME_MIN:
+    case Datatype::DATETIME_SEC:
+    case Datatype::DATETIME_MS:
+    case Datatype::DATETIME_US:
+    case Datatype::DATETIME_NS:
+    case Datatype::DATETIME_PS:
+    case Datatype::DATETIME_FS:
+    case Datatype::DATETIME_AS:
+      return Status::Ok();
+    default:
+      return LOG_STATUS(Status::QueryError(
+          "Invalid aggregate; Attribute '" + field_name_ +
+          "' has an unsupported type"));
+  }
+}
+
+const std::string& Aggregate::field_name() const {
+  return field_name_;
+}
+
+AggregateOp Aggregate::op() const {
+  return op_;
+}
+
+void Aggregate::add_cell_num(uint64_t cell_num) {
+  count_ += cell_num;
+}
+
+void Aggregate::add_values(
+    const void* values, uint64_t start, uint64_t step, uint64_t num) {
+  switch (type_) {
+    case Datatype::INT8:
+      add_values<int8_t, uint64_t>((const int8_t*)values, start, step, num);
+      break;
+    case Datatype::UINT8:
+      add_values<uint8_t, uint64_t>((const uint8_t*)values, start, step, num);
+      break;
+    case Datatype::INT16:
+      add_values<int16_t, uint64_t>((const int16_t*)values, start, step, num);
+      break;
+    case Datatype::UINT16:
+      add_values<uint16_t, uint64_t>(
+          (const uint16_t*)values, start, step, num);
+      break;
+    case Datatype::INT32:
+      add_values<int32_t, uint64_t>((const int32_t*)values, start, step, num);
+      break;
+    case Datatype::UINT32:
+      add_values<uint32_t, uint64_t>(
+          (const uint32_t*)values, start, step, num);
+      break;
+    case Datatype::UINT64:
+      add_values<uint64_t, uint64_t>(
+          (const uint64_t*)values, start, step, num);
+      break;
+    case Datatype::FLOAT32:
+      add_values<float, double>((const float*)values, start, step, num);
+      break;
+    case Datatype::FLOAT64:
+      add_values<double, double>((const double*)values, start, step, num);
+      break;
+    case Datatype::INT64:
+    case Datatype::DATETIME_YEAR:
+    case Datatype::DATETIME_MONTH:
+    case Datatype::DATETIME_WEEK:
+    case Datatype::DATETIME_DAY:
+    case Datatype::DATETIME_HR:
+    case Datatype::DATETIME_MIN:
+    case Datatype::DATETIME_SEC:
+    case Datatype::DATETIME_MS:
+    case Datatype::DATETIME_US:
+    case Datatype::DATETIME_NS:
+    case Datatype::DATETIME_PS:
+    case Datatype::DATETIME_FS:
+    case Datatype::DATETIME_AS:
+      add_values<int64_t, uint64_t>((const int64_t*)values, start, step, num);
+      break;
+    default:
+      assert(false);
+  }
+}
+
+bool Aggregate::add_tile_min_max_sum(
+    const void* min, const void* max, const void* sum) {
+  switch (type_) {
+    case Datatype::INT8:
+      return add_tile_min_max_sum<int8_t, uint64_t>(min, max, sum);
+    case Datatype::UINT8:
+      return add_tile_min_max_sum<uint8_t, uint64_t>(min, max, sum);
+    case Datatype::INT16:
+      return add_tile_min_max_sum<int16_t, uint64_t>(min, max, sum);
+    case Datatype::UINT16:
+      return add_tile_min_max_sum<uint16_t, uint64_t>(min, max, sum);
+    case Datatype::INT32:
+      return add_tile_min_max_sum<int32_t, uint64_t>(min, max, sum);
+    case Datatype::UINT32:
+      return add_tile_min_max_sum<uint32_t, uint64_t>(min, max, sum);
+    case Datatype::UINT64:
+      return add_tile_min_max_sum<uint64_t, uint64_t>(min, max, sum);
+    case Datatype::FLOAT32:
+      return add_tile_min_max_sum<float, double>(min, max, sum);
+    case Datatype::FLOAT64:
+      return add_tile_min_max_sum<double, double>(min, max, sum);
+    case Datatype::INT64:
+    case Datatype::DATETIME_YEAR:
+    case Datatype::DATETIME_MONTH:
+    case Datatype::DATETIME_WEEK:
+    case Datatype::DATETIME_DAY:
+    case Datatype::DATETIME_HR:
+    case Datatype::DATETIME_MIN:
+    case Datatype::DATETIME_SEC:
+    case Datatype::DATETIME_MS:
+    case Datatype::DATETIME_US:
+    case Datatype::DATETIME_NS:
+    case Datatype::DATETIME_PS:
+    case Datatype::DATETIME_FS:
+    case Datatype::DATETIME_AS:
+      return add_tile_min_max_sum<int64_t, uint64_t>(min, max, sum);
+    default:
+      return false;
+  }
+}
+
+void Aggregate::finalize() const {
+  switch (op_) {
+    case AggregateOp::AGGREGATE_COUNT:
+      std::memcpy(result_, &count_, sizeof(uint64_t));
+      break;
+    case AggregateOp::AGGREGATE_SUM:
+      std::memcpy(result_, &value_, sizeof(uint64_t));
+      break;
+    case AggregateOp::AGGREGATE_MIN:
+    case AggregateOp::AGGREGATE_MAX:
+      if (has_value_)
+        std::memcpy(result_, &value_, datatype_size(type_));
+      break;
+  }
+}
+
+/* ****************************** */
+/*          PRIVATE METHODS       */
+/* ****************************** */
+
+template <class T, class S>
+void Aggregate::add_values(
+    const T* values, uint64_t start, uint64_t step, uint64_t num) {
+  T min = T(), max = T();
+  bool has_min_max = false;
+  S sum = 0;
+  for (uint64_t c = 0; c < num; ++c) {
+    const auto& v = values[start + c * step];
+    sum += static_cast<S>(v);
+    if (std::is_floating_point<T>::value && std::isnan(static_cast<double>(v)))
+      continue;
+    if (!has_min_max || v < min)
+      min = v;
+    if (!has_min_max || v > max)
+      max = v;
+    has_min_max = true;
+  }
+
+  merge<T, S>(min, max, has_min_max, sum);
+}
+
+template <class T, class S>
+bool Aggregate::add_tile_min_max_sum(
+    const void* min, const void* max, const void* sum) {
+  T tile_min, tile_max;
+  S tile_sum;
+  std::memcpy(&tile_min, min, sizeof(T));
+  std::memcpy(&tile_max, max, sizeof(T));
+  std::memcpy(&tile_sum, sum, sizeof(S));
+
+  // The bounds of tiles with NaN values are NaN
+  bool is_min_max = op_ == AggregateOp::AGGREGATE_MIN ||
+                    op_ == AggregateOp::AGGREGATE_MAX;
+  if (is_min_max && std::is_floating_point<T>::value &&
+      (std::isnan(static_cast<double>(tile_min)) ||
+       std::isnan(static_cast<double>(tile_max))))
+    return false;
+
+  merge<T, S>(tile_min, tile_max, true, tile_sum);
+  return true;
+}
+
+template <class T, class S>
+void Aggregate::merge(const T& min, const T& max, bool has_min_max, S sum) {
+  switch (op_) {
+    case AggregateOp::AGGREGATE_COUNT:
+      break;
+    case AggregateOp::AGGREGATE_SUM: {
+      S value;
+      std::memcpy(&value, &value_, sizeof(S));
+      value += sum;
+      std::memcpy(&value_, &value, sizeof(S));
+      break;
+    }
+    case AggregateOp::AGGREGATE_MIN:
+    case AggregateOp::AGGREGATE_MAX: {
+      if (!has_min_max)
+        break;
+      bool is_min = op_ == AggregateOp::AGGREGATE_MIN;
+      const T& candidate = is_min ? min : max;
+      T value;
+      std::memcpy(&value, &value_, sizeof(T));
+      if (!has_value_ || (is_min ? candidate < value : candidate > value))
+        std::memcpy(&value_, &candidate, sizeof(T));
+      has_value_ = true;
+      break;
+    }
+  }
+}
+
+}  // namespace sm
+}  // namespace tiledb
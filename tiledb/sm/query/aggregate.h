@@ -0,0 +1,195 @@
+/**
+ * @file   aggregate.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class Aggregate.
+ */
+
+#ifndef TILEDB_AGGREGATE_H
+#define TILEDB_AGGREGATE_H
+
+#include <string>
+
+#include "tiledb/sm/enums/aggregate_op.h"
+#include "tiledb/sm/enums/datatype.h"
+#include "tiledb/sm/misc/status.h"
+
+namespace tiledb {
+namespace sm {
+
+class ArraySchema;
+
+/**
+ * An aggregate over the values of an attribute in the result cells of a
+ * read query. It is updated with the values of the result cells, or with
+ * the precomputed minimum, maximum and sum of whole tiles, and writes its
+ * result to a user-provided location when finalized.
+ *
+ * The result of `COUNT` is a `uint64_t`. The result of `SUM` is an
+ * `int64_t` for signed integer and datetime attributes, a `uint64_t` for
+ * unsigned integer attributes and a `double` for floating point
+ * attributes, where integer sums wrap around on overflow. The results of
+ * `MIN` and `MAX` have the attribute type, ignore NaN values and are left
+ * unchanged if there is no value to aggregate.
+ */
+class Aggregate {
+ public:
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /**
+   * Constructor.
+   *
+   * @param field_name The aggregated attribute.
+   * @param op The aggregate operator.
+   * @param result The location the result is written to.
+   */
+  Aggregate(const std::string& field_name, AggregateOp op, void* result);
+
+  /** Destructor. */
+  ~Aggregate() = default;
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /**
+   * Checks that the aggregate applies to the input array schema, i.e.,
+   * that the attribute exists and, unless the operator is `COUNT`, that it
+   * is numeric with a single fixed-sized value per cell.
+   *
+   * @param array_schema The array schema.
+   * @return Status
+   */
+  Status check(const ArraySchema* array_schema);
+
+  /** Returns the aggregated attribute. */
+  const std::string& field_name() const;
+
+  /** Returns the aggregate operator. */
+  AggregateOp op() const;
+
+  /** Adds the input number of result cells to a `COUNT` aggregate. */
+  void add_cell_num(uint64_t cell_num);
+
+  /**
+   * Aggregates the attribute values of a run of result cells.
+   *
+   * @param values The attribute values.
+   * @param start The position of the first cell in `values`.
+   * @param step The distance between consecutive cells in `values`.
+   * @param num The number of cells.
+   */
+  void add_values(
+      const void* values, uint64_t start, uint64_t step, uint64_t num);
+
+  /**
+   * Aggregates all the cells of a tile from its precomputed minimum,
+   * maximum and sum (see `FragmentMetadata::get_tile_min_max_sum`).
+   *
+   * @param min The minimum value of the tile.
+   * @param max The maximum value of the tile.
+   * @param sum The sum of the values of the tile.
+   * @return `false` if the aggregate cannot be computed from the input
+   *     values (e.g., for the minimum of a tile with NaN values), in which
+   *     case the aggregate is not updated.
+   */
+  bool add_tile_min_max_sum(const void* min, const void* max, const void* sum);
+
+  /** Writes the result of the aggregate to the user location. */
+  void finalize() const;
+
+ private:
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The aggregated attribute. */
+  std::string field_name_;
+
+  /** The aggregate operator. */
+  AggregateOp op_;
+
+  /** The location the result is written to. */
+  void* result_;
+
+  /** The attribute type. */
+  Datatype type_;
+
+  /** The number of result cells, for `COUNT`. */
+  uint64_t count_;
+
+  /** The bytes of the running sum, minimum or maximum. */
+  uint64_t value_;
+
+  /** `true` if `value_` holds a minimum or maximum. */
+  bool has_value_;
+
+  /* ********************************* */
+  /*           PRIVATE METHODS         */
+  /* ********************************* */
+
+  /**
+   * Aggregates the attribute values of a run of result cells.
+   *
+   * @tparam T The attribute type.
+   * @tparam S The type of the sum.
+   */
+  template <class T, class S>
+  void add_values(const T* values, uint64_t start, uint64_t step, uint64_t num);
+
+  /**
+   * Aggregates all the cells of a tile from its precomputed minimum,
+   * maximum and sum.
+   *
+   * @tparam T The attribute type.
+   * @tparam S The type of the sum.
+   */
+  template <class T, class S>
+  bool add_tile_min_max_sum(const void* min, const void* max, const void* sum);
+
+  /**
+   * Merges a partial minimum, maximum and sum into the aggregate.
+   *
+   * @tparam T The attribute type.
+   * @tparam S The type of the sum.
+   * @param min The partial minimum.
+   * @param max The partial maximum.
+   * @param has_min_max `false` if there was no (non-NaN) value to compute
+   *     the partial minimum and maximum from.
+   * @param sum The partial sum.
+   */
+  template <class T, class S>
+  void merge(const T& min, const T& max, bool has_min_max, S sum);
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_AGGREGATE_H
@@ -0,0 +1,342 @@
+/**
+ * @file   arrow_export.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * @section DESCRIPTION
+ *
+ * This file implements the export of query results through the Apache Arrow
+ * C data interface.
+ */
+
+#include "tiledb/sm/query/arrow_export.h"
+#include "tiledb/sm/array_schema/array_schema.h"
+#include "tiledb/sm/array_schema/attribute.h"
+#include "tiledb/sm/enums/datatype.h"
+#include "tiledb/sm/enums/query_status.h"
+#include "tiledb/sm/enums/query_type.h"
+#include "tiledb/sm/misc/constants.h"
+#include "tiledb/sm/misc/logger.h"
+#include "tiledb/sm/query/query.h"
+#include "tiledb/sm/query/reader.h"
+
+#include <memory>
+
+namespace tiledb {
+namespace sm {
+namespace arrow {
+
+namespace {
+
+/** The description of an exported schema, owned by its `private_data`. */
+struct ExportedSchema {
+  /** The Arrow format string. */
+  std::string format;
+
+  /** The field name. */
+  std::string name;
+
+  /** The child schema of list types, or `nullptr`. */
+  std::unique_ptr<ArrowSchema> child;
+
+  /** The array of children pointers of the schema. */
+  ArrowSchema* children[1];
+};
+
+/** The description of an exported array, owned by its `private_data`. */
+struct ExportedArray {
+  /** The buffers of the array, pointing into the user buffers. */
+  const void* buffers[3];
+
+  /** The child array of list types, or `nullptr`. */
+  std::unique_ptr<ArrowArray> child;
+
+  /** The array of children pointers of the array. */
+  ArrowArray* children[1];
+};
+
+/** The offsets of an empty var-sized array (valid for both widths). */
+const uint64_t empty_offsets = 0;
+
+void release_schema(ArrowSchema* schema) {
+  auto exported = static_cast<ExportedSchema*>(schema->private_data);
+  if (exported->child != nullptr && exported->child->release != nullptr)
+    exported->child->release(exported->child.get());
+  delete exported;
+  schema->release = nullptr;
+}
+
+void release_array(ArrowArray* array) {
+  auto exported = static_cast<ExportedArray*>(array->private_data);
+  if (exported->child != nullptr && exported->child->release != nullptr)
+    exported->child->release(exported->child.get());
+  delete exported;
+  array->release = nullptr;
+}
+
+/** Initializes `schema`, which takes ownership of `exported`. */
+void init_schema(ArrowSchema* schema, ExportedSchema* exported) {
+  exported->children[0] = exported->child.get();
+  schema->format = exported->format.c_str();
+  schema->name = exported->name.c_str();
+  schema->metadata = nullptr;
+  schema->flags = 0;
+  schema->n_children = (exported->child != nullptr) ? 1 : 0;
+  schema->children =
+      (exported->child != nullptr) ? exported->children : nullptr;
+  schema->dictionary = nullptr;
+  schema->release = release_schema;
+  schema->private_data = exported;
+}
+
+/** Initializes `array`, which takes ownership of `exported`. */
+void init_array(
+    ArrowArray* array,
+    int64_t length,
+    int64_t n_buffers,
+    ExportedArray* exported) {
+  exported->children[0] = exported->child.get();
+  array->length = length;
+  array->null_count = 0;
+  array->offset = 0;
+  array->n_buffers = n_buffers;
+  array->n_children = (exported->child != nullptr) ? 1 : 0;
+  array->buffers = exported->buffers;
+  array->children =
+      (exported->child != nullptr) ? exported->children : nullptr;
+  array->dictionary = nullptr;
+  array->release = release_array;
+  array->private_data = exported;
+}
+
+/** Returns `true` for the types exported as Arrow strings or binaries. */
+bool is_byte_string(Datatype type) {
+  return type == Datatype::CHAR || type == Datatype::STRING_ASCII ||
+         type == Datatype::STRING_UTF8;
+}
+
+/** Gets the Arrow format of a primitive array of the given type. */
+Status primitive_format(Datatype type, std::string* format) {
+  switch (type) {
+    case Datatype::INT8:
+      *format = "c";
+      break;
+    case Datatype::UINT8:
+      *format = "C";
+      break;
+    case Datatype::INT16:
+      *format = "s";
+      break;
+    case Datatype::UINT16:
+      *format = "S";
+      break;
+    case Datatype::INT32:
+      *format = "i";
+      break;
+    case Datatype::UINT32:
+      *format = "I";
+      break;
+    case Datatype::INT64:
+      *format = "l";
+      break;
+    case Datatype::UINT64:
+      *format = "L";
+      break;
+    case Datatype::FLOAT32:
+      *format = "f";
+      break;
+    case Datatype::FLOAT64:
+      *format = "g";
+      break;
+    case Datatype::DATETIME_SEC:
+      *format = "tss:";
+      break;
+    case Datatype::DATETIME_MS:
+      *format = "tsm:";
+      break;
+    case Datatype::DATETIME_US:
+      *format = "tsu:";
+      break;
+    case Datatype::DATETIME_NS:
+      *format = "tsn:";
+      break;
+    // Arrow has no 64-bit counterpart of the other datetime units
+    case Datatype::DATETIME_YEAR:
+    case Datatype::DATETIME_MONTH:
+    case Datatype::DATETIME_WEEK:
+    case Datatype::DATETIME_DAY:
+    case Datatype::DATETIME_HR:
+    case Datatype::DATETIME_MIN:
+    case Datatype::DATETIME_PS:
+    case Datatype::DATETIME_FS:
+    case Datatype::DATETIME_AS:
+      *format = "l";
+      break;
+    default:
+      return LOG_STATUS(Status::QueryError(
+          "Cannot export query buffer to Arrow; Unsupported datatype " +
+          datatype_str(type)));
+  }
+
+  return Status::Ok();
+}
+
+/** Creates the child of a list array, holding `length` primitive values. */
+Status make_child(
+    Datatype type,
+    const void* values,
+    uint64_t length,
+    ExportedSchema* parent_schema,
+    ExportedArray* parent_array) {
+  std::unique_ptr<ExportedSchema> schema(new ExportedSchema);
+  RETURN_NOT_OK(primitive_format(type, &schema->format));
+  schema->name = "item";
+  parent_schema->child.reset(new ArrowSchema);
+  init_schema(parent_schema->child.get(), schema.release());
+
+  std::unique_ptr<ExportedArray> array(new ExportedArray);
+  array->buffers[0] = nullptr;
+  array->buffers[1] = values;
+  parent_array->child.reset(new ArrowArray);
+  init_array(parent_array->child.get(), (int64_t)length, 2, array.release());
+
+  return Status::Ok();
+}
+
+}  // namespace
+
+Status export_query_buffer(
+    const Query* query,
+    const std::string& name,
+    ArrowArray* array,
+    ArrowSchema* schema) {
+  if (query->type() != QueryType::READ)
+    return LOG_STATUS(Status::QueryError(
+        "Cannot export query buffer to Arrow; Only read queries have results"));
+  if (query->status() != QueryStatus::COMPLETED &&
+      query->status() != QueryStatus::INCOMPLETE)
+    return LOG_STATUS(Status::QueryError(
+        "Cannot export query buffer to Arrow; The query has no results"));
+  const QueryBuffer buffer = query->buffer(name);
+  if (buffer.buffer_ == nullptr)
+    return LOG_STATUS(Status::QueryError(
+        "Cannot export query buffer to Arrow; No buffer set for '" + name +
+        "'"));
+
+  // Get the type of the values and their number per cell
+  const ArraySchema* array_schema = query->array_schema();
+  Datatype type;
+  uint32_t cell_val_num;
+  if (name == constants::coords) {
+    type = array_schema->coords_type();
+    cell_val_num = array_schema->dim_num();
+  } else {
+    const Attribute* attr = array_schema->attribute(name);
+    if (attr == nullptr)
+      return LOG_STATUS(Status::QueryError(
+          "Cannot export query buffer to Arrow; Unknown attribute '" + name +
+          "'"));
+    type = attr->type();
+    cell_val_num = attr->cell_val_num();
+  }
+  const uint64_t type_size = datatype_size(type);
+
+  std::unique_ptr<ExportedSchema> exported_schema(new ExportedSchema);
+  std::unique_ptr<ExportedArray> exported_array(new ExportedArray);
+  exported_schema->name = name;
+  exported_array->buffers[0] = nullptr;
+  int64_t length = 0, n_buffers = 2;
+
+  if (cell_val_num == constants::var_num) {
+    // The offsets must be those of Arrow: n + 1 of them for n cells
+    const Reader* reader = query->reader();
+    if (!reader->offsets_extra_element())
+      return LOG_STATUS(Status::QueryError(
+          "Cannot export query buffer to Arrow; Var-sized results need "
+          "'sm.var_offsets.extra_element' set to true"));
+    const bool large = reader->offsets_bitsize() == 64;
+    const uint64_t offset_size = reader->offsets_bitsize() / 8;
+    const void* offsets = buffer.buffer_;
+    if (*buffer.buffer_size_ < 2 * offset_size) {
+      offsets = &empty_offsets;
+    } else {
+      length = (int64_t)(*buffer.buffer_size_ / offset_size - 1);
+    }
+
+    if (is_byte_string(type) || type_size == 1) {
+      const bool utf8 =
+          type == Datatype::STRING_ASCII || type == Datatype::STRING_UTF8;
+      exported_schema->format =
+          utf8 ? (large ? "U" : "u") : (large ? "Z" : "z");
+      exported_array->buffers[1] = offsets;
+      exported_array->buffers[2] = buffer.buffer_var_;
+      n_buffers = 3;
+    } else {
+      if (!reader->offsets_in_elements())
+        return LOG_STATUS(Status::QueryError(
+            "Cannot export query buffer to Arrow; Var-sized results of "
+            "multi-byte types need 'sm.var_offsets.mode' set to 'elements'"));
+      exported_schema->format = large ? "+L" : "+l";
+      const uint64_t value_num =
+          large ? static_cast<const uint64_t*>(offsets)[length] :
+                  static_cast<const uint32_t*>(offsets)[length];
+      RETURN_NOT_OK(make_child(
+          type,
+          buffer.buffer_var_,
+          value_num,
+          exported_schema.get(),
+          exported_array.get()));
+      exported_array->buffers[1] = offsets;
+    }
+  } else if (is_byte_string(type)) {
+    exported_schema->format = "w:" + std::to_string(cell_val_num);
+    length = (int64_t)(*buffer.buffer_size_ / cell_val_num);
+    exported_array->buffers[1] = buffer.buffer_;
+  } else if (cell_val_num == 1) {
+    RETURN_NOT_OK(primitive_format(type, &exported_schema->format));
+    length = (int64_t)(*buffer.buffer_size_ / type_size);
+    exported_array->buffers[1] = buffer.buffer_;
+  } else {
+    exported_schema->format = "+w:" + std::to_string(cell_val_num);
+    length = (int64_t)(*buffer.buffer_size_ / (type_size * cell_val_num));
+    RETURN_NOT_OK(make_child(
+        type,
+        buffer.buffer_,
+        (uint64_t)length * cell_val_num,
+        exported_schema.get(),
+        exported_array.get()));
+    n_buffers = 1;
+  }
+
+  init_schema(schema, exported_schema.release());
+  init_array(array, length, n_buffers, exported_array.release());
+
+  return Status::Ok();
+}
+
+}  // namespace arrow
+}  // namespace sm
+}  // namespace tiledb
@@ -0,0 +1,131 @@
+/**
+ * @file   arrow_export.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * @section DESCRIPTION
+ *
+ * This file declares the export of query results through the Apache Arrow C
+ * data interface.
+ */
+
+#ifndef TILEDB_ARROW_EXPORT_H
+#define TILEDB_ARROW_EXPORT_H
+
+#include <cstdint>
+#include <string>
+
+#include "tiledb/sm/misc/status.h"
+
+/*
+ * The structs of the Apache Arrow C data interface, which is ABI-stable, as
+ * specified in https://arrow.apache.org/docs/format/CDataInterface.html.
+ * The guard lets them coexist with the definitions of Arrow itself.
+ */
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+  // Array type description
+  const char* format;
+  const char* name;
+  const char* metadata;
+  int64_t flags;
+  int64_t n_children;
+  struct ArrowSchema** children;
+  struct ArrowSchema* dictionary;
+
+  // Release callback
+  void (*release)(struct ArrowSchema*);
+  // Opaque producer-specific data
+  void* private_data;
+};
+
+struct ArrowArray {
+  // Array data description
+  int64_t length;
+  int64_t null_count;
+  int64_t offset;
+  int64_t n_buffers;
+  int64_t n_children;
+  const void** buffers;
+  struct ArrowArray** children;
+  struct ArrowArray* dictionary;
+
+  // Release callback
+  void (*release)(struct ArrowArray*);
+  // Opaque producer-specific data
+  void* private_data;
+};
+
+#endif  // ARROW_C_DATA_INTERFACE
+
+namespace tiledb {
+namespace sm {
+
+class Query;
+
+namespace arrow {
+
+/**
+ * Exports the results of a read query for an attribute (or the zipped
+ * coordinates) as an Arrow array, without copying them: the buffers of the
+ * array are the user buffers of the query, which must outlive it. The
+ * exported structs own only their descriptions, freed by their `release`
+ * callbacks.
+ *
+ * Fixed-sized attributes with one value per cell are exported as primitive
+ * arrays, and those with several values per cell (and the coordinates) as
+ * fixed-size lists, or fixed-size binaries for string types. Var-sized
+ * attributes are exported as strings (`STRING_ASCII`, `STRING_UTF8`),
+ * binaries (`CHAR` and other byte types) or lists, which requires the query
+ * to have written Arrow-compatible offsets: the end offset of the last
+ * cell must be appended (`sm.var_offsets.extra_element`), and lists need
+ * offsets in elements (`sm.var_offsets.mode`). 32-bit offsets
+ * (`sm.var_offsets.bitsize`) give the regular Arrow types, 64-bit offsets
+ * the large ones.
+ *
+ * @param query The read query, whose last submission has succeeded.
+ * @param name The attribute name, or `constants::coords`.
+ * @param array The Arrow array to initialize.
+ * @param schema The Arrow schema to initialize.
+ * @return Status
+ */
+Status export_query_buffer(
+    const Query* query,
+    const std::string& name,
+    ArrowArray* array,
+    ArrowSchema* schema);
+
+}  // namespace arrow
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_ARROW_EXPORT_H
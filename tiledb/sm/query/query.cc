@@ -37,6 +37,7 @@
 #include "tiledb/sm/misc/logger.h"
 #include "tiledb/sm/misc/stats.h"
 #include "tiledb/sm/rest/rest_client.h"
+#include "tiledb/sm/storage_manager/pyramid_builder.h"
 #include "tiledb/sm/storage_manager/storage_manager.h"
 
 #include <cassert>
@@ -52,6 +53,7 @@ namespace sm {
 
 Query::Query(StorageManager* storage_manager, Array* array, URI fragment_uri)
     : array_(array)
+    , base_array_(array)
     , storage_manager_(storage_manager) {
   assert(array != nullptr && array->is_open());
 
@@ -59,6 +61,10 @@ Query::Query(StorageManager* storage_manager, Array* array, URI fragment_uri)
   callback_data_ = nullptr;
   layout_ = Layout::ROW_MAJOR;
   status_ = QueryStatus::UNINITIALIZED;
+  prepared_ = false;
+  priority_ = QueryPriority::QUERY_PRIORITY_NORMAL;
+  stats_sampled_ = storage_manager != nullptr &&
+                   storage_manager->sample_query_stats();
   auto st = array->get_query_type(&type_);
   assert(st.ok());
 
@@ -201,10 +207,19 @@ QueryBuffer Query::buffer(const std::string& name) const {
   return reader_.buffer(name);
 }
 
+void Query::disable_write_buffer() {
+  if (type_ == QueryType::WRITE)
+    writer_.disable_write_buffer();
+}
+
 Status Query::finalize() {
-  if (status_ == QueryStatus::UNINITIALIZED)
+  // A query stitching the fragment parts of other queries is not submitted
+  if (status_ == QueryStatus::UNINITIALIZED &&
+      (type_ != QueryType::WRITE || !writer_.has_fragment_parts()))
     return Status::Ok();
 
+  stats::QueryStatsScope stats_scope(stats_.get());
+
   if (array_->is_remote()) {
     auto rest_client = storage_manager_->rest_client();
     if (rest_client == nullptr)
@@ -213,6 +228,7 @@ Status Query::finalize() {
 
     array_->array_schema()->set_array_uri(array_->array_uri());
 
+    rest_stream_.reset();
     return rest_client->finalize_query_to_rest(array_->array_uri(), this);
   }
 
@@ -312,7 +328,11 @@ Status Query::init() {
     }
 
     if (type_ == QueryType::READ) {
-      RETURN_NOT_OK(reader_.init());
+      // Prepared reads only reset their read state for the new subarray
+      if (prepared_)
+        RETURN_NOT_OK(reader_.reinit());
+      else
+        RETURN_NOT_OK(reader_.init());
     } else {  // Write
       RETURN_NOT_OK(writer_.init());
     }
@@ -323,6 +343,21 @@ Status Query::init() {
   return Status::Ok();
 }
 
+Status Query::prepare() {
+  if (type_ != QueryType::READ)
+    return LOG_STATUS(Status::QueryError(
+        "Cannot prepare query; Only applicable to read queries"));
+
+  // Remote queries are initialized by the server on each submission
+  if (array_->is_remote())
+    return Status::Ok();
+
+  RETURN_NOT_OK(init());
+  prepared_ = true;
+
+  return Status::Ok();
+}
+
 URI Query::first_fragment_uri() const {
   if (type_ == QueryType::WRITE)
     return URI();
@@ -344,47 +379,16 @@ Status Query::cancel() {
   return Status::Ok();
 }
 
-Status Query::check_var_attr_offsets(
-    const uint64_t* buffer_off,
-    const uint64_t* buffer_off_size,
-    const uint64_t* buffer_val_size) {
-  if (buffer_off == nullptr || buffer_off_size == nullptr ||
-      buffer_val_size == nullptr)
-    return LOG_STATUS(Status::QueryError("Cannot use null offset buffers."));
-
-  auto num_offsets = *buffer_off_size / sizeof(uint64_t);
-  if (num_offsets == 0)
-    return Status::Ok();
-
-  uint64_t prev_offset = buffer_off[0];
-  if (prev_offset >= *buffer_val_size)
-    return LOG_STATUS(Status::QueryError(
-        "Invalid offsets; offset " + std::to_string(prev_offset) +
-        " specified for buffer of size " + std::to_string(*buffer_val_size)));
-
-  for (uint64_t i = 1; i < num_offsets; i++) {
-    if (buffer_off[i] <= prev_offset)
-      return LOG_STATUS(
-          Status::QueryError("Invalid offsets; offsets must be given in "
-                             "strictly ascending order."));
-
-    if (buffer_off[i] >= *buffer_val_size)
-      return LOG_STATUS(Status::QueryError(
-          "Invalid offsets; offset " + std::to_string(buffer_off[i]) +
-          " specified for buffer of size " + std::to_string(*buffer_val_size)));
-
-    prev_offset = buffer_off[i];
-  }
-
-  return Status::Ok();
-}
-
 Status Query::process() {
   if (status_ == QueryStatus::UNINITIALIZED)
     return LOG_STATUS(
         Status::QueryError("Cannot process query; Query is not initialized"));
   status_ = QueryStatus::INPROGRESS;
 
+  // Give all the tasks of the query its priority and stats
+  ThreadPool::PriorityScope priority_scope(task_priority());
+  stats::QueryStatsScope stats_scope(stats_.get());
+
   // Process query
   Status st = Status::Ok();
   if (type_ == QueryType::READ)
@@ -429,6 +433,14 @@ Writer* Query::writer() {
   return &writer_;
 }
 
+std::shared_ptr<RestQueryStream> Query::rest_stream() const {
+  return rest_stream_;
+}
+
+void Query::set_rest_stream(std::shared_ptr<RestQueryStream> stream) {
+  rest_stream_ = std::move(stream);
+}
+
 Status Query::set_buffer(
     const std::string& attribute,
     void* buffer,
@@ -458,8 +470,200 @@ Status Query::set_buffer(
       check_null_buffers);
 }
 
+Status Query::set_managed_buffer(const std::string& attribute) {
+  if (type_ != QueryType::READ)
+    return LOG_STATUS(Status::QueryError(
+        "Cannot set managed buffer; Only applicable to read queries"));
+  if (array_->is_remote())
+    return LOG_STATUS(Status::QueryError(
+        "Cannot set managed buffer; Not supported for remote arrays"));
+
+  prepared_ = false;
+  return reader_.set_managed_buffer(attribute);
+}
+
+Status Query::set_condition(const QueryCondition& condition) {
+  if (type_ != QueryType::READ)
+    return LOG_STATUS(Status::QueryError(
+        "Cannot set query condition; Only applicable to read queries"));
+  if (array_->is_remote())
+    return LOG_STATUS(Status::QueryError(
+        "Cannot set query condition; Not supported for remote arrays"));
+
+  prepared_ = false;
+  return reader_.set_condition(condition);
+}
+
+Status Query::add_aggregate(
+    const std::string& name, AggregateOp op, void* result) {
+  if (type_ != QueryType::READ)
+    return LOG_STATUS(Status::QueryError(
+        "Cannot add aggregate; Only applicable to read queries"));
+  if (array_->is_remote())
+    return LOG_STATUS(Status::QueryError(
+        "Cannot add aggregate; Not supported for remote arrays"));
+
+  prepared_ = false;
+  return reader_.add_aggregate(name, op, result);
+}
+
+Status Query::set_limit(uint64_t limit) {
+  if (type_ != QueryType::READ)
+    return LOG_STATUS(Status::QueryError(
+        "Cannot set limit; Only applicable to read queries"));
+  if (array_->is_remote())
+    return LOG_STATUS(Status::QueryError(
+        "Cannot set limit; Not supported for remote arrays"));
+
+  prepared_ = false;
+  return reader_.set_limit(limit);
+}
+
+Status Query::set_deadline(uint64_t deadline_ms) {
+  if (type_ != QueryType::READ)
+    return LOG_STATUS(Status::QueryError(
+        "Cannot set deadline; Only applicable to read queries"));
+  if (array_->is_remote())
+    return LOG_STATUS(Status::QueryError(
+        "Cannot set deadline; Not supported for remote arrays"));
+
+  return reader_.set_deadline(deadline_ms);
+}
+
+Status Query::set_sample(double fraction, uint64_t seed) {
+  if (type_ != QueryType::READ)
+    return LOG_STATUS(Status::QueryError(
+        "Cannot set sample; Only applicable to read queries"));
+  if (array_->is_remote())
+    return LOG_STATUS(Status::QueryError(
+        "Cannot set sample; Not supported for remote arrays"));
+
+  prepared_ = false;
+  return reader_.set_sample(fraction, seed);
+}
+
+double Query::sample_ratio() const {
+  if (type_ != QueryType::READ)
+    return 1.0;
+  return reader_.sample_ratio();
+}
+
+Status Query::set_resolution_level(uint32_t level) {
+  if (type_ != QueryType::READ)
+    return LOG_STATUS(Status::QueryError(
+        "Cannot set resolution level; Only applicable to read queries"));
+  if (base_array_->is_remote())
+    return LOG_STATUS(Status::QueryError(
+        "Cannot set resolution level; Not supported for remote arrays"));
+  if (!base_array_->array_schema()->dense())
+    return LOG_STATUS(Status::QueryError(
+        "Cannot set resolution level; Only applicable to dense arrays"));
+
+  std::shared_ptr<Array> level_array;
+  if (level > 0) {
+    auto uri = PyramidBuilder::level_uri(base_array_->array_uri(), level);
+    bool is_array = false;
+    RETURN_NOT_OK(storage_manager_->is_array(uri, &is_array));
+    if (!is_array)
+      return LOG_STATUS(Status::QueryError(
+          "Cannot set resolution level; Level " + std::to_string(level) +
+          " does not exist"));
+
+    const auto& encryption_key = base_array_->get_encryption_key();
+    auto key = encryption_key.key();
+    std::unique_ptr<Array> array(new Array(uri, storage_manager_));
+    RETURN_NOT_OK(array->open(
+        QueryType::READ,
+        encryption_key.encryption_type(),
+        key.size() == 0 ? nullptr : key.data(),
+        (uint32_t)key.size()));
+    level_array.reset(array.release(), [](Array* a) {
+      a->close();
+      delete a;
+    });
+  }
+
+  array_ = level_array != nullptr ? level_array.get() : base_array_;
+  reader_.set_array(array_);
+  reader_.set_array_schema(array_->array_schema());
+  reader_.set_fragment_metadata(array_->fragment_metadata());
+  RETURN_NOT_OK(reader_.set_layout(layout_));
+  level_array_ = level_array;
+  prepared_ = false;
+
+  return Status::Ok();
+}
+
+Status Query::set_fragment_part(Query* fragment_query, uint32_t part) {
+  if (type_ != QueryType::WRITE || fragment_query->type_ != QueryType::WRITE)
+    return LOG_STATUS(Status::QueryError(
+        "Cannot set fragment part; Applicable only to write queries"));
+  if (status_ != QueryStatus::UNINITIALIZED ||
+      fragment_query->status_ != QueryStatus::UNINITIALIZED)
+    return LOG_STATUS(Status::QueryError(
+        "Cannot set fragment part; The query has already been submitted"));
+  if (array_->is_remote() || fragment_query->array_->is_remote())
+    return LOG_STATUS(Status::QueryError(
+        "Cannot set fragment part; Not supported for remote arrays"));
+  if (array_->array_uri().to_string() !=
+      fragment_query->array_->array_uri().to_string())
+    return LOG_STATUS(Status::QueryError(
+        "Cannot set fragment part; The queries must write the same array"));
+
+  URI part_uri;
+  RETURN_NOT_OK(fragment_query->writer_.add_fragment_part(part, &part_uri));
+  writer_.set_fragment_part(part_uri);
+
+  return Status::Ok();
+}
+
+Status Query::set_offsets_bitsize(uint32_t bitsize) {
+  if (status_ != QueryStatus::UNINITIALIZED)
+    return LOG_STATUS(Status::QueryError(
+        "Cannot set offsets bitsize; The query has already been submitted"));
+  if (array_->is_remote())
+    return LOG_STATUS(Status::QueryError(
+        "Cannot set offsets bitsize; Not supported for remote arrays"));
+
+  if (type_ == QueryType::WRITE)
+    return writer_.set_offsets_bitsize(bitsize);
+  return reader_.set_offsets_bitsize(bitsize);
+}
+
+Status Query::set_priority(QueryPriority priority) {
+  if (priority != QueryPriority::QUERY_PRIORITY_NORMAL &&
+      priority != QueryPriority::QUERY_PRIORITY_HIGH &&
+      priority != QueryPriority::QUERY_PRIORITY_LOW)
+    return LOG_STATUS(
+        Status::QueryError("Cannot set priority; Invalid query priority"));
+
+  priority_ = priority;
+  return Status::Ok();
+}
+
+QueryPriority Query::priority() const {
+  return priority_;
+}
+
+ThreadPool::Priority Query::task_priority() const {
+  switch (priority_) {
+    case QueryPriority::QUERY_PRIORITY_HIGH:
+      return ThreadPool::Priority::HIGH;
+    case QueryPriority::QUERY_PRIORITY_LOW:
+      return ThreadPool::Priority::BACKGROUND;
+    default:
+      return ThreadPool::Priority::COMPUTE;
+  }
+}
+
 Status Query::set_layout(Layout layout) {
+  if (layout == Layout::HILBERT)
+    return LOG_STATUS(Status::QueryError(
+        "Cannot set layout; The Hilbert layout can only be used as the cell "
+        "order of sparse arrays"));
+
   layout_ = layout;
+  prepared_ = false;
   if (type_ == QueryType::WRITE)
     return writer_.set_layout(layout);
   return reader_.set_layout(layout);
@@ -470,6 +674,7 @@ Status Query::set_sparse_mode(bool sparse_mode) {
     return LOG_STATUS(Status::QueryError(
         "Cannot set sparse mode; Only applicable to read queries"));
 
+  prepared_ = false;
   return reader_.set_sparse_mode(sparse_mode);
 }
 
@@ -486,6 +691,7 @@ Status Query::set_subarray(const void* subarray, bool check_expanded_domain) {
   }
 
   status_ = QueryStatus::UNINITIALIZED;
+  rest_stream_.reset();
 
   return Status::Ok();
 }
@@ -504,6 +710,7 @@ Status Query::set_subarray(const Subarray& subarray) {
   }
 
   status_ = QueryStatus::UNINITIALIZED;
+  rest_stream_.reset();
 
   return Status::Ok();
 }
@@ -513,6 +720,7 @@ Status Query::submit() {
   if (type_ == QueryType::READ && status_ == QueryStatus::COMPLETED) {
     return Status::Ok();
   }
+  stats::QueryStatsScope stats_scope(enabled_stats());
   if (array_->is_remote()) {
     auto rest_client = storage_manager_->rest_client();
     if (rest_client == nullptr)
@@ -534,21 +742,85 @@ Status Query::submit_async(
     callback(callback_data);
     return Status::Ok();
   }
+  stats::QueryStatsScope stats_scope(enabled_stats());
+  if (array_->is_remote()) {
+    auto rest_client = storage_manager_->rest_client();
+    if (rest_client == nullptr)
+      return LOG_STATUS(Status::QueryError(
+          "Error in async query submission; remote array with no rest "
+          "client."));
+
+    array_->array_schema()->set_array_uri(array_->array_uri());
+
+    callback_ = callback;
+    callback_data_ = callback_data;
+    return rest_client->submit_query_to_rest_async(
+        array_->array_uri(), this, [this](const Status& st) {
+          // Handle the callback and status as in `process`.
+          if (!st.ok()) {
+            status_ = QueryStatus::FAILED;
+            return;
+          }
+          if (status_ == QueryStatus::COMPLETED && callback_ != nullptr)
+            callback_(callback_data_);
+        });
+  }
   RETURN_NOT_OK(init());
-  if (array_->is_remote())
-    return LOG_STATUS(
-        Status::QueryError("Error in async query submission; async queries not "
-                           "supported for remote arrays."));
 
   callback_ = callback;
   callback_data_ = callback_data;
   return storage_manager_->query_submit_async(this);
 }
 
+Status Query::submit_async(void* completion_tag) {
+  // Do not resubmit completed reads.
+  if (type_ == QueryType::READ && status_ == QueryStatus::COMPLETED) {
+    storage_manager_->post_completion(completion_tag);
+    return Status::Ok();
+  }
+  stats::QueryStatsScope stats_scope(enabled_stats());
+  callback_ = nullptr;
+  callback_data_ = nullptr;
+  if (array_->is_remote()) {
+    auto rest_client = storage_manager_->rest_client();
+    if (rest_client == nullptr)
+      return LOG_STATUS(Status::QueryError(
+          "Error in async query submission; remote array with no rest "
+          "client."));
+
+    array_->array_schema()->set_array_uri(array_->array_uri());
+
+    return rest_client->submit_query_to_rest_async(
+        array_->array_uri(), this, [this, completion_tag](const Status& st) {
+          if (!st.ok())
+            status_ = QueryStatus::FAILED;
+          storage_manager_->post_completion(completion_tag);
+        });
+  }
+  RETURN_NOT_OK(init());
+
+  return storage_manager_->query_submit_async(this, completion_tag);
+}
+
 QueryStatus Query::status() const {
   return status_;
 }
 
+Status Query::stats(std::string* json) const {
+  if (stats_ != nullptr) {
+    stats_->dump(json);
+  } else {
+    std::unique_ptr<stats::Statistics> stats(new stats::Statistics());
+    stats->dump(json);
+  }
+
+  return Status::Ok();
+}
+
+bool Query::has_stats() const {
+  return stats_ != nullptr;
+}
+
 QueryType Query::type() const {
   return type_;
 }
@@ -629,5 +901,17 @@ Status Query::check_subarray(
   return Status::Ok();
 }
 
+stats::Statistics* Query::enabled_stats() {
+  if (stats_ == nullptr) {
+    if (stats::all_stats.enabled()) {
+      stats_.reset(new stats::Statistics());
+    } else if (stats_sampled_) {
+      stats_.reset(new stats::Statistics());
+      stats_->set_sampled(true, storage_manager_->sample_query_traces());
+    }
+  }
+  return stats_.get();
+}
+
 }  // namespace sm
 }  // namespace tiledb
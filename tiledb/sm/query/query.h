@@ -34,6 +34,7 @@
 #define TILEDB_QUERY_H
 
 #include <functional>
+#include <memory>
 #include <sstream>
 #include <utility>
 #include <vector>
@@ -41,8 +42,11 @@
 #include "tiledb/sm/array_schema/array_schema.h"
 #include "tiledb/sm/array_schema/dimension.h"
 #include "tiledb/sm/array_schema/domain.h"
+#include "tiledb/sm/enums/query_priority.h"
 #include "tiledb/sm/misc/logger.h"
+#include "tiledb/sm/misc/stats.h"
 #include "tiledb/sm/misc/status.h"
+#include "tiledb/sm/misc/thread_pool.h"
 #include "tiledb/sm/misc/utils.h"
 #include "tiledb/sm/query/reader.h"
 #include "tiledb/sm/query/writer.h"
@@ -51,6 +55,7 @@ namespace tiledb {
 namespace sm {
 
 class Array;
+class RestQueryStream;
 class Subarray;
 class StorageManager;
 
@@ -195,17 +200,11 @@ class Query {
   Status cancel();
 
   /**
-   * Check the validity of the provided buffer offsets for a variable attribute.
-   *
-   * @param buffer_off Offset buffer
-   * @param buffer_off_size Pointer to size of offset buffer
-   * @param buffer_val_size Pointer to size of data buffer
-   * @return Status
+   * Makes a write query write its cells right away, even if the context
+   * buffers the unordered writes (see `sm.write_buffer.max_size`).
+   * Applicable only to writes.
    */
-  static Status check_var_attr_offsets(
-      const uint64_t* buffer_off,
-      const uint64_t* buffer_off_size,
-      const uint64_t* buffer_val_size);
+  void disable_write_buffer();
 
   /**
    * Finalizes the query, flushing all internal state. Applicable only to global
@@ -264,6 +263,17 @@ class Query {
   /** Initializes the query. */
   Status init();
 
+  /**
+   * Prepares a read query for repeated submissions: it validates and
+   * initializes the query once, after which setting a new subarray only
+   * resets the read state, and restores the buffer sizes, instead of
+   * initializing the query again. Setting the layout, sparse mode, limit,
+   * condition or aggregates undoes the preparation.
+   *
+   * @return Status
+   */
+  Status prepare();
+
   /** Returns the first fragment uri. */
   URI first_fragment_uri() const;
 
@@ -288,6 +298,16 @@ class Query {
   /** Returns the Writer. */
   Writer* writer();
 
+  /**
+   * Returns the paused response of this query streamed from the REST server
+   * (see `rest.stream_incomplete`), which the next submission resumes, or
+   * null if there is none.
+   */
+  std::shared_ptr<RestQueryStream> rest_stream() const;
+
+  /** Sets the paused response streamed from the REST server (may be null). */
+  void set_rest_stream(std::shared_ptr<RestQueryStream> stream);
+
   /**
    * Sets the buffer for a fixed-sized attribute.
    *
@@ -338,6 +358,130 @@ class Query {
       uint64_t* buffer_val_size,
       bool check_null_buffers = true);
 
+  /**
+   * Makes a read query allocate the result buffers of an attribute itself.
+   * They grow to fit the results of each partition, up to
+   * `sm.memory_budget` and `sm.memory_budget_var`, so that the partitions
+   * are not split to fit small user buffers. After each submission the
+   * results are retrieved without a copy with `get_buffer`, and stay valid
+   * until the next submission.
+   *
+   * @param attribute The attribute to allocate the buffers of.
+   * @return Status
+   */
+  Status set_managed_buffer(const std::string& attribute);
+
+  /**
+   * Sets the condition that the result cells of a read query must satisfy.
+   * Only cells satisfying it are copied to the result buffers.
+   *
+   * @param condition The query condition.
+   * @return Status
+   */
+  Status set_condition(const QueryCondition& condition);
+
+  /**
+   * Adds an aggregate over the input attribute to a read query. A query
+   * with aggregates computes them over all its result cells when it is
+   * submitted, and cannot set result buffers.
+   *
+   * @param name The aggregated attribute.
+   * @param op The aggregate operator.
+   * @param result The location the result is written to.
+   * @return Status
+   */
+  Status add_aggregate(const std::string& name, AggregateOp op, void* result);
+
+  /**
+   * Sets the maximum number of result cells a read query on a sparse array
+   * returns over all its submissions. The query completes once it has
+   * returned `limit` cells.
+   *
+   * @param limit The maximum number of result cells.
+   * @return Status
+   */
+  Status set_limit(uint64_t limit);
+
+  /**
+   * Sets the wall-clock budget of each submission of a read query. A
+   * submission that would exceed it stops between partitions and returns
+   * an incomplete result.
+   *
+   * @param deadline_ms The budget in milliseconds, `0` for none.
+   * @return Status
+   */
+  Status set_deadline(uint64_t deadline_ms);
+
+  /**
+   * Makes a read query on a sparse array read a random sample of the
+   * overlapping tiles, each kept with probability `fraction`.
+   *
+   * @param fraction The probability of a tile to be read, in `(0, 1]`.
+   * @param seed The seed of the sample.
+   * @return Status
+   */
+  Status set_sample(double fraction, uint64_t seed);
+
+  /**
+   * Returns the ratio of the cells in the tiles read by a sampled query
+   * over the cells in all the overlapping tiles.
+   */
+  double sample_ratio() const;
+
+  /**
+   * Makes a read query on a dense array read a downsampled level of its
+   * pyramid (see `sm.consolidation.pyramid_levels`) instead of the array.
+   * Level `l` has the domain of the array with `2^l` times fewer cells along
+   * each dimension, starting at the same lower bounds, and the fixed-sized
+   * attributes of the array. It must be set before the subarray and the
+   * buffers, which are given in the domain of the level.
+   *
+   * @param level The pyramid level, `0` for the array itself.
+   * @return Status
+   */
+  Status set_resolution_level(uint32_t level);
+
+  /**
+   * Makes this global order write query write a part of the fragment of
+   * `fragment_query`, concurrently with the queries writing its other
+   * parts. The finalization of `fragment_query`, after that of all the part
+   * queries, stitches the parts into a single fragment (see
+   * `Writer::add_fragment_part`).
+   *
+   * @param fragment_query The global order write query of the fragment.
+   * @param part The index of the part, unique within the fragment.
+   * @return Status
+   */
+  Status set_fragment_part(Query* fragment_query, uint32_t part);
+
+  /**
+   * Sets the width in bits (32 or 64) of the var-sized offsets in the
+   * buffers of this query, overriding `sm.var_offsets.bitsize`.
+   *
+   * @param bitsize The offsets width in bits.
+   * @return Status
+   */
+  Status set_offsets_bitsize(uint32_t bitsize);
+
+  /**
+   * Sets the scheduling priority of the tasks the query enqueues when it is
+   * processed, including the tile reads, filtering and VFS tasks.
+   *
+   * @param priority The query priority.
+   * @return Status
+   */
+  Status set_priority(QueryPriority priority);
+
+  /** Returns the query priority. */
+  QueryPriority priority() const;
+
+  /**
+   * Returns the thread pool priority class of the query tasks: `HIGH` for
+   * high and `BACKGROUND` for low priority queries, which all their nested
+   * tasks inherit, and `COMPUTE` otherwise.
+   */
+  ThreadPool::Priority task_priority() const;
+
   /**
    * Sets the cell layout of the query. The function will return an error
    * if the queried array is a key-value store (because it has its default
@@ -397,9 +541,32 @@ class Query {
    */
   Status submit_async(std::function<void(void*)> callback, void* callback_data);
 
+  /**
+   * Submits the query to the storage manager for asynchronous processing.
+   * Once the query is processed, whether it completed, is incomplete, failed
+   * or was cancelled, `completion_tag` is posted to the completion queue of
+   * the storage manager.
+   */
+  Status submit_async(void* completion_tag);
+
   /** Returns the query status. */
   QueryStatus status() const;
 
+  /**
+   * Retrieves the stats of the query, gathered across its submissions while
+   * stats are enabled, in the JSON format of the global stats dump.
+   *
+   * @param json The stats to be retrieved.
+   * @return Status
+   */
+  Status stats(std::string* json) const;
+
+  /**
+   * Returns true if the query has gathered stats, i.e., if it was submitted
+   * while stats were enabled or its stats are sampled.
+   */
+  bool has_stats() const;
+
   /** Returns the query type. */
   QueryType type() const;
 
@@ -408,9 +575,15 @@ class Query {
   /*         PRIVATE ATTRIBUTES        */
   /* ********************************* */
 
-  /** The array the query is associated with. */
+  /**
+   * The array the query is associated with, or its pyramid level read by
+   * the query.
+   */
   Array* array_;
 
+  /** The array the query was created with. */
+  Array* base_array_;
+
   /** A function that will be called upon the completion of an async query. */
   std::function<void(void*)> callback_;
 
@@ -429,6 +602,32 @@ class Query {
   /** The query type. */
   QueryType type_;
 
+  /** True if the query has been prepared for repeated submissions. */
+  bool prepared_;
+
+  /** The scheduling priority of the tasks of the query. */
+  QueryPriority priority_;
+
+  /**
+   * True if the query gathers its stats while the global stats are
+   * disabled, drawn by `sm.stats.sample_rate` when the query is created.
+   */
+  bool stats_sampled_;
+
+  /**
+   * The stats of the query, created on its first submission while stats are
+   * enabled or if they are sampled. The tasks of the query share their
+   * ownership, so they must precede the reader and writer, which wait for
+   * their tasks when destroyed.
+   */
+  std::shared_ptr<stats::Statistics> stats_;
+
+  /**
+   * The pyramid level read by the query, if any, closed when released. It
+   * must precede the reader, which uses its fragment metadata.
+   */
+  std::shared_ptr<Array> level_array_;
+
   /** Query reader. */
   Reader reader_;
 
@@ -438,6 +637,12 @@ class Query {
   /** The current serialization state. */
   SerializationState serialization_state_;
 
+  /**
+   * The paused response streamed from the REST server, if any. It is
+   * discarded when the subarray changes.
+   */
+  std::shared_ptr<RestQueryStream> rest_stream_;
+
   /* ********************************* */
   /*           PRIVATE METHODS         */
   /* ********************************* */
@@ -580,6 +785,12 @@ class Query {
 
     return subarray_ss.str();
   }
+
+  /**
+   * Returns the stats of the query, creating them if stats are enabled or
+   * sampled, or `nullptr` if they are not and have not been created.
+   */
+  stats::Statistics* enabled_stats();
 };
 
 }  // namespace sm
@@ -0,0 +1,493 @@
+/**
+ * @file   query_condition.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file implements class QueryCondition.
+ */
+
+#include "tiledb/sm/query/query_condition.h"
+#include "tiledb/sm/array_schema/array_schema.h"
+#include "tiledb/sm/array_schema/attribute.h"
+#include "tiledb/sm/enums/datatype.h"
+#include "tiledb/sm/misc/constants.h"
+#include "tiledb/sm/misc/logger.h"
+#include "tiledb/sm/misc/parallel_functions.h"
+#include "tiledb/sm/query/result_tile.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+
+namespace tiledb {
+namespace sm {
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+Status QueryCondition::init(
+    const std::string& attribute_name,
+    const void* condition_value,
+    uint64_t condition_value_size,
+    QueryConditionOp op) {
+  if (tree_ != nullptr)
+    return LOG_STATUS(Status::QueryConditionError(
+        "Cannot initialize query condition; Already initialized"));
+  if (condition_value == nullptr || condition_value_size == 0)
+    return LOG_STATUS(Status::QueryConditionError(
+        "Cannot initialize query condition; Invalid condition value"));
+
+  auto node = std::make_shared<Node>();
+  node->field_name_ = attribute_name;
+  node->condition_value_.resize(condition_value_size);
+  std::memcpy(
+      &node->condition_value_[0], condition_value, condition_value_size);
+  node->op_ = op;
+  tree_ = node;
+  field_names_.insert(attribute_name);
+
+  return Status::Ok();
+}
+
+Status QueryCondition::check(const ArraySchema* array_schema) const {
+  if (tree_ == nullptr)
+    return LOG_STATUS(Status::QueryConditionError(
+        "Invalid query condition; Condition is not initialized"));
+
+  for (const auto& field_name : field_names_) {
+    auto attr = array_schema->attribute(field_name);
+    if (attr == nullptr)
+      return LOG_STATUS(Status::QueryConditionError(
+          "Invalid query condition; Unknown attribute '" + field_name +
+          "'"));
+    if (attr->var_size() || attr->cell_val_num() != 1)
+      return LOG_STATUS(Status::QueryConditionError(
+          "Invalid query condition; Attribute '" + field_name +
+          "' must have a single fixed-sized value per cell"));
+
+    switch (attr->type()) {
+      case Datatype::CHAR:
+      case Datatype::INT8:
+      case Datatype::UINT8:
+      case Datatype::INT16:
+      case Datatype::UINT16:
+      case Datatype::INT32:
+      case Datatype::UINT32:
+      case Datatype::INT64:
+      case Datatype::UINT64:
+      case Datatype::FLOAT32:
+      case Datatype::FLOAT64:
+      case Datatype::DATETIME_YEAR:
+      case Datatype::DATETIME_MONTH:
+      case Datatype::DATETIME_WEEK:
+      case Datatype::DATETIME_DAY:
+      case Datatype::DATETIME_HR:
+      case Datatype::DATETIME_MIN:
+      case Datatype::DATETIME_SEC:
+      case Datatype::DATETIME_MS:
+      case Datatype::DATETIME_US:
+      case Datatype::DATETIME_NS:
+      case Datatype::DATETIME_PS:
+      case Datatype::DATETIME_FS:
+      case Datatype::DATETIME_AS:
+        break;
+      default:
+        return LOG_STATUS(Status::QueryConditionError(
+            "Invalid query condition; Attribute '" + field_name +
+            "' has an unsupported type"));
+    }
+  }
+
+  // Check the sizes of the condition values
+  std::vector<const Node*> nodes = {tree_.get()};
+  while (!nodes.empty()) {
+    auto node = nodes.back();
+    nodes.pop_back();
+    if (node->children_.empty()) {
+      auto cell_size = array_schema->cell_size(node->field_name_);
+      if (node->condition_value_.size() != cell_size)
+        return LOG_STATUS(Status::QueryConditionError(
+            "Invalid query condition; The value compared with attribute '" +
+            node->field_name_ + "' does not match the attribute size"));
+    }
+    for (const auto& child : node->children_)
+      nodes.push_back(child.get());
+  }
+
+  return Status::Ok();
+}
+
+Status QueryCondition::combine(
+    const QueryCondition& rhs,
+    QueryConditionCombinationOp combination_op,
+    QueryCondition* combined_cond) const {
+  if (tree_ == nullptr || rhs.tree_ == nullptr)
+    return LOG_STATUS(Status::QueryConditionError(
+        "Cannot combine query conditions; Both conditions must be "
+        "initialized"));
+
+  auto node = std::make_shared<Node>();
+  node->combination_op_ = combination_op;
+  node->children_.push_back(tree_);
+  node->children_.push_back(rhs.tree_);
+  combined_cond->tree_ = node;
+  combined_cond->field_names_ = field_names_;
+  combined_cond->field_names_.insert(
+      rhs.field_names_.begin(), rhs.field_names_.end());
+
+  return Status::Ok();
+}
+
+bool QueryCondition::empty() const {
+  return tree_ == nullptr;
+}
+
+const std::unordered_set<std::string>& QueryCondition::field_names() const {
+  return field_names_;
+}
+
+Status QueryCondition::may_match(
+    const ArraySchema* array_schema,
+    const MinMaxFunc& min_max,
+    bool* match,
+    const IndexFunc& index) const {
+  *match = true;
+  if (tree_ == nullptr)
+    return Status::Ok();
+
+  return may_match(array_schema, *tree_, min_max, index, match);
+}
+
+Status QueryCondition::apply(
+    const ArraySchema* array_schema,
+    uint64_t stride,
+    std::vector<ResultCellSlab>* result_cell_slabs) const {
+  if (tree_ == nullptr)
+    return Status::Ok();
+
+  // Split each slab into the runs of cells that satisfy the condition
+  auto num_cs = result_cell_slabs->size();
+  std::vector<std::vector<ResultCellSlab>> filtered(num_cs);
+  auto statuses = parallel_for(0, num_cs, [&](uint64_t i) {
+    const auto& cs = (*result_cell_slabs)[i];
+    std::vector<uint8_t> result;
+    RETURN_NOT_OK(evaluate(array_schema, *tree_, stride, cs, &result));
+
+    auto step = (stride == UINT64_MAX) ? 1 : stride;
+    uint64_t c = 0;
+    while (c < cs.length_) {
+      if (result[c] == 0) {
+        ++c;
+        continue;
+      }
+      auto run_start = c;
+      while (c < cs.length_ && result[c] != 0)
+        ++c;
+      filtered[i].emplace_back(
+          cs.tile_, cs.start_ + run_start * step, c - run_start);
+    }
+
+    return Status::Ok();
+  });
+  for (const auto& st : statuses)
+    RETURN_NOT_OK(st);
+
+  result_cell_slabs->clear();
+  for (auto& slabs : filtered) {
+    for (auto& cs : slabs)
+      result_cell_slabs->emplace_back(std::move(cs));
+  }
+
+  return Status::Ok();
+}
+
+/* ****************************** */
+/*          PRIVATE METHODS       */
+/* ****************************** */
+
+Status QueryCondition::evaluate(
+    const ArraySchema* array_schema,
+    const Node& node,
+    uint64_t stride,
+    const ResultCellSlab& cs,
+    std::vector<uint8_t>* result) const {
+  // Combination
+  if (!node.children_.empty()) {
+    RETURN_NOT_OK(
+        evaluate(array_schema, *node.children_[0], stride, cs, result));
+    std::vector<uint8_t> child_result;
+    for (size_t i = 1; i < node.children_.size(); ++i) {
+      RETURN_NOT_OK(evaluate(
+          array_schema, *node.children_[i], stride, cs, &child_result));
+      if (node.combination_op_ == QueryConditionCombinationOp::AND) {
+        for (uint64_t c = 0; c < cs.length_; ++c)
+          (*result)[c] &= child_result[c];
+      } else {
+        for (uint64_t c = 0; c < cs.length_; ++c)
+          (*result)[c] |= child_result[c];
+      }
+    }
+    return Status::Ok();
+  }
+
+  // Comparison, on the tile values or on the fill value of empty slabs
+  auto type = array_schema->type(node.field_name_);
+  const void* values;
+  uint64_t start, step;
+  if (cs.tile_ == nullptr) {
+    values = constants::fill_value(type);
+    start = 0;
+    step = 0;
+  } else {
+    auto tile_pair = cs.tile_->tile_pair(node.field_name_);
+    if (tile_pair == nullptr || tile_pair->first.empty())
+      return LOG_STATUS(Status::QueryConditionError(
+          "Cannot apply query condition; Tile of attribute '" +
+          node.field_name_ + "' is not loaded"));
+    values = tile_pair->first.internal_data();
+    start = cs.start_;
+    step = (stride == UINT64_MAX) ? 1 : stride;
+  }
+  assert(values != nullptr);
+
+  result->resize(cs.length_);
+  switch (type) {
+    case Datatype::CHAR:
+      compare<char>(node, (const char*)values, start, step, result);
+      break;
+    case Datatype::INT8:
+      compare<int8_t>(node, (const int8_t*)values, start, step, result);
+      break;
+    case Datatype::UINT8:
+      compare<uint8_t>(node, (const uint8_t*)values, start, step, result);
+      break;
+    case Datatype::INT16:
+      compare<int16_t>(node, (const int16_t*)values, start, step, result);
+      break;
+    case Datatype::UINT16:
+      compare<uint16_t>(node, (const uint16_t*)values, start, step, result);
+      break;
+    case Datatype::INT32:
+      compare<int32_t>(node, (const int32_t*)values, start, step, result);
+      break;
+    case Datatype::UINT32:
+      compare<uint32_t>(node, (const uint32_t*)values, start, step, result);
+      break;
+    case Datatype::UINT64:
+      compare<uint64_t>(node, (const uint64_t*)values, start, step, result);
+      break;
+    case Datatype::FLOAT32:
+      compare<float>(node, (const float*)values, start, step, result);
+      break;
+    case Datatype::FLOAT64:
+      compare<double>(node, (const double*)values, start, step, result);
+      break;
+    case Datatype::INT64:
+    case Datatype::DATETIME_YEAR:
+    case Datatype::DATETIME_MONTH:
+    case Datatype::DATETIME_WEEK:
+    case Datatype::DATETIME_DAY:
+    case Datatype::DATETIME_HR:
+    case Datatype::DATETIME_MIN:
+    case Datatype::DATETIME_SEC:
+    case Datatype::DATETIME_MS:
+    case Datatype::DATETIME_US:
+    case Datatype::DATETIME_NS:
+    case Datatype::DATETIME_PS:
+    case Datatype::DATETIME_FS:
+    case Datatype::DATETIME_AS:
+      compare<int64_t>(node, (const int64_t*)values, start, step, result);
+      break;
+    default:
+      return LOG_STATUS(Status::QueryConditionError(
+          "Cannot apply query condition; Unsupported attribute type"));
+  }
+
+  return Status::Ok();
+}
+
+Status QueryCondition::may_match(
+    const ArraySchema* array_schema,
+    const Node& node,
+    const MinMaxFunc& min_max,
+    const IndexFunc& index,
+    bool* match) const {
+  // Combination, stopping at the first child that decides the result
+  if (!node.children_.empty()) {
+    bool is_and = node.combination_op_ == QueryConditionCombinationOp::AND;
+    *match = is_and;
+    for (const auto& child : node.children_) {
+      bool child_match = true;
+      RETURN_NOT_OK(
+          may_match(array_schema, *child, min_max, index, &child_match));
+      if (child_match != is_and) {
+        *match = child_match;
+        break;
+      }
+    }
+    return Status::Ok();
+  }
+
+  // Comparison
+  *match = true;
+  const void* min = nullptr;
+  const void* max = nullptr;
+  RETURN_NOT_OK(min_max(node.field_name_, &min, &max));
+  if (min != nullptr && max != nullptr) {
+    switch (array_schema->type(node.field_name_)) {
+      case Datatype::INT8:
+        *match = range_may_match<int8_t>(node, min, max);
+        break;
+      case Datatype::UINT8:
+        *match = range_may_match<uint8_t>(node, min, max);
+        break;
+      case Datatype::INT16:
+        *match = range_may_match<int16_t>(node, min, max);
+        break;
+      case Datatype::UINT16:
+        *match = range_may_match<uint16_t>(node, min, max);
+        break;
+      case Datatype::INT32:
+        *match = range_may_match<int32_t>(node, min, max);
+        break;
+      case Datatype::UINT32:
+        *match = range_may_match<uint32_t>(node, min, max);
+        break;
+      case Datatype::UINT64:
+        *match = range_may_match<uint64_t>(node, min, max);
+        break;
+      case Datatype::FLOAT32:
+        *match = range_may_match<float>(node, min, max);
+        break;
+      case Datatype::FLOAT64:
+        *match = range_may_match<double>(node, min, max);
+        break;
+      case Datatype::INT64:
+      case Datatype::DATETIME_YEAR:
+      case Datatype::DATETIME_MONTH:
+      case Datatype::DATETIME_WEEK:
+      case Datatype::DATETIME_DAY:
+      case Datatype::DATETIME_HR:
+      case Datatype::DATETIME_MIN:
+      case Datatype::DATETIME_SEC:
+      case Datatype::DATETIME_MS:
+      case Datatype::DATETIME_US:
+      case Datatype::DATETIME_NS:
+      case Datatype::DATETIME_PS:
+      case Datatype::DATETIME_FS:
+      case Datatype::DATETIME_AS:
+        *match = range_may_match<int64_t>(node, min, max);
+        break;
+      default:
+        break;
+    }
+  }
+
+  // The value index of the attribute tells whether the tile has a cell
+  // satisfying the comparison
+  if (*match && index != nullptr)
+    RETURN_NOT_OK(index(
+        node.field_name_, node.op_, &node.condition_value_[0], match));
+
+  return Status::Ok();
+}
+
+template <class T>
+bool QueryCondition::range_may_match(
+    const Node& node, const void* min, const void* max) const {
+  T value, range_min, range_max;
+  std::memcpy(&value, &node.condition_value_[0], sizeof(T));
+  std::memcpy(&range_min, min, sizeof(T));
+  std::memcpy(&range_max, max, sizeof(T));
+
+  if (std::is_floating_point<T>::value &&
+      (std::isnan(static_cast<double>(range_min)) ||
+       std::isnan(static_cast<double>(range_max))))
+    return true;
+
+  switch (node.op_) {
+    case QueryConditionOp::LT:
+      return range_min < value;
+    case QueryConditionOp::LE:
+      return range_min <= value;
+    case QueryConditionOp::GT:
+      return range_max > value;
+    case QueryConditionOp::GE:
+      return range_max >= value;
+    case QueryConditionOp::EQ:
+      return range_min <= value && value <= range_max;
+    case QueryConditionOp::NE:
+      return !(range_min == value && range_max == value);
+  }
+
+  return true;
+}
+
+template <class T>
+void QueryCondition::compare(
+    const Node& node,
+    const T* values,
+    uint64_t start,
+    uint64_t step,
+    std::vector<uint8_t>* result) const {
+  T value;
+  std::memcpy(&value, &node.condition_value_[0], sizeof(T));
+  auto num = result->size();
+  auto& res = *result;
+
+  switch (node.op_) {
+    case QueryConditionOp::LT:
+      for (uint64_t c = 0; c < num; ++c)
+        res[c] = values[start + c * step] < value;
+      break;
+    case QueryConditionOp::LE:
+      for (uint64_t c = 0; c < num; ++c)
+        res[c] = values[start + c * step] <= value;
+      break;
+    case QueryConditionOp::GT:
+      for (uint64_t c = 0; c < num; ++c)
+        res[c] = values[start + c * step] > value;
+      break;
+    case QueryConditionOp::GE:
+      for (uint64_t c = 0; c < num; ++c)
+        res[c] = values[start + c * step] >= value;
+      break;
+    case QueryConditionOp::EQ:
+      for (uint64_t c = 0; c < num; ++c)
+        res[c] = values[start + c * step] == value;
+      break;
+    case QueryConditionOp::NE:
+      for (uint64_t c = 0; c < num; ++c)
+        res[c] = values[start + c * step] != value;
+      break;
+  }
+}
+
+}  // namespace sm
+}  // namespace tiledb
@@ -0,0 +1,290 @@
+/**
+ * @file   query_condition.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines class QueryCondition.
+ */
+
+#ifndef TILEDB_QUERY_CONDITION_H
+#define TILEDB_QUERY_CONDITION_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "tiledb/sm/enums/query_condition_combination_op.h"
+#include "tiledb/sm/enums/query_condition_op.h"
+#include "tiledb/sm/misc/status.h"
+#include "tiledb/sm/query/result_cell_slab.h"
+
+namespace tiledb {
+namespace sm {
+
+class ArraySchema;
+
+/**
+ * A condition on the values of fixed-size attributes, which a read query
+ * evaluates on the result cells before copying them to the user buffers.
+ * A condition is either a single comparison of an attribute with a value,
+ * or the logical combination of other conditions. Conditions are immutable
+ * once initialized and share their sub-conditions when combined.
+ */
+class QueryCondition {
+ public:
+  /* ********************************* */
+  /*          TYPE DEFINITIONS         */
+  /* ********************************* */
+
+  /**
+   * Retrieves the minimum and maximum values of an attribute in a tile,
+   * setting them to `nullptr` if they are unknown.
+   */
+  typedef std::function<Status(
+      const std::string& name, const void** min, const void** max)>
+      MinMaxFunc;
+
+  /**
+   * Checks through a value index whether any cell of a tile satisfies the
+   * comparison of an attribute with a value, setting `match` to `false`
+   * if none does and leaving it unchanged if the attribute is not indexed.
+   */
+  typedef std::function<Status(
+      const std::string& name,
+      QueryConditionOp op,
+      const void* value,
+      bool* match)>
+      IndexFunc;
+
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /** Constructor. The condition is empty until initialized. */
+  QueryCondition() = default;
+
+  /** Destructor. */
+  ~QueryCondition() = default;
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /**
+   * Initializes the instance as the comparison of an attribute with a
+   * value.
+   *
+   * @param attribute_name The name of the compared attribute.
+   * @param condition_value The value the attribute is compared with.
+   * @param condition_value_size The size of the value in bytes.
+   * @param op The comparison operator.
+   * @return Status
+   */
+  Status init(
+      const std::string& attribute_name,
+      const void* condition_value,
+      uint64_t condition_value_size,
+      QueryConditionOp op);
+
+  /**
+   * Checks that the condition applies to the input array schema, i.e.,
+   * that every compared attribute exists, is fixed-sized with a single
+   * numeric value per cell, and is compared with a value of its size.
+   *
+   * @param array_schema The array schema.
+   * @return Status
+   */
+  Status check(const ArraySchema* array_schema) const;
+
+  /**
+   * Combines the instance with the input condition.
+   *
+   * @param rhs The condition to combine the instance with.
+   * @param combination_op The logical operator combining the conditions.
+   * @param combined_cond Set to the combined condition.
+   * @return Status
+   */
+  Status combine(
+      const QueryCondition& rhs,
+      QueryConditionCombinationOp combination_op,
+      QueryCondition* combined_cond) const;
+
+  /** Returns `true` if the condition is not initialized. */
+  bool empty() const;
+
+  /**
+   * Checks whether any cell of a tile may satisfy the condition, given
+   * the minimum and maximum values of the compared attributes in the tile
+   * and, optionally, the value indexes of the fragment of the tile.
+   * Comparisons on attributes with unknown value ranges and no index may
+   * always match.
+   *
+   * @param array_schema The array schema.
+   * @param min_max Retrieves the value range of an attribute in the tile.
+   * @param match Set to `false` if no cell of the tile satisfies the
+   *     condition.
+   * @param index If set, checks the comparisons through the value
+   *     indexes of the attributes.
+   * @return Status
+   */
+  Status may_match(
+      const ArraySchema* array_schema,
+      const MinMaxFunc& min_max,
+      bool* match,
+      const IndexFunc& index = nullptr) const;
+
+  /** Returns the names of the attributes the condition compares. */
+  const std::unordered_set<std::string>& field_names() const;
+
+  /**
+   * Removes from the input result cell slabs the cells that do not
+   * satisfy the condition, splitting the slabs where needed. The tiles
+   * of all the attributes in `field_names()` must be loaded and
+   * unfiltered in the result tiles of the slabs. Empty slabs (without a
+   * tile) are compared using the fill values of the attributes.
+   *
+   * @param array_schema The array schema.
+   * @param stride The distance between consecutive cells of a slab in
+   *     its tile, or `UINT64_MAX` if the cells are contiguous.
+   * @param result_cell_slabs The result cell slabs to filter.
+   * @return Status
+   */
+  Status apply(
+      const ArraySchema* array_schema,
+      uint64_t stride,
+      std::vector<ResultCellSlab>* result_cell_slabs) const;
+
+ private:
+  /* ********************************* */
+  /*          PRIVATE DATATYPES        */
+  /* ********************************* */
+
+  /** A node of the condition tree. */
+  struct Node {
+    /** The compared attribute, if the node is a comparison. */
+    std::string field_name_;
+    /** The value the attribute is compared with. */
+    std::vector<uint8_t> condition_value_;
+    /** The comparison operator. */
+    QueryConditionOp op_;
+    /** The combined conditions, if the node is a combination. */
+    std::vector<std::shared_ptr<const Node>> children_;
+    /** The logical operator combining the children. */
+    QueryConditionCombinationOp combination_op_;
+  };
+
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The root of the condition tree, `nullptr` if empty. */
+  std::shared_ptr<const Node> tree_;
+
+  /** The names of the attributes the condition compares. */
+  std::unordered_set<std::string> field_names_;
+
+  /* ********************************* */
+  /*           PRIVATE METHODS         */
+  /* ********************************* */
+
+  /**
+   * Evaluates a node of the condition tree on the cells of a result cell
+   * slab.
+   *
+   * @param array_schema The array schema.
+   * @param node The node to evaluate.
+   * @param stride The stride of the cells in the tile of the slab.
+   * @param cs The result cell slab.
+   * @param result Set to `1` for each cell satisfying the node and to `0`
+   *     otherwise.
+   * @return Status
+   */
+  Status evaluate(
+      const ArraySchema* array_schema,
+      const Node& node,
+      uint64_t stride,
+      const ResultCellSlab& cs,
+      std::vector<uint8_t>* result) const;
+
+  /**
+   * Checks whether any cell of a tile may satisfy a node of the condition
+   * tree (see the public `may_match`).
+   *
+   * @param array_schema The array schema.
+   * @param node The node to check.
+   * @param min_max Retrieves the value range of an attribute in the tile.
+   * @param index Checks a comparison through a value index, if set.
+   * @param match Set to `false` if no cell of the tile satisfies the node.
+   * @return Status
+   */
+  Status may_match(
+      const ArraySchema* array_schema,
+      const Node& node,
+      const MinMaxFunc& min_max,
+      const IndexFunc& index,
+      bool* match) const;
+
+  /**
+   * Returns `false` if no value in the input range satisfies a comparison
+   * node. A range with NaN bounds may always match.
+   *
+   * @tparam T The attribute type.
+   * @param node The comparison node.
+   * @param min The minimum value of the range.
+   * @param max The maximum value of the range.
+   */
+  template <class T>
+  bool range_may_match(const Node& node, const void* min, const void* max)
+      const;
+
+  /**
+   * Compares the cells of a result cell slab with the value of a
+   * comparison node.
+   *
+   * @tparam T The attribute type.
+   * @param node The comparison node.
+   * @param values The attribute values of the tile of the slab, or the
+   *     fill value if the slab has no tile.
+   * @param start The position of the first cell in `values`.
+   * @param step The distance between consecutive cells in `values`.
+   * @param result The comparison result for each cell of the slab.
+   */
+  template <class T>
+  void compare(
+      const Node& node,
+      const T* values,
+      uint64_t start,
+      uint64_t step,
+      std::vector<uint8_t>* result) const;
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_QUERY_CONDITION_H
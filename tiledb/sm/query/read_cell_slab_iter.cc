@@ -38,7 +38,6 @@
 
 #include <cassert>
 #include <iostream>
-#include <list>
 
 namespace tiledb {
 namespace sm {
@@ -61,6 +60,13 @@ ReadCellSlabIter<T>::ReadCellSlabIter(
                 subarray->array()->array_schema()->domain() :
                 nullptr;
   layout_ = (subarray != nullptr) ? subarray->layout() : Layout::ROW_MAJOR;
+  dim_num_ = (domain_ != nullptr) ? domain_->dim_num() : 0;
+  slab_dim_ =
+      (layout_ == Layout::ROW_MAJOR && dim_num_ > 0) ? dim_num_ - 1 : 0;
+  subarray_ = subarray;
+  result_space_tile_ = nullptr;
+  result_space_tile_coords_ = nullptr;
+  tile_sparse_cells_ = nullptr;
   cell_slab_iter_ = CellSlabIter<T>(subarray);
   end_ = true;
   compute_cell_offsets();
@@ -75,6 +81,8 @@ Status ReadCellSlabIter<T>::begin() {
   end_ = true;
   RETURN_NOT_OK(cell_slab_iter_.begin());
   result_coords_pos_ = init_result_coords_pos_;
+  result_space_tile_ = nullptr;
+  compute_sparse_cells();
   update_result_cell_slab();
 
   return Status::Ok();
@@ -148,11 +156,12 @@ void ReadCellSlabIter<T>::compute_cell_offsets_row() {
 }
 
 template <class T>
+template <unsigned N>
 void ReadCellSlabIter<T>::compute_cell_slab_start(
     const T* cell_slab_coords,
     const std::vector<T>& tile_start_coords,
-    uint64_t* start) {
-  auto dim_num = domain_->dim_num();
+    uint64_t* start) const {
+  const unsigned dim_num = (N != 0) ? N : dim_num_;
 
   // Compute start
   *start = 0;
@@ -161,252 +170,236 @@ void ReadCellSlabIter<T>::compute_cell_slab_start(
 }
 
 template <class T>
-void ReadCellSlabIter<T>::compute_cell_slab_overlap(
-    const CellSlab<T>& cell_slab,
-    const T* frag_domain,
-    std::vector<T>* slab_overlap,
-    uint64_t* overlap_length,
-    unsigned* overlap_type) {
-  auto dim_num = domain_->dim_num();
-  assert(slab_overlap->size() == dim_num);
-  unsigned slab_dim = (layout_ == Layout::ROW_MAJOR) ? dim_num - 1 : 0;
-  T slab_end, slab_start;
-  slab_start = cell_slab.coords_[slab_dim];
-  slab_end = slab_start + cell_slab.length_ - 1;
-
-  // Check if there is any overlap
-  for (unsigned i = 0; i < dim_num; ++i) {
-    if (i == slab_dim) {
-      if (slab_end < frag_domain[2 * i] ||
-          slab_start > frag_domain[2 * i + 1]) {
-        *overlap_type = 0;
-        *overlap_length = 0;
-        return;
-      }
-    } else if (
-        cell_slab.coords_[i] < frag_domain[2 * i] ||
-        cell_slab.coords_[i] > frag_domain[2 * i + 1]) {
-      *overlap_type = 0;
-      *overlap_length = 0;
-      return;
-    }
-  }
-
-  // There is some overlap
-  T overlap_start = std::max(slab_start, frag_domain[2 * slab_dim]);
-  T overlap_end = std::min(slab_end, frag_domain[2 * slab_dim + 1]);
-  *slab_overlap = cell_slab.coords_;
-  (*slab_overlap)[slab_dim] = overlap_start;
-  *overlap_length = overlap_end - overlap_start + 1;
-  *overlap_type = (*overlap_length == cell_slab.length_) ? 1 : 2;
-}
-
-template <class T>
+template <unsigned N>
 void ReadCellSlabIter<T>::compute_result_cell_slabs(
     const CellSlab<T>& cell_slab) {
-  // Find the result space tile
-  auto it = result_space_tiles_->find(cell_slab.tile_coords_);
-  assert(it != result_space_tiles_->end());
-  auto& result_space_tile = it->second;
-
-  // Note: this functions assumes that `result_coords_` are certain
-  // results (i.e., appropriate filtering has already taken place).
-  // Only the valid result coordinates are considered (non-valid
-  // coordinates are the filtered ones).
+  // Find the result space tile and its sparse cells, unless the previous
+  // cell slab belonged to the same tile
+  if (result_space_tile_ == nullptr ||
+      cell_slab.tile_coords_ != result_space_tile_coords_) {
+    auto it = result_space_tiles_->find(cell_slab.tile_coords_);
+    assert(it != result_space_tiles_->end());
+    result_space_tile_ = &(it->second);
+    result_space_tile_coords_ = cell_slab.tile_coords_;
+    auto sit = sparse_cells_.find(cell_slab.tile_coords_);
+    tile_sparse_cells_ =
+        (sit != sparse_cells_.end()) ? &(sit->second) : nullptr;
+  }
 
-  auto dim_num = domain_->dim_num();
-  unsigned slab_dim = (layout_ == Layout::ROW_MAJOR) ? dim_num - 1 : 0;
-  CellSlab<T> cell_slab_copy = cell_slab;
-  auto slab_start = cell_slab_copy.coords_[slab_dim];
-  auto slab_end = (T)(slab_start + cell_slab.length_ - 1);
-  bool must_break = false;
+  const T* slab_coords = &cell_slab.coords_[0];
+  auto slab_start = slab_coords[slab_dim_];
+  auto slab_length = cell_slab.length_;
 
-  size_t i;
-  for (; result_coords_pos_ < result_coords_->size(); ++result_coords_pos_) {
-    // For easy reference
-    i = result_coords_pos_;
+  // No sparse cells overwrite the tile
+  if (tile_sparse_cells_ == nullptr) {
+    compute_result_cell_slabs_dense<N>(
+        slab_coords, slab_start, slab_length, result_space_tile_);
+    return;
+  }
 
-    // Ignore if the result coordinates are invalid
-    if (!(*result_coords_)[i].valid_)
+  // Visit the sparse cells whose positions in the tile fall in the cell
+  // slab, which consists of `slab_length` cells `cell_offset` positions
+  // apart, and fill the gaps between them from the dense fragments
+  uint64_t slab_pos;
+  compute_cell_slab_start<N>(
+      slab_coords, result_space_tile_->start_coords_, &slab_pos);
+  const uint64_t cell_offset = cell_offsets_[slab_dim_];
+  const uint64_t slab_last_pos = slab_pos + (slab_length - 1) * cell_offset;
+  const auto& cells = *tile_sparse_cells_;
+  auto cit = std::lower_bound(
+      cells.begin(), cells.end(), std::pair<uint64_t, size_t>(slab_pos, 0));
+  uint64_t next = 0;
+  for (; cit != cells.end() && cit->first <= slab_last_pos; ++cit) {
+    auto diff = cit->first - slab_pos;
+    auto i = diff / cell_offset;
+    if (diff % cell_offset != 0 || i < next)
       continue;
 
-    // Check overlap
-    for (unsigned d = 0; d < dim_num; ++d) {
-      auto result_coord = *(const T*)(*result_coords_)[i].coord(d);
-      if (d != slab_dim) {
-        // No overlap
-        if (result_coord != cell_slab_copy.coords_[d]) {
-          must_break = true;
-          break;
-        }
-      } else if (result_coord < slab_start || result_coord > slab_end) {
-        must_break = true;
-        break;
-      }
-    }
-
-    if (must_break)
-      break;
-
     // Add left slab
-    auto result_coord = *(const T*)(*result_coords_)[i].coord(slab_dim);
-    if (result_coord > slab_start) {
-      cell_slab_copy.length_ = result_coord - cell_slab_copy.coords_[slab_dim];
-      compute_result_cell_slabs_dense(cell_slab_copy, &result_space_tile);
-    }
+    if (i > next)
+      compute_result_cell_slabs_dense<N>(
+          slab_coords, (T)(slab_start + next), i - next, result_space_tile_);
 
     // Add result
-    result_cell_slabs_.emplace_back(
-        (*result_coords_)[i].tile_, (*result_coords_)[i].pos_, 1);
-
-    // Update cell slab copy
-    cell_slab_copy.coords_[slab_dim] = result_coord + 1;
-    cell_slab_copy.length_ = slab_end - cell_slab_copy.coords_[slab_dim] + 1;
-    slab_start = cell_slab_copy.coords_[slab_dim];
-    slab_end = (T)(slab_start + cell_slab_copy.length_ - 1);
+    const auto& result_coords = (*result_coords_)[cit->second];
+    result_cell_slabs_.emplace_back(result_coords.tile_, result_coords.pos_, 1);
+    next = i + 1;
   }
 
   // Add remaining slab
-  auto cell_slab_end = (T)(cell_slab.coords_[slab_dim] + cell_slab.length_ - 1);
-  if (slab_start <= cell_slab_end) {
-    cell_slab_copy.length_ = slab_end - slab_start + 1;
-    compute_result_cell_slabs_dense(cell_slab_copy, &result_space_tile);
-  }
+  if (next < slab_length)
+    compute_result_cell_slabs_dense<N>(
+        slab_coords,
+        (T)(slab_start + next),
+        slab_length - next,
+        result_space_tile_);
 }
 
 template <class T>
+template <unsigned N>
 void ReadCellSlabIter<T>::compute_result_cell_slabs_dense(
-    const CellSlab<T>& cell_slab, ResultSpaceTile<T>* result_space_tile) {
-  std::list<CellSlab<T>> to_process;
-  to_process.push_back(cell_slab);
+    const T* slab_coords,
+    T slab_start,
+    uint64_t slab_length,
+    ResultSpaceTile<T>* result_space_tile) {
   const auto& frag_domains = result_space_tile->frag_domains_;
   auto& result_tiles = result_space_tile->result_tiles_;
-  auto dim_num = domain_->dim_num();
-  std::vector<T> slab_overlap;
-  slab_overlap.resize(dim_num);
-  unsigned overlap_type;  // 0: no overlap, 1: full overlap, 2: partial overlap
-  uint64_t overlap_length, start;
-  CellSlab<T> p1, p2;
-  bool two_slabs;
-  std::vector<ResultCellSlab> result_cell_slabs;
-
-  // Process all slabs in the `to_process` list for each fragment
+
+  // The slab parts left to process differ from the cell slab only along
+  // the slab dimension, so their cell positions in the tile are derived
+  // from that of the cell slab start
+  uint64_t slab_pos;
+  compute_cell_slab_start<N>(
+      slab_coords, result_space_tile->start_coords_, &slab_pos);
+  const auto slab_coord = slab_coords[slab_dim_];
+  const uint64_t cell_offset = cell_offsets_[slab_dim_];
+
+  // No fragment overlaps the space tile, so the whole slab is empty
+  if (frag_domains.empty()) {
+    result_cell_slabs_.emplace_back(
+        nullptr,
+        slab_pos + (uint64_t)(slab_start - slab_coord) * cell_offset,
+        slab_length);
+    return;
+  }
+
+  to_process_.clear();
+  to_process_.emplace_back(slab_start, slab_length);
+  aux_result_cell_slabs_.clear();
+
+  // Process all slab parts in `to_process_` for each fragment
   // in the result space tile
   for (const auto& fd : frag_domains) {
-    for (auto pit = to_process.begin(); pit != to_process.end();) {
-      compute_cell_slab_overlap(
-          *pit, fd.second, &slab_overlap, &overlap_length, &overlap_type);
+    if (to_process_.empty())
+      break;
+
+    if (!slab_in_frag_domain<N>(slab_coords, fd.second))
+      continue;
+
+    auto frag_start = fd.second[2 * slab_dim_];
+    auto frag_end = fd.second[2 * slab_dim_ + 1];
+    ResultTile* result_tile = nullptr;
+    for (size_t p = 0; p < to_process_.size();) {
+      auto start = to_process_[p].first;
+      auto end = (T)(start + to_process_[p].second - 1);
 
       // No overlap
-      if (overlap_type == 0) {
-        ++pit;
+      if (end < frag_start || start > frag_end) {
+        ++p;
         continue;
       }
 
       // Compute new result cell slab
-      compute_cell_slab_start(
-          &slab_overlap[0], result_space_tile->start_coords_, &start);
-      auto tit = result_tiles.find(fd.first);
-      assert(tit != result_tiles.end());
-      result_cell_slabs.emplace_back(&(tit->second), start, overlap_length);
-
-      // If it is partial overlap, we need to create up to two new cell slabs
-      // and re-insert to the head of `to_process` (so that the rest of the
-      // fragments can process them).
-      if (overlap_type == 2) {
-        split_cell_slab(
-            *pit, slab_overlap, overlap_length, &p1, &p2, &two_slabs);
-        to_process.push_front(p1);
-        if (two_slabs)
-          to_process.push_front(p2);
+      auto overlap_start = std::max(start, frag_start);
+      auto overlap_end = std::min(end, frag_end);
+      if (result_tile == nullptr) {
+        auto tit = result_tiles.find(fd.first);
+        assert(tit != result_tiles.end());
+        result_tile = &(tit->second);
+      }
+      aux_result_cell_slabs_.emplace_back(
+          result_tile,
+          slab_pos + (uint64_t)(overlap_start - slab_coord) * cell_offset,
+          (uint64_t)(overlap_end - overlap_start) + 1);
+
+      // Replace the processed part with what is left of it on either side
+      // of the overlap, so that the rest of the fragments can process it
+      bool left = overlap_start > start;
+      bool right = overlap_end < end;
+      auto right_part = std::pair<T, uint64_t>(
+          (T)(overlap_end + 1), (uint64_t)(end - overlap_end));
+      if (left) {
+        to_process_[p].second = (uint64_t)(overlap_start - start);
+        if (right)
+          to_process_.push_back(right_part);
+        ++p;
+      } else if (right) {
+        to_process_[p] = right_part;
+        ++p;
+      } else {
+        to_process_[p] = to_process_.back();
+        to_process_.pop_back();
       }
-
-      // Erase the processed slab
-      pit = to_process.erase(pit);
     }
   }
 
-  // Append temporary results for empty cell slabs
-  compute_result_cell_slabs_empty(
-      *result_space_tile, to_process, &result_cell_slabs);
+  // Append result cell slabs for the parts that belong to no fragment
+  for (const auto& part : to_process_)
+    aux_result_cell_slabs_.emplace_back(
+        nullptr,
+        slab_pos + (uint64_t)(part.first - slab_coord) * cell_offset,
+        part.second);
 
   // Sort the temporary result cell slabs on starting position
-  std::sort(result_cell_slabs.begin(), result_cell_slabs.end());
+  std::sort(aux_result_cell_slabs_.begin(), aux_result_cell_slabs_.end());
 
   // Insert the temporary results to `result_cell_slabs_`
   result_cell_slabs_.insert(
       result_cell_slabs_.end(),
-      result_cell_slabs.begin(),
-      result_cell_slabs.end());
+      aux_result_cell_slabs_.begin(),
+      aux_result_cell_slabs_.end());
 }
 
 template <class T>
-void ReadCellSlabIter<T>::compute_result_cell_slabs_empty(
-    const ResultSpaceTile<T>& result_space_tile,
-    const std::list<CellSlab<T>>& to_process,
-    std::vector<ResultCellSlab>* result_cell_slabs) {
-  // Nothing to process
-  if (to_process.empty())
+void ReadCellSlabIter<T>::compute_sparse_cells() {
+  sparse_cells_.clear();
+  if (subarray_ == nullptr || result_coords_ == nullptr)
     return;
 
-  // Create result cell slabs that belong to no fragment
-  uint64_t start;
-  for (auto pit = to_process.begin(); pit != to_process.end(); ++pit) {
-    compute_cell_slab_start(
-        &pit->coords_[0], result_space_tile.start_coords_, &start);
-    result_cell_slabs->emplace_back(nullptr, start, pit->length_);
-  }
-}
+  // For easy reference
+  auto array_domain = (const T*)domain_->domain();
+  auto tile_extents = (const T*)domain_->tile_extents();
+  auto coords_size = subarray_->array()->array_schema()->coords_size();
+  std::vector<T> coords(dim_num_);
+  std::vector<T> tile_coords(dim_num_);
+  std::vector<uint8_t> aux_tile_coords(coords_size);
 
-template <class T>
-void ReadCellSlabIter<T>::split_cell_slab(
-    const CellSlab<T>& cell_slab,
-    const std::vector<T>& slab_overlap,
-    uint64_t overlap_length,
-    CellSlab<T>* p1,
-    CellSlab<T>* p2,
-    bool* two_slabs) {
-  auto dim_num = domain_->dim_num();
-  auto slab_dim = (layout_ == Layout::ROW_MAJOR) ? dim_num - 1 : 0;
-  auto slab_start = cell_slab.coords_[slab_dim];
-  auto slab_end = slab_start + cell_slab.length_ - 1;
-  auto overlap_start = slab_overlap[slab_dim];
-  auto overlap_end = overlap_start + overlap_length - 1;
-
-  // Two slabs
-  if (overlap_start > slab_start && overlap_end < slab_end) {
-    // Create left
-    *p1 = cell_slab;
-    p1->length_ = overlap_start - slab_start;
-
-    // Create right
-    *p2 = cell_slab;
-    p2->coords_[slab_dim] = overlap_end + 1;
-    p2->length_ = cell_slab.length_ - overlap_length - p1->length_;
-
-    *two_slabs = true;
-    return;
-  }
+  // Note: this function assumes that `result_coords_` are certain
+  // results (i.e., appropriate filtering has already taken place).
+  // Only the valid result coordinates are considered (non-valid
+  // coordinates are the filtered ones). The coordinates are consumed
+  // up to the first one that falls outside the tiles of the subarray.
+  for (; result_coords_pos_ < result_coords_->size(); ++result_coords_pos_) {
+    const auto& result_coords = (*result_coords_)[result_coords_pos_];
+    if (!result_coords.valid_)
+      continue;
 
-  *two_slabs = false;
+    // Find the space tile of the coordinates
+    for (unsigned d = 0; d < dim_num_; ++d) {
+      coords[d] = *(const T*)result_coords.coord(d);
+      tile_coords[d] = (coords[d] - array_domain[2 * d]) / tile_extents[d];
+    }
+    auto tile_coords_ptr =
+        subarray_->tile_coords_ptr(tile_coords, &aux_tile_coords);
+    if (tile_coords_ptr == nullptr)
+      break;
+    auto it = result_space_tiles_->find(tile_coords_ptr);
+    if (it == result_space_tiles_->end())
+      break;
 
-  // Create only left
-  if (overlap_start > slab_start) {
-    *p1 = cell_slab;
-    p1->length_ = overlap_start - slab_start;
-    return;
+    // Record the position of the cell in the tile
+    uint64_t pos;
+    compute_cell_slab_start<0>(&coords[0], it->second.start_coords_, &pos);
+    sparse_cells_[tile_coords_ptr].emplace_back(pos, result_coords_pos_);
   }
 
-  // Create only right
-  if (overlap_end < slab_end) {
-    *p1 = cell_slab;
-    p1->coords_[slab_dim] = overlap_end + 1;
-    p1->length_ = cell_slab.length_ - overlap_length;
-    return;
+  for (auto& tile_cells : sparse_cells_)
+    std::sort(tile_cells.second.begin(), tile_cells.second.end());
+}
+
+template <class T>
+template <unsigned N>
+bool ReadCellSlabIter<T>::slab_in_frag_domain(
+    const T* slab_coords, const T* frag_domain) const {
+  const unsigned dim_num = (N != 0) ? N : dim_num_;
+
+  for (unsigned i = 0; i < dim_num; ++i) {
+    if (i != slab_dim_ && (slab_coords[i] < frag_domain[2 * i] ||
+                           slab_coords[i] > frag_domain[2 * i + 1]))
+      return false;
   }
 
-  // All the possible cases are covered above
-  assert(false);
+  return true;
 }
 
 template <class T>
@@ -419,9 +412,20 @@ void ReadCellSlabIter<T>::update_result_cell_slab() {
   end_ = false;
   result_cell_slabs_pos_ = 0;
   result_cell_slabs_.clear();
-  auto cell_slab = cell_slab_iter_.cell_slab();
+  const auto& cell_slab = cell_slab_iter_.cell_slab();
 
-  compute_result_cell_slabs(cell_slab);
+  // Use the fixed-rank versions for the common 2D and 3D cases
+  switch (dim_num_) {
+    case 2:
+      compute_result_cell_slabs<2>(cell_slab);
+      break;
+    case 3:
+      compute_result_cell_slabs<3>(cell_slab);
+      break;
+    default:
+      compute_result_cell_slabs<0>(cell_slab);
+      break;
+  }
 }
 
 // Explicit template instantiations
@@ -39,6 +39,8 @@
 #include "tiledb/sm/query/result_space_tile.h"
 #include "tiledb/sm/subarray/cell_slab_iter.h"
 
+#include <unordered_map>
+
 namespace tiledb {
 namespace sm {
 
@@ -132,6 +134,15 @@ class ReadCellSlabIter {
   /** `True` if the iterator has reached its end. */
   bool end_;
 
+  /** The number of dimensions. */
+  unsigned dim_num_;
+
+  /**
+   * The dimension the cell slabs extend along, i.e., the last one for
+   * row-major and the first one for col-major subarray layout.
+   */
+  unsigned slab_dim_;
+
   /**
    * Auxiliary cell offsets used for computing cell positions in a tile
    * given cell coordinates.
@@ -161,6 +172,40 @@ class ReadCellSlabIter {
    * */
   std::map<const T*, ResultSpaceTile<T>>* result_space_tiles_;
 
+  /** The subarray the iterator produces result cell slabs for. */
+  const Subarray* subarray_;
+
+  /**
+   * The sparse result coordinates per space tile (identified by the
+   * pointer to its tile coordinates), as pairs of the position of the
+   * cell in the tile and the index in `result_coords_`, sorted on the
+   * position. These cells overwrite the dense fragments.
+   */
+  std::unordered_map<const T*, std::vector<std::pair<uint64_t, size_t>>>
+      sparse_cells_;
+
+  /** The sparse cells of `result_space_tile_`, or `nullptr` if none. */
+  const std::vector<std::pair<uint64_t, size_t>>* tile_sparse_cells_;
+
+  /** The result space tile of the last processed cell slab. */
+  ResultSpaceTile<T>* result_space_tile_;
+
+  /** The tile coordinates of `result_space_tile_`. */
+  const T* result_space_tile_coords_;
+
+  /**
+   * The parts of the current cell slab still to be processed, as
+   * (start, length) pairs along the slab dimension. Kept as a member
+   * to avoid repeated allocations.
+   */
+  std::vector<std::pair<T, uint64_t>> to_process_;
+
+  /**
+   * Auxiliary result cell slabs, sorted before being appended to
+   * `result_cell_slabs_`. Kept as a member to avoid repeated allocations.
+   */
+  std::vector<ResultCellSlab> aux_result_cell_slabs_;
+
   /** The result sparse fragment coordinates. */
   std::vector<ResultCoords>* result_coords_;
 
@@ -203,87 +248,64 @@ class ReadCellSlabIter {
    * as well as the starting global coordinates of the tile the slab belongs
    * to, it computes the start cell position of the slab in the tile.
    *
+   * @tparam N The number of dimensions if it is known at compile time
+   *     (which unrolls the per-dimension loops), or `0` otherwise.
    * @param cell_slab_coords The starting coordinates of the cell slab.
    * @param tile_start_coords The global position of the first cell in the
    *     tile the cell slab belongs to.
    * @param start The computed start cell position of the slab.
    */
+  template <unsigned N>
   void compute_cell_slab_start(
       const T* cell_slab_coords,
       const std::vector<T>& tile_start_coords,
-      uint64_t* start);
-
-  /**
-   * Computes the overlap of the input cell slab with the input fragment
-   * domain.
-   *
-   * @param cell_slab The input cell slab.
-   * @param frag_domain The input fragment domain.
-   * @param slab_overlap The computed starting coordinates of the cell
-   *     slab overlap.
-   * @param overlap_length The length of the overlap (note that the overlap is
-   *     a subset of the input cell slab).
-   * @param overlap_type The type of overlap, where `0` means no overlap,
-   *     `1` means full overlap, and `2` means partial overlap.
-   */
-  void compute_cell_slab_overlap(
-      const CellSlab<T>& cell_slab,
-      const T* frag_domain,
-      std::vector<T>* slab_overlap,
-      uint64_t* overlap_length,
-      unsigned* overlap_type);
+      uint64_t* start) const;
 
   /**
    * Given the input cell slab, it creates the result cell slabs
-   * using `result_space_tiles_` and `result_coords` (which may
+   * using `result_space_tiles_` and `sparse_cells_` (which may
    * partition the cell slab into potentially multiple result
    * cell slabs).
    *
    * In other words, this function creates result cell slabs based
    * on both sparse and dense fragments in the dense array.
    */
+  template <unsigned N>
   void compute_result_cell_slabs(const CellSlab<T>& cell_slab);
 
   /**
-   * Given the input cell slab and result space tile,
-   * it creates result cell slabs based on dense fragments in the dense array.
+   * Given a part of a cell slab and the result space tile, it creates
+   * result cell slabs based on dense fragments in the dense array. The
+   * parts of the slab that overlap with no fragment produce result cell
+   * slabs for "empty" cells.
+   *
+   * @param slab_coords The starting coordinates of the cell slab.
+   * @param slab_start The start of the slab part along the slab dimension.
+   * @param slab_length The length of the slab part.
+   * @param result_space_tile The result space tile the cell slab
+   *     belongs to.
    */
+  template <unsigned N>
   void compute_result_cell_slabs_dense(
-      const CellSlab<T>& cell_slab, ResultSpaceTile<T>* result_space_tile);
+      const T* slab_coords,
+      T slab_start,
+      uint64_t slab_length,
+      ResultSpaceTile<T>* result_space_tile);
 
   /**
-   * Given the input result space tile and list of cell slabs to process,
-   * it creates result cell slabs that correspond to "empty" cells
-   * (i.e., to cells without any overlap with any fragments), and appends
-   * them to `result_cell_slabs`.
+   * Groups the valid result coordinates starting at `result_coords_pos_`
+   * into `sparse_cells_` by space tile, advancing `result_coords_pos_`
+   * up to the first coordinates outside the tiles of the subarray.
    */
-  void compute_result_cell_slabs_empty(
-      const ResultSpaceTile<T>& result_space_tile,
-      const std::list<CellSlab<T>>& to_process,
-      std::vector<ResultCellSlab>* result_cell_slabs);
+  void compute_sparse_cells();
 
   /**
-   * Splits the input cell slab into up to two new cell slabs based on the
-   * input slab overlap (i.e., it computes the set difference).
-   *
-   * @param cell_slab The input cell slab.
-   * @param slab_overlap The input slab overlap starting coordinates. This
-   *     will be used to split `cell_slab`. The result will essentially
-   *     be `cell_slab - (slab_overlap, overlap_length)`, which may consist
-   *     of one or two cell slabs (left and right of the slab overlap).
-   * @param overlap_length The overlap slab length.
-   * @param p1 The first new cell slab to be produced from the split.
-   * @param p2 The second (optional) new cell slab to be produced form the
-   * split.
-   * @param two_slabs Indicates whether one or two cell slabs got produced.
+   * Checks if the cell slab with the input starting coordinates lies
+   * in the input fragment domain along all dimensions other than the
+   * slab dimension.
    */
-  void split_cell_slab(
-      const CellSlab<T>& cell_slab,
-      const std::vector<T>& slab_overlap,
-      uint64_t overlap_length,
-      CellSlab<T>* p1,
-      CellSlab<T>* p2,
-      bool* two_slabs);
+  template <unsigned N>
+  bool slab_in_frag_domain(const T* slab_coords, const T* frag_domain) const;
 
   /**
    * Updates the current result cell slab, based on the next cell slab
@@ -34,6 +34,8 @@
 #include "tiledb/sm/array/array.h"
 #include "tiledb/sm/array_schema/array_schema.h"
 #include "tiledb/sm/array_schema/dimension.h"
+#include "tiledb/sm/cache/disk_tile_cache.h"
+#include "tiledb/sm/cache/tile_cache.h"
 #include "tiledb/sm/filesystem/vfs.h"
 #include "tiledb/sm/fragment/fragment_metadata.h"
 #include "tiledb/sm/misc/comparators.h"
@@ -41,14 +43,20 @@
 #include "tiledb/sm/misc/parallel_functions.h"
 #include "tiledb/sm/misc/stats.h"
 #include "tiledb/sm/misc/utils.h"
+#include "tiledb/sm/misc/var_offsets.h"
 #include "tiledb/sm/query/query_macros.h"
 #include "tiledb/sm/query/read_cell_slab_iter.h"
 #include "tiledb/sm/query/result_tile.h"
+#include "tiledb/sm/storage_manager/open_array.h"
 #include "tiledb/sm/storage_manager/storage_manager.h"
 #include "tiledb/sm/subarray/cell_slab.h"
 #include "tiledb/sm/tile/tile_io.h"
 
+#include <algorithm>
 #include <iostream>
+#include <limits>
+#include <queue>
+#include <unordered_set>
 
 namespace tiledb {
 namespace sm {
@@ -96,10 +104,30 @@ Reader::Reader() {
   storage_manager_ = nullptr;
   layout_ = Layout::ROW_MAJOR;
   sparse_mode_ = false;
+  prefetch_ = false;
+  balanced_splits_ = false;
+  plan_read_ = false;
+  open_array_ = nullptr;
+  empty_subarray_cache_size_ = 0;
+  offsets_bitsize_ = 64;
+  query_offsets_bitsize_ = 0;
+  offsets_extra_element_ = false;
+  offsets_in_elements_ = false;
+  limit_ = UINT64_MAX;
+  deadline_ms_ = 0;
+  sample_fraction_ = 1.0;
+  sample_seed_ = 0;
+  sample_cell_num_ = 0;
+  sample_skipped_cell_num_ = 0;
+  result_cell_num_ = 0;
+  tile_memory_fixed_ = 0;
+  tile_memory_var_ = 0;
   read_state_.initialized_ = false;
 }
 
-Reader::~Reader() = default;
+Reader::~Reader() {
+  wait_prefetch();
+}
 
 /* ****************************** */
 /*               API              */
@@ -109,6 +137,20 @@ const Array* Reader::array() const {
   return array_;
 }
 
+Status Reader::add_aggregate(
+    const std::string& name, AggregateOp op, void* result) {
+  if (read_state_.initialized_)
+    return LOG_STATUS(Status::ReaderError(
+        "Cannot add aggregate; Setting an aggregate on an already "
+        "initialized query is not supported"));
+
+  Aggregate aggregate(name, op, result);
+  RETURN_NOT_OK(aggregate.check(array_schema_));
+  aggregates_.emplace_back(std::move(aggregate));
+
+  return Status::Ok();
+}
+
 Status Reader::add_range(
     unsigned dim_idx, const void* start, const void* end, const void* stride) {
   if (stride != nullptr)
@@ -157,8 +199,22 @@ QueryBuffer Reader::buffer(const std::string& name) const {
   return buf->second;
 }
 
+uint32_t Reader::offsets_bitsize() const {
+  return offsets_bitsize_;
+}
+
+bool Reader::offsets_extra_element() const {
+  return offsets_extra_element_;
+}
+
+bool Reader::offsets_in_elements() const {
+  return offsets_in_elements_;
+}
+
 bool Reader::incomplete() const {
-  return read_state_.overflowed_ || !read_state_.done();
+  // A query that returned `limit_` cells is complete
+  return read_state_.overflowed_ || read_state_.resume_current_ ||
+         (!read_state_.done() && remaining_limit() > 0);
 }
 
 // TODO: handle both attributes and dimensions
@@ -206,28 +262,106 @@ Status Reader::init() {
   if (array_schema_ == nullptr)
     return LOG_STATUS(Status::ReaderError(
         "Cannot initialize reader; Array metadata not set"));
-  if (attr_buffers_.empty())
+  if (attr_buffers_.empty() && aggregates_.empty())
     return LOG_STATUS(
         Status::ReaderError("Cannot initialize reader; Buffers not set"));
-  if (attributes_.empty())
+  if (attributes_.empty() && aggregates_.empty())
     return LOG_STATUS(
         Status::ReaderError("Cannot initialize reader; Attributes not set"));
+  if (!attr_buffers_.empty() && !aggregates_.empty())
+    return LOG_STATUS(Status::ReaderError(
+        "Cannot initialize reader; Queries with aggregates cannot set "
+        "buffers"));
   if (array_schema_->dense() && !sparse_mode_ && !subarray_.is_set())
     return LOG_STATUS(Status::ReaderError(
         "Cannot initialize reader; Dense reads must have a subarray set"));
+  if (!condition_.empty() && array_schema_->dense() && !sparse_mode_ &&
+      has_coords())
+    return LOG_STATUS(Status::ReaderError(
+        "Cannot initialize reader; Dense reads with a query condition cannot "
+        "retrieve the coordinates"));
+  if (limit_ != UINT64_MAX && !aggregates_.empty())
+    return LOG_STATUS(Status::ReaderError(
+        "Cannot initialize reader; Queries with aggregates cannot set a "
+        "limit"));
 
   // Get configuration parameters
   const char *memory_budget, *memory_budget_var;
-  auto config = storage_manager_->config();
+  const auto& config = storage_manager_->config();
   RETURN_NOT_OK(config.get("sm.memory_budget", &memory_budget));
   RETURN_NOT_OK(config.get("sm.memory_budget_var", &memory_budget_var));
   RETURN_NOT_OK(utils::parse::convert(memory_budget, &memory_budget_));
   RETURN_NOT_OK(utils::parse::convert(memory_budget_var, &memory_budget_var_));
+
+  // Prefetched tiles are handed over through the tile cache
+  bool found = false;
+  uint64_t tile_cache_size = 0;
+  RETURN_NOT_OK(config.get<bool>("sm.read_prefetch", &prefetch_, &found));
+  assert(found);
+  RETURN_NOT_OK(
+      config.get<uint64_t>("sm.tile_cache_size", &tile_cache_size, &found));
+  assert(found);
+  prefetch_ = prefetch_ && tile_cache_size > 0;
+
+  RETURN_NOT_OK(config.get<bool>(
+      "sm.partitioner.balanced_splits", &balanced_splits_, &found));
+  assert(found);
+  const char* read_planner;
+  RETURN_NOT_OK(config.get("sm.read_planner", &read_planner));
+  plan_read_ = std::string(read_planner) == "cost";
+
+  // Tiles shared by consecutive partitions are unfiltered only once
+  double partition_tile_cache_ratio = 0.0;
+  RETURN_NOT_OK(config.get<double>(
+      "sm.partition_tile_cache_ratio", &partition_tile_cache_ratio, &found));
+  assert(found);
+  partition_tile_cache_.set_max_size(
+      (uint64_t)(partition_tile_cache_ratio * memory_budget_));
+
+  // Sparse reads record the subarrays in which they find no results
+  RETURN_NOT_OK(config.get<uint64_t>(
+      "sm.empty_subarray_cache_size", &empty_subarray_cache_size_, &found));
+  assert(found);
+  if (empty_subarray_cache_size_ > 0 && !array_schema_->dense() &&
+      array_ != nullptr)
+    open_array_ = storage_manager_->open_array_for_reads(array_->array_uri());
+
+  // Opening the array again loads the tile offsets of these attributes
+  if (array_ != nullptr)
+    storage_manager_->record_read_attributes(array_->array_uri(), attributes_);
+
+  // Format of the var-sized offsets written to the user buffers
+  RETURN_NOT_OK(config.get<uint32_t>(
+      "sm.var_offsets.bitsize", &offsets_bitsize_, &found));
+  assert(found);
+  if (query_offsets_bitsize_ != 0)
+    offsets_bitsize_ = query_offsets_bitsize_;
+  RETURN_NOT_OK(config.get<bool>(
+      "sm.var_offsets.extra_element", &offsets_extra_element_, &found));
+  assert(found);
+  const char* offsets_mode;
+  RETURN_NOT_OK(config.get("sm.var_offsets.mode", &offsets_mode));
+  offsets_in_elements_ = std::string(offsets_mode) == "elements";
+
   RETURN_NOT_OK(init_read_state());
 
   return Status::Ok();
 }
 
+Status Reader::reinit() {
+  if (!read_state_.initialized_)
+    return init();
+
+  if (array_schema_->dense() && !sparse_mode_ && !subarray_.is_set())
+    return LOG_STATUS(Status::ReaderError(
+        "Cannot initialize reader; Dense reads must have a subarray set"));
+
+  // The buffers are reused for the results of the new subarray
+  reset_buffer_sizes();
+
+  return init_read_state();
+}
+
 URI Reader::first_fragment_uri() const {
   if (fragment_metadata_.empty())
     return URI();
@@ -252,6 +386,51 @@ bool Reader::no_results() const {
   return true;
 }
 
+Status Reader::prefetch(const std::vector<std::string>& attributes) {
+  auto coords_type = array_schema_->coords_type();
+  switch (coords_type) {
+    case Datatype::INT8:
+      return prefetch<int8_t>(attributes);
+    case Datatype::UINT8:
+      return prefetch<uint8_t>(attributes);
+    case Datatype::INT16:
+      return prefetch<int16_t>(attributes);
+    case Datatype::UINT16:
+      return prefetch<uint16_t>(attributes);
+    case Datatype::INT32:
+      return prefetch<int>(attributes);
+    case Datatype::UINT32:
+      return prefetch<unsigned>(attributes);
+    case Datatype::INT64:
+      return prefetch<int64_t>(attributes);
+    case Datatype::UINT64:
+      return prefetch<uint64_t>(attributes);
+    case Datatype::FLOAT32:
+      return prefetch<float>(attributes);
+    case Datatype::FLOAT64:
+      return prefetch<double>(attributes);
+    case Datatype::DATETIME_YEAR:
+    case Datatype::DATETIME_MONTH:
+    case Datatype::DATETIME_WEEK:
+    case Datatype::DATETIME_DAY:
+    case Datatype::DATETIME_HR:
+    case Datatype::DATETIME_MIN:
+    case Datatype::DATETIME_SEC:
+    case Datatype::DATETIME_MS:
+    case Datatype::DATETIME_US:
+    case Datatype::DATETIME_NS:
+    case Datatype::DATETIME_PS:
+    case Datatype::DATETIME_FS:
+    case Datatype::DATETIME_AS:
+      return prefetch<int64_t>(attributes);
+    default:
+      return LOG_STATUS(
+          Status::ReaderError("Cannot prefetch; Unsupported domain type"));
+  }
+
+  return Status::Ok();
+}
+
 const Reader::ReadState* Reader::read_state() const {
   return &read_state_;
 }
@@ -308,10 +487,27 @@ Status Reader::read() {
 template <class T>
 Status Reader::read() {
   STATS_FUNC_IN(reader_read);
+  STATS_HISTOGRAM_TIMER(reader_read);
 
-  // Get next partition
-  if (!read_state_.unsplittable_)
+  // The prefetch works on a copy of the read state, but it must not
+  // outlive the partition it was computed from
+  wait_prefetch();
+
+  // The query returned all the cells within its limit
+  if (remaining_limit() == 0) {
+    zero_out_buffer_sizes();
+    return Status::Ok();
+  }
+
+  // Get next partition, unless the previous submission stopped at its
+  // deadline before reading the current one
+  if (!read_state_.unsplittable_ && !read_state_.resume_current_)
     RETURN_NOT_OK(read_state_.next());
+  read_state_.resume_current_ = false;
+
+  // Aggregates are computed over all partitions at once
+  if (!aggregates_.empty())
+    return aggregate_read<T>();
 
   // Handle empty array or empty/finished subarray
   if (fragment_metadata_.empty()) {
@@ -319,16 +515,30 @@ Status Reader::read() {
     return Status::Ok();
   }
 
-  // Loop until you find results, or unsplittable, or done
+  // Loop until you find results, or unsplittable, or done, or the deadline
+  auto start = std::chrono::steady_clock::now();
   do {
+    auto partition_start = std::chrono::steady_clock::now();
     read_state_.overflowed_ = false;
     reset_buffer_sizes();
+    partition_tile_cache_.next_partition();
 
     // Perform read
     if (array_schema_->dense() && !sparse_mode_) {
       RETURN_NOT_OK(dense_read<T>());
-    } else {
+    } else if (open_array_ == nullptr || !condition_.empty()) {
       RETURN_NOT_OK(sparse_read<T>());
+    } else {
+      // Skip the partitions already found to have no results
+      auto key = empty_subarray_key(read_state_.partitioner_.current());
+      if (open_array_->empty_subarray(key)) {
+        STATS_COUNTER_ADD(reader_empty_subarray_hits, 1);
+        zero_out_buffer_sizes();
+      } else {
+        RETURN_NOT_OK(sparse_read<T>());
+        if (!read_state_.overflowed_ && no_results())
+          open_array_->insert_empty_subarray(key, empty_subarray_cache_size_);
+      }
     }
 
     // In the case of overflow, we need to split the current partition
@@ -339,6 +549,14 @@ Status Reader::read() {
 
       if (read_state_.unsplittable_)
         return Status::Ok();
+
+      // Stop before reading the split partition, resuming from it in
+      // the next submission
+      if (deadline_reached(start, partition_start)) {
+        STATS_COUNTER_ADD(reader_num_deadline_stops, 1);
+        read_state_.resume_current_ = true;
+        return Status::Ok();
+      }
     } else {
       bool no_results = this->no_results();
 
@@ -346,10 +564,23 @@ Status Reader::read() {
       if (!no_results)
         read_state_.unsplittable_ = false;
 
-      if (!no_results || read_state_.done())
+      // No need to read further partitions
+      if (remaining_limit() == 0)
+        return Status::Ok();
+
+      if (!no_results || read_state_.done()) {
+        prefetch_next_partition<T>();
         return Status::Ok();
+      }
 
       RETURN_NOT_OK(read_state_.next());
+
+      // Stop before reading the next partition, returning no results
+      if (deadline_reached(start, partition_start)) {
+        STATS_COUNTER_ADD(reader_num_deadline_stops, 1);
+        read_state_.resume_current_ = true;
+        return Status::Ok();
+      }
     }
   } while (true);
 
@@ -408,6 +639,7 @@ Status Reader::set_buffer(
     attributes_.emplace_back(attribute);
 
   // Set attribute buffer
+  managed_buffers_.erase(attribute);
   attr_buffers_[attribute] = QueryBuffer(buffer, nullptr, buffer_size, nullptr);
 
   return Status::Ok();
@@ -458,12 +690,52 @@ Status Reader::set_buffer(
     attributes_.emplace_back(attribute);
 
   // Set attribute buffer
+  managed_buffers_.erase(attribute);
   attr_buffers_[attribute] =
       QueryBuffer(buffer_off, buffer_val, buffer_off_size, buffer_val_size);
 
   return Status::Ok();
 }
 
+Status Reader::set_managed_buffer(const std::string& attribute) {
+  // Array schema must exist
+  if (array_schema_ == nullptr)
+    return LOG_STATUS(Status::ReaderError(
+        "Cannot set managed buffer; Array schema not set"));
+
+  // Check that attribute exists
+  if (attribute != constants::coords &&
+      array_schema_->attribute(attribute) == nullptr)
+    return LOG_STATUS(Status::ReaderError(
+        "Cannot set managed buffer; Invalid attribute"));
+
+  // Check the attribute as for user buffers, then point its buffer to the
+  // empty managed buffers
+  bool var_size =
+      (attribute != constants::coords && array_schema_->var_size(attribute));
+  uint64_t size = 0, size_var = 0;
+  if (var_size)
+    RETURN_NOT_OK(
+        set_buffer(attribute, nullptr, &size, nullptr, &size_var, false));
+  else
+    RETURN_NOT_OK(set_buffer(attribute, nullptr, &size, false));
+
+  auto& managed = managed_buffers_[attribute];
+  attr_buffers_[attribute] = QueryBuffer(
+      nullptr,
+      nullptr,
+      &managed.buffer_size_,
+      var_size ? &managed.buffer_var_size_ : nullptr);
+
+  return Status::Ok();
+}
+
+Status Reader::set_condition(const QueryCondition& condition) {
+  RETURN_NOT_OK(condition.check(array_schema_));
+  condition_ = condition;
+  return Status::Ok();
+}
+
 void Reader::set_fragment_metadata(
     const std::vector<FragmentMetadata*>& fragment_metadata) {
   fragment_metadata_ = fragment_metadata;
@@ -476,6 +748,49 @@ Status Reader::set_layout(Layout layout) {
   return Status::Ok();
 }
 
+Status Reader::set_limit(uint64_t limit) {
+  if (array_schema_->dense())
+    return LOG_STATUS(Status::ReaderError(
+        "Cannot set limit; Only applicable to sparse arrays"));
+
+  limit_ = limit;
+  return Status::Ok();
+}
+
+Status Reader::set_deadline(uint64_t deadline_ms) {
+  deadline_ms_ = deadline_ms;
+  return Status::Ok();
+}
+
+Status Reader::set_sample(double fraction, uint64_t seed) {
+  if (array_schema_->dense())
+    return LOG_STATUS(Status::ReaderError(
+        "Cannot set sample; Only applicable to sparse arrays"));
+  if (!(fraction > 0.0 && fraction <= 1.0))
+    return LOG_STATUS(Status::ReaderError(
+        "Cannot set sample; The fraction must be in (0, 1]"));
+
+  sample_fraction_ = fraction;
+  sample_seed_ = seed;
+  return Status::Ok();
+}
+
+double Reader::sample_ratio() const {
+  auto total = sample_cell_num_ + sample_skipped_cell_num_;
+  if (total == 0)
+    return 1.0;
+  return (double)sample_cell_num_ / total;
+}
+
+Status Reader::set_offsets_bitsize(uint32_t bitsize) {
+  if (bitsize != 32 && bitsize != 64)
+    return LOG_STATUS(Status::ReaderError(
+        "Cannot set offsets bitsize; Must be 32 or 64"));
+
+  query_offsets_bitsize_ = bitsize;
+  return Status::Ok();
+}
+
 Status Reader::set_sparse_mode(bool sparse_mode) {
   if (!array_schema_->dense())
     return LOG_STATUS(Status::ReaderError(
@@ -544,50 +859,62 @@ void Reader::compute_result_space_tiles(
     const TileDomain<T>& array_tile_domain,
     const std::vector<TileDomain<T>>& frag_tile_domains,
     std::map<const T*, ResultSpaceTile<T>>* result_space_tiles) {
-  auto fragment_num = (unsigned)frag_tile_domains.size();
-  auto dim_num = array_tile_domain.dim_num();
-  std::vector<T> start_coords;
-  const T* coords;
-  start_coords.resize(dim_num);
+  // Compute the result space tiles concurrently, and then insert them
+  // into the map on this thread
+  auto tile_num = tile_coords.size();
+  std::vector<ResultSpaceTile<T>> space_tiles(tile_num);
+  parallel_for(0, tile_num, [&](uint64_t t) {
+    compute_result_space_tile<T>(
+        domain,
+        (const T*)&tile_coords[t][0],
+        array_tile_domain,
+        frag_tile_domains,
+        &space_tiles[t]);
+    return Status::Ok();
+  });
 
-  // For all tile coordinates
-  for (const auto& tc : tile_coords) {
-    coords = (T*)(&(tc[0]));
-    start_coords = array_tile_domain.start_coords(coords);
+  for (uint64_t t = 0; t < tile_num; ++t)
+    result_space_tiles->emplace(
+        (const T*)&tile_coords[t][0], std::move(space_tiles[t]));
+}
 
-    // Create result space tile and insert into the map
-    auto r = result_space_tiles->emplace(coords, ResultSpaceTile<T>());
-    auto& result_space_tile = r.first->second;
-    result_space_tile.start_coords_ = start_coords;
+template <class T>
+void Reader::compute_result_space_tile(
+    const Domain* domain,
+    const T* coords,
+    const TileDomain<T>& array_tile_domain,
+    const std::vector<TileDomain<T>>& frag_tile_domains,
+    ResultSpaceTile<T>* result_space_tile) {
+  auto fragment_num = (unsigned)frag_tile_domains.size();
+  result_space_tile->start_coords_ = array_tile_domain.start_coords(coords);
 
-    // Add fragment info to the result space tile
-    for (unsigned f = 0; f < fragment_num; ++f) {
-      // Check if the fragment overlaps with the space tile
-      if (!frag_tile_domains[f].in_tile_domain(coords))
-        continue;
+  // Add fragment info to the result space tile
+  for (unsigned f = 0; f < fragment_num; ++f) {
+    // Check if the fragment overlaps with the space tile
+    if (!frag_tile_domains[f].in_tile_domain(coords))
+      continue;
 
-      // Check if any previous fragment covers this fragment
-      // for the tile identified by `coords`
-      bool covered = false;
-      for (unsigned j = 0; j < f; ++j) {
-        if (frag_tile_domains[j].covers(coords, frag_tile_domains[f])) {
-          covered = true;
-          break;
-        }
+    // Check if any previous fragment covers this fragment
+    // for the tile identified by `coords`
+    bool covered = false;
+    for (unsigned j = 0; j < f; ++j) {
+      if (frag_tile_domains[j].covers(coords, frag_tile_domains[f])) {
+        covered = true;
+        break;
       }
+    }
 
-      // Exclude this fragment from the space tile
-      if (covered)
-        continue;
+    // Exclude this fragment from the space tile
+    if (covered)
+      continue;
 
-      // Include this fragment in the space tile
-      auto frag_domain = frag_tile_domains[f].domain_slice();
-      auto frag_idx = frag_tile_domains[f].id();
-      result_space_tile.frag_domains_.emplace_back(frag_idx, frag_domain);
-      auto tile_idx = frag_tile_domains[f].tile_pos(coords);
-      ResultTile result_tile(frag_idx, tile_idx, domain);
-      result_space_tile.result_tiles_[frag_idx] = result_tile;
-    }
+    // Include this fragment in the space tile
+    auto frag_domain = frag_tile_domains[f].domain_slice();
+    auto frag_idx = frag_tile_domains[f].id();
+    result_space_tile->frag_domains_.emplace_back(frag_idx, frag_domain);
+    auto tile_idx = frag_tile_domains[f].tile_pos(coords);
+    ResultTile result_tile(frag_idx, tile_idx, domain);
+    result_space_tile->result_tiles_[frag_idx] = result_tile;
   }
 }
 
@@ -595,119 +922,514 @@ void Reader::compute_result_space_tiles(
 /*          PRIVATE METHODS       */
 /* ****************************** */
 
-void Reader::clear_tiles(
-    const std::string& name,
-    const std::vector<ResultTile*>& result_tiles) const {
-  for (auto& result_tile : result_tiles)
-    result_tile->erase_tile(name);
-}
-
-Status Reader::compute_result_cell_slabs(
-    const std::vector<ResultCoords>& result_coords,
+void Reader::add_result_cell_slab(
+    const ResultCellSlab& result_cell_slab,
+    std::vector<ResultTile*>* result_tiles,
+    FragTileSet* frag_tile_set,
     std::vector<ResultCellSlab>* result_cell_slabs) const {
-  STATS_FUNC_IN(reader_compute_cell_ranges);
+  // Add result cell slab
+  result_cell_slabs->push_back(result_cell_slab);
+
+  // Add result tile
+  if (result_cell_slab.tile_ != nullptr) {
+    auto frag_idx = result_cell_slab.tile_->frag_idx();
+    auto tile_idx = result_cell_slab.tile_->tile_idx();
+    auto frag_tile_pair = std::pair<unsigned, uint64_t>(frag_idx, tile_idx);
+    auto it = frag_tile_set->find(frag_tile_pair);
+    if (it == frag_tile_set->end()) {
+      frag_tile_set->insert(frag_tile_pair);
+      result_tiles->push_back(result_cell_slab.tile_);
+    }
+  }
+}
 
-  // Trivial case
-  auto coords_num = (uint64_t)result_coords.size();
-  if (coords_num == 0)
+Status Reader::apply_query_condition(
+    uint64_t stride,
+    std::vector<ResultTile*>* result_tiles,
+    std::vector<ResultCellSlab>* result_cell_slabs) {
+  if (condition_.empty() || result_cell_slabs->empty())
     return Status::Ok();
 
-  // Initialize the first range
-  auto coords_end = result_coords.end();
-  auto it = skip_invalid_elements(result_coords.begin(), coords_end);
-  if (it == coords_end) {
-    return LOG_STATUS(Status::ReaderError("Unexpected empty cell range."));
+  STATS_FUNC_IN(reader_apply_query_condition);
+
+  // Skip the tiles whose value ranges cannot satisfy the condition, or
+  // without cells satisfying it according to the value indexes. The tiles
+  // with cells satisfying each comparison on an indexed attribute are
+  // looked up once per fragment, keyed on the compared value.
+  auto encryption_key = array_->encryption_key();
+  std::unordered_set<const ResultTile*> skipped_tiles;
+  std::map<std::pair<unsigned, const void*>, std::vector<uint64_t>>
+      index_tiles;
+  for (auto tile : *result_tiles) {
+    auto meta = fragment_metadata_[tile->frag_idx()];
+    auto tile_idx = tile->tile_idx();
+    auto min_max = [&](
+        const std::string& name, const void** min, const void** max) {
+      const void* sum;
+      return meta->get_tile_min_max_sum(
+          *encryption_key, name, tile_idx, min, max, &sum);
+    };
+    auto index = [&](
+        const std::string& name,
+        QueryConditionOp op,
+        const void* value,
+        bool* match) {
+      if (!plan_value_indexes_.empty() &&
+          !plan_value_indexes_[tile->frag_idx()])
+        return Status::Ok();
+      auto key = std::make_pair(tile->frag_idx(), value);
+      auto it = index_tiles.find(key);
+      if (it == index_tiles.end()) {
+        const ValueIndex* value_index = nullptr;
+        RETURN_NOT_OK(
+            meta->get_value_index(*encryption_key, name, &value_index));
+        if (value_index == nullptr)
+          return Status::Ok();
+        std::vector<uint64_t> tiles;
+        RETURN_NOT_OK(value_index->lookup(op, value, &tiles));
+        it = index_tiles.emplace(key, std::move(tiles)).first;
+      }
+      const auto& tiles = it->second;
+      *match = std::binary_search(tiles.begin(), tiles.end(), tile_idx);
+      return Status::Ok();
+    };
+    bool match = true;
+    RETURN_NOT_OK(
+        condition_.may_match(array_schema_, min_max, &match, index));
+    if (!match)
+      skipped_tiles.insert(tile);
+  }
+  if (!skipped_tiles.empty()) {
+    STATS_COUNTER_ADD(
+        reader_query_condition_skipped_tiles, skipped_tiles.size());
+    result_cell_slabs->erase(
+        std::remove_if(
+            result_cell_slabs->begin(),
+            result_cell_slabs->end(),
+            [&](const ResultCellSlab& cs) {
+              return skipped_tiles.count(cs.tile_) != 0;
+            }),
+        result_cell_slabs->end());
+    result_tiles->erase(
+        std::remove_if(
+            result_tiles->begin(),
+            result_tiles->end(),
+            [&](const ResultTile* tile) {
+              return skipped_tiles.count(tile) != 0;
+            }),
+        result_tiles->end());
   }
-  uint64_t start_pos = it->pos_;
-  uint64_t end_pos = start_pos;
-  auto tile = it->tile_;
 
-  // Scan the coordinates and compute ranges
-  it = skip_invalid_elements(++it, coords_end);
-  while (it != coords_end) {
-    if (it->tile_ == tile && it->pos_ == end_pos + 1) {
-      // Same range - advance end position
-      end_pos = it->pos_;
-    } else {
-      // New range - append previous range
-      result_cell_slabs->emplace_back(tile, start_pos, end_pos - start_pos + 1);
-      start_pos = it->pos_;
-      end_pos = start_pos;
-      tile = it->tile_;
-    }
-    it = skip_invalid_elements(++it, coords_end);
+  for (const auto& name : condition_.field_names()) {
+    RETURN_NOT_OK(charge_tile_memory(name, *result_tiles));
+    if (read_state_.overflowed_)
+      return Status::Ok();
+    RETURN_CANCEL_OR_ERROR(read_tiles(name, *result_tiles));
+    RETURN_CANCEL_OR_ERROR(filter_tiles(name, *result_tiles));
   }
 
-  // Append the last range
-  result_cell_slabs->emplace_back(tile, start_pos, end_pos - start_pos + 1);
+  RETURN_NOT_OK(condition_.apply(array_schema_, stride, result_cell_slabs));
+
+  // The remaining attributes are read only for the tiles with cells that
+  // satisfy the condition. Release the condition tiles of the others.
+  std::vector<ResultTile*> removed;
+  remove_empty_result_tiles(result_tiles, *result_cell_slabs, &removed);
+  for (auto tile : removed) {
+    for (const auto& name : condition_.field_names())
+      tile->erase_tile(name);
+  }
 
   return Status::Ok();
 
-  STATS_FUNC_OUT(reader_compute_cell_ranges);
+  STATS_FUNC_OUT(reader_apply_query_condition);
 }
 
-Status Reader::compute_range_result_coords(
-    unsigned frag_idx,
-    ResultTile* tile,
-    const std::vector<const void*>& range,
-    std::vector<ResultCoords>* result_coords) const {
-  auto coords_num = tile->cell_num();
-  auto fragment_num = fragment_metadata_.size();
+void Reader::apply_limit(
+    std::vector<ResultTile*>* result_tiles,
+    std::vector<ResultCellSlab>* result_cell_slabs) const {
+  auto max_num = remaining_limit();
+  uint64_t cell_num = 0;
+  size_t slab_num = 0;
+  for (; slab_num < result_cell_slabs->size() && cell_num < max_num;
+       ++slab_num) {
+    auto& cs = (*result_cell_slabs)[slab_num];
+    cs.length_ = std::min(cs.length_, max_num - cell_num);
+    cell_num += cs.length_;
+  }
+  if (slab_num == result_cell_slabs->size())
+    return;
 
-  for (uint64_t pos = 0; pos < coords_num; ++pos) {
-    // Check if the coordinates are in the range
-    if (!tile->coord_in_rect(pos, range))
-      continue;
+  // Keep only the tiles of the remaining slabs
+  result_cell_slabs->erase(
+      result_cell_slabs->begin() + slab_num, result_cell_slabs->end());
+  remove_empty_result_tiles(result_tiles, *result_cell_slabs, nullptr);
+}
 
-    // Check if the coordinates are overwritten by a future dense fragment
-    bool overwritten = false;
-    for (unsigned f = frag_idx + 1; !overwritten && f < fragment_num; ++f) {
-      if (fragment_metadata_[f]->dense()) {
-        overwritten = tile->coord_in_rect(
-            pos, fragment_metadata_[f]->non_empty_domain_vec());
-        if (overwritten)
-          break;
-      }
-    }
+void Reader::remove_empty_result_tiles(
+    std::vector<ResultTile*>* result_tiles,
+    const std::vector<ResultCellSlab>& result_cell_slabs,
+    std::vector<ResultTile*>* removed) const {
+  std::unordered_set<const ResultTile*> tiles;
+  for (const auto& cs : result_cell_slabs)
+    tiles.insert(cs.tile_);
+  auto it = std::stable_partition(
+      result_tiles->begin(),
+      result_tiles->end(),
+      [&](const ResultTile* tile) { return tiles.count(tile) != 0; });
+  STATS_COUNTER_ADD(
+      reader_num_empty_result_tiles_removed, result_tiles->end() - it);
+  if (removed != nullptr)
+    removed->insert(removed->end(), it, result_tiles->end());
+  result_tiles->erase(it, result_tiles->end());
+}
 
-    if (!overwritten)
-      result_coords->emplace_back(tile, pos);
+Status Reader::compute_aggregates(
+    uint64_t stride,
+    const std::vector<ResultTile*>& result_tiles,
+    const std::vector<ResultCellSlab>& result_cell_slabs) {
+  STATS_FUNC_IN(reader_compute_aggregates);
+
+  // Count the result cells, in total and per tile
+  uint64_t cell_num = 0;
+  std::unordered_map<const ResultTile*, uint64_t> tile_cell_nums;
+  for (const auto& cs : result_cell_slabs) {
+    cell_num += cs.length_;
+    if (cs.tile_ != nullptr)
+      tile_cell_nums[cs.tile_] += cs.length_;
   }
 
-  return Status::Ok();
-}
-
-// TODO: remove template 1
-template <class T>
-Status Reader::compute_range_result_coords(
-    const std::vector<bool>& single_fragment,
-    const std::map<std::pair<unsigned, uint64_t>, size_t>& result_tile_map,
-    std::vector<ResultTile>* result_tiles,
-    std::vector<std::vector<ResultCoords>>* range_result_coords) {
-  auto range_num = read_state_.partitioner_.current().range_num();
-  range_result_coords->resize(range_num);
-  auto cell_order = array_schema_->cell_order();
+  // Find the tiles whose cells are all results
+  std::vector<ResultTile*> full_tiles;
+  for (auto tile : result_tiles) {
+    auto it = tile_cell_nums.find(tile);
+    auto meta = fragment_metadata_[tile->frag_idx()];
+    if (it != tile_cell_nums.end() &&
+        it->second == meta->cell_num(tile->tile_idx()))
+      full_tiles.push_back(tile);
+  }
 
-  auto statuses = parallel_for(0, range_num, [&](uint64_t r) {
-    // Compute overlapping coordinates per range
-    RETURN_NOT_OK(compute_range_result_coords<T>(
-        r, result_tile_map, result_tiles, &((*range_result_coords)[r])));
-
-    // Potentially sort for deduping purposes (for the case of updates)
-    if (!single_fragment[r]) {
-      Layout layout =
-          (layout_ == Layout::GLOBAL_ORDER || layout_ == Layout ::UNORDERED) ?
-              cell_order :
-              layout_;
-
-      RETURN_CANCEL_OR_ERROR(
-          sort_result_coords(&((*range_result_coords)[r]), layout));
-      RETURN_CANCEL_OR_ERROR(dedup_result_coords(&((*range_result_coords)[r])));
-    }
+  // Group the aggregates per attribute, so that each tile is read once
+  std::map<std::string, std::vector<Aggregate*>> field_aggregates;
+  for (auto& aggregate : aggregates_) {
+    if (aggregate.op() == AggregateOp::AGGREGATE_COUNT)
+      aggregate.add_cell_num(cell_num);
+    else
+      field_aggregates[aggregate.field_name()].push_back(&aggregate);
+  }
 
-    // Compute tile coordinate
+  auto encryption_key = array_->encryption_key();
+  const auto& condition_names = condition_.field_names();
+  auto step = (stride == UINT64_MAX) ? 1 : stride;
+  for (const auto& it : field_aggregates) {
+    const auto& name = it.first;
+    const auto& aggregates = it.second;
+
+    // Aggregate the full tiles from the fragment metadata where possible
+    std::vector<std::unordered_set<const ResultTile*>> metadata_tiles(
+        aggregates.size());
+    for (auto tile : full_tiles) {
+      auto meta = fragment_metadata_[tile->frag_idx()];
+      const void *min, *max, *sum;
+      RETURN_NOT_OK(meta->get_tile_min_max_sum(
+          *encryption_key, name, tile->tile_idx(), &min, &max, &sum));
+      if (min == nullptr)
+        continue;
+      for (size_t i = 0; i < aggregates.size(); ++i) {
+        if (aggregates[i]->add_tile_min_max_sum(min, max, sum))
+          metadata_tiles[i].insert(tile);
+      }
+    }
+
+    // Read the tiles that are still needed, unless they are already loaded
+    // for the query condition
+    std::vector<ResultTile*> tiles;
+    for (auto tile : result_tiles) {
+      if (tile_cell_nums.count(tile) == 0)
+        continue;
+      for (const auto& aggregated : metadata_tiles) {
+        if (aggregated.count(tile) == 0) {
+          tiles.push_back(tile);
+          break;
+        }
+      }
+    }
+    STATS_COUNTER_ADD(
+        reader_aggregate_metadata_tiles, tile_cell_nums.size() - tiles.size());
+    bool loaded = condition_names.count(name) != 0;
+    if (!loaded) {
+      RETURN_CANCEL_OR_ERROR(read_tiles(name, tiles));
+      RETURN_CANCEL_OR_ERROR(filter_tiles(name, tiles));
+    }
+
+    // Aggregate the values of the result cells, comparing empty cells
+    // using the fill value
+    auto fill_value = constants::fill_value(array_schema_->type(name));
+    for (const auto& cs : result_cell_slabs) {
+      const void* values = fill_value;
+      uint64_t start = 0, cs_step = 0;
+      if (cs.tile_ != nullptr) {
+        auto tile_pair = cs.tile_->tile_pair(name);
+        values = (tile_pair == nullptr || tile_pair->first.empty()) ?
+                     nullptr :
+                     tile_pair->first.internal_data();
+        start = cs.start_;
+        cs_step = step;
+      }
+      for (size_t i = 0; i < aggregates.size(); ++i) {
+        if (cs.tile_ != nullptr && metadata_tiles[i].count(cs.tile_) != 0)
+          continue;
+        if (values == nullptr)
+          return LOG_STATUS(Status::ReaderError(
+              "Cannot compute aggregates; Tile of attribute '" + name +
+              "' is not loaded"));
+        aggregates[i]->add_values(values, start, cs_step, cs.length_);
+      }
+    }
+
+    if (!loaded)
+      clear_tiles(name, tiles);
+  }
+
+  return Status::Ok();
+
+  STATS_FUNC_OUT(reader_compute_aggregates);
+}
+
+void Reader::coalesce_result_cell_slabs(
+    std::vector<ResultCellSlab>* result_cell_slabs) const {
+  auto& slabs = *result_cell_slabs;
+  if (slabs.empty())
+    return;
+
+  size_t last = 0;
+  for (size_t i = 1; i < slabs.size(); ++i) {
+    auto& prev = slabs[last];
+    const auto& cs = slabs[i];
+    if (cs.tile_ == prev.tile_ &&
+        (cs.tile_ == nullptr || prev.start_ + prev.length_ == cs.start_)) {
+      prev.length_ += cs.length_;
+    } else if (++last != i) {
+      slabs[last] = std::move(slabs[i]);
+    }
+  }
+
+  STATS_COUNTER_ADD(reader_num_coalesced_cell_slabs, slabs.size() - last - 1);
+  slabs.resize(last + 1);
+}
+
+Status Reader::charge_tile_memory(
+    const std::string& name, const std::vector<ResultTile*>& result_tiles) {
+  // Compute the memory of the tiles that will be read
+  uint64_t size_fixed = 0, size_var = 0;
+  RETURN_NOT_OK(
+      compute_tile_memory(name, result_tiles, &size_fixed, &size_var));
+
+  // Split the partition rather than exceed the budget. A partition that
+  // could not be split further is read regardless, to ensure progress.
+  if (aggregates_.empty() && result_tiles.size() > 1 &&
+      !read_state_.unsplittable_ &&
+      (tile_memory_fixed_ + size_fixed > memory_budget_ ||
+       tile_memory_var_ + size_var > memory_budget_var_)) {
+    read_state_.overflowed_ = true;
+    STATS_COUNTER_ADD(reader_tile_memory_overflows, 1);
     return Status::Ok();
-  });
+  }
+
+  add_tile_memory(name, size_fixed, size_var);
+
+  return Status::Ok();
+}
+
+void Reader::add_tile_memory(
+    const std::string& name, uint64_t size_fixed, uint64_t size_var) {
+  auto& charged = tile_memory_[name];
+  charged.first += size_fixed;
+  charged.second += size_var;
+  tile_memory_fixed_ += size_fixed;
+  tile_memory_var_ += size_var;
+  STATS_COUNTER_MAX(
+      reader_tile_memory_peak, tile_memory_fixed_ + tile_memory_var_);
+}
+
+Status Reader::compute_tile_memory(
+    const std::string& name,
+    const std::vector<ResultTile*>& result_tiles,
+    uint64_t* size_fixed,
+    uint64_t* size_var) const {
+  bool var_size = array_schema_->var_size(name);
+  auto is_dim = array_schema_->is_dim(name);
+  auto encryption_key = array_->encryption_key();
+  uint64_t size;
+  *size_fixed = 0;
+  *size_var = 0;
+  for (const auto& tile : result_tiles) {
+    const auto& fragment = fragment_metadata_[tile->frag_idx()];
+    auto format_version = fragment->format_version();
+    if (name == constants::coords && format_version >= 5)
+      continue;
+    if (is_dim && format_version < 5)
+      continue;
+    auto tile_idx = tile->tile_idx();
+    *size_fixed += fragment->tile_size(name, tile_idx);
+    if (var_size) {
+      RETURN_NOT_OK(
+          fragment->tile_var_size(*encryption_key, name, tile_idx, &size));
+      *size_var += size;
+    }
+  }
+
+  return Status::Ok();
+}
+
+void Reader::clear_tiles(
+    const std::string& name,
+    const std::vector<ResultTile*>& result_tiles) const {
+  for (auto& result_tile : result_tiles)
+    result_tile->erase_tile(name);
+}
+
+void Reader::clear_tiles(
+    const std::string& name, const std::vector<ResultTile*>& result_tiles) {
+  static_cast<const Reader*>(this)->clear_tiles(name, result_tiles);
+  release_tile_memory(name);
+}
+
+Status Reader::compute_result_cell_slabs(
+    const std::vector<ResultCoords>& result_coords,
+    std::vector<ResultCellSlab>* result_cell_slabs) const {
+  STATS_FUNC_IN(reader_compute_cell_ranges);
+
+  // Trivial case
+  auto coords_num = (uint64_t)result_coords.size();
+  if (coords_num == 0)
+    return Status::Ok();
+
+  // Initialize the first range
+  auto coords_end = result_coords.end();
+  auto it = skip_invalid_elements(result_coords.begin(), coords_end);
+  if (it == coords_end) {
+    return LOG_STATUS(Status::ReaderError("Unexpected empty cell range."));
+  }
+  uint64_t start_pos = it->pos_;
+  uint64_t end_pos = start_pos;
+  auto tile = it->tile_;
+
+  // Scan the coordinates and compute ranges
+  it = skip_invalid_elements(++it, coords_end);
+  while (it != coords_end) {
+    if (it->tile_ == tile && it->pos_ == end_pos + 1) {
+      // Same range - advance end position
+      end_pos = it->pos_;
+    } else {
+      // New range - append previous range
+      result_cell_slabs->emplace_back(tile, start_pos, end_pos - start_pos + 1);
+      start_pos = it->pos_;
+      end_pos = start_pos;
+      tile = it->tile_;
+    }
+    it = skip_invalid_elements(++it, coords_end);
+  }
+
+  // Append the last range
+  result_cell_slabs->emplace_back(tile, start_pos, end_pos - start_pos + 1);
+
+  return Status::Ok();
+
+  STATS_FUNC_OUT(reader_compute_cell_ranges);
+}
+
+Status Reader::compute_range_result_coords(
+    unsigned frag_idx,
+    ResultTile* tile,
+    const std::vector<const void*>& range,
+    std::vector<ResultCoords>* result_coords) const {
+  auto coords_num = tile->cell_num();
+  auto fragment_num = fragment_metadata_.size();
+  auto dim_num = array_schema_->dim_num();
+
+  // Compute which coordinates are in the range, one dimension at a time
+  std::vector<uint8_t> result_bitmap(coords_num, 1);
+  for (unsigned d = 0; d < dim_num; ++d) {
+    if (skipped_dims_.empty() || !skipped_dims_[d])
+      tile->compute_results(d, range[d], &result_bitmap);
+  }
+
+  for (uint64_t pos = 0; pos < coords_num; ++pos) {
+    // Check if the coordinates are in the range
+    if (!result_bitmap[pos])
+      continue;
+
+    // Check if the coordinates are overwritten by a future dense fragment
+    bool overwritten = false;
+    for (unsigned f = frag_idx + 1; !overwritten && f < fragment_num; ++f) {
+      if (fragment_metadata_[f]->dense()) {
+        overwritten = tile->coord_in_rect(
+            pos, fragment_metadata_[f]->non_empty_domain_vec());
+        if (overwritten)
+          break;
+      }
+    }
+
+    if (!overwritten)
+      result_coords->emplace_back(tile, pos);
+  }
+
+  return Status::Ok();
+}
+
+// TODO: remove template 1
+template <class T>
+Status Reader::compute_range_result_coords(
+    const std::vector<bool>& single_fragment,
+    const ResultTileMap& result_tile_map,
+    std::vector<ResultTile>* result_tiles,
+    std::vector<std::vector<ResultCoords>>* range_result_coords) {
+  const auto& subarray = read_state_.partitioner_.current();
+  auto range_num = subarray.range_num();
+  range_result_coords->resize(range_num);
+  auto domain = array_schema_->domain();
+
+  // Visit each tile once for all the ranges, if they are disjoint. The
+  // sweep does not check the cells overwritten by dense fragments.
+  bool sweep = range_num > 1 && subarray.has_sorted_disjoint_ranges<T>();
+  for (const auto& meta : fragment_metadata_)
+    sweep = sweep && !meta->dense();
+  std::vector<std::vector<uint64_t>> range_runs(range_num);
+  if (sweep)
+    RETURN_NOT_OK(compute_range_result_coords_sweep<T>(
+        result_tile_map, result_tiles, range_result_coords, &range_runs));
+
+  auto cancel = storage_manager_->cancellation_flag();
+  auto statuses =
+      cancelable_parallel_for(0, range_num, cancel, [&](uint64_t r) {
+        // Compute overlapping coordinates per range
+        auto& runs = range_runs[r];
+        if (!sweep)
+          RETURN_NOT_OK(compute_range_result_coords<T>(
+              r,
+              result_tile_map,
+              result_tiles,
+              &((*range_result_coords)[r]),
+              &runs));
+
+        // Dedup (for the case of updates). Unordered results are deduped with
+        // hashing. Otherwise, the coordinates of each fragment are already in
+        // the global order, so they are merged to bring duplicates together and
+        // the range coordinates are left in the global order.
+        if (!single_fragment[r]) {
+          auto& coords = (*range_result_coords)[r];
+          if (layout_ == Layout::UNORDERED) {
+            RETURN_CANCEL_OR_ERROR(dedup_result_coords_unordered<T>(&coords));
+          } else {
+            RETURN_CANCEL_OR_ERROR(merge_result_coords(
+                &coords, runs, GlobalCmp(domain), UINT64_MAX));
+            RETURN_CANCEL_OR_ERROR(dedup_result_coords(&coords));
+          }
+        }
+
+        // Compute tile coordinate
+        return Status::Ok();
+      });
   for (auto st : statuses)
     RETURN_NOT_OK(st);
 
@@ -718,9 +1440,10 @@ Status Reader::compute_range_result_coords(
 template <class T>
 Status Reader::compute_range_result_coords(
     uint64_t range_idx,
-    const std::map<std::pair<unsigned, uint64_t>, size_t>& result_tile_map,
+    const ResultTileMap& result_tile_map,
     std::vector<ResultTile>* result_tiles,
-    std::vector<ResultCoords>* range_result_coords) {
+    std::vector<ResultCoords>* range_result_coords,
+    std::vector<uint64_t>* runs) {
   const auto& subarray = read_state_.partitioner_.current();
   const auto& overlap = subarray.tile_overlap();
   auto fragment_num = fragment_metadata_.size();
@@ -730,6 +1453,14 @@ Status Reader::compute_range_result_coords(
     if (fragment_metadata_[f]->dense())
       continue;
 
+    // Skip fragments whose bloom filter rejects the range, as done in
+    // `compute_sparse_result_tiles`
+    bool rejected = false;
+    RETURN_NOT_OK(coords_rejected<T>(f, subarray, range_idx, &rejected));
+    if (rejected)
+      continue;
+
+    runs->push_back(range_result_coords->size());
     auto tr = overlap[f][range_idx].tile_ranges_.begin();
     auto tr_end = overlap[f][range_idx].tile_ranges_.end();
     auto t = overlap[f][range_idx].tiles_.begin();
@@ -739,9 +1470,11 @@ Status Reader::compute_range_result_coords(
       // Handle tile range
       if (tr != tr_end && (t == t_end || tr->first < t->first)) {
         for (uint64_t i = tr->first; i <= tr->second; ++i) {
+          // Skip the tiles not needed within the limit of the query
           auto pair = std::pair<unsigned, uint64_t>(f, i);
           auto tile_it = result_tile_map.find(pair);
-          assert(tile_it != result_tile_map.end());
+          if (tile_it == result_tile_map.end())
+            continue;
           auto tile_idx = tile_it->second;
           auto& tile = (*result_tiles)[tile_idx];
 
@@ -756,7 +1489,10 @@ Status Reader::compute_range_result_coords(
         // Handle single tile
         auto pair = std::pair<unsigned, uint64_t>(f, t->first);
         auto tile_it = result_tile_map.find(pair);
-        assert(tile_it != result_tile_map.end());
+        if (tile_it == result_tile_map.end()) {
+          ++t;
+          continue;
+        }
         auto tile_idx = tile_it->second;
         auto& tile = (*result_tiles)[tile_idx];
         if (t->second == 1.0) {  // Full overlap
@@ -778,40 +1514,182 @@ Status Reader::compute_range_result_coords(
   return Status::Ok();
 }
 
+template <class T>
+Status Reader::compute_range_result_coords_sweep(
+    const ResultTileMap& result_tile_map,
+    std::vector<ResultTile>* result_tiles,
+    std::vector<std::vector<ResultCoords>>* range_result_coords,
+    std::vector<std::vector<uint64_t>>* range_runs) {
+  STATS_FUNC_IN(reader_compute_range_coords_sweep);
+
+  // For easy reference
+  const auto& subarray = read_state_.partitioner_.current();
+  const auto& overlap = subarray.tile_overlap();
+  auto range_num = subarray.range_num();
+  auto dim_num = array_schema_->dim_num();
+  auto tile_num = result_tiles->size();
+
+  // The cells of the tiles fully covered by a range are all in that range
+  std::vector<uint64_t> full_ranges(tile_num, UINT64_MAX);
+  auto set_full_range = [&](unsigned f, uint64_t t, uint64_t r) {
+    auto tile_it = result_tile_map.find(std::make_pair(f, t));
+    if (tile_it != result_tile_map.end())
+      full_ranges[tile_it->second] = r;
+  };
+  for (unsigned f = 0; f < fragment_metadata_.size(); ++f) {
+    for (uint64_t r = 0; r < range_num; ++r) {
+      for (const auto& tr : overlap[f][r].tile_ranges_) {
+        for (uint64_t t = tr.first; t <= tr.second; ++t)
+          set_full_range(f, t, r);
+      }
+      for (const auto& o_tile : overlap[f][r].tiles_) {
+        if (o_tile.second == 1.0)
+          set_full_range(f, o_tile.first, r);
+      }
+    }
+  }
+
+  // The sorted range bounds of each dimension
+  std::vector<std::vector<T>> starts(dim_num), ends(dim_num);
+  for (unsigned d = 0; d < dim_num; ++d) {
+    uint64_t dim_range_num = 0;
+    RETURN_NOT_OK(subarray.get_range_num(d, &dim_range_num));
+    for (uint64_t i = 0; i < dim_range_num; ++i) {
+      const void* range = nullptr;
+      RETURN_NOT_OK(subarray.get_range(d, i, &range));
+      starts[d].push_back(((const T*)range)[0]);
+      ends[d].push_back(((const T*)range)[1]);
+    }
+  }
+
+  // Visit the tiles in the order of their fragment and position, so that
+  // the coordinates of each fragment are in the global order in each range
+  std::vector<size_t> order(tile_num);
+  for (size_t i = 0; i < tile_num; ++i)
+    order[i] = i;
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    const auto& ta = (*result_tiles)[a];
+    const auto& tb = (*result_tiles)[b];
+    return ta.frag_idx() < tb.frag_idx() ||
+           (ta.frag_idx() == tb.frag_idx() && ta.tile_idx() < tb.tile_idx());
+  });
+
+  // Find the (range, position) of the result cells of each tile
+  typedef std::pair<uint64_t, uint64_t> RangePos;
+  std::vector<std::vector<RangePos>> tile_results(tile_num);
+  auto cancel = storage_manager_->cancellation_flag();
+  auto statuses = cancelable_parallel_for(0, tile_num, cancel, [&](uint64_t i) {
+    const auto& tile = (*result_tiles)[order[i]];
+    auto& results = tile_results[i];
+    auto coords_num = tile.cell_num();
+    auto full_range = full_ranges[order[i]];
+    if (full_range != UINT64_MAX) {
+      results.reserve(coords_num);
+      for (uint64_t pos = 0; pos < coords_num; ++pos)
+        results.emplace_back(full_range, pos);
+      return Status::Ok();
+    }
+
+    std::vector<uint64_t> range_coords(dim_num);
+    for (uint64_t pos = 0; pos < coords_num; ++pos) {
+      bool in_range = true;
+      for (unsigned d = 0; in_range && d < dim_num; ++d) {
+        // The coordinates on a skipped dimension are in its single range
+        if (!skipped_dims_.empty() && skipped_dims_[d]) {
+          range_coords[d] = 0;
+          continue;
+        }
+        auto c = *(const T*)tile.coord(pos, d);
+        auto it = std::lower_bound(ends[d].begin(), ends[d].end(), c);
+        auto idx = (uint64_t)(it - ends[d].begin());
+        in_range = it != ends[d].end() && !(c < starts[d][idx]);
+        range_coords[d] = idx;
+      }
+      if (in_range)
+        results.emplace_back(subarray.range_idx(range_coords), pos);
+    }
+
+    return Status::Ok();
+  });
+  for (const auto& st : statuses)
+    RETURN_NOT_OK(st);
+
+  // Distribute the cells to the ranges, starting a run at each fragment
+  std::vector<unsigned> last_frag(range_num, UINT32_MAX);
+  for (size_t i = 0; i < tile_num; ++i) {
+    auto& tile = (*result_tiles)[order[i]];
+    auto frag_idx = tile.frag_idx();
+    for (const auto& result : tile_results[i]) {
+      auto r = result.first;
+      auto& coords = (*range_result_coords)[r];
+      if (last_frag[r] != frag_idx) {
+        (*range_runs)[r].push_back(coords.size());
+        last_frag[r] = frag_idx;
+      }
+      coords.emplace_back(&tile, result.second);
+    }
+    tile_results[i].clear();
+  }
+
+  return Status::Ok();
+
+  STATS_FUNC_OUT(reader_compute_range_coords_sweep);
+}
+
 Status Reader::compute_subarray_coords(
     std::vector<std::vector<ResultCoords>>* range_result_coords,
     std::vector<ResultCoords>* result_coords) {
   // Add all valid ``range_result_coords`` to ``result_coords``
+  std::vector<uint64_t> runs;
   for (const auto& rv : *range_result_coords) {
+    runs.push_back(result_coords->size());
     for (const auto& c : rv) {
       if (c.valid())
         result_coords->emplace_back(c.tile_, c.pos_);
     }
   }
 
+  // Without a query condition, the coordinates past the limit of the query
+  // are not results
+  auto max_num = condition_.empty() ? remaining_limit() : UINT64_MAX;
+
   // No need to sort in UNORDERED layout
-  if (layout_ == Layout::UNORDERED)
+  if (layout_ == Layout::UNORDERED) {
+    if (result_coords->size() > max_num)
+      result_coords->erase(
+          result_coords->begin() + max_num, result_coords->end());
     return Status::Ok();
+  }
 
-  // Sort
-  auto cell_order = array_schema_->cell_order();
-  Layout layout = (layout_ == Layout ::UNORDERED) ? cell_order : layout_;
+  // The coordinates of each range are in the global order, which is also
+  // the row-major and col-major order of one-dimensional domains, so they
+  // only need to be merged
+  auto domain = array_schema_->domain();
+  if (layout_ == Layout::GLOBAL_ORDER || domain->dim_num() == 1)
+    return merge_result_coords(
+        result_coords, runs, GlobalCmp(domain), max_num);
 
-  RETURN_NOT_OK(sort_result_coords(result_coords, layout));
+  // Sort
+  RETURN_NOT_OK(sort_result_coords(result_coords, layout_));
+  if (result_coords->size() > max_num)
+    result_coords->erase(
+        result_coords->begin() + max_num, result_coords->end());
 
   return Status::Ok();
 }
 
 template <class T>
 Status Reader::compute_sparse_result_tiles(
+    const Subarray& subarray,
     std::vector<ResultTile>* result_tiles,
-    std::map<std::pair<unsigned, uint64_t>, size_t>* result_tile_map,
-    std::vector<bool>* single_fragment) {
+    ResultTileMap* result_tile_map,
+    std::vector<bool>* single_fragment,
+    std::vector<ResultTile>* free_result_tiles,
+    uint64_t* skipped_cell_num) const {
   STATS_FUNC_IN(reader_compute_overlapping_tiles);
 
   // For easy reference
   auto domain = array_schema_->domain();
-  const auto& subarray = read_state_.partitioner_.current();
   const auto& overlap = subarray.tile_overlap();
   auto range_num = subarray.range_num();
   auto fragment_num = fragment_metadata_.size();
@@ -824,21 +1702,64 @@ Status Reader::compute_sparse_result_tiles(
   for (uint64_t i = 0; i < range_num; ++i)
     (*single_fragment)[i] = true;
 
+  // The cells of the tiles fully covered by the ranges of a single fragment
+  // are all results of unordered reads, so no more tiles are needed once
+  // they reach the limit of the query
+  uint64_t max_num = (fragment_num == 1 && layout_ == Layout::UNORDERED &&
+                      condition_.empty()) ?
+                         remaining_limit() :
+                         UINT64_MAX;
+  uint64_t full_cell_num = 0;
+
+  // Returns `true` if a tile is left out of the sample, counting its cells
+  // once
+  std::set<std::pair<unsigned, uint64_t>> skipped_tiles;
+  auto skip_tile = [&](unsigned f, uint64_t t) {
+    if (tile_sampled(f, t))
+      return false;
+    if (skipped_cell_num != nullptr &&
+        skipped_tiles.insert(std::make_pair(f, t)).second)
+      *skipped_cell_num += fragment_metadata_[f]->cell_num(t);
+    return true;
+  };
+
+  // Adds a result tile, recycling a free one if possible
+  auto add_result_tile = [&](unsigned f, uint64_t t) {
+    if (free_result_tiles == nullptr || free_result_tiles->empty()) {
+      result_tiles->emplace_back(f, t, domain);
+    } else {
+      result_tiles->emplace_back(std::move(free_result_tiles->back()));
+      free_result_tiles->pop_back();
+      result_tiles->back().init(f, t, domain);
+    }
+  };
+
   result_tiles->clear();
   for (unsigned f = 0; f < fragment_num; ++f) {
     // Skip dense fragments
     if (fragment_metadata_[f]->dense())
       continue;
 
-    for (uint64_t r = 0; r < range_num; ++r) {
+    for (uint64_t r = 0; r < range_num && full_cell_num < max_num; ++r) {
+      // Skip the fragment if its bloom filter rejects the range
+      bool rejected = false;
+      RETURN_NOT_OK(coords_rejected<T>(f, subarray, r, &rejected));
+      if (rejected) {
+        STATS_COUNTER_ADD(reader_bloom_filter_skipped_fragments, 1);
+        continue;
+      }
+
       // Handle range of tiles (full overlap)
       const auto& tile_ranges = overlap[f][r].tile_ranges_;
       for (const auto& tr : tile_ranges) {
-        for (uint64_t t = tr.first; t <= tr.second; ++t) {
+        for (uint64_t t = tr.first; t <= tr.second && full_cell_num < max_num;
+             ++t) {
           auto pair = std::pair<unsigned, uint64_t>(f, t);
           // Add tile only if it does not already exist
-          if (result_tile_map->find(pair) == result_tile_map->end()) {
-            result_tiles->emplace_back(f, t, domain);
+          if (result_tile_map->find(pair) == result_tile_map->end() &&
+              !skip_tile(f, t)) {
+            full_cell_num += fragment_metadata_[f]->cell_num(t);
+            add_result_tile(f, t);
             (*result_tile_map)[pair] = result_tiles->size() - 1;
             if (f > first_fragment[r])
               (*single_fragment)[r] = false;
@@ -851,11 +1772,16 @@ Status Reader::compute_sparse_result_tiles(
       // Handle single tiles
       const auto& o_tiles = overlap[f][r].tiles_;
       for (const auto& o_tile : o_tiles) {
+        if (full_cell_num >= max_num)
+          break;
         auto t = o_tile.first;
         auto pair = std::pair<unsigned, uint64_t>(f, t);
         // Add tile only if it does not already exist
-        if (result_tile_map->find(pair) == result_tile_map->end()) {
-          result_tiles->emplace_back(f, t, domain);
+        if (result_tile_map->find(pair) == result_tile_map->end() &&
+            !skip_tile(f, t)) {
+          if (o_tile.second == 1.0)
+            full_cell_num += fragment_metadata_[f]->cell_num(t);
+          add_result_tile(f, t);
           (*result_tile_map)[pair] = result_tiles->size() - 1;
           if (f > first_fragment[r])
             (*single_fragment)[r] = false;
@@ -871,6 +1797,35 @@ Status Reader::compute_sparse_result_tiles(
   STATS_FUNC_OUT(reader_compute_overlapping_tiles);
 }
 
+template <class T>
+Status Reader::coords_rejected(
+    unsigned frag_idx,
+    const Subarray& subarray,
+    uint64_t range_idx,
+    bool* rejected) const {
+  *rejected = false;
+
+  // Only points can be looked up in the bloom filter
+  if (!subarray.is_unary(range_idx))
+    return Status::Ok();
+
+  auto meta = fragment_metadata_[frag_idx];
+  RETURN_NOT_OK(meta->load_coords_bloom_filter(*array_->encryption_key()));
+  auto bloom_filter = meta->coords_bloom_filter();
+  if (bloom_filter == nullptr)
+    return Status::Ok();
+
+  auto range = subarray.range<T>(range_idx);
+  auto dim_num = (unsigned)range.size();
+  std::vector<T> coords(dim_num);
+  for (unsigned d = 0; d < dim_num; ++d)
+    coords[d] = range[d][0];
+  *rejected = !bloom_filter->may_contain(
+      BloomFilter::hash_coords<T>(&coords[0], dim_num));
+
+  return Status::Ok();
+}
+
 Status Reader::copy_cells(
     const std::string& attribute,
     uint64_t stride,
@@ -882,13 +1837,14 @@ Status Reader::copy_cells(
 
   if (array_schema_->var_size(attribute))
     return copy_var_cells(attribute, stride, result_cell_slabs);
-  return copy_fixed_cells(attribute, stride, result_cell_slabs);
+  return copy_fixed_cells(attribute, stride, result_cell_slabs, {});
 }
 
 Status Reader::copy_fixed_cells(
     const std::string& name,
     uint64_t stride,
-    const std::vector<ResultCellSlab>& result_cell_slabs) {
+    const std::vector<ResultCellSlab>& result_cell_slabs,
+    const std::unordered_map<const ResultTile*, void*>& dests) {
   STATS_FUNC_IN(reader_copy_fixed_cells);
 
   // For easy reference
@@ -908,14 +1864,18 @@ Status Reader::copy_fixed_cells(
     buffer_offset += bytes_to_copy;
   }
 
-  // Handle overflow
+  // Handle overflow, unless the buffer can grow to fit the cells
   if (buffer_offset > *buffer_size) {
-    read_state_.overflowed_ = true;
-    return Status::Ok();
+    if (!grow_managed_buffer(name, buffer_offset, 0)) {
+      read_state_.overflowed_ = true;
+      return Status::Ok();
+    }
+    buffer = (unsigned char*)it->second.buffer_;
   }
 
   // Copy cell ranges in parallel.
-  auto statuses = parallel_for(0, num_cs, [&](uint64_t i) {
+  auto cancel = storage_manager_->cancellation_flag();
+  auto statuses = cancelable_parallel_for(0, num_cs, cancel, [&](uint64_t i) {
     const auto& cs = result_cell_slabs[i];
     uint64_t offset = cs_offsets[i];
     // Check for overflow
@@ -927,14 +1887,14 @@ Status Reader::copy_fixed_cells(
       auto fill_size = datatype_size(type);
       auto fill_value = constants::fill_value(type);
       assert(fill_value != nullptr);
-      auto bytes_to_copy = cs.length_ * cell_size;
-      auto fill_num = bytes_to_copy / fill_size;
-      for (uint64_t j = 0; j < fill_num; ++j) {
-        std::memcpy(buffer + offset, fill_value, fill_size);
-        offset += fill_size;
-      }
+      auto fill_num = cs.length_ * cell_size / fill_size;
+      fill_cells(buffer + offset, fill_value, fill_size, fill_num);
     } else {  // Non-empty range
       if (stride == UINT64_MAX) {
+        // Skip the tiles already unfiltered in place
+        auto dest_it = dests.find(cs.tile_);
+        if (dest_it != dests.end() && dest_it->second == buffer + offset)
+          return Status::Ok();
         RETURN_NOT_OK(
             cs.tile_->read(name, buffer + offset, cs.start_, cs.length_));
       } else {
@@ -975,83 +1935,137 @@ Status Reader::copy_var_cells(
   auto buffer_var = (unsigned char*)it->second.buffer_var_;
   auto buffer_size = it->second.buffer_size_;
   auto buffer_var_size = it->second.buffer_var_size_;
-  uint64_t offset_size = constants::cell_var_offset_size;
+  const uint64_t offset_size = offsets_bitsize_ / 8;
   auto type = array_schema_->type(name);
   auto fill_size = datatype_size(type);
   auto fill_value = constants::fill_value(type);
   assert(fill_value != nullptr);
 
+  // Writes an offset in the configured unit and width
+  const uint64_t offset_div = offsets_in_elements_ ? fill_size : 1;
+  auto write_offset = [offset_size, offset_div](
+                          unsigned char* dest, uint64_t offset) {
+    offset /= offset_div;
+    if (offset_size == sizeof(uint32_t)) {
+      const auto offset32 = static_cast<uint32_t>(offset);
+      std::memcpy(dest, &offset32, sizeof(offset32));
+    } else {
+      std::memcpy(dest, &offset, sizeof(offset));
+    }
+  };
+
   // Compute the destinations of offsets and var-len data in the buffers.
-  std::vector<std::vector<uint64_t>> offset_offsets_per_cs;
-  std::vector<std::vector<uint64_t>> var_offsets_per_cs;
+  std::vector<uint64_t> cs_offsets;
+  std::vector<uint64_t> cs_var_offsets;
   uint64_t total_offset_size, total_var_size;
   RETURN_NOT_OK(compute_var_cell_destinations(
       name,
       stride,
       result_cell_slabs,
-      &offset_offsets_per_cs,
-      &var_offsets_per_cs,
+      &cs_offsets,
+      &cs_var_offsets,
       &total_offset_size,
       &total_var_size));
 
-  // Check for overflow and return early (without copying) in that case.
-  if (total_offset_size > *buffer_size || total_var_size > *buffer_var_size) {
+  // Offsets that do not fit in 32 bits overflow like the buffers, so that
+  // the partition is split until they fit
+  if (offset_size == sizeof(uint32_t) &&
+      total_var_size / offset_div > UINT32_MAX) {
+    STATS_COUNTER_ADD(reader_num_offsets_overflows, 1);
     read_state_.overflowed_ = true;
     return Status::Ok();
   }
 
-  // Copy result cell slabs in parallel
-  const auto num_cs = result_cell_slabs.size();
-  auto statuses = parallel_for(0, num_cs, [&](uint64_t cs_idx) {
-    const auto& cs = result_cell_slabs[cs_idx];
-    const auto& offset_offsets = offset_offsets_per_cs[cs_idx];
-    const auto& var_offsets = var_offsets_per_cs[cs_idx];
-
-    // Get tile information, if the range is nonempty.
-    uint64_t* tile_offsets = nullptr;
-    Tile* tile_var = nullptr;
-    uint64_t tile_cell_num = 0;
-    if (cs.tile_ != nullptr) {
-      const auto tile_pair = cs.tile_->tile_pair(name);
-      Tile* const tile = &tile_pair->first;
-      tile_var = &tile_pair->second;
-      tile_offsets = (uint64_t*)tile->internal_data();
-      tile_cell_num = tile->cell_num();
+  // Check for overflow and return early (without copying) in that case,
+  // unless the buffers can grow to fit the cells.
+  if (total_offset_size > *buffer_size || total_var_size > *buffer_var_size) {
+    if (!grow_managed_buffer(name, total_offset_size, total_var_size)) {
+      read_state_.overflowed_ = true;
+      return Status::Ok();
     }
+    buffer = (unsigned char*)it->second.buffer_;
+    buffer_var = (unsigned char*)it->second.buffer_var_;
+  }
 
-    // Copy each cell in the range
-    uint64_t dest_vec_idx = 0;
-    stride = (stride == UINT64_MAX) ? 1 : stride;
-    for (auto cell_idx = cs.start_; dest_vec_idx < cs.length_;
-         cell_idx += stride, dest_vec_idx++) {
-      auto offset_dest = buffer + offset_offsets[dest_vec_idx];
-      auto var_offset = var_offsets[dest_vec_idx];
-      auto var_dest = buffer_var + var_offset;
-
-      // Copy offset
-      std::memcpy(offset_dest, &var_offset, offset_size);
-
-      // Copy variable-sized value
-      if (cs.tile_ == nullptr) {
-        std::memcpy(var_dest, &fill_value, fill_size);
-      } else {
-        const uint64_t cell_var_size =
-            (cell_idx != tile_cell_num - 1) ?
-                tile_offsets[cell_idx + 1] - tile_offsets[cell_idx] :
-                tile_var->size() - (tile_offsets[cell_idx] - tile_offsets[0]);
-        const uint64_t tile_var_offset =
-            tile_offsets[cell_idx] - tile_offsets[0];
-        RETURN_NOT_OK(tile_var->read(var_dest, cell_var_size, tile_var_offset));
-      }
-    }
+  // Copy result cell slabs in parallel
+  const auto num_cs = result_cell_slabs.size();
+  auto cancel = storage_manager_->cancellation_flag();
+  auto statuses =
+      cancelable_parallel_for(0, num_cs, cancel, [&](uint64_t cs_idx) {
+        const auto& cs = result_cell_slabs[cs_idx];
+        auto offset_dest = buffer + cs_offsets[cs_idx];
+        auto var_offset = cs_var_offsets[cs_idx];
+
+        // Fill empty ranges
+        if (cs.tile_ == nullptr) {
+          fill_cells(
+              buffer_var + var_offset, fill_value, fill_size, cs.length_);
+          var_offsets::sequence(
+              cs.length_,
+              var_offset,
+              fill_size,
+              offset_div,
+              offsets_bitsize_,
+              offset_dest);
+          return Status::Ok();
+        }
 
-    return Status::Ok();
-  });
+        if (cs.length_ == 0)
+          return Status::Ok();
+
+        // Get tile information
+        const auto tile_pair = cs.tile_->tile_pair(name);
+        Tile* const tile = &tile_pair->first;
+        Tile* const tile_var = &tile_pair->second;
+        auto tile_offsets = (const uint64_t*)tile->internal_data();
+        auto tile_cell_num = tile->cell_num();
+        auto tile_var_size = tile_var->size();
+
+        // The values of contiguous cells are contiguous in the tile, so they
+        // are copied at once, with their offsets shifted to their destination
+        if (stride == UINT64_MAX) {
+          auto start = tile_offsets[cs.start_] - tile_offsets[0];
+          auto end_cell = cs.start_ + cs.length_;
+          auto end = (end_cell != tile_cell_num) ?
+                         tile_offsets[end_cell] - tile_offsets[0] :
+                         tile_var_size;
+          var_offsets::to_user(
+              &tile_offsets[cs.start_],
+              cs.length_,
+              tile_offsets[cs.start_] - var_offset,
+              offset_div,
+              offsets_bitsize_,
+              offset_dest);
+          return tile_var->read(buffer_var + var_offset, end - start, start);
+        }
+
+        // Copy each cell in the range
+        uint64_t cell_idx = cs.start_;
+        for (uint64_t i = 0; i < cs.length_; ++i, cell_idx += stride) {
+          const uint64_t tile_var_offset =
+              tile_offsets[cell_idx] - tile_offsets[0];
+          const uint64_t cell_var_size =
+              (cell_idx != tile_cell_num - 1) ?
+                  tile_offsets[cell_idx + 1] - tile_offsets[cell_idx] :
+                  tile_var_size - tile_var_offset;
+          write_offset(offset_dest, var_offset);
+          RETURN_NOT_OK(tile_var->read(
+              buffer_var + var_offset, cell_var_size, tile_var_offset));
+          offset_dest += offset_size;
+          var_offset += cell_var_size;
+        }
+
+        return Status::Ok();
+      });
 
   // Check all statuses
   for (auto st : statuses)
     RETURN_NOT_OK(st);
 
+  // The extra offset marks the end of the last cell
+  if (offsets_extra_element_)
+    write_offset(buffer + total_offset_size - offset_size, total_var_size);
+
   // Update buffer offsets
   *(attr_buffers_[name].buffer_size_) = total_offset_size;
   *(attr_buffers_[name].buffer_var_size_) = total_var_size;
@@ -1067,91 +2081,100 @@ Status Reader::compute_var_cell_destinations(
     const std::string& name,
     uint64_t stride,
     const std::vector<ResultCellSlab>& result_cell_slabs,
-    std::vector<std::vector<uint64_t>>* offset_offsets_per_cs,
-    std::vector<std::vector<uint64_t>>* var_offsets_per_cs,
+    std::vector<uint64_t>* cs_offsets,
+    std::vector<uint64_t>* cs_var_offsets,
     uint64_t* total_offset_size,
     uint64_t* total_var_size) const {
   // For easy reference
   auto num_cs = result_cell_slabs.size();
-  auto offset_size = constants::cell_var_offset_size;
+  const uint64_t offset_size = offsets_bitsize_ / 8;
   auto type = array_schema_->type(name);
   auto fill_size = datatype_size(type);
 
-  // Resize the output vectors
-  offset_offsets_per_cs->resize(num_cs);
-  var_offsets_per_cs->resize(num_cs);
-
-  // Compute the destinations for all result cell slabs
-  *total_offset_size = 0;
-  *total_var_size = 0;
-  for (uint64_t cs_idx = 0; cs_idx < num_cs; cs_idx++) {
+  // Compute the variable-length data size of each result cell slab in
+  // parallel, with a single subtraction for contiguous cells
+  cs_var_offsets->resize(num_cs);
+  auto statuses = parallel_for(0, num_cs, [&](uint64_t cs_idx) {
     const auto& cs = result_cell_slabs[cs_idx];
-    (*offset_offsets_per_cs)[cs_idx].resize(cs.length_);
-    (*var_offsets_per_cs)[cs_idx].resize(cs.length_);
-
-    // Get tile information, if the range is nonempty.
-    uint64_t* tile_offsets = nullptr;
-    uint64_t tile_cell_num = 0;
-    uint64_t tile_var_size = 0;
-    if (cs.tile_ != nullptr) {
-      const auto tile_pair = cs.tile_->tile_pair(name);
-      const auto& tile = tile_pair->first;
-      const auto& tile_var = tile_pair->second;
-      tile_offsets = (uint64_t*)tile.internal_data();
-      tile_cell_num = tile.cell_num();
-      tile_var_size = tile_var.size();
+    auto& var_size = (*cs_var_offsets)[cs_idx];
+    if (cs.tile_ == nullptr || cs.length_ == 0) {
+      var_size = cs.length_ * fill_size;
+      return Status::Ok();
     }
 
-    // Compute the destinations for each cell in the range.
-    uint64_t dest_vec_idx = 0;
-    stride = (stride == UINT64_MAX) ? 1 : stride;
-    for (auto cell_idx = cs.start_; dest_vec_idx < cs.length_;
-         cell_idx += stride, dest_vec_idx++) {
-      // Get size of variable-sized cell
-      uint64_t cell_var_size = 0;
-      if (cs.tile_ == nullptr) {
-        cell_var_size = fill_size;
-      } else {
-        cell_var_size =
-            (cell_idx != tile_cell_num - 1) ?
-                tile_offsets[cell_idx + 1] - tile_offsets[cell_idx] :
-                tile_var_size - (tile_offsets[cell_idx] - tile_offsets[0]);
-      }
-
-      // Record destination offsets.
-      (*offset_offsets_per_cs)[cs_idx][dest_vec_idx] = *total_offset_size;
-      (*var_offsets_per_cs)[cs_idx][dest_vec_idx] = *total_var_size;
-      *total_offset_size += offset_size;
-      *total_var_size += cell_var_size;
+    const auto tile_pair = cs.tile_->tile_pair(name);
+    auto tile_offsets = (const uint64_t*)tile_pair->first.internal_data();
+    auto tile_cell_num = tile_pair->first.cell_num();
+    auto tile_var_size = tile_pair->second.size();
+    auto end_offset = [&](uint64_t cell_idx) {
+      return (cell_idx + 1 != tile_cell_num) ?
+                 tile_offsets[cell_idx + 1] - tile_offsets[0] :
+                 tile_var_size;
+    };
+
+    if (stride == UINT64_MAX) {
+      var_size = end_offset(cs.start_ + cs.length_ - 1) -
+                 (tile_offsets[cs.start_] - tile_offsets[0]);
+    } else {
+      var_size = 0;
+      uint64_t cell_idx = cs.start_;
+      for (uint64_t i = 0; i < cs.length_; ++i, cell_idx += stride)
+        var_size +=
+            end_offset(cell_idx) - (tile_offsets[cell_idx] - tile_offsets[0]);
     }
-  }
+
+    return Status::Ok();
+  });
+  for (auto st : statuses)
+    RETURN_NOT_OK(st);
+
+  // Turn the sizes into destinations with prefix sums
+  cs_offsets->resize(num_cs);
+  for (uint64_t cs_idx = 0; cs_idx < num_cs; cs_idx++)
+    (*cs_offsets)[cs_idx] = result_cell_slabs[cs_idx].length_ * offset_size;
+  *total_offset_size = var_offsets::prefix_sum(cs_offsets->data(), num_cs);
+  *total_var_size = var_offsets::prefix_sum(cs_var_offsets->data(), num_cs);
+  if (offsets_extra_element_)
+    *total_offset_size += offset_size;
 
   return Status::Ok();
 }
 
 template <class T>
-void Reader::compute_result_space_tiles(
-    const Subarray& subarray,
-    std::map<const T*, ResultSpaceTile<T>>* result_space_tiles) const {
+void Reader::compute_frag_tile_domains(
+    std::vector<TileDomain<T>>* frag_tile_domains) const {
   // For easy reference
   auto dim_num = array_schema_->dim_num();
   auto domain = (const T*)array_schema_->domain()->domain();
   auto tile_extents = (const T*)array_schema_->domain()->tile_extents();
   auto tile_order = array_schema_->tile_order();
 
-  // Compute fragment tile domains
-  std::vector<TileDomain<T>> frag_tile_domains;
   auto fragment_num = (int)fragment_metadata_.size();
   if (fragment_num > 0) {
     for (int i = fragment_num - 1; i >= 0; --i) {
       if (fragment_metadata_[i]->dense()) {
         auto non_empty_domain =
             (const T*)fragment_metadata_[i]->non_empty_domain();
-        frag_tile_domains.emplace_back(
+        frag_tile_domains->emplace_back(
             i, dim_num, domain, non_empty_domain, tile_extents, tile_order);
       }
     }
   }
+}
+
+template <class T>
+void Reader::compute_result_space_tiles(
+    const Subarray& subarray,
+    std::map<const T*, ResultSpaceTile<T>>* result_space_tiles) const {
+  // For easy reference
+  auto dim_num = array_schema_->dim_num();
+  auto domain = (const T*)array_schema_->domain()->domain();
+  auto tile_extents = (const T*)array_schema_->domain()->tile_extents();
+  auto tile_order = array_schema_->tile_order();
+
+  // Compute fragment tile domains
+  std::vector<TileDomain<T>> frag_tile_domains;
+  compute_frag_tile_domains<T>(&frag_tile_domains);
 
   // Get tile coords and array domain
   const auto& tile_coords = subarray.tile_coords();
@@ -1177,7 +2200,8 @@ void Reader::compute_result_cell_slabs(
   auto layout = subarray.layout();
   if (layout == Layout::ROW_MAJOR || layout == Layout::COL_MAJOR) {
     uint64_t result_coords_pos = 0;
-    std::set<std::pair<unsigned, uint64_t>> frag_tile_set;
+    ArenaAllocator<FragTilePair> alloc(&arena_);
+    FragTileSet frag_tile_set(alloc);
     compute_result_cell_slabs_row_col<T>(
         subarray,
         result_space_tiles,
@@ -1205,7 +2229,7 @@ void Reader::compute_result_cell_slabs_row_col(
     std::vector<ResultCoords>* result_coords,
     uint64_t* result_coords_pos,
     std::vector<ResultTile*>* result_tiles,
-    std::set<std::pair<unsigned, uint64_t>>* frag_tile_set,
+    FragTileSet* frag_tile_set,
     std::vector<ResultCellSlab>* result_cell_slabs) const {
   // Compute result space tiles. The result space tiles hold all the
   // relevant result tiles of the dense fragments
@@ -1217,22 +2241,12 @@ void Reader::compute_result_cell_slabs_row_col(
   // or in `result_space_tiles` (dense).
   auto rcs_it = ReadCellSlabIter<T>(
       &subarray, result_space_tiles, result_coords, *result_coords_pos);
-  for (rcs_it.begin(); !rcs_it.end(); ++rcs_it) {
-    // Add result cell slab
-    auto result_cell_slab = rcs_it.result_cell_slab();
-    result_cell_slabs->push_back(result_cell_slab);
-    // Add result tile
-    if (result_cell_slab.tile_ != nullptr) {
-      auto frag_idx = result_cell_slab.tile_->frag_idx();
-      auto tile_idx = result_cell_slab.tile_->tile_idx();
-      auto frag_tile_pair = std::pair<unsigned, uint64_t>(frag_idx, tile_idx);
-      auto it = frag_tile_set->find(frag_tile_pair);
-      if (it == frag_tile_set->end()) {
-        frag_tile_set->insert(frag_tile_pair);
-        result_tiles->push_back(result_cell_slab.tile_);
-      }
-    }
-  }
+  for (rcs_it.begin(); !rcs_it.end(); ++rcs_it)
+    add_result_cell_slab(
+        rcs_it.result_cell_slab(),
+        result_tiles,
+        frag_tile_set,
+        result_cell_slabs);
   *result_coords_pos = rcs_it.result_coords_pos();
 }
 
@@ -1243,27 +2257,83 @@ void Reader::compute_result_cell_slabs_global(
     std::vector<ResultCoords>* result_coords,
     std::vector<ResultTile*>* result_tiles,
     std::vector<ResultCellSlab>* result_cell_slabs) const {
+  // For easy reference
   const auto& tile_coords = subarray.tile_coords();
+  auto tile_num = tile_coords.size();
   auto cell_order = array_schema_->cell_order();
-  std::vector<Subarray> tile_subarrays;
-  tile_subarrays.reserve(tile_coords.size());
-  uint64_t result_coords_pos = 0;
-  std::set<std::pair<unsigned, uint64_t>> frag_tile_set;
+  auto tile_order = array_schema_->tile_order();
+  auto dim_num = array_schema_->dim_num();
+  auto domain = (const T*)array_schema_->domain()->domain();
+  auto tile_extents = (const T*)array_schema_->domain()->tile_extents();
 
-  for (const auto& tc : tile_coords) {
-    tile_subarrays.emplace_back(
-        subarray.crop_to_tile((const T*)&tc[0], cell_order));
-    auto& tile_subarray = tile_subarrays.back();
+  std::vector<TileDomain<T>> frag_tile_domains;
+  compute_frag_tile_domains<T>(&frag_tile_domains);
+  TileDomain<T> array_tile_domain(
+      UINT32_MAX, dim_num, domain, domain, tile_extents, tile_order);
+
+  // Crop the subarray to each space tile and compute the result space
+  // tile concurrently
+  std::vector<Subarray> tile_subarrays(tile_num);
+  std::vector<ResultSpaceTile<T>> space_tiles(tile_num);
+  parallel_for(0, tile_num, [&](uint64_t t) {
+    auto& tile_subarray = tile_subarrays[t];
+    tile_subarray =
+        subarray.crop_to_tile((const T*)&tile_coords[t][0], cell_order);
     tile_subarray.template compute_tile_coords<T>();
+    compute_result_space_tile<T>(
+        array_schema_->domain(),
+        (const T*)&tile_subarray.tile_coords()[0][0],
+        array_tile_domain,
+        frag_tile_domains,
+        &space_tiles[t]);
+    return Status::Ok();
+  });
 
-    compute_result_cell_slabs_row_col<T>(
-        tile_subarray,
+  // The result cell slab iterators look up the space tiles by the tile
+  // coordinates of the cropped subarrays. The map is only read below.
+  for (uint64_t t = 0; t < tile_num; ++t)
+    result_space_tiles->emplace(
+        (const T*)&tile_subarrays[t].tile_coords()[0][0],
+        std::move(space_tiles[t]));
+
+  // The result coordinates are sorted in the global order, so those of
+  // each space tile follow the ones of the previous space tile
+  std::vector<uint64_t> result_coords_pos(tile_num);
+  uint64_t pos = 0;
+  for (uint64_t t = 0; t < tile_num; ++t) {
+    result_coords_pos[t] = pos;
+    auto tc = (const T*)&tile_coords[t][0];
+    for (; pos < result_coords->size(); ++pos) {
+      bool in_tile = true;
+      for (unsigned d = 0; d < dim_num && in_tile; ++d) {
+        auto coord = *(const T*)(*result_coords)[pos].coord(d);
+        in_tile = (T)((coord - domain[2 * d]) / tile_extents[d]) == tc[d];
+      }
+      if (!in_tile)
+        break;
+    }
+  }
+
+  // Compute the result cell slabs of each space tile concurrently
+  std::vector<std::vector<ResultCellSlab>> tile_result_cell_slabs(tile_num);
+  parallel_for(0, tile_num, [&](uint64_t t) {
+    auto rcs_it = ReadCellSlabIter<T>(
+        &tile_subarrays[t],
         result_space_tiles,
         result_coords,
-        &result_coords_pos,
-        result_tiles,
-        &frag_tile_set,
-        result_cell_slabs);
+        result_coords_pos[t]);
+    for (rcs_it.begin(); !rcs_it.end(); ++rcs_it)
+      tile_result_cell_slabs[t].push_back(rcs_it.result_cell_slab());
+    return Status::Ok();
+  });
+
+  // Concatenate the result cell slabs in the space tile order
+  ArenaAllocator<FragTilePair> alloc(&arena_);
+  FragTileSet frag_tile_set(alloc);
+  for (const auto& slabs : tile_result_cell_slabs) {
+    for (const auto& result_cell_slab : slabs)
+      add_result_cell_slab(
+          result_cell_slab, result_tiles, &frag_tile_set, result_cell_slabs);
   }
 }
 
@@ -1273,23 +2343,51 @@ Status Reader::compute_result_coords(
     std::vector<ResultTile>* result_tiles,
     std::vector<ResultCoords>* result_coords) {
   // Get overlapping tile indexes
-  typedef std::pair<unsigned, uint64_t> FragTilePair;
-  std::map<FragTilePair, size_t> result_tile_map;
-  std::vector<bool> single_fragment;
+  ArenaAllocator<FragTilePair> alloc(&arena_);
+  ResultTileMap result_tile_map(alloc);
+  auto& single_fragment = single_fragment_;
 
   // TODO: remove template
   RETURN_CANCEL_OR_ERROR(compute_sparse_result_tiles<T>(
-      result_tiles, &result_tile_map, &single_fragment));
+      read_state_.partitioner_.current(),
+      result_tiles,
+      &result_tile_map,
+      &single_fragment,
+      &free_result_tiles_,
+      &sample_skipped_cell_num_));
+  if (sample_fraction_ < 1.0) {
+    for (const auto& result_tile : *result_tiles)
+      sample_cell_num_ += fragment_metadata_[result_tile.frag_idx()]->cell_num(
+          result_tile.tile_idx());
+  }
 
   if (result_tiles->empty())
     return Status::Ok();
 
+  // Find the dimensions whose coordinates are not needed
+  compute_skipped_dims<T>(single_fragment);
+  auto read_dim = [this](unsigned d) {
+    return skipped_dims_.empty() || !skipped_dims_[d];
+  };
+
   // Create temporary vector with pointers to result tiles, so that
   // `read_tiles`, `filter_tiles` below can work without changes
-  std::vector<ResultTile*> tmp_result_tiles;
+  auto& tmp_result_tiles = coord_result_tiles_;
+  tmp_result_tiles.clear();
   for (auto& result_tile : *result_tiles)
     tmp_result_tiles.push_back(&result_tile);
 
+  // Charge the coordinate tiles against the memory budget
+  auto dim_num = array_schema_->dim_num();
+  RETURN_NOT_OK(charge_tile_memory(constants::coords, tmp_result_tiles));
+  for (unsigned d = 0; d < dim_num; ++d) {
+    const auto& dim_name = array_schema_->dimension(d)->name();
+    if (read_dim(d))
+      RETURN_NOT_OK(charge_tile_memory(dim_name, tmp_result_tiles));
+  }
+  if (read_state_.overflowed_)
+    return Status::Ok();
+
   // Read and filter coordinate tiles
   // NOTE: these will ignore tiles of fragments with format version >=5
   RETURN_CANCEL_OR_ERROR(read_tiles(constants::coords, tmp_result_tiles));
@@ -1297,15 +2395,21 @@ Status Reader::compute_result_coords(
 
   // Read and filter coordinate tiles
   // NOTE: these will ignore tiles of fragments with format version <5
-  auto dim_num = array_schema_->dim_num();
   for (unsigned d = 0; d < dim_num; ++d) {
+    if (!read_dim(d)) {
+      STATS_COUNTER_ADD(reader_num_dim_tile_reads_skipped, 1);
+      continue;
+    }
     const auto& dim_name = array_schema_->dimension(d)->name();
     RETURN_CANCEL_OR_ERROR(read_tiles(dim_name, tmp_result_tiles));
     RETURN_CANCEL_OR_ERROR(filter_tiles(dim_name, tmp_result_tiles));
   }
 
-  // Compute the read coordinates for all fragments for each subarray range
-  std::vector<std::vector<ResultCoords>> range_result_coords;
+  // Compute the read coordinates for all fragments for each subarray range.
+  // The range vectors keep their memory from the previous partition.
+  auto& range_result_coords = range_result_coords_;
+  for (auto& coords : range_result_coords)
+    coords.clear();
   RETURN_CANCEL_OR_ERROR(compute_range_result_coords<T>(
       single_fragment, result_tile_map, result_tiles, &range_result_coords));
   result_tile_map.clear();
@@ -1313,11 +2417,66 @@ Status Reader::compute_result_coords(
   // Compute final coords (sorted in the result layout) of the whole subarray.
   RETURN_CANCEL_OR_ERROR(
       compute_subarray_coords(&range_result_coords, result_coords));
-  range_result_coords.clear();
+  for (auto& coords : range_result_coords)
+    coords.clear();
 
   return Status::Ok();
 }
 
+template <class T>
+void Reader::compute_skipped_dims(const std::vector<bool>& single_fragment) {
+  skipped_dims_.clear();
+
+  // The coordinates are needed to sort, deduplicate, check the cells
+  // overwritten by dense fragments, or if they are queried
+  if (array_schema_->dense() || layout_ != Layout::UNORDERED ||
+      has_coords())
+    return;
+  for (auto single : single_fragment) {
+    if (!single)
+      return;
+  }
+
+  const auto& subarray = read_state_.partitioner_.current();
+  const auto& condition_names = condition_.field_names();
+  auto dim_num = array_schema_->dim_num();
+  std::vector<uint8_t> skipped(dim_num, 0);
+  unsigned skipped_num = 0;
+  for (unsigned d = 0; d < dim_num; ++d) {
+    const auto& dim_name = array_schema_->dimension(d)->name();
+    if (attr_buffers_.count(dim_name) != 0 ||
+        condition_names.count(dim_name) != 0)
+      continue;
+
+    // The single range on the dimension must contain the non-empty
+    // domain of every fragment
+    uint64_t range_num = 0;
+    const void* range = nullptr;
+    if (!subarray.get_range_num(d, &range_num).ok() || range_num != 1 ||
+        !subarray.get_range(d, 0, &range).ok())
+      continue;
+    auto r = (const T*)range;
+    bool contained = true;
+    for (const auto& meta : fragment_metadata_) {
+      auto ned = (const T*)meta->non_empty_domain();
+      if (ned[2 * d] < r[0] || r[1] < ned[2 * d + 1]) {
+        contained = false;
+        break;
+      }
+    }
+    if (contained) {
+      skipped[d] = 1;
+      ++skipped_num;
+    }
+  }
+
+  // At least one dimension provides the cell number of each tile
+  if (skipped_num == dim_num)
+    skipped[0] = 0;
+  if (skipped_num != 0)
+    skipped_dims_.swap(skipped);
+}
+
 Status Reader::dedup_result_coords(
     std::vector<ResultCoords>* result_coords) const {
   STATS_FUNC_IN(reader_dedup_coords);
@@ -1342,28 +2501,270 @@ Status Reader::dedup_result_coords(
   STATS_FUNC_OUT(reader_dedup_coords);
 }
 
+template <class T>
+Status Reader::dedup_result_coords_unordered(
+    std::vector<ResultCoords>* result_coords) const {
+  STATS_FUNC_IN(reader_dedup_coords_unordered);
+
+  // Hash the coordinates
+  auto& coords = *result_coords;
+  auto coords_num = coords.size();
+  auto dim_num = array_schema_->dim_num();
+  std::vector<uint64_t> hashes(coords_num);
+  std::vector<T> c(dim_num);
+  for (uint64_t i = 0; i < coords_num; ++i) {
+    for (unsigned d = 0; d < dim_num; ++d)
+      c[d] = *(const T*)coords[i].coord(d);
+    hashes[i] = BloomFilter::hash_coords<T>(&c[0], dim_num);
+  }
+
+  // Partition the coordinates into shards on the high bits of their hashes,
+  // so that equal coordinates fall into the same shard
+  const unsigned shard_bits = 6;
+  std::vector<std::vector<uint64_t>> shards((size_t)1 << shard_bits);
+  for (uint64_t i = 0; i < coords_num; ++i)
+    shards[hashes[i] >> (64 - shard_bits)].push_back(i);
+
+  // Keep the coordinates of the latest fragment in each shard
+  auto statuses = parallel_for(0, shards.size(), [&](uint64_t s) {
+    auto hash = [&](uint64_t i) { return (size_t)hashes[i]; };
+    auto equal = [&](uint64_t a, uint64_t b) {
+      return coords[a].same_coords(coords[b]);
+    };
+    std::unordered_set<uint64_t, decltype(hash), decltype(equal)> latest(
+        shards[s].size(), hash, equal);
+    for (auto i : shards[s]) {
+      auto it = latest.find(i);
+      if (it == latest.end()) {
+        latest.insert(i);
+      } else if (
+          coords[*it].tile_->frag_idx() < coords[i].tile_->frag_idx()) {
+        coords[*it].invalidate();
+        latest.erase(it);
+        latest.insert(i);
+      } else {
+        coords[i].invalidate();
+      }
+    }
+    return Status::Ok();
+  });
+  for (const auto& st : statuses)
+    RETURN_NOT_OK(st);
+
+  return Status::Ok();
+
+  STATS_FUNC_OUT(reader_dedup_coords_unordered);
+}
+
+std::string Reader::empty_subarray_key(const Subarray& subarray) const {
+  // Fragments are sorted on timestamp and a handle sees all the fragments
+  // up to its timestamp, so their number and the last URI identify them
+  auto fragment_num = (uint64_t)fragment_metadata_.size();
+  std::string key((const char*)&fragment_num, sizeof(uint64_t));
+  key += last_fragment_uri().to_string();
+  auto dim_num = subarray.dim_num();
+  for (uint32_t d = 0; d < dim_num; ++d) {
+    const auto& buff = subarray.ranges_for_dim(d)->buffer_;
+    auto size = buff.size();
+    key.append((const char*)&size, sizeof(uint64_t));
+    key.append((const char*)buff.data(), size);
+  }
+  return key;
+}
+
+template <class T>
+Status Reader::aggregate_read() {
+  STATS_FUNC_IN(reader_aggregate_read);
+
+  // Sparse reads with only counts do not need the result coordinates,
+  // unless they are sampled
+  bool count_only = condition_.empty() && sample_fraction_ >= 1.0;
+  for (const auto& aggregate : aggregates_)
+    count_only = count_only && aggregate.op() == AggregateOp::AGGREGATE_COUNT;
+
+  // The first partition is already retrieved
+  if (!fragment_metadata_.empty()) {
+    do {
+      if (array_schema_->dense() && !sparse_mode_) {
+        RETURN_NOT_OK(dense_read<T>());
+      } else if (count_only) {
+        uint64_t cell_num = 0;
+        RETURN_NOT_OK(count_result_cells<T>(&cell_num));
+        for (auto& aggregate : aggregates_)
+          aggregate.add_cell_num(cell_num);
+      } else {
+        RETURN_NOT_OK(sparse_read<T>());
+      }
+
+      if (read_state_.done())
+        break;
+      RETURN_NOT_OK(read_state_.next());
+    } while (true);
+  }
+
+  for (const auto& aggregate : aggregates_)
+    aggregate.finalize();
+
+  return Status::Ok();
+
+  STATS_FUNC_OUT(reader_aggregate_read);
+}
+
+template <class T>
+Status Reader::count_result_cells(uint64_t* cell_num) {
+  STATS_FUNC_IN(reader_count_result_cells);
+
+  // Release the transient structures of the previous partition
+  arena_.reset();
+
+  // Get overlapping tile indexes
+  const auto& subarray = read_state_.partitioner_.current();
+  std::vector<ResultTile> result_tiles;
+  ArenaAllocator<FragTilePair> alloc(&arena_);
+  ResultTileMap result_tile_map(alloc);
+  std::vector<bool> single_fragment;
+  RETURN_CANCEL_OR_ERROR(compute_sparse_result_tiles<T>(
+      subarray, &result_tiles, &result_tile_map, &single_fragment));
+
+  // Find the fragments overlapping each range
+  const auto& overlap = subarray.tile_overlap();
+  auto range_num = subarray.range_num();
+  auto fragment_num = fragment_metadata_.size();
+  std::vector<std::vector<unsigned>> range_fragments(range_num);
+  for (uint64_t r = 0; r < range_num; ++r) {
+    for (unsigned f = 0; f < fragment_num; ++f) {
+      bool rejected = false;
+      RETURN_NOT_OK(coords_rejected<T>(f, subarray, r, &rejected));
+      if (!fragment_metadata_[f]->dense() && !rejected &&
+          (!overlap[f][r].tile_ranges_.empty() ||
+           !overlap[f][r].tiles_.empty()))
+        range_fragments[r].push_back(f);
+    }
+  }
+
+  // Find the tiles whose coordinates are needed: all the tiles of the
+  // ranges overlapping several fragments, whose cells are deduplicated,
+  // and the partially covered tiles of the other ranges
+  std::vector<bool> needed(result_tiles.size(), false);
+  for (uint64_t r = 0; r < range_num; ++r) {
+    bool dedup = range_fragments[r].size() > 1;
+    for (auto f : range_fragments[r]) {
+      if (dedup) {
+        for (const auto& tr : overlap[f][r].tile_ranges_) {
+          for (uint64_t t = tr.first; t <= tr.second; ++t)
+            needed[result_tile_map[std::make_pair(f, t)]] = true;
+        }
+      }
+      for (const auto& o_tile : overlap[f][r].tiles_) {
+        if (dedup || o_tile.second != 1.0)
+          needed[result_tile_map[std::make_pair(f, o_tile.first)]] = true;
+      }
+    }
+  }
+  std::vector<ResultTile*> tiles;
+  for (size_t i = 0; i < result_tiles.size(); ++i) {
+    if (needed[i])
+      tiles.push_back(&result_tiles[i]);
+  }
+  STATS_COUNTER_ADD(
+      reader_count_metadata_tiles, result_tiles.size() - tiles.size());
+
+  // Read and filter the needed coordinate tiles
+  RETURN_CANCEL_OR_ERROR(read_tiles(constants::coords, tiles));
+  RETURN_CANCEL_OR_ERROR(filter_tiles(constants::coords, tiles));
+  auto dim_num = array_schema_->dim_num();
+  for (unsigned d = 0; d < dim_num; ++d) {
+    const auto& dim_name = array_schema_->dimension(d)->name();
+    RETURN_CANCEL_OR_ERROR(read_tiles(dim_name, tiles));
+    RETURN_CANCEL_OR_ERROR(filter_tiles(dim_name, tiles));
+  }
+
+  // Count the result cells of each range
+  std::vector<uint64_t> range_cell_nums(range_num, 0);
+  auto statuses = parallel_for(0, range_num, [&](uint64_t r) {
+    auto& range_cell_num = range_cell_nums[r];
+
+    // Count the deduplicated coordinates
+    if (range_fragments[r].size() > 1) {
+      std::vector<ResultCoords> coords;
+      std::vector<uint64_t> runs;
+      RETURN_NOT_OK(compute_range_result_coords<T>(
+          r, result_tile_map, &result_tiles, &coords, &runs));
+      RETURN_NOT_OK(dedup_result_coords_unordered<T>(&coords));
+      for (const auto& c : coords)
+        range_cell_num += c.valid() ? 1 : 0;
+      return Status::Ok();
+    }
+
+    // Count the cells of the fully covered tiles from the fragment
+    // metadata, and check the coordinates of the partially covered ones
+    for (auto f : range_fragments[r]) {
+      const auto& meta = fragment_metadata_[f];
+      for (const auto& tr : overlap[f][r].tile_ranges_) {
+        for (uint64_t t = tr.first; t <= tr.second; ++t)
+          range_cell_num += meta->cell_num(t);
+      }
+      for (const auto& o_tile : overlap[f][r].tiles_) {
+        if (o_tile.second == 1.0) {
+          range_cell_num += meta->cell_num(o_tile.first);
+        } else {
+          auto tile_it = result_tile_map.find(std::make_pair(f, o_tile.first));
+          std::vector<ResultCoords> coords;
+          RETURN_NOT_OK(compute_range_result_coords(
+              f, &result_tiles[tile_it->second], subarray.range(r), &coords));
+          range_cell_num += coords.size();
+        }
+      }
+    }
+
+    return Status::Ok();
+  });
+  for (const auto& st : statuses)
+    RETURN_CANCEL_OR_ERROR(st);
+
+  *cell_num = 0;
+  for (auto n : range_cell_nums)
+    *cell_num += n;
+
+  return Status::Ok();
+
+  STATS_FUNC_OUT(reader_count_result_cells);
+}
+
 template <class T>
 Status Reader::dense_read() {
   STATS_FUNC_IN(reader_dense_read);
 
+  // Release the transient structures of the previous partition
+  arena_.reset();
+
   // Sanity checks
   assert(std::is_integral<T>::value);
   assert(!fragment_metadata_.empty());
 
+  // The scratch vectors keep their memory from the previous partition
+  auto& result_coords = result_coords_;
+  auto& sparse_result_tiles = sparse_result_tiles_;
+  auto& result_cell_slabs = result_cell_slabs_;
+  auto& result_tiles = result_tiles_;
+  result_coords.clear();
+  recycle_result_tiles();
+  result_cell_slabs.clear();
+  result_tiles.clear();
+  release_tile_memory();
+
   // Compute result coordinates from the sparse fragments
   // `sparse_result_tiles` will hold all the relevant result tiles of
   // sparse fragments
-  std::vector<ResultCoords> result_coords;
-  std::vector<ResultTile> sparse_result_tiles;
   RETURN_NOT_OK(compute_result_coords<T>(&sparse_result_tiles, &result_coords));
+  if (read_state_.overflowed_)
+    return Status::Ok();
 
   // Compute result cell slabs.
   // `result_space_tiles` will hold all the relevant result tiles of
   // dense fragments. `result` tiles will hold pointers to the
   // final result tiles for both sparse and dense fragments.
   std::map<const T*, ResultSpaceTile<T>> result_space_tiles;
-  std::vector<ResultCellSlab> result_cell_slabs;
-  std::vector<ResultTile*> result_tiles;
   auto& subarray = read_state_.partitioner_.current();
   subarray.compute_tile_coords<T>();
   compute_result_cell_slabs<T>(
@@ -1379,19 +2780,33 @@ Status Reader::dense_read() {
   // Needed when copying the cells
   auto stride = array_schema_->domain()->stride<T>(subarray.layout());
 
-  // Copy cells
-  for (const auto& attr : attributes_) {
-    if (read_state_.overflowed_)
-      break;
-    if (attr == constants::coords)
-      continue;
+  // Copy the contiguous cells of each tile at once
+  if (stride == UINT64_MAX)
+    coalesce_result_cell_slabs(&result_cell_slabs);
 
-    RETURN_CANCEL_OR_ERROR(read_tiles(attr, result_tiles));
-    RETURN_CANCEL_OR_ERROR(filter_tiles(attr, result_tiles));
-    RETURN_CANCEL_OR_ERROR(copy_cells(attr, stride, result_cell_slabs));
-    clear_tiles(attr, result_tiles);
+  // Keep only the cells that satisfy the query condition
+  RETURN_CANCEL_OR_ERROR(
+      apply_query_condition(stride, &result_tiles, &result_cell_slabs));
+  if (read_state_.overflowed_)
+    return Status::Ok();
+  const auto& condition_names = condition_.field_names();
+
+  // Aggregate the result cells instead of copying them
+  if (!aggregates_.empty()) {
+    RETURN_CANCEL_OR_ERROR(
+        compute_aggregates(stride, result_tiles, result_cell_slabs));
+    for (const auto& name : condition_names)
+      clear_tiles(name, result_tiles);
+    return Status::Ok();
   }
 
+  // Copy cells
+  if (!read_state_.overflowed_)
+    RETURN_NOT_OK(
+        copy_attribute_cells(stride, result_tiles, result_cell_slabs));
+  for (const auto& name : condition_names)
+    clear_tiles(name, result_tiles);
+
   // Fill coordinates if the user requested them
   if (!read_state_.overflowed_ && has_coords())
     RETURN_CANCEL_OR_ERROR(fill_dense_coords<T>(subarray));
@@ -1401,8 +2816,48 @@ Status Reader::dense_read() {
   STATS_FUNC_OUT(reader_dense_read);
 }
 
+void Reader::fill_cells(
+    unsigned char* dest,
+    const void* value,
+    uint64_t value_size,
+    uint64_t num) {
+  if (num == 0 || value_size == 0)
+    return;
+
+  auto bytes = static_cast<const unsigned char*>(value);
+  bool uniform = true;
+  for (uint64_t i = 1; i < value_size && uniform; ++i)
+    uniform = bytes[i] == bytes[0];
+  if (uniform) {
+    std::memset(dest, bytes[0], num * value_size);
+    return;
+  }
+
+  auto total = num * value_size;
+  std::memcpy(dest, value, value_size);
+  for (uint64_t filled = value_size; filled < total;) {
+    auto chunk = std::min(filled, total - filled);
+    std::memcpy(dest + filled, dest, chunk);
+    filled += chunk;
+  }
+}
+
 template <class T>
 Status Reader::fill_dense_coords(const Subarray& subarray) {
+  // Grow the managed coordinates buffer to fit all the cells
+  if (managed_buffers_.count(constants::coords) != 0) {
+    uint64_t cell_num = 0;
+    for (uint64_t r = 0; r < subarray.range_num(); ++r) {
+      auto range_cell_num = subarray.cell_num<T>(r);
+      cell_num = (range_cell_num > UINT64_MAX - cell_num) ?
+                     UINT64_MAX :
+                     cell_num + range_cell_num;
+    }
+    const auto coords_size = array_schema_->coords_size();
+    if (cell_num <= memory_budget_ / coords_size)
+      grow_managed_buffer(constants::coords, cell_num * coords_size, 0);
+  }
+
   // For easy reference
   uint64_t coords_buff_offset = 0;
   auto it = attr_buffers_.find(constants::coords);
@@ -1458,7 +2913,7 @@ Status Reader::fill_dense_coords_row_col(
   CellSlabIter<T> iter(&subarray);
   RETURN_CANCEL_OR_ERROR(iter.begin());
   while (!iter.end()) {
-    auto cell_slab = iter.cell_slab();
+    const auto& cell_slab = iter.cell_slab();
     auto coords_num = cell_slab.length_;
 
     // Check for overflow
@@ -1533,12 +2988,26 @@ void Reader::fill_dense_coords_col_slab(
 Status Reader::filter_tiles(
     const std::string& name,
     const std::vector<ResultTile*>& result_tiles) const {
+  return filter_tiles(name, result_tiles, {});
+}
+
+Status Reader::filter_tiles(
+    const std::string& name,
+    const std::vector<ResultTile*>& result_tiles,
+    const std::unordered_map<const ResultTile*, void*>& dests) const {
   STATS_FUNC_IN(reader_filter_tiles);
 
   auto var_size = array_schema_->var_size(name);
   auto num_tiles = static_cast<uint64_t>(result_tiles.size());
   auto encryption_key = array_->encryption_key();
 
+  // Collect the tiles to unfilter, with their destination and cache key. The
+  // fixed-sized (or offsets) tile of the i-th result tile goes to slot 2 * i
+  // and its var-sized tile to slot 2 * i + 1.
+  std::vector<Tile*> slot_tiles(2 * num_tiles, nullptr);
+  std::vector<std::pair<void*, uint64_t>> slot_dests(
+      2 * num_tiles, std::make_pair(nullptr, 0));
+  std::vector<TileCacheKey> slot_keys(2 * num_tiles);
   auto statuses = parallel_for(0, num_tiles, [&, this](uint64_t i) {
     auto& tile = result_tiles[i];
     auto& fragment = fragment_metadata_[tile->frag_idx()];
@@ -1557,32 +3026,35 @@ Status Reader::filter_tiles(
         return Status::Ok();
 
       // Get information about the tile in its fragment
-      auto tile_attr_uri = fragment->uri(name);
       auto tile_idx = tile->tile_idx();
-      uint64_t tile_attr_offset;
-      RETURN_NOT_OK(fragment->file_offset(
-          *encryption_key, name, tile_idx, &tile_attr_offset));
-
       auto& t = tile_pair->first;
       auto& t_var = tile_pair->second;
 
       if (!t.filtered()) {
-        // Decompress, etc.
-        RETURN_NOT_OK(filter_tile(name, &t, var_size));
-        RETURN_NOT_OK(storage_manager_->write_to_cache(
-            tile_attr_uri, tile_attr_offset, t.buffer()));
+        uint64_t tile_attr_offset;
+        RETURN_NOT_OK(fragment->file_offset(
+            *encryption_key, name, tile_idx, &tile_attr_offset));
+
+        // Decompress, etc., possibly into the result buffer
+        auto dest_it = dests.find(tile);
+        if (!var_size && dest_it != dests.end())
+          slot_dests[2 * i] = std::make_pair(
+              dest_it->second, fragment->cell_num(tile_idx) * t.cell_size());
+        slot_tiles[2 * i] = &t;
+        slot_keys[2 * i] = {
+            fragment->id(), fragment->file_id(name, false), tile_attr_offset};
       }
 
       if (var_size && !t_var.filtered()) {
-        auto tile_attr_var_uri = fragment->var_uri(name);
         uint64_t tile_attr_var_offset;
         RETURN_NOT_OK(fragment->file_var_offset(
             *encryption_key, name, tile_idx, &tile_attr_var_offset));
 
         // Decompress, etc.
-        RETURN_NOT_OK(filter_tile(name, &t_var, false));
-        RETURN_NOT_OK(storage_manager_->write_to_cache(
-            tile_attr_var_uri, tile_attr_var_offset, t_var.buffer()));
+        slot_tiles[2 * i + 1] = &t_var;
+        slot_keys[2 * i + 1] = {fragment->id(),
+                                fragment->file_id(name, true),
+                                tile_attr_var_offset};
       }
     }
 
@@ -1592,32 +3064,83 @@ Status Reader::filter_tiles(
   for (const auto& st : statuses)
     RETURN_CANCEL_OR_ERROR(st);
 
-  return Status::Ok();
-
-  STATS_FUNC_OUT(reader_filter_tiles);
-}
-
-Status Reader::filter_tile(
-    const std::string& name, Tile* tile, bool offsets) const {
-  uint64_t orig_size = tile->buffer()->size();
-
-  // Get a copy of the appropriate filter pipeline.
-  FilterPipeline filters =
-      (offsets ? *array_schema_->cell_var_offsets_filters() :
-                 *array_schema_->filters(name));
-
-  // Append an encryption filter when necessary.
+  // Get the filter pipelines, appending an encryption filter when necessary
+  FilterPipeline filters = *array_schema_->filters(name);
   RETURN_NOT_OK(FilterPipeline::append_encryption_filter(
       &filters, array_->get_encryption_key()));
+  FilterPipeline offsets_filters = *array_schema_->cell_var_offsets_filters();
+  RETURN_NOT_OK(FilterPipeline::append_encryption_filter(
+      &offsets_filters, array_->get_encryption_key()));
+
+  // Give each tile its own copy of the appropriate pipeline
+  std::vector<uint64_t> slots;
+  for (uint64_t s = 0; s < slot_tiles.size(); ++s) {
+    if (slot_tiles[s] != nullptr)
+      slots.push_back(s);
+  }
+  std::vector<FilterPipeline> pipelines;
+  pipelines.reserve(slots.size());
+  std::vector<const FilterPipeline*> pipeline_ptrs;
+  std::vector<Tile*> tiles;
+  std::vector<std::pair<void*, uint64_t>> tile_dests;
+  std::vector<uint64_t> orig_sizes;
+  std::vector<uint8_t> cache_filtered;
+  bool cache_filtered_attr =
+      storage_manager_->cache_filtered_tiles(array_schema_->filters(name));
+  bool cache_filtered_offsets = storage_manager_->cache_filtered_tiles(
+      array_schema_->cell_var_offsets_filters());
+  for (auto s : slots) {
+    bool offsets = var_size && s % 2 == 0;
+    pipelines.emplace_back(offsets ? offsets_filters : filters);
+    pipeline_ptrs.push_back(&pipelines.back());
+    tiles.push_back(slot_tiles[s]);
+    tile_dests.push_back(slot_dests[s]);
+    orig_sizes.push_back(slot_tiles[s]->buffer()->size());
+    cache_filtered.push_back(
+        offsets ? cache_filtered_offsets : cache_filtered_attr);
+  }
+
+  // Cache the filtered bytes of the tiles read from the fragments, for the
+  // pipelines whose tiles are cached in filtered form (see
+  // `sm.tile_cache_mode`)
+  statuses = parallel_for(0, slots.size(), [&, this](uint64_t i) {
+    auto tile = tiles[i];
+    if (!cache_filtered[i] || tile->cached_data() != nullptr ||
+        tile->buffer()->size() == 0)
+      return Status::Ok();
+    return storage_manager_->write_to_cache(
+        slot_keys[slots[i]], tile->buffer());
+  });
 
-  RETURN_NOT_OK(filters.run_reverse(tile));
+  for (const auto& st : statuses)
+    RETURN_CANCEL_OR_ERROR(st);
 
-  tile->set_filtered(true);
-  tile->set_pre_filtered_size(orig_size);
+  // Unfilter the chunks of all tiles together
+  RETURN_CANCEL_OR_ERROR(FilterPipeline::run_reverse(
+      pipeline_ptrs,
+      tiles,
+      tile_dests,
+      storage_manager_->cancellation_flag()));
+
+  statuses = parallel_for(0, slots.size(), [&, this](uint64_t i) {
+    auto tile = tiles[i];
+    tile->set_filtered(true);
+    tile->set_pre_filtered_size(orig_sizes[i]);
+    STATS_COUNTER_ADD(reader_num_bytes_after_filtering, tile->size());
+    RETURN_NOT_OK(
+        partition_tile_cache_.insert(slot_keys[slots[i]], tile->buffer()));
+    if (cache_filtered[i])
+      return Status::Ok();
+    return storage_manager_->write_to_cache(
+        slot_keys[slots[i]], tile->buffer());
+  });
 
-  STATS_COUNTER_ADD(reader_num_bytes_after_filtering, tile->size());
+  for (const auto& st : statuses)
+    RETURN_CANCEL_OR_ERROR(st);
 
   return Status::Ok();
+
+  STATS_FUNC_OUT(reader_filter_tiles);
 }
 
 Status Reader::get_all_result_coords(
@@ -1629,6 +3152,47 @@ Status Reader::get_all_result_coords(
   return Status::Ok();
 }
 
+bool Reader::grow_managed_buffer(
+    const std::string& name, uint64_t size, uint64_t var_size) {
+  auto it = managed_buffers_.find(name);
+  if (it == managed_buffers_.end() || size > memory_budget_ ||
+      var_size > memory_budget_var_)
+    return false;
+
+  // Grow geometrically, so that a run of growing partitions reallocates
+  // only a few times
+  auto grow = [](std::unique_ptr<uint8_t[]>* buffer,
+                 uint64_t* capacity,
+                 uint64_t size,
+                 uint64_t budget) {
+    if (size <= *capacity)
+      return false;
+    *capacity = std::min(budget, std::max(size, 2 * *capacity));
+    buffer->reset(new uint8_t[*capacity]);
+    return true;
+  };
+  auto& managed = it->second;
+  bool grown = grow(&managed.buffer_, &managed.capacity_, size, memory_budget_);
+  grown |= grow(
+      &managed.buffer_var_,
+      &managed.capacity_var_,
+      var_size,
+      memory_budget_var_);
+  STATS_COUNTER_ADD_IF(grown, reader_managed_buffer_growths, 1);
+
+  auto& query_buffer = attr_buffers_[name];
+  query_buffer.buffer_ = managed.buffer_.get();
+  query_buffer.original_buffer_size_ = managed.capacity_;
+  *query_buffer.buffer_size_ = managed.capacity_;
+  if (query_buffer.buffer_var_size_ != nullptr) {
+    query_buffer.buffer_var_ = managed.buffer_var_.get();
+    query_buffer.original_buffer_var_size_ = managed.capacity_var_;
+    *query_buffer.buffer_var_size_ = managed.capacity_var_;
+  }
+
+  return true;
+}
+
 bool Reader::has_coords() const {
   return attr_buffers_.find(constants::coords) != attr_buffers_.end();
 }
@@ -1640,45 +3204,179 @@ Status Reader::init_read_state() {
         Status::ReaderError("Cannot initialize read state; Multi-range "
                             "subarrays do not support global order"));
 
-  // Get config
-  bool found = false;
-  auto config = storage_manager_->config();
-  uint64_t memory_budget = 0;
-  RETURN_NOT_OK(
-      config.get<uint64_t>("sm.memory_budget", &memory_budget, &found));
-  assert(found);
-  uint64_t memory_budget_var = 0;
-  RETURN_NOT_OK(
-      config.get<uint64_t>("sm.memory_budget_var", &memory_budget_var, &found));
-  assert(found);
+  // The results of sparse reads are sorted on the coordinates (or are
+  // unordered) regardless of the range order, so their ranges are sorted
+  // and coalesced, which lets each tile be checked against all the ranges
+  // at once
+  Subarray subarray = subarray_;
+  if (!array_schema_->dense())
+    RETURN_NOT_OK(subarray.normalize_ranges());
+  if (plan_read_)
+    RETURN_NOT_OK(plan_read(&subarray));
 
   // Create read state
   read_state_.partitioner_ =
-      SubarrayPartitioner(subarray_, memory_budget, memory_budget_var);
+      SubarrayPartitioner(subarray, memory_budget_, memory_budget_var_);
   read_state_.overflowed_ = false;
   read_state_.unsplittable_ = false;
+  read_state_.resume_current_ = false;
 
   // Set result size budget
   for (const auto& a : attr_buffers_) {
     auto attr_name = a.first;
     auto buffer_size = a.second.buffer_size_;
     auto buffer_var_size = a.second.buffer_var_size_;
-    if (!array_schema_->var_size(a.first)) {
+    if (managed_buffers_.count(attr_name) != 0) {
+      // Managed buffers grow up to the memory budget
+      if (!array_schema_->var_size(a.first))
+        RETURN_NOT_OK(read_state_.partitioner_.set_result_budget(
+            attr_name.c_str(), memory_budget_));
+      else
+        RETURN_NOT_OK(read_state_.partitioner_.set_result_budget(
+            attr_name.c_str(), memory_budget_, memory_budget_var_));
+    } else if (!array_schema_->var_size(a.first)) {
       RETURN_NOT_OK(read_state_.partitioner_.set_result_budget(
           attr_name.c_str(), *buffer_size));
     } else {
+      // The partitioner budgets one 64-bit offset per result cell
+      const uint64_t offset_size = offsets_bitsize_ / 8;
+      uint64_t offsets_budget = *buffer_size;
+      if (offsets_extra_element_)
+        offsets_budget -= std::min(offsets_budget, offset_size);
+      offsets_budget =
+          offsets_budget / offset_size * constants::cell_var_offset_size;
       RETURN_NOT_OK(read_state_.partitioner_.set_result_budget(
-          attr_name.c_str(), *buffer_size, *buffer_var_size));
+          attr_name.c_str(), offsets_budget, *buffer_var_size));
     }
   }
 
+  // The partitions of aggregate queries are bounded only by the memory
+  // budget, which is checked on the attributes with a result budget
+  for (const auto& aggregate : aggregates_) {
+    if (aggregate.op() != AggregateOp::AGGREGATE_COUNT)
+      RETURN_NOT_OK(read_state_.partitioner_.set_result_budget(
+          aggregate.field_name().c_str(), UINT64_MAX));
+  }
+
   // Set memory budget
   RETURN_NOT_OK(read_state_.partitioner_.set_memory_budget(
       memory_budget_, memory_budget_var_));
+  RETURN_NOT_OK(
+      read_state_.partitioner_.set_balanced_splits(balanced_splits_));
 
   read_state_.unsplittable_ = false;
   read_state_.overflowed_ = false;
+  read_state_.resume_current_ = false;
   read_state_.initialized_ = true;
+  result_cell_num_ = 0;
+  sample_cell_num_ = 0;
+  sample_skipped_cell_num_ = 0;
+
+  return Status::Ok();
+}
+
+Status Reader::plan_read(Subarray* subarray) {
+  plan_value_indexes_.clear();
+  if (fragment_metadata_.empty())
+    return Status::Ok();
+  RETURN_NOT_OK(subarray->compute_tile_overlap());
+
+  // The number of partitions is estimated from the result size of each
+  // attribute against its budget
+  uint64_t partition_num = 1;
+  auto add_estimate = [&](uint64_t size, uint64_t budget) {
+    if (budget != 0)
+      partition_num = std::max(partition_num, utils::math::ceil(size, budget));
+  };
+  for (const auto& a : attr_buffers_) {
+    const auto& name = a.first;
+    const bool managed = managed_buffers_.count(name) != 0;
+    if (!array_schema_->var_size(name)) {
+      uint64_t size = 0;
+      RETURN_NOT_OK(subarray->get_est_result_size(name.c_str(), &size));
+      add_estimate(size, managed ? memory_budget_ : *a.second.buffer_size_);
+      add_estimate(size, memory_budget_);
+    } else {
+      uint64_t size_off = 0, size_val = 0;
+      RETURN_NOT_OK(
+          subarray->get_est_result_size(name.c_str(), &size_off, &size_val));
+      add_estimate(
+          size_off, managed ? memory_budget_ : *a.second.buffer_size_);
+      add_estimate(
+          size_val, managed ? memory_budget_var_ : *a.second.buffer_var_size_);
+      add_estimate(size_off, memory_budget_);
+      add_estimate(size_val, memory_budget_var_);
+    }
+  }
+
+  // Prefetching and balanced splits pay off only across partitions. The
+  // midpoint of a single range may leave most results on one side.
+  uint64_t tile_cache_size = 0;
+  bool found = false;
+  RETURN_NOT_OK(storage_manager_->config().get<uint64_t>(
+      "sm.tile_cache_size", &tile_cache_size, &found));
+  assert(found);
+  prefetch_ = partition_num > 1 && tile_cache_size > 0;
+  balanced_splits_ = partition_num > 1 && subarray->range_num() == 1;
+
+  // Looking up the value index of a fragment reads at least one tile id per
+  // tile, which pays off only if the condition tiles it may skip are
+  // larger. Otherwise the tiles are selected on their minimum and maximum
+  // values only.
+  uint64_t index_num = 0, scan_num = 0;
+  const auto& tile_overlap = subarray->tile_overlap();
+  if (!condition_.empty() && tile_overlap.size() == fragment_metadata_.size()) {
+    auto encryption_key = array_->encryption_key();
+    plan_value_indexes_.assign(fragment_metadata_.size(), false);
+    for (size_t f = 0; f < fragment_metadata_.size(); ++f) {
+      auto meta = fragment_metadata_[f];
+      std::vector<std::string> names;
+      for (const auto& name : condition_.field_names()) {
+        if (meta->has_value_index(name))
+          names.push_back(name);
+      }
+      if (names.empty())
+        continue;
+
+      const uint64_t index_cost =
+          names.size() * meta->tile_num() * sizeof(uint64_t);
+      uint64_t scan_cost = 0;
+      auto add_tile = [&](uint64_t tile_idx) {
+        for (const auto& name : names) {
+          uint64_t size = 0;
+          RETURN_NOT_OK(meta->persisted_tile_size(
+              *encryption_key, name, tile_idx, &size));
+          scan_cost += size;
+        }
+        return Status::Ok();
+      };
+      for (const auto& overlap : tile_overlap[f]) {
+        for (const auto& r : overlap.tile_ranges_) {
+          for (uint64_t t = r.first; t <= r.second && scan_cost <= index_cost;
+               ++t)
+            RETURN_NOT_OK(add_tile(t));
+        }
+        for (const auto& t : overlap.tiles_) {
+          if (scan_cost > index_cost)
+            break;
+          RETURN_NOT_OK(add_tile(t.first));
+        }
+      }
+
+      plan_value_indexes_[f] = scan_cost > index_cost;
+      if (plan_value_indexes_[f])
+        ++index_num;
+      else
+        ++scan_num;
+    }
+  }
+
+  STATS_COUNTER_ADD(reader_plan_num, 1);
+  STATS_COUNTER_ADD(reader_plan_index_fragments, index_num);
+  STATS_COUNTER_ADD(reader_plan_scan_fragments, scan_num);
+  STATS_COUNTER_ADD(reader_plan_prefetch, prefetch_ ? 1 : 0);
+  STATS_COUNTER_ADD(reader_plan_balanced_splits, balanced_splits_ ? 1 : 0);
+  STATS_COUNTER_ADD(reader_plan_est_partitions, partition_num);
 
   return Status::Ok();
 }
@@ -1728,142 +3426,444 @@ Status Reader::init_tile(
   return Status::Ok();
 }
 
+Status Reader::copy_attribute_cells(
+    uint64_t stride,
+    const std::vector<ResultTile*>& result_tiles,
+    const std::vector<ResultCellSlab>& result_cell_slabs) {
+  // The tiles of the query condition attributes are already loaded
+  const auto& condition_names = condition_.field_names();
+  std::vector<std::string> names;
+  for (const auto& attr : attributes_) {
+    if (attr != constants::coords && condition_names.count(attr) == 0)
+      names.push_back(attr);
+  }
+
+  // The tiles of the next attribute are fetched while the tiles of the
+  // current one are unfiltered and copied, as long as both fit in the
+  // memory budget. At most one fetch is in flight at a time.
+  std::vector<std::future<Status>> tasks;
+  std::vector<std::pair<URI, std::tuple<uint64_t, void*, uint64_t>>>
+      disk_cache_misses;
+  size_t fetched = names.size();
+  Status st;
+
+  // The tiles of co-located fragments are fetched for all attributes at
+  // once if they fit in the memory budget, so that the tiles with the same
+  // index are read with a single request
+  bool all_fetched = false;
+  if (array_schema_->tile_colocation() && names.size() > 1)
+    RETURN_NOT_OK(fetch_all_tiles(
+        names, result_tiles, &tasks, &disk_cache_misses, &all_fetched));
+
+  for (size_t i = 0; i < names.size(); ++i) {
+    const auto& name = names[i];
+
+    // Fetch the tiles, unless they are already in flight
+    if (fetched != i && !all_fetched) {
+      st = charge_tile_memory(name, result_tiles);
+      if (!st.ok() || read_state_.overflowed_)
+        break;
+      st = read_tiles({name}, result_tiles, &tasks, &disk_cache_misses);
+      if (!st.ok())
+        break;
+    }
+    st = wait_read_tiles(&tasks, &disk_cache_misses);
+    if (!st.ok())
+      break;
+
+    // Start fetching the tiles of the next attribute
+    fetched = names.size();
+    if (!all_fetched && i + 1 < names.size()) {
+      uint64_t size_fixed = 0, size_var = 0;
+      st = compute_tile_memory(
+          names[i + 1], result_tiles, &size_fixed, &size_var);
+      if (!st.ok())
+        break;
+      if (tile_memory_fixed_ + size_fixed <= memory_budget_ &&
+          tile_memory_var_ + size_var <= memory_budget_var_) {
+        add_tile_memory(names[i + 1], size_fixed, size_var);
+        st = read_tiles(
+            {names[i + 1]}, result_tiles, &tasks, &disk_cache_misses);
+        if (!st.ok())
+          break;
+        fetched = i + 1;
+        STATS_COUNTER_ADD(reader_num_tile_fetches_overlapped, 1);
+      }
+    }
+
+    st = filter_and_copy_cells(name, stride, result_tiles, result_cell_slabs);
+    if (!st.ok())
+      break;
+    clear_tiles(name, result_tiles);
+    if (read_state_.overflowed_)
+      break;
+  }
+
+  // The tiles of a fetch still in flight must not be released before the
+  // fetch completes
+  if (!tasks.empty())
+    storage_manager_->reader_thread_pool()->wait_all_status(tasks);
+  RETURN_CANCEL_OR_ERROR(st);
+
+  // Copy the cells of the query condition attributes
+  for (const auto& attr : attributes_) {
+    if (read_state_.overflowed_)
+      break;
+    if (condition_names.count(attr) != 0)
+      RETURN_CANCEL_OR_ERROR(copy_cells(attr, stride, result_cell_slabs));
+  }
+
+  return Status::Ok();
+}
+
+Status Reader::filter_and_copy_cells(
+    const std::string& name,
+    uint64_t stride,
+    const std::vector<ResultTile*>& result_tiles,
+    const std::vector<ResultCellSlab>& result_cell_slabs) {
+  // Find the slabs covering a full tile that is not unfiltered yet, so that
+  // the tile can be unfiltered directly into its place in the result buffer
+  std::unordered_map<const ResultTile*, void*> dests;
+  if (stride == UINT64_MAX && name != constants::coords &&
+      !array_schema_->is_dim(name) && !array_schema_->var_size(name)) {
+    auto cell_size = array_schema_->cell_size(name);
+
+    // Grow the managed buffers first, so that the tiles are unfiltered
+    // into their final place
+    if (managed_buffers_.count(name) != 0) {
+      uint64_t total_size = 0;
+      for (const auto& cs : result_cell_slabs)
+        total_size += cs.length_ * cell_size;
+      if (total_size > *attr_buffers_[name].buffer_size_)
+        grow_managed_buffer(name, total_size, 0);
+    }
+
+    const auto& query_buffer = attr_buffers_.find(name)->second;
+    auto buffer = (unsigned char*)query_buffer.buffer_;
+    auto buffer_size = *query_buffer.buffer_size_;
+    uint64_t offset = 0;
+    for (const auto& cs : result_cell_slabs) {
+      auto bytes = cs.length_ * cell_size;
+      if (cs.tile_ != nullptr && cs.start_ == 0 &&
+          offset + bytes <= buffer_size) {
+        auto tile_pair = cs.tile_->tile_pair(name);
+        const auto& meta = fragment_metadata_[cs.tile_->frag_idx()];
+        if (tile_pair != nullptr && !tile_pair->first.empty() &&
+            !tile_pair->first.filtered() &&
+            cs.length_ == meta->cell_num(cs.tile_->tile_idx()))
+          dests.emplace(cs.tile_, buffer + offset);
+      }
+      offset += bytes;
+    }
+
+    // The copy will overflow, nothing will be written to the buffer
+    if (offset > buffer_size)
+      dests.clear();
+  }
+
+  RETURN_CANCEL_OR_ERROR(filter_tiles(name, result_tiles, dests));
+  STATS_COUNTER_ADD(reader_num_tiles_unfiltered_in_place, dests.size());
+
+  if (dests.empty())
+    return copy_cells(name, stride, result_cell_slabs);
+  return copy_fixed_cells(name, stride, result_cell_slabs, dests);
+}
+
+Status Reader::fetch_all_tiles(
+    const std::vector<std::string>& names,
+    const std::vector<ResultTile*>& result_tiles,
+    std::vector<std::future<Status>>* tasks,
+    std::vector<std::pair<URI, std::tuple<uint64_t, void*, uint64_t>>>*
+        disk_cache_misses,
+    bool* fetched) {
+  *fetched = false;
+
+  std::vector<std::pair<uint64_t, uint64_t>> sizes(names.size());
+  uint64_t total_fixed = 0, total_var = 0;
+  for (size_t i = 0; i < names.size(); ++i) {
+    RETURN_NOT_OK(compute_tile_memory(
+        names[i], result_tiles, &sizes[i].first, &sizes[i].second));
+    total_fixed += sizes[i].first;
+    total_var += sizes[i].second;
+  }
+  if (tile_memory_fixed_ + total_fixed > memory_budget_ ||
+      tile_memory_var_ + total_var > memory_budget_var_)
+    return Status::Ok();
+
+  for (size_t i = 0; i < names.size(); ++i)
+    add_tile_memory(names[i], sizes[i].first, sizes[i].second);
+  RETURN_NOT_OK(read_tiles(names, result_tiles, tasks, disk_cache_misses));
+  *fetched = true;
+  STATS_COUNTER_ADD(reader_num_colocated_tile_fetches, 1);
+
+  return Status::Ok();
+}
+
 Status Reader::read_tiles(
     const std::string& name,
     const std::vector<ResultTile*>& result_tiles) const {
   // Shortcut for empty tile vec
   if (result_tiles.empty())
     return Status::Ok();
+  STATS_HISTOGRAM_TIMER(reader_read_tiles);
 
   // Read the tiles asynchronously
   std::vector<std::future<Status>> tasks;
-  RETURN_CANCEL_OR_ERROR(read_tiles(name, result_tiles, &tasks));
+  std::vector<std::pair<URI, std::tuple<uint64_t, void*, uint64_t>>>
+      disk_cache_misses;
+  RETURN_CANCEL_OR_ERROR(
+      read_tiles({name}, result_tiles, &tasks, &disk_cache_misses));
+
+  return wait_read_tiles(&tasks, &disk_cache_misses);
+}
 
+Status Reader::wait_read_tiles(
+    std::vector<std::future<Status>>* tasks,
+    std::vector<std::pair<URI, std::tuple<uint64_t, void*, uint64_t>>>*
+        disk_cache_misses) const {
   // Wait for the reads to finish and check statuses.
   auto statuses =
-      storage_manager_->reader_thread_pool()->wait_all_status(tasks);
-  for (const auto& st : statuses)
+      storage_manager_->reader_thread_pool()->wait_all_status(*tasks);
+  tasks->clear();
+  for (const auto& st : statuses) {
+    if (!st.ok())
+      disk_cache_misses->clear();
     RETURN_CANCEL_OR_ERROR(st);
+  }
+
+  // Store the tiles that missed the on-disk tile cache. The errors are
+  // logged, but failing to cache a tile does not fail the read.
+  if (!disk_cache_misses->empty()) {
+    auto disk_cache = storage_manager_->disk_tile_cache();
+    parallel_for(0, disk_cache_misses->size(), [&](uint64_t i) {
+      const auto& miss = (*disk_cache_misses)[i];
+      return disk_cache->write(
+          miss.first,
+          std::get<0>(miss.second),
+          std::get<1>(miss.second),
+          std::get<2>(miss.second));
+    });
+    disk_cache_misses->clear();
+  }
 
   return Status::Ok();
 }
 
 Status Reader::read_tiles(
-    const std::string& name,
+    const std::vector<std::string>& names,
     const std::vector<ResultTile*>& result_tiles,
-    std::vector<std::future<Status>>* tasks) const {
+    std::vector<std::future<Status>>* tasks,
+    std::vector<std::pair<URI, std::tuple<uint64_t, void*, uint64_t>>>*
+        disk_cache_misses) const {
   // For each tile, read from its fragment.
-  bool var_size = array_schema_->var_size(name);
   auto num_tiles = static_cast<uint64_t>(result_tiles.size());
   auto encryption_key = array_->encryption_key();
+  auto vfs = storage_manager_->vfs();
+
+  // Populate the list of regions per file to be read. The regions of all
+  // names share the map, so that those of co-located tiles are merged. The
+  // map nodes come from a local arena, since the prefetch may read tiles
+  // concurrently.
+  typedef std::vector<std::tuple<uint64_t, void*, uint64_t>> Regions;
+  Arena arena;
+  ArenaAllocator<std::pair<const URI, Regions>> alloc(&arena);
+  std::map<URI, Regions, std::less<URI>, decltype(alloc)> all_regions(alloc);
+  for (const auto& name : names) {
+    bool var_size = array_schema_->var_size(name);
+    bool cache_filtered = storage_manager_->cache_filtered_tiles(
+        var_size ? array_schema_->cell_var_offsets_filters() :
+                   array_schema_->filters(name));
+    bool cache_filtered_var =
+        var_size &&
+        storage_manager_->cache_filtered_tiles(array_schema_->filters(name));
+    for (uint64_t i = 0; i < num_tiles; i++) {
+      auto& tile = result_tiles[i];
+      auto& fragment = fragment_metadata_[tile->frag_idx()];
+      auto format_version = fragment->format_version();
+
+      // Applicable for zipped coordinates only to versions < 5
+      if (name == constants::coords && format_version >= 5)
+        continue;
 
-  // Populate the list of regions per file to be read.
-  std::map<URI, std::vector<std::tuple<uint64_t, void*, uint64_t>>> all_regions;
-  for (uint64_t i = 0; i < num_tiles; i++) {
-    auto& tile = result_tiles[i];
-    auto& fragment = fragment_metadata_[tile->frag_idx()];
-    auto format_version = fragment->format_version();
-
-    // Applicable for zipped coordinates only to versions < 5
-    if (name == constants::coords && format_version >= 5)
-      continue;
-
-    // Applicable to separate coordinates only to versions >= 5
-    auto is_dim = array_schema_->is_dim(name);
-    if (is_dim && format_version < 5)
-      continue;
+      // Applicable to separate coordinates only to versions >= 5
+      auto is_dim = array_schema_->is_dim(name);
+      if (is_dim && format_version < 5)
+        continue;
 
-    // Initialize the tile(s)
-    if (is_dim) {
-      auto dim_num = array_schema_->dim_num();
-      for (unsigned d = 0; d < dim_num; ++d) {
-        if (array_schema_->dimension(d)->name() == name) {
-          tile->init_coord_tile(name, d);
-          break;
+      // Initialize the tile(s)
+      if (is_dim) {
+        auto dim_num = array_schema_->dim_num();
+        for (unsigned d = 0; d < dim_num; ++d) {
+          if (array_schema_->dimension(d)->name() == name) {
+            tile->init_coord_tile(name, d);
+            break;
+          }
         }
+      } else {
+        tile->init_attr_tile(name);
+      }
+      auto tile_pair = tile->tile_pair(name);
+      assert(tile_pair != nullptr);
+      auto& t = tile_pair->first;
+      auto& t_var = tile_pair->second;
+      if (!var_size) {
+        RETURN_NOT_OK(init_tile(format_version, name, &t));
+      } else {
+        RETURN_NOT_OK(init_tile(format_version, name, &t, &t_var));
       }
-    } else {
-      tile->init_attr_tile(name);
-    }
-    auto tile_pair = tile->tile_pair(name);
-    assert(tile_pair != nullptr);
-    auto& t = tile_pair->first;
-    auto& t_var = tile_pair->second;
-    if (!var_size) {
-      RETURN_NOT_OK(init_tile(format_version, name, &t));
-    } else {
-      RETURN_NOT_OK(init_tile(format_version, name, &t, &t_var));
-    }
-
-    // Get information about the tile in its fragment
-    auto tile_attr_uri = fragment->uri(name);
-    uint64_t tile_attr_offset;
-    auto tile_idx = tile->tile_idx();
-    RETURN_NOT_OK(fragment->file_offset(
-        *encryption_key, name, tile_idx, &tile_attr_offset));
-    auto tile_size = fragment->tile_size(name, tile_idx);
-    uint64_t tile_persisted_size;
-    RETURN_NOT_OK(fragment->persisted_tile_size(
-        *encryption_key, name, tile_idx, &tile_persisted_size));
-
-    // Try the cache first.
-    bool cache_hit;
-    RETURN_NOT_OK(storage_manager_->read_from_cache(
-        tile_attr_uri, tile_attr_offset, t.buffer(), tile_size, &cache_hit));
-    if (cache_hit) {
-      t.set_filtered(true);
-      STATS_COUNTER_ADD(reader_attr_tile_cache_hits, 1);
-    } else {
-      // Add the region of the fragment to be read.
-      RETURN_NOT_OK(t.buffer()->realloc(tile_persisted_size));
-      t.buffer()->set_size(tile_persisted_size);
-      t.buffer()->reset_offset();
-      all_regions[tile_attr_uri].emplace_back(
-          tile_attr_offset, t.buffer()->data(), tile_persisted_size);
-
-      STATS_COUNTER_ADD(reader_num_tile_bytes_read, tile_persisted_size);
-    }
-
-    if (var_size) {
-      auto tile_attr_var_uri = fragment->var_uri(name);
-      uint64_t tile_attr_var_offset;
-      RETURN_NOT_OK(fragment->file_var_offset(
-          *encryption_key, name, tile_idx, &tile_attr_var_offset));
-      uint64_t tile_var_size;
-      RETURN_NOT_OK(fragment->tile_var_size(
-          *encryption_key, name, tile_idx, &tile_var_size));
-      uint64_t tile_var_persisted_size;
-      RETURN_NOT_OK(fragment->persisted_tile_var_size(
-          *encryption_key, name, tile_idx, &tile_var_persisted_size));
-
-      RETURN_NOT_OK(storage_manager_->read_from_cache(
-          tile_attr_var_uri,
-          tile_attr_var_offset,
-          t_var.buffer(),
-          tile_var_size,
-          &cache_hit));
 
+      // Get information about the tile in its fragment
+      auto tile_attr_uri = fragment->uri(name);
+      bool map_tiles = vfs->mmap_enabled(tile_attr_uri);
+      uint64_t tile_attr_offset;
+      auto tile_idx = tile->tile_idx();
+      RETURN_NOT_OK(fragment->file_offset(
+          *encryption_key, name, tile_idx, &tile_attr_offset));
+      auto tile_size = fragment->tile_size(name, tile_idx);
+      uint64_t tile_persisted_size;
+      RETURN_NOT_OK(fragment->persisted_tile_size(
+          *encryption_key, name, tile_idx, &tile_persisted_size));
+
+      // Try the caches first. A hit is borrowed, not copied. The global
+      // cache may hold the filtered tile, which is then unfiltered as if it
+      // was read from the fragment.
+      TileCacheKey key = {
+          fragment->id(), fragment->file_id(name, false), tile_attr_offset};
+      auto cached = partition_tile_cache_.get(key, tile_size);
+      bool cached_filtered = false;
+      if (cached == nullptr && (!cache_filtered || tile_persisted_size > 0)) {
+        cached_filtered = cache_filtered;
+        RETURN_NOT_OK(storage_manager_->read_from_cache(
+            key, cache_filtered ? tile_persisted_size : tile_size, &cached));
+      }
+      bool cache_hit = cached != nullptr;
       if (cache_hit) {
-        t_var.set_filtered(true);
+        RETURN_NOT_OK(t.set_cached_data(cached, !cached_filtered));
         STATS_COUNTER_ADD(reader_attr_tile_cache_hits, 1);
+      } else if (map_tiles && tile_persisted_size > 0) {
+        // Point the tile at the mapped fragment region.
+        std::shared_ptr<MappedRegion> region;
+        RETURN_NOT_OK(vfs->map_region(
+            tile_attr_uri, tile_attr_offset, tile_persisted_size, &region));
+        RETURN_NOT_OK(t.set_mapped_region(region));
+
+        STATS_COUNTER_ADD(reader_num_tile_bytes_read, tile_persisted_size);
       } else {
         // Add the region of the fragment to be read.
-        RETURN_NOT_OK(t_var.buffer()->realloc(tile_var_persisted_size));
-        t_var.buffer()->set_size(tile_var_persisted_size);
-        t_var.buffer()->reset_offset();
-        all_regions[tile_attr_var_uri].emplace_back(
-            tile_attr_var_offset,
-            t_var.buffer()->data(),
-            tile_var_persisted_size);
-
-        STATS_COUNTER_ADD(reader_num_tile_bytes_read, tile_var_persisted_size);
-        STATS_COUNTER_ADD(reader_num_var_cell_bytes_read, tile_persisted_size);
-        STATS_COUNTER_ADD(
-            reader_num_var_cell_bytes_read, tile_var_persisted_size);
+        RETURN_NOT_OK(t.buffer()->realloc(tile_persisted_size));
+        t.buffer()->set_size(tile_persisted_size);
+        t.buffer()->reset_offset();
+        all_regions[tile_attr_uri].emplace_back(
+            tile_attr_offset, t.buffer()->data(), tile_persisted_size);
+
+        STATS_COUNTER_ADD(reader_num_tile_bytes_read, tile_persisted_size);
       }
-    } else {
-      STATS_COUNTER_ADD_IF(
-          !cache_hit, reader_num_fixed_cell_bytes_read, tile_persisted_size);
+
+      if (var_size) {
+        auto tile_attr_var_uri = fragment->var_uri(name);
+        uint64_t tile_attr_var_offset;
+        RETURN_NOT_OK(fragment->file_var_offset(
+            *encryption_key, name, tile_idx, &tile_attr_var_offset));
+        uint64_t tile_var_size;
+        RETURN_NOT_OK(fragment->tile_var_size(
+            *encryption_key, name, tile_idx, &tile_var_size));
+        uint64_t tile_var_persisted_size;
+        RETURN_NOT_OK(fragment->persisted_tile_var_size(
+            *encryption_key, name, tile_idx, &tile_var_persisted_size));
+
+        TileCacheKey var_key = {
+            fragment->id(),
+            fragment->file_id(name, true),
+            tile_attr_var_offset};
+        auto cached_var = partition_tile_cache_.get(var_key, tile_var_size);
+        bool cached_var_filtered = false;
+        if (cached_var == nullptr &&
+            (!cache_filtered_var || tile_var_persisted_size > 0)) {
+          cached_var_filtered = cache_filtered_var;
+          RETURN_NOT_OK(storage_manager_->read_from_cache(
+              var_key,
+              cache_filtered_var ? tile_var_persisted_size : tile_var_size,
+              &cached_var));
+        }
+
+        if (cached_var != nullptr) {
+          RETURN_NOT_OK(
+              t_var.set_cached_data(cached_var, !cached_var_filtered));
+          STATS_COUNTER_ADD(reader_attr_tile_cache_hits, 1);
+        } else if (map_tiles && tile_var_persisted_size > 0) {
+          // Point the tile at the mapped fragment region.
+          std::shared_ptr<MappedRegion> region;
+          RETURN_NOT_OK(vfs->map_region(
+              tile_attr_var_uri,
+              tile_attr_var_offset,
+              tile_var_persisted_size,
+              &region));
+          RETURN_NOT_OK(t_var.set_mapped_region(region));
+
+          STATS_COUNTER_ADD(
+              reader_num_tile_bytes_read, tile_var_persisted_size);
+          STATS_COUNTER_ADD(
+              reader_num_var_cell_bytes_read, tile_persisted_size);
+          STATS_COUNTER_ADD(
+              reader_num_var_cell_bytes_read, tile_var_persisted_size);
+        } else {
+          // Add the region of the fragment to be read.
+          RETURN_NOT_OK(t_var.buffer()->realloc(tile_var_persisted_size));
+          t_var.buffer()->set_size(tile_var_persisted_size);
+          t_var.buffer()->reset_offset();
+          all_regions[tile_attr_var_uri].emplace_back(
+              tile_attr_var_offset,
+              t_var.buffer()->data(),
+              tile_var_persisted_size);
+
+          STATS_COUNTER_ADD(
+              reader_num_tile_bytes_read, tile_var_persisted_size);
+          STATS_COUNTER_ADD(
+              reader_num_var_cell_bytes_read, tile_persisted_size);
+          STATS_COUNTER_ADD(
+              reader_num_var_cell_bytes_read, tile_var_persisted_size);
+        }
+      } else {
+        STATS_COUNTER_ADD_IF(
+            !cache_hit, reader_num_fixed_cell_bytes_read, tile_persisted_size);
+      }
+    }
+
+    STATS_COUNTER_ADD(
+        reader_num_attr_tiles_touched, ((var_size ? 2 : 1) * num_tiles));
+  }
+
+  // Serve the regions of remote files from the on-disk tile cache, if
+  // enabled. The regions that miss are read as usual.
+  auto disk_cache = storage_manager_->disk_tile_cache();
+  if (disk_cache != nullptr) {
+    for (auto& item : all_regions) {
+      if (!disk_cache->caches(item.first))
+        continue;
+      auto& regions = item.second;
+      std::vector<uint8_t> hits(regions.size(), 0);
+      auto statuses = parallel_for(0, regions.size(), [&](uint64_t r) {
+        bool hit = false;
+        RETURN_NOT_OK(disk_cache->read(
+            item.first,
+            std::get<0>(regions[r]),
+            std::get<1>(regions[r]),
+            std::get<2>(regions[r]),
+            &hit));
+        hits[r] = hit;
+        return Status::Ok();
+      });
+      for (const auto& st : statuses)
+        RETURN_NOT_OK(st);
+
+      std::vector<std::tuple<uint64_t, void*, uint64_t>> misses;
+      for (uint64_t r = 0; r < regions.size(); ++r) {
+        if (hits[r])
+          continue;
+        misses.push_back(regions[r]);
+        disk_cache_misses->emplace_back(item.first, regions[r]);
+      }
+      regions.swap(misses);
     }
   }
 
@@ -1876,10 +3876,157 @@ Status Reader::read_tiles(
         tasks));
   }
 
-  STATS_COUNTER_ADD(
-      reader_num_attr_tiles_touched, ((var_size ? 2 : 1) * num_tiles));
+  return Status::Ok();
+}
+
+template <class T>
+void Reader::prefetch_next_partition() {
+  if (!prefetch_ || read_state_.unsplittable_ || read_state_.done())
+    return;
+
+  // Run on a dedicated thread rather than on the reader thread pool, which
+  // the prefetch itself waits on. The task owns copies of the partitioner
+  // and the attribute names, so the user may reset the buffers meanwhile.
+  auto partitioner = read_state_.partitioner_;
+  auto attributes = attributes_;
+  prefetch_task_ = std::async(
+      std::launch::async, [this, partitioner, attributes]() mutable {
+        bool unsplittable = false;
+        return prefetch_tiles<T>(&partitioner, attributes, &unsplittable);
+      });
+}
+
+template <class T>
+Status Reader::prefetch(const std::vector<std::string>& attributes) {
+  STATS_FUNC_IN(reader_prefetch);
+
+  if (array_schema_->dense() && !sparse_mode_ && !subarray_.is_set())
+    return LOG_STATUS(Status::ReaderError(
+        "Cannot prefetch; Dense reads must have a subarray set"));
+
+  // Tiles are handed over through the tile cache
+  bool found = false;
+  auto config = storage_manager_->config();
+  uint64_t tile_cache_size = 0;
+  RETURN_NOT_OK(
+      config.get<uint64_t>("sm.tile_cache_size", &tile_cache_size, &found));
+  assert(found);
+  if (tile_cache_size == 0 || fragment_metadata_.empty())
+    return Status::Ok();
+
+  uint64_t memory_budget = 0;
+  RETURN_NOT_OK(
+      config.get<uint64_t>("sm.memory_budget", &memory_budget, &found));
+  assert(found);
+  uint64_t memory_budget_var = 0;
+  RETURN_NOT_OK(
+      config.get<uint64_t>("sm.memory_budget_var", &memory_budget_var, &found));
+  assert(found);
+
+  // There are no result buffers, so only the memory budget splits the
+  // subarray
+  SubarrayPartitioner partitioner(subarray_, memory_budget, memory_budget_var);
+  for (const auto& attr : attributes) {
+    if (!array_schema_->var_size(attr)) {
+      RETURN_NOT_OK(partitioner.set_result_budget(attr.c_str(), UINT64_MAX));
+    } else {
+      RETURN_NOT_OK(partitioner.set_result_budget(
+          attr.c_str(), UINT64_MAX, UINT64_MAX));
+    }
+  }
+
+  bool unsplittable = false;
+  while (!partitioner.done() && !unsplittable)
+    RETURN_NOT_OK(prefetch_tiles<T>(&partitioner, attributes, &unsplittable));
 
   return Status::Ok();
+
+  STATS_FUNC_OUT(reader_prefetch);
+}
+
+template <class T>
+Status Reader::prefetch_tiles(
+    SubarrayPartitioner* partitioner,
+    const std::vector<std::string>& attributes,
+    bool* unsplittable) const {
+  STATS_FUNC_IN(reader_prefetch_tiles);
+
+  RETURN_NOT_OK(partitioner->next(unsplittable));
+  if (*unsplittable)
+    return Status::Ok();
+  auto& subarray = partitioner->current();
+  RETURN_NOT_OK(subarray.compute_tile_overlap());
+
+  // Tiles of the sparse fragments. This may run concurrently with the
+  // query, so it uses its own arena.
+  Arena arena;
+  ArenaAllocator<FragTilePair> alloc(&arena);
+  std::vector<ResultTile> sparse_result_tiles;
+  ResultTileMap result_tile_map(alloc);
+  std::vector<bool> single_fragment;
+  RETURN_CANCEL_OR_ERROR(compute_sparse_result_tiles<T>(
+      subarray, &sparse_result_tiles, &result_tile_map, &single_fragment));
+  result_tile_map.clear();
+  std::vector<ResultTile*> sparse_tiles;
+  for (auto& srt : sparse_result_tiles)
+    sparse_tiles.push_back(&srt);
+
+  // Tiles of the dense fragments
+  std::map<const T*, ResultSpaceTile<T>> result_space_tiles;
+  if (array_schema_->dense() && !sparse_mode_) {
+    subarray.compute_tile_coords<T>();
+    compute_result_space_tiles<T>(subarray, &result_space_tiles);
+  }
+  std::vector<ResultTile*> result_tiles(sparse_tiles);
+  for (auto& rst : result_space_tiles) {
+    for (auto& rt : rst.second.result_tiles_)
+      result_tiles.push_back(&rt.second);
+  }
+
+  // Coordinates (zipped or separate), then attributes
+  std::vector<std::string> coord_names = {constants::coords};
+  for (unsigned d = 0; d < array_schema_->dim_num(); ++d)
+    coord_names.push_back(array_schema_->dimension(d)->name());
+  for (const auto& name : coord_names) {
+    RETURN_CANCEL_OR_ERROR(read_tiles(name, sparse_tiles));
+    RETURN_CANCEL_OR_ERROR(filter_tiles(name, sparse_tiles));
+    clear_tiles(name, sparse_tiles);
+  }
+  for (const auto& attr : attributes) {
+    if (attr == constants::coords || array_schema_->is_dim(attr))
+      continue;
+    RETURN_CANCEL_OR_ERROR(read_tiles(attr, result_tiles));
+    RETURN_CANCEL_OR_ERROR(filter_tiles(attr, result_tiles));
+    clear_tiles(attr, result_tiles);
+  }
+
+  return Status::Ok();
+
+  STATS_FUNC_OUT(reader_prefetch_tiles);
+}
+
+void Reader::recycle_result_tiles() {
+  for (auto& result_tile : sparse_result_tiles_) {
+    result_tile.clear();
+    free_result_tiles_.emplace_back(std::move(result_tile));
+  }
+  sparse_result_tiles_.clear();
+}
+
+void Reader::release_tile_memory(const std::string& name) {
+  auto it = tile_memory_.find(name);
+  if (it == tile_memory_.end())
+    return;
+
+  tile_memory_fixed_ -= it->second.first;
+  tile_memory_var_ -= it->second.second;
+  tile_memory_.erase(it);
+}
+
+void Reader::release_tile_memory() {
+  tile_memory_.clear();
+  tile_memory_fixed_ = 0;
+  tile_memory_var_ = 0;
 }
 
 void Reader::reset_buffer_sizes() {
@@ -1894,11 +4041,91 @@ Status Reader::sort_result_coords(
     std::vector<ResultCoords>* result_coords, Layout layout) const {
   STATS_FUNC_IN(reader_sort_coords);
 
-  // TODO: do not sort if it is single fragment and
-  // (i) it is single dimension, or (ii) it is global order
-
   auto domain = array_schema_->domain();
 
+  // Sort integer coordinates on their cell ids if possible
+  if (layout == Layout::ROW_MAJOR || layout == Layout::COL_MAJOR) {
+    bool sorted = false;
+    switch (domain->type()) {
+      case Datatype::INT8:
+        sorted = sort_result_coords_on_cell_ids<int8_t>(result_coords, layout);
+        break;
+      case Datatype::UINT8:
+        sorted =
+            sort_result_coords_on_cell_ids<uint8_t>(result_coords, layout);
+        break;
+      case Datatype::INT16:
+        sorted =
+            sort_result_coords_on_cell_ids<int16_t>(result_coords, layout);
+        break;
+      case Datatype::UINT16:
+        sorted =
+            sort_result_coords_on_cell_ids<uint16_t>(result_coords, layout);
+        break;
+      case Datatype::INT32:
+        sorted =
+            sort_result_coords_on_cell_ids<int32_t>(result_coords, layout);
+        break;
+      case Datatype::UINT32:
+        sorted =
+            sort_result_coords_on_cell_ids<uint32_t>(result_coords, layout);
+        break;
+      case Datatype::INT64:
+        sorted =
+            sort_result_coords_on_cell_ids<int64_t>(result_coords, layout);
+        break;
+      case Datatype::UINT64:
+        sorted =
+            sort_result_coords_on_cell_ids<uint64_t>(result_coords, layout);
+        break;
+      default:
+        break;
+    }
+    if (sorted)
+      return Status::Ok();
+  }
+
+  // Sort with comparators specialized on the common domain types if
+  // possible
+  bool sorted = false;
+  switch (domain->type()) {
+    case Datatype::INT32:
+      sorted = sort_result_coords_typed<int32_t>(result_coords, layout);
+      break;
+    case Datatype::UINT32:
+      sorted = sort_result_coords_typed<uint32_t>(result_coords, layout);
+      break;
+    case Datatype::INT64:
+    case Datatype::DATETIME_YEAR:
+    case Datatype::DATETIME_MONTH:
+    case Datatype::DATETIME_WEEK:
+    case Datatype::DATETIME_DAY:
+    case Datatype::DATETIME_HR:
+    case Datatype::DATETIME_MIN:
+    case Datatype::DATETIME_SEC:
+    case Datatype::DATETIME_MS:
+    case Datatype::DATETIME_US:
+    case Datatype::DATETIME_NS:
+    case Datatype::DATETIME_PS:
+    case Datatype::DATETIME_FS:
+    case Datatype::DATETIME_AS:
+      sorted = sort_result_coords_typed<int64_t>(result_coords, layout);
+      break;
+    case Datatype::UINT64:
+      sorted = sort_result_coords_typed<uint64_t>(result_coords, layout);
+      break;
+    case Datatype::FLOAT32:
+      sorted = sort_result_coords_typed<float>(result_coords, layout);
+      break;
+    case Datatype::FLOAT64:
+      sorted = sort_result_coords_typed<double>(result_coords, layout);
+      break;
+    default:
+      break;
+  }
+  if (sorted)
+    return Status::Ok();
+
   if (layout == Layout::ROW_MAJOR) {
     parallel_sort(result_coords->begin(), result_coords->end(), RowCmp(domain));
   } else if (layout == Layout::COL_MAJOR) {
@@ -1915,28 +4142,253 @@ Status Reader::sort_result_coords(
   STATS_FUNC_OUT(reader_sort_coords);
 }
 
+template <class T>
+bool Reader::sort_result_coords_typed(
+    std::vector<ResultCoords>* result_coords, Layout layout) const {
+  switch (array_schema_->dim_num()) {
+    case 1:
+      return sort_result_coords_typed_dims<T, 1>(result_coords, layout);
+    case 2:
+      return sort_result_coords_typed_dims<T, 2>(result_coords, layout);
+    case 3:
+      return sort_result_coords_typed_dims<T, 3>(result_coords, layout);
+    case 4:
+      return sort_result_coords_typed_dims<T, 4>(result_coords, layout);
+    default:
+      return false;
+  }
+}
+
+template <class T, unsigned N>
+bool Reader::sort_result_coords_typed_dims(
+    std::vector<ResultCoords>* result_coords, Layout layout) const {
+  auto domain = array_schema_->domain();
+  if (layout == Layout::ROW_MAJOR) {
+    parallel_sort(
+        result_coords->begin(),
+        result_coords->end(),
+        TypedCellOrderCmp<T, N, false>());
+  } else if (layout == Layout::COL_MAJOR) {
+    parallel_sort(
+        result_coords->begin(),
+        result_coords->end(),
+        TypedCellOrderCmp<T, N, true>());
+  } else if (
+      layout == Layout::GLOBAL_ORDER &&
+      domain->cell_order() != Layout::HILBERT) {
+    parallel_sort(
+        result_coords->begin(),
+        result_coords->end(),
+        TypedGlobalCmp<T, N>(domain));
+  } else {
+    return false;
+  }
+
+  STATS_COUNTER_ADD(reader_coords_sorted_typed, 1);
+  return true;
+}
+
+template <class T>
+bool Reader::sort_result_coords_on_cell_ids(
+    std::vector<ResultCoords>* result_coords, Layout layout) const {
+  if (result_coords->empty())
+    return true;
+
+  auto dim_num = array_schema_->dim_num();
+  for (unsigned d = 0; d < dim_num; ++d) {
+    if (array_schema_->dimension(d)->var_size())
+      return false;
+  }
+
+  // Compute the bounding box of the coordinates
+  std::vector<T> low(dim_num, std::numeric_limits<T>::max());
+  std::vector<T> high(dim_num, std::numeric_limits<T>::min());
+  for (const auto& rc : *result_coords) {
+    for (unsigned d = 0; d < dim_num; ++d) {
+      auto c = *(const T*)rc.coord(d);
+      low[d] = std::min(low[d], c);
+      high[d] = std::max(high[d], c);
+    }
+  }
+
+  // Compute the extents of the bounding box, whose cell ids must fit in
+  // 64 bits. The unsigned conversions compute the differences modulo 2^64,
+  // which is exact for signed types too.
+  std::vector<uint64_t> extents(dim_num);
+  uint64_t cell_num = 1;
+  for (unsigned d = 0; d < dim_num; ++d) {
+    auto diff = (uint64_t)high[d] - (uint64_t)low[d];
+    if (diff == UINT64_MAX || cell_num > UINT64_MAX / (diff + 1))
+      return false;
+    extents[d] = diff + 1;
+    cell_num *= extents[d];
+  }
+
+  // Sort the positions of the coordinates on their cell ids
+  auto coords_num = result_coords->size();
+  std::vector<std::pair<uint64_t, uint64_t>> cell_ids;
+  cell_ids.reserve(coords_num);
+  for (uint64_t i = 0; i < coords_num; ++i) {
+    const auto& rc = (*result_coords)[i];
+    uint64_t cell_id = 0;
+    for (unsigned j = 0; j < dim_num; ++j) {
+      auto d = (layout == Layout::ROW_MAJOR) ? j : dim_num - j - 1;
+      auto c = *(const T*)rc.coord(d);
+      cell_id = cell_id * extents[d] + ((uint64_t)c - (uint64_t)low[d]);
+    }
+    cell_ids.emplace_back(cell_id, i);
+  }
+  parallel_radix_sort(&cell_ids, cell_num - 1);
+
+  std::vector<ResultCoords> sorted;
+  sorted.reserve(coords_num);
+  for (const auto& cell_id : cell_ids)
+    sorted.push_back((*result_coords)[cell_id.second]);
+  result_coords->swap(sorted);
+
+  return true;
+}
+
+template <class CmpT>
+Status Reader::merge_result_coords(
+    std::vector<ResultCoords>* result_coords,
+    const std::vector<uint64_t>& runs,
+    const CmpT& cmp,
+    uint64_t max_num) const {
+  STATS_FUNC_IN(reader_merge_coords);
+
+  // Nothing to merge
+  auto run_num = runs.size();
+  if (run_num < 2) {
+    if (result_coords->size() > max_num)
+      result_coords->erase(
+          result_coords->begin() + max_num, result_coords->end());
+    return Status::Ok();
+  }
+
+  // Heap of the (next, end) positions of the unmerged runs, ordered on the
+  // coordinates at their next positions
+  const auto& coords = *result_coords;
+  auto coords_num = coords.size();
+  typedef std::pair<uint64_t, uint64_t> Run;
+  auto greater = [&](const Run& a, const Run& b) {
+    return cmp(coords[b.first], coords[a.first]);
+  };
+  std::priority_queue<Run, std::vector<Run>, decltype(greater)> heap(greater);
+  for (size_t r = 0; r < run_num; ++r) {
+    auto end = (r + 1 < run_num) ? runs[r + 1] : coords_num;
+    if (runs[r] < end)
+      heap.emplace(runs[r], end);
+  }
+
+  // Merge, taking the coordinates of a run as long as they precede the
+  // other runs, which avoids heap operations for non-interleaved runs
+  std::vector<ResultCoords> merged;
+  merged.reserve(std::min(coords_num, max_num));
+  while (!heap.empty() && merged.size() < max_num) {
+    auto run = heap.top();
+    heap.pop();
+    do {
+      merged.push_back(coords[run.first++]);
+    } while (run.first < run.second && merged.size() < max_num &&
+             (heap.empty() ||
+              !cmp(coords[heap.top().first], coords[run.first])));
+    if (run.first < run.second)
+      heap.push(run);
+  }
+  result_coords->swap(merged);
+
+  return Status::Ok();
+
+  STATS_FUNC_OUT(reader_merge_coords);
+}
+
+bool Reader::deadline_reached(
+    std::chrono::steady_clock::time_point start,
+    std::chrono::steady_clock::time_point partition_start) const {
+  if (deadline_ms_ == 0)
+    return false;
+
+  auto now = std::chrono::steady_clock::now();
+  auto next_end = now + (now - partition_start);
+  return next_end - start > std::chrono::milliseconds(deadline_ms_);
+}
+
+bool Reader::tile_sampled(unsigned frag_idx, uint64_t tile_idx) const {
+  if (sample_fraction_ >= 1.0)
+    return true;
+
+  // Mix the seed, fragment and tile (splitmix64) into a uniform value
+  uint64_t h = sample_seed_ ^ ((uint64_t)frag_idx << 48) ^ tile_idx;
+  h += 0x9e3779b97f4a7c15ULL;
+  h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+  h ^= h >> 31;
+  return (double)(h >> 11) / (double)(1ULL << 53) < sample_fraction_;
+}
+
+uint64_t Reader::remaining_limit() const {
+  if (limit_ == UINT64_MAX)
+    return UINT64_MAX;
+  return limit_ - std::min(limit_, result_cell_num_);
+}
+
 template <class T>
 Status Reader::sparse_read() {
   STATS_FUNC_IN(reader_sparse_read);
 
+  // Release the transient structures of the previous partition
+  arena_.reset();
+
+  // The scratch vectors keep their memory from the previous partition
+  auto& result_coords = result_coords_;
+  auto& sparse_result_tiles = sparse_result_tiles_;
+  auto& result_cell_slabs = result_cell_slabs_;
+  auto& result_tiles = result_tiles_;
+  result_coords.clear();
+  recycle_result_tiles();
+  result_cell_slabs.clear();
+  result_tiles.clear();
+  release_tile_memory();
+
   // Compute result coordinates from the sparse fragments
   // `sparse_result_tiles` will hold all the relevant result tiles of
   // sparse fragments
-  std::vector<ResultCoords> result_coords;
-  std::vector<ResultTile> sparse_result_tiles;
   RETURN_NOT_OK(compute_result_coords<T>(&sparse_result_tiles, &result_coords));
-  std::vector<ResultTile*> result_tiles;
+  if (read_state_.overflowed_)
+    return Status::Ok();
   for (auto& srt : sparse_result_tiles)
     result_tiles.push_back(&srt);
 
-  // Compute result cell slabs
-  std::vector<ResultCellSlab> result_cell_slabs;
+  // Compute result cell slabs, and keep only the result tiles with result
+  // coordinates, so that no attribute tiles are read for the others
   RETURN_CANCEL_OR_ERROR(
       compute_result_cell_slabs(result_coords, &result_cell_slabs));
   result_coords.clear();
+  remove_empty_result_tiles(&result_tiles, result_cell_slabs, nullptr);
 
   uint64_t stride = UINT64_MAX;
 
+  // Keep only the cells that satisfy the query condition
+  RETURN_CANCEL_OR_ERROR(
+      apply_query_condition(stride, &result_tiles, &result_cell_slabs));
+  if (read_state_.overflowed_)
+    return Status::Ok();
+  const auto& condition_names = condition_.field_names();
+
+  // Keep only the cells within the limit of the query
+  if (limit_ != UINT64_MAX)
+    apply_limit(&result_tiles, &result_cell_slabs);
+
+  // Aggregate the result cells instead of copying them
+  if (!aggregates_.empty()) {
+    RETURN_CANCEL_OR_ERROR(
+        compute_aggregates(stride, result_tiles, result_cell_slabs));
+    for (const auto& name : condition_names)
+      clear_tiles(name, result_tiles);
+    return Status::Ok();
+  }
+
   // Copy coordinates
   if (has_coords())
     RETURN_CANCEL_OR_ERROR(
@@ -1946,16 +4398,16 @@ Status Reader::sparse_read() {
   erase_coord_tiles(&sparse_result_tiles);
 
   // Copy cells
-  for (const auto& attr : attributes_) {
-    if (read_state_.overflowed_)
-      break;
-    if (attr == constants::coords)
-      continue;
-
-    RETURN_CANCEL_OR_ERROR(read_tiles(attr, result_tiles));
-    RETURN_CANCEL_OR_ERROR(filter_tiles(attr, result_tiles));
-    RETURN_CANCEL_OR_ERROR(copy_cells(attr, stride, result_cell_slabs));
-    clear_tiles(attr, result_tiles);
+  if (!read_state_.overflowed_)
+    RETURN_NOT_OK(
+        copy_attribute_cells(stride, result_tiles, result_cell_slabs));
+  for (const auto& name : condition_names)
+    clear_tiles(name, result_tiles);
+
+  // Count the returned cells against the limit of the query
+  if (!read_state_.overflowed_) {
+    for (const auto& cs : result_cell_slabs)
+      result_cell_num_ += cs.length_;
   }
 
   return Status::Ok();
@@ -1963,6 +4415,11 @@ Status Reader::sparse_read() {
   STATS_FUNC_OUT(reader_sparse_read);
 }
 
+void Reader::wait_prefetch() {
+  if (prefetch_task_.valid())
+    prefetch_task_.get();
+}
+
 void Reader::zero_out_buffer_sizes() {
   for (auto& attr_buffer : attr_buffers_) {
     if (attr_buffer.second.buffer_size_ != nullptr)
@@ -1975,10 +4432,11 @@ void Reader::zero_out_buffer_sizes() {
 template <class T>
 bool Reader::sparse_tile_overwritten(
     unsigned frag_idx, uint64_t tile_idx) const {
-  auto mbr = (const T*)fragment_metadata_[frag_idx]->mbr(tile_idx);
-  assert(mbr != nullptr);
   auto fragment_num = fragment_metadata_.size();
   auto dim_num = array_schema_->dim_num();
+  std::vector<T> mbr_buff(2 * dim_num);
+  fragment_metadata_[frag_idx]->mbr(tile_idx, &mbr_buff[0]);
+  auto mbr = &mbr_buff[0];
 
   for (unsigned f = frag_idx + 1; f < fragment_num; ++f) {
     if (fragment_metadata_[f]->dense() &&
@@ -1999,6 +4457,15 @@ void Reader::erase_coord_tiles(std::vector<ResultTile>* result_tiles) const {
   }
 }
 
+void Reader::erase_coord_tiles(std::vector<ResultTile>* result_tiles) {
+  static_cast<const Reader*>(this)->erase_coord_tiles(result_tiles);
+
+  auto dim_num = array_schema_->dim_num();
+  for (unsigned d = 0; d < dim_num; ++d)
+    release_tile_memory(array_schema_->dimension(d)->name());
+  release_tile_memory(constants::coords);
+}
+
 // Explicit template instantiations
 template void Reader::compute_result_space_tiles<int8_t>(
     const Domain* domain,
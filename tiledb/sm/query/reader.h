@@ -33,14 +33,21 @@
 #ifndef TILEDB_READER_H
 #define TILEDB_READER_H
 
+#include <chrono>
 #include <future>
 #include <list>
 #include <map>
 #include <memory>
+#include <set>
+#include <tuple>
 
 #include "tiledb/sm/array_schema/tile_domain.h"
+#include "tiledb/sm/cache/partition_tile_cache.h"
+#include "tiledb/sm/misc/arena.h"
 #include "tiledb/sm/misc/status.h"
 #include "tiledb/sm/misc/uri.h"
+#include "tiledb/sm/query/aggregate.h"
+#include "tiledb/sm/query/query_condition.h"
 #include "tiledb/sm/query/result_cell_slab.h"
 #include "tiledb/sm/query/result_coords.h"
 #include "tiledb/sm/query/result_space_tile.h"
@@ -54,6 +61,7 @@ namespace sm {
 class Array;
 class ArraySchema;
 class FragmentMetadata;
+class OpenArray;
 class StorageManager;
 class Tile;
 
@@ -64,6 +72,22 @@ class Reader {
   /*          TYPE DEFINITIONS         */
   /* ********************************* */
 
+  /** A (fragment index, tile index) pair. */
+  typedef std::pair<unsigned, uint64_t> FragTilePair;
+
+  /** Maps (fragment, tile) pairs to result tile positions, in an arena. */
+  typedef std::map<
+      FragTilePair,
+      size_t,
+      std::less<FragTilePair>,
+      ArenaAllocator<std::pair<const FragTilePair, size_t>>>
+      ResultTileMap;
+
+  /** A set of (fragment, tile) pairs, in an arena. */
+  typedef std::
+      set<FragTilePair, std::less<FragTilePair>, ArenaAllocator<FragTilePair>>
+          FragTileSet;
+
   /** The state for a read query. */
   struct ReadState {
     /**
@@ -78,6 +102,12 @@ class Reader {
      * partitioner, because it reaches a partition that is unsplittable.
      */
     bool unsplittable_ = false;
+    /**
+     * ``true`` if the next submission must resume from the current
+     * partition instead of retrieving the next one, because the previous
+     * submission stopped at its deadline right after splitting it.
+     */
+    bool resume_current_ = false;
     /** True if the reader has been initialized. */
     bool initialized_ = false;
 
@@ -125,6 +155,19 @@ class Reader {
   /** Returns the array. */
   const Array* array() const;
 
+  /**
+   * Adds an aggregate over the input attribute to the query. A query with
+   * aggregates computes them over all its result cells in a single
+   * submission, without result buffers (see `Aggregate`).
+   *
+   * @param name The aggregated attribute.
+   * @param op The aggregate operator.
+   * @param result The location the result is written to when the query
+   *     completes.
+   * @return Status
+   */
+  Status add_aggregate(const std::string& name, AggregateOp op, void* result);
+
   /**
    * Adds a range to the (read/write) query on the input dimension,
    * in the form of (start, end, stride).
@@ -186,6 +229,21 @@ class Reader {
    */
   bool incomplete() const;
 
+  /** Returns the width in bits of the var-sized offsets written by reads. */
+  uint32_t offsets_bitsize() const;
+
+  /**
+   * Returns `true` if reads append the end offset of the last cell to the
+   * var-sized offsets.
+   */
+  bool offsets_extra_element() const;
+
+  /**
+   * Returns `true` if the var-sized offsets written by reads count elements
+   * of the attribute datatype instead of bytes.
+   */
+  bool offsets_in_elements() const;
+
   /**
    * Retrieves the buffer of a fixed-sized attribute.
    *
@@ -226,6 +284,13 @@ class Reader {
   /** Initializes the reader. */
   Status init();
 
+  /**
+   * Re-initializes a reader initialized before, for a new subarray. It
+   * restores the buffer sizes set by the user and resets the read state,
+   * without repeating the checks and config lookups of `init`.
+   */
+  Status reinit();
+
   /** Returns the cell layout. */
   Layout layout() const;
 
@@ -238,6 +303,19 @@ class Reader {
   /** Returns the current read state. */
   ReadState* read_state();
 
+  /**
+   * Reads and unfilters the tiles of the input attributes that overlap the
+   * subarray into the tile cache, without producing results. This loads
+   * the fragment metadata needed along the way, and processes the subarray
+   * in partitions that respect the memory budget. The result buffers need
+   * not be set.
+   *
+   * @param attributes The attributes whose tiles are fetched. The
+   *     coordinate tiles of the sparse fragments are always fetched.
+   * @return Status
+   */
+  Status prefetch(const std::vector<std::string>& attributes);
+
   /** Performs a read query using its set members. */
   Status read();
 
@@ -299,6 +377,27 @@ class Reader {
       uint64_t* buffer_val_size,
       bool check_null_buffers = true);
 
+  /**
+   * Makes the reader allocate the result buffers of the input attribute.
+   * The buffers start empty and grow to fit the results of each partition,
+   * up to the memory budget, instead of the partition being split. The
+   * results are retrieved with `get_buffer` and stay valid until the next
+   * read.
+   *
+   * @param attribute The attribute to allocate the buffers of.
+   * @return Status
+   */
+  Status set_managed_buffer(const std::string& attribute);
+
+  /**
+   * Sets the condition that the result cells must satisfy. Cells that do
+   * not satisfy it are not copied to the result buffers.
+   *
+   * @param condition The query condition.
+   * @return Status
+   */
+  Status set_condition(const QueryCondition& condition);
+
   /** Sets the fragment metadata. */
   void set_fragment_metadata(
       const std::vector<FragmentMetadata*>& fragment_metadata);
@@ -310,6 +409,60 @@ class Reader {
    */
   Status set_layout(Layout layout);
 
+  /**
+   * Sets the maximum number of result cells the query returns over all its
+   * submissions. Once the limit is reached, the query completes, and the
+   * coordinates and tiles that would produce further results are not
+   * computed or read. Only applicable to sparse arrays.
+   *
+   * @param limit The maximum number of result cells.
+   * @return Status
+   */
+  Status set_limit(uint64_t limit);
+
+  /**
+   * Sets the wall-clock budget of each submission of the query. Once the
+   * next partition would not be read within the budget, the submission
+   * stops and returns the results it has, possibly none, as incomplete.
+   * The next submission resumes from there.
+   *
+   * @param deadline_ms The budget of a submission in milliseconds, `0`
+   *     for none.
+   * @return Status
+   */
+  Status set_deadline(uint64_t deadline_ms);
+
+  /**
+   * Makes the query read a random sample of the sparse tiles overlapping
+   * its subarray, each kept with probability `fraction`. Only the sampled
+   * tiles are read and unfiltered. The choice of a tile depends only on
+   * `seed`, its fragment and its index, so that it is the same in all the
+   * partitions the tile overlaps. Only applicable to sparse arrays.
+   *
+   * @param fraction The probability of a tile to be read, in `(0, 1]`.
+   * @param seed The seed of the sample.
+   * @return Status
+   */
+  Status set_sample(double fraction, uint64_t seed);
+
+  /**
+   * Returns the ratio of the cells in the tiles read over the cells in
+   * all the overlapping tiles so far, `1.0` if the query is not sampled
+   * or found no tiles.
+   */
+  double sample_ratio() const;
+
+  /**
+   * Sets the width in bits (32 or 64) of the var-sized offsets written by
+   * this query, overriding `sm.var_offsets.bitsize`. If the offsets of a
+   * partition do not fit in 32 bits, the partition is split as if the
+   * buffers were too small.
+   *
+   * @param bitsize The offsets width in bits.
+   * @return Status
+   */
+  Status set_offsets_bitsize(uint32_t bitsize);
+
   /**
    * This is applicable only to dense arrays (errors out for sparse arrays),
    * and only in the case where the array is opened in a way that all its
@@ -353,6 +506,16 @@ class Reader {
    */
   Status set_subarray(const Subarray& subarray);
 
+  /**
+   * Sorts the input result coordinates according to the subarray layout.
+   *
+   * @param result_coords The coordinates to sort.
+   * @param layout The layout to sort into.
+   * @return Status
+   */
+  Status sort_result_coords(
+      std::vector<ResultCoords>* result_coords, Layout layout) const;
+
   /** Returns the query subarray. */
   const Subarray* subarray() const;
 
@@ -448,7 +611,7 @@ class Reader {
       std::vector<ResultCoords>* result_coords,
       uint64_t* result_coords_pos,
       std::vector<ResultTile*>* result_tiles,
-      std::set<std::pair<unsigned, uint64_t>>* frag_tile_set,
+      FragTileSet* frag_tile_set,
       std::vector<ResultCellSlab>* result_cell_slabs) const;
 
   /**
@@ -495,12 +658,37 @@ class Reader {
   /** Maps attribute names to their buffers. */
   std::unordered_map<std::string, QueryBuffer> attr_buffers_;
 
+  /** Result buffers allocated by the reader. */
+  struct ManagedBuffer {
+    /** The fixed-sized values, or the offsets of var-sized values. */
+    std::unique_ptr<uint8_t[]> buffer_;
+    /** The var-sized values. */
+    std::unique_ptr<uint8_t[]> buffer_var_;
+    /** The allocated size of `buffer_`. */
+    uint64_t capacity_ = 0;
+    /** The allocated size of `buffer_var_`. */
+    uint64_t capacity_var_ = 0;
+    /** The size of the results in `buffer_`. */
+    uint64_t buffer_size_ = 0;
+    /** The size of the results in `buffer_var_`. */
+    uint64_t buffer_var_size_ = 0;
+  };
+
+  /** Maps attribute names to the result buffers allocated by the reader. */
+  std::unordered_map<std::string, ManagedBuffer> managed_buffers_;
+
   /** The fragment metadata. */
   std::vector<FragmentMetadata*> fragment_metadata_;
 
   /** The layout of the cells in the result of the subarray. */
   Layout layout_;
 
+  /** The condition that the result cells must satisfy. */
+  QueryCondition condition_;
+
+  /** The aggregates computed over the result cells. */
+  std::vector<Aggregate> aggregates_;
+
   /** Read state. */
   ReadState read_state_;
 
@@ -526,10 +714,325 @@ class Reader {
   /** The memory budget for the var-sized attributes. */
   uint64_t memory_budget_var_;
 
+  /**
+   * If `true`, the tiles of the next partition are prefetched into the
+   * tile cache after an incomplete read.
+   */
+  bool prefetch_;
+
+  /**
+   * If `true`, the partitioner splits ranges on tile boundaries
+   * (`sm.partitioner.balanced_splits`).
+   */
+  bool balanced_splits_;
+
+  /**
+   * If `true`, the read strategy is chosen by `plan_read` when the read
+   * state is initialized (`sm.read_planner` is `cost`).
+   */
+  bool plan_read_;
+
+  /**
+   * Whether the query condition looks up the value indexes of each
+   * fragment, as chosen by `plan_read`. If empty, they are looked up in
+   * all fragments.
+   */
+  std::vector<bool> plan_value_indexes_;
+
+  /** The in-flight prefetch of the next partition (if any). */
+  std::future<Status> prefetch_task_;
+
+  /**
+   * The tiles unfiltered by the previous and current partitions, sized by
+   * `sm.partition_tile_cache_ratio`.
+   */
+  mutable PartitionTileCache partition_tile_cache_;
+
+  /**
+   * The open array entry that records the subarrays found to have no
+   * results, or `nullptr` if they are not recorded (see
+   * `sm.empty_subarray_cache_size`).
+   */
+  OpenArray* open_array_;
+
+  /** The maximum number of empty subarrays recorded per open array. */
+  uint64_t empty_subarray_cache_size_;
+
+  /**
+   * The width in bits of the var-sized offsets written to the user buffers
+   * (`sm.var_offsets.bitsize`).
+   */
+  uint32_t offsets_bitsize_;
+
+  /**
+   * The offsets width set on the query, which overrides
+   * `sm.var_offsets.bitsize`, or `0` if it is not set.
+   */
+  uint32_t query_offsets_bitsize_;
+
+  /**
+   * If `true`, the end offset of the last cell is appended to the var-sized
+   * offsets (`sm.var_offsets.extra_element`).
+   */
+  bool offsets_extra_element_;
+
+  /**
+   * If `true`, the var-sized offsets count elements of the attribute
+   * datatype instead of bytes (`sm.var_offsets.mode`).
+   */
+  bool offsets_in_elements_;
+
+  /**
+   * The maximum number of result cells returned by the query, or
+   * `UINT64_MAX` if there is no limit.
+   */
+  uint64_t limit_;
+
+  /**
+   * The wall-clock budget of each submission in milliseconds, or `0` if
+   * there is none.
+   */
+  uint64_t deadline_ms_;
+
+  /** The probability of a sparse tile to be read, `1.0` to read all. */
+  double sample_fraction_;
+
+  /** The seed of the sampled tiles. */
+  uint64_t sample_seed_;
+
+  /** The number of cells in the sampled tiles read so far. */
+  uint64_t sample_cell_num_;
+
+  /** The number of cells in the overlapping tiles skipped so far. */
+  uint64_t sample_skipped_cell_num_;
+
+  /** The number of result cells returned so far by the query. */
+  uint64_t result_cell_num_;
+
+  /**
+   * The result tiles, coordinates and cell slabs of the partition being
+   * read. They are cleared, not freed, between partitions, so that their
+   * memory is reused across partitions and incomplete submissions.
+   */
+  std::vector<ResultTile> sparse_result_tiles_;
+  std::vector<ResultCoords> result_coords_;
+  std::vector<ResultTile*> result_tiles_;
+  std::vector<ResultCellSlab> result_cell_slabs_;
+
+  /**
+   * The scratch structures of the result coordinate computation of the
+   * partition being read, cleared but not freed between partitions.
+   */
+  std::vector<bool> single_fragment_;
+  std::vector<ResultTile*> coord_result_tiles_;
+  std::vector<std::vector<ResultCoords>> range_result_coords_;
+
+  /**
+   * Cleared result tiles of previous partitions, recycled for the result
+   * tiles of the next partitions.
+   */
+  std::vector<ResultTile> free_result_tiles_;
+
+  /**
+   * The arena of the transient node-based structures of the partition being
+   * read (e.g., the result tile maps). It is reset at the start of each
+   * partition read, so that its memory is reused across partitions and
+   * submissions. It is used only by the thread executing the query; the
+   * prefetch of the next partition uses its own arena.
+   */
+  mutable Arena arena_;
+
+  /**
+   * The memory (in bytes) charged for the tiles currently loaded by the
+   * read of the current partition, per attribute/dimension, as a pair of
+   * the fixed-sized (or offsets) and the var-sized memory.
+   */
+  std::unordered_map<std::string, std::pair<uint64_t, uint64_t>> tile_memory_;
+
+  /** The total fixed-sized memory in `tile_memory_`. */
+  uint64_t tile_memory_fixed_;
+
+  /** The total var-sized memory in `tile_memory_`. */
+  uint64_t tile_memory_var_;
+
+  /**
+   * For each dimension, whether its coordinate tiles are not read for the
+   * current partition of a sparse read, because its coordinates are not
+   * needed. Empty if all the dimensions are read.
+   */
+  std::vector<uint8_t> skipped_dims_;
+
   /* ********************************* */
   /*           PRIVATE METHODS         */
   /* ********************************* */
 
+  /**
+   * Computes the result space tile of the space tile with the input
+   * coordinates. See `compute_result_space_tiles` for the parameters.
+   *
+   * @param coords The coordinates of the space tile.
+   * @param result_space_tile The result space tile to be computed.
+   */
+  template <class T>
+  static void compute_result_space_tile(
+      const Domain* domain,
+      const T* coords,
+      const TileDomain<T>& array_tile_domain,
+      const std::vector<TileDomain<T>>& frag_tile_domains,
+      ResultSpaceTile<T>* result_space_tile);
+
+  /**
+   * Appends the input result cell slab to `result_cell_slabs`, and its
+   * result tile to `result_tiles` if it is not in `frag_tile_set` yet.
+   */
+  void add_result_cell_slab(
+      const ResultCellSlab& result_cell_slab,
+      std::vector<ResultTile*>* result_tiles,
+      FragTileSet* frag_tile_set,
+      std::vector<ResultCellSlab>* result_cell_slabs) const;
+
+  /**
+   * Loads the tiles of the query condition attributes and removes the
+   * cells that do not satisfy the condition from the result cell slabs.
+   * The loaded tiles are kept for copying the cells. The result tiles
+   * whose attribute value ranges, stored in the fragment metadata, cannot
+   * satisfy the condition are removed along with their slabs before any
+   * tile is loaded.
+   *
+   * @param stride The stride of the cells in the result cell slabs, or
+   *     `UINT64_MAX` if the cells of each slab are contiguous.
+   * @param result_tiles The result tiles of the slabs.
+   * @param result_cell_slabs The result cell slabs to filter.
+   * @return Status
+   */
+  Status apply_query_condition(
+      uint64_t stride,
+      std::vector<ResultTile*>* result_tiles,
+      std::vector<ResultCellSlab>* result_cell_slabs);
+
+  /**
+   * Removes the result tiles that no result cell slab refers to, e.g.,
+   * because none of their cells are in the subarray or satisfy the query
+   * condition, so that the tiles of the remaining fields are not read
+   * for them.
+   *
+   * @param result_tiles The result tiles to filter.
+   * @param result_cell_slabs The result cell slabs referring to the tiles.
+   * @param removed If not `nullptr`, the removed tiles are appended to it.
+   * @return void
+   */
+  void remove_empty_result_tiles(
+      std::vector<ResultTile*>* result_tiles,
+      const std::vector<ResultCellSlab>& result_cell_slabs,
+      std::vector<ResultTile*>* removed) const;
+
+  /**
+   * Truncates the result cell slabs to the cells remaining within the
+   * limit of the query, and removes the result tiles that are left without
+   * a slab, so that they are not read.
+   *
+   * @param result_tiles The result tiles of the slabs.
+   * @param result_cell_slabs The result cell slabs to truncate.
+   */
+  void apply_limit(
+      std::vector<ResultTile*>* result_tiles,
+      std::vector<ResultCellSlab>* result_cell_slabs) const;
+
+  /**
+   * Updates the aggregates with the result cells of the current partition.
+   * The tiles whose cells are all results are aggregated from the minimum,
+   * maximum and sum stored in the fragment metadata, where available,
+   * without being read. The other tiles are read and filtered.
+   *
+   * @param stride The stride of the cells in the result cell slabs, or
+   *     `UINT64_MAX` if the cells of each slab are contiguous.
+   * @param result_tiles The result tiles of the slabs.
+   * @param result_cell_slabs The result cell slabs.
+   * @return Status
+   */
+  Status compute_aggregates(
+      uint64_t stride,
+      const std::vector<ResultTile*>& result_tiles,
+      const std::vector<ResultCellSlab>& result_cell_slabs);
+
+  /**
+   * Merges the consecutive result cell slabs whose cells are contiguous in
+   * the same result tile, and the consecutive empty slabs. Applicable only
+   * if the cells of each slab are contiguous (i.e., the copy stride is
+   * `UINT64_MAX`). When the read layout follows the cell order within the
+   * tiles, a fully covered tile of a single fragment becomes a single slab,
+   * which is copied at once.
+   *
+   * @param result_cell_slabs The result cell slabs to coalesce.
+   * @return void
+   */
+  void coalesce_result_cell_slabs(
+      std::vector<ResultCellSlab>* result_cell_slabs) const;
+
+  /**
+   * Reads, filters and copies the cells of all the queried attributes into
+   * their result buffers. The tiles of the next attribute are fetched
+   * while the tiles of the current one are unfiltered and copied, if the
+   * tiles of both fit in the memory budget, so that I/O overlaps with
+   * processing. The tiles of each attribute are released once copied.
+   *
+   * @param stride If it is `UINT64_MAX`, then the cells in the result
+   *     cell slabs are all contiguous. Otherwise, each cell in the
+   *     result cell slabs are `stride` cells apart from each other.
+   * @param result_tiles The result tiles of the attributes.
+   * @param result_cell_slabs The result cell slabs to copy cells for.
+   * @return Status
+   */
+  Status copy_attribute_cells(
+      uint64_t stride,
+      const std::vector<ResultTile*>& result_tiles,
+      const std::vector<ResultCellSlab>& result_cell_slabs);
+
+  /**
+   * Computes the memory of the (unfiltered) tiles on the input
+   * attribute/dimension of the result tiles.
+   *
+   * @param name The attribute/dimension name.
+   * @param result_tiles The result tiles whose tiles will be read.
+   * @param size_fixed Set to the memory of the fixed-sized (or offsets)
+   *     tiles.
+   * @param size_var Set to the memory of the var-sized tiles.
+   * @return Status
+   */
+  Status compute_tile_memory(
+      const std::string& name,
+      const std::vector<ResultTile*>& result_tiles,
+      uint64_t* size_fixed,
+      uint64_t* size_var) const;
+
+  /**
+   * Adds the input memory to the memory charged for the tiles of the
+   * input attribute/dimension.
+   *
+   * @param name The attribute/dimension name.
+   * @param size_fixed The memory of the fixed-sized (or offsets) tiles.
+   * @param size_var The memory of the var-sized tiles.
+   * @return void
+   */
+  void add_tile_memory(
+      const std::string& name, uint64_t size_fixed, uint64_t size_var);
+
+  /**
+   * Charges the memory of the (unfiltered) tiles on the input
+   * attribute/dimension of the result tiles against the memory budget,
+   * before the tiles are read. If the tiles loaded at the same time would
+   * exceed the budget, the read state is marked as overflowed instead, so
+   * that the current partition gets split, and nothing is charged. A
+   * single result tile is always allowed, as well as aggregate reads,
+   * whose partitions cannot be split.
+   *
+   * @param name The attribute/dimension name.
+   * @param result_tiles The result tiles whose tiles will be read.
+   * @return Status
+   */
+  Status charge_tile_memory(
+      const std::string& name, const std::vector<ResultTile*>& result_tiles);
+
   /**
    * Deletes the tiles on the input attribute/dimension from the result tiles.
    *
@@ -541,6 +1044,13 @@ class Reader {
       const std::string& name,
       const std::vector<ResultTile*>& result_tiles) const;
 
+  /**
+   * Same as `clear_tiles`, also releasing the memory charged for the tiles
+   * on the input attribute/dimension.
+   */
+  void clear_tiles(
+      const std::string& name, const std::vector<ResultTile*>& result_tiles);
+
   /**
    * Compute the maximal cell slabs of contiguous sparse coordinates.
    *
@@ -586,7 +1096,7 @@ class Reader {
   template <class T>
   Status compute_range_result_coords(
       const std::vector<bool>& single_fragment,
-      const std::map<std::pair<unsigned, uint64_t>, size_t>& result_tile_map,
+      const ResultTileMap& result_tile_map,
       std::vector<ResultTile>* result_tiles,
       std::vector<std::vector<ResultCoords>>* range_result_coords);
 
@@ -601,14 +1111,43 @@ class Reader {
    * @param result_tiles The result tiles to read the coordinates from.
    * @param range_result_coords The result coordinates to be retrieved.
    *     It contains a vector for each range of the subarray.
+   * @param runs The positions in `range_result_coords` where the
+   *     coordinates of each fragment start. The coordinates of a fragment
+   *     are in the global order.
    * @return Status
    */
   template <class T>
   Status compute_range_result_coords(
       uint64_t range_idx,
-      const std::map<std::pair<unsigned, uint64_t>, size_t>& result_tile_map,
+      const ResultTileMap& result_tile_map,
+      std::vector<ResultTile>* result_tiles,
+      std::vector<ResultCoords>* range_result_coords,
+      std::vector<uint64_t>* runs);
+
+  /**
+   * Computes the result coordinates of all the ranges of the query
+   * subarray at once, when the ranges of each dimension are sorted and
+   * disjoint. Each result tile is visited once, and each of its cells is
+   * assigned to the single range containing it with a binary search on the
+   * ranges of each dimension, so the tiles shared by many ranges are not
+   * processed once per range.
+   *
+   * @tparam T The domain type.
+   * @param result_tile_map This is an auxialiary map that helps finding the
+   *     result tiles overlapping with each range.
+   * @param result_tiles The result tiles to read the coordinates from.
+   * @param range_result_coords The result coordinates to be retrieved.
+   *     It contains a vector for each range of the subarray.
+   * @param range_runs The positions in each vector of `range_result_coords`
+   *     where the coordinates of each fragment start.
+   * @return Status
+   */
+  template <class T>
+  Status compute_range_result_coords_sweep(
+      const ResultTileMap& result_tile_map,
       std::vector<ResultTile>* result_tiles,
-      std::vector<ResultCoords>* range_result_coords);
+      std::vector<std::vector<ResultCoords>>* range_result_coords,
+      std::vector<std::vector<uint64_t>>* range_runs);
 
   /**
    * Computes the final subarray result coordinates, which will be
@@ -635,18 +1174,46 @@ class Reader {
    * with common tiles.
    *
    * @tparam T The coords type.
+   * @param subarray The subarray (partition) whose tiles are computed.
    * @param result_tiles The result tiles to be computed.
    * @param result_tile_map The result tile map to be computed.
    * @param single_fragment Each element corresponds to a range of the
    *     subarray and is set to ``true`` if all the overlapping
    *     tiles come from a single fragment for that range.
+   * @param free_result_tiles If not `nullptr`, cleared result tiles that
+   *     are recycled for the computed result tiles.
+   * @param skipped_cell_num If not `nullptr`, incremented by the number of
+   *     cells in the tiles left out of the sample of the query.
    * @return Status
    */
   template <class T>
   Status compute_sparse_result_tiles(
+      const Subarray& subarray,
       std::vector<ResultTile>* result_tiles,
-      std::map<std::pair<unsigned, uint64_t>, size_t>* result_tile_map,
-      std::vector<bool>* single_fragment);
+      ResultTileMap* result_tile_map,
+      std::vector<bool>* single_fragment,
+      std::vector<ResultTile>* free_result_tiles = nullptr,
+      uint64_t* skipped_cell_num = nullptr) const;
+
+  /**
+   * Checks whether the coordinate bloom filter of the input fragment rejects
+   * the input subarray range, i.e., whether the fragment certainly has no
+   * cell in it. This may only be the case for unary ranges, for which the
+   * bloom filter of the fragment is loaded on demand.
+   *
+   * @tparam T The coords type.
+   * @param frag_idx The index of the fragment.
+   * @param subarray The subarray (partition) the range belongs to.
+   * @param range_idx The index of the range in the subarray.
+   * @param rejected Set to `true` if the fragment can be skipped.
+   * @return Status
+   */
+  template <class T>
+  Status coords_rejected(
+      unsigned frag_idx,
+      const Subarray& subarray,
+      uint64_t range_idx,
+      bool* rejected) const;
 
   /**
    * Copies the cells for the input attribute and result cell slabs, into
@@ -673,12 +1240,16 @@ class Reader {
    *     cell slabs are all contiguous. Otherwise, each cell in the
    *     result cell slabs are `stride` cells apart from each other.
    * @param result_cell_slabs The result cell slabs to copy cells for.
+   * @param dests The tiles that were unfiltered directly into the result
+   *     buffer, mapped to their destination. A slab whose tile is already at
+   *     its destination is not copied.
    * @return Status
    */
   Status copy_fixed_cells(
       const std::string& name,
       uint64_t stride,
-      const std::vector<ResultCellSlab>& result_cell_slabs);
+      const std::vector<ResultCellSlab>& result_cell_slabs,
+      const std::unordered_map<const ResultTile*, void*>& dests);
 
   /**
    * Copies the cells for the input **var-sized** attribute/dimension and result
@@ -706,12 +1277,12 @@ class Reader {
    *     cell slabs are all contiguous. Otherwise, each cell in the
    *     result cell slabs are `stride` cells apart from each other.
    * @param result_cell_slabs The result cell slabs to compute destinations for.
-   * @param offset_offsets_per_cs Output to hold one vector per result cell
-   *    slab, and one element per cell in the slab. The elements are the
-   *    destination offsets for the attribute's offsets.
-   * @param var_offsets_per_cs Output to hold one vector per result cell slab,
-   *    and one element per cell in the slab. The elements are the destination
-   *    offsets for the attribute's variable-length data.
+   * @param cs_offsets Output to hold one element per result cell slab, the
+   *    destination offset of the slab's first offset. The offsets of the
+   *    cells of a slab are consecutive.
+   * @param cs_var_offsets Output to hold one element per result cell slab,
+   *    the destination offset of the variable-length data of the slab's
+   *    first cell. The data of the cells of a slab are consecutive.
    * @param total_offset_size Output set to the total size in bytes of the
    *    offsets in the given list of result cell slabs.
    * @param total_var_size Output set to the total size in bytes of the
@@ -722,11 +1293,22 @@ class Reader {
       const std::string& name,
       uint64_t stride,
       const std::vector<ResultCellSlab>& result_cell_slabs,
-      std::vector<std::vector<uint64_t>>* offset_offsets_per_cs,
-      std::vector<std::vector<uint64_t>>* var_offsets_per_cs,
+      std::vector<uint64_t>* cs_offsets,
+      std::vector<uint64_t>* cs_var_offsets,
       uint64_t* total_offset_size,
       uint64_t* total_var_size) const;
 
+  /**
+   * Computes the tile domains of the dense fragments, ordered from the
+   * most recent to the oldest fragment.
+   *
+   * @tparam T The domain datatype.
+   * @param frag_tile_domains The fragment tile domains to be computed.
+   */
+  template <class T>
+  void compute_frag_tile_domains(
+      std::vector<TileDomain<T>>* frag_tile_domains) const;
+
   /**
    * Computes the result space tiles based on the input subarray.
    *
@@ -739,6 +1321,23 @@ class Reader {
       const Subarray& subarray,
       std::map<const T*, ResultSpaceTile<T>>* result_space_tiles) const;
 
+  /**
+   * Computes the dimensions whose coordinate tiles need not be read for the
+   * current partition, storing them in `skipped_dims_`. A dimension is
+   * skipped in unordered sparse reads without deduplication, if it is
+   * neither queried nor in the query condition, and the single range of
+   * the partition on it contains the non-empty domain of every fragment,
+   * so that its coordinates pass the subarray check anyway. At least one
+   * dimension is read, as it provides the cell number of each tile.
+   *
+   * @tparam T The domain datatype.
+   * @param single_fragment For each range, it indicates whether all
+   *     result coordinates come from a single fragment.
+   * @return void
+   */
+  template <class T>
+  void compute_skipped_dims(const std::vector<bool>& single_fragment);
+
   /**
    * Computes the result coordinates from the sparse fragments.
    *
@@ -759,6 +1358,52 @@ class Reader {
    */
   Status dedup_result_coords(std::vector<ResultCoords>* result_coords) const;
 
+  /**
+   * Deduplicates the input result coordinates in any order, breaking ties
+   * giving preference to the largest fragment index (i.e., it prefers more
+   * recent fragments). The coordinates are partitioned on their hashes into
+   * shards, which are deduplicated concurrently with a hash set each.
+   *
+   * @tparam T The domain type.
+   * @param result_coords The result coordinates to dedup.
+   * @return Status
+   */
+  template <class T>
+  Status dedup_result_coords_unordered(
+      std::vector<ResultCoords>* result_coords) const;
+
+  /**
+   * Returns the key of the input subarray in the empty subarray records of
+   * the open array. It encodes the subarray ranges and the fragments of the
+   * reader, so that a record is only hit by reads on the same fragments.
+   */
+  std::string empty_subarray_key(const Subarray& subarray) const;
+
+  /**
+   * Computes the aggregates of the query over all the partitions of the
+   * subarray and writes their results.
+   *
+   * @tparam The domain type.
+   * @return Status
+   */
+  template <class T>
+  Status aggregate_read();
+
+  /**
+   * Counts the result cells of the current partition of a sparse read,
+   * without computing, sorting or copying the result coordinates. The
+   * cells of the tiles fully covered by a range are counted from the
+   * fragment metadata. Only the coordinate tiles partially covered by a
+   * range, or overlapping the range along with the tiles of other
+   * fragments (whose cells are deduplicated), are read.
+   *
+   * @tparam The domain type.
+   * @param cell_num The number of result cells.
+   * @return Status
+   */
+  template <class T>
+  Status count_result_cells(uint64_t* cell_num);
+
   /**
    * Performs a read on a dense array.
    *
@@ -768,6 +1413,22 @@ class Reader {
   template <class T>
   Status dense_read();
 
+  /**
+   * Writes `num` copies of a fill value contiguously to `dest`. A single
+   * memset is used when all bytes of the value are equal, otherwise the
+   * copies already written are replicated in doubling chunks.
+   *
+   * @param dest The destination buffer.
+   * @param value The fill value.
+   * @param value_size The size of the fill value in bytes.
+   * @param num The number of copies to write.
+   */
+  static void fill_cells(
+      unsigned char* dest,
+      const void* value,
+      uint64_t value_size,
+      uint64_t num);
+
   /**
    * Fills the coordinate buffer with coordinates. Applicable only to dense
    * arrays when the user explicitly requests the coordinates to be
@@ -867,17 +1528,40 @@ class Reader {
       const std::vector<ResultTile*>& result_tiles) const;
 
   /**
-   * Runs the input tile for the input attribute or dimension through the
-   * filter pipeline. The tile buffer is modified to contain the output of the
-   * pipeline.
+   * Same as `filter_tiles(name, result_tiles)`, but the fixed-sized tiles
+   * found in `dests` are unfiltered directly into their destination. The
+   * chunks of all the tiles are unfiltered as one set of parallel tasks.
+   *
+   * @param name Attribute/dimension whose tiles will be filtered
+   * @param result_tiles Vector containing the tiles to be filtered
+   * @param dests The destination of the unfiltered data of some tiles.
+   *     The destination must hold the full unfiltered tile.
+   * @return Status
+   */
+  Status filter_tiles(
+      const std::string& name,
+      const std::vector<ResultTile*>& result_tiles,
+      const std::unordered_map<const ResultTile*, void*>& dests) const;
+
+  /**
+   * Filters and copies the cells of the input attribute into its result
+   * buffer, once its tiles are read. When the cells are contiguous, the
+   * full tiles of a fixed-sized attribute are unfiltered directly into the
+   * result buffer, skipping the intermediate tile buffer and the copy.
    *
-   * @param name The attribute/dimension the tile belong to.
-   * @param tile The tile to be filtered.
-   * @param offsets True if the tile to be filtered contains offsets for a
-   *    var-sized attribute/dimension.
+   * @param name The targeted attribute.
+   * @param stride If it is `UINT64_MAX`, then the cells in the result
+   *     cell slabs are all contiguous. Otherwise, each cell in the
+   *     result cell slabs are `stride` cells apart from each other.
+   * @param result_tiles The result tiles of the attribute.
+   * @param result_cell_slabs The result cell slabs to copy cells for.
    * @return Status
    */
-  Status filter_tile(const std::string& name, Tile* tile, bool offsets) const;
+  Status filter_and_copy_cells(
+      const std::string& name,
+      uint64_t stride,
+      const std::vector<ResultTile*>& result_tiles,
+      const std::vector<ResultCellSlab>& result_cell_slabs);
 
   /**
    * Gets all the result coordinates of the input tile into `result_coords`.
@@ -889,12 +1573,37 @@ class Reader {
   Status get_all_result_coords(
       ResultTile* tile, std::vector<ResultCoords>* result_coords) const;
 
+  /**
+   * Grows the result buffers of the input attribute to at least `size`
+   * and `var_size` bytes, if the reader allocates them and the sizes are
+   * within the memory budget. The buffer contents are not preserved.
+   *
+   * @param name The attribute whose buffers to grow.
+   * @param size The needed size of the fixed-sized or offsets buffer.
+   * @param var_size The needed size of the var-sized buffer.
+   * @return `true` if the buffers were grown to the input sizes.
+   */
+  bool grow_managed_buffer(
+      const std::string& name, uint64_t size, uint64_t var_size);
+
   /** Returns `true` if the coordinates are included in the attributes. */
   bool has_coords() const;
 
   /** Initializes the read state. */
   Status init_read_state();
 
+  /**
+   * Chooses the read strategy of the query from the tile overlap of the
+   * input subarray and its estimated result sizes (see `sm.read_planner`):
+   * the fragments whose value indexes the query condition looks up, and
+   * whether the partitions are prefetched and split on tile boundaries.
+   * The choices are reported in the statistics.
+   *
+   * @param subarray The subarray the read state is initialized with.
+   * @return Status
+   */
+  Status plan_read(Subarray* subarray);
+
   /**
    * Initializes a fixed-sized tile.
    *
@@ -921,6 +1630,27 @@ class Reader {
       Tile* tile,
       Tile* tile_var) const;
 
+  /**
+   * Starts fetching the tiles of all the input attributes with a single
+   * `read_tiles` call, charging their memory, if they all fit in the memory
+   * budget.
+   *
+   * @param names The attribute names.
+   * @param result_tiles The tiles to fetch.
+   * @param tasks Vector to hold futures for the read tasks.
+   * @param disk_cache_misses The regions that missed the on-disk tile cache.
+   * @param fetched Set to `true` if the tiles are being fetched, or `false`
+   *     if they do not fit in the memory budget.
+   * @return Status
+   */
+  Status fetch_all_tiles(
+      const std::vector<std::string>& names,
+      const std::vector<ResultTile*>& result_tiles,
+      std::vector<std::future<Status>>* tasks,
+      std::vector<std::pair<URI, std::tuple<uint64_t, void*, uint64_t>>>*
+          disk_cache_misses,
+      bool* fetched);
+
   /**
    * Retrieves the tiles on a particular attribute or dimension and stores it
    * in the appropriate result tile.
@@ -935,22 +1665,98 @@ class Reader {
       const std::vector<ResultTile*>& result_tiles) const;
 
   /**
-   * Retrieves the tiles on a particular attribute or dimension and stores it
-   * in the appropriate result tile.
+   * Retrieves the tiles on the input attributes/dimensions and stores them
+   * in the appropriate result tiles. The regions of all names are read
+   * together, so that adjacent tiles of different names, such as those of
+   * co-located fragments, are read at once.
    *
    * The reads are done asynchronously, and futures for each read operation are
    * added to the output parameter.
    *
-   * @param name The attribute/dimension name.
+   * If the on-disk tile cache is enabled, the tiles of remote files are
+   * first looked up there. Those that miss are read as usual and returned
+   * in `disk_cache_misses`, to be stored in the disk cache once the reads
+   * complete.
+   *
+   * @param names The attribute/dimension names.
    * @param result_tiles The retrieved tiles will be stored inside the
    *     `ResultTile` instances in this vector.
    * @param tasks Vector to hold futures for the read tasks.
+   * @param disk_cache_misses The regions that missed the on-disk tile cache,
+   *     as pairs `(file_uri, (file_offset, dest_buffer, nbytes))`.
    * @return Status
    */
   Status read_tiles(
-      const std::string& name,
+      const std::vector<std::string>& names,
       const std::vector<ResultTile*>& result_tiles,
-      std::vector<std::future<Status>>* tasks) const;
+      std::vector<std::future<Status>>* tasks,
+      std::vector<std::pair<URI, std::tuple<uint64_t, void*, uint64_t>>>*
+          disk_cache_misses) const;
+
+  /**
+   * Waits for the asynchronous tile reads issued by `read_tiles` to
+   * complete, and stores the regions that missed the on-disk tile cache.
+   * Both input vectors are emptied.
+   *
+   * @param tasks The futures of the read tasks.
+   * @param disk_cache_misses The regions that missed the on-disk tile cache,
+   *     as pairs `(file_uri, (file_offset, dest_buffer, nbytes))`.
+   * @return Status
+   */
+  Status wait_read_tiles(
+      std::vector<std::future<Status>>* tasks,
+      std::vector<std::pair<URI, std::tuple<uint64_t, void*, uint64_t>>>*
+          disk_cache_misses) const;
+
+  /**
+   * Starts fetching the tiles of the partition following the current one
+   * in the background, if prefetching is enabled and there are more
+   * partitions to read.
+   *
+   * @tparam T The domain type.
+   */
+  template <class T>
+  void prefetch_next_partition();
+
+  /**
+   * Implements `prefetch` for the given domain type.
+   *
+   * @tparam T The domain type.
+   * @param attributes The attributes to prefetch.
+   * @return Status
+   */
+  template <class T>
+  Status prefetch(const std::vector<std::string>& attributes);
+
+  /**
+   * Advances the input partitioner and reads and unfilters the tiles of the
+   * resulting partition, which populates the tile cache. The tiles are
+   * dropped after each attribute/dimension is processed.
+   *
+   * @tparam T The domain type.
+   * @param partitioner A copy of the partitioner of the read state.
+   * @param attributes The attributes to prefetch.
+   * @param unsplittable Set to `true` if the partitioner could not advance
+   *     because the next partition does not fit in the memory budget.
+   * @return Status
+   */
+  template <class T>
+  Status prefetch_tiles(
+      SubarrayPartitioner* partitioner,
+      const std::vector<std::string>& attributes,
+      bool* unsplittable) const;
+
+  /**
+   * Clears the result tiles of the previous partition and moves them to
+   * the free list of result tiles.
+   */
+  void recycle_result_tiles();
+
+  /** Releases the memory charged for the tiles of the input field. */
+  void release_tile_memory(const std::string& name);
+
+  /** Releases the memory charged for all tiles. */
+  void release_tile_memory();
 
   /**
    * Resets the buffer sizes to the original buffer sizes. This is because
@@ -960,15 +1766,82 @@ class Reader {
   void reset_buffer_sizes();
 
   /**
-   * Sorts the input result coordinates according to the subarray layout.
+   * Sorts the input result coordinates on their row-major or col-major
+   * cell ids within the bounding box of the coordinates, with a radix sort.
+   * This is applicable only to integer domains with fixed-sized dimensions
+   * whose bounding box has at most 2^64 cells.
    *
+   * @tparam T The domain type.
+   * @param result_coords The coordinates to sort.
+   * @param layout The layout to sort into, row-major or col-major.
+   * @return `true` if the coordinates were sorted, and `false` if the
+   *     sort is not applicable.
+   */
+  template <class T>
+  bool sort_result_coords_on_cell_ids(
+      std::vector<ResultCoords>* result_coords, Layout layout) const;
+
+  /**
+   * Sorts the input result coordinates with a comparator specialized on
+   * the domain type and number of dimensions, which the sort inlines.
+   * This is applicable only to domains with 1 to 4 dimensions, and to the
+   * global order only with a row-major or col-major cell order.
+   *
+   * @tparam T The domain type.
    * @param result_coords The coordinates to sort.
    * @param layout The layout to sort into.
-   * @return Status
+   * @return `true` if the coordinates were sorted, and `false` if the
+   *     sort is not applicable.
    */
-  Status sort_result_coords(
+  template <class T>
+  bool sort_result_coords_typed(
       std::vector<ResultCoords>* result_coords, Layout layout) const;
 
+  /**
+   * Implements `sort_result_coords_typed` for a domain with `N`
+   * dimensions.
+   */
+  template <class T, unsigned N>
+  bool sort_result_coords_typed_dims(
+      std::vector<ResultCoords>* result_coords, Layout layout) const;
+
+  /**
+   * Merges the sorted runs of the input result coordinates with a k-way
+   * heap merge.
+   *
+   * @tparam CmpT The comparator type, in whose order the runs are sorted.
+   * @param result_coords The coordinates to merge.
+   * @param runs The positions in `result_coords` where the runs start.
+   * @param cmp The comparator.
+   * @param max_num The merge stops after producing this many coordinates,
+   *     and the rest are discarded.
+   * @return Status
+   */
+  template <class CmpT>
+  Status merge_result_coords(
+      std::vector<ResultCoords>* result_coords,
+      const std::vector<uint64_t>& runs,
+      const CmpT& cmp,
+      uint64_t max_num) const;
+
+  /**
+   * Returns the number of result cells the query can still return within
+   * its limit, or `UINT64_MAX` if there is no limit.
+   */
+  uint64_t remaining_limit() const;
+
+  /** Returns `true` if tile `tile_idx` of fragment `frag_idx` is sampled. */
+  bool tile_sampled(unsigned frag_idx, uint64_t tile_idx) const;
+
+  /**
+   * Returns `true` if a submission that started at `start` would exceed
+   * its deadline by reading another partition, assuming it takes as long
+   * as the last one, which started at `partition_start`.
+   */
+  bool deadline_reached(
+      std::chrono::steady_clock::time_point start,
+      std::chrono::steady_clock::time_point partition_start) const;
+
   /**
    * Performs a read on a sparse array.
    *
@@ -978,6 +1851,12 @@ class Reader {
   template <class T>
   Status sparse_read();
 
+  /**
+   * Waits for the in-flight prefetch (if any) to finish. Prefetching is
+   * best-effort, so its status is ignored.
+   */
+  void wait_prefetch();
+
   /** Zeroes out the user buffer sizes, indicating an empty result. */
   void zero_out_buffer_sizes();
 
@@ -993,6 +1872,12 @@ class Reader {
    * tiles.
    */
   void erase_coord_tiles(std::vector<ResultTile>* result_tiles) const;
+
+  /**
+   * Same as above, also releasing the memory charged for the coordinate
+   * tiles.
+   */
+  void erase_coord_tiles(std::vector<ResultTile>* result_tiles);
 };
 
 }  // namespace sm
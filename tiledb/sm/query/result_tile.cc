@@ -33,14 +33,183 @@
 #include "tiledb/sm/query/result_tile.h"
 #include "tiledb/sm/array_schema/dimension.h"
 #include "tiledb/sm/array_schema/domain.h"
+#include "tiledb/sm/enums/datatype.h"
 
 #include <cassert>
+#include <cstring>
 #include <iostream>
 #include <list>
 
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 namespace tiledb {
 namespace sm {
 
+namespace {
+
+/**
+ * Clears the entries of `bitmap` of the coordinates outside
+ * `[low, high]`, starting at coordinate `start`. There are `num`
+ * coordinates in `coords`, `stride` values apart.
+ */
+template <class T>
+void compute_results_in_range_scalar(
+    const T* coords,
+    uint64_t stride,
+    uint64_t start,
+    uint64_t num,
+    T low,
+    T high,
+    uint8_t* bitmap) {
+  for (uint64_t i = start; i < num; ++i) {
+    const auto& c = coords[i * stride];
+    bitmap[i] &= (uint8_t)(c >= low && c <= high);
+  }
+}
+
+/**
+ * Clears the entries of `bitmap` of the coordinates outside `[low, high]`.
+ * There are `num` coordinates in `coords`, `stride` values apart.
+ */
+template <class T>
+void compute_results_in_range(
+    const T* coords,
+    uint64_t stride,
+    uint64_t num,
+    T low,
+    T high,
+    uint8_t* bitmap) {
+  compute_results_in_range_scalar(coords, stride, 0, num, low, high, bitmap);
+}
+
+#ifdef __AVX2__
+
+/** Maps 4 bits to the 4 bytes holding each bit, in little-endian order. */
+const uint32_t spread_bits[16] = {0x00000000,
+                                  0x00000001,
+                                  0x00000100,
+                                  0x00000101,
+                                  0x00010000,
+                                  0x00010001,
+                                  0x00010100,
+                                  0x00010101,
+                                  0x01000000,
+                                  0x01000001,
+                                  0x01000100,
+                                  0x01000101,
+                                  0x01010000,
+                                  0x01010001,
+                                  0x01010100,
+                                  0x01010101};
+
+/** Clears the 4 bitmap entries whose bits are not set in `bits`. */
+inline void clear_bitmap(uint8_t* bitmap, int bits) {
+  uint32_t entries;
+  std::memcpy(&entries, bitmap, sizeof(entries));
+  entries &= spread_bits[bits & 0xf];
+  std::memcpy(bitmap, &entries, sizeof(entries));
+}
+
+template <>
+void compute_results_in_range<int32_t>(
+    const int32_t* coords,
+    uint64_t stride,
+    uint64_t num,
+    int32_t low,
+    int32_t high,
+    uint8_t* bitmap) {
+  uint64_t i = 0;
+  if (stride == 1) {
+    auto l = _mm256_set1_epi32(low);
+    auto h = _mm256_set1_epi32(high);
+    for (; i + 8 <= num; i += 8) {
+      auto c = _mm256_loadu_si256((const __m256i*)&coords[i]);
+      auto out = _mm256_or_si256(
+          _mm256_cmpgt_epi32(l, c), _mm256_cmpgt_epi32(c, h));
+      auto in = ~_mm256_movemask_ps(_mm256_castsi256_ps(out));
+      clear_bitmap(&bitmap[i], in);
+      clear_bitmap(&bitmap[i + 4], in >> 4);
+    }
+  }
+  compute_results_in_range_scalar(coords, stride, i, num, low, high, bitmap);
+}
+
+template <>
+void compute_results_in_range<int64_t>(
+    const int64_t* coords,
+    uint64_t stride,
+    uint64_t num,
+    int64_t low,
+    int64_t high,
+    uint8_t* bitmap) {
+  uint64_t i = 0;
+  if (stride == 1) {
+    auto l = _mm256_set1_epi64x(low);
+    auto h = _mm256_set1_epi64x(high);
+    for (; i + 4 <= num; i += 4) {
+      auto c = _mm256_loadu_si256((const __m256i*)&coords[i]);
+      auto out = _mm256_or_si256(
+          _mm256_cmpgt_epi64(l, c), _mm256_cmpgt_epi64(c, h));
+      clear_bitmap(
+          &bitmap[i], ~_mm256_movemask_pd(_mm256_castsi256_pd(out)));
+    }
+  }
+  compute_results_in_range_scalar(coords, stride, i, num, low, high, bitmap);
+}
+
+template <>
+void compute_results_in_range<float>(
+    const float* coords,
+    uint64_t stride,
+    uint64_t num,
+    float low,
+    float high,
+    uint8_t* bitmap) {
+  uint64_t i = 0;
+  if (stride == 1) {
+    auto l = _mm256_set1_ps(low);
+    auto h = _mm256_set1_ps(high);
+    for (; i + 8 <= num; i += 8) {
+      auto c = _mm256_loadu_ps(&coords[i]);
+      auto in = _mm256_movemask_ps(_mm256_and_ps(
+          _mm256_cmp_ps(c, l, _CMP_GE_OQ), _mm256_cmp_ps(c, h, _CMP_LE_OQ)));
+      clear_bitmap(&bitmap[i], in);
+      clear_bitmap(&bitmap[i + 4], in >> 4);
+    }
+  }
+  compute_results_in_range_scalar(coords, stride, i, num, low, high, bitmap);
+}
+
+template <>
+void compute_results_in_range<double>(
+    const double* coords,
+    uint64_t stride,
+    uint64_t num,
+    double low,
+    double high,
+    uint8_t* bitmap) {
+  uint64_t i = 0;
+  if (stride == 1) {
+    auto l = _mm256_set1_pd(low);
+    auto h = _mm256_set1_pd(high);
+    for (; i + 4 <= num; i += 4) {
+      auto c = _mm256_loadu_pd(&coords[i]);
+      clear_bitmap(
+          &bitmap[i],
+          _mm256_movemask_pd(_mm256_and_pd(
+              _mm256_cmp_pd(c, l, _CMP_GE_OQ),
+              _mm256_cmp_pd(c, h, _CMP_LE_OQ))));
+    }
+  }
+  compute_results_in_range_scalar(coords, stride, i, num, low, high, bitmap);
+}
+
+#endif
+
+}  // namespace
+
 /* ****************************** */
 /*   CONSTRUCTORS & DESTRUCTORS   */
 /* ****************************** */
@@ -63,8 +232,11 @@ bool ResultTile::operator==(const ResultTile& rt) const {
 }
 
 uint64_t ResultTile::cell_num() const {
-  if (!coord_tiles_[0].second.first.empty())
-    return coord_tiles_[0].second.first.cell_num();
+  // Some dimensions may not be read
+  for (const auto& coord_tile : coord_tiles_) {
+    if (!coord_tile.second.first.empty())
+      return coord_tile.second.first.cell_num();
+  }
 
   if (!coords_tile_.first.empty())
     return coords_tile_.first.cell_num();
@@ -75,6 +247,17 @@ uint64_t ResultTile::cell_num() const {
   return 0;
 }
 
+void ResultTile::clear() {
+  frag_idx_ = UINT32_MAX;
+  tile_idx_ = UINT64_MAX;
+  attr_tiles_.clear();
+  coords_tile_ = TilePair(Tile(), Tile());
+  for (auto& ct : coord_tiles_) {
+    ct.first.clear();
+    ct.second = TilePair(Tile(), Tile());
+  }
+}
+
 void ResultTile::erase_tile(const std::string& name) {
   // Handle zipped coordinates tiles
   if (name == constants::coords) {
@@ -94,6 +277,15 @@ void ResultTile::erase_tile(const std::string& name) {
   attr_tiles_.erase(name);
 }
 
+void ResultTile::init(
+    unsigned frag_idx, uint64_t tile_idx, const Domain* domain) {
+  assert(domain != nullptr);
+  domain_ = domain;
+  frag_idx_ = frag_idx;
+  tile_idx_ = tile_idx;
+  coord_tiles_.resize(domain->dim_num());
+}
+
 void ResultTile::init_attr_tile(const std::string& name) {
   // Nothing to do for the special zipped coordinates tile
   if (name == constants::coords)
@@ -168,6 +360,62 @@ uint64_t ResultTile::coord_size(unsigned dim_idx) const {
   return coord_tiles_[dim_idx].second.first.cell_size();
 }
 
+void ResultTile::compute_results(
+    unsigned dim_idx,
+    const void* range,
+    std::vector<uint8_t>* result_bitmap) const {
+  switch (domain_->dimension(dim_idx)->type()) {
+    case Datatype::INT32:
+      return compute_results<int32_t>(
+          dim_idx, (const int32_t*)range, result_bitmap);
+    case Datatype::INT64:
+      return compute_results<int64_t>(
+          dim_idx, (const int64_t*)range, result_bitmap);
+    case Datatype::INT8:
+      return compute_results<int8_t>(
+          dim_idx, (const int8_t*)range, result_bitmap);
+    case Datatype::UINT8:
+      return compute_results<uint8_t>(
+          dim_idx, (const uint8_t*)range, result_bitmap);
+    case Datatype::INT16:
+      return compute_results<int16_t>(
+          dim_idx, (const int16_t*)range, result_bitmap);
+    case Datatype::UINT16:
+      return compute_results<uint16_t>(
+          dim_idx, (const uint16_t*)range, result_bitmap);
+    case Datatype::UINT32:
+      return compute_results<uint32_t>(
+          dim_idx, (const uint32_t*)range, result_bitmap);
+    case Datatype::UINT64:
+      return compute_results<uint64_t>(
+          dim_idx, (const uint64_t*)range, result_bitmap);
+    case Datatype::FLOAT32:
+      return compute_results<float>(
+          dim_idx, (const float*)range, result_bitmap);
+    case Datatype::FLOAT64:
+      return compute_results<double>(
+          dim_idx, (const double*)range, result_bitmap);
+    case Datatype::DATETIME_YEAR:
+    case Datatype::DATETIME_MONTH:
+    case Datatype::DATETIME_WEEK:
+    case Datatype::DATETIME_DAY:
+    case Datatype::DATETIME_HR:
+    case Datatype::DATETIME_MIN:
+    case Datatype::DATETIME_SEC:
+    case Datatype::DATETIME_MS:
+    case Datatype::DATETIME_US:
+    case Datatype::DATETIME_NS:
+    case Datatype::DATETIME_PS:
+    case Datatype::DATETIME_FS:
+    case Datatype::DATETIME_AS:
+      return compute_results<int64_t>(
+          dim_idx, (const int64_t*)range, result_bitmap);
+    default:
+      assert(false);
+      return;
+  }
+}
+
 bool ResultTile::same_coords(
     const ResultTile& rt, uint64_t pos_a, uint64_t pos_b) const {
   auto dim_num = coord_tiles_.size();
@@ -218,5 +466,35 @@ Status ResultTile::read(
   return Status::Ok();
 }
 
+/* ****************************** */
+/*         PRIVATE METHODS        */
+/* ****************************** */
+
+template <class T>
+void ResultTile::compute_results(
+    unsigned dim_idx,
+    const T* range,
+    std::vector<uint8_t>* result_bitmap) const {
+  auto cell_num = this->cell_num();
+  assert(result_bitmap->size() >= cell_num);
+
+  // Handle separate coordinate tiles
+  const auto& coord_tile = coord_tiles_[dim_idx].second.first;
+  if (!coord_tile.empty()) {
+    auto coords = (const T*)coord_tile.internal_data();
+    compute_results_in_range(
+        coords, 1, cell_num, range[0], range[1], result_bitmap->data());
+    return;
+  }
+
+  // Handle zipped coordinates tile
+  if (!coords_tile_.first.empty()) {
+    auto dim_num = coords_tile_.first.dim_num();
+    auto coords = (const T*)coords_tile_.first.internal_data() + dim_idx;
+    compute_results_in_range(
+        coords, dim_num, cell_num, range[0], range[1], result_bitmap->data());
+  }
+}
+
 }  // namespace sm
 }  // namespace tiledb
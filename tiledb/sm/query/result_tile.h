@@ -93,9 +93,21 @@ class ResultTile {
    */
   uint64_t cell_num() const;
 
+  /**
+   * Clears the tiles of the result tile, keeping the memory of its tile
+   * containers, so that it can be recycled with `init` for another tile.
+   */
+  void clear();
+
   /** Erases the tile for the input attribute/dimension. */
   void erase_tile(const std::string& name);
 
+  /**
+   * Initializes a cleared result tile for tile `tile_idx` of fragment
+   * `frag_idx`.
+   */
+  void init(unsigned frag_idx, uint64_t tile_idx, const Domain* domain);
+
   /** Initializes the result tile for the given attribute. */
   void init_attr_tile(const std::string& name);
 
@@ -120,6 +132,23 @@ class ResultTile {
   /** Returns the coordinate size on the input dimension. */
   uint64_t coord_size(unsigned dim_idx) const;
 
+  /**
+   * Clears the entries of `result_bitmap` of the coordinates of the tile
+   * that are outside the input 1D range on the given dimension. The
+   * coordinates are checked in blocks, with AVX2 kernels for the `int32`,
+   * `int64`, `float32` and `float64` types if the library is built with
+   * AVX2 support.
+   *
+   * @param dim_idx The dimension index.
+   * @param range The 1D range on the dimension.
+   * @param result_bitmap One entry per coordinate of the tile, which is `1`
+   *     for results and `0` otherwise.
+   */
+  void compute_results(
+      unsigned dim_idx,
+      const void* range,
+      std::vector<uint8_t>* result_bitmap) const;
+
   /**
    * Returns true if the coordinates at position `pos_a` and `pos_b` are
    * the same.
@@ -155,6 +184,17 @@ class ResultTile {
    * dimension order.
    */
   std::vector<std::pair<std::string, TilePair>> coord_tiles_;
+
+  /**
+   * Applies `compute_results` for the input dimension type.
+   *
+   * @tparam T The dimension type.
+   */
+  template <class T>
+  void compute_results(
+      unsigned dim_idx,
+      const T* range,
+      std::vector<uint8_t>* result_bitmap) const;
 };
 
 }  // namespace sm
@@ -51,6 +51,11 @@ WriteCellSlabIter<T>::WriteCellSlabIter() {
   domain_ = nullptr;
   end_ = true;
   tile_overlap_ = false;
+  dim_num_ = 0;
+  array_domain_ = nullptr;
+  tile_extents_ = nullptr;
+  multi_cell_slabs_ = false;
+  slab_dim_ = 0;
 }
 
 template <class T>
@@ -61,6 +66,15 @@ WriteCellSlabIter<T>::WriteCellSlabIter(
     , layout_(layout) {
   end_ = true;
   tile_overlap_ = false;
+  dim_num_ = (domain != nullptr) ? domain->dim_num() : 0;
+  array_domain_ = (domain != nullptr) ? (const T*)domain->domain() : nullptr;
+  tile_extents_ =
+      (domain != nullptr) ? (const T*)domain->tile_extents() : nullptr;
+  auto cell_order = (domain != nullptr) ? domain->cell_order() : layout;
+  multi_cell_slabs_ =
+      (layout == Layout::GLOBAL_ORDER || layout == cell_order);
+  slab_dim_ =
+      (cell_order == Layout::ROW_MAJOR && dim_num_ > 0) ? dim_num_ - 1 : 0;
 }
 
 /* ****************************** */
@@ -88,7 +102,7 @@ Status WriteCellSlabIter<T>::begin() {
     coords_start_[i] = subarray_[2 * i];
 
   compute_current_tile_info();
-  compute_current_end_coords();
+  compute_current_end_coords<0>();
   RETURN_NOT_OK(compute_current_slab());
 
   return Status::Ok();
@@ -135,6 +149,27 @@ void WriteCellSlabIter<T>::operator++() {
   if (end_)
     return;
 
+  // Use the fixed-rank versions for the common 2D and 3D cases
+  switch (dim_num_) {
+    case 2:
+      advance<2>();
+      break;
+    case 3:
+      advance<3>();
+      break;
+    default:
+      advance<0>();
+      break;
+  }
+}
+
+/* ****************************** */
+/*          PRIVATE METHODS       */
+/* ****************************** */
+
+template <class T>
+template <unsigned N>
+void WriteCellSlabIter<T>::advance() {
   // Get next start coordinates, which must follow the end coordinates
   bool in_subarray = false;
   coords_start_ = coords_end_;
@@ -151,25 +186,36 @@ void WriteCellSlabIter<T>::operator++() {
   if (layout_ != Layout::GLOBAL_ORDER)
     compute_current_tile_info();
 
-  compute_current_end_coords();
+  compute_current_end_coords<N>();
   auto st = compute_current_slab();
   assert(st.ok());
 }
 
-/* ****************************** */
-/*          PRIVATE METHODS       */
-/* ****************************** */
-
 template <class T>
+template <unsigned N>
 void WriteCellSlabIter<T>::compute_current_end_coords() {
-  domain_->get_end_of_cell_slab(
-      &subarray_[0], &coords_start_[0], layout_, &coords_end_[0]);
+  const unsigned dim_num = (N != 0) ? N : dim_num_;
+  for (unsigned i = 0; i < dim_num; ++i)
+    coords_end_[i] = coords_start_[i];
+
+  // Extend the slab up to the end of the tile or the subarray
+  if (multi_cell_slabs_) {
+    auto d = slab_dim_;
+    auto tile_extent = tile_extents_[d];
+    auto offset = (coords_start_[d] - array_domain_[2 * d]) % tile_extent;
+    coords_end_[d] += tile_extent - offset - 1;
+    coords_end_[d] = std::min(coords_end_[d], subarray_[2 * d + 1]);
+  }
 }
 
 template <class T>
 Status WriteCellSlabIter<T>::compute_current_slab() {
   RETURN_NOT_OK(domain_->get_cell_pos<T>(&coords_start_[0], &slab_start_));
-  RETURN_NOT_OK(domain_->get_cell_pos<T>(&coords_end_[0], &slab_end_));
+
+  // The slab cells are contiguous in the tile and the end coordinates
+  // differ from the start ones at most along `slab_dim_`
+  auto d = slab_dim_;
+  slab_end_ = slab_start_ + (uint64_t)(coords_end_[d] - coords_start_[d]);
   assert(slab_start_ <= slab_end_);
   return Status::Ok();
 }
@@ -127,6 +127,28 @@ class WriteCellSlabIter {
   /** The array domain. */
   const Domain* domain_;
 
+  /** The number of dimensions. */
+  unsigned dim_num_;
+
+  /** The global domain of the array. */
+  const T* array_domain_;
+
+  /** The tile extents of the array. */
+  const T* tile_extents_;
+
+  /**
+   * `true` if the cell slabs may extend along `slab_dim_`, i.e., when
+   * the query layout is the global order or the cell order.
+   */
+  bool multi_cell_slabs_;
+
+  /**
+   * The dimension along which the cells of a slab are contiguous in a
+   * tile, i.e., the last one for row-major and the first one for
+   * col-major cell order.
+   */
+  unsigned slab_dim_;
+
   /** The query subarray. */
   std::vector<T> subarray_;
 
@@ -179,9 +201,19 @@ class WriteCellSlabIter {
   /** Computes the current start/end slab positions. */
   Status compute_current_slab();
 
-  /** Computes the end coordinates based on the current start coordinates. */
+  /**
+   * Computes the end coordinates based on the current start coordinates.
+   *
+   * @tparam N The number of dimensions if it is known at compile time
+   *     (which unrolls the per-dimension loops), or `0` otherwise.
+   */
+  template <unsigned N>
   void compute_current_end_coords();
 
+  /** Advances the iterator to the next slab. */
+  template <unsigned N>
+  void advance();
+
   /**
    * Computes the next start coordinates.
    *
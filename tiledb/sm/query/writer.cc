@@ -42,12 +42,20 @@
 #include "tiledb/sm/misc/stats.h"
 #include "tiledb/sm/misc/utils.h"
 #include "tiledb/sm/misc/uuid.h"
+#include "tiledb/sm/misc/var_offsets.h"
 #include "tiledb/sm/query/query_macros.h"
 #include "tiledb/sm/storage_manager/storage_manager.h"
+#include "tiledb/sm/storage_manager/write_buffer.h"
 #include "tiledb/sm/tile/tile_io.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <map>
 #include <sstream>
+#include <type_traits>
 
 namespace tiledb {
 namespace sm {
@@ -62,9 +70,23 @@ Writer::Writer() {
   coords_buffer_ = nullptr;
   coords_buffer_size_ = nullptr;
   coords_num_ = 0;
+  coords_bloom_filter_bits_ = 0;
+  offsets_bitsize_ = 64;
+  query_offsets_bitsize_ = 0;
+  offsets_extra_element_ = false;
+  offsets_in_elements_ = false;
+  rtree_str_packing_ = false;
+  fragment_sketches_ = false;
+  fragment_metadata_unfiltered_ = false;
+  fragment_part_ = false;
   has_coords_ = false;
   coord_buffer_is_set_ = false;
   global_write_state_.reset(nullptr);
+  async_flush_ = false;
+  unordered_fragment_num_ = 1;
+  capacity_target_tile_size_ = 0;
+  fragment_packing_max_size_ = 0;
+  use_write_buffer_ = true;
   initialized_ = false;
   layout_ = Layout::ROW_MAJOR;
   storage_manager_ = nullptr;
@@ -72,6 +94,7 @@ Writer::Writer() {
 }
 
 Writer::~Writer() {
+  wait_flush();
   std::free(subarray_);
   clear_coord_buffers();
 }
@@ -80,6 +103,46 @@ Writer::~Writer() {
 /*               API              */
 /* ****************************** */
 
+Status Writer::add_fragment_part(uint32_t part, URI* part_uri) {
+  std::lock_guard<std::mutex> lock(fragment_parts_mtx_);
+  if (layout_ != Layout::GLOBAL_ORDER)
+    return LOG_STATUS(Status::WriterError(
+        "Cannot add fragment part; The query layout must be global order"));
+  if (array_schema_->tile_colocation())
+    return LOG_STATUS(Status::WriterError(
+        "Cannot add fragment part; Co-located tiles cannot be stitched"));
+  if (global_write_state_ != nullptr)
+    return LOG_STATUS(Status::WriterError(
+        "Cannot add fragment part; The query already writes cells"));
+  if (fragment_parts_.count(part) != 0)
+    return LOG_STATUS(Status::WriterError(
+        "Cannot add fragment part; Part " + std::to_string(part) +
+        " already added"));
+
+  // The parts are written inside the fragment directory, which becomes a
+  // fragment only once the stitched fragment metadata is stored
+  if (fragment_uri_.to_string().empty()) {
+    std::string new_fragment_str;
+    uint64_t timestamp = 0;
+    RETURN_NOT_OK(new_fragment_name(&new_fragment_str, &timestamp));
+    auto uri = array_schema_->array_uri().join_path(new_fragment_str);
+    RETURN_NOT_OK(storage_manager_->create_dir(uri));
+    RETURN_NOT_OK(storage_manager_->create_dir(
+        uri.join_path(constants::fragment_parts_folder_name)));
+    fragment_uri_ = uri;
+  }
+
+  // Part names follow the fragment name format, with the part index in
+  // place of the UUID, so that their metadata loads like a fragment's
+  std::stringstream ss;
+  ss << "__0_0_" << part << "_" << constants::format_version;
+  *part_uri = fragment_uri_.join_path(constants::fragment_parts_folder_name)
+                  .join_path(ss.str());
+  fragment_parts_[part] = *part_uri;
+
+  return Status::Ok();
+}
+
 const ArraySchema* Writer::array_schema() const {
   return array_schema_;
 }
@@ -118,9 +181,16 @@ QueryBuffer Writer::buffer(const std::string& name) const {
 Status Writer::finalize() {
   if (global_write_state_ != nullptr)
     return finalize_global_write_state();
+  if (has_fragment_parts())
+    return finalize_fragment_parts();
   return Status::Ok();
 }
 
+bool Writer::has_fragment_parts() {
+  std::lock_guard<std::mutex> lock(fragment_parts_mtx_);
+  return !fragment_parts_.empty();
+}
+
 Status Writer::get_buffer(
     const std::string& name, void** buffer, uint64_t** buffer_size) const {
   // Special zipped coordinates
@@ -205,6 +275,14 @@ Status Writer::init() {
   if (buffers_.empty())
     return LOG_STATUS(
         Status::WriterError("Cannot initialize query; Buffers not set"));
+  if (fragment_part_ && layout_ != Layout::GLOBAL_ORDER)
+    return LOG_STATUS(Status::WriterError(
+        "Cannot initialize query; Fragment parts must be written in global "
+        "order"));
+  if (has_fragment_parts())
+    return LOG_STATUS(Status::WriterError(
+        "Cannot initialize query; The query only stitches the fragment parts "
+        "written by other queries"));
 
   if (subarray_ == nullptr)
     RETURN_NOT_OK(set_subarray(nullptr));
@@ -227,6 +305,44 @@ Status Writer::init() {
   check_coord_oob_ = !strcmp(check_coord_oob, "true");
   check_global_order_ = !strcmp(check_global_order, "true");
   dedup_coords_ = !strcmp(dedup_coords, "true");
+  bool found = false;
+  RETURN_NOT_OK(config.get<uint32_t>(
+      "sm.coords_bloom_filter_bits", &coords_bloom_filter_bits_, &found));
+  assert(found);
+  RETURN_NOT_OK(
+      config.get<bool>("sm.rtree_str_packing", &rtree_str_packing_, &found));
+  assert(found);
+  RETURN_NOT_OK(
+      config.get<bool>("sm.fragment_sketches", &fragment_sketches_, &found));
+  assert(found);
+  const char* value_index_attributes = nullptr;
+  RETURN_NOT_OK(
+      config.get("sm.value_index_attributes", &value_index_attributes));
+  assert(value_index_attributes != nullptr);
+  value_index_attributes_.clear();
+  std::stringstream value_index_ss(value_index_attributes);
+  std::string value_index_attribute;
+  while (std::getline(value_index_ss, value_index_attribute, ',')) {
+    if (!value_index_attribute.empty())
+      value_index_attributes_.push_back(value_index_attribute);
+  }
+  RETURN_NOT_OK(config.get<bool>(
+      "sm.fragment_metadata_unfiltered",
+      &fragment_metadata_unfiltered_,
+      &found));
+  assert(found);
+  RETURN_NOT_OK(
+      config.get<bool>("sm.write_async_flush", &async_flush_, &found));
+  assert(found);
+  RETURN_NOT_OK(config.get<uint64_t>(
+      "sm.unordered_write_fragment_num", &unordered_fragment_num_, &found));
+  assert(found);
+  RETURN_NOT_OK(config.get<uint64_t>(
+      "sm.capacity_target_tile_size", &capacity_target_tile_size_, &found));
+  assert(found);
+  RETURN_NOT_OK(config.get<uint64_t>(
+      "sm.fragment_packing_max_size", &fragment_packing_max_size_, &found));
+  assert(found);
   initialized_ = true;
 
   return Status::Ok();
@@ -352,9 +468,15 @@ Status Writer::set_buffer(
         std::string("Cannot set buffer for new attribute/dimension '") + name +
         "' after initialization"));
 
+  // The offsets may be in any of the formats of the `sm.var_offsets.*`
+  // parameters; they are converted while the tiles are prepared
+  RETURN_NOT_OK(init_offsets_format());
+  QueryBuffer buff(buffer_off, buffer_val, buffer_off_size, buffer_val_size);
+  RETURN_NOT_OK(check_var_offsets(name, buff));
+
   if (is_dim) {
     // Check number of coordinates
-    uint64_t coords_num = *buffer_off_size / constants::cell_var_offset_size;
+    uint64_t coords_num = var_cell_num(buff);
     if (coord_buffer_is_set_ && coords_num != coords_num_)
       return LOG_STATUS(Status::WriterError(
           std::string("Cannot set buffer; Input buffer for dimension '") +
@@ -368,8 +490,7 @@ Status Writer::set_buffer(
   }
 
   // Set attribute/dimension buffer
-  buffers_[name] =
-      QueryBuffer(buffer_off, buffer_val, buffer_off_size, buffer_val_size);
+  buffers_[name] = buff;
 
   return Status::Ok();
 }
@@ -378,6 +499,23 @@ void Writer::set_fragment_uri(const URI& fragment_uri) {
   fragment_uri_ = fragment_uri;
 }
 
+void Writer::set_fragment_part(const URI& part_uri) {
+  fragment_uri_ = part_uri;
+  fragment_part_ = true;
+}
+
+Status Writer::set_offsets_bitsize(uint32_t bitsize) {
+  if (bitsize != 32 && bitsize != 64)
+    return LOG_STATUS(Status::WriterError(
+        "Cannot set offsets bitsize; Must be 32 or 64"));
+  if (!buffers_.empty())
+    return LOG_STATUS(Status::WriterError(
+        "Cannot set offsets bitsize; It must be set before the buffers"));
+
+  query_offsets_bitsize_ = bitsize;
+  return Status::Ok();
+}
+
 Status Writer::set_layout(Layout layout) {
   // Ordered layout for writes in sparse arrays is meaningless
   if (!array_schema_->dense() &&
@@ -444,12 +582,19 @@ void* Writer::subarray() const {
 
 Status Writer::write() {
   STATS_FUNC_IN(writer_write);
+  STATS_HISTOGRAM_TIMER(writer_write);
 
   // In case the user has provided a coordinates buffer
   RETURN_NOT_OK(split_coords_buffer());
 
-  if (check_coord_oob_)
-    RETURN_NOT_OK(check_coord_oob());
+  // Validate the coordinates before they are sorted or written
+  RETURN_NOT_OK(check_coords());
+
+  // The unordered writes to sparse arrays may be batched in memory
+  auto write_buffer = storage_manager_->write_buffer();
+  if (write_buffer != nullptr && use_write_buffer_ &&
+      layout_ == Layout::UNORDERED && !array_schema_->dense())
+    return buffer_cells(write_buffer);
 
   if (layout_ == Layout::COL_MAJOR || layout_ == Layout::ROW_MAJOR) {
     RETURN_NOT_OK(ordered_write());
@@ -465,6 +610,10 @@ Status Writer::write() {
   STATS_FUNC_OUT(writer_write);
 }
 
+void Writer::disable_write_buffer() {
+  use_write_buffer_ = false;
+}
+
 const std::vector<WrittenFragmentInfo>& Writer::written_fragment_info() const {
   return written_fragment_info_;
 }
@@ -479,6 +628,32 @@ void Writer::add_written_fragment_info(const URI& uri) {
   written_fragment_info_.emplace_back(uri, timestamp_range);
 }
 
+Status Writer::buffer_cells(WriteBuffer* write_buffer) {
+  // Copy the cells, with the var-sized offsets in bytes
+  WriteBuffer::Cells cells;
+  for (const auto& it : buffers_) {
+    const auto& name = it.first;
+    const auto& buff = it.second;
+    auto& field = cells[name];
+    if (array_schema_->var_size(name)) {
+      auto cell_num = var_cell_num(buff);
+      auto unit = offsets_unit(name);
+      field.offsets_.resize(cell_num);
+      for (uint64_t i = 0; i < cell_num; ++i)
+        field.offsets_[i] = var_offset(buff, cell_num, unit, i);
+      auto values_size = var_offset(buff, cell_num, unit, cell_num);
+      auto values = (const uint8_t*)buff.buffer_var_;
+      field.values_.assign(values, values + values_size);
+    } else {
+      auto values = (const uint8_t*)buff.buffer_;
+      field.values_.assign(values, values + *buff.buffer_size_);
+    }
+  }
+
+  return write_buffer->append(
+      array_->array_uri(), array_->get_encryption_key(), std::move(cells));
+}
+
 Status Writer::check_buffer_names() {
   // If the array is sparse, the coordinates must be provided
   if (!array_schema_->dense() && !has_coords_)
@@ -513,11 +688,11 @@ Status Writer::check_buffer_sizes() const {
   for (const auto& it : buffers_) {
     const auto& attr = it.first;
     bool is_var = array_schema_->var_size(attr);
-    auto buffer_size = *it.second.buffer_size_;
     if (is_var) {
-      expected_cell_num = buffer_size / constants::cell_var_offset_size;
+      expected_cell_num = var_cell_num(it.second);
     } else {
-      expected_cell_num = buffer_size / array_schema_->cell_size(attr);
+      expected_cell_num =
+          *it.second.buffer_size_ / array_schema_->cell_size(attr);
     }
 
     if (expected_cell_num != cell_num) {
@@ -531,47 +706,39 @@ Status Writer::check_buffer_sizes() const {
   return Status::Ok();
 }
 
-Status Writer::check_coord_dups(const std::vector<uint64_t>& cell_pos) const {
-  STATS_FUNC_IN(writer_check_coord_dups);
-
-  if (!has_coords_) {
-    return LOG_STATUS(
-        Status::WriterError("Cannot check for coordinate duplicates; "
-                            "Coordinates buffer not found"));
-  }
-
-  if (coords_num_ < 2)
+Status Writer::check_var_offsets(
+    const std::string& name, const QueryBuffer& buff) const {
+  auto cell_num = var_cell_num(buff);
+  if (cell_num == 0)
     return Status::Ok();
 
-  // Prepare auxiliary vectors for better performance
-  auto dim_num = array_schema_->dim_num();
-  std::vector<unsigned char*> buffs(dim_num);
-  std::vector<uint64_t> coord_sizes(dim_num);
-  for (unsigned d = 0; d < dim_num; ++d) {
-    const auto& dim_name = array_schema_->dimension(d)->name();
-    buffs[d] = (unsigned char*)buffers_.find(dim_name)->second.buffer_;
-    coord_sizes[d] = array_schema_->cell_size(dim_name);
-  }
+  auto unit = offsets_unit(name);
+  auto buffer_var_size = *buff.buffer_var_size_;
+
+  // Check the offsets in parallel, in chunks of cells, each chunk
+  // comparing its first offset with the last one of the previous chunk
+  const uint64_t chunk_size = 1 << 16;
+  auto chunk_num = (cell_num + chunk_size - 1) / chunk_size;
+  auto statuses = parallel_for(0, chunk_num, [&](uint64_t k) {
+    auto begin = k * chunk_size;
+    auto end = std::min(cell_num, begin + chunk_size);
+    uint64_t prev_offset =
+        (begin > 0) ? var_offset(buff, cell_num, unit, begin - 1) : 0;
+    for (uint64_t i = begin; i < end; ++i) {
+      auto offset = var_offset(buff, cell_num, unit, i);
+      if (i > 0 && offset <= prev_offset)
+        return LOG_STATUS(
+            Status::WriterError("Invalid offsets; offsets must be given in "
+                                "strictly ascending order."));
 
-  auto statuses = parallel_for(1, coords_num_, [&](uint64_t i) {
-    // Check for duplicate in adjacent cells
-    bool found_dup = true;
-    for (unsigned d = 0; d < dim_num; ++d) {
-      if (memcmp(
-              buffs[d] + cell_pos[i] * coord_sizes[d],
-              buffs[d] + cell_pos[i - 1] * coord_sizes[d],
-              coord_sizes[d]) != 0) {  // Not the same
-        found_dup = false;
-        break;
-      }
-    }
+      if (offset >= buffer_var_size)
+        return LOG_STATUS(Status::WriterError(
+            "Invalid offsets; offset " + std::to_string(offset) +
+            " specified for buffer of size " +
+            std::to_string(buffer_var_size)));
 
-    // Found duplicate
-    if (found_dup) {
-      return LOG_STATUS(
-          Status::WriterError("Duplicate coordinates are not allowed"));
+      prev_offset = offset;
     }
-
     return Status::Ok();
   });
 
@@ -579,12 +746,21 @@ Status Writer::check_coord_dups(const std::vector<uint64_t>& cell_pos) const {
   for (auto& st : statuses)
     RETURN_NOT_OK(st);
 
+  // The extra offset ends the last cell within the values
+  if (offsets_extra_element_) {
+    auto prev_offset = var_offset(buff, cell_num, unit, cell_num - 1);
+    auto end_offset = var_offset(buff, cell_num, unit, cell_num);
+    if (end_offset <= prev_offset || end_offset > buffer_var_size)
+      return LOG_STATUS(Status::WriterError(
+          "Invalid offsets; extra offset " + std::to_string(end_offset) +
+          " specified for buffer of size " + std::to_string(buffer_var_size)));
+  }
+
   return Status::Ok();
-  STATS_FUNC_OUT(writer_check_coord_dups);
 }
 
-Status Writer::check_coord_dups() const {
-  STATS_FUNC_IN(writer_check_coord_dups_global);
+Status Writer::check_coord_dups(const std::vector<uint64_t>& cell_pos) const {
+  STATS_FUNC_IN(writer_check_coord_dups);
 
   if (!has_coords_) {
     return LOG_STATUS(
@@ -610,8 +786,8 @@ Status Writer::check_coord_dups() const {
     bool found_dup = true;
     for (unsigned d = 0; d < dim_num; ++d) {
       if (memcmp(
-              buffs[d] + i * coord_sizes[d],
-              buffs[d] + (i - 1) * coord_sizes[d],
+              buffs[d] + cell_pos[i] * coord_sizes[d],
+              buffs[d] + cell_pos[i - 1] * coord_sizes[d],
               coord_sizes[d]) != 0) {  // Not the same
         found_dup = false;
         break;
@@ -628,90 +804,98 @@ Status Writer::check_coord_dups() const {
   });
 
   // Check all statuses
-  for (auto& st : statuses) {
-    if (!st.ok())
-      return st;
-  }
+  for (auto& st : statuses)
+    RETURN_NOT_OK(st);
 
   return Status::Ok();
-
-  STATS_FUNC_OUT(writer_check_coord_dups_global);
+  STATS_FUNC_OUT(writer_check_coord_dups);
 }
 
-Status Writer::check_coord_oob() const {
+Status Writer::check_coords() const {
+  STATS_FUNC_IN(writer_check_coords);
+
   // Applicable only to sparse writes - exit if coordinates do not exist
-  if (!has_coords_)
+  if (!has_coords_ || coords_num_ == 0)
     return Status::Ok();
 
-  // Exit if there are no coordinates to write
-  if (coords_num_ == 0)
+  // Duplicates and the global order are checked here only for global
+  // order writes, whose coordinates are already sorted in the buffers
+  bool global = layout_ == Layout::GLOBAL_ORDER;
+  bool check_oob = check_coord_oob_;
+  bool check_dups = global && check_coord_dups_ && !dedup_coords_;
+  bool check_order = global && check_global_order_;
+  if (!check_oob && !check_dups && !check_order)
     return Status::Ok();
 
   // Prepare auxiliary vectors for better performance
   auto dim_num = array_schema_->dim_num();
-  std::vector<unsigned char*> buffs(dim_num);
+  std::vector<const void*> buffs(dim_num);
   std::vector<uint64_t> coord_sizes(dim_num);
   for (unsigned d = 0; d < dim_num; ++d) {
     const auto& dim_name = array_schema_->dimension(d)->name();
-    buffs[d] = (unsigned char*)buffers_.find(dim_name)->second.buffer_;
+    buffs[d] = buffers_.find(dim_name)->second.buffer_;
     coord_sizes[d] = array_schema_->cell_size(dim_name);
   }
 
-  // Check if all coordinates fall in the domain in parallel
-  auto statuses =
-      parallel_for_2d(0, coords_num_, 0, dim_num, [&](uint64_t c, unsigned d) {
-        auto dim = array_schema_->dimension(d);
-        std::string err_msg;
-        if (dim->oob(buffs[d] + c * coord_sizes[d], &err_msg))
-          return Status::WriterError(err_msg);
-        return Status::Ok();
-      });
-
-  // Check all statuses
-  for (auto& st : statuses)
-    RETURN_NOT_OK_ELSE(st, LOG_STATUS(st));
-
-  // Success
-  return Status::Ok();
-}
-
-Status Writer::check_global_order() const {
-  // Applicable only to sparse writes - exit if coordinates do not exist
-  if (!has_coords_ || coords_num_ < 2)
-    return Status::Ok();
+  // Check each cell, and its order with respect to the previous cell, in
+  // a single pass over chunks of cells in parallel
+  auto domain = array_schema_->domain();
+  const uint64_t chunk_size = 1 << 16;
+  auto chunk_num = (coords_num_ + chunk_size - 1) / chunk_size;
+  auto statuses = parallel_for(0, chunk_num, [&](uint64_t k) {
+    auto end = std::min(coords_num_, (k + 1) * chunk_size);
+    for (uint64_t c = k * chunk_size; c < end; ++c) {
+      if (check_oob) {
+        for (unsigned d = 0; d < dim_num; ++d) {
+          std::string err_msg;
+          auto coord = (const unsigned char*)buffs[d] + c * coord_sizes[d];
+          if (domain->dimension(d)->oob(coord, &err_msg))
+            return LOG_STATUS(Status::WriterError(err_msg));
+        }
+      }
 
-  // Prepare auxiliary vector for better performance
-  auto dim_num = array_schema_->dim_num();
-  std::vector<const void*> buffs(dim_num);
-  for (unsigned d = 0; d < dim_num; ++d) {
-    const auto& dim_name = array_schema_->dimension(d)->name();
-    buffs[d] = buffers_.find(dim_name)->second.buffer_;
-  }
+      if (c == 0)
+        continue;
 
-  // Check if all coordinates fall in the domain in parallel
-  auto domain = array_schema_->domain();
-  auto statuses = parallel_for(0, coords_num_ - 1, [&](uint64_t i) {
-    auto tile_cmp = domain->tile_order_cmp(buffs, i, i + 1);
-    auto fail = (tile_cmp > 0) || ((tile_cmp == 0) &&
-                                   domain->cell_order_cmp(buffs, i, i + 1) > 0);
+      if (check_dups) {
+        bool found_dup = true;
+        for (unsigned d = 0; d < dim_num; ++d) {
+          auto buff = (const unsigned char*)buffs[d];
+          if (memcmp(
+                  buff + c * coord_sizes[d],
+                  buff + (c - 1) * coord_sizes[d],
+                  coord_sizes[d]) != 0) {  // Not the same
+            found_dup = false;
+            break;
+          }
+        }
+        if (found_dup)
+          return LOG_STATUS(
+              Status::WriterError("Duplicate coordinates are not allowed"));
+      }
 
-    if (fail) {
-      std::stringstream ss;
-      ss << "Write failed; Coordinates " << coords_to_str(i);
-      ss << " succeed " << coords_to_str(i + 1);
-      ss << " in the global order";
-      return LOG_STATUS(Status::WriterError(ss.str()));
+      if (check_order) {
+        auto tile_cmp = domain->tile_order_cmp(buffs, c - 1, c);
+        if (tile_cmp > 0 ||
+            (tile_cmp == 0 && domain->cell_order_cmp(buffs, c - 1, c) > 0)) {
+          std::stringstream ss;
+          ss << "Write failed; Coordinates " << coords_to_str(c - 1);
+          ss << " succeed " << coords_to_str(c);
+          ss << " in the global order";
+          return LOG_STATUS(Status::WriterError(ss.str()));
+        }
+      }
     }
     return Status::Ok();
   });
 
   // Check all statuses
-  for (auto& st : statuses) {
-    if (!st.ok())
-      return st;
-  }
+  for (auto& st : statuses)
+    RETURN_NOT_OK(st);
 
   return Status::Ok();
+
+  STATS_FUNC_OUT(writer_check_coords);
 }
 
 Status Writer::check_subarray() const {
@@ -818,6 +1002,10 @@ void Writer::clear_coord_buffers() {
 }
 
 Status Writer::close_files(FragmentMetadata* meta) const {
+  // The tiles of co-located fragments are in a single file
+  if (array_schema_->tile_colocation())
+    return storage_manager_->close_file(meta->packed_uri());
+
   // Close attribute and dimension files
   for (const auto& it : buffers_) {
     const auto& name = it.first;
@@ -831,7 +1019,7 @@ Status Writer::close_files(FragmentMetadata* meta) const {
 
 Status Writer::compute_coord_dups(
     const std::vector<uint64_t>& cell_pos,
-    std::set<uint64_t>* coord_dups) const {
+    std::vector<uint8_t>* coord_dups) const {
   STATS_FUNC_IN(writer_compute_coord_dups);
   if (!has_coords_) {
     return LOG_STATUS(
@@ -852,7 +1040,9 @@ Status Writer::compute_coord_dups(
     coord_sizes[d] = array_schema_->cell_size(dim_name);
   }
 
-  std::mutex mtx;
+  // Each cell marks only its own position, so no locking is needed
+  coord_dups->assign(coords_num_, 0);
+  std::atomic<uint64_t> dups_num(0);
   auto statuses = parallel_for(1, coords_num_, [&](uint64_t i) {
     // Check for duplicate in adjacent cells
     bool found_dup = true;
@@ -868,8 +1058,8 @@ Status Writer::compute_coord_dups(
 
     // Found duplicate
     if (found_dup) {
-      std::lock_guard<std::mutex> lock(mtx);
-      coord_dups->insert(cell_pos[i]);
+      (*coord_dups)[cell_pos[i]] = 1;
+      ++dups_num;
     }
 
     return Status::Ok();
@@ -879,12 +1069,15 @@ Status Writer::compute_coord_dups(
   for (auto& st : statuses)
     RETURN_NOT_OK(st);
 
+  if (dups_num == 0)
+    coord_dups->clear();
+
   return Status::Ok();
 
   STATS_FUNC_OUT(writer_compute_coord_dups);
 }
 
-Status Writer::compute_coord_dups(std::set<uint64_t>* coord_dups) const {
+Status Writer::compute_coord_dups(std::vector<uint8_t>* coord_dups) const {
   STATS_FUNC_IN(writer_compute_coord_dups_global);
 
   if (!has_coords_) {
@@ -906,7 +1099,9 @@ Status Writer::compute_coord_dups(std::set<uint64_t>* coord_dups) const {
     coord_sizes[d] = array_schema_->cell_size(dim_name);
   }
 
-  std::mutex mtx;
+  // Each cell marks only its own position, so no locking is needed
+  coord_dups->assign(coords_num_, 0);
+  std::atomic<uint64_t> dups_num(0);
   auto statuses = parallel_for(1, coords_num_, [&](uint64_t i) {
     // Check for duplicate in adjacent cells
     bool found_dup = true;
@@ -922,8 +1117,8 @@ Status Writer::compute_coord_dups(std::set<uint64_t>* coord_dups) const {
 
     // Found duplicate
     if (found_dup) {
-      std::lock_guard<std::mutex> lock(mtx);
-      coord_dups->insert(i);
+      (*coord_dups)[i] = 1;
+      ++dups_num;
     }
 
     return Status::Ok();
@@ -935,40 +1130,158 @@ Status Writer::compute_coord_dups(std::set<uint64_t>* coord_dups) const {
       return st;
   }
 
+  if (dups_num == 0)
+    coord_dups->clear();
+
   return Status::Ok();
 
   STATS_FUNC_OUT(writer_compute_coord_dups_global);
 }
 
-Status Writer::compute_coords_metadata(
+Status Writer::compute_fragment_partitions(
+    const std::vector<uint64_t>& cell_pos,
+    std::vector<uint64_t>* starts) const {
+  starts->assign(1, 0);
+
+  // The partitions are determined by the space tiles and named fragments
+  // cannot be split
+  auto domain = array_schema_->domain();
+  auto dim_num = array_schema_->dim_num();
+  if (unordered_fragment_num_ < 2 || !fragment_uri_.to_string().empty())
+    return Status::Ok();
+  for (unsigned d = 0; d < dim_num; ++d) {
+    if (domain->dimension(d)->tile_extent() == nullptr)
+      return Status::Ok();
+  }
+
+  switch (domain->type()) {
+    case Datatype::INT8:
+      compute_fragment_partitions<int8_t>(cell_pos, starts);
+      break;
+    case Datatype::UINT8:
+      compute_fragment_partitions<uint8_t>(cell_pos, starts);
+      break;
+    case Datatype::INT16:
+      compute_fragment_partitions<int16_t>(cell_pos, starts);
+      break;
+    case Datatype::UINT16:
+      compute_fragment_partitions<uint16_t>(cell_pos, starts);
+      break;
+    case Datatype::INT32:
+      compute_fragment_partitions<int32_t>(cell_pos, starts);
+      break;
+    case Datatype::UINT32:
+      compute_fragment_partitions<uint32_t>(cell_pos, starts);
+      break;
+    case Datatype::INT64:
+    case Datatype::DATETIME_YEAR:
+    case Datatype::DATETIME_MONTH:
+    case Datatype::DATETIME_WEEK:
+    case Datatype::DATETIME_DAY:
+    case Datatype::DATETIME_HR:
+    case Datatype::DATETIME_MIN:
+    case Datatype::DATETIME_SEC:
+    case Datatype::DATETIME_MS:
+    case Datatype::DATETIME_US:
+    case Datatype::DATETIME_NS:
+    case Datatype::DATETIME_PS:
+    case Datatype::DATETIME_FS:
+    case Datatype::DATETIME_AS:
+      compute_fragment_partitions<int64_t>(cell_pos, starts);
+      break;
+    case Datatype::UINT64:
+      compute_fragment_partitions<uint64_t>(cell_pos, starts);
+      break;
+    case Datatype::FLOAT32:
+      compute_fragment_partitions<float>(cell_pos, starts);
+      break;
+    case Datatype::FLOAT64:
+      compute_fragment_partitions<double>(cell_pos, starts);
+      break;
+    default:
+      break;
+  }
+
+  return Status::Ok();
+}
+
+template <class T>
+void Writer::compute_fragment_partitions(
+    const std::vector<uint64_t>& cell_pos,
+    std::vector<uint64_t>* starts) const {
+  // For easy reference
+  auto domain = array_schema_->domain();
+  auto dim_num = array_schema_->dim_num();
+  auto d = (domain->tile_order() == Layout::ROW_MAJOR) ? 0 : dim_num - 1;
+  auto dim = domain->dimension(d);
+  auto buff = (const T*)buffers_.find(dim->name())->second.buffer_;
+  auto low = ((const T*)dim->domain())[0];
+  auto extent = *(const T*)dim->tile_extent();
+
+  // The space tile of a cell on the dimension. The unsigned conversions of
+  // the integer types compute the differences modulo 2^64, which is exact
+  // since the coordinates are in the domain.
+  auto tile_idx = [&](uint64_t pos) -> uint64_t {
+    if (std::is_integral<T>::value)
+      return ((uint64_t)buff[pos] - (uint64_t)low) / (uint64_t)extent;
+    return (uint64_t)(((double)buff[pos] - (double)low) / (double)extent);
+  };
+
+  // Start a new partition at the first tile change after each multiple of
+  // the target partition size. The cells are in the global order, so the
+  // space tile on the dimension never decreases.
+  auto cell_num = (uint64_t)cell_pos.size();
+  auto part_size = utils::math::ceil(cell_num, unordered_fragment_num_);
+  for (uint64_t i = part_size; i < cell_num;) {
+    auto prev = tile_idx(cell_pos[i - 1]);
+    while (i < cell_num && tile_idx(cell_pos[i]) == prev)
+      ++i;
+    if (i == cell_num)
+      break;
+    starts->push_back(i);
+    i += part_size;
+  }
+}
+
+Status Writer::compute_attr_metadata(
     const std::unordered_map<std::string, std::vector<Tile>>& tiles,
     FragmentMetadata* meta) const {
-  STATS_FUNC_IN(writer_compute_coords_metadata);
+  for (const auto& it : tiles)
+    RETURN_NOT_OK(compute_attr_metadata(it.first, it.second, meta));
 
-  auto coords_type = array_schema_->coords_type();
-  switch (coords_type) {
+  return Status::Ok();
+}
+
+Status Writer::compute_attr_metadata(
+    const std::string& name,
+    const std::vector<Tile>& tiles,
+    FragmentMetadata* meta) const {
+  if (!meta->has_tile_min_max_sum(name))
+    return Status::Ok();
+
+  STATS_FUNC_IN(writer_compute_attr_metadata);
+
+  switch (array_schema_->type(name)) {
     case Datatype::INT8:
-      return compute_coords_metadata<int8_t>(tiles, meta);
+      return compute_attr_metadata<int8_t, uint64_t>(name, tiles, meta);
     case Datatype::UINT8:
-      return compute_coords_metadata<uint8_t>(tiles, meta);
+      return compute_attr_metadata<uint8_t, uint64_t>(name, tiles, meta);
     case Datatype::INT16:
-      return compute_coords_metadata<int16_t>(tiles, meta);
+      return compute_attr_metadata<int16_t, uint64_t>(name, tiles, meta);
     case Datatype::UINT16:
-      return compute_coords_metadata<uint16_t>(tiles, meta);
+      return compute_attr_metadata<uint16_t, uint64_t>(name, tiles, meta);
     case Datatype::INT32:
-      return compute_coords_metadata<int32_t>(tiles, meta);
+      return compute_attr_metadata<int32_t, uint64_t>(name, tiles, meta);
     case Datatype::UINT32:
-      return compute_coords_metadata<uint32_t>(tiles, meta);
+      return compute_attr_metadata<uint32_t, uint64_t>(name, tiles, meta);
     case Datatype::INT64:
-      return compute_coords_metadata<int64_t>(tiles, meta);
+      return compute_attr_metadata<int64_t, uint64_t>(name, tiles, meta);
     case Datatype::UINT64:
-      return compute_coords_metadata<uint64_t>(tiles, meta);
+      return compute_attr_metadata<uint64_t, uint64_t>(name, tiles, meta);
     case Datatype::FLOAT32:
-      assert(!array_schema_->dense());
-      return compute_coords_metadata<float>(tiles, meta);
+      return compute_attr_metadata<float, double>(name, tiles, meta);
     case Datatype::FLOAT64:
-      assert(!array_schema_->dense());
-      return compute_coords_metadata<double>(tiles, meta);
+      return compute_attr_metadata<double, double>(name, tiles, meta);
     case Datatype::DATETIME_YEAR:
     case Datatype::DATETIME_MONTH:
     case Datatype::DATETIME_WEEK:
@@ -982,40 +1295,156 @@ Status Writer::compute_coords_metadata(
     case Datatype::DATETIME_PS:
     case Datatype::DATETIME_FS:
     case Datatype::DATETIME_AS:
-      return compute_coords_metadata<int64_t>(tiles, meta);
+      return compute_attr_metadata<int64_t, uint64_t>(name, tiles, meta);
     default:
       return LOG_STATUS(Status::WriterError(
-          "Cannot compute coordinates metadata; Unsupported domain type"));
+          "Cannot compute attribute metadata; Unsupported attribute type"));
   }
 
   return Status::Ok();
 
-  STATS_FUNC_OUT(writer_compute_coords_metadata);
+  STATS_FUNC_OUT(writer_compute_attr_metadata);
 }
 
-template <class T>
-Status Writer::compute_coords_metadata(
-    const std::unordered_map<std::string, std::vector<Tile>>& tiles,
+template <class T, class S>
+Status Writer::compute_attr_metadata(
+    const std::string& name,
+    const std::vector<Tile>& tiles,
     FragmentMetadata* meta) const {
-  // Applicable only if there are coordinates
-  if (!has_coords_)
-    return Status::Ok();
+  // Signed integers are summed as unsigned, which wraps around on overflow
+  // and yields the same bits as a wrapping signed sum
+  const bool sketches = meta->has_sketches(name);
+  const bool value_index = meta->has_value_index(name);
+  auto statuses = parallel_for(0, tiles.size(), [&](uint64_t t) {
+    const auto& tile = tiles[t];
+    auto cell_num = tile.cell_num();
+    if (cell_num == 0)
+      return Status::Ok();
 
-  // Check if tiles are empty
-  if (tiles.empty() || tiles.begin()->second.empty())
-    return Status::Ok();
+    auto data = (const T*)tile.internal_data();
+    T min = data[0], max = data[0];
+    S sum = 0;
+    bool has_nan = false;
+    for (uint64_t c = 0; c < cell_num; ++c) {
+      const auto& v = data[c];
+      if (std::is_floating_point<T>::value)
+        has_nan |= std::isnan(static_cast<double>(v));
+      if (v < min)
+        min = v;
+      if (v > max)
+        max = v;
+      sum += static_cast<S>(v);
+    }
 
-  // Compute number of tiles. Assumes all attributes and
-  // and dimensions have the same number of tiles
-  auto it = tiles.begin();
-  auto tile_num = array_schema_->var_size(it->first) ? it->second.size() / 2 :
-                                                       it->second.size();
-  auto dim_num = array_schema_->dim_num();
+    // The value range of a tile with NaN values is unknown
+    if (has_nan) {
+      min = std::numeric_limits<T>::quiet_NaN();
+      max = min;
+    }
 
-  // Compute MBRs
-  auto statuses = parallel_for(0, tile_num, [&](uint64_t t) {
-    std::vector<T> mbr(2 * dim_num);
-    std::vector<T*> data(dim_num);
+    meta->set_tile_min_max_sum(name, t, &min, &max, &sum);
+
+    // The sketches of each tile are merged into those of the fragment
+    if (sketches) {
+      HyperLogLog hll;
+      KllSketch kll;
+      for (uint64_t c = 0; c < cell_num; ++c) {
+        hll.add(HyperLogLog::hash_value<T>(data[c]));
+        kll.add(static_cast<double>(data[c]));
+      }
+      meta->add_sketches(name, hll, kll);
+    }
+
+    if (value_index)
+      meta->add_value_index_tile(name, t, data, cell_num);
+
+    return Status::Ok();
+  });
+
+  for (const auto& st : statuses)
+    RETURN_NOT_OK(st);
+
+  return Status::Ok();
+}
+
+Status Writer::compute_coords_metadata(
+    const std::unordered_map<std::string, std::vector<Tile>>& tiles,
+    FragmentMetadata* meta) const {
+  STATS_FUNC_IN(writer_compute_coords_metadata);
+
+  auto coords_type = array_schema_->coords_type();
+  switch (coords_type) {
+    case Datatype::INT8:
+      return compute_coords_metadata<int8_t>(tiles, meta);
+    case Datatype::UINT8:
+      return compute_coords_metadata<uint8_t>(tiles, meta);
+    case Datatype::INT16:
+      return compute_coords_metadata<int16_t>(tiles, meta);
+    case Datatype::UINT16:
+      return compute_coords_metadata<uint16_t>(tiles, meta);
+    case Datatype::INT32:
+      return compute_coords_metadata<int32_t>(tiles, meta);
+    case Datatype::UINT32:
+      return compute_coords_metadata<uint32_t>(tiles, meta);
+    case Datatype::INT64:
+      return compute_coords_metadata<int64_t>(tiles, meta);
+    case Datatype::UINT64:
+      return compute_coords_metadata<uint64_t>(tiles, meta);
+    case Datatype::FLOAT32:
+      assert(!array_schema_->dense());
+      return compute_coords_metadata<float>(tiles, meta);
+    case Datatype::FLOAT64:
+      assert(!array_schema_->dense());
+      return compute_coords_metadata<double>(tiles, meta);
+    case Datatype::DATETIME_YEAR:
+    case Datatype::DATETIME_MONTH:
+    case Datatype::DATETIME_WEEK:
+    case Datatype::DATETIME_DAY:
+    case Datatype::DATETIME_HR:
+    case Datatype::DATETIME_MIN:
+    case Datatype::DATETIME_SEC:
+    case Datatype::DATETIME_MS:
+    case Datatype::DATETIME_US:
+    case Datatype::DATETIME_NS:
+    case Datatype::DATETIME_PS:
+    case Datatype::DATETIME_FS:
+    case Datatype::DATETIME_AS:
+      return compute_coords_metadata<int64_t>(tiles, meta);
+    default:
+      return LOG_STATUS(Status::WriterError(
+          "Cannot compute coordinates metadata; Unsupported domain type"));
+  }
+
+  return Status::Ok();
+
+  STATS_FUNC_OUT(writer_compute_coords_metadata);
+}
+
+template <class T>
+Status Writer::compute_coords_metadata(
+    const std::unordered_map<std::string, std::vector<Tile>>& tiles,
+    FragmentMetadata* meta) const {
+  // Applicable only if there are coordinates
+  if (!has_coords_)
+    return Status::Ok();
+
+  // Check if tiles are empty
+  if (tiles.empty() || tiles.begin()->second.empty())
+    return Status::Ok();
+
+  // Compute number of tiles. Assumes all attributes and
+  // and dimensions have the same number of tiles
+  auto it = tiles.begin();
+  auto tile_num = array_schema_->var_size(it->first) ? it->second.size() / 2 :
+                                                       it->second.size();
+  auto dim_num = array_schema_->dim_num();
+
+  // Compute MBRs, and the coordinate hashes of the bloom filter
+  std::vector<std::vector<uint64_t>> hashes(
+      coords_bloom_filter_bits_ > 0 ? tile_num : 0);
+  auto statuses = parallel_for(0, tile_num, [&](uint64_t t) {
+    std::vector<T> mbr(2 * dim_num);
+    std::vector<T*> data(dim_num);
     uint64_t cell_num = UINT64_MAX;
     for (unsigned d = 0; d < dim_num; ++d) {
       const auto& dim_name = array_schema_->dimension(d)->name();
@@ -1026,17 +1455,23 @@ Status Writer::compute_coords_metadata(
           cell_num == UINT64_MAX || cell_num == tiles_it->second[t].cell_num());
       cell_num = tiles_it->second[t].cell_num();
 
-      // Initialize MBR with the first coords
-      mbr[2 * d] = data[d][0];
-      mbr[2 * d + 1] = data[d][0];
+      // Compute the MBR range on the dimension in a single sweep
+      assert(cell_num > 0);
+      utils::geometry::compute_range<T>(data[d], cell_num, &mbr[2 * d]);
     }
 
-    // Expand the MBR with the rest coords
-    assert(cell_num > 0);
-    for (uint64_t c = 1; c < cell_num; ++c)
-      utils::geometry::expand_mbr<T>(data, c, &mbr[0]);
-
     meta->set_mbr(t, &mbr[0]);
+
+    if (!hashes.empty()) {
+      std::vector<T> coords(dim_num);
+      hashes[t].resize(cell_num);
+      for (uint64_t c = 0; c < cell_num; ++c) {
+        for (unsigned d = 0; d < dim_num; ++d)
+          coords[d] = data[d][c];
+        hashes[t][c] = BloomFilter::hash_coords<T>(&coords[0], dim_num);
+      }
+    }
+
     return Status::Ok();
   });
 
@@ -1044,6 +1479,9 @@ Status Writer::compute_coords_metadata(
   for (auto& st : statuses)
     RETURN_NOT_OK(st);
 
+  for (const auto& tile_hashes : hashes)
+    meta->add_coords_hashes(tile_hashes);
+
   // Set last tile cell number
   const auto& dim_name = array_schema_->dimension(0)->name();
   uint64_t last_tile_cell_num = tiles.find(dim_name)->second.back().cell_num();
@@ -1127,6 +1565,13 @@ Status Writer::create_fragment(
   auto timestamp_range = std::pair<uint64_t, uint64_t>(timestamp, timestamp);
   *frag_meta = std::make_shared<FragmentMetadata>(
       storage_manager_, array_schema_, uri, timestamp_range, dense);
+  if (!dense) {
+    (*frag_meta)->set_coords_bloom_filter_bits(coords_bloom_filter_bits_);
+    (*frag_meta)->set_rtree_str_packing(rtree_str_packing_);
+  }
+  (*frag_meta)->set_sketches(fragment_sketches_);
+  (*frag_meta)->set_value_index_attributes(value_index_attributes_);
+  (*frag_meta)->set_unfiltered(fragment_metadata_unfiltered_);
 
   RETURN_NOT_OK((*frag_meta)->init(subarray_));
   return storage_manager_->create_dir(uri);
@@ -1153,19 +1598,84 @@ Status Writer::filter_tiles(
   return Status::Ok();
 }
 
+Status Writer::filter_and_write_all_tiles(
+    FragmentMetadata* frag_meta,
+    std::unordered_map<std::string, std::vector<Tile>>* tiles) const {
+  // The tiles of co-located and packed fragments are written to a single
+  // file once all are filtered
+  bool colocate = array_schema_->tile_colocation();
+  bool pack = !colocate && layout_ != Layout::GLOBAL_ORDER &&
+              fragment_packing_max_size_ > 0;
+
+  auto num = buffers_.size();
+  auto statuses = parallel_for(0, num, [&](uint64_t i) {
+    auto buff_it = buffers_.begin();
+    std::advance(buff_it, i);
+    const auto& name = buff_it->first;
+    auto& name_tiles = (*tiles)[name];
+    RETURN_CANCEL_OR_ERROR(filter_tiles(name, &name_tiles));
+    if (!colocate && !pack)
+      RETURN_CANCEL_OR_ERROR(write_tiles(name, frag_meta, name_tiles));
+    return Status::Ok();
+  });
+
+  // Check all statuses
+  for (auto& st : statuses)
+    RETURN_NOT_OK(st);
+
+  if (colocate)
+    RETURN_CANCEL_OR_ERROR(write_tiles_colocated(frag_meta, *tiles));
+  else if (pack)
+    RETURN_CANCEL_OR_ERROR(write_tiles_packed(frag_meta, *tiles));
+
+  return Status::Ok();
+}
+
 Status Writer::filter_tiles(
     const std::string& name, std::vector<Tile>* tiles) const {
   STATS_FUNC_IN(writer_filter_tiles);
 
   bool var_size = array_schema_->var_size(name);
-  // Filter all tiles
+
+  // Get the filter pipelines, appending an encryption filter when necessary
+  FilterPipeline filters = *array_schema_->filters(name);
+  RETURN_NOT_OK(FilterPipeline::append_encryption_filter(
+      &filters, array_->get_encryption_key()));
+  FilterPipeline offsets_filters = *array_schema_->cell_var_offsets_filters();
+  RETURN_NOT_OK(FilterPipeline::append_encryption_filter(
+      &offsets_filters, array_->get_encryption_key()));
+
+  // Give each tile its own copy of the appropriate pipeline. For var-sized
+  // tiles, the data tiles are filtered with their unfiltered offsets tile,
+  // which is only replaced once all chunks are filtered.
   auto tile_num = tiles->size();
+  std::vector<FilterPipeline> pipelines;
+  pipelines.reserve(tile_num);
+  std::vector<const FilterPipeline*> pipeline_ptrs;
+  std::vector<Tile*> tile_ptrs;
+  std::vector<const Tile*> offsets_tiles;
+  std::vector<uint64_t> orig_sizes;
   for (size_t i = 0; i < tile_num; ++i) {
-    RETURN_NOT_OK(filter_tile(name, &(*tiles)[i], var_size));
-    if (var_size) {
-      ++i;
-      RETURN_NOT_OK(filter_tile(name, &(*tiles)[i], false));
-    }
+    bool offsets = var_size && i % 2 == 0;
+    pipelines.emplace_back(offsets ? offsets_filters : filters);
+    pipeline_ptrs.push_back(&pipelines.back());
+    tile_ptrs.push_back(&(*tiles)[i]);
+    offsets_tiles.push_back(
+        (var_size && !offsets) ? &(*tiles)[i - 1] : nullptr);
+    orig_sizes.push_back((*tiles)[i].buffer()->size());
+  }
+
+  // Filter the chunks of all tiles together
+  RETURN_CANCEL_OR_ERROR(FilterPipeline::run_forward(
+      pipeline_ptrs,
+      tile_ptrs,
+      offsets_tiles,
+      storage_manager_->cancellation_flag()));
+
+  for (size_t i = 0; i < tile_num; ++i) {
+    (*tiles)[i].set_filtered(true);
+    (*tiles)[i].set_pre_filtered_size(orig_sizes[i]);
+    STATS_COUNTER_ADD(writer_num_bytes_before_filtering, orig_sizes[i]);
   }
 
   return Status::Ok();
@@ -1173,26 +1683,39 @@ Status Writer::filter_tiles(
   STATS_FUNC_OUT(writer_filter_tiles);
 }
 
-Status Writer::filter_tile(
-    const std::string& name, Tile* tile, bool offsets) const {
-  auto orig_size = tile->buffer()->size();
-
-  // Get a copy of the appropriate filter pipeline.
-  FilterPipeline filters =
-      (offsets ? *array_schema_->cell_var_offsets_filters() :
-                 *array_schema_->filters(name));
+Status Writer::finalize_fragment_parts() {
+  std::vector<URI> part_uris;
+  {
+    std::lock_guard<std::mutex> lock(fragment_parts_mtx_);
+    for (const auto& part : fragment_parts_)
+      part_uris.push_back(part.second);
+    fragment_parts_.clear();
+  }
+  auto uri = fragment_uri_;
 
-  // Append an encryption filter when necessary.
-  RETURN_NOT_OK(FilterPipeline::append_encryption_filter(
-      &filters, array_->get_encryption_key()));
+  // Stitch the parts
+  std::shared_ptr<FragmentMetadata> meta;
+  RETURN_NOT_OK_ELSE(
+      storage_manager_->fragment_parts_stitch(array_, uri, part_uris, &meta),
+      clean_up(uri));
 
-  RETURN_NOT_OK(filters.run_forward(tile));
+  // Nothing to commit if no part has cells
+  if (meta == nullptr) {
+    clean_up(uri);
+    return Status::Ok();
+  }
 
-  tile->set_filtered(true);
-  tile->set_pre_filtered_size(orig_size);
-  STATS_COUNTER_ADD(writer_num_bytes_before_filtering, orig_size);
+  // Delete the parts and flush the fragment metadata to storage
+  RETURN_NOT_OK_ELSE(
+      storage_manager_->vfs()->remove_dir(
+          uri.join_path(constants::fragment_parts_folder_name)),
+      clean_up(uri));
+  RETURN_NOT_OK_ELSE(meta->store(array_->get_encryption_key()), clean_up(uri));
 
-  return Status::Ok();
+  // Add written fragment info
+  add_written_fragment_info(uri);
+  return storage_manager_->update_array_manifest(
+      array_schema_->array_uri(), array_->get_encryption_key(), {uri}, {});
 }
 
 Status Writer::finalize_global_write_state() {
@@ -1200,8 +1723,16 @@ Status Writer::finalize_global_write_state() {
   auto meta = global_write_state_->frag_meta_.get();
   auto uri = meta->fragment_uri();
 
+  // Wait for the tiles of the last submission to be written
+  Status st = wait_flush();
+  if (!st.ok()) {
+    close_files(meta);
+    clean_up(uri);
+    return st;
+  }
+
   // Handle last tile
-  Status st = global_write_handle_last_tile();
+  st = global_write_handle_last_tile();
   if (!st.ok()) {
     close_files(meta);
     clean_up(uri);
@@ -1241,8 +1772,13 @@ Status Writer::finalize_global_write_state() {
   // Flush fragment metadata to storage
   RETURN_NOT_OK_ELSE(meta->store(array_->get_encryption_key()), clean_up(uri));
 
-  // Add written fragment info
-  add_written_fragment_info(uri);
+  // Add written fragment info, unless the fragment is a part that the
+  // query stitching it commits
+  if (!fragment_part_) {
+    add_written_fragment_info(uri);
+    RETURN_NOT_OK(storage_manager_->update_array_manifest(
+        array_schema_->array_uri(), array_->get_encryption_key(), {uri}, {}));
+  }
 
   // Delete global write state
   global_write_state_.reset(nullptr);
@@ -1260,16 +1796,8 @@ Status Writer::global_write() {
   auto frag_meta = global_write_state_->frag_meta_.get();
   auto uri = frag_meta->fragment_uri();
 
-  // Check for coordinate duplicates
-  if (has_coords_) {
-    if (check_coord_dups_ && !dedup_coords_)
-      RETURN_CANCEL_OR_ERROR(check_coord_dups());
-    if (check_global_order_)
-      RETURN_CANCEL_OR_ERROR(check_global_order());
-  }
-
   // Retrieve coordinate duplicates
-  std::set<uint64_t> coord_dups;
+  std::vector<uint8_t> coord_dups;
   if (dedup_coords_)
     RETURN_CANCEL_OR_ERROR(compute_coord_dups(&coord_dups));
 
@@ -1289,6 +1817,10 @@ Status Writer::global_write() {
   if (tile_num == 0)
     return Status::Ok();
 
+  // The fragment metadata is updated by the flush of the previous
+  // submission, which must complete first
+  RETURN_CANCEL_OR_ERROR_ELSE(wait_flush(), clean_up(uri));
+
   // Set new number of tiles in the fragment metadata
   auto new_num_tiles = frag_meta->tile_index_base() + tile_num;
   frag_meta->set_num_tiles(new_num_tiles);
@@ -1297,11 +1829,30 @@ Status Writer::global_write() {
   RETURN_CANCEL_OR_ERROR_ELSE(
       compute_coords_metadata(tiles, frag_meta), clean_up(uri));
 
-  // Filter all tiles
-  RETURN_CANCEL_OR_ERROR_ELSE(filter_tiles(&tiles), clean_up(uri));
+  // Compute attribute metadata
+  RETURN_CANCEL_OR_ERROR_ELSE(
+      compute_attr_metadata(tiles, frag_meta), clean_up(uri));
+
+  // Filter and write the tiles in the background. The tiles own copies of
+  // the cells, so the user may refill the buffers meanwhile. Errors are
+  // reported by the next submission or the finalization.
+  if (async_flush_) {
+    auto flushed = std::make_shared<
+        std::unordered_map<std::string, std::vector<Tile>>>(std::move(tiles));
+    flush_task_ = std::async(
+        std::launch::async, [this, frag_meta, flushed, new_num_tiles]() {
+          RETURN_NOT_OK(filter_and_write_all_tiles(frag_meta, flushed.get()));
+          recommend_capacity(*flushed);
+          frag_meta->set_tile_index_base(new_num_tiles);
+          return Status::Ok();
+        });
+    return Status::Ok();
+  }
 
-  // Write tiles for all attributes
-  RETURN_CANCEL_OR_ERROR_ELSE(write_all_tiles(frag_meta, tiles), clean_up(uri));
+  // Filter and write the tiles of each attribute
+  RETURN_CANCEL_OR_ERROR_ELSE(
+      filter_and_write_all_tiles(frag_meta, &tiles), clean_up(uri));
+  recommend_capacity(tiles);
 
   // Increment the tile index base for the next global order write.
   frag_meta->set_tile_index_base(new_num_tiles);
@@ -1309,6 +1860,12 @@ Status Writer::global_write() {
   return Status::Ok();
 }
 
+Status Writer::wait_flush() {
+  if (!flush_task_.valid())
+    return Status::Ok();
+  return flush_task_.get();
+}
+
 Status Writer::global_write_handle_last_tile() {
   if (all_last_tiles_empty())
     return Status::Ok();
@@ -1366,6 +1923,9 @@ Status Writer::filter_last_tiles(
   auto meta = global_write_state_->frag_meta_.get();
   RETURN_NOT_OK(compute_coords_metadata(*tiles, meta));
 
+  // Compute attribute metadata
+  RETURN_NOT_OK(compute_attr_metadata(*tiles, meta));
+
   // Filter tiles
   RETURN_NOT_OK(filter_tiles(tiles));
 
@@ -1426,6 +1986,24 @@ Status Writer::init_global_write_state() {
   STATS_FUNC_OUT(writer_init_global_write_state);
 }
 
+Status Writer::init_offsets_format() {
+  auto config = storage_manager_->config();
+  bool found = false;
+  RETURN_NOT_OK(config.get<uint32_t>(
+      "sm.var_offsets.bitsize", &offsets_bitsize_, &found));
+  assert(found);
+  if (query_offsets_bitsize_ != 0)
+    offsets_bitsize_ = query_offsets_bitsize_;
+  RETURN_NOT_OK(config.get<bool>(
+      "sm.var_offsets.extra_element", &offsets_extra_element_, &found));
+  assert(found);
+  const char* offsets_mode;
+  RETURN_NOT_OK(config.get("sm.var_offsets.mode", &offsets_mode));
+  offsets_in_elements_ = std::string(offsets_mode) == "elements";
+
+  return Status::Ok();
+}
+
 Status Writer::init_tile(const std::string& name, Tile* tile) const {
   // For easy reference
   auto cell_size = array_schema_->cell_size(name);
@@ -1642,34 +2220,41 @@ Status Writer::ordered_write() {
   // Set number of tiles in the fragment metadata
   frag_meta->set_num_tiles(tile_num);
 
-  // Prepare tiles and filter attribute tiles
+  // Prepare, filter and write the attribute tiles
   std::unordered_map<std::string, std::vector<Tile>> attr_tiles;
   RETURN_NOT_OK_ELSE(
-      prepare_and_filter_attr_tiles(write_cell_ranges, &attr_tiles),
+      prepare_filter_and_write_attr_tiles(
+          write_cell_ranges, frag_meta.get(), &attr_tiles),
       clean_up(uri));
 
-  // Write tiles for all attributes
-  RETURN_NOT_OK_ELSE(
-      write_all_tiles(frag_meta.get(), attr_tiles),
-      storage_manager_->vfs()->remove_dir(uri));
-
   // Write the fragment metadata
   RETURN_CANCEL_OR_ERROR_ELSE(
       frag_meta->store(array_->get_encryption_key()), clean_up(uri));
 
   // Add written fragment info
   add_written_fragment_info(frag_meta->fragment_uri());
+  RETURN_NOT_OK(storage_manager_->update_array_manifest(
+      array_schema_->array_uri(),
+      array_->get_encryption_key(),
+      {frag_meta->fragment_uri()},
+      {}));
 
   return Status::Ok();
 }
 
-Status Writer::prepare_and_filter_attr_tiles(
+Status Writer::prepare_filter_and_write_attr_tiles(
     const std::vector<WriteCellRangeVec>& write_cell_ranges,
+    FragmentMetadata* meta,
     std::unordered_map<std::string, std::vector<Tile>>* attr_tiles) const {
   // Initialize attribute tiles
   for (const auto& it : buffers_)
     (*attr_tiles)[it.first] = std::vector<Tile>();
 
+  // The tiles of co-located and packed fragments are written to a single
+  // file once all are filtered
+  bool colocate = array_schema_->tile_colocation();
+  bool pack = !colocate && fragment_packing_max_size_ > 0;
+
   uint64_t attr_num = buffers_.size();
   auto statuses = parallel_for(0, attr_num, [&](uint64_t i) {
     auto buff_it = buffers_.begin();
@@ -1677,7 +2262,10 @@ Status Writer::prepare_and_filter_attr_tiles(
     const auto& attr = buff_it->first;
     auto& tiles = (*attr_tiles)[attr];
     RETURN_CANCEL_OR_ERROR(prepare_tiles(attr, write_cell_ranges, &tiles));
+    RETURN_CANCEL_OR_ERROR(compute_attr_metadata(attr, tiles, meta));
     RETURN_CANCEL_OR_ERROR(filter_tiles(attr, &tiles));
+    if (!colocate && !pack)
+      RETURN_CANCEL_OR_ERROR(write_tiles(attr, meta, tiles));
     return Status::Ok();
   });
 
@@ -1685,11 +2273,16 @@ Status Writer::prepare_and_filter_attr_tiles(
   for (auto& st : statuses)
     RETURN_NOT_OK(st);
 
+  if (colocate)
+    RETURN_CANCEL_OR_ERROR(write_tiles_colocated(meta, *attr_tiles));
+  else if (pack)
+    RETURN_CANCEL_OR_ERROR(write_tiles_packed(meta, *attr_tiles));
+
   return Status::Ok();
 }
 
 Status Writer::prepare_full_tiles(
-    const std::set<uint64_t>& coord_dups,
+    const std::vector<uint8_t>& coord_dups,
     std::unordered_map<std::string, std::vector<Tile>>* tiles) const {
   // Initialize attribute and coordinate tiles
   for (const auto& it : buffers_)
@@ -1715,7 +2308,7 @@ Status Writer::prepare_full_tiles(
 
 Status Writer::prepare_full_tiles(
     const std::string& name,
-    const std::set<uint64_t>& coord_dups,
+    const std::vector<uint8_t>& coord_dups,
     std::vector<Tile>* tiles) const {
   return array_schema_->var_size(name) ?
              prepare_full_tiles_var(name, coord_dups, tiles) :
@@ -1724,7 +2317,7 @@ Status Writer::prepare_full_tiles(
 
 Status Writer::prepare_full_tiles_fixed(
     const std::string& name,
-    const std::set<uint64_t>& coord_dups,
+    const std::vector<uint8_t>& coord_dups,
     std::vector<Tile>* tiles) const {
   STATS_FUNC_IN(writer_prepare_full_tiles_fixed);
   // For easy reference
@@ -1753,7 +2346,7 @@ Status Writer::prepare_full_tiles_fixed(
       } while (!last_tile.full() && cell_idx != cell_num);
     } else {
       do {
-        if (coord_dups.find(cell_idx) == coord_dups.end())
+        if (!coord_dups[cell_idx])
           RETURN_NOT_OK(
               last_tile.write(buffer + cell_idx * cell_size, cell_size));
         ++cell_idx;
@@ -1794,7 +2387,7 @@ Status Writer::prepare_full_tiles_fixed(
     } else {
       for (uint64_t tile_idx = 0, i = 0; i < cell_num_to_write;
            ++cell_idx, ++i) {
-        if (coord_dups.find(cell_idx) == coord_dups.end()) {
+        if (!coord_dups[cell_idx]) {
           if ((*tiles)[tile_idx].full())
             ++tile_idx;
 
@@ -1813,7 +2406,7 @@ Status Writer::prepare_full_tiles_fixed(
     }
   } else {
     for (; cell_idx < cell_num; ++cell_idx) {
-      if (coord_dups.find(cell_idx) == coord_dups.end())
+      if (!coord_dups[cell_idx])
         RETURN_NOT_OK(
             last_tile.write(buffer + cell_idx * cell_size, cell_size));
     }
@@ -1828,21 +2421,19 @@ Status Writer::prepare_full_tiles_fixed(
 
 Status Writer::prepare_full_tiles_var(
     const std::string& name,
-    const std::set<uint64_t>& coord_dups,
+    const std::vector<uint8_t>& coord_dups,
     std::vector<Tile>* tiles) const {
   STATS_FUNC_IN(writer_prepare_full_tiles_var);
 
   // For easy reference
-  auto it = buffers_.find(name);
-  auto buffer = (uint64_t*)it->second.buffer_;
-  auto buffer_var = (unsigned char*)it->second.buffer_var_;
-  auto buffer_size = it->second.buffer_size_;
-  auto buffer_var_size = it->second.buffer_var_size_;
+  const auto& buff = buffers_.find(name)->second;
+  auto buffer_var = (unsigned char*)buff.buffer_var_;
+  auto unit = offsets_unit(name);
   auto capacity = array_schema_->capacity();
-  auto cell_num = *buffer_size / constants::cell_var_offset_size;
+  auto cell_num = var_cell_num(buff);
   auto domain = array_schema_->domain();
   auto cell_num_per_tile = has_coords_ ? capacity : domain->cell_num_per_tile();
-  uint64_t offset, var_size;
+  uint64_t offset, start, var_size;
 
   // Do nothing if there are no cells to write
   if (cell_num == 0)
@@ -1855,33 +2446,27 @@ Status Writer::prepare_full_tiles_var(
   uint64_t cell_idx = 0;
   if (!last_tile.empty()) {
     if (coord_dups.empty()) {
-      do {
-        // Write offset
-        offset = last_tile_var.size();
-        RETURN_NOT_OK(last_tile.write(&offset, sizeof(offset)));
-
-        // Write var-sized value
-        var_size = (cell_idx == cell_num - 1) ?
-                       *buffer_var_size - buffer[cell_idx] :
-                       buffer[cell_idx + 1] - buffer[cell_idx];
-        RETURN_NOT_OK(
-            last_tile_var.write(&buffer_var[buffer[cell_idx]], var_size));
-
-        ++cell_idx;
-      } while (!last_tile.full() && cell_idx != cell_num);
+      auto num = std::min(
+          cell_num_per_tile - last_tile.cell_num(), cell_num - cell_idx);
+      RETURN_NOT_OK(write_cell_range_to_tile_var(
+          buff,
+          unit,
+          cell_idx,
+          cell_idx + num - 1,
+          &last_tile,
+          &last_tile_var));
+      cell_idx += num;
     } else {
       do {
-        if (coord_dups.find(cell_idx) == coord_dups.end()) {
+        if (!coord_dups[cell_idx]) {
           // Write offset
           offset = last_tile_var.size();
           RETURN_NOT_OK(last_tile.write(&offset, sizeof(offset)));
 
           // Write var-sized value
-          var_size = (cell_idx == cell_num - 1) ?
-                         *buffer_var_size - buffer[cell_idx] :
-                         buffer[cell_idx + 1] - buffer[cell_idx];
-          RETURN_NOT_OK(
-              last_tile_var.write(&buffer_var[buffer[cell_idx]], var_size));
+          start = var_offset(buff, cell_num, unit, cell_idx);
+          var_size = var_offset(buff, cell_num, unit, cell_idx + 1) - start;
+          RETURN_NOT_OK(last_tile_var.write(&buffer_var[start], var_size));
         }
 
         ++cell_idx;
@@ -1912,28 +2497,30 @@ Status Writer::prepare_full_tiles_var(
       assert(last_tile_var.empty());
     }
 
-    // Write all remaining cells one by one
+    // Write all remaining cells, a tile at a time without duplicates and
+    // one by one otherwise
     if (coord_dups.empty()) {
-      for (uint64_t tile_idx = 0, i = 0; i < cell_num_to_write;
-           ++cell_idx, ++i) {
+      for (uint64_t tile_idx = 0, i = 0; i < cell_num_to_write;) {
         if ((*tiles)[tile_idx].full())
           tile_idx += 2;
 
-        // Write offset
-        offset = (*tiles)[tile_idx + 1].size();
-        RETURN_NOT_OK((*tiles)[tile_idx].write(&offset, sizeof(offset)));
-
-        // Write var-sized value
-        var_size = (cell_idx == cell_num - 1) ?
-                       *buffer_var_size - buffer[cell_idx] :
-                       buffer[cell_idx + 1] - buffer[cell_idx];
-        RETURN_NOT_OK((*tiles)[tile_idx + 1].write(
-            &buffer_var[buffer[cell_idx]], var_size));
+        auto num = std::min(
+            cell_num_per_tile - (*tiles)[tile_idx].cell_num(),
+            cell_num_to_write - i);
+        RETURN_NOT_OK(write_cell_range_to_tile_var(
+            buff,
+            unit,
+            cell_idx,
+            cell_idx + num - 1,
+            &(*tiles)[tile_idx],
+            &(*tiles)[tile_idx + 1]));
+        cell_idx += num;
+        i += num;
       }
     } else {
       for (uint64_t tile_idx = 0, i = 0; i < cell_num_to_write;
            ++cell_idx, ++i) {
-        if (coord_dups.find(cell_idx) == coord_dups.end()) {
+        if (!coord_dups[cell_idx]) {
           if ((*tiles)[tile_idx].full())
             tile_idx += 2;
 
@@ -1942,11 +2529,10 @@ Status Writer::prepare_full_tiles_var(
           RETURN_NOT_OK((*tiles)[tile_idx].write(&offset, sizeof(offset)));
 
           // Write var-sized value
-          var_size = (cell_idx == cell_num - 1) ?
-                         *buffer_var_size - buffer[cell_idx] :
-                         buffer[cell_idx + 1] - buffer[cell_idx];
-          RETURN_NOT_OK((*tiles)[tile_idx + 1].write(
-              &buffer_var[buffer[cell_idx]], var_size));
+          start = var_offset(buff, cell_num, unit, cell_idx);
+          var_size = var_offset(buff, cell_num, unit, cell_idx + 1) - start;
+          RETURN_NOT_OK(
+              (*tiles)[tile_idx + 1].write(&buffer_var[start], var_size));
         }
       }
     }
@@ -1955,31 +2541,22 @@ Status Writer::prepare_full_tiles_var(
   // Potentially fill the last tile
   assert(cell_num - cell_idx < cell_num_per_tile - last_tile.cell_num());
   if (coord_dups.empty()) {
-    for (; cell_idx < cell_num; ++cell_idx) {
-      // Write offset
-      offset = last_tile_var.size();
-      RETURN_NOT_OK(last_tile.write(&offset, sizeof(offset)));
-
-      // Write var-sized value
-      var_size = (cell_idx == cell_num - 1) ?
-                     *buffer_var_size - buffer[cell_idx] :
-                     buffer[cell_idx + 1] - buffer[cell_idx];
-      RETURN_NOT_OK(
-          last_tile_var.write(&buffer_var[buffer[cell_idx]], var_size));
+    if (cell_idx < cell_num) {
+      RETURN_NOT_OK(write_cell_range_to_tile_var(
+          buff, unit, cell_idx, cell_num - 1, &last_tile, &last_tile_var));
+      cell_idx = cell_num;
     }
   } else {
     for (; cell_idx < cell_num; ++cell_idx) {
-      if (coord_dups.find(cell_idx) == coord_dups.end()) {
+      if (!coord_dups[cell_idx]) {
         // Write offset
         offset = last_tile_var.size();
         RETURN_NOT_OK(last_tile.write(&offset, sizeof(offset)));
 
         // Write var-sized value
-        var_size = (cell_idx == cell_num - 1) ?
-                       *buffer_var_size - buffer[cell_idx] :
-                       buffer[cell_idx + 1] - buffer[cell_idx];
-        RETURN_NOT_OK(
-            last_tile_var.write(&buffer_var[buffer[cell_idx]], var_size));
+        start = var_offset(buff, cell_num, unit, cell_idx);
+        var_size = var_offset(buff, cell_num, unit, cell_idx + 1) - start;
+        RETURN_NOT_OK(last_tile_var.write(&buffer_var[start], var_size));
       }
     }
   }
@@ -2004,23 +2581,32 @@ Status Writer::prepare_tiles(
 
   // For easy reference
   auto var_size = array_schema_->var_size(attribute);
-  auto it = buffers_.find(attribute);
-  auto buffer = (uint64_t*)it->second.buffer_;
-  auto buffer_var = (uint64_t*)it->second.buffer_var_;
-  auto buffer_size = it->second.buffer_size_;
-  auto buffer_var_size = it->second.buffer_var_size_;
+  const auto& query_buff = buffers_.find(attribute)->second;
+  auto buffer = query_buff.buffer_;
+  auto buffer_size = query_buff.buffer_size_;
   auto cell_val_num = array_schema_->cell_val_num(attribute);
+  auto unit = var_size ? offsets_unit(attribute) : 0;
 
   // Initialize tiles and buffer
   RETURN_NOT_OK(init_tiles(attribute, tile_num, tiles));
   auto buff = std::make_shared<ConstBuffer>(buffer, *buffer_size);
-  auto buff_var =
-      (!var_size) ? nullptr :
-                    std::make_shared<ConstBuffer>(buffer_var, *buffer_var_size);
 
   // Populate each tile with the write cell ranges
   uint64_t end_pos = array_schema_->domain()->cell_num_per_tile() - 1;
   for (size_t i = 0, t = 0; i < tile_num; ++i, t += (var_size) ? 2 : 1) {
+    // A fixed-sized tile written by a single range of cells borrows them
+    // from the user buffer, which outlives the filtering of the tile
+    const auto& wcrs = write_cell_ranges[i];
+    if (!var_size && wcrs.size() == 1 && wcrs[0].pos_ == 0 &&
+        wcrs[0].end_ - wcrs[0].start_ == end_pos) {
+      auto cell_size = (*tiles)[t].cell_size();
+      RETURN_NOT_OK((*tiles)[t].set_borrowed_data(
+          (unsigned char*)buffer + wcrs[0].start_ * cell_size,
+          (end_pos + 1) * cell_size));
+      STATS_COUNTER_ADD(writer_num_tiles_borrowed, 1);
+      continue;
+    }
+
     uint64_t pos = 0;
     for (const auto& wcr : write_cell_ranges[i]) {
       // Write empty range
@@ -2037,8 +2623,8 @@ Status Writer::prepare_tiles(
       // Write (non-empty) range
       if (var_size)
         write_cell_range_to_tile_var(
-            buff.get(),
-            buff_var.get(),
+            query_buff,
+            unit,
             wcr.start_,
             wcr.end_,
             &(*tiles)[t],
@@ -2067,7 +2653,7 @@ Status Writer::prepare_tiles(
 
 Status Writer::prepare_tiles(
     const std::vector<uint64_t>& cell_pos,
-    const std::set<uint64_t>& coord_dups,
+    const std::vector<uint8_t>& coord_dups,
     std::unordered_map<std::string, std::vector<Tile>>* tiles) const {
   // Initialize attribute tiles
   tiles->clear();
@@ -2095,7 +2681,7 @@ Status Writer::prepare_tiles(
 Status Writer::prepare_tiles(
     const std::string& name,
     const std::vector<uint64_t>& cell_pos,
-    const std::set<uint64_t>& coord_dups,
+    const std::vector<uint8_t>& coord_dups,
     std::vector<Tile>* tiles) const {
   return array_schema_->var_size(name) ?
              prepare_tiles_var(name, cell_pos, coord_dups, tiles) :
@@ -2105,7 +2691,7 @@ Status Writer::prepare_tiles(
 Status Writer::prepare_tiles_fixed(
     const std::string& name,
     const std::vector<uint64_t>& cell_pos,
-    const std::set<uint64_t>& coord_dups,
+    const std::vector<uint8_t>& coord_dups,
     std::vector<Tile>* tiles) const {
   STATS_FUNC_IN(writer_prepare_tiles_fixed);
 
@@ -2118,7 +2704,11 @@ Status Writer::prepare_tiles_fixed(
   auto cell_size = array_schema_->cell_size(name);
   auto cell_num = (uint64_t)cell_pos.size();
   auto capacity = array_schema_->capacity();
-  auto dups_num = coord_dups.size();
+  uint64_t dups_num = 0;
+  if (!coord_dups.empty()) {
+    for (auto pos : cell_pos)
+      dups_num += coord_dups[pos];
+  }
   auto tile_num = utils::math::ceil(cell_num - dups_num, capacity);
 
   // Initialize tiles
@@ -2137,7 +2727,7 @@ Status Writer::prepare_tiles_fixed(
     }
   } else {
     for (uint64_t i = 0, tile_idx = 0; i < cell_num; ++i) {
-      if (coord_dups.find(cell_pos[i]) != coord_dups.end())
+      if (coord_dups[cell_pos[i]])
         continue;
 
       if ((*tiles)[tile_idx].full())
@@ -2156,20 +2746,25 @@ Status Writer::prepare_tiles_fixed(
 Status Writer::prepare_tiles_var(
     const std::string& name,
     const std::vector<uint64_t>& cell_pos,
-    const std::set<uint64_t>& coord_dups,
+    const std::vector<uint8_t>& coord_dups,
     std::vector<Tile>* tiles) const {
   STATS_FUNC_IN(writer_prepare_tiles_var);
 
   // For easy reference
-  auto it = buffers_.find(name);
-  auto buffer = (uint64_t*)it->second.buffer_;
-  auto buffer_var = (unsigned char*)it->second.buffer_var_;
-  auto buffer_var_size = it->second.buffer_var_size_;
+  const auto& buff = buffers_.find(name)->second;
+  auto buffer_var = (unsigned char*)buff.buffer_var_;
+  auto unit = offsets_unit(name);
+  auto buffer_cell_num = var_cell_num(buff);
   auto cell_num = (uint64_t)cell_pos.size();
   auto capacity = array_schema_->capacity();
-  auto dups_num = coord_dups.size();
+  uint64_t dups_num = 0;
+  if (!coord_dups.empty()) {
+    for (auto pos : cell_pos)
+      dups_num += coord_dups[pos];
+  }
   auto tile_num = utils::math::ceil(cell_num - dups_num, capacity);
   uint64_t offset;
+  uint64_t start;
   uint64_t var_size;
 
   // Initialize tiles
@@ -2189,15 +2784,14 @@ Status Writer::prepare_tiles_var(
       RETURN_NOT_OK((*tiles)[tile_idx].write(&offset, sizeof(offset)));
 
       // Write var-sized value
-      var_size = (cell_pos[i] == cell_num - 1) ?
-                     *buffer_var_size - buffer[cell_pos[i]] :
-                     buffer[cell_pos[i] + 1] - buffer[cell_pos[i]];
-      RETURN_NOT_OK((*tiles)[tile_idx + 1].write(
-          &buffer_var[buffer[cell_pos[i]]], var_size));
+      start = var_offset(buff, buffer_cell_num, unit, cell_pos[i]);
+      var_size =
+          var_offset(buff, buffer_cell_num, unit, cell_pos[i] + 1) - start;
+      RETURN_NOT_OK((*tiles)[tile_idx + 1].write(&buffer_var[start], var_size));
     }
   } else {
     for (uint64_t i = 0, tile_idx = 0; i < cell_num; ++i) {
-      if (coord_dups.find(cell_pos[i]) != coord_dups.end())
+      if (coord_dups[cell_pos[i]])
         continue;
 
       if ((*tiles)[tile_idx].full())
@@ -2208,11 +2802,10 @@ Status Writer::prepare_tiles_var(
       RETURN_NOT_OK((*tiles)[tile_idx].write(&offset, sizeof(offset)));
 
       // Write var-sized value
-      var_size = (cell_pos[i] == cell_num - 1) ?
-                     *buffer_var_size - buffer[cell_pos[i]] :
-                     buffer[cell_pos[i] + 1] - buffer[cell_pos[i]];
-      RETURN_NOT_OK((*tiles)[tile_idx + 1].write(
-          &buffer_var[buffer[cell_pos[i]]], var_size));
+      start = var_offset(buff, buffer_cell_num, unit, cell_pos[i]);
+      var_size =
+          var_offset(buff, buffer_cell_num, unit, cell_pos[i] + 1) - start;
+      RETURN_NOT_OK((*tiles)[tile_idx + 1].write(&buffer_var[start], var_size));
     }
   }
 
@@ -2227,6 +2820,41 @@ void Writer::reset() {
   initialized_ = false;
 }
 
+void Writer::recommend_capacity(
+    const std::unordered_map<std::string, std::vector<Tile>>& tiles) const {
+  if (capacity_target_tile_size_ == 0 || array_schema_->dense() ||
+      !stats::all_stats.enabled())
+    return;
+
+  // Count the cells from the unfiltered size of the first dimension tiles
+  const auto& dim_name = array_schema_->dimension(0)->name();
+  auto dim_it = tiles.find(dim_name);
+  if (dim_it == tiles.end())
+    return;
+  uint64_t cell_num = 0;
+  auto coord_size = array_schema_->cell_size(dim_name);
+  for (const auto& tile : dim_it->second)
+    cell_num += tile.pre_filtered_size() / coord_size;
+
+  // Find the largest filtered size of the tiles of a file, i.e., of the
+  // offsets or values of an attribute or dimension
+  uint64_t max_size = 0;
+  for (const auto& it : tiles) {
+    auto var_size = array_schema_->var_size(it.first);
+    uint64_t sizes[2] = {0, 0};
+    for (size_t i = 0; i < it.second.size(); ++i)
+      sizes[var_size ? i % 2 : 0] += it.second[i].buffer()->size();
+    max_size = std::max(max_size, std::max(sizes[0], sizes[1]));
+  }
+  if (cell_num == 0 || max_size == 0)
+    return;
+
+  STATS_COUNTER_MAX(
+      writer_recommended_capacity,
+      std::max<uint64_t>(
+          1, (double)capacity_target_tile_size_ * cell_num / max_size));
+}
+
 Status Writer::sort_coords(std::vector<uint64_t>* cell_pos) const {
   STATS_FUNC_IN(writer_sort_coords);
 
@@ -2241,11 +2869,110 @@ Status Writer::sort_coords(std::vector<uint64_t>* cell_pos) const {
     buffs[d] = (const void*)buffers_.find(dim_name)->second.buffer_;
   }
 
+  // Sort on the Hilbert values, computed once per cell
+  if (domain->cell_order() == Layout::HILBERT)
+    return sort_coords_on_hilbert_values(buffs, cell_pos);
+
   // Populate cell_pos
   cell_pos->resize(coords_num_);
   for (uint64_t i = 0; i < coords_num_; ++i)
     (*cell_pos)[i] = i;
 
+  // Cells already in the global order, or in a few long sorted runs (e.g.,
+  // appends in nearly global order), only need their runs merged
+  if (merge_sorted_runs(GlobalCmp(domain, &buffs), cell_pos))
+    return Status::Ok();
+
+  // Sort integer coordinates on their global order keys
+  bool sorted = false;
+  switch (domain->type()) {
+    case Datatype::INT8:
+      sorted = sort_coords_on_global_keys<int8_t>(cell_pos);
+      break;
+    case Datatype::UINT8:
+      sorted = sort_coords_on_global_keys<uint8_t>(cell_pos);
+      break;
+    case Datatype::INT16:
+      sorted = sort_coords_on_global_keys<int16_t>(cell_pos);
+      break;
+    case Datatype::UINT16:
+      sorted = sort_coords_on_global_keys<uint16_t>(cell_pos);
+      break;
+    case Datatype::INT32:
+      sorted = sort_coords_on_global_keys<int32_t>(cell_pos);
+      break;
+    case Datatype::UINT32:
+      sorted = sort_coords_on_global_keys<uint32_t>(cell_pos);
+      break;
+    case Datatype::INT64:
+    case Datatype::DATETIME_YEAR:
+    case Datatype::DATETIME_MONTH:
+    case Datatype::DATETIME_WEEK:
+    case Datatype::DATETIME_DAY:
+    case Datatype::DATETIME_HR:
+    case Datatype::DATETIME_MIN:
+    case Datatype::DATETIME_SEC:
+    case Datatype::DATETIME_MS:
+    case Datatype::DATETIME_US:
+    case Datatype::DATETIME_NS:
+    case Datatype::DATETIME_PS:
+    case Datatype::DATETIME_FS:
+    case Datatype::DATETIME_AS:
+      sorted = sort_coords_on_global_keys<int64_t>(cell_pos);
+      break;
+    case Datatype::UINT64:
+      sorted = sort_coords_on_global_keys<uint64_t>(cell_pos);
+      break;
+    default:
+      break;
+  }
+  if (sorted) {
+    STATS_COUNTER_ADD(writer_coords_sorted_on_keys, 1);
+    return Status::Ok();
+  }
+
+  // Sort with comparators specialized on the common domain types if
+  // possible
+  switch (domain->type()) {
+    case Datatype::INT32:
+      sorted = sort_coords_typed<int32_t>(buffs, cell_pos);
+      break;
+    case Datatype::UINT32:
+      sorted = sort_coords_typed<uint32_t>(buffs, cell_pos);
+      break;
+    case Datatype::INT64:
+    case Datatype::DATETIME_YEAR:
+    case Datatype::DATETIME_MONTH:
+    case Datatype::DATETIME_WEEK:
+    case Datatype::DATETIME_DAY:
+    case Datatype::DATETIME_HR:
+    case Datatype::DATETIME_MIN:
+    case Datatype::DATETIME_SEC:
+    case Datatype::DATETIME_MS:
+    case Datatype::DATETIME_US:
+    case Datatype::DATETIME_NS:
+    case Datatype::DATETIME_PS:
+    case Datatype::DATETIME_FS:
+    case Datatype::DATETIME_AS:
+      sorted = sort_coords_typed<int64_t>(buffs, cell_pos);
+      break;
+    case Datatype::UINT64:
+      sorted = sort_coords_typed<uint64_t>(buffs, cell_pos);
+      break;
+    case Datatype::FLOAT32:
+      sorted = sort_coords_typed<float>(buffs, cell_pos);
+      break;
+    case Datatype::FLOAT64:
+      sorted = sort_coords_typed<double>(buffs, cell_pos);
+      break;
+    default:
+      break;
+  }
+  if (sorted) {
+    STATS_COUNTER_ADD(writer_coords_sorted_typed, 1);
+    return Status::Ok();
+  }
+
   // Sort the coordinates in global order
   parallel_sort(cell_pos->begin(), cell_pos->end(), GlobalCmp(domain, &buffs));
 
@@ -2254,6 +2981,186 @@ Status Writer::sort_coords(std::vector<uint64_t>* cell_pos) const {
   STATS_FUNC_OUT(writer_sort_coords);
 }
 
+template <class T>
+bool Writer::sort_coords_typed(
+    const std::vector<const void*>& buffs,
+    std::vector<uint64_t>* cell_pos) const {
+  switch (array_schema_->dim_num()) {
+    case 1:
+      sort_coords_typed_dims<T, 1>(buffs, cell_pos);
+      return true;
+    case 2:
+      sort_coords_typed_dims<T, 2>(buffs, cell_pos);
+      return true;
+    case 3:
+      sort_coords_typed_dims<T, 3>(buffs, cell_pos);
+      return true;
+    case 4:
+      sort_coords_typed_dims<T, 4>(buffs, cell_pos);
+      return true;
+    default:
+      return false;
+  }
+}
+
+template <class T, unsigned N>
+void Writer::sort_coords_typed_dims(
+    const std::vector<const void*>& buffs,
+    std::vector<uint64_t>* cell_pos) const {
+  parallel_sort(
+      cell_pos->begin(),
+      cell_pos->end(),
+      TypedGlobalCmp<T, N>(array_schema_->domain(), &buffs));
+}
+
+Status Writer::sort_coords_on_hilbert_values(
+    const std::vector<const void*>& buffs,
+    std::vector<uint64_t>* cell_pos) const {
+  auto domain = array_schema_->domain();
+
+  // Compute the Hilbert values in parallel, in chunks of cells
+  std::vector<uint64_t> hilbert_values(coords_num_);
+  const uint64_t chunk_size = 1 << 16;
+  auto chunk_num = (coords_num_ + chunk_size - 1) / chunk_size;
+  if (chunk_num > 0) {
+    parallel_for(0, chunk_num, [&](uint64_t c) {
+      auto end = std::min(coords_num_, (c + 1) * chunk_size);
+      for (uint64_t i = c * chunk_size; i < end; ++i)
+        hilbert_values[i] = domain->hilbert_value(buffs, i);
+      return Status::Ok();
+    });
+  }
+
+  // Populate cell_pos
+  cell_pos->resize(coords_num_);
+  for (uint64_t i = 0; i < coords_num_; ++i)
+    (*cell_pos)[i] = i;
+
+  // Sort the coordinates in global order, unless only sorted runs need to
+  // be merged
+  HilbertCmp cmp(domain, &buffs, &hilbert_values);
+  if (!merge_sorted_runs(cmp, cell_pos))
+    parallel_sort(cell_pos->begin(), cell_pos->end(), cmp);
+
+  return Status::Ok();
+}
+
+template <class CmpT>
+bool Writer::merge_sorted_runs(
+    const CmpT& cmp, std::vector<uint64_t>* cell_pos) const {
+  // Merging is worth it over sorting only for a few long runs
+  const uint64_t max_run_num = 64;
+  const uint64_t min_run_size = 4096;
+  auto run_num_limit =
+      std::max<uint64_t>(1, std::min(max_run_num, coords_num_ / min_run_size));
+
+  uint64_t run_num = 0;
+  if (!parallel_merge_sorted_runs(
+          cell_pos->begin(), cell_pos->end(), cmp, run_num_limit, &run_num))
+    return false;
+
+  if (run_num <= 1) {
+    STATS_COUNTER_ADD(writer_coords_already_sorted, 1);
+  } else {
+    STATS_COUNTER_ADD(writer_coords_sorted_runs_merged, run_num);
+  }
+  return true;
+}
+
+template <class T>
+bool Writer::sort_coords_on_global_keys(std::vector<uint64_t>* cell_pos) const {
+  if (coords_num_ == 0)
+    return false;
+
+  // For easy reference
+  auto domain = array_schema_->domain();
+  auto dim_num = array_schema_->dim_num();
+  std::vector<const T*> buffs(dim_num);
+  std::vector<uint64_t> lows(dim_num), extents(dim_num, 0);
+  for (unsigned d = 0; d < dim_num; ++d) {
+    auto dim = domain->dimension(d);
+    buffs[d] = (const T*)buffers_.find(dim->name())->second.buffer_;
+    lows[d] = (uint64_t)((const T*)dim->domain())[0];
+    if (dim->tile_extent() != nullptr)
+      extents[d] = (uint64_t)*(const T*)dim->tile_extent();
+  }
+
+  // The space tile and in-tile offset of a coordinate on a dimension. The
+  // unsigned conversions compute the differences modulo 2^64, which is
+  // exact since the coordinates are in the domain. Without a tile extent,
+  // the whole dimension is a single tile.
+  auto tile_and_offset = [&](unsigned d, uint64_t i, uint64_t* t, uint64_t* o) {
+    auto diff = (uint64_t)buffs[d][i] - lows[d];
+    *t = (extents[d] == 0) ? 0 : diff / extents[d];
+    *o = (extents[d] == 0) ? diff : diff % extents[d];
+  };
+
+  // Compute the bounding box of the tiles and in-tile offsets
+  std::vector<uint64_t> t_min(dim_num, UINT64_MAX), t_max(dim_num, 0);
+  std::vector<uint64_t> o_min(dim_num, UINT64_MAX), o_max(dim_num, 0);
+  for (unsigned d = 0; d < dim_num; ++d) {
+    for (uint64_t i = 0; i < coords_num_; ++i) {
+      uint64_t t, o;
+      tile_and_offset(d, i, &t, &o);
+      t_min[d] = std::min(t_min[d], t);
+      t_max[d] = std::max(t_max[d], t);
+      o_min[d] = std::min(o_min[d], o);
+      o_max[d] = std::max(o_max[d], o);
+    }
+  }
+
+  // The keys must fit in 64 bits
+  std::vector<uint64_t> t_num(dim_num), o_num(dim_num);
+  uint64_t key_num = 1, cell_num = 1;
+  for (unsigned d = 0; d < dim_num; ++d) {
+    t_num[d] = t_max[d] - t_min[d] + 1;
+    o_num[d] = o_max[d] - o_min[d] + 1;
+    if (t_num[d] == 0 || o_num[d] == 0 || key_num > UINT64_MAX / t_num[d])
+      return false;
+    key_num *= t_num[d];
+    if (key_num > UINT64_MAX / o_num[d])
+      return false;
+    key_num *= o_num[d];
+    cell_num *= o_num[d];
+  }
+
+  // Compute the key of each cell, linearizing the tiles in the tile order
+  // and the in-tile offsets in the cell order
+  auto tile_row = domain->tile_order() == Layout::ROW_MAJOR;
+  auto cell_row = domain->cell_order() == Layout::ROW_MAJOR;
+  std::vector<std::pair<uint64_t, uint64_t>> keys(coords_num_);
+  const uint64_t chunk_size = 1 << 16;
+  auto chunk_num = (coords_num_ + chunk_size - 1) / chunk_size;
+  parallel_for(0, chunk_num, [&](uint64_t c) {
+    auto end = std::min(coords_num_, (c + 1) * chunk_size);
+    std::vector<uint64_t> t(dim_num), o(dim_num);
+    for (uint64_t i = c * chunk_size; i < end; ++i) {
+      for (unsigned d = 0; d < dim_num; ++d) {
+        tile_and_offset(d, i, &t[d], &o[d]);
+        t[d] -= t_min[d];
+        o[d] -= o_min[d];
+      }
+      uint64_t tile_key = 0, cell_key = 0;
+      for (unsigned j = 0; j < dim_num; ++j) {
+        auto dt = tile_row ? j : dim_num - j - 1;
+        auto dc = cell_row ? j : dim_num - j - 1;
+        tile_key = tile_key * t_num[dt] + t[dt];
+        cell_key = cell_key * o_num[dc] + o[dc];
+      }
+      keys[i] = std::make_pair(tile_key * cell_num + cell_key, i);
+    }
+    return Status::Ok();
+  });
+
+  parallel_radix_sort(&keys, key_num - 1);
+
+  cell_pos->resize(coords_num_);
+  for (uint64_t i = 0; i < coords_num_; ++i)
+    (*cell_pos)[i] = keys[i].second;
+
+  return true;
+}
+
 Status Writer::split_coords_buffer() {
   // Do nothing if the coordinates buffer is not set
   if (coords_buffer_ == nullptr)
@@ -2266,6 +3173,15 @@ Status Writer::split_coords_buffer() {
 
   clear_coord_buffers();
 
+  // The zipped coordinates of a single dimension are already laid out
+  // as its separate buffer
+  if (dim_num == 1) {
+    const auto& dim_name = array_schema_->dimension(0)->name();
+    buffers_[dim_name] =
+        QueryBuffer(coords_buffer_, nullptr, coords_buffer_size_, nullptr);
+    return Status::Ok();
+  }
+
   // New coord buffer allocations
   for (unsigned d = 0; d < dim_num; ++d) {
     auto dim = array_schema_->dimension(d);
@@ -2279,21 +3195,28 @@ Status Writer::split_coords_buffer() {
     if (buff.buffer_ == nullptr)
       RETURN_NOT_OK(Status::WriterError(
           "Cannot split coordinate buffers; memory allocation failed"));
-    buffers_.emplace(dim_name, buff);
+    buffers_[dim_name] = buff;
   }
 
-  // Split coordinates
-  auto coord = (unsigned char*)nullptr;
-  for (unsigned d = 0; d < dim_num; ++d) {
-    auto coord_size = array_schema_->dimension(d)->coord_size();
-    const auto& dim_name = array_schema_->dimension(d)->name();
-    auto buff = (unsigned char*)(buffers_[dim_name].buffer_);
-    for (uint64_t c = 0; c < coords_num_; ++c) {
-      coord =
-          &(((unsigned char*)coords_buffer_)[c * coords_size + d * coord_size]);
-      std::memcpy(&(buff[c * coord_size]), coord, coord_size);
-    }
-  }
+  // Split coordinates in parallel, in chunks of cells per dimension
+  const uint64_t chunk_size = 1 << 16;
+  auto chunk_num = (coords_num_ + chunk_size - 1) / chunk_size;
+  auto statuses =
+      parallel_for_2d(0, chunk_num, 0, dim_num, [&](uint64_t k, unsigned d) {
+        auto coord_size = array_schema_->dimension(d)->coord_size();
+        const auto& dim_name = array_schema_->dimension(d)->name();
+        auto buff = (unsigned char*)(buffers_.find(dim_name)->second.buffer_);
+        auto coord = (const unsigned char*)coords_buffer_ + d * coord_size;
+        auto end = std::min(coords_num_, (k + 1) * chunk_size);
+        for (uint64_t c = k * chunk_size; c < end; ++c)
+          std::memcpy(
+              &(buff[c * coord_size]), coord + c * coords_size, coord_size);
+        return Status::Ok();
+      });
+
+  // Check all statuses
+  for (auto& st : statuses)
+    RETURN_NOT_OK(st);
 
   return Status::Ok();
 }
@@ -2311,22 +3234,82 @@ Status Writer::unordered_write() {
     RETURN_CANCEL_OR_ERROR(check_coord_dups(cell_pos));
 
   // Retrieve coordinate duplicates
-  std::set<uint64_t> coord_dups;
+  std::vector<uint8_t> coord_dups;
   if (dedup_coords_)
     RETURN_CANCEL_OR_ERROR(compute_coord_dups(cell_pos, &coord_dups));
 
-  // Create new fragment
-  std::shared_ptr<FragmentMetadata> frag_meta;
-  RETURN_CANCEL_OR_ERROR(create_fragment(false, &frag_meta));
-  const auto& uri = frag_meta->fragment_uri();
+  // Split the cells into fragments with disjoint non-empty domains
+  std::vector<uint64_t> starts;
+  RETURN_CANCEL_OR_ERROR(compute_fragment_partitions(cell_pos, &starts));
+  auto frag_num = starts.size();
+
+  // Create new fragments
+  std::vector<std::shared_ptr<FragmentMetadata>> frag_metas(frag_num);
+  for (uint64_t f = 0; f < frag_num; ++f) {
+    auto st = create_fragment(false, &frag_metas[f]);
+    if (!st.ok()) {
+      for (uint64_t i = 0; i < f; ++i)
+        clean_up(frag_metas[i]->fragment_uri());
+      return st;
+    }
+  }
+
+  // Write the fragments in parallel
+  std::vector<uint8_t> written(frag_num, 0);
+  auto statuses = parallel_for(0, frag_num, [&](uint64_t f) {
+    auto end = (f == frag_num - 1) ? cell_pos.size() : starts[f + 1];
+    bool frag_written = false;
+    if (frag_num == 1) {
+      RETURN_NOT_OK(unordered_write_fragment(
+          cell_pos, coord_dups, frag_metas[f].get(), &frag_written));
+    } else {
+      std::vector<uint64_t> frag_cell_pos(
+          cell_pos.begin() + starts[f], cell_pos.begin() + end);
+      RETURN_NOT_OK(unordered_write_fragment(
+          frag_cell_pos, coord_dups, frag_metas[f].get(), &frag_written));
+    }
+    written[f] = frag_written;
+    return Status::Ok();
+  });
+
+  // Check all statuses, removing all fragments upon error
+  for (auto& st : statuses) {
+    if (!st.ok()) {
+      for (const auto& frag_meta : frag_metas)
+        clean_up(frag_meta->fragment_uri());
+      return st;
+    }
+  }
+
+  // Add written fragment info
+  std::vector<URI> written_uris;
+  for (uint64_t f = 0; f < frag_num; ++f) {
+    if (written[f]) {
+      add_written_fragment_info(frag_metas[f]->fragment_uri());
+      written_uris.push_back(frag_metas[f]->fragment_uri());
+    }
+  }
+  RETURN_NOT_OK(storage_manager_->update_array_manifest(
+      array_schema_->array_uri(),
+      array_->get_encryption_key(),
+      written_uris,
+      {}));
+  STATS_COUNTER_ADD_IF(
+      frag_num > 1, writer_num_unordered_fragments_split, frag_num);
+
+  return Status::Ok();
+}
+
+Status Writer::unordered_write_fragment(
+    const std::vector<uint64_t>& cell_pos,
+    const std::vector<uint8_t>& coord_dups,
+    FragmentMetadata* frag_meta,
+    bool* written) const {
+  *written = false;
 
   // Prepare tiles
   std::unordered_map<std::string, std::vector<Tile>> tiles;
-  RETURN_CANCEL_OR_ERROR_ELSE(
-      prepare_tiles(cell_pos, coord_dups, &tiles), clean_up(uri));
-
-  // Clear the boolean vector for coordinate duplicates
-  coord_dups.clear();
+  RETURN_CANCEL_OR_ERROR(prepare_tiles(cell_pos, coord_dups, &tiles));
 
   // No tiles
   if (tiles.empty() || tiles.begin()->second.empty())
@@ -2339,22 +3322,19 @@ Status Writer::unordered_write() {
   frag_meta->set_num_tiles(tile_num);
 
   // Compute coordinates metadata
-  RETURN_CANCEL_OR_ERROR_ELSE(
-      compute_coords_metadata(tiles, frag_meta.get()), clean_up(uri));
+  RETURN_CANCEL_OR_ERROR(compute_coords_metadata(tiles, frag_meta));
 
-  // Filter all tiles
-  RETURN_CANCEL_OR_ERROR_ELSE(filter_tiles(&tiles), clean_up(uri));
+  // Compute attribute metadata
+  RETURN_CANCEL_OR_ERROR(compute_attr_metadata(tiles, frag_meta));
 
-  // Write tiles for all attributes and coordinates
-  RETURN_CANCEL_OR_ERROR_ELSE(
-      write_all_tiles(frag_meta.get(), tiles), clean_up(uri));
+  // Filter and write the tiles of each attribute and dimension
+  RETURN_CANCEL_OR_ERROR(filter_and_write_all_tiles(frag_meta, &tiles));
+  recommend_capacity(tiles);
 
   // Write the fragment metadata
-  RETURN_CANCEL_OR_ERROR_ELSE(
-      frag_meta->store(array_->get_encryption_key()), clean_up(uri));
+  RETURN_CANCEL_OR_ERROR(frag_meta->store(array_->get_encryption_key()));
 
-  // Add written fragment info
-  add_written_fragment_info(frag_meta->fragment_uri());
+  *written = true;
 
   return Status::Ok();
 }
@@ -2398,30 +3378,37 @@ Status Writer::write_cell_range_to_tile(
 }
 
 Status Writer::write_cell_range_to_tile_var(
-    ConstBuffer* buff,
-    ConstBuffer* buff_var,
+    const QueryBuffer& buff,
+    uint64_t offsets_unit,
     uint64_t start,
     uint64_t end,
     Tile* tile,
     Tile* tile_var) const {
-  auto buff_cell_num = buff->size() / sizeof(uint64_t);
-  for (auto i = start; i <= end; ++i) {
-    // Write next offset
-    uint64_t next_offset = tile_var->size();
-    RETURN_NOT_OK(tile->write(&next_offset, sizeof(uint64_t)));
-
-    // Write variable-sized value
-    auto last_cell = (i == buff_cell_num - 1);
-    auto start_offset = buff->value<uint64_t>(i * sizeof(uint64_t));
-    auto end_offset = last_cell ?
-                          buff_var->size() :
-                          buff->value<uint64_t>((i + 1) * sizeof(uint64_t));
-    auto cell_var_size = end_offset - start_offset;
-    buff_var->set_offset(start_offset);
-    RETURN_NOT_OK(tile_var->write(buff_var, cell_var_size));
+  auto buff_cell_num = var_cell_num(buff);
+  auto buffer = (const unsigned char*)buff.buffer_;
+  auto buffer_var = (const unsigned char*)buff.buffer_var_;
+  const uint64_t offset_size = offsets_bitsize_ / 8;
+  auto start_offset = var_offset(buff, buff_cell_num, offsets_unit, start);
+  auto end_offset = var_offset(buff, buff_cell_num, offsets_unit, end + 1);
+
+  // The values of the range are contiguous, so the offsets are shifted to
+  // the end of the var-sized tile in chunks and the values copied at once
+  const uint64_t chunk_num = 1024;
+  uint64_t offsets[chunk_num];
+  const uint64_t base = start_offset - tile_var->size();
+  for (auto i = start; i <= end; i += chunk_num) {
+    auto num = std::min(chunk_num, end - i + 1);
+    var_offsets::to_disk(
+        buffer + i * offset_size,
+        num,
+        offsets_unit,
+        offsets_bitsize_,
+        base,
+        offsets);
+    RETURN_NOT_OK(tile->write(offsets, num * sizeof(uint64_t)));
   }
 
-  return Status::Ok();
+  return tile_var->write(&buffer_var[start_offset], end_offset - start_offset);
 }
 
 Status Writer::write_all_tiles(
@@ -2431,6 +3418,9 @@ Status Writer::write_all_tiles(
 
   assert(!tiles.empty());
 
+  if (array_schema_->tile_colocation())
+    return write_tiles_colocated(frag_meta, tiles);
+
   std::vector<std::future<Status>> tasks;
   for (const auto& it : tiles) {
     tasks.push_back(
@@ -2495,6 +3485,122 @@ Status Writer::write_tiles(
   return Status::Ok();
 }
 
+Status Writer::write_tiles_packed(
+    FragmentMetadata* frag_meta,
+    const std::unordered_map<std::string, std::vector<Tile>>& tiles) const {
+  // Large fragments are written to one file per attribute/dimension
+  uint64_t total_size = 0;
+  for (const auto& it : tiles) {
+    for (const auto& tile : it.second)
+      total_size += tile.buffer()->size();
+  }
+  if (total_size > fragment_packing_max_size_)
+    return write_all_tiles(frag_meta, tiles);
+
+  std::map<uint64_t, std::vector<Buffer*>> files;
+  uint64_t tile_num = set_tile_offsets(frag_meta, tiles, &files);
+  frag_meta->set_packed();
+
+  // Write the files one after the other, in file identifier order
+  const auto& uri = frag_meta->packed_uri();
+  for (const auto& file : files) {
+    for (auto buff : file.second) {
+      RETURN_NOT_OK(storage_manager_->write(uri, buff));
+      STATS_COUNTER_ADD(writer_num_bytes_written, buff->size());
+    }
+  }
+  RETURN_NOT_OK(storage_manager_->close_file(uri));
+
+  STATS_COUNTER_ADD(writer_num_attr_tiles_written, tile_num);
+  STATS_COUNTER_ADD(writer_num_packed_fragments, 1);
+
+  return Status::Ok();
+}
+
+Status Writer::write_tiles_colocated(
+    FragmentMetadata* frag_meta,
+    const std::unordered_map<std::string, std::vector<Tile>>& tiles) const {
+  std::map<uint64_t, std::vector<Buffer*>> files;
+  uint64_t tile_num = set_tile_offsets(frag_meta, tiles, &files);
+
+  // Write the tiles with the same index one after the other, in file
+  // identifier order. All the files have the same number of tiles.
+  const auto& uri = frag_meta->packed_uri();
+  auto num = files.empty() ? 0 : files.begin()->second.size();
+  for (uint64_t t = 0; t < num; ++t) {
+    for (const auto& file : files) {
+      auto buff = file.second[t];
+      RETURN_NOT_OK(storage_manager_->write(uri, buff));
+      STATS_COUNTER_ADD(writer_num_bytes_written, buff->size());
+    }
+  }
+
+  // Close the file, except in the case of global order
+  if (layout_ != Layout::GLOBAL_ORDER)
+    RETURN_NOT_OK(storage_manager_->close_file(uri));
+
+  STATS_COUNTER_ADD(writer_num_attr_tiles_written, tile_num);
+
+  return Status::Ok();
+}
+
+uint64_t Writer::set_tile_offsets(
+    FragmentMetadata* frag_meta,
+    const std::unordered_map<std::string, std::vector<Tile>>& tiles,
+    std::map<uint64_t, std::vector<Buffer*>>* files) const {
+  uint64_t tile_num = 0;
+  for (const auto& it : tiles) {
+    const auto& name = it.first;
+    const auto& name_tiles = it.second;
+    bool var_size = array_schema_->var_size(name);
+    auto name_tile_num = name_tiles.size();
+    for (size_t i = 0, tile_id = 0; i < name_tile_num; ++i, ++tile_id) {
+      auto buff = name_tiles[i].buffer();
+      (*files)[frag_meta->file_id(name, false)].push_back(buff);
+      frag_meta->set_tile_offset(name, tile_id, buff->size());
+
+      if (var_size) {
+        ++i;
+
+        buff = name_tiles[i].buffer();
+        (*files)[frag_meta->file_id(name, true)].push_back(buff);
+        frag_meta->set_tile_var_offset(name, tile_id, buff->size());
+        frag_meta->set_tile_var_size(
+            name, tile_id, name_tiles[i].pre_filtered_size());
+      }
+    }
+    tile_num += name_tile_num;
+  }
+
+  return tile_num;
+}
+
+uint64_t Writer::offsets_unit(const std::string& name) const {
+  return offsets_in_elements_ ? datatype_size(array_schema_->type(name)) : 1;
+}
+
+uint64_t Writer::var_cell_num(const QueryBuffer& buff) const {
+  auto offsets_num = *buff.buffer_size_ / (offsets_bitsize_ / 8);
+  if (offsets_extra_element_)
+    return offsets_num == 0 ? 0 : offsets_num - 1;
+  return offsets_num;
+}
+
+uint64_t Writer::var_offset(
+    const QueryBuffer& buff,
+    uint64_t cell_num,
+    uint64_t offsets_unit,
+    uint64_t cell_idx) const {
+  // Without the extra offset, the last cell ends with the values
+  if (cell_idx == cell_num && !offsets_extra_element_)
+    return *buff.buffer_var_size_;
+
+  uint64_t offset = (offsets_bitsize_ == 32) ?
+                        ((const uint32_t*)buff.buffer_)[cell_idx] :
+                        ((const uint64_t*)buff.buffer_)[cell_idx];
+  return offset * offsets_unit;
+}
+
 std::string Writer::coords_to_str(uint64_t i) const {
   std::stringstream ss;
   auto dim_num = array_schema_->dim_num();
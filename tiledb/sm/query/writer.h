@@ -33,9 +33,12 @@
 #ifndef TILEDB_WRITER_H
 #define TILEDB_WRITER_H
 
+#include <future>
+#include <map>
 #include <memory>
-#include <set>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 
 #include "tiledb/sm/fragment/written_fragment_info.h"
 #include "tiledb/sm/misc/status.h"
@@ -51,6 +54,7 @@ class ArraySchema;
 class FragmentMetadata;
 class StorageManager;
 class Subarray;
+class WriteBuffer;
 
 /** Processes write queries. */
 class Writer {
@@ -116,6 +120,18 @@ class Writer {
   /*                 API               */
   /* ********************************* */
 
+  /**
+   * Adds a part to the fragment of this global order query, which another
+   * query writes concurrently (see `set_fragment_part`). This query writes
+   * no cells itself; its finalization stitches the parts into a single
+   * fragment, in the global order of their cells. Thread-safe.
+   *
+   * @param part The index of the part, unique within the fragment.
+   * @param part_uri Set to the URI the part is written to.
+   * @return Status
+   */
+  Status add_fragment_part(uint32_t part, URI* part_uri);
+
   /** Returns the array schema. */
   const ArraySchema* array_schema() const;
 
@@ -128,9 +144,18 @@ class Writer {
    */
   QueryBuffer buffer(const std::string& name) const;
 
+  /**
+   * Makes the writer write its cells right away, even if the storage
+   * manager buffers the unordered writes.
+   */
+  void disable_write_buffer();
+
   /** Finalizes the reader. */
   Status finalize();
 
+  /** Returns `true` if parts were added with `add_fragment_part`. */
+  bool has_fragment_parts();
+
   /**
    * Retrieves the buffer of a fixed-sized attribute/dimension.
    *
@@ -228,6 +253,14 @@ class Writer {
   /** Sets the fragment URI. Applicable only to write queries. */
   void set_fragment_uri(const URI& fragment_uri);
 
+  /**
+   * Makes the writer write a part of the fragment of another global order
+   * query, at the input URI (see `add_fragment_part`). Each part must
+   * follow the previous one in the global order, and for sparse arrays must
+   * consist of full tiles unless it is the last one.
+   */
+  void set_fragment_part(const URI& part_uri);
+
   /**
    * Sets the cell layout of the query. The function will return an error
    * if the queried array is a key-value store (because it has its default
@@ -235,6 +268,15 @@ class Writer {
    */
   Status set_layout(Layout layout);
 
+  /**
+   * Sets the width in bits (32 or 64) of the offsets in the user buffers,
+   * overriding `sm.var_offsets.bitsize`. It must be set before the buffers.
+   *
+   * @param bitsize The offsets width in bits.
+   * @return Status
+   */
+  Status set_offsets_bitsize(uint32_t bitsize);
+
   /** Sets the storage manager. */
   void set_storage_manager(StorageManager* storage_manager);
 
@@ -255,6 +297,15 @@ class Writer {
    */
   Status set_subarray(const Subarray& subarray);
 
+  /**
+   * Sorts the coordinates of the user buffers, creating a vector with
+   * the sorted positions.
+   *
+   * @param cell_pos The sorted cell positions to be created.
+   * @return Status
+   */
+  Status sort_coords(std::vector<uint64_t>* cell_pos) const;
+
   /*
    * Return the subarray
    * @return subarray
@@ -335,12 +386,103 @@ class Writer {
    */
   bool dedup_coords_;
 
+  /**
+   * The number of bits per cell of the bloom filter over the coordinates
+   * stored with each new sparse fragment. `0` means no bloom filter.
+   */
+  uint32_t coords_bloom_filter_bits_;
+
+  /**
+   * Whether the R-Tree of each new fragment packs its leaves with
+   * Sort-Tile-Recursive.
+   */
+  bool rtree_str_packing_;
+
+  /**
+   * Whether each new fragment stores distinct count and quantile sketches
+   * of its numeric attributes.
+   */
+  bool fragment_sketches_;
+
+  /** The attributes whose values are indexed in each new fragment. */
+  std::vector<std::string> value_index_attributes_;
+
+  /** Whether the metadata of each new fragment is stored uncompressed. */
+  bool fragment_metadata_unfiltered_;
+
   /** The name of the new fragment to be created. */
   URI fragment_uri_;
 
+  /**
+   * The URIs of the parts of the fragment written by other queries, by
+   * part index (see `add_fragment_part`).
+   */
+  std::map<uint32_t, URI> fragment_parts_;
+
+  /** Protects `fragment_uri_` and `fragment_parts_` as parts are added. */
+  std::mutex fragment_parts_mtx_;
+
+  /** `true` if the writer writes a part of another query's fragment. */
+  bool fragment_part_;
+
   /** The state associated with global writes. */
   std::unique_ptr<GlobalWriteState> global_write_state_;
 
+  /**
+   * If `true`, the full tiles of each global order submission are filtered
+   * and written in the background, while the user prepares the next
+   * submission.
+   */
+  bool async_flush_;
+
+  /** The in-flight flush of the tiles of the last global write (if any). */
+  std::future<Status> flush_task_;
+
+  /**
+   * The maximum number of fragments with disjoint non-empty domains that
+   * an unordered write is split into.
+   */
+  uint64_t unordered_fragment_num_;
+
+  /**
+   * The filtered tile size that sparse writes recommend a capacity for
+   * (`0` if disabled).
+   */
+  uint64_t capacity_target_tile_size_;
+
+  /**
+   * The maximum filtered size of the tiles of a non-global write for them
+   * to be packed into a single file (`0` if disabled).
+   */
+  uint64_t fragment_packing_max_size_;
+
+  /**
+   * If `false`, the cells of unordered writes are written right away, even
+   * if the storage manager buffers them.
+   */
+  bool use_write_buffer_;
+
+  /** The width in bits (32 or 64) of the offsets in the user buffers. */
+  uint32_t offsets_bitsize_;
+
+  /**
+   * The offsets width set on the query, which overrides
+   * `sm.var_offsets.bitsize`, or `0` if it is not set.
+   */
+  uint32_t query_offsets_bitsize_;
+
+  /**
+   * True if the user offsets buffers hold one more offset after those of
+   * the cells, with the end of the last cell.
+   */
+  bool offsets_extra_element_;
+
+  /**
+   * True if the user offsets count elements of the datatype instead of
+   * bytes.
+   */
+  bool offsets_in_elements_;
+
   /** True if the writer has been initialized. */
   bool initialized_;
 
@@ -370,12 +512,29 @@ class Writer {
   /** Adss a fragment to `written_fragment_info_`. */
   void add_written_fragment_info(const URI& uri);
 
+  /**
+   * Appends the cells of an unordered write to the write buffer of the
+   * storage manager, instead of writing them.
+   *
+   * @param write_buffer The write buffer.
+   * @return Status
+   */
+  Status buffer_cells(WriteBuffer* write_buffer);
+
   /** Checks if the buffers names have been appropriately set for the query. */
   Status check_buffer_names();
 
   /** Correctness checks for buffer sizes. */
   Status check_buffer_sizes() const;
 
+  /**
+   * Checks that the offsets of the var-sized user buffer `buff` of `name`
+   * are strictly ascending and within its values, in the offsets format
+   * of the `sm.var_offsets.*` parameters.
+   */
+  Status check_var_offsets(
+      const std::string& name, const QueryBuffer& buff) const;
+
   /**
    * Throws an error if there are coordinate duplicates.
    *
@@ -386,29 +545,15 @@ class Writer {
   Status check_coord_dups(const std::vector<uint64_t>& cell_pos) const;
 
   /**
-   * Throws an error if there are coordinates falling out-of-bounds, i.e.,
-   * outside the array domain.
+   * Validates the coordinates in a single parallel pass, before they are
+   * sorted: throws an error if there are coordinates falling outside the
+   * array domain and, for global order writes, if there are coordinate
+   * duplicates or coordinates that do not obey the global order. Each
+   * check is subject to its `sm.check_*` configuration parameter.
    *
    * @return Status
    */
-  Status check_coord_oob() const;
-
-  /**
-   * Throws an error if there are coordinate duplicates. This function
-   * assumes that the coordinates are written in the global layout,
-   * which means that they are already sorted in the attribute buffers.
-   *
-   * @return Status
-   */
-  Status check_coord_dups() const;
-
-  /**
-   * Throws an error if there are coordinates that do not obey the
-   * global order.
-   *
-   * @return Status
-   */
-  Status check_global_order() const;
+  Status check_coords() const;
 
   /** Correctness checks for `subarray_`. */
   Status check_subarray() const;
@@ -434,14 +579,14 @@ class Writer {
    *
    * @param cell_pos The sorted positions of the coordinates in the
    *     `attr_buffers_`.
-   * @param A set indicating the positions of the duplicates.
+   * @param coord_dups A bitmap marking the positions of the duplicates.
    *     If there are not duplicates, this vector will be **empty** after
    *     the termination of the function.
    * @return Status
    */
   Status compute_coord_dups(
       const std::vector<uint64_t>& cell_pos,
-      std::set<uint64_t>* coord_dups) const;
+      std::vector<uint8_t>* coord_dups) const;
 
   /**
    * Computes the positions of the coordinate duplicates (if any). Note
@@ -452,12 +597,56 @@ class Writer {
    * This functions assumes that the coordinates are laid out in the
    * global order and, hence, they are sorted in the attribute buffers.
    *
-   * @param A set indicating the positions of the duplicates.
+   * @param coord_dups A bitmap marking the positions of the duplicates.
    *     If there are not duplicates, this vector will be **empty** after
    *     the termination of the function.
    * @return Status
    */
-  Status compute_coord_dups(std::set<uint64_t>* coord_dups) const;
+  Status compute_coord_dups(std::vector<uint8_t>* coord_dups) const;
+
+  /**
+   * Computes the attribute metadata, i.e., the minimum, maximum and sum of
+   * the values of each tile of the numeric attributes (see
+   * `FragmentMetadata::has_tile_min_max_sum`). The tiles must not be
+   * filtered yet.
+   *
+   * @param tiles The tiles to calculate the attribute metadata from, one
+   *     vector of tiles per attribute or dimension.
+   * @param meta The fragment metadata that will store the attribute metadata.
+   * @return Status
+   */
+  Status compute_attr_metadata(
+      const std::unordered_map<std::string, std::vector<Tile>>& tiles,
+      FragmentMetadata* meta) const;
+
+  /**
+   * Computes the attribute metadata of the input attribute tiles.
+   *
+   * @param name The attribute the tiles belong to.
+   * @param tiles The unfiltered tiles of the attribute.
+   * @param meta The fragment metadata that will store the attribute metadata.
+   * @return Status
+   */
+  Status compute_attr_metadata(
+      const std::string& name,
+      const std::vector<Tile>& tiles,
+      FragmentMetadata* meta) const;
+
+  /**
+   * Computes the attribute metadata of the input attribute tiles.
+   *
+   * @tparam T The attribute type.
+   * @tparam S The type the values are summed in.
+   * @param name The attribute the tiles belong to.
+   * @param tiles The unfiltered tiles of the attribute.
+   * @param meta The fragment metadata that will store the attribute metadata.
+   * @return Status
+   */
+  template <class T, class S>
+  Status compute_attr_metadata(
+      const std::string& name,
+      const std::vector<Tile>& tiles,
+      FragmentMetadata* meta) const;
 
   /**
    * Computes the coordinates metadata (e.g., MBRs).
@@ -517,6 +706,21 @@ class Writer {
   Status filter_tiles(
       std::unordered_map<std::string, std::vector<Tile>>* tiles) const;
 
+  /**
+   * Filters and then writes the input tiles of each attribute/dimension in
+   * an independent parallel task, so that the tiles of an attribute are
+   * written as soon as they are filtered, regardless of the filtering of
+   * the other attributes.
+   *
+   * @param frag_meta The metadata of the fragment to write to.
+   * @param tiles The tiles to filter and write, one element per attribute
+   *     or dimension.
+   * @return Status
+   */
+  Status filter_and_write_all_tiles(
+      FragmentMetadata* frag_meta,
+      std::unordered_map<std::string, std::vector<Tile>>* tiles) const;
+
   /**
    * Applicable only to global writes. Filters the last attribute and
    * coordinate tiles.
@@ -526,7 +730,8 @@ class Writer {
 
   /**
    * Runs the input tiles for the input attribute through the filter pipeline.
-   * The tile buffers are modified to contain the output of the pipeline.
+   * The tile buffers are modified to contain the output of the pipeline. The
+   * chunks of all the tiles are filtered as one set of parallel tasks.
    *
    * @param name The attribute/dimension the tiles belong to.
    * @param tile The tiles to be filtered.
@@ -535,17 +740,10 @@ class Writer {
   Status filter_tiles(const std::string& name, std::vector<Tile>* tiles) const;
 
   /**
-   * Runs the input tile for the input attribute/dimension through the filter
-   * pipeline. The tile buffer is modified to contain the output of the
-   * pipeline.
-   *
-   * @param name The attribute/dimension the tile belong to.
-   * @param tile The tile to be filtered.
-   * @param offsets True if the tile to be filtered contains offsets for a
-   *    var-sized attribute/dimension.
-   * @return Status
+   * Stitches the parts added with `add_fragment_part` into the fragment of
+   * the query, and commits it.
    */
-  Status filter_tile(const std::string& name, Tile* tile, bool offsets) const;
+  Status finalize_fragment_parts();
 
   /** Finalizes the global write state. */
   Status finalize_global_write_state();
@@ -568,6 +766,12 @@ class Writer {
   /** Initializes the global write state. */
   Status init_global_write_state();
 
+  /**
+   * Loads the user offsets format from the `sm.var_offsets.*` config and
+   * the offsets width set on the query.
+   */
+  Status init_offsets_format();
+
   /**
    * Initializes a fixed-sized tile.
    *
@@ -663,12 +867,13 @@ class Writer {
    * populates the partially full last tile from the previous
    * invocation.
    *
-   * @param coord_dups The positions of the duplicate coordinates.
+   * @param coord_dups The bitmap marking the positions of the duplicate
+   *     coordinates, empty if there are no duplicates.
    * @param tiles The **full** tiles to be created.
    * @return Status
    */
   Status prepare_full_tiles(
-      const std::set<uint64_t>& coord_dups,
+      const std::vector<uint8_t>& coord_dups,
       std::unordered_map<std::string, std::vector<Tile>>* tiles) const;
 
   /**
@@ -681,13 +886,14 @@ class Writer {
    * invocation.
    *
    * @param name The attribute/dimension to prepare the tiles for.
-   * @param coord_dups The positions of the duplicate coordinates.
+   * @param coord_dups The bitmap marking the positions of the duplicate
+   *     coordinates, empty if there are no duplicates.
    * @param tiles The **full** tiles to be created.
    * @return Status
    */
   Status prepare_full_tiles(
       const std::string& name,
-      const std::set<uint64_t>& coord_dups,
+      const std::vector<uint8_t>& coord_dups,
       std::vector<Tile>* tiles) const;
 
   /**
@@ -700,13 +906,14 @@ class Writer {
    * invocation. Applicable only to fixed-sized attributes.
    *
    * @param name The attribute/dimension to prepare the tiles for.
-   * @param coord_dups The positions of the duplicate coordinates.
+   * @param coord_dups The bitmap marking the positions of the duplicate
+   *     coordinates, empty if there are no duplicates.
    * @param tiles The **full** tiles to be created.
    * @return Status
    */
   Status prepare_full_tiles_fixed(
       const std::string& name,
-      const std::set<uint64_t>& coord_dups,
+      const std::vector<uint8_t>& coord_dups,
       std::vector<Tile>* tiles) const;
 
   /**
@@ -719,25 +926,30 @@ class Writer {
    * invocation. Applicable only to var-sized attributes.
    *
    * @param name The attribute/dimension to prepare the tiles for.
-   * @param coord_dups The positions of the duplicate coordinates.
+   * @param coord_dups The bitmap marking the positions of the duplicate
+   *     coordinates, empty if there are no duplicates.
    * @param tiles The **full** tiles to be created.
    * @return Status
    */
   Status prepare_full_tiles_var(
       const std::string& name,
-      const std::set<uint64_t>& coord_dups,
+      const std::vector<uint8_t>& coord_dups,
       std::vector<Tile>* tiles) const;
 
   /**
-   * It prepares and filters  attribute the tiles, copying from the user
-   * buffers into the tiles the values based on the input write cell ranges.
+   * It prepares, filters and writes the attribute tiles, copying from the
+   * user buffers into the tiles the values based on the input write cell
+   * ranges. The attribute metadata is computed before the tiles are
+   * filtered. Each attribute is processed in an independent parallel task.
    *
    * @param write_cell_ranges The write cell ranges.
+   * @param meta The fragment metadata that will store the attribute metadata.
    * @param tiles The tiles to be created.
    * @return Status
    */
-  Status prepare_and_filter_attr_tiles(
+  Status prepare_filter_and_write_attr_tiles(
       const std::vector<WriteCellRangeVec>& write_cell_ranges,
+      FragmentMetadata* meta,
       std::unordered_map<std::string, std::vector<Tile>>* attr_tiles) const;
 
   /**
@@ -762,15 +974,15 @@ class Writer {
    *
    * @param cell_pos The positions that resulted from sorting and
    *     according to which the cells must be re-arranged.
-   * @param coord_dups The set with the positions
-   *     of duplicate coordinates/cells.
+   * @param coord_dups The bitmap marking the positions of duplicate
+   *     coordinates/cells, empty if there are no duplicates.
    * @param tiles The tiles to be created, one vector per attribute or
    *     coordinate.
    * @return Status
    */
   Status prepare_tiles(
       const std::vector<uint64_t>& cell_pos,
-      const std::set<uint64_t>& coord_dups,
+      const std::vector<uint8_t>& coord_dups,
       std::unordered_map<std::string, std::vector<Tile>>* tiles) const;
 
   /**
@@ -780,15 +992,15 @@ class Writer {
    * @param name The attribute or dimension to prepare the tiles for.
    * @param cell_pos The positions that resulted from sorting and
    *     according to which the cells must be re-arranged.
-   * @param coord_dups The set with the positions
-   *     of duplicate coordinates/cells.
+   * @param coord_dups The bitmap marking the positions of duplicate
+   *     coordinates/cells, empty if there are no duplicates.
    * @param tiles The tiles to be created.
    * @return Status
    */
   Status prepare_tiles(
       const std::string& name,
       const std::vector<uint64_t>& cell_pos,
-      const std::set<uint64_t>& coord_dups,
+      const std::vector<uint8_t>& coord_dups,
       std::vector<Tile>* tiles) const;
 
   /**
@@ -799,15 +1011,15 @@ class Writer {
    * @param name The attribute or dimension to prepare the tiles for.
    * @param cell_pos The positions that resulted from sorting and
    *     according to which the cells must be re-arranged.
-   * @param coord_dups The set with the positions
-   *     of duplicate coordinates/cells.
+   * @param coord_dups The bitmap marking the positions of duplicate
+   *     coordinates/cells, empty if there are no duplicates.
    * @param tiles The tiles to be created.
    * @return Status
    */
   Status prepare_tiles_fixed(
       const std::string& name,
       const std::vector<uint64_t>& cell_pos,
-      const std::set<uint64_t>& coord_dups,
+      const std::vector<uint8_t>& coord_dups,
       std::vector<Tile>* tiles) const;
 
   /**
@@ -818,28 +1030,104 @@ class Writer {
    * @param name The attribute to prepare the tiles for.
    * @param cell_pos The positions that resulted from sorting and
    *     according to which the cells must be re-arranged.
-   * @param coord_dups The set with the positions
-   *     of duplicate coordinates/cells.
+   * @param coord_dups The bitmap marking the positions of duplicate
+   *     coordinates/cells, empty if there are no duplicates.
    * @param tiles The tiles to be created.
    * @return Status
    */
   Status prepare_tiles_var(
       const std::string& name,
       const std::vector<uint64_t>& cell_pos,
-      const std::set<uint64_t>& coord_dups,
+      const std::vector<uint8_t>& coord_dups,
       std::vector<Tile>* tiles) const;
 
   /** Resets the writer object, rendering it incomplete. */
   void reset();
 
   /**
-   * Sorts the coordinates of the user buffers, creating a vector with
-   * the sorted positions.
+   * Waits for the in-flight flush of the tiles of the last global write
+   * (if any) to complete.
    *
+   * @return Status The status of the flush.
+   */
+  Status wait_flush();
+
+  /**
+   * Recommends the capacity for which the largest filtered tiles of a
+   * sparse write would have `capacity_target_tile_size_` bytes, given the
+   * filtered bytes per cell of the input tiles of each attribute and
+   * dimension. The recommendation is reported by raising the
+   * `writer_recommended_capacity` statistics counter.
+   *
+   * @param tiles The filtered tiles.
+   */
+  void recommend_capacity(
+      const std::unordered_map<std::string, std::vector<Tile>>& tiles) const;
+
+  /**
+   * Sorts the coordinates of the user buffers in the global order with a
+   * radix sort on a global order key computed once per cell, i.e., the
+   * position of its space tile in the tile order followed by the position
+   * of the cell in the tile in the cell order, both within the bounding
+   * box of the coordinates. Returns `false` without sorting if the keys
+   * do not fit in 64 bits.
+   *
+   * @tparam T The (integer) domain type.
+   * @param cell_pos The sorted cell positions to be created.
+   * @return Whether the coordinates were sorted.
+   */
+  template <class T>
+  bool sort_coords_on_global_keys(std::vector<uint64_t>* cell_pos) const;
+
+  /**
+   * Sorts the coordinates of the user buffers in the global order with a
+   * comparator specialized on the domain type and number of dimensions,
+   * which the sort inlines. Returns `false` without sorting unless the
+   * domain has 1 to 4 dimensions and a row-major or col-major cell order.
+   *
+   * @tparam T The domain type.
+   * @param buffs The coordinate buffers, one per dimension.
+   * @param cell_pos The cell positions to sort.
+   * @return Whether the coordinates were sorted.
+   */
+  template <class T>
+  bool sort_coords_typed(
+      const std::vector<const void*>& buffs,
+      std::vector<uint64_t>* cell_pos) const;
+
+  /** Implements `sort_coords_typed` for a domain with `N` dimensions. */
+  template <class T, unsigned N>
+  void sort_coords_typed_dims(
+      const std::vector<const void*>& buffs,
+      std::vector<uint64_t>* cell_pos) const;
+
+  /**
+   * Sorts the coordinates of the user buffers in the global order of an
+   * array with a Hilbert cell order, i.e., on their space tiles and then
+   * on their Hilbert values, which are computed once per cell. Ties are
+   * broken in row-major order.
+   *
+   * @param buffs The coordinate buffers, one per dimension.
    * @param cell_pos The sorted cell positions to be created.
    * @return Status
    */
-  Status sort_coords(std::vector<uint64_t>* cell_pos) const;
+  Status sort_coords_on_hilbert_values(
+      const std::vector<const void*>& buffs,
+      std::vector<uint64_t>* cell_pos) const;
+
+  /**
+   * Sorts the cell positions by merging their sorted runs, if the cells
+   * are already in the global order or in a few long sorted runs.
+   *
+   * @tparam CmpT The global order comparator type.
+   * @param cmp The global order comparator of cell positions.
+   * @param cell_pos The cell positions, initially in the input order.
+   * @return True if the cell positions were sorted, false if there are too
+   *     many runs to merge, in which case they are left unmodified.
+   */
+  template <class CmpT>
+  bool merge_sorted_runs(const CmpT& cmp, std::vector<uint64_t>* cell_pos)
+      const;
 
   /**
    * Splits the coordinates buffer into separate coordinate
@@ -856,6 +1144,52 @@ class Writer {
    */
   Status unordered_write();
 
+  /**
+   * Writes the input sorted cells of an unordered write into the input
+   * fragment.
+   *
+   * @param cell_pos The sorted positions of the cells to write.
+   * @param coord_dups The bitmap marking the positions of the duplicate
+   *     coordinates, empty if there are no duplicates.
+   * @param frag_meta The metadata of the (created) fragment to write.
+   * @param written Set to `true` if the fragment got any tiles.
+   * @return Status
+   *
+   * @note Upon error, the caller must remove the fragment.
+   */
+  Status unordered_write_fragment(
+      const std::vector<uint64_t>& cell_pos,
+      const std::vector<uint8_t>& coord_dups,
+      FragmentMetadata* frag_meta,
+      bool* written) const;
+
+  /**
+   * Splits the sorted cells of an unordered write into at most
+   * `unordered_fragment_num_` partitions of about equal size, so that no
+   * space tile along the first dimension of the tile order spans two
+   * partitions. Since the cells are in the global order, the non-empty
+   * domains of the partitions do not overlap on that dimension.
+   *
+   * @param cell_pos The sorted cell positions.
+   * @param starts The start of each partition in `cell_pos`.
+   * @return Status
+   */
+  Status compute_fragment_partitions(
+      const std::vector<uint64_t>& cell_pos,
+      std::vector<uint64_t>* starts) const;
+
+  /**
+   * Implements `compute_fragment_partitions` for the input domain type.
+   *
+   * @tparam T The domain type.
+   * @param cell_pos The sorted cell positions.
+   * @param starts The start of each partition in `cell_pos`.
+   */
+  template <class T>
+  void compute_fragment_partitions(
+      const std::vector<uint64_t>& cell_pos,
+      std::vector<uint64_t>* starts) const;
+
   /**
    * Writes an empty cell range to the input tile.
    * Applicable to **fixed-sized** attributes.
@@ -895,8 +1229,8 @@ class Writer {
    * Writes the input cell range to the input tile, for a particular
    * buffer. Applicable to **variable-sized** attributes.
    *
-   * @param buff The write buffer where the cell offsets will be copied from.
-   * @param buff_var The write buffer where the cell values will be copied from.
+   * @param buff The user buffer with the cell offsets and values.
+   * @param offsets_unit The size in bytes of the unit of the user offsets.
    * @param start The start element in the write buffer.
    * @param end The end element in the write buffer.
    * @param tile The tile offsets to write to.
@@ -904,8 +1238,8 @@ class Writer {
    * @return Status
    */
   Status write_cell_range_to_tile_var(
-      ConstBuffer* buff,
-      ConstBuffer* buff_var,
+      const QueryBuffer& buff,
+      uint64_t offsets_unit,
       uint64_t start,
       uint64_t end,
       Tile* tile,
@@ -936,6 +1270,78 @@ class Writer {
       FragmentMetadata* frag_meta,
       const std::vector<Tile>& tiles) const;
 
+  /**
+   * Writes all the input filtered tiles of a non-global write to the single
+   * packed file of the fragment, if their total size does not exceed
+   * `fragment_packing_max_size_`. Otherwise, it writes them to one file per
+   * attribute/dimension with `write_all_tiles`.
+   *
+   * @param frag_meta The fragment metadata.
+   * @param tiles Attribute/Coordinate tiles to be written, one element per
+   *     attribute or dimension.
+   * @return Status
+   */
+  Status write_tiles_packed(
+      FragmentMetadata* frag_meta,
+      const std::unordered_map<std::string, std::vector<Tile>>& tiles) const;
+
+  /**
+   * Writes all the input filtered tiles to the single file of a fragment of
+   * an array whose schema co-locates tiles, the tiles with the same index
+   * of all attributes/dimensions one after the other.
+   *
+   * @param frag_meta The fragment metadata.
+   * @param tiles Attribute/Coordinate tiles to be written, one element per
+   *     attribute or dimension.
+   * @return Status
+   */
+  Status write_tiles_colocated(
+      FragmentMetadata* frag_meta,
+      const std::unordered_map<std::string, std::vector<Tile>>& tiles) const;
+
+  /**
+   * Sets the offsets of the input filtered tiles in the fragment metadata,
+   * as if each attribute/dimension file was written separately, and groups
+   * the tile buffers by the identifier of the file they belong to.
+   *
+   * @param frag_meta The fragment metadata.
+   * @param tiles Attribute/Coordinate tiles, one element per attribute or
+   *     dimension.
+   * @param files The tile buffers of each file, in tile index order.
+   * @return The number of tiles.
+   */
+  uint64_t set_tile_offsets(
+      FragmentMetadata* frag_meta,
+      const std::unordered_map<std::string, std::vector<Tile>>& tiles,
+      std::map<uint64_t, std::vector<Buffer*>>* files) const;
+
+  /**
+   * Returns the size in bytes of the unit of the user offsets of the
+   * var-sized `name`, i.e., 1 or the size of its datatype.
+   */
+  uint64_t offsets_unit(const std::string& name) const;
+
+  /** Returns the number of cells in the var-sized user buffer `buff`. */
+  uint64_t var_cell_num(const QueryBuffer& buff) const;
+
+  /**
+   * Returns the byte offset at which cell `cell_idx` starts in the values of
+   * the var-sized user buffer `buff`, converting from the user offsets
+   * format on the fly. For `cell_idx == cell_num` it returns the end of the
+   * values of the last cell.
+   *
+   * @param buff The var-sized user buffer.
+   * @param cell_num The number of cells in `buff`.
+   * @param offsets_unit The size in bytes of the unit of the user offsets.
+   * @param cell_idx The cell index.
+   * @return The byte offset.
+   */
+  uint64_t var_offset(
+      const QueryBuffer& buff,
+      uint64_t cell_num,
+      uint64_t offsets_unit,
+      uint64_t cell_idx) const;
+
   /**
    * Returns the i-th coordinates in the coordinate buffers in string
    * format.
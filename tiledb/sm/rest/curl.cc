@@ -31,11 +31,16 @@
  */
 
 #include "tiledb/sm/rest/curl.h"
+#include "tiledb/sm/compressors/gzip_compressor.h"
+#include "tiledb/sm/compressors/zstd_compressor.h"
 #include "tiledb/sm/global_state/global_state.h"
 #include "tiledb/sm/misc/logger.h"
 #include "tiledb/sm/misc/stats.h"
 #include "tiledb/sm/misc/utils.h"
 
+#include <zlib.h>
+#include <zstd.h>
+#include <algorithm>
 #include <cstring>
 
 // TODO: replace this with config option
@@ -161,20 +166,335 @@ size_t buffer_list_read_memory_callback(
   return num_read;
 }
 
+/**
+ * Compresses the data of a BufferList as libcurl reads it to POST, in the
+ * gzip or zstd HTTP content-coding. The buffers of the list are fed to the
+ * compression stream in place, and the compressed bytes are written directly
+ * into the libcurl upload buffer, so neither the whole uncompressed nor the
+ * whole compressed body are ever copied.
+ */
+class CompressedRequestBody {
+ public:
+  /** The supported content-codings. */
+  enum class Encoding : uint8_t { GZIP, ZSTD };
+
+  /** Constructor. */
+  CompressedRequestBody(Encoding encoding, const BufferList* data)
+      : encoding_(encoding)
+      , data_(data)
+      , buffer_idx_(0)
+      , in_(nullptr)
+      , in_nbytes_(0)
+      , done_(false)
+      , gzip_init_(false)
+      , zstd_stream_(nullptr) {
+    std::memset(&gzip_stream_, 0, sizeof(gzip_stream_));
+  }
+
+  /** Destructor. */
+  ~CompressedRequestBody() {
+    if (gzip_init_)
+      (void)deflateEnd(&gzip_stream_);
+    if (zstd_stream_ != nullptr)
+      ZSTD_freeCStream(zstd_stream_);
+  }
+
+  /** Initializes the compression stream. */
+  Status init() {
+    if (encoding_ == Encoding::GZIP) {
+      // A window of 15 bits plus 16 selects the gzip wrapper.
+      if (deflateInit2(
+              &gzip_stream_,
+              GZip::default_level(),
+              Z_DEFLATED,
+              15 + 16,
+              8,
+              Z_DEFAULT_STRATEGY) != Z_OK)
+        return LOG_STATUS(Status::RestError(
+            "Cannot compress request body; gzip stream initialization "
+            "failed"));
+      gzip_init_ = true;
+    } else {
+      zstd_stream_ = ZSTD_createCStream();
+      if (zstd_stream_ == nullptr ||
+          ZSTD_isError(
+              ZSTD_initCStream(zstd_stream_, ZStd::default_level())))
+        return LOG_STATUS(Status::RestError(
+            "Cannot compress request body; zstd stream initialization "
+            "failed"));
+    }
+
+    return Status::Ok();
+  }
+
+  /** Returns the value of the 'Content-Encoding' header. */
+  std::string content_encoding() const {
+    return encoding_ == Encoding::GZIP ? "gzip" : "zstd";
+  }
+
+  /**
+   * Compresses the next part of the body into `dest`.
+   *
+   * @param dest The buffer to write the compressed bytes to.
+   * @param max_nbytes The size of `dest`.
+   * @param nbytes Set to the number of bytes written, 0 once the whole body
+   *     has been read.
+   * @return Status
+   */
+  Status read(void* dest, uint64_t max_nbytes, uint64_t* nbytes) {
+    auto out = static_cast<char*>(dest);
+    uint64_t out_pos = 0;
+    while (out_pos < max_nbytes && !done_) {
+      // Move on to the next buffer of the list once the current one has
+      // been consumed; the stream is finished after the last one.
+      while (in_nbytes_ == 0 && buffer_idx_ < data_->num_buffers()) {
+        Buffer* buffer = nullptr;
+        RETURN_NOT_OK(const_cast<BufferList*>(data_)->get_buffer(
+            buffer_idx_++, &buffer));
+        in_ = static_cast<const char*>(buffer->data());
+        in_nbytes_ = buffer->size();
+      }
+      const bool finish = in_nbytes_ == 0;
+
+      uint64_t consumed = 0, produced = 0;
+      if (encoding_ == Encoding::GZIP) {
+        RETURN_NOT_OK(gzip_step(
+            finish, out + out_pos, max_nbytes - out_pos, &consumed, &produced));
+      } else {
+        RETURN_NOT_OK(zstd_step(
+            finish, out + out_pos, max_nbytes - out_pos, &consumed, &produced));
+      }
+      in_ += consumed;
+      in_nbytes_ -= consumed;
+      out_pos += produced;
+    }
+
+    *nbytes = out_pos;
+    return Status::Ok();
+  }
+
+ private:
+  /** The maximum number of bytes passed to a compression step. */
+  static const uint64_t MAX_STEP_NBYTES = uint64_t(1) << 30;
+
+  /** The content-coding. */
+  Encoding encoding_;
+
+  /** The uncompressed body. */
+  const BufferList* data_;
+
+  /** The index of the next buffer of `data_` to compress. */
+  uint64_t buffer_idx_;
+
+  /** The uncompressed bytes of the current buffer left to compress. */
+  const char* in_;
+
+  /** The number of bytes at `in_`. */
+  uint64_t in_nbytes_;
+
+  /** True once the compression stream has been finished. */
+  bool done_;
+
+  /** The gzip compression stream. */
+  z_stream gzip_stream_;
+
+  /** True if `gzip_stream_` has been initialized. */
+  bool gzip_init_;
+
+  /** The zstd compression stream. */
+  ZSTD_CStream* zstd_stream_;
+
+  /** Runs one step of the gzip stream, finishing it if `finish` is true. */
+  Status gzip_step(
+      bool finish,
+      char* out,
+      uint64_t out_nbytes,
+      uint64_t* consumed,
+      uint64_t* produced) {
+    const auto in_max =
+        static_cast<uInt>(std::min(in_nbytes_, MAX_STEP_NBYTES));
+    const auto out_max =
+        static_cast<uInt>(std::min(out_nbytes, MAX_STEP_NBYTES));
+    gzip_stream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in_));
+    gzip_stream_.avail_in = in_max;
+    gzip_stream_.next_out = reinterpret_cast<Bytef*>(out);
+    gzip_stream_.avail_out = out_max;
+
+    const int ret = deflate(&gzip_stream_, finish ? Z_FINISH : Z_NO_FLUSH);
+    if (ret == Z_STREAM_END)
+      done_ = true;
+    else if (ret != Z_OK && ret != Z_BUF_ERROR)
+      return LOG_STATUS(Status::RestError(
+          "Cannot compress request body; gzip error " + std::to_string(ret)));
+
+    *consumed = in_max - gzip_stream_.avail_in;
+    *produced = out_max - gzip_stream_.avail_out;
+    return Status::Ok();
+  }
+
+  /** Runs one step of the zstd stream, finishing it if `finish` is true. */
+  Status zstd_step(
+      bool finish,
+      char* out,
+      uint64_t out_nbytes,
+      uint64_t* consumed,
+      uint64_t* produced) {
+    ZSTD_inBuffer in_buffer = {in_, std::min(in_nbytes_, MAX_STEP_NBYTES), 0};
+    ZSTD_outBuffer out_buffer = {out, out_nbytes, 0};
+
+    const size_t ret =
+        finish ? ZSTD_endStream(zstd_stream_, &out_buffer) :
+                 ZSTD_compressStream(zstd_stream_, &out_buffer, &in_buffer);
+    if (ZSTD_isError(ret))
+      return LOG_STATUS(Status::RestError(
+          std::string("Cannot compress request body; zstd error: ") +
+          ZSTD_getErrorName(ret)));
+    if (finish && ret == 0)
+      done_ = true;
+
+    *consumed = in_buffer.pos;
+    *produced = out_buffer.pos;
+    return Status::Ok();
+  }
+};
+
+const uint64_t CompressedRequestBody::MAX_STEP_NBYTES;
+
+/**
+ * Callback for reading compressed data to POST.
+ *
+ * This is called by libcurl when there is data from a BufferList being POSTed
+ * with a 'Content-Encoding'.
+ *
+ * @param dest Destination buffer to read into
+ * @param size Size of a member in the dest buffer
+ * @param nmemb Max number of members in the dest buffer
+ * @param userdata User data attached to the callback (in our case will point to
+ *      a CompressedRequestBody instance)
+ * @return Number of bytes copied into the dest buffer
+ */
+size_t compressed_read_memory_callback(
+    void* dest, size_t size, size_t nmemb, void* userdata) {
+  auto body = static_cast<CompressedRequestBody*>(userdata);
+  const size_t max_nbytes = size * nmemb;
+
+  uint64_t num_read = 0;
+  auto st = body->read(dest, max_nbytes, &num_read);
+  if (!st.ok()) {
+    LOG_ERROR(
+        "Cannot copy libcurl POST data; compression failed: " +
+        st.to_string());
+    return CURL_READFUNC_ABORT;
+  }
+
+  return num_read;
+}
+
+CurlHandlePool::CurlHandlePool()
+    : share_(nullptr) {
+}
+
+CurlHandlePool::~CurlHandlePool() {
+  // The handles must be cleaned up before the share they use.
+  for (auto handle : handles_)
+    curl_easy_cleanup(handle);
+  if (share_ != nullptr)
+    curl_share_cleanup(share_);
+}
+
+Status CurlHandlePool::init() {
+  share_ = curl_share_init();
+  if (share_ == nullptr)
+    return LOG_STATUS(Status::RestError(
+        "Error initializing libcurl handle pool; curl_share_init failed"));
+
+  // The connection cache itself cannot be shared by handles used
+  // concurrently, so each handle keeps its own connections.
+  if (curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, lock_share) !=
+          CURLSHE_OK ||
+      curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, unlock_share) !=
+          CURLSHE_OK ||
+      curl_share_setopt(share_, CURLSHOPT_USERDATA, this) != CURLSHE_OK ||
+      curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION) !=
+          CURLSHE_OK ||
+      curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS) !=
+          CURLSHE_OK)
+    return LOG_STATUS(Status::RestError(
+        "Error initializing libcurl handle pool; curl_share_setopt failed"));
+
+  return Status::Ok();
+}
+
+Status CurlHandlePool::acquire(CURL** handle) {
+  {
+    std::unique_lock<std::mutex> lck(handles_mtx_);
+    if (!handles_.empty()) {
+      *handle = handles_.back();
+      handles_.pop_back();
+      curl_easy_reset(*handle);
+      return Status::Ok();
+    }
+  }
+
+  *handle = curl_easy_init();
+  if (*handle == nullptr)
+    return LOG_STATUS(Status::RestError(
+        "Error acquiring libcurl handle; curl_easy_init failed"));
+  curl_easy_setopt(*handle, CURLOPT_SHARE, share_);
+
+  return Status::Ok();
+}
+
+void CurlHandlePool::release(CURL* const handle) {
+  std::unique_lock<std::mutex> lck(handles_mtx_);
+  handles_.push_back(handle);
+}
+
+void CurlHandlePool::lock_share(
+    CURL*, curl_lock_data data, curl_lock_access, void* userptr) {
+  static_cast<CurlHandlePool*>(userptr)->share_mtx_[data].lock();
+}
+
+void CurlHandlePool::unlock_share(
+    CURL*, curl_lock_data data, void* userptr) {
+  static_cast<CurlHandlePool*>(userptr)->share_mtx_[data].unlock();
+}
+
 Curl::Curl()
     : config_(nullptr)
-    , curl_(nullptr, curl_easy_cleanup) {
+    , curl_(nullptr, curl_easy_cleanup)
+    , pool_(nullptr)
+    , multi_(nullptr)
+    , multi_headers_(nullptr)
+    , multi_reset_(true)
+    , multi_paused_(false) {
+}
+
+Curl::~Curl() {
+  // A handle whose request was abandoned midway is not reused.
+  const bool abandoned = multi_headers_ != nullptr;
+  post_data_end();
+  if (pool_ != nullptr && curl_ != nullptr && !abandoned)
+    pool_->release(curl_.release());
 }
 
 Status Curl::init(
     const Config* config,
-    const std::unordered_map<std::string, std::string>& extra_headers) {
+    const std::unordered_map<std::string, std::string>& extra_headers,
+    CurlHandlePool* const pool) {
   if (config == nullptr)
     return LOG_STATUS(
         Status::RestError("Error initializing libcurl; config is null."));
 
   config_ = config;
-  curl_.reset(curl_easy_init());
+  if (pool != nullptr) {
+    CURL* handle = nullptr;
+    RETURN_NOT_OK(pool->acquire(&handle));
+    curl_.reset(handle);
+    pool_ = pool;
+  } else {
+    curl_.reset(curl_easy_init());
+  }
   extra_headers_ = extra_headers;
 
   // See https://curl.haxx.se/libcurl/c/threadsafe.html
@@ -497,6 +817,148 @@ Status Curl::post_data(
   STATS_FUNC_OUT(rest_curl_post);
 }
 
+Status Curl::post_data_start(
+    const std::string& url,
+    const SerializationType serialization_type,
+    const BufferList* data,
+    PostResponseCb&& write_cb) {
+  RETURN_NOT_OK(
+      post_data_prepare(url, serialization_type, data, std::move(write_cb)));
+
+  multi_ = curl_multi_init();
+  if (multi_ == nullptr) {
+    post_data_end();
+    return LOG_STATUS(
+        Status::RestError("Error posting data; curl_multi_init failed."));
+  }
+
+  if (curl_multi_add_handle(multi_, curl_.get()) != CURLM_OK) {
+    post_data_end();
+    return LOG_STATUS(
+        Status::RestError("Error posting data; curl_multi_add_handle failed."));
+  }
+
+  return Status::Ok();
+}
+
+Status Curl::post_data_prepare(
+    const std::string& url,
+    const SerializationType serialization_type,
+    const BufferList* data,
+    PostResponseCb&& write_cb) {
+  if (multi_headers_ != nullptr)
+    return LOG_STATUS(Status::RestError(
+        "Error posting data; a request is already in progress."));
+
+  struct curl_slist* headers;
+  RETURN_NOT_OK(post_data_common(serialization_type, data, &headers));
+  multi_headers_ = headers;
+  multi_write_cb_ = std::move(write_cb);
+  multi_reset_ = true;
+  multi_paused_ = false;
+
+  CURL* curl = curl_.get();
+  curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, multi_write_callback);
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, static_cast<void*>(this));
+  curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1);
+  curl_easy_setopt(curl, CURLOPT_MAXREDIRS, 1);
+  const char* compressor = nullptr;
+  RETURN_NOT_OK_ELSE(
+      config_->get("rest.http_compressor", &compressor), post_data_end());
+  if (compressor != nullptr && std::string(compressor) != "none")
+    curl_easy_setopt(
+        curl,
+        CURLOPT_ACCEPT_ENCODING,
+        std::string(compressor) == "any" ? "" : compressor);
+
+  return Status::Ok();
+}
+
+Status Curl::post_data_finish(const CURLcode curl_code) {
+  post_data_end();
+  return check_curl_errors(curl_code, "POST");
+}
+
+CURL* Curl::handle() const {
+  return curl_.get();
+}
+
+Status Curl::post_data_continue(bool* const completed) {
+  STATS_FUNC_IN(rest_curl_post);
+
+  if (multi_ == nullptr)
+    return LOG_STATUS(Status::RestError(
+        "Error receiving response; no request in progress."));
+
+  CURL* curl = curl_.get();
+  if (multi_paused_) {
+    // Unpausing may pass the held data to the callback right away, which
+    // may pause the response again.
+    multi_paused_ = false;
+    curl_easy_pause(curl, CURLPAUSE_CONT);
+  }
+
+  while (!multi_paused_) {
+    int running = 0;
+    if (curl_multi_perform(multi_, &running) != CURLM_OK) {
+      post_data_end();
+      return LOG_STATUS(Status::RestError(
+          "Error receiving response; curl_multi_perform failed."));
+    }
+
+    if (running == 0) {
+      CURLcode ret = CURLE_OK;
+      int msgs_left = 0;
+      while (CURLMsg* msg = curl_multi_info_read(multi_, &msgs_left)) {
+        if (msg->msg == CURLMSG_DONE)
+          ret = msg->data.result;
+      }
+      RETURN_NOT_OK(post_data_finish(ret));
+      *completed = true;
+      return Status::Ok();
+    }
+
+    if (!multi_paused_ &&
+        curl_multi_wait(multi_, nullptr, 0, 1000, nullptr) != CURLM_OK) {
+      post_data_end();
+      return LOG_STATUS(Status::RestError(
+          "Error receiving response; curl_multi_wait failed."));
+    }
+  }
+
+  *completed = false;
+  return Status::Ok();
+
+  STATS_FUNC_OUT(rest_curl_post);
+}
+
+size_t Curl::multi_write_callback(
+    void* contents, size_t size, size_t nmemb, void* userdata) {
+  auto curl = static_cast<Curl*>(userdata);
+  bool skip_retries = false;
+  const size_t ret = curl->multi_write_cb_(
+      curl->multi_reset_, contents, size * nmemb, &skip_retries);
+  curl->multi_reset_ = false;
+  if (ret == CURL_WRITEFUNC_PAUSE)
+    curl->multi_paused_ = true;
+
+  return ret;
+}
+
+void Curl::post_data_end() {
+  if (multi_ != nullptr) {
+    curl_multi_remove_handle(multi_, curl_.get());
+    curl_multi_cleanup(multi_);
+    multi_ = nullptr;
+  }
+  if (multi_headers_ != nullptr) {
+    curl_slist_free_all(multi_headers_);
+    multi_headers_ = nullptr;
+  }
+  multi_paused_ = false;
+}
+
 Status Curl::post_data_common(
     const SerializationType serialization_type,
     const BufferList* data,
@@ -521,10 +983,42 @@ Status Curl::post_data_common(
 
   /* HTTP PUT please */
   curl_easy_setopt(curl, CURLOPT_POST, 1L);
-  curl_easy_setopt(
-      curl, CURLOPT_READFUNCTION, buffer_list_read_memory_callback);
-  curl_easy_setopt(curl, CURLOPT_READDATA, data);
-  curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, data->total_size());
+
+  // Compress the body as it is sent if requested. Its compressed size is
+  // not known in advance, so it is sent with chunked transfer encoding.
+  const char* request_compressor = nullptr;
+  RETURN_NOT_OK_ELSE(
+      config_->get("rest.http_request_compressor", &request_compressor),
+      curl_slist_free_all(*headers));
+  request_body_.reset();
+  if (request_compressor != nullptr &&
+      std::string(request_compressor) != "none") {
+    const auto encoding = std::string(request_compressor) == "zstd" ?
+                              CompressedRequestBody::Encoding::ZSTD :
+                              CompressedRequestBody::Encoding::GZIP;
+    request_body_.reset(new CompressedRequestBody(encoding, data));
+    RETURN_NOT_OK_ELSE(request_body_->init(), curl_slist_free_all(*headers));
+
+    const std::string content_encoding =
+        "Content-Encoding: " + request_body_->content_encoding();
+    *headers = curl_slist_append(*headers, content_encoding.c_str());
+    if (*headers != nullptr)
+      *headers = curl_slist_append(*headers, "Transfer-Encoding: chunked");
+    if (*headers == nullptr)
+      return LOG_STATUS(Status::RestError(
+          "Cannot set content-encoding header; curl_slist_append returned "
+          "null."));
+
+    curl_easy_setopt(
+        curl, CURLOPT_READFUNCTION, compressed_read_memory_callback);
+    curl_easy_setopt(curl, CURLOPT_READDATA, request_body_.get());
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, -1L);
+  } else {
+    curl_easy_setopt(
+        curl, CURLOPT_READFUNCTION, buffer_list_read_memory_callback);
+    curl_easy_setopt(curl, CURLOPT_READDATA, data);
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, data->total_size());
+  }
 
   /* pass our list of custom made headers */
   curl_easy_setopt(curl, CURLOPT_HTTPHEADER, *headers);
@@ -603,5 +1097,126 @@ Status Curl::delete_data(
   STATS_FUNC_OUT(rest_curl_delete);
 }
 
+CurlEventLoop::CurlEventLoop()
+    : multi_(nullptr)
+    , stop_(false) {
+}
+
+CurlEventLoop::~CurlEventLoop() {
+  {
+    std::unique_lock<std::mutex> lck(mtx_);
+    stop_ = true;
+  }
+#if LIBCURL_VERSION_NUM >= 0x074400
+  if (multi_ != nullptr)
+    curl_multi_wakeup(multi_);
+#endif
+  if (thread_.joinable())
+    thread_.join();
+
+  // Fail the requests that did not finish.
+  const Status st = Status::RestError(
+      "Error posting data; the request was cancelled before completing.");
+  for (auto& transfer : pending_) {
+    transfer.first->post_data_finish(CURLE_OK);
+    transfer.second(st);
+  }
+  pending_.clear();
+  for (auto& entry : running_) {
+    curl_multi_remove_handle(multi_, entry.first);
+    entry.second.first->post_data_finish(CURLE_OK);
+    entry.second.second(st);
+  }
+  running_.clear();
+
+  if (multi_ != nullptr)
+    curl_multi_cleanup(multi_);
+}
+
+Status CurlEventLoop::init() {
+  multi_ = curl_multi_init();
+  if (multi_ == nullptr)
+    return LOG_STATUS(Status::RestError(
+        "Cannot initialize curl event loop; curl_multi_init failed."));
+
+  try {
+    thread_ = std::thread([this]() { run(); });
+  } catch (const std::exception& e) {
+    return LOG_STATUS(Status::RestError(
+        std::string("Cannot initialize curl event loop; ") + e.what()));
+  }
+
+  return Status::Ok();
+}
+
+Status CurlEventLoop::add(Curl* const curl, DoneCb&& done) {
+  {
+    std::unique_lock<std::mutex> lck(mtx_);
+    if (stop_)
+      return LOG_STATUS(Status::RestError(
+          "Cannot add request to curl event loop; the loop is stopped."));
+    pending_.emplace_back(curl, std::move(done));
+  }
+#if LIBCURL_VERSION_NUM >= 0x074400
+  curl_multi_wakeup(multi_);
+#endif
+  return Status::Ok();
+}
+
+void CurlEventLoop::run() {
+  std::vector<Transfer> added;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lck(mtx_);
+      if (stop_)
+        return;
+      added.swap(pending_);
+    }
+
+    for (auto& transfer : added) {
+      CURL* const handle = transfer.first->handle();
+      if (curl_multi_add_handle(multi_, handle) != CURLM_OK) {
+        transfer.first->post_data_finish(CURLE_OK);
+        transfer.second(LOG_STATUS(Status::RestError(
+            "Error posting data; curl_multi_add_handle failed.")));
+        continue;
+      }
+      running_.emplace(handle, std::move(transfer));
+    }
+    added.clear();
+
+    int running = 0;
+    if (curl_multi_perform(multi_, &running) != CURLM_OK) {
+      // Fail every running request; the multi handle is left unusable.
+      while (!running_.empty())
+        finish(running_.begin()->first, CURLE_FAILED_INIT);
+    }
+
+    int msgs_left = 0;
+    while (CURLMsg* msg = curl_multi_info_read(multi_, &msgs_left)) {
+      if (msg->msg == CURLMSG_DONE)
+        finish(msg->easy_handle, msg->data.result);
+    }
+
+    // Wait for activity on the sockets, or for new requests. Without
+    // `curl_multi_wakeup` the wait is kept short to pick up new requests.
+#if LIBCURL_VERSION_NUM >= 0x074400
+    curl_multi_poll(multi_, nullptr, 0, 1000, nullptr);
+#else
+    curl_multi_wait(multi_, nullptr, 0, 10, nullptr);
+#endif
+  }
+}
+
+void CurlEventLoop::finish(CURL* const handle, const CURLcode result) {
+  auto it = running_.find(handle);
+  if (it == running_.end())
+    return;
+  Transfer transfer = std::move(it->second);
+  running_.erase(it);
+  curl_multi_remove_handle(multi_, handle);
+  transfer.second(transfer.first->post_data_finish(result));
+}
+
 }  // namespace sm
 }  // namespace tiledb
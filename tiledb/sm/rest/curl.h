@@ -38,8 +38,12 @@
 #include <curl/curl.h>
 #include <cstdlib>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include "tiledb/sm/buffer/buffer.h"
 #include "tiledb/sm/buffer/buffer_list.h"
@@ -49,6 +53,68 @@
 namespace tiledb {
 namespace sm {
 
+class CompressedRequestBody;
+
+/**
+ * A pool of libcurl easy handles, shared by the requests of a REST client so
+ * that they reuse the connections (and their TLS sessions) kept open by each
+ * handle instead of paying a TCP and TLS handshake per request. The handles
+ * also share their TLS session and DNS caches, so that a handle opening a new
+ * connection can resume a TLS session established by another.
+ *
+ * This class is thread-safe.
+ */
+class CurlHandlePool {
+ public:
+  /** Constructor. */
+  CurlHandlePool();
+
+  /** Destructor. Cleans up the idle handles. */
+  ~CurlHandlePool();
+
+  /** Initializes the shared caches. */
+  Status init();
+
+  /**
+   * Takes an idle handle from the pool, creating one if there is none. The
+   * options of the handle are reset, but it keeps its open connections.
+   *
+   * @param handle Set to the handle
+   * @return Status
+   */
+  Status acquire(CURL** handle);
+
+  /**
+   * Returns a handle taken with `acquire` to the pool.
+   *
+   * @param handle The handle
+   */
+  void release(CURL* handle);
+
+ private:
+  /** The TLS session and DNS caches shared by the handles. */
+  CURLSH* share_;
+
+  /** One mutex for each kind of data in `share_`. */
+  std::mutex share_mtx_[CURL_LOCK_DATA_LAST];
+
+  /** The idle handles. */
+  std::vector<CURL*> handles_;
+
+  /** Protects `handles_`. */
+  std::mutex handles_mtx_;
+
+  /** Locks the data of `share_` for libcurl. */
+  static void lock_share(
+      CURL* handle,
+      curl_lock_data data,
+      curl_lock_access access,
+      void* userptr);
+
+  /** Unlocks the data of `share_` for libcurl. */
+  static void unlock_share(CURL* handle, curl_lock_data data, void* userptr);
+};
+
 /**
  * Helper class offering a high-level wrapper over some libcurl functions.
  *
@@ -61,16 +127,22 @@ class Curl {
   /** Constructor. */
   Curl();
 
+  /** Destructor. */
+  ~Curl();
+
   /**
    * Initializes the class.
    *
    * @param config TileDB config storing server/auth information
    * @param extra_headers Any additional headers to attach to each request.
+   * @param pool The pool to take the curl handle from, and to return it to
+   *     on destruction. If null, a new handle is created.
    * @return Status
    */
   Status init(
       const Config* config,
-      const std::unordered_map<std::string, std::string>& extra_headers);
+      const std::unordered_map<std::string, std::string>& extra_headers,
+      CurlHandlePool* pool);
 
   /**
    * Escapes the given URL.
@@ -127,6 +199,66 @@ class Curl {
       const BufferList* data,
       PostResponseCb&& write_cb);
 
+  /**
+   * Starts posting data to the server, without waiting for the response,
+   * which is then received by `post_data_continue`. Unlike `post_data`, the
+   * request is not retried.
+   *
+   * @param url URL to post to
+   * @param serialization_type Serialization type to use
+   * @param data Encoded data buffer for posting, which must outlive the
+   *    request
+   * @param write_cb Invoked as response body buffers are received. It may
+   *    return `CURL_WRITEFUNC_PAUSE` to pause the response, in which case the
+   *    same data will be passed to it again once `post_data_continue` is
+   *    called next.
+   * @return Status
+   */
+  Status post_data_start(
+      const std::string& url,
+      SerializationType serialization_type,
+      const BufferList* data,
+      PostResponseCb&& write_cb);
+
+  /**
+   * Receives the response of the request started by `post_data_start`,
+   * resuming it if it was paused, until it is complete or paused again.
+   *
+   * @param completed Set to true if the response has been received entirely,
+   *    false if it has been paused.
+   * @return Status
+   */
+  Status post_data_continue(bool* completed);
+
+  /**
+   * Prepares a request posting data to the server, without performing it.
+   * This is used by `CurlEventLoop`, which performs the request with the
+   * handle returned by `handle()`, and then calls `post_data_finish`.
+   *
+   * @param url URL to post to
+   * @param serialization_type Serialization type to use
+   * @param data Encoded data buffer for posting, which must outlive the
+   *    request
+   * @param write_cb Invoked as response body buffers are received.
+   * @return Status
+   */
+  Status post_data_prepare(
+      const std::string& url,
+      SerializationType serialization_type,
+      const BufferList* data,
+      PostResponseCb&& write_cb);
+
+  /**
+   * Ends a request prepared by `post_data_prepare`, checking its result.
+   *
+   * @param curl_code The result of the request
+   * @return Status
+   */
+  Status post_data_finish(CURLcode curl_code);
+
+  /** Returns the underlying libcurl handle. */
+  CURL* handle() const;
+
   /**
    * Common code shared between variants of 'post_data'.
    *
@@ -176,12 +308,51 @@ class Curl {
   /** Underlying C curl instance. */
   std::unique_ptr<CURL, decltype(&curl_easy_cleanup)> curl_;
 
+  /** The pool `curl_` was taken from, if any. */
+  CurlHandlePool* pool_;
+
+  /** Drives the request started by `post_data_start`, if any. */
+  CURLM* multi_;
+
+  /** The headers of the request started by `post_data_start`. */
+  struct curl_slist* multi_headers_;
+
+  /** The callback receiving the response of `post_data_start`. */
+  PostResponseCb multi_write_cb_;
+
+  /** True until `multi_write_cb_` has been invoked once. */
+  bool multi_reset_;
+
+  /** True if `multi_write_cb_` has paused the response. */
+  bool multi_paused_;
+
+  /**
+   * Callback for the response of the request started by `post_data_start`.
+   *
+   * @param contents Pointer to received data
+   * @param size Size of a member in the received data
+   * @param nmemb Number of members in the received data
+   * @param userdata Points to this Curl instance
+   * @return Number of bytes acknowledged, or `CURL_WRITEFUNC_PAUSE`
+   */
+  static size_t multi_write_callback(
+      void* contents, size_t size, size_t nmemb, void* userdata);
+
+  /** Ends the request started by `post_data_start`. */
+  void post_data_end();
+
   /** String buffer that will be used by libcurl to store error messages. */
   Buffer curl_error_buffer_;
 
   /** Extra headers to attach to each request. */
   std::unordered_map<std::string, std::string> extra_headers_;
 
+  /**
+   * Compresses the body of the current POST request as libcurl reads it,
+   * if `rest.http_request_compressor` is not "none".
+   */
+  std::unique_ptr<CompressedRequestBody> request_body_;
+
   /**
    * Populates the curl slist with authorization (token or username+password),
    * and any extra headers.
@@ -264,6 +435,70 @@ class Curl {
   std::string get_curl_errstr(CURLcode curl_code) const;
 };
 
+/**
+ * Performs the requests of several `Curl` instances concurrently on a single
+ * background thread, through the libcurl multi interface. A request is added
+ * after being prepared with `Curl::post_data_prepare`, and a completion
+ * callback is invoked on the background thread once it has finished.
+ *
+ * This class is thread-safe.
+ */
+class CurlEventLoop {
+ public:
+  /** Invoked with the result of a request once it has finished. */
+  typedef std::function<void(const Status&)> DoneCb;
+
+  /** Constructor. */
+  CurlEventLoop();
+
+  /**
+   * Destructor. Stops the background thread, failing the requests that have
+   * not finished.
+   */
+  ~CurlEventLoop();
+
+  /** Initializes the multi handle and starts the background thread. */
+  Status init();
+
+  /**
+   * Adds a prepared request to the loop. The `Curl` instance must stay alive
+   * until `done` has been invoked.
+   *
+   * @param curl The `Curl` instance, prepared with `post_data_prepare`
+   * @param done Invoked on the background thread once the request finishes
+   * @return Status
+   */
+  Status add(Curl* curl, DoneCb&& done);
+
+ private:
+  /** A request, along with its completion callback. */
+  typedef std::pair<Curl*, DoneCb> Transfer;
+
+  /** The multi handle performing the requests. */
+  CURLM* multi_;
+
+  /** The background thread. */
+  std::thread thread_;
+
+  /** The requests added but not yet handed to `multi_`. */
+  std::vector<Transfer> pending_;
+
+  /** The requests being performed, keyed by their libcurl handle. */
+  std::unordered_map<CURL*, Transfer> running_;
+
+  /** True when the background thread should exit. */
+  bool stop_;
+
+  /** Protects `pending_` and `stop_`. */
+  std::mutex mtx_;
+
+  /** The routine of the background thread. */
+  void run();
+
+  /** Finishes the request of `handle` with `result`. */
+  void finish(CURL* handle, CURLcode result);
+};
+
 }  // namespace sm
 }  // namespace tiledb
 
@@ -30,10 +30,16 @@
  * This file declares a REST client class.
  */
 
+#include <algorithm>
 #include <cassert>
+#include <condition_variable>
+#include <cstring>
 
 #include "tiledb/sm/array/array.h"
 #include "tiledb/sm/array_schema/attribute.h"
+#include "tiledb/sm/enums/datatype.h"
+#include "tiledb/sm/enums/layout.h"
+#include "tiledb/sm/enums/query_status.h"
 #include "tiledb/sm/enums/query_type.h"
 #include "tiledb/sm/misc/logger.h"
 #include "tiledb/sm/misc/stats.h"
@@ -54,9 +60,93 @@ namespace sm {
 
 #ifdef TILEDB_SERIALIZATION
 
+/**
+ * The response to a read query streamed from the REST server (see
+ * `rest.stream_incomplete`). It stays open across the submissions of the
+ * query, while the server pushes the successive batches of results, and is
+ * paused whenever the user buffers are full.
+ */
+class RestQueryStream {
+ public:
+  /** Constructor. */
+  RestQueryStream()
+      : copy_state(nullptr) {
+  }
+
+  /** The serialized query posted, which must outlive the request. */
+  BufferList request;
+
+  /** The request. */
+  Curl curl;
+
+  /** The state of the response. */
+  RestClient::QueryResponseState state;
+
+  /** The copy state of the current submission of the query. */
+  serialization::CopyState* copy_state;
+};
+
+struct RestClient::AsyncSubmission {
+  /** Constructor. */
+  AsyncSubmission()
+      : status(QueryStatus::UNINITIALIZED) {
+  }
+
+  /** The serialized query posted, which must outlive the request. */
+  BufferList request;
+
+  /** The request. */
+  Curl curl;
+
+  /** The state of the response. */
+  QueryResponseState state;
+
+  /** The copy state of the submission. */
+  serialization::CopyState copy_state;
+
+  /** The query status received last, applied once the response ends. */
+  QueryStatus status;
+};
+
+/**
+ * Splits the range of a flattened single-range subarray on the given
+ * dimension into at most `num` contiguous ranges of nearly equal length,
+ * and appends the resulting subarrays to `partitions` in order.
+ */
+template <class T>
+void split_subarray(
+    const std::vector<uint8_t>& subarray,
+    const unsigned dim_idx,
+    uint64_t num,
+    std::vector<std::vector<uint8_t>>* partitions) {
+  const T* range = reinterpret_cast<const T*>(subarray.data()) + 2 * dim_idx;
+  const uint64_t start = static_cast<uint64_t>(range[0]);
+
+  // The range holds `span + 1` values, which may not fit in 64 bits.
+  const uint64_t span = static_cast<uint64_t>(range[1]) - start;
+  if (span < num - 1)
+    num = span + 1;
+  const uint64_t len = span / num;
+  const uint64_t rem = span % num;
+
+  uint64_t offset = 0;
+  for (uint64_t i = 0; i < num; ++i) {
+    const uint64_t cell_num = len + (i <= rem ? 1 : 0);
+    std::vector<uint8_t> partition(subarray);
+    T* partition_range = reinterpret_cast<T*>(partition.data()) + 2 * dim_idx;
+    partition_range[0] = static_cast<T>(start + offset);
+    partition_range[1] = static_cast<T>(start + offset + cell_num - 1);
+    offset += cell_num;
+    partitions->push_back(std::move(partition));
+  }
+}
+
 RestClient::RestClient()
     : config_(nullptr)
-    , resubmit_incomplete_(true) {
+    , resubmit_incomplete_(true)
+    , stream_incomplete_(false)
+    , cache_ttl_ms_(0)
+    , read_partition_num_(1) {
   auto st = utils::parse::convert(
       Config::REST_SERIALIZATION_DEFAULT_FORMAT, &serialization_type_);
   assert(st.ok());
@@ -86,6 +176,21 @@ Status RestClient::init(const Config* config) {
   if (c_str != nullptr)
     RETURN_NOT_OK(utils::parse::convert(c_str, &resubmit_incomplete_));
 
+  RETURN_NOT_OK(config_->get("rest.stream_incomplete", &c_str));
+  if (c_str != nullptr)
+    RETURN_NOT_OK(utils::parse::convert(c_str, &stream_incomplete_));
+
+  RETURN_NOT_OK(config_->get("rest.cache_ttl_ms", &c_str));
+  if (c_str != nullptr)
+    RETURN_NOT_OK(utils::parse::convert(c_str, &cache_ttl_ms_));
+
+  RETURN_NOT_OK(config_->get("rest.read_partition_num", &c_str));
+  if (c_str != nullptr)
+    RETURN_NOT_OK(utils::parse::convert(c_str, &read_partition_num_));
+
+  curl_pool_ = std::make_shared<CurlHandlePool>();
+  RETURN_NOT_OK(curl_pool_->init());
+
   return Status::Ok();
 }
 
@@ -101,21 +206,22 @@ Status RestClient::get_array_schema_from_rest(
 
   // Init curl and form the URL
   Curl curlc;
-  RETURN_NOT_OK(curlc.init(config_, extra_headers_));
+  RETURN_NOT_OK(curlc.init(config_, extra_headers_, curl_pool_.get()));
   std::string array_ns, array_uri;
   RETURN_NOT_OK(uri.get_rest_components(&array_ns, &array_uri));
   std::string url = rest_server_ + "/v1/arrays/" + array_ns + "/" +
                     curlc.url_escape(array_uri);
 
   // Get the data
-  Buffer returned_data;
-  RETURN_NOT_OK(curlc.get_data(url, serialization_type_, &returned_data));
-  if (returned_data.data() == nullptr || returned_data.size() == 0)
+  std::shared_ptr<const Buffer> returned_data;
+  RETURN_NOT_OK(get_data_cached(
+      &curlc, url, uri.to_string() + "#schema", &returned_data));
+  if (returned_data->data() == nullptr || returned_data->size() == 0)
     return LOG_STATUS(Status::RestError(
         "Error getting array schema from REST; server returned no data."));
 
   return serialization::array_schema_deserialize(
-      array_schema, serialization_type_, returned_data);
+      array_schema, serialization_type_, *returned_data);
 
   STATS_FUNC_OUT(rest_array_get_schema);
 }
@@ -124,6 +230,8 @@ Status RestClient::post_array_schema_to_rest(
     const URI& uri, ArraySchema* array_schema) {
   STATS_FUNC_IN(rest_array_create);
 
+  invalidate_cache(uri);
+
   Buffer buff;
   RETURN_NOT_OK(serialization::array_schema_serialize(
       array_schema, serialization_type_, &buff));
@@ -133,7 +241,7 @@ Status RestClient::post_array_schema_to_rest(
 
   // Init curl and form the URL
   Curl curlc;
-  RETURN_NOT_OK(curlc.init(config_, extra_headers_));
+  RETURN_NOT_OK(curlc.init(config_, extra_headers_, curl_pool_.get()));
   std::string array_ns, array_uri;
   RETURN_NOT_OK(uri.get_rest_components(&array_ns, &array_uri));
   std::string url = rest_server_ + "/v1/arrays/" + array_ns + "/" +
@@ -146,9 +254,11 @@ Status RestClient::post_array_schema_to_rest(
 }
 
 Status RestClient::deregister_array_from_rest(const URI& uri) {
+  invalidate_cache(uri);
+
   // Init curl and form the URL
   Curl curlc;
-  RETURN_NOT_OK(curlc.init(config_, extra_headers_));
+  RETURN_NOT_OK(curlc.init(config_, extra_headers_, curl_pool_.get()));
   std::string array_ns, array_uri;
   RETURN_NOT_OK(uri.get_rest_components(&array_ns, &array_uri));
   std::string url = rest_server_ + "/v1/arrays/" + array_ns + "/" +
@@ -172,24 +282,28 @@ Status RestClient::get_array_non_empty_domain(
 
   // Init curl and form the URL
   Curl curlc;
-  RETURN_NOT_OK(curlc.init(config_, extra_headers_));
+  RETURN_NOT_OK(curlc.init(config_, extra_headers_, curl_pool_.get()));
   std::string array_ns, array_uri;
   RETURN_NOT_OK(array->array_uri().get_rest_components(&array_ns, &array_uri));
   std::string url = rest_server_ + "/v1/arrays/" + array_ns + "/" +
                     curlc.url_escape(array_uri) + "/non_empty_domain";
 
   // Get the data
-  Buffer returned_data;
-  RETURN_NOT_OK(curlc.get_data(url, serialization_type_, &returned_data));
-
-  if (returned_data.data() == nullptr || returned_data.size() == 0)
+  std::shared_ptr<const Buffer> returned_data;
+  RETURN_NOT_OK(get_data_cached(
+      &curlc,
+      url,
+      array->array_uri().to_string() + "#non_empty_domain",
+      &returned_data));
+
+  if (returned_data->data() == nullptr || returned_data->size() == 0)
     return LOG_STATUS(
         Status::RestError("Error getting array non-empty domain "
                           "from REST; server returned no data."));
 
   // Deserialize data returned
   return serialization::nonempty_domain_deserialize(
-      array, returned_data, serialization_type_, domain, is_empty);
+      array, *returned_data, serialization_type_, domain, is_empty);
 }
 
 Status RestClient::get_array_max_buffer_sizes(
@@ -206,7 +320,7 @@ Status RestClient::get_array_max_buffer_sizes(
 
   // Init curl and form the URL
   Curl curlc;
-  RETURN_NOT_OK(curlc.init(config_, extra_headers_));
+  RETURN_NOT_OK(curlc.init(config_, extra_headers_, curl_pool_.get()));
   std::string array_ns, array_uri;
   RETURN_NOT_OK(uri.get_rest_components(&array_ns, &array_uri));
   std::string url = rest_server_ + "/v1/arrays/" + array_ns + "/" +
@@ -235,7 +349,7 @@ Status RestClient::get_array_metadata_from_rest(
 
   // Init curl and form the URL
   Curl curlc;
-  RETURN_NOT_OK(curlc.init(config_, extra_headers_));
+  RETURN_NOT_OK(curlc.init(config_, extra_headers_, curl_pool_.get()));
   std::string array_ns, array_uri;
   RETURN_NOT_OK(uri.get_rest_components(&array_ns, &array_uri));
   std::string url = rest_server_ + "/v1/arrays/" + array_ns + "/" +
@@ -267,7 +381,7 @@ Status RestClient::post_array_metadata_to_rest(const URI& uri, Array* array) {
 
   // Init curl and form the URL
   Curl curlc;
-  RETURN_NOT_OK(curlc.init(config_, extra_headers_));
+  RETURN_NOT_OK(curlc.init(config_, extra_headers_, curl_pool_.get()));
   std::string array_ns, array_uri;
   RETURN_NOT_OK(uri.get_rest_components(&array_ns, &array_uri));
   std::string url = rest_server_ + "/v1/arrays/" + array_ns + "/" +
@@ -286,7 +400,20 @@ Status RestClient::submit_query_to_rest(const URI& uri, Query* query) {
   // same user buffers.
   serialization::CopyState copy_state;
 
-  RETURN_NOT_OK(post_query_submit(uri, query, &copy_state));
+  // Writes change the non-empty domain.
+  if (query->type() == QueryType::WRITE)
+    invalidate_cache(uri);
+
+  if (stream_incomplete_ && query->type() == QueryType::READ) {
+    RETURN_NOT_OK(post_query_submit_streamed(uri, query, &copy_state));
+  } else {
+    bool submitted = false;
+    if (read_partition_num_ > 1 && query->type() == QueryType::READ)
+      RETURN_NOT_OK(
+          post_query_submit_partitioned(uri, query, &copy_state, &submitted));
+    if (!submitted)
+      RETURN_NOT_OK(post_query_submit(uri, query, &copy_state));
+  }
 
   // Now need to update the buffer sizes to the actual copied data size so that
   // the user can check the result size on reads.
@@ -297,6 +424,88 @@ Status RestClient::submit_query_to_rest(const URI& uri, Query* query) {
   STATS_FUNC_OUT(rest_query_submit);
 }
 
+Status RestClient::submit_query_to_rest_async(
+    const URI& uri, Query* query, std::function<void(const Status&)>&& done) {
+  if (query->array() == nullptr)
+    return LOG_STATUS(
+        Status::RestError("Error submitting query to REST; null array."));
+
+  // Writes change the non-empty domain.
+  if (query->type() == QueryType::WRITE)
+    invalidate_cache(uri);
+
+  auto submission = std::make_shared<AsyncSubmission>();
+  RETURN_NOT_OK(serialization::query_serialize(
+      query, serialization_type_, true, &submission->request));
+  RETURN_NOT_OK(
+      submission->curl.init(config_, extra_headers_, curl_pool_.get()));
+  std::string url;
+  RETURN_NOT_OK(query_submit_url(
+      uri, query, resubmit_incomplete_, submission->curl, &url));
+
+  // Deserializing each part of the response overwrites the query status.
+  // The status is set aside until the response ends, so that the query
+  // reads as in progress meanwhile. The submission owns the request, which
+  // owns the callback, so the raw pointer cannot dangle.
+  AsyncSubmission* const submission_ptr = submission.get();
+  auto write_cb = [this, submission_ptr, query](
+                      bool reset,
+                      void* contents,
+                      size_t content_nbytes,
+                      bool* skip_retries) {
+    const size_t ret = post_data_write_cb(
+        reset,
+        contents,
+        content_nbytes,
+        skip_retries,
+        &submission_ptr->state,
+        query,
+        &submission_ptr->copy_state);
+    if (query->status() != QueryStatus::INPROGRESS) {
+      submission_ptr->status = query->status();
+      query->set_status(QueryStatus::INPROGRESS);
+    }
+    return ret;
+  };
+  RETURN_NOT_OK(submission->curl.post_data_prepare(
+      url, serialization_type_, &submission->request, std::move(write_cb)));
+
+  auto done_cb = [this, submission, query, done](const Status& st) {
+    query->set_status(submission->status);
+    if (!st.ok() && submission->copy_state.empty()) {
+      done(LOG_STATUS(Status::RestError(
+          "Error submitting query to REST; "
+          "server returned no data. "
+          "Curl error: " +
+          st.message())));
+      return;
+    }
+    done(update_attribute_buffer_sizes(submission->copy_state, query));
+  };
+
+  CurlEventLoop* loop;
+  RETURN_NOT_OK(curl_event_loop(&loop));
+  submission->status = query->status();
+  query->set_status(QueryStatus::INPROGRESS);
+  const Status st = loop->add(&submission->curl, std::move(done_cb));
+  if (!st.ok())
+    query->set_status(submission->status);
+
+  return st;
+}
+
+Status RestClient::curl_event_loop(CurlEventLoop** const loop) {
+  std::unique_lock<std::mutex> lck(curl_loop_mtx_);
+  if (curl_loop_ == nullptr) {
+    auto new_loop = std::make_shared<CurlEventLoop>();
+    RETURN_NOT_OK(new_loop->init());
+    curl_loop_ = new_loop;
+  }
+  *loop = curl_loop_.get();
+
+  return Status::Ok();
+}
+
 Status RestClient::post_query_submit(
     const URI& uri, Query* query, serialization::CopyState* copy_state) {
   // Get array
@@ -313,21 +522,14 @@ Status RestClient::post_query_submit(
 
   // Init curl and form the URL
   Curl curlc;
-  RETURN_NOT_OK(curlc.init(config_, extra_headers_));
-  std::string array_ns, array_uri;
-  RETURN_NOT_OK(uri.get_rest_components(&array_ns, &array_uri));
-  std::string url = rest_server_ + "/v2/arrays/" + array_ns + "/" +
-                    curlc.url_escape(array_uri) +
-                    "/query/submit?type=" + query_type_str(query->type()) +
-                    "&read_all=" + (resubmit_incomplete_ ? "true" : "false");
-
-  // Remote array reads always supply the timestamp.
-  if (query->type() == QueryType::READ)
-    url += "&open_at=" + std::to_string(array->timestamp());
+  RETURN_NOT_OK(curlc.init(config_, extra_headers_, curl_pool_.get()));
+  std::string url;
+  RETURN_NOT_OK(
+      query_submit_url(uri, query, resubmit_incomplete_, curlc, &url));
 
   // Create the callback that will process the response buffers as they
   // are received.
-  Buffer scratch;
+  QueryResponseState state;
   auto write_cb = std::bind(
       &RestClient::post_data_write_cb,
       this,
@@ -335,7 +537,7 @@ Status RestClient::post_query_submit(
       std::placeholders::_2,
       std::placeholders::_3,
       std::placeholders::_4,
-      &scratch,
+      &state,
       query,
       copy_state);
 
@@ -353,175 +555,559 @@ Status RestClient::post_query_submit(
   return Status::Ok();
 }
 
+Status RestClient::get_data_cached(
+    Curl* const curlc,
+    const std::string& url,
+    const std::string& key,
+    std::shared_ptr<const Buffer>* const data) {
+  const auto now = std::chrono::steady_clock::now();
+  if (cache_ttl_ms_ > 0) {
+    std::unique_lock<std::mutex> lck(response_cache_mtx_);
+    auto it = response_cache_.find(key);
+    if (it != response_cache_.end()) {
+      if (now - it->second.time <= std::chrono::milliseconds(cache_ttl_ms_)) {
+        *data = it->second.data;
+        STATS_COUNTER_ADD(rest_cache_hits, 1);
+        return Status::Ok();
+      }
+      response_cache_.erase(it);
+    }
+  }
+
+  auto returned_data = std::make_shared<Buffer>();
+  RETURN_NOT_OK(
+      curlc->get_data(url, serialization_type_, returned_data.get()));
+  *data = returned_data;
+
+  if (cache_ttl_ms_ > 0 && returned_data->size() > 0) {
+    std::unique_lock<std::mutex> lck(response_cache_mtx_);
+    CachedResponse& cached = response_cache_[key];
+    cached.data = returned_data;
+    cached.time = now;
+  }
+
+  return Status::Ok();
+}
+
+void RestClient::invalidate_cache(const URI& uri) {
+  if (cache_ttl_ms_ == 0)
+    return;
+
+  std::unique_lock<std::mutex> lck(response_cache_mtx_);
+  response_cache_.erase(uri.to_string() + "#schema");
+  response_cache_.erase(uri.to_string() + "#non_empty_domain");
+}
+
+Status RestClient::post_query_submit_partitioned(
+    const URI& uri,
+    Query* query,
+    serialization::CopyState* copy_state,
+    bool* submitted) {
+  *submitted = false;
+  Array* array = query->array();
+  if (array == nullptr)
+    return LOG_STATUS(
+        Status::RestError("Error submitting query to REST; null array."));
+
+  // The results of partitions split along the slowest varying dimension of
+  // the layout concatenate into the results of the query. Global order is
+  // not split.
+  const ArraySchema* schema = query->array_schema();
+  const Layout layout = query->layout();
+  if (layout == Layout::GLOBAL_ORDER)
+    return Status::Ok();
+  const unsigned dim_num = schema->dim_num();
+  const unsigned split_dim = (layout == Layout::COL_MAJOR) ? dim_num - 1 : 0;
+
+  // Only subarrays with a single range per dimension are split
+  const Datatype coords_type = schema->coords_type();
+  const uint64_t coord_size = datatype_size(coords_type);
+  std::vector<uint8_t> subarray(2 * dim_num * coord_size);
+  for (unsigned d = 0; d < dim_num; ++d) {
+    uint64_t range_num;
+    RETURN_NOT_OK(query->get_range_num(d, &range_num));
+    if (range_num != 1)
+      return Status::Ok();
+    const void *start, *end, *stride;
+    RETURN_NOT_OK(query->get_range(d, 0, &start, &end, &stride));
+    std::memcpy(&subarray[2 * d * coord_size], start, coord_size);
+    std::memcpy(&subarray[(2 * d + 1) * coord_size], end, coord_size);
+  }
+
+  std::vector<std::vector<uint8_t>> partitions;
+  switch (coords_type) {
+    case Datatype::INT8:
+      split_subarray<int8_t>(
+          subarray, split_dim, read_partition_num_, &partitions);
+      break;
+    case Datatype::UINT8:
+      split_subarray<uint8_t>(
+          subarray, split_dim, read_partition_num_, &partitions);
+      break;
+    case Datatype::INT16:
+      split_subarray<int16_t>(
+          subarray, split_dim, read_partition_num_, &partitions);
+      break;
+    case Datatype::UINT16:
+      split_subarray<uint16_t>(
+          subarray, split_dim, read_partition_num_, &partitions);
+      break;
+    case Datatype::INT32:
+      split_subarray<int32_t>(
+          subarray, split_dim, read_partition_num_, &partitions);
+      break;
+    case Datatype::UINT32:
+      split_subarray<uint32_t>(
+          subarray, split_dim, read_partition_num_, &partitions);
+      break;
+    case Datatype::DATETIME_YEAR:
+    case Datatype::DATETIME_MONTH:
+    case Datatype::DATETIME_WEEK:
+    case Datatype::DATETIME_DAY:
+    case Datatype::DATETIME_HR:
+    case Datatype::DATETIME_MIN:
+    case Datatype::DATETIME_SEC:
+    case Datatype::DATETIME_MS:
+    case Datatype::DATETIME_US:
+    case Datatype::DATETIME_NS:
+    case Datatype::DATETIME_PS:
+    case Datatype::DATETIME_FS:
+    case Datatype::DATETIME_AS:
+    case Datatype::INT64:
+      split_subarray<int64_t>(
+          subarray, split_dim, read_partition_num_, &partitions);
+      break;
+    case Datatype::UINT64:
+      split_subarray<uint64_t>(
+          subarray, split_dim, read_partition_num_, &partitions);
+      break;
+    default:
+      // Real domains are not split
+      return Status::Ok();
+  }
+  if (partitions.size() < 2)
+    return Status::Ok();
+
+  // The scratch buffers receiving the results of a partition
+  struct PartitionBuffer {
+    std::vector<uint64_t> offsets;
+    std::vector<uint8_t> data;
+    uint64_t offsets_size;
+    uint64_t data_size;
+  };
+  const std::vector<std::string> names = query->buffer_names();
+  const size_t partition_num = partitions.size();
+  std::vector<std::unique_ptr<Query>> partition_queries(partition_num);
+  std::vector<std::vector<PartitionBuffer>> partition_buffers(
+      partition_num, std::vector<PartitionBuffer>(names.size()));
+
+  // Size the scratch buffers of each partition from the max buffer size
+  // estimates of the server, capped at the size of the user buffers.
+  for (size_t p = 0; p < partition_num; ++p) {
+    std::unordered_map<std::string, std::pair<uint64_t, uint64_t>> est_sizes;
+    RETURN_NOT_OK(get_array_max_buffer_sizes(
+        uri, schema, partitions[p].data(), &est_sizes));
+
+    partition_queries[p].reset(new Query(array->storage_manager(), array));
+    Query* partition_query = partition_queries[p].get();
+    RETURN_NOT_OK(partition_query->set_layout(layout));
+    RETURN_NOT_OK(partition_query->set_subarray(partitions[p].data()));
+    for (size_t i = 0; i < names.size(); ++i) {
+      const QueryBuffer user_buffer = query->buffer(names[i]);
+      auto est_it = est_sizes.find(names[i]);
+      const bool has_est = est_it != est_sizes.end();
+      PartitionBuffer& buffer = partition_buffers[p][i];
+      if (user_buffer.buffer_var_ != nullptr) {
+        buffer.offsets_size = std::min(
+            has_est ? est_it->second.first : UINT64_MAX,
+            user_buffer.original_buffer_size_);
+        buffer.data_size = std::min(
+            has_est ? est_it->second.second : UINT64_MAX,
+            user_buffer.original_buffer_var_size_);
+        buffer.offsets.resize(
+            std::max<uint64_t>(buffer.offsets_size / sizeof(uint64_t), 1));
+        buffer.data.resize(std::max<uint64_t>(buffer.data_size, 1));
+        RETURN_NOT_OK(partition_query->set_buffer(
+            names[i],
+            buffer.offsets.data(),
+            &buffer.offsets_size,
+            buffer.data.data(),
+            &buffer.data_size));
+      } else {
+        buffer.data_size = std::min(
+            has_est ? est_it->second.first : UINT64_MAX,
+            user_buffer.original_buffer_size_);
+        buffer.data.resize(std::max<uint64_t>(buffer.data_size, 1));
+        RETURN_NOT_OK(partition_query->set_buffer(
+            names[i], buffer.data.data(), &buffer.data_size));
+      }
+    }
+  }
+
+  // Submit the partitions concurrently, and wait for all the submitted ones
+  // to finish even if a later submission fails.
+  std::mutex mtx;
+  std::condition_variable cv;
+  size_t finished = 0;
+  std::vector<Status> results(partition_num);
+  size_t started = 0;
+  Status st;
+  for (; started < partition_num; ++started) {
+    st = submit_query_to_rest_async(
+        uri,
+        partition_queries[started].get(),
+        [&mtx, &cv, &finished, &results, started](const Status& result) {
+          std::unique_lock<std::mutex> lck(mtx);
+          results[started] = result;
+          ++finished;
+          cv.notify_one();
+        });
+    if (!st.ok())
+      break;
+  }
+  {
+    std::unique_lock<std::mutex> lck(mtx);
+    cv.wait(lck, [&finished, started]() { return finished == started; });
+  }
+  RETURN_NOT_OK(st);
+
+  // Fall back to submitting the query whole if a partition did not complete
+  // or if the results do not fit in the user buffers.
+  for (size_t p = 0; p < partition_num; ++p) {
+    if (!results[p].ok() ||
+        partition_queries[p]->status() != QueryStatus::COMPLETED)
+      return Status::Ok();
+  }
+  for (size_t i = 0; i < names.size(); ++i) {
+    const QueryBuffer user_buffer = query->buffer(names[i]);
+    uint64_t offsets_size = 0, data_size = 0;
+    for (size_t p = 0; p < partition_num; ++p) {
+      offsets_size += partition_buffers[p][i].offsets_size;
+      data_size += partition_buffers[p][i].data_size;
+    }
+    if (user_buffer.buffer_var_ != nullptr) {
+      if (offsets_size > user_buffer.original_buffer_size_ ||
+          data_size > user_buffer.original_buffer_var_size_)
+        return Status::Ok();
+    } else if (data_size > user_buffer.original_buffer_size_) {
+      return Status::Ok();
+    }
+  }
+
+  // Concatenate the results in partition order, shifting the offsets of
+  // each partition past the values of the previous ones.
+  for (size_t i = 0; i < names.size(); ++i) {
+    const QueryBuffer user_buffer = query->buffer(names[i]);
+    auto& buffer_copy_state = (*copy_state)[names[i]];
+    for (size_t p = 0; p < partition_num; ++p) {
+      const PartitionBuffer& buffer = partition_buffers[p][i];
+      if (user_buffer.buffer_var_ != nullptr) {
+        uint64_t* offsets = static_cast<uint64_t*>(user_buffer.buffer_) +
+                            buffer_copy_state.offset_size / sizeof(uint64_t);
+        const uint64_t offset_num = buffer.offsets_size / sizeof(uint64_t);
+        for (uint64_t c = 0; c < offset_num; ++c)
+          offsets[c] = buffer.offsets[c] + buffer_copy_state.data_size;
+        std::memcpy(
+            static_cast<uint8_t*>(user_buffer.buffer_var_) +
+                buffer_copy_state.data_size,
+            buffer.data.data(),
+            buffer.data_size);
+        buffer_copy_state.offset_size += buffer.offsets_size;
+      } else {
+        std::memcpy(
+            static_cast<uint8_t*>(user_buffer.buffer_) +
+                buffer_copy_state.data_size,
+            buffer.data.data(),
+            buffer.data_size);
+      }
+      buffer_copy_state.data_size += buffer.data_size;
+    }
+  }
+  query->set_status(QueryStatus::COMPLETED);
+  *submitted = true;
+
+  return Status::Ok();
+}
+
+Status RestClient::post_query_submit_streamed(
+    const URI& uri, Query* query, serialization::CopyState* copy_state) {
+  // Start the request on the first submission; later submissions resume
+  // receiving its response.
+  std::shared_ptr<RestQueryStream> stream = query->rest_stream();
+  if (stream == nullptr) {
+    stream = std::make_shared<RestQueryStream>();
+    RETURN_NOT_OK(serialization::query_serialize(
+        query, serialization_type_, true, &stream->request));
+    RETURN_NOT_OK(
+        stream->curl.init(config_, extra_headers_, curl_pool_.get()));
+    std::string url;
+    RETURN_NOT_OK(query_submit_url(uri, query, true, stream->curl, &url));
+
+    // The stream owns the request, which owns the callback, so the raw
+    // pointer cannot dangle.
+    RestQueryStream* const stream_ptr = stream.get();
+    stream->state.pausable = true;
+    auto write_cb = [this, stream_ptr, query](
+                        bool reset,
+                        void* contents,
+                        size_t content_nbytes,
+                        bool* skip_retries) {
+      return post_data_write_cb(
+          reset,
+          contents,
+          content_nbytes,
+          skip_retries,
+          &stream_ptr->state,
+          query,
+          stream_ptr->copy_state);
+    };
+    RETURN_NOT_OK(stream->curl.post_data_start(
+        url, serialization_type_, &stream->request, std::move(write_cb)));
+    query->set_rest_stream(stream);
+  }
+
+  // Receive the response until it completes, or until the next batch does
+  // not fit in the user buffers. The response is then paused, which stops
+  // reading from the connection until the next submission.
+  stream->copy_state = copy_state;
+  bool completed = false;
+  const Status st = stream->curl.post_data_continue(&completed);
+  stream->copy_state = nullptr;
+  if (!st.ok() || completed)
+    query->set_rest_stream(nullptr);
+
+  if (!st.ok() && copy_state->empty()) {
+    return LOG_STATUS(Status::RestError(
+        "Error submitting query to REST; "
+        "server returned no data. "
+        "Curl error: " +
+        st.message()));
+  }
+
+  return Status::Ok();
+}
+
+Status RestClient::query_submit_url(
+    const URI& uri,
+    const Query* query,
+    const bool read_all,
+    const Curl& curlc,
+    std::string* const url) const {
+  std::string array_ns, array_uri;
+  RETURN_NOT_OK(uri.get_rest_components(&array_ns, &array_uri));
+  *url = rest_server_ + "/v2/arrays/" + array_ns + "/" +
+         curlc.url_escape(array_uri) +
+         "/query/submit?type=" + query_type_str(query->type()) +
+         "&read_all=" + (read_all ? "true" : "false");
+
+  // Remote array reads always supply the timestamp.
+  if (query->type() == QueryType::READ)
+    *url += "&open_at=" + std::to_string(query->array()->timestamp());
+
+  return Status::Ok();
+}
+
 size_t RestClient::post_data_write_cb(
     const bool reset,
     void* const contents,
     const size_t content_nbytes,
     bool* const skip_retries,
-    Buffer* const scratch,
+    QueryResponseState* const state,
     Query* query,
     serialization::CopyState* copy_state) {
   // All return statements in this function must pass through this wrapper.
-  // This is responsible for two things:
-  // 1. The 'bytes_processed' may be negative in error scenarios. The negative
-  //    number is only used for convenience during processing. We must restrict
-  //    the return value to >= 0 before returning.
-  // 2. When our return value ('bytes_processed') does not match the number of
-  //    input bytes ('content_nbytes'), The CURL layer that invoked this
-  //    callback will interpret this as an error and may attempt to retry. We
-  //    specifically want to prevent CURL from retrying the request if we have
-  //    reached this callback. If we encounter an error within this callback,
-  //    the issue is with the response data itself and not an issue with
-  //    transporting the response data (for example, the common issue will be
-  //    deserialization failure). In this scenario, we will waste time retrying
-  //    on response data that we know we cannot handle without error.
-  auto return_wrapper = [content_nbytes, skip_retries](long bytes_processed) {
-    bytes_processed = std::max(bytes_processed, 0L);
-    if (static_cast<size_t>(bytes_processed) != content_nbytes) {
+  // When our return value ('bytes_processed') does not match the number of
+  // input bytes ('content_nbytes'), The CURL layer that invoked this
+  // callback will interpret this as an error and may attempt to retry. We
+  // specifically want to prevent CURL from retrying the request if we have
+  // reached this callback. If we encounter an error within this callback,
+  // the issue is with the response data itself and not an issue with
+  // transporting the response data (for example, the common issue will be
+  // deserialization failure). In this scenario, we will waste time retrying
+  // on response data that we know we cannot handle without error.
+  auto return_wrapper = [content_nbytes, skip_retries](size_t bytes_processed) {
+    if (bytes_processed != content_nbytes) {
       *skip_retries = true;
     }
     return bytes_processed;
   };
 
-  // This is the return value that represents the amount of bytes processed
-  // in 'contents'. This will act as the return value and will always be
-  // less-than-or-equal-to 'content_nbytes'.
-  long bytes_processed = 0;
-
   // When 'reset' is true, we must discard the in-progress memory state.
   // The most likely scenario is that the request failed and was retried
   // from within the Curl object.
   if (reset) {
-    scratch->set_size(0);
-    scratch->set_offset(0);
+    state->clear();
     copy_state->clear();
   }
 
-  // If the current scratch size is non-empty, we must subtract its size
-  // from 'bytes_processed' so that we do not count bytes processed from
-  // a previous callback.
-  bytes_processed -= scratch->size();
-
-  // Copy 'contents' to the end of 'scratch'. As a future optimization, if
-  // 'scratch' is empty, we could attempt to process 'contents' in-place and
-  // only copy the remaining, unprocessed bytes into 'scratch'.
-  scratch->set_offset(scratch->size());
-  Status st = scratch->write(contents, content_nbytes);
-  if (!st.ok()) {
-    LOG_ERROR(
-        "Cannot copy libcurl response data; buffer write failed: " +
-        st.to_string());
-    return return_wrapper(bytes_processed);
-  }
+  const char* data = static_cast<const char*>(contents);
+  uint64_t nbytes_left = content_nbytes;
+  Buffer* const scratch = &state->scratch;
+
+  // Skip the data processed before the response was paused, which libcurl
+  // passes again once it is resumed.
+  const uint64_t skip_nbytes = std::min(state->skip_nbytes, nbytes_left);
+  data += skip_nbytes;
+  nbytes_left -= skip_nbytes;
+  state->skip_nbytes -= skip_nbytes;
+
+  // Appends at most 'nbytes' of the remaining contents to 'scratch'.
+  auto append_to_scratch = [&data, &nbytes_left, scratch](uint64_t nbytes) {
+    nbytes = std::min(nbytes, nbytes_left);
+    const Status st = scratch->write(data, nbytes);
+    data += nbytes;
+    nbytes_left -= nbytes;
+    return st;
+  };
 
-  // Process all of the serialized queries contained within 'scratch'.
-  scratch->reset_offset();
-  while (scratch->offset() < scratch->size()) {
-    // We need at least 8 bytes to determine the size of the next
-    // serialized query.
-    if (scratch->offset() + 8 > scratch->size()) {
-      break;
-    }
+  // Process the serialized queries in 'contents', resuming the one left
+  // incomplete by the previous invocation.
+  Status st;
+  while (true) {
+    // We need 8 bytes to determine the size of the next serialized query.
+    if (state->query_size == 0) {
+      if (nbytes_left == 0)
+        break;
 
-    // Decode the query size. We could cache this from the previous
-    // callback to prevent decoding the same prefix multiple times.
-    const uint64_t query_size =
-        utils::endianness::decode_le<uint64_t>(scratch->cur_data());
+      st = append_to_scratch(sizeof(uint64_t) - scratch->size());
+      if (!st.ok()) {
+        LOG_ERROR(
+            "Cannot copy libcurl response data; buffer write failed: " +
+            st.to_string());
+        return return_wrapper(0);
+      }
+      if (scratch->size() < sizeof(uint64_t))
+        break;
 
-    // We must have the full serialized query before attempting to
-    // deserialize it.
-    if (scratch->offset() + 8 + query_size > scratch->size()) {
-      break;
+      state->query_size =
+          utils::endianness::decode_le<uint64_t>(scratch->data());
+      scratch->reset_size();
+      scratch->reset_offset();
+      if (state->query_size == 0) {
+        LOG_ERROR("Cannot deserialize libcurl response data; empty query.");
+        return return_wrapper(0);
+      }
+      continue;
     }
 
-    // At this point of execution, we know that we the next serialized
-    // query is entirely in 'scratch'. For convenience, we will advance
-    // the offset to point to the start of the serialized query.
-    scratch->advance_offset(8);
-
-    // We can only deserialize the query if it is 8-byte aligned. If the
-    // offset is 8-byte aligned, we can deserialize the query in-place.
-    // Otherwise, we must make a copy to an auxiliary buffer.
-    if (scratch->offset() % 8 != 0) {
-      // Copy the entire serialized buffer to a newly allocated, 8-byte
-      // aligned auxiliary buffer.
-      Buffer aux;
-      st = aux.write(scratch->cur_data(), query_size);
-      if (!st.ok()) {
-        scratch->set_offset(scratch->offset() - 8);
-        scratch->set_size(scratch->offset());
-        return return_wrapper(bytes_processed);
+    // Next, buffer the message of the query. With Cap'n Proto, its size is
+    // given by the segment table at its start and the attribute data follow
+    // it. Otherwise, the whole serialized query is the message.
+    if (state->message_size == 0) {
+      uint64_t message_size = state->query_size;
+      if (serialization_type_ == SerializationType::CAPNP) {
+        st = serialization::query_message_size(
+            scratch->data(), scratch->size(), &message_size);
+        if (!st.ok())
+          return return_wrapper(0);
+        if (message_size > state->query_size) {
+          LOG_ERROR(
+              "Cannot deserialize libcurl response data; message larger "
+              "than the serialized query.");
+          return return_wrapper(0);
+        }
       }
 
-      // Deserialize the buffer and store it in 'copy_state'. If
-      // the user buffers are too small to accomodate the attribute
-      // data when deserializing read queries, this will return an
-      // error status.
-      aux.reset_offset();
-      st = serialization::query_deserialize(
-          aux, serialization_type_, true, copy_state, query);
-      if (!st.ok()) {
-        scratch->set_offset(scratch->offset() - 8);
-        scratch->set_size(scratch->offset());
-        return return_wrapper(bytes_processed);
+      if (scratch->size() < message_size) {
+        if (nbytes_left == 0)
+          break;
+
+        st = append_to_scratch(message_size - scratch->size());
+        if (!st.ok()) {
+          LOG_ERROR(
+              "Cannot copy libcurl response data; buffer write failed: " +
+              st.to_string());
+          return return_wrapper(0);
+        }
+        continue;
       }
-    } else {
-      // Deserialize the buffer and store it in 'copy_state'. If
-      // the user buffers are too small to accomodate the attribute
-      // data when deserializing read queries, this will return an
-      // error status.
-      st = serialization::query_deserialize(
-          *scratch, serialization_type_, true, copy_state, query);
-      if (!st.ok()) {
-        scratch->set_offset(scratch->offset() - 8);
-        scratch->set_size(scratch->offset());
-        return return_wrapper(bytes_processed);
+
+      // The message is complete. Find where the attribute data following
+      // it go in the user buffers.
+      state->message_size = message_size;
+      if (message_size < state->query_size) {
+        bool fit = true;
+        st = serialization::query_buffer_destinations(
+            *scratch,
+            serialization_type_,
+            copy_state,
+            query,
+            &state->destinations,
+            &fit);
+        if (!st.ok())
+          return return_wrapper(0);
+
+        // If the user buffers are too small to accomodate the attribute data,
+        // a streamed response is paused until the next submission provides
+        // room, unless this submission has received nothing yet.
+        if (!fit) {
+          if (state->pausable && !copy_state->empty()) {
+            state->message_size = 0;
+            state->skip_nbytes = content_nbytes - nbytes_left;
+            return CURL_WRITEFUNC_PAUSE;
+          }
+          LOG_ERROR(
+              "Error deserializing read query; user buffers too small for "
+              "the response.");
+          return return_wrapper(0);
+        }
+
+        uint64_t data_size = 0;
+        for (const auto& dest : state->destinations)
+          data_size += dest.second;
+        if (data_size != state->query_size - message_size) {
+          LOG_ERROR(
+              "Cannot deserialize libcurl response data; attribute data "
+              "size does not match the attribute buffer headers.");
+          return return_wrapper(0);
+        }
       }
+      continue;
     }
 
-    scratch->advance_offset(query_size);
-    bytes_processed += (query_size + 8);
-  }
+    // Then, copy the attribute data straight into the user buffers.
+    if (state->dest_idx < state->destinations.size()) {
+      const auto& dest = state->destinations[state->dest_idx];
+      const uint64_t nbytes =
+          std::min(dest.second - state->dest_offset, nbytes_left);
+      if (nbytes > 0)
+        std::memcpy(
+            static_cast<char*>(dest.first) + state->dest_offset, data, nbytes);
+      data += nbytes;
+      nbytes_left -= nbytes;
+      state->dest_offset += nbytes;
+
+      if (state->dest_offset < dest.second)
+        break;
+      ++state->dest_idx;
+      state->dest_offset = 0;
+      continue;
+    }
 
-  // If there are unprocessed bytes left in the scratch space, copy them
-  // to the beginning of 'scratch'. The intent is to reduce memory
-  // consumption by overwriting the serialized query objects that we
-  // have already processed.
-  const uint64_t length = scratch->size() - scratch->offset();
-  if (scratch->offset() != 0) {
-    const uint64_t offset = scratch->offset();
-    scratch->set_offset(0);
-
-    // When the length of the remaining bytes is less than offset,
-    // we can safely read the remaining bytes from 'scratch' and
-    // write them to the beginning of 'scratch' because there will
-    // not be an overlap in accessed memory between the source
-    // and destination. Otherwise, we must use an auxilary buffer
-    // to temporarily store the remaining bytes because the behavior
-    // of the 'memcpy' used 'Buffer::write' will be undefined because
-    // there will be an overlap in the memory of the source and
-    // destination.
-    if (length <= offset) {
-      st = scratch->write(scratch->data(offset), length);
+    // At this point of execution, we know that the whole query has been
+    // received. Deserialize its message and store it in 'copy_state'.
+    scratch->reset_offset();
+    if (serialization_type_ == SerializationType::CAPNP) {
+      st = serialization::query_deserialize_in_place(
+          *scratch, serialization_type_, copy_state, query);
     } else {
-      Buffer aux;
-      st = aux.write(scratch->data(offset), length);
-      if (st.ok()) {
-        st = scratch->write(aux.data(), aux.size());
-      }
+      st = serialization::query_deserialize(
+          *scratch, serialization_type_, true, copy_state, query);
     }
+    if (!st.ok())
+      return return_wrapper(0);
 
-    assert(st.ok());
-    assert(scratch->size() == length);
+    state->clear();
   }
 
-  bytes_processed += length;
-
-  assert(static_cast<size_t>(bytes_processed) == content_nbytes);
-  return return_wrapper(bytes_processed);
+  assert(nbytes_left == 0);
+  return return_wrapper(content_nbytes);
 }
 
 Status RestClient::finalize_query_to_rest(const URI& uri, Query* query) {
+  if (query->type() == QueryType::WRITE)
+    invalidate_cache(uri);
+
   // Serialize data to send
   BufferList serialized;
   RETURN_NOT_OK(serialization::query_serialize(
@@ -529,7 +1115,7 @@ Status RestClient::finalize_query_to_rest(const URI& uri, Query* query) {
 
   // Init curl and form the URL
   Curl curlc;
-  RETURN_NOT_OK(curlc.init(config_, extra_headers_));
+  RETURN_NOT_OK(curlc.init(config_, extra_headers_, curl_pool_.get()));
   std::string array_ns, array_uri;
   RETURN_NOT_OK(uri.get_rest_components(&array_ns, &array_uri));
   std::string url = rest_server_ + "/v1/arrays/" + array_ns + "/" +
@@ -633,10 +1219,14 @@ Status RestClient::update_attribute_buffer_sizes(
     const auto& name = cit.first;
     auto state = cit.second;
     auto query_buffer = query->buffer(name);
-    if (query_buffer.buffer_var_size_ != nullptr)
-      *query_buffer.buffer_var_size_ = state.offset_size;
-    if (query_buffer.buffer_size_ != nullptr)
+    if (query_buffer.buffer_var_size_ != nullptr) {
+      // Var-sized: `buffer_size_` is the size of the offsets buffer
+      *query_buffer.buffer_var_size_ = state.data_size;
+      if (query_buffer.buffer_size_ != nullptr)
+        *query_buffer.buffer_size_ = state.offset_size;
+    } else if (query_buffer.buffer_size_ != nullptr) {
       *query_buffer.buffer_size_ = state.data_size;
+    }
   }
 
   return Status::Ok();
@@ -648,6 +1238,9 @@ RestClient::RestClient() {
   (void)config_;
   (void)rest_server_;
   (void)serialization_type_;
+  (void)stream_incomplete_;
+  (void)cache_ttl_ms_;
+  (void)read_partition_num_;
 }
 
 Status RestClient::init(const Config*) {
@@ -704,6 +1297,12 @@ Status RestClient::submit_query_to_rest(const URI&, Query*) {
       Status::RestError("Cannot use rest client; serialization not enabled."));
 }
 
+Status RestClient::submit_query_to_rest_async(
+    const URI&, Query*, std::function<void(const Status&)>&&) {
+  return LOG_STATUS(
+      Status::RestError("Cannot use rest client; serialization not enabled."));
+}
+
 Status RestClient::finalize_query_to_rest(const URI&, Query*) {
   return LOG_STATUS(
       Status::RestError("Cannot use rest client; serialization not enabled."));
@@ -33,9 +33,15 @@
 #ifndef TILEDB_REST_CLIENT_H
 #define TILEDB_REST_CLIENT_H
 
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
+#include "tiledb/sm/buffer/buffer.h"
 #include "tiledb/sm/misc/status.h"
 #include "tiledb/sm/serialization/query.h"
 
@@ -44,11 +50,16 @@ namespace sm {
 
 class ArraySchema;
 class Config;
+class Curl;
+class CurlEventLoop;
+class CurlHandlePool;
 class Query;
 
 enum class SerializationType : uint8_t;
 
 class RestClient {
+  friend class RestQueryStream;
+
  public:
   /** Constructor. */
   RestClient();
@@ -143,6 +154,21 @@ class RestClient {
    */
   Status submit_query_to_rest(const URI& uri, Query* query);
 
+  /**
+   * Post a data query to rest server without waiting for the response. The
+   * request is performed on a background thread shared by the asynchronous
+   * submissions of this client, which deserializes the response into the
+   * query and then invokes `done`. The query reads as in progress until then.
+   *
+   * @param uri of array being queried
+   * @param query to send to server and store results in, this will be
+   *    modified; it must stay alive until `done` is invoked
+   * @param done Invoked on the background thread with the submission result
+   * @return Status Ok() if the request was started, Error() on failures
+   */
+  Status submit_query_to_rest_async(
+      const URI& uri, Query* query, std::function<void(const Status&)>&& done);
+
   /**
    * Post a data query to rest server
    *
@@ -153,6 +179,82 @@ class RestClient {
   Status finalize_query_to_rest(const URI& uri, Query* query);
 
  private:
+  /* ********************************* */
+  /*        PRIVATE DATATYPES          */
+  /* ********************************* */
+
+  /**
+   * The state of a query submission response across the invocations of
+   * `post_data_write_cb`. Only the size prefix and the message of each
+   * serialized query are buffered; the attribute data that follow the
+   * message are copied straight into the user buffers.
+   */
+  struct QueryResponseState {
+    /** The size prefix, then the message, of the query being received. */
+    Buffer scratch;
+
+    /** The size of the query being received, or 0 if not known yet. */
+    uint64_t query_size;
+
+    /** The size of its message, or 0 if not received entirely yet. */
+    uint64_t message_size;
+
+    /** The destinations of its attribute data in the user buffers. */
+    std::vector<serialization::BufferDestination> destinations;
+
+    /** The index of the destination being filled. */
+    size_t dest_idx;
+
+    /** The number of bytes already copied to that destination. */
+    uint64_t dest_offset;
+
+    /**
+     * True if the response may be paused when the user buffers are full,
+     * instead of failing.
+     */
+    bool pausable;
+
+    /**
+     * The number of bytes of the data passed again by libcurl after a pause
+     * that have already been processed.
+     */
+    uint64_t skip_nbytes;
+
+    /** Constructor. */
+    QueryResponseState()
+        : query_size(0)
+        , message_size(0)
+        , dest_idx(0)
+        , dest_offset(0)
+        , pausable(false)
+        , skip_nbytes(0) {
+    }
+
+    /** Discards the query being received. */
+    void clear() {
+      scratch.reset_size();
+      scratch.reset_offset();
+      query_size = 0;
+      message_size = 0;
+      destinations.clear();
+      dest_idx = 0;
+      dest_offset = 0;
+      skip_nbytes = 0;
+    }
+  };
+
+  /** The state of an asynchronous query submission. */
+  struct AsyncSubmission;
+
+  /** A response of the REST server kept in `response_cache_`. */
+  struct CachedResponse {
+    /** The response data. */
+    std::shared_ptr<const Buffer> data;
+
+    /** When the response was received. */
+    std::chrono::steady_clock::time_point time;
+  };
+
   /* ********************************* */
   /*        PRIVATE ATTRIBUTES         */
   /* ********************************* */
@@ -177,9 +279,52 @@ class RestClient {
    */
   bool resubmit_incomplete_;
 
+  /**
+   * If true (`rest.stream_incomplete`, false by default), read queries
+   * receive all their results in one streamed response, which is paused
+   * when the user buffers are full and resumed on the next submission.
+   */
+  bool stream_incomplete_;
+
+  /**
+   * The time in milliseconds for which the array schemas and non-empty
+   * domains received from the server are reused (`rest.cache_ttl_ms`).
+   * 0 disables the cache.
+   */
+  uint64_t cache_ttl_ms_;
+
+  /**
+   * The number of partitions a read query with a single range per dimension
+   * is split into and submitted concurrently (`rest.read_partition_num`).
+   * 1 disables splitting.
+   */
+  uint64_t read_partition_num_;
+
+  /** The cached schema and non-empty domain responses, by array and kind. */
+  std::unordered_map<std::string, CachedResponse> response_cache_;
+
+  /** Protects `response_cache_`. */
+  std::mutex response_cache_mtx_;
+
   /** Collection of extra headers that are attached to REST requests. */
   std::unordered_map<std::string, std::string> extra_headers_;
 
+  /**
+   * The curl handles reused across requests, which keep their connections
+   * to the server open.
+   */
+  std::shared_ptr<CurlHandlePool> curl_pool_;
+
+  /**
+   * The loop performing the asynchronous query submissions, created on the
+   * first one. It is declared after `curl_pool_` so that its pending
+   * requests are cancelled before the pool is destroyed.
+   */
+  std::shared_ptr<CurlEventLoop> curl_loop_;
+
+  /** Protects `curl_loop_`. */
+  std::mutex curl_loop_mtx_;
+
   /* ********************************* */
   /*         PRIVATE METHODS           */
   /* ********************************* */
@@ -203,6 +348,94 @@ class RestClient {
   Status post_query_submit(
       const URI& uri, Query* query, serialization::CopyState* copy_state);
 
+  /**
+   * Splits a read query into `read_partition_num_` partitions along the
+   * slowest varying dimension of its layout, submits them concurrently into
+   * scratch buffers sized from the max buffer size estimates of the server,
+   * and concatenates their results into the user buffers.
+   *
+   * @param uri URI of array being queried
+   * @param query Query to split, which receives the results
+   * @param copy_state Map of copy state per attribute, updated with the
+   *    number of bytes copied into the user buffers.
+   * @param submitted Set to false if the query could not be split, or if
+   *    the partitions did not complete or their results do not fit in the
+   *    user buffers. The query must then be submitted whole.
+   * @return Status
+   */
+  Status post_query_submit_partitioned(
+      const URI& uri,
+      Query* query,
+      serialization::CopyState* copy_state,
+      bool* submitted);
+
+  /**
+   * Like `post_query_submit` for read queries, but the server pushes all the
+   * batches of results in one streamed response. The batches are copied
+   * into the user buffers until the next one does not fit; the response is
+   * then paused, and resumed by the next submission of the query.
+   *
+   * @param uri URI of array being queried
+   * @param query Query to send to server and store results in, this will be
+   *    modified.
+   * @param copy_state Map of copy state per attribute, updated as attribute
+   *    data is copied into user buffers.
+   * @return Status
+   */
+  Status post_query_submit_streamed(
+      const URI& uri, Query* query, serialization::CopyState* copy_state);
+
+  /**
+   * Gets the loop performing the asynchronous query submissions, creating it
+   * if needed.
+   *
+   * @param loop Set to the loop
+   * @return Status
+   */
+  Status curl_event_loop(CurlEventLoop** loop);
+
+  /**
+   * GETs the given URL, unless the response cached under the given key is
+   * younger than the cache TTL, in which case that response is returned.
+   * Otherwise the response is cached (if the cache is enabled).
+   *
+   * @param curlc Curl instance to make the request with
+   * @param url URL to get
+   * @param key Cache key of the response
+   * @param data Set to the response data
+   * @return Status
+   */
+  Status get_data_cached(
+      Curl* curlc,
+      const std::string& url,
+      const std::string& key,
+      std::shared_ptr<const Buffer>* data);
+
+  /**
+   * Drops the cached responses about the array with the given URI, whose
+   * schema or non-empty domain is about to change.
+   *
+   * @param uri URI of the array
+   */
+  void invalidate_cache(const URI& uri);
+
+  /**
+   * Forms the URL to submit a query to.
+   *
+   * @param uri URI of array being queried
+   * @param query Query to submit
+   * @param read_all Whether the server resubmits incomplete queries
+   * @param curlc Curl instance used to escape the URL
+   * @param url Set to the URL
+   * @return Status
+   */
+  Status query_submit_url(
+      const URI& uri,
+      const Query* query,
+      bool read_all,
+      const Curl& curlc,
+      std::string* url) const;
+
   /**
    * Callback to invoke as partial, buffered response data is received from
    * posting a query.
@@ -210,15 +443,19 @@ class RestClient {
    * This is not thread-safe. It expects the response data to be ordered. The
    * response must contain serialized query objects, prefixed by an 8-byte
    * unsigned integer that contains the byte-size of the serialized query object
-   * it is prefixing. The scratch space must be empty before the first
-   * invocation, and must not change until the last invocation has completed.
+   * it is prefixing. The state must be empty before the first invocation, and
+   * must not change until the last invocation has completed.
+   *
+   * With Cap'n Proto serialization, the attribute data of read responses are
+   * copied directly from 'contents' into the user buffers; only the size
+   * prefix and the message are buffered in the state.
    *
    * @param reset True if the callback must wipe the in-memory state
    * @param contents the partial response data
    * @param content_nbytes the size of the response data in 'contents'
    * @param skip_retries Output argument that can be set to true to
    *    prevent the curl layer from retrying this request.
-   * @scratch scratch space to use between invocations of this callback
+   * @param state the response state kept between invocations of this callback
    * @query the query object used for deserializing the serialized query
    *    objects in the response data.
    * @param copy_state Map of copy state per attribute. As attribute data is
@@ -231,7 +468,7 @@ class RestClient {
       void* contents,
       size_t content_nbytes,
       bool* skip_retries,
-      Buffer* scratch,
+      QueryResponseState* state,
       Query* query,
       serialization::CopyState* copy_state);
 
@@ -37,13 +37,189 @@
 #include "tiledb/sm/misc/logger.h"
 #include "tiledb/sm/misc/utils.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <iostream>
-#include <list>
+#include <numeric>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 namespace tiledb {
 namespace sm {
 
+namespace {
+
+/**
+ * Transposes ``num`` records of ``value_num`` values of ``value_size``
+ * bytes each, from an array of structs ``aos`` to a struct of arrays
+ * ``soa``.
+ */
+void aos_to_soa(
+    const uint8_t* aos,
+    uint64_t num,
+    unsigned value_num,
+    uint64_t value_size,
+    uint8_t* soa) {
+  for (uint64_t i = 0; i < num; ++i) {
+    for (unsigned v = 0; v < value_num; ++v) {
+      std::memcpy(
+          soa + (v * num + i) * value_size,
+          aos + (i * value_num + v) * value_size,
+          value_size);
+    }
+  }
+}
+
+/** The inverse of `aos_to_soa`. */
+void soa_to_aos(
+    const uint8_t* soa,
+    uint64_t num,
+    unsigned value_num,
+    uint64_t value_size,
+    uint8_t* aos) {
+  for (uint64_t i = 0; i < num; ++i) {
+    for (unsigned v = 0; v < value_num; ++v) {
+      std::memcpy(
+          aos + (i * value_num + v) * value_size,
+          soa + (v * num + i) * value_size,
+          value_size);
+    }
+  }
+}
+
+/**
+ * Clears the entries of `overlaps` of the MBRs whose `[lows[i], highs[i]]`
+ * does not intersect `[low, high]`, starting at MBR `start`.
+ */
+template <class T>
+void compute_overlaps_scalar(
+    const T* lows,
+    const T* highs,
+    uint64_t start,
+    uint64_t num,
+    T low,
+    T high,
+    uint8_t* overlaps) {
+  for (uint64_t i = start; i < num; ++i)
+    overlaps[i] &= (uint8_t)(lows[i] <= high && highs[i] >= low);
+}
+
+/**
+ * Clears the entries of `overlaps` of the `num` MBRs whose
+ * `[lows[i], highs[i]]` does not intersect `[low, high]`.
+ */
+template <class T>
+void compute_overlaps(
+    const T* lows,
+    const T* highs,
+    uint64_t num,
+    T low,
+    T high,
+    uint8_t* overlaps) {
+  compute_overlaps_scalar(lows, highs, 0, num, low, high, overlaps);
+}
+
+#ifdef __AVX2__
+
+/** Clears the `n` entries of `overlaps` whose bits are not set in `bits`. */
+inline void clear_overlaps(uint8_t* overlaps, int bits, unsigned n) {
+  for (unsigned j = 0; j < n; ++j)
+    overlaps[j] &= (uint8_t)((bits >> j) & 1);
+}
+
+template <>
+void compute_overlaps<int32_t>(
+    const int32_t* lows,
+    const int32_t* highs,
+    uint64_t num,
+    int32_t low,
+    int32_t high,
+    uint8_t* overlaps) {
+  uint64_t i = 0;
+  auto l = _mm256_set1_epi32(low);
+  auto h = _mm256_set1_epi32(high);
+  for (; i + 8 <= num; i += 8) {
+    auto lo = _mm256_loadu_si256((const __m256i*)&lows[i]);
+    auto hi = _mm256_loadu_si256((const __m256i*)&highs[i]);
+    auto out =
+        _mm256_or_si256(_mm256_cmpgt_epi32(lo, h), _mm256_cmpgt_epi32(l, hi));
+    clear_overlaps(
+        &overlaps[i], ~_mm256_movemask_ps(_mm256_castsi256_ps(out)), 8);
+  }
+  compute_overlaps_scalar(lows, highs, i, num, low, high, overlaps);
+}
+
+template <>
+void compute_overlaps<int64_t>(
+    const int64_t* lows,
+    const int64_t* highs,
+    uint64_t num,
+    int64_t low,
+    int64_t high,
+    uint8_t* overlaps) {
+  uint64_t i = 0;
+  auto l = _mm256_set1_epi64x(low);
+  auto h = _mm256_set1_epi64x(high);
+  for (; i + 4 <= num; i += 4) {
+    auto lo = _mm256_loadu_si256((const __m256i*)&lows[i]);
+    auto hi = _mm256_loadu_si256((const __m256i*)&highs[i]);
+    auto out =
+        _mm256_or_si256(_mm256_cmpgt_epi64(lo, h), _mm256_cmpgt_epi64(l, hi));
+    clear_overlaps(
+        &overlaps[i], ~_mm256_movemask_pd(_mm256_castsi256_pd(out)), 4);
+  }
+  compute_overlaps_scalar(lows, highs, i, num, low, high, overlaps);
+}
+
+template <>
+void compute_overlaps<float>(
+    const float* lows,
+    const float* highs,
+    uint64_t num,
+    float low,
+    float high,
+    uint8_t* overlaps) {
+  uint64_t i = 0;
+  auto l = _mm256_set1_ps(low);
+  auto h = _mm256_set1_ps(high);
+  for (; i + 8 <= num; i += 8) {
+    auto lo = _mm256_loadu_ps(&lows[i]);
+    auto hi = _mm256_loadu_ps(&highs[i]);
+    auto in = _mm256_movemask_ps(_mm256_and_ps(
+        _mm256_cmp_ps(lo, h, _CMP_LE_OQ), _mm256_cmp_ps(hi, l, _CMP_GE_OQ)));
+    clear_overlaps(&overlaps[i], in, 8);
+  }
+  compute_overlaps_scalar(lows, highs, i, num, low, high, overlaps);
+}
+
+template <>
+void compute_overlaps<double>(
+    const double* lows,
+    const double* highs,
+    uint64_t num,
+    double low,
+    double high,
+    uint8_t* overlaps) {
+  uint64_t i = 0;
+  auto l = _mm256_set1_pd(low);
+  auto h = _mm256_set1_pd(high);
+  for (; i + 4 <= num; i += 4) {
+    auto lo = _mm256_loadu_pd(&lows[i]);
+    auto hi = _mm256_loadu_pd(&highs[i]);
+    auto in = _mm256_movemask_pd(_mm256_and_pd(
+        _mm256_cmp_pd(lo, h, _CMP_LE_OQ), _mm256_cmp_pd(hi, l, _CMP_GE_OQ)));
+    clear_overlaps(&overlaps[i], in, 4);
+  }
+  compute_overlaps_scalar(lows, highs, i, num, low, high, overlaps);
+}
+
+#endif
+
+}  // namespace
+
 /* ****************************** */
 /*   CONSTRUCTORS & DESTRUCTORS   */
 /* ****************************** */
@@ -58,11 +234,12 @@ RTree::RTree(
     Datatype type,
     unsigned dim_num,
     unsigned fanout,
-    const std::vector<void*>& mbrs)
+    const std::vector<void*>& mbrs,
+    bool str_packing)
     : dim_num_(dim_num)
     , fanout_(fanout)
     , type_(type) {
-  build_tree(mbrs);
+  build_tree(mbrs, str_packing);
 }
 
 RTree::~RTree() = default;
@@ -111,51 +288,94 @@ TileOverlap RTree::get_tile_overlap(const std::vector<const T*>& range) const {
   if (dim_num_ == 0 || levels_.empty())
     return overlap;
 
-  // This will keep track of the traversal
-  std::list<Entry> traversal;
-  traversal.push_front({0, 0});
   auto leaf_num = levels_.back().mbr_num_;
   auto height = this->height();
-  uint64_t mbr_size = 2 * dim_num_ * datatype_size(type_);
+  std::vector<T> mbr(2 * dim_num_);
+  std::vector<uint8_t> overlaps(fanout_);
+
+  // With STR packing, the leaves fully overlapping the range are collected
+  // and grouped into ranges of leaf indices at the end
+  std::vector<uint64_t> full_leaves;
+
+  // This will keep track of the traversal, which visits the MBRs
+  // overlapping the range in ascending order
+  std::vector<Entry> traversal;
+  level_mbr(levels_[0], 0, &mbr[0]);
+  auto root_ratio = this->range_overlap<T>(range, &mbr[0]);
+  if (root_ratio != 0.0)
+    traversal.push_back({0, 0, root_ratio});
 
   while (!traversal.empty()) {
     // Get next entry
-    auto entry = traversal.front();
-    traversal.pop_front();
+    auto entry = traversal.back();
+    traversal.pop_back();
     auto level = entry.level_;
     auto mbr_idx = entry.mbr_idx_;
-    auto offset = entry.mbr_idx_ * mbr_size;
-    auto mbr = levels_[level].mbrs_.data() + offset;
-
-    // Get
-    auto ratio = this->range_overlap<T>(range, (T*)mbr);
-
-    // If there is overlap
-    if (ratio != 0.0) {
-      // If there is full overlap
-      if (ratio == 1.0) {
-        auto subtree_leaf_num = this->subtree_leaf_num(level);
-        assert(subtree_leaf_num > 0);
-        uint64_t start = mbr_idx * subtree_leaf_num;
-        uint64_t end = start + std::min(subtree_leaf_num, leaf_num - start) - 1;
-        auto tile_range = std::pair<uint64_t, uint64_t>(start, end);
-        overlap.tile_ranges_.emplace_back(tile_range);
-      } else {  // Partial overlap
-        // If this is the leaf level, insert into results
-        if (level == height - 1) {
-          auto mbr_idx_ratio = std::pair<uint64_t, double>(mbr_idx, ratio);
-          overlap.tiles_.emplace_back(mbr_idx_ratio);
-        } else {  // Insert all "children" to traversal
-          auto next_mbr_num = levels_[level + 1].mbr_num_;
-          auto start = mbr_idx * fanout_;
-          auto end = std::min(start + fanout_ - 1, next_mbr_num - 1);
-          for (uint64_t i = start; i <= end; ++i)
-            traversal.push_front({level + 1, end - (i - start)});
-        }
+    auto ratio = entry.ratio_;
+
+    // If there is full overlap
+    if (ratio == 1.0) {
+      auto subtree_leaf_num = this->subtree_leaf_num(level);
+      assert(subtree_leaf_num > 0);
+      uint64_t start = mbr_idx * subtree_leaf_num;
+      uint64_t end = start + std::min(subtree_leaf_num, leaf_num - start) - 1;
+      if (leaf_ids_.empty()) {
+        overlap.tile_ranges_.emplace_back(start, end);
+      } else {
+        for (uint64_t i = start; i <= end; ++i)
+          full_leaves.push_back(leaf_ids_[i]);
       }
+      continue;
+    }
+
+    // If this is the leaf level, insert into results
+    if (level == height - 1) {
+      auto leaf_idx = leaf_ids_.empty() ? mbr_idx : leaf_ids_[mbr_idx];
+      overlap.tiles_.emplace_back(leaf_idx, ratio);
+      continue;
+    }
+
+    // Mark the children intersecting the range on every dimension
+    const auto& child_level = levels_[level + 1];
+    auto child_num = child_level.mbr_num_;
+    auto start = mbr_idx * fanout_;
+    auto num = std::min<uint64_t>(fanout_, child_num - start);
+    auto child_mbrs = (const T*)child_level.mbrs_.data();
+    std::fill(overlaps.begin(), overlaps.end(), 1);
+    for (unsigned d = 0; d < dim_num_; ++d) {
+      compute_overlaps<T>(
+          &child_mbrs[2 * d * child_num + start],
+          &child_mbrs[(2 * d + 1) * child_num + start],
+          num,
+          range[d][0],
+          range[d][1],
+          &overlaps[0]);
+    }
+
+    // Insert the overlapping children to the traversal, the first child last
+    for (uint64_t i = num; i-- > 0;) {
+      if (!overlaps[i])
+        continue;
+      level_mbr(child_level, start + i, &mbr[0]);
+      auto child_ratio = this->range_overlap<T>(range, &mbr[0]);
+      traversal.push_back({level + 1, start + i, child_ratio});
     }
   }
 
+  // Sort the results by leaf index, grouping the contiguous full overlaps
+  if (!leaf_ids_.empty()) {
+    std::sort(full_leaves.begin(), full_leaves.end());
+    for (size_t i = 0; i < full_leaves.size();) {
+      auto j = i;
+      while (j + 1 < full_leaves.size() &&
+             full_leaves[j + 1] == full_leaves[j] + 1)
+        ++j;
+      overlap.tile_ranges_.emplace_back(full_leaves[i], full_leaves[j]);
+      i = j + 1;
+    }
+    std::sort(overlap.tiles_.begin(), overlap.tiles_.end());
+  }
+
   return overlap;
 }
 
@@ -163,13 +383,14 @@ unsigned RTree::height() const {
   return (unsigned)levels_.size();
 }
 
-const void* RTree::leaf(uint64_t leaf_idx) const {
-  if (leaf_idx >= levels_.back().mbr_num_)
-    return nullptr;
-  assert(leaf_idx < levels_.back().mbr_num_);
+void RTree::leaf(uint64_t leaf_idx, void* mbr) const {
+  assert(leaf_idx < leaf_num());
+  auto pos = leaf_pos_.empty() ? leaf_idx : leaf_pos_[leaf_idx];
+  level_mbr(levels_.back(), pos, mbr);
+}
 
-  uint64_t mbr_size = 2 * dim_num_ * datatype_size(type_);
-  return (const void*)&(levels_.back().mbrs_[leaf_idx * mbr_size]);
+uint64_t RTree::leaf_num() const {
+  return levels_.empty() ? 0 : levels_.back().mbr_num_;
 }
 
 template <class T>
@@ -214,6 +435,18 @@ double RTree::range_overlap(const std::vector<const T*>& range, const T* mbr) {
   return ratio;
 }
 
+bool RTree::str_packed() const {
+  return !leaf_ids_.empty();
+}
+
+uint64_t RTree::size() const {
+  uint64_t size = 0;
+  for (const auto& level : levels_)
+    size += level.mbrs_.size();
+  size += leaf_ids_.size() * sizeof(uint64_t);
+  return size;
+}
+
 uint64_t RTree::subtree_leaf_num(uint64_t level) const {
   // Check invalid level
   if (level >= levels_.size())
@@ -239,12 +472,27 @@ Status RTree::serialize(Buffer* buff) const {
   auto level_num = (unsigned)levels_.size();
   RETURN_NOT_OK(buff->write(&level_num, sizeof(level_num)));
 
+  std::vector<uint8_t> mbrs;
   for (unsigned i = 0; i < level_num; ++i) {
     auto mbr_num = levels_[i].mbr_num_;
     auto mbrs_size = levels_[i].mbrs_.size();
-    auto mbrs = levels_[i].mbrs_.data();
+    mbrs.resize(mbrs_size);
+    soa_to_aos(
+        levels_[i].mbrs_.data(),
+        mbr_num,
+        2 * dim_num_,
+        datatype_size(type_),
+        mbrs.data());
     RETURN_NOT_OK(buff->write(&mbr_num, sizeof(uint64_t)));
-    RETURN_NOT_OK(buff->write(mbrs, mbrs_size));
+    RETURN_NOT_OK(buff->write(mbrs.data(), mbrs_size));
+  }
+
+  // The leaf order is written only for STR-packed trees
+  if (!leaf_ids_.empty()) {
+    uint64_t leaf_id_num = leaf_ids_.size();
+    RETURN_NOT_OK(buff->write(&leaf_id_num, sizeof(uint64_t)));
+    RETURN_NOT_OK(
+        buff->write(leaf_ids_.data(), leaf_id_num * sizeof(uint64_t)));
   }
 
   return Status::Ok();
@@ -263,13 +511,35 @@ Status RTree::deserialize(ConstBuffer* cbuff) {
   levels_.resize(level_num);
   uint64_t mbr_size = 2 * dim_num_ * datatype_size(type_);
   uint64_t mbr_num;
+  std::vector<uint8_t> mbrs;
   for (unsigned i = 0; i < level_num; ++i) {
     RETURN_NOT_OK(cbuff->read(&mbr_num, sizeof(uint64_t)));
     levels_[i].mbr_num_ = mbr_num;
     auto mbrs_size = mbr_num * mbr_size;
+    mbrs.resize(mbrs_size);
     levels_[i].mbrs_.resize(mbrs_size);
-    RETURN_NOT_OK(cbuff->read(&levels_[i].mbrs_[0], mbrs_size));
+    RETURN_NOT_OK(cbuff->read(mbrs.data(), mbrs_size));
+    aos_to_soa(
+        mbrs.data(),
+        mbr_num,
+        2 * dim_num_,
+        datatype_size(type_),
+        levels_[i].mbrs_.data());
+  }
+
+  // Load the leaf order of STR-packed trees
+  leaf_ids_.clear();
+  if (cbuff->nbytes_left_to_read() > 0) {
+    uint64_t leaf_id_num;
+    RETURN_NOT_OK(cbuff->read(&leaf_id_num, sizeof(uint64_t)));
+    if (level_num == 0 || leaf_id_num != levels_.back().mbr_num_)
+      return LOG_STATUS(Status::RTreeError(
+          "Cannot deserialize R-Tree; Invalid number of leaf ids"));
+    leaf_ids_.resize(leaf_id_num);
+    RETURN_NOT_OK(
+        cbuff->read(leaf_ids_.data(), leaf_id_num * sizeof(uint64_t)));
   }
+  set_leaf_pos();
 
   return Status::Ok();
 }
@@ -278,28 +548,29 @@ Status RTree::deserialize(ConstBuffer* cbuff) {
 /*          PRIVATE METHODS       */
 /* ****************************** */
 
-Status RTree::build_tree(const std::vector<void*>& mbrs) {
+Status RTree::build_tree(
+    const std::vector<void*>& mbrs, bool str_packing) {
   switch (type_) {
     case Datatype::INT8:
-      return build_tree<int8_t>(mbrs);
+      return build_tree<int8_t>(mbrs, str_packing);
     case Datatype::UINT8:
-      return build_tree<uint8_t>(mbrs);
+      return build_tree<uint8_t>(mbrs, str_packing);
     case Datatype::INT16:
-      return build_tree<int16_t>(mbrs);
+      return build_tree<int16_t>(mbrs, str_packing);
     case Datatype::UINT16:
-      return build_tree<uint16_t>(mbrs);
+      return build_tree<uint16_t>(mbrs, str_packing);
     case Datatype::INT32:
-      return build_tree<int32_t>(mbrs);
+      return build_tree<int32_t>(mbrs, str_packing);
     case Datatype::UINT32:
-      return build_tree<uint32_t>(mbrs);
+      return build_tree<uint32_t>(mbrs, str_packing);
     case Datatype::INT64:
-      return build_tree<int64_t>(mbrs);
+      return build_tree<int64_t>(mbrs, str_packing);
     case Datatype::UINT64:
-      return build_tree<uint64_t>(mbrs);
+      return build_tree<uint64_t>(mbrs, str_packing);
     case Datatype::FLOAT32:
-      return build_tree<float>(mbrs);
+      return build_tree<float>(mbrs, str_packing);
     case Datatype::FLOAT64:
-      return build_tree<double>(mbrs);
+      return build_tree<double>(mbrs, str_packing);
     case Datatype::DATETIME_YEAR:
     case Datatype::DATETIME_MONTH:
     case Datatype::DATETIME_WEEK:
@@ -313,7 +584,7 @@ Status RTree::build_tree(const std::vector<void*>& mbrs) {
     case Datatype::DATETIME_PS:
     case Datatype::DATETIME_FS:
     case Datatype::DATETIME_AS:
-      return build_tree<int64_t>(mbrs);
+      return build_tree<int64_t>(mbrs, str_packing);
     default:
       assert(false);
       return LOG_STATUS(
@@ -324,13 +595,33 @@ Status RTree::build_tree(const std::vector<void*>& mbrs) {
 }
 
 template <class T>
-Status RTree::build_tree(const std::vector<void*>& mbrs) {
+Status RTree::build_tree(const std::vector<void*>& mbrs, bool str_packing) {
   // Handle empty tree
   if (mbrs.empty())
     return Status::Ok();
 
+  // Order the leaves with Sort-Tile-Recursive, on the MBR centers
+  leaf_ids_.clear();
+  auto mbr_num = (uint64_t)mbrs.size();
+  if (str_packing && mbr_num > fanout_) {
+    std::vector<double> centers(mbr_num * dim_num_);
+    for (uint64_t i = 0; i < mbr_num; ++i) {
+      auto mbr = (const T*)mbrs[i];
+      for (unsigned d = 0; d < dim_num_; ++d)
+        centers[i * dim_num_ + d] = mbr[2 * d] / 2.0 + mbr[2 * d + 1] / 2.0;
+    }
+    leaf_ids_.resize(mbr_num);
+    std::iota(leaf_ids_.begin(), leaf_ids_.end(), 0);
+    str_sort(centers, leaf_ids_.begin(), leaf_ids_.end(), 0);
+
+    // Keep the input order if packing does not change it
+    if (std::is_sorted(leaf_ids_.begin(), leaf_ids_.end()))
+      leaf_ids_.clear();
+  }
+  set_leaf_pos();
+
   // Build leaf level
-  auto leaf_level = build_leaf_level(mbrs);
+  auto leaf_level = build_leaf_level<T>(mbrs);
   auto leaf_num = leaf_level.mbr_num_;
   levels_.push_back(std::move(leaf_level));
   if (leaf_num == 1)
@@ -349,23 +640,23 @@ Status RTree::build_tree(const std::vector<void*>& mbrs) {
   return Status::Ok();
 }
 
+template <class T>
 RTree::Level RTree::build_leaf_level(const std::vector<void*>& mbrs) {
   assert(!mbrs.empty());
 
   Level new_level;
 
   // Allocate space
-  uint64_t mbr_size = 2 * dim_num_ * datatype_size(type_);
-  uint64_t leaf_level_size = mbrs.size() * mbr_size;
-  new_level.mbr_num_ = mbrs.size();
-  new_level.mbrs_.resize(leaf_level_size);
-
-  // Copy MBRs
-  uint64_t offset = 0;
-  for (auto mbr : mbrs) {
-    auto copy_loc = new_level.mbrs_.data() + offset;
-    std::memcpy(copy_loc, mbr, mbr_size);
-    offset += mbr_size;
+  uint64_t mbr_num = mbrs.size();
+  new_level.mbr_num_ = mbr_num;
+  new_level.mbrs_.resize(mbr_num * 2 * dim_num_ * sizeof(T));
+
+  // Copy MBRs, transposing them into one array per bound
+  auto level_mbrs = (T*)new_level.mbrs_.data();
+  for (uint64_t i = 0; i < mbr_num; ++i) {
+    auto mbr = (const T*)mbrs[leaf_ids_.empty() ? i : leaf_ids_[i]];
+    for (unsigned v = 0; v < 2 * dim_num_; ++v)
+      level_mbrs[v * mbr_num + i] = mbr[v];
   }
 
   return new_level;
@@ -375,32 +666,81 @@ template <class T>
 RTree::Level RTree::build_level(const Level& level) {
   Level new_level;
 
-  uint64_t mbr_size = 2 * dim_num_ * datatype_size(type_);
-  new_level.mbr_num_ = (uint64_t)ceil((double)level.mbr_num_ / fanout_);
-  uint64_t new_level_size = new_level.mbr_num_ * mbr_size;
-  new_level.mbrs_.resize(new_level_size);
-
-  uint64_t mbrs_visited = 0, offset_level = 0, offset_new_level = 0;
-  for (uint64_t i = 0; i < new_level.mbr_num_; ++i) {
-    auto mbr_num = std::min<uint64_t>(fanout_, level.mbr_num_ - mbrs_visited);
-    auto mbr_at = (T*)(level.mbrs_.data() + offset_level);
-    auto union_loc = (T*)(new_level.mbrs_.data() + offset_new_level);
-    utils::geometry::compute_mbr_union<T>(dim_num_, mbr_at, mbr_num, union_loc);
-    mbrs_visited += mbr_num;
-    offset_level += mbr_num * mbr_size;
-    offset_new_level += mbr_size;
+  auto mbr_num = level.mbr_num_;
+  new_level.mbr_num_ = (uint64_t)ceil((double)mbr_num / fanout_);
+  auto new_mbr_num = new_level.mbr_num_;
+  new_level.mbrs_.resize(new_mbr_num * 2 * dim_num_ * sizeof(T));
+
+  // Each new MBR is the union of `fanout_` consecutive MBRs
+  auto mbrs = (const T*)level.mbrs_.data();
+  auto new_mbrs = (T*)new_level.mbrs_.data();
+  for (unsigned d = 0; d < dim_num_; ++d) {
+    auto lows = &mbrs[2 * d * mbr_num];
+    auto highs = &mbrs[(2 * d + 1) * mbr_num];
+    auto new_lows = &new_mbrs[2 * d * new_mbr_num];
+    auto new_highs = &new_mbrs[(2 * d + 1) * new_mbr_num];
+    for (uint64_t i = 0; i < new_mbr_num; ++i) {
+      auto start = i * fanout_;
+      auto end = std::min<uint64_t>(start + fanout_, mbr_num);
+      new_lows[i] = *std::min_element(&lows[start], &lows[end]);
+      new_highs[i] = *std::max_element(&highs[start], &highs[end]);
+    }
   }
-  assert(mbrs_visited == level.mbr_num_);
 
   return new_level;
 }
 
+void RTree::str_sort(
+    const std::vector<double>& centers,
+    std::vector<uint64_t>::iterator first,
+    std::vector<uint64_t>::iterator last,
+    unsigned dim) {
+  auto dim_num = dim_num_;
+  std::sort(first, last, [&](uint64_t a, uint64_t b) {
+    return centers[a * dim_num + dim] < centers[b * dim_num + dim];
+  });
+  if (dim + 1 == dim_num_)
+    return;
+
+  // Split into slices of whole nodes and sort each on the next dimension
+  auto num = (uint64_t)(last - first);
+  auto node_num = (num + fanout_ - 1) / fanout_;
+  auto slice_num =
+      (uint64_t)std::ceil(std::pow((double)node_num, 1.0 / (dim_num_ - dim)));
+  auto slice_size = fanout_ * ((node_num + slice_num - 1) / slice_num);
+  for (auto it = first; it != last;) {
+    auto next = ((uint64_t)(last - it) > slice_size) ? it + slice_size : last;
+    str_sort(centers, it, next, dim + 1);
+    it = next;
+  }
+}
+
+void RTree::level_mbr(const Level& level, uint64_t mbr_idx, void* mbr) const {
+  auto value_size = datatype_size(type_);
+  auto mbr_num = level.mbr_num_;
+  auto out = (uint8_t*)mbr;
+  for (unsigned v = 0; v < 2 * dim_num_; ++v) {
+    std::memcpy(
+        out + v * value_size,
+        &level.mbrs_[(v * mbr_num + mbr_idx) * value_size],
+        value_size);
+  }
+}
+
+void RTree::set_leaf_pos() {
+  leaf_pos_.resize(leaf_ids_.size());
+  for (uint64_t i = 0; i < leaf_ids_.size(); ++i)
+    leaf_pos_[leaf_ids_[i]] = i;
+}
+
 RTree RTree::clone() const {
   RTree clone;
   clone.dim_num_ = dim_num_;
   clone.fanout_ = fanout_;
   clone.type_ = type_;
   clone.levels_ = levels_;
+  clone.leaf_ids_ = leaf_ids_;
+  clone.leaf_pos_ = leaf_pos_;
 
   return clone;
 }
@@ -410,6 +750,8 @@ void RTree::swap(RTree& rtree) {
   std::swap(fanout_, rtree.fanout_);
   std::swap(type_, rtree.type_);
   std::swap(levels_, rtree.levels_);
+  std::swap(leaf_ids_, rtree.leaf_ids_);
+  std::swap(leaf_pos_, rtree.leaf_pos_);
 }
 
 // Explicit template instantiations
@@ -51,6 +51,12 @@ enum class Layout : uint8_t;
  * A simple RTree implementation. It supports storing only n-dimensional
  * MBRs (not points). Also it only offers bottom-up bulk-loading
  * (without incremental updates), and range and point queries.
+ *
+ * The leaves are either grouped into nodes in the order of the input
+ * MBRs, or packed with Sort-Tile-Recursive (STR), which sorts them into
+ * spatially coherent nodes. The MBRs of each level are kept in memory as
+ * a struct of arrays, so that the children of a node are tested against
+ * a query range one dimension at a time (with SIMD where available).
  */
 class RTree {
  public:
@@ -65,13 +71,17 @@ class RTree {
    * Constructor. This admits a list of sorted MBRs that will
    * constitute the leaf level of the tree. The constructor will
    * construct bottom up the tree based on these ``mbrs``.
-   * The input MBRs will be copied into the leaf level.
+   * The input MBRs will be copied into the leaf level. If
+   * ``str_packing`` is ``true``, the leaves are packed into nodes
+   * with Sort-Tile-Recursive; the leaf indices exposed by the API
+   * remain the positions of the input MBRs.
    */
   RTree(
       Datatype type,
       unsigned dim_num,
       unsigned fanout,
-      const std::vector<void*>& mbrs);
+      const std::vector<void*>& mbrs,
+      bool str_packing = false);
 
   /** Destructor. */
   ~RTree();
@@ -108,8 +118,15 @@ class RTree {
   /** Returns the tree height. */
   unsigned height() const;
 
-  /** Returns the leaf MBR with the input index. */
-  const void* leaf(uint64_t leaf_idx) const;
+  /**
+   * Copies the leaf MBR with the input index into ``mbr``, in the form
+   * ``(low_1, high_1), ..., (low_d, high_d)``. The leaf index must be
+   * smaller than the number of leaves.
+   */
+  void leaf(uint64_t leaf_idx, void* mbr) const;
+
+  /** Returns the number of leaves. */
+  uint64_t leaf_num() const;
 
   /**
    * Returns the overlap between a range and an RTree MBR, as the ratio
@@ -118,6 +135,15 @@ class RTree {
   template <class T>
   static double range_overlap(const std::vector<const T*>& range, const T* mbr);
 
+  /** Returns `true` if the leaves are packed with Sort-Tile-Recursive. */
+  bool str_packed() const;
+
+  /**
+   * Returns the number of bytes occupied by the MBRs of all levels and
+   * the leaf order.
+   */
+  uint64_t size() const;
+
   /**
    * Returns the number of leaves that are stored in a (full) subtree
    * rooted at the input level. Note that the root is at level 0.
@@ -163,9 +189,11 @@ class RTree {
   struct Level {
     /** Number of MBRs in the level (across all nodes in the level). */
     uint64_t mbr_num_ = 0;
-    /** The serialized MBRs of the level, in the form
-     * ``(low_1, high_1), ..., (low_d, high_d)`` where ``d`` is
-     * the number of dimensions.
+    /** The MBRs of the level as a struct of arrays, in the form
+     * ``low_1[mbr_num_], high_1[mbr_num_], ..., low_d[mbr_num_],
+     * high_d[mbr_num_]`` where ``d`` is the number of dimensions.
+     * They are serialized in the form ``(low_1, high_1), ...,
+     * (low_d, high_d)`` per MBR.
      */
     std::vector<uint8_t> mbrs_;
   };
@@ -180,6 +208,8 @@ class RTree {
     uint64_t level_;
     /** The index of the first MBR of the corresponding node. */
     uint64_t mbr_idx_;
+    /** The overlap ratio of the query range with the MBR. */
+    double ratio_;
   };
 
   /* ********************************* */
@@ -201,24 +231,61 @@ class RTree {
    */
   std::vector<Level> levels_;
 
+  /**
+   * The input index of each leaf, in the order of the leaf level. Empty
+   * unless the leaves are packed with Sort-Tile-Recursive.
+   */
+  std::vector<uint64_t> leaf_ids_;
+
+  /**
+   * The position in the leaf level of each input leaf index (the inverse
+   * of `leaf_ids_`). Not serialized.
+   */
+  std::vector<uint64_t> leaf_pos_;
+
   /* ********************************* */
   /*           PRIVATE METHODS         */
   /* ********************************* */
 
   /** Builds the RTree bottom-up on the input MBRs. */
-  Status build_tree(const std::vector<void*>& mbrs);
+  Status build_tree(const std::vector<void*>& mbrs, bool str_packing);
 
   /** Builds the RTree bottom-up on the input MBRs. */
   template <class T>
-  Status build_tree(const std::vector<void*>& mbrs);
+  Status build_tree(const std::vector<void*>& mbrs, bool str_packing);
 
-  /** Builds the tree leaf level using the input mbrs. */
+  /**
+   * Builds the tree leaf level using the input mbrs, in the order of
+   * `leaf_ids_` if it is not empty.
+   */
+  template <class T>
   Level build_leaf_level(const std::vector<void*>& mbrs);
 
   /** Builds a single tree level on top of the input level. */
   template <class T>
   Level build_level(const Level& level);
 
+  /**
+   * Sorts the input leaf ids in Sort-Tile-Recursive order, on their MBR
+   * centers along dimension ``dim`` and the dimensions after it.
+   *
+   * @param centers The MBR centers, ``dim_num_`` values per leaf.
+   * @param first The first leaf id to sort.
+   * @param last One past the last leaf id to sort.
+   * @param dim The dimension to sort on.
+   */
+  void str_sort(
+      const std::vector<double>& centers,
+      std::vector<uint64_t>::iterator first,
+      std::vector<uint64_t>::iterator last,
+      unsigned dim);
+
+  /** Copies the MBR with the input index of the input level into ``mbr``. */
+  void level_mbr(const Level& level, uint64_t mbr_idx, void* mbr) const;
+
+  /** Rebuilds `leaf_pos_` from `leaf_ids_`. */
+  void set_leaf_pos();
+
   /** Returns a deep copy of this RTree. */
   RTree clone() const;
 
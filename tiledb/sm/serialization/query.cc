@@ -579,16 +579,20 @@ Status query_from_capnp(
       }
 
       // For reads, copy the response data into user buffers. For writes,
-      // nothing to do.
+      // nothing to do. A null buffer start means that the caller has already
+      // copied the data into the user buffers (see
+      // `query_deserialize_in_place`), so only the sizes are updated.
       if (type == QueryType::READ) {
         if (var_size) {
           char* offset_dest = (char*)existing_offset_buffer + curr_offset_size;
           char* data_dest = (char*)existing_buffer + curr_data_size;
           // Var size attribute; buffers already set.
-          std::memcpy(offset_dest, attribute_buffer_start, fixedlen_size);
-          attribute_buffer_start += fixedlen_size;
-          std::memcpy(data_dest, attribute_buffer_start, varlen_size);
-          attribute_buffer_start += varlen_size;
+          if (attribute_buffer_start != nullptr) {
+            std::memcpy(offset_dest, attribute_buffer_start, fixedlen_size);
+            attribute_buffer_start += fixedlen_size;
+            std::memcpy(data_dest, attribute_buffer_start, varlen_size);
+            attribute_buffer_start += varlen_size;
+          }
 
           if (attr_copy_state == nullptr) {
             // Set the size directly on the query (so user can introspect on
@@ -604,8 +608,10 @@ Status query_from_capnp(
         } else {
           // Fixed size attribute; buffers already set.
           char* data_dest = (char*)existing_buffer + curr_data_size;
-          std::memcpy(data_dest, attribute_buffer_start, fixedlen_size);
-          attribute_buffer_start += fixedlen_size;
+          if (attribute_buffer_start != nullptr) {
+            std::memcpy(data_dest, attribute_buffer_start, fixedlen_size);
+            attribute_buffer_start += fixedlen_size;
+          }
 
           if (attr_copy_state == nullptr) {
             *existing_buffer_size = fixedlen_size;
@@ -799,6 +805,7 @@ Status do_query_deserialize(
     const Buffer& serialized_buffer,
     SerializationType serialize_type,
     const SerializationContext context,
+    const bool data_in_place,
     CopyState* const copy_state,
     Query* query) {
   STATS_FUNC_IN(serialization_query_deserialize);
@@ -842,9 +849,13 @@ Status do_query_deserialize(
         capnp::Query::Reader query_reader = reader.getRoot<capnp::Query>();
 
         // Get a pointer to the start of the attribute buffer data (which
-        // was concatenated after the CapnP message on serialization).
+        // was concatenated after the CapnP message on serialization), unless
+        // the data are already in the user buffers.
         auto attribute_buffer_start = reader.getEnd();
-        auto buffer_start = const_cast<::capnp::word*>(attribute_buffer_start);
+        auto buffer_start =
+            data_in_place ?
+                nullptr :
+                const_cast<::capnp::word*>(attribute_buffer_start);
         return query_from_capnp(
             query_reader, context, buffer_start, copy_state, query);
       }
@@ -865,10 +876,15 @@ Status do_query_deserialize(
   STATS_FUNC_OUT(serialization_query_deserialize);
 }
 
-Status query_deserialize(
+/**
+ * Deserializes `serialized_buffer` into `query`, reverting `query` to its
+ * original state on failure.
+ */
+Status query_deserialize_or_revert(
     const Buffer& serialized_buffer,
     SerializationType serialize_type,
     bool clientside,
+    bool data_in_place,
     CopyState* copy_state,
     Query* query) {
   // Create an original, serialized copy of the 'query' that we will revert
@@ -894,6 +910,7 @@ Status query_deserialize(
       serialized_buffer,
       serialize_type,
       clientside ? SerializationContext::CLIENT : SerializationContext::SERVER,
+      data_in_place,
       copy_state,
       query);
 
@@ -911,6 +928,7 @@ Status query_deserialize(
         *original_buffer,
         serialize_type,
         SerializationContext::BACKUP,
+        false,
         copy_state,
         query);
     if (!st2.ok()) {
@@ -921,6 +939,181 @@ Status query_deserialize(
   return st;
 }
 
+Status query_deserialize(
+    const Buffer& serialized_buffer,
+    SerializationType serialize_type,
+    bool clientside,
+    CopyState* copy_state,
+    Query* query) {
+  return query_deserialize_or_revert(
+      serialized_buffer, serialize_type, clientside, false, copy_state, query);
+}
+
+Status query_message_size(
+    const void* const data,
+    const uint64_t nbytes,
+    uint64_t* const message_size) {
+  // The message starts with its segment table: the number of segments minus
+  // one, then the size of each segment in words, as 32-bit little-endian
+  // integers padded to a whole word.
+  const uint64_t word_size = sizeof(::capnp::word);
+  if (nbytes < sizeof(uint32_t)) {
+    *message_size = word_size;
+    return Status::Ok();
+  }
+
+  const auto table = static_cast<const char*>(data);
+  const uint64_t num_segments =
+      uint64_t(utils::endianness::decode_le<uint32_t>(table)) + 1;
+  const uint64_t table_size =
+      ((num_segments + 1) * sizeof(uint32_t) + word_size - 1) / word_size *
+      word_size;
+  if (nbytes < table_size) {
+    *message_size = table_size;
+    return Status::Ok();
+  }
+
+  uint64_t size = table_size;
+  for (uint64_t i = 0; i < num_segments; ++i)
+    size += word_size * utils::endianness::decode_le<uint32_t>(
+                            table + (i + 1) * sizeof(uint32_t));
+  *message_size = size;
+
+  return Status::Ok();
+}
+
+Status query_buffer_destinations(
+    const Buffer& serialized_message,
+    SerializationType serialize_type,
+    const CopyState* copy_state,
+    Query* query,
+    std::vector<BufferDestination>* destinations,
+    bool* fit) {
+  destinations->clear();
+  *fit = true;
+
+  if (serialize_type != SerializationType::CAPNP)
+    return LOG_STATUS(Status::SerializationError(
+        "Cannot get query buffer destinations; only capnp format supported."));
+
+  // Write responses carry no attribute data.
+  if (query->type() != QueryType::READ)
+    return Status::Ok();
+
+  const auto* schema = query->array_schema();
+  if (schema == nullptr)
+    return LOG_STATUS(Status::SerializationError(
+        "Cannot get query buffer destinations; array schema is null."));
+
+  // Capnp FlatArrayMessageReader requires 64-bit alignment.
+  if (!utils::is_aligned<sizeof(uint64_t)>(serialized_message.data()))
+    return LOG_STATUS(Status::SerializationError(
+        "Cannot get query buffer destinations; buffer is not 8-byte "
+        "aligned."));
+
+  try {
+    ::capnp::ReaderOptions readerOptions;
+    readerOptions.traversalLimitInWords = uint64_t(1024) * 1024 * 1024 * 10;
+    ::capnp::FlatArrayMessageReader reader(
+        kj::arrayPtr(
+            reinterpret_cast<const ::capnp::word*>(serialized_message.data()),
+            serialized_message.size() / sizeof(::capnp::word)),
+        readerOptions);
+    capnp::Query::Reader query_reader = reader.getRoot<capnp::Query>();
+
+    if (!query_reader.hasAttributeBufferHeaders())
+      return LOG_STATUS(Status::SerializationError(
+          "Cannot get query buffer destinations; no attribute buffer headers "
+          "in message."));
+
+    for (auto buffer_header : query_reader.getAttributeBufferHeaders()) {
+      const std::string name = buffer_header.getName().cStr();
+      const uint64_t fixedlen_size =
+          buffer_header.getFixedLenBufferSizeInBytes();
+      const uint64_t varlen_size = buffer_header.getVarLenBufferSizeInBytes();
+
+      // The data go after what previous responses copied.
+      uint64_t curr_offset_size = 0;
+      uint64_t curr_data_size = 0;
+      if (copy_state != nullptr) {
+        auto it = copy_state->find(name);
+        if (it != copy_state->end()) {
+          curr_offset_size = it->second.offset_size;
+          curr_data_size = it->second.data_size;
+        }
+      }
+
+      uint64_t* existing_offset_buffer = nullptr;
+      uint64_t* existing_offset_buffer_size = nullptr;
+      void* existing_buffer = nullptr;
+      uint64_t* existing_buffer_size = nullptr;
+      const bool var_size = schema->var_size(name);
+      if (var_size) {
+        RETURN_NOT_OK(query->get_buffer(
+            name.c_str(),
+            &existing_offset_buffer,
+            &existing_offset_buffer_size,
+            &existing_buffer,
+            &existing_buffer_size));
+      } else {
+        RETURN_NOT_OK(query->get_buffer(
+            name.c_str(), &existing_buffer, &existing_buffer_size));
+      }
+
+      if (existing_buffer_size == nullptr ||
+          (var_size && existing_offset_buffer_size == nullptr))
+        return LOG_STATUS(Status::SerializationError(
+            "Cannot get query buffer destinations; buffer '" + name +
+            "' not set."));
+
+      const uint64_t data_size_left = *existing_buffer_size - curr_data_size;
+      if (var_size) {
+        const uint64_t offset_size_left =
+            *existing_offset_buffer_size - curr_offset_size;
+        if (offset_size_left < fixedlen_size ||
+            data_size_left < varlen_size) {
+          destinations->clear();
+          *fit = false;
+          return Status::Ok();
+        }
+        destinations->emplace_back(
+            reinterpret_cast<char*>(existing_offset_buffer) + curr_offset_size,
+            fixedlen_size);
+        destinations->emplace_back(
+            static_cast<char*>(existing_buffer) + curr_data_size, varlen_size);
+      } else {
+        if (data_size_left < fixedlen_size) {
+          destinations->clear();
+          *fit = false;
+          return Status::Ok();
+        }
+        destinations->emplace_back(
+            static_cast<char*>(existing_buffer) + curr_data_size,
+            fixedlen_size);
+      }
+    }
+  } catch (kj::Exception& e) {
+    return LOG_STATUS(Status::SerializationError(
+        "Cannot get query buffer destinations; kj::Exception: " +
+        std::string(e.getDescription().cStr())));
+  } catch (std::exception& e) {
+    return LOG_STATUS(Status::SerializationError(
+        "Cannot get query buffer destinations; exception: " +
+        std::string(e.what())));
+  }
+
+  return Status::Ok();
+}
+
+Status query_deserialize_in_place(
+    const Buffer& serialized_message,
+    SerializationType serialize_type,
+    CopyState* copy_state,
+    Query* query) {
+  return query_deserialize_or_revert(
+      serialized_message, serialize_type, true, true, copy_state, query);
+}
+
 #else
 
 Status query_serialize(Query*, SerializationType, bool, BufferList*) {
@@ -934,6 +1127,28 @@ Status query_deserialize(
       "Cannot serialize; serialization not enabled."));
 }
 
+Status query_message_size(const void*, uint64_t, uint64_t*) {
+  return LOG_STATUS(Status::SerializationError(
+      "Cannot serialize; serialization not enabled."));
+}
+
+Status query_buffer_destinations(
+    const Buffer&,
+    SerializationType,
+    const CopyState*,
+    Query*,
+    std::vector<BufferDestination>*,
+    bool*) {
+  return LOG_STATUS(Status::SerializationError(
+      "Cannot serialize; serialization not enabled."));
+}
+
+Status query_deserialize_in_place(
+    const Buffer&, SerializationType, CopyState*, Query*) {
+  return LOG_STATUS(Status::SerializationError(
+      "Cannot serialize; serialization not enabled."));
+}
+
 #endif  // TILEDB_SERIALIZATION
 
 }  // namespace serialization
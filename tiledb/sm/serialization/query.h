@@ -34,6 +34,8 @@
 #define TILEDB_SERIALIZATION_QUERY_H
 
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "tiledb/sm/misc/status.h"
 
@@ -101,6 +103,12 @@ struct QueryBufferCopyState {
 using CopyState =
     std::unordered_map<std::string, serialization::QueryBufferCopyState>;
 
+/**
+ * A destination of attribute data in a user buffer, as a pointer and the
+ * number of bytes to copy there.
+ */
+using BufferDestination = std::pair<void*, uint64_t>;
+
 /**
  * Serialize a query
  *
@@ -135,6 +143,68 @@ Status query_deserialize(
     CopyState* copy_state,
     Query* query);
 
+/**
+ * Determines the size of the Cap'n Proto message at the start of a serialized
+ * query, which is followed by the concatenated attribute data. The size is
+ * read from the segment table of the message.
+ *
+ * If `nbytes` is too small to hold the segment table, `message_size` is set
+ * to a lower bound on the size that is greater than `nbytes`; the caller
+ * must then provide at least that many bytes and call this again. The
+ * message size is known once `message_size <= nbytes`.
+ *
+ * @param data The start of the serialized query.
+ * @param nbytes The number of bytes available at `data`.
+ * @param message_size Set to the message size (or its lower bound).
+ * @return Status
+ */
+Status query_message_size(
+    const void* data, uint64_t nbytes, uint64_t* message_size);
+
+/**
+ * Computes where the attribute data following a serialized read query go in
+ * the user buffers on the client side, in the order in which they are
+ * concatenated after the message. It allows the caller to copy the attribute
+ * data directly from the network into the user buffers, and then to
+ * deserialize only the message with `query_deserialize_in_place`.
+ *
+ * @param serialized_message Buffer containing only the serialized message
+ * @param serialize_type Serialization type of the serialized query
+ * @param copy_state Map of copy state per attribute (may be null)
+ * @param query Query that will be deserialized into
+ * @param destinations Set to the destinations of the attribute data. It is
+ *      empty for write queries, which have no attribute data in the response.
+ * @param fit Set to false (and `destinations` left empty) if the user
+ *      buffers are too small for the attribute data, true otherwise.
+ * @return Status
+ */
+Status query_buffer_destinations(
+    const Buffer& serialized_message,
+    SerializationType serialize_type,
+    const CopyState* copy_state,
+    Query* query,
+    std::vector<BufferDestination>* destinations,
+    bool* fit);
+
+/**
+ * Deserialize a query on the client side, like `query_deserialize`, when the
+ * attribute data have already been copied into the user buffers at the
+ * destinations returned by `query_buffer_destinations`. Only the message is
+ * deserialized; the buffer sizes (or the copy state) are updated as if the
+ * data had been copied.
+ *
+ * @param serialized_message Buffer containing only the serialized message
+ * @param serialize_type Serialization type of the serialized query
+ * @param copy_state Map of copy state per attribute (may be null)
+ * @param query Query to deserialize into
+ * @return Status
+ */
+Status query_deserialize_in_place(
+    const Buffer& serialized_message,
+    SerializationType serialize_type,
+    CopyState* copy_state,
+    Query* query);
+
 }  // namespace serialization
 }  // namespace sm
 }  // namespace tiledb
@@ -32,17 +32,25 @@
 
 #include "tiledb/sm/storage_manager/consolidator.h"
 #include "tiledb/sm/array_schema/array_schema.h"
+#include "tiledb/sm/buffer/buffer.h"
+#include "tiledb/sm/encryption/encryption_key.h"
 #include "tiledb/sm/enums/datatype.h"
 #include "tiledb/sm/enums/query_status.h"
 #include "tiledb/sm/enums/query_type.h"
 #include "tiledb/sm/filesystem/vfs.h"
 #include "tiledb/sm/fragment/fragment_info.h"
+#include "tiledb/sm/fragment/fragment_metadata.h"
 #include "tiledb/sm/misc/logger.h"
+#include "tiledb/sm/misc/parallel_functions.h"
+#include "tiledb/sm/misc/stats.h"
 #include "tiledb/sm/misc/utils.h"
 #include "tiledb/sm/misc/uuid.h"
 #include "tiledb/sm/query/query.h"
+#include "tiledb/sm/storage_manager/pyramid_builder.h"
 #include "tiledb/sm/storage_manager/storage_manager.h"
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <sstream>
 
@@ -55,6 +63,11 @@ namespace sm {
 
 Consolidator::Consolidator(StorageManager* storage_manager)
     : storage_manager_(storage_manager) {
+  stats_.fragment_num_before_ = 0;
+  stats_.fragment_num_after_ = 0;
+  stats_.overwritten_fragment_num_ = 0;
+  stats_.tiles_copied_ = 0;
+  stats_.ns_ = 0;
 }
 
 Consolidator::~Consolidator() = default;
@@ -69,6 +82,16 @@ Status Consolidator::consolidate(
     const void* encryption_key,
     uint32_t key_length,
     const Config* config) {
+  STATS_FUNC_IN(consolidator_consolidate);
+
+  auto start = std::chrono::steady_clock::now();
+  stats_.fragment_num_before_ = 0;
+  stats_.fragment_num_after_ = 0;
+  stats_.overwritten_fragment_num_ = 0;
+  stats_.tiles_copied_ = 0;
+  stats_.ns_ = 0;
+  stats_.steps_.clear();
+
   // Set config parameters
   RETURN_NOT_OK(set_config(config));
 
@@ -85,9 +108,33 @@ Status Consolidator::consolidate(
       consolidate(array_schema, encryption_type, encryption_key, key_length),
       delete array_schema);
 
+  // Rebuild the pyramid of dense arrays from the consolidated fragments
+  if (config_.pyramid_levels_ > 0 && array_schema->dense() &&
+      !config_.dry_run_) {
+    PyramidBuilder::Method method;
+    PyramidBuilder builder(
+        storage_manager_,
+        array_uri,
+        encryption_type,
+        encryption_key,
+        key_length,
+        config_.buffer_size_);
+    RETURN_NOT_OK_ELSE(
+        PyramidBuilder::method_from_str(config_.pyramid_method_, &method),
+        delete array_schema);
+    RETURN_NOT_OK_ELSE(
+        builder.build(config_.pyramid_levels_, method), delete array_schema);
+  }
+
   delete array_schema;
 
+  stats_.ns_ = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now() - start)
+                   .count();
+
   return Status::Ok();
+
+  STATS_FUNC_OUT(consolidator_consolidate);
 }
 
 Status Consolidator::consolidate_array_metadata(
@@ -136,6 +183,145 @@ Status Consolidator::consolidate_array_metadata(
   return Status::Ok();
 }
 
+Status Consolidator::consolidate_fragment_metadata(
+    const char* array_name,
+    EncryptionType encryption_type,
+    const void* encryption_key,
+    uint32_t key_length,
+    const Config* config) {
+  // Config not necessary yet
+  (void)config;
+
+  auto array_uri = URI(array_name);
+  EncryptionKey enc_key;
+  RETURN_NOT_OK(enc_key.set_key(encryption_type, encryption_key, key_length));
+
+  // Open array for reading
+  Array array_for_reads(array_uri, storage_manager_);
+  RETURN_NOT_OK(array_for_reads.open(
+      QueryType::READ, encryption_type, encryption_key, key_length));
+
+  // Serialize the entries of all fragments (see
+  // StorageManager::load_consolidated_fragment_metadata for the format)
+  auto fragment_metadata = array_for_reads.fragment_metadata();
+  uint64_t fragment_num = 0;
+  for (auto meta : fragment_metadata)
+    fragment_num += (meta->format_version() > 2);
+  Buffer buff, entry;
+  Status st = buff.write(&fragment_num, sizeof(uint64_t));
+  for (auto meta : fragment_metadata) {
+    if (!st.ok())
+      break;
+    if (meta->format_version() <= 2)
+      continue;
+    auto name = meta->fragment_uri().remove_trailing_slash().last_path_part();
+    uint64_t name_size = name.size();
+    entry.reset_size();
+    entry.reset_offset();
+    st = meta->write_consolidated(enc_key, &entry);
+    uint64_t entry_size = entry.size();
+    if (st.ok())
+      st = buff.write(&name_size, sizeof(uint64_t));
+    if (st.ok())
+      st = buff.write(name.data(), name_size);
+    if (st.ok())
+      st = buff.write(&entry_size, sizeof(uint64_t));
+    if (st.ok())
+      st = buff.write(entry.data(), entry_size);
+  }
+  RETURN_NOT_OK_ELSE(st, array_for_reads.close());
+  RETURN_NOT_OK(array_for_reads.close());
+
+  // Store the consolidated fragment metadata
+  return storage_manager_->store_consolidated_fragment_metadata(
+      array_uri, enc_key, &buff);
+}
+
+Status Consolidator::stitch(
+    const Array* array,
+    const URI& fragment_uri,
+    const std::vector<URI>& part_uris,
+    std::shared_ptr<FragmentMetadata>* new_fragment) {
+  RETURN_NOT_OK(set_config(nullptr));
+
+  switch (array->array_schema()->coords_type()) {
+    case Datatype::INT32:
+      return stitch<int>(array, fragment_uri, part_uris, new_fragment);
+    case Datatype::INT64:
+      return stitch<int64_t>(array, fragment_uri, part_uris, new_fragment);
+    case Datatype::INT8:
+      return stitch<int8_t>(array, fragment_uri, part_uris, new_fragment);
+    case Datatype::UINT8:
+      return stitch<uint8_t>(array, fragment_uri, part_uris, new_fragment);
+    case Datatype::INT16:
+      return stitch<int16_t>(array, fragment_uri, part_uris, new_fragment);
+    case Datatype::UINT16:
+      return stitch<uint16_t>(array, fragment_uri, part_uris, new_fragment);
+    case Datatype::UINT32:
+      return stitch<uint32_t>(array, fragment_uri, part_uris, new_fragment);
+    case Datatype::UINT64:
+      return stitch<uint64_t>(array, fragment_uri, part_uris, new_fragment);
+    case Datatype::FLOAT32:
+      return stitch<float>(array, fragment_uri, part_uris, new_fragment);
+    case Datatype::FLOAT64:
+      return stitch<double>(array, fragment_uri, part_uris, new_fragment);
+    case Datatype::DATETIME_YEAR:
+    case Datatype::DATETIME_MONTH:
+    case Datatype::DATETIME_WEEK:
+    case Datatype::DATETIME_DAY:
+    case Datatype::DATETIME_HR:
+    case Datatype::DATETIME_MIN:
+    case Datatype::DATETIME_SEC:
+    case Datatype::DATETIME_MS:
+    case Datatype::DATETIME_US:
+    case Datatype::DATETIME_NS:
+    case Datatype::DATETIME_PS:
+    case Datatype::DATETIME_FS:
+    case Datatype::DATETIME_AS:
+      return stitch<int64_t>(array, fragment_uri, part_uris, new_fragment);
+    default:
+      return LOG_STATUS(Status::ConsolidatorError(
+          "Cannot stitch fragment parts; Invalid domain type"));
+  }
+}
+
+const Consolidator::ConsolidationStats& Consolidator::stats() const {
+  return stats_;
+}
+
+void Consolidator::dump_stats(std::string* out) const {
+  uint64_t fragment_num = 0, bytes_read = 0, bytes_written = 0;
+  for (const auto& step : stats_.steps_) {
+    fragment_num += step.fragment_num_;
+    bytes_read += step.bytes_read_;
+    bytes_written += step.bytes_written_;
+  }
+
+  std::stringstream ss;
+  ss << "{\n";
+  ss << "  \"fragmentsBefore\": " << stats_.fragment_num_before_ << ",\n";
+  ss << "  \"fragmentsAfter\": " << stats_.fragment_num_after_ << ",\n";
+  ss << "  \"fragmentsOverwritten\": " << stats_.overwritten_fragment_num_
+     << ",\n";
+  ss << "  \"fragmentsConsolidated\": " << fragment_num << ",\n";
+  ss << "  \"bytesRead\": " << bytes_read << ",\n";
+  ss << "  \"bytesWritten\": " << bytes_written << ",\n";
+  ss << "  \"tilesCopied\": " << (uint64_t)stats_.tiles_copied_ << ",\n";
+  ss << "  \"ns\": " << stats_.ns_ << ",\n";
+  ss << "  \"steps\": [";
+  for (size_t i = 0; i < stats_.steps_.size(); ++i) {
+    const auto& step = stats_.steps_[i];
+    ss << ((i == 0) ? "\n" : ",\n");
+    ss << "    { \"fragments\": " << step.fragment_num_ << ", ";
+    ss << "\"bytesRead\": " << step.bytes_read_ << ", ";
+    ss << "\"bytesWritten\": " << step.bytes_written_ << ", ";
+    ss << "\"ns\": " << step.ns_ << " }";
+  }
+  ss << (stats_.steps_.empty() ? "]\n" : "\n  ]\n");
+  ss << "}";
+  *out = ss.str();
+}
+
 /* ****************************** */
 /*        STATIC FUNCTIONS        */
 /* ****************************** */
@@ -333,7 +519,26 @@ Status Consolidator::consolidate(
       array_schema, timestamp, enc_key, &fragment_info));
 
   // First make a pass and delete any entirely overwritten fragments
-  RETURN_NOT_OK(delete_overwritten_fragments<T>(array_schema, &fragment_info));
+  stats_.fragment_num_before_ = fragment_info.size();
+  RETURN_NOT_OK(
+      delete_overwritten_fragments<T>(array_schema, enc_key, &fragment_info));
+  stats_.overwritten_fragment_num_ =
+      stats_.fragment_num_before_ - fragment_info.size();
+  stats_.fragment_num_after_ = fragment_info.size();
+
+  // Get the subarray that limits the fragments to consolidate, if any
+  std::vector<T> subarray;
+  RETURN_NOT_OK(get_subarray<T>(array_schema, &subarray));
+
+  // Number of steps that run concurrently, each using two sets of buffers
+  uint64_t step_memory = 2 * buffer_num(array_schema, true);
+  step_memory *= std::max<uint64_t>(config_.buffer_size_, 1);
+  auto parallel_steps =
+      std::max<uint64_t>(config_.memory_budget_ / step_memory, 1);
+
+  // A dry run plans all the steps of a single round
+  if (config_.dry_run_)
+    parallel_steps = UINT64_MAX;
 
   uint32_t step = 0;
   do {
@@ -341,38 +546,109 @@ Status Consolidator::consolidate(
     if (fragment_info.size() <= 1)
       break;
 
-    // Find the next fragments to be consolidated
-    RETURN_NOT_OK(compute_next_to_consolidate<T>(
-        array_schema,
-        fragment_info,
-        &to_consolidate,
-        (T*)union_non_empty_domains.get()));
-
-    // Check if there is anything to consolidate
-    if (to_consolidate.size() <= 1)
+    // Find the next disjoint sets of fragments to be consolidated. Each
+    // selected set is replaced by a placeholder of the fragment it will be
+    // consolidated into, which is not selected again in this round
+    std::vector<std::vector<FragmentInfo>> to_consolidate_sets;
+    std::vector<std::vector<uint8_t>> unions;
+    auto round_fragment_info = fragment_info;
+    while (to_consolidate_sets.size() < parallel_steps &&
+           step + to_consolidate_sets.size() < config_.steps_) {
+      RETURN_NOT_OK(compute_next_to_consolidate<T>(
+          array_schema,
+          round_fragment_info,
+          subarray.empty() ? nullptr : &subarray[0],
+          &to_consolidate,
+          (T*)union_non_empty_domains.get()));
+
+      // Check if there is anything to consolidate
+      if (to_consolidate.size() <= 1)
+        break;
+
+      uint64_t size = 0;
+      for (const auto& f : to_consolidate)
+        size += f.fragment_size_;
+      auto union_begin = union_non_empty_domains.get();
+      unions.emplace_back(union_begin, union_begin + domain_size);
+      FragmentInfo placeholder(
+          URI(),
+          all_sparse(to_consolidate, 0, to_consolidate.size() - 1),
+          {to_consolidate.front().timestamp_range_.first,
+           to_consolidate.back().timestamp_range_.second},
+          size,
+          unions.back(),
+          unions.back());
+      update_fragment_info(to_consolidate, placeholder, &round_fragment_info);
+      to_consolidate_sets.emplace_back(std::move(to_consolidate));
+    }
+    if (to_consolidate_sets.empty())
       break;
 
-    // Consolidate the selected fragments
-    URI new_fragment_uri;
-    RETURN_NOT_OK(consolidate<T>(
-        array_uri,
-        to_consolidate,
-        (T*)union_non_empty_domains.get(),
-        encryption_type,
-        encryption_key,
-        key_length,
-        &new_fragment_uri));
-
-    // Get fragment info of the consolidated fragment
-    FragmentInfo new_fragment_info;
-    RETURN_NOT_OK(storage_manager_->get_fragment_info(
-        array_schema, enc_key, new_fragment_uri, &new_fragment_info));
+    if (config_.dry_run_) {
+      print_plan<T>(array_schema, to_consolidate_sets, unions);
+      return Status::Ok();
+    }
 
-    // Update fragment info
-    update_fragment_info(to_consolidate, new_fragment_info, &fragment_info);
+    // Consolidate the selected sets, all but the first in the background
+    auto set_num = to_consolidate_sets.size();
+    std::vector<URI> new_fragment_uris(set_num);
+    std::vector<StepStats> step_stats(set_num);
+    auto run_step = [&](size_t i) {
+      auto step_start = std::chrono::steady_clock::now();
+      auto st_step = consolidate<T>(
+          array_uri,
+          to_consolidate_sets[i],
+          (T*)&unions[i][0],
+          encryption_type,
+          encryption_key,
+          key_length,
+          &new_fragment_uris[i]);
+      step_stats[i].ns_ =
+          std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::steady_clock::now() - step_start)
+              .count();
+      return st_step;
+    };
+    std::vector<std::future<Status>> tasks;
+    for (size_t i = 1; i < set_num; ++i)
+      tasks.push_back(std::async(std::launch::async, run_step, i));
+    auto st = run_step(0);
+    for (auto& task : tasks) {
+      auto st_task = task.get();
+      if (st.ok())
+        st = st_task;
+    }
+    RETURN_NOT_OK(st);
+
+    for (size_t i = 0; i < set_num; ++i) {
+      // Get fragment info of the consolidated fragment
+      FragmentInfo new_fragment_info;
+      RETURN_NOT_OK(storage_manager_->get_fragment_info(
+          array_schema, enc_key, new_fragment_uris[i], &new_fragment_info));
+
+      // Record the step statistics
+      auto& step_stat = step_stats[i];
+      step_stat.fragment_num_ = to_consolidate_sets[i].size();
+      step_stat.bytes_read_ = 0;
+      for (const auto& f : to_consolidate_sets[i])
+        step_stat.bytes_read_ += f.fragment_size_;
+      step_stat.bytes_written_ = new_fragment_info.fragment_size_;
+      stats_.steps_.push_back(step_stat);
+      STATS_COUNTER_ADD(consolidator_num_steps, 1);
+      STATS_COUNTER_ADD(
+          consolidator_num_fragments_consolidated, step_stat.fragment_num_);
+      STATS_COUNTER_ADD(consolidator_num_bytes_read, step_stat.bytes_read_);
+      STATS_COUNTER_ADD(
+          consolidator_num_bytes_written, step_stat.bytes_written_);
+
+      // Update fragment info
+      update_fragment_info(
+          to_consolidate_sets[i], new_fragment_info, &fragment_info);
+    }
+    stats_.fragment_num_after_ = fragment_info.size();
 
     // Advance number of steps
-    ++step;
+    step += (uint32_t)set_num;
 
   } while (step < config_.steps_);
 
@@ -409,6 +685,63 @@ Status Consolidator::consolidate(
           QueryType::WRITE, encryption_type, encryption_key, key_length),
       array_for_reads.close());
 
+  // Fragments whose tiles can be concatenated are consolidated without
+  // decoding and re-encoding their cells. The tiles of co-located fragments
+  // are interleaved in a single file, so they are not concatenated.
+  if (config_.tile_copy_ &&
+      !array_for_reads.array_schema()->tile_colocation()) {
+    std::shared_ptr<FragmentMetadata> meta;
+    Status st = copy_tiles<T>(
+        &array_for_reads,
+        &array_for_writes,
+        union_non_empty_domains,
+        new_fragment_uri,
+        &meta);
+    if (!st.ok()) {
+      array_for_reads.close();
+      array_for_writes.close();
+      return st;
+    }
+    if (meta != nullptr) {
+      // Storing the fragment metadata locks the array exclusively unless
+      // the array manifest is enabled, which requires the array to be
+      // closed for reads
+      EncryptionKey enc_key;
+      st = array_for_reads.close();
+      if (st.ok())
+        st = enc_key.set_key(encryption_type, encryption_key, key_length);
+      if (st.ok())
+        st = meta->store(enc_key);
+      if (st.ok())
+        st = storage_manager_->update_array_manifest(
+            array_uri, enc_key, {*new_fragment_uri}, {});
+      auto st2 = array_for_writes.close();
+      if (st.ok())
+        st = st2;
+      if (!st.ok()) {
+        storage_manager_->vfs()->remove_dir(*new_fragment_uri);
+        return st;
+      }
+
+      std::vector<URI> to_delete;
+      for (const auto& f : to_consolidate)
+        to_delete.emplace_back(f.uri_);
+
+      // Leave the old fragments to a later vacuum
+      if (config_.deferred_vacuum_)
+        return write_vacuum_file(
+            array_uri, enc_key, *new_fragment_uri, to_delete);
+
+      // Delete old fragment metadata. This makes the old fragments invisible
+      st = delete_fragment_metadata(array_uri, enc_key, to_delete);
+
+      // Delete old fragments. The array does not need to be locked.
+      st2 = delete_fragments(to_delete);
+
+      return !st.ok() ? st : st2;
+    }
+  }
+
   // Get schema
   auto array_schema = array_for_reads.array_schema();
 
@@ -453,7 +786,8 @@ Status Consolidator::consolidate(
   }
 
   // Read from one array and write to the other
-  st = copy_array(query_r, query_w);
+  st = copy_array(
+      query_r, query_w, all_sparse, buffers, buffer_sizes, buffer_num);
   if (!st.ok()) {
     array_for_reads.close();
     array_for_writes.close();
@@ -500,7 +834,16 @@ Status Consolidator::consolidate(
     to_delete.emplace_back(f.uri_);
 
   // Delete old fragment metadata. This makes the old fragments invisible
-  st = delete_fragment_metadata(array_uri, to_delete);
+  EncryptionKey enc_key;
+  st = enc_key.set_key(encryption_type, encryption_key, key_length);
+  if (st.ok() && config_.deferred_vacuum_) {
+    // Leave the old fragments to a later vacuum
+    st = write_vacuum_file(array_uri, enc_key, *new_fragment_uri, to_delete);
+    clean_up(buffer_num, buffers, buffer_sizes, query_r, query_w);
+    return st;
+  }
+  if (st.ok())
+    st = delete_fragment_metadata(array_uri, enc_key, to_delete);
   if (!st.ok()) {
     delete_fragments(to_delete);
     clean_up(buffer_num, buffers, buffer_sizes, query_r, query_w);
@@ -516,11 +859,722 @@ Status Consolidator::consolidate(
   return st;
 }
 
-Status Consolidator::copy_array(Query* query_r, Query* query_w) {
-  do {
+Status Consolidator::copy_array(
+    Query* query_r,
+    Query* query_w,
+    bool sparse_mode,
+    void** buffers,
+    uint64_t* buffer_sizes,
+    unsigned buffer_num) {
+  auto read = [query_r]() {
     RETURN_NOT_OK(query_r->submit());
-    RETURN_NOT_OK(query_w->submit());
-  } while (query_r->status() == QueryStatus::INCOMPLETE);
+
+    // The read makes no progress if the cells of a partition that cannot
+    // be split further do not fit in the buffers
+    if (query_r->status() == QueryStatus::INCOMPLETE &&
+        !query_r->has_results())
+      return LOG_STATUS(Status::ConsolidatorError(
+          "Cannot consolidate; The consolidation buffers cannot hold the "
+          "cells of an unsplittable partition, increase "
+          "sm.consolidation.buffer_size"));
+
+    return Status::Ok();
+  };
+
+  // Nothing else to do if everything fits in the buffers at once
+  RETURN_NOT_OK(read());
+  if (query_r->status() != QueryStatus::INCOMPLETE)
+    return query_w->submit();
+
+  // Otherwise read each chunk into one set of buffers while the previous
+  // chunk is written from the other
+  void** buffers_2 = nullptr;
+  uint64_t* buffer_sizes_2 = nullptr;
+  unsigned buffer_num_2 = 0;
+  RETURN_NOT_OK(create_buffers(
+      query_r->array_schema(),
+      sparse_mode,
+      &buffers_2,
+      &buffer_sizes_2,
+      &buffer_num_2));
+  void** buffer_sets[2] = {buffers, buffers_2};
+  uint64_t* buffer_size_sets[2] = {buffer_sizes, buffer_sizes_2};
+
+  Status st;
+  unsigned cur = 0;
+  do {
+    st = set_query_buffers(
+        query_w, sparse_mode, buffer_sets[cur], buffer_size_sets[cur]);
+    if (!st.ok())
+      break;
+    auto write_task = std::async(
+        std::launch::async, [query_w]() { return query_w->submit(); });
+
+    auto next = 1 - cur;
+    for (unsigned i = 0; i < buffer_num; ++i)
+      buffer_size_sets[next][i] = config_.buffer_size_;
+    st = set_query_buffers(
+        query_r, sparse_mode, buffer_sets[next], buffer_size_sets[next]);
+    if (st.ok())
+      st = read();
+
+    auto st_w = write_task.get();
+    if (st.ok())
+      st = st_w;
+    cur = next;
+  } while (st.ok() && query_r->status() == QueryStatus::INCOMPLETE);
+
+  // Write the last chunk
+  if (st.ok())
+    st = set_query_buffers(
+        query_w, sparse_mode, buffer_sets[cur], buffer_size_sets[cur]);
+  if (st.ok())
+    st = query_w->submit();
+
+  // The queries must not point to the freed buffers
+  set_query_buffers(query_r, sparse_mode, buffers, buffer_sizes);
+  set_query_buffers(query_w, sparse_mode, buffers, buffer_sizes);
+  free_buffers(buffer_num_2, buffers_2, buffer_sizes_2);
+
+  return st;
+}
+
+template <class T>
+Status Consolidator::copy_tiles(
+    Array* array_for_reads,
+    Array* array_for_writes,
+    T* union_non_empty_domains,
+    URI* new_fragment_uri,
+    std::shared_ptr<FragmentMetadata>* new_fragment) {
+  new_fragment->reset();
+  auto array_schema = array_for_reads->array_schema();
+  const auto& encryption_key = array_for_reads->get_encryption_key();
+  auto fragments = array_for_reads->fragment_metadata();
+  assert(!fragments.empty());
+
+  // The fragment metadata are sorted on timestamp
+  auto first = fragments.front()->fragment_uri();
+  auto last = fragments.back()->fragment_uri();
+  if (!tile_copy_order<T>(array_schema, &fragments))
+    return copy_untouched_tiles<T>(
+        array_for_reads,
+        array_for_writes,
+        union_non_empty_domains,
+        new_fragment_uri,
+        new_fragment);
+
+  RETURN_NOT_OK(compute_new_fragment_uri(first, last, new_fragment_uri));
+  RETURN_NOT_OK(concat_fragments(
+      array_schema,
+      array_for_writes->array_schema(),
+      encryption_key,
+      fragments,
+      union_non_empty_domains,
+      *new_fragment_uri,
+      new_fragment));
+  if (*new_fragment == nullptr)
+    return Status::Ok();
+
+  uint64_t tile_num = (*new_fragment)->tile_num();
+  stats_.tiles_copied_ += tile_num;
+  STATS_COUNTER_ADD(consolidator_num_tiles_copied, tile_num);
+
+  return Status::Ok();
+}
+
+template <class T>
+Status Consolidator::stitch(
+    const Array* array,
+    const URI& fragment_uri,
+    const std::vector<URI>& part_uris,
+    std::shared_ptr<FragmentMetadata>* new_fragment) {
+  new_fragment->reset();
+  auto array_schema = array->array_schema();
+  const auto& encryption_key = array->get_encryption_key();
+  auto vfs = storage_manager_->vfs();
+
+  // Load the metadata of the parts, skipping those that were never written
+  // or have no cells
+  std::vector<std::shared_ptr<FragmentMetadata>> parts;
+  std::vector<FragmentMetadata*> fragments;
+  for (const auto& uri : part_uris) {
+    bool is_file = false;
+    RETURN_NOT_OK(vfs->is_file(
+        uri.join_path(constants::fragment_metadata_filename), &is_file));
+    if (!is_file)
+      continue;
+    auto meta = std::make_shared<FragmentMetadata>(
+        storage_manager_,
+        array_schema,
+        uri,
+        std::pair<uint64_t, uint64_t>(0, 0),
+        array_schema->dense());
+    RETURN_NOT_OK(meta->load(encryption_key));
+    if (meta->tile_num() == 0)
+      continue;
+    parts.push_back(meta);
+    fragments.push_back(meta.get());
+  }
+  if (fragments.empty())
+    return Status::Ok();
+
+  if (!tile_copy_order<T>(array_schema, &fragments))
+    return LOG_STATUS(Status::ConsolidatorError(
+        "Cannot stitch fragment parts; The parts must follow each other in "
+        "the global order and only the last tile of the last part may be "
+        "partially full, on an array without the Hilbert order or "
+        "coordinate bloom filters"));
+
+  auto dim_num = array_schema->dim_num();
+  auto first = (const T*)fragments.front()->non_empty_domain();
+  std::vector<T> union_non_empty_domains(first, first + 2 * dim_num);
+  for (auto f : fragments) {
+    auto non_empty_domain = (const T*)f->non_empty_domain();
+    for (unsigned d = 0; d < dim_num; ++d) {
+      union_non_empty_domains[2 * d] =
+          std::min(union_non_empty_domains[2 * d], non_empty_domain[2 * d]);
+      union_non_empty_domains[2 * d + 1] = std::max(
+          union_non_empty_domains[2 * d + 1], non_empty_domain[2 * d + 1]);
+    }
+  }
+
+  RETURN_NOT_OK(concat_fragments(
+      array_schema,
+      array_schema,
+      encryption_key,
+      fragments,
+      &union_non_empty_domains[0],
+      fragment_uri,
+      new_fragment));
+  if (*new_fragment == nullptr)
+    return LOG_STATUS(Status::ConsolidatorError(
+        "Cannot stitch fragment parts; The dense parts must cover whole "
+        "space tiles"));
+
+  return Status::Ok();
+}
+
+Status Consolidator::concat_fragments(
+    const ArraySchema* array_schema,
+    const ArraySchema* new_array_schema,
+    const EncryptionKey& encryption_key,
+    const std::vector<FragmentMetadata*>& fragments,
+    const void* union_non_empty_domains,
+    const URI& new_fragment_uri,
+    std::shared_ptr<FragmentMetadata>* new_fragment) {
+  new_fragment->reset();
+
+  // The sketches of the new fragment are the merge of those of the copied
+  // fragments, so it gets sketches only if all of them have them
+  bool sketches = config_.fragment_sketches_;
+  for (auto f : fragments) {
+    for (const auto& attr : array_schema->attributes()) {
+      if (!sketches || !f->has_tile_min_max_sum(attr->name()))
+        continue;
+      const HyperLogLog* hll = nullptr;
+      const KllSketch* kll = nullptr;
+      RETURN_NOT_OK(
+          f->get_sketches(encryption_key, attr->name(), &hll, &kll));
+      sketches = hll != nullptr;
+    }
+  }
+
+  // Likewise, it indexes the values of the attributes indexed by all of
+  // the copied fragments
+  std::vector<std::string> value_index_attributes;
+  for (const auto& attr : array_schema->attributes()) {
+    const ValueIndex* index = nullptr;
+    for (auto f : fragments) {
+      RETURN_NOT_OK(f->get_value_index(encryption_key, attr->name(), &index));
+      if (index == nullptr)
+        break;
+    }
+    if (index != nullptr)
+      value_index_attributes.push_back(attr->name());
+  }
+
+  // Create the new fragment, on the schema of the array for writes which
+  // stays open until the fragment metadata is stored
+  bool dense = fragments.front()->dense();
+  auto timestamp_range = std::pair<uint64_t, uint64_t>(0, 0);
+  auto meta = std::make_shared<FragmentMetadata>(
+      storage_manager_,
+      new_array_schema,
+      new_fragment_uri,
+      timestamp_range,
+      dense);
+  if (!dense)
+    meta->set_rtree_str_packing(config_.rtree_str_packing_);
+  meta->set_sketches(sketches);
+  meta->set_value_index_attributes(value_index_attributes);
+  meta->set_unfiltered(config_.fragment_metadata_unfiltered_);
+  RETURN_NOT_OK(meta->init(
+      dense ? union_non_empty_domains : array_schema->domain()->domain()));
+
+  uint64_t tile_num = 0;
+  for (auto f : fragments)
+    tile_num += f->tile_num();
+  if (dense && tile_num != meta->tile_num())
+    return Status::Ok();
+  RETURN_NOT_OK(meta->set_num_tiles(tile_num));
+  RETURN_NOT_OK(storage_manager_->create_dir(new_fragment_uri));
+
+  // Append the tiles of the fragments in order
+  uint64_t tile_index_base = 0;
+  for (auto f : fragments) {
+    meta->set_tile_index_base(tile_index_base);
+    RETURN_NOT_OK_ELSE(
+        copy_fragment_tiles(array_schema, encryption_key, f, meta.get()),
+        storage_manager_->vfs()->remove_dir(new_fragment_uri));
+    tile_index_base += f->tile_num();
+  }
+  if (!dense)
+    meta->set_last_tile_cell_num(fragments.back()->last_tile_cell_num());
+
+  // The files are closed only once all the fragments are appended, as
+  // closing an object store file completes it
+  std::vector<std::string> names;
+  for (const auto& attr : array_schema->attributes())
+    names.emplace_back(attr->name());
+  if (!dense) {
+    for (unsigned d = 0; d < array_schema->dim_num(); ++d)
+      names.emplace_back(array_schema->dimension(d)->name());
+  }
+  auto statuses = parallel_for(0, names.size(), [&](uint64_t i) {
+    RETURN_NOT_OK(storage_manager_->close_file(meta->uri(names[i])));
+    if (array_schema->var_size(names[i]))
+      RETURN_NOT_OK(storage_manager_->close_file(meta->var_uri(names[i])));
+    return Status::Ok();
+  });
+  for (auto& st : statuses)
+    RETURN_NOT_OK_ELSE(
+        st, storage_manager_->vfs()->remove_dir(new_fragment_uri));
+
+  *new_fragment = meta;
+
+  return Status::Ok();
+}
+
+Status Consolidator::copy_fragment_tiles(
+    const ArraySchema* array_schema,
+    const EncryptionKey& encryption_key,
+    FragmentMetadata* src,
+    FragmentMetadata* dst) {
+  auto tile_num = src->tile_num();
+  std::vector<std::string> names;
+  for (const auto& attr : array_schema->attributes())
+    names.emplace_back(attr->name());
+  if (!src->dense()) {
+    for (unsigned d = 0; d < array_schema->dim_num(); ++d)
+      names.emplace_back(array_schema->dimension(d)->name());
+  }
+
+  // Copy the files and the tile metadata of each attribute/dimension
+  auto statuses = parallel_for(0, names.size(), [&](uint64_t i) {
+    const auto& name = names[i];
+    auto var_size = array_schema->var_size(name);
+    if (src->packed()) {
+      // Copy the ranges of the packed file the tiles are stored in
+      uint64_t offset = 0, size = 0;
+      src->packed_range(name, false, &offset, &size);
+      RETURN_NOT_OK(
+          copy_file_range(src->packed_uri(), offset, size, dst->uri(name)));
+      if (var_size) {
+        src->packed_range(name, true, &offset, &size);
+        RETURN_NOT_OK(copy_file_range(
+            src->packed_uri(), offset, size, dst->var_uri(name)));
+      }
+    } else {
+      RETURN_NOT_OK(copy_file(src->uri(name), dst->uri(name)));
+      if (var_size)
+        RETURN_NOT_OK(copy_file(src->var_uri(name), dst->var_uri(name)));
+    }
+
+    uint64_t size = 0;
+    for (uint64_t t = 0; t < tile_num; ++t) {
+      RETURN_NOT_OK(src->persisted_tile_size(encryption_key, name, t, &size));
+      dst->set_tile_offset(name, t, size);
+      if (var_size) {
+        RETURN_NOT_OK(
+            src->persisted_tile_var_size(encryption_key, name, t, &size));
+        dst->set_tile_var_offset(name, t, size);
+        RETURN_NOT_OK(src->tile_var_size(encryption_key, name, t, &size));
+        dst->set_tile_var_size(name, t, size);
+      }
+    }
+
+    if (dst->has_tile_min_max_sum(name)) {
+      const void *min, *max, *sum;
+      for (uint64_t t = 0; t < tile_num; ++t) {
+        RETURN_NOT_OK(src->get_tile_min_max_sum(
+            encryption_key, name, t, &min, &max, &sum));
+        if (min != nullptr)
+          dst->set_tile_min_max_sum(name, t, min, max, sum);
+      }
+    }
+
+    if (dst->has_sketches(name)) {
+      const HyperLogLog* hll = nullptr;
+      const KllSketch* kll = nullptr;
+      RETURN_NOT_OK(src->get_sketches(encryption_key, name, &hll, &kll));
+      if (hll != nullptr)
+        dst->add_sketches(name, *hll, *kll);
+    }
+
+    if (dst->has_value_index(name)) {
+      const ValueIndex* index = nullptr;
+      RETURN_NOT_OK(src->get_value_index(encryption_key, name, &index));
+      if (index != nullptr)
+        dst->add_value_index(name, *index);
+    }
+
+    return Status::Ok();
+  });
+  for (auto& st : statuses)
+    RETURN_NOT_OK(st);
+
+  // Copy the MBRs, which also expands the non-empty domain
+  if (!src->dense()) {
+    RETURN_NOT_OK(src->load_rtree(encryption_key));
+    std::vector<uint8_t> mbr(2 * array_schema->coords_size());
+    for (uint64_t t = 0; t < tile_num; ++t) {
+      src->mbr(t, &mbr[0]);
+      RETURN_NOT_OK(dst->set_mbr(t, &mbr[0]));
+    }
+  }
+
+  return Status::Ok();
+}
+
+template <class T>
+Status Consolidator::copy_untouched_tiles(
+    Array* array_for_reads,
+    Array* array_for_writes,
+    T* union_non_empty_domains,
+    URI* new_fragment_uri,
+    std::shared_ptr<FragmentMetadata>* new_fragment) {
+  new_fragment->reset();
+  auto array_schema = array_for_reads->array_schema();
+  const auto& encryption_key = array_for_reads->get_encryption_key();
+  auto fragments = array_for_reads->fragment_metadata();
+  for (auto f : fragments) {
+    if (!f->dense() || f->format_version() != constants::format_version)
+      return Status::Ok();
+  }
+
+  auto meta = std::make_shared<FragmentMetadata>(
+      storage_manager_,
+      array_for_writes->array_schema(),
+      URI(),
+      std::pair<uint64_t, uint64_t>(0, 0),
+      true);
+  RETURN_NOT_OK(meta->init(union_non_empty_domains));
+  auto tile_num = meta->tile_num();
+
+  // Tile coordinates are counted from the start of the array domain, and
+  // tile positions follow the tile order within an expanded domain
+  auto domain = array_schema->domain();
+  auto dim_num = array_schema->dim_num();
+  auto dom = (const T*)domain->domain();
+  auto ext = (const T*)domain->tile_extents();
+  bool row_major = array_schema->tile_order() != Layout::COL_MAJOR;
+  auto first_tile = [&](const T* d, unsigned i) {
+    return (uint64_t)((d[2 * i] - dom[2 * i]) / ext[i]);
+  };
+  auto tiles_along = [&](const T* d, unsigned i) {
+    return (uint64_t)((d[2 * i + 1] - d[2 * i]) / ext[i]) + 1;
+  };
+  auto contains = [&](const T* d, const std::vector<uint64_t>& coords) {
+    for (unsigned i = 0; i < dim_num; ++i) {
+      auto first = first_tile(d, i);
+      if (coords[i] < first || coords[i] >= first + tiles_along(d, i))
+        return false;
+    }
+    return true;
+  };
+  auto tile_pos = [&](const T* d, const std::vector<uint64_t>& coords) {
+    uint64_t pos = 0;
+    for (unsigned k = 0; k < dim_num; ++k) {
+      auto i = row_major ? k : dim_num - 1 - k;
+      pos = pos * tiles_along(d, i) + coords[i] - first_tile(d, i);
+    }
+    return pos;
+  };
+
+  // Find the single fragment covering each tile of the new fragment. The
+  // other tiles are rewritten, with subarrays cropped to the array domain
+  auto new_dom = (const T*)meta->domain();
+  std::vector<FragmentMetadata*> src(tile_num, nullptr);
+  std::vector<uint64_t> src_tile(tile_num, 0);
+  std::vector<T> rewrite_subarrays;
+  std::vector<uint64_t> coords(dim_num);
+  for (unsigned i = 0; i < dim_num; ++i)
+    coords[i] = first_tile(new_dom, i);
+  for (uint64_t t = 0; t < tile_num; ++t) {
+    unsigned covering = 0;
+    for (auto f : fragments) {
+      auto f_dom = (const T*)f->domain();
+      if (contains(f_dom, coords)) {
+        src[t] = f;
+        src_tile[t] = tile_pos(f_dom, coords);
+        ++covering;
+      }
+    }
+    if (covering != 1) {
+      src[t] = nullptr;
+      for (unsigned i = 0; i < dim_num; ++i) {
+        T lo = dom[2 * i] + (T)coords[i] * ext[i];
+        T hi = std::min<T>(lo + ext[i] - 1, dom[2 * i + 1]);
+        rewrite_subarrays.push_back(lo);
+        rewrite_subarrays.push_back(hi);
+      }
+    }
+
+    // Advance to the next tile along the tile order
+    for (unsigned k = dim_num; k-- > 0;) {
+      auto i = row_major ? k : dim_num - 1 - k;
+      if (++coords[i] < first_tile(new_dom, i) + tiles_along(new_dom, i))
+        break;
+      coords[i] = first_tile(new_dom, i);
+    }
+  }
+  uint64_t rewrite_num = rewrite_subarrays.size() / (2 * dim_num);
+  if (2 * rewrite_num > tile_num)
+    return Status::Ok();
+
+  // Write the rewritten tiles into a scratch array, which is ignored as a
+  // fragment since its name starts with a dot
+  std::string uuid;
+  RETURN_NOT_OK(uuid::generate_uuid(&uuid, false));
+  auto array_uri = array_for_reads->array_uri();
+  auto scratch_uri = array_uri.join_path(".consolidation_" + uuid);
+  ArraySchema scratch_schema(array_for_writes->array_schema());
+  RETURN_NOT_OK(storage_manager_->array_create(
+      scratch_uri, &scratch_schema, encryption_key));
+  auto enc_type = encryption_key.encryption_type();
+  auto enc_key = encryption_key.key();
+  Array scratch(scratch_uri, storage_manager_);
+  auto clean_up_scratch = [&]() {
+    scratch.close();
+    storage_manager_->vfs()->remove_dir(scratch_uri);
+  };
+  RETURN_NOT_OK_ELSE(
+      scratch.open(
+          QueryType::WRITE,
+          enc_type,
+          enc_key.data(),
+          (uint32_t)enc_key.size()),
+      storage_manager_->vfs()->remove_dir(scratch_uri));
+
+  void** buffers;
+  uint64_t* buffer_sizes;
+  unsigned buffer_num;
+  RETURN_NOT_OK_ELSE(
+      create_buffers(
+          array_schema, false, &buffers, &buffer_sizes, &buffer_num),
+      clean_up_scratch());
+  Status st;
+  for (uint64_t r = 0; r < rewrite_num && st.ok(); ++r) {
+    st = rewrite_tile(
+        array_for_reads,
+        &scratch,
+        &rewrite_subarrays[2 * dim_num * r],
+        buffers,
+        buffer_sizes,
+        buffer_num);
+  }
+  free_buffers(buffer_num, buffers, buffer_sizes);
+  if (st.ok())
+    st = scratch.close();
+  if (st.ok())
+    st = scratch.open(
+        QueryType::READ, enc_type, enc_key.data(), (uint32_t)enc_key.size());
+  if (!st.ok()) {
+    clean_up_scratch();
+    return st;
+  }
+
+  // Each scratch fragment holds exactly one rewritten tile
+  auto scratch_fragments = scratch.fragment_metadata();
+  if (scratch_fragments.size() != rewrite_num) {
+    clean_up_scratch();
+    return LOG_STATUS(Status::ConsolidatorError(
+        "Cannot consolidate; Unexpected number of rewritten tiles"));
+  }
+  for (auto f : scratch_fragments) {
+    auto f_dom = (const T*)f->domain();
+    for (unsigned i = 0; i < dim_num; ++i)
+      coords[i] = first_tile(f_dom, i);
+    auto t = tile_pos(new_dom, coords);
+    src[t] = f;
+    src_tile[t] = 0;
+  }
+
+  // Create the new fragment and append its tiles in order
+  RETURN_NOT_OK_ELSE(
+      compute_new_fragment_uri(
+          fragments.front()->fragment_uri(),
+          fragments.back()->fragment_uri(),
+          new_fragment_uri),
+      clean_up_scratch());
+  meta = std::make_shared<FragmentMetadata>(
+      storage_manager_,
+      array_for_writes->array_schema(),
+      *new_fragment_uri,
+      std::pair<uint64_t, uint64_t>(0, 0),
+      true);
+  // No sketches or value indexes are stored, as those of the source
+  // fragments also cover their overwritten cells that are not copied
+  meta->set_unfiltered(config_.fragment_metadata_unfiltered_);
+  st = meta->init(union_non_empty_domains);
+  if (st.ok())
+    st = meta->set_num_tiles(tile_num);
+  if (st.ok())
+    st = storage_manager_->create_dir(*new_fragment_uri);
+  if (!st.ok()) {
+    clean_up_scratch();
+    return st;
+  }
+
+  auto statuses =
+      parallel_for(0, array_schema->attribute_num(), [&](uint64_t i) {
+        const auto& name = array_schema->attributes()[i]->name();
+        auto var_size = array_schema->var_size(name);
+        Buffer buff;
+        for (uint64_t t = 0; t < tile_num; ++t) {
+          RETURN_NOT_OK(copy_tile(
+              encryption_key,
+              name,
+              var_size,
+              src[t],
+              src_tile[t],
+              meta.get(),
+              t,
+              &buff));
+        }
+        RETURN_NOT_OK(storage_manager_->close_file(meta->uri(name)));
+        if (var_size)
+          RETURN_NOT_OK(storage_manager_->close_file(meta->var_uri(name)));
+        return Status::Ok();
+      });
+  for (auto& st_attr : statuses) {
+    if (st.ok())
+      st = st_attr;
+  }
+  clean_up_scratch();
+  if (!st.ok()) {
+    storage_manager_->vfs()->remove_dir(*new_fragment_uri);
+    return st;
+  }
+
+  stats_.tiles_copied_ += tile_num - rewrite_num;
+  STATS_COUNTER_ADD(consolidator_num_tiles_copied, tile_num - rewrite_num);
+
+  *new_fragment = meta;
+
+  return Status::Ok();
+}
+
+Status Consolidator::copy_tile(
+    const EncryptionKey& encryption_key,
+    const std::string& name,
+    bool var_size,
+    FragmentMetadata* src,
+    uint64_t src_tile,
+    FragmentMetadata* dst,
+    uint64_t dst_tile,
+    Buffer* buff) const {
+  uint64_t offset = 0, size = 0;
+  RETURN_NOT_OK(src->file_offset(encryption_key, name, src_tile, &offset));
+  RETURN_NOT_OK(
+      src->persisted_tile_size(encryption_key, name, src_tile, &size));
+  RETURN_NOT_OK(storage_manager_->read(src->uri(name), offset, buff, size));
+  RETURN_NOT_OK(storage_manager_->write(dst->uri(name), buff));
+  dst->set_tile_offset(name, dst_tile, size);
+
+  if (var_size) {
+    RETURN_NOT_OK(
+        src->file_var_offset(encryption_key, name, src_tile, &offset));
+    RETURN_NOT_OK(
+        src->persisted_tile_var_size(encryption_key, name, src_tile, &size));
+    RETURN_NOT_OK(
+        storage_manager_->read(src->var_uri(name), offset, buff, size));
+    RETURN_NOT_OK(storage_manager_->write(dst->var_uri(name), buff));
+    dst->set_tile_var_offset(name, dst_tile, size);
+    RETURN_NOT_OK(src->tile_var_size(encryption_key, name, src_tile, &size));
+    dst->set_tile_var_size(name, dst_tile, size);
+  }
+
+  if (dst->has_tile_min_max_sum(name)) {
+    const void *min, *max, *sum;
+    RETURN_NOT_OK(src->get_tile_min_max_sum(
+        encryption_key, name, src_tile, &min, &max, &sum));
+    if (min != nullptr)
+      dst->set_tile_min_max_sum(name, dst_tile, min, max, sum);
+  }
+
+  return Status::Ok();
+}
+
+Status Consolidator::rewrite_tile(
+    Array* array_for_reads,
+    Array* scratch,
+    void* subarray,
+    void** buffers,
+    uint64_t* buffer_sizes,
+    unsigned buffer_num) {
+  for (unsigned i = 0; i < buffer_num; ++i)
+    buffer_sizes[i] = config_.buffer_size_;
+
+  auto query_r = new Query(storage_manager_, array_for_reads);
+  auto query_w = new Query(storage_manager_, scratch);
+  Status st = query_r->set_layout(Layout::GLOBAL_ORDER);
+  if (st.ok())
+    st = set_query_buffers(query_r, false, buffers, buffer_sizes);
+  if (st.ok())
+    st = query_r->set_subarray(subarray, true);
+  if (st.ok())
+    st = query_w->set_layout(Layout::GLOBAL_ORDER);
+  if (st.ok())
+    st = query_w->set_subarray(subarray, true);
+  if (st.ok())
+    st = set_query_buffers(query_w, false, buffers, buffer_sizes);
+  if (st.ok())
+    st = copy_array(
+        query_r, query_w, false, buffers, buffer_sizes, buffer_num);
+  if (st.ok())
+    st = query_w->finalize();
+
+  delete query_r;
+  delete query_w;
+
+  return st;
+}
+
+Status Consolidator::copy_file(const URI& src, const URI& dst) const {
+  auto vfs = storage_manager_->vfs();
+  bool is_file = false;
+  RETURN_NOT_OK(vfs->is_file(src, &is_file));
+  if (!is_file)
+    return Status::Ok();
+
+  uint64_t file_size = 0;
+  RETURN_NOT_OK(vfs->file_size(src, &file_size));
+  return copy_file_range(src, 0, file_size, dst);
+}
+
+Status Consolidator::copy_file_range(
+    const URI& src, uint64_t offset, uint64_t size, const URI& dst) const {
+  if (size == 0)
+    return Status::Ok();
+
+  auto chunk_size = std::max<uint64_t>(config_.buffer_size_, 1);
+  Buffer buff;
+  for (uint64_t pos = 0; pos < size; pos += chunk_size) {
+    auto nbytes = std::min(chunk_size, size - pos);
+    RETURN_NOT_OK(storage_manager_->read(src, offset + pos, &buff, nbytes));
+    RETURN_NOT_OK(storage_manager_->write(dst, &buff));
+  }
 
   return Status::Ok();
 }
@@ -536,21 +1590,27 @@ void Consolidator::clean_up(
   delete query_w;
 }
 
+unsigned Consolidator::buffer_num(
+    const ArraySchema* array_schema, bool sparse_mode) const {
+  auto attribute_num = array_schema->attribute_num();
+  auto sparse = !array_schema->dense() || sparse_mode;
+
+  unsigned buffer_num = 0;
+  for (unsigned int i = 0; i < attribute_num; ++i)
+    buffer_num += (array_schema->attributes()[i]->var_size()) ? 2 : 1;
+  buffer_num += (sparse) ? 1 : 0;
+
+  return buffer_num;
+}
+
 Status Consolidator::create_buffers(
     const ArraySchema* array_schema,
     bool sparse_mode,
     void*** buffers,
     uint64_t** buffer_sizes,
     unsigned int* buffer_num) {
-  // For easy reference
-  auto attribute_num = array_schema->attribute_num();
-  auto sparse = !array_schema->dense() || sparse_mode;
-
   // Calculate number of buffers
-  *buffer_num = 0;
-  for (unsigned int i = 0; i < attribute_num; ++i)
-    *buffer_num += (array_schema->attributes()[i]->var_size()) ? 2 : 1;
-  *buffer_num += (sparse) ? 1 : 0;
+  *buffer_num = this->buffer_num(array_schema, sparse_mode);
 
   // Create buffers
   *buffers = (void**)std::malloc(*buffer_num * sizeof(void*));
@@ -621,12 +1681,21 @@ Status Consolidator::create_queries(
 }
 
 Status Consolidator::delete_fragment_metadata(
-    const URI& array_uri, const std::vector<URI>& fragments) {
+    const URI& array_uri,
+    const EncryptionKey& encryption_key,
+    const std::vector<URI>& fragments) {
+  // Readers that open the array after the fragments leave the manifest do
+  // not see them, so this does not wait for the readers that have them open
+  RETURN_NOT_OK(storage_manager_->update_array_manifest(
+      array_uri, encryption_key, {}, fragments));
+
   RETURN_NOT_OK(storage_manager_->array_xlock(array_uri));
 
   for (auto& uri : fragments) {
     auto meta_uri = uri.join_path(constants::fragment_metadata_filename);
-    RETURN_NOT_OK(storage_manager_->vfs()->remove_file(meta_uri));
+    RETURN_NOT_OK_ELSE(
+        storage_manager_->vfs()->remove_file(meta_uri),
+        storage_manager_->array_xunlock(array_uri));
   }
 
   RETURN_NOT_OK(storage_manager_->array_xunlock(array_uri));
@@ -635,15 +1704,85 @@ Status Consolidator::delete_fragment_metadata(
 }
 
 Status Consolidator::delete_fragments(const std::vector<URI>& fragments) {
-  for (auto& uri : fragments)
-    RETURN_NOT_OK(storage_manager_->vfs()->remove_dir(uri));
+  return storage_manager_->vfs()->remove_dirs(fragments);
+}
+
+Status Consolidator::write_vacuum_file(
+    const URI& array_uri,
+    const EncryptionKey& encryption_key,
+    const URI& new_fragment_uri,
+    const std::vector<URI>& fragments) {
+  std::stringstream ss;
+  for (const auto& uri : fragments)
+    ss << uri.remove_trailing_slash().last_path_part() << "\n";
+  auto data = ss.str();
+
+  auto vac_uri = URI(
+      new_fragment_uri.remove_trailing_slash().to_string() +
+      constants::vacuum_file_suffix);
+  auto vfs = storage_manager_->vfs();
+  RETURN_NOT_OK(vfs->write(vac_uri, data.data(), data.size()));
+  RETURN_NOT_OK(vfs->close_file(vac_uri));
+
+  // Readers ignore the old fragments by their names, but a manifest
+  // lists them explicitly
+  return storage_manager_->update_array_manifest(
+      array_uri, encryption_key, {}, fragments);
+}
+
+Status Consolidator::vacuum(const char* array_name) {
+  URI array_uri = URI(array_name);
+  auto vfs = storage_manager_->vfs();
+
+  // Get the fragments listed in the vacuum files
+  std::vector<URI> uris, vac_uris, to_delete;
+  RETURN_NOT_OK(vfs->ls(array_uri.add_trailing_slash(), &uris));
+  for (const auto& uri : uris) {
+    auto name = uri.remove_trailing_slash().last_path_part();
+    if (!utils::parse::ends_with(name, constants::vacuum_file_suffix))
+      continue;
+    vac_uris.push_back(uri);
+
+    uint64_t size = 0;
+    RETURN_NOT_OK(vfs->file_size(uri, &size));
+    std::string data(size, '\0');
+    if (size > 0)
+      RETURN_NOT_OK(vfs->read(uri, 0, &data[0], size));
+    std::stringstream ss(data);
+    std::string fragment_name;
+    while (std::getline(ss, fragment_name)) {
+      if (fragment_name.empty())
+        continue;
+      auto fragment_uri = array_uri.join_path(fragment_name);
+      bool is_dir = false;
+      RETURN_NOT_OK(vfs->is_dir(fragment_uri, &is_dir));
+      if (is_dir)
+        to_delete.push_back(fragment_uri);
+    }
+  }
+  if (vac_uris.empty())
+    return Status::Ok();
+
+  // The exclusive lock is only a barrier for the readers of this process
+  // that opened the array before the consolidation and may still read the
+  // old fragments. Later readers ignore them.
+  RETURN_NOT_OK(storage_manager_->array_xlock(array_uri));
+  RETURN_NOT_OK(storage_manager_->array_xunlock(array_uri));
+
+  // Delete the fragments in a batch, then the vacuum files, so that an
+  // interrupted vacuum is completed by the next one
+  RETURN_NOT_OK(delete_fragments(to_delete));
+  for (const auto& uri : vac_uris)
+    RETURN_NOT_OK(vfs->remove_file(uri));
 
   return Status::Ok();
 }
 
 template <class T>
 Status Consolidator::delete_overwritten_fragments(
-    const ArraySchema* array_schema, std::vector<FragmentInfo>* fragments) {
+    const ArraySchema* array_schema,
+    const EncryptionKey& encryption_key,
+    std::vector<FragmentInfo>* fragments) {
   // Trivial case
   if (fragments->size() == 1)
     return Status::Ok();
@@ -678,7 +1817,7 @@ Status Consolidator::delete_overwritten_fragments(
 
   // Delete the fragment metadata
   auto array_uri = array_schema->array_uri();
-  RETURN_NOT_OK(delete_fragment_metadata(array_uri, to_delete));
+  RETURN_NOT_OK(delete_fragment_metadata(array_uri, encryption_key, to_delete));
 
   // Delete the fragments
   RETURN_NOT_OK(delete_fragments(to_delete));
@@ -704,6 +1843,7 @@ template <class T>
 Status Consolidator::compute_next_to_consolidate(
     const ArraySchema* array_schema,
     const std::vector<FragmentInfo>& fragments,
+    const T* subarray,
     std::vector<FragmentInfo>* to_consolidate,
     T* union_non_empty_domains) const {
   // Preparation
@@ -711,8 +1851,19 @@ Status Consolidator::compute_next_to_consolidate(
   auto dim_num = array_schema->dim_num();
   auto domain = array_schema->domain();
   to_consolidate->clear();
+
+  // Only runs of adjacent fragments in the consolidation region can be
+  // consolidated, so the longest run bounds the minimum number of fragments
+  std::vector<bool> in_region(fragments.size());
+  uint32_t run = 0, max_run = 0;
+  for (size_t j = 0; j < fragments.size(); ++j) {
+    in_region[j] = in_consolidation_region<T>(fragments[j], subarray, dim_num);
+    run = in_region[j] ? run + 1 : 0;
+    max_run = (run > max_run) ? run : max_run;
+  }
+
   auto min = config_.min_frags_;
-  min = (uint32_t)((min > fragments.size()) ? fragments.size() : min);
+  min = (min > max_run) ? max_run : min;
   auto max = config_.max_frags_;
   max = (uint32_t)((max > fragments.size()) ? fragments.size() : max);
   auto size_ratio = config_.size_ratio_;
@@ -750,7 +1901,8 @@ Status Consolidator::compute_next_to_consolidate(
   for (size_t i = 0; i < row_num; ++i) {
     for (size_t j = 0; j < col_num; ++j) {
       if (i == 0) {  // In the first row we store the sizes of `fragments`
-        m_sizes[i][j] = fragments[j].fragment_size_;
+        m_sizes[i][j] =
+            in_region[j] ? fragments[j].fragment_size_ : UINT64_MAX;
         std::memcpy(
             &m_union[i][j][0], &fragments[j].non_empty_domain_[0], domain_size);
       } else if (i + j >= col_num) {  // Non-valid entries
@@ -761,7 +1913,8 @@ Status Consolidator::compute_next_to_consolidate(
         auto ratio = (float)fragments[i + j - 1].fragment_size_ /
                      fragments[i + j].fragment_size_;
         ratio = (ratio <= 1.0f) ? ratio : 1.0f / ratio;
-        if (ratio >= size_ratio && (m_sizes[i - 1][j] != UINT64_MAX)) {
+        if (ratio >= size_ratio && in_region[i + j] &&
+            (m_sizes[i - 1][j] != UINT64_MAX)) {
           m_sizes[i][j] = m_sizes[i - 1][j] + fragments[i + j].fragment_size_;
           std::memcpy(&m_union[i][j][0], &m_union[i - 1][j][0], domain_size);
           utils::geometry::expand_mbr_with_mbr<T>(
@@ -786,6 +1939,42 @@ Status Consolidator::compute_next_to_consolidate(
     }
   }
 
+  // Choose the set of fragments with the best estimated benefit per byte
+  // written, if it saves at least as many bytes as it writes
+  if (config_.planner_ == "cost") {
+    auto read_weight = this->read_weight();
+    double max_benefit = 1.0;
+    bool found = false;
+    size_t max_row = 0, max_col = 0;
+    for (size_t i = std::max<size_t>(min, 2) - 1; i < row_num; ++i) {
+      for (size_t j = 0; j < col_num; ++j) {
+        if (m_sizes[i][j] == UINT64_MAX)
+          continue;
+        auto benefit = merge_benefit<T>(
+            fragments,
+            j,
+            j + i,
+            (const T*)&m_union[i][j][0],
+            dim_num,
+            read_weight);
+        if (benefit > max_benefit || (!found && benefit == max_benefit)) {
+          max_benefit = benefit;
+          max_row = i;
+          max_col = j;
+          found = true;
+        }
+      }
+    }
+
+    if (found) {
+      for (size_t f = max_col; f <= max_col + max_row; ++f)
+        to_consolidate->emplace_back(fragments[f]);
+      std::memcpy(
+          union_non_empty_domains, &m_union[max_row][max_col][0], domain_size);
+    }
+    return Status::Ok();
+  }
+
   // Choose the maximal set of fragments with cardinality in [min, max]
   // with the minimum size
   uint64_t min_size = UINT64_MAX;
@@ -914,6 +2103,218 @@ void Consolidator::update_fragment_info(
   *fragment_info = std::move(updated_fragment_info);
 }
 
+template <class T>
+bool Consolidator::tile_copy_order(
+    const ArraySchema* array_schema,
+    std::vector<FragmentMetadata*>* fragments) const {
+  auto domain = array_schema->domain();
+  auto dim_num = array_schema->dim_num();
+  bool dense = fragments->front()->dense();
+  for (auto f : *fragments) {
+    if (f->dense() != dense || f->format_version() != constants::format_version)
+      return false;
+  }
+
+  if (dense) {
+    // The expanded domains must be slabs that are adjacent along the slowest
+    // dimension of the tile order and equal on the other dimensions
+    unsigned major =
+        (array_schema->tile_order() == Layout::COL_MAJOR) ? dim_num - 1 : 0;
+    std::sort(
+        fragments->begin(),
+        fragments->end(),
+        [major](const FragmentMetadata* a, const FragmentMetadata* b) {
+          return ((const T*)a->domain())[2 * major] <
+                 ((const T*)b->domain())[2 * major];
+        });
+    for (size_t i = 1; i < fragments->size(); ++i) {
+      auto prev = (const T*)(*fragments)[i - 1]->domain();
+      auto cur = (const T*)(*fragments)[i]->domain();
+      for (unsigned d = 0; d < dim_num; ++d) {
+        if (d == major) {
+          if (prev[2 * d + 1] + 1 != cur[2 * d])
+            return false;
+        } else if (
+            prev[2 * d] != cur[2 * d] || prev[2 * d + 1] != cur[2 * d + 1]) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  // Hilbert values are not monotonic over a non-empty domain, and the bloom
+  // filter cannot be built without reading the coordinates
+  if (array_schema->cell_order() == Layout::HILBERT ||
+      config_.coords_bloom_filter_bits_ > 0)
+    return false;
+
+  // Compares in the global order the lower (or upper) corner of non-empty
+  // domain `a` with the lower corner of non-empty domain `b`
+  std::vector<T> coords(2 * dim_num);
+  std::vector<const void*> coord_buffs(dim_num);
+  for (unsigned d = 0; d < dim_num; ++d)
+    coord_buffs[d] = &coords[2 * d];
+  auto cmp = [&](const FragmentMetadata* a,
+                 bool upper,
+                 const FragmentMetadata* b) {
+    auto a_dom = (const T*)a->non_empty_domain();
+    auto b_dom = (const T*)b->non_empty_domain();
+    for (unsigned d = 0; d < dim_num; ++d) {
+      coords[2 * d] = a_dom[2 * d + (upper ? 1 : 0)];
+      coords[2 * d + 1] = b_dom[2 * d];
+    }
+    auto res = domain->tile_order_cmp(coord_buffs, 0, 1);
+    return (res != 0) ? res : domain->cell_order_cmp(coord_buffs, 0, 1);
+  };
+
+  // Every cell of a fragment must precede those of the next fragment, and
+  // only the last tile of the last fragment may be partially full
+  std::sort(
+      fragments->begin(),
+      fragments->end(),
+      [&](const FragmentMetadata* a, const FragmentMetadata* b) {
+        return cmp(a, false, b) < 0;
+      });
+  for (size_t i = 1; i < fragments->size(); ++i) {
+    auto prev = (*fragments)[i - 1];
+    if (prev->last_tile_cell_num() != array_schema->capacity() ||
+        cmp(prev, true, (*fragments)[i]) >= 0)
+      return false;
+  }
+
+  return true;
+}
+
+template <class T>
+double Consolidator::merge_benefit(
+    const std::vector<FragmentInfo>& fragments,
+    size_t start,
+    size_t end,
+    const T* union_non_empty_domains,
+    unsigned dim_num,
+    double read_weight) const {
+  uint64_t size = 0;
+  for (size_t i = start; i <= end; ++i)
+    size += fragments[i].fragment_size_;
+
+  // Dense fragments are rewritten over the union of their domains
+  double written = (double)size;
+  if (!all_sparse(fragments, start, end)) {
+    uint64_t cell_num = 0;
+    for (size_t i = start; i <= end; ++i)
+      cell_num += utils::geometry::cell_num<T>(
+          (const T*)&fragments[i].expanded_non_empty_domain_[0], dim_num);
+    if (cell_num != 0)
+      written *= (double)utils::geometry::cell_num<T>(
+                     union_non_empty_domains, dim_num) /
+                 cell_num;
+  }
+  written = std::max(written, 1.0);
+
+  // Reads open fewer fragments and skip the cells overwritten in the set
+  double saved = (double)(end - start) * config_.planner_fragment_cost_ +
+                 std::max((double)size - written, 0.0);
+
+  return read_weight * saved / written;
+}
+
+template <class T>
+void Consolidator::print_plan(
+    const ArraySchema* array_schema,
+    const std::vector<std::vector<FragmentInfo>>& to_consolidate_sets,
+    const std::vector<std::vector<uint8_t>>& unions) const {
+  auto read_weight = this->read_weight();
+  auto dim_num = array_schema->dim_num();
+
+  std::stringstream ss;
+  ss << "Consolidation plan for " << array_schema->array_uri().to_string()
+     << "\n";
+  for (size_t i = 0; i < to_consolidate_sets.size(); ++i) {
+    const auto& fragments = to_consolidate_sets[i];
+    uint64_t size = 0;
+    for (const auto& f : fragments)
+      size += f.fragment_size_;
+    auto benefit = merge_benefit<T>(
+        fragments,
+        0,
+        fragments.size() - 1,
+        (const T*)&unions[i][0],
+        dim_num,
+        read_weight);
+    ss << "  Step " << (i + 1) << ": " << fragments.size() << " fragments, "
+       << size << " bytes, estimated benefit per byte written " << benefit
+       << "\n";
+    for (const auto& f : fragments)
+      ss << "    " << f.uri_.remove_trailing_slash().last_path_part() << "\n";
+  }
+
+  std::cout << ss.str();
+}
+
+double Consolidator::read_weight() const {
+  // Read-heavy workloads gain more from each byte written
+  if (!stats::all_stats.enabled())
+    return 1.0;
+  return (stats::all_stats.counter_sm_query_submit_read.load() + 1.0) /
+         (stats::all_stats.counter_sm_query_submit_write.load() + 1.0);
+}
+
+template <class T>
+Status Consolidator::get_subarray(
+    const ArraySchema* array_schema, std::vector<T>* subarray) const {
+  subarray->clear();
+  if (config_.subarray_.empty())
+    return Status::Ok();
+
+  std::stringstream ss(config_.subarray_);
+  std::string value;
+  while (std::getline(ss, value, ',')) {
+    T coord;
+    if (std::is_floating_point<T>::value) {
+      double v;
+      RETURN_NOT_OK(utils::parse::convert(value, &v));
+      coord = (T)v;
+    } else if (std::is_signed<T>::value) {
+      int64_t v;
+      RETURN_NOT_OK(utils::parse::convert(value, &v));
+      coord = (T)v;
+    } else {
+      uint64_t v;
+      RETURN_NOT_OK(utils::parse::convert(value, &v));
+      coord = (T)v;
+    }
+    subarray->push_back(coord);
+  }
+
+  auto dim_num = array_schema->dim_num();
+  bool valid = subarray->size() == 2 * dim_num;
+  for (unsigned d = 0; valid && d < dim_num; ++d)
+    valid = (*subarray)[2 * d] <= (*subarray)[2 * d + 1];
+  if (!valid)
+    return LOG_STATUS(Status::ConsolidatorError(
+        "Invalid configuration; The consolidation subarray must contain a "
+        "low and a high bound, with low <= high, for each dimension"));
+
+  return Status::Ok();
+}
+
+template <class T>
+bool Consolidator::in_consolidation_region(
+    const FragmentInfo& fragment, const T* subarray, unsigned dim_num) const {
+  // Placeholders of fragments being consolidated
+  if (fragment.uri_.is_invalid())
+    return false;
+
+  if (fragment.timestamp_range_.second < config_.timestamp_start_ ||
+      fragment.timestamp_range_.first > config_.timestamp_end_)
+    return false;
+
+  return subarray == nullptr ||
+         utils::geometry::overlap(
+             subarray, (const T*)&fragment.non_empty_domain_[0], dim_num);
+}
+
 Status Consolidator::set_config(const Config* config) {
   // Set the config
   Config merged_config = storage_manager_->config();
@@ -944,6 +2345,68 @@ Status Consolidator::set_config(const Config* config) {
   RETURN_NOT_OK(merged_config.get<uint32_t>(
       "sm.consolidation.step_max_frags", &config_.max_frags_, &found));
   assert(found);
+  config_.timestamp_start_ = 0;
+  RETURN_NOT_OK(merged_config.get<uint64_t>(
+      "sm.consolidation.timestamp_start", &config_.timestamp_start_, &found));
+  assert(found);
+  config_.timestamp_end_ = UINT64_MAX;
+  RETURN_NOT_OK(merged_config.get<uint64_t>(
+      "sm.consolidation.timestamp_end", &config_.timestamp_end_, &found));
+  assert(found);
+  config_.subarray_ = merged_config.get("sm.consolidation.subarray", &found);
+  assert(found);
+  config_.memory_budget_ = 0;
+  RETURN_NOT_OK(merged_config.get<uint64_t>(
+      "sm.consolidation.memory_budget", &config_.memory_budget_, &found));
+  assert(found);
+  config_.planner_ =
+      merged_config.get("sm.consolidation.planner", &found);
+  assert(found);
+  config_.planner_fragment_cost_ = 0;
+  RETURN_NOT_OK(merged_config.get<uint64_t>(
+      "sm.consolidation.planner_fragment_cost",
+      &config_.planner_fragment_cost_,
+      &found));
+  assert(found);
+  config_.dry_run_ = false;
+  RETURN_NOT_OK(merged_config.get<bool>(
+      "sm.consolidation.dry_run", &config_.dry_run_, &found));
+  assert(found);
+  config_.deferred_vacuum_ = false;
+  RETURN_NOT_OK(merged_config.get<bool>(
+      "sm.consolidation.deferred_vacuum", &config_.deferred_vacuum_, &found));
+  assert(found);
+  config_.pyramid_levels_ = 0;
+  RETURN_NOT_OK(merged_config.get<uint32_t>(
+      "sm.consolidation.pyramid_levels", &config_.pyramid_levels_, &found));
+  assert(found);
+  config_.pyramid_method_ =
+      merged_config.get("sm.consolidation.pyramid_method", &found);
+  assert(found);
+  config_.tile_copy_ = true;
+  RETURN_NOT_OK(merged_config.get<bool>(
+      "sm.consolidation.tile_copy", &config_.tile_copy_, &found));
+  assert(found);
+  config_.coords_bloom_filter_bits_ = 0;
+  RETURN_NOT_OK(merged_config.get<uint32_t>(
+      "sm.coords_bloom_filter_bits",
+      &config_.coords_bloom_filter_bits_,
+      &found));
+  assert(found);
+  config_.rtree_str_packing_ = false;
+  RETURN_NOT_OK(merged_config.get<bool>(
+      "sm.rtree_str_packing", &config_.rtree_str_packing_, &found));
+  assert(found);
+  config_.fragment_sketches_ = false;
+  RETURN_NOT_OK(merged_config.get<bool>(
+      "sm.fragment_sketches", &config_.fragment_sketches_, &found));
+  assert(found);
+  config_.fragment_metadata_unfiltered_ = false;
+  RETURN_NOT_OK(merged_config.get<bool>(
+      "sm.fragment_metadata_unfiltered",
+      &config_.fragment_metadata_unfiltered_,
+      &found));
+  assert(found);
 
   // Sanity checks
   if (config_.min_frags_ > config_.max_frags_)
@@ -954,6 +2417,10 @@ Status Consolidator::set_config(const Config* config) {
     return LOG_STATUS(Status::ConsolidatorError(
         "Invalid configuration; Step size ratio config parameter must be in "
         "[0.0, 1.0]"));
+  if (config_.timestamp_start_ > config_.timestamp_end_)
+    return LOG_STATUS(Status::ConsolidatorError(
+        "Invalid configuration; Consolidation start timestamp must not be "
+        "larger than the end timestamp"));
   if (config_.amplification_ < 0)
     return LOG_STATUS(
         Status::ConsolidatorError("Invalid configuration; Amplification config "
@@ -38,13 +38,18 @@
 #include "tiledb/sm/misc/status.h"
 #include "tiledb/sm/storage_manager/open_array.h"
 
+#include <atomic>
+#include <future>
+#include <string>
 #include <vector>
 
 namespace tiledb {
 namespace sm {
 
 class ArraySchema;
+class Buffer;
 class Config;
+class FragmentMetadata;
 class Query;
 class StorageManager;
 class URI;
@@ -84,6 +89,84 @@ class Consolidator {
      * consolidation.
      */
     float size_ratio_;
+    /**
+     * Only the fragments whose timestamp range intersects
+     * `[timestamp_start_, timestamp_end_]` are consolidated.
+     */
+    uint64_t timestamp_start_;
+    /** See `timestamp_start_`. */
+    uint64_t timestamp_end_;
+    /**
+     * If not empty, the comma-separated low and high bounds on each
+     * dimension of the subarray that the consolidated fragments must
+     * intersect.
+     */
+    std::string subarray_;
+    /**
+     * Upper bound on the buffer memory of the consolidation steps that run
+     * concurrently over disjoint sets of fragments. At least one step runs
+     * at a time.
+     */
+    uint64_t memory_budget_;
+    /**
+     * The step planner, `size_ratio` (smallest eligible set) or `cost`
+     * (best estimated read benefit per byte written).
+     */
+    std::string planner_;
+    /** The read cost of a fragment in bytes, used by the `cost` planner. */
+    uint64_t planner_fragment_cost_;
+    /** If `true`, the plan is printed instead of consolidating. */
+    bool dry_run_;
+    /** The number of pyramid levels rebuilt for dense arrays. */
+    uint32_t pyramid_levels_;
+    /** The downsampling method of the pyramid levels. */
+    std::string pyramid_method_;
+    /**
+     * If `true`, the consolidated fragments are left to a later vacuum
+     * instead of being deleted.
+     */
+    bool deferred_vacuum_;
+    /**
+     * Whether fragments that follow each other in the global order are
+     * consolidated by copying their filtered tiles.
+     */
+    bool tile_copy_;
+    /** Bloom filter bits per cell of the consolidated sparse fragments. */
+    uint32_t coords_bloom_filter_bits_;
+    /** Whether the R-Trees of consolidated fragments use STR packing. */
+    bool rtree_str_packing_;
+    /** Whether the consolidated fragments store attribute sketches. */
+    bool fragment_sketches_;
+    /** Whether the consolidated fragment metadata is stored unfiltered. */
+    bool fragment_metadata_unfiltered_;
+  };
+
+  /** Statistics of a consolidation step. */
+  struct StepStats {
+    /** Number of fragments consolidated. */
+    uint64_t fragment_num_;
+    /** Total size of the fragments consolidated. */
+    uint64_t bytes_read_;
+    /** Size of the consolidated fragment. */
+    uint64_t bytes_written_;
+    /** Duration of the step in nanoseconds. */
+    uint64_t ns_;
+  };
+
+  /** Statistics of a consolidation. */
+  struct ConsolidationStats {
+    /** Number of fragments before the consolidation. */
+    uint64_t fragment_num_before_;
+    /** Number of fragments after the consolidation. */
+    uint64_t fragment_num_after_;
+    /** Number of fragments deleted as entirely overwritten. */
+    uint64_t overwritten_fragment_num_;
+    /** Number of tiles copied without decoding their cells. */
+    std::atomic<uint64_t> tiles_copied_;
+    /** Duration of the consolidation in nanoseconds. */
+    uint64_t ns_;
+    /** The statistics of each step, in the order the steps started. */
+    std::vector<StepStats> steps_;
   };
 
   /* ********************************* */
@@ -142,6 +225,66 @@ class Consolidator {
       uint32_t key_length,
       const Config* config);
 
+  /**
+   * Consolidates the fragment metadata of the input array, i.e., writes the
+   * footers and R-Trees of all its fragments into a single file. Fragments of
+   * format version 2 or before are left out.
+   *
+   * @param array_name URI of array whose fragment metadata to consolidate.
+   * @param encryption_type The encryption type of the array
+   * @param encryption_key If the array is encrypted, the private encryption
+   *    key. For unencrypted arrays, pass `nullptr`.
+   * @param key_length The length in bytes of the encryption key.
+   * @param config Configuration parameters for the consolidation
+   *     (`nullptr` means default).
+   * @return Status
+   */
+  Status consolidate_fragment_metadata(
+      const char* array_name,
+      EncryptionType encryption_type,
+      const void* encryption_key,
+      uint32_t key_length,
+      const Config* config);
+
+  /**
+   * Stitches the parts written concurrently by the producers of a global
+   * order write (see `Writer::add_fragment_part`) into a single fragment,
+   * by copying their filtered tiles and appending their tile offsets, MBRs
+   * and min/max/sum values. The parts must follow each other in the global
+   * order, and their tiles must be full except for the last tile of the
+   * last part. The metadata of the new fragment is returned unstored, or
+   * `nullptr` if no part has cells.
+   *
+   * @param array The array opened for writes.
+   * @param fragment_uri The URI of the new fragment, containing the parts.
+   * @param part_uris The URIs of the parts.
+   * @param new_fragment The metadata of the new fragment.
+   * @return Status
+   */
+  Status stitch(
+      const Array* array,
+      const URI& fragment_uri,
+      const std::vector<URI>& part_uris,
+      std::shared_ptr<FragmentMetadata>* new_fragment);
+
+  /**
+   * Deletes the fragments that consolidations with deferred vacuum have
+   * superseded, as listed in the vacuum files of the array.
+   *
+   * @param array_name URI of the array to vacuum.
+   * @return Status
+   */
+  Status vacuum(const char* array_name);
+
+  /** Returns the statistics of the last consolidation. */
+  const ConsolidationStats& stats() const;
+
+  /**
+   * Dumps the statistics of the last consolidation as a JSON object, with
+   * totals over its steps followed by the statistics of each step.
+   */
+  void dump_stats(std::string* out) const;
+
   /* ********************************* */
   /*          STATIC FUNCTIONS         */
   /* ********************************* */
@@ -174,6 +317,9 @@ class Consolidator {
   /** The storage manager. */
   StorageManager* storage_manager_;
 
+  /** Statistics of the last consolidation. */
+  ConsolidationStats stats_;
+
   /* ********************************* */
   /*          PRIVATE METHODS           */
   /* ********************************* */
@@ -283,12 +429,184 @@ class Consolidator {
   /**
    * Copies the array by reading from the fragments to be consolidated
    * (with `query_r`) and writing to the new fragment (with `query_w`).
+   * If the cells do not fit in the buffers at once, a second set of
+   * buffers is created so that each chunk is read while the previous one
+   * is written.
    *
    * @param query_r The read query.
    * @param query_w The write query.
+   * @param sparse_mode This indicates whether a dense array is read in
+   *     special sparse mode.
+   * @param buffers The buffers set in the queries.
+   * @param buffer_sizes The corresponding buffer sizes.
+   * @param buffer_num The number of buffers.
+   * @return Status
+   */
+  Status copy_array(
+      Query* query_r,
+      Query* query_w,
+      bool sparse_mode,
+      void** buffers,
+      uint64_t* buffer_sizes,
+      unsigned buffer_num);
+
+  /**
+   * Copies the filtered tiles of the fragments opened in `array_for_reads`
+   * into a new fragment, without decoding and re-encoding the cells. This
+   * applies only when the tiles of the fragments can be concatenated (see
+   * `tile_copy_order`); otherwise `new_fragment` is set to `nullptr` and
+   * nothing is written. The metadata of the new fragment is returned
+   * unstored, as storing it requires the array to be closed for reads.
+   *
+   * @tparam T The domain type.
+   * @param array_for_reads The opened array for reading the fragments
+   *     to be consolidated.
+   * @param array_for_writes The opened array for writing the
+   *     consolidated fragment.
+   * @param union_non_empty_domains The union of the non-empty domains of
+   *     the fragments to be consolidated.
+   * @param new_fragment_uri The URI of the new fragment to be created.
+   * @param new_fragment The metadata of the new fragment.
+   * @return Status
+   */
+  template <class T>
+  Status copy_tiles(
+      Array* array_for_reads,
+      Array* array_for_writes,
+      T* union_non_empty_domains,
+      URI* new_fragment_uri,
+      std::shared_ptr<FragmentMetadata>* new_fragment);
+
+  /**
+   * Creates a new fragment from the concatenation of the tiles of the input
+   * fragments, which must be sorted in the order in which their tiles can
+   * be concatenated (see `tile_copy_order`). `new_fragment` is set to
+   * `nullptr` if the tiles of dense fragments do not fill the expanded
+   * union of their non-empty domains.
+   *
+   * @param array_schema The array schema of the fragments.
+   * @param new_array_schema The array schema of the new fragment.
+   * @param encryption_key The encryption key of the array.
+   * @param fragments The fragments whose tiles are copied.
+   * @param union_non_empty_domains The union of the non-empty domains of
+   *     the fragments.
+   * @param new_fragment_uri The URI of the new fragment.
+   * @param new_fragment The metadata of the new fragment.
+   * @return Status
+   */
+  Status concat_fragments(
+      const ArraySchema* array_schema,
+      const ArraySchema* new_array_schema,
+      const EncryptionKey& encryption_key,
+      const std::vector<FragmentMetadata*>& fragments,
+      const void* union_non_empty_domains,
+      const URI& new_fragment_uri,
+      std::shared_ptr<FragmentMetadata>* new_fragment);
+
+  /**
+   * Appends the tiles of the `src` fragment to the `dst` fragment, along with
+   * their offsets, sizes, MBRs and min/max/sum values. The tile index base
+   * of `dst` must be set to the number of tiles appended so far.
+   *
+   * @param array_schema The array schema.
+   * @param encryption_key The encryption key of the array.
+   * @param src The fragment whose tiles are copied.
+   * @param dst The new fragment.
    * @return Status
    */
-  Status copy_array(Query* query_r, Query* query_w);
+  Status copy_fragment_tiles(
+      const ArraySchema* array_schema,
+      const EncryptionKey& encryption_key,
+      FragmentMetadata* src,
+      FragmentMetadata* dst);
+
+  /** Appends the contents of file `src` to file `dst`. */
+  Status copy_file(const URI& src, const URI& dst) const;
+
+  /**
+   * Appends the `size` bytes of file `src` starting at `offset` to file
+   * `dst`.
+   */
+  Status copy_file_range(
+      const URI& src, uint64_t offset, uint64_t size, const URI& dst) const;
+
+  /**
+   * Appends tile `src_tile` of fragment `src` to the attribute files of
+   * fragment `dst` as tile `dst_tile`, along with its offsets, sizes and
+   * min/max/sum values. Tiles must be appended in the order of `dst`.
+   *
+   * @param encryption_key The encryption key of the array.
+   * @param name The attribute name.
+   * @param var_size Whether the attribute is var-sized.
+   * @param src The fragment whose tile is copied.
+   * @param src_tile The position of the tile in `src`.
+   * @param dst The new fragment.
+   * @param dst_tile The position of the tile in `dst`.
+   * @param buff Scratch buffer for the tile bytes.
+   * @return Status
+   */
+  Status copy_tile(
+      const EncryptionKey& encryption_key,
+      const std::string& name,
+      bool var_size,
+      FragmentMetadata* src,
+      uint64_t src_tile,
+      FragmentMetadata* dst,
+      uint64_t dst_tile,
+      Buffer* buff) const;
+
+  /**
+   * Consolidates overlapping dense fragments by rewriting only the space
+   * tiles that are covered by more than one fragment (or by none, within
+   * the union of their domains), and by copying the filtered tiles of every
+   * other space tile from the single fragment that covers it. The rewritten
+   * tiles are written one per fragment into a scratch array inside the
+   * array directory, whose tiles are then copied like the others.
+   *
+   * Nothing is written and `new_fragment` is set to `nullptr` if the
+   * fragments are not all dense, or if fewer tiles would be copied than
+   * rewritten, in which case the cells are consolidated as usual. The
+   * metadata of the new fragment is returned unstored, as in `copy_tiles`.
+   *
+   * @tparam T The domain type.
+   * @param array_for_reads The opened array for reading the fragments
+   *     to be consolidated.
+   * @param array_for_writes The opened array for writing the
+   *     consolidated fragment.
+   * @param union_non_empty_domains The union of the non-empty domains of
+   *     the fragments to be consolidated.
+   * @param new_fragment_uri The URI of the new fragment to be created.
+   * @param new_fragment The metadata of the new fragment.
+   * @return Status
+   */
+  template <class T>
+  Status copy_untouched_tiles(
+      Array* array_for_reads,
+      Array* array_for_writes,
+      T* union_non_empty_domains,
+      URI* new_fragment_uri,
+      std::shared_ptr<FragmentMetadata>* new_fragment);
+
+  /**
+   * Reads the cells of `subarray`, which spans a single space tile, from
+   * `array_for_reads` and writes them as a new fragment of `scratch`.
+   *
+   * @param array_for_reads The opened array for reading the fragments
+   *     to be consolidated.
+   * @param scratch The scratch array opened for writes.
+   * @param subarray The subarray of the tile.
+   * @param buffers The consolidation buffers.
+   * @param buffer_sizes The sizes of the consolidation buffers.
+   * @param buffer_num The number of consolidation buffers.
+   * @return Status
+   */
+  Status rewrite_tile(
+      Array* array_for_reads,
+      Array* scratch,
+      void* subarray,
+      void** buffers,
+      uint64_t* buffer_sizes,
+      unsigned buffer_num);
 
   /** Cleans up the inputs. */
   void clean_up(
@@ -298,6 +616,17 @@ class Consolidator {
       Query* query_r,
       Query* query_w) const;
 
+  /**
+   * Returns the number of buffers needed to read the input fragments and
+   * write the new fragment.
+   *
+   * @param array_schema The array schema.
+   * @param sparse_mode This indicates whether a dense array must be opened
+   *     in special sparse mode. This is ignored for sparse arrays.
+   * @return The number of buffers.
+   */
+  unsigned buffer_num(const ArraySchema* array_schema, bool sparse_mode) const;
+
   /**
    * Creates the buffers that will be used upon reading the input fragments and
    * writing into the new fragment. It also retrieves the number of buffers
@@ -351,14 +680,19 @@ class Consolidator {
 
   /**
    * Deletes the fragment metadata files of the input fragments.
-   * This renders the fragments "invisible".
+   * This renders the fragments "invisible". The fragments are first removed
+   * from the array manifest, if maintained, which hides them from new
+   * readers before the array is locked exclusively.
    *
    * @param array_uri The array URI.
+   * @param encryption_key The encryption key of the array.
    * @param fragments The URIs of the fragments to be deleted.
    * @return Status
    */
   Status delete_fragment_metadata(
-      const URI& array_uri, const std::vector<URI>& fragments);
+      const URI& array_uri,
+      const EncryptionKey& encryption_key,
+      const std::vector<URI>& fragments);
 
   /**
    * Deletes the entire directories of the input fragments.
@@ -368,6 +702,22 @@ class Consolidator {
    */
   Status delete_fragments(const std::vector<URI>& fragments);
 
+  /**
+   * Writes the vacuum file of a new consolidated fragment, which lists the
+   * fragments it superseded, and removes those from the array manifest.
+   *
+   * @param array_uri The array URI.
+   * @param encryption_key The encryption key of the array.
+   * @param new_fragment_uri The URI of the consolidated fragment.
+   * @param fragments The URIs of the superseded fragments.
+   * @return Status
+   */
+  Status write_vacuum_file(
+      const URI& array_uri,
+      const EncryptionKey& encryption_key,
+      const URI& new_fragment_uri,
+      const std::vector<URI>& fragments);
+
   /**
    * This function will delete all fragments that are completely
    * overwritten by more recent fragments, i.e., all fragments
@@ -377,6 +727,7 @@ class Consolidator {
    *
    * @tparam T The domain type.
    * @param array_schema The array schema.
+   * @param encryption_key The encryption key of the array.
    * @param fragments Fragment information that will help in identifying
    *     which fragments to delete. If a fragment gets deleted by the
    *     function, its corresponding fragment info will get evicted
@@ -385,7 +736,9 @@ class Consolidator {
    */
   template <class T>
   Status delete_overwritten_fragments(
-      const ArraySchema* array_schema, std::vector<FragmentInfo>* fragments);
+      const ArraySchema* array_schema,
+      const EncryptionKey& encryption_key,
+      std::vector<FragmentInfo>* fragments);
 
   /**
    * Frees the input buffers.
@@ -404,6 +757,8 @@ class Consolidator {
    * @tparam T The domain type.
    * @param array_schema The array schema.
    * @param fragments Information about all the fragments.
+   * @param subarray If not `nullptr`, only the fragments whose non-empty
+   *     domain intersects this subarray are considered.
    * @param to_consolidate The fragments to consolidate in the next step.
    * @param union_non_empty_domains The function will return here the
    *     union of the non-empty domains of the fragments in `to_consolidate`.
@@ -413,6 +768,7 @@ class Consolidator {
   Status compute_next_to_consolidate(
       const ArraySchema* array_schema,
       const std::vector<FragmentInfo>& fragments,
+      const T* subarray,
       std::vector<FragmentInfo>* to_consolidate,
       T* union_non_empty_domains) const;
 
@@ -423,9 +779,107 @@ class Consolidator {
   Status compute_new_fragment_uri(
       const URI& first, const URI& last, URI* new_uri) const;
 
+  /**
+   * Estimates the read cost saved per byte written by consolidating the
+   * fragments between `start` and `end` (inclusive) in `fragments`. The
+   * savings are the fragments that reads no longer open and the
+   * overwritten cells they no longer read, weighted by `read_weight`.
+   *
+   * @tparam T The domain type.
+   * @param fragments The input fragments.
+   * @param start The first fragment of the set.
+   * @param end The last fragment of the set.
+   * @param union_non_empty_domains The union of the non-empty domains of
+   *    the fragments between `start` and `end`.
+   * @param dim_num The number of domain dimensions.
+   * @param read_weight The weight of the read savings (see `read_weight`).
+   * @return The estimated benefit per byte written.
+   */
+  template <class T>
+  double merge_benefit(
+      const std::vector<FragmentInfo>& fragments,
+      size_t start,
+      size_t end,
+      const T* union_non_empty_domains,
+      unsigned dim_num,
+      double read_weight) const;
+
+  /**
+   * Prints the sets of fragments that would be consolidated to stdout.
+   *
+   * @tparam T The domain type.
+   * @param array_schema The array schema.
+   * @param to_consolidate_sets The sets of fragments to consolidate.
+   * @param unions The unions of the non-empty domains of the sets.
+   */
+  template <class T>
+  void print_plan(
+      const ArraySchema* array_schema,
+      const std::vector<std::vector<FragmentInfo>>& to_consolidate_sets,
+      const std::vector<std::vector<uint8_t>>& unions) const;
+
+  /**
+   * Returns the ratio of read to write queries submitted so far, if the
+   * statistics are enabled, and `1` otherwise.
+   */
+  double read_weight() const;
+
+  /**
+   * Retrieves the subarray of `sm.consolidation.subarray`, which is empty
+   * if the parameter is not set.
+   *
+   * @tparam T The domain type.
+   * @param array_schema The array schema.
+   * @param subarray The subarray to be retrieved.
+   * @return Status
+   */
+  template <class T>
+  Status get_subarray(
+      const ArraySchema* array_schema, std::vector<T>* subarray) const;
+
+  /**
+   * Returns `true` if the input fragment is in the consolidation region,
+   * i.e., its timestamp range intersects the configured one and its
+   * non-empty domain intersects `subarray` (if not `nullptr`).
+   */
+  template <class T>
+  bool in_consolidation_region(
+      const FragmentInfo& fragment, const T* subarray, unsigned dim_num) const;
+
   /** Checks and sets the input configuration parameters. */
   Status set_config(const Config* config);
 
+  /**
+   * Stitches the input parts into a single fragment (see `stitch`).
+   *
+   * @tparam T The domain type.
+   */
+  template <class T>
+  Status stitch(
+      const Array* array,
+      const URI& fragment_uri,
+      const std::vector<URI>& part_uris,
+      std::shared_ptr<FragmentMetadata>* new_fragment);
+
+  /**
+   * Sorts the input fragments in the order in which their tiles can be
+   * concatenated into a single fragment, and returns `true` if that yields
+   * a valid fragment. That is the case for sparse fragments whose non-empty
+   * domains follow each other in the global order and whose tiles are full
+   * (except for the last tile of the last fragment), and for dense
+   * fragments that tile a contiguous slab along the slowest dimension of
+   * the tile order.
+   *
+   * @tparam T The domain type.
+   * @param array_schema The array schema.
+   * @param fragments The fragments to be consolidated.
+   * @return `true` if the tiles of the fragments can be concatenated.
+   */
+  template <class T>
+  bool tile_copy_order(
+      const ArraySchema* array_schema,
+      std::vector<FragmentMetadata*>* fragments) const;
+
   /**
    * Sets the buffers to the query, using all the attributes in the
    * query schema. There is a 1-1 correspondence between the input `buffers`
@@ -33,6 +33,7 @@
 
 #include "tiledb/sm/storage_manager/open_array.h"
 #include "tiledb/sm/array_schema/array_schema.h"
+#include "tiledb/sm/buffer/const_buffer.h"
 #include "tiledb/sm/filesystem/vfs.h"
 #include "tiledb/sm/misc/constants.h"
 
@@ -93,6 +94,24 @@ bool OpenArray::is_empty(uint64_t timestamp) const {
          (*fragment_metadata_.cbegin())->first_timestamp() > timestamp;
 }
 
+bool OpenArray::empty_subarray(const std::string& key) const {
+  std::lock_guard<std::mutex> lock(local_mtx_);
+  return empty_subarrays_.find(key) != empty_subarrays_.end();
+}
+
+void OpenArray::insert_empty_subarray(
+    const std::string& key, uint64_t max_num) {
+  std::lock_guard<std::mutex> lock(local_mtx_);
+  if (max_num == 0 || !empty_subarrays_.insert(key).second)
+    return;
+
+  empty_subarray_ll_.push_back(key);
+  while (empty_subarray_ll_.size() > max_num) {
+    empty_subarrays_.erase(empty_subarray_ll_.front());
+    empty_subarray_ll_.pop_front();
+  }
+}
+
 Status OpenArray::file_lock(VFS* vfs) {
   auto uri = array_uri_.join_path(constants::filelock_name);
   if (filelock_ == INVALID_FILELOCK)
@@ -116,12 +135,31 @@ FragmentMetadata* OpenArray::fragment_metadata(const URI& uri) const {
   return (it == fragment_metadata_set_.end()) ? nullptr : it->second;
 }
 
+std::vector<URI> OpenArray::fragment_uris() const {
+  std::lock_guard<std::mutex> lock(local_mtx_);
+  std::vector<URI> uris;
+  uris.reserve(fragment_metadata_.size());
+  for (const auto& metadata : fragment_metadata_)
+    uris.push_back(metadata->fragment_uri());
+  return uris;
+}
+
 std::shared_ptr<ConstBuffer> OpenArray::array_metadata(const URI& uri) const {
   std::lock_guard<std::mutex> lock(local_mtx_);
   auto it = array_metadata_.find(uri.to_string());
   return (it == array_metadata_.end()) ? nullptr : it->second;
 }
 
+uint64_t OpenArray::memory_size() const {
+  std::lock_guard<std::mutex> lock(local_mtx_);
+  uint64_t size = 0;
+  for (auto metadata : fragment_metadata_)
+    size += metadata->memory_size();
+  for (const auto& it : array_metadata_)
+    size += it.second->size();
+  return size;
+}
+
 void OpenArray::mtx_lock() {
   mtx_.lock();
 }
@@ -143,6 +181,22 @@ void OpenArray::insert_fragment_metadata(FragmentMetadata* metadata) {
   assert(metadata != nullptr);
   fragment_metadata_.insert(metadata);
   fragment_metadata_set_[metadata->fragment_uri().to_string()] = metadata;
+
+  // The empty subarray keys identify their fragments, so the records of the
+  // previous fragments can no longer be hit by handles that see the new one
+  empty_subarrays_.clear();
+  empty_subarray_ll_.clear();
+}
+
+void OpenArray::remove_fragment_metadata(const URI& uri) {
+  std::lock_guard<std::mutex> lock(local_mtx_);
+  auto it = fragment_metadata_set_.find(uri.to_string());
+  if (it == fragment_metadata_set_.end())
+    return;
+  auto metadata = it->second;
+  fragment_metadata_.erase(metadata);
+  fragment_metadata_set_.erase(it);
+  delete metadata;
 }
 
 void OpenArray::insert_array_metadata(
@@ -37,8 +37,12 @@
 #include <map>
 #include <memory>
 #include <mutex>
+#include <list>
 #include <set>
+#include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "tiledb/sm/encryption/encryption_key_validation.h"
 #include "tiledb/sm/filesystem/filelock.h"
@@ -111,6 +115,18 @@ class OpenArray {
    */
   bool is_empty(uint64_t timestamp) const;
 
+  /**
+   * Returns `true` if a read found no results in the subarray with the input
+   * key. The key also identifies the fragments the read was performed on.
+   */
+  bool empty_subarray(const std::string& key) const;
+
+  /**
+   * Records that a read found no results in the subarray with the input key,
+   * evicting the oldest records beyond `max_num`.
+   */
+  void insert_empty_subarray(const std::string& key, uint64_t max_num);
+
   /** Retrieves a (shared) filelock for the array. */
   Status file_lock(VFS* vfs);
 
@@ -123,12 +139,21 @@ class OpenArray {
    */
   FragmentMetadata* fragment_metadata(const URI& uri) const;
 
+  /** Returns the URIs of the fragments whose metadata are loaded. */
+  std::vector<URI> fragment_uris() const;
+
   /**
    * Returns the constant buffer storing the serialized array metadata
    * of the input URI, or `nullptr` if the array metadata do not exist.
    */
   std::shared_ptr<ConstBuffer> array_metadata(const URI& uri) const;
 
+  /**
+   * Returns the approximate number of bytes held by the loaded fragment
+   * metadata and array metadata.
+   */
+  uint64_t memory_size() const;
+
   /** Locks the array mutex. */
   void mtx_lock();
 
@@ -145,6 +170,13 @@ class OpenArray {
    */
   void insert_fragment_metadata(FragmentMetadata* metadata);
 
+  /**
+   * Removes and deletes the fragment metadata of the input fragment URI,
+   * if they are loaded. The caller must ensure that no array handle still
+   * refers to them.
+   */
+  void remove_fragment_metadata(const URI& uri);
+
   /**
    * Inserts the input array metadata (serialized in a share constant
    * buffer) with the input URI.
@@ -202,9 +234,18 @@ class OpenArray {
    */
   std::unordered_map<std::string, std::shared_ptr<ConstBuffer>> array_metadata_;
 
+  /**
+   * The keys of the subarrays in which reads found no results (see
+   * `insert_empty_subarray`), and the same keys in insertion order.
+   */
+  std::unordered_set<std::string> empty_subarrays_;
+  std::list<std::string> empty_subarray_ll_;
+
   /**
    * A mutex used to lock the array for thread-safe open/close of the array
-   * by the StorageManager.
+   * by the StorageManager, and while loading its array schema or missing
+   * fragment metadata. Fragment metadata that are already loaded are
+   * looked up under `local_mtx_` only.
    */
   mutable std::mutex mtx_;
 
@@ -0,0 +1,457 @@
+/**
+ * @file   pyramid_builder.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * This file implements class PyramidBuilder.
+ */
+
+#include "tiledb/sm/storage_manager/pyramid_builder.h"
+#include "tiledb/sm/array/array.h"
+#include "tiledb/sm/array_schema/array_schema.h"
+#include "tiledb/sm/array_schema/attribute.h"
+#include "tiledb/sm/array_schema/dimension.h"
+#include "tiledb/sm/array_schema/domain.h"
+#include "tiledb/sm/encryption/encryption_key.h"
+#include "tiledb/sm/enums/array_type.h"
+#include "tiledb/sm/enums/datatype.h"
+#include "tiledb/sm/enums/encryption_type.h"
+#include "tiledb/sm/enums/layout.h"
+#include "tiledb/sm/enums/query_status.h"
+#include "tiledb/sm/enums/query_type.h"
+#include "tiledb/sm/filesystem/vfs.h"
+#include "tiledb/sm/misc/constants.h"
+#include "tiledb/sm/misc/logger.h"
+#include "tiledb/sm/query/query.h"
+#include "tiledb/sm/storage_manager/storage_manager.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <type_traits>
+
+namespace tiledb {
+namespace sm {
+
+namespace {
+
+/** Computes a cell of a level from the input cells of the previous one. */
+typedef void (*DownsampleFunc)(
+    PyramidBuilder::Method method,
+    const uint8_t* values,
+    const std::vector<uint64_t>& cells,
+    uint8_t* dst);
+
+template <class V>
+void downsample(
+    PyramidBuilder::Method method,
+    const uint8_t* values,
+    const std::vector<uint64_t>& cells,
+    uint8_t* dst) {
+  auto v = (const V*)values;
+  V res = v[cells[0]];
+  if (method == PyramidBuilder::Method::MEAN) {
+    double sum = 0;
+    for (auto c : cells)
+      sum += static_cast<double>(v[c]);
+    double mean = sum / cells.size();
+    res = static_cast<V>(std::is_integral<V>::value ? std::round(mean) : mean);
+  } else if (method == PyramidBuilder::Method::MAX) {
+    for (auto c : cells) {
+      if (v[c] > res)
+        res = v[c];
+    }
+  }
+  std::memcpy(dst, &res, sizeof(V));
+}
+
+/** Returns the downsampling function of a numeric type, else `nullptr`. */
+DownsampleFunc downsample_func(Datatype type) {
+  switch (type) {
+    case Datatype::INT8:
+      return downsample<int8_t>;
+    case Datatype::UINT8:
+      return downsample<uint8_t>;
+    case Datatype::INT16:
+      return downsample<int16_t>;
+    case Datatype::UINT16:
+      return downsample<uint16_t>;
+    case Datatype::INT32:
+      return downsample<int32_t>;
+    case Datatype::UINT32:
+      return downsample<uint32_t>;
+    case Datatype::INT64:
+      return downsample<int64_t>;
+    case Datatype::UINT64:
+      return downsample<uint64_t>;
+    case Datatype::FLOAT32:
+      return downsample<float>;
+    case Datatype::FLOAT64:
+      return downsample<double>;
+    default:
+      return datatype_is_datetime(type) ? downsample<int64_t> : nullptr;
+  }
+}
+
+/**
+ * Advances the input coordinates within `sizes` in row-major or column-major
+ * order. Returns `false` once they wrap around to the first ones.
+ */
+bool next_coords(
+    std::vector<uint64_t>* coords,
+    const std::vector<uint64_t>& sizes,
+    bool row_major) {
+  auto dim_num = (unsigned)sizes.size();
+  for (unsigned i = 0; i < dim_num; ++i) {
+    auto d = row_major ? dim_num - 1 - i : i;
+    if (++(*coords)[d] < sizes[d])
+      return true;
+    (*coords)[d] = 0;
+  }
+  return false;
+}
+
+}  // namespace
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+PyramidBuilder::PyramidBuilder(
+    StorageManager* storage_manager,
+    const URI& array_uri,
+    EncryptionType encryption_type,
+    const void* encryption_key,
+    uint32_t key_length,
+    uint64_t buffer_size)
+    : storage_manager_(storage_manager)
+    , array_uri_(array_uri)
+    , encryption_type_(encryption_type)
+    , buffer_size_(std::max<uint64_t>(buffer_size, 1)) {
+  if (encryption_key != nullptr) {
+    auto key = (const uint8_t*)encryption_key;
+    encryption_key_.assign(key, key + key_length);
+  }
+}
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+Status PyramidBuilder::build(uint32_t level_num, Method method) {
+  std::unique_ptr<Array> src(new Array(array_uri_, storage_manager_));
+  RETURN_NOT_OK(open(src.get(), true));
+  if (!src->array_schema()->dense()) {
+    src->close();
+    return LOG_STATUS(Status::ConsolidatorError(
+        "Cannot build pyramid; Only dense arrays have pyramids"));
+  }
+
+  // Replace the previous levels
+  auto vfs = storage_manager_->vfs();
+  auto dir = array_uri_.join_path(constants::pyramid_folder_name);
+  bool is_dir = false;
+  auto st = vfs->is_dir(dir, &is_dir);
+  if (st.ok() && is_dir)
+    st = vfs->remove_dir(dir);
+  if (st.ok() && level_num > 0)
+    st = vfs->create_dir(dir);
+
+  // Each level is built from the previous one, until it has a single cell
+  std::vector<uint64_t> sizes;
+  for (uint32_t l = 1; l <= level_num && st.ok(); ++l) {
+    if (l > 1) {
+      bool single_cell = true;
+      for (auto size : sizes)
+        single_cell &= size == 1;
+      if (single_cell)
+        break;
+
+      st = src->close();
+      if (!st.ok())
+        return st;
+      src.reset(new Array(level_uri(array_uri_, l - 1), storage_manager_));
+      RETURN_NOT_OK(open(src.get(), true));
+    }
+
+    auto uri = level_uri(array_uri_, l);
+    switch (src->array_schema()->coords_type()) {
+      case Datatype::INT8:
+        st = build_level<int8_t>(src.get(), uri, method, &sizes);
+        break;
+      case Datatype::UINT8:
+        st = build_level<uint8_t>(src.get(), uri, method, &sizes);
+        break;
+      case Datatype::INT16:
+        st = build_level<int16_t>(src.get(), uri, method, &sizes);
+        break;
+      case Datatype::UINT16:
+        st = build_level<uint16_t>(src.get(), uri, method, &sizes);
+        break;
+      case Datatype::INT32:
+        st = build_level<int32_t>(src.get(), uri, method, &sizes);
+        break;
+      case Datatype::UINT32:
+        st = build_level<uint32_t>(src.get(), uri, method, &sizes);
+        break;
+      case Datatype::INT64:
+        st = build_level<int64_t>(src.get(), uri, method, &sizes);
+        break;
+      case Datatype::UINT64:
+        st = build_level<uint64_t>(src.get(), uri, method, &sizes);
+        break;
+      default:
+        if (datatype_is_datetime(src->array_schema()->coords_type()))
+          st = build_level<int64_t>(src.get(), uri, method, &sizes);
+        else
+          st = LOG_STATUS(Status::ConsolidatorError(
+              "Cannot build pyramid; Invalid domain type"));
+    }
+  }
+
+  auto st_close = src->close();
+  RETURN_NOT_OK(st);
+  return st_close;
+}
+
+URI PyramidBuilder::level_uri(const URI& array_uri, uint32_t level) {
+  return array_uri.join_path(constants::pyramid_folder_name)
+      .join_path(std::to_string(level));
+}
+
+Status PyramidBuilder::method_from_str(const std::string& str, Method* method) {
+  if (str == "mean")
+    *method = Method::MEAN;
+  else if (str == "max")
+    *method = Method::MAX;
+  else if (str == "nearest")
+    *method = Method::NEAREST;
+  else
+    return LOG_STATUS(Status::ConsolidatorError(
+        "Invalid pyramid method '" + str + "'; Must be 'mean', 'max' or " +
+        "'nearest'"));
+
+  return Status::Ok();
+}
+
+/* ****************************** */
+/*         PRIVATE METHODS        */
+/* ****************************** */
+
+template <class T>
+Status PyramidBuilder::build_level(
+    Array* src, const URI& uri, Method method, std::vector<uint64_t>* sizes) {
+  auto src_schema = src->array_schema();
+  auto domain = src_schema->domain();
+  auto dim_num = domain->dim_num();
+  auto dom = (const T*)domain->domain();
+  auto ext = (const T*)domain->tile_extents();
+  if (sizes->empty()) {
+    for (unsigned d = 0; d < dim_num; ++d)
+      sizes->push_back((uint64_t)dom[2 * d + 1] - (uint64_t)dom[2 * d] + 1);
+  }
+
+  // The level halves the cells of the previous one along each dimension,
+  // and its domain is padded to its tile extents so that it is written in
+  // the global order in a single fragment
+  auto src_sizes = *sizes;
+  std::vector<uint64_t> level_ext(dim_num), tile_num(dim_num);
+  std::vector<T> level_subarray(2 * dim_num);
+  Domain level_domain(domain->type());
+  for (unsigned d = 0; d < dim_num; ++d) {
+    (*sizes)[d] = (src_sizes[d] + 1) / 2;
+    level_ext[d] = std::min<uint64_t>((uint64_t)ext[d], (*sizes)[d]);
+    tile_num[d] = ((*sizes)[d] + level_ext[d] - 1) / level_ext[d];
+    auto padded = tile_num[d] * level_ext[d];
+    if ((uint64_t)std::numeric_limits<T>::max() - (uint64_t)dom[2 * d] <
+        padded - 1)
+      return LOG_STATUS(Status::ConsolidatorError(
+          "Cannot build pyramid; The padded level domain exceeds the domain "
+          "type"));
+    level_subarray[2 * d] = dom[2 * d];
+    level_subarray[2 * d + 1] = (T)((uint64_t)dom[2 * d] + padded - 1);
+
+    auto tile_extent = (T)level_ext[d];
+    Dimension dim(domain->dimension(d)->name(), domain->type());
+    RETURN_NOT_OK(dim.set_domain(&level_subarray[2 * d]));
+    RETURN_NOT_OK(dim.set_tile_extent(&tile_extent));
+    RETURN_NOT_OK(level_domain.add_dimension(&dim));
+  }
+
+  // The level has the fixed-sized attributes of the array
+  ArraySchema level_schema(ArrayType::DENSE);
+  RETURN_NOT_OK(level_schema.set_domain(&level_domain));
+  level_schema.set_cell_order(src_schema->cell_order());
+  level_schema.set_tile_order(src_schema->tile_order());
+  std::vector<const Attribute*> attrs;
+  for (auto attr : src_schema->attributes()) {
+    if (attr->var_size())
+      continue;
+    attrs.push_back(attr);
+    RETURN_NOT_OK(level_schema.add_attribute(attr));
+  }
+  if (attrs.empty())
+    return LOG_STATUS(Status::ConsolidatorError(
+        "Cannot build pyramid; The array has no fixed-sized attributes"));
+  EncryptionKey enc_key;
+  RETURN_NOT_OK(enc_key.set_key(
+      encryption_type_,
+      encryption_key_.empty() ? nullptr : encryption_key_.data(),
+      (uint32_t)encryption_key_.size()));
+  RETURN_NOT_OK(storage_manager_->array_create(uri, &level_schema, enc_key));
+
+  auto attr_num = attrs.size();
+  std::vector<DownsampleFunc> funcs(attr_num, nullptr);
+  for (size_t i = 0; i < attr_num; ++i) {
+    if (method != Method::NEAREST && attrs[i]->cell_val_num() == 1)
+      funcs[i] = downsample_func(attrs[i]->type());
+  }
+  bool row_major = src_schema->cell_order() != Layout::COL_MAJOR;
+  bool tile_row_major = src_schema->tile_order() != Layout::COL_MAJOR;
+
+  Array dst(uri, storage_manager_);
+  RETURN_NOT_OK(open(&dst, false));
+  auto write_level = [&]() {
+    Query write_query(storage_manager_, &dst);
+    RETURN_NOT_OK(write_query.set_layout(Layout::GLOBAL_ORDER));
+    RETURN_NOT_OK(write_query.set_subarray(&level_subarray[0]));
+
+    std::vector<std::vector<uint8_t>> in(attr_num), out(attr_num);
+    std::vector<uint64_t> in_sizes(attr_num), out_sizes(attr_num);
+    auto flush = [&]() {
+      for (size_t i = 0; i < attr_num; ++i) {
+        out_sizes[i] = out[i].size();
+        RETURN_NOT_OK(write_query.set_buffer(
+            attrs[i]->name(), &out[i][0], &out_sizes[i]));
+      }
+      RETURN_NOT_OK(write_query.submit());
+      for (auto& o : out)
+        o.clear();
+      return Status::Ok();
+    };
+
+    // The tiles of the level are computed in the global order, each from
+    // the window of the previous level it covers
+    std::vector<uint64_t> tile(dim_num, 0), cell(dim_num), window(dim_num);
+    std::vector<uint64_t> strides(dim_num), src_cells;
+    std::vector<T> window_subarray(2 * dim_num);
+    do {
+      uint64_t window_cell_num = 1;
+      for (unsigned d = 0; d < dim_num; ++d) {
+        auto first = 2 * tile[d] * level_ext[d];
+        window[d] = std::min(2 * level_ext[d], src_sizes[d] - first);
+        window_subarray[2 * d] = (T)((uint64_t)dom[2 * d] + first);
+        window_subarray[2 * d + 1] =
+            (T)((uint64_t)dom[2 * d] + first + window[d] - 1);
+        window_cell_num *= window[d];
+      }
+      uint64_t stride = 1;
+      for (unsigned i = 0; i < dim_num; ++i) {
+        auto d = row_major ? dim_num - 1 - i : i;
+        strides[d] = stride;
+        stride *= window[d];
+      }
+
+      Query read_query(storage_manager_, src);
+      RETURN_NOT_OK(read_query.set_layout(
+          row_major ? Layout::ROW_MAJOR : Layout::COL_MAJOR));
+      RETURN_NOT_OK(read_query.set_subarray(&window_subarray[0]));
+      for (size_t i = 0; i < attr_num; ++i) {
+        in[i].resize(window_cell_num * attrs[i]->cell_size());
+        in_sizes[i] = in[i].size();
+        RETURN_NOT_OK(
+            read_query.set_buffer(attrs[i]->name(), &in[i][0], &in_sizes[i]));
+      }
+      RETURN_NOT_OK(read_query.submit());
+      if (read_query.status() != QueryStatus::COMPLETED)
+        return LOG_STATUS(Status::ConsolidatorError(
+            "Cannot build pyramid; Incomplete read of the previous level"));
+
+      // The cells past the end of the previous level are padding
+      std::fill(cell.begin(), cell.end(), 0);
+      do {
+        src_cells.clear();
+        bool padding = false;
+        for (unsigned d = 0; d < dim_num; ++d)
+          padding |= 2 * cell[d] >= window[d];
+        for (uint64_t m = 0; !padding && m < (uint64_t(1) << dim_num); ++m) {
+          uint64_t idx = 0;
+          bool in_window = true;
+          for (unsigned d = 0; d < dim_num && in_window; ++d) {
+            auto c = 2 * cell[d] + ((m >> d) & 1);
+            in_window = c < window[d];
+            idx += c * strides[d];
+          }
+          if (in_window)
+            src_cells.push_back(idx);
+        }
+
+        for (size_t i = 0; i < attr_num; ++i) {
+          auto type = attrs[i]->type();
+          auto cell_size = attrs[i]->cell_size();
+          auto pos = out[i].size();
+          out[i].resize(pos + cell_size);
+          if (padding) {
+            auto value_size = datatype_size(type);
+            for (uint64_t b = 0; b < cell_size; b += value_size)
+              std::memcpy(
+                  &out[i][pos + b], constants::fill_value(type), value_size);
+          } else if (funcs[i] != nullptr) {
+            funcs[i](method, &in[i][0], src_cells, &out[i][pos]);
+          } else {
+            std::memcpy(
+                &out[i][pos], &in[i][src_cells[0] * cell_size], cell_size);
+          }
+        }
+      } while (next_coords(&cell, level_ext, row_major));
+
+      if (out[0].size() >= buffer_size_)
+        RETURN_NOT_OK(flush());
+    } while (next_coords(&tile, tile_num, tile_row_major));
+
+    if (!out[0].empty())
+      RETURN_NOT_OK(flush());
+    return write_query.finalize();
+  };
+
+  auto st = write_level();
+  auto st_close = dst.close();
+  RETURN_NOT_OK(st);
+  return st_close;
+}
+
+Status PyramidBuilder::open(Array* array, bool for_reads) const {
+  return array->open(
+      for_reads ? QueryType::READ : QueryType::WRITE,
+      encryption_type_,
+      encryption_key_.empty() ? nullptr : encryption_key_.data(),
+      (uint32_t)encryption_key_.size());
+}
+
+}  // namespace sm
+}  // namespace tiledb
@@ -0,0 +1,167 @@
+/**
+ * @file   pyramid_builder.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * This file defines class PyramidBuilder.
+ */
+
+#ifndef TILEDB_PYRAMID_BUILDER_H
+#define TILEDB_PYRAMID_BUILDER_H
+
+#include "tiledb/sm/misc/status.h"
+#include "tiledb/sm/misc/uri.h"
+
+#include <string>
+#include <vector>
+
+namespace tiledb {
+namespace sm {
+
+class Array;
+class StorageManager;
+
+enum class EncryptionType : uint8_t;
+
+/**
+ * Builds the pyramid of a dense array: a sequence of downsampled levels,
+ * each halving the resolution of the previous one along every dimension.
+ * Level `l` is a dense array stored at `<array>/__pyramid/<l>`, with the
+ * fixed-sized attributes of the array, whose cell `c` summarizes the cells
+ * `lo + 2 * (c - lo)` and `lo + 2 * (c - lo) + 1` of level `l - 1` along
+ * each dimension (`lo` being the lower domain bound), level `0` being the
+ * array itself. The levels are snapshots of the array when they are built,
+ * so later writes to the array are not reflected until they are rebuilt.
+ */
+class PyramidBuilder {
+ public:
+  /* ********************************* */
+  /*            TYPE DEFINITIONS       */
+  /* ********************************* */
+
+  /** How the cells of a level are computed from the previous level. */
+  enum class Method : uint8_t {
+    /** The mean of the numeric values, rounded for integers. */
+    MEAN,
+    /** The maximum of the numeric values. */
+    MAX,
+    /** The value of the first cell, `lo + 2 * (c - lo)`. */
+    NEAREST
+  };
+
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /**
+   * Constructor.
+   *
+   * @param storage_manager The storage manager.
+   * @param array_uri The URI of the dense array.
+   * @param encryption_type The encryption type of the array.
+   * @param encryption_key The encryption key of the array, or `nullptr`.
+   * @param key_length The length in bytes of the encryption key.
+   * @param buffer_size The size in bytes of the cells of each attribute
+   *     accumulated before they are written to a level.
+   */
+  PyramidBuilder(
+      StorageManager* storage_manager,
+      const URI& array_uri,
+      EncryptionType encryption_type,
+      const void* encryption_key,
+      uint32_t key_length,
+      uint64_t buffer_size);
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /**
+   * Replaces the pyramid of the array with `level_num` levels computed
+   * with the input method. Fewer levels are built if the last one has a
+   * single cell. The numeric attributes with one value per cell are
+   * downsampled with the method and the others with `NEAREST`.
+   *
+   * @param level_num The number of levels, excluding the array itself.
+   * @param method The downsampling method.
+   * @return Status
+   */
+  Status build(uint32_t level_num, Method method);
+
+  /** Returns the URI of the input level of the pyramid of an array. */
+  static URI level_uri(const URI& array_uri, uint32_t level);
+
+  /** Parses a downsampling method (`mean`, `max` or `nearest`). */
+  static Status method_from_str(const std::string& str, Method* method);
+
+ private:
+  /* ********************************* */
+  /*         PRIVATE ATTRIBUTES        */
+  /* ********************************* */
+
+  /** The storage manager. */
+  StorageManager* storage_manager_;
+
+  /** The array URI. */
+  URI array_uri_;
+
+  /** The encryption type of the array. */
+  EncryptionType encryption_type_;
+
+  /** The encryption key of the array. */
+  std::vector<uint8_t> encryption_key_;
+
+  /** The size of the cells of an attribute written per submission. */
+  uint64_t buffer_size_;
+
+  /* ********************************* */
+  /*          PRIVATE METHODS          */
+  /* ********************************* */
+
+  /**
+   * Builds a level from the previous one.
+   *
+   * @tparam T The domain type.
+   * @param src The previous level, open for reads.
+   * @param uri The URI of the new level.
+   * @param method The downsampling method.
+   * @param sizes The number of cells of the previous level along each
+   *     dimension, excluding the padding to the tile extents, updated to
+   *     those of the new level.
+   * @return Status
+   */
+  template <class T>
+  Status build_level(
+      Array* src, const URI& uri, Method method, std::vector<uint64_t>* sizes);
+
+  /** Opens the array at the input URI with the encryption key. */
+  Status open(Array* array, bool for_reads) const;
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_PYRAMID_BUILDER_H
@@ -34,11 +34,21 @@
 #include "tiledb/sm/storage_manager/storage_manager.h"
 #include "tiledb/sm/array/array.h"
 #include "tiledb/sm/array_schema/array_schema.h"
-#include "tiledb/sm/cache/lru_cache.h"
+#include "tiledb/sm/buffer/buffer_pool.h"
+#include "tiledb/sm/buffer/const_buffer.h"
+#include "tiledb/sm/cache/disk_tile_cache.h"
+#include "tiledb/sm/cache/index_cache.h"
+#include "tiledb/sm/cache/fragment_metadata_cache.h"
+#include "tiledb/sm/cache/tile_cache.h"
+#include "tiledb/sm/enums/compressor.h"
+#include "tiledb/sm/enums/encryption_type.h"
 #include "tiledb/sm/enums/layout.h"
 #include "tiledb/sm/enums/object_type.h"
+#include "tiledb/sm/enums/query_status.h"
 #include "tiledb/sm/enums/query_type.h"
 #include "tiledb/sm/filesystem/vfs.h"
+#include "tiledb/sm/filter/compression_filter.h"
+#include "tiledb/sm/filter/filter_pipeline.h"
 #include "tiledb/sm/global_state/global_state.h"
 #include "tiledb/sm/misc/logger.h"
 #include "tiledb/sm/misc/parallel_functions.h"
@@ -49,12 +59,18 @@
 #include "tiledb/sm/rest/rest_client.h"
 #include "tiledb/sm/storage_manager/consolidator.h"
 #include "tiledb/sm/storage_manager/open_array.h"
+#include "tiledb/sm/storage_manager/write_buffer.h"
 #include "tiledb/sm/tile/tile.h"
 #include "tiledb/sm/tile/tile_io.h"
 
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <iostream>
+#include <random>
+#include <set>
 #include <sstream>
+#include <unordered_set>
 
 namespace tiledb {
 namespace sm {
@@ -65,18 +81,51 @@ namespace sm {
 
 StorageManager::StorageManager() {
   tile_cache_ = nullptr;
+  disk_tile_cache_ = nullptr;
+  index_cache_ = nullptr;
+  write_buffer_ = nullptr;
   vfs_ = nullptr;
   cancellation_in_progress_ = false;
   queries_in_progress_ = 0;
+  auto_consolidation_interval_ms_ = 0;
+  auto_consolidation_fragment_num_ = 0;
+  auto_consolidation_stop_ = false;
+  auto_array_metadata_consolidation_num_ = 0;
+  stats_sample_rate_ = 0.0;
+  stats_sample_traces_ = false;
+  slow_query_threshold_ms_ = 0;
+  eager_metadata_load_ = false;
 }
 
 StorageManager::~StorageManager() {
   global_state::GlobalState::GetGlobalState().unregister_storage_manager(this);
 
+  // Stop the background consolidation service
+  if (auto_consolidation_task_.valid()) {
+    {
+      std::lock_guard<std::mutex> lock(auto_consolidation_mtx_);
+      auto_consolidation_stop_ = true;
+    }
+    auto_consolidation_cv_.notify_all();
+    auto_consolidation_task_.wait();
+  }
+
+  // Write the buffered cells while the storage manager is fully functional
+  if (write_buffer_ != nullptr) {
+    write_buffer_->stop();
+    auto st = write_buffer_->flush_all();
+    if (!st.ok())
+      LOG_STATUS(st);
+    delete write_buffer_;
+    write_buffer_ = nullptr;
+  }
+
   if (vfs_ != nullptr)
     cancel_all_tasks();
 
   delete tile_cache_;
+  delete disk_tile_cache_;
+  delete index_cache_;
 
   // Release all filelocks and delete all opened arrays for reads
   for (auto& open_array_it : open_arrays_for_reads_) {
@@ -156,53 +205,63 @@ Status StorageManager::array_close_for_writes(
     const EncryptionKey& encryption_key,
     Metadata* array_metadata) {
   STATS_FUNC_IN(sm_array_close_for_writes);
-  // Lock mutex
-  std::lock_guard<std::mutex> lock{open_array_for_writes_mtx_};
+  {
+    // Lock mutex
+    std::lock_guard<std::mutex> lock{open_array_for_writes_mtx_};
 
-  // Find the open array entry
-  auto it = open_arrays_for_writes_.find(array_uri.to_string());
+    // Find the open array entry
+    auto it = open_arrays_for_writes_.find(array_uri.to_string());
 
-  // Do nothing if array is closed
-  if (it == open_arrays_for_writes_.end()) {
-    return Status::Ok();
-  }
+    // Do nothing if array is closed
+    if (it == open_arrays_for_writes_.end()) {
+      return Status::Ok();
+    }
 
-  // For easy reference
-  OpenArray* open_array = it->second;
+    // For easy reference
+    OpenArray* open_array = it->second;
 
-  // Flush the array metadata
-  RETURN_NOT_OK(
-      store_array_metadata(array_uri, encryption_key, array_metadata));
+    // Flush the array metadata
+    RETURN_NOT_OK(
+        store_array_metadata(array_uri, encryption_key, array_metadata));
 
-  // Lock the mutex of the array and decrement counter
-  open_array->mtx_lock();
-  open_array->cnt_decr();
+    // Lock the mutex of the array and decrement counter
+    open_array->mtx_lock();
+    open_array->cnt_decr();
 
-  // Close the array if the counter reaches 0
-  if (open_array->cnt() == 0) {
-    open_array->mtx_unlock();
-    delete open_array;
-    open_arrays_for_writes_.erase(it);
-  } else {  // Just unlock the array mutex
-    open_array->mtx_unlock();
+    // Close the array if the counter reaches 0
+    if (open_array->cnt() == 0) {
+      open_array->mtx_unlock();
+      delete open_array;
+      open_arrays_for_writes_.erase(it);
+    } else {  // Just unlock the array mutex
+      open_array->mtx_unlock();
+    }
   }
 
+  // Compact the array metadata files once enough have accumulated
+  if (array_metadata != nullptr && array_metadata->num() > 0)
+    RETURN_NOT_OK(auto_consolidate_array_metadata(array_uri, encryption_key));
+
   return Status::Ok();
   STATS_FUNC_OUT(sm_array_close_for_writes);
 }
 
 Status StorageManager::array_open_for_reads(
     const URI& array_uri,
+    uint64_t timestamp_start,
     uint64_t timestamp,
     const EncryptionKey& encryption_key,
     ArraySchema** array_schema,
     std::vector<FragmentMetadata*>* fragment_metadata) {
   STATS_FUNC_IN(sm_array_open_for_reads);
 
-  // Open array without fragments
+  // Open array without fragments, keeping the listing of the array
+  // directory that checks its existence to find the fragments
   auto open_array = (OpenArray*)nullptr;
+  std::vector<URI> array_dir_uris;
   RETURN_NOT_OK_ELSE(
-      array_open_without_fragments(array_uri, encryption_key, &open_array),
+      array_open_without_fragments(
+          array_uri, encryption_key, &open_array, &array_dir_uris),
       *array_schema = nullptr);
 
   // Retrieve array schema
@@ -211,22 +270,24 @@ Status StorageManager::array_open_for_reads(
   // Determine which fragments to load
   std::vector<TimestampedURI> fragments_to_load;
   std::vector<URI> fragment_uris;
-  RETURN_NOT_OK(get_fragment_uris(array_uri, &fragment_uris));
+  RETURN_NOT_OK(get_fragment_uris(
+      array_uri,
+      encryption_key,
+      {timestamp_start, timestamp},
+      &fragment_uris,
+      nullptr,
+      &array_dir_uris));
   RETURN_NOT_OK(get_sorted_uris(fragment_uris, timestamp, &fragments_to_load));
 
   // Get fragment metadata in the case of reads, if not fetched already
   Status st = load_fragment_metadata(
       open_array, encryption_key, fragments_to_load, fragment_metadata);
   if (!st.ok()) {
-    open_array->mtx_unlock();
     array_close_for_reads(array_uri);
     *array_schema = nullptr;
     return st;
   }
 
-  // Unlock the array mutex
-  open_array->mtx_unlock();
-
   // Note that we retain the (shared) lock on the array filelock
   return Status::Ok();
 
@@ -259,15 +320,11 @@ Status StorageManager::array_open_for_reads(
   Status st = load_fragment_metadata(
       open_array, encryption_key, fragments_to_load, fragment_metadata);
   if (!st.ok()) {
-    open_array->mtx_unlock();
     array_close_for_reads(array_uri);
     *array_schema = nullptr;
     return st;
   }
 
-  // Unlock the array mutex
-  open_array->mtx_unlock();
-
   // Note that we retain the (shared) lock on the array filelock
   return Status::Ok();
 
@@ -347,6 +404,8 @@ Status StorageManager::array_open_for_writes(
   // Unlock the array mutex
   open_array->mtx_unlock();
 
+  auto_consolidation_register(array_uri, encryption_key);
+
   return Status::Ok();
 
   STATS_FUNC_OUT(sm_array_open_for_writes);
@@ -354,6 +413,7 @@ Status StorageManager::array_open_for_writes(
 
 Status StorageManager::array_reopen(
     const URI& array_uri,
+    uint64_t timestamp_start,
     uint64_t timestamp,
     const EncryptionKey& encryption_key,
     ArraySchema** array_schema,
@@ -375,22 +435,40 @@ Status StorageManager::array_reopen(
     }
     RETURN_NOT_OK(it->second->set_encryption_key(encryption_key));
     open_array = it->second;
-
-    // Lock the array
-    open_array->mtx_lock();
   }
 
-  // Determine which fragments to load
+  // Determine which fragments to load. Only the new fragments are
+  // checked and loaded from storage.
   std::vector<TimestampedURI> fragments_to_load;
   std::vector<URI> fragment_uris;
-  RETURN_NOT_OK(get_fragment_uris(array_uri, &fragment_uris));
+  RETURN_NOT_OK(get_fragment_uris(
+      array_uri,
+      encryption_key,
+      {timestamp_start, timestamp},
+      &fragment_uris,
+      open_array));
   RETURN_NOT_OK(get_sorted_uris(fragment_uris, timestamp, &fragments_to_load));
 
+  // Release the metadata of the fragments that were removed, unless
+  // another array handle may still refer to them
+  open_array->mtx_lock();
+  if (open_array->cnt() == 1) {
+    std::unordered_set<std::string> listed;
+    for (const auto& uri : fragment_uris)
+      listed.insert(uri.to_string());
+    for (const auto& uri : open_array->fragment_uris()) {
+      if (listed.find(uri.to_string()) == listed.end())
+        open_array->remove_fragment_metadata(uri);
+    }
+  }
+
+  // Unlock the array mutex
+  open_array->mtx_unlock();
+
   // Get fragment metadata in the case of reads, if not fetched already
   auto st = load_fragment_metadata(
       open_array, encryption_key, fragments_to_load, fragment_metadata);
   if (!st.ok()) {
-    open_array->mtx_unlock();
     array_close_for_reads(array_uri);
     *array_schema = nullptr;
     return st;
@@ -399,9 +477,6 @@ Status StorageManager::array_reopen(
   // Get the array schema
   *array_schema = open_array->array_schema();
 
-  // Unlock the mutexes
-  open_array->mtx_unlock();
-
   return st;
 
   STATS_FUNC_OUT(sm_array_reopen);
@@ -412,7 +487,8 @@ Status StorageManager::array_consolidate(
     EncryptionType encryption_type,
     const void* encryption_key,
     uint32_t key_length,
-    const Config* config) {
+    const Config* config,
+    std::string* stats) {
   // Check array URI
   URI array_uri(array_name);
   if (array_uri.is_invalid()) {
@@ -436,8 +512,12 @@ Status StorageManager::array_consolidate(
 
   // Consolidate
   Consolidator consolidator(this);
-  return consolidator.consolidate(
-      array_name, encryption_type, encryption_key, key_length, config);
+  RETURN_NOT_OK(consolidator.consolidate(
+      array_name, encryption_type, encryption_key, key_length, config));
+  if (stats != nullptr)
+    consolidator.dump_stats(stats);
+
+  return Status::Ok();
 }
 
 Status StorageManager::array_metadata_consolidate(
@@ -473,6 +553,69 @@ Status StorageManager::array_metadata_consolidate(
       array_name, encryption_type, encryption_key, key_length, config);
 }
 
+Status StorageManager::fragment_metadata_consolidate(
+    const char* array_name,
+    EncryptionType encryption_type,
+    const void* encryption_key,
+    uint32_t key_length,
+    const Config* config) {
+  // Check array URI
+  URI array_uri(array_name);
+  if (array_uri.is_invalid()) {
+    return LOG_STATUS(Status::StorageManagerError(
+        "Cannot consolidate fragment metadata; Invalid URI"));
+  }
+  // Check if array exists
+  ObjectType obj_type;
+  RETURN_NOT_OK(object_type(array_uri, &obj_type));
+
+  if (obj_type != ObjectType::ARRAY) {
+    return LOG_STATUS(Status::StorageManagerError(
+        "Cannot consolidate fragment metadata; Array does not exist"));
+  }
+
+  // If 'config' is unset, use the 'config_' that was set during initialization
+  // of this StorageManager instance.
+  if (!config) {
+    config = &config_;
+  }
+
+  // Consolidate
+  Consolidator consolidator(this);
+  return consolidator.consolidate_fragment_metadata(
+      array_name, encryption_type, encryption_key, key_length, config);
+}
+
+Status StorageManager::fragment_parts_stitch(
+    const Array* array,
+    const URI& fragment_uri,
+    const std::vector<URI>& part_uris,
+    std::shared_ptr<FragmentMetadata>* new_fragment) {
+  Consolidator consolidator(this);
+  return consolidator.stitch(array, fragment_uri, part_uris, new_fragment);
+}
+
+Status StorageManager::array_vacuum(const char* array_name) {
+  // Check array URI
+  URI array_uri(array_name);
+  if (array_uri.is_invalid()) {
+    return LOG_STATUS(
+        Status::StorageManagerError("Cannot vacuum array; Invalid URI"));
+  }
+  // Check if array exists
+  ObjectType obj_type;
+  RETURN_NOT_OK(object_type(array_uri, &obj_type));
+
+  if (obj_type != ObjectType::ARRAY) {
+    return LOG_STATUS(Status::StorageManagerError(
+        "Cannot vacuum array; Array does not exist"));
+  }
+
+  // Vacuum
+  Consolidator consolidator(this);
+  return consolidator.vacuum(array_name);
+}
+
 Status StorageManager::array_create(
     const URI& array_uri,
     ArraySchema* array_schema,
@@ -670,7 +813,26 @@ Status StorageManager::array_xunlock(const URI& array_uri) {
   return Status::Ok();
 }
 
+Status StorageManager::array_commit_lock(const URI& array_uri, bool* locked) {
+  // Until the first commit creates the manifest, readers list the fragments
+  *locked = false;
+  if (array_manifest_enabled()) {
+    bool has_manifest = false;
+    RETURN_NOT_OK(is_file(
+        array_uri.join_path(constants::array_manifest_filename),
+        &has_manifest));
+    if (has_manifest)
+      return Status::Ok();
+  }
+
+  RETURN_NOT_OK(array_xlock(array_uri));
+  *locked = true;
+
+  return Status::Ok();
+}
+
 Status StorageManager::async_push_query(Query* query) {
+  ThreadPool::PriorityScope priority_scope(query->task_priority());
   cancelable_tasks_.enqueue(
       &async_thread_pool_,
       [this, query]() {
@@ -690,6 +852,56 @@ Status StorageManager::async_push_query(Query* query) {
   return Status::Ok();
 }
 
+Status StorageManager::async_push_query(Query* query, void* completion_tag) {
+  ThreadPool::PriorityScope priority_scope(query->task_priority());
+  cancelable_tasks_.enqueue(
+      &async_thread_pool_,
+      [this, query, completion_tag]() {
+        // Process query. The tag is posted once the query status is final,
+        // so that pollers can inspect it.
+        Status st = query_submit(query);
+        if (!st.ok())
+          LOG_STATUS(st);
+        post_completion(completion_tag);
+        return st;
+      },
+      [this, query, completion_tag]() {
+        // Task was cancelled.
+        query->cancel();
+        post_completion(completion_tag);
+      });
+
+  return Status::Ok();
+}
+
+bool StorageManager::cache_filtered_tiles(const FilterPipeline* filters) const {
+  switch (tile_cache_->mode()) {
+    case TileCache::Mode::UNFILTERED:
+      return false;
+    case TileCache::Mode::FILTERED:
+      return true;
+    default:
+      break;
+  }
+
+  // Cache filtered tiles only if they are compressed, and the decompression
+  // is cheap compared to the capacity it saves. Gzip and bzip2 decompress
+  // too slowly to pay off on every hit.
+  bool compressed = false;
+  for (unsigned i = 0; i < filters->size(); ++i) {
+    auto compression =
+        dynamic_cast<CompressionFilter*>(filters->get_filter(i));
+    if (compression == nullptr)
+      continue;
+    auto compressor = compression->compressor();
+    if (compressor == Compressor::GZIP || compressor == Compressor::BZIP2)
+      return false;
+    compressed |= compressor != Compressor::NO_COMPRESSION;
+  }
+
+  return compressed;
+}
+
 Status StorageManager::cancel_all_tasks() {
   // Check if there is already a "cancellation" in progress.
   bool handle_cancel = false;
@@ -721,15 +933,59 @@ Status StorageManager::cancel_all_tasks() {
   return Status::Ok();
 }
 
-bool StorageManager::cancellation_in_progress() {
-  std::unique_lock<std::mutex> lck(cancellation_in_progress_mtx_);
+bool StorageManager::cancellation_in_progress() const {
   return cancellation_in_progress_;
 }
 
+const std::atomic<bool>* StorageManager::cancellation_flag() const {
+  return &cancellation_in_progress_;
+}
+
 const Config& StorageManager::config() const {
   return config_;
 }
 
+DiskTileCache* StorageManager::disk_tile_cache() const {
+  return disk_tile_cache_;
+}
+
+IndexCache* StorageManager::index_cache() const {
+  return index_cache_;
+}
+
+WriteBuffer* StorageManager::write_buffer() const {
+  return write_buffer_;
+}
+
+bool StorageManager::eager_metadata_load() const {
+  return eager_metadata_load_;
+}
+
+void StorageManager::record_read_attributes(
+    const URI& array_uri, const std::vector<std::string>& attributes) {
+  if (!eager_metadata_load_)
+    return;
+
+  std::lock_guard<std::mutex> lock(read_attributes_mtx_);
+  read_attributes_[array_uri.to_string()].insert(
+      attributes.begin(), attributes.end());
+}
+
+std::vector<std::string> StorageManager::read_attributes(
+    const URI& array_uri) {
+  std::lock_guard<std::mutex> lock(read_attributes_mtx_);
+  auto it = read_attributes_.find(array_uri.to_string());
+  if (it == read_attributes_.end())
+    return {};
+  return std::vector<std::string>(it->second.begin(), it->second.end());
+}
+
+OpenArray* StorageManager::open_array_for_reads(const URI& array_uri) {
+  std::lock_guard<std::mutex> lock{open_array_for_reads_mtx_};
+  auto it = open_arrays_for_reads_.find(array_uri.to_string());
+  return (it == open_arrays_for_reads_.end()) ? nullptr : it->second;
+}
+
 Status StorageManager::create_dir(const URI& uri) {
   return vfs_->create_dir(uri);
 }
@@ -748,6 +1004,45 @@ void StorageManager::decrement_in_progress() {
   queries_in_progress_cv_.notify_all();
 }
 
+Status StorageManager::memory_usage(std::string* json) {
+  uint64_t open_array_num = 0, metadata_size = 0;
+  {
+    std::lock_guard<std::mutex> lock{open_array_for_reads_mtx_};
+    open_array_num = open_arrays_for_reads_.size();
+    for (const auto& it : open_arrays_for_reads_)
+      metadata_size += it.second->memory_size();
+  }
+  uint64_t queries_in_progress = 0;
+  {
+    std::unique_lock<std::mutex> lck(queries_in_progress_mtx_);
+    queries_in_progress = queries_in_progress_;
+  }
+  auto& buffer_pool = BufferPool::global();
+  auto metadata_cache =
+      global_state::GlobalState::GetGlobalState().fragment_metadata_cache();
+
+  std::stringstream ss;
+  ss << "{\n";
+  ss << "  \"tileCache\": " << tile_cache_->size() << ",\n";
+  ss << "  \"indexCache\": "
+     << ((index_cache_ == nullptr) ? 0 : index_cache_->size()) << ",\n";
+  ss << "  \"openArrays\": " << open_array_num << ",\n";
+  ss << "  \"metadata\": " << metadata_size << ",\n";
+  ss << "  \"writeBuffer\": "
+     << ((write_buffer_ == nullptr) ? 0 : write_buffer_->size()) << ",\n";
+  ss << "  \"vfsWriteBuffers\": " << vfs_->write_buffer_size() << ",\n";
+  ss << "  \"queriesInProgress\": " << queries_in_progress << ",\n";
+  ss << "  \"process\": {\n";
+  ss << "    \"buffersInUse\": " << buffer_pool.in_use() << ",\n";
+  ss << "    \"bufferPoolCached\": " << buffer_pool.cached() << ",\n";
+  ss << "    \"fragmentMetadataCache\": " << metadata_cache->size() << "\n";
+  ss << "  }\n";
+  ss << "}";
+  *json = ss.str();
+
+  return Status::Ok();
+}
+
 Status StorageManager::object_remove(const char* path) const {
   auto uri = URI(path);
   if (uri.is_invalid())
@@ -799,6 +1094,7 @@ Status StorageManager::get_fragment_info(
   std::vector<FragmentMetadata*> fragment_metadata;
   RETURN_NOT_OK(array_open_for_reads(
       array_uri,
+      0,
       timestamp,
       encryption_key,
       &array_schema_tmp,
@@ -971,29 +1267,149 @@ Status StorageManager::init(const Config* config) {
   RETURN_NOT_OK(config_.get<uint64_t>(
       "sm.num_writer_threads", &num_writer_threads, &found));
   assert(found);
+  uint64_t num_fragment_metadata_threads = 0;
+  RETURN_NOT_OK(config_.get<uint64_t>(
+      "sm.num_fragment_metadata_threads",
+      &num_fragment_metadata_threads,
+      &found));
+  assert(found);
+  bool numa_pinning = false;
+  RETURN_NOT_OK(config_.get<bool>("sm.numa_pinning", &numa_pinning, &found));
+  assert(found);
   uint64_t tile_cache_size = 0;
   RETURN_NOT_OK(
       config_.get<uint64_t>("sm.tile_cache_size", &tile_cache_size, &found));
   assert(found);
+  uint64_t tile_cache_shards = 0;
+  RETURN_NOT_OK(config_.get<uint64_t>(
+      "sm.tile_cache_shards", &tile_cache_shards, &found));
+  assert(found);
+  TileCache::Policy tile_cache_policy;
+  RETURN_NOT_OK(TileCache::policy_from_str(
+      config_.get("sm.tile_cache_policy", &found), &tile_cache_policy));
+  assert(found);
+  TileCache::Mode tile_cache_mode;
+  RETURN_NOT_OK(TileCache::mode_from_str(
+      config_.get("sm.tile_cache_mode", &found), &tile_cache_mode));
+  assert(found);
+  uint64_t index_cache_size = 0;
+  RETURN_NOT_OK(
+      config_.get<uint64_t>("sm.index_cache_size", &index_cache_size, &found));
+  assert(found);
+  uint64_t buffer_pool_size = 0;
+  RETURN_NOT_OK(
+      config_.get<uint64_t>("sm.buffer_pool_size", &buffer_pool_size, &found));
+  assert(found);
+  bool buffer_pool_huge_pages = false;
+  RETURN_NOT_OK(config_.get<bool>(
+      "sm.buffer_pool_huge_pages", &buffer_pool_huge_pages, &found));
+  assert(found);
+  RETURN_NOT_OK(config_.get<uint64_t>(
+      "sm.consolidation.auto_interval_ms",
+      &auto_consolidation_interval_ms_,
+      &found));
+  assert(found);
+  RETURN_NOT_OK(config_.get<uint64_t>(
+      "sm.consolidation.auto_fragment_num",
+      &auto_consolidation_fragment_num_,
+      &found));
+  assert(found);
+  RETURN_NOT_OK(config_.get<uint64_t>(
+      "sm.consolidation.auto_array_metadata_num",
+      &auto_array_metadata_consolidation_num_,
+      &found));
+  assert(found);
+  RETURN_NOT_OK(config_.get<bool>(
+      "sm.eager_metadata_load", &eager_metadata_load_, &found));
+  assert(found);
+  uint64_t write_buffer_max_size = 0;
+  RETURN_NOT_OK(config_.get<uint64_t>(
+      "sm.write_buffer.max_size", &write_buffer_max_size, &found));
+  assert(found);
+  uint64_t write_buffer_max_age_ms = 0;
+  RETURN_NOT_OK(config_.get<uint64_t>(
+      "sm.write_buffer.max_age_ms", &write_buffer_max_age_ms, &found));
+  assert(found);
+  RETURN_NOT_OK(config_.get<double>(
+      "sm.stats.sample_rate", &stats_sample_rate_, &found));
+  assert(found);
+  RETURN_NOT_OK(config_.get<bool>(
+      "sm.stats.sample_traces", &stats_sample_traces_, &found));
+  assert(found);
+  RETURN_NOT_OK(config_.get<uint64_t>(
+      "sm.stats.slow_query_threshold_ms", &slow_query_threshold_ms_, &found));
+  assert(found);
+  slow_query_log_ = config_.get("sm.stats.slow_query_log", &found);
+  assert(found);
 
-  RETURN_NOT_OK(async_thread_pool_.init(num_async_threads));
-  RETURN_NOT_OK(reader_thread_pool_.init(num_reader_threads));
-  RETURN_NOT_OK(writer_thread_pool_.init(num_writer_threads));
-  tile_cache_ = new LRUCache(tile_cache_size);
+  // Submit all the tasks to the process-wide scheduler if it is enabled
+  auto& global_state = global_state::GlobalState::GetGlobalState();
+  ThreadPool* scheduler = nullptr;
+  RETURN_NOT_OK(global_state.scheduler(config_, &scheduler));
+  if (scheduler != nullptr) {
+    const auto compute = ThreadPool::Priority::COMPUTE;
+    RETURN_NOT_OK(async_thread_pool_.init(scheduler, compute));
+    RETURN_NOT_OK(reader_thread_pool_.init(scheduler, compute));
+    RETURN_NOT_OK(writer_thread_pool_.init(scheduler, compute));
+    RETURN_NOT_OK(fragment_metadata_thread_pool_.init(scheduler, compute));
+  } else {
+    RETURN_NOT_OK(async_thread_pool_.init(num_async_threads));
+    RETURN_NOT_OK(reader_thread_pool_.init(num_reader_threads));
+    RETURN_NOT_OK(writer_thread_pool_.init(num_writer_threads));
+    RETURN_NOT_OK(
+        fragment_metadata_thread_pool_.init(num_fragment_metadata_threads));
+    if (numa_pinning) {
+      RETURN_NOT_OK(async_thread_pool_.pin_numa_nodes());
+      RETURN_NOT_OK(reader_thread_pool_.pin_numa_nodes());
+      RETURN_NOT_OK(writer_thread_pool_.pin_numa_nodes());
+      RETURN_NOT_OK(fragment_metadata_thread_pool_.pin_numa_nodes());
+    }
+  }
+  tile_cache_ = new TileCache(
+      tile_cache_size, tile_cache_shards, tile_cache_policy, tile_cache_mode);
+  if (index_cache_size > 0)
+    index_cache_ = new IndexCache(index_cache_size);
+  BufferPool::global().configure(buffer_pool_size, buffer_pool_huge_pages);
 
   // GlobalState must be initialized before `vfs->init` because S3::init calls
   // GetGlobalState
-  auto& global_state = global_state::GlobalState::GetGlobalState();
   RETURN_NOT_OK(global_state.init(config));
 
   vfs_ = new VFS();
   RETURN_NOT_OK(vfs_->init(&config_, nullptr));
+
+  auto tile_disk_cache_dir = config_.get("sm.tile_disk_cache_dir", &found);
+  assert(found);
+  uint64_t tile_disk_cache_size = 0;
+  RETURN_NOT_OK(config_.get<uint64_t>(
+      "sm.tile_disk_cache_size", &tile_disk_cache_size, &found));
+  assert(found);
+  if (!tile_disk_cache_dir.empty() && tile_disk_cache_size > 0) {
+    disk_tile_cache_ = new DiskTileCache(
+        vfs_, URI(tile_disk_cache_dir), tile_disk_cache_size);
+    RETURN_NOT_OK(disk_tile_cache_->init());
+  }
 #ifdef TILEDB_SERIALIZATION
   RETURN_NOT_OK(init_rest_client());
 #endif
 
   RETURN_NOT_OK(set_default_tags());
 
+  if (write_buffer_max_size > 0) {
+    write_buffer_ = new WriteBuffer(
+        this, write_buffer_max_size, write_buffer_max_age_ms);
+    RETURN_NOT_OK(write_buffer_->init());
+  }
+
+  // Start the background consolidation service
+  if (auto_consolidation_interval_ms_ > 0) {
+    // The tasks the service submits to the other pools are background tasks
+    RETURN_NOT_OK(consolidation_thread_pool_.init(
+        1, ThreadPool::Priority::BACKGROUND));
+    auto_consolidation_task_ = consolidation_thread_pool_.enqueue(
+        [this]() { return auto_consolidate(); });
+  }
+
   global_state.register_storage_manager(this);
 
   STATS_COUNTER_ADD(sm_contexts_created, 1);
@@ -1044,28 +1460,37 @@ Status StorageManager::load_array_schema(
 
   URI schema_uri = array_uri.join_path(constants::array_schema_filename);
 
-  auto tile_io = new TileIO(this, schema_uri);
-  auto tile = (Tile*)nullptr;
-  RETURN_NOT_OK_ELSE(
-      tile_io->read_generic(&tile, 0, encryption_key), delete tile_io);
-  tile->disown_buff();
-  auto buff = tile->buffer();
-  delete tile;
-  delete tile_io;
+  // Check the fragment metadata cache, which also holds array schemas
+  auto cache =
+      global_state::GlobalState::GetGlobalState().fragment_metadata_cache();
+  if (cache->max_size() == 0 ||
+      encryption_key.encryption_type() != EncryptionType::NO_ENCRYPTION)
+    cache = nullptr;
+  auto buff = (cache != nullptr) ? cache->get(schema_uri, 0) :
+                                   std::shared_ptr<const Buffer>();
+
+  if (buff == nullptr) {
+    TileIO tile_io(this, schema_uri);
+    auto tile = (Tile*)nullptr;
+    RETURN_NOT_OK(tile_io.read_generic(&tile, 0, encryption_key));
+    auto tile_buff = std::make_shared<Buffer>();
+    tile->buffer()->swap(*tile_buff);
+    delete tile;
+    if (cache != nullptr)
+      cache->insert(schema_uri, 0, tile_buff);
+    buff = tile_buff;
+  }
 
   // Deserialize
-  auto cbuff = new ConstBuffer(buff);
+  ConstBuffer cbuff(buff->data(), buff->size());
   *array_schema = new ArraySchema();
   (*array_schema)->set_array_uri(array_uri);
-  Status st = (*array_schema)->deserialize(cbuff);
-  delete cbuff;
+  Status st = (*array_schema)->deserialize(&cbuff);
   if (!st.ok()) {
     delete *array_schema;
     *array_schema = nullptr;
   }
 
-  delete buff;
-
   return st;
 }
 
@@ -1157,24 +1582,22 @@ Status StorageManager::object_iter_begin(
         "Cannot create object iterator; Invalid input path"));
   }
 
-  // Get all contents of path
+  // Get the TileDB objects in path
   std::vector<URI> uris;
-  RETURN_NOT_OK(vfs_->ls(path_uri, &uris));
+  std::vector<ObjectType> types;
+  RETURN_NOT_OK(ls_objects(path_uri, &uris, &types));
 
   // Create a new object iterator
   *obj_iter = new ObjectIter();
   (*obj_iter)->order_ = order;
   (*obj_iter)->recursive_ = true;
 
-  // Include the uris that are TileDB objects in the iterator state
-  ObjectType obj_type;
-  for (auto& uri : uris) {
-    RETURN_NOT_OK_ELSE(object_type(uri, &obj_type), delete *obj_iter);
-    if (obj_type != ObjectType::INVALID) {
-      (*obj_iter)->objs_.push_back(uri);
-      if (order == WalkOrder::POSTORDER)
-        (*obj_iter)->expanded_.push_back(false);
-    }
+  // Include the TileDB objects in the iterator state
+  for (size_t i = 0; i < uris.size(); ++i) {
+    (*obj_iter)->objs_.push_back(uris[i]);
+    (*obj_iter)->types_.push_back(types[i]);
+    if (order == WalkOrder::POSTORDER)
+      (*obj_iter)->expanded_.push_back(false);
   }
 
   return Status::Ok();
@@ -1189,22 +1612,19 @@ Status StorageManager::object_iter_begin(
         "Cannot create object iterator; Invalid input path"));
   }
 
-  // Get all contents of path
+  // Get the TileDB objects in path
   std::vector<URI> uris;
-  RETURN_NOT_OK(vfs_->ls(path_uri, &uris));
+  std::vector<ObjectType> types;
+  RETURN_NOT_OK(ls_objects(path_uri, &uris, &types));
 
   // Create a new object iterator
   *obj_iter = new ObjectIter();
   (*obj_iter)->order_ = WalkOrder::PREORDER;
   (*obj_iter)->recursive_ = false;
 
-  // Include the uris that are TileDB objects in the iterator state
-  ObjectType obj_type;
-  for (auto& uri : uris) {
-    RETURN_NOT_OK(object_type(uri, &obj_type));
-    if (obj_type != ObjectType::INVALID)
-      (*obj_iter)->objs_.push_back(uri);
-  }
+  // Include the TileDB objects in the iterator state
+  (*obj_iter)->objs_.assign(uris.begin(), uris.end());
+  (*obj_iter)->types_.assign(types.begin(), types.end());
 
   return Status::Ok();
 }
@@ -1237,36 +1657,34 @@ Status StorageManager::object_iter_next(
 Status StorageManager::object_iter_next_postorder(
     ObjectIter* obj_iter, const char** path, ObjectType* type, bool* has_next) {
   // Get all contents of the next URI recursively till the bottom,
-  // if the front of the list has not been expanded
-  if (obj_iter->expanded_.front() == false) {
-    uint64_t obj_num;
-    do {
-      obj_num = obj_iter->objs_.size();
-      std::vector<URI> uris;
-      RETURN_NOT_OK(vfs_->ls(obj_iter->objs_.front(), &uris));
-      obj_iter->expanded_.front() = true;
-
-      // Push the new TileDB objects in the front of the iterator's list
-      ObjectType obj_type;
-      for (auto it = uris.rbegin(); it != uris.rend(); ++it) {
-        RETURN_NOT_OK(object_type(*it, &obj_type));
-        if (obj_type != ObjectType::INVALID) {
-          obj_iter->objs_.push_front(*it);
-          obj_iter->expanded_.push_front(false);
-        }
-      }
-    } while (obj_num != obj_iter->objs_.size());
+  // if the front of the list has not been expanded. Arrays contain no
+  // TileDB objects, so they are not listed.
+  while (!obj_iter->expanded_.front()) {
+    obj_iter->expanded_.front() = true;
+    if (obj_iter->types_.front() == ObjectType::ARRAY)
+      break;
+
+    std::vector<URI> uris;
+    std::vector<ObjectType> types;
+    RETURN_NOT_OK(ls_objects(obj_iter->objs_.front(), &uris, &types));
+
+    // Push the new TileDB objects in the front of the iterator's list
+    for (size_t i = uris.size(); i-- > 0;) {
+      obj_iter->objs_.push_front(uris[i]);
+      obj_iter->types_.push_front(types[i]);
+      obj_iter->expanded_.push_front(false);
+    }
   }
 
   // Prepare the values to be returned
-  URI front_uri = obj_iter->objs_.front();
-  obj_iter->next_ = front_uri.to_string();
-  RETURN_NOT_OK(object_type(front_uri, type));
+  obj_iter->next_ = obj_iter->objs_.front().to_string();
+  *type = obj_iter->types_.front();
   *path = obj_iter->next_.c_str();
   *has_next = true;
 
   // Pop the front (next URI) of the iterator's object list
   obj_iter->objs_.pop_front();
+  obj_iter->types_.pop_front();
   obj_iter->expanded_.pop_front();
 
   return Status::Ok();
@@ -1277,27 +1695,27 @@ Status StorageManager::object_iter_next_preorder(
   // Prepare the values to be returned
   URI front_uri = obj_iter->objs_.front();
   obj_iter->next_ = front_uri.to_string();
-  RETURN_NOT_OK(object_type(front_uri, type));
+  *type = obj_iter->types_.front();
   *path = obj_iter->next_.c_str();
   *has_next = true;
 
   // Pop the front (next URI) of the iterator's object list
   obj_iter->objs_.pop_front();
+  obj_iter->types_.pop_front();
 
-  // Return if no recursion is needed
-  if (!obj_iter->recursive_)
+  // Return if no recursion is needed. Arrays contain no TileDB objects.
+  if (!obj_iter->recursive_ || *type == ObjectType::ARRAY)
     return Status::Ok();
 
-  // Get all contents of the next URI
+  // Get the TileDB objects in the next URI
   std::vector<URI> uris;
-  RETURN_NOT_OK(vfs_->ls(front_uri, &uris));
+  std::vector<ObjectType> types;
+  RETURN_NOT_OK(ls_objects(front_uri, &uris, &types));
 
   // Push the new TileDB objects in the front of the iterator's list
-  ObjectType obj_type;
-  for (auto it = uris.rbegin(); it != uris.rend(); ++it) {
-    RETURN_NOT_OK(object_type(*it, &obj_type));
-    if (obj_type != ObjectType::INVALID)
-      obj_iter->objs_.push_front(*it);
+  for (size_t i = uris.size(); i-- > 0;) {
+    obj_iter->objs_.push_front(uris[i]);
+    obj_iter->types_.push_front(types[i]);
   }
 
   return Status::Ok();
@@ -1328,8 +1746,18 @@ Status StorageManager::query_submit(Query* query) {
 
   // Process the query
   QueryInProgress in_progress(this);
+  auto start = std::chrono::steady_clock::now();
   auto st = query->process();
 
+  if (slow_query_threshold_ms_ > 0) {
+    uint64_t latency_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count();
+    if (latency_ms >= slow_query_threshold_ms_)
+      log_slow_query(query, latency_ms);
+  }
+
   return st;
 
   STATS_FUNC_OUT(sm_query_submit);
@@ -1340,19 +1768,77 @@ Status StorageManager::query_submit_async(Query* query) {
   return async_push_query(query);
 }
 
+Status StorageManager::query_submit_async(Query* query, void* completion_tag) {
+  // Push the query into the async queue
+  return async_push_query(query, completion_tag);
+}
+
+Status StorageManager::query_submit_batch(const std::vector<Query*>& queries) {
+  if (queries.empty())
+    return Status::Ok();
+  STATS_COUNTER_ADD(sm_query_batch_num_queries, queries.size());
+
+  // The last query is processed on the calling thread while the others run
+  // on the async thread pool
+  std::vector<std::future<Status>> tasks;
+  tasks.reserve(queries.size() - 1);
+  for (size_t i = 0; i < queries.size() - 1; ++i) {
+    auto query = queries[i];
+    ThreadPool::PriorityScope priority_scope(query->task_priority());
+    tasks.push_back(
+        async_thread_pool_.enqueue([query]() { return query->submit(); }));
+  }
+  Status st = queries.back()->submit();
+  Status st_wait = async_thread_pool_.wait_all(tasks);
+
+  return st.ok() ? st_wait : st;
+}
+
+void StorageManager::post_completion(void* completion_tag) {
+  {
+    std::lock_guard<std::mutex> lck(completions_mtx_);
+    completions_.push_back(completion_tag);
+  }
+  completions_cv_.notify_all();
+}
+
+Status StorageManager::poll_completions(
+    void** completion_tags,
+    uint64_t max_completions,
+    int64_t timeout_ms,
+    uint64_t* num_completions) {
+  *num_completions = 0;
+  if (max_completions == 0)
+    return Status::Ok();
+
+  std::unique_lock<std::mutex> lck(completions_mtx_);
+  auto posted = [this]() { return !completions_.empty(); };
+  if (timeout_ms < 0)
+    completions_cv_.wait(lck, posted);
+  else if (timeout_ms > 0)
+    completions_cv_.wait_for(
+        lck, std::chrono::milliseconds(timeout_ms), posted);
+
+  while (*num_completions < max_completions && !completions_.empty()) {
+    completion_tags[(*num_completions)++] = completions_.front();
+    completions_.pop_front();
+  }
+
+  return Status::Ok();
+}
+
 Status StorageManager::read_from_cache(
-    const URI& uri,
-    uint64_t offset,
-    Buffer* buffer,
+    const TileCacheKey& key,
     uint64_t nbytes,
-    bool* in_cache) const {
+    std::shared_ptr<const Buffer>* data) const {
   STATS_FUNC_IN(sm_read_from_cache);
 
-  std::stringstream key;
-  key << uri.to_string() << "+" << offset;
-  RETURN_NOT_OK(tile_cache_->read(key.str(), buffer, 0, nbytes, in_cache));
-  buffer->set_size(nbytes);
-  buffer->reset_offset();
+  RETURN_NOT_OK(tile_cache_->pin(key, data));
+  if (*data != nullptr && (*data)->size() < nbytes) {
+    data->reset();
+    return LOG_STATUS(Status::StorageManagerError(
+        "Cannot read from cache; Cached object is smaller than requested"));
+  }
 
   return Status::Ok();
 
@@ -1373,6 +1859,21 @@ ThreadPool* StorageManager::reader_thread_pool() {
   return &reader_thread_pool_;
 }
 
+bool StorageManager::sample_query_stats() const {
+  if (stats_sample_rate_ <= 0.0)
+    return false;
+  if (stats_sample_rate_ >= 1.0)
+    return true;
+
+  static thread_local std::minstd_rand engine(std::random_device{}());
+  std::uniform_real_distribution<double> dist(0.0, 1.0);
+  return dist(engine) < stats_sample_rate_;
+}
+
+bool StorageManager::sample_query_traces() const {
+  return stats_sample_traces_;
+}
+
 Status StorageManager::set_tag(
     const std::string& key, const std::string& value) {
   tags_[key] = value;
@@ -1419,9 +1920,64 @@ Status StorageManager::store_array_schema(
   delete tile_io;
   delete buff;
 
+  // A previous array with the same URI may have left its schema cached
+  global_state::GlobalState::GetGlobalState()
+      .fragment_metadata_cache()
+      ->invalidate(schema_uri);
+
   return st;
 }
 
+Status StorageManager::store_consolidated_fragment_metadata(
+    const URI& array_uri, const EncryptionKey& encryption_key, Buffer* buff) {
+  return store_generic_tile_atomically(
+      array_uri,
+      constants::consolidated_fragment_metadata_filename,
+      encryption_key,
+      buff);
+}
+
+Status StorageManager::update_array_manifest(
+    const URI& array_uri,
+    const EncryptionKey& encryption_key,
+    const std::vector<URI>& added,
+    const std::vector<URI>& removed) {
+  if (!array_manifest_enabled() || (added.empty() && removed.empty()))
+    return Status::Ok();
+
+  std::lock_guard<std::mutex> lock(array_manifest_mtx_);
+
+  // Start from the current manifest or, if there is none, from a listing
+  bool found = false;
+  std::vector<URI> uris;
+  RETURN_NOT_OK(load_array_manifest(array_uri, encryption_key, &uris, &found));
+  if (!found)
+    RETURN_NOT_OK(get_fragment_uris(
+        array_uri, encryption_key, {0, UINT64_MAX}, &uris));
+
+  // Apply the changes by fragment name
+  std::set<std::string> names;
+  for (const auto& uri : uris)
+    names.insert(uri.remove_trailing_slash().last_path_part());
+  for (const auto& uri : removed)
+    names.erase(uri.remove_trailing_slash().last_path_part());
+  for (const auto& uri : added)
+    names.insert(uri.remove_trailing_slash().last_path_part());
+
+  // Serialize
+  Buffer buff;
+  uint64_t fragment_num = names.size();
+  RETURN_NOT_OK(buff.write(&fragment_num, sizeof(uint64_t)));
+  for (const auto& name : names) {
+    uint64_t name_size = name.size();
+    RETURN_NOT_OK(buff.write(&name_size, sizeof(uint64_t)));
+    RETURN_NOT_OK(buff.write(name.data(), name_size));
+  }
+
+  return store_generic_tile_atomically(
+      array_uri, constants::array_manifest_filename, encryption_key, &buff);
+}
+
 Status StorageManager::store_array_metadata(
     const URI& array_uri,
     const EncryptionKey& encryption_key,
@@ -1498,32 +2054,19 @@ Status StorageManager::init_rest_client() {
 }
 
 Status StorageManager::write_to_cache(
-    const URI& uri, uint64_t offset, Buffer* buffer) const {
+    const TileCacheKey& key, Buffer* buffer) const {
   STATS_FUNC_IN(sm_write_to_cache);
 
-  // Do nothing if the object size is larger than the cache size
+  // Do nothing if the object size is larger than a cache shard
   uint64_t object_size = buffer->size();
-  if (object_size > tile_cache_->max_size())
+  if (object_size > tile_cache_->max_object_size())
     return Status::Ok();
 
-  // Do not write metadata to cache
-  std::string filename = uri.last_path_part();
-  if (filename == constants::fragment_metadata_filename ||
-      filename == constants::array_schema_filename) {
-    return Status::Ok();
-  }
-
-  // Generate key (uri + offset)
-  std::stringstream key;
-  key << uri.to_string() << "+" << offset;
-
-  // Insert to cache
-  void* object = std::malloc(object_size);
-  if (object == nullptr)
-    return LOG_STATUS(Status::StorageManagerError(
-        "Cannot write to cache; Object memory allocation failed"));
-  std::memcpy(object, buffer->data(), object_size);
-  RETURN_NOT_OK(tile_cache_->insert(key.str(), object, object_size, false));
+  // Insert a private copy to the cache, as the input buffer may not own its
+  // data (e.g., it may point into a memory-mapped file)
+  auto object = std::make_shared<Buffer>();
+  RETURN_NOT_OK(object->write(buffer->data(), object_size));
+  RETURN_NOT_OK(tile_cache_->insert(key, object, false));
 
   return Status::Ok();
 
@@ -1571,14 +2114,26 @@ void StorageManager::array_get_non_empty_domain(
 Status StorageManager::array_open_without_fragments(
     const URI& array_uri,
     const EncryptionKey& encryption_key,
-    OpenArray** open_array) {
+    OpenArray** open_array,
+    std::vector<URI>* array_dir_uris) {
   if (!vfs_->supports_uri_scheme(array_uri))
     return LOG_STATUS(Status::StorageManagerError(
         "Cannot open array; URI scheme unsupported."));
 
   // Check if array exists
-  ObjectType obj_type;
-  RETURN_NOT_OK(this->object_type(array_uri, &obj_type));
+  ObjectType obj_type = ObjectType::INVALID;
+  if (array_dir_uris != nullptr) {
+    RETURN_NOT_OK(ls_array_dir(array_uri, array_dir_uris));
+    for (const auto& uri : *array_dir_uris) {
+      if (uri.remove_trailing_slash().last_path_part() ==
+          constants::array_schema_filename) {
+        obj_type = ObjectType::ARRAY;
+        break;
+      }
+    }
+  } else {
+    RETURN_NOT_OK(this->object_type(array_uri, &obj_type));
+  }
   if (obj_type != ObjectType::ARRAY) {
     return LOG_STATUS(
         Status::StorageManagerError("Cannot open array; Array does not exist"));
@@ -1606,8 +2161,15 @@ Status StorageManager::array_open_without_fragments(
     (*open_array)->cnt_incr();
   }
 
-  // Acquire a shared filelock
-  auto st = (*open_array)->file_lock(vfs_);
+  // Acquire a shared filelock, unless reads are configured to rely on the
+  // immutability of fragments
+  bool found = false;
+  bool read_filelocks = true;
+  auto st = config_.get<bool>(
+      "vfs.file.enable_read_filelocks", &read_filelocks, &found);
+  assert(found);
+  if (st.ok() && read_filelocks)
+    st = (*open_array)->file_lock(vfs_);
   if (!st.ok()) {
     (*open_array)->mtx_unlock();
     array_close_for_reads(array_uri);
@@ -1624,29 +2186,256 @@ Status StorageManager::array_open_without_fragments(
     }
   }
 
+  // Unlock the array mutex, the fragment metadata are loaded under it only
+  // if they are missing
+  (*open_array)->mtx_unlock();
+
   return Status::Ok();
 }
 
+Status StorageManager::auto_consolidate() {
+  std::unique_lock<std::mutex> lck(auto_consolidation_mtx_);
+  while (!auto_consolidation_stop_) {
+    auto_consolidation_cv_.wait_for(
+        lck,
+        std::chrono::milliseconds(auto_consolidation_interval_ms_),
+        [this]() { return auto_consolidation_stop_; });
+    if (auto_consolidation_stop_ || auto_consolidation_arrays_.empty())
+      continue;
+
+    // Visit the registered arrays in turn, one per period
+    auto it = auto_consolidation_arrays_.upper_bound(
+        auto_consolidation_last_uri_);
+    if (it == auto_consolidation_arrays_.end())
+      it = auto_consolidation_arrays_.begin();
+    auto array_uri = it->first;
+    auto array = it->second;
+    auto_consolidation_last_uri_ = array_uri;
+
+    lck.unlock();
+    auto st = auto_consolidate_array(array_uri, array);
+    if (!st.ok())
+      LOG_STATUS(st);
+    lck.lock();
+  }
+
+  return Status::Ok();
+}
+
+Status StorageManager::auto_consolidate_array(
+    const std::string& array_uri, const AutoConsolidationArray& array) {
+  // Yield to the foreground queries and readers of the array, which
+  // consolidation would otherwise slow down or wait for
+  {
+    std::lock_guard<std::mutex> lock(queries_in_progress_mtx_);
+    if (queries_in_progress_ > 0)
+      return Status::Ok();
+  }
+  {
+    std::lock_guard<std::mutex> lock(open_array_for_reads_mtx_);
+    if (open_arrays_for_reads_.count(array_uri) > 0)
+      return Status::Ok();
+  }
+
+  // Delete the fragments superseded by earlier visits
+  RETURN_NOT_OK(array_vacuum(array_uri.c_str()));
+
+  auto key = array.encryption_key_.empty() ?
+                 nullptr :
+                 (const void*)array.encryption_key_.data();
+  auto key_length = (uint32_t)array.encryption_key_.size();
+  EncryptionKey encryption_key;
+  RETURN_NOT_OK(
+      encryption_key.set_key(array.encryption_type_, key, key_length));
+  std::vector<URI> fragment_uris;
+  RETURN_NOT_OK(get_fragment_uris(
+      URI(array_uri), encryption_key, {0, UINT64_MAX}, &fragment_uris));
+  if (fragment_uris.size() < auto_consolidation_fragment_num_)
+    return Status::Ok();
+
+  // A single step per period bounds the work taken from foreground queries
+  Config config = config_;
+  RETURN_NOT_OK(config.set("sm.consolidation.steps", "1"));
+  return array_consolidate(
+      array_uri.c_str(), array.encryption_type_, key, key_length, &config);
+}
+
+Status StorageManager::auto_consolidate_array_metadata(
+    const URI& array_uri, const EncryptionKey& encryption_key) {
+  if (auto_array_metadata_consolidation_num_ == 0)
+    return Status::Ok();
+
+  std::vector<URI> uris;
+  RETURN_NOT_OK(get_array_metadata_uris(array_uri, &uris));
+  if (uris.size() < auto_array_metadata_consolidation_num_)
+    return Status::Ok();
+
+  // The consolidation closes the array for writes with the consolidated
+  // metadata, which must not trigger another consolidation
+  {
+    std::lock_guard<std::mutex> lock(auto_array_metadata_consolidations_mtx_);
+    if (!auto_array_metadata_consolidations_.insert(array_uri.to_string())
+             .second)
+      return Status::Ok();
+  }
+
+  auto key = encryption_key.key();
+  auto st = array_metadata_consolidate(
+      array_uri.c_str(),
+      encryption_key.encryption_type(),
+      key.data(),
+      (uint32_t)key.size(),
+      nullptr);
+
+  std::lock_guard<std::mutex> lock(auto_array_metadata_consolidations_mtx_);
+  auto_array_metadata_consolidations_.erase(array_uri.to_string());
+
+  return st;
+}
+
+void StorageManager::auto_consolidation_register(
+    const URI& array_uri, const EncryptionKey& encryption_key) {
+  // Scratch arrays, whose names start with a dot, are transient
+  if (auto_consolidation_interval_ms_ == 0 ||
+      utils::parse::starts_with(array_uri.last_path_part(), "."))
+    return;
+
+  auto key = encryption_key.key();
+  AutoConsolidationArray array;
+  array.encryption_type_ = encryption_key.encryption_type();
+  array.encryption_key_.assign((const char*)key.data(), key.size());
+
+  std::lock_guard<std::mutex> lock(auto_consolidation_mtx_);
+  auto_consolidation_arrays_[array_uri.to_string()] = array;
+}
+
 Status StorageManager::get_fragment_uris(
-    const URI& array_uri, std::vector<URI>* fragment_uris) const {
+    const URI& array_uri,
+    const EncryptionKey& encryption_key,
+    const std::pair<uint64_t, uint64_t>& timestamp_range,
+    std::vector<URI>* fragment_uris,
+    const OpenArray* open_array,
+    const std::vector<URI>* array_dir_uris) {
+  // The fragments in the manifest are committed, so they need no check
+  auto in_range = [&](const URI& uri, const std::string& name, bool* in) {
+    uint32_t f_version;
+    RETURN_NOT_OK(utils::parse::get_fragment_name_version(uri, &f_version));
+    auto t = utils::parse::get_timestamp_range(f_version, name);
+    *in = t.first <= timestamp_range.second &&
+          t.second >= timestamp_range.first;
+    return Status::Ok();
+  };
+  if (array_manifest_enabled()) {
+    bool found = false;
+    std::vector<URI> uris;
+    RETURN_NOT_OK(
+        load_array_manifest(array_uri, encryption_key, &uris, &found));
+    if (found) {
+      for (auto& uri : uris) {
+        bool in = false;
+        RETURN_NOT_OK(in_range(uri, uri.last_path_part(), &in));
+        if (in)
+          fragment_uris->push_back(uri);
+      }
+      return Status::Ok();
+    }
+  }
+
   // Get all uris in the array directory
-  std::vector<URI> uris;
-  RETURN_NOT_OK(vfs_->ls(array_uri.add_trailing_slash(), &uris));
+  std::vector<URI> listed_uris;
+  if (array_dir_uris == nullptr) {
+    RETURN_NOT_OK(ls_array_dir(array_uri, &listed_uris));
+    array_dir_uris = &listed_uris;
+  }
 
-  // Get only the fragment uris
+  // Get only the fragment uris, checking the candidates in storage in
+  // parallel
   bool exists;
-  for (auto& uri : uris) {
-    if (utils::parse::starts_with(uri.last_path_part(), "."))
+  std::vector<URI> candidates;
+  std::vector<uint8_t> known;
+  for (auto& uri : *array_dir_uris) {
+    auto name = uri.remove_trailing_slash().last_path_part();
+    if (utils::parse::starts_with(name, ".") ||
+        utils::parse::ends_with(name, constants::vacuum_file_suffix) ||
+        name == constants::consolidated_fragment_metadata_filename ||
+        name == constants::array_manifest_filename ||
+        name == constants::array_schema_filename ||
+        name == constants::array_metadata_folder_name ||
+        name == constants::pyramid_folder_name ||
+        name == constants::filelock_name)
       continue;
 
-    RETURN_NOT_OK(is_fragment(uri, &exists));
-    if (exists)
-      fragment_uris->push_back(uri);
+    // Skip the fragments outside the timestamp range
+    if (utils::parse::starts_with(name, "__")) {
+      RETURN_NOT_OK(in_range(uri, name, &exists));
+      if (!exists)
+        continue;
+    }
+
+    candidates.push_back(uri);
+    known.push_back(
+        open_array != nullptr &&
+        open_array->fragment_metadata(uri) != nullptr);
+  }
+  std::vector<uint8_t> is_frag(candidates.size(), 0);
+  auto statuses = parallel_for(0, candidates.size(), [&](uint64_t i) {
+    if (known[i]) {
+      is_frag[i] = 1;
+      return Status::Ok();
+    }
+    bool frag = false;
+    RETURN_NOT_OK(is_fragment(candidates[i], &frag));
+    is_frag[i] = frag;
+    return Status::Ok();
+  });
+  for (const auto& st : statuses)
+    RETURN_NOT_OK(st);
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    if (is_frag[i])
+      fragment_uris->push_back(candidates[i]);
   }
 
   return Status::Ok();
 }
 
+Status StorageManager::ls_array_dir(
+    const URI& array_uri, std::vector<URI>* uris) const {
+  // Listing a non-directory is an error except on S3
+  if (!array_uri.is_s3()) {
+    bool is_dir = false;
+    RETURN_NOT_OK(vfs_->is_dir(array_uri, &is_dir));
+    if (!is_dir)
+      return Status::Ok();
+  }
+
+  // Fragment names start with `__<timestamp>_`, so a long listing can be
+  // split on timestamp ranges between the last listed fragment and now
+  auto shard_boundaries = [](const std::string& last, uint64_t shard_num) {
+    std::vector<std::string> boundaries;
+    if (!utils::parse::starts_with(last, "__"))
+      return boundaries;
+    auto digits = last.find_first_not_of("0123456789", 2);
+    if (digits == std::string::npos || digits == 2)
+      return boundaries;
+    digits -= 2;
+
+    uint64_t now = utils::time::timestamp_now_ms();
+    if (std::to_string(now).size() != digits)
+      return boundaries;
+    uint64_t first = std::stoull(last.substr(2, digits));
+    if (now <= first)
+      return boundaries;
+    for (uint64_t i = 1; i < shard_num; ++i)
+      boundaries.push_back(
+          "__" + std::to_string(first + (now - first) * i / shard_num));
+    return boundaries;
+  };
+  RETURN_NOT_OK(vfs_->ls_sharded(
+      array_uri.add_trailing_slash(), uris, shard_boundaries));
+
+  return Status::Ok();
+}
+
 Status StorageManager::get_array_metadata_uris(
     const URI& array_uri, std::vector<URI>* array_metadata_uris) const {
   // Get all uris in the array metadata directory
@@ -1673,6 +2462,41 @@ Status StorageManager::get_array_metadata_uris(
   return Status::Ok();
 }
 
+void StorageManager::log_slow_query(const Query* query, uint64_t latency_ms) {
+  std::stringstream ss;
+  ss << "{ \"array\": \"";
+  for (auto c : query->array()->array_uri().to_string()) {
+    if (c == '"' || c == '\\')
+      ss << '\\';
+    ss << c;
+  }
+  ss << "\", \"type\": \"" << query_type_str(query->type()) << "\", ";
+  ss << "\"status\": \"" << query_status_str(query->status()) << "\", ";
+  ss << "\"latency_ms\": " << latency_ms << ", \"stats\": ";
+  std::string stats;
+  if (query->has_stats() && query->stats(&stats).ok()) {
+    // Each query takes a single line
+    std::replace(stats.begin(), stats.end(), '\n', ' ');
+    ss << stats;
+  } else {
+    ss << "null";
+  }
+  ss << " }\n";
+
+  std::unique_lock<std::mutex> lck(slow_query_log_mtx_);
+  if (slow_query_log_.empty()) {
+    fputs(ss.str().c_str(), stderr);
+    return;
+  }
+  FILE* out = fopen(slow_query_log_.c_str(), "a");
+  if (out == nullptr) {
+    LOG_ERROR("Cannot append to slow query log '" + slow_query_log_ + "'");
+    return;
+  }
+  fputs(ss.str().c_str(), out);
+  fclose(out);
+}
+
 Status StorageManager::load_array_schema(
     const URI& array_uri,
     OpenArray* open_array,
@@ -1728,16 +2552,192 @@ Status StorageManager::load_array_metadata(
   return Status::Ok();
 }
 
+// ===== FORMAT =====
+// fragment_num (uint64_t)
+// fragment_name_size#0 (uint64_t)
+// fragment_name#0 (char[])
+// entry_size#0 (uint64_t)
+// entry#0 (uint8_t[]) - see FragmentMetadata::load_consolidated
+// ...
+Status StorageManager::load_consolidated_fragment_metadata(
+    const URI& array_uri,
+    const EncryptionKey& encryption_key,
+    std::shared_ptr<Buffer>* buff,
+    std::unordered_map<std::string, ConstBuffer>* entries) {
+  URI uri =
+      array_uri.join_path(constants::consolidated_fragment_metadata_filename);
+  bool exists;
+  RETURN_NOT_OK(is_file(uri, &exists));
+  if (!exists)
+    return Status::Ok();
+
+  // Read the file
+  TileIO tile_io(this, uri);
+  auto tile = (Tile*)nullptr;
+  RETURN_NOT_OK(tile_io.read_generic(&tile, 0, encryption_key));
+  *buff = std::make_shared<Buffer>();
+  tile->buffer()->swap(**buff);
+  delete tile;
+
+  // Index the fragment entries
+  ConstBuffer cbuff((*buff)->data(), (*buff)->size());
+  uint64_t fragment_num;
+  RETURN_NOT_OK(cbuff.read(&fragment_num, sizeof(uint64_t)));
+  for (uint64_t f = 0; f < fragment_num; ++f) {
+    uint64_t name_size, entry_size;
+    RETURN_NOT_OK(cbuff.read(&name_size, sizeof(uint64_t)));
+    std::string name(name_size, '\0');
+    RETURN_NOT_OK(cbuff.read(&name[0], name_size));
+    RETURN_NOT_OK(cbuff.read(&entry_size, sizeof(uint64_t)));
+    if (cbuff.nbytes_left_to_read() < entry_size)
+      return LOG_STATUS(Status::StorageManagerError(
+          "Cannot load consolidated fragment metadata; Invalid entry size"));
+    entries->emplace(name, ConstBuffer(cbuff.cur_data(), entry_size));
+    cbuff.advance_offset(entry_size);
+  }
+
+  return Status::Ok();
+}
+
+bool StorageManager::array_manifest_enabled() const {
+  bool enabled = false, found = false;
+  auto st = config_.get<bool>("sm.array_manifest", &enabled, &found);
+  return st.ok() && found && enabled;
+}
+
+Status StorageManager::load_array_manifest(
+    const URI& array_uri,
+    const EncryptionKey& encryption_key,
+    std::vector<URI>* fragment_uris,
+    bool* found) {
+  URI uri = array_uri.join_path(constants::array_manifest_filename);
+  RETURN_NOT_OK(is_file(uri, found));
+  if (!*found)
+    return Status::Ok();
+
+  // Read the file
+  TileIO tile_io(this, uri);
+  auto tile = (Tile*)nullptr;
+  RETURN_NOT_OK(tile_io.read_generic(&tile, 0, encryption_key));
+  Buffer buff;
+  tile->buffer()->swap(buff);
+  delete tile;
+
+  // Get the fragment URIs
+  ConstBuffer cbuff(buff.data(), buff.size());
+  uint64_t fragment_num;
+  RETURN_NOT_OK(cbuff.read(&fragment_num, sizeof(uint64_t)));
+  fragment_uris->reserve(fragment_num);
+  for (uint64_t f = 0; f < fragment_num; ++f) {
+    uint64_t name_size;
+    RETURN_NOT_OK(cbuff.read(&name_size, sizeof(uint64_t)));
+    if (cbuff.nbytes_left_to_read() < name_size)
+      return LOG_STATUS(Status::StorageManagerError(
+          "Cannot load array manifest; Invalid fragment name size"));
+    std::string name(name_size, '\0');
+    RETURN_NOT_OK(cbuff.read(&name[0], name_size));
+    fragment_uris->emplace_back(array_uri.join_path(name));
+  }
+
+  return Status::Ok();
+}
+
+Status StorageManager::store_generic_tile_atomically(
+    const URI& array_uri,
+    const std::string& filename,
+    const EncryptionKey& encryption_key,
+    Buffer* buff) {
+  URI uri = array_uri.join_path(filename);
+
+  // Write to a hidden temporary file first, so that readers never see a
+  // partially written file
+  std::string uuid;
+  RETURN_NOT_OK(uuid::generate_uuid(&uuid, false));
+  URI tmp_uri = array_uri.join_path("." + filename + "." + uuid);
+  buff->reset_offset();
+  Tile tile(
+      constants::generic_tile_datatype,
+      constants::generic_tile_cell_size,
+      0,
+      buff,
+      false);
+  TileIO tile_io(this, tmp_uri);
+  uint64_t nbytes;
+  RETURN_NOT_OK(tile_io.write_generic(&tile, encryption_key, &nbytes));
+  RETURN_NOT_OK(close_file(tmp_uri));
+
+  // Replace the previous file
+  bool exists;
+  RETURN_NOT_OK(is_file(uri, &exists));
+  if (exists)
+    RETURN_NOT_OK(vfs_->remove_file(uri));
+  return vfs_->move_file(tmp_uri, uri);
+}
+
 Status StorageManager::load_fragment_metadata(
     OpenArray* open_array,
     const EncryptionKey& encryption_key,
     const std::vector<TimestampedURI>& fragments_to_load,
     std::vector<FragmentMetadata*>* fragment_metadata) {
+  // Look up the fragment metadata that are already loaded without locking
+  // the array, so that reopening an array whose fragments are all loaded
+  // does not wait for other threads opening it
+  auto fragment_num = fragments_to_load.size();
+  fragment_metadata->resize(fragment_num);
+  bool all_loaded = true;
+  for (size_t f = 0; f < fragment_num; ++f) {
+    auto metadata = open_array->fragment_metadata(fragments_to_load[f].uri_);
+    (*fragment_metadata)[f] = metadata;
+    all_loaded = all_loaded && metadata != nullptr;
+  }
+
+  // Lock the array otherwise, so that each fragment is loaded only once
+  if (!all_loaded) {
+    open_array->mtx_lock();
+    auto st = load_missing_fragment_metadata(
+        open_array, encryption_key, fragments_to_load, fragment_metadata);
+    open_array->mtx_unlock();
+    RETURN_NOT_OK(st);
+  }
+
+  STATS_COUNTER_ADD(fragment_metadata_num_fragments, fragment_num);
+
+  return Status::Ok();
+}
+
+Status StorageManager::load_missing_fragment_metadata(
+    OpenArray* open_array,
+    const EncryptionKey& encryption_key,
+    const std::vector<TimestampedURI>& fragments_to_load,
+    std::vector<FragmentMetadata*>* fragment_metadata) {
+  // When several fragments need loading, fetch the consolidated fragment
+  // metadata with a single request. Only the fragments missing from it (e.g.,
+  // written after the consolidation) are then loaded individually.
+  uint64_t num_to_load = 0;
+  for (const auto& sf : fragments_to_load)
+    num_to_load += (open_array->fragment_metadata(sf.uri_) == nullptr);
+  std::shared_ptr<Buffer> consolidated;
+  std::unordered_map<std::string, ConstBuffer> consolidated_entries;
+  if (num_to_load > 1)
+    RETURN_NOT_OK(load_consolidated_fragment_metadata(
+        open_array->array_uri(),
+        encryption_key,
+        &consolidated,
+        &consolidated_entries));
+
+  // Small metadata files are fetched with a single read
+  bool found = false;
+  uint64_t speculative_read_size = 0;
+  RETURN_NOT_OK(config_.get<uint64_t>(
+      "sm.fragment_metadata_speculative_read_size",
+      &speculative_read_size,
+      &found));
+  assert(found);
+
   // Load the metadata for each fragment, only if they are not already loaded
   auto fragment_num = fragments_to_load.size();
   fragment_metadata->resize(fragment_num);
-  uint32_t f_version;
-  auto statuses = parallel_for(0, fragment_num, [&](size_t f) {
+  auto load_fn = [&](size_t f) {
     const auto& sf = fragments_to_load[f];
     auto array_schema = open_array->array_schema();
     auto metadata = open_array->fragment_metadata(sf.uri_);
@@ -1745,6 +2745,7 @@ Status StorageManager::load_fragment_metadata(
       URI coords_uri =
           sf.uri_.join_path(constants::coords + constants::file_suffix);
 
+      uint32_t f_version;
       RETURN_NOT_OK(
           utils::parse::get_fragment_name_version(sf.uri_, &f_version));
 
@@ -1761,16 +2762,65 @@ Status StorageManager::load_fragment_metadata(
             this, array_schema, sf.uri_, sf.timestamp_range_);
       }
 
-      RETURN_NOT_OK_ELSE(metadata->load(encryption_key), delete metadata);
+      auto entry = consolidated_entries.find(
+          sf.uri_.remove_trailing_slash().last_path_part());
+      if (entry != consolidated_entries.end()) {
+        ConstBuffer entry_buff = entry->second;
+        RETURN_NOT_OK_ELSE(
+            metadata->load_consolidated(&entry_buff), delete metadata);
+      } else {
+        RETURN_NOT_OK_ELSE(
+            metadata->load(encryption_key, speculative_read_size),
+            delete metadata);
+      }
       open_array->insert_fragment_metadata(metadata);
     }
     (*fragment_metadata)[f] = metadata;
     return Status::Ok();
-  });
+  };
+
+  // Use the dedicated pool if configured, so that the number of concurrent
+  // metadata requests is bounded independently of the TBB threads
+  std::vector<Status> statuses;
+  if (fragment_metadata_thread_pool_.num_threads() > 0 && num_to_load > 1) {
+    std::vector<std::future<Status>> tasks;
+    tasks.reserve(fragment_num);
+    for (size_t f = 0; f < fragment_num; ++f)
+      tasks.push_back(fragment_metadata_thread_pool_.enqueue(
+          [&load_fn, f]() { return load_fn(f); }));
+    statuses = fragment_metadata_thread_pool_.wait_all_status(tasks);
+  } else {
+    statuses = parallel_for(0, fragment_num, load_fn);
+  }
   for (auto st : statuses)
     RETURN_NOT_OK(st);
 
-  STATS_COUNTER_ADD(fragment_metadata_num_fragments, fragment_num);
+  return Status::Ok();
+}
+
+Status StorageManager::ls_objects(
+    const URI& uri,
+    std::vector<URI>* obj_uris,
+    std::vector<ObjectType>* obj_types) const {
+  std::vector<URI> uris;
+  RETURN_NOT_OK(vfs_->ls(uri, &uris));
+
+  // Probe the contents concurrently, since each probe lists the content
+  std::vector<ObjectType> types(uris.size());
+  auto statuses = parallel_for(0, uris.size(), [&](uint64_t i) {
+    return object_type(uris[i], &types[i]);
+  });
+  for (const auto& st : statuses)
+    RETURN_NOT_OK(st);
+
+  obj_uris->clear();
+  obj_types->clear();
+  for (size_t i = 0; i < uris.size(); ++i) {
+    if (types[i] != ObjectType::INVALID) {
+      obj_uris->push_back(uris[i]);
+      obj_types->push_back(types[i]);
+    }
+  }
 
   return Status::Ok();
 }
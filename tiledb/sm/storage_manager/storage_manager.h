@@ -34,12 +34,16 @@
 #ifndef TILEDB_STORAGE_MANAGER_H
 #define TILEDB_STORAGE_MANAGER_H
 
+#include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <functional>
 #include <list>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <queue>
+#include <set>
 #include <string>
 #include <thread>
 #include <unordered_map>
@@ -60,14 +64,21 @@ class Array;
 class ArraySchema;
 class Buffer;
 class Consolidator;
+class ConstBuffer;
+class DiskTileCache;
+class IndexCache;
 class EncryptionKey;
+class FilterPipeline;
 class FragmentMetadata;
-class LRUCache;
 class Metadata;
 class OpenArray;
 class Query;
 class RestClient;
+class TileCache;
 class VFS;
+class WriteBuffer;
+
+struct TileCacheKey;
 
 enum class EncryptionType : uint8_t;
 enum class ObjectType : uint8_t;
@@ -93,6 +104,8 @@ class StorageManager {
     std::string next_;
     /** The next objects to be visited. */
     std::list<URI> objs_;
+    /** The types of the objects in `objs_`, one-to-one. */
+    std::list<ObjectType> types_;
     /** The traversal order of the iterator. */
     WalkOrder order_;
     /** `True` if the iterator will recursively visit the directory tree. */
@@ -122,7 +135,9 @@ class StorageManager {
   Status array_close_for_reads(const URI& array_uri);
 
   /**
-   * Closes an array opened for writes.
+   * Closes an array opened for writes. If the array metadata is flushed
+   * and the array has at least `sm.consolidation.auto_array_metadata_num`
+   * metadata files, they are consolidated.
    *
    * @param array_uri The array URI
    * @param encryption_key The array encryption key.
@@ -137,9 +152,13 @@ class StorageManager {
 
   /**
    * Opens an array for reads at a timestamp. All the metadata of the
-   * fragments created before or at the input timestamp are retrieved.
+   * fragments created before or at the input timestamp, whose timestamp
+   * range ends at or after `timestamp_start`, are retrieved. Fragments
+   * outside this range are pruned by name, without accessing storage.
    *
    * @param array_uri The array URI.
+   * @param timestamp_start Fragments whose timestamp range ends before
+   *     this timestamp are ignored.
    * @param timestamp The timestamp at which the array will be opened.
    *     In TileDB, timestamps are in ms elapsed since
    *     1970-01-01 00:00:00 +0000 (UTC).
@@ -152,6 +171,7 @@ class StorageManager {
    */
   Status array_open_for_reads(
       const URI& array_uri,
+      uint64_t timestamp_start,
       uint64_t timestamp,
       const EncryptionKey& encryption_key,
       ArraySchema** array_schema,
@@ -193,9 +213,14 @@ class StorageManager {
   /**
    * Reopens an already open array at a potentially new timestamp,
    * retrieving the fragment metadata of any new fragments written
-   * in the array.
+   * in the array. Only the metadata of fragments that were not loaded
+   * before are read. If no other handle has the array open, the metadata
+   * of fragments that no longer exist (e.g., after consolidation) are
+   * released, so no query on the array may still be in progress.
    *
    * @param array_uri The array URI.
+   * @param timestamp_start Fragments whose timestamp range ends before
+   *     this timestamp are ignored.
    * @param timestamp The timestamp at which the array will be opened.
    *     In TileDB, timestamps are in ms elapsed since
    *     1970-01-01 00:00:00 +0000 (UTC).
@@ -208,6 +233,7 @@ class StorageManager {
    */
   Status array_reopen(
       const URI& array_uri,
+      uint64_t timestamp_start,
       uint64_t timestamp,
       const EncryptionKey& encryption_key,
       ArraySchema** array_schema,
@@ -224,6 +250,8 @@ class StorageManager {
    * @param config Configuration parameters for the consolidation
    *     (`nullptr` means default, which will use the config associated with
    *      this instance).
+   * @param stats If not `nullptr`, the statistics of the consolidation are
+   *     dumped here as JSON (see `Consolidator::dump_stats`).
    * @return Status
    */
   Status array_consolidate(
@@ -231,7 +259,8 @@ class StorageManager {
       EncryptionType encryption_type,
       const void* encryption_key,
       uint32_t key_length,
-      const Config* config);
+      const Config* config,
+      std::string* stats = nullptr);
 
   /**
    * Consolidates the metadata of an array into a single file.
@@ -254,6 +283,55 @@ class StorageManager {
       uint32_t key_length,
       const Config* config);
 
+  /**
+   * Consolidates the footers and R-Trees of all the fragments of an array
+   * into a single file, so that opening the array fetches them with a single
+   * request instead of one per fragment.
+   *
+   * @param array_name The name of the array whose fragment metadata will be
+   *     consolidated.
+   * @param encryption_type The encryption type of the array
+   * @param encryption_key If the array is encrypted, the private encryption
+   *    key. For unencrypted arrays, pass `nullptr`.
+   * @param key_length The length in bytes of the encryption key.
+   * @param config Configuration parameters for the consolidation
+   *     (`nullptr` means default, which will use the config associated with
+   *      this instance).
+   * @return Status
+   */
+  Status fragment_metadata_consolidate(
+      const char* array_name,
+      EncryptionType encryption_type,
+      const void* encryption_key,
+      uint32_t key_length,
+      const Config* config);
+
+  /**
+   * Stitches the parts written concurrently by the producers of a global
+   * order write into a single fragment (see `Consolidator::stitch`).
+   *
+   * @param array The array opened for writes.
+   * @param fragment_uri The URI of the fragment containing the parts.
+   * @param part_uris The URIs of the parts.
+   * @param new_fragment The unstored metadata of the stitched fragment,
+   *     `nullptr` if no part has cells.
+   * @return Status
+   */
+  Status fragment_parts_stitch(
+      const Array* array,
+      const URI& fragment_uri,
+      const std::vector<URI>& part_uris,
+      std::shared_ptr<FragmentMetadata>* new_fragment);
+
+  /**
+   * Deletes the fragments superseded by the consolidations of an array that
+   * ran with `sm.consolidation.deferred_vacuum`.
+   *
+   * @param array_name The name of the array to vacuum.
+   * @return Status
+   */
+  Status array_vacuum(const char* array_name);
+
   /**
    * Creates a TileDB array storing its schema.
    *
@@ -310,6 +388,20 @@ class StorageManager {
   /** Releases an exclusive lock for the input array. */
   Status array_xunlock(const URI& array_uri);
 
+  /**
+   * Locks the input array for storing the metadata of a new fragment. Once
+   * the array has a manifest, readers see a fragment only after the
+   * atomically replaced manifest lists it, so a commit needs no lock and
+   * never waits for readers or for a consolidation deleting fragments.
+   * Otherwise the array is locked exclusively (see `array_xlock`).
+   *
+   * @param array_uri The array URI.
+   * @param locked Set to `true` if the array was locked, in which case it
+   *     must be released with `array_xunlock`.
+   * @return Status
+   */
+  Status array_commit_lock(const URI& array_uri, bool* locked);
+
   /**
    * Pushes an async query to the queue.
    *
@@ -318,11 +410,35 @@ class StorageManager {
    */
   Status async_push_query(Query* query);
 
+  /**
+   * Pushes an async query to the queue, posting `completion_tag` to the
+   * completion queue once the query is processed or cancelled.
+   *
+   * @param query The async query.
+   * @param completion_tag The tag to post.
+   * @return Status
+   */
+  Status async_push_query(Query* query, void* completion_tag);
+
+  /**
+   * Returns true if the reader caches the tiles filtered with the input
+   * pipeline in their filtered (persisted) form, as dictated by
+   * `sm.tile_cache_mode`. In `auto` mode these are the tiles of a pipeline
+   * with a compressor that decompresses fast.
+   */
+  bool cache_filtered_tiles(const FilterPipeline* filters) const;
+
   /** Cancels all background tasks. */
   Status cancel_all_tasks();
 
   /** Returns true while all tasks are being cancelled. */
-  bool cancellation_in_progress();
+  bool cancellation_in_progress() const;
+
+  /**
+   * Returns the flag that is set while all tasks are being cancelled, which
+   * long-running parallel loops poll between iterations to stop early.
+   */
+  const std::atomic<bool>* cancellation_flag() const;
 
   /** Returns the configuration parameters. */
   const Config& config() const;
@@ -330,6 +446,47 @@ class StorageManager {
   /** Creates a directory with the input URI. */
   Status create_dir(const URI& uri);
 
+  /**
+   * Returns the on-disk tile cache, or `nullptr` if it is disabled (see
+   * `sm.tile_disk_cache_dir`).
+   */
+  DiskTileCache* disk_tile_cache() const;
+
+  /**
+   * Returns the cache of fragment index structures, or `nullptr` if it is
+   * disabled (see `sm.index_cache_size`).
+   */
+  IndexCache* index_cache() const;
+
+  /**
+   * Returns the buffer of the unordered writes, or `nullptr` if it is
+   * disabled (see `sm.write_buffer.max_size`).
+   */
+  WriteBuffer* write_buffer() const;
+
+  /**
+   * Returns the open array entry of the input array if it is open for reads,
+   * and `nullptr` otherwise. The entry stays valid while the array is open.
+   */
+  OpenArray* open_array_for_reads(const URI& array_uri);
+
+  /**
+   * Returns `true` if opening an array for reads loads its fragment
+   * metadata in the background (see `sm.eager_metadata_load`).
+   */
+  bool eager_metadata_load() const;
+
+  /**
+   * Records the attributes read by a query on an array, whose tile offsets
+   * are loaded eagerly when the array is opened again. It has no effect if
+   * eager metadata loading is disabled.
+   */
+  void record_read_attributes(
+      const URI& array_uri, const std::vector<std::string>& attributes);
+
+  /** Returns the attributes recorded by `record_read_attributes`. */
+  std::vector<std::string> read_attributes(const URI& array_uri);
+
   /** Creates an empty file with the input URI. */
   Status touch(const URI& uri);
 
@@ -463,6 +620,21 @@ class StorageManager {
       uint64_t timestamp,
       Metadata* metadata);
 
+  /**
+   * Retrieves the memory held by this storage manager as a JSON object,
+   * with the bytes of each component: the tile cache, the index cache, the
+   * fragment and array metadata of the arrays open for reads, the buffered
+   * unordered writes and the VFS write buffers, along with the number of
+   * open arrays and queries in progress. The `process` member holds the
+   * components shared by all contexts: the buffers in use (e.g., the tiles
+   * of the queries in progress, also counting the cached tiles), the freed
+   * buffers kept by the buffer pool, and the fragment metadata cache.
+   *
+   * @param json Set to the JSON object.
+   * @return Status
+   */
+  Status memory_usage(std::string* json);
+
   /** Removes a TileDB object (group, array). */
   Status object_remove(const char* path) const;
 
@@ -554,7 +726,10 @@ class StorageManager {
    */
   Status object_type(const URI& uri, ObjectType* type) const;
 
-  /** Submits a query for (sync) execution. */
+  /**
+   * Submits a query for (sync) execution, logging it to the slow query log
+   * if its processing takes at least `sm.stats.slow_query_threshold_ms`.
+   */
   Status query_submit(Query* query);
 
   /**
@@ -566,31 +741,84 @@ class StorageManager {
   Status query_submit_async(Query* query);
 
   /**
-   * Reads from the cache into the input buffer. `uri` and `offset` collectively
-   * form the key of the cached object to be read. Essentially, this is used
-   * to read potentially cached tiles. `uri` is the URI of the attribute the
-   * tile belongs to, and `offset` is the offset in the attribute file where
-   * the tile is located. Observe that the `uri`, `offset` pair is unique.
+   * Submits a query for async execution, posting `completion_tag` to the
+   * completion queue once the query is processed.
    *
-   * @param uri The URI of the cached object.
-   * @param offset The offset of the cached object.
-   * @param buffer The buffer to write into. The function reallocates memory
-   *     for the buffer, sets its size to *nbytes* and resets its offset.
-   * @param nbytes Number of bytes to be read.
-   * @param in_cache This is set to `true` if the object is in the cache,
-   *     and `false` otherwise.
+   * @param query The query to submit.
+   * @param completion_tag The tag to post.
+   * @return Status
+   */
+  Status query_submit_async(Query* query, void* completion_tag);
+
+  /**
+   * Submits a batch of queries, possibly on different arrays, and waits for
+   * all of them. The queries are processed concurrently on the async thread
+   * pool and the calling thread, so the batch takes about as long as its
+   * slowest query.
+   *
+   * @param queries The queries to submit.
+   * @return Status::Ok if all queries were processed, otherwise the error of
+   *     one of the failed queries.
+   */
+  Status query_submit_batch(const std::vector<Query*>& queries);
+
+  /**
+   * Posts a tag to the completion queue, waking up any thread waiting in
+   * `poll_completions`.
+   *
+   * @param completion_tag The tag to post.
+   */
+  void post_completion(void* completion_tag);
+
+  /**
+   * Removes up to `max_completions` tags from the completion queue, in the
+   * order they were posted.
+   *
+   * @param completion_tags Set to the removed tags. It must have room for
+   *     `max_completions` tags.
+   * @param max_completions The maximum number of tags to remove.
+   * @param timeout_ms If the queue is empty, the time to wait for a tag to be
+   *     posted; 0 does not wait, and a negative value waits indefinitely.
+   * @param num_completions Set to the number of removed tags, 0 if the
+   *     timeout expired.
+   * @return Status
+   */
+  Status poll_completions(
+      void** completion_tags,
+      uint64_t max_completions,
+      int64_t timeout_ms,
+      uint64_t* num_completions);
+
+  /**
+   * Retrieves an object from the tile cache without copying it. Essentially,
+   * this is used to read potentially cached tiles, identified by their
+   * fragment, attribute file and offset in that file. The object is pinned
+   * in memory for as long as `data` (or a copy of it) is held.
+   *
+   * @param key The key of the cached object.
+   * @param nbytes Number of bytes expected in the object.
+   * @param data Set to the cached object, or to `nullptr` if the object is
+   *     not in the cache.
    * @return Status.
    */
   Status read_from_cache(
-      const URI& uri,
-      uint64_t offset,
-      Buffer* buffer,
+      const TileCacheKey& key,
       uint64_t nbytes,
-      bool* in_cache) const;
+      std::shared_ptr<const Buffer>* data) const;
 
   /** Returns the Reader thread pool. */
   ThreadPool* reader_thread_pool();
 
+  /**
+   * Draws whether a new query gathers its own stats while the global stats
+   * are disabled, which is true for a `sm.stats.sample_rate` fraction of
+   * the queries.
+   */
+  bool sample_query_stats() const;
+
+  /** Returns true if the calls of the sampled queries are traced. */
+  bool sample_query_traces() const;
+
   /**
    * Reads from a file into the input buffer.
    *
@@ -638,6 +866,36 @@ class StorageManager {
       const EncryptionKey& encryption_key,
       Metadata* array_metadata);
 
+  /**
+   * Stores the consolidated fragment metadata of an array into persistent
+   * storage, replacing any previous one.
+   *
+   * @param array_uri The URI of the array.
+   * @param encryption_key The encryption key to use.
+   * @param buff The serialized consolidated fragment metadata.
+   * @return Status
+   */
+  Status store_consolidated_fragment_metadata(
+      const URI& array_uri, const EncryptionKey& encryption_key, Buffer* buff);
+
+  /**
+   * Updates the manifest of an array, which lists its fragments, adding
+   * and removing the input fragments. If the array has no manifest yet, it
+   * is created from a listing of the array directory. This is a no-op
+   * unless `sm.array_manifest` is set.
+   *
+   * @param array_uri The URI of the array.
+   * @param encryption_key The encryption key to use.
+   * @param added The URIs of the fragments to add.
+   * @param removed The URIs of the fragments to remove.
+   * @return Status
+   */
+  Status update_array_manifest(
+      const URI& array_uri,
+      const EncryptionKey& encryption_key,
+      const std::vector<URI>& added,
+      const std::vector<URI>& removed);
+
   /** Closes a file, flushing its contents to persistent storage. */
   Status close_file(const URI& uri);
 
@@ -651,18 +909,15 @@ class StorageManager {
   VFS* vfs() const;
 
   /**
-   * Writes the contents of a buffer into the cache. `uri` and `offset`
-   * collectively form the key of the object to be cached. Essentially, this is
-   * used to cach tiles. `uri` is the URI of the attribute the
-   * tile belongs to, and `offset` is the offset in the attribute file where
-   * the tile is located. Observe that the `uri`, `offset` pair is unique.
+   * Writes the contents of a buffer into the tile cache. Essentially, this is
+   * used to cache unfiltered (or filtered, see `cache_filtered_tiles`) tiles,
+   * identified by their fragment, attribute file and offset in that file.
    *
-   * @param uri The URI of the cached object.
-   * @param offset The offset of the cached object.
+   * @param key The key of the cached object.
    * @param buffer The buffer whose contents will be cached.
    * @return Status.
    */
-  Status write_to_cache(const URI& uri, uint64_t offset, Buffer* buffer) const;
+  Status write_to_cache(const TileCacheKey& key, Buffer* buffer) const;
 
   /**
    * Writes the contents of a buffer into a URI file.
@@ -711,14 +966,22 @@ class StorageManager {
     }
   };
 
+  /** An array registered with the background consolidation service. */
+  struct AutoConsolidationArray {
+    /** The encryption type of the array. */
+    EncryptionType encryption_type_;
+    /** The encryption key of the array (empty if unencrypted). */
+    std::string encryption_key_;
+  };
+
   /* ********************************* */
   /*        PRIVATE ATTRIBUTES         */
   /* ********************************* */
 
   /** Set to true when tasks are being cancelled. */
-  bool cancellation_in_progress_;
+  std::atomic<bool> cancellation_in_progress_;
 
-  /** Mutex protecting cancellation_in_progress_. */
+  /** Mutex serializing the updates of cancellation_in_progress_. */
   std::mutex cancellation_in_progress_mtx_;
 
   /**
@@ -746,6 +1009,9 @@ class StorageManager {
   /** Mutex for managing exclusive locks. */
   std::mutex xlock_mtx_;
 
+  /** Serializes the array manifest updates of this storage manager. */
+  std::mutex array_manifest_mtx_;
+
   /** Stores the currently open arrays for reads. */
   std::map<std::string, OpenArray*> open_arrays_for_reads_;
 
@@ -764,12 +1030,107 @@ class StorageManager {
   /** The storage manager's thread pool for async queries. */
   ThreadPool async_thread_pool_;
 
+  /** The tags of the processed async queries, not yet polled. */
+  std::deque<void*> completions_;
+
+  /** Guards `completions_`. */
+  std::mutex completions_mtx_;
+
+  /** Notified when a tag is posted to `completions_`. */
+  std::condition_variable completions_cv_;
+
   /** The storage manager's thread pool for Readers. */
   ThreadPool reader_thread_pool_;
 
   /** The storage manager's thread pool for Writers. */
   ThreadPool writer_thread_pool_;
 
+  /**
+   * The storage manager's thread pool for loading fragment metadata. It has
+   * no threads unless `sm.num_fragment_metadata_threads` is set, in which
+   * case it bounds the number of metadata files fetched concurrently.
+   */
+  ThreadPool fragment_metadata_thread_pool_;
+
+  /**
+   * The storage manager's thread pool for the background consolidation
+   * service. It has a single thread if `sm.consolidation.auto_interval_ms`
+   * is set, and none otherwise.
+   */
+  ThreadPool consolidation_thread_pool_;
+
+  /**
+   * The period (in ms) at which the background consolidation service
+   * visits a registered array (`0` if the service is disabled).
+   */
+  uint64_t auto_consolidation_interval_ms_;
+
+  /** The number of fragments at which a registered array is consolidated. */
+  uint64_t auto_consolidation_fragment_num_;
+
+  /**
+   * The arrays registered with the background consolidation service, i.e.,
+   * the arrays opened for writes, keyed by URI.
+   */
+  std::map<std::string, AutoConsolidationArray> auto_consolidation_arrays_;
+
+  /** The URI of the array last visited by the consolidation service. */
+  std::string auto_consolidation_last_uri_;
+
+  /** Set to stop the background consolidation service. */
+  bool auto_consolidation_stop_;
+
+  /** Guards the state of the background consolidation service. */
+  std::mutex auto_consolidation_mtx_;
+
+  /** Wakes up the background consolidation service when it is stopped. */
+  std::condition_variable auto_consolidation_cv_;
+
+  /** The task running the background consolidation service. */
+  std::future<Status> auto_consolidation_task_;
+
+  /**
+   * The number of array metadata files at which closing an array for
+   * writes consolidates them (`0` disables it).
+   */
+  uint64_t auto_array_metadata_consolidation_num_;
+
+  /**
+   * The arrays whose metadata is being consolidated automatically, which
+   * are not consolidated again when the consolidation closes them.
+   */
+  std::set<std::string> auto_array_metadata_consolidations_;
+
+  /** Guards `auto_array_metadata_consolidations_`. */
+  std::mutex auto_array_metadata_consolidations_mtx_;
+
+  /** The fraction of the queries whose stats are sampled. */
+  double stats_sample_rate_;
+
+  /** True if the calls of the sampled queries are traced. */
+  bool stats_sample_traces_;
+
+  /**
+   * The latency (in ms) from which a query submission is logged to the slow
+   * query log (`0` if the log is disabled).
+   */
+  uint64_t slow_query_threshold_ms_;
+
+  /** The file of the slow query log (standard error if empty). */
+  std::string slow_query_log_;
+
+  /** Serializes the appends to the slow query log. */
+  std::mutex slow_query_log_mtx_;
+
+  /** Whether arrays load their fragment metadata eagerly on open. */
+  bool eager_metadata_load_;
+
+  /** The attributes read by the queries on each array, keyed by URI. */
+  std::map<std::string, std::set<std::string>> read_attributes_;
+
+  /** Guards `read_attributes_`. */
+  std::mutex read_attributes_mtx_;
+
   /** Tracks all scheduled tasks that can be safely cancelled before execution.
    */
   CancelableTasks cancelable_tasks_;
@@ -778,7 +1139,16 @@ class StorageManager {
   std::unordered_map<std::string, std::string> tags_;
 
   /** A tile cache. */
-  LRUCache* tile_cache_;
+  TileCache* tile_cache_;
+
+  /** The on-disk tile cache (`nullptr` if disabled). */
+  DiskTileCache* disk_tile_cache_;
+
+  /** The cache of fragment index structures (`nullptr` if disabled). */
+  IndexCache* index_cache_;
+
+  /** The buffer of the unordered writes (`nullptr` if disabled). */
+  WriteBuffer* write_buffer_;
 
   /**
    * Virtual filesystem handler. It directs queries to the appropriate
@@ -810,28 +1180,113 @@ class StorageManager {
 
   /**
    * This is an auxiliary function to the other `array_open*` functions.
-   * It opens the array, retrieves an `OpenArray` instance, acquires
-   * its mutex and increases its counter. The array schema of the array
-   * is loaded, but not any fragment metadata at this point.
+   * It opens the array, retrieves an `OpenArray` instance and increases
+   * its counter. The array schema of the array is loaded under the array
+   * mutex, but not any fragment metadata at this point.
    *
    * @param array_uri The array URI.
    * @param encryption_key The encryption key.
    * @param open_array The `OpenArray` instance retrieved after opening
-   *      the array. Note that its mutex will be locked and its counter
-   *      will have been incremented when the function returns.
+   *      the array. Note that its counter will have been incremented (and
+   *      its mutex released) when the function returns.
+   * @param array_dir_uris If not `nullptr`, the array directory is listed
+   *      (see `ls_array_dir`) into it to check that the array exists, so
+   *      that the listing can be reused to find the fragments.
    * @return Status
    */
   Status array_open_without_fragments(
       const URI& array_uri,
       const EncryptionKey& encryption_key,
-      OpenArray** open_array);
+      OpenArray** open_array,
+      std::vector<URI>* array_dir_uris = nullptr);
+
+  /**
+   * Runs the background consolidation service until it is stopped. In each
+   * period it visits the next registered array in turn (see
+   * `auto_consolidate_array`).
+   */
+  Status auto_consolidate();
+
+  /**
+   * Runs a single consolidation step on the input array, following the
+   * `sm.consolidation.*` configuration, if it has at least
+   * `sm.consolidation.auto_fragment_num` fragments. The step is skipped
+   * while any query is in progress or the array is open for reads, so
+   * that the service does not compete with foreground queries.
+   *
+   * @param array_uri The array URI.
+   * @param array The registration of the array.
+   * @return Status
+   */
+  Status auto_consolidate_array(
+      const std::string& array_uri, const AutoConsolidationArray& array);
+
+  /**
+   * Consolidates the metadata of the input array if it has at least
+   * `sm.consolidation.auto_array_metadata_num` metadata files.
+   *
+   * @param array_uri The array URI.
+   * @param encryption_key The array encryption key.
+   * @return Status
+   */
+  Status auto_consolidate_array_metadata(
+      const URI& array_uri, const EncryptionKey& encryption_key);
+
+  /** Registers an array with the background consolidation service. */
+  void auto_consolidation_register(
+      const URI& array_uri, const EncryptionKey& encryption_key);
 
   /** Decrement the count of in-progress queries. */
   void decrement_in_progress();
 
-  /** Retrieves all the fragment URI's of an array. */
+  /**
+   * Retrieves the fragment URI's of an array whose timestamp range, as
+   * encoded in the fragment name, intersects `timestamp_range`. The
+   * other URIs are skipped before checking storage. If `open_array` is
+   * given, the listed URIs whose fragment metadata are already loaded in
+   * it are taken to be fragments without checking storage. If
+   * `sm.array_manifest` is set and the array has a manifest, the fragments
+   * are taken from it instead of listing the array directory. Otherwise
+   * the array directory is listed, unless its listing is given in
+   * `array_dir_uris`, and the remaining candidates are checked in
+   * parallel.
+   */
   Status get_fragment_uris(
-      const URI& array_uri, std::vector<URI>* fragment_uris) const;
+      const URI& array_uri,
+      const EncryptionKey& encryption_key,
+      const std::pair<uint64_t, uint64_t>& timestamp_range,
+      std::vector<URI>* fragment_uris,
+      const OpenArray* open_array = nullptr,
+      const std::vector<URI>* array_dir_uris = nullptr);
+
+  /** Returns `true` if `sm.array_manifest` is set. */
+  bool array_manifest_enabled() const;
+
+  /**
+   * Loads the fragment URIs listed in the manifest of an array.
+   *
+   * @param array_uri The array URI.
+   * @param encryption_key The encryption key to use.
+   * @param fragment_uris Set to the URIs of the fragments in the manifest.
+   * @param found Set to `false` if the array has no manifest.
+   * @return Status
+   */
+  Status load_array_manifest(
+      const URI& array_uri,
+      const EncryptionKey& encryption_key,
+      std::vector<URI>* fragment_uris,
+      bool* found);
+
+  /**
+   * Writes `buff` as a generic tile to file `filename` of an array,
+   * replacing any previous file. The tile is written to a hidden temporary
+   * file first, so that readers never see a partially written file.
+   */
+  Status store_generic_tile_atomically(
+      const URI& array_uri,
+      const std::string& filename,
+      const EncryptionKey& encryption_key,
+      Buffer* buff);
 
   /** Retrieves all the array metadata URI's of an array. */
   Status get_array_metadata_uris(
@@ -840,6 +1295,16 @@ class StorageManager {
   /** Increment the count of in-progress queries. */
   void increment_in_progress();
 
+  /**
+   * Appends a query to the slow query log, as a JSON line with the array,
+   * type, status and latency of the query, and its stats if it gathered
+   * them.
+   *
+   * @param query The slow query.
+   * @param latency_ms The latency of the query submission in ms.
+   */
+  void log_slow_query(const Query* query, uint64_t latency_ms);
+
   /**
    * Loads the array schema into an open array.
    *
@@ -873,6 +1338,23 @@ class StorageManager {
       const std::vector<TimestampedURI>& array_metadata_to_load,
       Metadata* metadata);
 
+  /**
+   * Loads the consolidated fragment metadata file of an array, if it exists.
+   *
+   * @param array_uri The array URI.
+   * @param encryption_key The encryption key to use.
+   * @param buff Set to the contents of the file, or left null if the file
+   *     does not exist.
+   * @param entries Set to the entry of each fragment in `buff`, keyed by
+   *     fragment name.
+   * @return Status
+   */
+  Status load_consolidated_fragment_metadata(
+      const URI& array_uri,
+      const EncryptionKey& encryption_key,
+      std::shared_ptr<Buffer>* buff,
+      std::unordered_map<std::string, ConstBuffer>* entries);
+
   /**
    * Loads the fragment metadata of an open array given a vector of
    * fragment URIs `fragments_to_load`. If the fragment metadata
@@ -880,6 +1362,9 @@ class StorageManager {
    * The function stores the fragment metadata of each fragment
    * in `fragments_to_load` into vector `fragment_metadata`, such
    * that there is a one-to-one correspondence between the two vectors.
+   * The array mutex must not be held by the caller: it is locked only if
+   * some fragment metadata are not loaded yet (see
+   * `load_missing_fragment_metadata`).
    *
    * @param open_array The open array object.
    * @param encryption_key The encryption key to use.
@@ -894,6 +1379,52 @@ class StorageManager {
       const std::vector<TimestampedURI>& fragments_to_load,
       std::vector<FragmentMetadata*>* fragment_metadata);
 
+  /**
+   * Implements `load_fragment_metadata` with the array mutex locked.
+   * When several fragments need loading, the ones found in the consolidated
+   * fragment metadata file are loaded from it. The rest are loaded in
+   * parallel, on the fragment metadata thread pool if it has threads.
+   *
+   * @param open_array The open array object.
+   * @param encryption_key The encryption key to use.
+   * @param fragments_to_load The fragments whose metadata to load.
+   * @param fragment_metadata The fragment metadata retrieved in a
+   *     vector.
+   * @return Status
+   */
+  Status load_missing_fragment_metadata(
+      OpenArray* open_array,
+      const EncryptionKey& encryption_key,
+      const std::vector<TimestampedURI>& fragments_to_load,
+      std::vector<FragmentMetadata*>* fragment_metadata);
+
+  /**
+   * Lists the contents of an array directory. Since fragment names start
+   * with `__<timestamp>_`, a long listing is split on timestamp ranges
+   * between the last listed fragment and now, listed in parallel on
+   * backends that support it (see `VFS::ls_sharded`). A non-S3 URI that
+   * is not a directory yields no contents.
+   *
+   * @param array_uri The array URI.
+   * @param uris The URIs of the contents of the array directory.
+   * @return Status
+   */
+  Status ls_array_dir(const URI& array_uri, std::vector<URI>* uris) const;
+
+  /**
+   * Lists the TileDB objects (arrays and groups) contained in a path. The
+   * types of its contents are probed in parallel.
+   *
+   * @param uri The path to list.
+   * @param obj_uris The URIs of the objects found, in listing order.
+   * @param obj_types The types of the objects in `obj_uris`.
+   * @return Status
+   */
+  Status ls_objects(
+      const URI& uri,
+      std::vector<URI>* obj_uris,
+      std::vector<ObjectType>* obj_types) const;
+
   /**
    * Applicable to fragment and array metadata URIs.
    *
@@ -0,0 +1,318 @@
+/**
+ * @file   write_buffer.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * This file implements class WriteBuffer.
+ */
+
+#include "tiledb/sm/storage_manager/write_buffer.h"
+#include "tiledb/sm/array/array.h"
+#include "tiledb/sm/array_schema/array_schema.h"
+#include "tiledb/sm/encryption/encryption_key.h"
+#include "tiledb/sm/enums/datatype.h"
+#include "tiledb/sm/enums/encryption_type.h"
+#include "tiledb/sm/enums/layout.h"
+#include "tiledb/sm/enums/query_type.h"
+#include "tiledb/sm/misc/logger.h"
+#include "tiledb/sm/misc/stats.h"
+#include "tiledb/sm/misc/utils.h"
+#include "tiledb/sm/query/query.h"
+#include "tiledb/sm/storage_manager/storage_manager.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+
+namespace tiledb {
+namespace sm {
+
+/* ****************************** */
+/*   CONSTRUCTORS & DESTRUCTORS   */
+/* ****************************** */
+
+WriteBuffer::WriteBuffer(
+    StorageManager* storage_manager, uint64_t max_size, uint64_t max_age_ms)
+    : storage_manager_(storage_manager)
+    , max_size_(max_size)
+    , max_age_ms_(max_age_ms)
+    , stop_(false) {
+}
+
+WriteBuffer::~WriteBuffer() {
+  stop();
+}
+
+/* ****************************** */
+/*               API              */
+/* ****************************** */
+
+Status WriteBuffer::init() {
+  if (max_age_ms_ == 0)
+    return Status::Ok();
+
+  // The fragments the service writes are background tasks
+  RETURN_NOT_OK(thread_pool_.init(1, ThreadPool::Priority::BACKGROUND));
+  task_ = thread_pool_.enqueue([this]() { return flush_service(); });
+
+  return Status::Ok();
+}
+
+Status WriteBuffer::append(
+    const URI& array_uri,
+    const EncryptionKey& encryption_key,
+    Cells&& cells) {
+  bool full = false;
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto it = entries_.find(array_uri.to_string());
+    if (it == entries_.end()) {
+      auto key = encryption_key.key();
+      Entry entry;
+      entry.encryption_type_ = encryption_key.encryption_type();
+      entry.encryption_key_.assign((const char*)key.data(), key.size());
+      entry.size_ = 0;
+      entry.first_write_ms_ = utils::time::timestamp_now_ms();
+      it = entries_.emplace(array_uri.to_string(), std::move(entry)).first;
+
+      // The flush service waits for the age of the new cells
+      cv_.notify_all();
+    }
+
+    auto& entry = it->second;
+    for (const auto& cell_it : cells) {
+      const auto& field = cell_it.second;
+      entry.size_ +=
+          field.values_.size() + field.offsets_.size() * sizeof(uint64_t);
+    }
+    if (entry.cells_.empty()) {
+      entry.cells_ = std::move(cells);
+    } else {
+      // The offsets of the appended cells follow the buffered values
+      for (auto& cell_it : cells) {
+        auto& field = entry.cells_[cell_it.first];
+        const auto& new_field = cell_it.second;
+        auto base = (uint64_t)field.values_.size();
+        for (auto offset : new_field.offsets_)
+          field.offsets_.push_back(base + offset);
+        field.values_.insert(
+            field.values_.end(),
+            new_field.values_.begin(),
+            new_field.values_.end());
+      }
+    }
+    full = entry.size_ >= max_size_;
+  }
+
+  STATS_COUNTER_ADD(writer_num_buffered_writes, 1);
+
+  return full ? flush(array_uri) : Status::Ok();
+}
+
+Status WriteBuffer::flush(const URI& array_uri) {
+  // Holding the lock while writing keeps the fragments of an array in the
+  // order of its writes
+  std::lock_guard<std::mutex> flush_lock(flush_mtx_);
+
+  Entry entry;
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto it = entries_.find(array_uri.to_string());
+    if (it == entries_.end())
+      return Status::Ok();
+    entry = std::move(it->second);
+    entries_.erase(it);
+  }
+
+  return write(array_uri.to_string(), entry);
+}
+
+Status WriteBuffer::flush_all() {
+  std::vector<std::string> array_uris;
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    for (const auto& it : entries_)
+      array_uris.push_back(it.first);
+  }
+
+  // Flush all the arrays even if some fail, reporting the last error
+  auto st = Status::Ok();
+  for (const auto& array_uri : array_uris) {
+    auto st_flush = flush(URI(array_uri));
+    if (!st_flush.ok())
+      st = st_flush;
+  }
+
+  return st;
+}
+
+uint64_t WriteBuffer::size() {
+  std::lock_guard<std::mutex> lock(mtx_);
+  uint64_t size = 0;
+  for (const auto& it : entries_)
+    size += it.second.size_;
+  return size;
+}
+
+void WriteBuffer::stop() {
+  if (!task_.valid())
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  task_.wait();
+  task_ = std::future<Status>();
+}
+
+/* ****************************** */
+/*         PRIVATE METHODS        */
+/* ****************************** */
+
+Status WriteBuffer::flush_service() {
+  std::unique_lock<std::mutex> lck(mtx_);
+  while (!stop_) {
+    // Find the arrays whose oldest cells reached the maximum age, and the
+    // time until the next one does
+    auto now = utils::time::timestamp_now_ms();
+    auto wait_ms = max_age_ms_;
+    std::vector<std::string> array_uris;
+    for (const auto& it : entries_) {
+      auto first_write_ms = it.second.first_write_ms_;
+      auto age = (now > first_write_ms) ? now - first_write_ms : 0;
+      if (age >= max_age_ms_)
+        array_uris.push_back(it.first);
+      else
+        wait_ms = std::min(wait_ms, max_age_ms_ - age);
+    }
+
+    // Appending the cells of a new array wakes up the service
+    if (array_uris.empty()) {
+      cv_.wait_for(lck, std::chrono::milliseconds(wait_ms));
+      continue;
+    }
+
+    lck.unlock();
+    for (const auto& array_uri : array_uris) {
+      auto st = flush(URI(array_uri));
+      if (!st.ok())
+        LOG_STATUS(st);
+    }
+    lck.lock();
+  }
+
+  return Status::Ok();
+}
+
+Status WriteBuffer::write(const std::string& array_uri, const Entry& entry) {
+  // Load the user offsets format of the context, which the query expects
+  const auto& config = storage_manager_->config();
+  bool found = false;
+  bool offsets_extra_element = false;
+  RETURN_NOT_OK(config.get<bool>(
+      "sm.var_offsets.extra_element", &offsets_extra_element, &found));
+  assert(found);
+  const char* offsets_mode;
+  RETURN_NOT_OK(config.get("sm.var_offsets.mode", &offsets_mode));
+  bool offsets_in_elements = std::string(offsets_mode) == "elements";
+
+  auto key = entry.encryption_key_.empty() ?
+                 nullptr :
+                 (const void*)entry.encryption_key_.data();
+  auto key_length = (uint32_t)entry.encryption_key_.size();
+  Array array(URI(array_uri), storage_manager_);
+  RETURN_NOT_OK(
+      array.open(QueryType::WRITE, entry.encryption_type_, key, key_length));
+
+  // Convert the offsets and set up the buffer sizes. Empty values are
+  // pointed at a dummy byte, since the query rejects null buffers.
+  auto array_schema = array.array_schema();
+  std::map<std::string, std::vector<uint64_t>> offsets;
+  std::map<std::string, uint64_t> sizes, var_sizes;
+  uint8_t empty_value = 0;
+  for (const auto& it : entry.cells_) {
+    const auto& name = it.first;
+    const auto& field = it.second;
+    sizes[name] = field.values_.size();
+    if (!array_schema->var_size(name))
+      continue;
+
+    auto unit = offsets_in_elements ?
+                    datatype_size(array_schema->type(name)) :
+                    (uint64_t)1;
+    auto& field_offsets = offsets[name];
+    field_offsets.reserve(field.offsets_.size() + 1);
+    for (auto offset : field.offsets_)
+      field_offsets.push_back(offset / unit);
+    if (offsets_extra_element)
+      field_offsets.push_back(field.values_.size() / unit);
+    sizes[name] = field_offsets.size() * sizeof(uint64_t);
+    var_sizes[name] = field.values_.size();
+  }
+
+  auto st = Status::Ok();
+  {
+    Query query(storage_manager_, &array);
+    query.disable_write_buffer();
+    st = query.set_layout(Layout::UNORDERED);
+    if (st.ok())
+      st = query.set_offsets_bitsize(64);
+    for (const auto& it : entry.cells_) {
+      if (!st.ok())
+        break;
+      const auto& name = it.first;
+      auto values = it.second.values_.empty() ?
+                        &empty_value :
+                        const_cast<uint8_t*>(it.second.values_.data());
+      if (array_schema->var_size(name)) {
+        st = query.set_buffer(
+            name,
+            offsets[name].data(),
+            &sizes[name],
+            values,
+            &var_sizes[name]);
+      } else {
+        st = query.set_buffer(name, values, &sizes[name]);
+      }
+    }
+    if (st.ok())
+      st = query.submit();
+    if (st.ok())
+      st = query.finalize();
+  }
+  auto st_close = array.close();
+  RETURN_NOT_OK(st);
+  RETURN_NOT_OK(st_close);
+
+  STATS_COUNTER_ADD(writer_num_write_buffer_flushes, 1);
+
+  return Status::Ok();
+}
+
+}  // namespace sm
+}  // namespace tiledb
@@ -0,0 +1,212 @@
+/**
+ * @file   write_buffer.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ * This file defines class WriteBuffer.
+ */
+
+#ifndef TILEDB_WRITE_BUFFER_H
+#define TILEDB_WRITE_BUFFER_H
+
+#include "tiledb/sm/misc/status.h"
+#include "tiledb/sm/misc/thread_pool.h"
+#include "tiledb/sm/misc/uri.h"
+
+#include <condition_variable>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tiledb {
+namespace sm {
+
+class EncryptionKey;
+class StorageManager;
+
+enum class EncryptionType : uint8_t;
+
+/**
+ * An in-memory buffer of the cells of the unordered writes to sparse
+ * arrays, owned by the storage manager. The cells of an array are appended
+ * across the queries of the context and written as a single fragment once
+ * they reach a maximum size, instead of one small fragment per query.
+ *
+ * The buffered cells of an array are also flushed before the array is
+ * opened for reads with the context, when they reach a maximum age (if
+ * set) and when the context is freed. Flushes are serialized, so that the
+ * fragments of an array are written in the order of its writes.
+ */
+class WriteBuffer {
+ public:
+  /* ********************************* */
+  /*            TYPE DEFINITIONS       */
+  /* ********************************* */
+
+  /** The buffered values of an attribute or dimension. */
+  struct Field {
+    /** The cell values. */
+    std::vector<uint8_t> values_;
+    /**
+     * The byte offsets of the cells in `values_` if the field is var-sized,
+     * without the end of the last cell. Empty for fixed-sized fields.
+     */
+    std::vector<uint64_t> offsets_;
+  };
+
+  /** The buffered cells of a write, keyed by attribute/dimension name. */
+  typedef std::unordered_map<std::string, Field> Cells;
+
+  /* ********************************* */
+  /*     CONSTRUCTORS & DESTRUCTORS    */
+  /* ********************************* */
+
+  /**
+   * Constructor.
+   *
+   * @param storage_manager The storage manager that writes the fragments.
+   * @param max_size The size in bytes at which the cells of an array are
+   *     flushed.
+   * @param max_age_ms The age in ms of the oldest cells of an array at
+   *     which they are flushed (`0` if disabled).
+   */
+  WriteBuffer(
+      StorageManager* storage_manager, uint64_t max_size, uint64_t max_age_ms);
+
+  /** Destructor. Stops the flush service, without flushing the cells. */
+  ~WriteBuffer();
+
+  WriteBuffer(const WriteBuffer&) = delete;
+  WriteBuffer& operator=(const WriteBuffer&) = delete;
+
+  /* ********************************* */
+  /*                API                */
+  /* ********************************* */
+
+  /** Starts the service flushing the cells by age, if enabled. */
+  Status init();
+
+  /**
+   * Appends the cells of a write to the buffer of an array, flushing them
+   * if the buffer reaches the maximum size.
+   *
+   * @param array_uri The array URI.
+   * @param encryption_key The encryption key the array is opened with.
+   * @param cells The cells, with the values of all the attributes and
+   *     dimensions of the array.
+   * @return Status
+   */
+  Status append(
+      const URI& array_uri,
+      const EncryptionKey& encryption_key,
+      Cells&& cells);
+
+  /** Writes the buffered cells of an array (if any) as a new fragment. */
+  Status flush(const URI& array_uri);
+
+  /** Flushes the buffered cells of all the arrays. */
+  Status flush_all();
+
+  /** Returns the size in bytes of the buffered cells of all the arrays. */
+  uint64_t size();
+
+  /** Stops the service flushing the cells by age. */
+  void stop();
+
+ private:
+  /* ********************************* */
+  /*        PRIVATE DATATYPES          */
+  /* ********************************* */
+
+  /** The buffered cells of an array. */
+  struct Entry {
+    /** The encryption type of the array. */
+    EncryptionType encryption_type_;
+    /** The encryption key of the array (empty if unencrypted). */
+    std::string encryption_key_;
+    /** The buffered cells. */
+    Cells cells_;
+    /** The size in bytes of the buffered cells. */
+    uint64_t size_;
+    /** The time in ms at which the first buffered cells were appended. */
+    uint64_t first_write_ms_;
+  };
+
+  /* ********************************* */
+  /*        PRIVATE ATTRIBUTES         */
+  /* ********************************* */
+
+  /** The storage manager. */
+  StorageManager* storage_manager_;
+
+  /** The size in bytes at which the cells of an array are flushed. */
+  uint64_t max_size_;
+
+  /** The age in ms at which the cells of an array are flushed. */
+  uint64_t max_age_ms_;
+
+  /** The buffered cells, keyed by array URI. */
+  std::map<std::string, Entry> entries_;
+
+  /** Guards `entries_` and `stop_`. */
+  std::mutex mtx_;
+
+  /** Serializes the flushes. */
+  std::mutex flush_mtx_;
+
+  /** Set to stop the flush service. */
+  bool stop_;
+
+  /** Wakes up the flush service when it is stopped. */
+  std::condition_variable cv_;
+
+  /** The thread pool of the flush service (one thread if it is enabled). */
+  ThreadPool thread_pool_;
+
+  /** The task running the flush service. */
+  std::future<Status> task_;
+
+  /* ********************************* */
+  /*          PRIVATE METHODS          */
+  /* ********************************* */
+
+  /**
+   * Runs the flush service, which periodically flushes the arrays whose
+   * oldest cells reached the maximum age.
+   */
+  Status flush_service();
+
+  /** Writes the buffered cells of an array as a new fragment. */
+  Status write(const std::string& array_uri, const Entry& entry);
+};
+
+}  // namespace sm
+}  // namespace tiledb
+
+#endif  // TILEDB_WRITE_BUFFER_H
@@ -51,12 +51,16 @@ template <class T>
 CellSlabIter<T>::CellSlabIter() {
   subarray_ = nullptr;
   end_ = true;
+  dim_num_ = 0;
+  layout_ = Layout::ROW_MAJOR;
 }
 
 template <class T>
 CellSlabIter<T>::CellSlabIter(const Subarray* subarray)
     : subarray_(subarray) {
   end_ = true;
+  dim_num_ = (subarray != nullptr) ? subarray->dim_num() : 0;
+  layout_ = (subarray != nullptr) ? subarray->layout() : Layout::ROW_MAJOR;
   if (subarray != nullptr) {
     aux_tile_coords_.resize(subarray->dim_num());
     aux_tile_coords_2_.resize(subarray->array()->array_schema()->coords_size());
@@ -77,7 +81,7 @@ Status CellSlabIter<T>::begin() {
   RETURN_NOT_OK(init_ranges());
   init_coords();
   init_cell_slab_lengths();
-  update_cell_slab();
+  update_cell_slab<0>();
 
   end_ = false;
 
@@ -85,7 +89,7 @@ Status CellSlabIter<T>::begin() {
 }
 
 template <class T>
-CellSlab<T> CellSlabIter<T>::cell_slab() const {
+const CellSlab<T>& CellSlabIter<T>::cell_slab() const {
   return cell_slab_;
 }
 
@@ -100,27 +104,45 @@ void CellSlabIter<T>::operator++() {
   if (end_)
     return;
 
-  // Advance the iterator
-  if (subarray_->layout() == Layout::ROW_MAJOR)
-    advance_row();
+  // Advance the iterator, using the fixed-rank versions for the common
+  // 2D and 3D cases
+  switch (dim_num_) {
+    case 2:
+      advance<2>();
+      break;
+    case 3:
+      advance<3>();
+      break;
+    default:
+      advance<0>();
+      break;
+  }
+}
+
+/* ****************************** */
+/*          PRIVATE METHODS       */
+/* ****************************** */
+
+template <class T>
+template <unsigned N>
+void CellSlabIter<T>::advance() {
+  if (layout_ == Layout::ROW_MAJOR)
+    advance_row<N>();
   else
-    advance_col();
+    advance_col<N>();
 
   if (end_) {
     cell_slab_.reset();
     return;
   }
 
-  update_cell_slab();
+  update_cell_slab<N>();
 }
 
-/* ****************************** */
-/*          PRIVATE METHODS       */
-/* ****************************** */
-
 template <class T>
+template <unsigned N>
 void CellSlabIter<T>::advance_col() {
-  auto dim_num = (int)subarray_->dim_num();
+  const int dim_num = (N != 0) ? (int)N : (int)dim_num_;
 
   for (int i = 0; i < dim_num; ++i) {
     cell_slab_coords_[i] += (i == 0) ? cell_slab_lengths_[range_coords_[i]] : 1;
@@ -146,8 +168,9 @@ void CellSlabIter<T>::advance_col() {
 }
 
 template <class T>
+template <unsigned N>
 void CellSlabIter<T>::advance_row() {
-  auto dim_num = (int)subarray_->dim_num();
+  const int dim_num = (N != 0) ? (int)N : (int)dim_num_;
 
   for (int i = dim_num - 1; i >= 0; --i) {
     cell_slab_coords_[i] +=
@@ -321,17 +344,21 @@ Status CellSlabIter<T>::sanity_check() const {
 }
 
 template <class T>
+template <unsigned N>
 void CellSlabIter<T>::update_cell_slab() {
-  auto dim_num = subarray_->dim_num();
-  auto layout = subarray_->layout();
+  const unsigned dim_num = (N != 0) ? N : dim_num_;
 
+  bool tile_changed = (cell_slab_.tile_coords_ == nullptr);
   for (unsigned i = 0; i < dim_num; ++i) {
-    aux_tile_coords_[i] = ranges_[i][range_coords_[i]].tile_coord_;
+    auto tile_coord = ranges_[i][range_coords_[i]].tile_coord_;
+    tile_changed |= (aux_tile_coords_[i] != tile_coord);
+    aux_tile_coords_[i] = tile_coord;
     cell_slab_.coords_[i] = cell_slab_coords_[i];
   }
-  cell_slab_.tile_coords_ =
-      subarray_->tile_coords_ptr(aux_tile_coords_, &aux_tile_coords_2_);
-  cell_slab_.length_ = (layout == Layout::ROW_MAJOR) ?
+  if (tile_changed)
+    cell_slab_.tile_coords_ =
+        subarray_->tile_coords_ptr(aux_tile_coords_, &aux_tile_coords_2_);
+  cell_slab_.length_ = (layout_ == Layout::ROW_MAJOR) ?
                            cell_slab_lengths_[range_coords_[dim_num - 1]] :
                            cell_slab_lengths_[range_coords_[0]];
 }
@@ -156,7 +156,7 @@ class CellSlabIter {
   Status begin();
 
   /** Returns the current cell slab. */
-  CellSlab<T> cell_slab() const;
+  const CellSlab<T>& cell_slab() const;
 
   /** Checks if the iterator has reached the end. */
   bool end() const;
@@ -195,6 +195,12 @@ class CellSlabIter {
   /** `True` if the iterator has reached its end. */
   bool end_;
 
+  /** The number of dimensions of the subarray. */
+  unsigned dim_num_;
+
+  /** The subarray layout. */
+  Layout layout_;
+
   /**
    * A list of ranges per dimension. This is derived from the `subarray_`
    * ranges, after appropriately splitting them so that no range crosses
@@ -215,10 +221,21 @@ class CellSlabIter {
   /*           PRIVATE METHODS         */
   /* ********************************* */
 
+  /**
+   * Advances to the next cell slab and updates the current cell slab.
+   *
+   * @tparam N The number of dimensions if it is known at compile time
+   *     (which unrolls the per-dimension loops), or `0` otherwise.
+   */
+  template <unsigned N>
+  void advance();
+
   /** Advances to the next cell slab when the layout is col-major. */
+  template <unsigned N>
   void advance_col();
 
   /** Advances to the next cell slab when the layout is row-major. */
+  template <unsigned N>
   void advance_row();
 
   /**
@@ -259,8 +276,10 @@ class CellSlabIter {
 
   /**
    * Updates the current cell slab, based on the current state of
-   * the iterator.
+   * the iterator. The tile coordinates are looked up only when the
+   * cell slab moves to a different tile.
    */
+  template <unsigned N>
   void update_cell_slab();
 };
 
@@ -39,6 +39,7 @@
 #include "tiledb/sm/enums/layout.h"
 #include "tiledb/sm/fragment/fragment_metadata.h"
 #include "tiledb/sm/misc/parallel_functions.h"
+#include "tiledb/sm/misc/stats.h"
 #include "tiledb/sm/misc/utils.h"
 #include "tiledb/sm/rtree/rtree.h"
 
@@ -319,6 +320,51 @@ Status Subarray::compute_tile_overlap() {
   return Status::Ok();
 }
 
+Status Subarray::compute_tile_overlap(const Subarray& parent) {
+  auto type = array_->array_schema()->domain()->type();
+  switch (type) {
+    case Datatype::INT8:
+      return compute_tile_overlap<int8_t>(parent);
+    case Datatype::UINT8:
+      return compute_tile_overlap<uint8_t>(parent);
+    case Datatype::INT16:
+      return compute_tile_overlap<int16_t>(parent);
+    case Datatype::UINT16:
+      return compute_tile_overlap<uint16_t>(parent);
+    case Datatype::INT32:
+      return compute_tile_overlap<int32_t>(parent);
+    case Datatype::UINT32:
+      return compute_tile_overlap<uint32_t>(parent);
+    case Datatype::INT64:
+      return compute_tile_overlap<int64_t>(parent);
+    case Datatype::UINT64:
+      return compute_tile_overlap<uint64_t>(parent);
+    case Datatype::FLOAT32:
+      return compute_tile_overlap<float>(parent);
+    case Datatype::FLOAT64:
+      return compute_tile_overlap<double>(parent);
+    case Datatype::DATETIME_YEAR:
+    case Datatype::DATETIME_MONTH:
+    case Datatype::DATETIME_WEEK:
+    case Datatype::DATETIME_DAY:
+    case Datatype::DATETIME_HR:
+    case Datatype::DATETIME_MIN:
+    case Datatype::DATETIME_SEC:
+    case Datatype::DATETIME_MS:
+    case Datatype::DATETIME_US:
+    case Datatype::DATETIME_NS:
+    case Datatype::DATETIME_PS:
+    case Datatype::DATETIME_FS:
+    case Datatype::DATETIME_AS:
+      return compute_tile_overlap<int64_t>(parent);
+    default:
+      return LOG_STATUS(Status::SubarrayError(
+          "Failed to compute tile overlap; unsupported domain type"));
+  }
+
+  return Status::Ok();
+}
+
 template <class T>
 Subarray Subarray::crop_to_tile(const T* tile_coords, Layout layout) const {
   Subarray ret(array_, layout);
@@ -441,6 +487,11 @@ Subarray Subarray::get_subarray(uint64_t start, uint64_t end) const {
   // Compute range offsets
   ret.compute_range_offsets();
 
+  // The sliced tile overlap is valid if [start, end] spans exactly the
+  // ranges of `ret`, so that it need not be recomputed
+  ret.tile_overlap_computed_ =
+      tile_overlap_computed_ && ret.range_num() == end - start + 1;
+
   return ret;
 }
 
@@ -479,6 +530,21 @@ bool Subarray::is_unary(uint64_t range_idx) const {
   return true;
 }
 
+template <class T>
+bool Subarray::has_sorted_disjoint_ranges() const {
+  for (const auto& ranges : ranges_) {
+    auto range_num = ranges.range_num();
+    for (uint64_t i = 1; i < range_num; ++i) {
+      auto prev = (const T*)ranges.get_range(i - 1);
+      auto r = (const T*)ranges.get_range(i);
+      if (!(prev[1] < r[0]))
+        return false;
+    }
+  }
+
+  return true;
+}
+
 void Subarray::set_layout(Layout layout) {
   layout_ = layout;
 }
@@ -487,6 +553,62 @@ Layout Subarray::layout() const {
   return layout_;
 }
 
+Status Subarray::normalize_ranges() {
+  auto type = array_->array_schema()->domain()->type();
+  switch (type) {
+    case Datatype::INT8:
+      normalize_ranges<int8_t>();
+      break;
+    case Datatype::UINT8:
+      normalize_ranges<uint8_t>();
+      break;
+    case Datatype::INT16:
+      normalize_ranges<int16_t>();
+      break;
+    case Datatype::UINT16:
+      normalize_ranges<uint16_t>();
+      break;
+    case Datatype::INT32:
+      normalize_ranges<int32_t>();
+      break;
+    case Datatype::UINT32:
+      normalize_ranges<uint32_t>();
+      break;
+    case Datatype::INT64:
+      normalize_ranges<int64_t>();
+      break;
+    case Datatype::UINT64:
+      normalize_ranges<uint64_t>();
+      break;
+    case Datatype::FLOAT32:
+      normalize_ranges<float>();
+      break;
+    case Datatype::FLOAT64:
+      normalize_ranges<double>();
+      break;
+    case Datatype::DATETIME_YEAR:
+    case Datatype::DATETIME_MONTH:
+    case Datatype::DATETIME_WEEK:
+    case Datatype::DATETIME_DAY:
+    case Datatype::DATETIME_HR:
+    case Datatype::DATETIME_MIN:
+    case Datatype::DATETIME_SEC:
+    case Datatype::DATETIME_MS:
+    case Datatype::DATETIME_US:
+    case Datatype::DATETIME_NS:
+    case Datatype::DATETIME_PS:
+    case Datatype::DATETIME_FS:
+    case Datatype::DATETIME_AS:
+      normalize_ranges<int64_t>();
+      break;
+    default:
+      return LOG_STATUS(Status::SubarrayError(
+          "Cannot normalize ranges; Unsupported subarray domain type"));
+  }
+
+  return Status::Ok();
+}
+
 Status Subarray::get_est_result_size(const char* attr_name, uint64_t* size) {
   // Check attribute name
   if (attr_name == nullptr)
@@ -612,8 +734,7 @@ std::vector<uint64_t> Subarray::get_range_coords(uint64_t range_idx) const {
 
   uint64_t tmp_idx = range_idx;
   auto dim_num = this->dim_num();
-  auto cell_order = array_->array_schema()->cell_order();
-  auto layout = (layout_ == Layout::UNORDERED) ? cell_order : layout_;
+  auto layout = (layout_ == Layout::UNORDERED) ? range_cell_order() : layout_;
 
   if (layout == Layout::ROW_MAJOR) {
     for (unsigned i = 0; i < dim_num; ++i) {
@@ -664,8 +785,7 @@ std::vector<const T*> Subarray::range(uint64_t range_idx) const {
   std::vector<const T*> ret;
   uint64_t tmp_idx = range_idx;
   auto dim_num = this->dim_num();
-  auto cell_order = array_->array_schema()->cell_order();
-  auto layout = (layout_ == Layout::UNORDERED) ? cell_order : layout_;
+  auto layout = (layout_ == Layout::UNORDERED) ? range_cell_order() : layout_;
 
   if (layout == Layout::ROW_MAJOR) {
     for (unsigned i = 0; i < dim_num; ++i) {
@@ -694,8 +814,7 @@ std::vector<const void*> Subarray::range(uint64_t range_idx) const {
   std::vector<const void*> ret;
   uint64_t tmp_idx = range_idx;
   auto dim_num = this->dim_num();
-  auto cell_order = array_->array_schema()->cell_order();
-  auto layout = (layout_ == Layout::UNORDERED) ? cell_order : layout_;
+  auto layout = (layout_ == Layout::UNORDERED) ? range_cell_order() : layout_;
 
   if (layout == Layout::ROW_MAJOR) {
     for (unsigned i = 0; i < dim_num; ++i) {
@@ -720,6 +839,11 @@ std::vector<const void*> Subarray::range(uint64_t range_idx) const {
   return ret;
 }
 
+Layout Subarray::range_cell_order() const {
+  auto cell_order = array_->array_schema()->cell_order();
+  return (cell_order == Layout::HILBERT) ? Layout::ROW_MAJOR : cell_order;
+}
+
 const Subarray::Ranges* Subarray::ranges_for_dim(uint32_t dim_idx) const {
   return &ranges_[dim_idx];
 }
@@ -850,8 +974,7 @@ void Subarray::compute_range_offsets() {
   range_offsets_.clear();
 
   auto dim_num = this->dim_num();
-  auto cell_order = array_->array_schema()->cell_order();
-  auto layout = (layout_ == Layout::UNORDERED) ? cell_order : layout_;
+  auto layout = (layout_ == Layout::UNORDERED) ? range_cell_order() : layout_;
 
   if (layout == Layout::COL_MAJOR) {
     range_offsets_.push_back(1);
@@ -931,6 +1054,53 @@ Status Subarray::compute_est_result_size() {
   return Status::Ok();
 }
 
+template <class T>
+void Subarray::normalize_ranges() {
+  // Sort the ranges of each dimension, giving up on overlapping ranges
+  auto dim_num = this->dim_num();
+  std::vector<std::vector<std::pair<T, T>>> sorted(dim_num);
+  for (unsigned d = 0; d < dim_num; ++d) {
+    auto range_num = ranges_[d].range_num();
+    if (range_num < 2)
+      continue;
+    auto& dim_ranges = sorted[d];
+    dim_ranges.reserve(range_num);
+    for (uint64_t i = 0; i < range_num; ++i) {
+      auto r = (const T*)ranges_[d].get_range(i);
+      dim_ranges.emplace_back(r[0], r[1]);
+    }
+    std::sort(dim_ranges.begin(), dim_ranges.end());
+    for (size_t i = 1; i < dim_ranges.size(); ++i) {
+      if (!(dim_ranges[i - 1].second < dim_ranges[i].first))
+        return;
+    }
+  }
+
+  // Coalesce the adjacent integer ranges
+  for (unsigned d = 0; d < dim_num; ++d) {
+    auto& dim_ranges = sorted[d];
+    if (dim_ranges.empty())
+      continue;
+    Ranges ranges(ranges_[d].type_);
+    T range[2] = {dim_ranges[0].first, dim_ranges[0].second};
+    for (size_t i = 1; i < dim_ranges.size(); ++i) {
+      if (std::is_integral<T>::value && range[1] + 1 == dim_ranges[i].first) {
+        range[1] = dim_ranges[i].second;
+      } else {
+        ranges.add_range(range);
+        range[0] = dim_ranges[i].first;
+        range[1] = dim_ranges[i].second;
+      }
+    }
+    ranges.add_range(range);
+    ranges_[d] = ranges;
+  }
+
+  // Must reset the result size and tile overlap
+  est_result_size_computed_ = false;
+  tile_overlap_computed_ = false;
+}
+
 template <class T>
 Status Subarray::compute_est_result_size() {
   if (est_result_size_computed_)
@@ -997,20 +1167,23 @@ Status Subarray::compute_est_result_size(
     bool var_size,
     ResultSize* result_size) const {
   // For easy reference
-  auto fragment_num = array_->fragment_metadata().size();
+  auto fragment_metadata = array_->fragment_metadata();
+  auto fragment_num = fragment_metadata.size();
   ResultSize ret{0.0, 0.0, 0, 0};
   auto array_schema = array_->array_schema();
   auto encryption_key = array_->encryption_key();
   uint64_t size;
+  double est_cell_num = 0.0;
 
   // Compute estimated result
   for (unsigned f = 0; f < fragment_num; ++f) {
     const auto& overlap = tile_overlap_[f][range_idx];
-    auto meta = array_->fragment_metadata()[f];
+    auto meta = fragment_metadata[f];
 
     // Parse tile ranges
     for (const auto& tr : overlap.tile_ranges_) {
       for (uint64_t tid = tr.first; tid <= tr.second; ++tid) {
+        est_cell_num += meta->cell_num(tid);
         if (!var_size) {
           ret.size_fixed_ += meta->tile_size(attr_name, tid);
           ret.mem_size_fixed_ += meta->tile_size(attr_name, tid);
@@ -1029,6 +1202,7 @@ Status Subarray::compute_est_result_size(
     for (const auto& t : overlap.tiles_) {
       auto tid = t.first;
       auto ratio = t.second;
+      est_cell_num += meta->cell_num(tid) * ratio;
       if (!var_size) {
         ret.size_fixed_ += meta->tile_size(attr_name, tid) * ratio;
         ret.mem_size_fixed_ += meta->tile_size(attr_name, tid);
@@ -1043,8 +1217,10 @@ Status Subarray::compute_est_result_size(
     }
   }
 
-  // Calibrate result
-  uint64_t max_size_fixed, max_size_var = UINT64_MAX;
+  // Calibrate result. The estimated number of cells cannot exceed the
+  // number of cells in the range (e.g., due to overlapping fragments),
+  // so both the fixed and var sizes are scaled down by the same factor
+  uint64_t max_size_fixed;
   auto cell_num = this->cell_num<T>(range_idx);
   if (var_size) {
     max_size_fixed =
@@ -1053,8 +1229,23 @@ Status Subarray::compute_est_result_size(
     max_size_fixed =
         utils::math::safe_mul(cell_num, array_schema->cell_size(attr_name));
   }
+  if (est_cell_num > cell_num) {
+    auto factor = cell_num / est_cell_num;
+    ret.size_fixed_ *= factor;
+    ret.size_var_ *= factor;
+    est_cell_num = cell_num;
+  }
   ret.size_fixed_ = std::min<double>(ret.size_fixed_, max_size_fixed);
-  ret.size_var_ = std::min<double>(ret.size_var_, max_size_var);
+
+  // Dense reads return every cell of the range, filling the empty ones
+  // with a single-value fill for var-sized attributes
+  if (array_schema->dense() && cell_num != UINT64_MAX) {
+    ret.size_fixed_ = max_size_fixed;
+    if (var_size) {
+      ret.size_var_ += (cell_num - est_cell_num) *
+                       datatype_size(array_schema->type(attr_name));
+    }
+  }
 
   *result_size = ret;
 
@@ -1191,24 +1382,103 @@ Status Subarray::compute_tile_overlap() {
 
   auto encryption_key = array_->encryption_key();
 
-  // Compute estimated tile overlap in parallel over fragments and ranges
-  auto statuses = parallel_for_2d(
-      0, fragment_num, 0, range_num, [&](unsigned i, uint64_t j) {
-        auto range = this->range<T>(j);
-        if (meta[i]->dense()) {  // Dense fragment
-          tile_overlap_[i][j] = get_tile_overlap<T>(range, i);
-        } else {  // Sparse fragment
-          RETURN_NOT_OK(meta[i]->get_tile_overlap<T>(
-              *encryption_key, range, &(tile_overlap_[i][j])));
+  // Compute estimated tile overlap in parallel over the fragment and range
+  // pairs that may intersect
+  auto pairs = fragment_range_pairs<T>();
+  auto statuses = parallel_for(0, pairs.size(), [&](uint64_t p) {
+    unsigned i = pairs[p].first;
+    uint64_t j = pairs[p].second;
+    auto range = this->range<T>(j);
+    if (meta[i]->dense()) {  // Dense fragment
+      tile_overlap_[i][j] = get_tile_overlap<T>(range, meta[i]);
+    } else {  // Sparse fragment
+      RETURN_NOT_OK(meta[i]->get_tile_overlap<T>(
+          *encryption_key, range, &(tile_overlap_[i][j])));
+    }
+    return Status::Ok();
+  });
+  for (const auto& st : statuses) {
+    if (!st.ok())
+      return st;
+  }
+
+  tile_overlap_computed_ = true;
+
+  return Status::Ok();
+}
+
+template <class T>
+Status Subarray::compute_tile_overlap(const Subarray& parent) {
+  if (tile_overlap_computed_)
+    return Status::Ok();
+
+  if (!parent.tile_overlap_computed_)
+    return compute_tile_overlap<T>();
+
+  // Map every 1D range to a parent 1D range of the same dimension that
+  // contains it. The ranges of a split partition preserve the parent order,
+  // so the search starts from the previous match.
+  auto dim_num = this->dim_num();
+  std::vector<std::vector<uint64_t>> parent_ranges(dim_num);
+  for (unsigned d = 0; d < dim_num; ++d) {
+    auto range_num = ranges_[d].range_num();
+    auto parent_range_num = parent.ranges_[d].range_num();
+    uint64_t hint = 0;
+    for (uint64_t r = 0; r < range_num; ++r) {
+      auto range = (const T*)ranges_[d].get_range(r);
+      bool found = false;
+      for (uint64_t k = 0; k < parent_range_num && !found; ++k) {
+        auto idx = (hint + k) % parent_range_num;
+        auto p = (const T*)parent.ranges_[d].get_range(idx);
+        if (p[0] <= range[0] && range[1] <= p[1]) {
+          parent_ranges[d].push_back(idx);
+          hint = idx;
+          found = true;
         }
-        return Status::Ok();
-      });
+      }
+      if (!found)
+        return compute_tile_overlap<T>();
+    }
+  }
+
+  compute_range_offsets();
+  tile_overlap_.clear();
+  auto meta = array_->fragment_metadata();
+  auto fragment_num = meta.size();
+  tile_overlap_.resize(fragment_num);
+  auto range_num = this->range_num();
+  for (unsigned i = 0; i < fragment_num; ++i)
+    tile_overlap_[i].resize(range_num);
+
+  auto encryption_key = array_->encryption_key();
+
+  // Compute tile overlap in parallel over the fragment and range pairs
+  // that may intersect
+  auto pairs = fragment_range_pairs<T>();
+  auto statuses = parallel_for(0, pairs.size(), [&](uint64_t p) {
+    unsigned i = pairs[p].first;
+    uint64_t j = pairs[p].second;
+    auto range = this->range<T>(j);
+    if (meta[i]->dense()) {  // Dense fragment
+      tile_overlap_[i][j] = get_tile_overlap<T>(range, meta[i]);
+    } else {  // Sparse fragment
+      auto coords = get_range_coords(j);
+      for (unsigned d = 0; d < dim_num; ++d)
+        coords[d] = parent_ranges[d][coords[d]];
+      const auto& candidates =
+          parent.tile_overlap_[i][parent.range_idx(coords)];
+      RETURN_NOT_OK(meta[i]->get_tile_overlap<T>(
+          *encryption_key, range, candidates, &(tile_overlap_[i][j])));
+    }
+    return Status::Ok();
+  });
   for (const auto& st : statuses) {
     if (!st.ok())
       return st;
   }
 
   tile_overlap_computed_ = true;
+  STATS_COUNTER_ADD(subarray_derived_tile_overlaps, 1);
 
   return Status::Ok();
 }
@@ -1227,9 +1497,39 @@ Subarray Subarray::clone() const {
   return clone;
 }
 
+template <class T>
+std::vector<std::pair<unsigned, uint64_t>> Subarray::fragment_range_pairs()
+    const {
+  std::vector<std::pair<unsigned, uint64_t>> ret;
+  auto fragment_index = array_->fragment_index();
+  if (fragment_index == nullptr)
+    return ret;
+
+  // Query the fragment index with every range
+  auto range_num = this->range_num();
+  std::vector<std::vector<unsigned>> fids(range_num);
+  parallel_for(0, range_num, [&](uint64_t j) {
+    auto overlap = fragment_index->get_tile_overlap<T>(this->range<T>(j));
+    for (const auto& r : overlap.tile_ranges_) {
+      for (auto fid = r.first; fid <= r.second; ++fid)
+        fids[j].push_back((unsigned)fid);
+    }
+    for (const auto& t : overlap.tiles_)
+      fids[j].push_back((unsigned)t.first);
+    return Status::Ok();
+  });
+
+  for (uint64_t j = 0; j < range_num; ++j) {
+    for (auto fid : fids[j])
+      ret.emplace_back(fid, j);
+  }
+
+  return ret;
+}
+
 template <class T>
 TileOverlap Subarray::get_tile_overlap(
-    const std::vector<const T*>& range, unsigned fid) const {
+    const std::vector<const T*>& range, const FragmentMetadata* meta) const {
   TileOverlap ret;
 
   // Prepare a range copy
@@ -1242,7 +1542,6 @@ TileOverlap Subarray::get_tile_overlap(
   }
 
   // Get tile overlap from fragment
-  auto meta = array_->fragment_metadata()[fid];
   auto frag_overlap = meta->compute_overlapping_tile_ids_cov<T>(&range_cpy[0]);
 
   // Prepare ret. Contiguous tile ids with full overlap
@@ -1340,6 +1639,17 @@ template uint64_t Subarray::cell_num<uint64_t>(uint64_t range_idx) const;
 template uint64_t Subarray::cell_num<float>(uint64_t range_idx) const;
 template uint64_t Subarray::cell_num<double>(uint64_t range_idx) const;
 
+template bool Subarray::has_sorted_disjoint_ranges<int8_t>() const;
+template bool Subarray::has_sorted_disjoint_ranges<uint8_t>() const;
+template bool Subarray::has_sorted_disjoint_ranges<int16_t>() const;
+template bool Subarray::has_sorted_disjoint_ranges<uint16_t>() const;
+template bool Subarray::has_sorted_disjoint_ranges<int32_t>() const;
+template bool Subarray::has_sorted_disjoint_ranges<uint32_t>() const;
+template bool Subarray::has_sorted_disjoint_ranges<int64_t>() const;
+template bool Subarray::has_sorted_disjoint_ranges<uint64_t>() const;
+template bool Subarray::has_sorted_disjoint_ranges<float>() const;
+template bool Subarray::has_sorted_disjoint_ranges<double>() const;
+
 template void Subarray::compute_tile_coords<int8_t>();
 template void Subarray::compute_tile_coords<uint8_t>();
 template void Subarray::compute_tile_coords<int16_t>();
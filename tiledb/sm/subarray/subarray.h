@@ -49,6 +49,7 @@ namespace tiledb {
 namespace sm {
 
 class Array;
+class FragmentMetadata;
 
 enum class Layout : uint8_t;
 enum class QueryType : uint8_t;
@@ -297,6 +298,16 @@ class Subarray {
    */
   Status compute_tile_overlap();
 
+  /**
+   * Computes the tile overlap of this subarray from the already computed
+   * tile overlap of ``parent``, which must contain every range of this
+   * subarray (e.g., this subarray was split from ``parent``). Only the
+   * tiles overlapping the containing parent ranges are checked, instead of
+   * traversing the fragment R-Trees again. Falls back to a full
+   * computation if the parent overlap is not available.
+   */
+  Status compute_tile_overlap(const Subarray& parent);
+
   /**
    * Computes the estimated result size (calibrated using the maximum size)
    * for a given attribute and range id, for all fragments.
@@ -365,6 +376,13 @@ class Subarray {
    */
   bool is_unary(uint64_t range_idx) const;
 
+  /**
+   * Returns ``true`` if the ranges of each dimension are sorted and
+   * pairwise disjoint, so that every cell falls in at most one ND range.
+   */
+  template <class T>
+  bool has_sorted_disjoint_ranges() const;
+
   /**
    * Gets the estimated result size (in bytes) for the input fixed-sized
    * attribute.
@@ -421,6 +439,15 @@ class Subarray {
   /** Returns the subarray layout. */
   Layout layout() const;
 
+  /**
+   * Sorts the ranges of each dimension and coalesces the adjacent ones.
+   * This covers the same cells, but changes the order of the ranges, so
+   * it is only applicable to reads whose results are not in range order.
+   * The ranges are left unchanged if some of them overlap, since the cells
+   * in the intersection of overlapping ranges are returned once per range.
+   */
+  Status normalize_ranges();
+
   /** Returns the flattened 1D id of the range with the input coordinates. */
   uint64_t range_idx(const std::vector<uint64_t>& range_coords) const;
 
@@ -446,6 +473,13 @@ class Subarray {
    */
   std::vector<const void*> range(uint64_t range_idx) const;
 
+  /**
+   * Returns the order the ranges are linearized in when the layout is
+   * UNORDERED, i.e., the array cell order, treating the Hilbert cell
+   * order as row-major.
+   */
+  Layout range_cell_order() const;
+
   /**
    * Returns the `Ranges` for the given dimension index.
    * @note Intended for serialization only
@@ -594,6 +628,13 @@ class Subarray {
   template <class T>
   Status compute_est_result_size();
 
+  /**
+   * Sorts and coalesces the ranges of each dimension, unless some of them
+   * overlap.
+   */
+  template <class T>
+  void normalize_ranges();
+
   /**
    * Compute `tile_coords_` and `tile_coords_map_`. The coordinates will
    * be sorted on col-major tile order.
@@ -619,21 +660,38 @@ class Subarray {
   template <class T>
   Status compute_tile_overlap();
 
+  /**
+   * Computes the tile overlap with all subarray ranges for all fragments,
+   * from the tile overlap of a parent subarray that contains this one.
+   */
+  template <class T>
+  Status compute_tile_overlap(const Subarray& parent);
+
   /** Returns a deep copy of this Subarray. */
   Subarray clone() const;
 
+  /**
+   * Returns the (fragment id, range id) pairs whose fragment non-empty
+   * domain intersects the range, as found by the fragment index of the
+   * array. The tile overlap of all other pairs is empty.
+   *
+   * @tparam T The domain data type.
+   */
+  template <class T>
+  std::vector<std::pair<unsigned, uint64_t>> fragment_range_pairs() const;
+
   /**
    * Compute the tile overlap between ``range`` and the non-empty domain
    * of the input fragment. Applicable only to dense fragments.
    *
    * @tparam T The domain data type.
    * @param range The range to compute the overlap with.
-   * @param fid The id of the fragment to focus on.
+   * @param meta The metadata of the fragment to focus on.
    * @return The tile overlap.
    */
   template <class T>
   TileOverlap get_tile_overlap(
-      const std::vector<const T*>& range, unsigned fid) const;
+      const std::vector<const T*>& range, const FragmentMetadata* meta) const;
 
   /**
    * Swaps the contents (all field values) of this subarray with the
@@ -36,7 +36,11 @@
 #include "tiledb/sm/array_schema/attribute.h"
 #include "tiledb/sm/array_schema/domain.h"
 #include "tiledb/sm/enums/layout.h"
+#include "tiledb/sm/fragment/fragment_metadata.h"
+#include "tiledb/sm/misc/constants.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iomanip>
 
 /* ****************************** */
@@ -302,6 +306,36 @@ Status SubarrayPartitioner::next(bool* unsplittable) {
   return next_from_multi_range<T>(unsplittable);
 }
 
+Status SubarrayPartitioner::next(Subarray* partition, bool* unsplittable) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  *unsplittable = false;
+
+  if (done()) {
+    *partition = Subarray();
+    return Status::Ok();
+  }
+
+  RETURN_NOT_OK(next(unsplittable));
+  *partition = current_.partition_;
+
+  return Status::Ok();
+}
+
+Status SubarrayPartitioner::partitions(
+    std::vector<Subarray>* partitions, bool* unsplittable) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  *unsplittable = false;
+
+  bool partition_unsplittable;
+  while (!done()) {
+    RETURN_NOT_OK(next(&partition_unsplittable));
+    *unsplittable = *unsplittable || partition_unsplittable;
+    partitions->push_back(current_.partition_);
+  }
+
+  return Status::Ok();
+}
+
 Status SubarrayPartitioner::set_result_budget(
     const char* attr_name, uint64_t budget) {
   // Check attribute name
@@ -363,6 +397,11 @@ Status SubarrayPartitioner::set_memory_budget(
   return Status::Ok();
 }
 
+Status SubarrayPartitioner::set_balanced_splits(bool balanced_splits) {
+  balanced_splits_ = balanced_splits;
+  return Status::Ok();
+}
+
 template <class T>
 Status SubarrayPartitioner::split_current(bool* unsplittable) {
   *unsplittable = false;
@@ -439,7 +478,7 @@ void SubarrayPartitioner::calibrate_current_start_end(bool* must_split_slab) {
   }
 
   auto layout = subarray_.layout();
-  auto cell_order = subarray_.array()->array_schema()->cell_order();
+  auto cell_order = subarray_.range_cell_order();
   layout = (layout == Layout::UNORDERED) ? cell_order : layout;
   assert(layout == Layout::ROW_MAJOR || layout == Layout::COL_MAJOR);
 
@@ -516,6 +555,7 @@ SubarrayPartitioner SubarrayPartitioner::clone() const {
   clone.state_ = state_;
   clone.memory_budget_ = memory_budget_;
   clone.memory_budget_var_ = memory_budget_var_;
+  clone.balanced_splits_ = balanced_splits_;
 
   return clone;
 }
@@ -623,8 +663,137 @@ void SubarrayPartitioner::compute_splitting_point_on_tiles(
   }
 }
 
-// TODO (sp): in the future this can be more sophisticated, taking into
-// TODO (sp): account MBRs (i.e., the distirbution of the data) as well
+template <class T>
+bool SubarrayPartitioner::compute_balanced_splitting_point(
+    const Subarray& range, unsigned dim, T* splitting_point) const {
+  // For easy reference
+  auto domain = subarray_.array()->array_schema()->domain();
+  auto dim_num = domain->dim_num();
+  auto meta = subarray_.array()->fragment_metadata();
+  const auto& tile_overlap = range.tile_overlap();
+  const void* r_v;
+  range.get_range(dim, 0, &r_v);
+  auto r = (const T*)r_v;
+
+  // Collect the extents on `dim` of the overlapping tiles, clamped to the
+  // range, weighted by their estimated result cells. This applies only
+  // if the range overlaps sparse fragments alone.
+  struct TileExtent {
+    T low_;
+    T high_;
+    double cell_num_;
+  };
+  std::vector<TileExtent> tiles;
+  bool use_mbrs = tile_overlap.size() == meta.size();
+  std::vector<T> mbr(2 * dim_num);
+  for (size_t f = 0; use_mbrs && f < meta.size(); ++f) {
+    if (tile_overlap[f].size() != 1) {
+      use_mbrs = false;
+      break;
+    }
+    const auto& overlap = tile_overlap[f][0];
+    if (overlap.tiles_.empty() && overlap.tile_ranges_.empty())
+      continue;
+    if (meta[f]->dense()) {
+      use_mbrs = false;
+      break;
+    }
+
+    auto add_tile = [&](uint64_t tid, double ratio) {
+      meta[f]->mbr(tid, &mbr[0]);
+      tiles.push_back({std::max(mbr[2 * dim], r[0]),
+                       std::min(mbr[2 * dim + 1], r[1]),
+                       ratio * meta[f]->cell_num(tid)});
+    };
+    for (const auto& t : overlap.tiles_)
+      add_tile(t.first, t.second);
+    for (const auto& tr : overlap.tile_ranges_) {
+      for (uint64_t tid = tr.first; tid <= tr.second; ++tid)
+        add_tile(tid, 1.0);
+    }
+    if (tiles.size() > constants::partition_split_max_tiles)
+      use_mbrs = false;
+  }
+
+  if (use_mbrs && !tiles.empty()) {
+    // Sort the tile bounds and sum the cells up to each of them
+    auto tile_num = tiles.size();
+    std::vector<std::pair<T, double>> lows(tile_num), highs(tile_num);
+    for (size_t t = 0; t < tile_num; ++t) {
+      lows[t] = {tiles[t].low_, tiles[t].cell_num_};
+      highs[t] = {tiles[t].high_, tiles[t].cell_num_};
+    }
+    std::sort(lows.begin(), lows.end());
+    std::sort(highs.begin(), highs.end());
+    std::vector<double> lows_sum(tile_num + 1, 0.0);
+    std::vector<double> highs_sum(tile_num + 1, 0.0);
+    for (size_t t = 0; t < tile_num; ++t) {
+      lows_sum[t + 1] = lows_sum[t] + lows[t].second;
+      highs_sum[t + 1] = highs_sum[t] + highs[t].second;
+    }
+    auto total = highs_sum[tile_num];
+
+    // Every upper tile bound inside the range is a candidate point. The
+    // cells of the tiles that straddle it are fetched by both halves, so
+    // they count twice against the balance of the two halves.
+    auto not_after = [](const std::pair<T, double>& a, T v) {
+      return a.first <= v;
+    };
+    bool found = false;
+    double best_cost = 0.0;
+    for (size_t t = 0; t < tile_num; ++t) {
+      auto point = highs[t].first;
+      if (point >= r[1] || (t + 1 < tile_num && highs[t + 1].first == point))
+        continue;
+      auto left = highs_sum[t + 1];
+      auto l = std::lower_bound(lows.begin(), lows.end(), point, not_after);
+      auto right = total - lows_sum[l - lows.begin()];
+      auto straddling = total - left - right;
+      auto cost = std::fabs(left - right) + 2 * straddling;
+      if (!found || cost < best_cost) {
+        found = true;
+        best_cost = cost;
+        *splitting_point = point;
+      }
+    }
+    if (found)
+      return true;
+  }
+
+  // Split on the space tile boundary closest to the midpoint, if any lies
+  // inside the range
+  auto tile_extents = (const T*)domain->tile_extents();
+  if (tile_extents == nullptr)
+    return false;
+  auto extent = tile_extents[dim];
+  T mid = r[0] + (r[1] - r[0]) / 2;
+  T boundaries[2];
+  unsigned boundary_num = 0;
+  boundaries[boundary_num++] = domain->floor_to_tile(mid, dim);
+  if (boundaries[0] <= std::numeric_limits<T>::max() - extent)
+    boundaries[boundary_num++] = boundaries[0] + extent;
+
+  bool found = false;
+  double best_dist = 0.0;
+  for (unsigned b = 0; b < boundary_num; ++b) {
+    if (boundaries[b] <= r[0] || boundaries[b] > r[1])
+      continue;
+    T point;
+    if (std::numeric_limits<T>::is_integer)
+      point = boundaries[b] - 1;
+    else
+      point = std::nextafter(boundaries[b], std::numeric_limits<T>::lowest());
+    auto dist = std::fabs((double)point - (double)mid);
+    if (!found || dist < best_dist) {
+      found = true;
+      best_dist = dist;
+      *splitting_point = point;
+    }
+  }
+
+  return found;
+}
+
 template <class T>
 void SubarrayPartitioner::compute_splitting_point_single_range(
     const Subarray& range,
@@ -639,12 +808,19 @@ void SubarrayPartitioner::compute_splitting_point_single_range(
     if (!*unsplittable)
       return;  // Splitting dim/point found
     // Else `range` is contained within a tile.
+
+    // The Hilbert curve does not visit the two halves of a range split on
+    // a dimension one after the other, so the cells of a tile cannot be
+    // split into partitions that follow the global order
+    if (subarray_.array()->array_schema()->cell_order() == Layout::HILBERT)
+      return;
+
     // The rest of the function will find the splitting dim/point
   }
 
   // For easy reference
   auto dim_num = subarray_.array()->array_schema()->dim_num();
-  auto cell_order = subarray_.array()->array_schema()->cell_order();
+  auto cell_order = subarray_.range_cell_order();
   assert(!range.is_unary());
   auto layout = subarray_.layout();
   layout = (layout == Layout::UNORDERED || layout == Layout::GLOBAL_ORDER) ?
@@ -668,6 +844,11 @@ void SubarrayPartitioner::compute_splitting_point_single_range(
     auto r = (T*)r_v;
     if (std::memcmp(r, &r[1], sizeof(T)) != 0) {
       *splitting_dim = i;
+      if (balanced_splits_ &&
+          compute_balanced_splitting_point(range, i, splitting_point)) {
+        *unsplittable = false;
+        break;  // Splitting dim/point found
+      }
       *splitting_point = r[0] + (r[1] - r[0]) / 2;
       *unsplittable = !std::memcmp(splitting_point, &r[1], sizeof(T));
       if (!*unsplittable)
@@ -697,7 +878,7 @@ void SubarrayPartitioner::compute_splitting_point_multi_range(
   // Multi-range partition
   auto layout = subarray_.layout();
   auto dim_num = subarray_.array()->array_schema()->dim_num();
-  auto cell_order = subarray_.array()->array_schema()->cell_order();
+  auto cell_order = subarray_.range_cell_order();
   layout = (layout == Layout::UNORDERED) ? cell_order : layout;
   const void* r_v;
   *splitting_dim = UINT32_MAX;
@@ -879,6 +1060,10 @@ Status SubarrayPartitioner::split_top_single_range(bool* unsplittable) {
     }
   }
 
+  // Derive the tile overlap of the new ranges from the split range
+  RETURN_NOT_OK(r1.compute_tile_overlap(range));
+  RETURN_NOT_OK(r2.compute_tile_overlap(range));
+
   // Update list
   state_.single_range_.pop_front();
   state_.single_range_.push_front(std::move(r2));
@@ -949,6 +1134,10 @@ Status SubarrayPartitioner::split_top_multi_range(bool* unsplittable) {
     }
   }
 
+  // Derive the tile overlap of the new partitions from the split partition
+  RETURN_NOT_OK(p1.compute_tile_overlap(partition));
+  RETURN_NOT_OK(p2.compute_tile_overlap(partition));
+
   // Update list
   state_.multi_range_.pop_front();
   state_.multi_range_.push_front(std::move(p2));
@@ -964,6 +1153,7 @@ void SubarrayPartitioner::swap(SubarrayPartitioner& partitioner) {
   std::swap(state_, partitioner.state_);
   std::swap(memory_budget_, partitioner.memory_budget_);
   std::swap(memory_budget_var_, partitioner.memory_budget_var_);
+  std::swap(balanced_splits_, partitioner.balanced_splits_);
 }
 
 // Explicit template instantiations
@@ -34,7 +34,7 @@
 #define TILEDB_SUBARRAY_PARTITIONER_H
 
 #include <list>
-
+#include <mutex>
 #include <unordered_map>
 #include "tiledb/sm/misc/constants.h"
 #include "tiledb/sm/subarray/subarray.h"
@@ -231,6 +231,23 @@ class SubarrayPartitioner {
   template <class T>
   Status next(bool* unsplittable);
 
+  /**
+   * Thread-safe variant of ``next``, which advances to the next partition
+   * and copies it into ``partition``. This allows several threads to
+   * retrieve partitions from the same partitioner and read them
+   * concurrently, e.g., with separate queries on the same open array.
+   * If there are no more partitions, ``partition`` is set to an empty
+   * subarray.
+   */
+  Status next(Subarray* partition, bool* unsplittable);
+
+  /**
+   * Enumerates all the remaining partitions up front, so that they can be
+   * read independently and in any order. ``unsplittable`` is set to
+   * ``true`` if some partition could not be split to fit the budget.
+   */
+  Status partitions(std::vector<Subarray>* partitions, bool* unsplittable);
+
   /**
    * Sets the memory budget (in bytes).
    *
@@ -241,6 +258,13 @@ class SubarrayPartitioner {
    */
   Status set_memory_budget(uint64_t budget, uint64_t budget_var);
 
+  /**
+   * Sets whether ranges are split on tile boundaries, balancing the
+   * estimated result cells of the two halves, instead of at their midpoint
+   * (see `sm.partitioner.balanced_splits`).
+   */
+  Status set_balanced_splits(bool balanced_splits);
+
   /** Sets result size budget (in bytes) for the input fixed-sized attribute. */
   Status set_result_budget(const char* attr_name, uint64_t budget);
 
@@ -295,6 +319,15 @@ class SubarrayPartitioner {
   /** The memory budget for the var-sized attributes. */
   uint64_t memory_budget_var_;
 
+  /**
+   * If `true`, single ranges are split on MBR or space tile boundaries
+   * instead of at their midpoint.
+   */
+  bool balanced_splits_ = false;
+
+  /** Protects the partitioner state in the thread-safe functions. */
+  std::mutex mtx_;
+
   /* ********************************* */
   /*           PRIVATE METHODS         */
   /* ********************************* */
@@ -346,6 +379,21 @@ class SubarrayPartitioner {
       T* splitting_point,
       bool* unsplittable);
 
+  /**
+   * Computes a splitting point of `range` on dimension `dim` that falls on
+   * a tile boundary, so that no tile is split across the two halves.
+   *
+   * If the range overlaps sparse fragments only, the point is the upper
+   * MBR bound on `dim` that best balances the estimated result cells of
+   * the two halves, penalizing the cells of the tiles that straddle it.
+   * Otherwise, it is the space tile boundary closest to the midpoint.
+   *
+   * @return `false` if no such point lies inside the range.
+   */
+  template <class T>
+  bool compute_balanced_splitting_point(
+      const Subarray& range, unsigned dim, T* splitting_point) const;
+
   /**
    * Computes the splitting point and dimension for the input range.
    * In case of real domains, if this function may not be able to find a
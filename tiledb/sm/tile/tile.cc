@@ -180,6 +180,8 @@ Tile Tile::clone(bool deep_copy) const {
   clone.dim_num_ = dim_num_;
   clone.filtered_ = filtered_;
   clone.format_version_ = format_version_;
+  clone.mapped_region_ = mapped_region_;
+  clone.cached_data_ = cached_data_;
   clone.pre_filtered_size_ = pre_filtered_size_;
   clone.type_ = type_;
 
@@ -234,6 +236,14 @@ bool Tile::full() const {
          (buffer_->offset() == buffer_->alloced_size());
 }
 
+const std::shared_ptr<MappedRegion>& Tile::mapped_region() const {
+  return mapped_region_;
+}
+
+const std::shared_ptr<const Buffer>& Tile::cached_data() const {
+  return cached_data_;
+}
+
 uint64_t Tile::offset() const {
   return buffer_->offset();
 }
@@ -279,6 +289,43 @@ void Tile::set_filtered(bool filtered) {
   filtered_ = filtered;
 }
 
+Status Tile::set_mapped_region(const std::shared_ptr<MappedRegion>& region) {
+  if (buffer_ == nullptr)
+    return LOG_STATUS(
+        Status::TileError("Cannot set mapped region; Tile has null buffer"));
+
+  Buffer view(region->data(), region->size());
+  RETURN_NOT_OK(buffer_->swap(view));
+  mapped_region_ = region;
+
+  return Status::Ok();
+}
+
+Status Tile::set_cached_data(
+    const std::shared_ptr<const Buffer>& data, bool filtered) {
+  if (buffer_ == nullptr)
+    return LOG_STATUS(
+        Status::TileError("Cannot set cached data; Tile has null buffer"));
+
+  Buffer view(data->data(), data->size());
+  RETURN_NOT_OK(buffer_->swap(view));
+  cached_data_ = data;
+  filtered_ = filtered;
+
+  return Status::Ok();
+}
+
+Status Tile::set_borrowed_data(void* data, uint64_t size) {
+  if (buffer_ == nullptr)
+    return LOG_STATUS(
+        Status::TileError("Cannot set borrowed data; Tile has null buffer"));
+
+  Buffer view(data, size);
+  RETURN_NOT_OK(buffer_->swap(view));
+
+  return Status::Ok();
+}
+
 void Tile::set_offset(uint64_t offset) {
   buffer_->set_offset(offset);
 }
@@ -368,6 +415,8 @@ void Tile::swap(Tile& tile) {
   std::swap(dim_num_, tile.dim_num_);
   std::swap(filtered_, tile.filtered_);
   std::swap(format_version_, tile.format_version_);
+  std::swap(mapped_region_, tile.mapped_region_);
+  std::swap(cached_data_, tile.cached_data_);
   std::swap(owns_buff_, tile.owns_buff_);
   std::swap(pre_filtered_size_, tile.pre_filtered_size_);
   std::swap(type_, tile.type_);
@@ -36,9 +36,11 @@
 #include "tiledb/sm/array_schema/attribute.h"
 #include "tiledb/sm/buffer/buffer.h"
 #include "tiledb/sm/buffer/const_buffer.h"
+#include "tiledb/sm/filesystem/mapped_region.h"
 #include "tiledb/sm/misc/status.h"
 
 #include <cinttypes>
+#include <memory>
 
 namespace tiledb {
 namespace sm {
@@ -200,6 +202,12 @@ class Tile {
   /** Checks if the tile is full. */
   bool full() const;
 
+  /** Returns the memory-mapped region backing the tile data, if any. */
+  const std::shared_ptr<MappedRegion>& mapped_region() const;
+
+  /** Returns the tile cache object backing the tile data, if any. */
+  const std::shared_ptr<const Buffer>& cached_data() const;
+
   /** The current offset in the tile. */
   uint64_t offset() const;
 
@@ -237,6 +245,29 @@ class Tile {
   /** Set the filtered state of the tile. */
   void set_filtered(bool filtered);
 
+  /**
+   * Points the tile buffer at the data of the input memory-mapped region
+   * instead of copying it. The tile keeps the region mapped for as long as
+   * it (or any clone) is alive.
+   */
+  Status set_mapped_region(const std::shared_ptr<MappedRegion>& region);
+
+  /**
+   * Points the tile buffer at the data of the input (immutable) tile cache
+   * object instead of copying it, and marks the tile as filtered unless the
+   * object holds the filtered (persisted) bytes of the tile. The tile keeps
+   * the object pinned for as long as it (or any clone) is alive.
+   */
+  Status set_cached_data(
+      const std::shared_ptr<const Buffer>& data, bool filtered = true);
+
+  /**
+   * Points the tile buffer at the input memory instead of copying it. The
+   * tile does not own the memory, which must outlive the tile buffer, e.g.,
+   * until filtering replaces the buffer with the filtered data.
+   */
+  Status set_borrowed_data(void* data, uint64_t size);
+
   /** Sets the tile offset. */
   void set_offset(uint64_t offset);
 
@@ -319,6 +350,12 @@ class Tile {
   /** The format version of the data in this tile. */
   uint32_t format_version_;
 
+  /** The memory-mapped region the tile buffer points into (if any). */
+  std::shared_ptr<MappedRegion> mapped_region_;
+
+  /** The tile cache object the tile buffer points into (if any). */
+  std::shared_ptr<const Buffer> cached_data_;
+
   /**
    * If *true* the tile object will delete *buff* upon
    * destruction, otherwise it will not delete it.
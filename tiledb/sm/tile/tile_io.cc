@@ -41,6 +41,8 @@
 #include "tiledb/sm/storage_manager/storage_manager.h"
 #include "tiledb/sm/tile/tile.h"
 
+#include <algorithm>
+
 namespace tiledb {
 namespace sm {
 
@@ -122,14 +124,28 @@ Status TileIO::read_generic(
   auto tile_data_offset =
       GenericTileHeader::BASE_SIZE + header.filter_pipeline_size;
 
-  // Read the tile.
-  RETURN_NOT_OK_ELSE(
-      storage_manager_->read(
-          uri_,
-          file_offset + tile_data_offset,
-          (*tile)->buffer(),
-          header.persisted_size),
-      delete *tile);
+  // Read the tile, or map it if enabled for the file. A tile stored
+  // unfiltered in a single chunk is then used in place.
+  auto vfs = storage_manager_->vfs();
+  if (header.persisted_size > 0 && vfs->mmap_enabled(uri_)) {
+    std::shared_ptr<MappedRegion> region;
+    RETURN_NOT_OK_ELSE(
+        vfs->map_region(
+            uri_,
+            file_offset + tile_data_offset,
+            header.persisted_size,
+            &region),
+        delete *tile);
+    RETURN_NOT_OK_ELSE((*tile)->set_mapped_region(region), delete *tile);
+  } else {
+    RETURN_NOT_OK_ELSE(
+        storage_manager_->read(
+            uri_,
+            file_offset + tile_data_offset,
+            (*tile)->buffer(),
+            header.persisted_size),
+        delete *tile);
+  }
 
   // Filter
   RETURN_NOT_OK_ELSE(header.filters.run_reverse(*tile), delete *tile);
@@ -154,14 +170,8 @@ Status TileIO::read_generic_tile_header(
       uri, file_offset, header_buff.get(), GenericTileHeader::BASE_SIZE));
 
   // Read header individual values
-  RETURN_NOT_OK(header_buff->read(&header->version_number, sizeof(uint32_t)));
-  RETURN_NOT_OK(header_buff->read(&header->persisted_size, sizeof(uint64_t)));
-  RETURN_NOT_OK(header_buff->read(&header->tile_size, sizeof(uint64_t)));
-  RETURN_NOT_OK(header_buff->read(&header->datatype, sizeof(uint8_t)));
-  RETURN_NOT_OK(header_buff->read(&header->cell_size, sizeof(uint64_t)));
-  RETURN_NOT_OK(header_buff->read(&header->encryption_type, sizeof(uint8_t)));
-  RETURN_NOT_OK(
-      header_buff->read(&header->filter_pipeline_size, sizeof(uint32_t)));
+  ConstBuffer base_buff(header_buff->data(), header_buff->size());
+  RETURN_NOT_OK(read_generic_tile_header_base(&base_buff, header));
 
   // Read header filter pipeline.
   header_buff->reset_size();
@@ -181,8 +191,75 @@ Status TileIO::read_generic_tile_header(
   return Status::Ok();
 }
 
+Status TileIO::read_generic(
+    Tile** tile,
+    uint64_t file_offset,
+    const EncryptionKey& encryption_key,
+    const Buffer& file_buff,
+    uint64_t buff_offset) {
+  STATS_FUNC_IN(tileio_read_generic);
+
+  if (file_offset < buff_offset ||
+      file_offset - buff_offset + GenericTileHeader::BASE_SIZE >
+          file_buff.size())
+    return LOG_STATUS(Status::TileIOError(
+        "Error reading generic tile; tile header out of buffer bounds"));
+  ConstBuffer cbuff(
+      file_buff.data(file_offset - buff_offset),
+      file_buff.size() - (file_offset - buff_offset));
+
+  // Read header
+  GenericTileHeader header;
+  RETURN_NOT_OK(read_generic_tile_header_base(&cbuff, &header));
+  if (cbuff.nbytes_left_to_read() <
+      (uint64_t)header.filter_pipeline_size + header.persisted_size)
+    return LOG_STATUS(Status::TileIOError(
+        "Error reading generic tile; tile out of buffer bounds"));
+  ConstBuffer filters_buff(cbuff.cur_data(), header.filter_pipeline_size);
+  RETURN_NOT_OK(header.filters.deserialize(&filters_buff));
+  cbuff.advance_offset(header.filter_pipeline_size);
+
+  if (encryption_key.encryption_type() !=
+      (EncryptionType)header.encryption_type)
+    return LOG_STATUS(Status::TileIOError(
+        "Error reading generic tile; tile is encrypted with " +
+        encryption_type_str((EncryptionType)header.encryption_type) +
+        " but given key is for " +
+        encryption_type_str(encryption_key.encryption_type())));
+
+  RETURN_NOT_OK(configure_encryption_filter(&header, encryption_key));
+
+  *tile = new Tile();
+  RETURN_NOT_OK_ELSE(
+      (*tile)->init(
+          header.version_number,
+          (Datatype)header.datatype,
+          header.cell_size,
+          0),
+      delete *tile);
+
+  // Copy the tile
+  auto tile_buff = (*tile)->buffer();
+  RETURN_NOT_OK_ELSE(
+      tile_buff->write(cbuff.cur_data(), header.persisted_size), delete *tile);
+  tile_buff->reset_offset();
+
+  // Filter
+  RETURN_NOT_OK_ELSE(header.filters.run_reverse(*tile), delete *tile);
+
+  file_size_ = header.persisted_size;
+  STATS_COUNTER_ADD(tileio_read_num_resulting_bytes, (*tile)->size());
+
+  return Status::Ok();
+
+  STATS_FUNC_OUT(tileio_read_generic);
+}
+
 Status TileIO::write_generic(
-    Tile* tile, const EncryptionKey& encryption_key, uint64_t* nbytes) {
+    Tile* tile,
+    const EncryptionKey& encryption_key,
+    uint64_t* nbytes,
+    bool unfiltered) {
   STATS_FUNC_IN(tileio_write_generic);
 
   // Reset the tile and buffer offset
@@ -192,7 +269,8 @@ Status TileIO::write_generic(
 
   // Create a header
   GenericTileHeader header;
-  RETURN_NOT_OK(init_generic_tile_header(tile, &header, encryption_key));
+  RETURN_NOT_OK(
+      init_generic_tile_header(tile, &header, encryption_key, unfiltered));
 
   // Filter tile
   RETURN_NOT_OK(header.filters.run_forward(tile));
@@ -255,6 +333,18 @@ Status TileIO::write_generic_tile_header(GenericTileHeader* header) {
   return st;
 }
 
+Status TileIO::read_generic_tile_header_base(
+    ConstBuffer* buff, GenericTileHeader* header) {
+  RETURN_NOT_OK(buff->read(&header->version_number, sizeof(uint32_t)));
+  RETURN_NOT_OK(buff->read(&header->persisted_size, sizeof(uint64_t)));
+  RETURN_NOT_OK(buff->read(&header->tile_size, sizeof(uint64_t)));
+  RETURN_NOT_OK(buff->read(&header->datatype, sizeof(uint8_t)));
+  RETURN_NOT_OK(buff->read(&header->cell_size, sizeof(uint64_t)));
+  RETURN_NOT_OK(buff->read(&header->encryption_type, sizeof(uint8_t)));
+  RETURN_NOT_OK(buff->read(&header->filter_pipeline_size, sizeof(uint32_t)));
+  return Status::Ok();
+}
+
 Status TileIO::configure_encryption_filter(
     GenericTileHeader* header, const EncryptionKey& encryption_key) const {
   switch ((EncryptionType)header->encryption_type) {
@@ -280,15 +370,21 @@ Status TileIO::configure_encryption_filter(
 Status TileIO::init_generic_tile_header(
     Tile* tile,
     GenericTileHeader* header,
-    const EncryptionKey& encryption_key) const {
+    const EncryptionKey& encryption_key,
+    bool unfiltered) const {
   header->tile_size = tile->size();
   header->datatype = (uint8_t)tile->type();
   header->cell_size = tile->cell_size();
   header->encryption_type = (uint8_t)encryption_key.encryption_type();
 
-  RETURN_NOT_OK(header->filters.add_filter(CompressionFilter(
-      constants::generic_tile_compressor,
-      constants::generic_tile_compression_level)));
+  if (unfiltered) {
+    header->filters.set_max_chunk_size((uint32_t)std::max<uint64_t>(
+        1, std::min<uint64_t>(tile->size(), UINT32_MAX)));
+  } else {
+    RETURN_NOT_OK(header->filters.add_filter(CompressionFilter(
+        constants::generic_tile_compressor,
+        constants::generic_tile_compression_level)));
+  }
 
   RETURN_NOT_OK(FilterPipeline::append_encryption_filter(
       &header->filters, encryption_key));
@@ -144,6 +144,26 @@ class TileIO {
   Status read_generic(
       Tile** tile, uint64_t file_offset, const EncryptionKey& encryption_key);
 
+  /**
+   * Reads a generic tile like `read_generic`, but from an in-memory copy
+   * of a region of the file (e.g., read in a single request along with
+   * other tiles), without accessing storage.
+   *
+   * @param tile The tile that will hold the read data.
+   * @param file_offset The offset of the tile in the file.
+   * @param encryption_key The encryption key to use.
+   * @param file_buff The bytes of the file region, which must contain the
+   *     whole tile.
+   * @param buff_offset The offset of the file region in the file.
+   * @return Status
+   */
+  Status read_generic(
+      Tile** tile,
+      uint64_t file_offset,
+      const EncryptionKey& encryption_key,
+      const Buffer& file_buff,
+      uint64_t buff_offset);
+
   /**
    * Reads the generic tile header from the file.
    *
@@ -170,10 +190,15 @@ class TileIO {
    * @param tile The tile to be written.
    * @param encryption_key The encryption key to use.
    * @param nbytes The total number of bytes written to the file.
+   * @param unfiltered If `true`, the tile is not compressed and is stored
+   *     in a single chunk, so that it can be used in place when mapped.
    * @return Status
    */
   Status write_generic(
-      Tile* tile, const EncryptionKey& encryption_key, uint64_t* nbytes);
+      Tile* tile,
+      const EncryptionKey& encryption_key,
+      uint64_t* nbytes,
+      bool unfiltered = false);
 
   /**
    * Writes the generic tile header to the file.
@@ -197,6 +222,13 @@ class TileIO {
   /** The file URI. */
   URI uri_;
 
+  /**
+   * Deserializes the non-filters part of a generic tile header (of size
+   * `GenericTileHeader::BASE_SIZE`) from the input buffer.
+   */
+  static Status read_generic_tile_header_base(
+      ConstBuffer* buff, GenericTileHeader* header);
+
   /**
    * Configures the header's encryption filter with the given key.
    *
@@ -215,12 +247,14 @@ class TileIO {
    * @param tile The tile to initialize a header for
    * @param header The header to initialize
    * @param encryption_key The encryption key to use.
+   * @param unfiltered Whether the tile is stored uncompressed, in one chunk.
    * @return Status
    */
   Status init_generic_tile_header(
       Tile* tile,
       GenericTileHeader* header,
-      const EncryptionKey& encryption_key) const;
+      const EncryptionKey& encryption_key,
+      bool unfiltered) const;
 };
 
 }  // namespace sm
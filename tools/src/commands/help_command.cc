@@ -50,6 +50,10 @@ void HelpCommand::run(const std::map<std::string, clipp::group>& group_help) {
     description = "Displays help about a specific command.";
   } else if (command_ == "info") {
     description = "Displays information about a TileDB array.";
+  } else if (command_ == "profile") {
+    description =
+        "Runs a read query on a TileDB array with stats enabled and prints "
+        "where its time and bytes went.";
   } else if (command_ == "all") {
     description =
         "Command-line interface for performing common TileDB tasks. Choose a "
@@ -39,11 +39,16 @@
 #include "tiledb/sm/encryption/encryption_key.h"
 #include "tiledb/sm/enums/encryption_type.h"
 #include "tiledb/sm/enums/query_type.h"
+#include "tiledb/sm/fragment/fragment_info.h"
 #include "tiledb/sm/fragment/fragment_metadata.h"
 #include "tiledb/sm/storage_manager/storage_manager.h"
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <map>
 #include <sstream>
 
 namespace tiledb {
@@ -51,6 +56,40 @@ namespace cli {
 
 using namespace tiledb::sm;
 
+namespace {
+
+/** Formats a number of bytes with a binary unit. */
+std::string format_bytes(double bytes) {
+  static const char* units[] = {"B", "KB", "MB", "GB", "TB"};
+  unsigned unit = 0;
+  while (bytes >= 1024 && unit < 4) {
+    bytes /= 1024;
+    unit++;
+  }
+  std::stringstream ss;
+  ss << std::setprecision(4) << bytes << " " << units[unit];
+  return ss.str();
+}
+
+/**
+ * Returns the volume of the intersection of two domains given as doubles,
+ * counting the cells of integer domains.
+ */
+double intersection_volume(
+    const std::vector<double>& a, const std::vector<double>& b, bool integer) {
+  double volume = 1;
+  for (size_t i = 0; i < a.size(); i += 2) {
+    const double low = std::max(a[i], b[i]);
+    const double high = std::min(a[i + 1], b[i + 1]);
+    if (low > high)
+      return 0;
+    volume *= high - low + (integer ? 1 : 0);
+  }
+  return volume;
+}
+
+}  // namespace
+
 clipp::group InfoCommand::get_cli() {
   using namespace clipp;
   auto array_arg =
@@ -83,7 +122,12 @@ clipp::group InfoCommand::get_cli() {
        option("-o", "--output").doc("Path to write output text file") &
            value("path", output_path_));
 
-  auto cli = schema_info | tile_sizes | dump_mbrs | svg_mbrs;
+  auto fragments =
+      "fragments: Reports the health of the array's fragments and "
+      "recommends consolidation settings." %
+      (command("fragments").set(type_, InfoType::Fragments), array_arg);
+
+  auto cli = schema_info | tile_sizes | dump_mbrs | svg_mbrs | fragments;
   return cli;
 }
 
@@ -103,6 +147,9 @@ void InfoCommand::run() {
     case InfoType::ArraySchema:
       print_schema_info();
       break;
+    case InfoType::Fragments:
+      print_fragment_health();
+      break;
   }
 }
 
@@ -193,6 +240,198 @@ void InfoCommand::print_schema_info() const {
   THROW_NOT_OK(array.close());
 }
 
+void InfoCommand::print_fragment_health() const {
+  StorageManager sm;
+  THROW_NOT_OK(sm.init(nullptr));
+
+  // Open the array
+  URI uri(array_uri_);
+  Array array(uri, &sm);
+  THROW_NOT_OK(
+      array.open(QueryType::READ, EncryptionType::NO_ENCRYPTION, nullptr, 0));
+  EncryptionKey enc_key;
+
+  const auto* schema = array.array_schema();
+  const auto dim_num = schema->dim_num();
+  const auto coords_type = schema->coords_type();
+  const bool integer =
+      coords_type != Datatype::FLOAT32 && coords_type != Datatype::FLOAT64;
+  std::vector<FragmentInfo> fragment_info;
+  THROW_NOT_OK(sm.get_fragment_info(
+      schema, array.timestamp(), enc_key, &fragment_info));
+  auto fragment_metadata = array.fragment_metadata();
+  const size_t fragment_num = fragment_info.size();
+
+  std::cout << "Array URI: " << uri.to_string() << std::endl;
+  std::cout << "Fragments: " << fragment_num << std::endl;
+  if (fragment_num == 0) {
+    THROW_NOT_OK(array.close());
+    return;
+  }
+
+  // Report the distribution of the fragment sizes.
+  std::vector<uint64_t> sizes;
+  uint64_t total_size = 0;
+  size_t sparse_num = 0;
+  for (const auto& info : fragment_info) {
+    sizes.push_back(info.fragment_size_);
+    total_size += info.fragment_size_;
+    sparse_num += info.sparse_ ? 1 : 0;
+  }
+  std::sort(sizes.begin(), sizes.end());
+  std::cout << "  Dense: " << fragment_num - sparse_num
+            << ", sparse: " << sparse_num << std::endl;
+  std::cout << "Fragment sizes:" << std::endl;
+  std::cout << "  Total: " << format_bytes(total_size) << std::endl;
+  std::cout << "  Min: " << format_bytes(sizes.front())
+            << ", median: " << format_bytes(sizes[fragment_num / 2])
+            << ", mean: " << format_bytes((double)total_size / fragment_num)
+            << ", max: " << format_bytes(sizes.back()) << std::endl;
+
+  // Compute how much the non-empty domains of the fragments overlap. The
+  // read amplification is the mean number of fragments covering a cell of
+  // a fragment, weighted by fragment volume, which is the number of
+  // fragments a read of that cell has to consult.
+  std::vector<std::vector<double>> domains;
+  for (const auto& info : fragment_info)
+    domains.push_back(domain_to_double(
+        info.non_empty_domain_.data(), coords_type, dim_num));
+  std::vector<double> bounding_box = domains[0];
+  uint64_t overlapping_pairs = 0;
+  double total_volume = 0, weighted_depth = 0;
+  for (size_t i = 0; i < fragment_num; i++) {
+    for (unsigned d = 0; d < dim_num; d++) {
+      bounding_box[2 * d] = std::min(bounding_box[2 * d], domains[i][2 * d]);
+      bounding_box[2 * d + 1] =
+          std::max(bounding_box[2 * d + 1], domains[i][2 * d + 1]);
+    }
+    const double volume = intersection_volume(domains[i], domains[i], integer);
+    double depth = 0;
+    for (size_t j = 0; j < fragment_num; j++) {
+      const double overlap =
+          intersection_volume(domains[i], domains[j], integer);
+      // Degenerate real domains have no volume; count the fragments.
+      if (volume > 0)
+        depth += overlap / volume;
+      else if (overlap > 0 || j == i)
+        depth += 1;
+      if (j > i && overlap > 0)
+        overlapping_pairs++;
+    }
+    const double weight = volume > 0 ? volume : 1;
+    total_volume += weight;
+    weighted_depth += weight * depth;
+  }
+  const uint64_t pair_num = fragment_num * (fragment_num - 1) / 2;
+  const double overlap_ratio =
+      pair_num == 0 ? 0 : (double)overlapping_pairs / pair_num;
+  const double read_amplification = weighted_depth / total_volume;
+  const double bounding_volume =
+      intersection_volume(bounding_box, bounding_box, integer);
+  const double coverage =
+      bounding_volume > 0 ? total_volume / bounding_volume : 1;
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << "Domain overlap ratio: " << overlap_ratio << " ("
+            << overlapping_pairs << " of " << pair_num
+            << " fragment pairs overlap)" << std::endl;
+  std::cout << "Estimated read amplification: " << read_amplification
+            << " fragments per cell" << std::endl;
+  std::cout << std::defaultfloat;
+
+  // Report the persisted tile size histogram and compression ratio of each
+  // attribute, in power-of-two buckets.
+  std::cout << "Tile sizes (per attribute):" << std::endl;
+  auto process_attr = [&](const std::string& name, bool var_size) {
+    std::map<unsigned, uint64_t> histogram;
+    uint64_t persisted_size = 0, in_memory_size = 0;
+    auto add_tile = [&](uint64_t persisted, uint64_t in_memory) {
+      unsigned bucket = 0;
+      while (bucket < 63 && (uint64_t(1) << (bucket + 1)) <= persisted)
+        bucket++;
+      histogram[bucket]++;
+      persisted_size += persisted;
+      in_memory_size += in_memory;
+    };
+    for (const auto& f : fragment_metadata) {
+      uint64_t tile_num = f->tile_num();
+      for (uint64_t tile_idx = 0; tile_idx < tile_num; tile_idx++) {
+        uint64_t persisted = 0, in_memory = 0;
+        THROW_NOT_OK(
+            f->persisted_tile_size(enc_key, name, tile_idx, &persisted));
+        add_tile(persisted, f->tile_size(name, tile_idx));
+        if (var_size) {
+          THROW_NOT_OK(
+              f->persisted_tile_var_size(enc_key, name, tile_idx, &persisted));
+          THROW_NOT_OK(f->tile_var_size(enc_key, name, tile_idx, &in_memory));
+          add_tile(persisted, in_memory);
+        }
+      }
+    }
+
+    std::cout << "- " << name << ":" << std::endl;
+    std::cout << "  Compression ratio: ";
+    if (persisted_size == 0)
+      std::cout << "n/a" << std::endl;
+    else
+      std::cout << std::fixed << std::setprecision(2)
+                << (double)in_memory_size / persisted_size << std::defaultfloat
+                << std::endl;
+    for (const auto& bucket : histogram)
+      std::cout << "  [" << format_bytes(uint64_t(1) << bucket.first) << ", "
+                << format_bytes(std::ldexp(1.0, bucket.first + 1))
+                << "): " << bucket.second << " tiles" << std::endl;
+  };
+  if (!schema->dense())
+    process_attr(constants::coords, false);
+  for (const auto* attr : schema->attributes())
+    process_attr(attr->name(), attr->var_size());
+
+  // Recommend consolidation settings. Every fragment costs a metadata load
+  // and a read of each of its overlapping tiles, so many or overlapping
+  // fragments call for consolidation.
+  std::cout << "Consolidation recommendation:" << std::endl;
+  if (fragment_num < 2 || (read_amplification < 1.5 && fragment_num <= 8)) {
+    std::cout << "  None; the fragments are healthy." << std::endl;
+  } else {
+    const uint64_t max_frags = std::min<uint64_t>(fragment_num, 32);
+    const uint64_t steps = std::max<uint64_t>(
+        1,
+        (uint64_t)std::ceil(
+            std::log((double)fragment_num) / std::log((double)max_frags)));
+    std::cout << "  sm.consolidation.steps = " << steps << std::endl;
+    std::cout << "  sm.consolidation.step_min_frags = 2" << std::endl;
+    std::cout << "  sm.consolidation.step_max_frags = " << max_frags
+              << std::endl;
+
+    // With very different fragment sizes, merging by size ratio rewrites
+    // the large fragments to absorb the small ones.
+    const double size_skew =
+        (double)sizes.back() / std::max<uint64_t>(sizes.front(), 1);
+    if (size_skew > 10) {
+      std::cout << "  sm.consolidation.planner = cost  "
+                << "# fragment sizes differ by up to " << std::fixed
+                << std::setprecision(0) << size_skew << "x"
+                << std::defaultfloat << std::endl;
+    } else {
+      std::cout << "  sm.consolidation.planner = size_ratio" << std::endl;
+      std::cout << "  sm.consolidation.step_size_ratio = 0.5" << std::endl;
+    }
+
+    // Dense fragments with gaps between them are only consolidated if the
+    // amplification allows filling the gaps.
+    if (sparse_num < fragment_num && coverage < 1) {
+      std::cout << "  sm.consolidation.amplification = " << std::fixed
+                << std::setprecision(1) << std::ceil(10 / coverage) / 10
+                << std::defaultfloat
+                << "  # the fragments cover part of their bounding box"
+                << std::endl;
+    }
+  }
+
+  // Close the array.
+  THROW_NOT_OK(array.close());
+}
+
 void InfoCommand::write_svg_mbrs() const {
   StorageManager sm;
   THROW_NOT_OK(sm.init(nullptr));
@@ -434,6 +673,51 @@ std::vector<std::string> InfoCommand::mbr_to_string(
   return result;
 }
 
+std::vector<double> InfoCommand::domain_to_double(
+    const void* domain, Datatype coords_type, unsigned dim_num) const {
+  std::vector<double> result;
+  for (unsigned i = 0; i < 2 * dim_num; i++) {
+    switch (coords_type) {
+      case Datatype::INT8:
+        result.push_back(static_cast<const int8_t*>(domain)[i]);
+        break;
+      case Datatype::UINT8:
+        result.push_back(static_cast<const uint8_t*>(domain)[i]);
+        break;
+      case Datatype::INT16:
+        result.push_back(static_cast<const int16_t*>(domain)[i]);
+        break;
+      case Datatype::UINT16:
+        result.push_back(static_cast<const uint16_t*>(domain)[i]);
+        break;
+      case Datatype::INT32:
+        result.push_back(static_cast<const int*>(domain)[i]);
+        break;
+      case Datatype::UINT32:
+        result.push_back(static_cast<const unsigned*>(domain)[i]);
+        break;
+      case Datatype::UINT64:
+        result.push_back(static_cast<const uint64_t*>(domain)[i]);
+        break;
+      case Datatype::FLOAT32:
+        result.push_back(static_cast<const float*>(domain)[i]);
+        break;
+      case Datatype::FLOAT64:
+        result.push_back(static_cast<const double*>(domain)[i]);
+        break;
+      default:
+        if (!datatype_is_integer(coords_type) &&
+            !datatype_is_datetime(coords_type))
+          throw std::invalid_argument(
+              "Cannot get domain; Unsupported coordinates type");
+        result.push_back(static_cast<const int64_t*>(domain)[i]);
+        break;
+    }
+  }
+
+  return result;
+}
+
 // Explicit template instantiations
 template std::tuple<double, double, double, double>
 InfoCommand::get_mbr<int8_t>(const void* mbr) const;
@@ -37,6 +37,9 @@
 
 #include "tiledb/sm/enums/datatype.h"
 
+#include <string>
+#include <vector>
+
 namespace tiledb {
 namespace cli {
 
@@ -53,7 +56,14 @@ class InfoCommand : public Command {
 
  private:
   /** Types of information that can be displayed. */
-  enum class InfoType { None, TileSizes, SVGMBRs, DumpMBRs, ArraySchema };
+  enum class InfoType {
+    None,
+    TileSizes,
+    SVGMBRs,
+    DumpMBRs,
+    ArraySchema,
+    Fragments
+  };
 
   /** Type of information to display. */
   InfoType type_ = InfoType::None;
@@ -76,6 +86,13 @@ class InfoCommand : public Command {
   /** Prints basic information about the array schema. */
   void print_schema_info() const;
 
+  /**
+   * Prints the health of the array's fragments (sizes, overlap, tile sizes,
+   * compression and read amplification) and recommends consolidation
+   * settings.
+   */
+  void print_fragment_health() const;
+
   /** Dumps array MBRs to SVG. */
   void write_svg_mbrs() const;
 
@@ -90,6 +107,15 @@ class InfoCommand : public Command {
   template <typename T>
   std::tuple<double, double, double, double> get_mbr(const void* mbr) const;
 
+  /**
+   * Converts an opaque non-empty domain to a double vector:
+   * [dim0_min, dim0_max, dim1_min, dim1_max, ...]
+   */
+  std::vector<double> domain_to_double(
+      const void* domain,
+      tiledb::sm::Datatype coords_type,
+      unsigned dim_num) const;
+
   /**
    * Converts an opaque MBR to a string vector. The vector contents are strings:
    * [dim0_min, dim0_max, dim1_min, dim1_max, ...]
@@ -0,0 +1,404 @@
+/**
+ * @file  profile_command.cc
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018-2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file defines the profile command.
+ */
+
+#include "commands/profile_command.h"
+#include "misc/common.h"
+
+#include "tiledb/sm/array/array.h"
+#include "tiledb/sm/array_schema/array_schema.h"
+#include "tiledb/sm/array_schema/attribute.h"
+#include "tiledb/sm/array_schema/domain.h"
+#include "tiledb/sm/enums/encryption_type.h"
+#include "tiledb/sm/enums/layout.h"
+#include "tiledb/sm/enums/query_status.h"
+#include "tiledb/sm/enums/query_type.h"
+#include "tiledb/sm/fragment/fragment_metadata.h"
+#include "tiledb/sm/misc/stats.h"
+#include "tiledb/sm/misc/trace.h"
+#include "tiledb/sm/query/query.h"
+#include "tiledb/sm/storage_manager/storage_manager.h"
+
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace tiledb {
+namespace cli {
+
+using namespace tiledb::sm;
+
+namespace {
+
+template <class T>
+void parse_integer_bound(const std::string& str, void* value) {
+  std::size_t pos = 0;
+  T parsed = std::is_signed<T>::value ?
+                 static_cast<T>(std::stoll(str, &pos)) :
+                 static_cast<T>(std::stoull(str, &pos));
+  if (pos != str.size())
+    throw std::invalid_argument(str);
+  *static_cast<T*>(value) = parsed;
+}
+
+template <class T>
+void parse_real_bound(const std::string& str, void* value) {
+  std::size_t pos = 0;
+  T parsed = static_cast<T>(std::stod(str, &pos));
+  if (pos != str.size())
+    throw std::invalid_argument(str);
+  *static_cast<T*>(value) = parsed;
+}
+
+/** Formats a ratio as a percentage. */
+std::string percent(uint64_t part, uint64_t whole) {
+  if (whole == 0)
+    return "n/a";
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(1) << (100.0 * part) / whole << "%";
+  return ss.str();
+}
+
+/** Formats a duration in nanoseconds as milliseconds. */
+std::string millis(uint64_t ns) {
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(3) << ns / 1e6 << " ms";
+  return ss.str();
+}
+
+}  // namespace
+
+clipp::group ProfileCommand::get_cli() {
+  using namespace clipp;
+  auto cli =
+      ((option("-a", "--array").required(true) & value("uri", array_uri_)) %
+           "URI of TileDB array",
+       (option("-s", "--subarray") & value("bounds", subarray_)) %
+           "Comma-separated low and high bounds of each dimension (default: "
+           "the non-empty domain)",
+       (option("-l", "--layout") & value("layout", layout_)) %
+           "Result layout: row-major, col-major, global-order or unordered "
+           "(default: row-major)",
+       (option("-A", "--attributes") & value("names", attributes_)) %
+           "Comma-separated attributes to read (default: all)",
+       (option("-b", "--buffer-size") & value("MB", buffer_size_mb_)) %
+           "Size of each result buffer in MB (default: 64)",
+       (option("-t", "--trace") & value("path", trace_path_)) %
+           "Path to write a Chrome trace of the read");
+  return cli;
+}
+
+void ProfileCommand::run() {
+  const auto attributes = attribute_names();
+
+  // Profile the read of all the attributes, tracing it if requested.
+  auto& tracer = stats::Tracer::global();
+  if (!trace_path_.empty()) {
+    tracer.reset();
+    tracer.set_enabled(true);
+  }
+  const ReadProfile profile = read(attributes);
+  tracer.set_enabled(false);
+
+  const auto& s = stats::all_stats;
+  const uint64_t tile_bytes = s.counter_reader_num_tile_bytes_read.load();
+  const uint64_t vfs_bytes = s.counter_vfs_read_total_bytes.load();
+  const uint64_t unfiltered_bytes =
+      s.counter_reader_num_bytes_after_filtering.load();
+  const uint64_t cache_hits = s.counter_cache_tile_read_hits.load();
+  const uint64_t cache_misses = s.counter_cache_tile_read_misses.load();
+
+  std::cout << "Array URI: " << array_uri_ << std::endl;
+  std::cout << "Read time: " << millis(profile.elapsed_ns) << " ("
+            << profile.submissions << " submissions)" << std::endl;
+  std::cout << "Result bytes: " << profile.result_bytes << std::endl;
+  std::cout << "Partition splits: "
+            << s.reader_next_subarray_partition_call_count.load() << std::endl;
+  std::cout << "Fragments touched: " << profile.fragments_touched << " of "
+            << profile.fragments << std::endl;
+  std::cout << "Attribute tiles touched: "
+            << s.counter_reader_num_attr_tiles_touched.load() << std::endl;
+  std::cout << "Bytes read:" << std::endl;
+  std::cout << "  Tile bytes read: " << tile_bytes << std::endl;
+  std::cout << "  Total bytes read from storage: " << vfs_bytes << std::endl;
+  std::cout << "  Tile bytes after filtering: " << unfiltered_bytes
+            << std::endl;
+  std::cout << "  Result bytes per unfiltered tile byte: "
+            << percent(profile.result_bytes, unfiltered_bytes) << std::endl;
+  std::cout << "Filter time: "
+            << millis(s.filter_pipeline_run_reverse_total_ns.load())
+            << std::endl;
+  std::cout << "Tile cache hit rate: "
+            << percent(cache_hits, cache_hits + cache_misses) << " ("
+            << cache_hits << " hits, " << cache_misses << " misses)"
+            << std::endl;
+
+  // The reader does not split the filter time by attribute, so read each
+  // attribute on its own to get it.
+  if (attributes.size() > 1) {
+    std::cout << "Filter time per attribute (read on its own):" << std::endl;
+    for (const auto& name : attributes) {
+      read({name});
+      std::cout << "  " << name << ": "
+                << millis(s.filter_pipeline_run_reverse_total_ns.load())
+                << std::endl;
+    }
+  }
+  stats::all_stats.set_enabled(false);
+
+  if (!trace_path_.empty()) {
+    FILE* out = fopen(trace_path_.c_str(), "w");
+    if (out == nullptr)
+      throw std::runtime_error("Cannot open trace file " + trace_path_);
+    tracer.dump(out);
+    fclose(out);
+    std::cout << "Trace written to " << trace_path_ << std::endl;
+  }
+}
+
+ProfileCommand::ReadProfile ProfileCommand::read(
+    const std::vector<std::string>& attributes) const {
+  StorageManager sm;
+  THROW_NOT_OK(sm.init(nullptr));
+
+  // Open the array
+  URI uri(array_uri_);
+  Array array(uri, &sm);
+  THROW_NOT_OK(
+      array.open(QueryType::READ, EncryptionType::NO_ENCRYPTION, nullptr, 0));
+  const auto* schema = array.array_schema();
+  const auto* domain = schema->domain();
+  const Datatype type = domain->type();
+  const unsigned dim_num = domain->dim_num();
+  const uint64_t type_size = datatype_size(type);
+
+  // Get the subarray bounds, one low and high pair per dimension.
+  std::vector<uint8_t> bounds(2 * dim_num * type_size);
+  if (subarray_.empty()) {
+    bool is_empty = false;
+    THROW_NOT_OK(
+        sm.array_get_non_empty_domain(&array, bounds.data(), &is_empty));
+    if (is_empty)
+      throw std::runtime_error("Array " + array_uri_ + " is empty");
+  } else {
+    const auto strs = split(subarray_);
+    if (strs.size() != 2 * dim_num)
+      throw std::runtime_error(
+          "Subarray must have a low and high bound for each of the " +
+          std::to_string(dim_num) + " dimensions");
+    for (size_t i = 0; i < strs.size(); i++)
+      parse_bound(strs[i], type, &bounds[i * type_size]);
+  }
+
+  // Count the fragments whose non-empty domain overlaps the subarray.
+  ReadProfile profile;
+  const auto fragment_metadata = array.fragment_metadata();
+  profile.fragments = fragment_metadata.size();
+  for (const auto* f : fragment_metadata) {
+    const auto* ned = static_cast<const uint8_t*>(f->non_empty_domain());
+    bool overlaps = true;
+    for (unsigned d = 0; d < dim_num && overlaps; d++) {
+      const uint64_t low = 2 * d * type_size, high = low + type_size;
+      overlaps = to_double(&ned[low], type) <= to_double(&bounds[high], type) &&
+                 to_double(&bounds[low], type) <= to_double(&ned[high], type);
+    }
+    if (overlaps)
+      profile.fragments_touched++;
+  }
+
+  Layout layout;
+  THROW_NOT_OK(layout_enum(layout_, &layout));
+  Query query(&sm, &array);
+  THROW_NOT_OK(query.set_layout(layout));
+  for (unsigned d = 0; d < dim_num; d++) {
+    const uint64_t low = 2 * d * type_size, high = low + type_size;
+    THROW_NOT_OK(query.add_range(d, &bounds[low], &bounds[high], nullptr));
+  }
+
+  // Allocate the result buffers, which are reset before each submission.
+  struct ResultBuffer {
+    bool var_size;
+    std::vector<uint64_t> offsets;
+    std::vector<uint8_t> data;
+    uint64_t offsets_size;
+    uint64_t data_size;
+  };
+  const uint64_t buffer_size = buffer_size_mb_ * 1024 * 1024;
+  std::vector<ResultBuffer> buffers(attributes.size());
+  for (size_t i = 0; i < attributes.size(); i++) {
+    const auto* attr = schema->attribute(attributes[i]);
+    if (attr == nullptr)
+      throw std::runtime_error("Unknown attribute " + attributes[i]);
+    buffers[i].var_size = attr->var_size();
+    buffers[i].data.resize(buffer_size);
+    if (buffers[i].var_size)
+      buffers[i].offsets.resize(buffer_size / sizeof(uint64_t));
+  }
+
+  stats::all_stats.reset();
+  stats::all_stats.set_enabled(true);
+  const auto start = std::chrono::steady_clock::now();
+  do {
+    for (size_t i = 0; i < attributes.size(); i++) {
+      auto& buffer = buffers[i];
+      buffer.data_size = buffer.data.size();
+      if (buffer.var_size) {
+        buffer.offsets_size = buffer.offsets.size() * sizeof(uint64_t);
+        THROW_NOT_OK(query.set_buffer(
+            attributes[i],
+            buffer.offsets.data(),
+            &buffer.offsets_size,
+            buffer.data.data(),
+            &buffer.data_size));
+      } else {
+        buffer.offsets_size = 0;
+        THROW_NOT_OK(query.set_buffer(
+            attributes[i], buffer.data.data(), &buffer.data_size));
+      }
+    }
+
+    THROW_NOT_OK(query.submit());
+    profile.submissions++;
+
+    uint64_t result_bytes = 0;
+    for (const auto& buffer : buffers)
+      result_bytes += buffer.offsets_size + buffer.data_size;
+    if (query.status() == QueryStatus::INCOMPLETE && result_bytes == 0)
+      throw std::runtime_error(
+          "Read made no progress; the result buffers are too small");
+    profile.result_bytes += result_bytes;
+  } while (query.status() == QueryStatus::INCOMPLETE);
+  profile.elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+
+  // Close the array.
+  THROW_NOT_OK(array.close());
+
+  return profile;
+}
+
+std::vector<std::string> ProfileCommand::attribute_names() const {
+  if (!attributes_.empty())
+    return split(attributes_);
+
+  StorageManager sm;
+  THROW_NOT_OK(sm.init(nullptr));
+
+  // Open the array
+  URI uri(array_uri_);
+  Array array(uri, &sm);
+  THROW_NOT_OK(
+      array.open(QueryType::READ, EncryptionType::NO_ENCRYPTION, nullptr, 0));
+
+  std::vector<std::string> names;
+  for (const auto* attr : array.array_schema()->attributes())
+    names.push_back(attr->name());
+
+  // Close the array.
+  THROW_NOT_OK(array.close());
+
+  return names;
+}
+
+void ProfileCommand::parse_bound(
+    const std::string& str, Datatype type, void* value) {
+  try {
+    switch (type) {
+      case Datatype::INT8:
+        return parse_integer_bound<int8_t>(str, value);
+      case Datatype::UINT8:
+        return parse_integer_bound<uint8_t>(str, value);
+      case Datatype::INT16:
+        return parse_integer_bound<int16_t>(str, value);
+      case Datatype::UINT16:
+        return parse_integer_bound<uint16_t>(str, value);
+      case Datatype::INT32:
+        return parse_integer_bound<int32_t>(str, value);
+      case Datatype::UINT32:
+        return parse_integer_bound<uint32_t>(str, value);
+      case Datatype::UINT64:
+        return parse_integer_bound<uint64_t>(str, value);
+      case Datatype::FLOAT32:
+        return parse_real_bound<float>(str, value);
+      case Datatype::FLOAT64:
+        return parse_real_bound<double>(str, value);
+      default:
+        if (datatype_is_integer(type) || datatype_is_datetime(type))
+          return parse_integer_bound<int64_t>(str, value);
+        break;
+    }
+  } catch (const std::logic_error&) {
+    throw std::runtime_error("Invalid subarray bound " + str);
+  }
+  throw std::runtime_error(
+      "Cannot profile arrays with domain type " + datatype_str(type));
+}
+
+double ProfileCommand::to_double(const void* value, Datatype type) {
+  switch (type) {
+    case Datatype::INT8:
+      return *static_cast<const int8_t*>(value);
+    case Datatype::UINT8:
+      return *static_cast<const uint8_t*>(value);
+    case Datatype::INT16:
+      return *static_cast<const int16_t*>(value);
+    case Datatype::UINT16:
+      return *static_cast<const uint16_t*>(value);
+    case Datatype::INT32:
+      return *static_cast<const int32_t*>(value);
+    case Datatype::UINT32:
+      return *static_cast<const uint32_t*>(value);
+    case Datatype::UINT64:
+      return static_cast<double>(*static_cast<const uint64_t*>(value));
+    case Datatype::FLOAT32:
+      return *static_cast<const float*>(value);
+    case Datatype::FLOAT64:
+      return *static_cast<const double*>(value);
+    default:
+      return static_cast<double>(*static_cast<const int64_t*>(value));
+  }
+}
+
+std::vector<std::string> ProfileCommand::split(const std::string& str) {
+  std::vector<std::string> parts;
+  std::stringstream ss(str);
+  std::string part;
+  while (std::getline(ss, part, ','))
+    parts.push_back(part);
+  return parts;
+}
+
+}  // namespace cli
+}  // namespace tiledb
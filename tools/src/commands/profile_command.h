@@ -0,0 +1,118 @@
+/**
+ * @file  profile_command.h
+ *
+ * @section LICENSE
+ *
+ * The MIT License
+ *
+ * @copyright Copyright (c) 2018-2020 TileDB, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * @section DESCRIPTION
+ *
+ * This file declares the profile command.
+ */
+
+#ifndef TILEDB_CLI_PROFILE_COMMAND_H
+#define TILEDB_CLI_PROFILE_COMMAND_H
+
+#include "commands/command.h"
+
+#include "tiledb/sm/enums/datatype.h"
+
+#include <string>
+#include <vector>
+
+namespace tiledb {
+namespace cli {
+
+/**
+ * Command that runs a read query with stats enabled and prints a breakdown
+ * of where its time and bytes went.
+ */
+class ProfileCommand : public Command {
+ public:
+  /** Get the CLI for this command instance. */
+  clipp::group get_cli();
+
+  /** Runs this profile command. */
+  void run();
+
+ private:
+  /** What a profiled read did, besides the stats counters. */
+  struct ReadProfile {
+    /** The number of submissions until the read completed. */
+    uint64_t submissions = 0;
+
+    /** The number of fragments of the array. */
+    uint64_t fragments = 0;
+
+    /** The number of fragments overlapping the subarray. */
+    uint64_t fragments_touched = 0;
+
+    /** The number of result bytes, including offsets. */
+    uint64_t result_bytes = 0;
+
+    /** The wall time of the submissions, in nanoseconds. */
+    uint64_t elapsed_ns = 0;
+  };
+
+  /** Array to profile. */
+  std::string array_uri_;
+
+  /** Comma-separated subarray bounds, empty for the non-empty domain. */
+  std::string subarray_;
+
+  /** Result layout. */
+  std::string layout_ = "row-major";
+
+  /** Comma-separated attributes to read, empty for all of them. */
+  std::string attributes_;
+
+  /** Size of each result buffer, in MB. */
+  uint64_t buffer_size_mb_ = 64;
+
+  /** Path to write a Chrome trace of the read, if not empty. */
+  std::string trace_path_;
+
+  /**
+   * Reads the given attributes of the subarray with a fresh storage
+   * manager, so that no cache is warm.
+   */
+  ReadProfile read(const std::vector<std::string>& attributes) const;
+
+  /** Returns the attributes to read. */
+  std::vector<std::string> attribute_names() const;
+
+  /** Parses a bound of the subarray into `value`. */
+  static void parse_bound(
+      const std::string& str, tiledb::sm::Datatype type, void* value);
+
+  /** Returns the value of a coordinate as a double. */
+  static double to_double(const void* value, tiledb::sm::Datatype type);
+
+  /** Splits a comma-separated list. */
+  static std::vector<std::string> split(const std::string& str);
+};
+
+}  // namespace cli
+}  // namespace tiledb
+
+#endif
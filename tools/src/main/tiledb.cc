@@ -37,24 +37,32 @@
 
 #include "commands/help_command.h"
 #include "commands/info_command.h"
+#include "commands/profile_command.h"
 
 using namespace tiledb::cli;
 using namespace clipp;
 
 int main(int argc, char** argv) {
-  enum class Mode { Undef, Info, Help };
+  enum class Mode { Undef, Info, Profile, Help };
   Mode mode = Mode::Undef;
 
   InfoCommand info;
   auto info_mode = (command("info").set(mode, Mode::Info), info.get_cli());
 
+  ProfileCommand profile;
+  auto profile_mode =
+      (command("profile").set(mode, Mode::Profile), profile.get_cli());
+
   HelpCommand help;
   auto help_mode = (command("help").set(mode, Mode::Help), help.get_cli());
 
-  auto all_args = help_mode | info_mode;
+  auto all_args = help_mode | info_mode | profile_mode;
 
   std::map<std::string, clipp::group> help_map = {
-      {"all", all_args}, {"help", help_mode}, {"info", info_mode}};
+      {"all", all_args},
+      {"help", help_mode},
+      {"info", info_mode},
+      {"profile", profile_mode}};
 
   if (argc > 2 && argv[1] == std::string("help")) {
     // Shortcut parsing for help command.
@@ -67,6 +75,9 @@ int main(int argc, char** argv) {
       case Mode::Info:
         help.set_command("info");
         break;
+      case Mode::Profile:
+        help.set_command("profile");
+        break;
       case Mode::Help:
         help.set_command("help");
         break;
@@ -83,6 +94,9 @@ int main(int argc, char** argv) {
     case Mode::Info:
       info.run();
       break;
+    case Mode::Profile:
+      profile.run();
+      break;
     case Mode::Help:
       help.run(help_map);
       break;